@@ -90,3 +90,48 @@ function(add_core_ze_library_test project_name)
 
     add_test(NAME ${name} COMMAND ${name} WORKING_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}")
 endfunction()
+
+# Builds native binaries of the SPIR-V FILES of target with ocloc for every
+# device in ZE_NATIVE_KERNEL_TARGETS, kernel.spv giving kernel_<device>.bin,
+# and installs them to destination next to the SPIR-V. The target gets the
+# device list as ZE_NATIVE_KERNEL_TARGETS, for the lookup in
+# perf_tests/common/include/common.hpp.
+function(add_native_kernels target destination)
+    cmake_parse_arguments(F "" "" "FILES" ${ARGN})
+    if(NOT ZE_NATIVE_KERNEL_TARGETS)
+        return()
+    endif()
+
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/native_kernels")
+    set(native_binaries "")
+    foreach(spirv ${F_FILES})
+        get_filename_component(kernel "${spirv}" NAME_WE)
+        foreach(device ${ZE_NATIVE_KERNEL_TARGETS})
+            set(output_name "${kernel}_${device}")
+            add_custom_command(
+                OUTPUT "${output_dir}/${output_name}.bin"
+                COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+                COMMAND ${OCLOC_EXECUTABLE} compile -spirv_input
+                    -file "${spirv}" -device ${device}
+                    -output ${output_name} -output_no_suffix
+                    -out_dir "${output_dir}"
+                DEPENDS "${spirv}"
+                COMMENT "Building ${output_name}.bin with ocloc"
+                VERBATIM
+            )
+            list(APPEND native_binaries "${output_dir}/${output_name}.bin")
+        endforeach()
+    endforeach()
+    if(NOT native_binaries)
+        return()
+    endif()
+
+    add_custom_target(${target}_native_kernels ALL DEPENDS ${native_binaries})
+    install(FILES ${native_binaries} DESTINATION ${destination})
+
+    string(REPLACE ";" "," device_list "${ZE_NATIVE_KERNEL_TARGETS}")
+    target_compile_definitions(${target}
+      PRIVATE
+      ZE_NATIVE_KERNEL_TARGETS="${device_list}"
+    )
+endfunction()
@@ -0,0 +1,171 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include <level_zero/ze_api.h>
+
+namespace lzt = level_zero_tests;
+
+namespace {
+
+enum OrderingType {
+  OT_GLOBAL_BARRIER,
+  OT_MEMORY_RANGES_BARRIER,
+  OT_DEVICE_SCOPE_EVENT,
+  OT_HOST_SCOPE_EVENT,
+  OT_IN_ORDER_LIST
+};
+
+std::string ordering_name(OrderingType ordering) {
+  switch (ordering) {
+  case OT_GLOBAL_BARRIER:
+    return "global barrier";
+  case OT_MEMORY_RANGES_BARRIER:
+    return "memory ranges barrier";
+  case OT_DEVICE_SCOPE_EVENT:
+    return "device scope event";
+  case OT_HOST_SCOPE_EVENT:
+    return "host scope event";
+  case OT_IN_ORDER_LIST:
+    return "in-order list";
+  }
+  return "unknown";
+}
+
+// Every kernel signals its own kernel timestamp event, so the cost of an
+// ordering mechanism is the device time from the end of a kernel to the
+// start of the kernel depending on it.  Pairs are separated by a global
+// barrier outside of in-order lists, and only the gap within a pair is
+// reported.
+class zeBarrierPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<OrderingType> {};
+
+TEST_P(
+    zeBarrierPerformanceTests,
+    GivenDependentKernelsWhenOrderedBySynchronizationPrimitiveThenReportDeviceGapBetweenKernels) {
+  const ze_device_handle_t device = lzt::zeDevice::get_instance()->get_device();
+  ze_context_handle_t context = lzt::get_default_context();
+  const OrderingType ordering = GetParam();
+  const uint32_t pairs = 64;
+  const uint32_t group_size_x = 64;
+  const uint32_t num_int = 4096;
+  const size_t size = num_int * sizeof(int);
+  const int addval = 3;
+
+  const ze_command_list_flags_t list_flags =
+      (ordering == OT_IN_ORDER_LIST) ? ZE_COMMAND_LIST_FLAG_IN_ORDER : 0;
+  auto bundle = lzt::create_command_bundle(context, device, list_flags, false);
+  void *dev_buff = lzt::allocate_device_memory(size, 1, 0, 0, device, context);
+  void *host_buff = lzt::allocate_host_memory(size, 1, context);
+
+  ze_module_handle_t module =
+      lzt::create_module(context, device, "barrier_add.spv",
+                         ZE_MODULE_FORMAT_IL_SPIRV, nullptr, nullptr);
+  ze_kernel_handle_t kernel =
+      lzt::create_function(module, "barrier_add_constant");
+  lzt::set_group_size(kernel, group_size_x, 1, 1);
+  lzt::set_argument_value(kernel, 0, sizeof(dev_buff), &dev_buff);
+  lzt::set_argument_value(kernel, 1, sizeof(addval), &addval);
+  ze_group_count_t group_count = {num_int / group_size_x, 1, 1};
+
+  ze_event_pool_handle_t event_pool = lzt::create_event_pool(
+      context, 2 * pairs,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  const ze_event_scope_flags_t signal_scope =
+      (ordering == OT_HOST_SCOPE_EVENT) ? ZE_EVENT_SCOPE_FLAG_HOST
+                                        : ZE_EVENT_SCOPE_FLAG_DEVICE;
+  std::vector<ze_event_handle_t> events(2 * pairs);
+  for (uint32_t i = 0; i < 2 * pairs; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                  signal_scope, ZE_EVENT_SCOPE_FLAG_DEVICE};
+    events[i] = lzt::create_event(event_pool, event_desc);
+  }
+
+  const uint8_t zero = 0;
+  lzt::append_memory_set(bundle.list, dev_buff, &zero, size);
+  if (ordering != OT_IN_ORDER_LIST) {
+    lzt::append_barrier(bundle.list, nullptr, 0, nullptr);
+  }
+  for (uint32_t i = 0; i < pairs; i++) {
+    ze_event_handle_t *first = &events[2 * i];
+    ze_event_handle_t *second = &events[2 * i + 1];
+    lzt::append_launch_function(bundle.list, kernel, &group_count, *first, 0,
+                                nullptr);
+    uint32_t num_wait = 0;
+    if (ordering == OT_GLOBAL_BARRIER) {
+      lzt::append_barrier(bundle.list, nullptr, 0, nullptr);
+    } else if (ordering == OT_MEMORY_RANGES_BARRIER) {
+      const void *range = dev_buff;
+      lzt::append_memory_ranges_barrier(bundle.list, 1, &size, &range,
+                                        nullptr, 0, nullptr);
+    } else if (ordering == OT_DEVICE_SCOPE_EVENT ||
+               ordering == OT_HOST_SCOPE_EVENT) {
+      num_wait = 1;
+    }
+    lzt::append_launch_function(bundle.list, kernel, &group_count, *second,
+                                num_wait, num_wait ? first : nullptr);
+    if (ordering != OT_IN_ORDER_LIST) {
+      lzt::append_barrier(bundle.list, nullptr, 0, nullptr);
+    }
+  }
+  lzt::append_memory_copy(bundle.list, host_buff, dev_buff, size);
+  lzt::close_command_list(bundle.list);
+
+  // Only the last execution is measured, after the warm-up ones
+  for (int run = 0; run < lzt::warm_up_iterations + 1; run++) {
+    for (auto event : events) {
+      lzt::event_host_reset(event);
+    }
+    memset(host_buff, 0, size);
+    lzt::execute_and_sync_command_bundle(bundle, UINT64_MAX);
+  }
+
+  // Any kernel running before its predecessor finished loses the update
+  const int *p_host = static_cast<int *>(host_buff);
+  for (uint32_t i = 0; i < num_int; i++) {
+    EXPECT_EQ(static_cast<int>(2 * pairs) * addval, p_host[i]);
+  }
+
+  std::vector<double> gaps, kernel_times;
+  for (uint32_t i = 0; i < pairs; i++) {
+    auto timeline =
+        lzt::get_kernel_timeline(device, {events[2 * i], events[2 * i + 1]});
+    gaps.push_back(timeline.spans[1].start_ns - timeline.spans[0].end_ns);
+    kernel_times.push_back(timeline.spans[0].duration_ns());
+    kernel_times.push_back(timeline.spans[1].duration_ns());
+  }
+  LOG_INFO << ordering_name(ordering) << ": gap between dependent kernels p50 "
+           << lzt::median(gaps) << " ns, p90 " << lzt::percentile(gaps, 90)
+           << " ns, min " << lzt::percentile(gaps, 0) << " ns, kernel p50 "
+           << lzt::median(kernel_times) << " ns";
+
+  for (auto event : events) {
+    lzt::destroy_event(event);
+  }
+  lzt::destroy_event_pool(event_pool);
+  lzt::destroy_function(kernel);
+  lzt::destroy_module(module);
+  lzt::destroy_command_bundle(bundle);
+  lzt::free_memory(context, host_buff);
+  lzt::free_memory(context, dev_buff);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TestBarrierPerformance, zeBarrierPerformanceTests,
+    ::testing::Values(OT_GLOBAL_BARRIER, OT_MEMORY_RANGES_BARRIER,
+                      OT_DEVICE_SCOPE_EVENT, OT_HOST_SCOPE_EVENT,
+                      OT_IN_ORDER_LIST));
+
+} // namespace
@@ -8,6 +8,7 @@
 
 #include "gmock/gmock.h"
 #include "logging/logging.hpp"
+#include "test_harness/test_harness.hpp"
 #include "utils/utils.hpp"
 
 int main(int argc, char **argv) {
@@ -23,5 +24,5 @@ int main(int argc, char **argv) {
   LOG_TRACE << "Driver initialized";
   level_zero_tests::print_platform_overview();
 
-  return RUN_ALL_TESTS();
+  return level_zero_tests::run_all_tests();
 }
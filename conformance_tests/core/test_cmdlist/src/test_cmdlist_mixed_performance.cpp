@@ -0,0 +1,235 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock mixed_clock;
+
+double elapsed_us(mixed_clock::time_point start) {
+  const auto elapsed = mixed_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+// Where the immediate list runs against the queue of the regular list,
+// always on the first compute engine
+enum ImmediatePlacement { SAME_ENGINE, OTHER_COMPUTE_ENGINE, COPY_ENGINE };
+
+const char *placement_name(ImmediatePlacement placement) {
+  switch (placement) {
+  case SAME_ENGINE:
+    return "same compute engine";
+  case OTHER_COMPUTE_ENGINE:
+    return "other compute engine";
+  case COPY_ENGINE:
+    return "copy engine";
+  default:
+    return "unknown";
+  }
+}
+
+const size_t buffer_size = 4096;
+const uint32_t batch = 16;
+const int rounds = 200;
+
+// Host time of the submissions and of the final wait of a run, in us
+struct MixedRun {
+  double total_us = 0;
+  double execute_us = 0;
+  double append_us = 0;
+  double sync_us = 0;
+};
+
+// Throughput of a runtime running both submission models at once:
+// rounds of a regular list of batch small operations executed on a
+// queue, interleaved with batch appends of the same operations to an
+// immediate list, against each model running alone. The operations
+// are add_one launches on compute engines and copies on the copy engine.
+// The stalls are the host time the interleaving adds to the executions
+// and appends, and the overlap is how much of the shorter model ran in
+// the shadow of the longer one: 1 when the interleaved run takes as long
+// as the longer model alone, 0 when it takes as long as both in turn.
+// The parameter is where the immediate list runs.
+class zeMixedCMDListsPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<ImmediatePlacement> {
+protected:
+  // Appends batch operations to list, launches when kernel, else copies
+  void append_batch(ze_command_list_handle_t list, bool kernel_ops,
+                    void *buffer, void *copy_buffer) {
+    const ze_group_count_t dispatch = {buffer_size / 8, 1, 1};
+    for (uint32_t i = 0; i < batch; i++) {
+      if (kernel_ops) {
+        lzt::set_argument_value(kernel, 0, sizeof(buffer), &buffer);
+        lzt::append_launch_function(list, kernel, &dispatch, nullptr, 0,
+                                    nullptr);
+      } else {
+        lzt::append_memory_copy(list, copy_buffer, buffer, buffer_size);
+      }
+    }
+  }
+
+  // rounds of the regular list, of batches appended to the immediate
+  // list, or of both interleaved
+  MixedRun run(bool regular, bool immediate, bool kernel_ops) {
+    MixedRun result;
+    const auto start = mixed_clock::now();
+    for (int r = 0; r < rounds; r++) {
+      if (regular) {
+        const auto execute_start = mixed_clock::now();
+        lzt::execute_command_lists(cq, 1, &regular_list, nullptr);
+        result.execute_us += elapsed_us(execute_start);
+      }
+      if (immediate) {
+        const auto append_start = mixed_clock::now();
+        append_batch(immediate_list, kernel_ops, immediate_buffer,
+                     copy_buffer);
+        result.append_us += elapsed_us(append_start);
+      }
+    }
+    const auto sync_start = mixed_clock::now();
+    if (regular) {
+      lzt::synchronize(cq, UINT64_MAX);
+    }
+    if (immediate) {
+      lzt::synchronize_command_list_host(immediate_list, UINT64_MAX);
+    }
+    result.sync_us = elapsed_us(sync_start);
+    result.total_us = elapsed_us(start);
+    return result;
+  }
+
+  ze_kernel_handle_t kernel = nullptr;
+  ze_command_queue_handle_t cq = nullptr;
+  ze_command_list_handle_t regular_list = nullptr;
+  ze_command_list_handle_t immediate_list = nullptr;
+  void *immediate_buffer = nullptr;
+  void *copy_buffer = nullptr;
+};
+
+TEST_P(
+    zeMixedCMDListsPerformanceTests,
+    GivenRegularAndImmediateCMDListsWhenInterleavingSubmissionsThenReportThroughputAndStalls) {
+  const auto placement = GetParam();
+  auto context = lzt::get_default_context();
+  auto device = lzt::get_default_device(lzt::get_default_driver());
+
+  // Ordinal and index of all physical engines
+  std::vector<std::pair<uint32_t, uint32_t>> compute_engines, copy_engines;
+  const auto cq_group_properties =
+      lzt::get_command_queue_group_properties(device);
+  for (uint32_t i = 0; i < cq_group_properties.size(); i++) {
+    if (cq_group_properties[i].flags &
+        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      for (uint32_t j = 0; j < cq_group_properties[i].numQueues; j++) {
+        compute_engines.emplace_back(i, j);
+      }
+    } else if (cq_group_properties[i].flags &
+               ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY) {
+      for (uint32_t j = 0; j < cq_group_properties[i].numQueues; j++) {
+        copy_engines.emplace_back(i, j);
+      }
+    }
+  }
+  ASSERT_FALSE(compute_engines.empty());
+  std::pair<uint32_t, uint32_t> immediate_engine = compute_engines[0];
+  if (placement == OTHER_COMPUTE_ENGINE) {
+    if (compute_engines.size() < 2) {
+      GTEST_SKIP() << "Device has a single compute engine";
+    }
+    immediate_engine = compute_engines[1];
+  } else if (placement == COPY_ENGINE) {
+    if (copy_engines.empty()) {
+      GTEST_SKIP() << "Device has no copy engine";
+    }
+    immediate_engine = copy_engines[0];
+  }
+  const bool kernel_ops = placement != COPY_ENGINE;
+
+  auto module = lzt::create_module(device, "cmdlist_verify.spv");
+  kernel = lzt::create_function(module, "add_one");
+  lzt::set_group_size(kernel, 8, 1, 1);
+
+  cq = lzt::create_command_queue(
+      context, device, ZE_COMMAND_QUEUE_FLAG_EXPLICIT_ONLY,
+      ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS, ZE_COMMAND_QUEUE_PRIORITY_NORMAL,
+      compute_engines[0].first, compute_engines[0].second);
+  regular_list = lzt::create_command_list(context, device, 0,
+                                          compute_engines[0].first);
+  immediate_list = lzt::create_immediate_command_list(
+      context, device, ZE_COMMAND_QUEUE_FLAG_EXPLICIT_ONLY,
+      ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS, ZE_COMMAND_QUEUE_PRIORITY_NORMAL,
+      immediate_engine.first, immediate_engine.second);
+
+  auto regular_buffer = lzt::allocate_device_memory(buffer_size);
+  immediate_buffer = lzt::allocate_device_memory(buffer_size);
+  copy_buffer = lzt::allocate_device_memory(buffer_size);
+  append_batch(regular_list, true, regular_buffer, nullptr);
+  lzt::close_command_list(regular_list);
+
+  // Warm up both models before timing them
+  run(true, true, kernel_ops);
+  const MixedRun regular = run(true, false, kernel_ops);
+  const MixedRun immediate = run(false, true, kernel_ops);
+  const MixedRun mixed = run(true, true, kernel_ops);
+
+  const double operations = 2.0 * rounds * batch;
+  const double serialized_us = regular.total_us + immediate.total_us;
+  const double overlapped_us = std::max(regular.total_us, immediate.total_us);
+  const double overlap =
+      (serialized_us - mixed.total_us) / (serialized_us - overlapped_us);
+
+  LOG_INFO << "Immediate list on the " << placement_name(placement) << ", "
+           << rounds << " rounds of " << batch << " "
+           << (kernel_ops ? "launches" : "copies") << " per model";
+  LOG_INFO << "  regular alone: " << rounds * batch / regular.total_us
+           << " ops/us, execute " << regular.execute_us / rounds
+           << " us per batch";
+  LOG_INFO << "  immediate alone: " << rounds * batch / immediate.total_us
+           << " ops/us, append " << immediate.append_us / rounds
+           << " us per batch";
+  LOG_INFO << "  interleaved: " << operations / mixed.total_us
+           << " ops/us, execute " << mixed.execute_us / rounds
+           << " us and append " << mixed.append_us / rounds
+           << " us per batch, final wait " << mixed.sync_us << " us";
+  LOG_INFO << "  stalls: execute +"
+           << (mixed.execute_us - regular.execute_us) / rounds
+           << " us and append +"
+           << (mixed.append_us - immediate.append_us) / rounds
+           << " us per batch, overlap " << overlap;
+
+  lzt::free_memory(copy_buffer);
+  lzt::free_memory(immediate_buffer);
+  lzt::free_memory(regular_buffer);
+  lzt::destroy_command_list(immediate_list);
+  lzt::destroy_command_list(regular_list);
+  lzt::destroy_command_queue(cq);
+  lzt::destroy_function(kernel);
+  lzt::destroy_module(module);
+}
+
+INSTANTIATE_TEST_SUITE_P(MixedCMDListsThroughput,
+                         zeMixedCMDListsPerformanceTests,
+                         ::testing::Values(SAME_ENGINE, OTHER_COMPUTE_ENGINE,
+                                           COPY_ENGINE));
+
+} // namespace
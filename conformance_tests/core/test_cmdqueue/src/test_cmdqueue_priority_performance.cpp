@@ -0,0 +1,210 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+std::string priority_name(ze_command_queue_priority_t priority) {
+  switch (priority) {
+  case ZE_COMMAND_QUEUE_PRIORITY_PRIORITY_LOW:
+    return "low";
+  case ZE_COMMAND_QUEUE_PRIORITY_PRIORITY_HIGH:
+    return "high";
+  default:
+    return "normal";
+  }
+}
+
+// A long run of memory fills on a low priority queue keeps the compute
+// engine busy, while short fills are submitted one at a time on a probe
+// queue.  The start and completion of every probe are measured from the
+// device timestamp taken just before its submission, and only probes
+// completing before the background work are counted as under load.  The
+// probe queue is warmed up before the background work starts.
+class CommandQueuePriorityPerformanceTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::tuple<ze_command_queue_priority_t, ze_command_queue_mode_t>> {
+protected:
+  struct ProbeLatencies {
+    std::vector<double> start_ns;
+    std::vector<double> complete_ns;
+  };
+
+  // Runs the probes, with the background work when background is set, and
+  // returns the latencies of the probes that completed while it still ran
+  ProbeLatencies run_probes(bool background) {
+    const ze_device_handle_t device =
+        lzt::zeDevice::get_instance()->get_device();
+    const ze_context_handle_t context = lzt::get_default_context();
+    const auto priority = std::get<0>(GetParam());
+    const auto mode = std::get<1>(GetParam());
+    const auto clock = lzt::get_timestamp_clock(device);
+
+    auto ep = lzt::create_event_pool(context, probe_count + 1,
+                                     ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP |
+                                         ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+    ze_event_desc_t event_desc = {};
+    event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+    event_desc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+    event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+    std::vector<ze_event_handle_t> probe_events;
+    for (uint32_t i = 0; i < probe_count; i++) {
+      event_desc.index = i;
+      probe_events.push_back(lzt::create_event(ep, event_desc));
+    }
+    event_desc.index = probe_count;
+    auto background_event = lzt::create_event(ep, event_desc);
+
+    auto background_queue = lzt::create_command_queue(
+        device, static_cast<ze_command_queue_flag_t>(0),
+        ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+        ZE_COMMAND_QUEUE_PRIORITY_PRIORITY_LOW, 0);
+    auto background_list = lzt::create_command_list(device);
+    auto background_buffer =
+        lzt::allocate_device_memory(background_size, 1, 0, 0, device, context);
+    const uint8_t background_value = 0x22;
+    for (uint32_t i = 0; i < background_fills - 1; i++) {
+      lzt::append_memory_set(background_list, background_buffer,
+                             &background_value, background_size);
+      lzt::append_barrier(background_list);
+    }
+    lzt::append_memory_set(background_list, background_buffer,
+                           &background_value, background_size,
+                           background_event);
+    lzt::close_command_list(background_list);
+
+    auto probe_queue = lzt::create_command_queue(
+        device, static_cast<ze_command_queue_flag_t>(0), mode, priority, 0);
+    auto probe_list = lzt::create_command_list(device);
+    auto probe_buffer = lzt::allocate_shared_memory(probe_size);
+    const uint8_t probe_value = 0x55;
+
+    for (int i = 0; i < lzt::warm_up_iterations; i++) {
+      lzt::reset_command_list(probe_list);
+      lzt::append_memory_set(probe_list, probe_buffer, &probe_value,
+                             probe_size);
+      lzt::close_command_list(probe_list);
+      lzt::execute_command_lists(probe_queue, 1, &probe_list, nullptr);
+      lzt::synchronize(probe_queue, UINT64_MAX);
+    }
+    if (background) {
+      lzt::execute_command_lists(background_queue, 1, &background_list,
+                                 nullptr);
+    }
+    std::vector<uint64_t> submit_timestamps;
+    for (uint32_t i = 0; i < probe_count; i++) {
+      lzt::reset_command_list(probe_list);
+      lzt::append_memory_set(probe_list, probe_buffer, &probe_value,
+                             probe_size, probe_events[i]);
+      lzt::close_command_list(probe_list);
+      submit_timestamps.push_back(
+          std::get<1>(lzt::get_global_timestamps(device)));
+      lzt::execute_command_lists(probe_queue, 1, &probe_list, nullptr);
+      lzt::synchronize(probe_queue, UINT64_MAX);
+    }
+    if (background) {
+      lzt::synchronize(background_queue, UINT64_MAX);
+    }
+
+    const uint8_t *probe_bytes = static_cast<uint8_t *>(probe_buffer);
+    for (size_t i = 0; i < probe_size; i++) {
+      EXPECT_EQ(probe_value, probe_bytes[i]);
+    }
+
+    ProbeLatencies latencies;
+    const auto background_timestamp =
+        background ? lzt::get_event_kernel_timestamp(background_event)
+                   : ze_kernel_timestamp_result_t{};
+    for (uint32_t i = 0; i < probe_count; i++) {
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventQueryStatus(probe_events[i]));
+      const auto timestamp = lzt::get_event_kernel_timestamp(probe_events[i]);
+      if (background &&
+          clock.signed_ticks(timestamp.global.kernelEnd,
+                             background_timestamp.global.kernelEnd) <= 0) {
+        continue;
+      }
+      latencies.start_ns.push_back(
+          clock.signed_ticks(submit_timestamps[i],
+                             timestamp.global.kernelStart) *
+          clock.ns_per_tick);
+      latencies.complete_ns.push_back(
+          clock.signed_ticks(submit_timestamps[i], timestamp.global.kernelEnd) *
+          clock.ns_per_tick);
+    }
+
+    lzt::free_memory(probe_buffer);
+    lzt::destroy_command_list(probe_list);
+    lzt::destroy_command_queue(probe_queue);
+    lzt::free_memory(context, background_buffer);
+    lzt::destroy_command_list(background_list);
+    lzt::destroy_command_queue(background_queue);
+    lzt::destroy_event(background_event);
+    for (auto event : probe_events) {
+      lzt::destroy_event(event);
+    }
+    lzt::destroy_event_pool(ep);
+    return latencies;
+  }
+
+  const uint32_t probe_count = 32;
+  const size_t probe_size = 4096;
+  const uint32_t background_fills = 64;
+  const size_t background_size = 256 * 1024 * 1024;
+};
+
+TEST_P(
+    CommandQueuePriorityPerformanceTest,
+    GivenLowPriorityBackgroundWorkWhenSubmittingShortWorkOnProbeQueueThenReportStartAndCompletionLatency) {
+  const auto priority = std::get<0>(GetParam());
+  const auto mode = std::get<1>(GetParam());
+  const auto idle = run_probes(false);
+  const auto loaded = run_probes(true);
+
+  const std::string name =
+      priority_name(priority) + " priority " +
+      ((mode == ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS) ? "synchronous"
+                                                   : "asynchronous");
+  LOG_INFO << name << " probe, idle device: start p50 "
+           << lzt::median(idle.start_ns) << " ns p99 "
+           << lzt::percentile(idle.start_ns, 99) << " ns, complete p50 "
+           << lzt::median(idle.complete_ns) << " ns p99 "
+           << lzt::percentile(idle.complete_ns, 99) << " ns";
+  if (loaded.start_ns.empty()) {
+    LOG_WARNING << name
+                << " probe: background work completed before any probe, "
+                   "no latency under load";
+    return;
+  }
+  LOG_INFO << name << " probe, " << loaded.start_ns.size() << " of "
+           << probe_count << " under low priority load: start p50 "
+           << lzt::median(loaded.start_ns) << " ns p99 "
+           << lzt::percentile(loaded.start_ns, 99) << " ns, complete p50 "
+           << lzt::median(loaded.complete_ns) << " ns p99 "
+           << lzt::percentile(loaded.complete_ns, 99) << " ns";
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TestQueuePriorityLatency, CommandQueuePriorityPerformanceTest,
+    ::testing::Combine(
+        ::testing::Values(ZE_COMMAND_QUEUE_PRIORITY_PRIORITY_LOW,
+                          ZE_COMMAND_QUEUE_PRIORITY_NORMAL,
+                          ZE_COMMAND_QUEUE_PRIORITY_PRIORITY_HIGH),
+        ::testing::Values(ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                          ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS)));
+
+} // namespace
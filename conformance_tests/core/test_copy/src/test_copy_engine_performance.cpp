@@ -0,0 +1,261 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+enum CopyType {
+  CT_HOST_TO_DEVICE,
+  CT_DEVICE_TO_HOST,
+  CT_DEVICE_TO_DEVICE,
+  CT_REGION,
+  CT_FILL,
+  CT_IMAGE_FROM_MEMORY
+};
+
+std::string copy_type_name(CopyType type) {
+  switch (type) {
+  case CT_HOST_TO_DEVICE:
+    return "host to device";
+  case CT_DEVICE_TO_HOST:
+    return "device to host";
+  case CT_DEVICE_TO_DEVICE:
+    return "device to device";
+  case CT_REGION:
+    return "region";
+  case CT_FILL:
+    return "fill";
+  case CT_IMAGE_FROM_MEMORY:
+    return "image from memory";
+  }
+  return "unknown";
+}
+
+const std::vector<size_t> copy_sizes = {4 * 1024, 64 * 1024, 1024 * 1024,
+                                        16 * 1024 * 1024, 256 * 1024 * 1024};
+
+// Rows of the regions and images the buffers are copied as
+const uint32_t row_pitch = 4096;
+
+// Runs every copy type at every size on index 0 of every command queue
+// group of the device and reports the bandwidth from the kernel timestamps
+// of the copies, one line per engine, copy type and size.  Copy-only groups
+// are named main copy for the first and link copy for the others.
+class zeCopyEnginePerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<CopyType> {
+protected:
+  void SetUp() override {
+    context_ = lzt::get_default_context();
+    device_ = lzt::zeDevice::get_instance()->get_device();
+    if (GetParam() == CT_IMAGE_FROM_MEMORY && !lzt::image_support()) {
+      GTEST_SKIP() << "Device does not support images";
+    }
+  }
+
+  // Returns the median time in ns of the copy, or a negative value when
+  // the engine does not support it
+  double time_copy(uint32_t ordinal, CopyType type, size_t size) {
+    auto bundle =
+        lzt::create_command_bundle(context_, device_, 0, ordinal, false);
+    auto ep = lzt::create_event_pool(context_, iterations_,
+                                     ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP |
+                                         ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+    std::vector<ze_event_handle_t> events(iterations_);
+    for (uint32_t i = 0; i < iterations_; i++) {
+      ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                    ZE_EVENT_SCOPE_FLAG_HOST,
+                                    ZE_EVENT_SCOPE_FLAG_HOST};
+      events[i] = lzt::create_event(ep, event_desc);
+    }
+
+    auto reference =
+        static_cast<uint8_t *>(lzt::allocate_host_memory(size, 1, context_));
+    auto readback =
+        static_cast<uint8_t *>(lzt::allocate_host_memory(size, 1, context_));
+    const uint8_t fill_value = 0x5a;
+    for (size_t i = 0; i < size; i++) {
+      reference[i] = (type == CT_FILL) ? fill_value : (i * 13 + 7) & 0xff;
+    }
+    memset(readback, 0, size);
+
+    const bool device_source = (type == CT_DEVICE_TO_HOST ||
+                                type == CT_DEVICE_TO_DEVICE ||
+                                type == CT_REGION);
+    void *source = device_source ? lzt::allocate_device_memory(
+                                       size, 1, 0, 0, device_, context_)
+                                 : reference;
+    void *destination = nullptr;
+    ze_image_handle_t image = nullptr;
+    if (type == CT_DEVICE_TO_HOST) {
+      destination = lzt::allocate_host_memory(size, 1, context_);
+    } else if (type == CT_IMAGE_FROM_MEMORY) {
+      ze_image_desc_t image_desc = {};
+      image_desc.stype = ZE_STRUCTURE_TYPE_IMAGE_DESC;
+      image_desc.type = ZE_IMAGE_TYPE_2D;
+      image_desc.format = {
+          ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8, ZE_IMAGE_FORMAT_TYPE_UINT,
+          ZE_IMAGE_FORMAT_SWIZZLE_R,      ZE_IMAGE_FORMAT_SWIZZLE_G,
+          ZE_IMAGE_FORMAT_SWIZZLE_B,      ZE_IMAGE_FORMAT_SWIZZLE_A};
+      image_desc.width = row_pitch / 4;
+      image_desc.height = static_cast<uint32_t>(size / row_pitch);
+      image_desc.depth = 1;
+      image = lzt::create_ze_image(context_, device_, image_desc);
+    } else {
+      destination =
+          lzt::allocate_device_memory(size, 1, 0, 0, device_, context_);
+    }
+
+    const uint32_t rows = static_cast<uint32_t>(size / row_pitch);
+    const ze_copy_region_t region = {0, 0, 0, row_pitch, rows, 1};
+    // Appends the copy measured, returning false when unsupported
+    auto append_copy = [&](ze_event_handle_t event) {
+      ze_result_t result = ZE_RESULT_SUCCESS;
+      switch (type) {
+      case CT_HOST_TO_DEVICE:
+      case CT_DEVICE_TO_HOST:
+      case CT_DEVICE_TO_DEVICE:
+        result = zeCommandListAppendMemoryCopy(bundle.list, destination,
+                                               source, size, event, 0, nullptr);
+        break;
+      case CT_REGION:
+        result = zeCommandListAppendMemoryCopyRegion(
+            bundle.list, destination, &region, row_pitch, 0, source, &region,
+            row_pitch, 0, event, 0, nullptr);
+        break;
+      case CT_FILL:
+        result = zeCommandListAppendMemoryFill(bundle.list, destination,
+                                               &fill_value, sizeof(fill_value),
+                                               size, event, 0, nullptr);
+        break;
+      case CT_IMAGE_FROM_MEMORY:
+        result = zeCommandListAppendImageCopyFromMemory(
+            bundle.list, image, source, nullptr, event, 0, nullptr);
+        break;
+      }
+      if (result == ZE_RESULT_ERROR_UNSUPPORTED_FEATURE) {
+        return false;
+      }
+      EXPECT_EQ(ZE_RESULT_SUCCESS, result);
+      return true;
+    };
+
+    if (device_source) {
+      lzt::append_memory_copy(bundle.list, source, reference, size);
+      lzt::append_barrier(bundle.list);
+    }
+    // The first copy warms up the engine and the pages, and is not timed
+    bool supported = append_copy(nullptr);
+    if (supported) {
+      for (uint32_t i = 0; i < iterations_; i++) {
+        lzt::append_barrier(bundle.list);
+        append_copy(events[i]);
+      }
+      lzt::append_barrier(bundle.list);
+      if (image) {
+        lzt::append_image_copy_to_mem(bundle.list, readback, image, nullptr);
+      } else {
+        lzt::append_memory_copy(bundle.list, readback, destination, size);
+      }
+      lzt::close_command_list(bundle.list);
+      lzt::execute_and_sync_command_bundle(bundle, UINT64_MAX);
+      EXPECT_EQ(0, memcmp(reference, readback, size));
+    }
+
+    std::vector<double> times;
+    if (supported) {
+      const auto clock = lzt::get_timestamp_clock(device_);
+      for (auto event : events) {
+        times.push_back(
+            clock.duration_ns(lzt::get_event_kernel_timestamp(event).global));
+      }
+    }
+
+    if (image) {
+      lzt::destroy_ze_image(image);
+    }
+    if (destination) {
+      lzt::free_memory(context_, destination);
+    }
+    if (device_source) {
+      lzt::free_memory(context_, source);
+    }
+    lzt::free_memory(context_, readback);
+    lzt::free_memory(context_, reference);
+    for (auto event : events) {
+      lzt::destroy_event(event);
+    }
+    lzt::destroy_event_pool(ep);
+    lzt::destroy_command_bundle(bundle);
+    return supported ? lzt::median(times) : -1;
+  }
+
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+  const uint32_t iterations_ = 10;
+};
+
+TEST_P(
+    zeCopyEnginePerformanceTests,
+    GivenEveryCommandQueueGroupWhenCopyingBuffersOfIncreasingSizeThenReportBandwidthPerEngine) {
+  const CopyType type = GetParam();
+  const auto groups = lzt::get_command_queue_group_properties(device_);
+  const auto device_properties = lzt::get_device_properties(device_);
+  const auto image_properties = lzt::get_image_properties(device_);
+
+  bool main_copy_found = false;
+  for (uint32_t ordinal = 0; ordinal < groups.size(); ordinal++) {
+    std::string engine;
+    if (groups[ordinal].flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      engine = "compute";
+    } else if (groups[ordinal].flags &
+               ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY) {
+      engine = main_copy_found ? "link copy" : "main copy";
+      main_copy_found = true;
+    } else {
+      continue;
+    }
+
+    for (auto size : copy_sizes) {
+      if (size > device_properties.maxMemAllocSize / 2 ||
+          (type == CT_IMAGE_FROM_MEMORY &&
+           size / row_pitch > image_properties.maxImageDims2D)) {
+        continue;
+      }
+      const double ns = time_copy(ordinal, type, size);
+      if (ns < 0) {
+        LOG_INFO << "ordinal " << ordinal << " (" << engine << "), "
+                 << copy_type_name(type) << ": not supported";
+        break;
+      }
+      LOG_INFO << "ordinal " << ordinal << " (" << engine << "), "
+               << copy_type_name(type) << ", " << size
+               << " bytes: " << size / ns << " GB/s, " << ns << " ns";
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(TestCopyEnginePerformance,
+                         zeCopyEnginePerformanceTests,
+                         ::testing::Values(CT_HOST_TO_DEVICE,
+                                           CT_DEVICE_TO_HOST,
+                                           CT_DEVICE_TO_DEVICE, CT_REGION,
+                                           CT_FILL, CT_IMAGE_FROM_MEMORY));
+
+} // namespace
@@ -0,0 +1,213 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock query_clock;
+
+struct DeviceQuery {
+  const char *name;
+  std::function<ze_result_t()> call;
+};
+
+// The queries a framework may issue per operation, each filling the same
+// structures every call
+std::vector<DeviceQuery> device_queries(ze_device_handle_t device,
+                                        ze_device_handle_t peer) {
+  auto properties = std::make_shared<ze_device_properties_t>();
+  auto compute = std::make_shared<ze_device_compute_properties_t>();
+  auto memory = std::make_shared<std::vector<ze_device_memory_properties_t>>(
+      16, ze_device_memory_properties_t{
+              ZE_STRUCTURE_TYPE_DEVICE_MEMORY_PROPERTIES, nullptr});
+  auto access = std::make_shared<ze_device_memory_access_properties_t>();
+  auto cache = std::make_shared<std::vector<ze_device_cache_properties_t>>(
+      16, ze_device_cache_properties_t{
+              ZE_STRUCTURE_TYPE_DEVICE_CACHE_PROPERTIES, nullptr});
+  auto image = std::make_shared<ze_device_image_properties_t>();
+  auto module = std::make_shared<ze_device_module_properties_t>();
+  auto groups =
+      std::make_shared<std::vector<ze_command_queue_group_properties_t>>(
+          16, ze_command_queue_group_properties_t{
+                  ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES, nullptr});
+  auto external = std::make_shared<ze_device_external_memory_properties_t>();
+  auto p2p = std::make_shared<ze_device_p2p_properties_t>();
+  properties->stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  compute->stype = ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES;
+  access->stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_ACCESS_PROPERTIES;
+  image->stype = ZE_STRUCTURE_TYPE_DEVICE_IMAGE_PROPERTIES;
+  module->stype = ZE_STRUCTURE_TYPE_DEVICE_MODULE_PROPERTIES;
+  external->stype = ZE_STRUCTURE_TYPE_DEVICE_EXTERNAL_MEMORY_PROPERTIES;
+  p2p->stype = ZE_STRUCTURE_TYPE_DEVICE_P2P_PROPERTIES;
+
+  return {
+      {"zeDeviceGetProperties",
+       [=]() { return zeDeviceGetProperties(device, properties.get()); }},
+      {"zeDeviceGetComputeProperties",
+       [=]() { return zeDeviceGetComputeProperties(device, compute.get()); }},
+      {"zeDeviceGetMemoryProperties",
+       [=]() {
+         uint32_t count = 0;
+         auto result = zeDeviceGetMemoryProperties(device, &count, nullptr);
+         count = std::min(count, static_cast<uint32_t>(memory->size()));
+         return result ? result
+                       : zeDeviceGetMemoryProperties(device, &count,
+                                                     memory->data());
+       }},
+      {"zeDeviceGetMemoryAccessProperties",
+       [=]() {
+         return zeDeviceGetMemoryAccessProperties(device, access.get());
+       }},
+      {"zeDeviceGetCacheProperties",
+       [=]() {
+         uint32_t count = 0;
+         auto result = zeDeviceGetCacheProperties(device, &count, nullptr);
+         count = std::min(count, static_cast<uint32_t>(cache->size()));
+         return result ? result
+                       : zeDeviceGetCacheProperties(device, &count,
+                                                    cache->data());
+       }},
+      {"zeDeviceGetImageProperties",
+       [=]() { return zeDeviceGetImageProperties(device, image.get()); }},
+      {"zeDeviceGetModuleProperties",
+       [=]() { return zeDeviceGetModuleProperties(device, module.get()); }},
+      {"zeDeviceGetCommandQueueGroupProperties",
+       [=]() {
+         uint32_t count = 0;
+         auto result =
+             zeDeviceGetCommandQueueGroupProperties(device, &count, nullptr);
+         count = std::min(count, static_cast<uint32_t>(groups->size()));
+         return result ? result
+                       : zeDeviceGetCommandQueueGroupProperties(
+                             device, &count, groups->data());
+       }},
+      {"zeDeviceGetExternalMemoryProperties",
+       [=]() {
+         return zeDeviceGetExternalMemoryProperties(device, external.get());
+       }},
+      {"zeDeviceGetP2PProperties",
+       [=]() { return zeDeviceGetP2PProperties(device, peer, p2p.get()); }},
+      {"zeDeviceCanAccessPeer",
+       [=]() {
+         ze_bool_t can_access = false;
+         return zeDeviceCanAccessPeer(device, peer, &can_access);
+       }},
+      {"zeDeviceGetSubDevices count",
+       [=]() {
+         uint32_t count = 0;
+         return zeDeviceGetSubDevices(device, &count, nullptr);
+       }},
+      {"zeDeviceGetStatus", [=]() { return zeDeviceGetStatus(device); }},
+      {"zeDeviceGetGlobalTimestamps", [=]() {
+         uint64_t host_timestamp = 0, device_timestamp = 0;
+         return zeDeviceGetGlobalTimestamps(device, &host_timestamp,
+                                            &device_timestamp);
+       }}};
+}
+
+// Latency in ns of every call of query, one after the other
+std::vector<double> time_calls(const DeviceQuery &query, int calls) {
+  std::vector<double> latencies;
+  latencies.reserve(calls);
+  for (int i = 0; i < calls; i++) {
+    const auto start = query_clock::now();
+    const ze_result_t result = query.call();
+    latencies.push_back(
+        std::chrono::duration<double, std::nano>(query_clock::now() - start)
+            .count());
+    EXPECT_EQ(ZE_RESULT_SUCCESS, result) << query.name;
+  }
+  return latencies;
+}
+
+// Mean latency in ns of calls of query made by every one of threads
+// threads at once
+double time_concurrent_calls(const DeviceQuery &query, int calls,
+                             int threads) {
+  std::atomic<int> ready(0);
+  std::atomic<bool> go(false);
+  std::vector<double> thread_ns(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t]() {
+      ready++;
+      while (!go) {
+        std::this_thread::yield();
+      }
+      const auto start = query_clock::now();
+      for (int i = 0; i < calls; i++) {
+        query.call();
+      }
+      thread_ns[t] =
+          std::chrono::duration<double, std::nano>(query_clock::now() - start)
+              .count();
+    });
+  }
+  while (ready < threads) {
+    std::this_thread::yield();
+  }
+  go = true;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  double total_ns = 0;
+  for (auto ns : thread_ns) {
+    total_ns += ns;
+  }
+  return total_ns / threads / calls;
+}
+
+// Host cost of the device queries, alone and from several threads at
+// once, to tell which of them a runtime has to cache and which are cheap
+// enough to call on the hot path. A query is flagged for caching when a
+// call takes over a microsecond, or when concurrent calls take over twice
+// as long as single ones, which points at a lock in the driver.
+TEST(
+    zeDeviceQueryPerformanceTests,
+    GivenDeviceWhenRepeatedlyQueryingPropertiesThenReportSingleAndMultiThreadedLatency) {
+  auto driver = lzt::get_default_driver();
+  auto devices = lzt::get_ze_devices(driver);
+  auto device = devices.front();
+  auto peer = devices.back();
+  const int calls = 10000;
+  const int threads = static_cast<int>(
+      std::min(8u, std::max(2u, std::thread::hardware_concurrency())));
+
+  LOG_INFO << "query: single-threaded p50 / p99 ns, " << threads
+           << " threads mean ns, guidance";
+  for (auto &query : device_queries(device, peer)) {
+    // Warm up whatever the driver caches on the first call
+    EXPECT_EQ(ZE_RESULT_SUCCESS, query.call()) << query.name;
+    const auto latencies = time_calls(query, calls);
+    const double p50 = lzt::median(latencies);
+    const double p99 = lzt::percentile(latencies, 99);
+    const double concurrent = time_concurrent_calls(query, calls, threads);
+    const bool cache = p50 > 1000 || concurrent > 2 * p50;
+    LOG_INFO << query.name << ": " << p50 << " / " << p99 << ", "
+             << concurrent << ", "
+             << (cache ? "cache" : "cheap enough for the hot path");
+  }
+}
+
+} // namespace
@@ -0,0 +1,313 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock profiling_clock;
+
+uint64_t gcd(uint64_t a, uint64_t b) {
+  while (b != 0) {
+    const uint64_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+const uint32_t launches = 1000;
+const int iterations = 20;
+
+// Cost of always-on kernel timing: lists of launches tiny kernels, each
+// of a single work-group, launched with no event, with a plain event or
+// with a kernel timestamp event apiece, as a runtime timing every kernel
+// it submits would.
+class zeEventProfilingPerformanceTests : public ::testing::Test {
+protected:
+  void SetUp() override {
+    context = lzt::get_default_context();
+    device = lzt::zeDevice::get_instance()->get_device();
+    module = lzt::create_module(context, device, "profile_add.spv",
+                                ZE_MODULE_FORMAT_IL_SPIRV, nullptr, nullptr);
+    kernel = lzt::create_function(module, "profile_add_constant");
+    lzt::set_group_size(kernel, elements, 1, 1);
+    const size_t size = elements * sizeof(int);
+    values_in = lzt::allocate_device_memory(size, 64, 0, 0, device, context);
+    values_out = lzt::allocate_device_memory(size, 64, 0, 0, device, context);
+    const int addval = 1;
+    lzt::set_argument_value(kernel, 0, sizeof(values_in), &values_in);
+    lzt::set_argument_value(kernel, 1, sizeof(values_out), &values_out);
+    lzt::set_argument_value(kernel, 2, sizeof(addval), &addval);
+    cmd_bundle = lzt::create_command_bundle(context, device, false);
+  }
+
+  void TearDown() override {
+    lzt::destroy_command_bundle(cmd_bundle);
+    lzt::free_memory(context, values_out);
+    lzt::free_memory(context, values_in);
+    lzt::destroy_function(kernel);
+    lzt::destroy_module(module);
+  }
+
+  // One event of pool per launch
+  std::vector<ze_event_handle_t> create_events(ze_event_pool_handle_t pool) {
+    std::vector<ze_event_handle_t> events;
+    for (uint32_t i = 0; i < launches; i++) {
+      ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                    ZE_EVENT_SCOPE_FLAG_HOST,
+                                    ZE_EVENT_SCOPE_FLAG_HOST};
+      events.push_back(lzt::create_event(pool, event_desc));
+    }
+    return events;
+  }
+
+  void destroy_events(std::vector<ze_event_handle_t> &events) {
+    for (auto event : events) {
+      lzt::destroy_event(event);
+    }
+    events.clear();
+  }
+
+  // Records the launches, each signaling its event when events are given
+  void record_launches(const std::vector<ze_event_handle_t> &events) {
+    ze_group_count_t group_count = {1, 1, 1};
+    lzt::reset_command_list(cmd_bundle.list);
+    for (uint32_t i = 0; i < launches; i++) {
+      lzt::append_launch_function(cmd_bundle.list, kernel, &group_count,
+                                  events.empty() ? nullptr : events[i], 0,
+                                  nullptr);
+    }
+    lzt::close_command_list(cmd_bundle.list);
+  }
+
+  // Host time in us per launch, submission to completion, of the
+  // recorded launches, resetting the events between executions
+  double time_launches(const std::vector<ze_event_handle_t> &events) {
+    std::vector<double> launch_us;
+    for (int i = 0; i < lzt::warm_up_iterations + iterations; i++) {
+      for (auto event : events) {
+        lzt::event_host_reset(event);
+      }
+      const auto start = profiling_clock::now();
+      lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+      const auto elapsed = profiling_clock::now() - start;
+      if (i >= lzt::warm_up_iterations) {
+        launch_us.push_back(
+            std::chrono::duration<double, std::micro>(elapsed).count() /
+            launches);
+      }
+    }
+    return lzt::median(launch_us);
+  }
+
+  const uint32_t elements = 64;
+  ze_context_handle_t context = nullptr;
+  ze_device_handle_t device = nullptr;
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t kernel = nullptr;
+  void *values_in = nullptr;
+  void *values_out = nullptr;
+  lzt::zeCommandBundle cmd_bundle = {};
+};
+
+TEST_F(
+    zeEventProfilingPerformanceTests,
+    GivenTinyKernelsWhenLaunchedWithTimestampEventsThenReportOverheadAgainstNoEventAndPlainEvents) {
+  auto plain_pool = lzt::create_event_pool(context, launches,
+                                           ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  auto timestamp_pool = lzt::create_event_pool(
+      context, launches,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  auto plain_events = create_events(plain_pool);
+  auto timestamp_events = create_events(timestamp_pool);
+
+  record_launches({});
+  const double no_event_us = time_launches({});
+  record_launches(plain_events);
+  const double plain_us = time_launches(plain_events);
+  record_launches(timestamp_events);
+  const double timestamp_us = time_launches(timestamp_events);
+
+  LOG_INFO << launches << " single work-group kernels, per launch p50: "
+           << no_event_us << " us with no event, " << plain_us
+           << " us with an event, " << timestamp_us
+           << " us with a kernel timestamp event";
+  LOG_INFO << "Kernel timestamp events add " << timestamp_us - no_event_us
+           << " us per launch over no event ("
+           << (timestamp_us / no_event_us - 1) * 100 << "%), "
+           << timestamp_us - plain_us << " us over plain events";
+
+  destroy_events(timestamp_events);
+  destroy_events(plain_events);
+  lzt::destroy_event_pool(timestamp_pool);
+  lzt::destroy_event_pool(plain_pool);
+}
+
+// The effective resolution of kernel timestamps against the nominal
+// timerResolution: the greatest common step of the timestamps of many
+// tiny kernels, which a counter ticking in coarser steps than its
+// nominal period shows, the shortest duration measured and how many of
+// the kernels measured as zero ticks.
+TEST_F(
+    zeEventProfilingPerformanceTests,
+    GivenTinyKernelsWithTimestampEventsWhenComparingTimestampsThenReportEffectiveResolution) {
+  auto timestamp_pool = lzt::create_event_pool(
+      context, launches,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  auto events = create_events(timestamp_pool);
+  record_launches(events);
+  lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+
+  const auto clock = lzt::get_timestamp_clock(device);
+  ASSERT_GT(clock.ns_per_tick, 0);
+  const uint64_t origin = lzt::get_event_kernel_timestamp(events[0])
+                              .global.kernelStart;
+  uint64_t step = 0, shortest = UINT64_MAX;
+  uint32_t zero_durations = 0;
+  for (auto event : events) {
+    const auto timestamp = lzt::get_event_kernel_timestamp(event).global;
+    const uint64_t duration =
+        clock.ticks(timestamp.kernelStart, timestamp.kernelEnd);
+    // Kernels of the list may start before the first one
+    const int64_t offset = clock.signed_ticks(origin, timestamp.kernelStart);
+    step = gcd(step, static_cast<uint64_t>(std::abs(offset)));
+    step = gcd(step, duration);
+    if (duration == 0) {
+      zero_durations++;
+    } else {
+      shortest = std::min(shortest, duration);
+    }
+  }
+
+  LOG_INFO << "timerResolution: " << clock.ns_per_tick << " ns per tick";
+  LOG_INFO << "Effective step: " << step << " ticks, "
+           << step * clock.ns_per_tick << " ns";
+  if (shortest != UINT64_MAX) {
+    LOG_INFO << "Shortest nonzero duration of a single work-group kernel: "
+             << shortest << " ticks, " << shortest * clock.ns_per_tick
+             << " ns";
+  }
+  LOG_INFO << zero_durations << " of " << launches
+           << " kernels measured as 0 ticks";
+
+  destroy_events(events);
+  lzt::destroy_event_pool(timestamp_pool);
+}
+
+// Host cost per event of retrieving the timestamps of the launches once
+// they completed: zeEventQueryKernelTimestamp, and with
+// ZE_extension_event_query_kernel_timestamps, zeEventQueryKernelTimestampsExt
+// on kernel timestamp events and on mapped timestamp events, which also
+// return the timestamps synchronized to the host clock. The Ext queries
+// include the call returning the count of timestamps of the event.
+TEST_F(
+    zeEventProfilingPerformanceTests,
+    GivenCompletedTimestampEventsWhenRetrievingTimestampsThenReportCostPerEvent) {
+  auto timestamp_pool = lzt::create_event_pool(
+      context, launches,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  auto events = create_events(timestamp_pool);
+  record_launches(events);
+  lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+
+  std::vector<double> query_ns;
+  for (int i = 0; i < lzt::warm_up_iterations + iterations; i++) {
+    ze_kernel_timestamp_result_t timestamp = {};
+    const auto start = profiling_clock::now();
+    for (auto event : events) {
+      ASSERT_EQ(ZE_RESULT_SUCCESS,
+                zeEventQueryKernelTimestamp(event, &timestamp));
+    }
+    const auto elapsed = profiling_clock::now() - start;
+    if (i >= lzt::warm_up_iterations) {
+      query_ns.push_back(
+          std::chrono::duration<double, std::nano>(elapsed).count() /
+          launches);
+    }
+  }
+  LOG_INFO << "zeEventQueryKernelTimestamp: " << lzt::median(query_ns)
+           << " ns per event";
+
+  if (!lzt::check_if_extension_supported(
+          lzt::get_default_driver(),
+          "ZE_extension_event_query_kernel_timestamps")) {
+    LOG_INFO << "zeEventQueryKernelTimestampsExt skipped for missing "
+                "ZE_extension_event_query_kernel_timestamps";
+    destroy_events(events);
+    lzt::destroy_event_pool(timestamp_pool);
+    return;
+  }
+
+  auto mapped_pool = lzt::create_event_pool(
+      context, launches,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
+          ZE_EVENT_POOL_FLAG_KERNEL_MAPPED_TIMESTAMP);
+  auto mapped_events = create_events(mapped_pool);
+  record_launches(mapped_events);
+  lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+
+  const std::pair<std::vector<ze_event_handle_t> *, const char *> variants[] =
+      {{&events, "kernel timestamp events"},
+       {&mapped_events, "mapped timestamp events"}};
+  for (auto &variant : variants) {
+    const bool mapped = variant.first == &mapped_events;
+    // Room for the timestamps of every sub device
+    std::vector<ze_kernel_timestamp_result_t> kernel_timestamps(64);
+    std::vector<ze_synchronized_timestamp_result_ext_t> synchronized(64);
+    ze_event_query_kernel_timestamps_results_ext_properties_t results = {};
+    results.stype =
+        ZE_STRUCTURE_TYPE_EVENT_QUERY_KERNEL_TIMESTAMPS_RESULTS_EXT_PROPERTIES;
+    results.pKernelTimestampsBuffer = kernel_timestamps.data();
+    results.pSynchronizedTimestampsBuffer =
+        mapped ? synchronized.data() : nullptr;
+
+    query_ns.clear();
+    uint32_t max_count = 0;
+    for (int i = 0; i < lzt::warm_up_iterations + iterations; i++) {
+      const auto start = profiling_clock::now();
+      for (auto event : *variant.first) {
+        uint32_t count = 0;
+        ASSERT_EQ(ZE_RESULT_SUCCESS, zeEventQueryKernelTimestampsExt(
+                                         event, device, &count, nullptr));
+        ASSERT_LE(count, kernel_timestamps.size());
+        ASSERT_EQ(ZE_RESULT_SUCCESS, zeEventQueryKernelTimestampsExt(
+                                         event, device, &count, &results));
+        max_count = std::max(max_count, count);
+      }
+      const auto elapsed = profiling_clock::now() - start;
+      if (i >= lzt::warm_up_iterations) {
+        query_ns.push_back(
+            std::chrono::duration<double, std::nano>(elapsed).count() /
+            launches);
+      }
+    }
+    LOG_INFO << "zeEventQueryKernelTimestampsExt on " << variant.second
+             << ": " << lzt::median(query_ns) << " ns per event, up to "
+             << max_count << " timestamps per event";
+  }
+
+  destroy_events(mapped_events);
+  lzt::destroy_event_pool(mapped_pool);
+  destroy_events(events);
+  lzt::destroy_event_pool(timestamp_pool);
+}
+
+} // namespace
@@ -0,0 +1,160 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <chrono>
+#include <ctime>
+#include <tuple>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "test_harness/test_harness_fence.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock completion_clock;
+
+enum CompletionMethod {
+  FENCE_HOST_SYNCHRONIZE,
+  FENCE_QUERY_POLLING,
+  EVENT_HOST_SYNCHRONIZE,
+  QUEUE_SYNCHRONIZE
+};
+
+const char *completion_method_name(CompletionMethod method) {
+  switch (method) {
+  case FENCE_HOST_SYNCHRONIZE:
+    return "zeFenceHostSynchronize";
+  case FENCE_QUERY_POLLING:
+    return "zeFenceQueryStatus polling";
+  case EVENT_HOST_SYNCHRONIZE:
+    return "zeEventHostSynchronize";
+  case QUEUE_SYNCHRONIZE:
+    return "zeCommandQueueSynchronize";
+  default:
+    return "unknown";
+  }
+}
+
+// Cost of detecting the completion of a submission on the host by each of
+// the ways a completion thread can wait for it. The submission is a fill
+// long enough for the host to be waiting before it ends, and its event
+// timestamps the end on the device. The wakeup latency runs from that end
+// to a device timestamp taken right after the wait returns, so it includes
+// the zeDeviceGetGlobalTimestamps call, the same for every method. The
+// CPU usage is the process CPU time over the wall time of the wait: close
+// to 100% for a spinning waiter and close to 0% for a blocking one. The
+// parameter is the completion method.
+class zeFenceCompletionPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<CompletionMethod> {};
+
+TEST_P(
+    zeFenceCompletionPerformanceTests,
+    GivenSubmissionWhenWaitingForCompletionThenReportWakeupLatencyAndHostCpuUsage) {
+  const auto method = GetParam();
+  auto context = lzt::get_default_context();
+  auto device = lzt::zeDevice::get_instance()->get_device();
+  auto cmd_q = lzt::create_command_queue(context, device, 0,
+                                         ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                                         ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+  auto cmd_list = lzt::create_command_list(context, device, 0);
+  auto fence = lzt::create_fence(cmd_q);
+  auto event_pool = lzt::create_event_pool(
+      context, 1,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                ZE_EVENT_SCOPE_FLAG_HOST,
+                                ZE_EVENT_SCOPE_FLAG_HOST};
+  auto event = lzt::create_event(event_pool, event_desc);
+
+  const size_t size = 64 * 1024 * 1024;
+  auto buffer = lzt::allocate_device_memory(size, 64, 0, 0, device, context);
+  const uint32_t pattern = 0xA5A5A5A5;
+  lzt::append_memory_fill(cmd_list, buffer, &pattern, sizeof(pattern), size,
+                          event);
+  lzt::close_command_list(cmd_list);
+
+  const auto clock = lzt::get_timestamp_clock(device);
+  const int iterations = 100;
+  std::vector<double> wait_us, wakeup_us, cpu_usage;
+  for (int i = 0; i < lzt::warm_up_iterations + iterations; i++) {
+    lzt::reset_fence(fence);
+    lzt::event_host_reset(event);
+    ASSERT_EQ(ZE_RESULT_SUCCESS,
+              zeCommandQueueExecuteCommandLists(cmd_q, 1, &cmd_list, fence));
+
+    const auto wall_start = completion_clock::now();
+    const std::clock_t cpu_start = std::clock();
+    switch (method) {
+    case FENCE_HOST_SYNCHRONIZE:
+      ASSERT_EQ(ZE_RESULT_SUCCESS, zeFenceHostSynchronize(fence, UINT64_MAX));
+      break;
+    case FENCE_QUERY_POLLING: {
+      ze_result_t status = ZE_RESULT_NOT_READY;
+      while (status == ZE_RESULT_NOT_READY) {
+        status = zeFenceQueryStatus(fence);
+      }
+      ASSERT_EQ(ZE_RESULT_SUCCESS, status);
+      break;
+    }
+    case EVENT_HOST_SYNCHRONIZE:
+      ASSERT_EQ(ZE_RESULT_SUCCESS, zeEventHostSynchronize(event, UINT64_MAX));
+      break;
+    case QUEUE_SYNCHRONIZE:
+      ASSERT_EQ(ZE_RESULT_SUCCESS,
+                zeCommandQueueSynchronize(cmd_q, UINT64_MAX));
+      break;
+    }
+    const uint64_t device_now = std::get<1>(lzt::get_global_timestamps(device));
+    const std::clock_t cpu_end = std::clock();
+    const double wall_s =
+        std::chrono::duration<double>(completion_clock::now() - wall_start)
+            .count();
+
+    // Every method returns once the list is done, so that the event and
+    // the fence are both signaled from here on
+    lzt::synchronize(cmd_q, UINT64_MAX);
+    auto timestamp = lzt::get_event_kernel_timestamp(event);
+    if (i < lzt::warm_up_iterations) {
+      continue;
+    }
+    const int64_t wakeup_ticks = clock.signed_ticks(
+        timestamp.global.kernelEnd, device_now & clock.valid_mask);
+    wakeup_us.push_back(wakeup_ticks * clock.ns_per_tick / 1000);
+    wait_us.push_back(wall_s * 1e6);
+    cpu_usage.push_back(static_cast<double>(cpu_end - cpu_start) /
+                        CLOCKS_PER_SEC / wall_s * 100);
+  }
+
+  LOG_INFO << completion_method_name(method) << ": wait p50 "
+           << lzt::median(wait_us) << " us, wakeup after device end p50 "
+           << lzt::median(wakeup_us) << " us, host CPU usage p50 "
+           << lzt::median(cpu_usage) << "%";
+
+  lzt::free_memory(context, buffer);
+  lzt::destroy_event(event);
+  lzt::destroy_event_pool(event_pool);
+  lzt::destroy_fence(fence);
+  lzt::destroy_command_list(cmd_list);
+  lzt::destroy_command_queue(cmd_q);
+}
+
+INSTANTIATE_TEST_SUITE_P(CompletionMethods, zeFenceCompletionPerformanceTests,
+                         ::testing::Values(FENCE_HOST_SYNCHRONIZE,
+                                           FENCE_QUERY_POLLING,
+                                           EVENT_HOST_SYNCHRONIZE,
+                                           QUEUE_SYNCHRONIZE));
+
+} // namespace
@@ -0,0 +1,271 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <chrono>
+#include <cstring>
+#include <tuple>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock image_clock;
+
+double elapsed_us(image_clock::time_point start) {
+  const auto elapsed = image_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+bool image_view_support(ze_driver_handle_t driver) {
+  for (auto &property : lzt::get_extension_properties(driver)) {
+    if (strncmp(property.name, ZE_IMAGE_VIEW_EXT_NAME,
+                ZE_MAX_EXTENSION_NAME) == 0) {
+      return property.version != 0;
+    }
+  }
+  return false;
+}
+
+const char *image_type_name(ze_image_type_t type) {
+  switch (type) {
+  case ZE_IMAGE_TYPE_1D:
+    return "1D";
+  case ZE_IMAGE_TYPE_2D:
+    return "2D";
+  case ZE_IMAGE_TYPE_3D:
+    return "3D";
+  default:
+    return "other";
+  }
+}
+
+const char *image_layout_name(ze_image_format_layout_t layout) {
+  switch (layout) {
+  case ZE_IMAGE_FORMAT_LAYOUT_8:
+    return "8";
+  case ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8:
+    return "8_8_8_8";
+  case ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32:
+    return "32_32_32_32";
+  default:
+    return "other";
+  }
+}
+
+// Image of edge texels along every dimension of type, except 3D images,
+// which get an eighth of it so that their size stays close to the 2D one
+ze_image_desc_t image_descriptor(ze_image_type_t type,
+                                 ze_image_format_layout_t layout,
+                                 uint32_t edge, ze_image_flags_t flags) {
+  ze_image_desc_t descriptor = {};
+  descriptor.stype = ZE_STRUCTURE_TYPE_IMAGE_DESC;
+  descriptor.flags = flags;
+  descriptor.type = type;
+  descriptor.format = {layout,
+                       ZE_IMAGE_FORMAT_TYPE_UINT,
+                       ZE_IMAGE_FORMAT_SWIZZLE_R,
+                       ZE_IMAGE_FORMAT_SWIZZLE_G,
+                       ZE_IMAGE_FORMAT_SWIZZLE_B,
+                       ZE_IMAGE_FORMAT_SWIZZLE_A};
+  descriptor.width = type == ZE_IMAGE_TYPE_3D ? edge / 8 : edge;
+  descriptor.height = type == ZE_IMAGE_TYPE_1D ? 1 : descriptor.width;
+  descriptor.depth = type == ZE_IMAGE_TYPE_3D ? descriptor.width : 1;
+  descriptor.arraylevels = 0;
+  descriptor.miplevels = 0;
+  return descriptor;
+}
+
+const int iterations = 50;
+
+// Host latency of zeImageCreate, zeImageViewCreateExt and zeImageDestroy
+// by image type, format layout and edge size, as paid by workloads
+// creating transient images and views every frame. Views reinterpret the
+// whole image with the same format. The parameter is the image type, the
+// format layout and the edge size in texels.
+class zeImageCreatePerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::tuple<ze_image_type_t, ze_image_format_layout_t, uint32_t>> {
+};
+
+TEST_P(
+    zeImageCreatePerformanceTests,
+    GivenImageDescriptorWhenRepeatedlyCreatingAndDestroyingImagesAndViewsThenReportLatency) {
+  if (!(lzt::image_support())) {
+    LOG_INFO << "device does not support images, cannot run test";
+    GTEST_SKIP();
+  }
+  const auto type = std::get<0>(GetParam());
+  const auto layout = std::get<1>(GetParam());
+  const uint32_t edge = std::get<2>(GetParam());
+  auto driver = lzt::get_default_driver();
+  auto context = lzt::get_default_context();
+  auto device = lzt::get_default_device(driver);
+  const bool views = image_view_support(driver);
+
+  auto descriptor = image_descriptor(type, layout, edge, 0);
+  std::vector<double> create_latencies, destroy_latencies;
+  std::vector<double> view_create_latencies, view_destroy_latencies;
+  for (int i = 0; i < lzt::warm_up_iterations + iterations; i++) {
+    ze_image_handle_t image = nullptr;
+    auto start = image_clock::now();
+    ASSERT_EQ(ZE_RESULT_SUCCESS,
+              zeImageCreate(context, device, &descriptor, &image));
+    const double create_us = elapsed_us(start);
+
+    double view_create_us = 0, view_destroy_us = 0;
+    if (views) {
+      ze_image_handle_t view = nullptr;
+      start = image_clock::now();
+      ASSERT_EQ(ZE_RESULT_SUCCESS, zeImageViewCreateExt(context, device,
+                                                        &descriptor, image,
+                                                        &view));
+      view_create_us = elapsed_us(start);
+      start = image_clock::now();
+      ASSERT_EQ(ZE_RESULT_SUCCESS, zeImageDestroy(view));
+      view_destroy_us = elapsed_us(start);
+    }
+
+    start = image_clock::now();
+    ASSERT_EQ(ZE_RESULT_SUCCESS, zeImageDestroy(image));
+    const double destroy_us = elapsed_us(start);
+    if (i < lzt::warm_up_iterations) {
+      continue;
+    }
+    create_latencies.push_back(create_us);
+    destroy_latencies.push_back(destroy_us);
+    view_create_latencies.push_back(view_create_us);
+    view_destroy_latencies.push_back(view_destroy_us);
+  }
+
+  LOG_INFO << image_type_name(type) << " " << image_layout_name(layout) << " "
+           << descriptor.width << "x" << descriptor.height << "x"
+           << descriptor.depth << ": create p50 "
+           << lzt::median(create_latencies) << " us, destroy p50 "
+           << lzt::median(destroy_latencies) << " us";
+  if (views) {
+    LOG_INFO << "  view create p50 " << lzt::median(view_create_latencies)
+             << " us, view destroy p50 "
+             << lzt::median(view_destroy_latencies) << " us";
+  } else {
+    LOG_INFO << "  views skipped for missing ZE_extension_image_view";
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ImageCreateLatency, zeImageCreatePerformanceTests,
+    ::testing::Combine(::testing::Values(ZE_IMAGE_TYPE_1D, ZE_IMAGE_TYPE_2D,
+                                         ZE_IMAGE_TYPE_3D),
+                       ::testing::Values(ZE_IMAGE_FORMAT_LAYOUT_8,
+                                         ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8,
+                                         ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32),
+                       ::testing::Values(64, 512, 2048)));
+
+// First use of freshly created images in a kernel against the next use of
+// the same images: the device time of the kernel and the host time from
+// submission to completion, which includes making the images resident.
+// The parameter is the edge size in texels of the 2D 8_8_8_8 images.
+class zeImageFirstUsePerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<uint32_t> {};
+
+TEST_P(
+    zeImageFirstUsePerformanceTests,
+    GivenNewImagesWhenUsedByKernelThenReportFirstUseCostAgainstLaterUse) {
+  if (!(lzt::image_support())) {
+    LOG_INFO << "device does not support images, cannot run test";
+    GTEST_SKIP();
+  }
+  const uint32_t edge = GetParam();
+  auto context = lzt::get_default_context();
+  auto device = lzt::get_default_device(lzt::get_default_driver());
+
+  auto module = lzt::create_module(device, "image_formats_tests.spv");
+  auto kernel = lzt::create_function(module, "image_format_uint");
+  uint32_t group_size_x, group_size_y, group_size_z;
+  EXPECT_EQ(ZE_RESULT_SUCCESS,
+            zeKernelSuggestGroupSize(kernel, edge, edge, 1, &group_size_x,
+                                     &group_size_y, &group_size_z));
+  lzt::set_group_size(kernel, group_size_x, group_size_y, group_size_z);
+  ze_group_count_t group_count = {edge / group_size_x, edge / group_size_y,
+                                  1};
+
+  auto event_pool = lzt::create_event_pool(
+      context, 1,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                ZE_EVENT_SCOPE_FLAG_HOST,
+                                ZE_EVENT_SCOPE_FLAG_HOST};
+  auto event = lzt::create_event(event_pool, event_desc);
+  auto cmd_bundle = lzt::create_command_bundle(context, device, false);
+  const auto clock = lzt::get_timestamp_clock(device);
+
+  auto in_descriptor =
+      image_descriptor(ZE_IMAGE_TYPE_2D, ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8, edge,
+                       ZE_IMAGE_FLAG_KERNEL_WRITE);
+  auto out_descriptor = in_descriptor;
+  std::vector<double> first_device_ns, later_device_ns;
+  std::vector<double> first_host_us, later_host_us;
+  for (int i = 0; i < lzt::warm_up_iterations + iterations; i++) {
+    auto image_in = lzt::create_ze_image(context, device, in_descriptor);
+    auto image_out = lzt::create_ze_image(context, device, out_descriptor);
+    lzt::reset_command_list(cmd_bundle.list);
+    lzt::set_argument_value(kernel, 0, sizeof(image_in), &image_in);
+    lzt::set_argument_value(kernel, 1, sizeof(image_out), &image_out);
+    lzt::append_launch_function(cmd_bundle.list, kernel, &group_count, event,
+                                0, nullptr);
+    lzt::close_command_list(cmd_bundle.list);
+
+    double device_ns[2], host_us[2];
+    for (int use = 0; use < 2; use++) {
+      const auto start = image_clock::now();
+      lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+      host_us[use] = elapsed_us(start);
+      device_ns[use] =
+          clock.duration_ns(lzt::get_event_kernel_timestamp(event).global);
+      lzt::event_host_reset(event);
+    }
+    lzt::destroy_ze_image(image_out);
+    lzt::destroy_ze_image(image_in);
+    // The warm-up iterations also pay for the first use of the kernel
+    if (i < lzt::warm_up_iterations) {
+      continue;
+    }
+    first_device_ns.push_back(device_ns[0]);
+    later_device_ns.push_back(device_ns[1]);
+    first_host_us.push_back(host_us[0]);
+    later_host_us.push_back(host_us[1]);
+  }
+
+  LOG_INFO << "2D 8_8_8_8 " << edge << "x" << edge
+           << " images in a kernel: first use p50 "
+           << lzt::median(first_device_ns) << " ns device, "
+           << lzt::median(first_host_us) << " us host; later use p50 "
+           << lzt::median(later_device_ns) << " ns device, "
+           << lzt::median(later_host_us) << " us host";
+
+  lzt::destroy_command_bundle(cmd_bundle);
+  lzt::destroy_event(event);
+  lzt::destroy_event_pool(event_pool);
+  lzt::destroy_function(kernel);
+  lzt::destroy_module(module);
+}
+
+INSTANTIATE_TEST_SUITE_P(ImageFirstUseLatency,
+                         zeImageFirstUsePerformanceTests,
+                         ::testing::Values(64, 512, 2048));
+
+} // namespace
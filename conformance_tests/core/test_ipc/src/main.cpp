@@ -8,11 +8,12 @@
 
 #include "gmock/gmock.h"
 #include "logging/logging.hpp"
+#include "test_harness/test_harness.hpp"
 #include "utils/utils.hpp"
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleMock(&argc, argv);
   std::vector<std::string> command_line(argv + 1, argv + argc);
   level_zero_tests::init_logging(command_line);
-  return RUN_ALL_TESTS();
+  return level_zero_tests::run_all_tests();
 }
@@ -19,6 +19,8 @@
 
 #include <level_zero/ze_api.h>
 
+#include <chrono>
+
 namespace lzt = level_zero_tests;
 namespace bipc = boost::interprocess;
 namespace {
@@ -103,6 +105,62 @@ static void parent_device_signals(ze_event_handle_t hEvent,
   lzt::destroy_command_bundle(cmdbundle);
 }
 
+const uint32_t ping_pong_warm_up = 10;
+const uint32_t ping_pong_iterations = 1000;
+
+// Signals ping and waits for the child to answer with pong, either both
+// signaled by the devices and waited for by the hosts or the other way
+// around, and reports the round trip latency percentiles
+static void parent_ping_pong(ze_event_pool_handle_t hEventPool,
+                             ze_context_handle_t context, bool device_signals) {
+  ze_event_desc_t ping_desc = defaultEventDesc;
+  ping_desc.index = ping_event_index;
+  ze_event_desc_t pong_desc = defaultEventDesc;
+  pong_desc.index = pong_event_index;
+  auto ping = lzt::create_event(hEventPool, ping_desc);
+  auto pong = lzt::create_event(hEventPool, pong_desc);
+
+  auto device = lzt::get_default_device(lzt::get_default_driver());
+  auto cmdbundle = lzt::create_command_bundle(context, device, false);
+  if (device_signals) {
+    lzt::append_signal_event(cmdbundle.list, ping);
+  } else {
+    lzt::append_wait_on_events(cmdbundle.list, 1, &pong);
+  }
+  lzt::close_command_list(cmdbundle.list);
+
+  std::vector<double> round_trips;
+  for (uint32_t i = 0; i < ping_pong_warm_up + ping_pong_iterations; i++) {
+    const auto start = std::chrono::steady_clock::now();
+    if (device_signals) {
+      lzt::execute_and_sync_command_bundle(cmdbundle, UINT64_MAX);
+      lzt::event_host_synchronize(pong, UINT64_MAX);
+    } else {
+      lzt::signal_event_from_host(ping);
+      lzt::execute_and_sync_command_bundle(cmdbundle, UINT64_MAX);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    // The child resets ping before answering, so only pong is left
+    lzt::event_host_reset(pong);
+    if (i >= ping_pong_warm_up) {
+      round_trips.push_back(
+          std::chrono::duration<double, std::micro>(end - start).count());
+    }
+  }
+
+  LOG_INFO << (device_signals ? "Device signaled, host waited"
+                              : "Host signaled, device waited")
+           << " IPC event round trip: p50 " << lzt::median(round_trips)
+           << " us, p90 " << lzt::percentile(round_trips, 90) << " us, p99 "
+           << lzt::percentile(round_trips, 99) << " us, max "
+           << lzt::percentile(round_trips, 100) << " us";
+
+  // cleanup
+  lzt::destroy_command_bundle(cmdbundle);
+  lzt::destroy_event(pong);
+  lzt::destroy_event(ping);
+}
+
 ze_kernel_handle_t get_matrix_multiplication_kernel(
     const ze_context_handle_t &context, ze_device_handle_t device,
     ze_group_count_t *tg, void **a_buffer, void **b_buffer, void **c_buffer,
@@ -243,6 +301,7 @@ static void run_ipc_event_test(parent_test_t parent_test,
   }
   shared_data_t test_data = {parent_test, child_test, multi_device,
                              isImmediate};
+  test_data.ping_pong_count = ping_pong_warm_up + ping_pong_iterations;
   bipc::shared_memory_object shm(bipc::create_only, "ipc_event_test",
                                  bipc::read_write);
   shm.truncate(sizeof(shared_data_t));
@@ -263,6 +322,10 @@ static void run_ipc_event_test(parent_test_t parent_test,
     run_workload(hEvent, context, startTime, endTime,
                  (timestamp_type == MAPPED_KERNEL_TIMESTAMP));
     break;
+  case PARENT_TEST_PING_PONG:
+    parent_ping_pong(ep, context,
+                     child_test == CHILD_TEST_DEVICE_SIGNALS_PING_PONG);
+    break;
   default:
     FAIL() << "Fatal test error";
   }
@@ -354,6 +417,20 @@ TEST(
                      CHILD_TEST_HOST_MAPPED_TIMESTAMP_READS, false, false);
 }
 
+TEST(
+    zeIPCEventTests,
+    GivenTwoProcessesWhenEventsPingPongSignaledByDeviceAndWaitedByHostThenRoundTripLatencyIsReported) {
+  run_ipc_event_test(PARENT_TEST_PING_PONG,
+                     CHILD_TEST_DEVICE_SIGNALS_PING_PONG, false, false);
+}
+
+TEST(
+    zeIPCEventTests,
+    GivenTwoProcessesWhenEventsPingPongSignaledByHostAndWaitedByDeviceThenRoundTripLatencyIsReported) {
+  run_ipc_event_test(PARENT_TEST_PING_PONG, CHILD_TEST_HOST_SIGNALS_PING_PONG,
+                     false, false);
+}
+
 TEST(
     zeIPCEventMultipleDeviceTests,
     GivenTwoProcessesWhenEventSignaledByDeviceInParentThenEventSetinChildFromSecondDevicePerspective) {
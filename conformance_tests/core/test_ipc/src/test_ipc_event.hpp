@@ -12,7 +12,8 @@
 typedef enum {
   PARENT_TEST_HOST_SIGNALS,
   PARENT_TEST_DEVICE_SIGNALS,
-  PARENT_TEST_HOST_LAUNCHES_KERNEL
+  PARENT_TEST_HOST_LAUNCHES_KERNEL,
+  PARENT_TEST_PING_PONG
 } parent_test_t;
 
 typedef enum {
@@ -22,9 +23,16 @@ typedef enum {
   CHILD_TEST_MULTI_DEVICE_READS,
   CHILD_TEST_HOST_TIMESTAMP_READS,
   CHILD_TEST_DEVICE_TIMESTAMP_READS,
-  CHILD_TEST_HOST_MAPPED_TIMESTAMP_READS
+  CHILD_TEST_HOST_MAPPED_TIMESTAMP_READS,
+  CHILD_TEST_DEVICE_SIGNALS_PING_PONG,
+  CHILD_TEST_HOST_SIGNALS_PING_PONG
 } child_test_t;
 
+// The ping pong benchmark bounces two events of the pool between the
+// processes, the parent signals ping and the child answers with pong
+constexpr uint32_t ping_event_index = 0;
+constexpr uint32_t pong_event_index = 1;
+
 typedef struct {
   parent_test_t parent_type;
   child_test_t child_type;
@@ -32,6 +40,7 @@ typedef struct {
   bool is_immediate;
   uint64_t start_time;
   uint64_t end_time;
+  uint32_t ping_pong_count;
 } shared_data_t;
 
 #endif
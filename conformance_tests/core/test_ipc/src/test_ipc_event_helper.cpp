@@ -222,6 +222,45 @@ child_device_query_timestamp(const ze_event_pool_handle_t &hEventPool,
   EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventDestroy(hEvent));
 }
 
+// Answers every ping of the parent with pong, see parent_ping_pong
+static void child_ping_pong(ze_event_pool_handle_t hEventPool,
+                            ze_context_handle_t context, bool device_signals,
+                            uint32_t count) {
+  ze_event_desc_t ping_desc = defaultEventDesc;
+  ping_desc.index = ping_event_index;
+  ze_event_desc_t pong_desc = defaultEventDesc;
+  pong_desc.index = pong_event_index;
+  ze_event_handle_t ping, pong;
+  EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventCreate(hEventPool, &ping_desc, &ping));
+  EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventCreate(hEventPool, &pong_desc, &pong));
+
+  auto device = lzt::get_default_device(lzt::get_default_driver());
+  auto cmdbundle = lzt::create_command_bundle(context, device, false);
+  if (device_signals) {
+    lzt::append_signal_event(cmdbundle.list, pong);
+  } else {
+    lzt::append_wait_on_events(cmdbundle.list, 1, &ping);
+  }
+  lzt::close_command_list(cmdbundle.list);
+
+  for (uint32_t i = 0; i < count; i++) {
+    if (device_signals) {
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventHostSynchronize(ping, UINT64_MAX));
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventHostReset(ping));
+      lzt::execute_and_sync_command_bundle(cmdbundle, UINT64_MAX);
+    } else {
+      lzt::execute_and_sync_command_bundle(cmdbundle, UINT64_MAX);
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventHostReset(ping));
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventHostSignal(pong));
+    }
+  }
+
+  // cleanup
+  lzt::destroy_command_bundle(cmdbundle);
+  EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventDestroy(pong));
+  EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventDestroy(ping));
+}
+
 int main() {
   ze_result_t result = zeInit(0);
   if (result != ZE_RESULT_SUCCESS) {
@@ -306,6 +345,13 @@ int main() {
   case CHILD_TEST_HOST_MAPPED_TIMESTAMP_READS:
     child_host_query_timestamp(hEventPool, shared_data, true);
     break;
+  case CHILD_TEST_DEVICE_SIGNALS_PING_PONG:
+  case CHILD_TEST_HOST_SIGNALS_PING_PONG:
+    child_ping_pong(hEventPool, context,
+                    shared_data.child_type ==
+                        CHILD_TEST_DEVICE_SIGNALS_PING_PONG,
+                    shared_data.ping_pong_count);
+    break;
   default:
     LOG_DEBUG << "Unrecognized test case";
     lzt::destroy_context(context);
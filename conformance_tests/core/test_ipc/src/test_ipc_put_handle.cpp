@@ -20,6 +20,7 @@
 #include "test_ipc_put_handle.hpp"
 #include "net/test_ipc_comm.hpp"
 
+#include <chrono>
 #include <thread>
 #include <level_zero/ze_api.h>
 
@@ -261,6 +262,145 @@ TEST(
                           ZE_IPC_MEMORY_FLAG_BIAS_UNCACHED, true);
 }
 
+// Time spent in every phase of sharing a set of handles, in us
+typedef struct {
+  double get_us;
+  double send_us;
+  double receive_us;
+  double open_us;
+  double put_us;
+} ipc_bulk_timing_t;
+
+static double elapsed_us(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+static void run_ipc_put_handle_scaling_test(int handle_count, int size,
+                                            ipc_bulk_timing_t &timing) {
+  bipc::shared_memory_object::remove("ipc_put_handle_test");
+  shared_data_t test_data = {};
+  test_data.test_type = TEST_PUT_BULK_SCALING;
+  test_data.size = size;
+  test_data.flags = ZE_IPC_MEMORY_FLAG_BIAS_UNCACHED;
+  test_data.handle_count = handle_count;
+  bipc::shared_memory_object shm(bipc::create_only, "ipc_put_handle_test",
+                                 bipc::read_write);
+  shm.truncate(sizeof(shared_data_t));
+  bipc::mapped_region region(shm, bipc::read_write);
+  std::memcpy(region.get_address(), &test_data, sizeof(shared_data_t));
+  auto shared_data =
+      static_cast<volatile shared_data_t *>(region.get_address());
+  // launch child
+  boost::process::child c("./ipc/test_ipc_put_handle_helper");
+
+  auto driver = lzt::get_default_driver();
+  auto context = lzt::create_context(driver);
+  auto device = lzt::zeDevice::get_instance()->get_device();
+  auto cmd_bundle = lzt::create_command_bundle(context, device, false);
+
+  void *buffer = lzt::allocate_host_memory(size, 1, context);
+  lzt::write_data_pattern(buffer, size, 1);
+  std::vector<void *> shards(handle_count, nullptr);
+  for (auto &shard : shards) {
+    shard = lzt::allocate_device_memory(size, 1, 0, context);
+    lzt::append_memory_copy(cmd_bundle.list, shard, buffer, size);
+  }
+  lzt::close_command_list(cmd_bundle.list);
+  lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+
+  std::vector<ze_ipc_mem_handle_t> ipc_handles(handle_count);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < handle_count; i++) {
+    ASSERT_EQ(ZE_RESULT_SUCCESS,
+              zeMemGetIpcHandle(context, shards[i], &ipc_handles[i]));
+  }
+  timing.get_us = elapsed_us(start);
+
+  // Waiting for the child keeps its startup out of the transfer time
+  while (!shared_data->child_ready && c.running()) {
+    std::this_thread::yield();
+  }
+  start = std::chrono::steady_clock::now();
+  lzt::send_ipc_handles(ipc_handles);
+  timing.send_us = elapsed_us(start);
+
+  c.wait();
+  ASSERT_EQ(0, c.exit_code())
+      << "Receiver process failed to open " << handle_count << " handles";
+  timing.receive_us = shared_data->receive_us;
+  timing.open_us = shared_data->open_us;
+
+  start = std::chrono::steady_clock::now();
+  for (auto &ipc_handle : ipc_handles) {
+    ASSERT_EQ(ZE_RESULT_SUCCESS, zeMemPutIpcHandle(context, ipc_handle));
+  }
+  timing.put_us = elapsed_us(start);
+  bipc::shared_memory_object::remove("ipc_put_handle_test");
+
+  for (auto shard : shards) {
+    lzt::free_memory(context, shard);
+  }
+  lzt::free_memory(context, buffer);
+  lzt::destroy_command_bundle(cmd_bundle);
+  lzt::destroy_context(context);
+}
+
+TEST(
+    PutIpcMemoryBulkScalingTest,
+    GivenThousandsOfShardedAllocationsWhenSharingTheirIpcHandlesThenPerHandleCostIsReported) {
+  ze_result_t result = zeInit(0);
+  if (result != ZE_RESULT_SUCCESS) {
+    throw std::runtime_error("Parent zeInit failed: " +
+                             level_zero_tests::to_string(result));
+  }
+  auto ipc_flags = lzt::get_ipc_properties(lzt::get_default_driver()).flags;
+  if ((ipc_flags & ZE_IPC_PROPERTY_FLAG_MEMORY) == 0) {
+    GTEST_SKIP() << "Driver does not support memory IPC";
+  }
+
+  // Each process holds a descriptor per handle, beside its own few dozen
+  const rlim_t open_file_limit = raise_open_file_limit();
+  const int reserved_descriptors = 64;
+  const int shard_size = 64 * 1024;
+  int transfer_bound_count = 0;
+  for (int handle_count : {16, 64, 256, 1024, 4096}) {
+    if (static_cast<rlim_t>(handle_count + reserved_descriptors) >
+        open_file_limit) {
+      LOG_INFO << "Open file limit " << open_file_limit << " too low to share "
+               << handle_count << " handles";
+      break;
+    }
+    ipc_bulk_timing_t timing = {};
+    run_ipc_put_handle_scaling_test(handle_count, shard_size, timing);
+    if (::testing::Test::HasFatalFailure()) {
+      return;
+    }
+
+    const double driver_us = timing.get_us + timing.open_us + timing.put_us;
+    const double total_us = driver_us + timing.send_us;
+    LOG_INFO << handle_count << " shards of " << shard_size
+             << " bytes shared in " << total_us / 1000
+             << " ms, us per handle: get " << timing.get_us / handle_count
+             << " send " << timing.send_us / handle_count << " receive "
+             << timing.receive_us / handle_count << " open "
+             << timing.open_us / handle_count << " put "
+             << timing.put_us / handle_count << ", descriptor transfer "
+             << 100 * timing.send_us / total_us << "% of the total";
+    if (!transfer_bound_count && timing.send_us > driver_us) {
+      transfer_bound_count = handle_count;
+    }
+  }
+
+  if (transfer_bound_count) {
+    LOG_INFO << "Descriptor transfer over the unix socket dominates from "
+             << transfer_bound_count << " handles";
+  } else {
+    LOG_INFO << "Driver calls dominate for every handle count";
+  }
+}
+
 #endif // __linux__
 
 class zePutIpcMemHandleTests : public ::testing::Test {
@@ -11,7 +11,8 @@
 
 typedef enum {
   TEST_PUT_DEVICE_ACCESS,
-  TEST_PUT_SUBDEVICE_ACCESS
+  TEST_PUT_SUBDEVICE_ACCESS,
+  TEST_PUT_BULK_SCALING
 } ipc_put_mem_access_test_t;
 
 typedef struct {
@@ -19,6 +20,28 @@ typedef struct {
   int size;
   ze_ipc_memory_flags_t flags;
   bool is_immediate;
+  // Bulk scaling only: handles shared, and the child side timings in us
+  int handle_count;
+  double receive_us;
+  double open_us;
+  bool child_ready;
 } shared_data_t;
 
+#ifdef __linux__
+#include <sys/resource.h>
+
+// Every open IPC handle holds a descriptor, so bulk sharing needs the soft
+// limit raised as far as the hard limit allows
+static inline rlim_t raise_open_file_limit() {
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit)) {
+    return 0;
+  }
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+  getrlimit(RLIMIT_NOFILE, &limit);
+  return limit.rlim_cur;
+}
+#endif
+
 #endif
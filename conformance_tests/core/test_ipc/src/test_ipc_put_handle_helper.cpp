@@ -16,6 +16,7 @@
 #include <boost/interprocess/mapped_region.hpp>
 #include <boost/process.hpp>
 
+#include <chrono>
 #include <level_zero/ze_api.h>
 
 namespace bipc = boost::interprocess;
@@ -108,6 +109,69 @@ static void child_put_subdevice_test(int size, ze_ipc_memory_flags_t flags,
   }
 }
 
+static double elapsed_us(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+static void child_put_bulk_scaling_test(volatile shared_data_t *shared_data) {
+  raise_open_file_limit();
+  auto driver = lzt::get_default_driver();
+  auto context = lzt::create_context(driver);
+  auto device = lzt::zeDevice::get_instance()->get_device();
+  const int handle_count = shared_data->handle_count;
+  const int size = shared_data->size;
+  const ze_ipc_memory_flags_t flags = shared_data->flags;
+  std::vector<ze_ipc_mem_handle_t> ipc_handles(handle_count);
+  std::vector<void *> memory(handle_count, nullptr);
+
+  // The parent starts sending once it sees the flag
+  shared_data->child_ready = true;
+  auto start = std::chrono::steady_clock::now();
+  lzt::receive_ipc_handles(ipc_handles);
+  shared_data->receive_us = elapsed_us(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < handle_count; i++) {
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeMemOpenIpcHandle(context, device, ipc_handles[i], flags,
+                                 &memory[i]));
+  }
+  shared_data->open_us = elapsed_us(start);
+
+  // Every shard holds the same pattern, checking the first and the last
+  // ones catches handles lost or reordered on the way
+  auto cmd_bundle = lzt::create_command_bundle(context, device, false);
+  void *first_buffer = lzt::allocate_host_memory(size, 1, context);
+  void *last_buffer = lzt::allocate_host_memory(size, 1, context);
+  memset(first_buffer, 0, size);
+  memset(last_buffer, 0, size);
+  lzt::append_memory_copy(cmd_bundle.list, first_buffer, memory[0], size);
+  lzt::append_memory_copy(cmd_bundle.list, last_buffer,
+                          memory[handle_count - 1], size);
+  lzt::close_command_list(cmd_bundle.list);
+  lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+
+  LOG_DEBUG << "[Child] Validating shards received correctly";
+  lzt::validate_data_pattern(first_buffer, size, 1);
+  lzt::validate_data_pattern(last_buffer, size, 1);
+
+  for (auto shard : memory) {
+    EXPECT_EQ(ZE_RESULT_SUCCESS, zeMemCloseIpcHandle(context, shard));
+  }
+  lzt::free_memory(context, first_buffer);
+  lzt::free_memory(context, last_buffer);
+  lzt::destroy_command_bundle(cmd_bundle);
+  lzt::destroy_context(context);
+
+  if (::testing::Test::HasFailure()) {
+    exit(1);
+  } else {
+    exit(0);
+  }
+}
+
 int main() {
   ze_result_t result = zeInit(0);
   if (result != ZE_RESULT_SUCCESS) {
@@ -134,7 +198,7 @@ int main() {
   }
 
   shm.truncate(sizeof(shared_data_t));
-  bipc::mapped_region region(shm, bipc::read_only);
+  bipc::mapped_region region(shm, bipc::read_write);
   std::memcpy(&shared_data, region.get_address(), sizeof(shared_data_t));
 
   switch (shared_data.test_type) {
@@ -146,6 +210,10 @@ int main() {
     child_put_subdevice_test(shared_data.size, shared_data.flags,
                              shared_data.is_immediate);
     break;
+  case TEST_PUT_BULK_SCALING:
+    child_put_bulk_scaling_test(
+        static_cast<volatile shared_data_t *>(region.get_address()));
+    break;
   default:
     LOG_DEBUG << "Unrecognized test case";
     exit(1);
@@ -0,0 +1,12 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+kernel void copy_buffer(global const uint4 *src, global uint4 *dst) {
+  const size_t i = get_global_id(0);
+  dst[i] = src[i];
+}
@@ -0,0 +1,262 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <chrono>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock export_import_clock;
+
+double elapsed_us(export_import_clock::time_point start) {
+  const auto elapsed = export_import_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+// Exports a device allocation as a dma-buf and imports it into a second
+// context on the last device, as a consumer process would. Reports the
+// latency of the export and of the import by size, then the bandwidth of a
+// kernel on the importing device reading the imported allocation against
+// the same kernel reading a native allocation. A pattern written through
+// the exporter after the import has to show through the imported
+// allocation, which holds only if both share the memory without a copy.
+// The parameter is the allocation size.
+class zeMemoryExportImportPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<size_t> {
+protected:
+  // Median device time in ns of the recorded list, whose launch signals
+  // event
+  double time_kernel(lzt::zeCommandBundle &bundle, ze_event_handle_t event,
+                     const lzt::TimestampClock &clock) {
+    std::vector<double> durations;
+    for (int i = 0; i < iterations_; i++) {
+      lzt::execute_and_sync_command_bundle(bundle, UINT64_MAX);
+      auto timestamp = lzt::get_event_kernel_timestamp(event);
+      durations.push_back(clock.duration_ns(timestamp.global));
+      lzt::event_host_reset(event);
+    }
+    return lzt::median(durations);
+  }
+
+  const int iterations_ = 20;
+};
+
+#ifdef __linux__
+TEST_P(
+    zeMemoryExportImportPerformanceTests,
+    GivenDmaBufExportedAllocationWhenImportedAndReadByKernelThenReportLatencyAndBandwidthAgainstNativeAllocation) {
+  const size_t size = GetParam();
+  auto driver = lzt::get_default_driver();
+  auto devices = lzt::get_ze_devices(driver);
+  auto export_device = devices.front();
+  auto import_device = devices.back();
+
+  if (!(lzt::get_external_memory_properties(export_device)
+            .memoryAllocationExportTypes &
+        ZE_EXTERNAL_MEMORY_TYPE_FLAG_DMA_BUF)) {
+    GTEST_SKIP() << "Device does not support exporting DMA_BUF";
+  }
+  if (!(lzt::get_external_memory_properties(import_device)
+            .memoryAllocationImportTypes &
+        ZE_EXTERNAL_MEMORY_TYPE_FLAG_DMA_BUF)) {
+    GTEST_SKIP() << "Device does not support importing DMA_BUF";
+  }
+  uint64_t device_memory = 0;
+  for (auto &properties : lzt::get_memory_properties(import_device)) {
+    device_memory += properties.totalSize;
+  }
+  if (size > device_memory / 8) {
+    GTEST_SKIP() << size << " bytes exceed an eighth of the device memory";
+  }
+
+  auto export_context = lzt::create_context(driver);
+  auto import_context = lzt::create_context(driver);
+
+  ze_external_memory_export_desc_t export_desc = {};
+  export_desc.stype = ZE_STRUCTURE_TYPE_EXTERNAL_MEMORY_EXPORT_DESC;
+  export_desc.flags = ZE_EXTERNAL_MEMORY_TYPE_FLAG_DMA_BUF;
+  auto exported_memory = lzt::allocate_device_memory(
+      size, 64, 0, &export_desc, 0, export_device, export_context);
+
+  // Export and import latency, each export giving a new fd
+  std::vector<double> export_latencies, import_latencies, free_latencies;
+  int exported_fd = -1;
+  void *imported_memory = nullptr;
+  for (int i = 0; i <= iterations_; i++) {
+    ze_external_memory_export_fd_t export_fd = {};
+    export_fd.stype = ZE_STRUCTURE_TYPE_EXTERNAL_MEMORY_EXPORT_FD;
+    export_fd.flags = ZE_EXTERNAL_MEMORY_TYPE_FLAG_DMA_BUF;
+    ze_memory_allocation_properties_t alloc_props = {};
+    alloc_props.stype = ZE_STRUCTURE_TYPE_MEMORY_ALLOCATION_PROPERTIES;
+    alloc_props.pNext = &export_fd;
+    auto start = export_import_clock::now();
+    lzt::get_mem_alloc_properties(export_context, exported_memory,
+                                  &alloc_props);
+    export_latencies.push_back(elapsed_us(start));
+    ASSERT_GT(export_fd.fd, 0);
+
+    ze_external_memory_import_fd_t import_fd = {};
+    import_fd.stype = ZE_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMPORT_FD;
+    import_fd.flags = ZE_EXTERNAL_MEMORY_TYPE_FLAG_DMA_BUF;
+    import_fd.fd = export_fd.fd;
+    ze_device_mem_alloc_desc_t import_desc = {};
+    import_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+    import_desc.pNext = &import_fd;
+    start = export_import_clock::now();
+    ASSERT_EQ(ZE_RESULT_SUCCESS,
+              zeMemAllocDevice(import_context, &import_desc, size, 64,
+                               import_device, &imported_memory));
+    import_latencies.push_back(elapsed_us(start));
+
+    // The last import is kept for the kernels
+    if (i == iterations_) {
+      exported_fd = export_fd.fd;
+      break;
+    }
+    start = export_import_clock::now();
+    lzt::free_memory(import_context, imported_memory);
+    free_latencies.push_back(elapsed_us(start));
+    close(export_fd.fd);
+  }
+  LOG_INFO << "dma-buf of " << size << " bytes: export p50 "
+           << lzt::median(export_latencies) << " us, import p50 "
+           << lzt::median(import_latencies) << " us, imported free p50 "
+           << lzt::median(free_latencies) << " us";
+
+  // Written through the exporter after the import, so that a copy taken
+  // at import would still hold the old contents
+  auto export_bundle =
+      lzt::create_command_bundle(export_context, export_device, false);
+  const uint32_t stale_pattern = 0x0;
+  const uint32_t pattern = 0xC0FFEE11;
+  lzt::append_memory_fill(export_bundle.list, exported_memory, &stale_pattern,
+                          sizeof(stale_pattern), size, nullptr);
+  lzt::append_barrier(export_bundle.list, nullptr, 0, nullptr);
+  lzt::append_memory_fill(export_bundle.list, exported_memory, &pattern,
+                          sizeof(pattern), size, nullptr);
+  lzt::close_command_list(export_bundle.list);
+  lzt::execute_and_sync_command_bundle(export_bundle, UINT64_MAX);
+
+  auto native_memory = lzt::allocate_device_memory(
+      size, 64, 0, 0, import_device, import_context);
+  auto output_memory = lzt::allocate_device_memory(
+      size, 64, 0, 0, import_device, import_context);
+  auto verification_memory = lzt::allocate_shared_memory(
+      size, 64, 0, 0, import_device, import_context);
+
+  auto module = lzt::create_module(import_context, import_device,
+                                   "export_import_performance.spv",
+                                   ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+  auto event_pool = lzt::create_event_pool(
+      import_context, 2,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  const uint32_t group_size = 64;
+  ze_group_count_t group_count = {
+      static_cast<uint32_t>(size / (4 * sizeof(uint32_t)) / group_size), 1, 1};
+  void *sources[2] = {imported_memory, native_memory};
+  ze_kernel_handle_t kernels[2];
+  ze_event_handle_t events[2];
+  lzt::zeCommandBundle bundles[2];
+  for (int i = 0; i < 2; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr,
+                                  static_cast<uint32_t>(i),
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    events[i] = lzt::create_event(event_pool, event_desc);
+    kernels[i] = lzt::create_function(module, "copy_buffer");
+    lzt::set_group_size(kernels[i], group_size, 1, 1);
+    lzt::set_argument_value(kernels[i], 0, sizeof(sources[i]), &sources[i]);
+    lzt::set_argument_value(kernels[i], 1, sizeof(output_memory),
+                            &output_memory);
+    bundles[i] =
+        lzt::create_command_bundle(import_context, import_device, false);
+    if (i == 1) {
+      lzt::append_memory_fill(bundles[i].list, native_memory, &pattern,
+                              sizeof(pattern), size, nullptr);
+      lzt::append_barrier(bundles[i].list, nullptr, 0, nullptr);
+    }
+    lzt::append_launch_function(bundles[i].list, kernels[i], &group_count,
+                                events[i], 0, nullptr);
+    lzt::close_command_list(bundles[i].list);
+  }
+
+  // Zero copy check: the imported allocation reads the later pattern
+  lzt::execute_and_sync_command_bundle(bundles[0], UINT64_MAX);
+  lzt::event_host_reset(events[0]);
+  auto check_bundle =
+      lzt::create_command_bundle(import_context, import_device, false);
+  lzt::append_memory_copy(check_bundle.list, verification_memory,
+                          output_memory, size);
+  lzt::close_command_list(check_bundle.list);
+  lzt::execute_and_sync_command_bundle(check_bundle, UINT64_MAX);
+  auto words = static_cast<uint32_t *>(verification_memory);
+  size_t mismatches = 0;
+  for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+    mismatches += (words[i] != pattern);
+  }
+  EXPECT_EQ(0u, mismatches)
+      << "imported allocation does not alias the exported memory";
+
+  const auto clock = lzt::get_timestamp_clock(import_device);
+  const double imported_ns = time_kernel(bundles[0], events[0], clock);
+  const double native_ns = time_kernel(bundles[1], events[1], clock);
+  // Bytes read and written per ns are GB/s
+  const double imported_gbps = 2.0 * size / imported_ns;
+  const double native_gbps = 2.0 * size / native_ns;
+  LOG_INFO << "kernel copy of " << size << " bytes: imported "
+           << imported_gbps << " GB/s, native " << native_gbps
+           << " GB/s, loss " << (1.0 - imported_gbps / native_gbps) * 100
+           << "%";
+
+  // cleanup
+  for (int i = 0; i < 2; i++) {
+    lzt::destroy_command_bundle(bundles[i]);
+    lzt::destroy_function(kernels[i]);
+    lzt::destroy_event(events[i]);
+  }
+  lzt::destroy_command_bundle(check_bundle);
+  lzt::destroy_command_bundle(export_bundle);
+  lzt::destroy_event_pool(event_pool);
+  lzt::destroy_module(module);
+  lzt::free_memory(import_context, verification_memory);
+  lzt::free_memory(import_context, output_memory);
+  lzt::free_memory(import_context, native_memory);
+  lzt::free_memory(import_context, imported_memory);
+  close(exported_fd);
+  lzt::free_memory(export_context, exported_memory);
+  lzt::destroy_context(import_context);
+  lzt::destroy_context(export_context);
+}
+#else
+TEST_P(
+    zeMemoryExportImportPerformanceTests,
+    GivenDmaBufExportedAllocationWhenImportedAndReadByKernelThenReportLatencyAndBandwidthAgainstNativeAllocation) {
+  GTEST_SKIP() << "dma-buf is only supported on Linux";
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(ExportImportSizes,
+                         zeMemoryExportImportPerformanceTests,
+                         ::testing::Values(4 * 1024, 1024 * 1024,
+                                           16 * 1024 * 1024,
+                                           256 * 1024 * 1024));
+
+} // namespace
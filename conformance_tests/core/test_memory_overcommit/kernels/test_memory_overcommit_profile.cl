@@ -0,0 +1,12 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+kernel void increment_memory(global uint4 *data) {
+  const size_t i = get_global_id(0);
+  data[i] += (uint4)(1);
+}
@@ -0,0 +1,218 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock overcommit_clock;
+
+double elapsed_s(overcommit_clock::time_point start) {
+  const auto elapsed = overcommit_clock::now() - start;
+  return std::chrono::duration<double>(elapsed).count();
+}
+
+struct OvercommitPoint {
+  double ratio;
+  size_t size;
+  double first_pass_s;
+  double steady_pass_s;
+  double steady_gbps;
+};
+
+// Profile of shared allocations oversubscribing the device memory: for
+// every ratio of the allocated size to the device memory, a kernel
+// increments every element of the allocations a few times, and the time
+// to completion of the first pass, which migrates all of it, and the
+// bandwidth of the later passes are reported. The cliff is the first
+// ratio whose bandwidth falls below half of that at 0.5x. It allocates up
+// to 3x the device memory, backed by system memory, so it only runs with
+// LZT_MEMORY_OVERCOMMIT_PROFILE=1.
+class zeDriverMemoryOvercommitProfileTests : public ::testing::Test {
+protected:
+  // Chunks no larger than maxMemAllocSize, so that no allocation needs
+  // relaxed limits, holding size bytes in total; empty when the system
+  // cannot back them
+  std::vector<void *> allocate_chunks(size_t size, size_t chunk_size) {
+    std::vector<void *> chunks;
+    for (size_t allocated = 0; allocated < size; allocated += chunk_size) {
+      ze_result_t result = ZE_RESULT_SUCCESS;
+      void *chunk = lzt::allocate_shared_memory_no_check(
+          std::min(chunk_size, size - allocated), 64, 0, nullptr, 0, nullptr,
+          device_, context_, &result);
+      if (result != ZE_RESULT_SUCCESS) {
+        free_chunks(chunks);
+        break;
+      }
+      chunks.push_back(chunk);
+    }
+    return chunks;
+  }
+
+  void free_chunks(std::vector<void *> &chunks) {
+    for (auto chunk : chunks) {
+      lzt::free_memory(context_, chunk);
+    }
+    chunks.clear();
+  }
+
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+};
+
+TEST_F(
+    zeDriverMemoryOvercommitProfileTests,
+    GivenSharedMemoryOversubscribingDeviceMemoryWhenSweepingRatioThenReportKernelBandwidthAndTimeToCompletion) {
+  const char *enabled = getenv("LZT_MEMORY_OVERCOMMIT_PROFILE");
+  if (enabled == nullptr || strcmp(enabled, "1") != 0) {
+    GTEST_SKIP() << "Set LZT_MEMORY_OVERCOMMIT_PROFILE=1 to profile memory "
+                    "oversubscription";
+  }
+
+  context_ = lzt::get_default_context();
+  device_ = lzt::zeDevice::get_instance()->get_device();
+  auto access_properties = lzt::get_memory_access_properties(device_);
+  if (!(access_properties.sharedSingleDeviceAllocCapabilities &
+        ZE_MEMORY_ACCESS_CAP_FLAG_RW)) {
+    GTEST_SKIP() << "Device does not support shared single device memory";
+  }
+
+  uint64_t device_memory = 0;
+  for (auto &properties : lzt::get_memory_properties(device_)) {
+    device_memory += properties.totalSize;
+  }
+  const uint32_t group_size = 256;
+  const size_t element_size = 4 * sizeof(uint32_t);
+  const size_t granularity = group_size * element_size;
+  const size_t chunk_size =
+      std::min<uint64_t>(lzt::get_device_properties(device_).maxMemAllocSize,
+                         1ULL << 30) /
+      granularity * granularity;
+  ASSERT_GT(chunk_size, 0u);
+  const uint32_t max_group_count =
+      lzt::get_compute_properties(device_).maxGroupCountX;
+  if (chunk_size / granularity > max_group_count) {
+    GTEST_SKIP() << "Chunks of " << chunk_size
+                 << " bytes need more groups than the device launches";
+  }
+
+  auto module = lzt::create_module(context_, device_,
+                                   "test_memory_overcommit_profile.spv",
+                                   ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+  auto kernel = lzt::create_function(module, "increment_memory");
+  lzt::set_group_size(kernel, group_size, 1, 1);
+  auto cmd_bundle = lzt::create_command_bundle(context_, device_, false);
+
+  const double ratios[] = {0.5, 0.75, 1.0, 1.25, 1.5, 2.0, 2.5, 3.0};
+  const int passes = 4;
+  std::vector<OvercommitPoint> points;
+  for (auto ratio : ratios) {
+    const size_t size =
+        static_cast<size_t>(ratio * device_memory) / granularity * granularity;
+    auto chunks = allocate_chunks(size, chunk_size);
+    if (chunks.empty()) {
+      LOG_INFO << "Stopping at " << ratio
+               << "x: the system cannot back " << size << " bytes";
+      break;
+    }
+
+    // One launch per chunk, all of them in one list per pass
+    lzt::reset_command_list(cmd_bundle.list);
+    for (size_t i = 0; i < chunks.size(); i++) {
+      const size_t bytes = std::min(chunk_size, size - i * chunk_size);
+      ze_group_count_t group_count = {
+          static_cast<uint32_t>(bytes / granularity), 1, 1};
+      lzt::set_argument_value(kernel, 0, sizeof(chunks[i]), &chunks[i]);
+      lzt::append_launch_function(cmd_bundle.list, kernel, &group_count,
+                                  nullptr, 0, nullptr);
+    }
+    lzt::close_command_list(cmd_bundle.list);
+
+    // Zero on the host, so that the first pass starts from system memory
+    for (size_t i = 0; i < chunks.size(); i++) {
+      memset(chunks[i], 0, std::min(chunk_size, size - i * chunk_size));
+    }
+
+    OvercommitPoint point = {ratio, size, 0, 0, 0};
+    for (int pass = 0; pass < passes; pass++) {
+      const auto start = overcommit_clock::now();
+      lzt::execute_and_sync_command_bundle(cmd_bundle, UINT64_MAX);
+      const double pass_s = elapsed_s(start);
+      if (pass == 0) {
+        point.first_pass_s = pass_s;
+      } else {
+        point.steady_pass_s += pass_s / (passes - 1);
+      }
+    }
+    // Every element read and written once per pass
+    point.steady_gbps = 2.0 * size / point.steady_pass_s / 1e9;
+
+    // Spot check one word every chunk_size / 16 bytes after the timing,
+    // as the host reads migrate the pages back
+    size_t mismatches = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+      const size_t bytes = std::min(chunk_size, size - i * chunk_size);
+      auto words = static_cast<uint32_t *>(chunks[i]);
+      for (size_t offset = 0; offset < bytes; offset += chunk_size / 16) {
+        mismatches += (words[offset / sizeof(uint32_t)] != passes);
+      }
+    }
+    EXPECT_EQ(0u, mismatches) << "corrupted data at " << ratio << "x";
+
+    points.push_back(point);
+    free_chunks(chunks);
+  }
+
+  std::stringstream table;
+  table << std::fixed << std::setprecision(3);
+  table << "\n   ratio        bytes   first pass s   steady pass s   GB/s";
+  for (auto &point : points) {
+    table << "\n" << std::setw(7) << point.ratio << "x" << std::setw(13)
+          << point.size << std::setw(15) << point.first_pass_s
+          << std::setw(16) << point.steady_pass_s << std::setw(7)
+          << point.steady_gbps;
+  }
+  LOG_INFO << "Memory oversubscription profile of " << device_memory
+           << " bytes of device memory:" << table.str();
+
+  if (!points.empty()) {
+    const double baseline_gbps = points.front().steady_gbps;
+    auto cliff = std::find_if(
+        points.begin(), points.end(), [&](const OvercommitPoint &point) {
+          return point.steady_gbps < baseline_gbps / 2;
+        });
+    if (cliff == points.end()) {
+      LOG_INFO << "No bandwidth cliff up to " << points.back().ratio << "x";
+    } else {
+      LOG_INFO << "Bandwidth cliff at " << cliff->ratio << "x: "
+               << cliff->steady_gbps << " GB/s against " << baseline_gbps
+               << " GB/s at " << points.front().ratio << "x";
+    }
+  }
+
+  lzt::destroy_command_bundle(cmd_bundle);
+  lzt::destroy_function(kernel);
+  lzt::destroy_module(module);
+}
+
+} // namespace
@@ -0,0 +1,47 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+ulong __spirv_SpecConstant(int, ulong);
+
+// Sums 64 specialization constants with ids 0 to 63, each defaulting to 1
+kernel void module_spec_constants(global ulong *output) {
+  ulong sum = 0;
+  sum += __spirv_SpecConstant(0, 1) + __spirv_SpecConstant(1, 1) +
+         __spirv_SpecConstant(2, 1) + __spirv_SpecConstant(3, 1);
+  sum += __spirv_SpecConstant(4, 1) + __spirv_SpecConstant(5, 1) +
+         __spirv_SpecConstant(6, 1) + __spirv_SpecConstant(7, 1);
+  sum += __spirv_SpecConstant(8, 1) + __spirv_SpecConstant(9, 1) +
+         __spirv_SpecConstant(10, 1) + __spirv_SpecConstant(11, 1);
+  sum += __spirv_SpecConstant(12, 1) + __spirv_SpecConstant(13, 1) +
+         __spirv_SpecConstant(14, 1) + __spirv_SpecConstant(15, 1);
+  sum += __spirv_SpecConstant(16, 1) + __spirv_SpecConstant(17, 1) +
+         __spirv_SpecConstant(18, 1) + __spirv_SpecConstant(19, 1);
+  sum += __spirv_SpecConstant(20, 1) + __spirv_SpecConstant(21, 1) +
+         __spirv_SpecConstant(22, 1) + __spirv_SpecConstant(23, 1);
+  sum += __spirv_SpecConstant(24, 1) + __spirv_SpecConstant(25, 1) +
+         __spirv_SpecConstant(26, 1) + __spirv_SpecConstant(27, 1);
+  sum += __spirv_SpecConstant(28, 1) + __spirv_SpecConstant(29, 1) +
+         __spirv_SpecConstant(30, 1) + __spirv_SpecConstant(31, 1);
+  sum += __spirv_SpecConstant(32, 1) + __spirv_SpecConstant(33, 1) +
+         __spirv_SpecConstant(34, 1) + __spirv_SpecConstant(35, 1);
+  sum += __spirv_SpecConstant(36, 1) + __spirv_SpecConstant(37, 1) +
+         __spirv_SpecConstant(38, 1) + __spirv_SpecConstant(39, 1);
+  sum += __spirv_SpecConstant(40, 1) + __spirv_SpecConstant(41, 1) +
+         __spirv_SpecConstant(42, 1) + __spirv_SpecConstant(43, 1);
+  sum += __spirv_SpecConstant(44, 1) + __spirv_SpecConstant(45, 1) +
+         __spirv_SpecConstant(46, 1) + __spirv_SpecConstant(47, 1);
+  sum += __spirv_SpecConstant(48, 1) + __spirv_SpecConstant(49, 1) +
+         __spirv_SpecConstant(50, 1) + __spirv_SpecConstant(51, 1);
+  sum += __spirv_SpecConstant(52, 1) + __spirv_SpecConstant(53, 1) +
+         __spirv_SpecConstant(54, 1) + __spirv_SpecConstant(55, 1);
+  sum += __spirv_SpecConstant(56, 1) + __spirv_SpecConstant(57, 1) +
+         __spirv_SpecConstant(58, 1) + __spirv_SpecConstant(59, 1);
+  sum += __spirv_SpecConstant(60, 1) + __spirv_SpecConstant(61, 1) +
+         __spirv_SpecConstant(62, 1) + __spirv_SpecConstant(63, 1);
+  *output = sum;
+}
@@ -0,0 +1,291 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock build_clock;
+
+const int build_repetitions = 5;
+
+double elapsed_ms(build_clock::time_point start) {
+  const auto elapsed = build_clock::now() - start;
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+// Modules are built with zeModuleCreate directly, so that every build
+// reaches the compiler where lzt::create_module may reuse a native binary
+// cached by an earlier build of the same SPIR-V
+class zeModuleBuildPerformanceTests : public ::testing::Test {
+protected:
+  void SetUp() override {
+    context_ = lzt::get_default_context();
+    device_ = lzt::zeDevice::get_instance()->get_device();
+  }
+
+  ze_module_handle_t build(ze_module_format_t format,
+                           const std::vector<uint8_t> &input,
+                           const char *build_flags,
+                           const ze_module_constants_t *constants,
+                           double *build_ms) {
+    ze_module_desc_t module_description = {};
+    module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+    module_description.format = format;
+    module_description.inputSize = input.size();
+    module_description.pInputModule = input.data();
+    module_description.pBuildFlags = build_flags;
+    module_description.pConstants = constants;
+    ze_module_handle_t module = nullptr;
+    ze_module_build_log_handle_t build_log = nullptr;
+
+    const auto start = build_clock::now();
+    const ze_result_t result = zeModuleCreate(
+        context_, device_, &module_description, &module, &build_log);
+    if (build_ms) {
+      *build_ms = elapsed_ms(start);
+    }
+    if (result != ZE_RESULT_SUCCESS && build_log) {
+      LOG_ERROR << lzt::get_build_log_string(build_log);
+    }
+    if (build_log) {
+      lzt::destroy_build_log(build_log);
+    }
+    EXPECT_EQ(ZE_RESULT_SUCCESS, result);
+    return module;
+  }
+
+  // Returns the median time in ms of build_repetitions builds of the input
+  double time_builds(ze_module_format_t format,
+                     const std::vector<uint8_t> &input,
+                     const char *build_flags,
+                     const ze_module_constants_t *constants) {
+    std::vector<double> build_times;
+    for (int i = 0; i < build_repetitions; i++) {
+      double build_ms = 0;
+      auto module = build(format, input, build_flags, constants, &build_ms);
+      build_times.push_back(build_ms);
+      if (module) {
+        lzt::destroy_module(module);
+      }
+    }
+    return lzt::median(build_times);
+  }
+
+  std::vector<uint8_t> get_native_binary(ze_module_handle_t module) {
+    size_t size = 0;
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeModuleGetNativeBinary(module, &size, nullptr));
+    std::vector<uint8_t> binary(size);
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeModuleGetNativeBinary(module, &size, binary.data()));
+    return binary;
+  }
+
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+};
+
+TEST_F(
+    zeModuleBuildPerformanceTests,
+    GivenSpirvModulesOfIncreasingSizeWhenBuildingAndReloadingNativeBinaryThenReportBuildTimes) {
+  for (const std::string name :
+       {"1kernel", "10kernels", "100kernels", "1000kernels"}) {
+    const auto spirv = lzt::load_binary_file(name + ".spv");
+    ASSERT_FALSE(spirv.empty());
+    const double spirv_ms =
+        time_builds(ZE_MODULE_FORMAT_IL_SPIRV, spirv, nullptr, nullptr);
+
+    auto module =
+        build(ZE_MODULE_FORMAT_IL_SPIRV, spirv, nullptr, nullptr, nullptr);
+    ASSERT_NE(nullptr, module);
+    const auto native_binary = get_native_binary(module);
+    lzt::destroy_module(module);
+    const double native_ms =
+        time_builds(ZE_MODULE_FORMAT_NATIVE, native_binary, nullptr, nullptr);
+
+    LOG_INFO << name << ": " << spirv.size() << " bytes of SPIR-V built in "
+             << spirv_ms << " ms (" << spirv.size() / spirv_ms
+             << " bytes per ms), " << native_binary.size()
+             << " bytes of native binary reloaded in " << native_ms
+             << " ms (" << spirv_ms / native_ms << "x faster)";
+  }
+}
+
+TEST_F(zeModuleBuildPerformanceTests,
+       GivenBuildFlagSetsWhenBuildingModuleThenReportBuildTimePerFlagSet) {
+  const auto spirv = lzt::load_binary_file("module_add.spv");
+  ASSERT_FALSE(spirv.empty());
+  for (const char *build_flags :
+       {"", "-ze-opt-disable", "-ze-opt-level=0", "-ze-opt-level=2",
+        "-ze-opt-large-register-file",
+        "-ze-opt-greater-than-4GB-buffer-required"}) {
+    const double build_ms =
+        time_builds(ZE_MODULE_FORMAT_IL_SPIRV, spirv, build_flags, nullptr);
+    auto module =
+        build(ZE_MODULE_FORMAT_IL_SPIRV, spirv, build_flags, nullptr, nullptr);
+    ASSERT_NE(nullptr, module);
+    const size_t native_size = lzt::get_native_binary_size(module);
+    lzt::destroy_module(module);
+    LOG_INFO << "Build flags \"" << build_flags << "\": " << build_ms
+             << " ms, native binary of " << native_size << " bytes";
+  }
+}
+
+TEST_F(
+    zeModuleBuildPerformanceTests,
+    GivenIncreasingSpecConstantCountsWhenBuildingModuleThenReportBuildTimeAndConstantsAreApplied) {
+  // module_spec_constants sums 64 constants, each defaulting to 1
+  const uint32_t total_constants = 64;
+  const auto spirv = lzt::load_binary_file("module_spec_constants.spv");
+  ASSERT_FALSE(spirv.empty());
+  std::vector<uint32_t> ids(total_constants);
+  const uint64_t value = 2;
+  std::vector<const void *> values(total_constants, &value);
+  for (uint32_t i = 0; i < total_constants; i++) {
+    ids[i] = i;
+  }
+  auto output = lzt::allocate_host_memory(sizeof(uint64_t));
+
+  for (uint32_t count : {0u, 1u, 4u, 16u, 64u}) {
+    ze_module_constants_t constants = {count, ids.data(), values.data()};
+    const double build_ms =
+        time_builds(ZE_MODULE_FORMAT_IL_SPIRV, spirv, nullptr, &constants);
+
+    auto module =
+        build(ZE_MODULE_FORMAT_IL_SPIRV, spirv, nullptr, &constants, nullptr);
+    ASSERT_NE(nullptr, module);
+    *static_cast<uint64_t *>(output) = 0;
+    lzt::create_and_execute_function(device_, module, "module_spec_constants",
+                                     1, output, false);
+    EXPECT_EQ(total_constants + count * (value - 1),
+              *static_cast<uint64_t *>(output));
+    lzt::destroy_module(module);
+    LOG_INFO << count << " of " << total_constants
+             << " specialization constants set: " << build_ms << " ms";
+  }
+  lzt::free_memory(output);
+}
+
+TEST_F(
+    zeModuleBuildPerformanceTests,
+    GivenModulesWithLinkageDependenciesWhenDynamicallyLinkingThenReportBuildAndLinkTimes) {
+  const auto import_spirv = lzt::load_binary_file("import_kernel.spv");
+  const auto export_spirv = lzt::load_binary_file("export_kernel.spv");
+  ASSERT_FALSE(import_spirv.empty());
+  ASSERT_FALSE(export_spirv.empty());
+  auto result = static_cast<int *>(lzt::allocate_host_memory(sizeof(int)));
+
+  std::vector<double> import_times, export_times, link_times;
+  for (int i = 0; i < build_repetitions; i++) {
+    double import_ms = 0;
+    double export_ms = 0;
+    ze_module_handle_t modules[2] = {
+        build(ZE_MODULE_FORMAT_IL_SPIRV, import_spirv, nullptr, nullptr,
+              &import_ms),
+        // Exported functions are only visible to other modules when
+        // compiled as a library
+        build(ZE_MODULE_FORMAT_IL_SPIRV, export_spirv, "-library-compilation",
+              nullptr, &export_ms)};
+    ASSERT_NE(nullptr, modules[0]);
+    ASSERT_NE(nullptr, modules[1]);
+
+    ze_module_build_log_handle_t link_log = nullptr;
+    const auto start = build_clock::now();
+    const ze_result_t link_result = zeModuleDynamicLink(2, modules, &link_log);
+    link_times.push_back(elapsed_ms(start));
+    import_times.push_back(import_ms);
+    export_times.push_back(export_ms);
+    if (link_result != ZE_RESULT_SUCCESS && link_log) {
+      LOG_ERROR << lzt::get_build_log_string(link_log);
+    }
+    if (link_log) {
+      lzt::destroy_build_log(link_log);
+    }
+    ASSERT_EQ(ZE_RESULT_SUCCESS, link_result);
+
+    int x = i + 1;
+    int y = 2 * i + 3;
+    *result = 0;
+    std::vector<lzt::FunctionArg> args = {
+        {sizeof(x), &x}, {sizeof(y), &y}, {sizeof(result), &result}};
+    lzt::create_and_execute_function(device_, modules[0], "import_function", 1,
+                                     args, false);
+    EXPECT_EQ(x + y, *result);
+    lzt::destroy_module(modules[0]);
+    lzt::destroy_module(modules[1]);
+  }
+  LOG_INFO << "Import module built in " << lzt::median(import_times)
+           << " ms, export module in " << lzt::median(export_times)
+           << " ms, zeModuleDynamicLink in " << lzt::median(link_times)
+           << " ms";
+  lzt::free_memory(result);
+}
+
+TEST_F(
+    zeModuleBuildPerformanceTests,
+    GivenConcurrentThreadsWhenBuildingModulesThenReportBuildThroughputScaling) {
+  const auto spirv = lzt::load_binary_file("100kernels.spv");
+  ASSERT_FALSE(spirv.empty());
+  const uint32_t max_threads =
+      std::max(1u, std::thread::hardware_concurrency());
+
+  double single_thread_rate = 0;
+  for (uint32_t thread_count : {1u, 2u, 4u, 8u, 16u}) {
+    if (thread_count > max_threads) {
+      break;
+    }
+    std::vector<std::vector<double>> build_times(thread_count);
+    std::vector<std::thread> threads;
+    const auto start = build_clock::now();
+    for (uint32_t t = 0; t < thread_count; t++) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < build_repetitions; i++) {
+          double build_ms = 0;
+          auto module = build(ZE_MODULE_FORMAT_IL_SPIRV, spirv, nullptr,
+                              nullptr, &build_ms);
+          build_times[t].push_back(build_ms);
+          if (module) {
+            lzt::destroy_module(module);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    const double total_ms = elapsed_ms(start);
+
+    std::vector<double> all_times;
+    for (auto &times : build_times) {
+      all_times.insert(all_times.end(), times.begin(), times.end());
+    }
+    const double rate = thread_count * build_repetitions * 1000.0 / total_ms;
+    if (thread_count == 1) {
+      single_thread_rate = rate;
+    }
+    LOG_INFO << thread_count << " threads: " << rate
+             << " builds per second, median build " << lzt::median(all_times)
+             << " ms, " << rate / single_thread_rate
+             << "x the single thread throughput";
+  }
+}
+
+} // namespace
@@ -19,6 +19,9 @@ namespace fs = boost::filesystem;
 
 #include <level_zero/ze_api.h>
 
+#include <algorithm>
+#include <sstream>
+
 namespace {
 
 constexpr size_t num_processes = 8;
@@ -70,4 +73,70 @@ TEST(
   RunGivenMultipleProcessesUsingMultipleDevicesKernelsTest(0, 1);
 }
 
+// Jain's fairness index, 1 when every process gets the same throughput
+double fairness_index(const std::vector<double> &throughputs) {
+  double sum = 0, sum_of_squares = 0;
+  for (auto throughput : throughputs) {
+    sum += throughput;
+    sum_of_squares += throughput * throughput;
+  }
+  return (sum_of_squares > 0)
+             ? sum * sum / (throughputs.size() * sum_of_squares)
+             : 0;
+}
+
+TEST(
+    MultiProcessTests,
+    GivenMultipleProcessesSubmittingKernelsAndCopiesThenThroughputAndFairnessAreReported) {
+  std::array<bp::ipstream, num_processes> outputs;
+  std::vector<bp::child> processes;
+  fs::path helper_path(fs::current_path() / "process");
+  std::vector<fs::path> paths;
+  paths.push_back(helper_path);
+
+  for (int i = 0; i < num_processes; i++) {
+    auto env = boost::this_process::environment();
+    bp::environment child_env = env;
+    child_env["ZE_ENABLE_PCI_ID_DEVICE_ORDER"] = "1";
+    fs::path helper = bp::search_path("test_process_helper", paths);
+    bp::child timing_process(
+        helper, bp::args({std::to_string(i), "0", "0", "1"}), child_env,
+        bp::std_out > outputs[i]);
+    processes.push_back(std::move(timing_process));
+  }
+
+  // Every child prints one line with the ops/s, p50 and p99 latency in us
+  // of its kernel and copy workloads
+  const char *workload_names[2] = {"kernel", "copy"};
+  std::vector<double> throughputs[2];
+  for (int i = 0; i < num_processes; i++) {
+    std::string line;
+    while (std::getline(outputs[i], line) && line.rfind("timing", 0) != 0) {
+    }
+    processes[i].wait();
+    EXPECT_EQ(processes[i].exit_code(), 0);
+
+    std::istringstream fields(line.substr(std::min(line.size(), size_t(6))));
+    for (int workload = 0; workload < 2; workload++) {
+      double rate = 0, p50 = 0, p99 = 0;
+      fields >> rate >> p50 >> p99;
+      EXPECT_GT(rate, 0) << "No timing from process " << i;
+      throughputs[workload].push_back(rate);
+      LOG_INFO << "Process " << i << " " << workload_names[workload] << ": "
+               << rate << " ops/s, latency p50 " << p50 << " us, p99 " << p99
+               << " us";
+    }
+  }
+
+  for (int workload = 0; workload < 2; workload++) {
+    double aggregate = 0;
+    for (auto rate : throughputs[workload]) {
+      aggregate += rate;
+    }
+    LOG_INFO << num_processes << " processes " << workload_names[workload]
+             << ": aggregate " << aggregate << " ops/s, fairness "
+             << fairness_index(throughputs[workload]);
+  }
+}
+
 } // namespace
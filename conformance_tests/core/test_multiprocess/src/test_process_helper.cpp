@@ -10,6 +10,66 @@
 #include "test_harness/test_harness.hpp"
 #include "logging/logging.hpp"
 
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+const std::chrono::seconds timing_duration(3);
+const size_t timing_copy_size = 4 * 1024 * 1024;
+
+// Executes the kernel and a device copy in turn for a fixed time, each on
+// its own regular command list, and prints the throughput and latency
+// percentiles of both on one line for the parent:
+// timing <kernel ops/s> <p50 us> <p99 us> <copy ops/s> <p50 us> <p99 us>
+void run_timing_workload(ze_device_handle_t device, ze_kernel_handle_t kernel,
+                         ze_group_count_t group_count) {
+  auto context = lzt::get_default_context();
+  auto kernel_bundle = lzt::create_command_bundle(device, false);
+  lzt::append_launch_function(kernel_bundle.list, kernel, &group_count,
+                              nullptr, 0, nullptr);
+  lzt::close_command_list(kernel_bundle.list);
+
+  auto copy_source = lzt::allocate_device_memory(timing_copy_size, 8, 0, 0,
+                                                 device, context);
+  auto copy_destination = lzt::allocate_device_memory(timing_copy_size, 8, 0,
+                                                      0, device, context);
+  auto copy_bundle = lzt::create_command_bundle(device, false);
+  lzt::append_memory_copy(copy_bundle.list, copy_destination, copy_source,
+                          timing_copy_size);
+  lzt::close_command_list(copy_bundle.list);
+
+  std::vector<double> latencies[2];
+  lzt::zeCommandBundle *bundles[2] = {&kernel_bundle, &copy_bundle};
+  const auto start = std::chrono::steady_clock::now();
+  auto now = start;
+  while (now - start < timing_duration) {
+    for (int i = 0; i < 2; i++) {
+      const auto operation_start = std::chrono::steady_clock::now();
+      lzt::execute_and_sync_command_bundle(*bundles[i], UINT64_MAX);
+      now = std::chrono::steady_clock::now();
+      latencies[i].push_back(
+          std::chrono::duration<double, std::micro>(now - operation_start)
+              .count());
+    }
+  }
+  const double seconds = std::chrono::duration<double>(now - start).count();
+
+  std::cout << "timing";
+  for (auto &values : latencies) {
+    std::cout << " " << values.size() / seconds << " "
+              << lzt::median(values) << " " << lzt::percentile(values, 99);
+  }
+  std::cout << std::endl;
+
+  lzt::destroy_command_bundle(copy_bundle);
+  lzt::free_memory(context, copy_destination);
+  lzt::free_memory(context, copy_source);
+  lzt::destroy_command_bundle(kernel_bundle);
+}
+
+} // namespace
+
 int main(int argc, char **argv) {
 
   ze_result_t result = zeInit(0);
@@ -21,6 +81,7 @@ int main(int argc, char **argv) {
   int proc_number = std::stoi(argv[1]);
   bool is_immediate = std::stoi(argv[2]) == 0 ? false : true;
   bool is_stress_test = std::stoi(argv[3]) == 0 ? false : true;
+  bool is_timing_test = argc > 4 && std::stoi(argv[4]) != 0;
 
   auto driver = lzt::get_default_driver();
   auto device_0 = lzt::get_devices(driver)[0];
@@ -69,6 +130,12 @@ int main(int argc, char **argv) {
   lzt::set_argument_value(kernel, 0, sizeof(input_a), &input_a);
   lzt::set_argument_value(kernel, 1, sizeof(input_b), &input_b);
 
+  if (is_timing_test) {
+    run_timing_workload(device, kernel, group_count);
+    lzt::destroy_command_bundle(cmd_bundle);
+    exit(0);
+  }
+
   if (is_stress_test) {
     for (int i = 0; i < 10; i++) {
       lzt::append_launch_function(cmd_bundle.list, kernel, &group_count,
@@ -0,0 +1,156 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <level_zero/ze_api.h>
+
+namespace lzt = level_zero_tests;
+
+namespace {
+
+const int num_operations_per_thread = 500;
+const uint32_t appends_per_list = 64;
+const size_t allocation_size = 64 * 1024;
+
+enum scaling_operation_t {
+  SCALING_LIST_CREATE,
+  SCALING_APPEND,
+  SCALING_KERNEL_CREATE,
+  SCALING_ALLOCATION
+};
+
+std::string to_string(scaling_operation_t operation) {
+  switch (operation) {
+  case SCALING_LIST_CREATE:
+    return "command list create/destroy";
+  case SCALING_APPEND:
+    return "command list append";
+  case SCALING_KERNEL_CREATE:
+    return "kernel create/destroy";
+  default:
+    return "device allocation/free";
+  }
+}
+
+void thread_list_create(ze_context_handle_t context,
+                        ze_device_handle_t device) {
+  for (int i = 0; i < num_operations_per_thread; i++) {
+    auto command_list = lzt::create_command_list(context, device, 0);
+    lzt::destroy_command_list(command_list);
+  }
+}
+
+void thread_append(ze_context_handle_t context, ze_device_handle_t device) {
+  auto command_list = lzt::create_command_list(context, device, 0);
+  for (int i = 0; i < num_operations_per_thread; i++) {
+    if (i % appends_per_list == 0) {
+      lzt::reset_command_list(command_list);
+    }
+    lzt::append_barrier(command_list, nullptr);
+  }
+  lzt::destroy_command_list(command_list);
+}
+
+void thread_kernel_create(ze_module_handle_t module) {
+  for (int i = 0; i < num_operations_per_thread; i++) {
+    auto kernel = lzt::create_function(module, "fill_device_memory");
+    lzt::destroy_function(kernel);
+  }
+}
+
+void thread_allocation(ze_context_handle_t context,
+                       ze_device_handle_t device) {
+  for (int i = 0; i < num_operations_per_thread; i++) {
+    auto memory = lzt::allocate_device_memory(allocation_size, 8, 0, 0, device,
+                                              context);
+    lzt::free_memory(context, memory);
+  }
+}
+
+// Runs the operation from 1 up to hardware_concurrency threads and reports
+// the operations per second and the parallel efficiency of every thread
+// count.  Only correctness is checked, so slow drivers still pass.
+class zeMultithreadScalingTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<scaling_operation_t> {};
+
+TEST_P(
+    zeMultithreadScalingTests,
+    GivenIncreasingThreadCountsWhenRunningDriverOperationsThenReportThroughput) {
+  const scaling_operation_t operation = GetParam();
+  auto context = lzt::get_default_context();
+  auto device = lzt::zeDevice::get_instance()->get_device();
+  auto module = lzt::create_module(device,
+                                   "test_fill_device_memory_multi_thread.spv");
+
+  const uint32_t max_threads =
+      std::max(1u, std::thread::hardware_concurrency());
+  std::vector<uint32_t> thread_counts;
+  for (uint32_t count = 1; count < max_threads; count *= 2) {
+    thread_counts.push_back(count);
+  }
+  thread_counts.push_back(max_threads);
+
+  double single_thread_rate = 0;
+  for (auto thread_count : thread_counts) {
+    std::vector<std::unique_ptr<std::thread>> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < thread_count; i++) {
+      switch (operation) {
+      case SCALING_LIST_CREATE:
+        threads.push_back(
+            std::make_unique<std::thread>(thread_list_create, context, device));
+        break;
+      case SCALING_APPEND:
+        threads.push_back(
+            std::make_unique<std::thread>(thread_append, context, device));
+        break;
+      case SCALING_KERNEL_CREATE:
+        threads.push_back(
+            std::make_unique<std::thread>(thread_kernel_create, module));
+        break;
+      default:
+        threads.push_back(
+            std::make_unique<std::thread>(thread_allocation, context, device));
+        break;
+      }
+    }
+    for (auto &thread : threads) {
+      thread->join();
+    }
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+    const double rate = thread_count * num_operations_per_thread / seconds;
+    if (thread_count == 1) {
+      single_thread_rate = rate;
+    }
+    LOG_INFO << to_string(operation) << " with " << thread_count
+             << " threads: " << rate << " ops/s, parallel efficiency "
+             << 100 * rate / (thread_count * single_thread_rate) << "%";
+  }
+
+  lzt::destroy_module(module);
+}
+
+INSTANTIATE_TEST_CASE_P(TestCasesforMultithreadScaling,
+                        zeMultithreadScalingTests,
+                        testing::Values(SCALING_LIST_CREATE, SCALING_APPEND,
+                                        SCALING_KERNEL_CREATE,
+                                        SCALING_ALLOCATION));
+
+} // namespace
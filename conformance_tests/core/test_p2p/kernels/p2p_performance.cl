@@ -0,0 +1,51 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+kernel void p2p_atomic_add(global int *counters, uint counter_mask,
+                           uint iterations) {
+  const uint index = get_global_id(0) & counter_mask;
+  for (uint i = 0; i < iterations; i++) {
+    atomic_add(&counters[index], 1);
+  }
+}
+
+kernel void p2p_copy_uchar(global uchar *dst, global uchar *src, ulong count) {
+  for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+    dst[i] = src[i];
+  }
+}
+
+kernel void p2p_copy_uint(global uint *dst, global uint *src, ulong count) {
+  for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+    dst[i] = src[i];
+  }
+}
+
+kernel void p2p_copy_ulong2(global ulong2 *dst, global ulong2 *src,
+                            ulong count) {
+  for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+    dst[i] = src[i];
+  }
+}
+
+kernel void p2p_copy_ulong8(global ulong8 *dst, global ulong8 *src,
+                            ulong count) {
+  for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+    dst[i] = src[i];
+  }
+}
+
+// A single work item follows the chain, so every load waits for the last
+kernel void p2p_pointer_chase(global ulong *chain, ulong steps,
+                              global ulong *result) {
+  ulong index = 0;
+  for (ulong i = 0; i < steps; i++) {
+    index = chain[index];
+  }
+  result[0] = index;
+}
@@ -0,0 +1,298 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+// Measures the fine-grained access of a device to the memory of its peer,
+// with the same kernels run on local memory as the reference: atomics
+// throughput, load and store bandwidth per access size, and the latency of
+// dependent loads.  Only correctness is checked, the numbers are reported.
+class zeP2PPerformanceTests : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto driver = lzt::get_default_driver();
+    context_ = lzt::get_default_context();
+    auto devices = lzt::get_ze_devices(driver);
+    if (devices.size() < 2) {
+      GTEST_SKIP() << "WARNING:  Exiting test due to lack of multiple devices";
+    }
+
+    for (auto device : devices) {
+      for (auto peer : devices) {
+        if (device == peer || !lzt::can_access_peer(device, peer)) {
+          continue;
+        }
+        auto p2p_properties = lzt::get_p2p_properties(device, peer);
+        if (p2p_properties.flags & ZE_DEVICE_P2P_PROPERTY_FLAG_ACCESS) {
+          device_ = device;
+          peer_ = peer;
+          peer_atomics_ =
+              p2p_properties.flags & ZE_DEVICE_P2P_PROPERTY_FLAG_ATOMICS;
+          break;
+        }
+      }
+      if (device_) {
+        break;
+      }
+    }
+    if (!device_) {
+      GTEST_SKIP() << "WARNING:  Exiting as no peer-to-peer access capability";
+    }
+
+    module_ = lzt::create_module(context_, device_, "p2p_performance.spv",
+                                 ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+    event_pool_ = lzt::create_event_pool(
+        context_, 1,
+        ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    event_ = lzt::create_event(event_pool_, event_desc);
+    cmd_bundle_ = lzt::create_command_bundle(context_, device_, false);
+  }
+
+  void TearDown() override {
+    if (!device_) {
+      return;
+    }
+    lzt::destroy_command_bundle(cmd_bundle_);
+    lzt::destroy_event(event_);
+    lzt::destroy_event_pool(event_pool_);
+    lzt::destroy_module(module_);
+  }
+
+  // Launches the kernel twice on the local device, returning the time of
+  // the second launch in ns, so that the first one warms up the caches and
+  // the page tables
+  double time_kernel(ze_kernel_handle_t kernel, ze_group_count_t group_count) {
+    lzt::reset_command_list(cmd_bundle_.list);
+    lzt::event_host_reset(event_);
+    lzt::append_launch_function(cmd_bundle_.list, kernel, &group_count,
+                                nullptr, 0, nullptr);
+    lzt::append_barrier(cmd_bundle_.list, nullptr);
+    lzt::append_launch_function(cmd_bundle_.list, kernel, &group_count, event_,
+                                0, nullptr);
+    lzt::close_command_list(cmd_bundle_.list);
+    lzt::execute_and_sync_command_bundle(cmd_bundle_, UINT64_MAX);
+    return lzt::get_timestamp_clock(device_).duration_ns(
+        lzt::get_event_kernel_timestamp(event_).global);
+  }
+
+  void copy_memory(void *destination, const void *source, size_t size) {
+    lzt::reset_command_list(cmd_bundle_.list);
+    lzt::append_memory_copy(cmd_bundle_.list, destination, source, size);
+    lzt::close_command_list(cmd_bundle_.list);
+    lzt::execute_and_sync_command_bundle(cmd_bundle_, UINT64_MAX);
+  }
+
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+  ze_device_handle_t peer_ = nullptr;
+  bool peer_atomics_ = false;
+  ze_module_handle_t module_ = nullptr;
+  ze_event_pool_handle_t event_pool_ = nullptr;
+  ze_event_handle_t event_ = nullptr;
+  lzt::zeCommandBundle cmd_bundle_ = {};
+  const uint32_t group_size_x_ = 256;
+};
+
+class zeP2PAtomicPerformanceTests
+    : public zeP2PPerformanceTests,
+      public ::testing::WithParamInterface<uint32_t> {};
+
+TEST_P(
+    zeP2PAtomicPerformanceTests,
+    GivenPeerMemoryWhenIncrementingCountersWithAtomicsThenReportAtomicThroughput) {
+  if (!peer_atomics_) {
+    GTEST_SKIP() << "WARNING:  Exiting as no peer-to-peer atomics capability";
+  }
+  // Every work item increments the counter its id masks to, so that the
+  // counter count sets the contention
+  const uint32_t counter_count = GetParam();
+  const uint32_t counter_mask = counter_count - 1;
+  const uint32_t iterations = 256;
+  const uint32_t group_count_x = 256;
+  const uint64_t operations =
+      2ULL * group_count_x * group_size_x_ * iterations;
+
+  ze_kernel_handle_t kernel = lzt::create_function(module_, "p2p_atomic_add");
+  lzt::set_group_size(kernel, group_size_x_, 1, 1);
+  lzt::set_argument_value(kernel, 1, sizeof(counter_mask), &counter_mask);
+  lzt::set_argument_value(kernel, 2, sizeof(iterations), &iterations);
+  ze_group_count_t group_count = {group_count_x, 1, 1};
+
+  std::vector<uint32_t> counters(counter_count, 0);
+  for (auto owner : {device_, peer_}) {
+    void *memory = lzt::allocate_device_memory(
+        counter_count * sizeof(uint32_t), 1, 0, 0, owner, context_);
+    copy_memory(memory, counters.data(), counter_count * sizeof(uint32_t));
+    lzt::set_argument_value(kernel, 0, sizeof(memory), &memory);
+    const double ns = time_kernel(kernel, group_count);
+
+    std::vector<uint32_t> result(counter_count, 0);
+    copy_memory(result.data(), memory, counter_count * sizeof(uint32_t));
+    const uint64_t total =
+        std::accumulate(result.begin(), result.end(), uint64_t(0));
+    EXPECT_EQ(operations, total);
+
+    // Only the second of the two launches is timed
+    LOG_INFO << ((owner == device_) ? "Local" : "Remote") << " atomics on "
+             << counter_count << " counters: " << operations / 2 / ns * 1e9
+             << " ops/s";
+    lzt::free_memory(context_, memory);
+  }
+  lzt::destroy_function(kernel);
+}
+
+INSTANTIATE_TEST_CASE_P(TestP2PAtomicPerformance, zeP2PAtomicPerformanceTests,
+                        ::testing::Values(1, 64, 4096));
+
+class zeP2PBandwidthPerformanceTests
+    : public zeP2PPerformanceTests,
+      public ::testing::WithParamInterface<std::tuple<std::string, size_t>> {};
+
+TEST_P(
+    zeP2PBandwidthPerformanceTests,
+    GivenPeerMemoryWhenLoadingAndStoringWithKernelThenReportBandwidthPerAccessSize) {
+  const std::string kernel_name = std::get<0>(GetParam());
+  const size_t element_size = std::get<1>(GetParam());
+  const size_t size = 64 * 1024 * 1024;
+  const uint64_t count = size / element_size;
+
+  ze_kernel_handle_t kernel = lzt::create_function(module_, kernel_name);
+  lzt::set_group_size(kernel, group_size_x_, 1, 1);
+  lzt::set_argument_value(kernel, 2, sizeof(count), &count);
+  // The kernel strides over the buffer, a few waves of groups are enough
+  ze_group_count_t group_count = {
+      static_cast<uint32_t>(std::min<uint64_t>(count / group_size_x_, 4096)),
+      1, 1};
+
+  std::vector<uint8_t> pattern(size);
+  for (size_t i = 0; i < size; i++) {
+    pattern[i] = static_cast<uint8_t>(i * 7 + 1);
+  }
+  void *local =
+      lzt::allocate_device_memory(size, element_size, 0, 0, device_, context_);
+  void *remote =
+      lzt::allocate_device_memory(size, element_size, 0, 0, peer_, context_);
+  void *local_copy =
+      lzt::allocate_device_memory(size, element_size, 0, 0, device_, context_);
+
+  struct access_t {
+    const char *name;
+    void *destination;
+    void *source;
+  };
+  const access_t accesses[] = {{"local load/store", local_copy, local},
+                               {"remote load", local_copy, remote},
+                               {"remote store", remote, local}};
+  std::vector<uint8_t> result(size);
+  for (const auto &access : accesses) {
+    copy_memory(access.source, pattern.data(), size);
+    lzt::set_argument_value(kernel, 0, sizeof(access.destination),
+                            &access.destination);
+    lzt::set_argument_value(kernel, 1, sizeof(access.source), &access.source);
+    const double ns = time_kernel(kernel, group_count);
+
+    std::fill(result.begin(), result.end(), 0);
+    copy_memory(result.data(), access.destination, size);
+    EXPECT_EQ(0, memcmp(pattern.data(), result.data(), size))
+        << access.name << " corrupted data";
+
+    // Every byte is read once and written once
+    LOG_INFO << kernel_name << " " << access.name << ": " << 2 * size / ns
+             << " GB/s";
+  }
+
+  lzt::free_memory(context_, local_copy);
+  lzt::free_memory(context_, remote);
+  lzt::free_memory(context_, local);
+  lzt::destroy_function(kernel);
+}
+
+struct P2PBandwidthTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    return std::get<0>(info.param);
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestP2PBandwidthPerformance, zeP2PBandwidthPerformanceTests,
+    ::testing::Values(std::make_tuple("p2p_copy_uchar", 1),
+                      std::make_tuple("p2p_copy_uint", 4),
+                      std::make_tuple("p2p_copy_ulong2", 16),
+                      std::make_tuple("p2p_copy_ulong8", 64)),
+    P2PBandwidthTestNameSuffix());
+
+TEST_F(zeP2PPerformanceTests,
+       GivenPeerMemoryWhenChasingPointersThenReportRemoteLoadLatency) {
+  // One element per 64 byte line, linked in a random single cycle so that
+  // neither the caches nor the prefetchers can follow the chain
+  const size_t line_elements = 64 / sizeof(uint64_t);
+  const size_t line_count = 1024 * 1024;
+  const size_t size = line_count * line_elements * sizeof(uint64_t);
+  const uint64_t steps = 100000;
+
+  std::vector<uint64_t> lines(line_count);
+  std::iota(lines.begin(), lines.end(), 0);
+  std::shuffle(lines.begin(), lines.end(), std::mt19937_64(42));
+  std::vector<uint64_t> chain(line_count * line_elements, 0);
+  for (size_t i = 0; i < line_count; i++) {
+    chain[lines[i] * line_elements] =
+        lines[(i + 1) % line_count] * line_elements;
+  }
+  // The walk starts at element 0, wherever the cycle puts it
+  uint64_t expected_index = 0;
+  for (uint64_t i = 0; i < steps; i++) {
+    expected_index = chain[expected_index];
+  }
+
+  ze_kernel_handle_t kernel =
+      lzt::create_function(module_, "p2p_pointer_chase");
+  lzt::set_group_size(kernel, 1, 1, 1);
+  lzt::set_argument_value(kernel, 1, sizeof(steps), &steps);
+  void *result =
+      lzt::allocate_device_memory(sizeof(uint64_t), 8, 0, 0, device_, context_);
+  lzt::set_argument_value(kernel, 2, sizeof(result), &result);
+  ze_group_count_t group_count = {1, 1, 1};
+
+  for (auto owner : {device_, peer_}) {
+    void *memory = lzt::allocate_device_memory(size, 8, 0, 0, owner, context_);
+    copy_memory(memory, chain.data(), size);
+    lzt::set_argument_value(kernel, 0, sizeof(memory), &memory);
+    const double ns = time_kernel(kernel, group_count);
+
+    uint64_t index = 0;
+    copy_memory(&index, result, sizeof(index));
+    EXPECT_EQ(expected_index, index);
+    LOG_INFO << ((owner == device_) ? "Local" : "Remote")
+             << " dependent load latency: " << ns / steps << " ns";
+    lzt::free_memory(context_, memory);
+  }
+
+  lzt::free_memory(context_, result);
+  lzt::destroy_function(kernel);
+}
+
+} // namespace
@@ -0,0 +1,17 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// The allocations are reached through the table only, so the kernel needs
+// indirect access to device allocations
+kernel void residency_touch(global ulong *allocations, uint count) {
+  const uint tid = get_global_id(0);
+  if (tid < count) {
+    global uint *allocation = (global uint *)allocations[tid];
+    allocation[0] += 1;
+  }
+}
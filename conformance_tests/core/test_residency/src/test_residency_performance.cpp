@@ -0,0 +1,213 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace {
+
+typedef std::chrono::steady_clock residency_clock;
+
+double elapsed_us(residency_clock::time_point start) {
+  const auto elapsed = residency_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+// Times zeContextMakeMemoryResident and zeContextEvictMemory on a set of
+// device allocations, then the first launch of a kernel reaching all of them
+// indirectly, once with the allocations evicted, so that the driver has to
+// make them resident on submission, and once made resident beforehand.
+// The parameters are the size and the count of the allocations.
+class zeResidencyPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<std::tuple<size_t, uint32_t>> {
+protected:
+  void print_latencies(const std::string &name,
+                       const std::vector<double> &values) {
+    double total = 0;
+    for (auto value : values) {
+      total += value;
+    }
+    LOG_INFO << name << " of " << values.size() << " allocations of " << size_
+             << " bytes: total " << total << " us, per call p50 "
+             << lzt::median(values) << " us p99 "
+             << lzt::percentile(values, 99) << " us";
+  }
+
+  std::vector<double> make_resident_all() {
+    std::vector<double> latencies;
+    for (auto allocation : allocations_) {
+      const auto start = residency_clock::now();
+      lzt::make_memory_resident(device_, allocation, size_);
+      latencies.push_back(elapsed_us(start));
+    }
+    return latencies;
+  }
+
+  std::vector<double> evict_all() {
+    std::vector<double> latencies;
+    for (auto allocation : allocations_) {
+      const auto start = residency_clock::now();
+      lzt::evict_memory(device_, allocation, size_);
+      latencies.push_back(elapsed_us(start));
+    }
+    return latencies;
+  }
+
+  // Returns the host time from submission to completion of the list in us
+  double time_execution(ze_command_list_handle_t list) {
+    const auto start = residency_clock::now();
+    lzt::execute_command_lists(queue_, 1, &list, nullptr);
+    lzt::synchronize(queue_, UINT64_MAX);
+    return elapsed_us(start);
+  }
+
+  size_t size_ = 0;
+  ze_device_handle_t device_ = nullptr;
+  ze_command_queue_handle_t queue_ = nullptr;
+  std::vector<void *> allocations_;
+};
+
+TEST_P(
+    zeResidencyPerformanceTests,
+    GivenDeviceAllocationsWhenManagingResidencyExplicitlyThenReportCallAndFirstLaunchLatency) {
+  size_ = std::get<0>(GetParam());
+  const uint32_t count = std::get<1>(GetParam());
+  auto context = lzt::get_default_context();
+  device_ = lzt::zeDevice::get_instance()->get_device();
+
+  uint64_t device_memory = 0;
+  for (auto &properties : lzt::get_memory_properties(device_)) {
+    device_memory += properties.totalSize;
+  }
+  if (size_ * count > device_memory / 4) {
+    GTEST_SKIP() << count << " allocations of " << size_
+                 << " bytes exceed a quarter of the device memory";
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    allocations_.push_back(
+        lzt::allocate_device_memory(size_, 8, 0, 0, device_, context));
+  }
+  // The kernel finds the allocations through a host table, so none of them
+  // is a kernel argument the driver would make resident by itself
+  auto table = static_cast<uint64_t *>(
+      lzt::allocate_host_memory(count * sizeof(uint64_t), 8, context));
+  for (uint32_t i = 0; i < count; i++) {
+    table[i] = reinterpret_cast<uint64_t>(allocations_[i]);
+  }
+
+  queue_ = lzt::create_command_queue(context, device_, 0,
+                                     ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                                     ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+  auto init_list = lzt::create_command_list(context, device_, 0);
+  const uint32_t zero = 0;
+  for (auto allocation : allocations_) {
+    lzt::append_memory_fill(init_list, allocation, &zero, sizeof(zero),
+                            sizeof(zero), nullptr);
+  }
+  lzt::close_command_list(init_list);
+  time_execution(init_list);
+
+  auto module = lzt::create_module(context, device_,
+                                   "residency_performance.spv",
+                                   ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+  // With no allocation to touch and no indirect access, the first list only
+  // warms up the kernel without making anything resident
+  ze_kernel_handle_t warm_up_kernel =
+      lzt::create_function(module, "residency_touch");
+  ze_kernel_handle_t kernel = lzt::create_function(module, "residency_touch");
+  const uint32_t no_allocations = 0;
+  ze_group_count_t group_count = {(count + 63) / 64, 1, 1};
+  ze_command_list_handle_t lists[2];
+  ze_kernel_handle_t kernels[2] = {warm_up_kernel, kernel};
+  lzt::kernel_set_indirect_access(kernel,
+                                  ZE_KERNEL_INDIRECT_ACCESS_FLAG_DEVICE);
+  for (int i = 0; i < 2; i++) {
+    lzt::set_group_size(kernels[i], 64, 1, 1);
+    lzt::set_argument_value(kernels[i], 0, sizeof(table), &table);
+    lzt::set_argument_value(kernels[i], 1, sizeof(count),
+                            (i == 0) ? &no_allocations : &count);
+    lists[i] = lzt::create_command_list(context, device_, 0);
+    lzt::append_launch_function(lists[i], kernels[i], &group_count, nullptr, 0,
+                                nullptr);
+    lzt::close_command_list(lists[i]);
+  }
+
+  auto make_resident_latencies = make_resident_all();
+  print_latencies("zeContextMakeMemoryResident", make_resident_latencies);
+  auto evict_latencies = evict_all();
+  print_latencies("zeContextEvictMemory", evict_latencies);
+
+  time_execution(lists[0]);
+  const double evicted_us = time_execution(lists[1]);
+  evict_all();
+  time_execution(lists[0]);
+  const auto start = residency_clock::now();
+  make_resident_all();
+  const double residency_us = elapsed_us(start);
+  const double resident_us = time_execution(lists[1]);
+  LOG_INFO << "First launch over " << count << " allocations of " << size_
+           << " bytes: " << evicted_us << " us when evicted, " << resident_us
+           << " us when made resident beforehand in " << residency_us
+           << " us";
+
+  // Both launches incremented every allocation
+  std::vector<uint32_t> values(count, 0);
+  auto read_list = lzt::create_command_list(context, device_, 0);
+  for (uint32_t i = 0; i < count; i++) {
+    lzt::append_memory_copy(read_list, &values[i], allocations_[i],
+                            sizeof(uint32_t), nullptr);
+  }
+  lzt::close_command_list(read_list);
+  time_execution(read_list);
+  EXPECT_EQ(count, static_cast<uint32_t>(
+                       std::count(values.begin(), values.end(), 2u)));
+
+  lzt::destroy_command_list(read_list);
+  for (int i = 0; i < 2; i++) {
+    lzt::destroy_command_list(lists[i]);
+    lzt::destroy_function(kernels[i]);
+  }
+  lzt::destroy_module(module);
+  lzt::destroy_command_list(init_list);
+  lzt::destroy_command_queue(queue_);
+  lzt::free_memory(context, table);
+  for (auto allocation : allocations_) {
+    lzt::free_memory(context, allocation);
+  }
+}
+
+struct ResidencyTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    std::stringstream ss;
+    ss << std::get<1>(info.param) << "_allocations_of_"
+       << std::get<0>(info.param) << "_bytes";
+    return ss.str();
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestResidencyPerformance, zeResidencyPerformanceTests,
+    ::testing::Combine(::testing::Values(4096, 1024 * 1024, 64 * 1024 * 1024),
+                       ::testing::Values(1, 64, 1024)),
+    ResidencyTestNameSuffix());
+
+} // namespace
@@ -0,0 +1,25 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+kernel void usm_gather(global ulong *data, global uint *indices, ulong count,
+                       global ulong *sums) {
+  ulong sum = 0;
+  for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+    sum += data[indices[i]];
+  }
+  sums[get_global_id(0)] = sum;
+}
+
+kernel void usm_pointer_chase(global ulong *chain, ulong steps,
+                              global ulong *result) {
+  ulong index = 0;
+  for (ulong i = 0; i < steps; i++) {
+    index = chain[index];
+  }
+  result[0] = index;
+}
@@ -0,0 +1,412 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+namespace lzt = level_zero_tests;
+#include <level_zero/ze_api.h>
+
+namespace {
+
+enum usm_memory_t { USM_HOST, USM_DEVICE, USM_SHARED };
+enum usm_agent_t { AGENT_HOST, AGENT_DEVICE, AGENT_PEER };
+enum usm_variant_t { VARIANT_NONE, VARIANT_ADVISE, VARIANT_PREFETCH };
+enum usm_pattern_t { PATTERN_SEQUENTIAL, PATTERN_STRIDED, PATTERN_RANDOM };
+
+std::string to_string(usm_memory_t memory) {
+  switch (memory) {
+  case USM_HOST:
+    return "host";
+  case USM_DEVICE:
+    return "device";
+  default:
+    return "shared";
+  }
+}
+
+std::string to_string(usm_agent_t agent) {
+  switch (agent) {
+  case AGENT_HOST:
+    return "host_cpu";
+  case AGENT_DEVICE:
+    return "same_device";
+  default:
+    return "peer_device";
+  }
+}
+
+std::string to_string(usm_variant_t variant) {
+  switch (variant) {
+  case VARIANT_NONE:
+    return "plain";
+  case VARIANT_ADVISE:
+    return "preferred_location";
+  default:
+    return "prefetch";
+  }
+}
+
+std::string to_string(usm_pattern_t pattern) {
+  switch (pattern) {
+  case PATTERN_SEQUENTIAL:
+    return "sequential";
+  case PATTERN_STRIDED:
+    return "strided";
+  default:
+    return "random";
+  }
+}
+
+// Reads an allocation through an index array from the host, from the device
+// it is associated with or from a peer device, and reports the bandwidth of
+// the first pass, which pays for any migration, and of the second one.  The
+// latency comes from a chase over randomly linked lines of the same kind of
+// allocation.
+class zeUSMPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::tuple<usm_memory_t, usm_agent_t, usm_variant_t>> {
+protected:
+  void SetUp() override {
+    memory_type_ = std::get<0>(GetParam());
+    agent_ = std::get<1>(GetParam());
+    variant_ = std::get<2>(GetParam());
+    context_ = lzt::get_default_context();
+    device_ = lzt::zeDevice::get_instance()->get_device();
+    agent_device_ = device_;
+
+    if (agent_ == AGENT_HOST && memory_type_ == USM_DEVICE) {
+      GTEST_SKIP() << "The host cannot access device allocations";
+    }
+    if (variant_ != VARIANT_NONE && memory_type_ != USM_SHARED) {
+      GTEST_SKIP() << "Advice and prefetch only apply to shared allocations";
+    }
+    if (agent_ == AGENT_HOST && variant_ == VARIANT_PREFETCH) {
+      GTEST_SKIP() << "Prefetch only migrates to devices";
+    }
+    auto access_properties = lzt::get_memory_access_properties(device_);
+    if (memory_type_ == USM_SHARED &&
+        !(access_properties.sharedSingleDeviceAllocCapabilities &
+          ZE_MEMORY_ACCESS_CAP_FLAG_RW)) {
+      GTEST_SKIP() << "Shared memory is not supported";
+    }
+
+    if (agent_ == AGENT_PEER) {
+      agent_device_ = nullptr;
+      for (auto device : lzt::get_ze_devices(lzt::get_default_driver())) {
+        if (device != device_ && lzt::can_access_peer(device, device_)) {
+          agent_device_ = device;
+          break;
+        }
+      }
+      if (!agent_device_) {
+        GTEST_SKIP() << "No peer device can access the device memory";
+      }
+      auto peer_access_properties =
+          lzt::get_memory_access_properties(agent_device_);
+      if (memory_type_ == USM_SHARED &&
+          !(peer_access_properties.sharedCrossDeviceAllocCapabilities &
+            ZE_MEMORY_ACCESS_CAP_FLAG_RW)) {
+        GTEST_SKIP() << "Cross device shared memory is not supported";
+      }
+    }
+
+    cmd_bundle_ = lzt::create_command_bundle(context_, agent_device_, false);
+    if (agent_ != AGENT_HOST) {
+      module_ = lzt::create_module(context_, agent_device_,
+                                   "test_usm_performance.spv",
+                                   ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+      event_pool_ = lzt::create_event_pool(
+          context_, 2,
+          ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
+              ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+      for (uint32_t i = 0; i < 2; i++) {
+        ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                      ZE_EVENT_SCOPE_FLAG_HOST,
+                                      ZE_EVENT_SCOPE_FLAG_HOST};
+        events_[i] = lzt::create_event(event_pool_, event_desc);
+      }
+    }
+  }
+
+  void TearDown() override {
+    if (event_pool_) {
+      lzt::destroy_event(events_[0]);
+      lzt::destroy_event(events_[1]);
+      lzt::destroy_event_pool(event_pool_);
+    }
+    if (module_) {
+      lzt::destroy_module(module_);
+    }
+    if (cmd_bundle_.list) {
+      lzt::destroy_command_bundle(cmd_bundle_);
+    }
+  }
+
+  void *allocate(size_t size) {
+    switch (memory_type_) {
+    case USM_HOST:
+      return lzt::allocate_host_memory(size, 8, context_);
+    case USM_DEVICE:
+      return lzt::allocate_device_memory(size, 8, 0, 0, device_, context_);
+    default:
+      return lzt::allocate_shared_memory(size, 8, 0, 0, device_, context_);
+    }
+  }
+
+  void execute_bundle() {
+    lzt::close_command_list(cmd_bundle_.list);
+    lzt::execute_and_sync_command_bundle(cmd_bundle_, UINT64_MAX);
+    lzt::reset_command_list(cmd_bundle_.list);
+  }
+
+  void copy_memory(void *destination, const void *source, size_t size) {
+    lzt::append_memory_copy(cmd_bundle_.list, destination, source, size);
+    execute_bundle();
+  }
+
+  // Writes the values from the host, which is also where shared pages start
+  // before every pass, and applies the advice of the variant
+  template <typename T>
+  void write_from_host(T *memory, const std::vector<T> &values) {
+    const size_t size = values.size() * sizeof(T);
+    if (memory_type_ == USM_DEVICE) {
+      copy_memory(memory, values.data(), size);
+    } else {
+      std::copy(values.begin(), values.end(), memory);
+    }
+    if (variant_ == VARIANT_ADVISE) {
+      EXPECT_EQ(ZE_RESULT_SUCCESS,
+                zeCommandListAppendMemAdvise(
+                    cmd_bundle_.list, agent_device_, memory, size,
+                    (agent_ == AGENT_HOST)
+                        ? ZE_MEMORY_ADVICE_SET_SYSTEM_MEMORY_PREFERRED_LOCATION
+                        : ZE_MEMORY_ADVICE_SET_PREFERRED_LOCATION));
+      execute_bundle();
+    }
+  }
+
+  // Launches the kernel twice, after a prefetch in the prefetch variant, and
+  // returns the times of both launches in ns
+  std::pair<double, double> time_device_passes(ze_kernel_handle_t kernel,
+                                               ze_group_count_t group_count,
+                                               void *memory, size_t size) {
+    if (variant_ == VARIANT_PREFETCH) {
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeCommandListAppendMemoryPrefetch(
+                                       cmd_bundle_.list, memory, size));
+      lzt::append_barrier(cmd_bundle_.list, nullptr);
+    }
+    for (auto event : events_) {
+      lzt::event_host_reset(event);
+      lzt::append_launch_function(cmd_bundle_.list, kernel, &group_count,
+                                  event, 0, nullptr);
+      lzt::append_barrier(cmd_bundle_.list, nullptr);
+    }
+    execute_bundle();
+    const auto clock = lzt::get_timestamp_clock(agent_device_);
+    return {
+        clock.duration_ns(lzt::get_event_kernel_timestamp(events_[0]).global),
+        clock.duration_ns(lzt::get_event_kernel_timestamp(events_[1]).global)};
+  }
+
+  std::string name() {
+    return to_string(memory_type_) + " memory, " + to_string(agent_) + ", " +
+           to_string(variant_);
+  }
+
+  const uint64_t element_count_ = 8 * 1024 * 1024;
+  const size_t line_elements_ = 64 / sizeof(uint64_t);
+  const size_t chase_line_count_ = 256 * 1024;
+  const uint64_t chase_steps_ = 100000;
+  const uint32_t group_size_x_ = 256;
+  const uint32_t group_count_x_ = 1024;
+
+  usm_memory_t memory_type_;
+  usm_agent_t agent_;
+  usm_variant_t variant_;
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+  ze_device_handle_t agent_device_ = nullptr;
+  lzt::zeCommandBundle cmd_bundle_ = {};
+  ze_module_handle_t module_ = nullptr;
+  ze_event_pool_handle_t event_pool_ = nullptr;
+  ze_event_handle_t events_[2] = {nullptr, nullptr};
+};
+
+std::vector<uint32_t> pattern_indices(usm_pattern_t pattern, uint64_t count,
+                                      size_t line_elements) {
+  std::vector<uint32_t> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+  if (pattern == PATTERN_STRIDED) {
+    // Visit the first element of every line, then the second one, and so on
+    const uint64_t line_count = count / line_elements;
+    for (uint64_t i = 0; i < count; i++) {
+      indices[i] = static_cast<uint32_t>((i % line_count) * line_elements +
+                                         i / line_count);
+    }
+  } else if (pattern == PATTERN_RANDOM) {
+    std::shuffle(indices.begin(), indices.end(), std::mt19937(42));
+  }
+  return indices;
+}
+
+TEST_P(
+    zeUSMPerformanceTests,
+    GivenAllocationTypeAndAccessingAgentWhenReadingWithAccessPatternsThenReportBandwidthAndLatency) {
+  const size_t size = element_count_ * sizeof(uint64_t);
+  std::vector<uint64_t> values(element_count_);
+  std::iota(values.begin(), values.end(), 0);
+  const uint64_t expected_sum = element_count_ * (element_count_ - 1) / 2;
+  auto data = static_cast<uint64_t *>(allocate(size));
+
+  ze_kernel_handle_t gather = nullptr;
+  uint32_t *device_indices = nullptr;
+  uint64_t *device_sums = nullptr;
+  const size_t sums_size = group_count_x_ * group_size_x_ * sizeof(uint64_t);
+  if (agent_ != AGENT_HOST) {
+    // The indices and the sums stay local to the agent, only the data moves
+    device_indices = static_cast<uint32_t *>(lzt::allocate_device_memory(
+        element_count_ * sizeof(uint32_t), 4, 0, 0, agent_device_, context_));
+    device_sums = static_cast<uint64_t *>(lzt::allocate_device_memory(
+        sums_size, 8, 0, 0, agent_device_, context_));
+    gather = lzt::create_function(module_, "usm_gather");
+    lzt::set_group_size(gather, group_size_x_, 1, 1);
+    lzt::set_argument_value(gather, 0, sizeof(data), &data);
+    lzt::set_argument_value(gather, 1, sizeof(device_indices),
+                            &device_indices);
+    lzt::set_argument_value(gather, 2, sizeof(element_count_),
+                            &element_count_);
+    lzt::set_argument_value(gather, 3, sizeof(device_sums), &device_sums);
+  }
+
+  for (auto pattern : {PATTERN_SEQUENTIAL, PATTERN_STRIDED, PATTERN_RANDOM}) {
+    auto indices = pattern_indices(pattern, element_count_, line_elements_);
+    write_from_host(data, values);
+
+    double first_ns = 0;
+    double second_ns = 0;
+    if (agent_ == AGENT_HOST) {
+      for (int pass = 0; pass < 2; pass++) {
+        const auto start = std::chrono::steady_clock::now();
+        uint64_t sum = 0;
+        for (auto index : indices) {
+          sum += data[index];
+        }
+        second_ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+        if (pass == 0) {
+          first_ns = second_ns;
+        }
+        EXPECT_EQ(expected_sum, sum);
+      }
+    } else {
+      copy_memory(device_indices, indices.data(),
+                  element_count_ * sizeof(uint32_t));
+      ze_group_count_t group_count = {group_count_x_, 1, 1};
+      auto times = time_device_passes(gather, group_count, data, size);
+      first_ns = times.first;
+      second_ns = times.second;
+
+      std::vector<uint64_t> sums(group_count_x_ * group_size_x_, 0);
+      copy_memory(sums.data(), device_sums, sums_size);
+      EXPECT_EQ(expected_sum,
+                std::accumulate(sums.begin(), sums.end(), uint64_t(0)));
+    }
+    LOG_INFO << name() << ", " << to_string(pattern) << ": first pass "
+             << size / first_ns << " GB/s, second pass " << size / second_ns
+             << " GB/s";
+  }
+
+  if (gather) {
+    lzt::destroy_function(gather);
+    lzt::free_memory(context_, device_sums);
+    lzt::free_memory(context_, device_indices);
+  }
+  lzt::free_memory(context_, data);
+
+  // Chase one element per line around a random cycle of the lines
+  std::vector<uint64_t> lines(chase_line_count_);
+  std::iota(lines.begin(), lines.end(), 0);
+  std::shuffle(lines.begin(), lines.end(), std::mt19937_64(42));
+  std::vector<uint64_t> chain(chase_line_count_ * line_elements_, 0);
+  for (size_t i = 0; i < chase_line_count_; i++) {
+    chain[lines[i] * line_elements_] =
+        lines[(i + 1) % chase_line_count_] * line_elements_;
+  }
+  uint64_t expected_index = 0;
+  for (uint64_t i = 0; i < chase_steps_; i++) {
+    expected_index = chain[expected_index];
+  }
+  const size_t chain_size = chain.size() * sizeof(uint64_t);
+  auto chain_memory = static_cast<uint64_t *>(allocate(chain_size));
+  write_from_host(chain_memory, chain);
+
+  double chase_ns = 0;
+  uint64_t index = 0;
+  if (agent_ == AGENT_HOST) {
+    // The first chase warms up, as on the device
+    for (int pass = 0; pass < 2; pass++) {
+      const auto start = std::chrono::steady_clock::now();
+      index = 0;
+      for (uint64_t i = 0; i < chase_steps_; i++) {
+        index = chain_memory[index];
+      }
+      chase_ns = std::chrono::duration<double, std::nano>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+    }
+  } else {
+    auto result = lzt::allocate_device_memory(sizeof(uint64_t), 8, 0, 0,
+                                              agent_device_, context_);
+    ze_kernel_handle_t chase =
+        lzt::create_function(module_, "usm_pointer_chase");
+    lzt::set_group_size(chase, 1, 1, 1);
+    lzt::set_argument_value(chase, 0, sizeof(chain_memory), &chain_memory);
+    lzt::set_argument_value(chase, 1, sizeof(chase_steps_), &chase_steps_);
+    lzt::set_argument_value(chase, 2, sizeof(result), &result);
+    ze_group_count_t group_count = {1, 1, 1};
+    chase_ns =
+        time_device_passes(chase, group_count, chain_memory, chain_size).second;
+    copy_memory(&index, result, sizeof(index));
+    lzt::destroy_function(chase);
+    lzt::free_memory(context_, result);
+  }
+  EXPECT_EQ(expected_index, index);
+  LOG_INFO << name() << ", dependent load latency: " << chase_ns / chase_steps_
+           << " ns";
+  lzt::free_memory(context_, chain_memory);
+}
+
+struct USMPerformanceTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    return to_string(std::get<0>(info.param)) + "_" +
+           to_string(std::get<1>(info.param)) + "_" +
+           to_string(std::get<2>(info.param));
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestUSMPerformanceMatrix, zeUSMPerformanceTests,
+    ::testing::Combine(::testing::Values(USM_HOST, USM_DEVICE, USM_SHARED),
+                       ::testing::Values(AGENT_HOST, AGENT_DEVICE, AGENT_PEER),
+                       ::testing::Values(VARIANT_NONE, VARIANT_ADVISE,
+                                         VARIANT_PREFETCH)),
+    USMPerformanceTestNameSuffix());
+
+} // namespace
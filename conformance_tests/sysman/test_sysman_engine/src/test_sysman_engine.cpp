@@ -15,6 +15,11 @@ namespace lzt = level_zero_tests;
 
 #include <level_zero/zes_api.h>
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <thread>
+
 namespace {
 
 #ifdef USE_ZESINIT
@@ -331,4 +336,287 @@ TEST_F(
   }
 }
 
+// Busy work of a known duty cycle: every period runs units of work for
+// duty of the period on a queue of the engine group, then leaves it idle,
+// and the kernel timestamps of the units are the ground truth of the time
+// the engine was busy
+const std::chrono::milliseconds duty_period(50);
+const uint32_t duty_periods = 40;
+// Percentage points between the reported utilization and the one of the
+// kernel timestamps beyond which the counters are considered wrong
+const double engine_utilization_tolerance = 20.0;
+
+struct DutyCycleLoad {
+  ze_device_handle_t device;
+  ze_command_queue_handle_t queue;
+  ze_command_list_handle_t list;
+  ze_event_pool_handle_t event_pool;
+  std::vector<ze_event_handle_t> events;
+  std::function<void(ze_event_handle_t)> append_unit;
+};
+
+// An ordinal of a queue group running the engine group, or -1
+int32_t queue_ordinal_for_engine(ze_device_handle_t device,
+                                 zes_engine_group_t type) {
+  auto groups = lzt::get_command_queue_group_properties(device);
+  for (uint32_t i = 0; i < groups.size(); i++) {
+    const auto flags = groups[i].flags;
+    const bool compute = flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE;
+    const bool copy = flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY;
+    if ((type == ZES_ENGINE_GROUP_COMPUTE_ALL && compute) ||
+        (type == ZES_ENGINE_GROUP_COPY_ALL && copy && !compute)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Runs units of work until duty of every period has gone, and returns the
+// busy time of the units in ns
+double run_duty_cycle(DutyCycleLoad &load, double duty, double unit_ns) {
+  const uint32_t max_units = static_cast<uint32_t>(load.events.size());
+  const double period_ns =
+      std::chrono::duration<double, std::nano>(duty_period).count();
+  const uint32_t units = std::max(
+      1u, std::min(max_units, static_cast<uint32_t>(
+                                  duty * period_ns / unit_ns + 0.5)));
+
+  lzt::reset_command_list(load.list);
+  for (uint32_t i = 0; i < units; i++) {
+    load.append_unit(load.events[i]);
+  }
+  lzt::close_command_list(load.list);
+
+  double busy_ns = 0;
+  auto deadline = std::chrono::steady_clock::now();
+  for (uint32_t period = 0; period < duty_periods; period++) {
+    deadline += duty_period;
+    for (uint32_t i = 0; i < units; i++) {
+      lzt::event_host_reset(load.events[i]);
+    }
+    lzt::execute_command_lists(load.queue, 1, &load.list, nullptr);
+    lzt::synchronize(load.queue, UINT64_MAX);
+    busy_ns += lzt::get_kernel_timeline(
+                   load.device, std::vector<ze_event_handle_t>(
+                                    load.events.begin(),
+                                    load.events.begin() + units))
+                   .busy_ns;
+    if (duty < 1.0) {
+      std::this_thread::sleep_until(deadline);
+    }
+  }
+  return busy_ns;
+}
+
+double engine_utilization(const zes_engine_stats_t &s1,
+                          const zes_engine_stats_t &s2) {
+  if (s2.timestamp <= s1.timestamp) {
+    return -1;
+  }
+  return 100.0 *
+         (static_cast<double>(s2.activeTime) -
+          static_cast<double>(s1.activeTime)) /
+         (static_cast<double>(s2.timestamp) -
+          static_cast<double>(s1.timestamp));
+}
+
+// Time from the submission of work to an idle engine group until its active
+// time first increases, and the mean interval between later increases while
+// the work runs, in ms
+void measure_activity_latency(DutyCycleLoad &load,
+                              zes_engine_handle_t engine_handle,
+                              double &first_update_ms,
+                              double &update_interval_ms) {
+  first_update_ms = -1;
+  update_interval_ms = -1;
+  lzt::reset_command_list(load.list);
+  for (auto event : load.events) {
+    lzt::event_host_reset(event);
+    load.append_unit(event);
+  }
+  lzt::close_command_list(load.list);
+
+  std::this_thread::sleep_for(duty_period);
+  auto last = lzt::get_engine_activity(engine_handle);
+  const auto submitted = std::chrono::steady_clock::now();
+  lzt::execute_command_lists(load.queue, 1, &load.list, nullptr);
+  uint32_t updates = 0;
+  auto first_update = submitted, last_update = submitted;
+  while (zeCommandQueueSynchronize(load.queue, 0) == ZE_RESULT_NOT_READY) {
+    auto stats = lzt::get_engine_activity(engine_handle);
+    if (stats.activeTime != last.activeTime) {
+      last_update = std::chrono::steady_clock::now();
+      if (updates++ == 0) {
+        first_update = last_update;
+      }
+      last = stats;
+    }
+  }
+  if (updates > 0) {
+    first_update_ms = std::chrono::duration<double, std::milli>(
+                          first_update - submitted)
+                          .count();
+  }
+  if (updates > 1) {
+    update_interval_ms = std::chrono::duration<double, std::milli>(
+                             last_update - first_update)
+                             .count() /
+                         (updates - 1);
+  }
+}
+
+TEST_F(
+    ENGINE_TEST,
+    GivenKnownDutyCycleLoadWhenMeasuringEngineActivityThenReportedUtilizationMatchesKernelTimestamps) {
+  for (auto device : devices) {
+    uint32_t count = 0;
+    auto engine_handles = lzt::get_engine_handles(device, count);
+    if (count == 0) {
+      FAIL() << "No handles found: "
+             << _ze_result_t(ZE_RESULT_ERROR_UNSUPPORTED_FEATURE);
+    }
+#ifdef USE_ZESINIT
+    auto sysman_device_properties = lzt::get_sysman_device_properties(device);
+    ze_device_handle_t core_device =
+        get_core_device_by_uuid(sysman_device_properties.core.uuid.id);
+    ASSERT_NE(core_device, nullptr);
+#else  // USE_ZESINIT
+    ze_device_handle_t core_device = device;
+#endif // USE_ZESINIT
+    auto context = lzt::get_default_context();
+
+    for (auto engine_handle : engine_handles) {
+      ASSERT_NE(nullptr, engine_handle);
+      auto properties = lzt::get_engine_properties(engine_handle);
+      if (properties.onSubdevice ||
+          (properties.type != ZES_ENGINE_GROUP_COMPUTE_ALL &&
+           properties.type != ZES_ENGINE_GROUP_COPY_ALL)) {
+        continue;
+      }
+      const int32_t ordinal =
+          queue_ordinal_for_engine(core_device, properties.type);
+      if (ordinal < 0) {
+        LOG_INFO << "No command queue group for engine group type "
+                 << properties.type;
+        continue;
+      }
+
+      // Enough units for a whole period of a unit of 1 ms or more
+      const uint32_t max_units = 64;
+      DutyCycleLoad load;
+      load.device = core_device;
+      load.queue = lzt::create_command_queue(
+          context, core_device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+          ZE_COMMAND_QUEUE_PRIORITY_NORMAL, ordinal);
+      load.list = lzt::create_command_list(context, core_device, 0, ordinal);
+      load.event_pool =
+          lzt::create_event_pool(context, max_units,
+                                 ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
+                                     ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+      for (uint32_t i = 0; i < max_units; i++) {
+        ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                      ZE_EVENT_SCOPE_FLAG_HOST,
+                                      ZE_EVENT_SCOPE_FLAG_HOST};
+        load.events.push_back(lzt::create_event(load.event_pool, event_desc));
+      }
+
+      // Compute units are matrix multiplications and copy units copies
+      // between device allocations, each of about a millisecond
+      int m = 512, k = 512, n = 512;
+      const size_t copy_size = 64 * 1024 * 1024;
+      void *a_buffer = nullptr, *b_buffer = nullptr, *c_buffer = nullptr;
+      ze_module_handle_t module = nullptr;
+      ze_kernel_handle_t function = nullptr;
+      ze_group_count_t tg = {static_cast<uint32_t>(m / 16),
+                             static_cast<uint32_t>(n / 16), 1};
+      if (properties.type == ZES_ENGINE_GROUP_COMPUTE_ALL) {
+        a_buffer = lzt::allocate_device_memory(m * k * sizeof(float), 1, 0,
+                                               core_device, context);
+        b_buffer = lzt::allocate_device_memory(k * n * sizeof(float), 1, 0,
+                                               core_device, context);
+        c_buffer = lzt::allocate_device_memory(m * n * sizeof(float), 1, 0,
+                                               core_device, context);
+        module = lzt::create_module(
+            core_device, "sysman_matrix_multiplication.spv",
+            ZE_MODULE_FORMAT_IL_SPIRV, nullptr, nullptr);
+        function = lzt::create_function(module, "sysman_matrix_multiplication");
+        lzt::set_group_size(function, 16, 16, 1);
+        lzt::set_argument_value(function, 0, sizeof(a_buffer), &a_buffer);
+        lzt::set_argument_value(function, 1, sizeof(b_buffer), &b_buffer);
+        lzt::set_argument_value(function, 2, sizeof(m), &m);
+        lzt::set_argument_value(function, 3, sizeof(k), &k);
+        lzt::set_argument_value(function, 4, sizeof(n), &n);
+        lzt::set_argument_value(function, 5, sizeof(c_buffer), &c_buffer);
+        load.append_unit = [&](ze_event_handle_t event) {
+          lzt::append_launch_function(load.list, function, &tg, event, 0,
+                                      nullptr);
+        };
+      } else {
+        a_buffer = lzt::allocate_device_memory(copy_size, 1, 0, core_device,
+                                               context);
+        b_buffer = lzt::allocate_device_memory(copy_size, 1, 0, core_device,
+                                               context);
+        load.append_unit = [&](ze_event_handle_t event) {
+          lzt::append_memory_copy(load.list, b_buffer, a_buffer, copy_size,
+                                  event);
+        };
+      }
+
+      // The duration of one unit sets how many make the duty of a period
+      lzt::reset_command_list(load.list);
+      load.append_unit(load.events[0]);
+      lzt::close_command_list(load.list);
+      lzt::execute_command_lists(load.queue, 1, &load.list, nullptr);
+      lzt::synchronize(load.queue, UINT64_MAX);
+      const double unit_ns =
+          lzt::get_kernel_timeline(core_device, {load.events[0]}).busy_ns;
+      ASSERT_GT(unit_ns, 0);
+
+      double first_update_ms, update_interval_ms;
+      measure_activity_latency(load, engine_handle, first_update_ms,
+                               update_interval_ms);
+      LOG_INFO << "Engine group type " << properties.type << ": unit of "
+               << unit_ns / 1e6 << " ms, first activity update "
+               << first_update_ms << " ms after submission, updated every "
+               << update_interval_ms << " ms under load";
+
+      for (double duty : {0.25, 0.5, 1.0}) {
+        std::this_thread::sleep_for(duty_period);
+        auto s1 = lzt::get_engine_activity(engine_handle);
+        const double busy_ns = run_duty_cycle(load, duty, unit_ns);
+        auto s2 = lzt::get_engine_activity(engine_handle);
+
+        // Both over the interval of the Sysman timestamps, in microseconds
+        const double reported = engine_utilization(s1, s2);
+        const double expected =
+            100.0 * busy_ns /
+            (1000.0 * (static_cast<double>(s2.timestamp) -
+                       static_cast<double>(s1.timestamp)));
+        LOG_INFO << "  duty " << duty * 100 << "%: reported "
+                 << reported << "%, kernel timestamps " << expected
+                 << "%, error " << reported - expected << " points";
+        EXPECT_GE(reported, 0);
+        EXPECT_NEAR(reported, std::min(expected, 100.0),
+                    engine_utilization_tolerance);
+      }
+
+      for (auto event : load.events) {
+        lzt::destroy_event(event);
+      }
+      lzt::destroy_event_pool(load.event_pool);
+      lzt::destroy_command_list(load.list);
+      lzt::destroy_command_queue(load.queue);
+      if (function) {
+        lzt::destroy_function(function);
+        lzt::destroy_module(module);
+      }
+      for (auto buffer : {a_buffer, b_buffer, c_buffer}) {
+        if (buffer) {
+          lzt::free_memory(context, buffer);
+        }
+      }
+    }
+  }
+}
+
 } // namespace
@@ -14,6 +14,13 @@
 
 namespace lzt = level_zero_tests;
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
 #include <thread>
 #include <level_zero/ze_api.h>
 #include <level_zero/zes_api.h>
@@ -771,4 +778,449 @@ TEST_F(
   }
 }
 
+#ifdef USE_ZESINIT
+bool is_uuids_equal(uint8_t *uuid1, uint8_t *uuid2) {
+  for (uint32_t i = 0; i < ZE_MAX_UUID_SIZE; i++) {
+    if (uuid1[i] != uuid2[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+ze_device_handle_t get_core_device_by_uuid(uint8_t *uuid) {
+  lzt::initialize_core();
+  auto driver = lzt::zeDevice::get_instance()->get_driver();
+  auto core_devices = lzt::get_ze_devices(driver);
+  for (auto device : core_devices) {
+    auto device_properties = lzt::get_device_properties(device);
+    if (is_uuids_equal(uuid, device_properties.uuid.id)) {
+      return device;
+    }
+  }
+  return nullptr;
+}
+#endif // USE_ZESINIT
+
+// Event notification latency: the time from the action or condition that
+// triggers an event to zesDriverEventListen returning it, measured on one
+// device and on all devices at once, to tell whether listening can replace
+// polling.  Conditions are observed by polling every millisecond, so a
+// latency is exact to about that period.
+using latency_clock = std::chrono::steady_clock;
+const uint32_t event_latency_iterations = 10;
+// Time given to the listener to block in zesDriverEventListen
+const std::chrono::milliseconds event_listener_settle_time(100);
+const std::chrono::milliseconds event_condition_poll_period(1);
+// The energy threshold is set this far ahead of the energy counter
+const std::chrono::milliseconds energy_threshold_lead_time(500);
+
+// Listens from a thread until each device has returned one of the events,
+// or the timeout, recording when the event of each device was returned
+class EventLatencyListener {
+public:
+  EventLatencyListener(ze_driver_handle_t driver,
+                       const std::vector<zes_device_handle_t> &devices,
+                       zes_event_type_flags_t events, uint32_t timeout)
+      : received(devices.size(), latency_clock::time_point::max()) {
+    thread_ = std::thread([this, driver, devices, events, timeout] {
+      auto deadline =
+          latency_clock::now() + std::chrono::milliseconds(timeout);
+      std::vector<uint32_t> pending(devices.size());
+      for (uint32_t i = 0; i < pending.size(); i++) {
+        pending[i] = i;
+      }
+      while (!pending.empty() && latency_clock::now() < deadline) {
+        std::vector<zes_device_handle_t> listened;
+        for (auto i : pending) {
+          listened.push_back(devices[i]);
+        }
+        std::vector<zes_event_type_flags_t> returned(listened.size(), 0);
+        uint32_t num_device_events = 0;
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - latency_clock::now());
+        ze_result_t result = zesDriverEventListen(
+            driver, static_cast<uint32_t>(std::max<int64_t>(
+                        remaining.count(), 0)),
+            listened.size(), listened.data(), &num_device_events,
+            returned.data());
+        auto now = latency_clock::now();
+        if (result != ZE_RESULT_SUCCESS || num_device_events == 0) {
+          break;
+        }
+        std::vector<uint32_t> still_pending;
+        for (uint32_t j = 0; j < listened.size(); j++) {
+          if (returned[j] & events) {
+            received[pending[j]] = now;
+          } else {
+            still_pending.push_back(pending[j]);
+          }
+        }
+        pending = still_pending;
+      }
+    });
+  }
+
+  void join() {
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  ~EventLatencyListener() { join(); }
+
+  std::vector<latency_clock::time_point> received;
+
+private:
+  std::thread thread_;
+};
+
+double latency_ms(latency_clock::time_point trigger,
+                  latency_clock::time_point received) {
+  return std::chrono::duration<double, std::milli>(received - trigger).count();
+}
+
+void log_latencies(const std::string &label,
+                   const std::vector<double> &latencies) {
+  if (latencies.empty()) {
+    LOG_INFO << label << ": no events received";
+    return;
+  }
+  LOG_INFO << label << ": " << latencies.size() << " events, latency min "
+           << lzt::percentile(latencies, 0) << " ms, median "
+           << lzt::median(latencies) << " ms, max "
+           << lzt::percentile(latencies, 100) << " ms";
+}
+
+// The time from clearing the registrations to a blocked listener returning,
+// the floor of the notification path
+std::vector<double>
+measure_listen_wake_latency(ze_driver_handle_t driver,
+                            std::vector<zes_device_handle_t> devices,
+                            uint32_t timeout) {
+  std::vector<double> latencies;
+  for (uint32_t i = 0; i < event_latency_iterations; i++) {
+    for (auto device : devices) {
+      lzt::register_event(device, ZES_EVENT_TYPE_FLAG_DEVICE_DETACH);
+    }
+    latency_clock::time_point returned;
+    std::thread listener([&] {
+      uint32_t num_device_events = 0;
+      std::vector<zes_event_type_flags_t> events(devices.size(), 0);
+      zesDriverEventListen(driver, timeout, devices.size(), devices.data(),
+                           &num_device_events, events.data());
+      returned = latency_clock::now();
+    });
+    std::this_thread::sleep_for(event_listener_settle_time);
+    auto cleared = latency_clock::now();
+    for (auto device : devices) {
+      lzt::register_event(device, 0);
+    }
+    listener.join();
+    latencies.push_back(latency_ms(cleared, returned));
+  }
+  return latencies;
+}
+
+TEST_F(
+    EVENTS_TEST,
+    GivenBlockedListenerWhenClearingRegisteredEventsThenReportListenWakeLatencyForOneAndAllDevices) {
+  std::vector<std::vector<zes_device_handle_t>> device_sets = {
+      {devices.front()}};
+  if (devices.size() > 1) {
+    device_sets.push_back(devices);
+  }
+  for (auto &device_set : device_sets) {
+    auto latencies = measure_listen_wake_latency(hDriver, device_set, timeout);
+    log_latencies("Listen wake on " + std::to_string(device_set.size()) +
+                      " device(s)",
+                  latencies);
+    for (auto latency : latencies) {
+      EXPECT_LT(latency, 2000);
+    }
+  }
+}
+
+// Sets the energy threshold of the card of each device ahead of its energy
+// counter, and returns, per device, the time the counter was seen crossing
+// it; devices without a threshold are left out
+std::vector<latency_clock::time_point>
+trigger_energy_thresholds(const std::vector<zes_device_handle_t> &devices,
+                          std::vector<zes_pwr_handle_t> &power_handles,
+                          std::vector<double> &thresholds, uint32_t timeout) {
+  std::vector<latency_clock::time_point> crossed(
+      devices.size(), latency_clock::time_point::max());
+  auto deadline = latency_clock::now() + std::chrono::milliseconds(timeout);
+  uint32_t pending = 0;
+  for (auto power_handle : power_handles) {
+    pending += power_handle != nullptr;
+  }
+  while (pending > 0 && latency_clock::now() < deadline) {
+    for (uint32_t i = 0; i < devices.size(); i++) {
+      if (power_handles[i] == nullptr ||
+          crossed[i] != latency_clock::time_point::max()) {
+        continue;
+      }
+      zes_power_energy_counter_t energy = {};
+      lzt::get_power_energy_counter(power_handles[i], &energy);
+      if (energy.energy / 1e6 >= thresholds[i]) {
+        crossed[i] = latency_clock::now();
+        pending--;
+      }
+    }
+    std::this_thread::sleep_for(event_condition_poll_period);
+  }
+  return crossed;
+}
+
+std::vector<double>
+measure_energy_threshold_latency(ze_driver_handle_t driver,
+                                 std::vector<zes_device_handle_t> devices,
+                                 uint32_t timeout) {
+  std::vector<double> latencies;
+  std::vector<zes_pwr_handle_t> power_handles(devices.size(), nullptr);
+  std::vector<zes_energy_threshold_t> original(devices.size());
+  std::vector<double> thresholds(devices.size(), 0);
+  for (uint32_t i = 0; i < devices.size(); i++) {
+    zes_pwr_handle_t power_handle = nullptr;
+    if (zesDeviceGetCardPowerDomain(devices[i], &power_handle) !=
+            ZE_RESULT_SUCCESS ||
+        zesPowerGetEnergyThreshold(power_handle, &original[i]) !=
+            ZE_RESULT_SUCCESS) {
+      continue;
+    }
+    // The threshold is set ahead of the counter by the energy the card
+    // draws over the lead time, at its current power
+    zes_power_energy_counter_t energy1 = {}, energy2 = {};
+    lzt::get_power_energy_counter(power_handle, &energy1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    lzt::get_power_energy_counter(power_handle, &energy2);
+    if (energy2.timestamp <= energy1.timestamp) {
+      continue;
+    }
+    const double power_w =
+        static_cast<double>(energy2.energy - energy1.energy) /
+        (energy2.timestamp - energy1.timestamp);
+    thresholds[i] = energy2.energy / 1e6 +
+                    power_w * energy_threshold_lead_time.count() / 1000.0;
+    if (zesPowerSetEnergyThreshold(power_handle, thresholds[i]) !=
+        ZE_RESULT_SUCCESS) {
+      continue;
+    }
+    power_handles[i] = power_handle;
+    lzt::register_event(devices[i],
+                        ZES_EVENT_TYPE_FLAG_ENERGY_THRESHOLD_CROSSED);
+  }
+
+  EventLatencyListener listener(
+      driver, devices, ZES_EVENT_TYPE_FLAG_ENERGY_THRESHOLD_CROSSED, timeout);
+  std::this_thread::sleep_for(event_listener_settle_time);
+  auto crossed =
+      trigger_energy_thresholds(devices, power_handles, thresholds, timeout);
+  listener.join();
+
+  for (uint32_t i = 0; i < devices.size(); i++) {
+    if (power_handles[i] == nullptr) {
+      continue;
+    }
+    if (crossed[i] != latency_clock::time_point::max() &&
+        listener.received[i] != latency_clock::time_point::max()) {
+      latencies.push_back(latency_ms(crossed[i], listener.received[i]));
+    }
+    lzt::register_event(devices[i], 0);
+    if (original[i].enable) {
+      zesPowerSetEnergyThreshold(power_handles[i], original[i].threshold);
+    }
+  }
+  return latencies;
+}
+
+TEST_F(
+    EVENTS_TEST,
+    GivenEnergyThresholdAheadOfEnergyCounterWhenThresholdIsCrossedThenReportEventNotificationLatencyForOneAndAllDevices) {
+  std::vector<std::vector<zes_device_handle_t>> device_sets = {
+      {devices.front()}};
+  if (devices.size() > 1) {
+    device_sets.push_back(devices);
+  }
+  for (auto &device_set : device_sets) {
+    std::vector<double> latencies;
+    for (uint32_t i = 0; i < event_latency_iterations; i++) {
+      auto iteration =
+          measure_energy_threshold_latency(hDriver, device_set, timeout);
+      latencies.insert(latencies.end(), iteration.begin(), iteration.end());
+    }
+    log_latencies("Energy threshold crossed on " +
+                      std::to_string(device_set.size()) + " device(s)",
+                  latencies);
+  }
+}
+
+// Runs the compute load of ze_peak's compute_sp_v8 from a thread until
+// stopped, to draw enough power for a lowered limit to throttle
+class ThrottleLoad {
+public:
+  ThrottleLoad(ze_device_handle_t device) {
+    context_ = lzt::get_default_context();
+    const uint32_t group_size =
+        std::min(256u, lzt::get_compute_properties(device).maxGroupSizeX);
+    const uint32_t work_items = 16 * 1024 * 1024;
+    input_ = lzt::allocate_device_memory(sizeof(float), 1, 0, device, context_);
+    output_ = lzt::allocate_device_memory(work_items * sizeof(float), 1, 0,
+                                          device, context_);
+    module_ = lzt::create_module(device, "ze_sp_compute.spv",
+                                 ZE_MODULE_FORMAT_IL_SPIRV, nullptr, nullptr);
+    kernel_ = lzt::create_function(module_, "compute_sp_v8");
+    lzt::set_group_size(kernel_, group_size, 1, 1);
+    lzt::set_argument_value(kernel_, 0, sizeof(input_), &input_);
+    lzt::set_argument_value(kernel_, 1, sizeof(output_), &output_);
+    ze_group_count_t tg = {work_items / group_size, 1, 1};
+    list_ = lzt::create_command_list(context_, device, 0);
+    lzt::append_launch_function(list_, kernel_, &tg, nullptr, 0, nullptr);
+    lzt::close_command_list(list_);
+    queue_ = lzt::create_command_queue(device);
+    running_ = true;
+    thread_ = std::thread([this] {
+      while (running_) {
+        lzt::execute_command_lists(queue_, 1, &list_, nullptr);
+        lzt::synchronize(queue_, UINT64_MAX);
+      }
+    });
+  }
+
+  ~ThrottleLoad() {
+    running_ = false;
+    thread_.join();
+    lzt::destroy_command_queue(queue_);
+    lzt::destroy_command_list(list_);
+    lzt::destroy_function(kernel_);
+    lzt::destroy_module(module_);
+    lzt::free_memory(context_, input_);
+    lzt::free_memory(context_, output_);
+  }
+
+private:
+  ze_context_handle_t context_;
+  void *input_;
+  void *output_;
+  ze_module_handle_t module_;
+  ze_kernel_handle_t kernel_;
+  ze_command_list_handle_t list_;
+  ze_command_queue_handle_t queue_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+};
+
+zes_freq_handle_t get_gpu_freq_handle(zes_device_handle_t device) {
+  uint32_t count = 0;
+  for (auto freq_handle : lzt::get_freq_handles(device, count)) {
+    if (lzt::get_freq_properties(freq_handle).type == ZES_FREQ_DOMAIN_GPU) {
+      return freq_handle;
+    }
+  }
+  return nullptr;
+}
+
+// Frequency throttle, enabled with LZT_SYSMAN_EVENT_THROTTLE_LATENCY=1 as it
+// lowers the sustained power limit of the cards: under a compute load the
+// limit is lowered to its minimum, and the throttle reasons of the GPU
+// frequency domain are polled for the start of throttling
+TEST_F(
+    EVENTS_TEST,
+    GivenComputeLoadWhenLoweringSustainedPowerLimitThenReportFrequencyThrottledEventNotificationLatencyForOneAndAllDevices) {
+  auto is_enabled = getenv("LZT_SYSMAN_EVENT_THROTTLE_LATENCY");
+  if (is_enabled == nullptr || strcmp(is_enabled, "1") != 0) {
+    GTEST_SKIP() << "Lowers the sustained power limit, enable with "
+                    "LZT_SYSMAN_EVENT_THROTTLE_LATENCY=1";
+  }
+  std::vector<std::vector<zes_device_handle_t>> device_sets = {
+      {devices.front()}};
+  if (devices.size() > 1) {
+    device_sets.push_back(devices);
+  }
+  for (auto &device_set : device_sets) {
+    std::vector<zes_pwr_handle_t> power_handles;
+    std::vector<zes_freq_handle_t> freq_handles;
+    std::vector<zes_power_sustained_limit_t> sustained(device_set.size());
+    std::vector<std::unique_ptr<ThrottleLoad>> loads;
+    for (uint32_t i = 0; i < device_set.size(); i++) {
+      zes_pwr_handle_t power_handle = nullptr;
+      if (zesDeviceGetCardPowerDomain(device_set[i], &power_handle) !=
+          ZE_RESULT_SUCCESS) {
+        power_handle = nullptr;
+      }
+      power_handles.push_back(power_handle);
+      freq_handles.push_back(get_gpu_freq_handle(device_set[i]));
+#ifdef USE_ZESINIT
+      auto sysman_device_properties =
+          lzt::get_sysman_device_properties(device_set[i]);
+      ze_device_handle_t core_device =
+          get_core_device_by_uuid(sysman_device_properties.core.uuid.id);
+      ASSERT_NE(core_device, nullptr);
+#else  // USE_ZESINIT
+      ze_device_handle_t core_device = device_set[i];
+#endif // USE_ZESINIT
+      loads.emplace_back(new ThrottleLoad(core_device));
+      lzt::register_event(device_set[i], ZES_EVENT_TYPE_FLAG_FREQ_THROTTLED);
+    }
+    // Lets the load reach full power before the limits are lowered
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    EventLatencyListener listener(hDriver, device_set,
+                                  ZES_EVENT_TYPE_FLAG_FREQ_THROTTLED, timeout);
+    std::this_thread::sleep_for(event_listener_settle_time);
+    for (uint32_t i = 0; i < device_set.size(); i++) {
+      if (power_handles[i] == nullptr || freq_handles[i] == nullptr) {
+        continue;
+      }
+      lzt::get_power_limits(power_handles[i], &sustained[i], nullptr,
+                            nullptr);
+      auto properties = lzt::get_power_properties(power_handles[i]);
+      zes_power_sustained_limit_t lowered = sustained[i];
+      lowered.power = properties.minLimit > 0 ? properties.minLimit
+                                              : sustained[i].power / 4;
+      lzt::set_power_limits(power_handles[i], &lowered, nullptr, nullptr);
+    }
+    std::vector<latency_clock::time_point> throttled(
+        device_set.size(), latency_clock::time_point::max());
+    auto deadline = latency_clock::now() + std::chrono::milliseconds(timeout);
+    while (latency_clock::now() < deadline) {
+      bool pending = false;
+      for (uint32_t i = 0; i < device_set.size(); i++) {
+        if (freq_handles[i] == nullptr || power_handles[i] == nullptr ||
+            throttled[i] != latency_clock::time_point::max()) {
+          continue;
+        }
+        if (lzt::get_freq_state(freq_handles[i]).throttleReasons != 0) {
+          throttled[i] = latency_clock::now();
+        } else {
+          pending = true;
+        }
+      }
+      if (!pending) {
+        break;
+      }
+      std::this_thread::sleep_for(event_condition_poll_period);
+    }
+    listener.join();
+
+    std::vector<double> latencies;
+    for (uint32_t i = 0; i < device_set.size(); i++) {
+      lzt::register_event(device_set[i], 0);
+      if (power_handles[i] == nullptr || freq_handles[i] == nullptr) {
+        continue;
+      }
+      lzt::set_power_limits(power_handles[i], &sustained[i], nullptr, nullptr);
+      if (throttled[i] == latency_clock::time_point::max()) {
+        LOG_INFO << "Device " << i << " did not throttle";
+      } else if (listener.received[i] != latency_clock::time_point::max()) {
+        latencies.push_back(latency_ms(throttled[i], listener.received[i]));
+      }
+    }
+    loads.clear();
+    log_latencies("Frequency throttled on " +
+                      std::to_string(device_set.size()) + " device(s)",
+                  latencies);
+  }
+}
+
 } // namespace
@@ -12,6 +12,9 @@
 #include "utils/utils.hpp"
 #include "test_harness/test_harness.hpp"
 #include "math.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace lzt = level_zero_tests;
 
@@ -676,4 +679,218 @@ TEST_F(
   }
 }
 
+// Frequency characterization, enabled with
+// LZT_SYSMAN_FREQUENCY_CHARACTERIZATION=1 as it takes a few seconds per
+// frequency step and leaves the device at each step in turn: the ze_peak
+// sp_compute and global_bw kernels run at every available GPU frequency, for
+// the throughput, power and throughput per watt curves of both
+const double freq_settle_tolerance_mhz = 50.0;
+const std::chrono::milliseconds freq_settle_timeout(1000);
+const std::chrono::milliseconds characterization_run_time(500);
+const uint32_t launches_per_run = 8;
+// As FETCH_PER_WI of ze_global_bw.cl, times the 16 floats of a float16
+const uint64_t global_bw_floats_per_work_item = 16 * 16;
+const uint64_t sp_compute_flops_per_work_item = 4096;
+
+struct PeakKernel {
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t kernel = nullptr;
+  ze_command_list_handle_t list = nullptr;
+  std::vector<void *> buffers;
+  // Flops or bytes of a run of the list
+  double work_per_run = 0;
+};
+
+PeakKernel create_peak_kernel(ze_context_handle_t context,
+                              ze_device_handle_t device, const char *file,
+                              const char *name, uint64_t work_items,
+                              size_t input_size, double work_per_item) {
+  PeakKernel peak;
+  const uint32_t group_size = std::min(
+      256u, lzt::get_compute_properties(device).maxGroupSizeX);
+  work_items -= work_items % group_size;
+  peak.buffers.push_back(
+      lzt::allocate_device_memory(input_size, 1, 0, device, context));
+  peak.buffers.push_back(lzt::allocate_device_memory(
+      work_items * sizeof(float), 1, 0, device, context));
+  peak.module = lzt::create_module(device, file, ZE_MODULE_FORMAT_IL_SPIRV,
+                                   nullptr, nullptr);
+  peak.kernel = lzt::create_function(peak.module, name);
+  lzt::set_group_size(peak.kernel, group_size, 1, 1);
+  lzt::set_argument_value(peak.kernel, 0, sizeof(void *), &peak.buffers[0]);
+  lzt::set_argument_value(peak.kernel, 1, sizeof(void *), &peak.buffers[1]);
+
+  ze_group_count_t tg = {static_cast<uint32_t>(work_items / group_size), 1, 1};
+  peak.list = lzt::create_command_list(context, device, 0);
+  for (uint32_t i = 0; i < launches_per_run; i++) {
+    lzt::append_launch_function(peak.list, peak.kernel, &tg, nullptr, 0,
+                                nullptr);
+    lzt::append_barrier(peak.list, nullptr, 0, nullptr);
+  }
+  lzt::close_command_list(peak.list);
+  peak.work_per_run = launches_per_run * work_items * work_per_item;
+  return peak;
+}
+
+void destroy_peak_kernel(ze_context_handle_t context, PeakKernel &peak) {
+  lzt::destroy_command_list(peak.list);
+  lzt::destroy_function(peak.kernel);
+  lzt::destroy_module(peak.module);
+  for (auto buffer : peak.buffers) {
+    lzt::free_memory(context, buffer);
+  }
+}
+
+struct PeakResult {
+  double per_second;
+  double power_w;
+  double frequency_mhz;
+};
+
+// Runs the kernel for characterization_run_time, with power and frequency
+// sampled over the runs
+PeakResult run_peak_kernel(ze_command_queue_handle_t queue, PeakKernel &peak,
+                           lzt::TelemetryRecorder &recorder) {
+  // Once untimed, so that the first run does not include the warm up
+  lzt::execute_command_lists(queue, 1, &peak.list, nullptr);
+  lzt::synchronize(queue, UINT64_MAX);
+
+  uint32_t runs = 0;
+  recorder.start();
+  const auto start = std::chrono::steady_clock::now();
+  auto now = start;
+  while (now - start < characterization_run_time) {
+    lzt::execute_command_lists(queue, 1, &peak.list, nullptr);
+    lzt::synchronize(queue, UINT64_MAX);
+    runs++;
+    now = std::chrono::steady_clock::now();
+  }
+  recorder.stop();
+
+  const auto average = recorder.get_average();
+  const double seconds = std::chrono::duration<double>(now - start).count();
+  return {runs * peak.work_per_run / seconds, average.power_w,
+          average.frequency_mhz};
+}
+
+// Time from a request of the frequency until the actual frequency is within
+// freq_settle_tolerance_mhz of it, while the device runs the kernel, or -1
+double settle_frequency(zes_freq_handle_t pfreq_handle, double frequency,
+                        ze_command_queue_handle_t queue, PeakKernel &load) {
+  for (uint32_t i = 0; i < 4; i++) {
+    lzt::execute_command_lists(queue, 1, &load.list, nullptr);
+  }
+  zes_freq_range_t limits = {frequency, frequency};
+  const auto requested = std::chrono::steady_clock::now();
+  lzt::set_freq_range(pfreq_handle, limits);
+  double settle_ms = -1;
+  auto now = requested;
+  while (now - requested < freq_settle_timeout) {
+    auto state = lzt::get_freq_state(pfreq_handle);
+    now = std::chrono::steady_clock::now();
+    if (state.actual > 0 &&
+        std::fabs(state.actual - frequency) <= freq_settle_tolerance_mhz) {
+      settle_ms =
+          std::chrono::duration<double, std::milli>(now - requested).count();
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  lzt::synchronize(queue, UINT64_MAX);
+  return settle_ms;
+}
+
+TEST_F(
+    FREQUENCY_TEST,
+    GivenEachAvailableFrequencyWhenRunningPeakComputeAndBandwidthKernelsThenReportThroughputPowerAndSettleTime) {
+  const char *enabled = getenv("LZT_SYSMAN_FREQUENCY_CHARACTERIZATION");
+  if (enabled == nullptr || strcmp(enabled, "1") != 0) {
+    GTEST_SKIP() << "Set LZT_SYSMAN_FREQUENCY_CHARACTERIZATION=1 to "
+                    "characterize the frequency steps";
+  }
+  for (auto device : devices) {
+    uint32_t p_count = 0;
+    auto pfreq_handles = lzt::get_freq_handles(device, p_count);
+    if (p_count == 0) {
+      FAIL() << "No handles found: "
+             << _ze_result_t(ZE_RESULT_ERROR_UNSUPPORTED_FEATURE);
+    }
+#ifdef USE_ZESINIT
+    auto sysman_device_properties = lzt::get_sysman_device_properties(device);
+    ze_device_handle_t core_device =
+        get_core_device_by_uuid(sysman_device_properties.core.uuid.id);
+    ASSERT_NE(core_device, nullptr);
+#else  // USE_ZESINIT
+    ze_device_handle_t core_device = device;
+#endif // USE_ZESINIT
+
+    for (auto pfreq_handle : pfreq_handles) {
+      EXPECT_NE(nullptr, pfreq_handle);
+      auto properties = lzt::get_freq_properties(pfreq_handle);
+      if (properties.type != ZES_FREQ_DOMAIN_GPU || properties.onSubdevice) {
+        continue;
+      }
+      if (!properties.canControl) {
+        LOG_WARNING << "User cannot control min/max frequency setting, "
+                       "skipping characterization";
+        continue;
+      }
+
+      auto context = lzt::get_default_context();
+      auto device_properties = lzt::get_device_properties(core_device);
+      const uint64_t max_floats =
+          std::min<uint64_t>(device_properties.maxMemAllocSize / sizeof(float),
+                             64 * 1024 * 1024);
+      PeakKernel compute = create_peak_kernel(
+          context, core_device, "ze_sp_compute.spv", "compute_sp_v8",
+          16 * 1024 * 1024, sizeof(float), sp_compute_flops_per_work_item);
+      PeakKernel bandwidth = create_peak_kernel(
+          context, core_device, "ze_global_bw.spv",
+          "global_bandwidth_v16_local_offset",
+          max_floats / global_bw_floats_per_work_item,
+          max_floats * sizeof(float),
+          global_bw_floats_per_work_item * sizeof(float));
+      auto queue = lzt::create_command_queue(core_device);
+      lzt::TelemetryRecorder recorder(
+          device, lzt::TELEMETRY_POWER | lzt::TELEMETRY_FREQUENCY,
+          std::chrono::milliseconds(10));
+
+      const zes_freq_range_t original_limits =
+          lzt::get_freq_range(pfreq_handle);
+      uint32_t clock_count = 0;
+      auto clocks = lzt::get_available_clocks(pfreq_handle, clock_count);
+      LOG_INFO << "MHz, settle ms, GFLOPS, W, GFLOPS/W, GB/s, W, GB/s/W";
+      for (auto frequency : clocks) {
+        const double settle_ms =
+            settle_frequency(pfreq_handle, frequency, queue, compute);
+        const PeakResult flops = run_peak_kernel(queue, compute, recorder);
+        const PeakResult bytes = run_peak_kernel(queue, bandwidth, recorder);
+
+        auto per_watt = [](const PeakResult &result) {
+          return result.power_w > 0 ? result.per_second / 1e9 / result.power_w
+                                    : -1;
+        };
+        LOG_INFO << frequency << ", " << settle_ms << ", "
+                 << flops.per_second / 1e9 << ", " << flops.power_w << ", "
+                 << per_watt(flops) << ", " << bytes.per_second / 1e9 << ", "
+                 << bytes.power_w << ", " << per_watt(bytes);
+        if (flops.frequency_mhz > 0 &&
+            std::fabs(flops.frequency_mhz - frequency) >
+                freq_settle_tolerance_mhz) {
+          LOG_WARNING << "Average frequency " << flops.frequency_mhz
+                      << " MHz while pinned at " << frequency << " MHz";
+        }
+        EXPECT_GT(flops.per_second, 0);
+        EXPECT_GT(bytes.per_second, 0);
+      }
+
+      zes_freq_range_t limits = original_limits;
+      lzt::set_freq_range(pfreq_handle, limits);
+      lzt::destroy_command_queue(queue);
+      destroy_peak_kernel(context, compute);
+      destroy_peak_kernel(context, bandwidth);
+    }
+  }
+}
+
 } // namespace
@@ -10,6 +10,9 @@
 #include "logging/logging.hpp"
 #include "utils/utils.hpp"
 #include "test_harness/test_harness.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <thread>
 
@@ -380,4 +383,242 @@ TEST_F(
     memoryThread.join();
   }
 }
+
+// Bandwidth counter validation: known traffic is generated in device memory,
+// reads by ze_peak's global_bandwidth_v16_local_offset kernel and writes by
+// memory fills, and the bytes the counters of the device memory modules
+// report are compared to the bytes generated
+const uint32_t traffic_launches = 16;
+const uint64_t traffic_buffer_size = 512 * 1024 * 1024;
+// As FETCH_PER_WI of ze_global_bw.cl, times the 16 floats of a float16
+const uint64_t global_bw_floats_per_work_item = 16 * 16;
+// Fraction the counted bytes may be off the generated bytes
+const double bandwidth_counter_tolerance = 0.25;
+const uint32_t bandwidth_read_overhead_calls = 1000;
+
+// Sums the counters of the device memory modules, or returns false if they
+// are not supported
+bool read_device_mem_bandwidth(const std::vector<zes_mem_handle_t> &handles,
+                               uint64_t &read_bytes, uint64_t &write_bytes,
+                               uint64_t &timestamp) {
+  read_bytes = write_bytes = timestamp = 0;
+  for (auto mem_handle : handles) {
+    zes_mem_bandwidth_t bandwidth = {};
+    ze_result_t result = zesMemoryGetBandwidth(mem_handle, &bandwidth);
+    if (result == ZE_RESULT_ERROR_UNSUPPORTED_FEATURE) {
+      return false;
+    }
+    EXPECT_EQ(ZE_RESULT_SUCCESS, result);
+    read_bytes += bandwidth.readCounter;
+    write_bytes += bandwidth.writeCounter;
+    timestamp = std::max(timestamp, bandwidth.timestamp);
+  }
+  return true;
+}
+
+struct TrafficResult {
+  double generated_bytes;
+  double kernel_bytes_per_s;
+  double counted_read_bytes;
+  double counted_write_bytes;
+  double counted_bytes_per_s;
+};
+
+// Executes the list, which signals one timestamp event per launch, between
+// two reads of the counters
+TrafficResult run_traffic(ze_device_handle_t core_device,
+                          ze_command_queue_handle_t queue,
+                          ze_command_list_handle_t list,
+                          const std::vector<ze_event_handle_t> &events,
+                          const std::vector<zes_mem_handle_t> &mem_handles,
+                          double generated_bytes) {
+  TrafficResult result = {generated_bytes, 0, 0, 0, 0};
+  for (auto event : events) {
+    lzt::event_host_reset(event);
+  }
+  uint64_t read1, write1, timestamp1, read2, write2, timestamp2;
+  read_device_mem_bandwidth(mem_handles, read1, write1, timestamp1);
+  lzt::execute_command_lists(queue, 1, &list, nullptr);
+  lzt::synchronize(queue, UINT64_MAX);
+  read_device_mem_bandwidth(mem_handles, read2, write2, timestamp2);
+
+  const double busy_ns =
+      lzt::get_kernel_timeline(core_device, events).busy_ns;
+  result.kernel_bytes_per_s = busy_ns > 0 ? generated_bytes * 1e9 / busy_ns : 0;
+  result.counted_read_bytes = static_cast<double>(read2 - read1);
+  result.counted_write_bytes = static_cast<double>(write2 - write1);
+  // Counter timestamps are in microseconds
+  if (timestamp2 > timestamp1) {
+    result.counted_bytes_per_s =
+        (result.counted_read_bytes + result.counted_write_bytes) * 1e6 /
+        (timestamp2 - timestamp1);
+  }
+  return result;
+}
+
+TEST_F(
+    MEMORY_TEST,
+    GivenKnownReadAndWriteTrafficWhenReadingMemBandwidthCountersThenCountedBytesMatchGeneratedTraffic) {
+  for (auto device : devices) {
+    uint32_t count = 0;
+    auto all_mem_handles = lzt::get_mem_handles(device, count);
+    if (count == 0) {
+      FAIL() << "No handles found: "
+             << _ze_result_t(ZE_RESULT_ERROR_UNSUPPORTED_FEATURE);
+    }
+    std::vector<zes_mem_handle_t> mem_handles;
+    for (auto mem_handle : all_mem_handles) {
+      if (lzt::get_mem_properties(mem_handle).location ==
+          ZES_MEM_LOC_DEVICE) {
+        mem_handles.push_back(mem_handle);
+      }
+    }
+    uint64_t read_bytes, write_bytes, timestamp;
+    if (mem_handles.empty() || !read_device_mem_bandwidth(
+                                   mem_handles, read_bytes, write_bytes,
+                                   timestamp)) {
+      LOG_INFO << "No device memory bandwidth counters";
+      continue;
+    }
+
+#ifdef USE_ZESINIT
+    auto sysman_device_properties = lzt::get_sysman_device_properties(device);
+    ze_device_handle_t core_device =
+        get_core_device_by_uuid(sysman_device_properties.core.uuid.id);
+    ASSERT_NE(core_device, nullptr);
+#else  // USE_ZESINIT
+    ze_device_handle_t core_device = device;
+#endif // USE_ZESINIT
+    auto context = lzt::get_default_context();
+    const uint64_t buffer_size =
+        std::min<uint64_t>(traffic_buffer_size,
+                           lzt::get_device_properties(core_device)
+                               .maxMemAllocSize);
+    const uint32_t group_size =
+        std::min(256u, lzt::get_compute_properties(core_device).maxGroupSizeX);
+    uint64_t work_items =
+        buffer_size / sizeof(float) / global_bw_floats_per_work_item;
+    work_items -= work_items % group_size;
+
+    void *input =
+        lzt::allocate_device_memory(buffer_size, 1, 0, core_device, context);
+    void *output = lzt::allocate_device_memory(work_items * sizeof(float), 1,
+                                               0, core_device, context);
+    auto module = lzt::create_module(core_device, "ze_global_bw.spv",
+                                     ZE_MODULE_FORMAT_IL_SPIRV, nullptr,
+                                     nullptr);
+    auto kernel =
+        lzt::create_function(module, "global_bandwidth_v16_local_offset");
+    lzt::set_group_size(kernel, group_size, 1, 1);
+    lzt::set_argument_value(kernel, 0, sizeof(input), &input);
+    lzt::set_argument_value(kernel, 1, sizeof(output), &output);
+    ze_group_count_t tg = {static_cast<uint32_t>(work_items / group_size), 1,
+                           1};
+
+    auto event_pool = lzt::create_event_pool(
+        context, traffic_launches,
+        ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+    std::vector<ze_event_handle_t> events;
+    for (uint32_t i = 0; i < traffic_launches; i++) {
+      ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                    ZE_EVENT_SCOPE_FLAG_HOST,
+                                    ZE_EVENT_SCOPE_FLAG_HOST};
+      events.push_back(lzt::create_event(event_pool, event_desc));
+    }
+    auto queue = lzt::create_command_queue(core_device);
+
+    // Reads of the whole input per launch, and a small write of the output
+    auto read_list = lzt::create_command_list(context, core_device, 0);
+    for (auto event : events) {
+      lzt::append_launch_function(read_list, kernel, &tg, event, 0, nullptr);
+      lzt::append_barrier(read_list, nullptr, 0, nullptr);
+    }
+    lzt::close_command_list(read_list);
+    // Writes of the whole input per fill
+    auto write_list = lzt::create_command_list(context, core_device, 0);
+    const uint32_t pattern = 0x5a5a5a5a;
+    for (auto event : events) {
+      lzt::append_memory_fill(write_list, input, &pattern, sizeof(pattern),
+                              buffer_size, event);
+      lzt::append_barrier(write_list, nullptr, 0, nullptr);
+    }
+    lzt::close_command_list(write_list);
+
+    // Warm up, so that neither run includes first use costs
+    lzt::execute_command_lists(queue, 1, &read_list, nullptr);
+    lzt::execute_command_lists(queue, 1, &write_list, nullptr);
+    lzt::synchronize(queue, UINT64_MAX);
+
+    const double read_generated = static_cast<double>(traffic_launches) *
+                                  work_items * global_bw_floats_per_work_item *
+                                  sizeof(float);
+    const double write_generated =
+        static_cast<double>(traffic_launches) * buffer_size;
+    const auto reads = run_traffic(core_device, queue, read_list, events,
+                                   mem_handles, read_generated);
+    const auto writes = run_traffic(core_device, queue, write_list, events,
+                                    mem_handles, write_generated);
+    LOG_INFO << "Reads: generated " << reads.generated_bytes
+             << " B at " << reads.kernel_bytes_per_s / 1e9
+             << " GB/s (kernel timestamps), counted "
+             << reads.counted_read_bytes << " B read ("
+             << 100.0 * reads.counted_read_bytes / reads.generated_bytes
+             << "%) and " << reads.counted_write_bytes << " B written, "
+             << reads.counted_bytes_per_s / 1e9 << " GB/s";
+    LOG_INFO << "Writes: generated " << writes.generated_bytes
+             << " B at " << writes.kernel_bytes_per_s / 1e9
+             << " GB/s (kernel timestamps), counted "
+             << writes.counted_write_bytes << " B written ("
+             << 100.0 * writes.counted_write_bytes / writes.generated_bytes
+             << "%) and " << writes.counted_read_bytes << " B read, "
+             << writes.counted_bytes_per_s / 1e9 << " GB/s";
+    // Other traffic of the device can only add to the counts
+    EXPECT_GE(reads.counted_read_bytes,
+              reads.generated_bytes * (1 - bandwidth_counter_tolerance));
+    EXPECT_GE(writes.counted_write_bytes,
+              writes.generated_bytes * (1 - bandwidth_counter_tolerance));
+
+    // Overhead: the cost of a read of the counters, and the change of the
+    // kernel bandwidth while another thread polls them every millisecond
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < bandwidth_read_overhead_calls; i++) {
+      read_device_mem_bandwidth(mem_handles, read_bytes, write_bytes,
+                                timestamp);
+    }
+    const double read_us = std::chrono::duration<double, std::micro>(
+                               std::chrono::steady_clock::now() - start)
+                               .count() /
+                           bandwidth_read_overhead_calls;
+    std::atomic<bool> polling(true);
+    std::thread poller([&] {
+      uint64_t r, w, t;
+      while (polling) {
+        read_device_mem_bandwidth(mem_handles, r, w, t);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+    const auto polled = run_traffic(core_device, queue, read_list, events,
+                                    mem_handles, read_generated);
+    polling = false;
+    poller.join();
+    LOG_INFO << "Counter read " << read_us << " us for " << mem_handles.size()
+             << " modules, kernel bandwidth "
+             << polled.kernel_bytes_per_s / 1e9 << " GB/s polled every ms ("
+             << 100.0 * (polled.kernel_bytes_per_s / reads.kernel_bytes_per_s -
+                         1)
+             << "%)";
+
+    lzt::destroy_command_list(read_list);
+    lzt::destroy_command_list(write_list);
+    lzt::destroy_command_queue(queue);
+    for (auto event : events) {
+      lzt::destroy_event(event);
+    }
+    lzt::destroy_event_pool(event_pool);
+    lzt::destroy_function(kernel);
+    lzt::destroy_module(module);
+    lzt::free_memory(context, input);
+    lzt::free_memory(context, output);
+  }
+}
 } // namespace
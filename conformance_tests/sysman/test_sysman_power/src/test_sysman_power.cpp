@@ -12,6 +12,9 @@
 #include "utils/utils.hpp"
 #include "test_harness/test_harness.hpp"
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 namespace lzt = level_zero_tests;
 
 #include <level_zero/zes_api.h>
@@ -1036,4 +1039,274 @@ TEST_F(
   }
 }
 
+#ifdef USE_ZESINIT
+bool is_uuids_equal(uint8_t *uuid1, uint8_t *uuid2) {
+  for (uint32_t i = 0; i < ZE_MAX_UUID_SIZE; i++) {
+    if (uuid1[i] != uuid2[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+ze_device_handle_t get_core_device_by_uuid(uint8_t *uuid) {
+  lzt::initialize_core();
+  auto driver = lzt::zeDevice::get_instance()->get_driver();
+  auto core_devices = lzt::get_ze_devices(driver);
+  for (auto device : core_devices) {
+    auto device_properties = lzt::get_device_properties(device);
+    if (is_uuids_equal(uuid, device_properties.uuid.id)) {
+      return device;
+    }
+  }
+  return nullptr;
+}
+#endif // USE_ZESINIT
+
+// Power limit response, enabled with LZT_SYSMAN_POWER_LIMIT_RESPONSE=1 as it
+// lowers the sustained limit of the card for several seconds: a compute
+// load runs at full power, the sustained limit is lowered to half of the
+// power it draws, and the energy counter shows how fast and how closely
+// the new limit is enforced, and the completed runs how much the load slows
+const std::chrono::milliseconds power_window(100);
+const std::chrono::milliseconds power_baseline_time(2000);
+const std::chrono::milliseconds power_min_enforced_time(3000);
+const std::chrono::milliseconds power_max_enforced_time(30000);
+// The window power is enforced once within this fraction above the limit
+const double power_enforced_margin = 0.05;
+
+struct PowerWindow {
+  double end_s;
+  double power_w;
+  uint64_t runs;
+};
+
+// Runs the compute load of ze_peak's compute_sp_v8 from a thread until
+// stopped, counting the runs completed
+class PowerLimitLoad {
+public:
+  PowerLimitLoad(ze_device_handle_t device) {
+    context_ = lzt::get_default_context();
+    const uint32_t group_size =
+        std::min(256u, lzt::get_compute_properties(device).maxGroupSizeX);
+    const uint32_t work_items = 16 * 1024 * 1024;
+    input_ = lzt::allocate_device_memory(sizeof(float), 1, 0, device, context_);
+    output_ = lzt::allocate_device_memory(work_items * sizeof(float), 1, 0,
+                                          device, context_);
+    module_ = lzt::create_module(device, "ze_sp_compute.spv",
+                                 ZE_MODULE_FORMAT_IL_SPIRV, nullptr, nullptr);
+    kernel_ = lzt::create_function(module_, "compute_sp_v8");
+    lzt::set_group_size(kernel_, group_size, 1, 1);
+    lzt::set_argument_value(kernel_, 0, sizeof(input_), &input_);
+    lzt::set_argument_value(kernel_, 1, sizeof(output_), &output_);
+    ze_group_count_t tg = {work_items / group_size, 1, 1};
+    list_ = lzt::create_command_list(context_, device, 0);
+    lzt::append_launch_function(list_, kernel_, &tg, nullptr, 0, nullptr);
+    lzt::close_command_list(list_);
+    queue_ = lzt::create_command_queue(device);
+  }
+
+  ~PowerLimitLoad() {
+    stop();
+    lzt::destroy_command_queue(queue_);
+    lzt::destroy_command_list(list_);
+    lzt::destroy_function(kernel_);
+    lzt::destroy_module(module_);
+    lzt::free_memory(context_, input_);
+    lzt::free_memory(context_, output_);
+  }
+
+  void start() {
+    running_ = true;
+    thread_ = std::thread([this] {
+      while (running_) {
+        lzt::execute_command_lists(queue_, 1, &list_, nullptr);
+        lzt::synchronize(queue_, UINT64_MAX);
+        runs_++;
+      }
+    });
+  }
+
+  void stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  uint64_t runs() const { return runs_; }
+
+private:
+  ze_context_handle_t context_;
+  void *input_;
+  void *output_;
+  ze_module_handle_t module_;
+  ze_kernel_handle_t kernel_;
+  ze_command_list_handle_t list_;
+  ze_command_queue_handle_t queue_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> runs_{0};
+};
+
+// Power from the energy counter and runs completed over consecutive
+// windows, until the duration has gone
+void record_power_windows(zes_pwr_handle_t power_handle, PowerLimitLoad &load,
+                          std::chrono::steady_clock::time_point origin,
+                          std::chrono::milliseconds duration,
+                          std::vector<PowerWindow> &windows) {
+  zes_power_energy_counter_t previous = {};
+  lzt::get_power_energy_counter(power_handle, &previous);
+  uint64_t previous_runs = load.runs();
+  const auto end = std::chrono::steady_clock::now() + duration;
+  auto deadline = std::chrono::steady_clock::now();
+  while (deadline < end) {
+    deadline += power_window;
+    std::this_thread::sleep_until(deadline);
+    zes_power_energy_counter_t counter = {};
+    lzt::get_power_energy_counter(power_handle, &counter);
+    const uint64_t runs = load.runs();
+    PowerWindow window;
+    window.end_s = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - origin)
+                       .count();
+    // Microjoules over microseconds are watts
+    window.power_w =
+        counter.timestamp > previous.timestamp
+            ? static_cast<double>(counter.energy - previous.energy) /
+                  (counter.timestamp - previous.timestamp)
+            : -1;
+    window.runs = runs - previous_runs;
+    windows.push_back(window);
+    previous = counter;
+    previous_runs = runs;
+  }
+}
+
+PowerWindow average_power_windows(const std::vector<PowerWindow> &windows,
+                                  size_t first, size_t last) {
+  PowerWindow average = {0, 0, 0};
+  size_t count = 0;
+  for (size_t i = first; i < last && i < windows.size(); i++) {
+    if (windows[i].power_w >= 0) {
+      average.power_w += windows[i].power_w;
+      count++;
+    }
+    average.runs += windows[i].runs;
+  }
+  if (count) {
+    average.power_w /= count;
+  }
+  return average;
+}
+
+TEST_F(
+    POWER_TEST,
+    GivenMaxPowerComputeLoadWhenLoweringSustainedLimitThenReportEnforcementResponseTimeAccuracyAndThroughputDrop) {
+  const char *enabled = getenv("LZT_SYSMAN_POWER_LIMIT_RESPONSE");
+  if (enabled == nullptr || strcmp(enabled, "1") != 0) {
+    GTEST_SKIP() << "Set LZT_SYSMAN_POWER_LIMIT_RESPONSE=1 to measure the "
+                    "power limit response";
+  }
+  for (auto device : devices) {
+    auto p_power_handle = lzt::get_card_power_handle(device);
+    if (p_power_handle == nullptr) {
+      FAIL() << "No handles found: "
+             << _ze_result_t(ZE_RESULT_ERROR_UNSUPPORTED_FEATURE);
+    }
+    uint32_t count_power = 0;
+    auto power_limits_descriptors =
+        lzt::get_power_limits_ext(p_power_handle, &count_power);
+    const auto power_limits_descriptors_initial = power_limits_descriptors;
+    int32_t sustained = -1;
+    for (uint32_t i = 0; i < power_limits_descriptors.size(); i++) {
+      if (power_limits_descriptors[i].level == ZES_POWER_LEVEL_SUSTAINED) {
+        sustained = i;
+      }
+    }
+    if (sustained < 0 ||
+        power_limits_descriptors[sustained].limitValueLocked ||
+        power_limits_descriptors[sustained].limitUnit != ZES_LIMIT_UNIT_POWER) {
+      LOG_INFO << "No sustained power limit in mW that can be set";
+      continue;
+    }
+
+#ifdef USE_ZESINIT
+    auto sysman_device_properties = lzt::get_sysman_device_properties(device);
+    ze_device_handle_t core_device =
+        get_core_device_by_uuid(sysman_device_properties.core.uuid.id);
+    ASSERT_NE(core_device, nullptr);
+#else  // USE_ZESINIT
+    ze_device_handle_t core_device = device;
+#endif // USE_ZESINIT
+
+    // The sustained limit is an average over its interval, so enforcement
+    // is watched over twice the interval
+    const auto enforced_time = std::min(
+        power_max_enforced_time,
+        std::max(power_min_enforced_time,
+                 std::chrono::milliseconds(
+                     2 * power_limits_descriptors[sustained].interval)));
+
+    PowerLimitLoad load(core_device);
+    std::vector<PowerWindow> windows;
+    windows.reserve((power_baseline_time + enforced_time) / power_window + 1);
+    const auto origin = std::chrono::steady_clock::now();
+    load.start();
+    record_power_windows(p_power_handle, load, origin, power_baseline_time,
+                         windows);
+    // The first half of the baseline lets the load ramp up
+    const size_t baseline_windows = windows.size();
+    const PowerWindow baseline = average_power_windows(
+        windows, baseline_windows / 2, baseline_windows);
+    ASSERT_GT(baseline.power_w, 0);
+
+    const double limit_w = baseline.power_w / 2;
+    power_limits_descriptors[sustained].limit =
+        static_cast<int32_t>(limit_w * 1000);
+    const double lowered_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - origin)
+            .count();
+    lzt::set_power_limits_ext(p_power_handle, &count_power,
+                              power_limits_descriptors.data());
+    record_power_windows(p_power_handle, load, origin, enforced_time, windows);
+    load.stop();
+    auto restore_descriptors = power_limits_descriptors_initial;
+    lzt::set_power_limits_ext(p_power_handle, &count_power,
+                              restore_descriptors.data());
+
+    double response_s = -1;
+    for (size_t i = baseline_windows; i < windows.size(); i++) {
+      if (windows[i].power_w >= 0 &&
+          windows[i].power_w <= limit_w * (1 + power_enforced_margin)) {
+        response_s = windows[i].end_s - lowered_s;
+        break;
+      }
+    }
+    // Accuracy and throughput over the last second of the enforcement
+    const size_t last_second = std::chrono::seconds(1) / power_window;
+    const PowerWindow enforced = average_power_windows(
+        windows, windows.size() - last_second, windows.size());
+    const double window_s =
+        std::chrono::duration<double>(power_window).count();
+    const double baseline_runs_per_s =
+        baseline.runs / ((baseline_windows - baseline_windows / 2) * window_s);
+    const double enforced_runs_per_s = enforced.runs / (last_second * window_s);
+
+    LOG_INFO << "Baseline " << baseline.power_w << " W, sustained limit "
+             << limit_w << " W, interval "
+             << power_limits_descriptors[sustained].interval << " ms";
+    LOG_INFO << "Enforced within " << power_enforced_margin * 100
+             << "% after " << response_s << " s, then " << enforced.power_w
+             << " W (" << 100.0 * (enforced.power_w / limit_w - 1)
+             << "% from the limit)";
+    LOG_INFO << "Throughput " << baseline_runs_per_s << " runs/s before, "
+             << enforced_runs_per_s << " runs/s limited ("
+             << 100.0 * (1 - enforced_runs_per_s / baseline_runs_per_s)
+             << "% drop)";
+    EXPECT_GE(response_s, 0) << "sustained limit not enforced within "
+                             << enforced_time.count() << " ms";
+    EXPECT_LT(enforced.power_w, baseline.power_w);
+  }
+}
+
 } // namespace
@@ -110,6 +110,33 @@ void basic(ze_context_handle_t context, ze_device_handle_t device,
   }
 }
 
+// Creates and destroys modules back to back, for the debugger to read
+// bursts of module load and unload events
+void module_load_burst_test(ze_context_handle_t context,
+                            ze_device_handle_t device,
+                            process_synchro &synchro,
+                            debug_options &options) {
+  const uint32_t module_count = 32;
+  synchro.wait_for_debugger_signal();
+  std::string module_name = (options.use_custom_module == true)
+                                ? options.module_name_in
+                                : "debug_add.spv";
+
+  std::vector<ze_module_handle_t> modules;
+  for (uint32_t i = 0; i < module_count; i++) {
+    modules.push_back(lzt::create_module(context, device, module_name,
+                                         ZE_MODULE_FORMAT_IL_SPIRV, "-g",
+                                         nullptr));
+  }
+  for (auto module : modules) {
+    lzt::destroy_module(module);
+  }
+
+  if (::testing::Test::HasFailure()) {
+    exit(1);
+  }
+}
+
 // Debugger attaches after module created
 void attach_after_module_created_test(ze_context_handle_t context,
                                       ze_device_handle_t device,
@@ -1201,6 +1228,9 @@ int main(int argc, char **argv) {
   case MULTIPLE_MODULES_CREATED:
     multiple_modules_created_test(context, device, synchro, options);
     break;
+  case MODULE_LOAD_BURST:
+    module_load_burst_test(context, device, synchro, options);
+    break;
   case ATTACH_AFTER_MODULE_DESTROYED:
     attach_after_module_destroyed_test(context, device, synchro, options);
     break;
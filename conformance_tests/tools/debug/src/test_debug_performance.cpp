@@ -0,0 +1,256 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "test_debug.hpp"
+#include "test_debug_utils.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Reads and acks the events of the session until the process exits
+void read_events_until_process_exit(zet_debug_session_handle_t session) {
+  zet_debug_event_t debug_event = {};
+  do {
+    if (lzt::debug_read_event(session, debug_event, eventsTimeoutMS, false) !=
+        ZE_RESULT_SUCCESS) {
+      break;
+    }
+    if (debug_event.flags & ZET_DEBUG_EVENT_FLAG_NEED_ACK) {
+      lzt::debug_ack_event(session, &debug_event);
+    }
+  } while (debug_event.type != ZET_DEBUG_EVENT_TYPE_PROCESS_EXIT &&
+           debug_event.type != ZET_DEBUG_EVENT_TYPE_INVALID);
+}
+
+class zetDebugPerformanceTest : public zetDebugThreadControlTest {
+protected:
+  void run_attach_latency_test(std::vector<ze_device_handle_t> &devices) {
+    const uint32_t cycles = 10;
+    for (auto &device : devices) {
+      print_device(device);
+      if (!is_debug_supported(device)) {
+        continue;
+      }
+
+      synchro->clear_debugger_signal();
+      debugHelper = launch_process(BASIC, device, false);
+      zet_debug_config_t debug_config = {};
+      debug_config.pid = debugHelper.id();
+
+      std::vector<double> attach_ms, detach_ms;
+      for (uint32_t cycle = 0; cycle < cycles; cycle++) {
+        auto start = std::chrono::steady_clock::now();
+        debugSession = lzt::debug_attach(device, debug_config);
+        attach_ms.push_back(elapsed_ms(start));
+        if (!debugSession) {
+          FAIL() << "[Debugger] Failed to attach to start a debug session";
+        }
+        start = std::chrono::steady_clock::now();
+        lzt::debug_detach(debugSession);
+        detach_ms.push_back(elapsed_ms(start));
+      }
+
+      // The last session lets the application run to its end
+      debugSession = lzt::debug_attach(device, debug_config);
+      if (!debugSession) {
+        FAIL() << "[Debugger] Failed to attach to start a debug session";
+      }
+      synchro->notify_application();
+      read_events_until_process_exit(debugSession);
+      debugHelper.wait();
+      lzt::debug_detach(debugSession);
+      EXPECT_EQ(debugHelper.exit_code(), 0);
+
+      LOG_INFO << "[Debugger] zetDebugAttach over " << cycles
+               << " sessions: min " << lzt::percentile(attach_ms, 0)
+               << " ms, p50 " << lzt::median(attach_ms) << " ms, max "
+               << lzt::percentile(attach_ms, 100) << " ms; zetDebugDetach p50 "
+               << lzt::median(detach_ms) << " ms";
+    }
+  }
+
+  void run_module_load_burst_test(std::vector<ze_device_handle_t> &devices) {
+    for (auto &device : devices) {
+      print_device(device);
+      if (!is_debug_supported(device)) {
+        continue;
+      }
+
+      synchro->clear_debugger_signal();
+      debugHelper = launch_process(MODULE_LOAD_BURST, device, false);
+      zet_debug_config_t debug_config = {};
+      debug_config.pid = debugHelper.id();
+      debugSession = lzt::debug_attach(device, debug_config);
+      if (!debugSession) {
+        FAIL() << "[Debugger] Failed to attach to start a debug session";
+      }
+      synchro->notify_application();
+
+      // Every read is timed from its call, and the burst from the return of
+      // the read of its first module event to the one of its last
+      std::vector<double> read_ms, ack_ms;
+      uint32_t module_loads = 0, module_unloads = 0;
+      std::chrono::steady_clock::time_point burst_start, burst_end;
+      zet_debug_event_t debug_event = {};
+      do {
+        auto start = std::chrono::steady_clock::now();
+        if (lzt::debug_read_event(debugSession, debug_event, eventsTimeoutMS,
+                                  false) != ZE_RESULT_SUCCESS) {
+          break;
+        }
+        const double read_time = elapsed_ms(start);
+        if (debug_event.type == ZET_DEBUG_EVENT_TYPE_MODULE_LOAD ||
+            debug_event.type == ZET_DEBUG_EVENT_TYPE_MODULE_UNLOAD) {
+          if (!module_loads && !module_unloads) {
+            burst_start = std::chrono::steady_clock::now();
+          } else {
+            read_ms.push_back(read_time);
+          }
+          burst_end = std::chrono::steady_clock::now();
+          if (debug_event.type == ZET_DEBUG_EVENT_TYPE_MODULE_LOAD) {
+            module_loads++;
+          } else {
+            module_unloads++;
+          }
+        }
+        if (debug_event.flags & ZET_DEBUG_EVENT_FLAG_NEED_ACK) {
+          start = std::chrono::steady_clock::now();
+          lzt::debug_ack_event(debugSession, &debug_event);
+          ack_ms.push_back(elapsed_ms(start));
+        }
+      } while (debug_event.type != ZET_DEBUG_EVENT_TYPE_PROCESS_EXIT &&
+               debug_event.type != ZET_DEBUG_EVENT_TYPE_INVALID);
+
+      debugHelper.wait();
+      lzt::debug_detach(debugSession);
+      EXPECT_EQ(debugHelper.exit_code(), 0);
+      EXPECT_GT(module_loads, 0);
+      EXPECT_EQ(module_loads, module_unloads);
+
+      const double burst_ms =
+          std::chrono::duration<double, std::milli>(burst_end - burst_start)
+              .count();
+      LOG_INFO << "[Debugger] " << module_loads << " module loads and "
+               << module_unloads << " unloads read in " << burst_ms
+               << " ms (" << (module_loads + module_unloads) * 1000 / burst_ms
+               << " events/s)";
+      // The first module event starts the burst, and events may need no ack
+      if (!read_ms.empty()) {
+        LOG_INFO << "[Debugger] Module event read p50 "
+                 << lzt::median(read_ms) << " ms p99 "
+                 << lzt::percentile(read_ms, 99) << " ms";
+      }
+      if (!ack_ms.empty()) {
+        LOG_INFO << "[Debugger] Event ack p50 " << lzt::median(ack_ms)
+                 << " ms";
+      }
+    }
+  }
+
+  void run_interrupt_latency_test(std::vector<ze_device_handle_t> &devices) {
+    const uint32_t rounds = 5;
+    for (auto &device : devices) {
+      print_device(device);
+      if (!is_debug_supported(device)) {
+        continue;
+      }
+
+      // Leaves every thread of the long running kernel stopped
+      SetUpThreadControl(device, false);
+      if (::testing::Test::HasFailure()) {
+        FAIL() << "[Debugger] Failed to setup Thread Control tests";
+      }
+
+      ze_device_thread_t all_threads;
+      all_threads.slice = UINT32_MAX;
+      all_threads.subslice = UINT32_MAX;
+      all_threads.eu = UINT32_MAX;
+      all_threads.thread = UINT32_MAX;
+
+      std::vector<double> event_ms, stopped_ms;
+      std::vector<ze_device_thread_t> newly_stopped_threads;
+      for (uint32_t round = 0; round < rounds; round++) {
+        lzt::debug_resume(debugSession, all_threads);
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // The first thread stopped event and the state of every thread
+        // stopped are timed from the interrupt
+        const auto start = std::chrono::steady_clock::now();
+        lzt::debug_interrupt(debugSession, all_threads);
+        zet_debug_event_t debug_event = {};
+        do {
+          if (lzt::debug_read_event(debugSession, debug_event,
+                                    eventsTimeoutMS / 10,
+                                    true) != ZE_RESULT_SUCCESS) {
+            break;
+          }
+        } while (debug_event.type != ZET_DEBUG_EVENT_TYPE_THREAD_STOPPED);
+        event_ms.push_back(elapsed_ms(start));
+        do {
+          newly_stopped_threads = get_stopped_threads(debugSession, device);
+        } while (newly_stopped_threads.size() < stopped_threads.size() &&
+                 elapsed_ms(start) < eventsTimeoutMS);
+        stopped_ms.push_back(elapsed_ms(start));
+        EXPECT_EQ(newly_stopped_threads.size(), stopped_threads.size());
+      }
+
+      LOG_INFO << "[Debugger] Interrupting " << stopped_threads.size()
+               << " threads: stopped event p50 " << lzt::median(event_ms)
+               << " ms max " << lzt::percentile(event_ms, 100)
+               << " ms, all threads stopped p50 " << lzt::median(stopped_ms)
+               << " ms max " << lzt::percentile(stopped_ms, 100) << " ms";
+
+      // Breaks the kernel loop so that the application completes
+      uint8_t buffer = 0;
+      lzt::debug_write_memory(debugSession, all_threads, memorySpaceDesc, 1,
+                              &buffer);
+      lzt::debug_resume(debugSession, all_threads);
+      debugHelper.wait();
+      lzt::debug_detach(debugSession);
+      ASSERT_EQ(debugHelper.exit_code(), 0);
+    }
+  }
+};
+
+TEST_F(
+    zetDebugPerformanceTest,
+    GivenDebugCapableDeviceWhenAttachingAndDetachingRepeatedlyThenReportAttachLatency) {
+  auto driver = lzt::get_default_driver();
+  auto devices = lzt::get_devices(driver);
+  run_attach_latency_test(devices);
+}
+
+TEST_F(
+    zetDebugPerformanceTest,
+    GivenApplicationLoadingModulesInBurstWhenReadingDebugEventsThenReportReadLatencyAndRate) {
+  auto driver = lzt::get_default_driver();
+  auto devices = lzt::get_devices(driver);
+  run_module_load_burst_test(devices);
+}
+
+TEST_F(
+    zetDebugPerformanceTest,
+    GivenLongRunningKernelWhenInterruptingAllThreadsThenReportInterruptToStoppedLatency) {
+  auto driver = lzt::get_default_driver();
+  auto devices = lzt::get_devices(driver);
+  run_interrupt_latency_test(devices);
+}
+
+} // namespace
@@ -0,0 +1,330 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+#include "logging/logging.hpp"
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "test_metric_utils.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+namespace {
+
+const uint32_t dispatch_count = 64;
+const int matrix_dimension = 512;
+
+// Times dispatch_count launches of the matrix multiplication kernel in one
+// command list, each signaling its own kernel timestamp event.  With a
+// query pool every launch is wrapped in a metric query of its own.
+struct DispatchTimes {
+  double host_ns = 0;
+  double device_total_ns = 0;
+  double device_busy_ns = 0;
+};
+
+DispatchTimes run_dispatches(ze_device_handle_t device,
+                             zet_metric_query_pool_handle_t query_pool,
+                             zet_metric_streamer_handle_t streamer = nullptr,
+                             ze_event_handle_t notify_event = nullptr,
+                             std::vector<uint8_t> *raw_data = nullptr,
+                             uint32_t *dropped_reads = nullptr) {
+  ze_command_queue_handle_t queue = lzt::create_command_queue(device);
+  zet_command_list_handle_t list = lzt::create_command_list(device);
+  void *a_buffer, *b_buffer, *c_buffer;
+  ze_group_count_t tg;
+  ze_kernel_handle_t function = get_matrix_multiplication_kernel(
+      device, &tg, &a_buffer, &b_buffer, &c_buffer, matrix_dimension);
+
+  auto ep = lzt::create_event_pool(lzt::get_default_context(), dispatch_count,
+                                   ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP |
+                                       ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  std::vector<ze_event_handle_t> events(dispatch_count);
+  std::vector<zet_metric_query_handle_t> queries;
+  for (uint32_t i = 0; i < dispatch_count; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    events[i] = lzt::create_event(ep, event_desc);
+    if (query_pool) {
+      queries.push_back(lzt::metric_query_create(query_pool, i));
+    }
+  }
+
+  for (uint32_t i = 0; i < dispatch_count; i++) {
+    if (query_pool) {
+      lzt::append_metric_query_begin(list, queries[i]);
+    }
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeCommandListAppendLaunchKernel(list, function, &tg, events[i],
+                                              0, nullptr));
+    if (query_pool) {
+      lzt::append_metric_query_end(list, queries[i], nullptr);
+    }
+  }
+  lzt::close_command_list(list);
+
+  // Reports are drained whenever the streamer signals that notifyEveryNReports
+  // are available, as a profiler would, and once more at the end
+  auto drain = [&]() {
+    size_t size = lzt::metric_streamer_read_data_size(streamer);
+    if (size == 0) {
+      return;
+    }
+    std::vector<uint8_t> data(size);
+    const ze_result_t result =
+        zetMetricStreamerReadData(streamer, UINT32_MAX, &size, data.data());
+    if (result == ZE_RESULT_WARNING_DROPPED_DATA) {
+      (*dropped_reads)++;
+    } else {
+      EXPECT_EQ(ZE_RESULT_SUCCESS, result);
+    }
+    raw_data->insert(raw_data->end(), data.begin(), data.begin() + size);
+  };
+
+  const auto start = std::chrono::steady_clock::now();
+  lzt::execute_command_lists(queue, 1, &list, nullptr);
+  if (streamer) {
+    while (zeCommandQueueSynchronize(queue, 0) == ZE_RESULT_NOT_READY) {
+      if (zeEventQueryStatus(notify_event) == ZE_RESULT_SUCCESS) {
+        lzt::event_host_reset(notify_event);
+        drain();
+      }
+    }
+  } else {
+    lzt::synchronize(queue, UINT64_MAX);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  if (streamer) {
+    drain();
+  }
+
+  DispatchTimes times;
+  times.host_ns =
+      std::chrono::duration<double, std::nano>(end - start).count();
+  const auto timeline = lzt::get_kernel_timeline(device, events);
+  times.device_total_ns = timeline.total_ns;
+  times.device_busy_ns = timeline.busy_ns;
+
+  if (query_pool) {
+    std::vector<uint8_t> query_data;
+    lzt::metric_query_get_data(queries.back(), &query_data);
+    EXPECT_GT(query_data.size(), 0);
+  }
+
+  for (auto query : queries) {
+    lzt::destroy_metric_query(query);
+  }
+  for (auto event : events) {
+    lzt::destroy_event(event);
+  }
+  lzt::destroy_event_pool(ep);
+  lzt::destroy_function(function);
+  lzt::free_memory(a_buffer);
+  lzt::free_memory(b_buffer);
+  lzt::free_memory(c_buffer);
+  lzt::destroy_command_list(list);
+  lzt::destroy_command_queue(queue);
+  return times;
+}
+
+void log_slowdown(const std::string &name, const DispatchTimes &baseline,
+                  const DispatchTimes &profiled) {
+  LOG_INFO << name << ": host " << profiled.host_ns << " ns ("
+           << 100.0 * (profiled.host_ns / baseline.host_ns - 1)
+           << "% slower), device span " << profiled.device_total_ns << " ns ("
+           << 100.0 *
+                  (profiled.device_total_ns / baseline.device_total_ns - 1)
+           << "% slower), kernel busy " << profiled.device_busy_ns << " ns ("
+           << 100.0 * (profiled.device_busy_ns / baseline.device_busy_ns - 1)
+           << "% slower), per dispatch "
+           << (profiled.device_total_ns - baseline.device_total_ns) /
+                  dispatch_count
+           << " ns";
+}
+
+class zetMetricPerformanceTest : public ::testing::Test {
+protected:
+  std::vector<ze_device_handle_t> devices;
+
+  void SetUp() override { devices = lzt::get_metric_test_device_list(); }
+};
+
+TEST_F(
+    zetMetricPerformanceTest,
+    GivenEventBasedMetricGroupWhenWrappingEveryDispatchInMetricQueryThenReportKernelSlowdown) {
+  for (auto device : devices) {
+    auto metricGroupInfo = lzt::get_metric_group_info(
+        device, ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_EVENT_BASED, false);
+    if (metricGroupInfo.empty()) {
+      LOG_WARNING << "no event based metric group, skipping device";
+      continue;
+    }
+    auto &groupInfo = metricGroupInfo[0];
+
+    // The baseline runs first so that the kernel is warm for both runs
+    run_dispatches(device, nullptr);
+    const auto baseline = run_dispatches(device, nullptr);
+
+    lzt::activate_metric_groups(device, 1, &groupInfo.metricGroupHandle);
+    zet_metric_query_pool_handle_t query_pool =
+        lzt::create_metric_query_pool_for_device(
+            device, dispatch_count, ZET_METRIC_QUERY_POOL_TYPE_PERFORMANCE,
+            groupInfo.metricGroupHandle);
+    const auto profiled = run_dispatches(device, query_pool);
+    lzt::destroy_metric_query_pool(query_pool);
+    lzt::deactivate_metric_groups(device);
+
+    log_slowdown("metric query " + groupInfo.metricGroupName, baseline,
+                 profiled);
+  }
+}
+
+class zetMetricStreamerPerformanceTest
+    : public zetMetricPerformanceTest,
+      public ::testing::WithParamInterface<std::tuple<uint32_t, uint32_t>> {};
+
+TEST_P(
+    zetMetricStreamerPerformanceTest,
+    GivenTimeBasedMetricGroupWhenStreamingDuringDispatchesThenReportKernelSlowdownAndDroppedReports) {
+  const uint32_t samplingPeriod = std::get<0>(GetParam());
+  const uint32_t notifyEveryNReports = std::get<1>(GetParam());
+
+  for (auto device : devices) {
+    auto metricGroupInfo = lzt::get_metric_group_info(
+        device, ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_TIME_BASED, false);
+    if (metricGroupInfo.empty()) {
+      LOG_WARNING << "no time based metric group, skipping device";
+      continue;
+    }
+    auto &groupInfo = metricGroupInfo[0];
+
+    run_dispatches(device, nullptr);
+    const auto baseline = run_dispatches(device, nullptr);
+
+    lzt::activate_metric_groups(device, 1, &groupInfo.metricGroupHandle);
+    ze_event_handle_t notify_event;
+    lzt::zeEventPool eventPool;
+    eventPool.create_event(notify_event, ZE_EVENT_SCOPE_FLAG_HOST,
+                           ZE_EVENT_SCOPE_FLAG_HOST);
+    zet_metric_streamer_handle_t streamer =
+        lzt::metric_streamer_open_for_device(device,
+                                             groupInfo.metricGroupHandle,
+                                             notify_event, notifyEveryNReports,
+                                             samplingPeriod);
+    ASSERT_NE(nullptr, streamer);
+
+    // The streamer runs from open to close, so the reports expected cover
+    // the whole window and not only the dispatches
+    const auto open = std::chrono::steady_clock::now();
+    std::vector<uint8_t> raw_data;
+    uint32_t dropped_reads = 0;
+    const auto profiled = run_dispatches(device, nullptr, streamer,
+                                         notify_event, &raw_data,
+                                         &dropped_reads);
+    const double window_ns = std::chrono::duration<double, std::nano>(
+                                 std::chrono::steady_clock::now() - open)
+                                 .count();
+    lzt::metric_streamer_close(streamer);
+    eventPool.destroy_event(notify_event);
+
+    std::vector<zet_typed_value_t> values;
+    std::vector<uint32_t> value_sets;
+    uint64_t reports = 0;
+    if (!raw_data.empty()) {
+      lzt::metric_calculate_metric_values_from_raw_data(
+          groupInfo.metricGroupHandle, raw_data, values, value_sets,
+          dropped_reads > 0);
+      for (auto set : value_sets) {
+        reports += set / groupInfo.metricCount;
+      }
+    }
+    lzt::deactivate_metric_groups(device);
+
+    const double expected = window_ns / samplingPeriod;
+    const double dropped_rate =
+        (expected > reports) ? 100.0 * (1 - reports / expected) : 0;
+    log_slowdown("streamer " + groupInfo.metricGroupName + " period " +
+                     std::to_string(samplingPeriod) + " ns, notify every " +
+                     std::to_string(notifyEveryNReports),
+                 baseline, profiled);
+    LOG_INFO << "streamer period " << samplingPeriod << " ns, notify every "
+             << notifyEveryNReports << ": " << reports << " reports of "
+             << static_cast<uint64_t>(expected) << " expected, "
+             << dropped_rate << "% dropped, " << dropped_reads
+             << " reads with dropped data, " << raw_data.size()
+             << " bytes";
+  }
+}
+
+TEST_F(
+    zetMetricPerformanceTest,
+    GivenHighSamplingRateWhenDrainingStreamerFromReaderThreadThenReportCollectedAndDroppedReports) {
+  const uint32_t samplingPeriod = 10000;
+  const uint32_t rounds = 8;
+
+  for (auto device : devices) {
+    auto metricGroupInfo = lzt::get_metric_group_info(
+        device, ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_TIME_BASED, false);
+    if (metricGroupInfo.empty()) {
+      LOG_WARNING << "no time based metric group, skipping device";
+      continue;
+    }
+    auto &groupInfo = metricGroupInfo[0];
+
+    lzt::activate_metric_groups(device, 1, &groupInfo.metricGroupHandle);
+    zet_metric_streamer_handle_t streamer =
+        lzt::metric_streamer_open_for_device(
+            device, groupInfo.metricGroupHandle, nullptr, UINT32_MAX,
+            samplingPeriod);
+    ASSERT_NE(nullptr, streamer);
+
+    const auto open = std::chrono::steady_clock::now();
+    lzt::zeMetricStreamerReader reader(streamer);
+    reader.start();
+    for (uint32_t round = 0; round < rounds; round++) {
+      run_dispatches(device, nullptr);
+    }
+    reader.stop();
+    const double window_ns = std::chrono::duration<double, std::nano>(
+                                 std::chrono::steady_clock::now() - open)
+                                 .count();
+
+    std::vector<zet_typed_value_t> values;
+    std::vector<uint32_t> value_sets;
+    reader.calculate(groupInfo.metricGroupHandle, values, value_sets);
+    lzt::metric_streamer_close(streamer);
+    lzt::deactivate_metric_groups(device);
+
+    uint64_t reports = 0;
+    for (auto set : value_sets) {
+      reports += set / groupInfo.metricCount;
+    }
+    const double expected = window_ns / samplingPeriod;
+    LOG_INFO << "streamer reader, period " << samplingPeriod << " ns over "
+             << window_ns << " ns: " << reports << " reports of "
+             << static_cast<uint64_t>(expected) << " expected, "
+             << reader.reads() << " reads, " << reader.dropped_reads()
+             << " with dropped data, " << reader.lost_bytes()
+             << " bytes overwritten in the ring";
+    EXPECT_EQ(0u, reader.lost_bytes());
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TestStreamerSamplingCost, zetMetricStreamerPerformanceTest,
+    ::testing::Combine(::testing::Values(10000u, 100000u, 1000000u),
+                       ::testing::Values(64u, 1024u, 16384u)));
+
+} // namespace
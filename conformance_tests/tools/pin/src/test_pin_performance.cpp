@@ -0,0 +1,160 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <cstring>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "logging/logging.hpp"
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+namespace {
+
+struct PinWorkload {
+  const char *module;
+  const char *kernel;
+  // Bytes of the input buffer read per work-item
+  size_t input_per_item;
+};
+
+const PinWorkload sp_compute = {"ze_sp_compute.spv", "compute_sp_v4",
+                                sizeof(float)};
+const PinWorkload global_bw = {"ze_global_bw.spv",
+                               "global_bandwidth_v4_local_offset",
+                               16 * 4 * sizeof(float)};
+
+const uint32_t work_items = 256 * 1024;
+const uint32_t group_size = 256;
+const uint32_t iterations = 20;
+
+// Median device time in ns of the kernel of the workload, built with the
+// profile flags given, and its output in output
+double time_kernel(const PinWorkload &workload, uint32_t profile_flags,
+                   std::vector<float> &output) {
+  auto context = lzt::get_default_context();
+  auto device = lzt::zeDevice::get_instance()->get_device();
+
+  std::string build_flags;
+  if (profile_flags) {
+    std::stringstream build_string;
+    build_string << "-zet-profile-flags " << std::hex << profile_flags;
+    build_flags = build_string.str();
+  }
+  auto module = lzt::create_module(context, device, workload.module,
+                                   ZE_MODULE_FORMAT_IL_SPIRV,
+                                   build_flags.c_str(), nullptr);
+  auto kernel = lzt::create_function(module, workload.kernel);
+  zet_profile_properties_t profile_properties = {
+      ZET_STRUCTURE_TYPE_PROFILE_PROPERTIES, nullptr};
+  EXPECT_EQ(ZE_RESULT_SUCCESS,
+            zetKernelGetProfileInfo(kernel, &profile_properties));
+  EXPECT_EQ(profile_flags, profile_properties.flags);
+
+  const size_t input_size = work_items * workload.input_per_item;
+  const size_t output_size = work_items * sizeof(float);
+  auto input = lzt::allocate_device_memory(input_size, 1, 0, 0, device,
+                                           context);
+  auto result = lzt::allocate_device_memory(output_size, 1, 0, 0, device,
+                                            context);
+  auto readback = lzt::allocate_host_memory(output_size, 1, context);
+  lzt::set_group_size(kernel, group_size, 1, 1);
+  lzt::set_argument_value(kernel, 0, sizeof(input), &input);
+  lzt::set_argument_value(kernel, 1, sizeof(result), &result);
+  ze_group_count_t group_count = {work_items / group_size, 1, 1};
+
+  auto ep = lzt::create_event_pool(context, iterations,
+                                   ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP |
+                                       ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  std::vector<ze_event_handle_t> events(iterations);
+  for (uint32_t i = 0; i < iterations; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    events[i] = lzt::create_event(ep, event_desc);
+  }
+
+  auto bundle = lzt::create_command_bundle(context, device, 0, false);
+  const float one = 1.0f;
+  lzt::append_memory_fill(bundle.list, input, &one, sizeof(one), input_size,
+                          nullptr);
+  lzt::append_barrier(bundle.list);
+  // The first launch warms up the kernel and is not timed
+  lzt::append_launch_function(bundle.list, kernel, &group_count, nullptr, 0,
+                              nullptr);
+  for (auto event : events) {
+    lzt::append_barrier(bundle.list);
+    lzt::append_launch_function(bundle.list, kernel, &group_count, event, 0,
+                                nullptr);
+  }
+  lzt::append_barrier(bundle.list);
+  lzt::append_memory_copy(bundle.list, readback, result, output_size);
+  lzt::close_command_list(bundle.list);
+  lzt::execute_and_sync_command_bundle(bundle, UINT64_MAX);
+
+  output.resize(work_items);
+  memcpy(output.data(), readback, output_size);
+  const auto clock = lzt::get_timestamp_clock(device);
+  std::vector<double> times;
+  for (auto event : events) {
+    times.push_back(
+        clock.duration_ns(lzt::get_event_kernel_timestamp(event).global));
+  }
+
+  lzt::destroy_command_bundle(bundle);
+  for (auto event : events) {
+    lzt::destroy_event(event);
+  }
+  lzt::destroy_event_pool(ep);
+  lzt::free_memory(context, readback);
+  lzt::free_memory(context, result);
+  lzt::free_memory(context, input);
+  lzt::destroy_function(kernel);
+  lzt::destroy_module(module);
+  return lzt::median(times);
+}
+
+class PINPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<PinWorkload> {};
+
+TEST_P(
+    PINPerformanceTests,
+    GivenPeakKernelBuiltWithProfileFlagsWhenLaunchingThenReportSlowdownOverUninstrumentedKernel) {
+  const PinWorkload workload = GetParam();
+  const std::vector<uint32_t> profile_flags = {
+      ZET_PROFILE_FLAG_REGISTER_REALLOCATION,
+      ZET_PROFILE_FLAG_FREE_REGISTER_INFO,
+      (ZET_PROFILE_FLAG_REGISTER_REALLOCATION |
+       ZET_PROFILE_FLAG_FREE_REGISTER_INFO)};
+
+  std::vector<float> baseline_output;
+  const double baseline_ns = time_kernel(workload, 0, baseline_output);
+  LOG_INFO << workload.kernel << " uninstrumented: " << baseline_ns << " ns";
+
+  for (auto flags : profile_flags) {
+    std::vector<float> output;
+    const double ns = time_kernel(workload, flags, output);
+    // Instrumentation must not change what the kernel computes
+    EXPECT_EQ(baseline_output, output);
+    LOG_INFO << workload.kernel << " profile flags 0x" << std::hex << flags
+             << std::dec << ": " << ns << " ns, slowdown "
+             << ns / baseline_ns << "x";
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(TestPinOverhead, PINPerformanceTests,
+                         ::testing::Values(sp_compute, global_bw));
+
+} // namespace
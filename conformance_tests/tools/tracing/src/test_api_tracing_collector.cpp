@@ -0,0 +1,89 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "logging/logging.hpp"
+#include "test_harness/test_harness.hpp"
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+namespace lzt = level_zero_tests;
+
+namespace {
+
+const uint32_t thread_count = 4;
+const uint32_t calls_per_thread = 10000;
+
+void query_signaled_event(ze_event_handle_t event) {
+  for (uint32_t i = 0; i < calls_per_thread; i++) {
+    zeEventQueryStatus(event);
+  }
+}
+
+TEST(
+    TraceCollectorTests,
+    GivenTraceCollectorWhenCallingAPIFromSeveralThreadsThenEveryCallIsWrittenAndConvertedToChromeTrace) {
+  const std::string trace_file = "test_api_tracing_collector.bin";
+  const std::string json_file = "test_api_tracing_collector.json";
+
+  auto ep = lzt::create_event_pool(lzt::get_default_context(), thread_count,
+                                   ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  std::vector<ze_event_handle_t> events(thread_count);
+  for (uint32_t i = 0; i < thread_count; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    events[i] = lzt::create_event(ep, event_desc);
+    lzt::signal_event_from_host(events[i]);
+  }
+
+  lzt::TraceCollector collector;
+  ASSERT_TRUE(collector.start(trace_file));
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < thread_count; i++) {
+    threads.emplace_back(query_signaled_event, events[i]);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  void *memory = lzt::allocate_host_memory(64);
+  lzt::free_memory(memory);
+  collector.stop();
+
+  EXPECT_EQ(0u, collector.dropped_records());
+  EXPECT_EQ(thread_count * calls_per_thread + 2, collector.records_written());
+
+  ASSERT_TRUE(lzt::convert_trace_to_chrome_json(trace_file, json_file));
+  std::ifstream json(json_file);
+  std::stringstream contents;
+  contents << json.rdbuf();
+  const std::string text = contents.str();
+  size_t spans = 0;
+  for (size_t at = text.find("\"ph\": \"X\""); at != std::string::npos;
+       at = text.find("\"ph\": \"X\"", at + 1)) {
+    spans++;
+  }
+  EXPECT_EQ(collector.records_written(), spans);
+  EXPECT_NE(std::string::npos, text.find("\"zeEventQueryStatus\""));
+  EXPECT_NE(std::string::npos, text.find("\"zeMemAllocHost\""));
+
+  for (auto event : events) {
+    lzt::destroy_event(event);
+  }
+  lzt::destroy_event_pool(ep);
+  std::remove(trace_file.c_str());
+  std::remove(json_file.c_str());
+}
+
+} // namespace
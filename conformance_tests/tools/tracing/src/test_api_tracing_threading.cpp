@@ -187,4 +187,52 @@ TEST_F(
   lzt::destroy_tracer_handle(tracer);
 }
 
+class TracingOverheadTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<lzt::tracing_overhead_mode_t> {};
+
+TEST_P(
+    TracingOverheadTests,
+    GivenTracingModeWhenCallingAPIFromIncreasingNumberOfThreadsThenReportPerCallOverhead) {
+  const lzt::tracing_overhead_mode_t mode = GetParam();
+  for (auto thread_count : lzt::tracing_thread_counts()) {
+    const auto disabled = lzt::time_query_status_calls(thread_count);
+    if (mode == lzt::TRACING_OVERHEAD_DISABLED) {
+      LOG_INFO << lzt::tracing_overhead_mode_name(mode) << ", "
+               << thread_count << " threads: " << disabled.ns_per_call
+               << " ns per call";
+      continue;
+    }
+
+    zet_tracer_exp_desc_t tracer_desc = {ZET_STRUCTURE_TYPE_TRACER_EXP_DESC,
+                                         nullptr, nullptr};
+    zet_tracer_exp_handle_t tracer = lzt::create_tracer_handle(tracer_desc);
+    zet_core_callbacks_t prologues = {};
+    zet_core_callbacks_t epilogues = {};
+    lzt::set_query_status_callbacks(mode, prologues, epilogues);
+    lzt::set_tracer_prologues(tracer, prologues);
+    lzt::set_tracer_epilogues(tracer, epilogues);
+    lzt::enable_tracer(tracer);
+    const auto traced = lzt::time_query_status_calls(thread_count);
+    lzt::disable_tracer(tracer);
+    lzt::destroy_tracer_handle(tracer);
+
+    lzt::log_tracing_overhead(lzt::tracing_overhead_mode_name(mode),
+                              thread_count, disabled.ns_per_call,
+                              traced.ns_per_call);
+    if (mode == lzt::TRACING_OVERHEAD_TIMESTAMP_CALLBACKS) {
+      LOG_INFO << lzt::tracing_overhead_mode_name(mode) << ", "
+               << thread_count << " threads: "
+               << traced.callback_ns_per_call
+               << " ns per call recorded by the callbacks";
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(TestTracingOverhead, TracingOverheadTests,
+                         ::testing::Values(
+                             lzt::TRACING_OVERHEAD_DISABLED,
+                             lzt::TRACING_OVERHEAD_EMPTY_CALLBACKS,
+                             lzt::TRACING_OVERHEAD_TIMESTAMP_CALLBACKS));
+
 } // namespace
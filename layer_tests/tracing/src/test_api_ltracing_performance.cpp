@@ -0,0 +1,208 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <atomic>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "logging/logging.hpp"
+#include "test_harness/test_harness.hpp"
+#include <level_zero/ze_api.h>
+#include <level_zero/layers/zel_tracing_api.h>
+#include <level_zero/layers/zel_tracing_register_cb.h>
+
+namespace lzt = level_zero_tests;
+
+namespace {
+
+// The same call mix is traced through the ze_callbacks_t tables of
+// zelTracerSetPrologues/Epilogues, as in test_api_ltracing.cpp, and through
+// the per API zelTracer*RegisterCallback functions, as in
+// test_api_ltracing_compat.cpp
+enum LTracingPath { LTP_DISABLED, LTP_CALLBACK_TABLES, LTP_REGISTER_CALLBACK };
+
+std::string ltracing_path_name(LTracingPath path) {
+  switch (path) {
+  case LTP_DISABLED:
+    return "tracing disabled";
+  case LTP_CALLBACK_TABLES:
+    return "callback tables";
+  case LTP_REGISTER_CALLBACK:
+    return "register callback";
+  }
+  return "unknown";
+}
+
+// Both paths install these same callbacks, which count the traced calls of
+// their thread and so cost the same whichever path calls them
+thread_local uint64_t prologue_calls = 0;
+thread_local uint64_t epilogue_calls = 0;
+
+template <typename params_t>
+void OnEnterCount(params_t *params, ze_result_t result, void *pTraceUserData,
+                  void **ppTracerInstanceUserData) {
+  prologue_calls++;
+}
+
+template <typename params_t>
+void OnExitCount(params_t *params, ze_result_t result, void *pTraceUserData,
+                 void **ppTracerInstanceUserData) {
+  epilogue_calls++;
+}
+
+const uint32_t mix_iterations = 20000;
+const uint32_t calls_per_iteration = 5;
+
+struct CallMixTimes {
+  double ns_per_call;
+  double calls_per_second;
+  uint64_t traced_calls;
+};
+
+// Every thread repeats zeEventQueryStatus, zeEventHostReset,
+// zeEventQueryStatus, zeEventHostSignal and zeDeviceGetProperties on an
+// event of its own, a mix of cheap calls whose cost is dominated by the
+// tracing layer once traced
+CallMixTimes time_call_mix(ze_device_handle_t device, uint32_t thread_count) {
+  std::atomic<uint64_t> traced_calls(0);
+  const auto thread_ns = lzt::time_threads_with_own_event(
+      thread_count, [&](uint32_t index, ze_event_handle_t event) {
+        ze_device_properties_t properties = {
+            ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, nullptr};
+        prologue_calls = 0;
+        epilogue_calls = 0;
+        for (uint32_t i = 0; i < mix_iterations; i++) {
+          if (zeEventQueryStatus(event) != ZE_RESULT_SUCCESS ||
+              zeEventHostReset(event) != ZE_RESULT_SUCCESS ||
+              zeEventQueryStatus(event) != ZE_RESULT_NOT_READY ||
+              zeEventHostSignal(event) != ZE_RESULT_SUCCESS ||
+              zeDeviceGetProperties(device, &properties) !=
+                  ZE_RESULT_SUCCESS) {
+            break;
+          }
+        }
+        EXPECT_EQ(prologue_calls, epilogue_calls);
+        traced_calls += prologue_calls;
+      });
+
+  double total_ns = 0, longest_ns = 0;
+  for (auto ns : thread_ns) {
+    total_ns += ns;
+    longest_ns = std::max(longest_ns, ns);
+  }
+  const double calls =
+      static_cast<double>(mix_iterations) * calls_per_iteration * thread_count;
+  CallMixTimes times;
+  times.ns_per_call = total_ns / calls;
+  times.calls_per_second = longest_ns > 0 ? calls * 1e9 / longest_ns : 0;
+  times.traced_calls = traced_calls;
+  return times;
+}
+
+void register_count_callbacks(zel_tracer_handle_t tracer) {
+  for (auto type : {ZEL_REGISTER_PROLOGUE, ZEL_REGISTER_EPILOGUE}) {
+    const bool prologue = type == ZEL_REGISTER_PROLOGUE;
+    zelTracerEventQueryStatusRegisterCallback(
+        tracer, type,
+        prologue ? OnEnterCount<ze_event_query_status_params_t>
+                 : OnExitCount<ze_event_query_status_params_t>);
+    zelTracerEventHostResetRegisterCallback(
+        tracer, type,
+        prologue ? OnEnterCount<ze_event_host_reset_params_t>
+                 : OnExitCount<ze_event_host_reset_params_t>);
+    zelTracerEventHostSignalRegisterCallback(
+        tracer, type,
+        prologue ? OnEnterCount<ze_event_host_signal_params_t>
+                 : OnExitCount<ze_event_host_signal_params_t>);
+    zelTracerDeviceGetPropertiesRegisterCallback(
+        tracer, type,
+        prologue ? OnEnterCount<ze_device_get_properties_params_t>
+                 : OnExitCount<ze_device_get_properties_params_t>);
+  }
+}
+
+void set_count_callback_tables(zel_tracer_handle_t tracer) {
+  ze_callbacks_t prologues = {};
+  ze_callbacks_t epilogues = {};
+  prologues.Event.pfnQueryStatusCb =
+      OnEnterCount<ze_event_query_status_params_t>;
+  epilogues.Event.pfnQueryStatusCb =
+      OnExitCount<ze_event_query_status_params_t>;
+  prologues.Event.pfnHostResetCb = OnEnterCount<ze_event_host_reset_params_t>;
+  epilogues.Event.pfnHostResetCb = OnExitCount<ze_event_host_reset_params_t>;
+  prologues.Event.pfnHostSignalCb =
+      OnEnterCount<ze_event_host_signal_params_t>;
+  epilogues.Event.pfnHostSignalCb = OnExitCount<ze_event_host_signal_params_t>;
+  prologues.Device.pfnGetPropertiesCb =
+      OnEnterCount<ze_device_get_properties_params_t>;
+  epilogues.Device.pfnGetPropertiesCb =
+      OnExitCount<ze_device_get_properties_params_t>;
+  lzt::set_ltracer_prologues(tracer, prologues);
+  lzt::set_ltracer_epilogues(tracer, epilogues);
+}
+
+class LTracingPathPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<LTracingPath> {};
+
+#ifdef USE_RUNTIME_TRACING
+class LDynamicTracingPathPerformanceTests
+    : public LTracingPathPerformanceTests {};
+#define LTRACING_PATH_PERFORMANCE_TEST_NAME LDynamicTracingPathPerformanceTests
+#else // USE Tracing ENV
+#define LTRACING_PATH_PERFORMANCE_TEST_NAME LTracingPathPerformanceTests
+#endif
+
+TEST_P(
+    LTRACING_PATH_PERFORMANCE_TEST_NAME,
+    GivenTracingPathWhenCallingAPIMixFromIncreasingNumberOfThreadsThenReportPerCallOverheadAndThroughput) {
+  const LTracingPath path = GetParam();
+  auto device = lzt::zeDevice::get_instance()->get_device();
+  for (auto thread_count : lzt::tracing_thread_counts()) {
+    const CallMixTimes disabled = time_call_mix(device, thread_count);
+    if (path == LTP_DISABLED) {
+      LOG_INFO << ltracing_path_name(path) << ", " << thread_count
+               << " threads: " << disabled.ns_per_call << " ns per call, "
+               << disabled.calls_per_second << " calls/s";
+      continue;
+    }
+
+    zel_tracer_desc_t tracer_desc = {ZEL_STRUCTURE_TYPE_TRACER_EXP_DESC,
+                                     nullptr, nullptr};
+    zel_tracer_handle_t tracer = lzt::create_ltracer_handle(tracer_desc);
+    if (path == LTP_CALLBACK_TABLES) {
+      set_count_callback_tables(tracer);
+    } else {
+      register_count_callbacks(tracer);
+    }
+    lzt::enable_ltracer(tracer);
+    const CallMixTimes traced = time_call_mix(device, thread_count);
+    lzt::disable_ltracer(tracer);
+    lzt::destroy_ltracer_handle(tracer);
+
+    // Every call of the mix must have gone through the callbacks, or the
+    // path did not trace what the other one did
+    EXPECT_EQ(traced.traced_calls,
+              static_cast<uint64_t>(mix_iterations) * calls_per_iteration *
+                  thread_count);
+    lzt::log_tracing_overhead(ltracing_path_name(path), thread_count,
+                              disabled.ns_per_call, traced.ns_per_call);
+    LOG_INFO << ltracing_path_name(path) << ", " << thread_count
+             << " threads: " << traced.calls_per_second
+             << " calls/s against " << disabled.calls_per_second
+             << " untraced";
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(TestLTracingPathPerformance,
+                         LTRACING_PATH_PERFORMANCE_TEST_NAME,
+                         ::testing::Values(LTP_DISABLED, LTP_CALLBACK_TABLES,
+                                           LTP_REGISTER_CALLBACK));
+
+} // namespace
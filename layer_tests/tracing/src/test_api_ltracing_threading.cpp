@@ -202,4 +202,59 @@ TEST_F(
   lzt::destroy_ltracer_handle(tracer);
 }
 
+class LTracingOverheadTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<lzt::tracing_overhead_mode_t> {};
+
+#ifdef USE_RUNTIME_TRACING
+class LDynamicTracingOverheadTests : public LTracingOverheadTests {};
+#define LTRACING_OVERHEAD_TEST_NAME LDynamicTracingOverheadTests
+#else // USE Tracing ENV
+#define LTRACING_OVERHEAD_TEST_NAME LTracingOverheadTests
+#endif
+
+TEST_P(
+    LTRACING_OVERHEAD_TEST_NAME,
+    GivenTracingModeWhenCallingAPIFromIncreasingNumberOfThreadsThenReportPerCallOverhead) {
+  const lzt::tracing_overhead_mode_t mode = GetParam();
+  for (auto thread_count : lzt::tracing_thread_counts()) {
+    const auto disabled = lzt::time_query_status_calls(thread_count);
+    if (mode == lzt::TRACING_OVERHEAD_DISABLED) {
+      LOG_INFO << lzt::tracing_overhead_mode_name(mode) << ", "
+               << thread_count << " threads: " << disabled.ns_per_call
+               << " ns per call";
+      continue;
+    }
+
+    zel_tracer_desc_t tracer_desc = {ZEL_STRUCTURE_TYPE_TRACER_DESC, nullptr,
+                                     nullptr};
+    zel_tracer_handle_t tracer = lzt::create_ltracer_handle(tracer_desc);
+    zet_core_callbacks_t prologues = {};
+    zet_core_callbacks_t epilogues = {};
+    lzt::set_query_status_callbacks(mode, prologues, epilogues);
+    lzt::set_ltracer_prologues(tracer, prologues);
+    lzt::set_ltracer_epilogues(tracer, epilogues);
+    lzt::enable_ltracer(tracer);
+    const auto traced = lzt::time_query_status_calls(thread_count);
+    lzt::disable_ltracer(tracer);
+    lzt::destroy_ltracer_handle(tracer);
+
+    lzt::log_tracing_overhead(lzt::tracing_overhead_mode_name(mode),
+                              thread_count, disabled.ns_per_call,
+                              traced.ns_per_call);
+    if (mode == lzt::TRACING_OVERHEAD_TIMESTAMP_CALLBACKS) {
+      LOG_INFO << lzt::tracing_overhead_mode_name(mode) << ", "
+               << thread_count << " threads: "
+               << traced.callback_ns_per_call
+               << " ns per call recorded by the callbacks";
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(TestLTracingOverhead, LTRACING_OVERHEAD_TEST_NAME,
+                         ::testing::Values(
+                             lzt::TRACING_OVERHEAD_DISABLED,
+                             lzt::TRACING_OVERHEAD_EMPTY_CALLBACKS,
+                             lzt::TRACING_OVERHEAD_TIMESTAMP_CALLBACKS));
+
 } // namespace
@@ -0,0 +1,29 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gmock/gmock.h"
+#include "logging/logging.hpp"
+#include "utils/utils.hpp"
+
+int main(int argc, char **argv) {
+  // The layers are enabled in the helper processes only, one configuration
+  // per process, since the loader reads the layer settings in zeInit
+  ::testing::InitGoogleMock(&argc, argv);
+  std::vector<std::string> command_line(argv + 1, argv + argc);
+  level_zero_tests::init_logging(command_line);
+
+  ze_result_t result = zeInit(0);
+  if (result) {
+    throw std::runtime_error("zeInit failed: " +
+                             level_zero_tests::to_string(result));
+  }
+  LOG_TRACE << "Driver initialized";
+  level_zero_tests::print_platform_overview();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include <boost/process.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <map>
+#include <thread>
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+
+namespace bp = boost::process;
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct LayerConfig {
+  std::string name;
+  bool validation;
+  bool parameter_validation;
+  bool handle_lifetime;
+};
+
+const LayerConfig layers_disabled = {"layers disabled", false, false, false};
+
+// Runs test_validation_performance_helper with the layers of the
+// configuration and returns its ns per call of every API timed
+std::map<std::string, double> run_helper(const LayerConfig &config,
+                                         uint32_t thread_count) {
+  auto env = boost::this_process::environment();
+  bp::environment child_env = env;
+  child_env.erase("ZE_ENABLE_VALIDATION_LAYER");
+  child_env.erase("ZE_ENABLE_PARAMETER_VALIDATION");
+  child_env.erase("ZE_ENABLE_HANDLE_LIFETIME");
+  if (config.validation) {
+    child_env["ZE_ENABLE_VALIDATION_LAYER"] = "1";
+  }
+  if (config.parameter_validation) {
+    child_env["ZE_ENABLE_PARAMETER_VALIDATION"] = "1";
+  }
+  if (config.handle_lifetime) {
+    child_env["ZE_ENABLE_HANDLE_LIFETIME"] = "1";
+  }
+
+  fs::path helper_path(fs::current_path() / "validation");
+  std::vector<fs::path> paths;
+  paths.push_back(helper_path);
+  fs::path helper =
+      bp::search_path("test_validation_performance_helper", paths);
+  bp::ipstream child_output;
+  bp::child helper_process(helper, std::to_string(thread_count), child_env,
+                           bp::std_out > child_output);
+
+  std::map<std::string, double> ns_per_call;
+  std::string line;
+  while (std::getline(child_output, line)) {
+    const auto separator = line.rfind(':');
+    if (separator == std::string::npos) {
+      LOG_INFO << line;
+      continue;
+    }
+    ns_per_call[line.substr(0, separator)] =
+        std::stod(line.substr(separator + 1));
+  }
+  helper_process.wait();
+  EXPECT_EQ(helper_process.exit_code(), 0)
+      << config.name << ": helper failed with " << thread_count << " threads";
+  return ns_per_call;
+}
+
+class ValidationLayerPerformanceTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<LayerConfig> {};
+
+TEST_P(
+    ValidationLayerPerformanceTests,
+    GivenLayerConfigurationWhenCallingHotAPIsThenReportPerCallOverheadAgainstLayersDisabled) {
+  const LayerConfig config = GetParam();
+  const uint32_t max_threads =
+      std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+  std::vector<uint32_t> thread_counts = {1};
+  if (max_threads > 1) {
+    thread_counts.push_back(max_threads);
+  }
+
+  for (auto thread_count : thread_counts) {
+    // The same calls without any layer are the reference of the overhead
+    auto disabled = run_helper(layers_disabled, thread_count);
+    auto enabled = run_helper(config, thread_count);
+    ASSERT_FALSE(enabled.empty());
+
+    LOG_INFO << config.name << ", " << thread_count << " threads:";
+    for (auto &timed : enabled) {
+      auto reference = disabled.find(timed.first);
+      if (reference == disabled.end()) {
+        // Error paths are only timed with the layer that catches them
+        LOG_INFO << "  " << timed.first << ": " << timed.second
+                 << " ns per call";
+        continue;
+      }
+      LOG_INFO << "  " << timed.first << ": " << timed.second
+               << " ns per call, " << timed.second - reference->second
+               << " ns overhead ("
+               << 100.0 * (timed.second / reference->second - 1) << "%)";
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TestValidationLayerPerformance, ValidationLayerPerformanceTests,
+    ::testing::Values(
+        LayerConfig{"validation layer", true, false, false},
+        LayerConfig{"parameter validation", true, true, false},
+        LayerConfig{"handle lifetime", true, false, true},
+        LayerConfig{"parameter validation and handle lifetime", true, true,
+                    true}),
+    [](const ::testing::TestParamInfo<LayerConfig> &info) {
+      std::string name = info.param.name;
+      std::replace(name.begin(), name.end(), ' ', '_');
+      return name;
+    });
+
+} // namespace
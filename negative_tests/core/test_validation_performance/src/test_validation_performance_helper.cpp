@@ -0,0 +1,206 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace lzt = level_zero_tests;
+
+namespace {
+
+const uint32_t iterations = 2000;
+
+struct TimedCall {
+  std::string name;
+  // Calls the API once; false if it did not return what it should
+  std::function<bool(uint32_t)> call;
+};
+
+bool layer_enabled(const char *name) {
+  const char *value = getenv(name);
+  return value && strcmp(value, "1") == 0;
+}
+
+} // namespace
+
+// Times the hot APIs, then the error paths the enabled layers catch, from
+// the number of threads given, each on objects of its own, and prints one
+// "name:ns per call" line per API for test_validation_performance
+int main(int argc, char **argv) {
+  const uint32_t thread_count = argc > 1 ? std::max(1, atoi(argv[1])) : 1;
+  ze_result_t result = zeInit(0);
+  if (result != ZE_RESULT_SUCCESS) {
+    std::cout << "zeInit failed" << std::endl;
+    exit(1);
+  }
+
+  auto driver = lzt::get_default_driver();
+  auto device = lzt::zeDevice::get_instance()->get_device();
+  auto context = lzt::create_context(driver);
+
+  auto ep = lzt::create_event_pool(context, thread_count,
+                                   ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  std::vector<ze_event_handle_t> events(thread_count);
+  std::vector<ze_command_queue_handle_t> queues(thread_count);
+  std::vector<ze_command_list_handle_t> lists(thread_count);
+  std::vector<void *> sources(thread_count), destinations(thread_count);
+  std::vector<ze_event_handle_t> destroyed_events(thread_count);
+  const size_t copy_size = 4096;
+  for (uint32_t i = 0; i < thread_count; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    events[i] = lzt::create_event(ep, event_desc);
+    queues[i] = lzt::create_command_queue(
+        context, device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+        ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+    lists[i] = lzt::create_command_list(context, device, 0);
+    sources[i] = lzt::allocate_host_memory(copy_size, 1, context);
+    destinations[i] = lzt::allocate_host_memory(copy_size, 1, context);
+
+    // A handle of a destroyed event, which only handle lifetime tracking
+    // tells from a live one
+    auto pool = lzt::create_event_pool(context, 1,
+                                       ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+    event_desc.index = 0;
+    destroyed_events[i] = lzt::create_event(pool, event_desc);
+    lzt::destroy_event(destroyed_events[i]);
+    lzt::destroy_event_pool(pool);
+  }
+
+  std::vector<TimedCall> calls = {
+      {"zeEventHostSignal",
+       [&](uint32_t t) {
+         return zeEventHostSignal(events[t]) == ZE_RESULT_SUCCESS;
+       }},
+      {"zeEventQueryStatus",
+       [&](uint32_t t) {
+         return zeEventQueryStatus(events[t]) == ZE_RESULT_SUCCESS;
+       }},
+      {"zeEventHostReset",
+       [&](uint32_t t) {
+         return zeEventHostReset(events[t]) == ZE_RESULT_SUCCESS;
+       }},
+      {"zeMemAllocHost+zeMemFree",
+       [&](uint32_t t) {
+         ze_host_mem_alloc_desc_t desc = {
+             ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC, nullptr, 0};
+         void *memory = nullptr;
+         return zeMemAllocHost(context, &desc, copy_size, 1, &memory) ==
+                    ZE_RESULT_SUCCESS &&
+                zeMemFree(context, memory) == ZE_RESULT_SUCCESS;
+       }},
+      {"zeCommandListAppendMemoryCopy",
+       [&](uint32_t t) {
+         return zeCommandListAppendMemoryCopy(lists[t], destinations[t],
+                                              sources[t], copy_size, nullptr,
+                                              0, nullptr) == ZE_RESULT_SUCCESS;
+       }},
+      {"zeCommandListReset",
+       [&](uint32_t t) {
+         return zeCommandListReset(lists[t]) == ZE_RESULT_SUCCESS;
+       }},
+      {"zeCommandQueueExecuteCommandLists+Synchronize",
+       [&](uint32_t t) {
+         return zeCommandListReset(lists[t]) == ZE_RESULT_SUCCESS &&
+                zeCommandListAppendMemoryCopy(
+                    lists[t], destinations[t], sources[t], copy_size, nullptr,
+                    0, nullptr) == ZE_RESULT_SUCCESS &&
+                zeCommandListClose(lists[t]) == ZE_RESULT_SUCCESS &&
+                zeCommandQueueExecuteCommandLists(queues[t], 1, &lists[t],
+                                                  nullptr) ==
+                    ZE_RESULT_SUCCESS &&
+                zeCommandQueueSynchronize(queues[t], UINT64_MAX) ==
+                    ZE_RESULT_SUCCESS;
+       }},
+  };
+
+  // Without the checks that catch them, these calls would reach the driver
+  // with invalid arguments
+  if (layer_enabled("ZE_ENABLE_VALIDATION_LAYER") &&
+      layer_enabled("ZE_ENABLE_PARAMETER_VALIDATION")) {
+    calls.push_back({"error zeEventQueryStatus(nullptr)", [&](uint32_t t) {
+                       return zeEventQueryStatus(nullptr) ==
+                              ZE_RESULT_ERROR_INVALID_NULL_HANDLE;
+                     }});
+    calls.push_back(
+        {"error zeMemAllocHost(size 0)", [&](uint32_t t) {
+           ze_host_mem_alloc_desc_t desc = {
+               ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC, nullptr, 0};
+           void *memory = nullptr;
+           return zeMemAllocHost(context, &desc, 0, 1, &memory) !=
+                  ZE_RESULT_SUCCESS;
+         }});
+  }
+  if (layer_enabled("ZE_ENABLE_VALIDATION_LAYER") &&
+      layer_enabled("ZE_ENABLE_HANDLE_LIFETIME")) {
+    calls.push_back(
+        {"error zeEventQueryStatus(destroyed event)", [&](uint32_t t) {
+           return zeEventQueryStatus(destroyed_events[t]) ==
+                  ZE_RESULT_ERROR_INVALID_NULL_HANDLE;
+         }});
+  }
+
+  bool failed = false;
+  for (auto &timed_call : calls) {
+    std::atomic<uint32_t> started(0);
+    std::atomic<bool> call_failed(false);
+    std::vector<double> thread_ns(thread_count);
+    auto caller = [&](uint32_t t) {
+      started++;
+      while (started < thread_count) {
+      }
+      const auto start = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < iterations; i++) {
+        if (!timed_call.call(t)) {
+          call_failed = true;
+          break;
+        }
+      }
+      thread_ns[t] = std::chrono::duration<double, std::nano>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < thread_count; t++) {
+      threads.emplace_back(caller, t);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    if (call_failed) {
+      std::cerr << timed_call.name << " failed" << std::endl;
+      failed = true;
+      continue;
+    }
+    double total_ns = 0;
+    for (auto ns : thread_ns) {
+      total_ns += ns;
+    }
+    std::cout << timed_call.name << ":"
+              << total_ns / (static_cast<double>(iterations) * thread_count)
+              << std::endl;
+  }
+
+  for (uint32_t i = 0; i < thread_count; i++) {
+    lzt::free_memory(context, sources[i]);
+    lzt::free_memory(context, destinations[i]);
+    lzt::destroy_command_list(lists[i]);
+    lzt::destroy_command_queue(queues[i]);
+    lzt::destroy_event(events[i]);
+  }
+  lzt::destroy_event_pool(ep);
+  lzt::destroy_context(context);
+  exit(failed ? 1 : 0);
+}
@@ -59,6 +59,7 @@ public:
   void measureParallelDevice2Host();
   int parse_command_line(int argc, char **argv);
   bool is_json_output_enabled();
+  void put_image_config(ptree *test_ptree);
 
 private:
   cl_context clContext;
@@ -88,6 +89,13 @@ private:
   cl_channel_type to_channel_datatype(std::string channel_datatype);
   cl_channel_order to_channel_order(std::string channel_order);
   cl_mem_object_type to_image_type(std::string image_type);
+  bool to_channel_format(const std::string &layout, const std::string &format);
+  uint32_t channel_count();
+  uint32_t channel_bits();
+  uint32_t bytes_per_pixel();
+  std::string layout_name();
+  std::string format_name();
+  std::string type_name();
 };
 
 class ClImageCopyLatency : public ClImageCopy {
@@ -78,7 +78,7 @@ void ClImageCopy::create_resources(void) {
     throw std::runtime_error("clCreateCommandQueueWithProperties failed: ");
   }
 
-  imagesize = 4 * width * height * depth;
+  imagesize = static_cast<size_t>(bytes_per_pixel()) * width * height * depth;
 
   // create host side src  and dst buffers
   src = new uint8_t[imagesize];
@@ -113,6 +113,17 @@ ClImageCopy ::~ClImageCopy() {}
 bool ClImageCopy::is_json_output_enabled(void) {
   return JsonFileName.size() != 0;
 }
+
+// Configuration of a result, with the same keys and values as in
+// ze_image_copy
+void ClImageCopy::put_image_config(ptree *test_ptree) {
+  test_ptree->put("API", "OpenCL");
+  test_ptree->put("Image type", type_name());
+  test_ptree->put("Image Layout", layout_name());
+  test_ptree->put("Image format", format_name());
+  test_ptree->put("Iterations", number_iterations);
+  test_ptree->put("Copies", num_image_copy);
+}
 void ClImageCopy::validate_data_buffer(void) {
   if (this->data_validation) {
     validRet = (0 == memcmp(src, dst, imagesize));
@@ -338,6 +349,7 @@ void measure_bandwidth_Host2Device2Host(ClImageCopy &Imagecopy,
     test_ptree->put(
         "Name", "Host2Device2Host: Bandwidth copying from Host->Device->Host ");
     test_ptree->put("Image size", Image_dimensions.str());
+    Imagecopy.put_image_config(test_ptree);
   } else {
     std::cout << "Host2Device2Host: Measuring Bandwidth for copying the "
                  "image buffer size "
@@ -367,6 +379,7 @@ void measure_bandwidth_Host2Device(ClImageCopy &Imagecopy, ptree *test_ptree) {
                      << Imagecopy.depth;
     test_ptree->put("Name", "Host2Device: Bandwidth copying from Host->Device");
     test_ptree->put("Image size", Image_dimensions.str());
+    Imagecopy.put_image_config(test_ptree);
   } else {
     std::cout
         << "Host2Device: Measuring Bandwidth/Latency for copying the image "
@@ -379,6 +392,7 @@ void measure_bandwidth_Host2Device(ClImageCopy &Imagecopy, ptree *test_ptree) {
 
   if (Imagecopy.is_json_output_enabled()) {
     test_ptree->put("GBPS", Imagecopy.gbps);
+    test_ptree->put("Latency", Imagecopy.latency);
     if (Imagecopy.data_validation) {
       test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
     }
@@ -398,6 +412,7 @@ void measure_bandwidth_Device2Host(ClImageCopy &Imagecopy, ptree *test_ptree) {
                      << Imagecopy.depth;
     test_ptree->put("Name", "Device2Host: Bandwidth copying from Device->Host");
     test_ptree->put("Image size", Image_dimensions.str());
+    Imagecopy.put_image_config(test_ptree);
   } else {
     std::cout
         << "Device2Host: Measurign Bandwidth/Latency for copying the image "
@@ -410,6 +425,7 @@ void measure_bandwidth_Device2Host(ClImageCopy &Imagecopy, ptree *test_ptree) {
 
   if (Imagecopy.is_json_output_enabled()) {
     test_ptree->put("GBPS", Imagecopy.gbps);
+    test_ptree->put("Latency", Imagecopy.latency);
     if (Imagecopy.data_validation)
       test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
   } else {
@@ -450,11 +466,7 @@ void measure_latency_Host2Device(ClImageCopyLatency &imageCopyLatency,
     test_ptree->put("Name",
                     "Host2Device: Measuring Latency for copying the image ");
     test_ptree->put("Image size", Image_dimensions.str());
-    test_ptree->put("Image type", level_zero_tests::to_string(
-                                      (cl_uint)imageCopyLatency.clImagetype));
-    test_ptree->put("Image Channel order",
-                    level_zero_tests::to_string(
-                        (cl_uint)imageCopyLatency.clImageChannelOrder));
+    imageCopyLatency.put_image_config(test_ptree);
   } else {
     std::cout
         << "Host2Device: Measuring Bandwidth/Latency for copying the image "
@@ -487,11 +499,7 @@ void measure_latency_Device2Host(ClImageCopyLatency &imageCopyLatency,
     test_ptree->put("Name",
                     "Device2Host: Measuring Latency for copying the image");
     test_ptree->put("Image size", Image_dimensions.str());
-    test_ptree->put("Image type", level_zero_tests::to_string(
-                                      (cl_uint)imageCopyLatency.clImagetype));
-    test_ptree->put("Image Channel order",
-                    level_zero_tests::to_string(
-                        (cl_uint)imageCopyLatency.clImageChannelOrder));
+    imageCopyLatency.put_image_config(test_ptree);
   } else {
     std::cout
         << "Device2Host: Measuring Bandwidth/Latency for copying the image "
@@ -543,6 +551,13 @@ int main(int argc, char **argv) {
   ClImageCopyLatency imageCopyLatency;
   imageCopyLatency.JsonFileName =
       Imagecopy.JsonFileName; // need to add latency values to the same file
+  // 1x1x1 image of the measured format, so that both benchmarks measure the
+  // latency of the same configuration
+  imageCopyLatency.clImageChannelOrder = Imagecopy.clImageChannelOrder;
+  imageCopyLatency.clChannelDataType = Imagecopy.clChannelDataType;
+  imageCopyLatency.number_iterations = Imagecopy.number_iterations;
+  imageCopyLatency.warm_up_iterations = Imagecopy.warm_up_iterations;
+  imageCopyLatency.num_image_copy = Imagecopy.num_image_copy;
   measure_latency(imageCopyLatency);
 
   std::cout << std::flush;
@@ -14,6 +14,8 @@ int ClImageCopy::parse_command_line(int argc, char **argv) {
   std::string flags = "";
   std::string image_type = "";
   std::string channel_datatype = "";
+  std::string layout = "";
+  std::string format = "";
 
   // Declare the supported options.
   po::options_description desc("Allowed options");
@@ -47,6 +49,19 @@ int ClImageCopy::parse_command_line(int argc, char **argv) {
       "SNORM_INT8/SNORM_INT16/UNORM_INT8/UNORM_INT16/UNORM_SHORT565/"
       "UNORM_SHORT555/UNORM_INT_101010/SIGNED_INT8/SIGNED_INT16/SIGNED_INT32/"
       "UNSIGNED_INT8/UNSIGNED_INT16/UNSIGNED_INT32/HALF_FLOAT/FLOAT")(
+      "layout", po::value<string>(&layout),
+      "image layout as in ze_image_copy like "
+      "8/16/32/8_8/16_16/32_32/8_8_8_8/16_16_16_16/32_32_32_32, sets the "
+      "channel order and data type")(
+      "format", po::value<string>(&format),
+      "image format as in ze_image_copy like UINT/SINT/UNORM/SNORM/FLOAT, "
+      "UINT by default with layout")(
+      "type", po::value<string>(&image_type),
+      "same as image_type, as in ze_image_copy")(
+      "num-iter", po::value<uint32_t>(&number_iterations),
+      "same as iter, as in ze_image_copy")(
+      "noofimg", po::value<uint32_t>(&num_image_copy),
+      "same as num_image_copies, as in ze_image_copy")(
       "data-validation", po::value<uint32_t>(&data_validation),
       "optional param for validating the copied image is correct or not")(
       "json-output-file", po::value<string>(&JsonFileName),
@@ -66,6 +81,12 @@ int ClImageCopy::parse_command_line(int argc, char **argv) {
   if (vm.count("help")) {
     std::cout << desc << "\n";
     return 1;
+  } else if ((layout.size() != 0 || format.size() != 0) &&
+             !to_channel_format(layout.size() ? layout : "8_8_8_8",
+                                format.size() ? format : "UINT")) {
+    std::cout << "unknown layout and format" << endl;
+    std::cout << desc << "\n";
+    return 1;
   } else if (clChannelDataType == -1) {
     std::cout << "unknown channel datatype" << endl;
     std::cout << desc << "\n";
@@ -93,6 +93,155 @@ cl_mem_object_type ClImageCopy::to_image_type(std::string image_type) {
   abort();
 }
 
+// Channel order and data type of a ze_image_copy layout and format, false
+// when OpenCL has no such format
+bool ClImageCopy::to_channel_format(const std::string &layout,
+                                    const std::string &format) {
+  uint32_t bits = 0;
+
+  if (layout == "8" || layout == "16" || layout == "32") {
+    clImageChannelOrder = CL_R;
+  } else if (layout == "8_8" || layout == "16_16" || layout == "32_32") {
+    clImageChannelOrder = CL_RG;
+  } else if (layout == "8_8_8_8" || layout == "16_16_16_16" ||
+             layout == "32_32_32_32") {
+    clImageChannelOrder = CL_RGBA;
+  } else {
+    return false;
+  }
+  bits = std::stoi(layout.substr(0, layout.find('_')));
+
+  if (format == "UINT") {
+    clChannelDataType = (bits == 8)    ? CL_UNSIGNED_INT8
+                        : (bits == 16) ? CL_UNSIGNED_INT16
+                                       : CL_UNSIGNED_INT32;
+  } else if (format == "SINT") {
+    clChannelDataType = (bits == 8)    ? CL_SIGNED_INT8
+                        : (bits == 16) ? CL_SIGNED_INT16
+                                       : CL_SIGNED_INT32;
+  } else if (format == "UNORM" && bits != 32) {
+    clChannelDataType = (bits == 8) ? CL_UNORM_INT8 : CL_UNORM_INT16;
+  } else if (format == "SNORM" && bits != 32) {
+    clChannelDataType = (bits == 8) ? CL_SNORM_INT8 : CL_SNORM_INT16;
+  } else if (format == "FLOAT" && bits != 8) {
+    clChannelDataType = (bits == 16) ? CL_HALF_FLOAT : CL_FLOAT;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+uint32_t ClImageCopy::channel_count() {
+  switch (clImageChannelOrder) {
+  case CL_RG:
+  case CL_RA:
+    return 2;
+  case CL_RGB:
+    return 3;
+  case CL_RGBA:
+  case CL_ARGB:
+  case CL_BGRA:
+    return 4;
+  default:
+    return 1;
+  }
+}
+
+// Bits per channel, 0 for the packed data types
+uint32_t ClImageCopy::channel_bits() {
+  switch (clChannelDataType) {
+  case CL_SNORM_INT8:
+  case CL_UNORM_INT8:
+  case CL_SIGNED_INT8:
+  case CL_UNSIGNED_INT8:
+    return 8;
+  case CL_SNORM_INT16:
+  case CL_UNORM_INT16:
+  case CL_SIGNED_INT16:
+  case CL_UNSIGNED_INT16:
+  case CL_HALF_FLOAT:
+    return 16;
+  case CL_SIGNED_INT32:
+  case CL_UNSIGNED_INT32:
+  case CL_FLOAT:
+    return 32;
+  default:
+    return 0;
+  }
+}
+
+uint32_t ClImageCopy::bytes_per_pixel() {
+  switch (clChannelDataType) {
+  case CL_UNORM_SHORT_565:
+  case CL_UNORM_SHORT_555:
+    return 2;
+  case CL_UNORM_INT_101010:
+    return 4;
+  default:
+    return channel_count() * channel_bits() / 8;
+  }
+}
+
+// Layout, format and type in the spelling of the ze_image_copy options,
+// so that the results of both benchmarks can be matched
+std::string ClImageCopy::layout_name() {
+  switch (clChannelDataType) {
+  case CL_UNORM_SHORT_565:
+    return "5_6_5";
+  case CL_UNORM_SHORT_555:
+    return "5_5_5_1";
+  case CL_UNORM_INT_101010:
+    return "10_10_10_2";
+  default:
+    break;
+  }
+  std::string name = std::to_string(channel_bits());
+  for (uint32_t i = 1; i < channel_count(); i++) {
+    name += "_" + std::to_string(channel_bits());
+  }
+  return name;
+}
+
+std::string ClImageCopy::format_name() {
+  switch (clChannelDataType) {
+  case CL_SIGNED_INT8:
+  case CL_SIGNED_INT16:
+  case CL_SIGNED_INT32:
+    return "SINT";
+  case CL_UNSIGNED_INT8:
+  case CL_UNSIGNED_INT16:
+  case CL_UNSIGNED_INT32:
+    return "UINT";
+  case CL_SNORM_INT8:
+  case CL_SNORM_INT16:
+    return "SNORM";
+  case CL_HALF_FLOAT:
+  case CL_FLOAT:
+    return "FLOAT";
+  default:
+    return "UNORM";
+  }
+}
+
+std::string ClImageCopy::type_name() {
+  switch (clImagetype) {
+  case CL_MEM_OBJECT_BUFFER:
+    return "BUFFER";
+  case CL_MEM_OBJECT_IMAGE3D:
+    return "3D";
+  case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+    return "2DARRAY";
+  case CL_MEM_OBJECT_IMAGE1D:
+    return "1D";
+  case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+    return "1DARRAY";
+  case CL_MEM_OBJECT_IMAGE1D_BUFFER:
+    return "1DBUFFER";
+  default:
+    return "2D";
+  }
+}
+
 namespace level_zero_tests {
 
 // for channel order, channel type and mem_object type
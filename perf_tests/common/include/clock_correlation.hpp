@@ -0,0 +1,103 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _CLOCK_CORRELATION_HPP_
+#define _CLOCK_CORRELATION_HPP_
+
+#include <level_zero/ze_api.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+/* One zeDeviceGetGlobalTimestamps reading */
+struct ClockSample {
+  uint64_t host_ns;
+  uint64_t device_ticks;
+};
+
+/*
+ * Maps device timestamps to host time. Every sample() reads the host and
+ * device clocks together, and the last window samples are fitted with a
+ * line, whose slope is the drift of the device clock against the host
+ * clock. Device timestamps, of global width or of the narrower kernel
+ * timestamps, are unwrapped around the latest sample and converted to
+ * host nanoseconds, in the clock of the host timestamps of the driver.
+ * Tools sample at the start and then every so often, such as once per
+ * iteration, to follow the drift.
+ */
+class ClockCorrelation {
+public:
+  ClockCorrelation(ze_device_handle_t device, size_t window = 64);
+
+  ClockSample sample();
+  /* count samples interval apart */
+  void calibrate(uint32_t count, std::chrono::microseconds interval);
+
+  long double device_to_host_ns(uint64_t device_ticks) const;
+  long double kernel_to_host_ns(uint64_t kernel_ticks) const;
+  /* Device clock rate against the host clock in parts per million */
+  long double drift_ppm() const;
+  long double nsec_per_tick() const { return tick_ns; }
+  size_t samples() const { return window_samples.size(); }
+
+  /* Ticks from begin to end of a counter of valid_bits that may have
+   * wrapped once in between */
+  static uint64_t elapsed_ticks(uint64_t begin, uint64_t end,
+                                uint32_t valid_bits) {
+    const uint64_t mask =
+        valid_bits >= 64 ? ~0ULL : ((1ULL << valid_bits) - 1);
+    return (end - begin) & mask;
+  }
+  /* Ticks from begin to end as elapsed_ticks, negative when end is the
+   * earlier one by less than half the range of the counter */
+  static int64_t signed_elapsed_ticks(uint64_t begin, uint64_t end,
+                                      uint32_t valid_bits) {
+    const uint64_t mask =
+        valid_bits >= 64 ? ~0ULL : ((1ULL << valid_bits) - 1);
+    const uint64_t forward = elapsed_ticks(begin, end, valid_bits);
+    if (forward > mask / 2) {
+      return -static_cast<int64_t>(elapsed_ticks(end, begin, valid_bits));
+    }
+    return static_cast<int64_t>(forward);
+  }
+  /* Ticks from a global timestamp of the device to a later kernel
+   * timestamp, counted on the narrower of the two counters, which may
+   * have wrapped between them */
+  uint64_t global_to_kernel_ticks(uint64_t global_ticks,
+                                  uint64_t kernel_ticks) const {
+    return elapsed_ticks(global_ticks, kernel_ticks,
+                         std::min(global_bits, kernel_bits));
+  }
+
+private:
+  /* A sample with the device clock unwrapped since the first sample */
+  struct FittedSample {
+    long double host_ns;
+    long double device_ns;
+  };
+
+  long double to_host_ns(uint64_t ticks, uint32_t valid_bits) const;
+  void fit();
+
+  ze_device_handle_t device;
+  long double tick_ns;
+  uint32_t global_bits;
+  uint32_t kernel_bits;
+  size_t window;
+
+  std::deque<FittedSample> window_samples;
+  ClockSample latest = {0, 0};
+  long double latest_device_ns = 0;
+  /* host_ns = intercept + slope * device_ns */
+  long double slope = 1;
+  long double intercept = 0;
+};
+
+#endif /* _CLOCK_CORRELATION_HPP_ */
@@ -8,11 +8,21 @@
 
 #ifndef _COMMON_HPP_
 #define _COMMON_HPP_
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 // Bandwidth reported in GBPS (10^9), instead of GiBPS (2^30).
 #define ONE_KB (1 * 1000ULL)
 #define ONE_MB (1 * ONE_KB * ONE_KB)
@@ -57,6 +67,170 @@ private:
   }
 };
 
+/*
+ * Clock reading the TSC with rdtscp on x86, which waits for the timed code
+ * to complete before reading, at a fraction of the cost of steady_clock.
+ * The tick period is calibrated against steady_clock on first use.
+ * Elsewhere it is steady_clock.
+ */
+struct TscClock {
+  typedef std::chrono::nanoseconds duration;
+  typedef duration::rep rep;
+  typedef duration::period period;
+  typedef std::chrono::time_point<TscClock> time_point;
+  static const bool is_steady = true;
+
+  static time_point now() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    static const long double nsec_per_tick = calibrate();
+    unsigned int aux;
+    return time_point(
+        duration(static_cast<rep>(__rdtscp(&aux) * nsec_per_tick)));
+#else
+    return time_point(std::chrono::duration_cast<duration>(
+        std::chrono::steady_clock::now().time_since_epoch()));
+#endif
+  }
+
+private:
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  static long double calibrate() {
+    unsigned int aux;
+    auto steady_begin = std::chrono::steady_clock::now();
+    uint64_t tsc_begin = __rdtscp(&aux);
+    while (std::chrono::steady_clock::now() - steady_begin <
+           std::chrono::milliseconds(20)) {
+    }
+    uint64_t tsc_end = __rdtscp(&aux);
+    auto steady_end = std::chrono::steady_clock::now();
+    return std::chrono::duration<long double, std::nano>(steady_end -
+                                                         steady_begin)
+               .count() /
+           (tsc_end - tsc_begin);
+  }
+#endif
+};
+
+/* Nearest rank percentile of samples sorted in ascending order, p from 0
+ * to 100, 0 without samples */
+inline long double sorted_percentile(const std::vector<long double> &sorted,
+                                     long double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const long double position =
+      std::max<long double>(p, 0) / 100 * (sorted.size() - 1);
+  const size_t rank = static_cast<size_t>(position + 0.5);
+  return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+/* sorted_percentile of samples in any order */
+inline long double sample_percentile(std::vector<long double> samples,
+                                     long double p) {
+  std::sort(samples.begin(), samples.end());
+  return sorted_percentile(samples, p);
+}
+
+inline long double sample_median(const std::vector<long double> &samples) {
+  return sample_percentile(samples, 50);
+}
+
+/*
+ * Timer keeping every sample. The overhead is the median of
+ * calibration_samples back to back start/stop pairs, the sample buffer is
+ * allocated up front so that stop() never allocates, and the statistics
+ * are computed on demand once the timed loop is done.
+ * Samples are in units of T, stop(operations) divides a sample by the
+ * number of operations it timed.
+ */
+template <typename T = std::chrono::nanoseconds::period,
+          typename Clock = std::chrono::steady_clock>
+class SampleTimer {
+public:
+  SampleTimer(size_t capacity, uint32_t calibration_samples = 1000)
+      : capacity(capacity) {
+    sample_buffer.reserve(std::max<size_t>(capacity, calibration_samples));
+    sorted.reserve(sample_buffer.capacity());
+    for (uint32_t i = 0; i < calibration_samples; i++) {
+      start();
+      time_end = Clock::now();
+      sample_buffer.push_back(
+          std::chrono::duration<long double, T>(time_end - time_start)
+              .count());
+    }
+    time_overhead = calibration_samples ? percentile(50) : 0;
+    clear();
+  }
+
+  inline void start() { time_start = Clock::now(); }
+
+  /* Records the sample, dropped once capacity samples are kept */
+  inline void stop(uint32_t operations = 1) {
+    time_end = Clock::now();
+    if (sample_buffer.size() < capacity) {
+      long double sample =
+          std::chrono::duration<long double, T>(time_end - time_start)
+              .count() -
+          time_overhead;
+      sample_buffer.push_back(std::max<long double>(sample, 0) / operations);
+      is_sorted = false;
+    }
+  }
+
+  /* Drops the samples, such as the ones of the warmup iterations */
+  void clear() {
+    sample_buffer.clear();
+    is_sorted = false;
+  }
+
+  size_t count() const { return sample_buffer.size(); }
+  const std::vector<long double> &samples() const { return sample_buffer; }
+  long double overhead() const { return time_overhead; }
+
+  long double mean() const {
+    if (sample_buffer.empty()) {
+      return 0;
+    }
+    long double sum = 0;
+    for (auto sample : sample_buffer) {
+      sum += sample;
+    }
+    return sum / sample_buffer.size();
+  }
+
+  long double stddev() const {
+    if (sample_buffer.empty()) {
+      return 0;
+    }
+    const long double sample_mean = mean();
+    long double sum_squares = 0;
+    for (auto sample : sample_buffer) {
+      sum_squares += (sample - sample_mean) * (sample - sample_mean);
+    }
+    return std::sqrt(sum_squares / sample_buffer.size());
+  }
+
+  /* Nearest rank percentile, p from 0 to 100 */
+  long double percentile(long double p) {
+    if (!is_sorted) {
+      sorted.assign(sample_buffer.begin(), sample_buffer.end());
+      std::sort(sorted.begin(), sorted.end());
+      is_sorted = true;
+    }
+    return sorted_percentile(sorted, p);
+  }
+
+  long double median() { return percentile(50); }
+
+private:
+  typename Clock::time_point time_start, time_end;
+  long double time_overhead = 0;
+  size_t capacity;
+  std::vector<long double> sample_buffer;
+  std::vector<long double> sorted;
+  bool is_sorted = false;
+};
+
 inline uint64_t roundToMultipleOf(uint64_t number, uint64_t base,
                                   uint64_t maxValue) {
   uint64_t n = (number > maxValue) ? maxValue : number;
@@ -87,6 +261,45 @@ template <typename T> int size_in_bytes(const std::vector<T> &v) {
   return static_cast<int>(sizeof(T) * v.size());
 }
 
+/*
+ * Native binaries built ahead of time with ocloc for the devices of the
+ * ZE_NATIVE_KERNEL_TARGETS build option are installed next to their SPIR-V
+ * module, kernel.spv giving kernel_<device>.bin. Returns their paths for
+ * the module at spirv_path, to be tried with ZE_MODULE_FORMAT_NATIVE before
+ * building the SPIR-V; zeModuleCreate rejects a binary of another device.
+ * ZE_PERF_NATIVE_KERNELS=0 keeps to the SPIR-V, e.g. to measure the JIT.
+ */
+inline std::vector<std::string>
+native_binary_paths(const std::string &spirv_path) {
+#ifdef ZE_NATIVE_KERNEL_TARGETS
+  const std::string devices = ZE_NATIVE_KERNEL_TARGETS;
+#else
+  const std::string devices;
+#endif
+  std::vector<std::string> paths;
+  const char *enabled = getenv("ZE_PERF_NATIVE_KERNELS");
+  const size_t extension = spirv_path.rfind(".spv");
+  if ((enabled != nullptr && strcmp(enabled, "0") == 0) ||
+      extension == std::string::npos) {
+    return paths;
+  }
+
+  const std::string stem = spirv_path.substr(0, extension);
+  size_t begin = 0;
+  while (begin < devices.size()) {
+    size_t end = devices.find(',', begin);
+    if (end == std::string::npos) {
+      end = devices.size();
+    }
+    if (end > begin) {
+      paths.push_back(stem + "_" + devices.substr(begin, end - begin) +
+                      ".bin");
+    }
+    begin = end + 1;
+  }
+  return paths;
+}
+
 #define ERROR_RETURN(retval)                                                   \
   {                                                                            \
     std::cerr << "ERROR : " << __FILE__ << ":" << __LINE__ << " " << ret       \
@@ -0,0 +1,71 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _HOST_PLACEMENT_HPP_
+#define _HOST_PLACEMENT_HPP_
+
+#include <level_zero/ze_api.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+ * Where the host threads of a tool run and where its host buffers live,
+ * from the options shared by the tools:
+ *
+ *   --cpus list          bind to the CPUs of list, such as 0-3,8
+ *   --numa-local         bind to the CPUs local to the device
+ *   --rt-priority n      run with SCHED_FIFO priority n
+ *   --host-numa-node n   allocate host buffers on NUMA node n, or on the
+ *                        node of the device with "local"
+ *
+ * Tools parse the options, apply them on their submission thread once the
+ * device is known and print the placement that took effect. Threads the
+ * tool starts later inherit it. The device locality comes from sysman
+ * and sysfs, so tools enable sysman before zeInit when needs_sysman says
+ * so. Placement is only supported on Linux; elsewhere the options are
+ * accepted and reported as not applied.
+ */
+class HostPlacement {
+public:
+  /* Consumes argv[i], and its value, when it is a placement option */
+  bool parse_option(int argc, char **argv, int &i);
+  static const char *usage();
+  static bool needs_sysman(int argc, char **argv);
+
+  bool enabled() const;
+  /* Binds the calling thread and sets its scheduling for device, which
+   * may be null without --numa-local and --host-numa-node local */
+  void apply(ze_device_handle_t device);
+  /* Runs allocate on a thread bound to the CPUs of the host NUMA node, so
+   * that the pages it touches first come from that node */
+  void allocate_on_node(const std::function<void()> &allocate) const;
+  /* Affinity and scheduling of the calling thread and the host node */
+  std::string describe() const;
+
+  /* NUMA node and local CPUs of the PCI device, -1 and none if unknown */
+  static void device_locality(ze_device_handle_t device, int &numa_node,
+                              std::vector<int> &cpus);
+  /* Lists of ranges such as 0-27,56-83 */
+  static std::vector<int> parse_cpu_list(const std::string &list);
+  static std::string cpu_list_string(const std::vector<int> &cpus);
+
+private:
+  std::vector<int> requested_cpus;
+  bool numa_local = false;
+  int rt_priority = 0;
+  bool host_node_local = false;
+  int host_node = -1;
+
+  /* CPUs of host_node once resolved by apply */
+  std::vector<int> host_node_cpus;
+  std::vector<std::string> warnings;
+};
+
+#endif /* _HOST_PLACEMENT_HPP_ */
@@ -0,0 +1,98 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _METRIC_PROFILER_HPP_
+#define _METRIC_PROFILER_HPP_
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Hardware counters of a device sampled in streamer mode while a stage of
+ * a tool runs, from the options shared by the tools:
+ *
+ *   --metrics group          stream the time based metric group, such as
+ *                            ComputeBasic
+ *   --metrics-period ns      sampling period (default: 100000)
+ *   --metrics-filter list    comma separated parts of the names of the
+ *                            metrics reported, such as EuActive,L3
+ *
+ * Tools parse the options, init the profiler once the device is known and
+ * put begin and end around the timed part of every stage. A thread drains
+ * the streamer while the window is open so that the hardware buffer does
+ * not overflow on long stages. At end the raw reports are calculated into
+ * one value per metric: event counts are summed over the window, with
+ * byte counts also given as GB/s, and every other metric is averaged over
+ * the reports. Metrics must be enabled before zeInit, which tools do when
+ * needs_metrics says so.
+ */
+class MetricProfiler {
+public:
+  struct Counter {
+    std::string name;
+    std::string unit;
+    long double value;
+  };
+
+  ~MetricProfiler();
+
+  /* Consumes argv[i], and its value, when it is a metric option */
+  bool parse_option(int argc, char **argv, int &i);
+  static const char *usage();
+  static bool needs_metrics(int argc, char **argv);
+
+  bool enabled() const { return !group_name.empty(); }
+  /* Finds and activates the metric group on device, false if the device
+   * has no time based group of that name */
+  bool init(ze_context_handle_t context, ze_device_handle_t device);
+  void begin();
+  /* Closes the window started by begin, false if none was started */
+  bool end(std::vector<Counter> &counters);
+  static std::string describe(const std::vector<Counter> &counters);
+
+private:
+  struct Metric {
+    uint32_t index;
+    std::string name;
+    std::string unit;
+    zet_metric_type_t type;
+  };
+
+  void drain();
+  void read_reports();
+  static long double typed_value(const zet_typed_value_t &value);
+
+  std::string group_name;
+  uint32_t sampling_period_ns = 100000;
+  std::vector<std::string> filters = {"EuActive", "EuStall", "XveActive",
+                                      "XveStall", "L3",      "GpuMemory"};
+
+  ze_context_handle_t context = nullptr;
+  ze_device_handle_t device = nullptr;
+  zet_metric_group_handle_t group = nullptr;
+  uint32_t metric_count = 0;
+  std::vector<Metric> metrics;
+
+  zet_metric_streamer_handle_t streamer = nullptr;
+  std::chrono::steady_clock::time_point window_begin;
+  std::atomic<bool> running{false};
+  std::thread drainer;
+  std::mutex raw_mutex;
+  std::vector<uint8_t> raw_data;
+  uint32_t dropped_reads = 0;
+};
+
+#endif /* _METRIC_PROFILER_HPP_ */
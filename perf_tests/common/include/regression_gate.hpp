@@ -0,0 +1,76 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _REGRESSION_GATE_HPP_
+#define _REGRESSION_GATE_HPP_
+
+#include "results.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+ * Compares the results of a report against a stored baseline, as the
+ * gate:<dir> result sink, or stores the report as the baseline, as the
+ * baseline:<dir> sink. There is one baseline file in dir per tool, device
+ * SKU and driver version, so a baseline is only compared against runs on
+ * the same devices and driver.
+ *
+ * The samples of a result are its per iteration samples when the tool
+ * records them, otherwise its value, and records that only differ in the
+ * parameters of a run, such as its repetition or iteration count, pool
+ * their samples. Every result with samples in both runs is compared with a
+ * one sided Mann-Whitney U test in the direction of a regression: lower is
+ * better for time units and higher for all others. A result regresses when
+ * the test is significant at alpha and its median moved the wrong way by
+ * more than min_change, and a regression makes the status of the sink
+ * nonzero. ZE_PERF_GATE_ALPHA and ZE_PERF_GATE_MIN_CHANGE override the
+ * defaults. Without a baseline, the gate stores the run as one and passes.
+ */
+class RegressionGateSink : public ResultSink {
+public:
+  RegressionGateSink(const std::string &directory, bool update);
+  void add(const ResultRecord &record) override;
+  void end(const ResultMetadata &metadata) override;
+  int status() const override { return (regressions || failed) ? 1 : 0; }
+
+  /* One sided p value of the hypothesis that y tends to be greater than x,
+   * from the normal approximation with tie and continuity corrections */
+  static long double mann_whitney_greater(const std::vector<long double> &x,
+                                          const std::vector<long double> &y);
+  static bool lower_is_better(const std::string &unit);
+  std::string baseline_file(const ResultMetadata &metadata) const;
+
+  long double alpha = 0.01;
+  /* Relative change of the median, 0.01 is 1% */
+  long double min_change = 0.01;
+  /* Fewer samples on either side cannot be significant at usual alphas */
+  size_t min_samples = 5;
+
+private:
+  struct Samples {
+    std::string unit;
+    std::vector<long double> values;
+  };
+
+  bool read_baseline(const std::string &file_name,
+                     std::map<std::string, Samples> &baseline);
+  bool write_baseline(const std::string &file_name) const;
+  void compare(const std::map<std::string, Samples> &baseline);
+
+  std::string directory;
+  bool update;
+  /* Samples of the current run by result key */
+  std::map<std::string, Samples> current;
+  uint32_t regressions = 0;
+  /* The baseline could not be read */
+  bool failed = false;
+};
+
+#endif /* _REGRESSION_GATE_HPP_ */
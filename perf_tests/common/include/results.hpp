@@ -0,0 +1,138 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _RESULTS_HPP_
+#define _RESULTS_HPP_
+
+#include <level_zero/ze_api.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Distribution of the samples behind a result, count is 0 when absent */
+struct ResultStats {
+  size_t count = 0;
+  long double min = 0;
+  long double max = 0;
+  long double mean = 0;
+  long double median = 0;
+  long double stddev = 0;
+  long double p99 = 0;
+
+  static ResultStats from_samples(std::vector<long double> samples);
+};
+
+/*
+ * One measured value: the test it comes from, such as "Host2Device", the
+ * metric and its unit, such as "bandwidth" in "GBPS", and the parameters
+ * the value was measured with, such as the transfer size or the device.
+ */
+struct ResultRecord {
+  std::string test;
+  std::string metric;
+  std::string unit;
+  long double value = 0;
+  std::vector<std::pair<std::string, std::string>> parameters;
+  ResultStats stats;
+  /* Per iteration values behind value, compared by the regression gate */
+  std::vector<long double> samples;
+};
+
+struct ResultDevice {
+  std::string name;
+  std::string uuid;
+  uint32_t core_clock_mhz = 0;
+};
+
+/* What the results were measured on, written once per report */
+struct ResultMetadata {
+  std::string tool;
+  std::string driver_version;
+  std::vector<ResultDevice> devices;
+};
+
+/* Destination of a report, which gets every record as it is added */
+class ResultSink {
+public:
+  virtual ~ResultSink() = default;
+  virtual void begin(const ResultMetadata &metadata) {}
+  virtual void add(const ResultRecord &record) = 0;
+  virtual void end(const ResultMetadata &metadata) {}
+  /* Nonzero when the sink fails the run, once it has ended */
+  virtual int status() const { return 0; }
+};
+
+/* One line per record, for reading */
+class ConsoleResultSink : public ResultSink {
+public:
+  void add(const ResultRecord &record) override;
+};
+
+/* One row per record with the metadata in every row, to stdout or a file */
+class CsvResultSink : public ResultSink {
+public:
+  CsvResultSink(const std::string &file_name);
+  void begin(const ResultMetadata &metadata) override;
+  void add(const ResultRecord &record) override;
+
+private:
+  std::ofstream file;
+  std::ostream *out;
+  ResultMetadata metadata;
+};
+
+/* One document with the metadata and all records, written at the end */
+class JsonResultSink : public ResultSink {
+public:
+  JsonResultSink(const std::string &file_name);
+  void add(const ResultRecord &record) override;
+  void end(const ResultMetadata &metadata) override;
+
+private:
+  std::string file_name;
+  std::vector<ResultRecord> records;
+};
+
+/*
+ * Results of a tool, sent to any number of sinks. Tools fill the metadata
+ * once, add records as they are measured and call finish before exiting.
+ */
+class ResultReport {
+public:
+  ResultReport(const std::string &tool);
+  ~ResultReport();
+
+  /* Comma separated console, csv, csv:<file>, json:<file>, gate:<dir> or
+   * baseline:<dir>, see RegressionGateSink */
+  bool add_sinks(const std::string &sinks_list);
+  void add_sink(std::unique_ptr<ResultSink> sink);
+  bool enabled() const { return !sinks.empty(); }
+
+  /* Driver version, names, UUIDs and clocks of the devices */
+  void read_metadata(ze_driver_handle_t driver,
+                     const std::vector<ze_device_handle_t> &devices);
+  void read_metadata(const std::vector<ze_device_handle_t> &devices);
+
+  void add(const ResultRecord &record);
+  /* Nonzero when a sink fails the run, such as on a regression */
+  int finish();
+
+  ResultMetadata metadata;
+
+private:
+  std::vector<std::unique_ptr<ResultSink>> sinks;
+  bool begun = false;
+  bool finished = false;
+  int status = 0;
+};
+
+#endif /* _RESULTS_HPP_ */
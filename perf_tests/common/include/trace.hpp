@@ -0,0 +1,102 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _TRACE_HPP_
+#define _TRACE_HPP_
+
+#include "clock_correlation.hpp"
+
+#include <level_zero/ze_api.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Timeline of a run in the Chrome trace event format, which chrome://tracing
+ * and Perfetto open. Tracing is enabled by naming the output file in the
+ * ZE_PERF_TRACE_FILE environment variable, and the file is written when the
+ * tool exits. Host spans, such as appends, submissions and synchronizations,
+ * are timed on the host thread that makes them. Device spans come from
+ * kernel timestamps, which are mapped to host time by a ClockCorrelation of
+ * the device, so both show on one time axis. Every span costs a lock and a
+ * clock read, so traced runs are for finding gaps and overlap rather than
+ * for the numbers they report.
+ */
+class Trace {
+public:
+  static Trace &instance();
+  ~Trace();
+
+  bool enabled() const { return !file_name.empty(); }
+  /* Host time of the trace, also for spans timed by the caller */
+  uint64_t host_now_ns() const;
+
+  void host_span(const std::string &name, const char *category,
+                 uint64_t begin_ns, uint64_t end_ns);
+  /* The global begin and end of a signaled event's kernel timestamp */
+  void device_span(ze_device_handle_t device, const std::string &name,
+                   const ze_kernel_timestamp_result_t &timestamp);
+  void write();
+
+private:
+  struct Event {
+    std::string name;
+    const char *category;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+  };
+  struct DeviceClock {
+    uint32_t pid;
+    std::unique_ptr<ClockCorrelation> correlation;
+    /* from the host clock of the driver to the host clock of the trace */
+    long double offset_ns;
+    uint64_t sampled_ns;
+  };
+
+  Trace();
+  uint32_t thread_tid();
+  DeviceClock &device_clock(ze_device_handle_t device);
+
+  std::string file_name;
+  std::chrono::steady_clock::time_point origin;
+  std::mutex mutex;
+  std::vector<Event> events;
+  std::map<std::thread::id, uint32_t> thread_tids;
+  std::map<ze_device_handle_t, DeviceClock> device_clocks;
+  bool written = false;
+};
+
+/* Host span over the lifetime of the object, free when not tracing */
+class TraceSpan {
+public:
+  TraceSpan(const char *name, const char *category)
+      : name(name), category(category),
+        begin_ns(Trace::instance().enabled() ? Trace::instance().host_now_ns()
+                                             : 0) {}
+  ~TraceSpan() {
+    Trace &trace = Trace::instance();
+    if (trace.enabled()) {
+      trace.host_span(name, category, begin_ns, trace.host_now_ns());
+    }
+  }
+
+private:
+  const char *name;
+  const char *category;
+  uint64_t begin_ns;
+};
+
+#endif /* _TRACE_HPP_ */
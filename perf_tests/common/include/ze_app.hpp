@@ -10,11 +10,14 @@
 #define _ZE_APP_HPP_
 
 #include <level_zero/ze_api.h>
+#include "utils/binary_file.hpp"
 
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <map>
+#include <utility>
 #include <vector>
 
 class ZeApp {
@@ -24,6 +27,9 @@ public:
   ~ZeApp();
 
   bool canAccessPeer(uint32_t device_index_0, uint32_t device_index_1);
+  /* Whether the driver reports the extension, such as
+   * ZE_MUTABLE_COMMAND_LIST_EXP_NAME, with any version */
+  bool driverHasExtension(const char *extension_name);
   void memoryAlloc(size_t size, void **ptr);
   void memoryAlloc(const uint32_t device_index, size_t size, void **ptr);
   void memoryAllocHost(size_t size, void **ptr);
@@ -50,9 +56,30 @@ public:
   void commandListCreate(uint32_t device_index,
                          uint32_t command_queue_group_ordinal,
                          ze_command_list_handle_t *phCommandList);
+  void commandListCreateImmediate(ze_command_queue_mode_t mode,
+                                  ze_command_list_handle_t *phCommandList);
+  /* Immediate list on any engine: flags such as
+   * ZE_COMMAND_QUEUE_FLAG_IN_ORDER are passed to the implicit queue */
+  void commandListCreateImmediate(uint32_t device_index,
+                                  uint32_t command_queue_group_ordinal,
+                                  uint32_t command_queue_index,
+                                  ze_command_queue_mode_t mode,
+                                  ze_command_list_handle_t *phCommandList,
+                                  ze_command_queue_flags_t flags = 0);
+  /* Waits for the work appended to an immediate list: on completion_event,
+   * which is then reset on the host, or without one on the whole list */
+  void commandListHostSynchronize(ze_command_list_handle_t command_list,
+                                  ze_event_handle_t completion_event);
   void commandListDestroy(ze_command_list_handle_t phCommandList);
   void commandListClose(ze_command_list_handle_t phCommandList);
   void commandListReset(ze_command_list_handle_t phCommandList);
+  /* Command lists kept across measurements: a released list is reset and
+   * handed out again by the next acquire of the same device and queue
+   * group, instead of being destroyed and created */
+  ze_command_list_handle_t
+  commandListAcquire(uint32_t device_index,
+                     uint32_t command_queue_group_ordinal);
+  void commandListRelease(ze_command_list_handle_t command_list);
   void getIpcHandle(void *ptr, ze_ipc_mem_handle_t *pIpcHandle);
   void closeIpcHandle(void *ipc_ptr);
   void commandListAppendImageCopyFromMemory(
@@ -63,6 +90,11 @@ public:
       uint8_t *srcBuffer, ze_image_region_t *Region, ze_event_handle_t hEvent);
   void commandListAppendMemoryCopy(ze_command_list_handle_t command_list,
                                    void *dstptr, void *srcptr, size_t size);
+  void commandListAppendMemoryCopy(ze_command_list_handle_t command_list,
+                                   void *dstptr, const void *srcptr,
+                                   size_t size, ze_event_handle_t hSignalEvent,
+                                   uint32_t numWaitEvents,
+                                   ze_event_handle_t *phWaitEvents);
   void commandListAppendBarrier(ze_command_list_handle_t command_list);
 
   void commandListAppendImageCopyToMemory(ze_command_list_handle_t command_list,
@@ -109,9 +141,18 @@ public:
   void create_event(ze_event_pool_handle_t event_pool, ze_event_handle_t &event,
                     uint32_t index);
   void destroy_event(ze_event_handle_t event);
+  /* Host visible events kept across measurements, in pools that only
+   * grow: acquired events are not signaled, released ones are reset on
+   * the host and handed out again */
+  void acquire_events(uint32_t device_index, uint32_t count,
+                      ze_event_scope_flags_t signal,
+                      ze_event_scope_flags_t wait,
+                      std::vector<ze_event_handle_t> &events);
+  void release_events(std::vector<ze_event_handle_t> &events);
 
   void singleDeviceInit(void);
   uint32_t allDevicesInit(void);
+  std::vector<std::pair<uint32_t, int>> subDevicesInit(void);
   void singleDeviceCleanup(void);
   void allDevicesCleanup(void);
 
@@ -119,11 +160,40 @@ public:
   std::vector<ze_device_handle_t> _devices;
 
 private:
+  struct EventSlots {
+    uint32_t device_index;
+    ze_event_scope_flags_t signal;
+    ze_event_scope_flags_t wait;
+    std::vector<ze_event_pool_handle_t> pools;
+    std::vector<ze_event_handle_t> free_events;
+  };
+  struct CommandListSlots {
+    uint32_t device_index;
+    uint32_t command_queue_group_ordinal;
+    std::vector<ze_command_list_handle_t> free_lists;
+  };
+  std::vector<EventSlots> _event_slots;
+  /* slots of every event and list handed out, to release them to */
+  std::map<ze_event_handle_t, size_t> _event_owners;
+  std::vector<CommandListSlots> _command_list_slots;
+  std::map<ze_command_list_handle_t, size_t> _command_list_owners;
+
+  void destroyPooledObjects(void);
+
   std::vector<ze_module_handle_t> _modules;
   std::string _module_path;
-  std::vector<uint8_t> _binary_file;
-
-  std::vector<uint8_t> load_binary_file(const std::string &file_path);
+  level_zero_tests::BinaryFile _binary_file;
+  ze_driver_handle_t _driver = nullptr;
+
+  level_zero_tests::BinaryFile load_binary_file(const std::string &file_path);
+  std::string module_cache_path(ze_device_handle_t device);
+  bool moduleCreateNative(ze_device_handle_t device,
+                          ze_module_handle_t *module);
+  bool moduleCreateFromCache(ze_device_handle_t device,
+                             const std::string &cache_path,
+                             ze_module_handle_t *module);
+  void moduleStoreInCache(ze_module_handle_t module,
+                          const std::string &cache_path);
 
   void imageCreate(ze_device_handle_t device, const ze_image_desc_t *imageDesc,
                    ze_image_handle_t *image);
@@ -0,0 +1,100 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "clock_correlation.hpp"
+
+#include "common.hpp"
+
+#include <thread>
+
+ClockCorrelation::ClockCorrelation(ze_device_handle_t device, size_t window)
+    : device(device), window(window < 2 ? 2 : window) {
+  ze_device_properties_t device_properties = {
+      ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeDeviceGetProperties(device, &device_properties));
+  tick_ns = device_properties.timerResolution;
+  global_bits = device_properties.timestampValidBits;
+  kernel_bits = device_properties.kernelTimestampValidBits;
+}
+
+ClockSample ClockCorrelation::sample() {
+  ClockSample reading;
+  SUCCESS_OR_TERMINATE(zeDeviceGetGlobalTimestamps(
+      device, &reading.host_ns, &reading.device_ticks));
+
+  if (window_samples.empty()) {
+    latest_device_ns = 0;
+  } else {
+    latest_device_ns +=
+        elapsed_ticks(latest.device_ticks, reading.device_ticks, global_bits) *
+        tick_ns;
+  }
+  latest = reading;
+
+  window_samples.push_back(
+      {static_cast<long double>(reading.host_ns), latest_device_ns});
+  if (window_samples.size() > window) {
+    window_samples.pop_front();
+  }
+  fit();
+  return reading;
+}
+
+void ClockCorrelation::calibrate(uint32_t count,
+                                 std::chrono::microseconds interval) {
+  for (uint32_t i = 0; i < count; i++) {
+    if (i) {
+      std::this_thread::sleep_for(interval);
+    }
+    sample();
+  }
+}
+
+/*
+ * Least squares line through the window, relative to its first sample so
+ * that the products keep their precision. With a single sample the
+ * clocks are taken to run at the same rate.
+ */
+void ClockCorrelation::fit() {
+  const FittedSample &origin = window_samples.front();
+  const long double n = window_samples.size();
+  long double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+  for (auto &fitted : window_samples) {
+    const long double x = fitted.device_ns - origin.device_ns;
+    const long double y = fitted.host_ns - origin.host_ns;
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+  }
+
+  const long double denominator = n * sum_xx - sum_x * sum_x;
+  slope = denominator > 0 ? (n * sum_xy - sum_x * sum_y) / denominator : 1;
+  const long double relative_intercept = (sum_y - slope * sum_x) / n;
+  intercept = origin.host_ns + relative_intercept - slope * origin.device_ns;
+}
+
+/* Unwrapped around the latest sample, up to half the counter range on
+ * either side of it */
+long double ClockCorrelation::to_host_ns(uint64_t ticks,
+                                         uint32_t valid_bits) const {
+  const long double delta_ticks = static_cast<long double>(
+      signed_elapsed_ticks(latest.device_ticks, ticks, valid_bits));
+  const long double device_ns = latest_device_ns + delta_ticks * tick_ns;
+  return intercept + slope * device_ns;
+}
+
+long double ClockCorrelation::device_to_host_ns(uint64_t device_ticks) const {
+  return to_host_ns(device_ticks, global_bits);
+}
+
+long double ClockCorrelation::kernel_to_host_ns(uint64_t kernel_ticks) const {
+  return to_host_ns(kernel_ticks, kernel_bits);
+}
+
+long double ClockCorrelation::drift_ppm() const { return (slope - 1) * 1e6; }
@@ -0,0 +1,270 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "host_placement.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <level_zero/zes_api.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool HostPlacement::parse_option(int argc, char **argv, int &i) {
+  const bool has_value = (i + 1) < argc;
+  if (strcmp(argv[i], "--cpus") == 0 && has_value) {
+    requested_cpus = parse_cpu_list(argv[++i]);
+  } else if (strcmp(argv[i], "--numa-local") == 0) {
+    numa_local = true;
+  } else if (strcmp(argv[i], "--rt-priority") == 0 && has_value) {
+    rt_priority = atoi(argv[++i]);
+  } else if (strcmp(argv[i], "--host-numa-node") == 0 && has_value) {
+    i++;
+    host_node_local = (strcmp(argv[i], "local") == 0);
+    host_node = host_node_local ? -1 : atoi(argv[i]);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+const char *HostPlacement::usage() {
+  return "\n  --cpus list              bind the host threads to the CPUs of "
+         "list,"
+         "\n                           such as 0-3,8 (default: not bound)"
+         "\n  --numa-local             bind the host threads to the CPUs "
+         "local to"
+         "\n                           the device"
+         "\n  --rt-priority n          run the host threads with SCHED_FIFO "
+         "priority"
+         "\n                           n, which needs CAP_SYS_NICE"
+         "\n  --host-numa-node n       allocate host buffers on NUMA node n, "
+         "or on"
+         "\n                           the node of the device with local";
+}
+
+bool HostPlacement::needs_sysman(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--numa-local") == 0 ||
+        (strcmp(argv[i], "--host-numa-node") == 0 && (i + 1) < argc &&
+         strcmp(argv[i + 1], "local") == 0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool HostPlacement::enabled() const {
+  return !requested_cpus.empty() || numa_local || rt_priority ||
+         host_node_local || host_node >= 0;
+}
+
+std::vector<int> HostPlacement::parse_cpu_list(const std::string &list) {
+  std::vector<int> cpus;
+  size_t start = 0;
+  while (start < list.length()) {
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) {
+      end = list.length();
+    }
+    const std::string range = list.substr(start, end - start);
+    const size_t dash = range.find('-');
+    const int first = atoi(range.c_str());
+    const int last = (dash == std::string::npos)
+                         ? first
+                         : atoi(range.substr(dash + 1).c_str());
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+    start = end + 1;
+  }
+  return cpus;
+}
+
+std::string HostPlacement::cpu_list_string(const std::vector<int> &cpus) {
+  std::stringstream list;
+  size_t i = 0;
+  while (i < cpus.size()) {
+    size_t last = i;
+    while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1) {
+      last++;
+    }
+    list << (i ? "," : "") << cpus[i];
+    if (last > i) {
+      list << "-" << cpus[last];
+    }
+    i = last + 1;
+  }
+  return list.str();
+}
+
+#ifdef __linux__
+
+static void bind_thread(const std::vector<int> &cpus) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+}
+
+//---------------------------------------------------------------------
+// Looks up the PCI location of the device through sysman and the NUMA
+// node and local CPUs of that PCI device from sysfs.
+//---------------------------------------------------------------------
+void HostPlacement::device_locality(ze_device_handle_t device, int &numa_node,
+                                    std::vector<int> &cpus) {
+  numa_node = -1;
+  cpus.clear();
+
+  zes_pci_properties_t pci_properties = {ZES_STRUCTURE_TYPE_PCI_PROPERTIES,
+                                         nullptr};
+  if (zesDevicePciGetProperties(reinterpret_cast<zes_device_handle_t>(device),
+                                &pci_properties)) {
+    return;
+  }
+
+  char bdf[32];
+  snprintf(bdf, sizeof(bdf), "%04x:%02x:%02x.%x",
+           pci_properties.address.domain, pci_properties.address.bus,
+           pci_properties.address.device, pci_properties.address.function);
+  const std::string sysfs_path = std::string("/sys/bus/pci/devices/") + bdf;
+
+  std::ifstream numa_node_file(sysfs_path + "/numa_node");
+  numa_node_file >> numa_node;
+
+  std::ifstream cpulist_file(sysfs_path + "/local_cpulist");
+  std::string cpulist;
+  cpulist_file >> cpulist;
+  cpus = parse_cpu_list(cpulist);
+}
+
+void HostPlacement::apply(ze_device_handle_t device) {
+  int device_node = -1;
+  std::vector<int> device_cpus;
+  if (numa_local || host_node_local) {
+    if (device == nullptr) {
+      warnings.push_back("no device to place the host threads near");
+    } else {
+      device_locality(device, device_node, device_cpus);
+      if (device_cpus.empty()) {
+        warnings.push_back("device locality unknown, is ZES_ENABLE_SYSMAN=1 "
+                           "set?");
+      }
+    }
+  }
+
+  std::vector<int> cpus = requested_cpus;
+  if (numa_local && !device_cpus.empty()) {
+    cpus = device_cpus;
+  }
+  if (!cpus.empty()) {
+    bind_thread(cpus);
+  }
+
+  if (rt_priority) {
+    sched_param param = {};
+    param.sched_priority = rt_priority;
+    const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error) {
+      warnings.push_back(std::string("SCHED_FIFO not set: ") +
+                         strerror(error));
+    }
+  }
+
+  if (host_node_local) {
+    host_node = device_node;
+  }
+  host_node_cpus.clear();
+  if (host_node >= 0) {
+    std::ifstream cpulist_file("/sys/devices/system/node/node" +
+                               std::to_string(host_node) + "/cpulist");
+    std::string cpulist;
+    cpulist_file >> cpulist;
+    host_node_cpus = parse_cpu_list(cpulist);
+    if (host_node_cpus.empty()) {
+      warnings.push_back("NUMA node " + std::to_string(host_node) +
+                         " has no CPUs, host buffers are not placed");
+    }
+  }
+}
+
+void HostPlacement::allocate_on_node(
+    const std::function<void()> &allocate) const {
+  if (host_node_cpus.empty()) {
+    allocate();
+    return;
+  }
+  std::thread allocator([&]() {
+    bind_thread(host_node_cpus);
+    allocate();
+  });
+  allocator.join();
+}
+
+std::string HostPlacement::describe() const {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  std::vector<int> cpus;
+  if (!pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set)) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &cpu_set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+  int policy = SCHED_OTHER;
+  sched_param param = {};
+  pthread_getschedparam(pthread_self(), &policy, &param);
+
+  std::stringstream description;
+  description << "Host placement: CPUs " << cpu_list_string(cpus);
+  if (policy == SCHED_FIFO) {
+    description << ", SCHED_FIFO priority " << param.sched_priority;
+  } else {
+    description << ", default scheduling";
+  }
+  if (!host_node_cpus.empty()) {
+    description << ", host buffers on NUMA node " << host_node;
+  }
+  for (auto &warning : warnings) {
+    description << "\n  warning: " << warning;
+  }
+  return description.str();
+}
+
+#else
+
+void HostPlacement::device_locality(ze_device_handle_t device, int &numa_node,
+                                    std::vector<int> &cpus) {
+  numa_node = -1;
+  cpus.clear();
+}
+
+void HostPlacement::apply(ze_device_handle_t device) {}
+
+void HostPlacement::allocate_on_node(
+    const std::function<void()> &allocate) const {
+  allocate();
+}
+
+std::string HostPlacement::describe() const {
+  return enabled() ? "Host placement: not supported on this OS, not applied"
+                   : "Host placement: default";
+}
+
+#endif
@@ -0,0 +1,267 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "metric_profiler.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+/* Interval between two reads of the streamer by the drain thread */
+static const std::chrono::milliseconds drain_interval(10);
+
+/* The group stays activated until the tool destroys its context */
+MetricProfiler::~MetricProfiler() {
+  running = false;
+  if (drainer.joinable()) {
+    drainer.join();
+  }
+}
+
+bool MetricProfiler::parse_option(int argc, char **argv, int &i) {
+  const bool has_value = (i + 1) < argc;
+  if (strcmp(argv[i], "--metrics") == 0 && has_value) {
+    group_name = argv[++i];
+  } else if (strcmp(argv[i], "--metrics-period") == 0 && has_value) {
+    sampling_period_ns = static_cast<uint32_t>(atol(argv[++i]));
+  } else if (strcmp(argv[i], "--metrics-filter") == 0 && has_value) {
+    filters.clear();
+    std::stringstream list(argv[++i]);
+    std::string filter;
+    while (std::getline(list, filter, ',')) {
+      if (!filter.empty()) {
+        filters.push_back(filter);
+      }
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+const char *MetricProfiler::usage() {
+  return "\n  --metrics group          sample the time based metric group, "
+         "such as"
+         "\n                           ComputeBasic, in streamer mode and "
+         "report its"
+         "\n                           counters with every result"
+         "\n  --metrics-period ns      sampling period of the streamer "
+         "(default: 100000)"
+         "\n  --metrics-filter list    comma separated parts of the metric "
+         "names"
+         "\n                           reported (default: EuActive,EuStall,"
+         "XveActive,"
+         "\n                           XveStall,L3,GpuMemory)";
+}
+
+bool MetricProfiler::needs_metrics(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--metrics") == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MetricProfiler::init(ze_context_handle_t context,
+                          ze_device_handle_t device) {
+  this->context = context;
+  this->device = device;
+
+  uint32_t count = 0;
+  if (zetMetricGroupGet(device, &count, nullptr) != ZE_RESULT_SUCCESS ||
+      count == 0) {
+    return false;
+  }
+  std::vector<zet_metric_group_handle_t> groups(count);
+  if (zetMetricGroupGet(device, &count, groups.data()) != ZE_RESULT_SUCCESS) {
+    return false;
+  }
+  for (auto candidate : groups) {
+    zet_metric_group_properties_t properties = {
+        ZET_STRUCTURE_TYPE_METRIC_GROUP_PROPERTIES, nullptr};
+    if (zetMetricGroupGetProperties(candidate, &properties) ==
+            ZE_RESULT_SUCCESS &&
+        group_name == properties.name &&
+        (properties.samplingType &
+         ZET_METRIC_GROUP_SAMPLING_TYPE_FLAG_TIME_BASED)) {
+      group = candidate;
+      metric_count = properties.metricCount;
+      break;
+    }
+  }
+  if (!group) {
+    return false;
+  }
+
+  std::vector<zet_metric_handle_t> handles(metric_count);
+  if (zetMetricGet(group, &metric_count, handles.data()) !=
+      ZE_RESULT_SUCCESS) {
+    group = nullptr;
+    return false;
+  }
+  for (uint32_t i = 0; i < metric_count; i++) {
+    zet_metric_properties_t properties = {ZET_STRUCTURE_TYPE_METRIC_PROPERTIES,
+                                          nullptr};
+    if (zetMetricGetProperties(handles[i], &properties) != ZE_RESULT_SUCCESS ||
+        properties.metricType == ZET_METRIC_TYPE_TIMESTAMP) {
+      continue;
+    }
+    const std::string name = properties.name;
+    for (auto &filter : filters) {
+      if (name.find(filter) != std::string::npos) {
+        metrics.push_back(
+            {i, name, properties.resultUnits, properties.metricType});
+        break;
+      }
+    }
+  }
+
+  if (zetContextActivateMetricGroups(context, device, 1, &group) !=
+      ZE_RESULT_SUCCESS) {
+    group = nullptr;
+    return false;
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------
+// Appends the reports the streamer has collected since the last read.
+//---------------------------------------------------------------------
+void MetricProfiler::read_reports() {
+  size_t size = 0;
+  if (zetMetricStreamerReadData(streamer, UINT32_MAX, &size, nullptr) !=
+          ZE_RESULT_SUCCESS ||
+      size == 0) {
+    return;
+  }
+  std::vector<uint8_t> data(size);
+  const ze_result_t result =
+      zetMetricStreamerReadData(streamer, UINT32_MAX, &size, data.data());
+  if (result == ZE_RESULT_WARNING_DROPPED_DATA) {
+    dropped_reads++;
+  } else if (result != ZE_RESULT_SUCCESS) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(raw_mutex);
+  raw_data.insert(raw_data.end(), data.begin(), data.begin() + size);
+}
+
+void MetricProfiler::drain() {
+  while (running) {
+    std::this_thread::sleep_for(drain_interval);
+    read_reports();
+  }
+}
+
+//---------------------------------------------------------------------
+// Starts a window: opens the streamer and starts the drain thread.
+//---------------------------------------------------------------------
+void MetricProfiler::begin() {
+  if (!group || running) {
+    return;
+  }
+  zet_metric_streamer_desc_t desc = {ZET_STRUCTURE_TYPE_METRIC_STREAMER_DESC,
+                                     nullptr, UINT32_MAX, sampling_period_ns};
+  if (zetMetricStreamerOpen(context, device, group, &desc, nullptr,
+                            &streamer) != ZE_RESULT_SUCCESS) {
+    streamer = nullptr;
+    return;
+  }
+  raw_data.clear();
+  dropped_reads = 0;
+  window_begin = std::chrono::steady_clock::now();
+  running = true;
+  drainer = std::thread(&MetricProfiler::drain, this);
+}
+
+long double MetricProfiler::typed_value(const zet_typed_value_t &value) {
+  switch (value.type) {
+  case ZET_VALUE_TYPE_UINT32:
+    return value.value.ui32;
+  case ZET_VALUE_TYPE_UINT64:
+    return value.value.ui64;
+  case ZET_VALUE_TYPE_FLOAT32:
+    return value.value.fp32;
+  case ZET_VALUE_TYPE_FLOAT64:
+    return value.value.fp64;
+  case ZET_VALUE_TYPE_BOOL8:
+    return value.value.b8;
+  default:
+    return 0;
+  }
+}
+
+//---------------------------------------------------------------------
+// Ends the window started by begin() and calculates one value per metric
+// reported from the reports drained over the window. A metric whose
+// reads dropped data is still reported, with a warning.
+//---------------------------------------------------------------------
+bool MetricProfiler::end(std::vector<Counter> &counters) {
+  counters.clear();
+  if (!running) {
+    return false;
+  }
+  running = false;
+  drainer.join();
+  read_reports();
+  const long double window_ns = std::chrono::duration<long double, std::nano>(
+                                    std::chrono::steady_clock::now() -
+                                    window_begin)
+                                    .count();
+  zetMetricStreamerClose(streamer);
+  streamer = nullptr;
+
+  uint32_t value_count = 0;
+  if (raw_data.empty() ||
+      zetMetricGroupCalculateMetricValues(
+          group, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+          raw_data.size(), raw_data.data(), &value_count,
+          nullptr) != ZE_RESULT_SUCCESS ||
+      value_count == 0) {
+    return true;
+  }
+  std::vector<zet_typed_value_t> values(value_count);
+  if (zetMetricGroupCalculateMetricValues(
+          group, ZET_METRIC_GROUP_CALCULATION_TYPE_METRIC_VALUES,
+          raw_data.size(), raw_data.data(), &value_count, values.data()) !=
+      ZE_RESULT_SUCCESS) {
+    return true;
+  }
+  const uint32_t reports = value_count / metric_count;
+  if (dropped_reads) {
+    std::cerr << "Metric streamer dropped data in " << dropped_reads
+              << " reads, raise --metrics-period\n";
+  }
+
+  for (auto &metric : metrics) {
+    long double sum = 0;
+    for (uint32_t report = 0; report < reports; report++) {
+      sum += typed_value(values[report * metric_count + metric.index]);
+    }
+    if (metric.type == ZET_METRIC_TYPE_EVENT) {
+      counters.push_back({metric.name, metric.unit, sum});
+      if (metric.unit == "bytes" && window_ns > 0) {
+        counters.push_back({metric.name, "GB/s", sum / window_ns});
+      }
+    } else if (reports) {
+      counters.push_back({metric.name, metric.unit, sum / reports});
+    }
+  }
+  return true;
+}
+
+std::string MetricProfiler::describe(const std::vector<Counter> &counters) {
+  std::stringstream out;
+  for (size_t i = 0; i < counters.size(); i++) {
+    out << (i ? ", " : "") << counters[i].name << " " << counters[i].value
+        << " " << counters[i].unit;
+  }
+  return out.str();
+}
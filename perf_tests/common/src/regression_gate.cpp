@@ -0,0 +1,267 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "regression_gate.hpp"
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+static const char *baseline_header = "ze_perf_baseline 1";
+
+/* Parameters of a run rather than of the measurement */
+static bool is_run_parameter(const std::string &name) {
+  return name == "repetition" || name == "iterations" || name == "stddev" ||
+         name == "power_w" || name == "frequency_mhz";
+}
+
+/* Test, metric and measurement parameters, without tabs or newlines */
+static std::string result_key(const ResultRecord &record) {
+  std::string key = record.test + "|" + record.metric;
+  for (auto &parameter : record.parameters) {
+    if (!is_run_parameter(parameter.first)) {
+      key += "|" + parameter.first + "=" + parameter.second;
+    }
+  }
+  std::replace(key.begin(), key.end(), '\t', ' ');
+  std::replace(key.begin(), key.end(), '\n', ' ');
+  return key;
+}
+
+/* Keeps letters, digits, dots and dashes of a file name component */
+static std::string file_name_safe(const std::string &name) {
+  std::string safe;
+  for (auto c : name) {
+    safe += (isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-')
+                ? c
+                : '_';
+  }
+  return safe;
+}
+
+static long double env_or(const char *name, long double value) {
+  const char *env = getenv(name);
+  return env ? strtold(env, nullptr) : value;
+}
+
+RegressionGateSink::RegressionGateSink(const std::string &directory,
+                                       bool update)
+    : directory(directory), update(update) {
+  alpha = env_or("ZE_PERF_GATE_ALPHA", alpha);
+  min_change = env_or("ZE_PERF_GATE_MIN_CHANGE", min_change);
+}
+
+void RegressionGateSink::add(const ResultRecord &record) {
+  /* Exit statuses and other values without a unit are not performance */
+  if (record.unit.empty()) {
+    return;
+  }
+  Samples &samples = current[result_key(record)];
+  samples.unit = record.unit;
+  if (record.samples.empty()) {
+    samples.values.push_back(record.value);
+  } else {
+    samples.values.insert(samples.values.end(), record.samples.begin(),
+                          record.samples.end());
+  }
+}
+
+bool RegressionGateSink::lower_is_better(const std::string &unit) {
+  static const char *time_units[] = {"ns", "nsec", "us",  "usec", "ms",
+                                     "msec", "s",  "sec", "cycles"};
+  for (auto time_unit : time_units) {
+    if (unit == time_unit) {
+      return true;
+    }
+  }
+  return false;
+}
+
+long double
+RegressionGateSink::mann_whitney_greater(const std::vector<long double> &x,
+                                         const std::vector<long double> &y) {
+  std::vector<std::pair<long double, bool>> pooled;
+  for (auto value : x) {
+    pooled.push_back({value, false});
+  }
+  for (auto value : y) {
+    pooled.push_back({value, true});
+  }
+  std::sort(pooled.begin(), pooled.end());
+
+  /* Ranks from 1, ties get the mean rank of their run */
+  const long double n = static_cast<long double>(pooled.size());
+  long double rank_sum_y = 0, tie_term = 0;
+  size_t i = 0;
+  while (i < pooled.size()) {
+    size_t j = i;
+    while (j + 1 < pooled.size() && pooled[j + 1].first == pooled[i].first) {
+      j++;
+    }
+    const long double rank = (i + j) / 2.0L + 1;
+    const long double ties = static_cast<long double>(j - i + 1);
+    tie_term += ties * ties * ties - ties;
+    for (size_t k = i; k <= j; k++) {
+      if (pooled[k].second) {
+        rank_sum_y += rank;
+      }
+    }
+    i = j + 1;
+  }
+
+  const long double nx = static_cast<long double>(x.size());
+  const long double ny = static_cast<long double>(y.size());
+  const long double u_y = rank_sum_y - ny * (ny + 1) / 2;
+  const long double variance =
+      nx * ny / 12 * ((n + 1) - tie_term / (n * (n - 1)));
+  if (variance <= 0) {
+    return 1;
+  }
+  const long double z = (u_y - nx * ny / 2 - 0.5L) / std::sqrt(variance);
+  return 0.5L * std::erfc(z / std::sqrt(2.0L));
+}
+
+std::string
+RegressionGateSink::baseline_file(const ResultMetadata &metadata) const {
+  std::vector<std::string> names;
+  for (auto &device : metadata.devices) {
+    if (std::find(names.begin(), names.end(), device.name) == names.end()) {
+      names.push_back(device.name);
+    }
+  }
+  std::string sku;
+  for (auto &name : names) {
+    sku += (sku.empty() ? "" : "+") + name;
+  }
+  return directory + "/" +
+         file_name_safe(metadata.tool + "-" +
+                        (sku.empty() ? "unknown" : sku) + "-" +
+                        (metadata.driver_version.empty()
+                             ? "unknown"
+                             : metadata.driver_version)) +
+         ".baseline";
+}
+
+bool RegressionGateSink::read_baseline(
+    const std::string &file_name,
+    std::map<std::string, Samples> &baseline) {
+  std::ifstream file(file_name);
+  std::string line;
+  if (!std::getline(file, line)) {
+    return false;
+  }
+  if (line != baseline_header) {
+    /* Not overwritten either */
+    std::cerr << "ERROR : " << file_name << " is not a baseline" << std::endl;
+    failed = true;
+    return true;
+  }
+  /* key <tab> unit <tab> samples separated by spaces */
+  while (std::getline(file, line)) {
+    const size_t key_end = line.find('\t');
+    const size_t unit_end = line.find('\t', key_end + 1);
+    if (key_end == std::string::npos || unit_end == std::string::npos) {
+      continue;
+    }
+    Samples &samples = baseline[line.substr(0, key_end)];
+    samples.unit = line.substr(key_end + 1, unit_end - key_end - 1);
+    std::stringstream values(line.substr(unit_end + 1));
+    long double value;
+    while (values >> value) {
+      samples.values.push_back(value);
+    }
+  }
+  return true;
+}
+
+bool RegressionGateSink::write_baseline(const std::string &file_name) const {
+  std::ofstream file(file_name);
+  if (!file.good()) {
+    std::cerr << "ERROR : cannot open " << file_name << std::endl;
+    return false;
+  }
+  file << baseline_header << "\n" << std::setprecision(10);
+  for (auto &entry : current) {
+    file << entry.first << "\t" << entry.second.unit << "\t";
+    for (size_t i = 0; i < entry.second.values.size(); i++) {
+      file << (i ? " " : "") << entry.second.values[i];
+    }
+    file << "\n";
+  }
+  return true;
+}
+
+void RegressionGateSink::compare(
+    const std::map<std::string, Samples> &baseline) {
+  uint32_t compared = 0, too_few = 0, added = 0;
+  for (auto &entry : current) {
+    auto base = baseline.find(entry.first);
+    if (base == baseline.end() || base->second.unit != entry.second.unit) {
+      added++;
+      continue;
+    }
+    const std::vector<long double> &before = base->second.values;
+    const std::vector<long double> &after = entry.second.values;
+    if (before.size() < min_samples || after.size() < min_samples) {
+      too_few++;
+      continue;
+    }
+    compared++;
+
+    const bool lower_better = lower_is_better(entry.second.unit);
+    const long double p = lower_better ? mann_whitney_greater(before, after)
+                                       : mann_whitney_greater(after, before);
+    const long double before_median = sample_median(before);
+    const long double change =
+        before_median ? (sample_median(after) - before_median) / before_median : 0;
+    const bool worse =
+        lower_better ? change > min_change : change < -min_change;
+    if (p < alpha && worse) {
+      regressions++;
+      std::cout << "REGRESSION : " << entry.first << ": median "
+                << before_median << " -> " << sample_median(after) << " "
+                << entry.second.unit << " (" << std::showpos << std::fixed
+                << std::setprecision(2) << 100 * change << std::noshowpos
+                << std::defaultfloat << std::setprecision(6) << " %), p "
+                << p << std::endl;
+    }
+  }
+  std::cout << "Regression gate: " << compared << " results compared, "
+            << regressions << " regressed (alpha " << alpha << ", change > "
+            << 100 * min_change << " %)";
+  if (too_few) {
+    std::cout << ", " << too_few << " with fewer than " << min_samples
+              << " samples not compared";
+  }
+  if (added) {
+    std::cout << ", " << added << " not in the baseline";
+  }
+  std::cout << std::endl;
+}
+
+void RegressionGateSink::end(const ResultMetadata &metadata) {
+  const std::string file_name = baseline_file(metadata);
+  std::map<std::string, Samples> baseline;
+  if (!update && read_baseline(file_name, baseline)) {
+    if (!failed) {
+      compare(baseline);
+    }
+    return;
+  }
+  if (write_baseline(file_name)) {
+    std::cout << (update ? "Baseline written to " : "No baseline, written to ")
+              << file_name << std::endl;
+  }
+}
@@ -0,0 +1,302 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "results.hpp"
+
+#include "common.hpp"
+#include "regression_gate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+ResultStats ResultStats::from_samples(std::vector<long double> samples) {
+  ResultStats stats;
+  if (samples.empty()) {
+    return stats;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  stats.count = samples.size();
+  stats.min = samples.front();
+  stats.max = samples.back();
+  stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0L) /
+               samples.size();
+  stats.median = sorted_percentile(samples, 50);
+  stats.p99 = sorted_percentile(samples, 99);
+  long double sum_squares = 0;
+  for (auto sample : samples) {
+    sum_squares += (sample - stats.mean) * (sample - stats.mean);
+  }
+  stats.stddev = std::sqrt(sum_squares / samples.size());
+  return stats;
+}
+
+static std::string json_quoted(const std::string &value) {
+  std::string quoted = "\"";
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+/* Values that are not finite have no JSON spelling */
+static std::string json_number(long double value) {
+  if (!std::isfinite(value)) {
+    return "null";
+  }
+  std::stringstream number;
+  number << std::setprecision(10) << value;
+  return number.str();
+}
+
+static std::string csv_quoted(const std::string &value) {
+  if (value.find_first_of(",\"\n") == std::string::npos) {
+    return value;
+  }
+  std::string quoted = "\"";
+  for (auto c : value) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+static std::string parameters_string(const ResultRecord &record,
+                                     const char *separator) {
+  std::string parameters;
+  for (auto &parameter : record.parameters) {
+    if (!parameters.empty()) {
+      parameters += separator;
+    }
+    parameters += parameter.first + "=" + parameter.second;
+  }
+  return parameters;
+}
+
+void ConsoleResultSink::add(const ResultRecord &record) {
+  std::cout << std::left << std::setw(24) << record.test << std::setw(20)
+            << record.metric << std::right << std::fixed
+            << std::setprecision(3) << std::setw(14) << record.value << " "
+            << std::left << std::setw(8) << record.unit;
+  if (record.stats.count) {
+    std::cout << " median " << record.stats.median << " stddev "
+              << record.stats.stddev << " p99 " << record.stats.p99;
+  }
+  std::cout << " " << parameters_string(record, " ") << std::right
+            << std::defaultfloat << std::endl;
+}
+
+CsvResultSink::CsvResultSink(const std::string &file_name) : out(&std::cout) {
+  if (!file_name.empty()) {
+    file.open(file_name);
+    if (!file.good()) {
+      std::cerr << "ERROR : cannot open " << file_name << std::endl;
+      std::terminate();
+    }
+    out = &file;
+  }
+}
+
+void CsvResultSink::begin(const ResultMetadata &metadata) {
+  this->metadata = metadata;
+  *out << "tool,driver_version,test,metric,unit,value,count,min,max,mean,"
+          "median,stddev,p99,parameters"
+       << std::endl;
+}
+
+void CsvResultSink::add(const ResultRecord &record) {
+  *out << csv_quoted(metadata.tool) << ","
+       << csv_quoted(metadata.driver_version) << "," << csv_quoted(record.test)
+       << "," << csv_quoted(record.metric) << "," << csv_quoted(record.unit)
+       << "," << json_number(record.value) << "," << record.stats.count;
+  if (record.stats.count) {
+    *out << "," << json_number(record.stats.min) << ","
+         << json_number(record.stats.max) << ","
+         << json_number(record.stats.mean) << ","
+         << json_number(record.stats.median) << ","
+         << json_number(record.stats.stddev) << ","
+         << json_number(record.stats.p99);
+  } else {
+    *out << ",,,,,,";
+  }
+  *out << "," << csv_quoted(parameters_string(record, ";")) << std::endl;
+}
+
+JsonResultSink::JsonResultSink(const std::string &file_name)
+    : file_name(file_name) {}
+
+void JsonResultSink::add(const ResultRecord &record) {
+  records.push_back(record);
+}
+
+void JsonResultSink::end(const ResultMetadata &metadata) {
+  std::ofstream file(file_name);
+  if (!file.good()) {
+    std::cerr << "ERROR : cannot open " << file_name << std::endl;
+    return;
+  }
+
+  file << "{\n  \"schema_version\": 1,\n  \"tool\": "
+       << json_quoted(metadata.tool)
+       << ",\n  \"driver_version\": " << json_quoted(metadata.driver_version)
+       << ",\n  \"devices\": [";
+  for (size_t i = 0; i < metadata.devices.size(); i++) {
+    auto &device = metadata.devices[i];
+    file << (i ? ",\n" : "\n") << "    {\"index\": " << i
+         << ", \"name\": " << json_quoted(device.name)
+         << ", \"uuid\": " << json_quoted(device.uuid)
+         << ", \"core_clock_mhz\": " << device.core_clock_mhz << "}";
+  }
+  file << "\n  ],\n  \"results\": [";
+  for (size_t i = 0; i < records.size(); i++) {
+    auto &record = records[i];
+    file << (i ? ",\n" : "\n") << "    {\"test\": " << json_quoted(record.test)
+         << ", \"metric\": " << json_quoted(record.metric)
+         << ", \"unit\": " << json_quoted(record.unit)
+         << ", \"value\": " << json_number(record.value)
+         << ", \"parameters\": {";
+    for (size_t p = 0; p < record.parameters.size(); p++) {
+      file << (p ? ", " : "") << json_quoted(record.parameters[p].first)
+           << ": " << json_quoted(record.parameters[p].second);
+    }
+    file << "}";
+    if (record.stats.count) {
+      file << ", \"stats\": {\"count\": " << record.stats.count
+           << ", \"min\": " << json_number(record.stats.min)
+           << ", \"max\": " << json_number(record.stats.max)
+           << ", \"mean\": " << json_number(record.stats.mean)
+           << ", \"median\": " << json_number(record.stats.median)
+           << ", \"stddev\": " << json_number(record.stats.stddev)
+           << ", \"p99\": " << json_number(record.stats.p99) << "}";
+    }
+    file << "}";
+  }
+  file << "\n  ]\n}\n";
+}
+
+ResultReport::ResultReport(const std::string &tool) { metadata.tool = tool; }
+
+ResultReport::~ResultReport() { finish(); }
+
+bool ResultReport::add_sinks(const std::string &sinks_list) {
+  size_t start = 0;
+  while (start <= sinks_list.length()) {
+    size_t end = sinks_list.find(',', start);
+    if (end == std::string::npos) {
+      end = sinks_list.length();
+    }
+    const std::string sink = sinks_list.substr(start, end - start);
+    const size_t colon = sink.find(':');
+    const std::string kind = sink.substr(0, colon);
+    const std::string file_name =
+        colon == std::string::npos ? "" : sink.substr(colon + 1);
+
+    if (kind == "console" && file_name.empty()) {
+      add_sink(std::unique_ptr<ResultSink>(new ConsoleResultSink()));
+    } else if (kind == "csv") {
+      add_sink(std::unique_ptr<ResultSink>(new CsvResultSink(file_name)));
+    } else if (kind == "json" && !file_name.empty()) {
+      add_sink(std::unique_ptr<ResultSink>(new JsonResultSink(file_name)));
+    } else if ((kind == "gate" || kind == "baseline") && !file_name.empty()) {
+      add_sink(std::unique_ptr<ResultSink>(
+          new RegressionGateSink(file_name, kind == "baseline")));
+    } else {
+      std::cerr << "ERROR : unknown result sink " << sink
+                << ", expected console, csv, csv:<file>, json:<file>, "
+                   "gate:<dir> or baseline:<dir>"
+                << std::endl;
+      return false;
+    }
+    start = end + 1;
+  }
+  return true;
+}
+
+void ResultReport::add_sink(std::unique_ptr<ResultSink> sink) {
+  sinks.push_back(std::move(sink));
+}
+
+void ResultReport::read_metadata(
+    ze_driver_handle_t driver, const std::vector<ze_device_handle_t> &devices) {
+  ze_driver_properties_t driver_properties = {
+      ZE_STRUCTURE_TYPE_DRIVER_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeDriverGetProperties(driver, &driver_properties));
+  metadata.driver_version = std::to_string(driver_properties.driverVersion);
+
+  metadata.devices.clear();
+  for (auto device : devices) {
+    ze_device_properties_t device_properties = {
+        ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, nullptr};
+    SUCCESS_OR_TERMINATE(zeDeviceGetProperties(device, &device_properties));
+
+    ResultDevice result_device;
+    result_device.name = device_properties.name;
+    std::stringstream uuid;
+    for (int i = ZE_MAX_DEVICE_UUID_SIZE - 1; i >= 0; i--) {
+      uuid << std::hex << std::setw(2) << std::setfill('0')
+           << static_cast<uint32_t>(device_properties.uuid.id[i]);
+    }
+    result_device.uuid = uuid.str();
+    result_device.core_clock_mhz = device_properties.coreClockRate;
+    metadata.devices.push_back(result_device);
+  }
+}
+
+/* The first driver, which is the one ZeApp runs on */
+void ResultReport::read_metadata(
+    const std::vector<ze_device_handle_t> &devices) {
+  uint32_t driver_count = 1;
+  ze_driver_handle_t driver;
+  SUCCESS_OR_TERMINATE(zeDriverGet(&driver_count, &driver));
+  read_metadata(driver, devices);
+}
+
+void ResultReport::add(const ResultRecord &record) {
+  if (!begun) {
+    for (auto &sink : sinks) {
+      sink->begin(metadata);
+    }
+    begun = true;
+  }
+  for (auto &sink : sinks) {
+    sink->add(record);
+  }
+}
+
+int ResultReport::finish() {
+  if (finished) {
+    return status;
+  }
+  if (!begun) {
+    for (auto &sink : sinks) {
+      sink->begin(metadata);
+    }
+    begun = true;
+  }
+  for (auto &sink : sinks) {
+    sink->end(metadata);
+    status |= sink->status();
+  }
+  finished = true;
+  return status;
+}
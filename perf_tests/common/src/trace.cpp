@@ -0,0 +1,167 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "trace.hpp"
+
+#include "common.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+
+/* Device clocks are sampled again after this long, to follow their drift */
+static const uint64_t resample_interval_ns = 100000000;
+
+Trace &Trace::instance() {
+  static Trace trace;
+  return trace;
+}
+
+Trace::Trace() : origin(std::chrono::steady_clock::now()) {
+  const char *trace_file = getenv("ZE_PERF_TRACE_FILE");
+  if (trace_file != nullptr) {
+    file_name = trace_file;
+    events.reserve(1 << 16);
+  }
+}
+
+Trace::~Trace() { write(); }
+
+uint64_t Trace::host_now_ns() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - origin)
+      .count();
+}
+
+/* Host threads are numbered in the order they first trace */
+uint32_t Trace::thread_tid() {
+  auto tid = thread_tids.find(std::this_thread::get_id());
+  if (tid == thread_tids.end()) {
+    const uint32_t next = static_cast<uint32_t>(thread_tids.size());
+    tid = thread_tids.emplace(std::this_thread::get_id(), next).first;
+  }
+  return tid->second;
+}
+
+void Trace::host_span(const std::string &name, const char *category,
+                      uint64_t begin_ns, uint64_t end_ns) {
+  if (!enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  events.push_back({name, category, 0, thread_tid(), begin_ns, end_ns});
+}
+
+/*
+ * Devices are numbered in the order they first trace. The offset between
+ * the host clock of the driver and the one of the trace is taken around
+ * every sample of the device clock.
+ */
+Trace::DeviceClock &Trace::device_clock(ze_device_handle_t device) {
+  auto clock = device_clocks.find(device);
+  if (clock == device_clocks.end()) {
+    DeviceClock new_clock;
+    new_clock.pid = static_cast<uint32_t>(device_clocks.size()) + 1;
+    new_clock.correlation.reset(new ClockCorrelation(device));
+    new_clock.sampled_ns = 0;
+    clock = device_clocks.emplace(device, std::move(new_clock)).first;
+  }
+
+  DeviceClock &device_clock = clock->second;
+  const uint64_t now_ns = host_now_ns();
+  if (!device_clock.correlation->samples() ||
+      now_ns - device_clock.sampled_ns > resample_interval_ns) {
+    const uint64_t before_ns = host_now_ns();
+    const ClockSample sample = device_clock.correlation->sample();
+    const uint64_t after_ns = host_now_ns();
+    device_clock.offset_ns = (before_ns + after_ns) / 2.0L -
+                             static_cast<long double>(sample.host_ns);
+    device_clock.sampled_ns = after_ns;
+  }
+  return device_clock;
+}
+
+void Trace::device_span(ze_device_handle_t device, const std::string &name,
+                        const ze_kernel_timestamp_result_t &timestamp) {
+  if (!enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  DeviceClock &clock = device_clock(device);
+  const long double begin_ns =
+      clock.correlation->kernel_to_host_ns(timestamp.global.kernelStart) +
+      clock.offset_ns;
+  long double end_ns =
+      clock.correlation->kernel_to_host_ns(timestamp.global.kernelEnd) +
+      clock.offset_ns;
+  if (begin_ns < 0) {
+    return;
+  }
+  if (end_ns < begin_ns) {
+    end_ns = begin_ns;
+  }
+  events.push_back({name, "device", clock.pid, 0,
+                    static_cast<uint64_t>(begin_ns),
+                    static_cast<uint64_t>(end_ns)});
+}
+
+static std::string trace_quoted(const std::string &value) {
+  std::string quoted = "\"";
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+/* Timestamps of the format are in microseconds */
+void Trace::write() {
+  if (!enabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (written) {
+    return;
+  }
+  written = true;
+
+  std::ofstream file(file_name);
+  if (!file.good()) {
+    std::cerr << "ERROR : cannot open " << file_name << std::endl;
+    return;
+  }
+
+  file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n"
+       << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, "
+          "\"args\": {\"name\": \"host\"}}";
+  for (auto &clock : device_clocks) {
+    file << ",\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": "
+         << clock.second.pid << ", \"args\": {\"name\": \"device "
+         << clock.second.pid - 1 << "\"}}";
+  }
+  file << std::fixed << std::setprecision(3);
+  for (auto &event : events) {
+    file << ",\n{\"name\": " << trace_quoted(event.name) << ", \"cat\": \""
+         << event.category << "\", \"ph\": \"X\", \"pid\": " << event.pid
+         << ", \"tid\": " << event.tid
+         << ", \"ts\": " << event.begin_ns / 1e3L
+         << ", \"dur\": " << (event.end_ns - event.begin_ns) / 1e3L << "}";
+  }
+  file << "\n]}\n";
+  std::cout << "Trace of " << events.size() << " spans written to "
+            << file_name << std::endl;
+}
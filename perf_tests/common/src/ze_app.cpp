@@ -9,36 +9,28 @@
 #include "ze_app.hpp"
 
 #include "../../common/include/common.hpp"
+#include "trace.hpp"
 
+#include <algorithm>
 #include <assert.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
 
 bool verbose = false;
 
-std::vector<uint8_t> ZeApp::load_binary_file(const std::string &file_path) {
+level_zero_tests::BinaryFile
+ZeApp::load_binary_file(const std::string &file_path) {
   if (verbose)
     std::cout << "File path: " << file_path << std::endl;
-  std::ifstream stream(file_path, std::ios::in | std::ios::binary);
-
-  std::vector<uint8_t> binary_file;
-  if (!stream.good()) {
+  level_zero_tests::BinaryFile binary_file(file_path);
+  if (!binary_file.is_open()) {
     std::cerr << "Failed to load binary file: " << file_path;
-    return binary_file;
+  } else if (verbose) {
+    std::cout << "Binary file length: " << binary_file.size() << std::endl;
   }
 
-  size_t length = 0;
-  stream.seekg(0, stream.end);
-  length = static_cast<size_t>(stream.tellg());
-  stream.seekg(0, stream.beg);
-  if (verbose)
-    std::cout << "Binary file length: " << length << std::endl;
-
-  binary_file.resize(length);
-  stream.read(reinterpret_cast<char *>(binary_file.data()), length);
-  if (verbose)
-    std::cout << "Binary file loaded" << std::endl;
-
-  stream.close();
-
   return binary_file;
 }
 
@@ -58,8 +50,139 @@ ZeApp::ZeApp(std::string module_path) {
   _binary_file = load_binary_file(_module_path);
 }
 
+/*
+ * With ZE_PERF_MODULE_CACHE_DIR set, the native binary built from the
+ * SPIR-V module is kept in that directory, one file per module, device and
+ * driver version, and loaded instead of building the module again.
+ * Returns an empty path when the cache is disabled.
+ */
+std::string ZeApp::module_cache_path(ze_device_handle_t device) {
+  const char *cache_dir = getenv("ZE_PERF_MODULE_CACHE_DIR");
+  if (cache_dir == nullptr || cache_dir[0] == '\0' || _driver == nullptr) {
+    return "";
+  }
+
+  ze_driver_properties_t driver_properties = {
+      ZE_STRUCTURE_TYPE_DRIVER_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeDriverGetProperties(_driver, &driver_properties));
+  ze_device_properties_t device_properties = {
+      ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeDeviceGetProperties(device, &device_properties));
+
+  /* FNV-1a of the SPIR-V, so that a rebuilt module is not matched */
+  uint64_t spirv_hash = 14695981039346656037ULL;
+  for (auto byte : _binary_file) {
+    spirv_hash = (spirv_hash ^ byte) * 1099511628211ULL;
+  }
+
+  std::string module_name = _module_path;
+  const size_t separator = module_name.find_last_of("/\\");
+  if (separator != std::string::npos) {
+    module_name = module_name.substr(separator + 1);
+  }
+  char key[96];
+  snprintf(key, sizeof(key), "-%016llx-%04x-%04x-%08x.bin",
+           static_cast<unsigned long long>(spirv_hash),
+           device_properties.vendorId, device_properties.deviceId,
+           driver_properties.driverVersion);
+  return std::string(cache_dir) + "/" + module_name + key;
+}
+
+bool ZeApp::moduleCreateFromCache(ze_device_handle_t device,
+                                  const std::string &cache_path,
+                                  ze_module_handle_t *module) {
+  std::ifstream stream(cache_path, std::ios::in | std::ios::binary);
+  if (!stream.good()) {
+    return false;
+  }
+  std::vector<uint8_t> native_binary((std::istreambuf_iterator<char>(stream)),
+                                     std::istreambuf_iterator<char>());
+  if (native_binary.empty()) {
+    return false;
+  }
+
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+  module_description.format = ZE_MODULE_FORMAT_NATIVE;
+  module_description.inputSize = native_binary.size();
+  module_description.pInputModule = native_binary.data();
+  /* A stale or truncated entry is rebuilt from the SPIR-V */
+  if (zeModuleCreate(context, device, &module_description, module, nullptr) !=
+      ZE_RESULT_SUCCESS) {
+    return false;
+  }
+  if (verbose)
+    std::cout << "Module loaded from " << cache_path << std::endl;
+  return true;
+}
+
+/* Written to a temporary file first, so that concurrent runs never read a
+ * partial entry */
+void ZeApp::moduleStoreInCache(ze_module_handle_t module,
+                               const std::string &cache_path) {
+  size_t native_size = 0;
+  if (zeModuleGetNativeBinary(module, &native_size, nullptr) !=
+          ZE_RESULT_SUCCESS ||
+      native_size == 0) {
+    return;
+  }
+  std::vector<uint8_t> native_binary(native_size);
+  if (zeModuleGetNativeBinary(module, &native_size, native_binary.data()) !=
+      ZE_RESULT_SUCCESS) {
+    return;
+  }
+
+  const std::string temporary_path =
+      cache_path + "." + std::to_string(reinterpret_cast<uintptr_t>(module));
+  std::ofstream stream(temporary_path, std::ios::out | std::ios::binary);
+  stream.write(reinterpret_cast<const char *>(native_binary.data()),
+               native_binary.size());
+  stream.close();
+  if (!stream.good() ||
+      std::rename(temporary_path.c_str(), cache_path.c_str()) != 0) {
+    std::cerr << "WARNING : cannot write module cache " << cache_path
+              << std::endl;
+    std::remove(temporary_path.c_str());
+  }
+}
+
+/* Native binaries built ahead of time, see native_binary_paths, are
+ * preferred over both the module cache and building the SPIR-V */
+bool ZeApp::moduleCreateNative(ze_device_handle_t device,
+                               ze_module_handle_t *module) {
+  for (auto &native_path : native_binary_paths(_module_path)) {
+    level_zero_tests::BinaryFile native_binary(native_path);
+    if (native_binary.empty()) {
+      continue;
+    }
+
+    ze_module_desc_t module_description = {};
+    module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+    module_description.format = ZE_MODULE_FORMAT_NATIVE;
+    module_description.inputSize = native_binary.size();
+    module_description.pInputModule = native_binary.data();
+    if (zeModuleCreate(context, device, &module_description, module,
+                       nullptr) == ZE_RESULT_SUCCESS) {
+      if (verbose)
+        std::cout << "Module loaded from " << native_path << std::endl;
+      return true;
+    }
+  }
+  return false;
+}
+
 void ZeApp::moduleCreate(ze_device_handle_t device,
                          ze_module_handle_t *module) {
+  if (moduleCreateNative(device, module)) {
+    return;
+  }
+
+  const std::string cache_path = module_cache_path(device);
+  if (!cache_path.empty() &&
+      moduleCreateFromCache(device, cache_path, module)) {
+    return;
+  }
+
   ze_module_desc_t module_description = {};
   module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
 
@@ -71,6 +194,10 @@ void ZeApp::moduleCreate(ze_device_handle_t device,
 
   SUCCESS_OR_TERMINATE(
       zeModuleCreate(context, device, &module_description, module, nullptr));
+
+  if (!cache_path.empty()) {
+    moduleStoreInCache(*module, cache_path);
+  }
 }
 
 void ZeApp::moduleDestroy(ze_module_handle_t module) {
@@ -90,6 +217,23 @@ bool ZeApp::canAccessPeer(uint32_t device_index_0, uint32_t device_index_1) {
   return canAccess;
 }
 
+bool ZeApp::driverHasExtension(const char *extension_name) {
+  assert(_driver != nullptr);
+
+  uint32_t count = 0;
+  SUCCESS_OR_TERMINATE(
+      zeDriverGetExtensionProperties(_driver, &count, nullptr));
+  std::vector<ze_driver_extension_properties_t> extensions(count);
+  SUCCESS_OR_TERMINATE(
+      zeDriverGetExtensionProperties(_driver, &count, extensions.data()));
+  for (auto &extension : extensions) {
+    if (strcmp(extension.name, extension_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ZeApp::memoryAlloc(size_t size, void **ptr) {
   assert(_devices.size() != 0);
   assert(context != nullptr);
@@ -233,11 +377,57 @@ void ZeApp::commandListCreate(uint32_t device_index,
                                            phCommandList));
 }
 
+void ZeApp::commandListCreateImmediate(
+    ze_command_queue_mode_t mode, ze_command_list_handle_t *phCommandList) {
+  assert(_devices.size() != 0);
+  ze_command_queue_desc_t command_queue_description{};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.pNext = nullptr;
+  command_queue_description.ordinal = 0;
+  command_queue_description.mode = mode;
+
+  SUCCESS_OR_TERMINATE(zeCommandListCreateImmediate(
+      context, _devices[0], &command_queue_description, phCommandList));
+}
+
+void ZeApp::commandListCreateImmediate(uint32_t device_index,
+                                       uint32_t command_queue_group_ordinal,
+                                       uint32_t command_queue_index,
+                                       ze_command_queue_mode_t mode,
+                                       ze_command_list_handle_t *phCommandList,
+                                       ze_command_queue_flags_t flags) {
+  assert(device_index < _devices.size());
+  ze_command_queue_desc_t command_queue_description{};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.pNext = nullptr;
+  command_queue_description.ordinal = command_queue_group_ordinal;
+  command_queue_description.index = command_queue_index;
+  command_queue_description.flags = flags;
+  command_queue_description.mode = mode;
+
+  SUCCESS_OR_TERMINATE(zeCommandListCreateImmediate(
+      context, _devices[device_index], &command_queue_description,
+      phCommandList));
+}
+
+void ZeApp::commandListHostSynchronize(ze_command_list_handle_t command_list,
+                                       ze_event_handle_t completion_event) {
+  TraceSpan span("zeCommandListHostSynchronize", "sync");
+  if (completion_event == nullptr) {
+    SUCCESS_OR_TERMINATE(
+        zeCommandListHostSynchronize(command_list, UINT64_MAX));
+    return;
+  }
+  SUCCESS_OR_TERMINATE(zeEventHostSynchronize(completion_event, UINT64_MAX));
+  SUCCESS_OR_TERMINATE(zeEventHostReset(completion_event));
+}
+
 void ZeApp::commandListDestroy(ze_command_list_handle_t command_list) {
   SUCCESS_OR_TERMINATE(zeCommandListDestroy(command_list));
 }
 
 void ZeApp::commandListClose(ze_command_list_handle_t command_list) {
+  TraceSpan span("zeCommandListClose", "append");
   SUCCESS_OR_TERMINATE(zeCommandListClose(command_list));
 }
 
@@ -245,6 +435,41 @@ void ZeApp::commandListReset(ze_command_list_handle_t command_list) {
   SUCCESS_OR_TERMINATE(zeCommandListReset(command_list));
 }
 
+ze_command_list_handle_t
+ZeApp::commandListAcquire(uint32_t device_index,
+                          uint32_t command_queue_group_ordinal) {
+  size_t slots = 0;
+  while (slots < _command_list_slots.size() &&
+         (_command_list_slots[slots].device_index != device_index ||
+          _command_list_slots[slots].command_queue_group_ordinal !=
+              command_queue_group_ordinal)) {
+    slots++;
+  }
+  if (slots == _command_list_slots.size()) {
+    _command_list_slots.push_back(
+        {device_index, command_queue_group_ordinal, {}});
+  }
+
+  ze_command_list_handle_t command_list;
+  auto &free_lists = _command_list_slots[slots].free_lists;
+  if (free_lists.empty()) {
+    commandListCreate(device_index, command_queue_group_ordinal,
+                      &command_list);
+    _command_list_owners[command_list] = slots;
+  } else {
+    command_list = free_lists.back();
+    free_lists.pop_back();
+  }
+  return command_list;
+}
+
+void ZeApp::commandListRelease(ze_command_list_handle_t command_list) {
+  assert(_command_list_owners.count(command_list));
+  commandListReset(command_list);
+  _command_list_slots[_command_list_owners[command_list]].free_lists.push_back(
+      command_list);
+}
+
 void ZeApp::getIpcHandle(void *ptr, ze_ipc_mem_handle_t *pIpcHandle) {
   SUCCESS_OR_TERMINATE(zeMemGetIpcHandle(context, ptr, pIpcHandle));
 }
@@ -256,6 +481,7 @@ void ZeApp::closeIpcHandle(void *ipc_ptr) {
 void ZeApp::commandListAppendImageCopyFromMemory(
     ze_command_list_handle_t command_list, ze_image_handle_t image,
     uint8_t *srcBuffer, ze_image_region_t *Region) {
+  TraceSpan span("zeCommandListAppendImageCopyFromMemory", "append");
   SUCCESS_OR_TERMINATE(zeCommandListAppendImageCopyFromMemory(
       command_list, image, srcBuffer, Region, nullptr, 0, nullptr));
 }
@@ -263,11 +489,13 @@ void ZeApp::commandListAppendImageCopyFromMemory(
 void ZeApp::commandListAppendImageCopyFromMemory(
     ze_command_list_handle_t command_list, ze_image_handle_t image,
     uint8_t *srcBuffer, ze_image_region_t *Region, ze_event_handle_t hEvent) {
+  TraceSpan span("zeCommandListAppendImageCopyFromMemory", "append");
   SUCCESS_OR_TERMINATE(zeCommandListAppendImageCopyFromMemory(
       command_list, image, srcBuffer, Region, hEvent, 0, nullptr));
 }
 
 void ZeApp::commandListAppendBarrier(ze_command_list_handle_t command_list) {
+  TraceSpan span("zeCommandListAppendBarrier", "append");
   SUCCESS_OR_TERMINATE(
       zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
 }
@@ -275,6 +503,7 @@ void ZeApp::commandListAppendBarrier(ze_command_list_handle_t command_list) {
 void ZeApp::commandListAppendImageCopyToMemory(
     ze_command_list_handle_t command_list, uint8_t *dstBuffer,
     ze_image_handle_t image, ze_image_region_t *Region) {
+  TraceSpan span("zeCommandListAppendImageCopyToMemory", "append");
   SUCCESS_OR_TERMINATE(zeCommandListAppendImageCopyToMemory(
       command_list, dstBuffer, image, Region, nullptr, 0, nullptr));
 }
@@ -283,6 +512,7 @@ void ZeApp::commandListAppendImageCopyToMemory(
     ze_command_list_handle_t command_list, uint8_t *dstBuffer,
     ze_image_handle_t image, ze_image_region_t *Region,
     ze_event_handle_t hEvent) {
+  TraceSpan span("zeCommandListAppendImageCopyToMemory", "append");
   SUCCESS_OR_TERMINATE(zeCommandListAppendImageCopyToMemory(
       command_list, dstBuffer, image, Region, hEvent, 0, nullptr));
 }
@@ -290,24 +520,40 @@ void ZeApp::commandListAppendImageCopyToMemory(
 void ZeApp::commandListAppendMemoryCopy(ze_command_list_handle_t command_list,
                                         void *dstptr, void *srcptr,
                                         size_t size) {
+  TraceSpan span("zeCommandListAppendMemoryCopy", "append");
   SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
       command_list, dstptr, srcptr, size, nullptr, 0, nullptr));
 }
 
+void ZeApp::commandListAppendMemoryCopy(ze_command_list_handle_t command_list,
+                                        void *dstptr, const void *srcptr,
+                                        size_t size,
+                                        ze_event_handle_t hSignalEvent,
+                                        uint32_t numWaitEvents,
+                                        ze_event_handle_t *phWaitEvents) {
+  TraceSpan span("zeCommandListAppendMemoryCopy", "append");
+  SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+      command_list, dstptr, srcptr, size, hSignalEvent, numWaitEvents,
+      phWaitEvents));
+}
+
 void ZeApp::commandListAppendWaitOnEvents(ze_command_list_handle_t CommandList,
                                           uint32_t numEvents,
                                           ze_event_handle_t *phEvents) {
+  TraceSpan span("zeCommandListAppendWaitOnEvents", "append");
   SUCCESS_OR_TERMINATE(
       zeCommandListAppendWaitOnEvents(CommandList, numEvents, phEvents));
 }
 
 void ZeApp::commandListAppendSignalEvent(ze_command_list_handle_t CommandList,
                                          ze_event_handle_t hEvent) {
+  TraceSpan span("zeCommandListAppendSignalEvent", "append");
   SUCCESS_OR_TERMINATE(zeCommandListAppendSignalEvent(CommandList, hEvent));
 }
 
 void ZeApp::commandListAppendResetEvent(ze_command_list_handle_t CommandList,
                                         ze_event_handle_t hEvent) {
+  TraceSpan span("zeCommandListAppendEventReset", "append");
   SUCCESS_OR_TERMINATE(zeCommandListAppendEventReset(CommandList, hEvent));
 }
 
@@ -317,12 +563,12 @@ void ZeApp::hostEventSignal(ze_event_handle_t hEvent) {
 }
 
 void ZeApp::hostSynchronize(ze_event_handle_t hEvent, uint32_t timeout) {
-
+  TraceSpan span("zeEventHostSynchronize", "sync");
   SUCCESS_OR_TERMINATE(zeEventHostSynchronize(hEvent, timeout));
 }
 
 void ZeApp::hostSynchronize(ze_event_handle_t hEvent) {
-
+  TraceSpan span("zeEventHostSynchronize", "sync");
   SUCCESS_OR_TERMINATE(zeEventHostSynchronize(hEvent, ~0));
 }
 
@@ -369,6 +615,7 @@ void ZeApp::commandQueueDestroy(ze_command_queue_handle_t command_queue) {
 void ZeApp::commandQueueExecuteCommandList(
     ze_command_queue_handle_t command_queue, uint32_t numCommandLists,
     ze_command_list_handle_t *command_lists) {
+  TraceSpan span("zeCommandQueueExecuteCommandLists", "submit");
   SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
       command_queue, numCommandLists, command_lists, nullptr));
 }
@@ -416,7 +663,80 @@ void ZeApp::destroy_event(ze_event_handle_t event) {
   SUCCESS_OR_TERMINATE(zeEventDestroy(event));
 }
 
+void ZeApp::acquire_events(uint32_t device_index, uint32_t count,
+                           ze_event_scope_flags_t signal,
+                           ze_event_scope_flags_t wait,
+                           std::vector<ze_event_handle_t> &events) {
+  size_t slots = 0;
+  while (slots < _event_slots.size() &&
+         (_event_slots[slots].device_index != device_index ||
+          _event_slots[slots].signal != signal ||
+          _event_slots[slots].wait != wait)) {
+    slots++;
+  }
+  if (slots == _event_slots.size()) {
+    _event_slots.push_back({device_index, signal, wait, {}, {}});
+  }
+
+  /* Grow by at least 64 events, so that small requests share a pool */
+  auto &free_events = _event_slots[slots].free_events;
+  if (free_events.size() < count) {
+    const uint32_t pool_count = std::max<uint32_t>(
+        count - static_cast<uint32_t>(free_events.size()), 64);
+    ze_event_pool_desc_t pool_desc = {ZE_STRUCTURE_TYPE_EVENT_POOL_DESC};
+    pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+    pool_desc.count = pool_count;
+    ze_event_pool_handle_t event_pool;
+    SUCCESS_OR_TERMINATE(zeEventPoolCreate(
+        context, &pool_desc, 1, &_devices[device_index], &event_pool));
+    _event_slots[slots].pools.push_back(event_pool);
+
+    for (uint32_t i = 0; i < pool_count; i++) {
+      ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC};
+      event_desc.index = i;
+      event_desc.signal = signal;
+      event_desc.wait = wait;
+      ze_event_handle_t event;
+      SUCCESS_OR_TERMINATE(zeEventCreate(event_pool, &event_desc, &event));
+      _event_owners[event] = slots;
+      free_events.push_back(event);
+    }
+  }
+
+  events.assign(free_events.end() - count, free_events.end());
+  free_events.resize(free_events.size() - count);
+}
+
+void ZeApp::release_events(std::vector<ze_event_handle_t> &events) {
+  for (auto event : events) {
+    assert(_event_owners.count(event));
+    SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+    _event_slots[_event_owners[event]].free_events.push_back(event);
+  }
+  events.clear();
+}
+
+/* Pooled events and lists, whether released or not */
+void ZeApp::destroyPooledObjects(void) {
+  for (auto &event_owner : _event_owners) {
+    destroy_event(event_owner.first);
+  }
+  for (auto &slots : _event_slots) {
+    for (auto event_pool : slots.pools) {
+      destroy_event_pool(event_pool);
+    }
+  }
+  for (auto &command_list_owner : _command_list_owners) {
+    commandListDestroy(command_list_owner.first);
+  }
+  _event_owners.clear();
+  _event_slots.clear();
+  _command_list_owners.clear();
+  _command_list_slots.clear();
+}
+
 void ZeApp::commandQueueSynchronize(ze_command_queue_handle_t command_queue) {
+  TraceSpan span("zeCommandQueueSynchronize", "sync");
   SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(command_queue, UINT64_MAX));
 }
 
@@ -432,6 +752,7 @@ void ZeApp::initCountDevices(const uint32_t count) {
   driver_count = 1;
   ze_driver_handle_t driver;
   SUCCESS_OR_TERMINATE(zeDriverGet(&driver_count, &driver));
+  _driver = driver;
 
   ze_context_desc_t context_desc = {};
   context_desc.stype = ZE_STRUCTURE_TYPE_CONTEXT_DESC;
@@ -461,7 +782,37 @@ uint32_t ZeApp::allDevicesInit(void) {
   return _devices.size();
 }
 
+/* Append the subdevices of every root device to _devices, after all the
+ * root devices, and return the root device and subdevice index of each
+ * entry, -1 standing for the root device itself */
+std::vector<std::pair<uint32_t, int>> ZeApp::subDevicesInit(void) {
+  uint32_t root_device_count = _devices.size();
+  std::vector<std::pair<uint32_t, int>> locations;
+  for (uint32_t d = 0; d < root_device_count; d++) {
+    locations.push_back(std::make_pair(d, -1));
+  }
+  for (uint32_t d = 0; d < root_device_count; d++) {
+    uint32_t subdevice_count = 0;
+    SUCCESS_OR_TERMINATE(
+        zeDeviceGetSubDevices(_devices[d], &subdevice_count, nullptr));
+    std::vector<ze_device_handle_t> subdevices(subdevice_count);
+    SUCCESS_OR_TERMINATE(zeDeviceGetSubDevices(_devices[d], &subdevice_count,
+                                               subdevices.data()));
+    for (uint32_t s = 0; s < subdevice_count; s++) {
+      _devices.push_back(subdevices[s]);
+      if (_module_path.size() != 0) {
+        _modules.emplace_back();
+        moduleCreate(subdevices[s], &_modules.back());
+      }
+      locations.push_back(std::make_pair(d, static_cast<int>(s)));
+    }
+  }
+  return locations;
+}
+
 void ZeApp::cleanupDevices(void) {
+  destroyPooledObjects();
+
   if (_module_path.size() != 0) {
     for (int i = 0; i < _devices.size(); i++) {
       moduleDestroy(_modules[i]);
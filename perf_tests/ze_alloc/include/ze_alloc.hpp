@@ -0,0 +1,73 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_ALLOC_HPP_
+#define _ZE_ALLOC_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+enum class AllocType { HOST = 0, DEVICE, SHARED };
+
+/* Samples of every thread of one point of the sweep, in usec */
+struct AllocSamples {
+  std::vector<long double> alloc;
+  std::vector<long double> free;
+  std::vector<long double> properties;
+};
+
+class ZeAlloc {
+public:
+  ZeAlloc();
+  ~ZeAlloc();
+  int parse_arguments(int argc, char **argv);
+  void read_device_properties(void);
+  void test_alloc_latency(void);
+  void test_first_touch(void);
+
+  std::vector<AllocType> alloc_types{AllocType::HOST, AllocType::DEVICE,
+                                     AllocType::SHARED};
+  std::vector<size_t> alloc_sizes;
+  size_t size_lower_limit = 64;
+  size_t size_upper_limit = 64 * 1024 * 1024;
+  /* 0 leaves the alignment to the driver */
+  std::vector<size_t> alignments{0, 4096, 65536};
+  std::vector<uint32_t> thread_counts{1, 4};
+  uint32_t device_id = 0;
+  uint32_t number_iterations = 100;
+  uint32_t warmup_iterations = 10;
+  /* every touch iteration allocates and launches a kernel */
+  uint32_t touch_iterations = 20;
+  bool run_alloc = true;
+  bool run_touch = true;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_alloc"};
+
+  ZeApp *benchmark;
+
+private:
+  void *allocate(AllocType type, size_t size, size_t alignment);
+  void alloc_thread(AllocType type, size_t size, size_t alignment,
+                    std::atomic<uint32_t> &ready,
+                    const std::atomic<bool> &go, AllocSamples &samples);
+  bool supported(size_t size) const;
+  void add_result(const std::string &test, AllocType type, size_t size,
+                  size_t alignment, uint32_t threads,
+                  const std::vector<long double> &samples);
+
+  ze_device_properties_t device_properties = {};
+};
+
+#endif /* _ZE_ALLOC_HPP_ */
@@ -0,0 +1,211 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_alloc.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_alloc [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -t, list                 comma separated tests to run "
+    "[default: alloc,touch]:"
+    "\n      alloc                            latency of allocating, "
+    "querying and"
+    "\n                                       freeing with "
+    "zeMemAlloc*, zeMemGetAllocProperties"
+    "\n                                       and zeMemFree"
+    "\n      touch                            cost of the first kernel "
+    "writing a"
+    "\n                                       fresh allocation against a "
+    "second one"
+    "\n  -m, list                 comma separated memory types host, device "
+    "and shared"
+    "\n                            [default:  all]"
+    "\n  -s                       select only one allocation size (bytes)"
+    "\n  -sb                      select beginning allocation size (bytes), "
+    "quadrupled"
+    "\n                            up to the ending size [default:  64]"
+    "\n  -se                      select ending allocation size (bytes)"
+    "\n                            [default:  64MB]"
+    "\n  -a, list                 comma separated alignments (bytes), 0 "
+    "leaving the"
+    "\n                            alignment to the driver "
+    "[default:  0,4096,65536]"
+    "\n  --threads list           comma separated numbers of threads "
+    "allocating at"
+    "\n                            once [default:  1,4]"
+    "\n  -i                       set number of iterations per thread"
+    "\n                            [default:  100]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  10]"
+    "\n  --touch-iterations       set number of fresh allocations touched"
+    "\n                            [default:  20]"
+    "\n  -d                       select the device (default: 0)"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+static bool parse_number_list(const char *list, std::vector<size_t> &numbers) {
+  numbers.clear();
+  for (auto &item : split_list(list)) {
+    if (!isdigit(item[0])) {
+      return false;
+    }
+    numbers.push_back(strtoull(item.c_str(), nullptr, 0));
+  }
+  return !numbers.empty();
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_alloc and
+// sets the test parameters accordingly for main to execute the tests
+// with the correct environment.
+//---------------------------------------------------------------------
+int ZeAlloc::parse_arguments(int argc, char **argv) {
+  std::vector<size_t> numbers;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc)) {
+      run_alloc = false;
+      run_touch = false;
+      for (auto &test : split_list(argv[i + 1])) {
+        if (test == "alloc") {
+          run_alloc = true;
+        } else if (test == "touch") {
+          run_touch = true;
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-m") == 0) && (i + 1 < argc)) {
+      alloc_types.clear();
+      for (auto &type : split_list(argv[i + 1])) {
+        if (type == "host") {
+          alloc_types.push_back(AllocType::HOST);
+        } else if (type == "device") {
+          alloc_types.push_back(AllocType::DEVICE);
+        } else if (type == "shared") {
+          alloc_types.push_back(AllocType::SHARED);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+      alloc_sizes.push_back(strtoull(argv[i + 1], nullptr, 0));
+      i++;
+    } else if ((strcmp(argv[i], "-sb") == 0) && (i + 1 < argc)) {
+      size_lower_limit = strtoull(argv[i + 1], nullptr, 0);
+      i++;
+    } else if ((strcmp(argv[i], "-se") == 0) && (i + 1 < argc)) {
+      size_upper_limit = strtoull(argv[i + 1], nullptr, 0);
+      i++;
+    } else if ((strcmp(argv[i], "-a") == 0) && (i + 1 < argc)) {
+      if (!parse_number_list(argv[i + 1], alignments)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      for (auto alignment : alignments) {
+        if (alignment & (alignment - 1)) {
+          std::cerr << "alignment " << alignment
+                    << " is not a power of two" << std::endl;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) {
+      if (!parse_number_list(argv[i + 1], numbers)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      thread_counts.clear();
+      for (auto threads : numbers) {
+        thread_counts.push_back(
+            std::max<uint32_t>(1, static_cast<uint32_t>(threads)));
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if ((strcmp(argv[i], "--touch-iterations") == 0) &&
+               (i + 1 < argc)) {
+      touch_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc)) {
+      device_id = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  if (alloc_sizes.empty()) {
+    for (size_t size = std::max<size_t>(1, size_lower_limit);
+         size <= size_upper_limit; size *= 4) {
+      alloc_sizes.push_back(size);
+    }
+  }
+
+  return 0;
+}
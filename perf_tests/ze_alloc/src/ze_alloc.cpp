@@ -0,0 +1,373 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_alloc.hpp"
+#include "ze_app.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+/* produce_shared of ze_bandwidth.spv writes every uint of a buffer */
+static const uint32_t touch_group_size = 256;
+static const uint32_t touch_max_group_count = 1024;
+
+static const char *alloc_type_names[] = {"host", "device", "shared"};
+
+ZeAlloc::ZeAlloc() {
+  benchmark = new ZeApp("ze_bandwidth.spv");
+
+  benchmark->allDevicesInit();
+}
+
+ZeAlloc::~ZeAlloc() {
+  benchmark->allDevicesCleanup();
+
+  delete benchmark;
+}
+
+//---------------------------------------------------------------------
+// Allocates with the alignment asked for, 0 leaving it to the driver.
+//---------------------------------------------------------------------
+void *ZeAlloc::allocate(AllocType type, size_t size, size_t alignment) {
+  ze_device_mem_alloc_desc_t device_description = {
+      ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC, nullptr, 0, 0};
+  ze_host_mem_alloc_desc_t host_description = {
+      ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC, nullptr, 0};
+  void *ptr = nullptr;
+
+  switch (type) {
+  case AllocType::HOST:
+    SUCCESS_OR_TERMINATE(zeMemAllocHost(benchmark->context, &host_description,
+                                        size, alignment, &ptr));
+    break;
+  case AllocType::DEVICE:
+    SUCCESS_OR_TERMINATE(zeMemAllocDevice(
+        benchmark->context, &device_description, size, alignment,
+        benchmark->_devices[device_id], &ptr));
+    break;
+  case AllocType::SHARED:
+    SUCCESS_OR_TERMINATE(zeMemAllocShared(
+        benchmark->context, &device_description, &host_description, size,
+        alignment, benchmark->_devices[device_id], &ptr));
+    break;
+  }
+  return ptr;
+}
+
+void ZeAlloc::read_device_properties(void) {
+  device_properties.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  SUCCESS_OR_TERMINATE(zeDeviceGetProperties(benchmark->_devices[device_id],
+                                             &device_properties));
+}
+
+bool ZeAlloc::supported(size_t size) const {
+  return size <= device_properties.maxMemAllocSize;
+}
+
+//---------------------------------------------------------------------
+// Allocates, queries and frees one buffer per iteration, so that every
+// thread holds at most one buffer, and keeps the time of each call once
+// the warmup iterations are done. Every thread sets up its timers and
+// counts itself ready, then all are released together.
+//---------------------------------------------------------------------
+void ZeAlloc::alloc_thread(AllocType type, size_t size, size_t alignment,
+                           std::atomic<uint32_t> &ready,
+                           const std::atomic<bool> &go,
+                           AllocSamples &samples) {
+  SampleTimer<std::micro> alloc_timer(number_iterations);
+  SampleTimer<std::micro> free_timer(number_iterations);
+  SampleTimer<std::micro> properties_timer(number_iterations);
+  ze_memory_allocation_properties_t properties = {
+      ZE_STRUCTURE_TYPE_MEMORY_ALLOCATION_PROPERTIES, nullptr};
+  ze_device_handle_t device = nullptr;
+
+  ready.fetch_add(1, std::memory_order_release);
+  while (!go.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    if (i == warmup_iterations) {
+      alloc_timer.clear();
+      free_timer.clear();
+      properties_timer.clear();
+    }
+
+    alloc_timer.start();
+    void *ptr = allocate(type, size, alignment);
+    alloc_timer.stop();
+
+    properties_timer.start();
+    SUCCESS_OR_TERMINATE(zeMemGetAllocProperties(benchmark->context, ptr,
+                                                 &properties, &device));
+    properties_timer.stop();
+
+    free_timer.start();
+    SUCCESS_OR_TERMINATE(zeMemFree(benchmark->context, ptr));
+    free_timer.stop();
+  }
+
+  samples.alloc = alloc_timer.samples();
+  samples.free = free_timer.samples();
+  samples.properties = properties_timer.samples();
+}
+
+void ZeAlloc::add_result(const std::string &test, AllocType type, size_t size,
+                         size_t alignment, uint32_t threads,
+                         const std::vector<long double> &samples) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = "usec";
+  record.parameters = {{"device", std::to_string(device_id)},
+                       {"type", alloc_type_names[static_cast<int>(type)]},
+                       {"size", std::to_string(size)},
+                       {"alignment", std::to_string(alignment)},
+                       {"threads", std::to_string(threads)}};
+  record.stats = ResultStats::from_samples(samples);
+  record.value = record.stats.median;
+  record.samples = samples;
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// Latency of zeMemAlloc{Host,Device,Shared}, zeMemGetAllocProperties and
+// zeMemFree over allocation type, size, alignment and number of threads
+// allocating at once, as the median and 99th percentile of the calls of
+// all threads.
+//---------------------------------------------------------------------
+void ZeAlloc::test_alloc_latency(void) {
+  std::cout << std::endl;
+  std::cout << "ALLOCATION LATENCY" << std::endl;
+  if (csv_output) {
+    std::cout << "Type,Size,Alignment,Threads,Alloc_median_(usec),"
+                 "Alloc_p99_(usec),Free_median_(usec),Free_p99_(usec),"
+                 "Properties_median_(usec),Properties_p99_(usec)"
+              << std::endl;
+  }
+
+  for (auto type : alloc_types) {
+    for (auto size : alloc_sizes) {
+      if (!supported(size)) {
+        continue;
+      }
+      for (auto alignment : alignments) {
+        for (auto threads : thread_counts) {
+          std::vector<AllocSamples> thread_samples(threads);
+          std::vector<std::thread> workers;
+          std::atomic<uint32_t> ready{0};
+          std::atomic<bool> go{false};
+          for (uint32_t t = 0; t < threads; t++) {
+            workers.emplace_back(&ZeAlloc::alloc_thread, this, type, size,
+                                 alignment, std::ref(ready), std::cref(go),
+                                 std::ref(thread_samples[t]));
+          }
+          while (ready.load(std::memory_order_acquire) < threads) {
+            std::this_thread::yield();
+          }
+          go.store(true, std::memory_order_release);
+          for (auto &worker : workers) {
+            worker.join();
+          }
+
+          AllocSamples all;
+          for (const auto &samples : thread_samples) {
+            all.alloc.insert(all.alloc.end(), samples.alloc.begin(),
+                             samples.alloc.end());
+            all.free.insert(all.free.end(), samples.free.begin(),
+                            samples.free.end());
+            all.properties.insert(all.properties.end(),
+                                  samples.properties.begin(),
+                                  samples.properties.end());
+          }
+          const ResultStats alloc_stats = ResultStats::from_samples(all.alloc);
+          const ResultStats free_stats = ResultStats::from_samples(all.free);
+          const ResultStats properties_stats =
+              ResultStats::from_samples(all.properties);
+
+          const char *type_name = alloc_type_names[static_cast<int>(type)];
+          if (csv_output) {
+            std::cout << type_name << "," << size << "," << alignment << ","
+                      << threads << "," << alloc_stats.median << ","
+                      << alloc_stats.p99 << "," << free_stats.median << ","
+                      << free_stats.p99 << "," << properties_stats.median
+                      << "," << properties_stats.p99 << std::endl;
+          } else {
+            std::cout << std::setprecision(2) << std::fixed << "Type: "
+                      << std::setw(6) << type_name
+                      << " Size: " << std::setw(10) << size
+                      << " Alignment: " << std::setw(7) << alignment
+                      << " Threads: " << std::setw(2) << threads
+                      << " Alloc(median/p99): " << std::setw(9)
+                      << alloc_stats.median << "/" << std::setw(9)
+                      << alloc_stats.p99 << " usec Free(median/p99): "
+                      << std::setw(9) << free_stats.median << "/"
+                      << std::setw(9) << free_stats.p99
+                      << " usec Properties(median/p99): " << std::setw(7)
+                      << properties_stats.median << "/" << std::setw(7)
+                      << properties_stats.p99 << " usec" << std::endl;
+          }
+
+          add_result("Alloc", type, size, alignment, threads, all.alloc);
+          add_result("Free", type, size, alignment, threads, all.free);
+          add_result("GetAllocProperties", type, size, alignment, threads,
+                     all.properties);
+        }
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Cost of the first kernel writing a fresh allocation, against a second
+// launch of the same kernel on the now touched memory, on a synchronous
+// immediate list of a compute engine. The difference is what the first
+// touch adds, such as page faults, migration or residency setup.
+//---------------------------------------------------------------------
+void ZeAlloc::test_first_touch(void) {
+  std::cout << std::endl;
+  std::cout << "FIRST KERNEL TOUCH" << std::endl;
+  if (csv_output) {
+    std::cout << "Type,Size,Alignment,First_touch_median_(usec),"
+                 "Warm_touch_median_(usec),First_touch_overhead_(usec)"
+              << std::endl;
+  }
+
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  queue_properties.data());
+  uint32_t ordinal = num_queue_groups;
+  for (uint32_t i = 0; i < num_queue_groups; i++) {
+    if (queue_properties[i].flags &
+        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      ordinal = i;
+      break;
+    }
+  }
+  if (ordinal == num_queue_groups) {
+    std::cout << "No compute command queue group found, skipping"
+              << std::endl;
+    return;
+  }
+
+  ze_command_list_handle_t immediate_list;
+  benchmark->commandListCreateImmediate(device_id, ordinal, 0,
+                                        ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS,
+                                        &immediate_list);
+  ze_kernel_handle_t produce;
+  benchmark->functionCreate(device_id, &produce, "produce_shared");
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetGroupSize(produce, touch_group_size, 1, 1));
+
+  for (auto type : alloc_types) {
+    for (auto size : alloc_sizes) {
+      uint32_t count = static_cast<uint32_t>(size / sizeof(uint32_t));
+      if (count == 0 || !supported(size)) {
+        continue;
+      }
+      ze_group_count_t group_count = {
+          std::min((count + touch_group_size - 1) / touch_group_size,
+                   touch_max_group_count),
+          1, 1};
+
+      for (auto alignment : alignments) {
+        SampleTimer<std::micro> first_timer(touch_iterations);
+        SampleTimer<std::micro> warm_timer(touch_iterations);
+
+        for (uint32_t i = 0; i < touch_iterations; i++) {
+          void *ptr = allocate(type, size, alignment);
+          uint32_t value = i;
+          SUCCESS_OR_TERMINATE(
+              zeKernelSetArgumentValue(produce, 0, sizeof(void *), &ptr));
+          SUCCESS_OR_TERMINATE(
+              zeKernelSetArgumentValue(produce, 1, sizeof(count), &count));
+          SUCCESS_OR_TERMINATE(
+              zeKernelSetArgumentValue(produce, 2, sizeof(value), &value));
+
+          first_timer.start();
+          SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+              immediate_list, produce, &group_count, nullptr, 0, nullptr));
+          first_timer.stop();
+
+          warm_timer.start();
+          SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+              immediate_list, produce, &group_count, nullptr, 0, nullptr));
+          warm_timer.stop();
+
+          SUCCESS_OR_TERMINATE(zeMemFree(benchmark->context, ptr));
+        }
+
+        const long double first = first_timer.median();
+        const long double warm = warm_timer.median();
+        const char *type_name = alloc_type_names[static_cast<int>(type)];
+        if (csv_output) {
+          std::cout << type_name << "," << size << "," << alignment << ","
+                    << first << "," << warm << "," << first - warm
+                    << std::endl;
+        } else {
+          std::cout << std::setprecision(2) << std::fixed << "Type: "
+                    << std::setw(6) << type_name << " Size: " << std::setw(10)
+                    << size << " Alignment: " << std::setw(7) << alignment
+                    << " First touch: " << std::setw(9) << first
+                    << " usec Warm touch: " << std::setw(9) << warm
+                    << " usec Overhead: " << std::setw(9) << first - warm
+                    << " usec" << std::endl;
+        }
+
+        add_result("FirstTouch", type, size, alignment, 1,
+                   first_timer.samples());
+        add_result("WarmTouch", type, size, alignment, 1,
+                   warm_timer.samples());
+      }
+    }
+  }
+
+  benchmark->functionDestroy(produce);
+  benchmark->commandListDestroy(immediate_list);
+}
+
+int main(int argc, char **argv) {
+  ZeAlloc alloc;
+
+  alloc.parse_arguments(argc, argv);
+
+  if (alloc.device_id >= alloc.benchmark->_devices.size()) {
+    std::cerr << "ERROR: device " << alloc.device_id << " not found"
+              << std::endl;
+    return -1;
+  }
+
+  alloc.read_device_properties();
+  if (alloc.results.enabled()) {
+    alloc.results.read_metadata({alloc.benchmark->_devices[alloc.device_id]});
+  }
+
+  if (alloc.run_alloc) {
+    alloc.test_alloc_latency();
+  }
+  if (alloc.run_touch) {
+    alloc.test_first_touch();
+  }
+
+  std::cout << std::endl;
+  return alloc.results.finish();
+}
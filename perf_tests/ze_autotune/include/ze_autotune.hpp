@@ -0,0 +1,93 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_AUTOTUNE_HPP_
+#define _ZE_AUTOTUNE_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+/*
+ * Kernel arguments given on the command line, in order:
+ *   BUFFER -> device memory of size bytes, zeroed
+ *   LOCAL  -> shared local memory of size bytes per group
+ *   VALUE  -> the size bytes of value, for uint, int, ulong and float
+ */
+enum class TuneArgKind { BUFFER = 0, LOCAL, VALUE };
+
+struct TuneArg {
+  TuneArgKind kind;
+  size_t size;
+  uint64_t value;
+};
+
+/* One configuration of the sweep and what it measured */
+struct TuneConfig {
+  std::array<uint32_t, 3> group_size;
+  ze_cache_config_flags_t cache_config;
+  long double usec = 0;
+  std::vector<long double> samples;
+  /* resident hardware threads over all of them, in % */
+  long double theoretical_occupancy = 0;
+  long double achieved_occupancy = 0;
+};
+
+class ZeAutotune {
+public:
+  ZeAutotune();
+  ~ZeAutotune();
+  int parse_arguments(int argc, char **argv);
+  /* loads the module, once parse_arguments named it */
+  void initialize(void);
+  void test_autotune(void);
+
+  std::string module_path;
+  std::string kernel_name;
+  std::array<uint32_t, 3> global_size{{1048576, 1, 1}};
+  std::vector<TuneArg> args;
+  /* group sizes to sweep, powers of two up to the device limits when empty */
+  std::vector<std::array<uint32_t, 3>> group_sizes;
+  std::vector<ze_cache_config_flags_t> cache_configs{
+      0, ZE_CACHE_CONFIG_FLAG_LARGE_SLM, ZE_CACHE_CONFIG_FLAG_LARGE_DATA};
+  uint32_t number_iterations = 50;
+  uint32_t warmup_iterations = 5;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_autotune"};
+
+  ZeApp *benchmark = nullptr;
+
+private:
+  void set_arguments(void);
+  std::vector<std::array<uint32_t, 3>> candidate_group_sizes(void);
+  bool occupancy(TuneConfig &config);
+  bool measure(TuneConfig &config);
+  void print_config(const char *label, const TuneConfig &config);
+  void add_result(const std::string &test, const TuneConfig &config);
+
+  ze_device_properties_t device_properties;
+  ze_device_compute_properties_t compute_properties;
+  ze_kernel_properties_t kernel_properties;
+  /* shared local memory per group: the kernel's and the LOCAL arguments */
+  size_t slm_per_group = 0;
+  long double nsec_per_tick = 1;
+  ze_kernel_handle_t kernel = nullptr;
+  std::vector<void *> buffers;
+  ze_command_queue_handle_t queue = nullptr;
+  ze_command_list_handle_t list = nullptr;
+  ze_event_pool_handle_t event_pool = nullptr;
+  ze_event_handle_t event = nullptr;
+};
+
+#endif /* _ZE_AUTOTUNE_HPP_ */
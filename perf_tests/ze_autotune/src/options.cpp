@@ -0,0 +1,213 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_autotune.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_autotune -m module.spv -k kernel [-a arg ...] [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -m                       SPIR-V module of the kernel"
+    "\n  -k                       name of the kernel"
+    "\n  -a                       next argument of the kernel, once per "
+    "argument in"
+    "\n                            order:"
+    "\n      buffer:bytes                     device memory, zeroed"
+    "\n      local:bytes                      shared local memory per group"
+    "\n      uint:value, int:value, ulong:value, float:value"
+    "\n  -g                       global size X[,Y[,Z]] in work items"
+    "\n                            [default:  1048576]"
+    "\n  -s, list                 comma separated group sizes X[xY[xZ]] to "
+    "sweep"
+    "\n                            [default:  powers of two up to the "
+    "device limits"
+    "\n                            and the suggested one]"
+    "\n  -c, list                 comma separated cache configurations "
+    "[default:  all]:"
+    "\n      default, large_slm, large_data"
+    "\n  -i                       set number of iterations per "
+    "configuration"
+    "\n                            [default:  50]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  5]"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list, char separator) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, separator)) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/* Up to three sizes of at least 1, the missing ones 1 */
+static bool parse_size(const char *list, char separator,
+                       std::array<uint32_t, 3> &size) {
+  std::vector<std::string> items = split_list(list, separator);
+  if (items.empty() || items.size() > 3) {
+    return false;
+  }
+  size = {{1, 1, 1}};
+  for (size_t d = 0; d < items.size(); d++) {
+    if (!isdigit(items[d][0])) {
+      return false;
+    }
+    size[d] = sanitize_ulong(&items[d][0]);
+    if (size[d] == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool parse_arg(const char *text, TuneArg &arg) {
+  const char *colon = strchr(text, ':');
+  if (colon == nullptr || colon[1] == '\0') {
+    return false;
+  }
+  const std::string kind(text, colon - text);
+  const char *value = colon + 1;
+  arg.value = 0;
+  if (kind == "buffer" || kind == "local") {
+    arg.kind = (kind == "buffer") ? TuneArgKind::BUFFER : TuneArgKind::LOCAL;
+    arg.size = strtoull(value, nullptr, 0);
+    return arg.size != 0;
+  }
+  arg.kind = TuneArgKind::VALUE;
+  if (kind == "uint" || kind == "int") {
+    const uint32_t word = static_cast<uint32_t>(strtol(value, nullptr, 0));
+    arg.size = sizeof(word);
+    memcpy(&arg.value, &word, sizeof(word));
+  } else if (kind == "ulong") {
+    arg.size = sizeof(uint64_t);
+    arg.value = strtoull(value, nullptr, 0);
+  } else if (kind == "float") {
+    const float number = strtof(value, nullptr);
+    arg.size = sizeof(number);
+    memcpy(&arg.value, &number, sizeof(number));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_autotune and sets
+// the test parameters accordingly for main to execute the tests with
+// the correct environment.
+//---------------------------------------------------------------------
+int ZeAutotune::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-m") == 0) && (i + 1 < argc)) {
+      module_path = argv[i + 1];
+      i++;
+    } else if ((strcmp(argv[i], "-k") == 0) && (i + 1 < argc)) {
+      kernel_name = argv[i + 1];
+      i++;
+    } else if ((strcmp(argv[i], "-a") == 0) && (i + 1 < argc)) {
+      TuneArg arg;
+      if (!parse_arg(argv[i + 1], arg)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      args.push_back(arg);
+      i++;
+    } else if ((strcmp(argv[i], "-g") == 0) && (i + 1 < argc)) {
+      if (!parse_size(argv[i + 1], ',', global_size)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+      group_sizes.clear();
+      for (auto &item : split_list(argv[i + 1], ',')) {
+        std::array<uint32_t, 3> size;
+        if (!parse_size(item.c_str(), 'x', size)) {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+        group_sizes.push_back(size);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc)) {
+      cache_configs.clear();
+      for (auto &config : split_list(argv[i + 1], ',')) {
+        if (config == "default") {
+          cache_configs.push_back(0);
+        } else if (config == "large_slm") {
+          cache_configs.push_back(ZE_CACHE_CONFIG_FLAG_LARGE_SLM);
+        } else if (config == "large_data") {
+          cache_configs.push_back(ZE_CACHE_CONFIG_FLAG_LARGE_DATA);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  if (module_path.empty() || kernel_name.empty() || cache_configs.empty()) {
+    std::cerr << usage_str;
+    exit(-1);
+  }
+
+  return 0;
+}
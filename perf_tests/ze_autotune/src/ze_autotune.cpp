@@ -0,0 +1,413 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "clock_correlation.hpp"
+#include "ze_app.hpp"
+#include "ze_autotune.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+static const char *cache_config_name(ze_cache_config_flags_t flags) {
+  if (flags & ZE_CACHE_CONFIG_FLAG_LARGE_SLM) {
+    return "large_slm";
+  }
+  if (flags & ZE_CACHE_CONFIG_FLAG_LARGE_DATA) {
+    return "large_data";
+  }
+  return "default";
+}
+
+static std::string group_size_name(const std::array<uint32_t, 3> &size) {
+  return std::to_string(size[0]) + "x" + std::to_string(size[1]) + "x" +
+         std::to_string(size[2]);
+}
+
+ZeAutotune::ZeAutotune() {}
+
+ZeAutotune::~ZeAutotune() {
+  if (!benchmark) {
+    return;
+  }
+  if (event) {
+    benchmark->destroy_event(event);
+  }
+  if (event_pool) {
+    benchmark->destroy_event_pool(event_pool);
+  }
+  if (list) {
+    benchmark->commandListDestroy(list);
+  }
+  if (queue) {
+    benchmark->commandQueueDestroy(queue);
+  }
+  for (auto buffer : buffers) {
+    benchmark->memoryFree(buffer);
+  }
+  if (kernel) {
+    benchmark->functionDestroy(kernel);
+  }
+
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+//---------------------------------------------------------------------
+// Loads the module, creates the kernel with the arguments given on the
+// command line, and the queue, list and timestamp event of the sweep.
+//---------------------------------------------------------------------
+void ZeAutotune::initialize(void) {
+  benchmark = new ZeApp(module_path);
+  benchmark->singleDeviceInit();
+
+  ze_device_handle_t device = benchmark->_devices[0];
+  device_properties = {ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeDeviceGetProperties(device, &device_properties));
+  compute_properties = {ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGetComputeProperties(device, &compute_properties));
+  nsec_per_tick = ClockCorrelation(device).nsec_per_tick();
+
+  benchmark->functionCreate(&kernel, kernel_name.c_str());
+  kernel_properties = {ZE_STRUCTURE_TYPE_KERNEL_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeKernelGetProperties(kernel, &kernel_properties));
+  if (kernel_properties.numKernelArgs != args.size()) {
+    std::cerr << kernel_name << " takes " << kernel_properties.numKernelArgs
+              << " arguments, " << args.size() << " given with -a"
+              << std::endl;
+    exit(-1);
+  }
+
+  benchmark->commandQueueCreate(0, &queue);
+  benchmark->commandListCreate(&list);
+  set_arguments();
+
+  event_pool = benchmark->create_event_pool(
+      1, ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  benchmark->create_event(event_pool, event, 0);
+}
+
+/* Sets every argument, allocating and zeroing the buffers */
+void ZeAutotune::set_arguments(void) {
+  const uint8_t zero = 0;
+
+  slm_per_group = kernel_properties.localMemSize;
+  for (uint32_t i = 0; i < args.size(); i++) {
+    const TuneArg &arg = args[i];
+    switch (arg.kind) {
+    case TuneArgKind::BUFFER: {
+      void *buffer = nullptr;
+      benchmark->memoryAlloc(arg.size, &buffer);
+      buffers.push_back(buffer);
+      SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryFill(
+          list, buffer, &zero, sizeof(zero), arg.size, nullptr, 0, nullptr));
+      SUCCESS_OR_TERMINATE(
+          zeKernelSetArgumentValue(kernel, i, sizeof(buffer), &buffer));
+      break;
+    }
+    case TuneArgKind::LOCAL:
+      slm_per_group += arg.size;
+      SUCCESS_OR_TERMINATE(
+          zeKernelSetArgumentValue(kernel, i, arg.size, nullptr));
+      break;
+    default:
+      /* the low bytes of value, on the little endian hosts of the GPUs */
+      SUCCESS_OR_TERMINATE(
+          zeKernelSetArgumentValue(kernel, i, arg.size, &arg.value));
+      break;
+    }
+  }
+
+  benchmark->commandListClose(list);
+  benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+  benchmark->commandQueueSynchronize(queue);
+}
+
+//---------------------------------------------------------------------
+// The group sizes of the sweep that divide the global size within the
+// device limits: the ones of -s, or powers of two in every dimension of
+// more than one work item, with the size zeKernelSuggestGroupSize picks.
+// A kernel compiled for a required group size only gets that one.
+//---------------------------------------------------------------------
+std::vector<std::array<uint32_t, 3>> ZeAutotune::candidate_group_sizes(void) {
+  if (kernel_properties.requiredGroupSizeX) {
+    return {{{kernel_properties.requiredGroupSizeX,
+              kernel_properties.requiredGroupSizeY,
+              kernel_properties.requiredGroupSizeZ}}};
+  }
+
+  const uint32_t max_size[3] = {compute_properties.maxGroupSizeX,
+                                compute_properties.maxGroupSizeY,
+                                compute_properties.maxGroupSizeZ};
+  std::vector<std::array<uint32_t, 3>> sizes = group_sizes;
+  if (sizes.empty()) {
+    std::vector<uint32_t> powers[3];
+    for (int d = 0; d < 3; d++) {
+      for (uint32_t size = 1; size <= std::min(max_size[d], global_size[d]);
+           size *= 2) {
+        powers[d].push_back(size);
+      }
+    }
+    for (auto z : powers[2]) {
+      for (auto y : powers[1]) {
+        for (auto x : powers[0]) {
+          sizes.push_back({{x, y, z}});
+        }
+      }
+    }
+    std::array<uint32_t, 3> suggested;
+    SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(
+        kernel, global_size[0], global_size[1], global_size[2], &suggested[0],
+        &suggested[1], &suggested[2]));
+    if (std::find(sizes.begin(), sizes.end(), suggested) == sizes.end()) {
+      sizes.push_back(suggested);
+    }
+  }
+
+  std::vector<std::array<uint32_t, 3>> candidates;
+  for (auto &size : sizes) {
+    bool fits = static_cast<uint64_t>(size[0]) * size[1] * size[2] <=
+                compute_properties.maxTotalGroupSize;
+    for (int d = 0; d < 3; d++) {
+      fits &= size[d] != 0 && size[d] <= max_size[d] &&
+              global_size[d] % size[d] == 0;
+    }
+    if (fits) {
+      candidates.push_back(size);
+    }
+  }
+  return candidates;
+}
+
+//---------------------------------------------------------------------
+// Estimates the occupancy of the configuration from the kernel and
+// device properties: hardware threads of SIMD width per group, groups
+// per subslice as limited by its threads and shared local memory, and
+// over the whole launch, the last partial wave of groups. Returns false
+// when a group does not fit on a subslice.
+//---------------------------------------------------------------------
+bool ZeAutotune::occupancy(TuneConfig &config) {
+  const uint32_t simd = kernel_properties.requiredSubgroupSize
+                            ? kernel_properties.requiredSubgroupSize
+                            : std::max(1u, kernel_properties.maxSubgroupSize);
+  const uint64_t group_items = static_cast<uint64_t>(config.group_size[0]) *
+                               config.group_size[1] * config.group_size[2];
+  const uint64_t threads_per_group = (group_items + simd - 1) / simd;
+  const uint64_t subslice_threads =
+      static_cast<uint64_t>(device_properties.numEUsPerSubslice) *
+      device_properties.numThreadsPerEU;
+  const uint64_t subslices =
+      static_cast<uint64_t>(device_properties.numSlices) *
+      device_properties.numSubslicesPerSlice;
+  if (subslice_threads == 0 || subslices == 0) {
+    return true;
+  }
+
+  uint64_t groups_per_subslice = subslice_threads / threads_per_group;
+  if (slm_per_group > 0) {
+    groups_per_subslice = std::min<uint64_t>(
+        groups_per_subslice,
+        compute_properties.maxSharedLocalMemory / slm_per_group);
+  }
+  if (groups_per_subslice == 0) {
+    return false;
+  }
+
+  uint64_t groups = 1;
+  for (int d = 0; d < 3; d++) {
+    groups *= global_size[d] / config.group_size[d];
+  }
+  const uint64_t groups_per_wave = groups_per_subslice * subslices;
+  const uint64_t waves = (groups + groups_per_wave - 1) / groups_per_wave;
+
+  config.theoretical_occupancy = 100.0L * groups_per_subslice *
+                                 threads_per_group / subslice_threads;
+  config.achieved_occupancy = 100.0L * groups * threads_per_group /
+                              (waves * subslices * subslice_threads);
+  return true;
+}
+
+//---------------------------------------------------------------------
+// Times the kernel with the group size and cache configuration from its
+// kernel timestamps, once per iteration. Returns false when the driver
+// rejects the configuration.
+//---------------------------------------------------------------------
+bool ZeAutotune::measure(TuneConfig &config) {
+  if (zeKernelSetGroupSize(kernel, config.group_size[0], config.group_size[1],
+                           config.group_size[2]) != ZE_RESULT_SUCCESS ||
+      zeKernelSetCacheConfig(kernel, config.cache_config) !=
+          ZE_RESULT_SUCCESS) {
+    return false;
+  }
+
+  const ze_group_count_t group_count = {
+      global_size[0] / config.group_size[0],
+      global_size[1] / config.group_size[1],
+      global_size[2] / config.group_size[2]};
+  benchmark->commandListReset(list);
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      list, kernel, &group_count, event, 0, nullptr));
+  benchmark->commandListClose(list);
+
+  config.samples.clear();
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    ze_kernel_timestamp_result_t timestamp;
+    SUCCESS_OR_TERMINATE(zeEventQueryKernelTimestamp(event, &timestamp));
+    SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+    if (i >= warmup_iterations) {
+      config.samples.push_back(
+          ClockCorrelation::elapsed_ticks(
+              timestamp.global.kernelStart, timestamp.global.kernelEnd,
+              device_properties.kernelTimestampValidBits) *
+          nsec_per_tick / 1e3);
+    }
+  }
+  config.usec = ResultStats::from_samples(config.samples).median;
+  return true;
+}
+
+void ZeAutotune::print_config(const char *label, const TuneConfig &config) {
+  if (csv_output) {
+    std::cout << label << "," << group_size_name(config.group_size) << ","
+              << cache_config_name(config.cache_config) << "," << config.usec
+              << "," << config.theoretical_occupancy << ","
+              << config.achieved_occupancy << std::endl;
+  } else {
+    std::cout << std::setprecision(2) << std::fixed << label
+              << " Group: " << std::setw(13)
+              << group_size_name(config.group_size)
+              << " Cache: " << std::setw(10)
+              << cache_config_name(config.cache_config)
+              << " Time: " << std::setw(10) << config.usec
+              << " usec Occupancy: " << std::setw(6)
+              << config.theoretical_occupancy << "% theoretical "
+              << std::setw(6) << config.achieved_occupancy << "% achieved"
+              << std::endl;
+  }
+}
+
+void ZeAutotune::add_result(const std::string &test,
+                            const TuneConfig &config) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = "usec";
+  record.parameters = {{"kernel", kernel_name},
+                       {"global", group_size_name(global_size)},
+                       {"group", group_size_name(config.group_size)},
+                       {"cache", cache_config_name(config.cache_config)}};
+  record.stats = ResultStats::from_samples(config.samples);
+  record.value = record.stats.median;
+  record.samples = config.samples;
+  results.add(record);
+
+  record.metric = "occupancy";
+  record.unit = "%";
+  record.value = config.achieved_occupancy;
+  record.stats = ResultStats();
+  record.samples.clear();
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// Runs the kernel with every group size and cache configuration of the
+// sweep and reports the time and estimated occupancy of each, then the
+// fastest one with its speedup over the suggested group size.
+//---------------------------------------------------------------------
+void ZeAutotune::test_autotune(void) {
+  std::array<uint32_t, 3> suggested;
+  SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(
+      kernel, global_size[0], global_size[1], global_size[2], &suggested[0],
+      &suggested[1], &suggested[2]));
+
+  std::cout << std::endl;
+  std::cout << "KERNEL " << kernel_name << " global "
+            << group_size_name(global_size) << std::endl;
+  std::cout << "SIMD " << kernel_properties.maxSubgroupSize
+            << ", shared local memory " << slm_per_group
+            << " bytes per group, private memory "
+            << kernel_properties.privateMemSize << " bytes, spill "
+            << kernel_properties.spillMemSize << " bytes, suggested group "
+            << group_size_name(suggested) << std::endl;
+  if (csv_output) {
+    std::cout << "Label,Group,Cache,Time_(usec),Theoretical_occupancy_(%),"
+                 "Achieved_occupancy_(%)"
+              << std::endl;
+  }
+
+  const std::vector<std::array<uint32_t, 3>> sizes = candidate_group_sizes();
+  if (sizes.empty()) {
+    std::cout << "No group size divides the global size within the device "
+                 "limits"
+              << std::endl;
+    return;
+  }
+
+  bool found = false;
+  TuneConfig fastest;
+  long double suggested_usec = 0;
+  for (auto &size : sizes) {
+    for (auto cache_config : cache_configs) {
+      TuneConfig config;
+      config.group_size = size;
+      config.cache_config = cache_config;
+      if (!occupancy(config) || !measure(config)) {
+        continue;
+      }
+      print_config("Config", config);
+      add_result("Config", config);
+
+      if (!found || config.usec < fastest.usec) {
+        fastest = config;
+        found = true;
+      }
+      if (size == suggested && cache_config == 0) {
+        suggested_usec = config.usec;
+      }
+    }
+  }
+  if (!found) {
+    std::cout << "No configuration could be launched" << std::endl;
+    return;
+  }
+
+  std::cout << std::endl;
+  print_config("Fastest", fastest);
+  if (suggested_usec > 0) {
+    std::cout << "Speedup over the suggested group size: " << std::fixed
+              << std::setprecision(2) << suggested_usec / fastest.usec << "x"
+              << std::endl;
+  }
+  add_result("Fastest", fastest);
+}
+
+int main(int argc, char **argv) {
+  ZeAutotune autotune;
+
+  autotune.parse_arguments(argc, argv);
+  autotune.initialize();
+
+  if (autotune.results.enabled()) {
+    autotune.results.read_metadata(autotune.benchmark->_devices);
+  }
+
+  autotune.test_autotune();
+
+  std::cout << std::endl;
+  return autotune.results.finish();
+}
@@ -8,8 +8,61 @@
 
 #include <chrono>
 #include <level_zero/ze_api.h>
+#include <level_zero/zes_api.h>
+#include "../../common/include/common.hpp"
+#include "../../common/include/host_placement.hpp"
+#include "../../common/include/metric_profiler.hpp"
+#include "results.hpp"
 #include "ze_app.hpp"
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+struct ZeBandwidthStripe {
+  uint32_t ordinal;
+  uint32_t index;
+  /* share of every transfer relative to the other stripes */
+  uint32_t ratio;
+};
+
+/* Running mean and variance of the time per iteration (Welford) */
+struct ZeBandwidthConvergence {
+  uint32_t count = 0;
+  long double mean = 0;
+  long double m2 = 0;
+
+  void add(long double sample);
+  /* coefficient of variation in percent */
+  long double cov() const;
+  /* half width of the 95% confidence interval of the mean in percent */
+  long double confidence_interval() const;
+};
+
+/* One engine of a device copying from its own host thread */
+struct ZeBandwidthStream {
+  uint32_t device_id;
+  ze_command_queue_handle_t queue;
+  ze_command_list_handle_t list;
+  ze_event_handle_t event;
+  void *destination;
+  void *source;
+};
+
+enum class SmallTransferVariant {
+  SYNCHRONOUS = 0,
+  IN_ORDER_PIPELINE,
+  HOST_POLLED
+};
+
+enum class SharedMigrationVariant {
+  HOST_TO_DEVICE_UNHINTED = 0,
+  HOST_TO_DEVICE_PREFETCH,
+  HOST_TO_DEVICE_ADVISE,
+  DEVICE_RESIDENT,
+  DEVICE_TO_HOST
+};
+
 class ZeBandwidth {
 public:
   ZeBandwidth();
@@ -18,19 +71,48 @@ public:
   void test_host2device(void);
   void test_device2host(void);
   void test_bidir(void);
+  void test_striped(void);
+  void test_small_latency(void);
+  void test_shared_migration(void);
+  void test_region_copy(void);
+  void test_fill(void);
+  void test_compression(void);
   void ze_bandwidth_query_engines();
+  void find_numa_nodes();
 
   std::vector<size_t> transfer_size;
   std::vector<uint32_t> device_ids{};
   size_t transfer_lower_limit = 1;
   size_t transfer_upper_limit = (1 << 28);
   bool verify = false;
+  /* with verify, read destinations back to the host instead of comparing
+   * device checksums */
+  bool verify_on_host = false;
   bool run_host2dev = true;
   bool run_dev2host = true;
   bool run_bidirectional = false;
+  bool run_small_latency = false;
+  bool run_shared_migration = false;
+  bool run_region_copy = false;
+  bool run_fill = false;
+  bool run_compression = false;
   bool use_immediate_command_list = false;
+  /* submit every device and engine from a pinned host thread of its own */
+  bool threaded_submission = false;
   uint32_t number_iterations = 500;
   uint32_t warmup_iterations = 10;
+  /* adaptive mode: stop once the CoV in percent of the time per
+   * iteration drops to cov_target or after time_budget_msec per size,
+   * with number_iterations as the upper bound; 0 disables either */
+  long double cov_target = 0;
+  uint32_t time_budget_msec = 0;
+  /* iterations run by the last transfer size */
+  uint32_t measured_iterations = 0;
+  ZeBandwidthConvergence convergence;
+  /* With --results, time of every timed iteration of a size by device,
+   * and of the slowest device, which add_results turns into samples */
+  std::vector<std::vector<long double>> iteration_nsec;
+  std::vector<long double> slowest_iteration_nsec;
   bool query_engines = false;
   bool enable_fixed_ordinal_index = false;
   uint32_t command_queue_group_ordinal = 0;
@@ -38,7 +120,21 @@ public:
   uint32_t command_queue_group_ordinal1 = 0;
   uint32_t command_queue_index1 = 0;
   bool csv_output = false;
+  /* --results sinks, which get every h2d/d2h/bidir result */
+  ResultReport results{"ze_bandwidth"};
+  /* place every host buffer on the NUMA node closest to its device */
+  bool numa_aware = false;
+  /* NUMA node of every device from its PCI location, -1 when unknown */
+  std::vector<int> device_numa_node;
+  /* --cpus, --numa-local, --rt-priority and --host-numa-node */
+  HostPlacement placement;
+  /* --metrics streamer on the first device around every transfer size */
+  MetricProfiler metric_profiler;
+  /* engines for the striped test, which runs when not empty */
+  std::vector<ZeBandwidthStripe> stripes;
+  /* event and event1 are kernel timestamp events of the copies */
   ze_event_pool_handle_t event_pool = {};
+  ze_event_pool_handle_t wait_event_pool = {};
   ze_event_handle_t wait_event = {};
 
   std::vector<ze_event_handle_t> event{};
@@ -56,10 +152,13 @@ public:
 
   ZeApp *benchmark;
 
+  bool adaptive() const { return cov_target > 0 || time_budget_msec > 0; }
+
 private:
   void transfer_size_test(size_t size, std::vector<void *> &destination_buffer,
                           std::vector<void *> &source_buffer,
                           std::vector<long double> &device_times_nsec,
+                          std::vector<long double> &copy_times_nsec,
                           long double &total_time_nsec);
   void transfer_bidir_size_test(size_t size,
                                 std::vector<void *> &destination_buffer,
@@ -67,18 +166,92 @@ private:
                                 std::vector<void *> &destination_buffer1,
                                 std::vector<void *> &source_buffer1,
                                 std::vector<long double> &device_times_nsec,
+                                std::vector<long double> &copy_times_nsec,
                                 long double &total_time_nsec);
+  void striped_size_test(uint32_t device_id, size_t size,
+                         void *destination_buffer, void *source_buffer,
+                         std::vector<ze_command_queue_handle_t> &queues,
+                         std::vector<ze_command_list_handle_t> &lists,
+                         std::vector<ze_event_handle_t> &events,
+                         long double &host_time_nsec,
+                         long double &copy_time_nsec);
+  void small_transfer_samples(uint32_t device_id, SmallTransferVariant variant,
+                              void *destination_buffer, void *source_buffer,
+                              size_t size,
+                              SampleTimer<std::micro, TscClock> &timer);
+  void print_latency_distribution(uint32_t device_id, size_t size,
+                                  const std::string &direction_string,
+                                  const char *variant_name,
+                                  SampleTimer<std::micro, TscClock> &timer);
+  void shared_migration_size_test(
+      uint32_t device_id, SharedMigrationVariant variant,
+      ze_command_list_handle_t immediate_list, ze_kernel_handle_t consume,
+      ze_kernel_handle_t produce, uint32_t *partial_sums, size_t size,
+      long double &first_touch_nsec, long double &steady_state_nsec);
+  void region_copy_size_test(uint32_t device_id,
+                             ze_command_queue_handle_t queue,
+                             ze_command_list_handle_t list,
+                             void *destination_buffer, void *source_buffer,
+                             const ze_copy_region_t *region, uint32_t pitch,
+                             uint32_t slice_pitch, size_t bytes,
+                             long double &host_time_nsec,
+                             long double &copy_time_nsec);
+  void fill_size_test(uint32_t device_id, ze_command_queue_handle_t queue,
+                      ze_command_list_handle_t list, void *device_buffer,
+                      const void *pattern, size_t pattern_size, size_t size,
+                      long double &host_time_nsec,
+                      long double &fill_time_nsec);
+  void compression_size_test(uint32_t device_id,
+                             ze_command_queue_handle_t queue,
+                             ze_command_list_handle_t list,
+                             ze_kernel_handle_t kernel,
+                             void *destination_buffer, void *source_buffer,
+                             size_t size, long double &host_time_nsec,
+                             long double &device_time_nsec);
+  void threaded_transfer(size_t buffer_size,
+                         std::vector<ZeBandwidthStream> &streams,
+                         std::vector<long double> &device_times_nsec,
+                         std::vector<long double> &copy_times_nsec,
+                         long double &total_time_nsec);
+  void pin_submission_thread(uint32_t device_id, uint32_t stream_index);
   long double measure_transfer();
+  bool keep_iterating(Timer<std::chrono::nanoseconds::period> &timer);
+  void record_iteration(
+      std::vector<Timer<std::chrono::nanoseconds::period>> &timers);
+  void host_alloc(uint32_t device_id, size_t size, void **ptr);
+  void print_numa_totals(size_t size, long double bytes_per_iteration,
+                         std::vector<long double> &device_times_nsec,
+                         std::vector<long double> &copy_times_nsec);
+  void event_timestamps_nsec(uint32_t device_id, ze_event_handle_t event,
+                             long double &start_nsec, long double &end_nsec);
   void print_results(size_t buffer_size, long double total_bandwidth,
-                     long double total_latency, std::string direction_string);
+                     long double total_latency, long double copy_bandwidth,
+                     long double copy_latency, std::string direction_string);
+  void print_csv_header();
+  void end_metric_window(const std::string &test, size_t buffer_size);
+  void add_results(const std::string &test, const std::string &device,
+                   size_t buffer_size, long double total_bandwidth,
+                   long double total_latency, long double copy_bandwidth,
+                   long double copy_latency);
   void calculate_metrics(long double total_time_nsec, /* Units in nanoseconds */
                          long double total_data_transfer, /* Units in bytes */
                          long double &total_bandwidth,
                          long double &total_latency);
 
+  uint32_t checksum_mismatches(void *destination_buffer, void *source_buffer,
+                               size_t buffer_size);
+
   ze_command_queue_handle_t command_queue_verify{};
   ze_command_list_handle_t command_list_verify{};
+  /* checksum_words and the hashes it writes for a source and a
+   * destination, checksum_work_items each */
+  ze_kernel_handle_t checksum_kernel{};
+  void *checksum_hashes = nullptr;
   std::vector<ze_command_queue_group_properties_t> queueProperties;
+  std::vector<ze_device_properties_t> device_properties;
+#ifdef __linux__
+  std::vector<cpu_set_t> device_local_cpus;
+#endif
 
   void *host_buffer_verify;
   void *host_buffer_verify1;
@@ -0,0 +1,42 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Reads every uint of the buffer once, so that the device touches all of
+// its pages, and writes one partial sum per work item.
+__kernel void consume_shared(__global const uint *input,
+                             __global uint *output, uint count) {
+  uint sum = 0;
+
+  for (uint i = get_global_id(0); i < count; i += get_global_size(0)) {
+    sum += input[i];
+  }
+
+  output[get_global_id(0)] = sum;
+}
+
+// Writes value to every uint of the buffer.
+__kernel void produce_shared(__global uint *output, uint count, uint value) {
+  for (uint i = get_global_id(0); i < count; i += get_global_size(0)) {
+    output[i] = value;
+  }
+}
+
+// XOR hash of the words of a buffer, each mixed with its index so that a
+// corrupted, missing or misplaced word changes the hash. Work item g folds
+// words g, g + global size, ... so that the reads stay coalesced, and
+// writes its hash, which the host compares with that of the source.
+__kernel void checksum_words(__global const uint *data, __global uint *hashes,
+                             uint count) {
+  uint hash = 0;
+
+  for (uint i = get_global_id(0); i < count; i += get_global_size(0)) {
+    hash ^= (data[i] ^ i) * 0x9E3779B1u;
+  }
+
+  hashes[get_global_id(0)] = hash;
+}
@@ -0,0 +1,306 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_bandwidth.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+/* Smaller buffers are not worth compressing, they are skipped */
+static const size_t compression_min = 4096;
+
+static const uint32_t compression_group_size = 256;
+static const uint32_t compression_group_count = 256;
+static const uint32_t compression_work_items =
+    compression_group_size * compression_group_count;
+
+static const char *compression_entropy_names[] = {"zeros", "pattern",
+                                                  "random"};
+
+static const ze_memory_compression_hints_ext_flags_t compression_hints[] = {
+    ZE_MEMORY_COMPRESSION_HINTS_EXT_FLAG_UNCOMPRESSED,
+    ZE_MEMORY_COMPRESSION_HINTS_EXT_FLAG_COMPRESSED};
+static const char *compression_hint_names[] = {"uncompressed", "compressed"};
+
+//---------------------------------------------------------------------
+// Fills the host buffer with data of the given entropy level:
+//   0 -> all zeros
+//   1 -> a 64 byte pattern repeated over the buffer
+//   2 -> random words, which no compression scheme can shrink
+//---------------------------------------------------------------------
+static void fill_entropy(uint32_t entropy, void *buffer, size_t size) {
+  uint8_t *bytes = static_cast<uint8_t *>(buffer);
+  if (entropy == 0) {
+    memset(bytes, 0, size);
+  } else if (entropy == 1) {
+    for (size_t i = 0; i < size; i++) {
+      bytes[i] = static_cast<uint8_t>((i % 64) * 7);
+    }
+  } else {
+    std::mt19937 generator(static_cast<uint32_t>(size));
+    uint32_t *words = static_cast<uint32_t *>(buffer);
+    for (size_t i = 0; i < size / sizeof(uint32_t); i++) {
+      words[i] = generator();
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Times number_iterations executions of one command list on the given
+// queue, which either runs consume_shared over the source when kernel
+// is set, or copies the source to the destination, host time and device
+// time from the kernel timestamps of the event.
+//---------------------------------------------------------------------
+void ZeBandwidth::compression_size_test(
+    uint32_t device_id, ze_command_queue_handle_t queue,
+    ze_command_list_handle_t list, ze_kernel_handle_t kernel,
+    void *destination_buffer, void *source_buffer, size_t size,
+    long double &host_time_nsec, long double &device_time_nsec) {
+  SUCCESS_OR_TERMINATE(
+      zeCommandListAppendEventReset(list, event[device_id]));
+  if (kernel) {
+    uint32_t count = static_cast<uint32_t>(size / sizeof(uint32_t));
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(kernel, 0, sizeof(void *), &source_buffer));
+    SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+        kernel, 1, sizeof(void *), &destination_buffer));
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(kernel, 2, sizeof(count), &count));
+    ze_group_count_t group_count = {compression_group_count, 1, 1};
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        list, kernel, &group_count, event[device_id], 0, nullptr));
+  } else {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+        list, destination_buffer, source_buffer, size, event[device_id], 0,
+        nullptr));
+  }
+  benchmark->commandListClose(list);
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  host_time_nsec = 0;
+  device_time_nsec = 0;
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    timer.start();
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    timer.end();
+
+    if (i >= warmup_iterations) {
+      host_time_nsec += timer.period_minus_overhead();
+      long double start_nsec, end_nsec;
+      event_timestamps_nsec(device_id, event[device_id], start_nsec,
+                            end_nsec);
+      device_time_nsec += end_nsec - start_nsec;
+    }
+  }
+
+  benchmark->commandListReset(list);
+}
+
+//---------------------------------------------------------------------
+// Device bandwidth of device allocations made with the compressed and
+// the uncompressed hint of ZE_extension_memory_compression_hints, over
+// data of three entropy levels:
+//   Read     -> consume_shared reading the hinted buffer
+//   Write    -> a compute engine copy from a plain device buffer into
+//               the hinted one, as the kernel write path
+//   Copy in  -> the same copy on the first copy engine group
+//   Copy out -> a copy engine copy from the hinted buffer to a plain one
+// The copy engine rows are left out on devices without one.
+//---------------------------------------------------------------------
+void ZeBandwidth::test_compression(void) {
+  std::cout << std::endl;
+  std::cout << "MEMORY COMPRESSION HINTS" << std::endl;
+  if (!benchmark->driverHasExtension(ZE_MEMORY_COMPRESSION_HINTS_EXT_NAME)) {
+    std::cout << "Driver does not support "
+              << ZE_MEMORY_COMPRESSION_HINTS_EXT_NAME << ", skipping"
+              << std::endl;
+    return;
+  }
+  if (csv_output) {
+    std::cout << "Entropy,Hint,Transfer_size,Read_BW_(GBPS),"
+                 "Write_BW_(GBPS),Copy_in_BW_(GBPS),Copy_out_BW_(GBPS)"
+              << std::endl;
+  }
+
+  /* the measurements always run number_iterations */
+  measured_iterations = number_iterations;
+
+  for (auto device_id : device_ids) {
+    uint32_t numQueueGroups = 0;
+    benchmark->deviceGetCommandQueueGroupProperties(device_id, &numQueueGroups,
+                                                    nullptr);
+    std::vector<ze_command_queue_group_properties_t> group_properties(
+        numQueueGroups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+    benchmark->deviceGetCommandQueueGroupProperties(
+        device_id, &numQueueGroups, group_properties.data());
+    uint32_t compute_ordinal = numQueueGroups;
+    uint32_t copy_ordinal = numQueueGroups;
+    for (uint32_t ordinal = 0; ordinal < numQueueGroups; ordinal++) {
+      const auto flags = group_properties[ordinal].flags;
+      if (flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+        compute_ordinal = std::min(compute_ordinal, ordinal);
+      } else if (flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY) {
+        copy_ordinal = std::min(copy_ordinal, ordinal);
+      }
+    }
+    if (compute_ordinal == numQueueGroups) {
+      throw std::runtime_error("No compute command queue group found");
+    }
+    const bool has_copy_engine = copy_ordinal < numQueueGroups;
+
+    ze_command_queue_handle_t compute_queue = nullptr;
+    ze_command_list_handle_t compute_list = nullptr;
+    benchmark->commandQueueCreate(device_id, compute_ordinal, 0,
+                                  &compute_queue);
+    benchmark->commandListCreate(device_id, compute_ordinal, &compute_list);
+    ze_command_queue_handle_t copy_queue = nullptr;
+    ze_command_list_handle_t copy_list = nullptr;
+    if (has_copy_engine) {
+      benchmark->commandQueueCreate(device_id, copy_ordinal, 0, &copy_queue);
+      benchmark->commandListCreate(device_id, copy_ordinal, &copy_list);
+    }
+
+    ze_kernel_handle_t consume = nullptr;
+    benchmark->functionCreate(device_id, &consume, "consume_shared");
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetGroupSize(consume, compression_group_size, 1, 1));
+    void *partial_sums = nullptr;
+    benchmark->memoryAlloc(device_id, compression_work_items * sizeof(uint32_t),
+                           &partial_sums);
+
+    for (uint32_t entropy = 0; entropy < 3; entropy++) {
+      if (!csv_output) {
+        std::cout << "-----------------------------------------------------"
+                     "---------------------------\n";
+        std::cout << "Data " << compression_entropy_names[entropy] << "\n";
+      }
+      for (auto size : transfer_size) {
+        if (size < compression_min || size % sizeof(uint32_t)) {
+          continue;
+        }
+        void *host_buffer = nullptr;
+        void *plain_buffer = nullptr;
+        host_alloc(device_id, size, &host_buffer);
+        fill_entropy(entropy, host_buffer, size);
+        benchmark->memoryAlloc(device_id, size, &plain_buffer);
+        SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+            compute_list, plain_buffer, host_buffer, size, nullptr, 0,
+            nullptr));
+        benchmark->commandListClose(compute_list);
+        benchmark->commandQueueExecuteCommandList(compute_queue, 1,
+                                                  &compute_list);
+        benchmark->commandQueueSynchronize(compute_queue);
+        benchmark->commandListReset(compute_list);
+
+        for (uint32_t hint = 0; hint < 2; hint++) {
+          ze_memory_compression_hints_ext_desc_t hint_description = {};
+          hint_description.stype =
+              ZE_STRUCTURE_TYPE_MEMORY_COMPRESSION_HINTS_EXT_DESC;
+          hint_description.flags = compression_hints[hint];
+          ze_device_mem_alloc_desc_t device_description = {};
+          device_description.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+          device_description.pNext = &hint_description;
+          void *hinted_buffer = nullptr;
+          SUCCESS_OR_TERMINATE(zeMemAllocDevice(
+              benchmark->context, &device_description, size, 64,
+              benchmark->_devices[device_id], &hinted_buffer));
+
+          /* The write leaves the data in the hinted buffer for the rest */
+          long double host_time_nsec, write_nsec, read_nsec = 0;
+          long double copy_in_nsec = 0, copy_out_nsec = 0;
+          compression_size_test(device_id, compute_queue, compute_list,
+                                nullptr, hinted_buffer, plain_buffer, size,
+                                host_time_nsec, write_nsec);
+          compression_size_test(device_id, compute_queue, compute_list,
+                                consume, partial_sums, hinted_buffer, size,
+                                host_time_nsec, read_nsec);
+          if (has_copy_engine) {
+            compression_size_test(device_id, copy_queue, copy_list, nullptr,
+                                  hinted_buffer, plain_buffer, size,
+                                  host_time_nsec, copy_in_nsec);
+            compression_size_test(device_id, copy_queue, copy_list, nullptr,
+                                  plain_buffer, hinted_buffer, size,
+                                  host_time_nsec, copy_out_nsec);
+          }
+
+          if (verify) {
+            void *readback = nullptr;
+            host_alloc(device_id, size, &readback);
+            SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+                compute_list, readback, hinted_buffer, size, nullptr, 0,
+                nullptr));
+            benchmark->commandListClose(compute_list);
+            benchmark->commandQueueExecuteCommandList(compute_queue, 1,
+                                                      &compute_list);
+            benchmark->commandQueueSynchronize(compute_queue);
+            benchmark->commandListReset(compute_list);
+            if (memcmp(readback, host_buffer, size)) {
+              std::cout << "ERROR: Compression verification failed for "
+                        << compression_entropy_names[entropy] << " data in "
+                        << compression_hint_names[hint] << " memory at "
+                        << size << " bytes" << std::endl;
+            }
+            benchmark->memoryFree(readback);
+          }
+          benchmark->memoryFree(hinted_buffer);
+
+          const long double bytes =
+              static_cast<long double>(size) * number_iterations;
+          auto gbps = [&](long double nsec) {
+            return nsec > 0 ? bytes / (nsec / 1e9) / ONE_GB : 0;
+          };
+          if (csv_output) {
+            std::cout << compression_entropy_names[entropy] << ","
+                      << compression_hint_names[hint] << "," << size << ","
+                      << std::setprecision(6) << gbps(read_nsec) << ","
+                      << gbps(write_nsec) << "," << gbps(copy_in_nsec) << ","
+                      << gbps(copy_out_nsec) << std::endl;
+          } else {
+            std::cout << "\t[Device " << device_id << " " << std::fixed
+                      << std::setw(10) << size << "] " << std::setw(12)
+                      << compression_hint_names[hint]
+                      << ":  Read = " << std::setw(9)
+                      << std::setprecision(6) << gbps(read_nsec)
+                      << "  Write = " << std::setw(9) << gbps(write_nsec);
+            if (has_copy_engine) {
+              std::cout << "  Copy in = " << std::setw(9)
+                        << gbps(copy_in_nsec) << "  Copy out = "
+                        << std::setw(9) << gbps(copy_out_nsec);
+            }
+            std::cout << " GBPS" << std::endl;
+          }
+        }
+
+        benchmark->memoryFree(plain_buffer);
+        benchmark->memoryFree(host_buffer);
+      }
+    }
+
+    benchmark->memoryFree(partial_sums);
+    benchmark->functionDestroy(consume);
+    if (has_copy_engine) {
+      benchmark->commandListDestroy(copy_list);
+      benchmark->commandQueueDestroy(copy_queue);
+    }
+    benchmark->commandListDestroy(compute_list);
+    benchmark->commandQueueDestroy(compute_queue);
+  }
+  if (!csv_output) {
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+  }
+}
@@ -0,0 +1,163 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_bandwidth.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+/* Largest fill pattern tried, engines may support less */
+static const size_t fill_pattern_max = 128;
+
+//---------------------------------------------------------------------
+// Times number_iterations executions of one command list filling the
+// device buffer with a pattern_size bytes pattern on the given queue,
+// host time and device time from the kernel timestamps of the fill
+// event.
+//---------------------------------------------------------------------
+void ZeBandwidth::fill_size_test(uint32_t device_id,
+                                 ze_command_queue_handle_t queue,
+                                 ze_command_list_handle_t list,
+                                 void *device_buffer, const void *pattern,
+                                 size_t pattern_size, size_t size,
+                                 long double &host_time_nsec,
+                                 long double &fill_time_nsec) {
+  SUCCESS_OR_TERMINATE(
+      zeCommandListAppendEventReset(list, event[device_id]));
+  SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryFill(
+      list, device_buffer, pattern, pattern_size, size, event[device_id], 0,
+      nullptr));
+  benchmark->commandListClose(list);
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  host_time_nsec = 0;
+  fill_time_nsec = 0;
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    timer.start();
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    timer.end();
+
+    if (i >= warmup_iterations) {
+      host_time_nsec += timer.period_minus_overhead();
+      long double start_nsec, end_nsec;
+      event_timestamps_nsec(device_id, event[device_id], start_nsec,
+                            end_nsec);
+      fill_time_nsec += end_nsec - start_nsec;
+    }
+  }
+
+  benchmark->commandListReset(list);
+}
+
+//---------------------------------------------------------------------
+// zeCommandListAppendMemoryFill bandwidth of device memory over pattern
+// sizes from 1 byte up to the largest one of every compute and copy
+// engine group, index 0 of each, and over the transfer sizes, to pick
+// the fastest engine and pattern to clear device memory with.
+//---------------------------------------------------------------------
+void ZeBandwidth::test_fill(void) {
+  long double bandwidth, latency, fill_bandwidth, fill_latency;
+  std::vector<uint8_t> pattern(fill_pattern_max);
+  for (size_t i = 0; i < pattern.size(); i++) {
+    pattern[i] = static_cast<uint8_t>(i);
+  }
+
+  /* the fills always run number_iterations */
+  measured_iterations = number_iterations;
+
+  std::cout << std::endl;
+  std::cout << "DEVICE MEMORY FILL BANDWIDTH" << std::endl;
+  if (csv_output) {
+    std::cout << "Group,Engine,Pattern_size,Transfer_size,Bandwidth_(GBPS),"
+                 "Latency_(usec),Device_Bandwidth_(GBPS),"
+                 "Device_Latency_(usec)"
+              << std::endl;
+  }
+
+  for (auto device_id : device_ids) {
+    uint32_t numQueueGroups = 0;
+    benchmark->deviceGetCommandQueueGroupProperties(device_id, &numQueueGroups,
+                                                    nullptr);
+    std::vector<ze_command_queue_group_properties_t> group_properties(
+        numQueueGroups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+    benchmark->deviceGetCommandQueueGroupProperties(
+        device_id, &numQueueGroups, group_properties.data());
+
+    for (uint32_t ordinal = 0; ordinal < numQueueGroups; ordinal++) {
+      const bool compute = group_properties[ordinal].flags &
+                           ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE;
+      const bool copy = group_properties[ordinal].flags &
+                        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY;
+      if (!compute && !copy) {
+        continue;
+      }
+      const char *engine = compute ? "compute" : "copy";
+      size_t pattern_max = std::min(
+          fill_pattern_max, group_properties[ordinal].maxMemoryFillPatternSize);
+
+      ze_command_queue_handle_t queue = nullptr;
+      ze_command_list_handle_t list = nullptr;
+      benchmark->commandQueueCreate(device_id, ordinal, 0, &queue);
+      benchmark->commandListCreate(device_id, ordinal, &list);
+
+      for (size_t pattern_size = 1; pattern_size <= pattern_max;
+           pattern_size <<= 1) {
+        if (!csv_output) {
+          std::cout << "-----------------------------------------------------"
+                       "---------------------------\n";
+          std::cout << "Group " << ordinal << " (" << engine << ") pattern "
+                    << pattern_size << " bytes\n";
+        }
+        for (auto size : transfer_size) {
+          if (size < pattern_size || size % pattern_size) {
+            continue;
+          }
+          void *device_buffer = nullptr;
+          long double host_time_nsec, fill_time_nsec;
+          benchmark->memoryAlloc(device_id, size, &device_buffer);
+          fill_size_test(device_id, queue, list, device_buffer,
+                         pattern.data(), pattern_size, size, host_time_nsec,
+                         fill_time_nsec);
+          benchmark->memoryFree(device_buffer);
+
+          calculate_metrics(host_time_nsec,
+                            static_cast<long double>(size) * number_iterations,
+                            bandwidth, latency);
+          calculate_metrics(fill_time_nsec,
+                            static_cast<long double>(size) * number_iterations,
+                            fill_bandwidth, fill_latency);
+          if (csv_output) {
+            std::cout << ordinal << "," << engine << "," << pattern_size
+                      << "," << size << "," << std::setprecision(6)
+                      << bandwidth << "," << std::setprecision(2) << latency
+                      << "," << std::setprecision(6) << fill_bandwidth << ","
+                      << std::setprecision(2) << fill_latency << std::endl;
+          } else {
+            print_results(size, bandwidth, latency, fill_bandwidth,
+                          fill_latency,
+                          "\t[Device " + std::to_string(device_id) + " ");
+          }
+        }
+      }
+
+      benchmark->commandListDestroy(list);
+      benchmark->commandQueueDestroy(queue);
+    }
+  }
+  if (!csv_output) {
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+  }
+}
@@ -16,12 +16,52 @@ static const char *usage_str =
     "\n      h2d or H2D                       run only Host-to-Device tests"
     "\n      d2h or D2H                       run only Device-to-Host tests "
     "\n      bidir                            run only bidirectional tests "
-    "\n  -v                       enable verification"
+    "\n      latency                          run only the 8B-64KB latency "
+    "distribution"
+    "\n                                       of synchronous, in-order "
+    "pipelined and"
+    "\n                                       host polled immediate lists"
+    "\n      shared                           run only the shared memory "
+    "migration"
+    "\n                                       test, unhinted and with "
+    "prefetch and"
+    "\n                                       advise hints"
+    "\n      region                           run only the 2D/3D region "
+    "copy sweep"
+    "\n                                       over width, height, depth "
+    "and pitch"
+    "\n      fill                             run only the device memory "
+    "fill test"
+    "\n                                       over pattern sizes on every "
+    "compute and"
+    "\n                                       copy engine group"
+    "\n      compression                      run only the memory "
+    "compression hints"
+    "\n                                       test over zero, pattern and "
+    "random data"
+    "\n  -v                       enable verification, comparing "
+    "checksums of the"
+    "\n                            source and destination computed on the "
+    "device"
     "\n                            [default:  disabled]"
+    "\n  --verify-host            with -v, read every destination back to "
+    "the host"
+    "\n                            and compare it byte by byte instead"
     "\n  -i                       set number of iterations per transfer"
     "\n                            [default:  500]"
     "\n  -w                       set number of warmup iterations"
     "\n                            [default:  10]"
+    "\n  --cov percent            adaptive iterations: stop a transfer size "
+    "once the"
+    "\n                            coefficient of variation of its "
+    "iterations is"
+    "\n                            at most percent, with -i as the maximum "
+    "and the"
+    "\n                            95% confidence interval reported "
+    "(default: off)"
+    "\n  --budget msec            adaptive iterations: stop a transfer size "
+    "after msec"
+    "\n                            of timed iterations (default: off)"
     "\n  -s                       select only one transfer size (bytes) "
     "\n  -sb                      select beginning transfer size (bytes)"
     "\n                            [default:  1]"
@@ -29,7 +69,13 @@ static const char *usage_str =
     "\n                            [default: 2^30]"
     "\n  -q                       query for number of engines available"
     "\n  -d                       comma separated list of devices for "
-    "\n                            parallel h2d/d2h tests (default: 0)"
+    "\n                            parallel h2d/d2h tests, or all "
+    "(default: 0)"
+    "\n  --numa                   allocate the host buffer of every device "
+    "on the"
+    "\n                            NUMA node closest to it and report the "
+    "aggregate"
+    "\n                            of every node (default: disabled)"
     "\n  -g, group                select engine group (default: 0)."
     "\n                            when using bidir tests, a comma-separated "
     "list "
@@ -40,9 +86,29 @@ static const char *usage_str =
     "list "
     "\n                            of engine groups may be passed, for h2d and "
     "d2h"
+    "\n  --stripe list            also stripe every h2d/d2h transfer "
+    "across the"
+    "\n                            comma separated engines group.index[:ratio]"
+    "\n                            and report the aggregate, e.g. "
+    "1.0:2,2.0,2.1"
+    "\n                            (ratio default: 1)"
     "\n  --immediate              use immediate command lists (default: "
     "disabled)"
+    "\n  --threads                submit the h2d/d2h/bidir copies of every "
+    "device and"
+    "\n                            engine from a pinned host thread of its "
+    "own, all"
+    "\n                            starting together (default: disabled)"
     "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the h2d/d2h/bidir results to "
+    "the comma"
+    "\n                            separated sinks console, csv, csv:file, "
+    "json:file,"
+    "\n                            gate:dir and baseline:dir, with the "
+    "driver and"
+    "\n                            device metadata; gate:dir exits with 1 on "
+    "a"
+    "\n                            regression against the baseline in dir"
     "\n  -h, --help               display help message"
     "\n";
 
@@ -76,15 +142,31 @@ int ZeBandwidth::parse_arguments(int argc, char **argv) {
 
   for (int i = 1; i < argc; i++) {
     if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
-      std::cout << usage_str;
+      std::cout << usage_str << "\n Host placement options:"
+                << HostPlacement::usage() << "\n Metric options:"
+                << MetricProfiler::usage() << "\n";
       exit(0);
+    } else if (placement.parse_option(argc, argv, i)) {
+    } else if (metric_profiler.parse_option(argc, argv, i)) {
     } else if (strcmp(argv[i], "-v") == 0) {
       verify = true;
+    } else if (strcmp(argv[i], "--verify-host") == 0) {
+      verify_on_host = true;
     } else if (strcmp(argv[i], "-i") == 0) {
       if ((i + 1) < argc) {
         number_iterations = sanitize_ulong(argv[i + 1]);
         i++;
       }
+    } else if (strcmp(argv[i], "--cov") == 0) {
+      if ((i + 1) < argc) {
+        cov_target = strtod(argv[i + 1], nullptr);
+        i++;
+      }
+    } else if (strcmp(argv[i], "--budget") == 0) {
+      if ((i + 1) < argc) {
+        time_budget_msec = sanitize_ulong(argv[i + 1]);
+        i++;
+      }
     } else if (strcmp(argv[i], "-w") == 0) {
       if ((i + 1) < argc) {
         warmup_iterations = sanitize_ulong(argv[i + 1]);
@@ -130,8 +212,49 @@ int ZeBandwidth::parse_arguments(int argc, char **argv) {
       i++;
     } else if ((strcmp(argv[i], "--csv") == 0)) {
       csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0)) {
+      if ((i + 1) >= argc || !results.add_sinks(argv[i + 1])) {
+        std::cout << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "--stripe") == 0)) {
+      if ((i + 1) >= argc) {
+        std::cout << usage_str;
+        exit(-1);
+      }
+      std::string stripes_string = argv[i + 1];
+      size_t start = 0;
+      while (start <= stripes_string.length()) {
+        size_t end = stripes_string.find(',', start);
+        if (end == std::string::npos) {
+          end = stripes_string.length();
+        }
+        std::string stripe_string = stripes_string.substr(start, end - start);
+        ZeBandwidthStripe stripe = {0, 0, 1};
+        char *next = nullptr;
+        stripe.ordinal = strtoul(stripe_string.c_str(), &next, 10);
+        if (!isdigit(stripe_string[0]) || *next != '.' ||
+            !isdigit(next[1])) {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+        stripe.index = strtoul(next + 1, &next, 10);
+        if (*next == ':') {
+          stripe.ratio = strtoul(next + 1, &next, 10);
+        }
+        if (*next != '\0' || stripe.ratio == 0) {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+        stripes.push_back(stripe);
+        start = end + 1;
+      }
+      i++;
     } else if ((strcmp(argv[i], "--immediate") == 0)) {
       use_immediate_command_list = true;
+    } else if ((strcmp(argv[i], "--threads") == 0)) {
+      threaded_submission = true;
     } else if ((strcmp(argv[i], "-n") == 0)) {
       enable_fixed_ordinal_index = true;
       std::string queues_string = argv[i + 1];
@@ -151,6 +274,15 @@ int ZeBandwidth::parse_arguments(int argc, char **argv) {
         command_queue_index1 = command_queue_index;
       }
       i++;
+    } else if ((strcmp(argv[i], "--numa") == 0)) {
+      numa_aware = true;
+    } else if (strcmp(argv[i], "-d") == 0 && (i + 1) < argc &&
+               strcmp(argv[i + 1], "all") == 0) {
+      for (uint32_t device_id = 0; device_id < benchmark->_devices.size();
+           device_id++) {
+        device_ids.push_back(device_id);
+      }
+      i++;
     } else if (strcmp(argv[i], "-d") == 0) {
       std::string list_device_ids_string = argv[i + 1];
       const std::string comma = ",";
@@ -194,6 +326,36 @@ int ZeBandwidth::parse_arguments(int argc, char **argv) {
         run_dev2host = false;
         run_bidirectional = true;
         i++;
+      } else if ((strcmp(argv[i + 1], "latency") == 0)) {
+        run_host2dev = false;
+        run_dev2host = false;
+        run_bidirectional = false;
+        run_small_latency = true;
+        i++;
+      } else if ((strcmp(argv[i + 1], "shared") == 0)) {
+        run_host2dev = false;
+        run_dev2host = false;
+        run_bidirectional = false;
+        run_shared_migration = true;
+        i++;
+      } else if ((strcmp(argv[i + 1], "region") == 0)) {
+        run_host2dev = false;
+        run_dev2host = false;
+        run_bidirectional = false;
+        run_region_copy = true;
+        i++;
+      } else if ((strcmp(argv[i + 1], "fill") == 0)) {
+        run_host2dev = false;
+        run_dev2host = false;
+        run_bidirectional = false;
+        run_fill = true;
+        i++;
+      } else if ((strcmp(argv[i + 1], "compression") == 0)) {
+        run_host2dev = false;
+        run_dev2host = false;
+        run_bidirectional = false;
+        run_compression = true;
+        i++;
       } else {
         std::cout << usage_str;
         exit(-1);
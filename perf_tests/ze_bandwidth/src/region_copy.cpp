@@ -0,0 +1,198 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_bandwidth.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+/* Row widths in bytes, rows and slices of the copied sub-rectangles */
+static const uint32_t region_widths[] = {64, 512, 4096};
+static const uint32_t region_heights[] = {64, 1024};
+static const uint32_t region_depths[] = {1, 8};
+/* Bytes of padding added to every row of the pitched surfaces */
+static const uint32_t region_row_paddings[] = {0, 64, 4096};
+
+//---------------------------------------------------------------------
+// Times number_iterations executions of one command list holding a
+// single copy on the selected engine, host time and device time from the
+// kernel timestamps of the copy event. With region set, the copy is a
+// region copy between two surfaces of equal row and slice pitch,
+// otherwise a linear copy of bytes.
+//---------------------------------------------------------------------
+void ZeBandwidth::region_copy_size_test(
+    uint32_t device_id, ze_command_queue_handle_t queue,
+    ze_command_list_handle_t list, void *destination_buffer,
+    void *source_buffer, const ze_copy_region_t *region, uint32_t pitch,
+    uint32_t slice_pitch, size_t bytes, long double &host_time_nsec,
+    long double &copy_time_nsec) {
+  SUCCESS_OR_TERMINATE(
+      zeCommandListAppendEventReset(list, event[device_id]));
+  if (region) {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopyRegion(
+        list, destination_buffer, region, pitch, slice_pitch, source_buffer,
+        region, pitch, slice_pitch, event[device_id], 0, nullptr));
+  } else {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+        list, destination_buffer, source_buffer, bytes, event[device_id], 0,
+        nullptr));
+  }
+  benchmark->commandListClose(list);
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  host_time_nsec = 0;
+  copy_time_nsec = 0;
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    timer.start();
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    timer.end();
+
+    if (i >= warmup_iterations) {
+      host_time_nsec += timer.period_minus_overhead();
+      long double start_nsec, end_nsec;
+      event_timestamps_nsec(device_id, event[device_id], start_nsec,
+                            end_nsec);
+      copy_time_nsec += end_nsec - start_nsec;
+    }
+  }
+
+  benchmark->commandListReset(list);
+}
+
+//---------------------------------------------------------------------
+// Region copy sweep over row width, rows, slices and row pitch of
+// pitched sub-rectangles between host and device, each next to a linear
+// copy of the same bytes to show what the copy engine loses on the non
+// contiguous transfer. Shapes whose copied bytes are outside of the
+// -sb/-se range are skipped.
+//---------------------------------------------------------------------
+void ZeBandwidth::test_region_copy(void) {
+  long double bandwidth, latency, copy_bandwidth, copy_latency;
+  long double linear_bandwidth, linear_copy_bandwidth;
+
+  /* the region copies always run number_iterations */
+  measured_iterations = number_iterations;
+
+  std::cout << std::endl;
+  std::cout << "REGION COPY BANDWIDTH" << std::endl;
+  if (csv_output) {
+    std::cout << "Direction,Width_(bytes),Height,Depth,Pitch_(bytes),"
+                 "Transfer_size,Bandwidth_(GBPS),Device_Bandwidth_(GBPS),"
+                 "Linear_Bandwidth_(GBPS),Linear_Device_Bandwidth_(GBPS)"
+              << std::endl;
+  }
+
+  for (auto device_id : device_ids) {
+    ze_command_queue_handle_t queue = nullptr;
+    ze_command_list_handle_t list = nullptr;
+    benchmark->commandQueueCreate(device_id, command_queue_group_ordinal,
+                                  command_queue_index, &queue);
+    benchmark->commandListCreate(device_id, command_queue_group_ordinal,
+                                 &list);
+
+    for (uint32_t direction = 0; direction < 2; direction++) {
+      const bool to_device = (direction == 0);
+      const std::string direction_string =
+          to_device ? "Host->Device" : "Device->Host";
+      if (!csv_output) {
+        std::cout << "-----------------------------------------------------"
+                     "---------------------------\n";
+        std::cout << direction_string << " region copy\n";
+      }
+
+      for (auto depth : region_depths) {
+        for (auto height : region_heights) {
+          for (auto width : region_widths) {
+            size_t bytes = static_cast<size_t>(width) * height * depth;
+            if (bytes < transfer_lower_limit || bytes > transfer_upper_limit) {
+              continue;
+            }
+            for (auto padding : region_row_paddings) {
+              uint32_t pitch = width + padding;
+              uint32_t slice_pitch = pitch * height;
+              size_t surface_size = static_cast<size_t>(slice_pitch) * depth;
+
+              void *device_buffer = nullptr;
+              void *host_buffer = nullptr;
+              benchmark->memoryAlloc(device_id, surface_size, &device_buffer);
+              host_alloc(device_id, surface_size, &host_buffer);
+              void *destination = to_device ? device_buffer : host_buffer;
+              void *source = to_device ? host_buffer : device_buffer;
+
+              ze_copy_region_t region = {0, 0, 0, width, height, depth};
+              long double host_time_nsec, copy_time_nsec;
+              region_copy_size_test(device_id, queue, list, destination,
+                                    source, &region, pitch, slice_pitch,
+                                    bytes, host_time_nsec, copy_time_nsec);
+              calculate_metrics(host_time_nsec,
+                                static_cast<long double>(bytes) *
+                                    number_iterations,
+                                bandwidth, latency);
+              calculate_metrics(copy_time_nsec,
+                                static_cast<long double>(bytes) *
+                                    number_iterations,
+                                copy_bandwidth, copy_latency);
+
+              region_copy_size_test(device_id, queue, list, destination,
+                                    source, nullptr, 0, 0, bytes,
+                                    host_time_nsec, copy_time_nsec);
+              calculate_metrics(host_time_nsec,
+                                static_cast<long double>(bytes) *
+                                    number_iterations,
+                                linear_bandwidth, latency);
+              calculate_metrics(copy_time_nsec,
+                                static_cast<long double>(bytes) *
+                                    number_iterations,
+                                linear_copy_bandwidth, copy_latency);
+
+              benchmark->memoryFree(device_buffer);
+              benchmark->memoryFree(host_buffer);
+
+              if (csv_output) {
+                std::cout << direction_string << "," << width << ","
+                          << height << "," << depth << "," << pitch << ","
+                          << bytes << "," << std::setprecision(6)
+                          << bandwidth << "," << copy_bandwidth << ","
+                          << linear_bandwidth << "," << linear_copy_bandwidth
+                          << std::endl;
+              } else {
+                std::string shape = std::to_string(width) + "x" +
+                                    std::to_string(height) + "x" +
+                                    std::to_string(depth) + " pitch " +
+                                    std::to_string(pitch);
+                std::cout << "\t[Device " << device_id << " " << std::fixed
+                          << std::setw(24) << shape
+                          << "]:  BW = " << std::setw(9)
+                          << std::setprecision(6) << bandwidth
+                          << " GBPS  Device BW = " << std::setw(9)
+                          << copy_bandwidth << " GBPS  Linear Device BW = "
+                          << std::setw(9) << linear_copy_bandwidth
+                          << " GBPS  Efficiency = " << std::setw(6)
+                          << std::setprecision(2)
+                          << 100 * copy_bandwidth / linear_copy_bandwidth
+                          << " %" << std::endl;
+              }
+            }
+          }
+        }
+      }
+    }
+
+    benchmark->commandListDestroy(list);
+    benchmark->commandQueueDestroy(queue);
+  }
+  if (!csv_output) {
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+  }
+}
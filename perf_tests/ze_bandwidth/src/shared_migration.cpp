@@ -0,0 +1,286 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_bandwidth.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+/* Shared allocations migrate by pages, smaller transfers are skipped */
+static const size_t shared_migration_min = 4096;
+
+static const uint32_t shared_group_size = 256;
+static const uint32_t shared_group_count = 256;
+static const uint32_t shared_work_items =
+    shared_group_size * shared_group_count;
+
+static const char *shared_migration_variant_names[] = {
+    "Host->Device unhinted", "Host->Device prefetch", "Host->Device advise",
+    "Device resident", "Device->Host unhinted"};
+
+//---------------------------------------------------------------------
+// Looks up the first command queue group of the device that can run
+// kernels.
+//---------------------------------------------------------------------
+static uint32_t compute_ordinal(ZeApp *benchmark, uint32_t device_id) {
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> properties(
+      num_queue_groups);
+  for (auto &property : properties) {
+    property.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES;
+    property.pNext = nullptr;
+  }
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  properties.data());
+  for (uint32_t i = 0; i < num_queue_groups; i++) {
+    if (properties[i].flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      return i;
+    }
+  }
+  throw std::runtime_error("No compute command queue group found");
+}
+
+//---------------------------------------------------------------------
+// Times the migration of one freshly allocated shared buffer between
+// host and device, on a synchronous immediate list of a compute engine:
+//   HOST_TO_DEVICE_* -> the host writes the buffer, then consume_shared
+//                       reads it on the device, timed with the host
+//                       writes left out. PREFETCH appends a prefetch
+//                       of the buffer ahead of the kernel, ADVISE sets
+//                       the device as preferred location once.
+//   DEVICE_RESIDENT -> consume_shared reads the buffer again without
+//                      host access in between, as the no migration
+//                      reference.
+//   DEVICE_TO_HOST -> produce_shared writes the buffer on the device,
+//                     then the host reads it, timed around the reads.
+// The first access to the fresh allocation is returned on its own as the
+// first touch time, the mean of the iterations after the warmup as the
+// steady state one.
+//---------------------------------------------------------------------
+void ZeBandwidth::shared_migration_size_test(
+    uint32_t device_id, SharedMigrationVariant variant,
+    ze_command_list_handle_t immediate_list, ze_kernel_handle_t consume,
+    ze_kernel_handle_t produce, uint32_t *partial_sums, size_t size,
+    long double &first_touch_nsec, long double &steady_state_nsec) {
+  ze_device_mem_alloc_desc_t device_description = {};
+  device_description.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  ze_host_mem_alloc_desc_t host_description = {};
+  host_description.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
+
+  void *shared_buffer = nullptr;
+  SUCCESS_OR_TERMINATE(zeMemAllocShared(
+      benchmark->context, &device_description, &host_description, size, 64,
+      benchmark->_devices[device_id], &shared_buffer));
+
+  uint32_t count = static_cast<uint32_t>(size / sizeof(uint32_t));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(consume, 0, sizeof(void *), &shared_buffer));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(consume, 1, sizeof(void *), &partial_sums));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(consume, 2, sizeof(count), &count));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(produce, 0, sizeof(void *), &shared_buffer));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(produce, 1, sizeof(count), &count));
+
+  ze_group_count_t group_count = {shared_group_count, 1, 1};
+  auto launch = [&](ze_kernel_handle_t kernel) {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        immediate_list, kernel, &group_count, nullptr, 0, nullptr));
+  };
+
+  /* The first touch starts from pages placed where the data came from */
+  if (variant == SharedMigrationVariant::DEVICE_TO_HOST) {
+    uint32_t value = 0;
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(produce, 2, sizeof(value), &value));
+    launch(produce);
+  } else {
+    memset(shared_buffer, 0, size);
+  }
+  if (variant == SharedMigrationVariant::HOST_TO_DEVICE_ADVISE) {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemAdvise(
+        immediate_list, benchmark->_devices[device_id], shared_buffer, size,
+        ZE_MEMORY_ADVICE_SET_PREFERRED_LOCATION));
+  }
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  volatile uint32_t host_sum = 0;
+  first_touch_nsec = 0;
+  steady_state_nsec = 0;
+
+  for (uint32_t i = 0; i < 1 + warmup_iterations + number_iterations; i++) {
+    uint32_t value = i & 0xff;
+    if (i > 0) {
+      switch (variant) {
+      case SharedMigrationVariant::DEVICE_RESIDENT:
+        break;
+      case SharedMigrationVariant::DEVICE_TO_HOST:
+        value |= value << 8;
+        value |= value << 16;
+        SUCCESS_OR_TERMINATE(
+            zeKernelSetArgumentValue(produce, 2, sizeof(value), &value));
+        launch(produce);
+        break;
+      default:
+        memset(shared_buffer, value, size);
+        break;
+      }
+    }
+
+    timer.start();
+    if (variant == SharedMigrationVariant::DEVICE_TO_HOST) {
+      uint32_t sum = 0;
+      for (uint32_t j = 0; j < count; j++) {
+        sum += static_cast<uint32_t *>(shared_buffer)[j];
+      }
+      host_sum = sum;
+    } else {
+      if (variant == SharedMigrationVariant::HOST_TO_DEVICE_PREFETCH) {
+        SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryPrefetch(
+            immediate_list, shared_buffer, size));
+      }
+      launch(consume);
+    }
+    timer.end();
+
+    if (i == 0) {
+      first_touch_nsec = timer.period_minus_overhead();
+    } else if (i > warmup_iterations) {
+      steady_state_nsec += timer.period_minus_overhead();
+    }
+  }
+  steady_state_nsec /= number_iterations;
+
+  if (verify && variant != SharedMigrationVariant::DEVICE_TO_HOST) {
+    uint32_t value = (number_iterations + warmup_iterations) & 0xff;
+    if (variant == SharedMigrationVariant::DEVICE_RESIDENT) {
+      value = 0;
+    }
+    uint32_t expected = count * (value * 0x01010101u);
+    uint32_t sum = 0;
+    for (uint32_t j = 0; j < shared_work_items; j++) {
+      sum += partial_sums[j];
+    }
+    if (sum != expected) {
+      std::cout << "ERROR: Shared migration verification failed for "
+                << shared_migration_variant_names[static_cast<int>(variant)]
+                << " at " << size << " bytes" << std::endl;
+    }
+  }
+  (void)host_sum;
+
+  benchmark->memoryFree(shared_buffer);
+}
+
+//---------------------------------------------------------------------
+// First touch and steady state migration bandwidth of shared
+// allocations between host and device, with and without prefetch and
+// memory advise hints, with kernels of ze_bandwidth.spv touching the
+// data on the device.
+//---------------------------------------------------------------------
+void ZeBandwidth::test_shared_migration(void) {
+  std::cout << std::endl;
+  std::cout << "SHARED MEMORY MIGRATION" << std::endl;
+  if (csv_output) {
+    std::cout << "Variant,Transfer_size,First_touch_BW_(GBPS),"
+                 "First_touch_latency_(usec),Steady_state_BW_(GBPS),"
+                 "Steady_state_latency_(usec)"
+              << std::endl;
+  }
+
+  for (auto device_id : device_ids) {
+    ze_command_queue_desc_t command_queue_description{};
+    command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+    command_queue_description.pNext = nullptr;
+    command_queue_description.ordinal = compute_ordinal(benchmark, device_id);
+    command_queue_description.index = 0;
+    command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
+
+    ze_command_list_handle_t immediate_list = nullptr;
+    SUCCESS_OR_TERMINATE(zeCommandListCreateImmediate(
+        benchmark->context, benchmark->_devices[device_id],
+        &command_queue_description, &immediate_list));
+
+    ze_kernel_handle_t consume = nullptr;
+    ze_kernel_handle_t produce = nullptr;
+    benchmark->functionCreate(device_id, &consume, "consume_shared");
+    benchmark->functionCreate(device_id, &produce, "produce_shared");
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetGroupSize(consume, shared_group_size, 1, 1));
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetGroupSize(produce, shared_group_size, 1, 1));
+
+    ze_device_mem_alloc_desc_t device_description = {};
+    device_description.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+    ze_host_mem_alloc_desc_t host_description = {};
+    host_description.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
+    void *partial_sums = nullptr;
+    SUCCESS_OR_TERMINATE(zeMemAllocShared(
+        benchmark->context, &device_description, &host_description,
+        shared_work_items * sizeof(uint32_t), 64,
+        benchmark->_devices[device_id], &partial_sums));
+
+    for (uint32_t v = 0; v < 5; v++) {
+      auto variant = static_cast<SharedMigrationVariant>(v);
+      if (!csv_output) {
+        std::cout << "-----------------------------------------------------"
+                     "---------------------------\n";
+        std::cout << shared_migration_variant_names[v] << "\n";
+      }
+      for (auto size : transfer_size) {
+        if (size < shared_migration_min) {
+          continue;
+        }
+        long double first_touch_nsec = 0;
+        long double steady_state_nsec = 0;
+        shared_migration_size_test(
+            device_id, variant, immediate_list, consume, produce,
+            static_cast<uint32_t *>(partial_sums), size, first_touch_nsec,
+            steady_state_nsec);
+
+        long double first_touch_bw = size / (first_touch_nsec / 1e9) / ONE_GB;
+        long double steady_state_bw =
+            size / (steady_state_nsec / 1e9) / ONE_GB;
+        if (csv_output) {
+          std::cout << shared_migration_variant_names[v] << "," << size << ","
+                    << std::setprecision(6) << first_touch_bw << ","
+                    << std::setprecision(2) << first_touch_nsec / 1e3 << ","
+                    << std::setprecision(6) << steady_state_bw << ","
+                    << std::setprecision(2) << steady_state_nsec / 1e3
+                    << std::endl;
+        } else {
+          std::cout << "\t[Device " << device_id << " " << std::fixed
+                    << std::setw(10) << size
+                    << "]:  First touch BW = " << std::setw(9)
+                    << std::setprecision(6) << first_touch_bw
+                    << " GBPS  Steady BW = " << std::setw(9)
+                    << steady_state_bw << " GBPS  Steady Latency = "
+                    << std::setw(9) << std::setprecision(2)
+                    << steady_state_nsec / 1e3 << " usec" << std::endl;
+        }
+      }
+    }
+
+    benchmark->memoryFree(partial_sums);
+    benchmark->functionDestroy(consume);
+    benchmark->functionDestroy(produce);
+    SUCCESS_OR_TERMINATE(zeCommandListDestroy(immediate_list));
+  }
+  if (!csv_output) {
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+  }
+}
@@ -0,0 +1,179 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_bandwidth.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+/* Copies submitted per sample by the in-order pipeline variant */
+static const uint32_t pipeline_depth = 16;
+
+static const size_t small_transfer_min = 8;
+static const size_t small_transfer_max = 64 * 1024;
+
+static const char *small_transfer_variant_names[] = {
+    "synchronous", "in-order pipeline", "host polled"};
+
+//---------------------------------------------------------------------
+// Times number_iterations small copies on an immediate command list of
+// the selected engine, one sample in microseconds per copy, read from
+// the TSC with the timer overhead calibrated over many reads:
+//   SYNCHRONOUS -> synchronous list, the append returns on completion
+//   IN_ORDER_PIPELINE -> in-order asynchronous list, pipeline_depth
+//                        copies with only the last one signaling an
+//                        event, sample is the time per copy
+//   HOST_POLLED -> asynchronous list, the host spins on
+//                  zeEventQueryStatus instead of blocking
+//---------------------------------------------------------------------
+void ZeBandwidth::small_transfer_samples(
+    uint32_t device_id, SmallTransferVariant variant, void *destination_buffer,
+    void *source_buffer, size_t size,
+    SampleTimer<std::micro, TscClock> &timer) {
+  ze_command_list_handle_t immediate_list = nullptr;
+  benchmark->commandListCreateImmediate(
+      device_id, command_queue_group_ordinal, command_queue_index,
+      (variant == SmallTransferVariant::SYNCHRONOUS)
+          ? ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS
+          : ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+      &immediate_list,
+      (variant == SmallTransferVariant::IN_ORDER_PIPELINE)
+          ? ZE_COMMAND_QUEUE_FLAG_IN_ORDER
+          : 0);
+
+  ze_event_handle_t completion_event = event[device_id];
+
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    if (i == warmup_iterations) {
+      timer.clear();
+    }
+    timer.start();
+    switch (variant) {
+    case SmallTransferVariant::SYNCHRONOUS:
+      SUCCESS_OR_TERMINATE(
+          zeCommandListAppendMemoryCopy(immediate_list, destination_buffer,
+                                        source_buffer, size, nullptr, 0,
+                                        nullptr));
+      break;
+    case SmallTransferVariant::IN_ORDER_PIPELINE:
+      for (uint32_t j = 0; j < pipeline_depth; j++) {
+        benchmark->commandListAppendMemoryCopy(
+            immediate_list, destination_buffer, source_buffer, size,
+            (j + 1 == pipeline_depth) ? completion_event : nullptr, 0,
+            nullptr);
+      }
+      SUCCESS_OR_TERMINATE(
+          zeEventHostSynchronize(completion_event, UINT64_MAX));
+      break;
+    case SmallTransferVariant::HOST_POLLED:
+      SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+          immediate_list, destination_buffer, source_buffer, size,
+          completion_event, 0, nullptr));
+      while (zeEventQueryStatus(completion_event) == ZE_RESULT_NOT_READY) {
+      }
+      break;
+    }
+    timer.stop((variant == SmallTransferVariant::IN_ORDER_PIPELINE)
+                   ? pipeline_depth
+                   : 1);
+
+    if (variant != SmallTransferVariant::SYNCHRONOUS) {
+      SUCCESS_OR_TERMINATE(zeEventHostReset(completion_event));
+    }
+  }
+
+  benchmark->commandListDestroy(immediate_list);
+}
+
+void ZeBandwidth::print_latency_distribution(
+    uint32_t device_id, size_t size, const std::string &direction_string,
+    const char *variant_name, SampleTimer<std::micro, TscClock> &timer) {
+  if (!timer.count()) {
+    return;
+  }
+
+  if (csv_output) {
+    std::cout << direction_string << "," << variant_name << "," << size << ","
+              << std::setprecision(2) << timer.mean() << ","
+              << timer.percentile(50) << "," << timer.percentile(90) << ","
+              << timer.percentile(99) << "," << timer.percentile(100) << ","
+              << timer.stddev() << std::endl;
+  } else {
+    std::cout << "\t[Device " << device_id << " " << std::fixed
+              << std::setw(10) << size << "]:  mean = " << std::setw(8)
+              << std::setprecision(2) << timer.mean()
+              << "  p50 = " << std::setw(8) << timer.percentile(50)
+              << "  p90 = " << std::setw(8) << timer.percentile(90)
+              << "  p99 = " << std::setw(8) << timer.percentile(99)
+              << "  max = " << std::setw(8) << timer.percentile(100)
+              << "  stddev = " << std::setw(8) << timer.stddev() << " usec"
+              << std::endl;
+  }
+}
+
+//---------------------------------------------------------------------
+// Latency distribution of 8B to 64KB copies between host and device
+// memory for three ways of submitting to and waiting on an immediate
+// command list, to pick the submission strategy of small messages.
+//---------------------------------------------------------------------
+void ZeBandwidth::test_small_latency(void) {
+  /* One buffer for all sizes, calibrated once */
+  SampleTimer<std::micro, TscClock> timer(number_iterations);
+
+  std::cout << std::endl;
+  std::cout << "SMALL TRANSFER LATENCY" << std::endl;
+  if (csv_output) {
+    std::cout << "Direction,Variant,Transfer_size,Mean_(usec),P50_(usec),"
+                 "P90_(usec),P99_(usec),Max_(usec),Stddev_(usec)"
+              << std::endl;
+  }
+
+  for (auto device_id : device_ids) {
+    void *device_buffer = nullptr;
+    void *host_buffer = nullptr;
+    benchmark->memoryAlloc(device_id, small_transfer_max, &device_buffer);
+    host_alloc(device_id, small_transfer_max, &host_buffer);
+
+    for (uint32_t direction = 0; direction < 2; direction++) {
+      const bool to_device = (direction == 0);
+      const std::string direction_string =
+          to_device ? "Host->Device" : "Device->Host";
+
+      for (uint32_t v = 0; v < 3; v++) {
+        auto variant = static_cast<SmallTransferVariant>(v);
+        if (!csv_output) {
+          std::cout << "-----------------------------------------------------"
+                       "---------------------------\n";
+          std::cout << direction_string << " "
+                    << small_transfer_variant_names[v] << "\n";
+        }
+        for (size_t size = small_transfer_min; size <= small_transfer_max;
+             size <<= 1) {
+          small_transfer_samples(device_id, variant,
+                                 to_device ? device_buffer : host_buffer,
+                                 to_device ? host_buffer : device_buffer, size,
+                                 timer);
+          print_latency_distribution(device_id, size, direction_string,
+                                     small_transfer_variant_names[v], timer);
+        }
+      }
+    }
+
+    benchmark->memoryFree(device_buffer);
+    benchmark->memoryFree(host_buffer);
+  }
+  if (!csv_output) {
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+  }
+}
@@ -0,0 +1,147 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_bandwidth.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+//---------------------------------------------------------------------
+// Binds the submission thread of a stream to the CPUs local to its
+// device with --numa, otherwise to a CPU of its own.
+//---------------------------------------------------------------------
+void ZeBandwidth::pin_submission_thread(uint32_t device_id,
+                                        uint32_t stream_index) {
+#ifdef __linux__
+  if (numa_aware && CPU_COUNT(&device_local_cpus[device_id])) {
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                           &device_local_cpus[device_id]);
+    return;
+  }
+  uint32_t cpu_count = std::thread::hardware_concurrency();
+  if (cpu_count) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(stream_index % cpu_count, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus);
+  }
+#endif
+}
+
+//---------------------------------------------------------------------
+// Runs the copies of every stream from a host thread of its own, so that
+// the submissions to different devices and engines do not serialize on
+// the host. Each thread does its warmup iterations, then all of them
+// start the timed iterations together once the main thread releases the
+// barrier. The per device host and copy times are the ones of the
+// slowest stream of the device, the total time spans from the release
+// to the end of the last stream.
+//---------------------------------------------------------------------
+void ZeBandwidth::threaded_transfer(size_t buffer_size,
+                                    std::vector<ZeBandwidthStream> &streams,
+                                    std::vector<long double> &device_times_nsec,
+                                    std::vector<long double> &copy_times_nsec,
+                                    long double &total_time_nsec) {
+  std::vector<long double> stream_times_nsec(streams.size(), 0);
+  std::vector<long double> stream_copy_times_nsec(streams.size(), 0);
+  std::atomic<uint32_t> ready{0};
+  std::atomic<bool> go{false};
+
+  /* every stream runs a fixed count, convergence is not tracked */
+  measured_iterations = number_iterations;
+  convergence = ZeBandwidthConvergence();
+
+  auto submit = [&](uint32_t s) {
+    ZeBandwidthStream &stream = streams[s];
+    pin_submission_thread(stream.device_id, s);
+
+    auto copy = [&]() {
+      if (use_immediate_command_list == false) {
+        benchmark->commandQueueExecuteCommandList(stream.queue, 1,
+                                                  &stream.list);
+        benchmark->commandQueueSynchronize(stream.queue);
+      } else {
+        SUCCESS_OR_TERMINATE(zeEventHostReset(stream.event));
+        SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+            stream.list, stream.destination, stream.source, buffer_size,
+            stream.event, 0, nullptr));
+        SUCCESS_OR_TERMINATE(zeEventHostSynchronize(stream.event, UINT64_MAX));
+      }
+    };
+
+    if (use_immediate_command_list == false) {
+      SUCCESS_OR_TERMINATE(
+          zeCommandListAppendEventReset(stream.list, stream.event));
+      SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+          stream.list, stream.destination, stream.source, buffer_size,
+          stream.event, 0, nullptr));
+      benchmark->commandListClose(stream.list);
+    }
+
+    for (uint32_t i = 0; i < warmup_iterations; i++) {
+      copy();
+    }
+
+    ready++;
+    while (!go) {
+      std::this_thread::yield();
+    }
+
+    Timer<std::chrono::nanoseconds::period> timer;
+    timer.start();
+    for (uint32_t i = 0; i < number_iterations; i++) {
+      copy();
+
+      long double start_nsec, end_nsec;
+      event_timestamps_nsec(stream.device_id, stream.event, start_nsec,
+                            end_nsec);
+      stream_copy_times_nsec[s] += end_nsec - start_nsec;
+    }
+    timer.end();
+    stream_times_nsec[s] = timer.period_minus_overhead();
+
+    if (use_immediate_command_list == false) {
+      benchmark->commandListReset(stream.list);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (uint32_t s = 0; s < streams.size(); s++) {
+    threads.emplace_back(submit, s);
+  }
+  while (ready < streams.size()) {
+    std::this_thread::yield();
+  }
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  timer.start();
+  go = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  timer.end();
+  total_time_nsec = timer.period_minus_overhead();
+
+  for (uint32_t s = 0; s < streams.size(); s++) {
+    uint32_t device_id = streams[s].device_id;
+    device_times_nsec[device_id] =
+        std::max(device_times_nsec[device_id], stream_times_nsec[s]);
+    copy_times_nsec[device_id] =
+        std::max(copy_times_nsec[device_id], stream_copy_times_nsec[s]);
+  }
+}
@@ -9,21 +9,45 @@
 #include <level_zero/ze_api.h>
 
 #include "../../common/include/common.hpp"
+#include "trace.hpp"
 #include "ze_app.hpp"
 #include "ze_bandwidth.hpp"
 
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+/* Iterations run in adaptive mode before convergence is checked */
+static const uint32_t adaptive_min_iterations = 10;
+
+/* Work items of checksum_words, each hashing every checksum_work_items-th
+ * word of a buffer */
+static const uint32_t checksum_group_size = 256;
+static const uint32_t checksum_group_count = 64;
+static const uint32_t checksum_work_items =
+    checksum_group_size * checksum_group_count;
 
 ZeBandwidth::ZeBandwidth() {
-  benchmark = new ZeApp();
+  benchmark = new ZeApp("ze_bandwidth.spv");
 
   benchmark->allDevicesInit();
 }
 
 ZeBandwidth::~ZeBandwidth() {
   if (!query_engines) {
+    if (checksum_kernel) {
+      SUCCESS_OR_TERMINATE(zeKernelDestroy(checksum_kernel));
+    }
+    if (checksum_hashes) {
+      benchmark->memoryFree(checksum_hashes);
+    }
     if (command_list_verify) {
       benchmark->commandListDestroy(command_list_verify);
     }
@@ -49,6 +73,7 @@ ZeBandwidth::~ZeBandwidth() {
     }
 
     SUCCESS_OR_TERMINATE(zeEventDestroy(wait_event));
+    SUCCESS_OR_TERMINATE(zeEventPoolDestroy(wait_event_pool));
     SUCCESS_OR_TERMINATE(zeEventPoolDestroy(event_pool));
   }
 
@@ -65,27 +90,360 @@ void ZeBandwidth::calculate_metrics(
 
   total_time_s = total_time_nsec / 1e9;
   total_bandwidth = (total_data_transfer / total_time_s) / ONE_GB;
-  total_latency = total_time_nsec / (1e3 * number_iterations);
+  total_latency = total_time_nsec / (1e3 * measured_iterations);
+}
+
+void ZeBandwidthConvergence::add(long double sample) {
+  count++;
+  long double delta = sample - mean;
+  mean += delta / count;
+  m2 += delta * (sample - mean);
+}
+
+long double ZeBandwidthConvergence::cov() const {
+  if (count < 2 || mean <= 0) {
+    return 0;
+  }
+  return 100 * std::sqrt(m2 / (count - 1)) / mean;
+}
+
+long double ZeBandwidthConvergence::confidence_interval() const {
+  if (count < 2) {
+    return 0;
+  }
+  return 1.96 * cov() / std::sqrt(static_cast<long double>(count));
+}
+
+//---------------------------------------------------------------------
+// Loop condition of the timed iterations, called before every one of
+// them with measured_iterations counting the ones done. Runs
+// number_iterations of them, or in adaptive mode at least
+// adaptive_min_iterations and then stops as soon as the CoV target is
+// met or the time budget of the size is spent.
+//---------------------------------------------------------------------
+bool ZeBandwidth::keep_iterating(
+    Timer<std::chrono::nanoseconds::period> &timer) {
+  if (measured_iterations == 0) {
+    convergence = ZeBandwidthConvergence();
+    iteration_nsec.assign(benchmark->_devices.size(), {});
+    slowest_iteration_nsec.clear();
+  }
+  if (measured_iterations >= number_iterations) {
+    return false;
+  }
+  if (!adaptive() || measured_iterations < adaptive_min_iterations) {
+    return true;
+  }
+  if (time_budget_msec &&
+      timer.has_it_been(static_cast<long long int>(time_budget_msec) *
+                        1000000)) {
+    return false;
+  }
+  return cov_target <= 0 || convergence.cov() > cov_target;
+}
+
+//---------------------------------------------------------------------
+// Adds the time of the slowest device in the iteration to the
+// convergence statistics.
+//---------------------------------------------------------------------
+void ZeBandwidth::record_iteration(
+    std::vector<Timer<std::chrono::nanoseconds::period>> &timers) {
+  long double slowest_nsec = 0;
+  for (auto device_id : device_ids) {
+    const long double nsec = timers[device_id].period_minus_overhead();
+    slowest_nsec = std::max(slowest_nsec, nsec);
+    if (results.enabled()) {
+      iteration_nsec[device_id].push_back(nsec);
+    }
+  }
+  convergence.add(slowest_nsec);
+  if (results.enabled()) {
+    slowest_iteration_nsec.push_back(slowest_nsec);
+  }
 }
 
+//---------------------------------------------------------------------
+// Prints the host observed bandwidth and latency next to the ones of the
+// copy itself, taken from the kernel timestamps of the copy events, and
+// the host overhead between the two latencies.
+//---------------------------------------------------------------------
 void ZeBandwidth::print_results(size_t buffer_size, long double total_bandwidth,
                                 long double total_latency,
+                                long double copy_bandwidth,
+                                long double copy_latency,
                                 std::string direction_string) {
   if (csv_output) {
     std::cout << buffer_size << "," << std::setprecision(6) << total_bandwidth
-              << "," << std::setprecision(2) << total_latency << std::endl;
+              << "," << std::setprecision(2) << total_latency << ","
+              << std::setprecision(6) << copy_bandwidth << ","
+              << std::setprecision(2) << copy_latency << ","
+              << total_latency - copy_latency;
+    if (adaptive()) {
+      std::cout << "," << measured_iterations << "," << convergence.cov()
+                << "," << convergence.confidence_interval();
+    }
+    std::cout << std::endl;
   } else {
     std::cout << direction_string << std::fixed << std::setw(10) << buffer_size
               << "]:  BW = " << std::setw(9) << std::setprecision(6)
               << total_bandwidth << " GBPS  Latency = " << std::setw(9)
-              << std::setprecision(2) << total_latency << " usec" << std::endl;
+              << std::setprecision(2) << total_latency << " usec"
+              << "  Device BW = " << std::setw(9) << std::setprecision(6)
+              << copy_bandwidth << " GBPS  Overhead = " << std::setw(9)
+              << std::setprecision(2) << total_latency - copy_latency
+              << " usec";
+    if (adaptive() && convergence.count) {
+      std::cout << "  Iterations = " << std::setw(6) << measured_iterations
+                << "  95% CI = +-" << std::setw(5) << std::setprecision(2)
+                << convergence.confidence_interval() << " %";
+    }
+    std::cout << std::endl;
+  }
+}
+
+//---------------------------------------------------------------------
+// Adds the results of one transfer size to the --results report, the
+// device being a device index or "all" for the total of the devices.
+// The host bandwidth and latency get the samples of every iteration,
+// the bandwidth ones scaled from the iteration times so that they share
+// the byte count of the total.
+//---------------------------------------------------------------------
+void ZeBandwidth::add_results(const std::string &test,
+                              const std::string &device, size_t buffer_size,
+                              long double total_bandwidth,
+                              long double total_latency,
+                              long double copy_bandwidth,
+                              long double copy_latency) {
+  if (!results.enabled()) {
+    return;
+  }
+
+  ResultRecord record;
+  record.test = test;
+  record.parameters = {{"device", device},
+                       {"size", std::to_string(buffer_size)},
+                       {"iterations", std::to_string(measured_iterations)},
+                       {"immediate", use_immediate_command_list ? "1" : "0"}};
+  const std::pair<const char *, const char *> metrics[] = {
+      {"bandwidth", "GBPS"},
+      {"latency", "usec"},
+      {"device_bandwidth", "GBPS"},
+      {"overhead", "usec"}};
+  const long double values[] = {total_bandwidth, total_latency,
+                                copy_bandwidth, total_latency - copy_latency};
+  const std::vector<long double> &nsec =
+      (device == "all") ? slowest_iteration_nsec
+                        : iteration_nsec[std::stoul(device)];
+  std::vector<long double> latency_samples, bandwidth_samples;
+  for (auto sample : nsec) {
+    if (sample > 0) {
+      latency_samples.push_back(sample / 1e3);
+      bandwidth_samples.push_back(total_bandwidth * total_latency * 1e3 /
+                                  sample);
+    }
+  }
+
+  for (int i = 0; i < 4; i++) {
+    record.metric = metrics[i].first;
+    record.unit = metrics[i].second;
+    record.value = values[i];
+    record.samples = (i == 0)   ? bandwidth_samples
+                     : (i == 1) ? latency_samples
+                                : std::vector<long double>();
+    results.add(record);
+  }
+}
+
+//---------------------------------------------------------------------
+// Closes the --metrics window opened around the transfers of one size,
+// printing its counters and adding them to the --results report as
+// metrics of the test on the first device.
+//---------------------------------------------------------------------
+void ZeBandwidth::end_metric_window(const std::string &test,
+                                    size_t buffer_size) {
+  std::vector<MetricProfiler::Counter> counters;
+  if (!metric_profiler.end(counters) || counters.empty()) {
+    return;
+  }
+  (csv_output ? std::cerr : std::cout)
+      << "\t[Metrics  " << std::setw(10) << buffer_size
+      << "]:  " << MetricProfiler::describe(counters) << std::endl;
+
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.parameters = {{"device", std::to_string(device_ids[0])},
+                       {"size", std::to_string(buffer_size)},
+                       {"iterations", std::to_string(measured_iterations)},
+                       {"immediate", use_immediate_command_list ? "1" : "0"}};
+  for (auto &counter : counters) {
+    record.metric = counter.name;
+    record.unit = counter.unit;
+    record.value = counter.value;
+    results.add(record);
   }
 }
 
+void ZeBandwidth::print_csv_header() {
+  if (csv_output) {
+    std::cout << "Transfer_size,Bandwidth_(GBPS),Latency_(usec),"
+                 "Device_Bandwidth_(GBPS),Device_Latency_(usec),"
+                 "Overhead_(usec)";
+    if (adaptive()) {
+      std::cout << ",Iterations,CoV_(%),CI95_(%)";
+    }
+    std::cout << std::endl;
+  }
+}
+
+//---------------------------------------------------------------------
+// Converts the global kernel timestamps of a signaled copy event to
+// nanoseconds, unwrapping the end timestamp when the counter wrapped.
+//---------------------------------------------------------------------
+void ZeBandwidth::event_timestamps_nsec(uint32_t device_id,
+                                        ze_event_handle_t event,
+                                        long double &start_nsec,
+                                        long double &end_nsec) {
+  ze_kernel_timestamp_result_t timestamp = {};
+  SUCCESS_OR_TERMINATE(zeEventQueryKernelTimestamp(event, &timestamp));
+  Trace::instance().device_span(benchmark->_devices[device_id], "copy",
+                                timestamp);
+
+  const long double timer_resolution_ns =
+      device_properties[device_id].timerResolution;
+  const uint64_t timestamp_max_value =
+      ~(-1L << device_properties[device_id].kernelTimestampValidBits);
+  uint64_t end = timestamp.global.kernelEnd;
+  if (end < timestamp.global.kernelStart) {
+    end += timestamp_max_value + 1;
+  }
+  start_nsec = timestamp.global.kernelStart * timer_resolution_ns;
+  end_nsec = end * timer_resolution_ns;
+}
+
+//---------------------------------------------------------------------
+// Allocates a pinned host buffer for a device. With --numa the buffer is
+// allocated and first touched by a thread bound to the CPUs local to the
+// device, so its pages land on the NUMA node closest to the device.
+//---------------------------------------------------------------------
+void ZeBandwidth::host_alloc(uint32_t device_id, size_t size, void **ptr) {
+#ifdef __linux__
+  if (numa_aware && CPU_COUNT(&device_local_cpus[device_id])) {
+    std::thread allocator([&]() {
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                             &device_local_cpus[device_id]);
+      benchmark->memoryAllocHost(size, ptr);
+      memset(*ptr, 0, size);
+    });
+    allocator.join();
+    return;
+  }
+#endif
+  if (placement.enabled()) {
+    placement.allocate_on_node([&]() {
+      benchmark->memoryAllocHost(size, ptr);
+      memset(*ptr, 0, size);
+    });
+    return;
+  }
+  benchmark->memoryAllocHost(size, ptr);
+}
+
+//---------------------------------------------------------------------
+// With --numa, prints the aggregate of the devices attached to each NUMA
+// node: the bytes of all of them over the slowest one, since they
+// stream at the same time.
+//---------------------------------------------------------------------
+void ZeBandwidth::print_numa_totals(size_t size,
+                                    long double bytes_per_iteration,
+                                    std::vector<long double> &device_times_nsec,
+                                    std::vector<long double> &copy_times_nsec) {
+  if (!numa_aware) {
+    return;
+  }
+
+  std::vector<int> nodes;
+  for (auto device_id : device_ids) {
+    if (std::find(nodes.begin(), nodes.end(), device_numa_node[device_id]) ==
+        nodes.end()) {
+      nodes.push_back(device_numa_node[device_id]);
+    }
+  }
+  std::sort(nodes.begin(), nodes.end());
+
+  for (auto node : nodes) {
+    uint32_t node_devices = 0;
+    long double node_time_nsec = 0, node_copy_time_nsec = 0;
+    for (auto device_id : device_ids) {
+      if (device_numa_node[device_id] == node) {
+        node_devices++;
+        node_time_nsec = std::max(node_time_nsec, device_times_nsec[device_id]);
+        node_copy_time_nsec =
+            std::max(node_copy_time_nsec, copy_times_nsec[device_id]);
+      }
+    }
+
+    long double total_bandwidth, total_latency, copy_bandwidth, copy_latency;
+    calculate_metrics(node_time_nsec,
+                      node_devices * bytes_per_iteration * measured_iterations,
+                      total_bandwidth, total_latency);
+    calculate_metrics(node_copy_time_nsec,
+                      node_devices * bytes_per_iteration * measured_iterations,
+                      copy_bandwidth, copy_latency);
+    print_results(size * node_devices, total_bandwidth, total_latency,
+                  copy_bandwidth, copy_latency,
+                  (node < 0 ? std::string("[Node ?   ")
+                            : "[Node " + std::to_string(node) + "   "));
+  }
+}
+
+// Hashes the source and the destination of a copy on the device with
+// checksum_words and returns the number of hashes that differ, so that
+// verification reads back 2 * checksum_work_items words instead of the
+// whole destination. Every word is mixed with its index, so that a
+// corrupted, missing or misplaced word changes the hash of its work item.
+uint32_t ZeBandwidth::checksum_mismatches(void *destination_buffer,
+                                          void *source_buffer,
+                                          size_t buffer_size) {
+  const uint32_t count = static_cast<uint32_t>(buffer_size / sizeof(uint32_t));
+  uint32_t *hashes = static_cast<uint32_t *>(checksum_hashes);
+  ze_group_count_t group_count = {checksum_group_count, 1, 1};
+
+  void *buffers[] = {source_buffer, destination_buffer};
+  for (uint32_t i = 0; i < 2; i++) {
+    uint32_t *buffer_hashes = hashes + i * checksum_work_items;
+    SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+        checksum_kernel, 0, sizeof(void *), &buffers[i]));
+    SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+        checksum_kernel, 1, sizeof(void *), &buffer_hashes));
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(checksum_kernel, 2, sizeof(count), &count));
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        command_list_verify, checksum_kernel, &group_count, nullptr, 0,
+        nullptr));
+  }
+  benchmark->commandListClose(command_list_verify);
+  benchmark->commandQueueExecuteCommandList(command_queue_verify, 1,
+                                            &command_list_verify);
+  benchmark->commandQueueSynchronize(command_queue_verify);
+  benchmark->commandListReset(command_list_verify);
+
+  uint32_t mismatches = 0;
+  for (uint32_t i = 0; i < checksum_work_items; i++) {
+    if (hashes[i] != hashes[checksum_work_items + i]) {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
 void ZeBandwidth::transfer_size_test(
     size_t size, std::vector<void *> &destination_buffer,
     std::vector<void *> &source_buffer,
-    std::vector<long double> &device_times_nsec, long double &total_time_nsec) {
+    std::vector<long double> &device_times_nsec,
+    std::vector<long double> &copy_times_nsec, long double &total_time_nsec) {
   size_t element_size = sizeof(uint8_t);
   size_t buffer_size = element_size * size;
 
@@ -108,11 +466,24 @@ void ZeBandwidth::transfer_size_test(
     }
   }
 
-  if (use_immediate_command_list == false) {
+  if (threaded_submission) {
+    std::vector<ZeBandwidthStream> streams;
+    for (auto device_id : device_ids) {
+      streams.push_back({device_id, command_queue[device_id],
+                         command_list[device_id], event[device_id],
+                         destination_buffer[device_id],
+                         source_buffer[device_id]});
+    }
+    threaded_transfer(buffer_size, streams, device_times_nsec,
+                      copy_times_nsec, total_time_nsec);
+  } else if (use_immediate_command_list == false) {
     for (auto device_id : device_ids) {
+      SUCCESS_OR_TERMINATE(zeCommandListAppendEventReset(
+          command_list[device_id], event[device_id]));
       SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
           command_list[device_id], destination_buffer[device_id],
-          source_buffer[device_id], buffer_size, nullptr, 1, &wait_event));
+          source_buffer[device_id], buffer_size, event[device_id], 1,
+          &wait_event));
     }
 
     for (auto device_id : device_ids) {
@@ -140,7 +511,8 @@ void ZeBandwidth::transfer_size_test(
         benchmark->_devices.size());
 
     timer.start();
-    for (uint32_t i = 0; i < number_iterations; i++) {
+    for (measured_iterations = 0; keep_iterating(timer);
+         measured_iterations++) {
       for (auto device_id : device_ids) {
         benchmark->commandQueueExecuteCommandList(command_queue[device_id], 1,
                                                   &command_list[device_id]);
@@ -158,7 +530,13 @@ void ZeBandwidth::transfer_size_test(
         timers[device_id].end();
         device_times_nsec[device_id] +=
             timers[device_id].period_minus_overhead();
+
+        long double start_nsec, end_nsec;
+        event_timestamps_nsec(device_id, event[device_id], start_nsec,
+                              end_nsec);
+        copy_times_nsec[device_id] += end_nsec - start_nsec;
       }
+      record_iteration(timers);
 
       SUCCESS_OR_TERMINATE(zeEventHostReset(wait_event));
     }
@@ -195,7 +573,8 @@ void ZeBandwidth::transfer_size_test(
         benchmark->_devices.size());
 
     timer.start();
-    for (uint32_t i = 0; i < number_iterations; i++) {
+    for (measured_iterations = 0; keep_iterating(timer);
+         measured_iterations++) {
       for (auto device_id : device_ids) {
         SUCCESS_OR_TERMINATE(zeEventHostReset(event[device_id]));
         SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
@@ -217,7 +596,13 @@ void ZeBandwidth::transfer_size_test(
         timers[device_id].end();
         device_times_nsec[device_id] +=
             timers[device_id].period_minus_overhead();
+
+        long double start_nsec, end_nsec;
+        event_timestamps_nsec(device_id, event[device_id], start_nsec,
+                              end_nsec);
+        copy_times_nsec[device_id] += end_nsec - start_nsec;
       }
+      record_iteration(timers);
 
       SUCCESS_OR_TERMINATE(zeEventHostReset(wait_event));
     }
@@ -226,7 +611,21 @@ void ZeBandwidth::transfer_size_test(
     total_time_nsec = timer.period_minus_overhead();
   }
 
-  if (verify) {
+  if (verify && !verify_on_host && buffer_size % sizeof(uint32_t) == 0) {
+    uint32_t number_of_errors = 0;
+    for (auto device_id : device_ids) {
+      number_of_errors += checksum_mismatches(
+          destination_buffer[device_id], source_buffer[device_id], buffer_size);
+    }
+
+    benchmark->memoryFree(host_buffer_verify1);
+
+    if (number_of_errors > 0) {
+      throw std::runtime_error("Device checksum verification failed ");
+    } else {
+      std::cout << "Verification successful\n";
+    }
+  } else if (verify) {
     uint32_t number_of_errors = 0;
     benchmark->memoryAllocHost(buffer_size, &host_buffer_verify);
 
@@ -265,17 +664,35 @@ void ZeBandwidth::transfer_bidir_size_test(
     std::vector<void *> &source_buffer,
     std::vector<void *> &destination_buffer1,
     std::vector<void *> &source_buffer1,
-    std::vector<long double> &device_times_nsec, long double &total_time_nsec) {
+    std::vector<long double> &device_times_nsec,
+    std::vector<long double> &copy_times_nsec, long double &total_time_nsec) {
   size_t element_size = sizeof(uint8_t);
   size_t buffer_size = element_size * size;
   long double total_time_s;
   long double total_data_transfer;
 
-  if (use_immediate_command_list == false) {
+  if (threaded_submission) {
+    std::vector<ZeBandwidthStream> streams;
+    for (auto device_id : device_ids) {
+      streams.push_back({device_id, command_queue[device_id],
+                         command_list[device_id], event[device_id],
+                         destination_buffer[device_id],
+                         source_buffer[device_id]});
+      streams.push_back({device_id, command_queue1[device_id],
+                         command_list1[device_id], event1[device_id],
+                         destination_buffer1[device_id],
+                         source_buffer1[device_id]});
+    }
+    threaded_transfer(buffer_size, streams, device_times_nsec,
+                      copy_times_nsec, total_time_nsec);
+  } else if (use_immediate_command_list == false) {
     for (auto device_id : device_ids) {
+      SUCCESS_OR_TERMINATE(zeCommandListAppendEventReset(
+          command_list[device_id], event[device_id]));
       SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
           command_list[device_id], destination_buffer[device_id],
-          source_buffer[device_id], buffer_size, nullptr, 1, &wait_event));
+          source_buffer[device_id], buffer_size, event[device_id], 1,
+          &wait_event));
     }
 
     for (auto device_id : device_ids) {
@@ -283,9 +700,12 @@ void ZeBandwidth::transfer_bidir_size_test(
     }
 
     for (auto device_id : device_ids) {
+      SUCCESS_OR_TERMINATE(zeCommandListAppendEventReset(
+          command_list1[device_id], event1[device_id]));
       SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
           command_list1[device_id], destination_buffer1[device_id],
-          source_buffer1[device_id], buffer_size, nullptr, 1, &wait_event));
+          source_buffer1[device_id], buffer_size, event1[device_id], 1,
+          &wait_event));
     }
 
     for (auto device_id : device_ids) {
@@ -316,7 +736,8 @@ void ZeBandwidth::transfer_bidir_size_test(
         benchmark->_devices.size());
 
     timer.start();
-    for (uint32_t i = 0; i < number_iterations; i++) {
+    for (measured_iterations = 0; keep_iterating(timer);
+         measured_iterations++) {
       for (auto device_id : device_ids) {
         benchmark->commandQueueExecuteCommandList(command_queue1[device_id], 1,
                                                   &command_list1[device_id]);
@@ -337,7 +758,16 @@ void ZeBandwidth::transfer_bidir_size_test(
         timers[device_id].end();
         device_times_nsec[device_id] +=
             timers[device_id].period_minus_overhead();
+
+        long double start_nsec, end_nsec, start1_nsec, end1_nsec;
+        event_timestamps_nsec(device_id, event[device_id], start_nsec,
+                              end_nsec);
+        event_timestamps_nsec(device_id, event1[device_id], start1_nsec,
+                              end1_nsec);
+        copy_times_nsec[device_id] +=
+            std::max(end_nsec, end1_nsec) - std::min(start_nsec, start1_nsec);
       }
+      record_iteration(timers);
 
       SUCCESS_OR_TERMINATE(zeEventHostReset(wait_event));
     }
@@ -382,7 +812,8 @@ void ZeBandwidth::transfer_bidir_size_test(
         benchmark->_devices.size());
 
     timer.start();
-    for (uint32_t i = 0; i < number_iterations; i++) {
+    for (measured_iterations = 0; keep_iterating(timer);
+         measured_iterations++) {
       for (auto device_id : device_ids) {
         SUCCESS_OR_TERMINATE(zeEventHostReset(event[device_id]));
         SUCCESS_OR_TERMINATE(zeEventHostReset(event1[device_id]));
@@ -411,7 +842,16 @@ void ZeBandwidth::transfer_bidir_size_test(
         timers[device_id].end();
         device_times_nsec[device_id] +=
             timers[device_id].period_minus_overhead();
+
+        long double start_nsec, end_nsec, start1_nsec, end1_nsec;
+        event_timestamps_nsec(device_id, event[device_id], start_nsec,
+                              end_nsec);
+        event_timestamps_nsec(device_id, event1[device_id], start1_nsec,
+                              end1_nsec);
+        copy_times_nsec[device_id] +=
+            std::max(end_nsec, end1_nsec) - std::min(start_nsec, start1_nsec);
       }
+      record_iteration(timers);
 
       SUCCESS_OR_TERMINATE(zeEventHostReset(wait_event));
     }
@@ -424,12 +864,12 @@ void ZeBandwidth::transfer_bidir_size_test(
 void ZeBandwidth::test_host2device(void) {
   long double total_bandwidth = 0.0;
   long double total_latency = 0.0;
+  long double copy_bandwidth = 0.0;
+  long double copy_latency = 0.0;
 
   std::cout << std::endl;
   std::cout << "HOST-TO-DEVICE BANDWIDTH AND LATENCY" << std::endl;
-  if (csv_output) {
-    std::cout << "Transfer_size,Bandwidth_(GBPS),Latency_(usec)" << std::endl;
-  }
+  print_csv_header();
 
   for (auto size : transfer_size) {
     long double total_time_nsec = 0;
@@ -437,14 +877,17 @@ void ZeBandwidth::test_host2device(void) {
     for (int i = 0; i < device_times_nsec.size(); i++) {
       device_times_nsec[i] = 0;
     }
+    std::vector<long double> copy_times_nsec(benchmark->_devices.size(), 0);
 
     for (auto device_id : device_ids) {
       benchmark->memoryAlloc(device_id, size, &device_buffers[device_id]);
-      benchmark->memoryAllocHost(size, &host_buffers[device_id]);
+      host_alloc(device_id, size, &host_buffers[device_id]);
     }
 
+    metric_profiler.begin();
     transfer_size_test(size, device_buffers, host_buffers, device_times_nsec,
-                       total_time_nsec);
+                       copy_times_nsec, total_time_nsec);
+    end_metric_window("Host2Device", size);
 
     std::cout << "-----------------------------------------------------"
                  "---------------------------\n";
@@ -454,18 +897,35 @@ void ZeBandwidth::test_host2device(void) {
       benchmark->memoryFree(host_buffers[device_id]);
 
       calculate_metrics(device_times_nsec[device_id],
-                        static_cast<long double>(size * number_iterations),
+                        static_cast<long double>(size * measured_iterations),
                         total_bandwidth, total_latency);
-      print_results(size, total_bandwidth, total_latency,
+      calculate_metrics(copy_times_nsec[device_id],
+                        static_cast<long double>(size * measured_iterations),
+                        copy_bandwidth, copy_latency);
+      print_results(size, total_bandwidth, total_latency, copy_bandwidth,
+                    copy_latency,
                     "\t[Device " + std::to_string(device_id) + " ");
+      add_results("Host2Device", std::to_string(device_id), size,
+                  total_bandwidth, total_latency, copy_bandwidth,
+                  copy_latency);
     }
 
     calculate_metrics(
         total_time_nsec,
-        static_cast<long double>(device_ids.size() * size * number_iterations),
+        static_cast<long double>(device_ids.size() * size *
+                                 measured_iterations),
         total_bandwidth, total_latency);
+    calculate_metrics(
+        *std::max_element(copy_times_nsec.begin(), copy_times_nsec.end()),
+        static_cast<long double>(device_ids.size() * size *
+                                 measured_iterations),
+        copy_bandwidth, copy_latency);
     print_results(size * device_ids.size(), total_bandwidth, total_latency,
-                  "[Total    ");
+                  copy_bandwidth, copy_latency, "[Total    ");
+    add_results("Host2Device", "all", size * device_ids.size(),
+                total_bandwidth, total_latency, copy_bandwidth, copy_latency);
+    print_numa_totals(size, static_cast<long double>(size), device_times_nsec,
+                      copy_times_nsec);
     std::cout << "-----------------------------------------------------"
                  "---------------------------\n";
   }
@@ -474,12 +934,12 @@ void ZeBandwidth::test_host2device(void) {
 void ZeBandwidth::test_device2host(void) {
   long double total_bandwidth = 0.0;
   long double total_latency = 0.0;
+  long double copy_bandwidth = 0.0;
+  long double copy_latency = 0.0;
 
   std::cout << std::endl;
   std::cout << "DEVICE-TO-HOST BANDWIDTH AND LATENCY" << std::endl;
-  if (csv_output) {
-    std::cout << "Transfer_size,Bandwidth_(GBPS),Latency_(usec)" << std::endl;
-  }
+  print_csv_header();
 
   for (auto size : transfer_size) {
     long double total_time_nsec = 0;
@@ -487,14 +947,17 @@ void ZeBandwidth::test_device2host(void) {
     for (int i = 0; i < device_times_nsec.size(); i++) {
       device_times_nsec[i] = 0;
     }
+    std::vector<long double> copy_times_nsec(benchmark->_devices.size(), 0);
 
     for (auto device_id : device_ids) {
-      benchmark->memoryAlloc(size, &device_buffers[device_id]);
-      benchmark->memoryAllocHost(size, &host_buffers[device_id]);
+      benchmark->memoryAlloc(device_id, size, &device_buffers[device_id]);
+      host_alloc(device_id, size, &host_buffers[device_id]);
     }
 
+    metric_profiler.begin();
     transfer_size_test(size, host_buffers, device_buffers, device_times_nsec,
-                       total_time_nsec);
+                       copy_times_nsec, total_time_nsec);
+    end_metric_window("Device2Host", size);
 
     std::cout << "-----------------------------------------------------"
                  "---------------------------\n";
@@ -504,18 +967,35 @@ void ZeBandwidth::test_device2host(void) {
       benchmark->memoryFree(host_buffers[device_id]);
 
       calculate_metrics(device_times_nsec[device_id],
-                        static_cast<long double>(size * number_iterations),
+                        static_cast<long double>(size * measured_iterations),
                         total_bandwidth, total_latency);
-      print_results(size, total_bandwidth, total_latency,
+      calculate_metrics(copy_times_nsec[device_id],
+                        static_cast<long double>(size * measured_iterations),
+                        copy_bandwidth, copy_latency);
+      print_results(size, total_bandwidth, total_latency, copy_bandwidth,
+                    copy_latency,
                     "\t[Device " + std::to_string(device_id) + " ");
+      add_results("Device2Host", std::to_string(device_id), size,
+                  total_bandwidth, total_latency, copy_bandwidth,
+                  copy_latency);
     }
 
     calculate_metrics(
         total_time_nsec,
-        static_cast<long double>(device_ids.size() * size * number_iterations),
+        static_cast<long double>(device_ids.size() * size *
+                                 measured_iterations),
         total_bandwidth, total_latency);
+    calculate_metrics(
+        *std::max_element(copy_times_nsec.begin(), copy_times_nsec.end()),
+        static_cast<long double>(device_ids.size() * size *
+                                 measured_iterations),
+        copy_bandwidth, copy_latency);
     print_results(size * device_ids.size(), total_bandwidth, total_latency,
-                  "[Total    ");
+                  copy_bandwidth, copy_latency, "[Total    ");
+    add_results("Device2Host", "all", size * device_ids.size(),
+                total_bandwidth, total_latency, copy_bandwidth, copy_latency);
+    print_numa_totals(size, static_cast<long double>(size), device_times_nsec,
+                      copy_times_nsec);
     std::cout << "-----------------------------------------------------"
                  "---------------------------\n";
   }
@@ -524,14 +1004,14 @@ void ZeBandwidth::test_device2host(void) {
 void ZeBandwidth::test_bidir(void) {
   long double total_bandwidth = 0.0;
   long double total_latency = 0.0;
+  long double copy_bandwidth = 0.0;
+  long double copy_latency = 0.0;
 
   std::cout << std::endl;
   std::cout
       << "BIDIRECTIONAL HOST-TO-DEVICE/DEVICE-TO-HOST BANDWIDTH AND LATENCY"
       << std::endl;
-  if (csv_output) {
-    std::cout << "Transfer_size,Bandwidth_(GBPS),Latency_(usec)" << std::endl;
-  }
+  print_csv_header();
 
   for (auto size : transfer_size) {
     long double total_time_nsec = 0;
@@ -539,17 +1019,22 @@ void ZeBandwidth::test_bidir(void) {
     for (int i = 0; i < device_times_nsec.size(); i++) {
       device_times_nsec[i] = 0;
     }
+    std::vector<long double> copy_times_nsec(benchmark->_devices.size(), 0);
 
     for (auto device_id : device_ids) {
-      benchmark->memoryAlloc(size, &device_buffers[device_id]);
-      benchmark->memoryAllocHost(size, &host_buffers[device_id]);
-      benchmark->memoryAlloc(size, &device_buffers_bidir[device_id]);
-      benchmark->memoryAllocHost(size, &host_buffers_bidir[device_id]);
+      benchmark->memoryAlloc(device_id, size, &device_buffers[device_id]);
+      host_alloc(device_id, size, &host_buffers[device_id]);
+      benchmark->memoryAlloc(device_id, size,
+                             &device_buffers_bidir[device_id]);
+      host_alloc(device_id, size, &host_buffers_bidir[device_id]);
     }
 
-    transfer_bidir_size_test(size, device_buffers, host_buffers, host_buffers_bidir,
-                             device_buffers_bidir, device_times_nsec,
+    metric_profiler.begin();
+    transfer_bidir_size_test(size, device_buffers, host_buffers,
+                             host_buffers_bidir, device_buffers_bidir,
+                             device_times_nsec, copy_times_nsec,
                              total_time_nsec);
+    end_metric_window("Bidirectional", size);
 
     std::cout << "-----------------------------------------------------"
                  "---------------------------\n";
@@ -561,23 +1046,287 @@ void ZeBandwidth::test_bidir(void) {
       benchmark->memoryFree(host_buffers_bidir[device_id]);
 
       calculate_metrics(device_times_nsec[device_id],
-                        static_cast<long double>(2 * size * number_iterations),
+                        static_cast<long double>(2 * size *
+                                                 measured_iterations),
                         total_bandwidth, total_latency);
-      print_results(size, total_bandwidth, total_latency,
+      calculate_metrics(copy_times_nsec[device_id],
+                        static_cast<long double>(2 * size *
+                                                 measured_iterations),
+                        copy_bandwidth, copy_latency);
+      print_results(size, total_bandwidth, total_latency, copy_bandwidth,
+                    copy_latency,
                     "\t[Device " + std::to_string(device_id) + " ");
+      add_results("Bidirectional", std::to_string(device_id), size,
+                  total_bandwidth, total_latency, copy_bandwidth,
+                  copy_latency);
     }
 
     calculate_metrics(total_time_nsec,
                       static_cast<long double>(device_ids.size() * 2 * size *
-                                               number_iterations),
+                                               measured_iterations),
                       total_bandwidth, total_latency);
+    calculate_metrics(
+        *std::max_element(copy_times_nsec.begin(), copy_times_nsec.end()),
+        static_cast<long double>(device_ids.size() * 2 * size *
+                                 measured_iterations),
+        copy_bandwidth, copy_latency);
     print_results(size * device_ids.size(), total_bandwidth, total_latency,
-                  "[Total    ");
+                  copy_bandwidth, copy_latency, "[Total    ");
+    add_results("Bidirectional", "all", size * device_ids.size(),
+                total_bandwidth, total_latency, copy_bandwidth, copy_latency);
+    print_numa_totals(size, static_cast<long double>(2 * size),
+                      device_times_nsec, copy_times_nsec);
     std::cout << "-----------------------------------------------------"
                  "---------------------------\n";
   }
 }
 
+//---------------------------------------------------------------------
+// Splits one transfer into slices proportional to the stripe ratios and
+// copies every slice on its own engine, all released at once by
+// wait_event. The host time runs from the release until the last engine
+// finished; the copy time spans the earliest start to the latest end of
+// the slice copies.
+//---------------------------------------------------------------------
+void ZeBandwidth::striped_size_test(
+    uint32_t device_id, size_t size, void *destination_buffer,
+    void *source_buffer, std::vector<ze_command_queue_handle_t> &queues,
+    std::vector<ze_command_list_handle_t> &lists,
+    std::vector<ze_event_handle_t> &events, long double &host_time_nsec,
+    long double &copy_time_nsec) {
+  uint64_t ratio_sum = 0;
+  for (auto &stripe : stripes) {
+    ratio_sum += stripe.ratio;
+  }
+
+  std::vector<uint32_t> active;
+  size_t offset = 0;
+  for (uint32_t i = 0; i < stripes.size(); i++) {
+    size_t length = size - offset;
+    if (i + 1 < stripes.size()) {
+      length = static_cast<size_t>(size * stripes[i].ratio / ratio_sum);
+      /* keep the slices cache line aligned */
+      length -= length % 64;
+    }
+    if (length == 0) {
+      continue;
+    }
+    SUCCESS_OR_TERMINATE(zeCommandListAppendEventReset(lists[i], events[i]));
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+        lists[i], static_cast<uint8_t *>(destination_buffer) + offset,
+        static_cast<uint8_t *>(source_buffer) + offset, length, events[i], 1,
+        &wait_event));
+    benchmark->commandListClose(lists[i]);
+    active.push_back(i);
+    offset += length;
+  }
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  host_time_nsec = 0;
+  copy_time_nsec = 0;
+
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    for (auto stripe : active) {
+      benchmark->commandQueueExecuteCommandList(queues[stripe], 1,
+                                                &lists[stripe]);
+    }
+
+    timer.start();
+    SUCCESS_OR_TERMINATE(zeEventHostSignal(wait_event));
+    for (auto stripe : active) {
+      benchmark->commandQueueSynchronize(queues[stripe]);
+    }
+    timer.end();
+
+    if (i >= warmup_iterations) {
+      host_time_nsec += timer.period_minus_overhead();
+
+      long double first_start = 0, last_end = 0;
+      for (uint32_t j = 0; j < active.size(); j++) {
+        long double start_nsec, end_nsec;
+        event_timestamps_nsec(device_id, events[active[j]], start_nsec,
+                              end_nsec);
+        first_start = j ? std::min(first_start, start_nsec) : start_nsec;
+        last_end = j ? std::max(last_end, end_nsec) : end_nsec;
+      }
+      copy_time_nsec += last_end - first_start;
+    }
+
+    SUCCESS_OR_TERMINATE(zeEventHostReset(wait_event));
+  }
+
+  for (auto stripe : active) {
+    benchmark->commandListReset(lists[stripe]);
+  }
+}
+
+//---------------------------------------------------------------------
+// Stripes every host<->device transfer across the engines given with
+// --stripe, for each selected device in turn, and reports the aggregate
+// bandwidth of all the engines.
+//---------------------------------------------------------------------
+void ZeBandwidth::test_striped(void) {
+  long double total_bandwidth = 0.0;
+  long double total_latency = 0.0;
+  long double copy_bandwidth = 0.0;
+  long double copy_latency = 0.0;
+
+  /* the striped transfers always run number_iterations */
+  measured_iterations = number_iterations;
+  convergence = ZeBandwidthConvergence();
+
+  for (auto device_id : device_ids) {
+    uint32_t numQueueGroups = 0;
+    benchmark->deviceGetCommandQueueGroupProperties(device_id, &numQueueGroups,
+                                                    nullptr);
+    std::vector<ze_command_queue_group_properties_t> group_properties(
+        numQueueGroups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+    benchmark->deviceGetCommandQueueGroupProperties(
+        device_id, &numQueueGroups, group_properties.data());
+
+    std::vector<ze_command_queue_handle_t> queues(stripes.size());
+    std::vector<ze_command_list_handle_t> lists(stripes.size());
+    std::cout << std::endl
+              << "[Device " << device_id << "] Striping across engines";
+    for (uint32_t i = 0; i < stripes.size(); i++) {
+      if (stripes[i].ordinal >= numQueueGroups ||
+          stripes[i].index >= group_properties[stripes[i].ordinal].numQueues) {
+        std::cout << std::endl;
+        throw std::runtime_error("Stripe engine " +
+                                 std::to_string(stripes[i].ordinal) + "." +
+                                 std::to_string(stripes[i].index) +
+                                 " is not valid");
+      }
+      std::cout << " " << stripes[i].ordinal << "," << stripes[i].index << ":"
+                << stripes[i].ratio;
+      benchmark->commandQueueCreate(device_id, stripes[i].ordinal,
+                                    stripes[i].index, &queues[i]);
+      benchmark->commandListCreate(device_id, stripes[i].ordinal, &lists[i]);
+    }
+    std::cout << std::endl;
+
+    ze_event_pool_desc_t event_pool_desc = {ZE_STRUCTURE_TYPE_EVENT_POOL_DESC};
+    event_pool_desc.count = static_cast<uint32_t>(stripes.size());
+    event_pool_desc.flags =
+        ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP;
+    ze_event_pool_handle_t stripe_event_pool = {};
+    SUCCESS_OR_TERMINATE(zeEventPoolCreate(
+        benchmark->context, &event_pool_desc, 1,
+        &benchmark->_devices[device_id], &stripe_event_pool));
+    std::vector<ze_event_handle_t> events(stripes.size());
+    for (uint32_t i = 0; i < stripes.size(); i++) {
+      ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC};
+      event_desc.index = i;
+      event_desc.signal = ZE_EVENT_SCOPE_FLAG_DEVICE;
+      event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+      SUCCESS_OR_TERMINATE(
+          zeEventCreate(stripe_event_pool, &event_desc, &events[i]));
+    }
+
+    for (uint32_t direction = 0; direction < 2; direction++) {
+      const bool to_device = (direction == 0);
+      if ((to_device && !run_host2dev) || (!to_device && !run_dev2host)) {
+        continue;
+      }
+
+      std::cout << std::endl
+                << (to_device ? "STRIPED HOST-TO-DEVICE"
+                              : "STRIPED DEVICE-TO-HOST")
+                << " BANDWIDTH AND LATENCY" << std::endl;
+      print_csv_header();
+
+      for (auto size : transfer_size) {
+        void *device_buffer = nullptr;
+        void *host_buffer = nullptr;
+        long double host_time_nsec = 0;
+        long double copy_time_nsec = 0;
+
+        benchmark->memoryAlloc(device_id, size, &device_buffer);
+        host_alloc(device_id, size, &host_buffer);
+
+        striped_size_test(device_id, size,
+                          to_device ? device_buffer : host_buffer,
+                          to_device ? host_buffer : device_buffer, queues,
+                          lists, events, host_time_nsec, copy_time_nsec);
+
+        benchmark->memoryFree(device_buffer);
+        benchmark->memoryFree(host_buffer);
+
+        calculate_metrics(host_time_nsec,
+                          static_cast<long double>(size * number_iterations),
+                          total_bandwidth, total_latency);
+        calculate_metrics(copy_time_nsec,
+                          static_cast<long double>(size * number_iterations),
+                          copy_bandwidth, copy_latency);
+        print_results(size, total_bandwidth, total_latency, copy_bandwidth,
+                      copy_latency,
+                      "\t[Device " + std::to_string(device_id) + " ");
+      }
+    }
+
+    for (uint32_t i = 0; i < stripes.size(); i++) {
+      SUCCESS_OR_TERMINATE(zeEventDestroy(events[i]));
+      benchmark->commandListDestroy(lists[i]);
+      benchmark->commandQueueDestroy(queues[i]);
+    }
+    SUCCESS_OR_TERMINATE(zeEventPoolDestroy(stripe_event_pool));
+  }
+}
+
+//---------------------------------------------------------------------
+// Looks up the PCI location of every selected device through sysman and
+// the NUMA node and local CPUs of that PCI device from sysfs.
+//---------------------------------------------------------------------
+void ZeBandwidth::find_numa_nodes() {
+  device_numa_node.assign(benchmark->_devices.size(), -1);
+#ifdef __linux__
+  device_local_cpus.resize(benchmark->_devices.size());
+  for (auto device_id : device_ids) {
+    CPU_ZERO(&device_local_cpus[device_id]);
+
+    zes_pci_properties_t pci_properties = {ZES_STRUCTURE_TYPE_PCI_PROPERTIES,
+                                           nullptr};
+    ze_result_t result = zesDevicePciGetProperties(
+        reinterpret_cast<zes_device_handle_t>(benchmark->_devices[device_id]),
+        &pci_properties);
+    if (result) {
+      std::cout << "[Device " << device_id
+                << "] zesDevicePciGetProperties failed: " << result
+                << ", host buffers are not placed\n";
+      continue;
+    }
+
+    char bdf[32];
+    snprintf(bdf, sizeof(bdf), "%04x:%02x:%02x.%x",
+             pci_properties.address.domain, pci_properties.address.bus,
+             pci_properties.address.device, pci_properties.address.function);
+    const std::string sysfs_path = std::string("/sys/bus/pci/devices/") + bdf;
+
+    std::ifstream numa_node_file(sysfs_path + "/numa_node");
+    int numa_node = -1;
+    numa_node_file >> numa_node;
+    device_numa_node[device_id] = numa_node;
+
+    /* local_cpulist is a list of ranges such as 0-27,56-83 */
+    std::ifstream cpulist_file(sysfs_path + "/local_cpulist");
+    std::string cpulist;
+    cpulist_file >> cpulist;
+    for (auto cpu : HostPlacement::parse_cpu_list(cpulist)) {
+      if (cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &device_local_cpus[device_id]);
+      }
+    }
+
+    std::cout << "[Device " << device_id << "] PCI " << bdf << ", NUMA node "
+              << numa_node << ", local CPUs "
+              << (cpulist.empty() ? "unknown" : cpulist) << "\n";
+  }
+#else
+  std::cout << "NUMA placement of host buffers is only supported on Linux\n";
+#endif
+}
+
 //---------------------------------------------------------------------
 // Utility function to query queue group properties
 //---------------------------------------------------------------------
@@ -679,37 +1428,46 @@ void ZeBandwidth::ze_bandwidth_query_engines() {
       benchmark->commandListCreate(device_id, command_queue_group_ordinal1,
                                    &command_list1[device_id]);
     } else {
-      ze_command_queue_desc_t command_queue_description{};
-      command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
-      command_queue_description.pNext = nullptr;
-      command_queue_description.ordinal = command_queue_group_ordinal;
-      command_queue_description.index = command_queue_index;
-      command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
-
-      SUCCESS_OR_TERMINATE(zeCommandListCreateImmediate(
-          benchmark->context, benchmark->_devices[device_id],
-          &command_queue_description, &command_list[device_id]));
-
-      command_queue_description.ordinal = command_queue_group_ordinal1;
-      command_queue_description.index = command_queue_index1;
-      SUCCESS_OR_TERMINATE(zeCommandListCreateImmediate(
-          benchmark->context, benchmark->_devices[device_id],
-          &command_queue_description, &command_list1[device_id]));
+      benchmark->commandListCreateImmediate(
+          device_id, command_queue_group_ordinal, command_queue_index,
+          ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS, &command_list[device_id]);
+      benchmark->commandListCreateImmediate(
+          device_id, command_queue_group_ordinal1, command_queue_index1,
+          ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS, &command_list1[device_id]);
     }
   }
 
   if (verify) {
     benchmark->commandQueueCreate(0, 0, 0, &command_queue_verify);
     benchmark->commandListCreate(0, 0, &command_list_verify);
+    benchmark->functionCreate(0, &checksum_kernel, "checksum_words");
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetGroupSize(checksum_kernel, checksum_group_size, 1, 1));
+    benchmark->memoryAllocHost(2 * checksum_work_items * sizeof(uint32_t),
+                               &checksum_hashes);
+  }
+
+  device_properties.assign(benchmark->_devices.size(),
+                           {ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, nullptr});
+  for (auto device_id : device_ids) {
+    SUCCESS_OR_TERMINATE(zeDeviceGetProperties(
+        benchmark->_devices[device_id], &device_properties[device_id]));
   }
 
   ze_event_pool_desc_t event_pool_desc = {ZE_STRUCTURE_TYPE_EVENT_POOL_DESC};
-  event_pool_desc.count = 2 * device_ids.size() + 1;
-  event_pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  event_pool_desc.count = 2 * device_ids.size();
+  event_pool_desc.flags =
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP;
   SUCCESS_OR_TERMINATE(zeEventPoolCreate(
       benchmark->context, &event_pool_desc, benchmark->_devices.size(),
       benchmark->_devices.data(), &event_pool));
 
+  event_pool_desc.count = 1;
+  event_pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  SUCCESS_OR_TERMINATE(zeEventPoolCreate(
+      benchmark->context, &event_pool_desc, benchmark->_devices.size(),
+      benchmark->_devices.data(), &wait_event_pool));
+
   ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC};
   event_desc.signal = ZE_EVENT_SCOPE_FLAG_DEVICE;
   event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
@@ -724,13 +1482,28 @@ void ZeBandwidth::ze_bandwidth_query_engines() {
         zeEventCreate(event_pool, &event_desc, &event1[device_id]));
   }
 
-  event_desc.index = event_index;
+  event_desc.index = 0;
   event_desc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
   event_desc.wait = ZE_EVENT_SCOPE_FLAG_DEVICE;
-  SUCCESS_OR_TERMINATE(zeEventCreate(event_pool, &event_desc, &wait_event));
+  SUCCESS_OR_TERMINATE(
+      zeEventCreate(wait_event_pool, &event_desc, &wait_event));
 }
 
 int main(int argc, char **argv) {
+  /* sysman must be enabled before the driver is initialized */
+  bool enable_sysman = HostPlacement::needs_sysman(argc, argv);
+  for (int i = 1; i < argc; i++) {
+    enable_sysman |= (strcmp(argv[i], "--numa") == 0);
+  }
+  if (enable_sysman) {
+    static char sys_env[] = "ZES_ENABLE_SYSMAN=1";
+    putenv(sys_env);
+  }
+  if (MetricProfiler::needs_metrics(argc, argv)) {
+    static char metrics_env[] = "ZET_ENABLE_METRICS=1";
+    putenv(metrics_env);
+  }
+
   ZeBandwidth bw;
   size_t default_size;
   srand(1);
@@ -748,8 +1521,29 @@ int main(int argc, char **argv) {
     bw.device_ids.push_back(0);
   }
 
+  if (bw.results.enabled()) {
+    bw.results.read_metadata(bw.benchmark->_devices);
+  }
+
   bw.ze_bandwidth_query_engines();
 
+  if (!bw.query_engines && bw.numa_aware) {
+    bw.find_numa_nodes();
+  }
+
+  if (!bw.query_engines && bw.metric_profiler.enabled() &&
+      !bw.metric_profiler.init(bw.benchmark->context,
+                               bw.benchmark->_devices[bw.device_ids[0]])) {
+    std::cerr << "metric profiling skipping for missing support: "
+              << "no time based metric group of that name" << std::endl;
+  }
+
+  if (!bw.query_engines) {
+    bw.placement.apply(bw.benchmark->_devices[bw.device_ids[0]]);
+    (bw.csv_output ? std::cerr : std::cout) << bw.placement.describe()
+                                            << std::endl;
+  }
+
   if (!bw.query_engines) {
     default_size = bw.transfer_lower_limit;
     while (default_size < bw.transfer_upper_limit) {
@@ -759,8 +1553,19 @@ int main(int argc, char **argv) {
     bw.transfer_size.push_back(bw.transfer_upper_limit);
 
     std::cout << std::endl
-              << "Iterations per transfer size = " << bw.number_iterations
-              << std::endl;
+              << (bw.adaptive() ? "Maximum iterations per transfer size = "
+                                : "Iterations per transfer size = ")
+              << bw.number_iterations << std::endl;
+    if (bw.adaptive()) {
+      std::cout << "Adaptive iterations, stopping at";
+      if (bw.cov_target > 0) {
+        std::cout << " CoV <= " << bw.cov_target << " %";
+      }
+      if (bw.time_budget_msec) {
+        std::cout << " " << bw.time_budget_msec << " ms per size";
+      }
+      std::cout << std::endl;
+    }
 
     bw.device_buffers.resize(bw.benchmark->_devices.size());
     bw.device_buffers_bidir.resize(bw.benchmark->_devices.size());
@@ -784,9 +1589,33 @@ int main(int argc, char **argv) {
       bw.test_bidir();
     }
 
+    if (!bw.stripes.empty()) {
+      bw.test_striped();
+    }
+
+    if (bw.run_small_latency) {
+      bw.test_small_latency();
+    }
+
+    if (bw.run_shared_migration) {
+      bw.test_shared_migration();
+    }
+
+    if (bw.run_region_copy) {
+      bw.test_region_copy();
+    }
+
+    if (bw.run_fill) {
+      bw.test_fill();
+    }
+
+    if (bw.run_compression) {
+      bw.test_compression();
+    }
+
     std::cout << std::endl;
 
     std::cout << std::flush;
   }
-  return 0;
+  return bw.results.finish();
 }
@@ -0,0 +1,32 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#define TILE_SIZE 16
+
+kernel void gemm(global const float *a, global const float *b, global float *c, int n) {
+    local float tile_a[TILE_SIZE * TILE_SIZE];
+    local float tile_b[TILE_SIZE * TILE_SIZE];
+    const size_t col = get_global_id(0);
+    const size_t row = get_global_id(1);
+    const size_t local_x = get_local_id(0);
+    const size_t local_y = get_local_id(1);
+    const size_t tile_offset = local_y * TILE_SIZE + local_x;
+
+    float sum = 0.0f;
+    for (size_t t = 0; t < n; t += TILE_SIZE) {
+        tile_a[tile_offset] = a[row * n + t + local_x];
+        tile_b[tile_offset] = b[(t + local_y) * n + col];
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (size_t k = 0; k < TILE_SIZE; k++) {
+            sum += tile_a[local_y * TILE_SIZE + k] * tile_b[k * TILE_SIZE + local_x];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    c[row * n + col] = sum;
+}
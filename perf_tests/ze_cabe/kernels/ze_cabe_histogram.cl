@@ -0,0 +1,23 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#define NUM_BINS 256
+
+// One work-item per bin in every work-group: GWS must be a multiple of 256
+kernel void histogram(global const uint *input, global uint *bins) {
+    local uint local_bins[NUM_BINS];
+    const size_t local_id = get_local_id(0);
+
+    local_bins[local_id] = 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    atomic_inc(&local_bins[input[get_global_id(0)] & (NUM_BINS - 1)]);
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    atomic_add(&bins[local_id], local_bins[local_id]);
+}
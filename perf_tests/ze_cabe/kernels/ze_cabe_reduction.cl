@@ -0,0 +1,28 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#define GROUP_SIZE 256
+
+kernel void reduction(global const int *input, global int *sum) {
+    local int scratch[GROUP_SIZE];
+    const size_t local_id = get_local_id(0);
+
+    scratch[local_id] = input[get_global_id(0)];
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (size_t stride = GROUP_SIZE / 2; stride > 0; stride >>= 1) {
+        if (local_id < stride) {
+            scratch[local_id] += scratch[local_id + stride];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    if (local_id == 0) {
+        atomic_add(sum, scratch[0]);
+    }
+}
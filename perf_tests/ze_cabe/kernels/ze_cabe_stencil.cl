@@ -0,0 +1,25 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+kernel void stencil(global const float *input, global float *output, int nx, int ny, int nz) {
+    const size_t x = get_global_id(0);
+    const size_t y = get_global_id(1);
+    const size_t z = get_global_id(2);
+    const size_t offset = (z * ny + y) * nx + x;
+
+    if (x == 0 || y == 0 || z == 0 || x == nx - 1 || y == ny - 1 || z == nz - 1) {
+        output[offset] = input[offset];
+        return;
+    }
+
+    const size_t plane = nx * ny;
+    const float neighbours = input[offset - 1] + input[offset + 1] +
+        input[offset - nx] + input[offset + nx] +
+        input[offset - plane] + input[offset + plane];
+    output[offset] = 0.4f * input[offset] + 0.1f * neighbours;
+}
@@ -54,4 +54,35 @@ void save_csv(const std::string &csv_string, const std::string &csv_filename) {
   stream.close();
 }
 
+std::string json_quoted(const std::string &in) {
+  std::string out = "\"";
+  for (char c : in) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+void save_json(const std::string &json_string,
+               const std::string &json_filename) {
+  std::ofstream stream(json_filename);
+  if (stream.fail()) {
+    std::cout << "Cannot write to json!" << std::endl;
+    exit(0);
+  }
+  stream << json_string;
+  stream.close();
+}
+
+void set_environment_variable(const std::string &name,
+                              const std::string &value) {
+#ifdef _WIN32
+  _putenv_s(name.c_str(), value.c_str());
+#else
+  setenv(name.c_str(), value.c_str(), 1);
+#endif
+}
+
 } // namespace compute_api_bench
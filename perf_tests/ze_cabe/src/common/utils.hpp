@@ -25,7 +25,12 @@ namespace compute_api_bench {
 std::vector<uint8_t> load_binary_file(size_t &length,
                                       const std::string &file_path);
 std::string load_text_file(size_t &length, const std::string &file_path);
+std::string json_quoted(const std::string &in);
+void save_json(const std::string &json_string,
+               const std::string &json_filename);
 void save_csv(const std::string &csv_string, const std::string &csv_filename);
+void set_environment_variable(const std::string &name,
+                              const std::string &value);
 
 static const std::string red = "\033[0;31m";
 static const std::string green = "\033[1;32m";
@@ -38,17 +43,26 @@ static const std::string reset = "\033[0m";
 static const std::string intense_white = "\033[0;97m";
 static const std::string light_red = "\033[1;31m";
 
+// BUILD_PROGRAM_NATIVE rebuilds the program of BUILD_PROGRAM from the native
+// binary the driver produced; it is an alternative, not an extra stage.
 enum Stages {
   CREATE_DEVICE,
   BUILD_PROGRAM,
+  BUILD_PROGRAM_NATIVE,
   CREATE_BUFFERS_CMDLIST,
   EXECUTE_WORK,
   COUNT
 };
 
 static std::string StagesList[Stages::COUNT] = {
-    "Device Creation", "Kernel Compilation", "Buffer&CmdList Creation",
-    "Work Execution"};
+    "Device Creation", "Kernel Compilation", "Kernel Load (native)",
+    "Buffer&CmdList Creation", "Work Execution"};
+
+// Names of the stages in the JSON results, kept fixed for the results
+// already stored
+static std::string StageKeys[Stages::COUNT] = {
+    "create_device", "build_program", "build_program_native",
+    "create_buffers_cmdlist", "execute_work"};
 
 template <class T> class BlackScholesData {
 public:
@@ -233,6 +247,62 @@ inline void mandelbrot_cpu(float *pixels, int width, int height) {
   }
 }
 
+#define GEMM_TILE_SIZE 16
+
+inline void gemm_cpu(const float *a, const float *b, float *c,
+                     const int n) {
+  for (int row = 0; row < n; ++row) {
+    for (int col = 0; col < n; ++col) {
+      float sum = 0.0f;
+      for (int k = 0; k < n; ++k) {
+        sum += a[row * n + k] * b[k * n + col];
+      }
+      c[row * n + col] = sum;
+    }
+  }
+}
+
+#define REDUCTION_GROUP_SIZE 256
+
+inline void stencil_cpu(const float *input, float *output, const int nx,
+                        const int ny, const int nz) {
+  const int plane = nx * ny;
+  for (int z = 0; z < nz; ++z) {
+    for (int y = 0; y < ny; ++y) {
+      for (int x = 0; x < nx; ++x) {
+        const int offset = (z * ny + y) * nx + x;
+        if (x == 0 || y == 0 || z == 0 || x == nx - 1 || y == ny - 1 ||
+            z == nz - 1) {
+          output[offset] = input[offset];
+          continue;
+        }
+        const float neighbours = input[offset - 1] + input[offset + 1] +
+                                 input[offset - nx] + input[offset + nx] +
+                                 input[offset - plane] + input[offset + plane];
+        output[offset] = 0.4f * input[offset] + 0.1f * neighbours;
+      }
+    }
+  }
+}
+
+#define HISTOGRAM_NUM_BINS 256
+
+inline void histogram_cpu(const uint32_t *input, uint32_t *bins,
+                          const int num_elements) {
+  for (int i = 0; i < num_elements; ++i) {
+    bins[input[i] & (HISTOGRAM_NUM_BINS - 1)]++;
+  }
+}
+
+#define PIPELINE_THRESHOLD_LEVEL 64
+
+inline void threshold_cpu(const uint32_t *input, uint32_t *output,
+                          const uint32_t level, const int num_elements) {
+  for (int i = 0; i < num_elements; ++i) {
+    output[i] = input[i] >= level ? input[i] : 0;
+  }
+}
+
 } // namespace compute_api_bench
 
 #endif // COMPUTE_API_BENCH_UTILS_HPP
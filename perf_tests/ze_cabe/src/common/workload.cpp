@@ -14,7 +14,10 @@ namespace compute_api_bench {
 
 Workload::Workload() {}
 
-void Workload::run(unsigned int iterations) {
+void Workload::run(unsigned int iterations) { run_steady_state(iterations, 0); }
+
+void Workload::run_steady_state(unsigned int iterations,
+                                unsigned int executions) {
   try {
     Timer timer;
 
@@ -22,6 +25,8 @@ void Workload::run(unsigned int iterations) {
     for (unsigned int i = 0; i < WARMUP_ITERATIONS; ++i) {
       create_device();
       build_program();
+      save_native_binary();
+      build_program_native();
       create_buffers();
       create_cmdlist();
       execute_work();
@@ -29,8 +34,10 @@ void Workload::run(unsigned int iterations) {
     }
 
     for (unsigned int i = 0; i < iterations; ++i) {
-      std::cout << "\r" << workload_api << " " << workload_name
-                << " - iteration: " << i + 1 << std::flush;
+      if (show_progress) {
+        std::cout << "\r" << workload_api << " " << workload_name
+                  << " - iteration: " << i + 1 << std::flush;
+      }
       timer.start();
       create_device();
       result[Stages::CREATE_DEVICE].times.push_back(timer.elapsed_time());
@@ -38,6 +45,12 @@ void Workload::run(unsigned int iterations) {
       build_program();
       result[Stages::BUILD_PROGRAM].times.push_back(timer.elapsed_time());
 
+      save_native_binary();
+      timer.start();
+      build_program_native();
+      result[Stages::BUILD_PROGRAM_NATIVE].times.push_back(
+          timer.elapsed_time());
+
       create_buffers();
       create_cmdlist();
       result[Stages::CREATE_BUFFERS_CMDLIST].times.push_back(
@@ -46,6 +59,11 @@ void Workload::run(unsigned int iterations) {
       execute_work();
       result[Stages::EXECUTE_WORK].times.push_back(timer.elapsed_time());
 
+      for (unsigned int e = 0; e < executions; ++e) {
+        execute_work();
+        warm_result.times.push_back(timer.elapsed_time());
+      }
+
       if (verify_results() == false) {
         cleanup();
         std::cout << "\r" << std::flush;
@@ -55,10 +73,15 @@ void Workload::run(unsigned int iterations) {
 
       cleanup();
 
-      std::cout << "\r" << std::flush;
+      if (show_progress) {
+        std::cout << "\r" << std::flush;
+      }
     }
 
     calculate_results();
+    if (executions > 0) {
+      calculate_result(warm_result);
+    }
   } catch (const std::exception &e) {
     std::cout << "Exception occured: " << e.what();
     exit(0);
@@ -66,31 +89,37 @@ void Workload::run(unsigned int iterations) {
 }
 
 void Workload::calculate_results() {
-
   for (unsigned int i = 0; i < Stages::COUNT; ++i) {
-    result[i].time_mean =
-        std::accumulate(result[i].times.begin(), result[i].times.end(), 0.0f) /
-        result[i].times.size();
+    calculate_result(result[i]);
+  }
+}
 
-    double error = 0.0;
-    for (double time : result[i].times) {
-      error += pow(time - result[i].time_mean, 2);
-    }
+void Workload::calculate_result(Result &stage_result) {
+  stage_result.time_mean = std::accumulate(stage_result.times.begin(),
+                                           stage_result.times.end(), 0.0f) /
+                           stage_result.times.size();
 
-    result[i].time_standard_deviation = sqrt(error / result[i].times.size());
+  double error = 0.0;
+  for (double time : stage_result.times) {
+    error += pow(time - stage_result.time_mean, 2);
+  }
 
-    std::sort(result[i].times.begin(), result[i].times.end());
-    result[i].time_min = result[i].times.front();
-    result[i].time_max = result[i].times.back();
+  stage_result.time_standard_deviation =
+      sqrt(error / stage_result.times.size());
 
-    unsigned int middleIdx = result[i].times.size() / 2;
+  // Sorted apart, so the times stay in iteration order for the reports
+  std::vector<double> sorted_times = stage_result.times;
+  std::sort(sorted_times.begin(), sorted_times.end());
+  stage_result.time_min = sorted_times.front();
+  stage_result.time_max = sorted_times.back();
 
-    if (result[i].times.size() % 2) {
-      result[i].time_median = result[i].times[middleIdx];
-    } else {
-      result[i].time_median =
-          (result[i].times[middleIdx - 1] + result[i].times[middleIdx]) / 2;
-    }
+  unsigned int middleIdx = sorted_times.size() / 2;
+
+  if (sorted_times.size() % 2) {
+    stage_result.time_median = sorted_times[middleIdx];
+  } else {
+    stage_result.time_median =
+        (sorted_times[middleIdx - 1] + sorted_times[middleIdx]) / 2;
   }
 }
 
@@ -98,7 +127,9 @@ void Workload::print_total_mean_time() {
   std::cout.precision(4);
   double total_time = 0;
   for (unsigned int i = 0; i < Stages::COUNT; ++i) {
-    total_time += result[i].time_mean;
+    if (i != Stages::BUILD_PROGRAM_NATIVE) {
+      total_time += result[i].time_mean;
+    }
   }
 
   std::string tmp = workload_api + " " + workload_name + " overall mean time: ";
@@ -108,8 +139,19 @@ void Workload::print_total_mean_time() {
 
 void Workload::print_stage_mean_sd(unsigned int stage, std::string &csv_string,
                                    bool colored, bool useMedian) {
+  print_mean_sd(result[stage], csv_string, colored, useMedian);
+}
+
+void Workload::print_warm_mean_sd(std::string &csv_string, bool colored,
+                                  bool useMedian) {
+  print_mean_sd(warm_result, csv_string, colored, useMedian);
+}
+
+void Workload::print_mean_sd(const Result &stage_result,
+                             std::string &csv_string, bool colored,
+                             bool useMedian) {
   double sd_percent =
-      result[stage].time_standard_deviation / result[stage].time_mean * 100.0f;
+      stage_result.time_standard_deviation / stage_result.time_mean * 100.0f;
 
   std::string color = "", reset_color = "";
   if (colored) {
@@ -124,17 +166,55 @@ void Workload::print_stage_mean_sd(unsigned int stage, std::string &csv_string,
       color = green;
   }
 
-  csv_string += std::to_string(result[stage].time_mean * 1000.0f) + "," +
+  csv_string += std::to_string(stage_result.time_mean * 1000.0f) + "," +
                 std::to_string(sd_percent / 100.0f) + ",";
   if (useMedian) {
-    std::cout << std::setw(9) << result[stage].time_median * 1000.0f;
+    std::cout << std::setw(9) << stage_result.time_median * 1000.0f;
   } else {
-    std::cout << std::setw(9) << result[stage].time_mean * 1000.0f;
+    std::cout << std::setw(9) << stage_result.time_mean * 1000.0f;
   }
   std::cout << " (SD: " << color << std::setw(3) << (int)sd_percent
             << reset_color << "%)  |  ";
 }
 
+std::string Workload::result_json(const Result &stage_result) {
+  std::ostringstream stream;
+  stream << std::setprecision(10) << "{\"times\": [";
+  for (size_t i = 0; i < stage_result.times.size(); i++) {
+    stream << (i ? ", " : "") << stage_result.times[i];
+  }
+  stream << "], \"min\": " << stage_result.time_min
+         << ", \"max\": " << stage_result.time_max
+         << ", \"mean\": " << stage_result.time_mean
+         << ", \"median\": " << stage_result.time_median
+         << ", \"sd\": " << stage_result.time_standard_deviation << "}";
+  return stream.str();
+}
+
+void Workload::append_json(std::string &json_string,
+                           const std::string &scenario) {
+  json_string += json_string.empty() ? "\n" : ",\n";
+  json_string += "    {\"api\": " + json_quoted(workload_api) +
+                 ", \"scenario\": " + json_quoted(scenario) +
+                 ", \"workload\": " + json_quoted(workload_name) +
+                 ",\n     \"device\": {\"index\": " +
+                 std::to_string(device_index < 0 ? 0 : device_index) +
+                 ", \"name\": " + json_quoted(device_name) +
+                 ", \"driver_version\": " + json_quoted(driver_version) +
+                 ", \"properties\": {";
+  for (size_t i = 0; i < device_properties.size(); i++) {
+    json_string += (i ? ", " : "") + json_quoted(device_properties[i].first) +
+                   ": " + json_quoted(device_properties[i].second);
+  }
+  json_string += "}},\n     \"stages\": {";
+  for (unsigned int i = 0; i < Stages::COUNT; ++i) {
+    json_string += "\n       " + json_quoted(StageKeys[i]) + ": " +
+                   result_json(result[i]) + ",";
+  }
+  json_string +=
+      "\n       \"execute_work_warm\": " + result_json(warm_result) + "}}";
+}
+
 void Workload::print_apis(std::string api, std::string &csv_string,
                           bool colored) {
   std::string color = "", reset_color = "";
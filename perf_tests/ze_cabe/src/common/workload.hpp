@@ -15,6 +15,7 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <chrono>
 #include <assert.h>
 #include "timer.hpp"
@@ -40,20 +41,46 @@ public:
           time_standard_deviation(0) {}
   } result[Stages::COUNT];
 
+  // Executions of the steady-state mode, after the first one of each setup
+  Result warm_result;
+
   virtual ~Workload() = default;
   void run(unsigned int iterations);
+  // Sets up once per iteration, then repeats only execute_work with the
+  // same buffers and command lists. result[] holds the cold stages and
+  // the first execution, warm_result the executions that follow it.
+  void run_steady_state(unsigned int iterations, unsigned int executions);
   void print_total_mean_time();
   void print_stage_mean_sd(unsigned int stage, std::string &csv_string,
                            bool colored, bool useMedian);
+  void print_warm_mean_sd(std::string &csv_string, bool colored,
+                          bool useMedian);
   static void print_apis(std::string api, std::string &csv, bool colored);
+  // Appends the results of the workload as one JSON object, with the raw
+  // times of every stage in iteration order
+  void append_json(std::string &json_string, const std::string &scenario);
 
   unsigned int iterations;
   std::string workload_name;
   std::string workload_api;
+  // Index into the devices listed by the API when set, the first device
+  // otherwise. device_name is filled in by the first device creation.
+  int device_index = -1;
+  std::string device_name;
+  // Also filled in by the first device creation, reported in the JSON
+  // results with the same keys on every run of an API
+  std::string driver_version;
+  std::vector<std::pair<std::string, std::string>> device_properties;
+  // Off when several workloads run at once and share the console
+  bool show_progress = true;
 
 protected:
   virtual void create_device() = 0;
   virtual void build_program() = 0;
+  // Keeps the native binary of the built program and releases the program
+  virtual void save_native_binary() = 0;
+  // Builds the program again from the binary kept by save_native_binary()
+  virtual void build_program_native() = 0;
   virtual void create_buffers() = 0;
   virtual void create_cmdlist() = 0;
   virtual void execute_work() = 0;
@@ -62,6 +89,11 @@ protected:
 
 private:
   void calculate_results();
+  static void calculate_result(Result &stage_result);
+  static std::string result_json(const Result &stage_result);
+  static void print_mean_sd(const Result &stage_result,
+                            std::string &csv_string, bool colored,
+                            bool useMedian);
 };
 
 } // namespace compute_api_bench
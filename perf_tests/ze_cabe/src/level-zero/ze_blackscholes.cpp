@@ -58,6 +58,14 @@ template <class T> void ZeBlackScholes<T>::build_program() {
   ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
 }
 
+template <class T> void ZeBlackScholes<T>::save_native_binary() {
+  save_module_native_binary(module, function);
+}
+
+template <class T> void ZeBlackScholes<T>::build_program_native() {
+  prepare_program_from_native(module, function, "blackscholes");
+}
+
 template <class T> void ZeBlackScholes<T>::create_buffers() {
   ze_device_mem_alloc_desc_t device_desc = {};
   device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
@@ -0,0 +1,156 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_gemm.hpp"
+
+namespace compute_api_bench {
+
+ZeGemm::ZeGemm(unsigned int size, unsigned int num_iterations)
+    : ZeWorkload(), size(size), num_iterations(num_iterations) {
+  workload_name = "GEMM";
+  matrix_buffer_size = size * size * sizeof(float);
+  a.assign(size * size, 0);
+  b.assign(size * size, 0);
+  c.assign(size * size, 0);
+  c_CPU.assign(size * size, 0);
+
+  // Small integers keep every partial sum exact in fp32
+  for (unsigned int i = 0; i < size * size; i++) {
+    a[i] = (float)(i % 7);
+    b[i] = (float)(i % 5);
+  }
+
+  gemm_cpu(a.data(), b.data(), c_CPU.data(), size);
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_gemm.spv");
+}
+
+ZeGemm::~ZeGemm() {}
+
+void ZeGemm::build_program() {
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+
+  module_description.pNext = nullptr;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = kernel_length;
+  module_description.pInputModule = kernel_spv.data();
+  module_description.pBuildFlags = nullptr;
+  ZE_CHECK_RESULT(
+      zeModuleCreate(context, device, &module_description, &module, nullptr));
+
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  function_description.pNext = nullptr;
+  function_description.flags = 0;
+  function_description.pKernelName = "gemm";
+  ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
+}
+
+void ZeGemm::save_native_binary() {
+  save_module_native_binary(module, function);
+}
+
+void ZeGemm::build_program_native() {
+  prepare_program_from_native(module, function, "gemm");
+}
+
+void ZeGemm::create_buffers() {
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  device_desc.ordinal = 0;
+  device_desc.flags = 0;
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, matrix_buffer_size,
+                                   1, device, &a_buffer));
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, matrix_buffer_size,
+                                   1, device, &b_buffer));
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, matrix_buffer_size,
+                                   1, device, &c_buffer));
+}
+
+void ZeGemm::create_cmdlist() {
+  uint32_t group_size_x = GEMM_TILE_SIZE;
+  uint32_t group_size_y = GEMM_TILE_SIZE;
+  uint32_t group_size_z = 1;
+
+  ZE_CHECK_RESULT(
+      zeKernelSetGroupSize(function, group_size_x, group_size_y, group_size_z));
+  ZE_CHECK_RESULT(
+      zeKernelSetArgumentValue(function, 0, sizeof(a_buffer), &a_buffer));
+  ZE_CHECK_RESULT(
+      zeKernelSetArgumentValue(function, 1, sizeof(b_buffer), &b_buffer));
+  ZE_CHECK_RESULT(
+      zeKernelSetArgumentValue(function, 2, sizeof(c_buffer), &c_buffer));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(function, 3, sizeof(int), &size));
+
+  ze_command_list_desc_t command_list_description = {};
+  command_list_description.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+  command_list_description.pNext = nullptr;
+  ZE_CHECK_RESULT(zeCommandListCreate(
+      context, device, &command_list_description, &command_list));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(command_list, a_buffer,
+                                                a.data(), matrix_buffer_size,
+                                                nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(command_list, b_buffer,
+                                                b.data(), matrix_buffer_size,
+                                                nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(
+      zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = size / group_size_x;
+  group_count.groupCountY = size / group_size_y;
+  group_count.groupCountZ = 1;
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    ZE_CHECK_RESULT(zeCommandListAppendLaunchKernel(
+        command_list, function, &group_count, nullptr, 0, nullptr));
+  }
+  ZE_CHECK_RESULT(
+      zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(command_list, c.data(),
+                                                c_buffer, matrix_buffer_size,
+                                                nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListClose(command_list));
+
+  ze_command_queue_desc_t command_queue_description = {};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.pNext = nullptr;
+  command_queue_description.ordinal = 0;
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  ZE_CHECK_RESULT(zeCommandQueueCreate(
+      context, device, &command_queue_description, &command_queue));
+}
+
+void ZeGemm::execute_work() {
+  ZE_CHECK_RESULT(zeCommandQueueExecuteCommandLists(command_queue, 1,
+                                                    &command_list, nullptr));
+  ZE_CHECK_RESULT(zeCommandQueueSynchronize(command_queue, UINT64_MAX));
+}
+
+bool ZeGemm::verify_results() {
+  for (unsigned int i = 0; i < size * size; i++) {
+    if (c[i] != c_CPU[i]) {
+      printf("\nGPU %f vs. CPU %f\n", c[i], c_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ZeGemm::cleanup() {
+  ZE_CHECK_RESULT(zeCommandQueueDestroy(command_queue));
+  ZE_CHECK_RESULT(zeCommandListDestroy(command_list));
+  ZE_CHECK_RESULT(zeKernelDestroy(function));
+  ZE_CHECK_RESULT(zeModuleDestroy(module));
+  ZE_CHECK_RESULT(zeMemFree(context, c_buffer));
+  ZE_CHECK_RESULT(zeMemFree(context, b_buffer));
+  ZE_CHECK_RESULT(zeMemFree(context, a_buffer));
+  ZE_CHECK_RESULT(zeContextDestroy(context));
+}
+
+} // namespace compute_api_bench
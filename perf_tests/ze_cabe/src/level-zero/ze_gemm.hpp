@@ -0,0 +1,54 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_ZE_GEMM_HPP
+#define COMPUTE_API_BENCH_ZE_GEMM_HPP
+
+#include <vector>
+#include <string>
+#include "ze_workload.hpp"
+
+namespace compute_api_bench {
+
+class ZeGemm : public ZeWorkload {
+public:
+  ZeGemm(unsigned int size, unsigned int num_iterations);
+  ~ZeGemm();
+
+  void build_program();
+  void save_native_binary();
+  void build_program_native();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  size_t kernel_length;
+  std::string kernel_code;
+  std::vector<uint8_t> kernel_spv;
+  size_t matrix_buffer_size;
+  std::vector<float> a;
+  std::vector<float> b;
+  std::vector<float> c;
+  std::vector<float> c_CPU;
+  unsigned int size;
+  unsigned int num_iterations;
+  void *a_buffer = nullptr;
+  void *b_buffer = nullptr;
+  void *c_buffer = nullptr;
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t function = nullptr;
+  ze_command_queue_handle_t command_queue = nullptr;
+  ze_command_list_handle_t command_list = nullptr;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_ZE_GEMM_HPP
@@ -0,0 +1,158 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_histogram.hpp"
+
+namespace compute_api_bench {
+
+ZeHistogram::ZeHistogram(unsigned int num_elements,
+                         unsigned int num_iterations)
+    : ZeWorkload(), num_elements(num_elements),
+      num_iterations(num_iterations) {
+  workload_name = "Histogram";
+  input_buffer_size = num_elements * sizeof(uint32_t);
+  bins_buffer_size = HISTOGRAM_NUM_BINS * sizeof(uint32_t);
+  input.assign(num_elements, 0);
+  bins_GPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_CPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_zero.assign(HISTOGRAM_NUM_BINS, 0);
+
+  srand(1);
+  for (unsigned int i = 0; i < num_elements; i++) {
+    input[i] = (uint32_t)rand() % HISTOGRAM_NUM_BINS;
+  }
+
+  // Every launch adds its counts to the bins, which are reset once per
+  // execution of the command list
+  histogram_cpu(input.data(), bins_CPU.data(), num_elements);
+  for (auto &bin : bins_CPU) {
+    bin *= num_iterations;
+  }
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_histogram.spv");
+}
+
+ZeHistogram::~ZeHistogram() {}
+
+void ZeHistogram::build_program() {
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+
+  module_description.pNext = nullptr;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = kernel_length;
+  module_description.pInputModule = kernel_spv.data();
+  module_description.pBuildFlags = nullptr;
+  ZE_CHECK_RESULT(
+      zeModuleCreate(context, device, &module_description, &module, nullptr));
+
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  function_description.pNext = nullptr;
+  function_description.flags = 0;
+  function_description.pKernelName = "histogram";
+  ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
+}
+
+void ZeHistogram::save_native_binary() {
+  save_module_native_binary(module, function);
+}
+
+void ZeHistogram::build_program_native() {
+  prepare_program_from_native(module, function, "histogram");
+}
+
+void ZeHistogram::create_buffers() {
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  device_desc.ordinal = 0;
+  device_desc.flags = 0;
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, input_buffer_size,
+                                   1, device, &input_buffer));
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, bins_buffer_size,
+                                   1, device, &bins_buffer));
+}
+
+void ZeHistogram::create_cmdlist() {
+  uint32_t group_size_x = HISTOGRAM_NUM_BINS;
+  uint32_t group_size_y = 1;
+  uint32_t group_size_z = 1;
+
+  ZE_CHECK_RESULT(
+      zeKernelSetGroupSize(function, group_size_x, group_size_y, group_size_z));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(function, 0, sizeof(input_buffer),
+                                           &input_buffer));
+  ZE_CHECK_RESULT(
+      zeKernelSetArgumentValue(function, 1, sizeof(bins_buffer), &bins_buffer));
+
+  ze_command_list_desc_t command_list_description = {};
+  command_list_description.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+  command_list_description.pNext = nullptr;
+  ZE_CHECK_RESULT(zeCommandListCreate(
+      context, device, &command_list_description, &command_list));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(command_list, input_buffer,
+                                                input.data(), input_buffer_size,
+                                                nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(command_list, bins_buffer,
+                                                bins_zero.data(),
+                                                bins_buffer_size, nullptr, 0,
+                                                nullptr));
+  ZE_CHECK_RESULT(
+      zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = num_elements / group_size_x;
+  group_count.groupCountY = 1;
+  group_count.groupCountZ = 1;
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    ZE_CHECK_RESULT(zeCommandListAppendLaunchKernel(
+        command_list, function, &group_count, nullptr, 0, nullptr));
+  }
+  ZE_CHECK_RESULT(
+      zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(command_list, bins_GPU.data(),
+                                                bins_buffer, bins_buffer_size,
+                                                nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListClose(command_list));
+
+  ze_command_queue_desc_t command_queue_description = {};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.pNext = nullptr;
+  command_queue_description.ordinal = 0;
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  ZE_CHECK_RESULT(zeCommandQueueCreate(
+      context, device, &command_queue_description, &command_queue));
+}
+
+void ZeHistogram::execute_work() {
+  ZE_CHECK_RESULT(zeCommandQueueExecuteCommandLists(command_queue, 1,
+                                                    &command_list, nullptr));
+  ZE_CHECK_RESULT(zeCommandQueueSynchronize(command_queue, UINT64_MAX));
+}
+
+bool ZeHistogram::verify_results() {
+  for (unsigned int i = 0; i < HISTOGRAM_NUM_BINS; i++) {
+    if (bins_GPU[i] != bins_CPU[i]) {
+      printf("\nGPU %u vs. CPU %u\n", bins_GPU[i], bins_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ZeHistogram::cleanup() {
+  ZE_CHECK_RESULT(zeCommandQueueDestroy(command_queue));
+  ZE_CHECK_RESULT(zeCommandListDestroy(command_list));
+  ZE_CHECK_RESULT(zeKernelDestroy(function));
+  ZE_CHECK_RESULT(zeModuleDestroy(module));
+  ZE_CHECK_RESULT(zeMemFree(context, bins_buffer));
+  ZE_CHECK_RESULT(zeMemFree(context, input_buffer));
+  ZE_CHECK_RESULT(zeContextDestroy(context));
+}
+
+} // namespace compute_api_bench
@@ -44,6 +44,14 @@ void ZeMandelbrot::build_program() {
   ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
 }
 
+void ZeMandelbrot::save_native_binary() {
+  save_module_native_binary(module, function);
+}
+
+void ZeMandelbrot::build_program_native() {
+  prepare_program_from_native(module, function, "mandelbrot");
+}
+
 void ZeMandelbrot::create_buffers() {
   ze_device_mem_alloc_desc_t device_desc = {};
   device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
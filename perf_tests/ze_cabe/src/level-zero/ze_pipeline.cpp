@@ -0,0 +1,281 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_pipeline.hpp"
+
+namespace compute_api_bench {
+
+ZePipeline::ZePipeline(level_zero_tests::ImageBMP8Bit image,
+                       unsigned int num_iterations, bool chained)
+    : ZeWorkload(), num_iterations(num_iterations), chained(chained) {
+  workload_name = chained ? "Pipeline (chained)" : "Pipeline (separate)";
+  width = image.width();
+  height = image.height();
+  image_buffer_size = width * height * sizeof(uint32_t);
+  bins_buffer_size = HISTOGRAM_NUM_BINS * sizeof(uint32_t);
+  lena_original.assign(width * height, 0);
+  bins_GPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_CPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_zero.assign(HISTOGRAM_NUM_BINS, 0);
+
+  for (unsigned int i = 0; i < width; i++) {
+    for (unsigned int j = 0; j < height; j++) {
+      lena_original[i + j * width] = (uint32_t)image.get_pixel(i, j);
+    }
+  }
+
+  // Every pass adds its counts to the bins, which are reset once per
+  // execution
+  std::vector<uint32_t> filtered(width * height, 0);
+  sobel_cpu(lena_original.data(), filtered.data(), width, height);
+  threshold_cpu(filtered.data(), filtered.data(), threshold_level,
+                width * height);
+  histogram_cpu(filtered.data(), bins_CPU.data(), width * height);
+  for (auto &bin : bins_CPU) {
+    bin *= num_iterations;
+  }
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_pipeline.spv");
+}
+
+ZePipeline::~ZePipeline() {}
+
+void ZePipeline::create_kernel(const char *kernel_name,
+                               ze_kernel_handle_t &function) {
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  function_description.pNext = nullptr;
+  function_description.flags = 0;
+  function_description.pKernelName = kernel_name;
+  ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
+}
+
+void ZePipeline::build_program() {
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+
+  module_description.pNext = nullptr;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = kernel_length;
+  module_description.pInputModule = kernel_spv.data();
+  module_description.pBuildFlags = nullptr;
+  ZE_CHECK_RESULT(
+      zeModuleCreate(context, device, &module_description, &module, nullptr));
+
+  create_kernel("sobel", sobel_function);
+  create_kernel("threshold", threshold_function);
+  create_kernel("histogram", histogram_function);
+}
+
+void ZePipeline::save_native_binary() {
+  ZE_CHECK_RESULT(zeKernelDestroy(threshold_function));
+  ZE_CHECK_RESULT(zeKernelDestroy(histogram_function));
+  save_module_native_binary(module, sobel_function);
+}
+
+void ZePipeline::build_program_native() {
+  prepare_program_from_native(module, sobel_function, "sobel");
+  create_kernel("threshold", threshold_function);
+  create_kernel("histogram", histogram_function);
+}
+
+void ZePipeline::create_buffers() {
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  device_desc.ordinal = 0;
+  device_desc.flags = 0;
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, image_buffer_size,
+                                   1, device, &input_buffer));
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, image_buffer_size,
+                                   1, device, &sobel_buffer));
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, image_buffer_size,
+                                   1, device, &threshold_buffer));
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, bins_buffer_size,
+                                   1, device, &bins_buffer));
+}
+
+void ZePipeline::create_stage_cmdlist(ze_command_list_handle_t &command_list) {
+  ze_command_list_desc_t command_list_description = {};
+  command_list_description.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+  command_list_description.pNext = nullptr;
+  ZE_CHECK_RESULT(zeCommandListCreate(
+      context, device, &command_list_description, &command_list));
+}
+
+void ZePipeline::create_cmdlist() {
+  ZE_CHECK_RESULT(zeKernelSetGroupSize(sobel_function, 16, 16, 1));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(
+      sobel_function, 0, sizeof(input_buffer), &input_buffer));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(
+      sobel_function, 1, sizeof(sobel_buffer), &sobel_buffer));
+  ZE_CHECK_RESULT(
+      zeKernelSetArgumentValue(sobel_function, 2, sizeof(int), &width));
+  ZE_CHECK_RESULT(
+      zeKernelSetArgumentValue(sobel_function, 3, sizeof(int), &height));
+
+  ZE_CHECK_RESULT(
+      zeKernelSetGroupSize(threshold_function, HISTOGRAM_NUM_BINS, 1, 1));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(
+      threshold_function, 0, sizeof(sobel_buffer), &sobel_buffer));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(
+      threshold_function, 1, sizeof(threshold_buffer), &threshold_buffer));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(
+      threshold_function, 2, sizeof(uint32_t), &threshold_level));
+
+  ZE_CHECK_RESULT(
+      zeKernelSetGroupSize(histogram_function, HISTOGRAM_NUM_BINS, 1, 1));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(
+      histogram_function, 0, sizeof(threshold_buffer), &threshold_buffer));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(
+      histogram_function, 1, sizeof(bins_buffer), &bins_buffer));
+
+  ze_group_count_t image_group_count = {width / 16, height / 16, 1};
+  ze_group_count_t pixel_group_count = {
+      width * height / HISTOGRAM_NUM_BINS, 1, 1};
+  ze_kernel_handle_t stages[] = {sobel_function, threshold_function,
+                                 histogram_function};
+  ze_group_count_t *stage_group_counts[] = {
+      &image_group_count, &pixel_group_count, &pixel_group_count};
+
+  if (chained) {
+    // Both uploads, then every launch waiting on the one before it, then
+    // the download: events are the only ordering in the command list
+    const uint32_t num_events = 3 * num_iterations + 2;
+    ze_event_pool_desc_t event_pool_desc = {};
+    event_pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+    event_pool_desc.flags = 0;
+    event_pool_desc.count = num_events;
+    ZE_CHECK_RESULT(zeEventPoolCreate(context, &event_pool_desc, 1, &device,
+                                      &event_pool));
+    events.assign(num_events, nullptr);
+    for (uint32_t i = 0; i < num_events; i++) {
+      ze_event_desc_t event_desc = {};
+      event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+      event_desc.index = i;
+      event_desc.signal = ZE_EVENT_SCOPE_FLAG_DEVICE;
+      event_desc.wait = ZE_EVENT_SCOPE_FLAG_DEVICE;
+      ZE_CHECK_RESULT(zeEventCreate(event_pool, &event_desc, &events[i]));
+    }
+
+    create_stage_cmdlist(command_list);
+    ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(
+        command_list, input_buffer, lena_original.data(), image_buffer_size,
+        events[0], 0, nullptr));
+    ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(
+        command_list, bins_buffer, bins_zero.data(), bins_buffer_size,
+        events[1], 0, nullptr));
+    for (uint32_t i = 0; i < 3 * num_iterations; ++i) {
+      const uint32_t num_wait_events = i == 0 ? 2 : 1;
+      ZE_CHECK_RESULT(zeCommandListAppendLaunchKernel(
+          command_list, stages[i % 3], stage_group_counts[i % 3],
+          events[i + 2], num_wait_events, &events[i + 2 - num_wait_events]));
+    }
+    ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(
+        command_list, bins_GPU.data(), bins_buffer, bins_buffer_size, nullptr,
+        1, &events[num_events - 1]));
+    ZE_CHECK_RESULT(
+        zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+    for (auto event : events) {
+      ZE_CHECK_RESULT(zeCommandListAppendEventReset(command_list, event));
+    }
+    ZE_CHECK_RESULT(zeCommandListClose(command_list));
+  } else {
+    create_stage_cmdlist(upload_command_list);
+    ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(
+        upload_command_list, input_buffer, lena_original.data(),
+        image_buffer_size, nullptr, 0, nullptr));
+    ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(
+        upload_command_list, bins_buffer, bins_zero.data(), bins_buffer_size,
+        nullptr, 0, nullptr));
+    ZE_CHECK_RESULT(zeCommandListClose(upload_command_list));
+
+    ze_command_list_handle_t *stage_command_lists[] = {
+        &sobel_command_list, &threshold_command_list,
+        &histogram_command_list};
+    for (int i = 0; i < 3; i++) {
+      create_stage_cmdlist(*stage_command_lists[i]);
+      ZE_CHECK_RESULT(zeCommandListAppendLaunchKernel(
+          *stage_command_lists[i], stages[i], stage_group_counts[i], nullptr,
+          0, nullptr));
+      ZE_CHECK_RESULT(zeCommandListClose(*stage_command_lists[i]));
+    }
+
+    create_stage_cmdlist(download_command_list);
+    ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(
+        download_command_list, bins_GPU.data(), bins_buffer, bins_buffer_size,
+        nullptr, 0, nullptr));
+    ZE_CHECK_RESULT(zeCommandListClose(download_command_list));
+  }
+
+  ze_command_queue_desc_t command_queue_description = {};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.pNext = nullptr;
+  command_queue_description.ordinal = 0;
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  ZE_CHECK_RESULT(zeCommandQueueCreate(
+      context, device, &command_queue_description, &command_queue));
+}
+
+void ZePipeline::execute_stage(ze_command_list_handle_t command_list) {
+  ZE_CHECK_RESULT(zeCommandQueueExecuteCommandLists(command_queue, 1,
+                                                    &command_list, nullptr));
+  ZE_CHECK_RESULT(zeCommandQueueSynchronize(command_queue, UINT64_MAX));
+}
+
+void ZePipeline::execute_work() {
+  if (chained) {
+    execute_stage(command_list);
+    return;
+  }
+
+  execute_stage(upload_command_list);
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    execute_stage(sobel_command_list);
+    execute_stage(threshold_command_list);
+    execute_stage(histogram_command_list);
+  }
+  execute_stage(download_command_list);
+}
+
+bool ZePipeline::verify_results() {
+  for (unsigned int i = 0; i < HISTOGRAM_NUM_BINS; i++) {
+    if (bins_GPU[i] != bins_CPU[i]) {
+      printf("\nGPU %u vs. CPU %u\n", bins_GPU[i], bins_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ZePipeline::cleanup() {
+  ZE_CHECK_RESULT(zeCommandQueueDestroy(command_queue));
+  if (chained) {
+    ZE_CHECK_RESULT(zeCommandListDestroy(command_list));
+    for (auto event : events) {
+      ZE_CHECK_RESULT(zeEventDestroy(event));
+    }
+    ZE_CHECK_RESULT(zeEventPoolDestroy(event_pool));
+  } else {
+    ZE_CHECK_RESULT(zeCommandListDestroy(upload_command_list));
+    ZE_CHECK_RESULT(zeCommandListDestroy(sobel_command_list));
+    ZE_CHECK_RESULT(zeCommandListDestroy(threshold_command_list));
+    ZE_CHECK_RESULT(zeCommandListDestroy(histogram_command_list));
+    ZE_CHECK_RESULT(zeCommandListDestroy(download_command_list));
+  }
+  ZE_CHECK_RESULT(zeKernelDestroy(histogram_function));
+  ZE_CHECK_RESULT(zeKernelDestroy(threshold_function));
+  ZE_CHECK_RESULT(zeKernelDestroy(sobel_function));
+  ZE_CHECK_RESULT(zeModuleDestroy(module));
+  ZE_CHECK_RESULT(zeMemFree(context, bins_buffer));
+  ZE_CHECK_RESULT(zeMemFree(context, threshold_buffer));
+  ZE_CHECK_RESULT(zeMemFree(context, sobel_buffer));
+  ZE_CHECK_RESULT(zeMemFree(context, input_buffer));
+  ZE_CHECK_RESULT(zeContextDestroy(context));
+}
+
+} // namespace compute_api_bench
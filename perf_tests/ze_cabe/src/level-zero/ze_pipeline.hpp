@@ -0,0 +1,76 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_ZE_PIPELINE_HPP
+#define COMPUTE_API_BENCH_ZE_PIPELINE_HPP
+
+#include <vector>
+#include <string>
+#include "ze_workload.hpp"
+
+namespace compute_api_bench {
+
+// Sobel, threshold and histogram run back to back on one image. Chained,
+// the three kernels are ordered by events in one command list; otherwise
+// every kernel is a submission of its own, synchronized on the host.
+class ZePipeline : public ZeWorkload {
+public:
+  ZePipeline(level_zero_tests::ImageBMP8Bit image, unsigned int num_iterations,
+             bool chained);
+  ~ZePipeline();
+
+  void build_program();
+  void save_native_binary();
+  void build_program_native();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  void create_kernel(const char *kernel_name, ze_kernel_handle_t &function);
+  void create_stage_cmdlist(ze_command_list_handle_t &command_list);
+  void execute_stage(ze_command_list_handle_t command_list);
+
+  size_t kernel_length;
+  std::string kernel_code;
+  std::vector<uint8_t> kernel_spv;
+  uint32_t image_buffer_size;
+  uint32_t bins_buffer_size;
+  std::vector<uint32_t> lena_original;
+  std::vector<uint32_t> bins_GPU;
+  std::vector<uint32_t> bins_CPU;
+  std::vector<uint32_t> bins_zero;
+  unsigned int num_iterations;
+  unsigned int width;
+  unsigned int height;
+  bool chained;
+  uint32_t threshold_level = PIPELINE_THRESHOLD_LEVEL;
+  void *input_buffer = nullptr;
+  void *sobel_buffer = nullptr;
+  void *threshold_buffer = nullptr;
+  void *bins_buffer = nullptr;
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t sobel_function = nullptr;
+  ze_kernel_handle_t threshold_function = nullptr;
+  ze_kernel_handle_t histogram_function = nullptr;
+  ze_command_queue_handle_t command_queue = nullptr;
+  ze_command_list_handle_t command_list = nullptr;
+  ze_event_pool_handle_t event_pool = nullptr;
+  std::vector<ze_event_handle_t> events;
+  ze_command_list_handle_t upload_command_list = nullptr;
+  ze_command_list_handle_t sobel_command_list = nullptr;
+  ze_command_list_handle_t threshold_command_list = nullptr;
+  ze_command_list_handle_t histogram_command_list = nullptr;
+  ze_command_list_handle_t download_command_list = nullptr;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_ZE_PIPELINE_HPP
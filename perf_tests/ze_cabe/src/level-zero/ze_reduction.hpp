@@ -0,0 +1,53 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_ZE_REDUCTION_HPP
+#define COMPUTE_API_BENCH_ZE_REDUCTION_HPP
+
+#include <vector>
+#include <string>
+#include "ze_workload.hpp"
+
+namespace compute_api_bench {
+
+class ZeReduction : public ZeWorkload {
+public:
+  ZeReduction(unsigned int num_elements, unsigned int num_iterations);
+  ~ZeReduction();
+
+  void build_program();
+  void save_native_binary();
+  void build_program_native();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  size_t kernel_length;
+  std::string kernel_code;
+  std::vector<uint8_t> kernel_spv;
+  size_t input_buffer_size;
+  std::vector<int> input;
+  int sum_GPU = 0;
+  int sum_CPU = 0;
+  const int sum_zero = 0;
+  unsigned int num_elements;
+  unsigned int num_iterations;
+  void *input_buffer = nullptr;
+  void *sum_buffer = nullptr;
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t function = nullptr;
+  ze_command_queue_handle_t command_queue = nullptr;
+  ze_command_list_handle_t command_list = nullptr;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_ZE_REDUCTION_HPP
@@ -40,6 +40,14 @@ void ZeSimpleAdd::build_program() {
   ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
 }
 
+void ZeSimpleAdd::save_native_binary() {
+  save_module_native_binary(module, function);
+}
+
+void ZeSimpleAdd::build_program_native() {
+  prepare_program_from_native(module, function, "NaiveAdd");
+}
+
 void ZeSimpleAdd::create_buffers() {
   ze_device_mem_alloc_desc_t device_desc = {
       ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC, nullptr};
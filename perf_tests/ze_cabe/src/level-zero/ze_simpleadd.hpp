@@ -21,6 +21,8 @@ public:
   ~ZeSimpleAdd();
 
   void build_program();
+  void save_native_binary();
+  void build_program_native();
   void create_buffers();
   void create_cmdlist();
   void execute_work();
@@ -0,0 +1,149 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_stencil.hpp"
+
+namespace compute_api_bench {
+
+ZeStencil::ZeStencil(unsigned int nx, unsigned int ny, unsigned int nz,
+                     unsigned int num_iterations)
+    : ZeWorkload(), nx(nx), ny(ny), nz(nz), num_iterations(num_iterations) {
+  workload_name = "Stencil";
+  grid_buffer_size = nx * ny * nz * sizeof(float);
+  input.assign(nx * ny * nz, 0);
+  output_GPU.assign(nx * ny * nz, 0);
+  output_CPU.assign(nx * ny * nz, 0);
+
+  srand(1);
+  for (unsigned int i = 0; i < nx * ny * nz; i++) {
+    input[i] = (float)rand() / RAND_MAX;
+  }
+
+  stencil_cpu(input.data(), output_CPU.data(), nx, ny, nz);
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_stencil.spv");
+}
+
+ZeStencil::~ZeStencil() {}
+
+void ZeStencil::build_program() {
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+
+  module_description.pNext = nullptr;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = kernel_length;
+  module_description.pInputModule = kernel_spv.data();
+  module_description.pBuildFlags = nullptr;
+  ZE_CHECK_RESULT(
+      zeModuleCreate(context, device, &module_description, &module, nullptr));
+
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  function_description.pNext = nullptr;
+  function_description.flags = 0;
+  function_description.pKernelName = "stencil";
+  ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
+}
+
+void ZeStencil::save_native_binary() {
+  save_module_native_binary(module, function);
+}
+
+void ZeStencil::build_program_native() {
+  prepare_program_from_native(module, function, "stencil");
+}
+
+void ZeStencil::create_buffers() {
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  device_desc.ordinal = 0;
+  device_desc.flags = 0;
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, grid_buffer_size,
+                                   1, device, &input_buffer));
+  ZE_CHECK_RESULT(zeMemAllocDevice(context, &device_desc, grid_buffer_size,
+                                   1, device, &output_buffer));
+}
+
+void ZeStencil::create_cmdlist() {
+  uint32_t group_size_x = 8;
+  uint32_t group_size_y = 8;
+  uint32_t group_size_z = 4;
+
+  ZE_CHECK_RESULT(
+      zeKernelSetGroupSize(function, group_size_x, group_size_y, group_size_z));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(function, 0, sizeof(input_buffer),
+                                           &input_buffer));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(function, 1, sizeof(output_buffer),
+                                           &output_buffer));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(function, 2, sizeof(int), &nx));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(function, 3, sizeof(int), &ny));
+  ZE_CHECK_RESULT(zeKernelSetArgumentValue(function, 4, sizeof(int), &nz));
+
+  ze_command_list_desc_t command_list_description = {};
+  command_list_description.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+  command_list_description.pNext = nullptr;
+  ZE_CHECK_RESULT(zeCommandListCreate(
+      context, device, &command_list_description, &command_list));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(command_list, input_buffer,
+                                                input.data(), grid_buffer_size,
+                                                nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(
+      zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = nx / group_size_x;
+  group_count.groupCountY = ny / group_size_y;
+  group_count.groupCountZ = nz / group_size_z;
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    ZE_CHECK_RESULT(zeCommandListAppendLaunchKernel(
+        command_list, function, &group_count, nullptr, 0, nullptr));
+  }
+  ZE_CHECK_RESULT(
+      zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListAppendMemoryCopy(
+      command_list, output_GPU.data(), output_buffer, grid_buffer_size,
+      nullptr, 0, nullptr));
+  ZE_CHECK_RESULT(zeCommandListClose(command_list));
+
+  ze_command_queue_desc_t command_queue_description = {};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.pNext = nullptr;
+  command_queue_description.ordinal = 0;
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  ZE_CHECK_RESULT(zeCommandQueueCreate(
+      context, device, &command_queue_description, &command_queue));
+}
+
+void ZeStencil::execute_work() {
+  ZE_CHECK_RESULT(zeCommandQueueExecuteCommandLists(command_queue, 1,
+                                                    &command_list, nullptr));
+  ZE_CHECK_RESULT(zeCommandQueueSynchronize(command_queue, UINT64_MAX));
+}
+
+bool ZeStencil::verify_results() {
+  for (unsigned int i = 0; i < nx * ny * nz; i++) {
+    if (std::fabs(output_GPU[i] - output_CPU[i]) > 1e-5f) {
+      printf("\nGPU %f vs. CPU %f\n", output_GPU[i], output_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void ZeStencil::cleanup() {
+  ZE_CHECK_RESULT(zeCommandQueueDestroy(command_queue));
+  ZE_CHECK_RESULT(zeCommandListDestroy(command_list));
+  ZE_CHECK_RESULT(zeKernelDestroy(function));
+  ZE_CHECK_RESULT(zeModuleDestroy(module));
+  ZE_CHECK_RESULT(zeMemFree(context, output_buffer));
+  ZE_CHECK_RESULT(zeMemFree(context, input_buffer));
+  ZE_CHECK_RESULT(zeContextDestroy(context));
+}
+
+} // namespace compute_api_bench
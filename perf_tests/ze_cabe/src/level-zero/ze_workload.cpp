@@ -31,10 +31,113 @@ void ZeWorkload::create_device() {
   ZE_CHECK_RESULT(zeDeviceGet(driver_handle, &device_count, nullptr));
   if (device_count == 0)
     std::terminate();
-  device_count = 1;
-  ZE_CHECK_RESULT(zeDeviceGet(driver_handle, &device_count, &device));
+  if (device_index < 0) {
+    device_count = 1;
+    ZE_CHECK_RESULT(zeDeviceGet(driver_handle, &device_count, &device));
+  } else {
+    device = get_devices(driver_handle)[device_index];
+  }
+
+  if (device_name.empty()) {
+    read_device_properties();
+  }
+}
+
+void ZeWorkload::read_device_properties() {
+  ze_driver_properties_t driver_properties = {};
+  driver_properties.stype = ZE_STRUCTURE_TYPE_DRIVER_PROPERTIES;
+  ZE_CHECK_RESULT(zeDriverGetProperties(driver_handle, &driver_properties));
+  driver_version = std::to_string(driver_properties.driverVersion);
+
+  ze_device_properties_t properties = {};
+  properties.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  ZE_CHECK_RESULT(zeDeviceGetProperties(device, &properties));
+  const bool subdevice = properties.flags & ZE_DEVICE_PROPERTY_FLAG_SUBDEVICE;
+  device_name = properties.name;
+  if (subdevice) {
+    device_name +=
+        " (subdevice " + std::to_string(properties.subdeviceId) + ")";
+  }
+
+  device_properties = {
+      {"vendor_id", std::to_string(properties.vendorId)},
+      {"device_id", std::to_string(properties.deviceId)},
+      {"subdevice", subdevice ? "true" : "false"},
+      {"core_clock_rate_mhz", std::to_string(properties.coreClockRate)},
+      {"max_mem_alloc_size", std::to_string(properties.maxMemAllocSize)},
+      {"num_slices", std::to_string(properties.numSlices)},
+      {"num_subslices_per_slice",
+       std::to_string(properties.numSubslicesPerSlice)},
+      {"num_eus_per_subslice", std::to_string(properties.numEUsPerSubslice)},
+      {"num_threads_per_eu", std::to_string(properties.numThreadsPerEU)}};
+}
+
+std::vector<ze_device_handle_t>
+ZeWorkload::get_devices(ze_driver_handle_t driver_handle) {
+  uint32_t device_count = 0;
+  ZE_CHECK_RESULT(zeDeviceGet(driver_handle, &device_count, nullptr));
+  std::vector<ze_device_handle_t> root_devices(device_count);
+  ZE_CHECK_RESULT(
+      zeDeviceGet(driver_handle, &device_count, root_devices.data()));
+
+  std::vector<ze_device_handle_t> devices;
+  for (auto root_device : root_devices) {
+    uint32_t sub_device_count = 0;
+    ZE_CHECK_RESULT(
+        zeDeviceGetSubDevices(root_device, &sub_device_count, nullptr));
+    if (sub_device_count == 0) {
+      devices.push_back(root_device);
+      continue;
+    }
+    std::vector<ze_device_handle_t> sub_devices(sub_device_count);
+    ZE_CHECK_RESULT(zeDeviceGetSubDevices(root_device, &sub_device_count,
+                                          sub_devices.data()));
+    devices.insert(devices.end(), sub_devices.begin(), sub_devices.end());
+  }
+  return devices;
+}
+
+unsigned int ZeWorkload::count_devices() {
+  ZE_CHECK_RESULT(zeInit(0));
+
+  uint32_t driverCount = 0;
+  ZE_CHECK_RESULT(zeDriverGet(&driverCount, nullptr));
+  if (driverCount == 0)
+    return 0;
+  ze_driver_handle_t driver_handle = nullptr;
+  driverCount = 1;
+  ZE_CHECK_RESULT(zeDriverGet(&driverCount, &driver_handle));
+  return get_devices(driver_handle).size();
 }
 
 void ZeWorkload::prepare_program() {}
 
+void ZeWorkload::save_module_native_binary(ze_module_handle_t &module,
+                                           ze_kernel_handle_t &function) {
+  size_t binary_size = 0;
+  ZE_CHECK_RESULT(zeModuleGetNativeBinary(module, &binary_size, nullptr));
+  native_binary.resize(binary_size);
+  ZE_CHECK_RESULT(
+      zeModuleGetNativeBinary(module, &binary_size, native_binary.data()));
+  ZE_CHECK_RESULT(zeKernelDestroy(function));
+  ZE_CHECK_RESULT(zeModuleDestroy(module));
+}
+
+void ZeWorkload::prepare_program_from_native(ze_module_handle_t &module,
+                                             ze_kernel_handle_t &function,
+                                             const char *kernel_name) {
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+  module_description.format = ZE_MODULE_FORMAT_NATIVE;
+  module_description.inputSize = native_binary.size();
+  module_description.pInputModule = native_binary.data();
+  ZE_CHECK_RESULT(
+      zeModuleCreate(context, device, &module_description, &module, nullptr));
+
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  function_description.pKernelName = kernel_name;
+  ZE_CHECK_RESULT(zeKernelCreate(module, &function_description, &function));
+}
+
 } // namespace compute_api_bench
@@ -32,9 +32,21 @@ public:
   ZeWorkload();
   virtual ~ZeWorkload();
 
+  // Devices without subdevices and the subdevices of the others, which
+  // device_index refers to
+  static std::vector<ze_device_handle_t>
+  get_devices(ze_driver_handle_t driver_handle);
+  static unsigned int count_devices();
+
 protected:
   void create_device();
+  void read_device_properties();
   void prepare_program();
+  void save_module_native_binary(ze_module_handle_t &module,
+                                 ze_kernel_handle_t &function);
+  void prepare_program_from_native(ze_module_handle_t &module,
+                                   ze_kernel_handle_t &function,
+                                   const char *kernel_name);
   virtual void build_program() = 0;
   virtual void create_buffers() = 0;
   virtual void create_cmdlist() = 0;
@@ -45,6 +57,7 @@ protected:
   size_t kernel_length;
   std::string kernel_code;
   std::vector<uint8_t> kernel_spv;
+  std::vector<uint8_t> native_binary;
   ze_device_handle_t device = nullptr;
   ze_driver_handle_t driver_handle = nullptr;
   ze_context_handle_t context = nullptr;
@@ -0,0 +1,101 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ocl_gemm.hpp"
+
+namespace compute_api_bench {
+
+OCLGemm::OCLGemm(unsigned int size, unsigned int num_iterations)
+    : OCLWorkload(), size(size), num_iterations(num_iterations) {
+  workload_name = "GEMM";
+  matrix_buffer_size = size * size * sizeof(float);
+  a.assign(size * size, 0);
+  b.assign(size * size, 0);
+  c.assign(size * size, 0);
+  c_CPU.assign(size * size, 0);
+
+  // Small integers keep every partial sum exact in fp32
+  for (unsigned int i = 0; i < size * size; i++) {
+    a[i] = (float)(i % 7);
+    b[i] = (float)(i % 5);
+  }
+
+  gemm_cpu(a.data(), b.data(), c_CPU.data(), size);
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_gemm.spv");
+}
+
+OCLGemm::~OCLGemm() {}
+
+void OCLGemm::build_program() { prepare_program_from_binary(); }
+
+void OCLGemm::create_buffers() {
+  memobj_a =
+      clCreateBuffer(context, CL_MEM_READ_ONLY, matrix_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_b =
+      clCreateBuffer(context, CL_MEM_READ_ONLY, matrix_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_c = clCreateBuffer(context, CL_MEM_WRITE_ONLY, matrix_buffer_size,
+                            NULL, &ret);
+  CL_CHECK_RESULT(ret);
+}
+
+void OCLGemm::create_cmdlist() {
+  command_queue = clCreateCommandQueue(context, device_id, 0, &ret);
+  CL_CHECK_RESULT(ret);
+  kernel = clCreateKernel(program, "gemm", &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(clSetKernelArg(kernel, 0, sizeof(cl_mem), (void *)&memobj_a));
+  CL_CHECK_RESULT(clSetKernelArg(kernel, 1, sizeof(cl_mem), (void *)&memobj_b));
+  CL_CHECK_RESULT(clSetKernelArg(kernel, 2, sizeof(cl_mem), (void *)&memobj_c));
+  CL_CHECK_RESULT(clSetKernelArg(kernel, 3, sizeof(int), &size));
+}
+
+void OCLGemm::execute_work() {
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_a, CL_TRUE, 0,
+                                       matrix_buffer_size, a.data(), 0, NULL,
+                                       NULL));
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_b, CL_TRUE, 0,
+                                       matrix_buffer_size, b.data(), 0, NULL,
+                                       NULL));
+  size_t global_item_size[2] = {size, size};
+  size_t local_item_size[2] = {GEMM_TILE_SIZE, GEMM_TILE_SIZE};
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    CL_CHECK_RESULT(clEnqueueNDRangeKernel(command_queue, kernel, 2, NULL,
+                                           global_item_size, local_item_size, 0,
+                                           NULL, NULL));
+  }
+  CL_CHECK_RESULT(clEnqueueReadBuffer(command_queue, memobj_c, CL_TRUE, 0,
+                                      matrix_buffer_size, c.data(), 0, NULL,
+                                      NULL));
+}
+
+bool OCLGemm::verify_results() {
+  for (unsigned int i = 0; i < size * size; i++) {
+    if (c[i] != c_CPU[i]) {
+      printf("\nGPU %f vs. CPU %f\n", c[i], c_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void OCLGemm::cleanup() {
+  CL_CHECK_RESULT(clFlush(command_queue));
+  CL_CHECK_RESULT(clFinish(command_queue));
+  CL_CHECK_RESULT(clReleaseKernel(kernel));
+  CL_CHECK_RESULT(clReleaseProgram(program));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_a));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_b));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_c));
+  CL_CHECK_RESULT(clReleaseCommandQueue(command_queue));
+  CL_CHECK_RESULT(clReleaseContext(context));
+}
+
+} // namespace compute_api_bench
@@ -0,0 +1,46 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_OCL_GEMM_HPP
+#define COMPUTE_API_BENCH_OCL_GEMM_HPP
+
+#include <vector>
+#include <string>
+#include "ocl_workload.hpp"
+
+namespace compute_api_bench {
+
+class OCLGemm : public OCLWorkload {
+public:
+  OCLGemm(unsigned int size, unsigned int num_iterations);
+  ~OCLGemm();
+
+  void build_program();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  cl_kernel kernel = NULL;
+  cl_mem memobj_a = NULL;
+  cl_mem memobj_b = NULL;
+  cl_mem memobj_c = NULL;
+  size_t matrix_buffer_size;
+  std::vector<float> a;
+  std::vector<float> b;
+  std::vector<float> c;
+  std::vector<float> c_CPU;
+  unsigned int size;
+  unsigned int num_iterations;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_OCL_GEMM_HPP
@@ -0,0 +1,104 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ocl_histogram.hpp"
+
+namespace compute_api_bench {
+
+OCLHistogram::OCLHistogram(unsigned int num_elements,
+                           unsigned int num_iterations)
+    : OCLWorkload(), num_elements(num_elements),
+      num_iterations(num_iterations) {
+  workload_name = "Histogram";
+  input_buffer_size = num_elements * sizeof(uint32_t);
+  bins_buffer_size = HISTOGRAM_NUM_BINS * sizeof(uint32_t);
+  input.assign(num_elements, 0);
+  bins_GPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_CPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_zero.assign(HISTOGRAM_NUM_BINS, 0);
+
+  srand(1);
+  for (unsigned int i = 0; i < num_elements; i++) {
+    input[i] = (uint32_t)rand() % HISTOGRAM_NUM_BINS;
+  }
+
+  // Every launch adds its counts to the bins, which are reset once per
+  // execution
+  histogram_cpu(input.data(), bins_CPU.data(), num_elements);
+  for (auto &bin : bins_CPU) {
+    bin *= num_iterations;
+  }
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_histogram.spv");
+}
+
+OCLHistogram::~OCLHistogram() {}
+
+void OCLHistogram::build_program() { prepare_program_from_binary(); }
+
+void OCLHistogram::create_buffers() {
+  memobj_input =
+      clCreateBuffer(context, CL_MEM_READ_ONLY, input_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_bins =
+      clCreateBuffer(context, CL_MEM_READ_WRITE, bins_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+}
+
+void OCLHistogram::create_cmdlist() {
+  command_queue = clCreateCommandQueue(context, device_id, 0, &ret);
+  CL_CHECK_RESULT(ret);
+  kernel = clCreateKernel(program, "histogram", &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(
+      clSetKernelArg(kernel, 0, sizeof(cl_mem), (void *)&memobj_input));
+  CL_CHECK_RESULT(
+      clSetKernelArg(kernel, 1, sizeof(cl_mem), (void *)&memobj_bins));
+}
+
+void OCLHistogram::execute_work() {
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_input, CL_TRUE, 0,
+                                       input_buffer_size, input.data(), 0,
+                                       NULL, NULL));
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_bins, CL_TRUE, 0,
+                                       bins_buffer_size, bins_zero.data(), 0,
+                                       NULL, NULL));
+  size_t global_item_size[1] = {num_elements};
+  size_t local_item_size[1] = {HISTOGRAM_NUM_BINS};
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    CL_CHECK_RESULT(clEnqueueNDRangeKernel(command_queue, kernel, 1, NULL,
+                                           global_item_size, local_item_size, 0,
+                                           NULL, NULL));
+  }
+  CL_CHECK_RESULT(clEnqueueReadBuffer(command_queue, memobj_bins, CL_TRUE, 0,
+                                      bins_buffer_size, bins_GPU.data(), 0,
+                                      NULL, NULL));
+}
+
+bool OCLHistogram::verify_results() {
+  for (unsigned int i = 0; i < HISTOGRAM_NUM_BINS; i++) {
+    if (bins_GPU[i] != bins_CPU[i]) {
+      printf("\nGPU %u vs. CPU %u\n", bins_GPU[i], bins_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void OCLHistogram::cleanup() {
+  CL_CHECK_RESULT(clFlush(command_queue));
+  CL_CHECK_RESULT(clFinish(command_queue));
+  CL_CHECK_RESULT(clReleaseKernel(kernel));
+  CL_CHECK_RESULT(clReleaseProgram(program));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_input));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_bins));
+  CL_CHECK_RESULT(clReleaseCommandQueue(command_queue));
+  CL_CHECK_RESULT(clReleaseContext(context));
+}
+
+} // namespace compute_api_bench
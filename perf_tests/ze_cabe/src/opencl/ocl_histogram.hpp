@@ -0,0 +1,46 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_OCL_HISTOGRAM_HPP
+#define COMPUTE_API_BENCH_OCL_HISTOGRAM_HPP
+
+#include <vector>
+#include <string>
+#include "ocl_workload.hpp"
+
+namespace compute_api_bench {
+
+class OCLHistogram : public OCLWorkload {
+public:
+  OCLHistogram(unsigned int num_elements, unsigned int num_iterations);
+  ~OCLHistogram();
+
+  void build_program();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  cl_kernel kernel = NULL;
+  cl_mem memobj_input = NULL;
+  cl_mem memobj_bins = NULL;
+  size_t input_buffer_size;
+  size_t bins_buffer_size;
+  std::vector<uint32_t> input;
+  std::vector<uint32_t> bins_GPU;
+  std::vector<uint32_t> bins_CPU;
+  std::vector<uint32_t> bins_zero;
+  unsigned int num_elements;
+  unsigned int num_iterations;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_OCL_HISTOGRAM_HPP
@@ -0,0 +1,155 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ocl_pipeline.hpp"
+
+namespace compute_api_bench {
+
+OCLPipeline::OCLPipeline(level_zero_tests::ImageBMP8Bit image,
+                         unsigned int num_iterations, bool chained)
+    : OCLWorkload(), num_iterations(num_iterations), chained(chained) {
+  workload_name = chained ? "Pipeline (chained)" : "Pipeline (separate)";
+  width = image.width();
+  height = image.height();
+  image_buffer_size = width * height * sizeof(uint32_t);
+  bins_buffer_size = HISTOGRAM_NUM_BINS * sizeof(uint32_t);
+  lena_original.assign(width * height, 0);
+  bins_GPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_CPU.assign(HISTOGRAM_NUM_BINS, 0);
+  bins_zero.assign(HISTOGRAM_NUM_BINS, 0);
+
+  for (unsigned int i = 0; i < width; i++) {
+    for (unsigned int j = 0; j < height; j++) {
+      lena_original[i + j * width] = (uint32_t)image.get_pixel(i, j);
+    }
+  }
+
+  // Every pass adds its counts to the bins, which are reset once per
+  // execution
+  std::vector<uint32_t> filtered(width * height, 0);
+  sobel_cpu(lena_original.data(), filtered.data(), width, height);
+  threshold_cpu(filtered.data(), filtered.data(), threshold_level,
+                width * height);
+  histogram_cpu(filtered.data(), bins_CPU.data(), width * height);
+  for (auto &bin : bins_CPU) {
+    bin *= num_iterations;
+  }
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_pipeline.spv");
+}
+
+OCLPipeline::~OCLPipeline() {}
+
+void OCLPipeline::build_program() { prepare_program_from_binary(); }
+
+void OCLPipeline::create_buffers() {
+  memobj_original =
+      clCreateBuffer(context, CL_MEM_READ_WRITE, image_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_filtered =
+      clCreateBuffer(context, CL_MEM_READ_WRITE, image_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_thresholded =
+      clCreateBuffer(context, CL_MEM_READ_WRITE, image_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_bins =
+      clCreateBuffer(context, CL_MEM_READ_WRITE, bins_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+}
+
+void OCLPipeline::create_cmdlist() {
+  command_queue = clCreateCommandQueue(context, device_id, 0, &ret);
+  CL_CHECK_RESULT(ret);
+
+  sobel_kernel = clCreateKernel(program, "sobel", &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(clSetKernelArg(sobel_kernel, 0, sizeof(cl_mem),
+                                 (void *)&memobj_original));
+  CL_CHECK_RESULT(clSetKernelArg(sobel_kernel, 1, sizeof(cl_mem),
+                                 (void *)&memobj_filtered));
+  CL_CHECK_RESULT(clSetKernelArg(sobel_kernel, 2, sizeof(int), &width));
+  CL_CHECK_RESULT(clSetKernelArg(sobel_kernel, 3, sizeof(int), &height));
+
+  threshold_kernel = clCreateKernel(program, "threshold", &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(clSetKernelArg(threshold_kernel, 0, sizeof(cl_mem),
+                                 (void *)&memobj_filtered));
+  CL_CHECK_RESULT(clSetKernelArg(threshold_kernel, 1, sizeof(cl_mem),
+                                 (void *)&memobj_thresholded));
+  CL_CHECK_RESULT(clSetKernelArg(threshold_kernel, 2, sizeof(uint32_t),
+                                 &threshold_level));
+
+  histogram_kernel = clCreateKernel(program, "histogram", &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(clSetKernelArg(histogram_kernel, 0, sizeof(cl_mem),
+                                 (void *)&memobj_thresholded));
+  CL_CHECK_RESULT(clSetKernelArg(histogram_kernel, 1, sizeof(cl_mem),
+                                 (void *)&memobj_bins));
+}
+
+void OCLPipeline::enqueue_kernel(cl_kernel kernel, cl_uint work_dim,
+                                 const size_t *global_item_size,
+                                 const size_t *local_item_size) {
+  CL_CHECK_RESULT(clEnqueueNDRangeKernel(command_queue, kernel, work_dim,
+                                         NULL, global_item_size,
+                                         local_item_size, 0, NULL, NULL));
+  if (!chained) {
+    CL_CHECK_RESULT(clFinish(command_queue));
+  }
+}
+
+void OCLPipeline::execute_work() {
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_original, CL_TRUE,
+                                       0, image_buffer_size,
+                                       lena_original.data(), 0, NULL, NULL));
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_bins, CL_TRUE, 0,
+                                       bins_buffer_size, bins_zero.data(), 0,
+                                       NULL, NULL));
+  size_t image_global_item_size[2] = {width, height};
+  size_t image_local_item_size[2] = {16, 16};
+  size_t pixel_global_item_size[1] = {width * height};
+  size_t pixel_local_item_size[1] = {HISTOGRAM_NUM_BINS};
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    enqueue_kernel(sobel_kernel, 2, image_global_item_size,
+                   image_local_item_size);
+    enqueue_kernel(threshold_kernel, 1, pixel_global_item_size,
+                   pixel_local_item_size);
+    enqueue_kernel(histogram_kernel, 1, pixel_global_item_size,
+                   pixel_local_item_size);
+  }
+  CL_CHECK_RESULT(clEnqueueReadBuffer(command_queue, memobj_bins, CL_TRUE, 0,
+                                      bins_buffer_size, bins_GPU.data(), 0,
+                                      NULL, NULL));
+}
+
+bool OCLPipeline::verify_results() {
+  for (unsigned int i = 0; i < HISTOGRAM_NUM_BINS; i++) {
+    if (bins_GPU[i] != bins_CPU[i]) {
+      printf("\nGPU %u vs. CPU %u\n", bins_GPU[i], bins_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void OCLPipeline::cleanup() {
+  CL_CHECK_RESULT(clFlush(command_queue));
+  CL_CHECK_RESULT(clFinish(command_queue));
+  CL_CHECK_RESULT(clReleaseKernel(histogram_kernel));
+  CL_CHECK_RESULT(clReleaseKernel(threshold_kernel));
+  CL_CHECK_RESULT(clReleaseKernel(sobel_kernel));
+  CL_CHECK_RESULT(clReleaseProgram(program));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_original));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_filtered));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_thresholded));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_bins));
+  CL_CHECK_RESULT(clReleaseCommandQueue(command_queue));
+  CL_CHECK_RESULT(clReleaseContext(context));
+}
+
+} // namespace compute_api_bench
@@ -0,0 +1,61 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_OCL_PIPELINE_HPP
+#define COMPUTE_API_BENCH_OCL_PIPELINE_HPP
+
+#include <vector>
+#include <string>
+#include "ocl_workload.hpp"
+
+namespace compute_api_bench {
+
+// Sobel, threshold and histogram run back to back on one image. Chained,
+// the three kernels are ordered by the in-order queue alone; otherwise
+// the host waits for every kernel before enqueuing the next one.
+class OCLPipeline : public OCLWorkload {
+public:
+  OCLPipeline(level_zero_tests::ImageBMP8Bit image, unsigned int num_iterations,
+              bool chained);
+  ~OCLPipeline();
+
+  void build_program();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  void enqueue_kernel(cl_kernel kernel, cl_uint work_dim,
+                      const size_t *global_item_size,
+                      const size_t *local_item_size);
+
+  cl_kernel sobel_kernel = NULL;
+  cl_kernel threshold_kernel = NULL;
+  cl_kernel histogram_kernel = NULL;
+  cl_mem memobj_original = NULL;
+  cl_mem memobj_filtered = NULL;
+  cl_mem memobj_thresholded = NULL;
+  cl_mem memobj_bins = NULL;
+  uint32_t image_buffer_size;
+  uint32_t bins_buffer_size;
+  std::vector<uint32_t> lena_original;
+  std::vector<uint32_t> bins_GPU;
+  std::vector<uint32_t> bins_CPU;
+  std::vector<uint32_t> bins_zero;
+  unsigned int num_iterations;
+  unsigned int width;
+  unsigned int height;
+  bool chained;
+  uint32_t threshold_level = PIPELINE_THRESHOLD_LEVEL;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_OCL_PIPELINE_HPP
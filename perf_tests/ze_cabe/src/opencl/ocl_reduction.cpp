@@ -0,0 +1,94 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ocl_reduction.hpp"
+
+namespace compute_api_bench {
+
+OCLReduction::OCLReduction(unsigned int num_elements,
+                           unsigned int num_iterations)
+    : OCLWorkload(), num_elements(num_elements),
+      num_iterations(num_iterations) {
+  workload_name = "Reduction";
+  input_buffer_size = num_elements * sizeof(int);
+  input.assign(num_elements, 0);
+
+  for (unsigned int i = 0; i < num_elements; i++) {
+    input[i] = i % 10;
+    sum_CPU += input[i];
+  }
+
+  // Every launch adds its sum to the result, which is reset once per
+  // execution
+  sum_CPU *= num_iterations;
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_reduction.spv");
+}
+
+OCLReduction::~OCLReduction() {}
+
+void OCLReduction::build_program() { prepare_program_from_binary(); }
+
+void OCLReduction::create_buffers() {
+  memobj_input =
+      clCreateBuffer(context, CL_MEM_READ_ONLY, input_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_sum =
+      clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(int), NULL, &ret);
+  CL_CHECK_RESULT(ret);
+}
+
+void OCLReduction::create_cmdlist() {
+  command_queue = clCreateCommandQueue(context, device_id, 0, &ret);
+  CL_CHECK_RESULT(ret);
+  kernel = clCreateKernel(program, "reduction", &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(
+      clSetKernelArg(kernel, 0, sizeof(cl_mem), (void *)&memobj_input));
+  CL_CHECK_RESULT(
+      clSetKernelArg(kernel, 1, sizeof(cl_mem), (void *)&memobj_sum));
+}
+
+void OCLReduction::execute_work() {
+  const int sum_zero = 0;
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_input, CL_TRUE, 0,
+                                       input_buffer_size, input.data(), 0,
+                                       NULL, NULL));
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_sum, CL_TRUE, 0,
+                                       sizeof(int), &sum_zero, 0, NULL, NULL));
+  size_t global_item_size[1] = {num_elements};
+  size_t local_item_size[1] = {REDUCTION_GROUP_SIZE};
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    CL_CHECK_RESULT(clEnqueueNDRangeKernel(command_queue, kernel, 1, NULL,
+                                           global_item_size, local_item_size, 0,
+                                           NULL, NULL));
+  }
+  CL_CHECK_RESULT(clEnqueueReadBuffer(command_queue, memobj_sum, CL_TRUE, 0,
+                                      sizeof(int), &sum_GPU, 0, NULL, NULL));
+}
+
+bool OCLReduction::verify_results() {
+  if (sum_GPU != sum_CPU) {
+    printf("\nGPU %d vs. CPU %d\n", sum_GPU, sum_CPU);
+    return false;
+  }
+
+  return true;
+}
+
+void OCLReduction::cleanup() {
+  CL_CHECK_RESULT(clFlush(command_queue));
+  CL_CHECK_RESULT(clFinish(command_queue));
+  CL_CHECK_RESULT(clReleaseKernel(kernel));
+  CL_CHECK_RESULT(clReleaseProgram(program));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_input));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_sum));
+  CL_CHECK_RESULT(clReleaseCommandQueue(command_queue));
+  CL_CHECK_RESULT(clReleaseContext(context));
+}
+
+} // namespace compute_api_bench
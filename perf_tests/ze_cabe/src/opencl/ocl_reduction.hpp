@@ -0,0 +1,44 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_OCL_REDUCTION_HPP
+#define COMPUTE_API_BENCH_OCL_REDUCTION_HPP
+
+#include <vector>
+#include <string>
+#include "ocl_workload.hpp"
+
+namespace compute_api_bench {
+
+class OCLReduction : public OCLWorkload {
+public:
+  OCLReduction(unsigned int num_elements, unsigned int num_iterations);
+  ~OCLReduction();
+
+  void build_program();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  cl_kernel kernel = NULL;
+  cl_mem memobj_input = NULL;
+  cl_mem memobj_sum = NULL;
+  size_t input_buffer_size;
+  std::vector<int> input;
+  int sum_GPU = 0;
+  int sum_CPU = 0;
+  unsigned int num_elements;
+  unsigned int num_iterations;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_OCL_REDUCTION_HPP
@@ -0,0 +1,96 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ocl_stencil.hpp"
+
+namespace compute_api_bench {
+
+OCLStencil::OCLStencil(unsigned int nx, unsigned int ny, unsigned int nz,
+                       unsigned int num_iterations)
+    : OCLWorkload(), nx(nx), ny(ny), nz(nz), num_iterations(num_iterations) {
+  workload_name = "Stencil";
+  grid_buffer_size = nx * ny * nz * sizeof(float);
+  input.assign(nx * ny * nz, 0);
+  output_GPU.assign(nx * ny * nz, 0);
+  output_CPU.assign(nx * ny * nz, 0);
+
+  srand(1);
+  for (unsigned int i = 0; i < nx * ny * nz; i++) {
+    input[i] = (float)rand() / RAND_MAX;
+  }
+
+  stencil_cpu(input.data(), output_CPU.data(), nx, ny, nz);
+  kernel_spv = load_binary_file(kernel_length, "ze_cabe_stencil.spv");
+}
+
+OCLStencil::~OCLStencil() {}
+
+void OCLStencil::build_program() { prepare_program_from_binary(); }
+
+void OCLStencil::create_buffers() {
+  memobj_input =
+      clCreateBuffer(context, CL_MEM_READ_ONLY, grid_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+  memobj_output =
+      clCreateBuffer(context, CL_MEM_WRITE_ONLY, grid_buffer_size, NULL, &ret);
+  CL_CHECK_RESULT(ret);
+}
+
+void OCLStencil::create_cmdlist() {
+  command_queue = clCreateCommandQueue(context, device_id, 0, &ret);
+  CL_CHECK_RESULT(ret);
+  kernel = clCreateKernel(program, "stencil", &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(
+      clSetKernelArg(kernel, 0, sizeof(cl_mem), (void *)&memobj_input));
+  CL_CHECK_RESULT(
+      clSetKernelArg(kernel, 1, sizeof(cl_mem), (void *)&memobj_output));
+  CL_CHECK_RESULT(clSetKernelArg(kernel, 2, sizeof(int), &nx));
+  CL_CHECK_RESULT(clSetKernelArg(kernel, 3, sizeof(int), &ny));
+  CL_CHECK_RESULT(clSetKernelArg(kernel, 4, sizeof(int), &nz));
+}
+
+void OCLStencil::execute_work() {
+  CL_CHECK_RESULT(clEnqueueWriteBuffer(command_queue, memobj_input, CL_TRUE, 0,
+                                       grid_buffer_size, input.data(), 0, NULL,
+                                       NULL));
+  size_t global_item_size[3] = {nx, ny, nz};
+  size_t local_item_size[3] = {8, 8, 4};
+  for (unsigned int i = 0; i < num_iterations; ++i) {
+    CL_CHECK_RESULT(clEnqueueNDRangeKernel(command_queue, kernel, 3, NULL,
+                                           global_item_size, local_item_size, 0,
+                                           NULL, NULL));
+  }
+  CL_CHECK_RESULT(clEnqueueReadBuffer(command_queue, memobj_output, CL_TRUE, 0,
+                                      grid_buffer_size, output_GPU.data(), 0,
+                                      NULL, NULL));
+}
+
+bool OCLStencil::verify_results() {
+  for (unsigned int i = 0; i < nx * ny * nz; i++) {
+    if (std::fabs(output_GPU[i] - output_CPU[i]) > 1e-5f) {
+      printf("\nGPU %f vs. CPU %f\n", output_GPU[i], output_CPU[i]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void OCLStencil::cleanup() {
+  CL_CHECK_RESULT(clFlush(command_queue));
+  CL_CHECK_RESULT(clFinish(command_queue));
+  CL_CHECK_RESULT(clReleaseKernel(kernel));
+  CL_CHECK_RESULT(clReleaseProgram(program));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_input));
+  CL_CHECK_RESULT(clReleaseMemObject(memobj_output));
+  CL_CHECK_RESULT(clReleaseCommandQueue(command_queue));
+  CL_CHECK_RESULT(clReleaseContext(context));
+}
+
+} // namespace compute_api_bench
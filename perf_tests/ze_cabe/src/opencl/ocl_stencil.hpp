@@ -0,0 +1,47 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef COMPUTE_API_BENCH_OCL_STENCIL_HPP
+#define COMPUTE_API_BENCH_OCL_STENCIL_HPP
+
+#include <vector>
+#include <string>
+#include "ocl_workload.hpp"
+
+namespace compute_api_bench {
+
+class OCLStencil : public OCLWorkload {
+public:
+  OCLStencil(unsigned int nx, unsigned int ny, unsigned int nz,
+             unsigned int num_iterations);
+  ~OCLStencil();
+
+  void build_program();
+  void create_buffers();
+  void create_cmdlist();
+  void execute_work();
+  bool verify_results();
+  void cleanup();
+
+private:
+  cl_kernel kernel = NULL;
+  cl_mem memobj_input = NULL;
+  cl_mem memobj_output = NULL;
+  size_t grid_buffer_size;
+  std::vector<float> input;
+  std::vector<float> output_GPU;
+  std::vector<float> output_CPU;
+  unsigned int nx;
+  unsigned int ny;
+  unsigned int nz;
+  unsigned int num_iterations;
+};
+
+} // namespace compute_api_bench
+
+#endif // COMPUTE_API_BENCH_OCL_STENCIL_HPP
@@ -16,10 +16,109 @@ OCLWorkload::~OCLWorkload() {}
 
 void OCLWorkload::create_device() {
   CL_CHECK_RESULT(clGetPlatformIDs(1, &platform_id, &ret_num_platforms));
-  CL_CHECK_RESULT(clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device_id,
-                                 &ret_num_devices));
-  context = clCreateContext(NULL, 1, &device_id, NULL, NULL, &ret);
-  CL_CHECK_RESULT(ret);
+  if (device_index < 0) {
+    CL_CHECK_RESULT(clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1,
+                                   &device_id, &ret_num_devices));
+    context = clCreateContext(NULL, 1, &device_id, NULL, NULL, &ret);
+    CL_CHECK_RESULT(ret);
+  } else {
+    std::vector<cl_device_id> devices = get_devices(platform_id);
+    device_id = devices[device_index];
+    context = clCreateContext(NULL, 1, &device_id, NULL, NULL, &ret);
+    CL_CHECK_RESULT(ret);
+    // The context keeps its own reference to the device
+    for (auto device : devices) {
+      CL_CHECK_RESULT(clReleaseDevice(device));
+    }
+  }
+
+  if (device_name.empty()) {
+    read_device_properties();
+  }
+}
+
+std::string OCLWorkload::get_device_info_string(cl_device_info param_name) {
+  size_t value_size = 0;
+  CL_CHECK_RESULT(clGetDeviceInfo(device_id, param_name, 0, NULL, &value_size));
+  std::vector<char> value(value_size);
+  CL_CHECK_RESULT(clGetDeviceInfo(device_id, param_name, value_size,
+                                  value.data(), NULL));
+  return value.data();
+}
+
+void OCLWorkload::read_device_properties() {
+  device_name = get_device_info_string(CL_DEVICE_NAME);
+  driver_version = get_device_info_string(CL_DRIVER_VERSION);
+
+  cl_uint vendor_id = 0;
+  cl_uint max_compute_units = 0;
+  cl_uint max_clock_frequency = 0;
+  cl_ulong global_mem_size = 0;
+  cl_ulong max_mem_alloc_size = 0;
+  CL_CHECK_RESULT(clGetDeviceInfo(device_id, CL_DEVICE_VENDOR_ID,
+                                  sizeof(vendor_id), &vendor_id, NULL));
+  CL_CHECK_RESULT(clGetDeviceInfo(device_id, CL_DEVICE_MAX_COMPUTE_UNITS,
+                                  sizeof(max_compute_units),
+                                  &max_compute_units, NULL));
+  CL_CHECK_RESULT(clGetDeviceInfo(device_id, CL_DEVICE_MAX_CLOCK_FREQUENCY,
+                                  sizeof(max_clock_frequency),
+                                  &max_clock_frequency, NULL));
+  CL_CHECK_RESULT(clGetDeviceInfo(device_id, CL_DEVICE_GLOBAL_MEM_SIZE,
+                                  sizeof(global_mem_size), &global_mem_size,
+                                  NULL));
+  CL_CHECK_RESULT(clGetDeviceInfo(device_id, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                  sizeof(max_mem_alloc_size),
+                                  &max_mem_alloc_size, NULL));
+
+  device_properties = {
+      {"vendor_id", std::to_string(vendor_id)},
+      {"device_version", get_device_info_string(CL_DEVICE_VERSION)},
+      {"max_compute_units", std::to_string(max_compute_units)},
+      {"max_clock_frequency_mhz", std::to_string(max_clock_frequency)},
+      {"global_mem_size", std::to_string(global_mem_size)},
+      {"max_mem_alloc_size", std::to_string(max_mem_alloc_size)}};
+}
+
+std::vector<cl_device_id> OCLWorkload::get_devices(cl_platform_id platform_id) {
+  cl_uint num_devices = 0;
+  CL_CHECK_RESULT(
+      clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 0, NULL, &num_devices));
+  std::vector<cl_device_id> root_devices(num_devices);
+  CL_CHECK_RESULT(clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, num_devices,
+                                 root_devices.data(), NULL));
+
+  const cl_device_partition_property properties[] = {
+      CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+      CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE, 0};
+  std::vector<cl_device_id> devices;
+  for (auto root_device : root_devices) {
+    cl_uint num_sub_devices = 0;
+    if (clCreateSubDevices(root_device, properties, 0, NULL,
+                           &num_sub_devices) != CL_SUCCESS ||
+        num_sub_devices == 0) {
+      devices.push_back(root_device);
+      continue;
+    }
+    std::vector<cl_device_id> sub_devices(num_sub_devices);
+    CL_CHECK_RESULT(clCreateSubDevices(root_device, properties,
+                                       num_sub_devices, sub_devices.data(),
+                                       NULL));
+    devices.insert(devices.end(), sub_devices.begin(), sub_devices.end());
+  }
+  return devices;
+}
+
+unsigned int OCLWorkload::count_devices() {
+  cl_platform_id platform_id = NULL;
+  cl_uint num_platforms = 0;
+  CL_CHECK_RESULT(clGetPlatformIDs(1, &platform_id, &num_platforms));
+  if (num_platforms == 0)
+    return 0;
+  std::vector<cl_device_id> devices = get_devices(platform_id);
+  for (auto device : devices) {
+    CL_CHECK_RESULT(clReleaseDevice(device));
+  }
+  return devices.size();
 }
 
 void OCLWorkload::prepare_program_from_binary() {
@@ -37,4 +136,26 @@ void OCLWorkload::prepare_program_from_text() {
   CL_CHECK_RESULT(clBuildProgram(program, 1, &device_id, NULL, NULL, NULL));
 }
 
+void OCLWorkload::save_native_binary() {
+  size_t binary_size = 0;
+  CL_CHECK_RESULT(clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                                   sizeof(binary_size), &binary_size, NULL));
+  native_binary.resize(binary_size);
+  unsigned char *binary = native_binary.data();
+  CL_CHECK_RESULT(clGetProgramInfo(program, CL_PROGRAM_BINARIES,
+                                   sizeof(binary), &binary, NULL));
+  CL_CHECK_RESULT(clReleaseProgram(program));
+}
+
+void OCLWorkload::build_program_native() {
+  const unsigned char *binary = native_binary.data();
+  size_t binary_size = native_binary.size();
+  cl_int binary_status;
+  program = clCreateProgramWithBinary(context, 1, &device_id, &binary_size,
+                                      &binary, &binary_status, &ret);
+  CL_CHECK_RESULT(ret);
+  CL_CHECK_RESULT(binary_status);
+  CL_CHECK_RESULT(clBuildProgram(program, 1, &device_id, NULL, NULL, NULL));
+}
+
 } // namespace compute_api_bench
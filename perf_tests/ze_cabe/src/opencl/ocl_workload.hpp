@@ -31,10 +31,20 @@ public:
   OCLWorkload();
   virtual ~OCLWorkload();
 
+  // GPUs that cannot be partitioned and the subdevices of the others,
+  // which device_index refers to. Subdevices are created by the call and
+  // must be released with clReleaseDevice.
+  static std::vector<cl_device_id> get_devices(cl_platform_id platform_id);
+  static unsigned int count_devices();
+
 protected:
   void create_device();
+  std::string get_device_info_string(cl_device_info param_name);
+  void read_device_properties();
   void prepare_program_from_binary();
   void prepare_program_from_text();
+  void save_native_binary();
+  void build_program_native();
   virtual void build_program() = 0;
   virtual void create_buffers() = 0;
   virtual void create_cmdlist() = 0;
@@ -53,6 +63,7 @@ protected:
   size_t kernel_length;
   std::string kernel_code;
   std::vector<uint8_t> kernel_spv;
+  std::vector<unsigned char> native_binary;
 };
 
 } // namespace compute_api_bench
@@ -13,11 +13,24 @@
 #include "opencl/ocl_sobel.hpp"
 #include "opencl/ocl_blackscholes.hpp"
 #include "opencl/ocl_blackscholes.cpp"
+#include "opencl/ocl_gemm.hpp"
+#include "opencl/ocl_reduction.hpp"
+#include "opencl/ocl_stencil.hpp"
+#include "opencl/ocl_histogram.hpp"
+#include "opencl/ocl_pipeline.hpp"
 #include "level-zero/ze_simpleadd.hpp"
 #include "level-zero/ze_mandelbrot.hpp"
 #include "level-zero/ze_sobel.hpp"
 #include "level-zero/ze_blackscholes.hpp"
 #include "level-zero/ze_blackscholes.cpp"
+#include "level-zero/ze_gemm.hpp"
+#include "level-zero/ze_reduction.hpp"
+#include "level-zero/ze_stencil.hpp"
+#include "level-zero/ze_histogram.hpp"
+#include "level-zero/ze_pipeline.hpp"
+
+#include <memory>
+#include <thread>
 
 using namespace compute_api_bench;
 
@@ -25,10 +38,21 @@ using namespace compute_api_bench;
 #define SOBEL_ITERATIONS 200
 #define MANDELBROT_ITERATIONS 50
 #define BLACKSCHOLES_ITERATIONS 50
+#define GEMM_ITERATIONS 10
+#define REDUCTION_ITERATIONS 50
+#define STENCIL_ITERATIONS 50
+#define HISTOGRAM_ITERATIONS 50
+#define PIPELINE_ITERATIONS 50
 #define SIMPLEADD_NUM_ELEMENTS 100000
 #define MANDELBROT_WIDTH 1024
 #define MANDELBROT_HEIGHT 1024
 #define BLACKSCHOLES_NUM_OPTIONS 1024 * 1024
+#define GEMM_SIZE 512
+#define REDUCTION_NUM_ELEMENTS 1024 * 1024
+#define STENCIL_NX 128
+#define STENCIL_NY 128
+#define STENCIL_NZ 64
+#define HISTOGRAM_NUM_ELEMENTS 1024 * 1024
 
 void print_help() {
   printf(R"===(
@@ -37,25 +61,222 @@ ze_cabe is a benchmark designed to compare the performance of level-zero and ope
 Parameters:
  -api <api> - Valid values: opencl, level-zero, all. The default is all. 
  -scenario <scenario> - Valid values: simpleadd, mandelbrot, sobel, blackscholesfp32,
-                        blackscholesfp64, all. The default is all.
+                        blackscholesfp64, gemm, reduction, stencil, histogram,
+                        pipeline, pipelineseparate, all. The default is all.
  -iterations <X> - X is a value between 1..200. The default is 30.
+ -devices <devices> - Valid values: first, all. With all, every scenario runs
+                      at once on each device and subdevice, one host thread
+                      per device, and reports the stages per device and the
+                      aggregate throughput. The default is first.
+ -program_cache <cache> - Valid values: enabled, disabled. Turns the persistent
+                          compiler cache of the driver on or off for all
+                          builds. The default keeps the driver setting.
+ -steady <X> - steady-state mode: sets up once per iteration, then repeats only
+               the work execution X more times with the same buffers and
+               command lists, reported apart as warm work execution.
  -median - uses median instead of default mean for reporting detailed results.
  -csv <filename> - saves results to a filename file in csv format. 
+ -json <filename> - saves results to a filename file in json format, with the
+                    raw time of every iteration per stage, the driver version
+                    and the device properties.
  -color - presents SDs in color (does not work in Windows cmd).
 
 Usage examples:
  ze_cabe -api opencl
  ze_cabe -api level-zero -scenario sobel -iterations 10 -csv out.csv -color
+ ze_cabe -scenario simpleadd -steady 1000
+ ze_cabe -program_cache disabled
+ ze_cabe -api level-zero -scenario gemm -devices all
+ ze_cabe -scenario sobel -json sobel.json
 
 )===");
 }
 
+std::unique_ptr<Workload>
+create_workload(const std::string &api, const std::string &scenario,
+                level_zero_tests::ImageBMP8Bit &image,
+                BlackScholesData<float> *bs_io_data_fp32,
+                BlackScholesData<double> *bs_io_data_fp64) {
+  const bool opencl = api == "opencl";
+
+  if (scenario == "simpleadd") {
+    if (opencl)
+      return std::make_unique<OCLSimpleAdd>(SIMPLEADD_NUM_ELEMENTS);
+    return std::make_unique<ZeSimpleAdd>(SIMPLEADD_NUM_ELEMENTS);
+  }
+  if (scenario == "mandelbrot") {
+    if (opencl)
+      return std::make_unique<OCLMandelbrot>(
+          MANDELBROT_WIDTH, MANDELBROT_HEIGHT, MANDELBROT_ITERATIONS);
+    return std::make_unique<ZeMandelbrot>(MANDELBROT_WIDTH, MANDELBROT_HEIGHT,
+                                          MANDELBROT_ITERATIONS);
+  }
+  if (scenario == "sobel") {
+    if (opencl)
+      return std::make_unique<OCLSobel>(image, SOBEL_ITERATIONS);
+    return std::make_unique<ZeSobel>(image, SOBEL_ITERATIONS);
+  }
+  if (scenario == "blackscholesfp32") {
+    if (opencl)
+      return std::make_unique<OCLBlackScholes<float>>(bs_io_data_fp32,
+                                                      BLACKSCHOLES_ITERATIONS);
+    return std::make_unique<ZeBlackScholes<float>>(bs_io_data_fp32,
+                                                   BLACKSCHOLES_ITERATIONS);
+  }
+  if (scenario == "blackscholesfp64") {
+    if (opencl)
+      return std::make_unique<OCLBlackScholes<double>>(
+          bs_io_data_fp64, BLACKSCHOLES_ITERATIONS);
+    return std::make_unique<ZeBlackScholes<double>>(bs_io_data_fp64,
+                                                    BLACKSCHOLES_ITERATIONS);
+  }
+  if (scenario == "gemm") {
+    if (opencl)
+      return std::make_unique<OCLGemm>(GEMM_SIZE, GEMM_ITERATIONS);
+    return std::make_unique<ZeGemm>(GEMM_SIZE, GEMM_ITERATIONS);
+  }
+  if (scenario == "reduction") {
+    if (opencl)
+      return std::make_unique<OCLReduction>(REDUCTION_NUM_ELEMENTS,
+                                            REDUCTION_ITERATIONS);
+    return std::make_unique<ZeReduction>(REDUCTION_NUM_ELEMENTS,
+                                         REDUCTION_ITERATIONS);
+  }
+  if (scenario == "stencil") {
+    if (opencl)
+      return std::make_unique<OCLStencil>(STENCIL_NX, STENCIL_NY, STENCIL_NZ,
+                                          STENCIL_ITERATIONS);
+    return std::make_unique<ZeStencil>(STENCIL_NX, STENCIL_NY, STENCIL_NZ,
+                                       STENCIL_ITERATIONS);
+  }
+  if (scenario == "histogram") {
+    if (opencl)
+      return std::make_unique<OCLHistogram>(HISTOGRAM_NUM_ELEMENTS,
+                                            HISTOGRAM_ITERATIONS);
+    return std::make_unique<ZeHistogram>(HISTOGRAM_NUM_ELEMENTS,
+                                         HISTOGRAM_ITERATIONS);
+  }
+  if (scenario == "pipeline") {
+    if (opencl)
+      return std::make_unique<OCLPipeline>(image, PIPELINE_ITERATIONS, true);
+    return std::make_unique<ZePipeline>(image, PIPELINE_ITERATIONS, true);
+  }
+  if (opencl)
+    return std::make_unique<OCLPipeline>(image, PIPELINE_ITERATIONS, false);
+  return std::make_unique<ZePipeline>(image, PIPELINE_ITERATIONS, false);
+}
+
+// Runs every scenario on all devices and subdevices of the api at once,
+// one host thread per device, and prints the stages per device with the
+// work executions per second summed over the devices.
+void run_on_all_devices(const std::string &api,
+                        const std::vector<std::string> &scenarios,
+                        unsigned int iterations, unsigned int warm_executions,
+                        level_zero_tests::ImageBMP8Bit &image,
+                        BlackScholesData<float> *bs_io_data_fp32,
+                        BlackScholesData<double> *bs_io_data_fp64,
+                        std::string &csv_string, std::string &json_string,
+                        bool colored, bool useMedian) {
+  const unsigned int device_count = api == "opencl"
+                                        ? OCLWorkload::count_devices()
+                                        : ZeWorkload::count_devices();
+  std::string color = "", reset_color = "";
+  if (colored) {
+    color = intense_white;
+    reset_color = reset;
+  }
+
+  for (auto &scenario : scenarios) {
+    std::vector<std::unique_ptr<Workload>> workloads;
+    for (unsigned int d = 0; d < device_count; ++d) {
+      workloads.push_back(create_workload(api, scenario, image,
+                                          bs_io_data_fp32, bs_io_data_fp64));
+      workloads.back()->device_index = d;
+      workloads.back()->show_progress = false;
+    }
+
+    std::cout << "Testing " << workloads.front()->workload_api << " "
+              << workloads.front()->workload_name << " on " << device_count
+              << " devices" << std::endl;
+    Timer timer;
+    timer.start();
+    std::vector<std::thread> threads;
+    for (auto &workload : workloads) {
+      threads.emplace_back([&workload, iterations, warm_executions]() {
+        workload->run_steady_state(iterations, warm_executions);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    const double wall_time = timer.elapsed_time();
+
+    for (unsigned int d = 0; d < device_count; ++d) {
+      std::cout << "  Device " << d << ": " << workloads[d]->device_name
+                << std::endl;
+      workloads[d]->append_json(json_string, scenario);
+    }
+    std::cout << color << std::left << std::setw(25) << scenario
+              << reset_color << "  |  ";
+    csv_string += scenario;
+    for (unsigned int d = 0; d < device_count; ++d) {
+      std::cout << color << std::setw(20) << "Device " + std::to_string(d)
+                << reset_color << "  |  ";
+      csv_string += ",Device " + std::to_string(d) + " Mean,Device " +
+                    std::to_string(d) + " SD";
+    }
+    std::cout << std::endl;
+    csv_string += "\n";
+
+    for (unsigned int j = 0; j < Stages::COUNT; ++j) {
+      std::cout << std::left << std::setw(25) << StagesList[j] << std::right
+                << "  |  ";
+      csv_string += StagesList[j] + ",";
+      for (auto &workload : workloads) {
+        workload->print_stage_mean_sd(j, csv_string, colored, useMedian);
+      }
+      std::cout << std::endl;
+      csv_string += "\n";
+    }
+    if (warm_executions > 0) {
+      std::cout << std::left << std::setw(25) << "Work Execution (warm)"
+                << std::right << "  |  ";
+      csv_string += "Work Execution (warm),";
+      for (auto &workload : workloads) {
+        workload->print_warm_mean_sd(csv_string, colored, useMedian);
+      }
+      std::cout << std::endl;
+      csv_string += "\n";
+    }
+
+    // Every device executes back to back, so its rate is the inverse of
+    // its mean work execution
+    double throughput = 0;
+    for (auto &workload : workloads) {
+      const Workload::Result &executions =
+          warm_executions > 0 ? workload->warm_result
+                              : workload->result[Stages::EXECUTE_WORK];
+      throughput += 1.0 / executions.time_mean;
+    }
+    std::cout << std::left << std::setw(25) << "Aggregate throughput"
+              << std::right << "  |  " << std::setw(9) << throughput
+              << " work executions/s, wall time " << wall_time << " s"
+              << std::endl
+              << std::endl;
+    csv_string += "Aggregate throughput," + std::to_string(throughput) +
+                  ",Wall time," + std::to_string(wall_time) + "\n";
+  }
+}
+
 int main(int argc, char *argv[]) {
 
   std::vector<std::string> valid_apis = {"opencl", "level-zero", "all"};
   std::vector<std::string> valid_scenarios = {
       "simpleadd",        "mandelbrot",       "sobel",
-      "blackscholesfp32", "blackscholesfp64", "all"};
+      "blackscholesfp32", "blackscholesfp64", "gemm",
+      "reduction",        "stencil",          "histogram",
+      "pipeline",         "pipelineseparate", "all"};
+  std::vector<std::unique_ptr<Workload>> workload_instances;
   std::vector<Workload *> ocl_workloads;
   std::vector<Workload *> levelzero_workloads;
   std::string api = "all";
@@ -64,12 +285,17 @@ int main(int argc, char *argv[]) {
   unsigned int number_of_scenarios = valid_scenarios.size() - 1;
   bool write_csv = false;
   std::string csv_filename;
+  bool write_json = false;
+  std::string json_filename;
   level_zero_tests::ImageBMP8Bit image("lena512.bmp");
   bool colored = false;
 #if defined __linux__
   colored = true;
 #endif
   bool useMedian = false;
+  unsigned int warm_executions = 0;
+  std::string program_cache = "default";
+  std::string devices = "first";
 
   for (uint32_t argIndex = 1; argIndex < argc; argIndex++) {
     if (!strcmp(argv[argIndex], "-h") || !strcmp(argv[argIndex], "-help")) {
@@ -101,10 +327,39 @@ int main(int argc, char *argv[]) {
         exit(0);
       }
       argIndex++;
+    } else if (!strcmp(argv[argIndex], "-program_cache") &&
+               (argIndex + 1 < argc)) {
+      program_cache = argv[argIndex + 1];
+      if (program_cache != "enabled" && program_cache != "disabled") {
+        std::cout << "Invalid program cache setting!" << std::endl;
+        exit(0);
+      }
+      // Read by the driver when it initializes, before the first workload
+      set_environment_variable("NEO_CACHE_PERSISTENT",
+                               program_cache == "enabled" ? "1" : "0");
+      argIndex++;
+    } else if (!strcmp(argv[argIndex], "-steady") && (argIndex + 1 < argc)) {
+      warm_executions = std::stoi(argv[argIndex + 1]);
+      if (warm_executions < 1) {
+        std::cout << "Invalid number of warm executions!" << std::endl;
+        exit(0);
+      }
+      argIndex++;
+    } else if (!strcmp(argv[argIndex], "-devices") && (argIndex + 1 < argc)) {
+      devices = argv[argIndex + 1];
+      if (devices != "all" && devices != "first") {
+        std::cout << "Invalid devices setting!" << std::endl;
+        exit(0);
+      }
+      argIndex++;
     } else if (!strcmp(argv[argIndex], "-csv") && (argIndex + 1 < argc)) {
       write_csv = true;
       csv_filename = argv[argIndex + 1];
       argIndex++;
+    } else if (!strcmp(argv[argIndex], "-json") && (argIndex + 1 < argc)) {
+      write_json = true;
+      json_filename = argv[argIndex + 1];
+      argIndex++;
     } else if (!strcmp(argv[argIndex], "-color")) {
       colored = true;
     } else if (!strcmp(argv[argIndex], "-median")) {
@@ -121,6 +376,12 @@ int main(int argc, char *argv[]) {
     std::cout << "using median for reporting detailed results";
   else
     std::cout << "using mean for reporting detailed results";
+  std::cout << ", program cache: " << program_cache;
+  if (warm_executions > 0)
+    std::cout << ", steady state with " << warm_executions
+              << " warm executions per iteration";
+  if (devices == "all")
+    std::cout << ", on all devices and subdevices in parallel";
   std::cout << std::endl << std::endl;
 
   BlackScholesData<float> bs_io_data_fp32(BLACKSCHOLES_NUM_OPTIONS);
@@ -133,67 +394,75 @@ int main(int argc, char *argv[]) {
     bs_io_data_fp64.generate_data();
   }
 
-  OCLSimpleAdd oclSimpleAdd(SIMPLEADD_NUM_ELEMENTS);
-  OCLMandelbrot oclMandelbrot(MANDELBROT_WIDTH, MANDELBROT_HEIGHT,
-                              MANDELBROT_ITERATIONS);
-  OCLSobel oclSobel(image, SOBEL_ITERATIONS);
-  OCLBlackScholes<float> oclBlackScholesFP32(&bs_io_data_fp32,
-                                             BLACKSCHOLES_ITERATIONS);
-  OCLBlackScholes<double> oclBlackScholesFP64(&bs_io_data_fp64,
-                                              BLACKSCHOLES_ITERATIONS);
+  std::vector<std::string> selected_scenarios;
+  for (auto &name : valid_scenarios) {
+    if (name != "all" && (scenario == name || scenario == "all")) {
+      selected_scenarios.push_back(name);
+    }
+  }
 
-  if (api == "opencl" || api == "all") {
-    std::cout << "Testing OpenCL" << std::endl;
-    if (scenario == "simpleadd" || scenario == "all") {
-      ocl_workloads.push_back(&oclSimpleAdd);
+  // Results of every workload, wrapped in the fixed header before saving
+  std::string json_results = "";
+  auto json_document = [&]() {
+    return "{\n  \"schema_version\": 1,\n  \"benchmark\": \"ze_cabe\",\n"
+           "  \"iterations\": " +
+           std::to_string(iterations) +
+           ",\n  \"warm_executions\": " + std::to_string(warm_executions) +
+           ",\n  \"program_cache\": " + json_quoted(program_cache) +
+           ",\n  \"devices\": " + json_quoted(devices) +
+           ",\n  \"time_unit\": \"s\",\n  \"results\": [" + json_results +
+           "\n  ]\n}\n";
+  };
+
+  if (devices == "all") {
+    std::string csv_string = "";
+    if (api == "opencl" || api == "all") {
+      run_on_all_devices("opencl", selected_scenarios, iterations,
+                         warm_executions, image, &bs_io_data_fp32,
+                         &bs_io_data_fp64, csv_string, json_results, colored,
+                         useMedian);
     }
-    if (scenario == "mandelbrot" || scenario == "all") {
-      ocl_workloads.push_back(&oclMandelbrot);
+    if (api == "level-zero" || api == "all") {
+      run_on_all_devices("level-zero", selected_scenarios, iterations,
+                         warm_executions, image, &bs_io_data_fp32,
+                         &bs_io_data_fp64, csv_string, json_results, colored,
+                         useMedian);
     }
-    if (scenario == "sobel" || scenario == "all") {
-      ocl_workloads.push_back(&oclSobel);
+    if (write_csv) {
+      save_csv(csv_string, csv_filename);
     }
-    if (scenario == "blackscholesfp32" || scenario == "all") {
-      ocl_workloads.push_back(&oclBlackScholesFP32);
+    if (write_json) {
+      save_json(json_document(), json_filename);
     }
-    if (scenario == "blackscholesfp64" || scenario == "all") {
-      ocl_workloads.push_back(&oclBlackScholesFP64);
+    return 0;
+  }
+
+  if (api == "opencl" || api == "all") {
+    std::cout << "Testing OpenCL" << std::endl;
+    for (auto &name : selected_scenarios) {
+      workload_instances.push_back(create_workload(
+          "opencl", name, image, &bs_io_data_fp32, &bs_io_data_fp64));
+      ocl_workloads.push_back(workload_instances.back().get());
     }
-    for (auto workload : ocl_workloads) {
-      workload->run(iterations);
-      workload->print_total_mean_time();
+    for (size_t i = 0; i < ocl_workloads.size(); ++i) {
+      ocl_workloads[i]->run_steady_state(iterations, warm_executions);
+      ocl_workloads[i]->print_total_mean_time();
+      ocl_workloads[i]->append_json(json_results, selected_scenarios[i]);
     }
   }
 
-  ZeSimpleAdd zeSimpleAdd(SIMPLEADD_NUM_ELEMENTS);
-  ZeMandelbrot zeMandelbrot(MANDELBROT_WIDTH, MANDELBROT_HEIGHT,
-                            MANDELBROT_ITERATIONS);
-  ZeSobel zeSobel(image, SOBEL_ITERATIONS);
-  ZeBlackScholes<float> zeBlackScholesFP32(&bs_io_data_fp32,
-                                           BLACKSCHOLES_ITERATIONS);
-  ZeBlackScholes<double> zeBlackScholesFP64(&bs_io_data_fp64,
-                                            BLACKSCHOLES_ITERATIONS);
-
   if (api == "level-zero" || api == "all") {
     std::cout << "Testing Level-Zero" << std::endl;
-    if (scenario == "simpleadd" || scenario == "all") {
-      levelzero_workloads.push_back(&zeSimpleAdd);
-    }
-    if (scenario == "mandelbrot" || scenario == "all") {
-      levelzero_workloads.push_back(&zeMandelbrot);
-    }
-    if (scenario == "sobel" || scenario == "all") {
-      levelzero_workloads.push_back(&zeSobel);
-    }
-    if (scenario == "blackscholesfp32" || scenario == "all") {
-      levelzero_workloads.push_back(&zeBlackScholesFP32);
+    for (auto &name : selected_scenarios) {
+      workload_instances.push_back(create_workload(
+          "level-zero", name, image, &bs_io_data_fp32, &bs_io_data_fp64));
+      levelzero_workloads.push_back(workload_instances.back().get());
     }
-    if (scenario == "blackscholesfp64" || scenario == "all") {
-      levelzero_workloads.push_back(&zeBlackScholesFP64);
-    }
-    for (auto workload : levelzero_workloads) {
-      workload->run(iterations);
-      workload->print_total_mean_time();
+    for (size_t i = 0; i < levelzero_workloads.size(); ++i) {
+      levelzero_workloads[i]->run_steady_state(iterations, warm_executions);
+      levelzero_workloads[i]->print_total_mean_time();
+      levelzero_workloads[i]->append_json(json_results,
+                                          selected_scenarios[i]);
     }
   }
 
@@ -246,11 +515,29 @@ int main(int argc, char *argv[]) {
       std::cout << std::endl;
       csv_string += "\n";
     }
+
+    if (warm_executions > 0) {
+      std::cout << std::left << std::setw(25) << "Work Execution (warm)"
+                << std::right << "  |  ";
+      csv_string += "Work Execution (warm),";
+      if (api == "opencl" || api == "all") {
+        ocl_workloads[i]->print_warm_mean_sd(csv_string, colored, useMedian);
+      }
+      if (api == "level-zero" || api == "all") {
+        levelzero_workloads[i]->print_warm_mean_sd(csv_string, colored,
+                                                   useMedian);
+      }
+      std::cout << std::endl;
+      csv_string += "\n";
+    }
   }
 
   if (write_csv) {
     save_csv(csv_string, csv_filename);
   }
+  if (write_json) {
+    save_json(json_document(), json_filename);
+  }
 
   return 0;
 }
@@ -0,0 +1,61 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_CL_INTEROP_HPP_
+#define _ZE_CL_INTEROP_HPP_
+
+#include <level_zero/ze_api.h>
+#include <CL/cl.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <string>
+#include <vector>
+
+class ZeClInterop {
+public:
+  ZeClInterop();
+  ~ZeClInterop();
+  int parse_arguments(int argc, char **argv);
+  void create_cl_resources(void);
+  void test_import(void);
+  void test_handoff(void);
+
+  std::vector<size_t> buffer_sizes{4096, 1024 * 1024, 16 * 1024 * 1024};
+  uint32_t number_iterations = 100;
+  uint32_t warmup_iterations = 10;
+  bool run_import = true;
+  bool run_handoff = true;
+  bool csv_output = false;
+  /* a kernel of either API left wrong data behind */
+  bool validation_failed = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_cl_interop"};
+
+  ZeApp *benchmark;
+
+private:
+  uint32_t group_count(size_t size) const;
+  void add_result(const std::string &test, size_t size,
+                  const std::vector<long double> &samples);
+
+  /* L0 side: produce_shared of ze_bandwidth writing the whole buffer */
+  ze_command_queue_handle_t queue = nullptr;
+  ze_command_list_handle_t list = nullptr;
+  ze_kernel_handle_t produce = nullptr;
+
+  /* CL side: a kernel incrementing every uint of the buffer */
+  cl_device_id cl_device = nullptr;
+  cl_context cl_ctx = nullptr;
+  cl_command_queue cl_queue = nullptr;
+  cl_program cl_prog = nullptr;
+  cl_kernel increment = nullptr;
+};
+
+#endif /* _ZE_CL_INTEROP_HPP_ */
@@ -0,0 +1,134 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_cl_interop.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_cl_interop [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -t, list                 comma separated tests to run "
+    "[default: import,handoff]:"
+    "\n      import                           wrapping an L0 host "
+    "allocation in a CL"
+    "\n                                       buffer and releasing it"
+    "\n      handoff                          an L0 kernel followed by a "
+    "CL kernel on"
+    "\n                                       the same buffer, against "
+    "each alone"
+    "\n  -s, list                 comma separated buffer sizes (bytes, "
+    "multiple of 4)"
+    "\n                            [default:  4096,1048576,16777216]"
+    "\n  -i                       set number of iterations per size"
+    "\n                            [default:  100]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  10]"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_cl_interop and sets
+// the test parameters accordingly for main to execute the tests with
+// the correct environment.
+//---------------------------------------------------------------------
+int ZeClInterop::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc)) {
+      run_import = false;
+      run_handoff = false;
+      for (auto &test : split_list(argv[i + 1])) {
+        if (test == "import") {
+          run_import = true;
+        } else if (test == "handoff") {
+          run_handoff = true;
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+      buffer_sizes.clear();
+      for (auto &item : split_list(argv[i + 1])) {
+        const size_t size = isdigit(item[0]) ? sanitize_ulong(&item[0]) : 0;
+        if (size == 0 || size % sizeof(uint32_t)) {
+          std::cerr << "buffer size " << item << " is not a multiple of 4"
+                    << std::endl;
+          exit(-1);
+        }
+        buffer_sizes.push_back(size);
+      }
+      if (buffer_sizes.empty()) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  return 0;
+}
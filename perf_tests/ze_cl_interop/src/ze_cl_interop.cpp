@@ -0,0 +1,356 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_cl_interop.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+static const uint32_t interop_group_size = 256;
+static const uint32_t interop_max_group_count = 1024;
+/* written by the L0 kernel, then incremented by the CL one */
+static const uint32_t produce_value = 7;
+
+static const char *increment_source =
+    "__kernel void increment(__global uint *data, uint count) {\n"
+    "  for (uint i = get_global_id(0); i < count; i += get_global_size(0)) {\n"
+    "    data[i] += 1;\n"
+    "  }\n"
+    "}\n";
+
+static void cl_check(cl_int ret, const char *call) {
+  if (ret != CL_SUCCESS) {
+    throw std::runtime_error(std::string(call) +
+                             " failed: " + std::to_string(ret));
+  }
+}
+
+ZeClInterop::ZeClInterop() {
+  benchmark = new ZeApp("ze_bandwidth.spv");
+
+  benchmark->singleDeviceInit();
+}
+
+ZeClInterop::~ZeClInterop() {
+  if (increment) {
+    clReleaseKernel(increment);
+  }
+  if (cl_prog) {
+    clReleaseProgram(cl_prog);
+  }
+  if (cl_queue) {
+    clReleaseCommandQueue(cl_queue);
+  }
+  if (cl_ctx) {
+    clReleaseContext(cl_ctx);
+  }
+  if (list) {
+    benchmark->commandListDestroy(list);
+  }
+  if (queue) {
+    benchmark->commandQueueDestroy(queue);
+  }
+  if (produce) {
+    benchmark->functionDestroy(produce);
+  }
+
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+//---------------------------------------------------------------------
+// Creates the CL context and queue on the first GPU of any platform, and
+// builds the increment kernel from source, next to the L0 queue and
+// produce_shared kernel on device 0.
+//---------------------------------------------------------------------
+void ZeClInterop::create_cl_resources(void) {
+  cl_uint platform_count = 0;
+  cl_check(clGetPlatformIDs(0, nullptr, &platform_count), "clGetPlatformIDs");
+  std::vector<cl_platform_id> platforms(platform_count);
+  cl_check(clGetPlatformIDs(platform_count, platforms.data(), nullptr),
+           "clGetPlatformIDs");
+  for (auto platform : platforms) {
+    cl_uint device_count = 0;
+    if (clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 1, &cl_device,
+                       &device_count) == CL_SUCCESS &&
+        device_count > 0) {
+      break;
+    }
+    cl_device = nullptr;
+  }
+  if (cl_device == nullptr) {
+    throw std::runtime_error("no OpenCL GPU device found");
+  }
+
+  cl_int ret;
+  cl_ctx = clCreateContext(nullptr, 1, &cl_device, nullptr, nullptr, &ret);
+  cl_check(ret, "clCreateContext");
+  cl_queue = clCreateCommandQueueWithProperties(cl_ctx, cl_device, nullptr,
+                                                &ret);
+  cl_check(ret, "clCreateCommandQueueWithProperties");
+  cl_prog =
+      clCreateProgramWithSource(cl_ctx, 1, &increment_source, nullptr, &ret);
+  cl_check(ret, "clCreateProgramWithSource");
+  cl_check(clBuildProgram(cl_prog, 1, &cl_device, nullptr, nullptr, nullptr),
+           "clBuildProgram");
+  increment = clCreateKernel(cl_prog, "increment", &ret);
+  cl_check(ret, "clCreateKernel");
+
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(0, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(0, &num_queue_groups,
+                                                  queue_properties.data());
+  uint32_t ordinal = 0;
+  for (uint32_t i = 0; i < num_queue_groups; i++) {
+    if (queue_properties[i].flags &
+        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      ordinal = i;
+      break;
+    }
+  }
+  benchmark->commandQueueCreate(0, ordinal, &queue);
+  benchmark->commandListCreate(0, ordinal, &list);
+  benchmark->functionCreate(&produce, "produce_shared");
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetGroupSize(produce, interop_group_size, 1, 1));
+}
+
+uint32_t ZeClInterop::group_count(size_t size) const {
+  const size_t count = size / sizeof(uint32_t);
+  return static_cast<uint32_t>(
+      std::min<size_t>((count + interop_group_size - 1) / interop_group_size,
+                       interop_max_group_count));
+}
+
+void ZeClInterop::add_result(const std::string &test, size_t size,
+                             const std::vector<long double> &samples) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = "usec";
+  record.parameters = {{"size", std::to_string(size)}};
+  record.stats = ResultStats::from_samples(samples);
+  record.value = record.stats.median;
+  record.samples = samples;
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// Cost of handing an L0 host allocation to CL: wrapping it in a CL
+// buffer with CL_MEM_USE_HOST_PTR, and releasing that buffer again.
+//---------------------------------------------------------------------
+void ZeClInterop::test_import(void) {
+  std::cout << std::endl;
+  std::cout << "L0 TO CL BUFFER IMPORT" << std::endl;
+  if (csv_output) {
+    std::cout << "Size_(bytes),Import_median_(usec),Import_p99_(usec),"
+                 "Release_median_(usec),Release_p99_(usec)"
+              << std::endl;
+  }
+
+  for (auto size : buffer_sizes) {
+    void *buffer = nullptr;
+    benchmark->memoryAllocHost(size, &buffer);
+    SampleTimer<std::micro> import_timer(number_iterations);
+    SampleTimer<std::micro> release_timer(number_iterations);
+
+    for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+      if (i == warmup_iterations) {
+        import_timer.clear();
+        release_timer.clear();
+      }
+      cl_int ret;
+      import_timer.start();
+      cl_mem cl_buffer = clCreateBuffer(
+          cl_ctx, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, size, buffer, &ret);
+      import_timer.stop();
+      cl_check(ret, "clCreateBuffer");
+
+      release_timer.start();
+      cl_check(clReleaseMemObject(cl_buffer), "clReleaseMemObject");
+      release_timer.stop();
+    }
+    benchmark->memoryFree(buffer);
+
+    const ResultStats import_stats =
+        ResultStats::from_samples(import_timer.samples());
+    const ResultStats release_stats =
+        ResultStats::from_samples(release_timer.samples());
+    if (csv_output) {
+      std::cout << size << "," << import_stats.median << ","
+                << import_stats.p99 << "," << release_stats.median << ","
+                << release_stats.p99 << std::endl;
+    } else {
+      std::cout << std::setprecision(2) << std::fixed
+                << "Size: " << std::setw(10) << size
+                << " Import(median/p99): " << std::setw(9)
+                << import_stats.median << "/" << std::setw(9)
+                << import_stats.p99 << " usec Release(median/p99): "
+                << std::setw(9) << release_stats.median << "/"
+                << std::setw(9) << release_stats.p99 << " usec"
+                << std::endl;
+    }
+    add_result("Import", size, import_timer.samples());
+    add_result("Release", size, release_timer.samples());
+  }
+}
+
+//---------------------------------------------------------------------
+// Round trips of an L0 kernel and a CL kernel on the same host buffer,
+// each waited on by the host: L0 alone, CL alone, and the L0 kernel
+// followed by the CL one, as a mixed pipeline hands the buffer over.
+// The handoff is what the pair costs above the two kernels alone. The
+// buffer is checked after the last pair.
+//---------------------------------------------------------------------
+void ZeClInterop::test_handoff(void) {
+  std::cout << std::endl;
+  std::cout << "L0 AND CL KERNEL HANDOFF" << std::endl;
+  if (csv_output) {
+    std::cout << "Size_(bytes),L0_(usec),CL_(usec),L0_then_CL_(usec),"
+                 "Handoff_(usec)"
+              << std::endl;
+  }
+
+  for (auto size : buffer_sizes) {
+    const uint32_t count = static_cast<uint32_t>(size / sizeof(uint32_t));
+    uint32_t *buffer = nullptr;
+    benchmark->memoryAllocHost(size, reinterpret_cast<void **>(&buffer));
+
+    const ze_group_count_t ze_groups = {group_count(size), 1, 1};
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(produce, 0, sizeof(buffer), &buffer));
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(produce, 1, sizeof(count), &count));
+    SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+        produce, 2, sizeof(produce_value), &produce_value));
+    benchmark->commandListReset(list);
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        list, produce, &ze_groups, nullptr, 0, nullptr));
+    benchmark->commandListClose(list);
+
+    cl_int ret;
+    cl_mem cl_buffer = clCreateBuffer(
+        cl_ctx, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, size, buffer, &ret);
+    cl_check(ret, "clCreateBuffer");
+    cl_check(clSetKernelArg(increment, 0, sizeof(cl_buffer), &cl_buffer),
+             "clSetKernelArg");
+    cl_check(clSetKernelArg(increment, 1, sizeof(count), &count),
+             "clSetKernelArg");
+    const size_t cl_local = interop_group_size;
+    const size_t cl_global = static_cast<size_t>(ze_groups.groupCountX) *
+                             interop_group_size;
+
+    auto run_l0 = [&]() {
+      benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+      benchmark->commandQueueSynchronize(queue);
+    };
+    auto run_cl = [&]() {
+      cl_check(clEnqueueNDRangeKernel(cl_queue, increment, 1, nullptr,
+                                      &cl_global, &cl_local, 0, nullptr,
+                                      nullptr),
+               "clEnqueueNDRangeKernel");
+      cl_check(clFinish(cl_queue), "clFinish");
+    };
+
+    SampleTimer<std::micro> l0_timer(number_iterations);
+    SampleTimer<std::micro> cl_timer(number_iterations);
+    SampleTimer<std::micro> pair_timer(number_iterations);
+    for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+      if (i == warmup_iterations) {
+        l0_timer.clear();
+        cl_timer.clear();
+        pair_timer.clear();
+      }
+      l0_timer.start();
+      run_l0();
+      l0_timer.stop();
+
+      cl_timer.start();
+      run_cl();
+      cl_timer.stop();
+
+      pair_timer.start();
+      run_l0();
+      run_cl();
+      pair_timer.stop();
+    }
+
+    cl_check(clReleaseMemObject(cl_buffer), "clReleaseMemObject");
+    for (uint32_t i = 0; i < count; i++) {
+      if (buffer[i] != produce_value + 1) {
+        std::cerr << "ERROR: " << size << " byte buffer holds " << buffer[i]
+                  << " instead of " << produce_value + 1 << " at " << i
+                  << std::endl;
+        validation_failed = true;
+        break;
+      }
+    }
+    benchmark->memoryFree(buffer);
+
+    const long double l0 = l0_timer.percentile(50);
+    const long double cl = cl_timer.percentile(50);
+    std::vector<long double> handoff;
+    for (auto pair : pair_timer.samples()) {
+      handoff.push_back(pair - l0 - cl);
+    }
+    const long double pair = pair_timer.percentile(50);
+    const long double handoff_median = pair - l0 - cl;
+
+    if (csv_output) {
+      std::cout << size << "," << l0 << "," << cl << "," << pair << ","
+                << handoff_median << std::endl;
+    } else {
+      std::cout << std::setprecision(2) << std::fixed
+                << "Size: " << std::setw(10) << size << " L0: "
+                << std::setw(9) << l0 << " usec CL: " << std::setw(9) << cl
+                << " usec L0->CL: " << std::setw(9) << pair
+                << " usec Handoff: " << std::setw(9) << handoff_median
+                << " usec" << std::endl;
+    }
+    add_result("L0Kernel", size, l0_timer.samples());
+    add_result("CLKernel", size, cl_timer.samples());
+    add_result("L0ThenCL", size, pair_timer.samples());
+    add_result("Handoff", size, handoff);
+  }
+}
+
+int main(int argc, char **argv) {
+  ZeClInterop interop;
+
+  interop.parse_arguments(argc, argv);
+  interop.create_cl_resources();
+
+  if (interop.results.enabled()) {
+    interop.results.read_metadata(interop.benchmark->_devices);
+  }
+
+  if (interop.run_import) {
+    interop.test_import();
+  }
+  if (interop.run_handoff) {
+    interop.test_handoff();
+  }
+
+  std::cout << std::endl;
+  const int result = interop.results.finish();
+  return interop.validation_failed ? 1 : result;
+}
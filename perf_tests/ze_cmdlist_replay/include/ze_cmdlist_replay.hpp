@@ -0,0 +1,78 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_CMDLIST_REPLAY_HPP_
+#define _ZE_CMDLIST_REPLAY_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <string>
+#include <vector>
+
+/*
+ * Dependencies between the kernels of a graph:
+ *   CHAIN  -> every kernel waits on the one before it
+ *   FAN    -> one kernel, all but the last waiting on it, and the last
+ *             waiting on all of them
+ *   LAYERS -> layers of width kernels, every kernel waiting on all kernels
+ *             of the layer before
+ */
+enum class GraphShape { CHAIN = 0, FAN, LAYERS };
+
+/* The kernels each kernel of a graph waits on */
+struct Graph {
+  GraphShape shape;
+  std::vector<std::vector<uint32_t>> parents;
+  /* kernels another kernel waits on, which signal an event */
+  std::vector<bool> signals;
+
+  static Graph build(GraphShape shape, uint32_t node_count, uint32_t width);
+};
+
+class ZeCmdListReplay {
+public:
+  ZeCmdListReplay();
+  ~ZeCmdListReplay();
+  int parse_arguments(int argc, char **argv);
+  void test_replay(void);
+
+  std::vector<uint32_t> node_counts{1, 4, 16, 64, 256, 1024};
+  std::vector<GraphShape> shapes{GraphShape::CHAIN, GraphShape::FAN,
+                                 GraphShape::LAYERS};
+  /* kernels per layer of the LAYERS shape */
+  uint32_t layer_width = 4;
+  /* uints each kernel writes */
+  uint32_t node_work = 64;
+  uint32_t number_replays = 100;
+  uint32_t warmup_replays = 10;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_cmdlist_replay"};
+
+  ZeApp *benchmark;
+
+private:
+  void append_graph(ze_command_list_handle_t list, const Graph &graph,
+                    std::vector<ze_event_handle_t> &events);
+  long double replay_usec(ze_command_list_handle_t list);
+  long double reissue_usec(ze_command_list_handle_t list, const Graph &graph,
+                           std::vector<ze_event_handle_t> &events);
+  void add_result(const std::string &test, const Graph &graph,
+                  uint32_t node_count, const std::string &unit,
+                  long double value);
+
+  uint32_t compute_ordinal = 0;
+  ze_command_queue_handle_t queue = nullptr;
+  ze_kernel_handle_t kernel = nullptr;
+  uint32_t *buffer = nullptr;
+};
+
+#endif /* _ZE_CMDLIST_REPLAY_HPP_ */
@@ -0,0 +1,146 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_cmdlist_replay.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_cmdlist_replay [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -k, list                 comma separated numbers of kernels per "
+    "graph"
+    "\n                            [default:  1,4,16,64,256,1024]"
+    "\n  -g, list                 comma separated graph shapes "
+    "[default:  all]:"
+    "\n      chain                            every kernel waits on the "
+    "one before"
+    "\n      fan                              one kernel fans out to all "
+    "but the last,"
+    "\n                                       which waits on all of them"
+    "\n      layers                           every kernel waits on all "
+    "kernels of the"
+    "\n                                       layer before"
+    "\n  --width                  set number of kernels per layer of the "
+    "layers shape"
+    "\n                            [default:  4]"
+    "\n  --work                   set number of uints each kernel writes"
+    "\n                            [default:  64]"
+    "\n  -r                       set number of replays per graph"
+    "\n                            [default:  100]"
+    "\n  -w                       set number of warmup replays"
+    "\n                            [default:  10]"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_cmdlist_replay and
+// sets the test parameters accordingly for main to execute the tests
+// with the correct environment.
+//---------------------------------------------------------------------
+int ZeCmdListReplay::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-k") == 0) && (i + 1 < argc)) {
+      node_counts.clear();
+      for (auto &item : split_list(argv[i + 1])) {
+        const uint32_t count = isdigit(item[0]) ? sanitize_ulong(&item[0]) : 0;
+        if (count == 0) {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+        node_counts.push_back(count);
+      }
+      if (node_counts.empty()) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-g") == 0) && (i + 1 < argc)) {
+      shapes.clear();
+      for (auto &shape : split_list(argv[i + 1])) {
+        if (shape == "chain") {
+          shapes.push_back(GraphShape::CHAIN);
+        } else if (shape == "fan") {
+          shapes.push_back(GraphShape::FAN);
+        } else if (shape == "layers") {
+          shapes.push_back(GraphShape::LAYERS);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "--width") == 0) && (i + 1 < argc)) {
+      layer_width = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "--work") == 0) && (i + 1 < argc)) {
+      node_work = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc)) {
+      number_replays = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_replays = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,309 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_cmdlist_replay.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+/* Every kernel is produce_shared of ze_bandwidth, writing node_work uints */
+static const uint32_t node_group_size = 64;
+
+static const char *graph_shape_names[] = {"chain", "fan", "layers"};
+
+Graph Graph::build(GraphShape shape, uint32_t node_count, uint32_t width) {
+  Graph graph;
+  graph.shape = shape;
+  graph.parents.resize(node_count);
+  graph.signals.assign(node_count, false);
+
+  for (uint32_t n = 1; n < node_count; n++) {
+    std::vector<uint32_t> &parents = graph.parents[n];
+    switch (shape) {
+    case GraphShape::FAN:
+      if (n + 1 < node_count || node_count < 3) {
+        parents.push_back(0);
+      } else {
+        for (uint32_t p = 1; p < n; p++) {
+          parents.push_back(p);
+        }
+      }
+      break;
+    case GraphShape::LAYERS:
+      if (n >= width) {
+        const uint32_t layer_begin = (n / width - 1) * width;
+        for (uint32_t p = layer_begin; p < layer_begin + width; p++) {
+          parents.push_back(p);
+        }
+      }
+      break;
+    default:
+      parents.push_back(n - 1);
+      break;
+    }
+    for (auto parent : parents) {
+      graph.signals[parent] = true;
+    }
+  }
+  return graph;
+}
+
+ZeCmdListReplay::ZeCmdListReplay() {
+  benchmark = new ZeApp("ze_bandwidth.spv");
+
+  benchmark->singleDeviceInit();
+}
+
+ZeCmdListReplay::~ZeCmdListReplay() {
+  if (kernel) {
+    benchmark->functionDestroy(kernel);
+  }
+  if (queue) {
+    benchmark->commandQueueDestroy(queue);
+  }
+  if (buffer) {
+    benchmark->memoryFree(buffer);
+  }
+
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+//---------------------------------------------------------------------
+// Appends every kernel of the graph, waiting on the events of its
+// parents and signaling its own event when it has children, then resets
+// the events once all kernels are done, so that the same commands can
+// run again. Each kernel writes its own slice of the buffer.
+//---------------------------------------------------------------------
+void ZeCmdListReplay::append_graph(ze_command_list_handle_t list,
+                                   const Graph &graph,
+                                   std::vector<ze_event_handle_t> &events) {
+  const uint32_t node_count = static_cast<uint32_t>(graph.parents.size());
+  const ze_group_count_t group_count = {
+      (node_work + node_group_size - 1) / node_group_size, 1, 1};
+  std::vector<ze_event_handle_t> wait_events;
+
+  for (uint32_t n = 0; n < node_count; n++) {
+    wait_events.clear();
+    for (auto parent : graph.parents[n]) {
+      wait_events.push_back(events[parent]);
+    }
+    uint32_t *slice = buffer + static_cast<size_t>(n) * node_work;
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(kernel, 0, sizeof(slice), &slice));
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        list, kernel, &group_count, graph.signals[n] ? events[n] : nullptr,
+        static_cast<uint32_t>(wait_events.size()), wait_events.data()));
+  }
+
+  benchmark->commandListAppendBarrier(list);
+  for (uint32_t n = 0; n < node_count; n++) {
+    if (graph.signals[n]) {
+      benchmark->commandListAppendResetEvent(list, events[n]);
+    }
+  }
+  benchmark->commandListAppendBarrier(list);
+}
+
+//---------------------------------------------------------------------
+// Submits the closed list number_replays times back to back and waits
+// once, returning the time per replay.
+//---------------------------------------------------------------------
+long double ZeCmdListReplay::replay_usec(ze_command_list_handle_t list) {
+  Timer<std::micro> timer;
+
+  for (uint32_t i = 0; i < warmup_replays; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+  }
+  benchmark->commandQueueSynchronize(queue);
+
+  timer.start();
+  for (uint32_t i = 0; i < number_replays; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+  }
+  benchmark->commandQueueSynchronize(queue);
+  timer.end();
+
+  return timer.period_minus_overhead() / number_replays;
+}
+
+//---------------------------------------------------------------------
+// Appends the whole graph to the immediate list number_replays times
+// back to back and waits once, returning the time per graph.
+//---------------------------------------------------------------------
+long double
+ZeCmdListReplay::reissue_usec(ze_command_list_handle_t list,
+                              const Graph &graph,
+                              std::vector<ze_event_handle_t> &events) {
+  Timer<std::micro> timer;
+
+  for (uint32_t i = 0; i < warmup_replays; i++) {
+    append_graph(list, graph, events);
+  }
+  benchmark->commandListHostSynchronize(list, nullptr);
+
+  timer.start();
+  for (uint32_t i = 0; i < number_replays; i++) {
+    append_graph(list, graph, events);
+  }
+  benchmark->commandListHostSynchronize(list, nullptr);
+  timer.end();
+
+  return timer.period_minus_overhead() / number_replays;
+}
+
+void ZeCmdListReplay::add_result(const std::string &test, const Graph &graph,
+                                 uint32_t node_count, const std::string &unit,
+                                 long double value) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = unit;
+  record.value = value;
+  record.parameters = {
+      {"shape", graph_shape_names[static_cast<int>(graph.shape)]},
+      {"nodes", std::to_string(node_count)},
+      {"replays", std::to_string(number_replays)}};
+  if (graph.shape == GraphShape::LAYERS) {
+    record.parameters.push_back({"width", std::to_string(layer_width)});
+  }
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// Records every graph once into a regular command list and replays it,
+// against appending the same graph to an immediate list every time, and
+// reports the time per graph and per kernel of both as the graph grows.
+//---------------------------------------------------------------------
+void ZeCmdListReplay::test_replay(void) {
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(0, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(0, &num_queue_groups,
+                                                  queue_properties.data());
+  for (uint32_t i = 0; i < num_queue_groups; i++) {
+    if (queue_properties[i].flags &
+        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      compute_ordinal = i;
+      break;
+    }
+  }
+
+  const uint32_t max_nodes =
+      *std::max_element(node_counts.begin(), node_counts.end());
+  benchmark->memoryAlloc(static_cast<size_t>(max_nodes) * node_work *
+                             sizeof(uint32_t),
+                         reinterpret_cast<void **>(&buffer));
+  benchmark->functionCreate(&kernel, "produce_shared");
+  SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(kernel, node_group_size, 1, 1));
+  uint32_t value = 1;
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 1, sizeof(node_work), &node_work));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 2, sizeof(value), &value));
+  benchmark->commandQueueCreate(0, compute_ordinal, &queue);
+
+  ze_event_pool_handle_t event_pool =
+      benchmark->create_event_pool(max_nodes, 0);
+  std::vector<ze_event_handle_t> events(max_nodes);
+  for (uint32_t n = 0; n < max_nodes; n++) {
+    benchmark->create_event(event_pool, events[n], n);
+  }
+
+  std::cout << std::endl;
+  std::cout << "COMMAND LIST REPLAY" << std::endl;
+  if (csv_output) {
+    std::cout << "Shape,Nodes,Record_(usec),Replay_(usec),"
+                 "Replay_per_node_(usec),Immediate_(usec),"
+                 "Immediate_per_node_(usec),Speedup"
+              << std::endl;
+  }
+
+  for (auto shape : shapes) {
+    for (auto node_count : node_counts) {
+      const Graph graph = Graph::build(shape, node_count, layer_width);
+
+      ze_command_list_handle_t list;
+      benchmark->commandListCreate(0, compute_ordinal, &list);
+      Timer<std::micro> record_timer;
+      record_timer.start();
+      append_graph(list, graph, events);
+      benchmark->commandListClose(list);
+      record_timer.end();
+      const long double record = record_timer.period_minus_overhead();
+      const long double replay = replay_usec(list);
+      benchmark->commandListDestroy(list);
+
+      ze_command_list_handle_t immediate_list;
+      benchmark->commandListCreateImmediate(
+          0, compute_ordinal, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+          &immediate_list);
+      const long double reissue = reissue_usec(immediate_list, graph, events);
+      benchmark->commandListDestroy(immediate_list);
+
+      const char *shape_name = graph_shape_names[static_cast<int>(shape)];
+      if (csv_output) {
+        std::cout << shape_name << "," << node_count << "," << record << ","
+                  << replay << "," << replay / node_count << "," << reissue
+                  << "," << reissue / node_count << "," << reissue / replay
+                  << std::endl;
+      } else {
+        std::cout << std::setprecision(2) << std::fixed
+                  << "Shape: " << std::setw(6) << shape_name
+                  << " Nodes: " << std::setw(5) << node_count
+                  << " Record: " << std::setw(9) << record
+                  << " usec Replay: " << std::setw(9) << replay << " usec ("
+                  << std::setw(6) << replay / node_count
+                  << " per node) Immediate: " << std::setw(9) << reissue
+                  << " usec (" << std::setw(6) << reissue / node_count
+                  << " per node) Speedup: " << reissue / replay << "x"
+                  << std::endl;
+      }
+
+      add_result("Record", graph, node_count, "usec", record);
+      add_result("Replay", graph, node_count, "usec", replay);
+      add_result("ReplayPerNode", graph, node_count, "usec",
+                 replay / node_count);
+      add_result("Immediate", graph, node_count, "usec", reissue);
+      add_result("ImmediatePerNode", graph, node_count, "usec",
+                 reissue / node_count);
+    }
+  }
+
+  for (auto event : events) {
+    benchmark->destroy_event(event);
+  }
+  benchmark->destroy_event_pool(event_pool);
+}
+
+int main(int argc, char **argv) {
+  ZeCmdListReplay replay;
+
+  replay.parse_arguments(argc, argv);
+
+  if (replay.results.enabled()) {
+    replay.results.read_metadata(replay.benchmark->_devices);
+  }
+
+  replay.test_replay();
+
+  std::cout << std::endl;
+  return replay.results.finish();
+}
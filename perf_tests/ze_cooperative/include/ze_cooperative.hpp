@@ -0,0 +1,63 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_COOPERATIVE_HPP_
+#define _ZE_COOPERATIVE_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <string>
+#include <vector>
+
+class ZeCooperative {
+public:
+  ZeCooperative();
+  ~ZeCooperative();
+  int parse_arguments(int argc, char **argv);
+  void test_cooperative(void);
+
+  /* compute ordinals to run on, all of them when empty */
+  std::vector<uint32_t> ordinals;
+  uint32_t group_size = 64;
+  /* grid barriers per kernel of the barrier test */
+  uint32_t barrier_rounds = 1000;
+  uint32_t launches_per_list = 100;
+  uint32_t number_iterations = 20;
+  uint32_t warmup_iterations = 3;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_cooperative"};
+
+  ZeApp *benchmark;
+
+private:
+  void set_rounds(uint32_t rounds);
+  std::vector<long double> kernel_usec(ze_command_queue_handle_t queue,
+                                       ze_command_list_handle_t list,
+                                       uint32_t groups, uint32_t rounds);
+  std::vector<long double> launch_usec(ze_command_queue_handle_t queue,
+                                       ze_command_list_handle_t list,
+                                       uint32_t groups, bool cooperative,
+                                       long double &append_usec);
+  void add_result(const std::string &test, uint32_t ordinal, uint32_t groups,
+                  const std::vector<std::pair<std::string, std::string>> &mode,
+                  const std::vector<long double> &samples);
+
+  ze_kernel_handle_t kernel = nullptr;
+  uint32_t *sync = nullptr;
+  uint32_t *output = nullptr;
+  ze_event_pool_handle_t event_pool = nullptr;
+  ze_event_handle_t event = nullptr;
+  long double nsec_per_tick = 1;
+  uint32_t timestamp_bits = 64;
+};
+
+#endif /* _ZE_COOPERATIVE_HPP_ */
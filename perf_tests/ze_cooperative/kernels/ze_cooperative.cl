@@ -0,0 +1,34 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Grid wide barrier of a persistent kernel, rounds times: the first work
+// item of every group counts its arrival on sync[0] and spins until all
+// groups of the round arrived. Only safe when all groups are resident at
+// once, as a cooperative launch guarantees. sync[0] must be 0 at launch.
+// With rounds 0 it is an almost empty kernel, for the launch overhead.
+__kernel void grid_barrier(__global uint *sync, uint rounds,
+                           __global uint *output) {
+  uint groups = (uint)get_num_groups(0);
+
+  for (uint round = 0; round < rounds; round++) {
+    barrier(CLK_GLOBAL_MEM_FENCE);
+    if (get_local_id(0) == 0) {
+      uint target = (round + 1) * groups;
+      atomic_inc(&sync[0]);
+      while (atomic_load_explicit((volatile __global atomic_uint *)sync,
+                                  memory_order_seq_cst,
+                                  memory_scope_device) < target) {
+      }
+    }
+    barrier(CLK_GLOBAL_MEM_FENCE);
+  }
+
+  if (get_global_id(0) == 0) {
+    output[0] = rounds;
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_cooperative.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_cooperative [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -o, list                 comma separated compute ordinals "
+    "[default:  all]"
+    "\n  -g                       set number of work items per group"
+    "\n                            [default:  64]"
+    "\n  -b                       set number of grid barriers per kernel "
+    "of the"
+    "\n                            barrier test [default:  1000]"
+    "\n  -l                       set number of launches per command list "
+    "of the"
+    "\n                            launch test [default:  100]"
+    "\n  -i                       set number of iterations per test"
+    "\n                            [default:  20]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  3]"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_cooperative and
+// sets the test parameters accordingly for main to execute the tests
+// with the correct environment.
+//---------------------------------------------------------------------
+int ZeCooperative::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-o") == 0) && (i + 1 < argc)) {
+      ordinals.clear();
+      for (auto &item : split_list(argv[i + 1])) {
+        if (!isdigit(item[0])) {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+        ordinals.push_back(sanitize_ulong(&item[0]));
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-g") == 0) && (i + 1 < argc)) {
+      group_size = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-b") == 0) && (i + 1 < argc)) {
+      barrier_rounds = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-l") == 0) && (i + 1 < argc)) {
+      launches_per_list = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,296 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "clock_correlation.hpp"
+#include "ze_app.hpp"
+#include "ze_cooperative.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+ZeCooperative::ZeCooperative() {
+  benchmark = new ZeApp("ze_cooperative.spv");
+
+  benchmark->singleDeviceInit();
+}
+
+ZeCooperative::~ZeCooperative() {
+  if (event) {
+    benchmark->destroy_event(event);
+  }
+  if (event_pool) {
+    benchmark->destroy_event_pool(event_pool);
+  }
+  if (kernel) {
+    benchmark->functionDestroy(kernel);
+  }
+  if (sync) {
+    benchmark->memoryFree(sync);
+  }
+  if (output) {
+    benchmark->memoryFree(output);
+  }
+
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+void ZeCooperative::set_rounds(uint32_t rounds) {
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 1, sizeof(rounds), &rounds));
+}
+
+//---------------------------------------------------------------------
+// Device time of a cooperative launch of groups groups passing rounds
+// grid barriers, from its kernel timestamps, once per iteration. The
+// arrival counter is cleared before every launch.
+//---------------------------------------------------------------------
+std::vector<long double>
+ZeCooperative::kernel_usec(ze_command_queue_handle_t queue,
+                           ze_command_list_handle_t list, uint32_t groups,
+                           uint32_t rounds) {
+  const ze_group_count_t group_count = {groups, 1, 1};
+  const uint32_t zero = 0;
+  std::vector<long double> samples;
+
+  set_rounds(rounds);
+  benchmark->commandListReset(list);
+  SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryFill(
+      list, sync, &zero, sizeof(zero), sizeof(zero), nullptr, 0, nullptr));
+  benchmark->commandListAppendBarrier(list);
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchCooperativeKernel(
+      list, kernel, &group_count, event, 0, nullptr));
+  benchmark->commandListClose(list);
+
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    ze_kernel_timestamp_result_t timestamp;
+    SUCCESS_OR_TERMINATE(zeEventQueryKernelTimestamp(event, &timestamp));
+    SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+    if (i >= warmup_iterations) {
+      samples.push_back(ClockCorrelation::elapsed_ticks(
+                            timestamp.global.kernelStart,
+                            timestamp.global.kernelEnd, timestamp_bits) *
+                        nsec_per_tick / 1e3);
+    }
+  }
+  return samples;
+}
+
+//---------------------------------------------------------------------
+// Time per launch of a list of launches_per_list launches of groups
+// groups without barriers, launched as regular or cooperative kernels,
+// from host submission to completion, with the host time per append.
+//---------------------------------------------------------------------
+std::vector<long double>
+ZeCooperative::launch_usec(ze_command_queue_handle_t queue,
+                           ze_command_list_handle_t list, uint32_t groups,
+                           bool cooperative, long double &append_usec) {
+  const ze_group_count_t group_count = {groups, 1, 1};
+  SampleTimer<std::micro> timer(number_iterations);
+  Timer<std::micro> append_timer;
+
+  set_rounds(0);
+  benchmark->commandListReset(list);
+  append_timer.start();
+  for (uint32_t i = 0; i < launches_per_list; i++) {
+    if (cooperative) {
+      SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchCooperativeKernel(
+          list, kernel, &group_count, nullptr, 0, nullptr));
+    } else {
+      SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+          list, kernel, &group_count, nullptr, 0, nullptr));
+    }
+  }
+  append_timer.end();
+  benchmark->commandListClose(list);
+  append_usec = append_timer.period_minus_overhead() / launches_per_list;
+
+  for (uint32_t i = 0; i < warmup_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+  }
+  for (uint32_t i = 0; i < number_iterations; i++) {
+    timer.start();
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    timer.stop(launches_per_list);
+  }
+  return timer.samples();
+}
+
+void ZeCooperative::add_result(
+    const std::string &test, uint32_t ordinal, uint32_t groups,
+    const std::vector<std::pair<std::string, std::string>> &mode,
+    const std::vector<long double> &samples) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = "usec";
+  record.parameters = {{"ordinal", std::to_string(ordinal)},
+                       {"groups", std::to_string(groups)},
+                       {"group_size", std::to_string(group_size)}};
+  record.parameters.insert(record.parameters.end(), mode.begin(), mode.end());
+  record.stats = ResultStats::from_samples(samples);
+  record.value = record.stats.median;
+  record.samples = samples;
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// On every compute ordinal with cooperative kernels, and for group
+// counts from 1 up to zeKernelSuggestMaxCooperativeGroupCount, reports
+// the cost of one grid barrier, from the kernel time with and without
+// barrier_rounds barriers, and the time per launch and per append of
+// cooperative launches against regular ones.
+//---------------------------------------------------------------------
+void ZeCooperative::test_cooperative(void) {
+  ze_device_handle_t device = benchmark->_devices[0];
+  ze_device_properties_t device_properties = {
+      ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeDeviceGetProperties(device, &device_properties));
+  timestamp_bits = device_properties.kernelTimestampValidBits;
+  nsec_per_tick = ClockCorrelation(device).nsec_per_tick();
+
+  benchmark->memoryAlloc(sizeof(uint32_t), reinterpret_cast<void **>(&sync));
+  benchmark->memoryAlloc(sizeof(uint32_t),
+                         reinterpret_cast<void **>(&output));
+  benchmark->functionCreate(&kernel, "grid_barrier");
+  SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(kernel, group_size, 1, 1));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 0, sizeof(sync), &sync));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 2, sizeof(output), &output));
+  event_pool = benchmark->create_event_pool(
+      1, ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  benchmark->create_event(event_pool, event, 0);
+
+  uint32_t max_groups = 0;
+  SUCCESS_OR_TERMINATE(
+      zeKernelSuggestMaxCooperativeGroupCount(kernel, &max_groups));
+  std::vector<uint32_t> group_counts;
+  for (uint32_t groups = 1; groups < max_groups; groups *= 2) {
+    group_counts.push_back(groups);
+  }
+  if (max_groups > 0) {
+    group_counts.push_back(max_groups);
+  }
+
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(0, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(0, &num_queue_groups,
+                                                  queue_properties.data());
+
+  std::cout << std::endl;
+  std::cout << "COOPERATIVE KERNELS, group size " << group_size
+            << ", at most " << max_groups << " cooperative groups"
+            << std::endl;
+  if (csv_output) {
+    std::cout << "Ordinal,Groups,Launch_(usec),Cooperative_launch_(usec),"
+                 "Append_(usec),Cooperative_append_(usec),Barrier_(usec)"
+              << std::endl;
+  }
+
+  for (uint32_t ordinal = 0; ordinal < num_queue_groups; ordinal++) {
+    const ze_command_queue_group_property_flags_t flags =
+        queue_properties[ordinal].flags;
+    if (!(flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) ||
+        (!ordinals.empty() && std::find(ordinals.begin(), ordinals.end(),
+                                        ordinal) == ordinals.end())) {
+      continue;
+    }
+    if (!(flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COOPERATIVE_KERNELS)) {
+      std::cout << "Ordinal " << ordinal
+                << ": no cooperative kernels, skipped" << std::endl;
+      continue;
+    }
+
+    ze_command_queue_handle_t queue;
+    ze_command_list_handle_t list;
+    benchmark->commandQueueCreate(0, ordinal, &queue);
+    benchmark->commandListCreate(0, ordinal, &list);
+
+    for (auto groups : group_counts) {
+      long double append = 0;
+      long double cooperative_append = 0;
+      const std::vector<long double> launch =
+          launch_usec(queue, list, groups, false, append);
+      const std::vector<long double> cooperative_launch =
+          launch_usec(queue, list, groups, true, cooperative_append);
+
+      /* barrier cost of every iteration, less the median kernel time
+       * without barriers */
+      const long double base_usec =
+          ResultStats::from_samples(kernel_usec(queue, list, groups, 0))
+              .median;
+      std::vector<long double> barrier =
+          kernel_usec(queue, list, groups, barrier_rounds);
+      for (auto &sample : barrier) {
+        sample = std::max<long double>(sample - base_usec, 0) / barrier_rounds;
+      }
+
+      const long double launch_median =
+          ResultStats::from_samples(launch).median;
+      const long double cooperative_median =
+          ResultStats::from_samples(cooperative_launch).median;
+      const long double barrier_median =
+          ResultStats::from_samples(barrier).median;
+      if (csv_output) {
+        std::cout << ordinal << "," << groups << "," << launch_median << ","
+                  << cooperative_median << "," << append << ","
+                  << cooperative_append << "," << barrier_median << std::endl;
+      } else {
+        std::cout << std::setprecision(2) << std::fixed
+                  << "Ordinal: " << ordinal << " Groups: " << std::setw(5)
+                  << groups << " Launch: " << std::setw(8) << launch_median
+                  << " usec Cooperative: " << std::setw(8)
+                  << cooperative_median << " usec Append: " << std::setw(6)
+                  << append << " / " << std::setw(6) << cooperative_append
+                  << " usec Barrier: " << std::setw(8) << barrier_median
+                  << " usec" << std::endl;
+      }
+
+      add_result("Launch", ordinal, groups, {{"launch", "regular"}}, launch);
+      add_result("Launch", ordinal, groups, {{"launch", "cooperative"}},
+                 cooperative_launch);
+      add_result("Barrier", ordinal, groups,
+                 {{"rounds", std::to_string(barrier_rounds)}}, barrier);
+    }
+
+    benchmark->commandListDestroy(list);
+    benchmark->commandQueueDestroy(queue);
+  }
+}
+
+int main(int argc, char **argv) {
+  ZeCooperative cooperative;
+
+  cooperative.parse_arguments(argc, argv);
+
+  if (cooperative.results.enabled()) {
+    cooperative.results.read_metadata(cooperative.benchmark->_devices);
+  }
+
+  cooperative.test_cooperative();
+
+  std::cout << std::endl;
+  return cooperative.results.finish();
+}
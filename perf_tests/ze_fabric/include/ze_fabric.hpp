@@ -0,0 +1,78 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_FABRIC_HPP_
+#define _ZE_FABRIC_HPP_
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zes_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <string>
+#include <vector>
+
+/* A sysman fabric port of a device and the device its remote port is on */
+struct FabricPort {
+  uint32_t device_id;
+  zes_fabric_port_handle_t handle;
+  zes_fabric_port_properties_t properties;
+  zes_fabric_port_state_t state;
+  /* index into the devices, or -1 when the remote port is on none of them */
+  int remote_device_id;
+};
+
+/* The fabric edges between two devices and the ports linking them */
+struct FabricLink {
+  uint32_t device_a;
+  uint32_t device_b;
+  /* models of the edges, such as XeLink or PCIe */
+  std::string models;
+  /* sum of the edge bandwidths in GBPS, 0 when not given per time */
+  long double edge_gbps = 0;
+  /* indexes into the ports, of device_a towards device_b and back */
+  std::vector<uint32_t> ports_a;
+  std::vector<uint32_t> ports_b;
+};
+
+class ZeFabric {
+public:
+  ZeFabric();
+  ~ZeFabric();
+  int parse_arguments(int argc, char **argv);
+  bool discover(void);
+  void test_links(void);
+
+  size_t transfer_size = 256 * 1024 * 1024;
+  uint32_t number_iterations = 20;
+  uint32_t warmup_iterations = 2;
+  /* a port is reported LOW below this percentage of the mean utilization
+   * of the ports carrying the same transfer */
+  uint32_t low_threshold = 50;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_fabric"};
+
+  ZeApp *benchmark;
+
+private:
+  void find_ports(void);
+  uint32_t copy_ordinal(uint32_t device_id);
+  std::vector<long double> copy_usec(uint32_t source, uint32_t destination);
+  void report_ports(const FabricLink &link, uint32_t source,
+                    const std::vector<uint32_t> &port_ids, bool transmit,
+                    const std::vector<zes_fabric_port_throughput_t> &before,
+                    const std::vector<zes_fabric_port_throughput_t> &after);
+  std::string port_name(const FabricPort &port);
+
+  std::vector<FabricPort> ports;
+  std::vector<FabricLink> links;
+};
+
+#endif /* _ZE_FABRIC_HPP_ */
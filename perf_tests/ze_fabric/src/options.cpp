@@ -0,0 +1,93 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_fabric.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+static const char *usage_str =
+    "\n ze_fabric [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -s                       set transfer size in bytes"
+    "\n                            [default:  268435456]"
+    "\n  -i                       set number of iterations per link and "
+    "direction"
+    "\n                            [default:  20]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  2]"
+    "\n  --low                    flag ports below this percentage of the "
+    "mean"
+    "\n                            utilization of the ports of the same "
+    "transfer"
+    "\n                            [default:  50]"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_fabric and sets
+// the test parameters accordingly for main to execute the tests with
+// the correct environment.
+//---------------------------------------------------------------------
+int ZeFabric::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+      transfer_size = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if ((strcmp(argv[i], "--low") == 0) && (i + 1 < argc)) {
+      low_threshold = std::min(100u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  return 0;
+}
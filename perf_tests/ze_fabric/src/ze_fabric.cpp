@@ -0,0 +1,456 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zes_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_fabric.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+static const char *port_status_name(zes_fabric_port_status_t status) {
+  switch (status) {
+  case ZES_FABRIC_PORT_STATUS_HEALTHY:
+    return "healthy";
+  case ZES_FABRIC_PORT_STATUS_DEGRADED:
+    return "DEGRADED";
+  case ZES_FABRIC_PORT_STATUS_FAILED:
+    return "FAILED";
+  case ZES_FABRIC_PORT_STATUS_DISABLED:
+    return "disabled";
+  default:
+    return "unknown";
+  }
+}
+
+/* Speed in GBPS, 0 when unknown */
+static long double port_speed_gbps(const zes_fabric_port_speed_t &speed) {
+  if (speed.bitRate <= 0 || speed.width <= 0) {
+    return 0;
+  }
+  return static_cast<long double>(speed.bitRate) * speed.width / 8 / 1e9;
+}
+
+static std::vector<zes_fabric_port_throughput_t>
+read_throughput(const std::vector<FabricPort> &ports,
+                const std::vector<uint32_t> &port_ids) {
+  std::vector<zes_fabric_port_throughput_t> throughput(port_ids.size());
+  for (size_t i = 0; i < port_ids.size(); i++) {
+    SUCCESS_OR_TERMINATE(
+        zesFabricPortGetThroughput(ports[port_ids[i]].handle, &throughput[i]));
+  }
+  return throughput;
+}
+
+ZeFabric::ZeFabric() {
+  benchmark = new ZeApp();
+
+  benchmark->allDevicesInit();
+}
+
+ZeFabric::~ZeFabric() {
+  benchmark->allDevicesCleanup();
+
+  delete benchmark;
+}
+
+std::string ZeFabric::port_name(const FabricPort &port) {
+  std::string name = std::to_string(port.device_id);
+  if (port.properties.onSubdevice) {
+    name += "." + std::to_string(port.properties.subdeviceId);
+  }
+  return name + ":" + std::to_string(port.properties.portId.portNumber);
+}
+
+//---------------------------------------------------------------------
+// Looks up the fabric ports of every device through sysman, and the
+// device each one is cabled to from the fabric id of its remote port.
+//---------------------------------------------------------------------
+void ZeFabric::find_ports(void) {
+  std::map<uint32_t, uint32_t> fabric_devices;
+
+  for (uint32_t d = 0; d < benchmark->_devices.size(); d++) {
+    zes_device_handle_t device =
+        reinterpret_cast<zes_device_handle_t>(benchmark->_devices[d]);
+    uint32_t port_count = 0;
+    if (zesDeviceEnumFabricPorts(device, &port_count, nullptr) !=
+            ZE_RESULT_SUCCESS ||
+        port_count == 0) {
+      continue;
+    }
+    std::vector<zes_fabric_port_handle_t> handles(port_count);
+    SUCCESS_OR_TERMINATE(
+        zesDeviceEnumFabricPorts(device, &port_count, handles.data()));
+    for (auto handle : handles) {
+      FabricPort port = {};
+      port.device_id = d;
+      port.handle = handle;
+      port.properties = {ZES_STRUCTURE_TYPE_FABRIC_PORT_PROPERTIES, nullptr};
+      SUCCESS_OR_TERMINATE(
+          zesFabricPortGetProperties(handle, &port.properties));
+      port.state = {ZES_STRUCTURE_TYPE_FABRIC_PORT_STATE, nullptr};
+      SUCCESS_OR_TERMINATE(zesFabricPortGetState(handle, &port.state));
+      fabric_devices[port.properties.portId.fabricId] = d;
+      ports.push_back(port);
+    }
+  }
+
+  for (auto &port : ports) {
+    auto remote = fabric_devices.find(port.state.remotePortId.fabricId);
+    port.remote_device_id = (remote == fabric_devices.end() ||
+                             port.state.status ==
+                                 ZES_FABRIC_PORT_STATUS_DISABLED)
+                                ? -1
+                                : static_cast<int>(remote->second);
+  }
+}
+
+//---------------------------------------------------------------------
+// Walks the fabric edges between every pair of devices and groups them
+// with the ports linking the two devices. Prints the topology, with the
+// ports that lead to none of the devices, and returns false when the
+// driver has no fabric topology.
+//---------------------------------------------------------------------
+bool ZeFabric::discover(void) {
+  const uint32_t device_count =
+      static_cast<uint32_t>(benchmark->_devices.size());
+  std::vector<ze_fabric_vertex_handle_t> vertices(device_count);
+  for (uint32_t d = 0; d < device_count; d++) {
+    if (zeDeviceGetFabricVertexExp(benchmark->_devices[d], &vertices[d]) !=
+        ZE_RESULT_SUCCESS) {
+      std::cout << "Fabric topology is not supported by the driver"
+                << std::endl;
+      return false;
+    }
+  }
+
+  find_ports();
+
+  for (uint32_t a = 0; a < device_count; a++) {
+    for (uint32_t b = a + 1; b < device_count; b++) {
+      uint32_t edge_count = 0;
+      SUCCESS_OR_TERMINATE(
+          zeFabricEdgeGetExp(vertices[a], vertices[b], &edge_count, nullptr));
+      if (edge_count == 0) {
+        continue;
+      }
+      std::vector<ze_fabric_edge_handle_t> edges(edge_count);
+      SUCCESS_OR_TERMINATE(zeFabricEdgeGetExp(vertices[a], vertices[b],
+                                              &edge_count, edges.data()));
+
+      FabricLink link;
+      link.device_a = a;
+      link.device_b = b;
+      for (auto edge : edges) {
+        ze_fabric_edge_exp_properties_t properties = {
+            ZE_STRUCTURE_TYPE_FABRIC_EDGE_EXP_PROPERTIES, nullptr};
+        SUCCESS_OR_TERMINATE(zeFabricEdgeGetPropertiesExp(edge, &properties));
+        link.models += (link.models.empty() ? "" : "+");
+        link.models += properties.model;
+        if (properties.bandwidthUnit == ZE_BANDWIDTH_UNIT_BYTES_PER_NANOSEC) {
+          link.edge_gbps += properties.bandwidth;
+        }
+      }
+      for (uint32_t p = 0; p < ports.size(); p++) {
+        if (ports[p].device_id == a &&
+            ports[p].remote_device_id == static_cast<int>(b)) {
+          link.ports_a.push_back(p);
+        } else if (ports[p].device_id == b &&
+                   ports[p].remote_device_id == static_cast<int>(a)) {
+          link.ports_b.push_back(p);
+        }
+      }
+      links.push_back(link);
+    }
+  }
+
+  std::cout << std::endl;
+  std::cout << "FABRIC TOPOLOGY" << std::endl;
+  for (auto &link : links) {
+    std::cout << "Device " << link.device_a << " <-> " << link.device_b << ": "
+              << link.models << ", " << std::fixed << std::setprecision(2)
+              << link.edge_gbps << " GBPS, ports " << link.ports_a.size()
+              << " <-> " << link.ports_b.size();
+    if (link.ports_a.size() != link.ports_b.size()) {
+      std::cout << " ASYMMETRIC";
+    }
+    std::cout << std::endl;
+  }
+  for (auto &port : ports) {
+    if (port.remote_device_id < 0 &&
+        port.state.status != ZES_FABRIC_PORT_STATUS_DISABLED) {
+      std::cout << "Port " << port_name(port) << " ("
+                << port_status_name(port.state.status)
+                << ") leads to none of the devices" << std::endl;
+    }
+  }
+  if (links.empty()) {
+    std::cout << "No fabric edges between the devices" << std::endl;
+  }
+  return true;
+}
+
+/* The first copy only engine group of the device, else the first compute
+ * one */
+uint32_t ZeFabric::copy_ordinal(uint32_t device_id) {
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(
+      device_id, &num_queue_groups, queue_properties.data());
+
+  uint32_t compute_ordinal = num_queue_groups;
+  for (uint32_t i = 0; i < num_queue_groups; i++) {
+    const ze_command_queue_group_property_flags_t flags =
+        queue_properties[i].flags;
+    if ((flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY) &&
+        !(flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE)) {
+      return i;
+    }
+    if ((flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) &&
+        compute_ordinal == num_queue_groups) {
+      compute_ordinal = i;
+    }
+  }
+  return (compute_ordinal < num_queue_groups) ? compute_ordinal : 0;
+}
+
+//---------------------------------------------------------------------
+// Copies transfer_size bytes from device memory of source to device
+// memory of destination on an engine of source, and returns the time of
+// every iteration.
+//---------------------------------------------------------------------
+std::vector<long double> ZeFabric::copy_usec(uint32_t source,
+                                             uint32_t destination) {
+  SampleTimer<std::micro> timer(number_iterations);
+  const uint32_t ordinal = copy_ordinal(source);
+  ze_command_queue_handle_t queue;
+  ze_command_list_handle_t list;
+  void *source_buffer = nullptr;
+  void *destination_buffer = nullptr;
+
+  benchmark->memoryAlloc(source, transfer_size, &source_buffer);
+  benchmark->memoryAlloc(destination, transfer_size, &destination_buffer);
+  benchmark->commandQueueCreate(source, ordinal, &queue);
+  benchmark->commandListCreate(source, ordinal, &list);
+  benchmark->commandListAppendMemoryCopy(list, destination_buffer,
+                                         source_buffer, transfer_size);
+  benchmark->commandListClose(list);
+
+  for (uint32_t i = 0; i < warmup_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+  }
+  for (uint32_t i = 0; i < number_iterations; i++) {
+    timer.start();
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    timer.stop();
+  }
+
+  benchmark->commandListDestroy(list);
+  benchmark->commandQueueDestroy(queue);
+  benchmark->memoryFree(destination_buffer);
+  benchmark->memoryFree(source_buffer);
+  return timer.samples();
+}
+
+//---------------------------------------------------------------------
+// Prints the rate of every port of one side of a link over a transfer,
+// tx on the source side and rx on the destination side, against the
+// maximum speed of the port, and flags ports that are not healthy, run
+// below their maximum speed, or carry less than low_threshold percent
+// of the mean utilization of the side.
+//---------------------------------------------------------------------
+void ZeFabric::report_ports(
+    const FabricLink &link, uint32_t source,
+    const std::vector<uint32_t> &port_ids, bool transmit,
+    const std::vector<zes_fabric_port_throughput_t> &before,
+    const std::vector<zes_fabric_port_throughput_t> &after) {
+  const uint32_t destination =
+      (source == link.device_a) ? link.device_b : link.device_a;
+  std::vector<long double> rates(port_ids.size(), 0);
+  std::vector<long double> utilizations(port_ids.size(), 0);
+  long double utilization_sum = 0;
+
+  for (size_t i = 0; i < port_ids.size(); i++) {
+    const FabricPort &port = ports[port_ids[i]];
+    const long double elapsed_usec =
+        static_cast<long double>(after[i].timestamp - before[i].timestamp);
+    const uint64_t bytes = transmit
+                               ? after[i].txCounter - before[i].txCounter
+                               : after[i].rxCounter - before[i].rxCounter;
+    /* bytes per us over 1e3 are GBPS */
+    rates[i] = (elapsed_usec > 0) ? bytes / elapsed_usec / 1e3 : 0;
+    const long double max_gbps =
+        port_speed_gbps(transmit ? port.properties.maxTxSpeed
+                                 : port.properties.maxRxSpeed);
+    utilizations[i] = (max_gbps > 0) ? 100 * rates[i] / max_gbps : 0;
+    utilization_sum += utilizations[i];
+  }
+  const long double utilization_mean =
+      port_ids.empty() ? 0 : utilization_sum / port_ids.size();
+
+  for (size_t i = 0; i < port_ids.size(); i++) {
+    FabricPort &port = ports[port_ids[i]];
+    port.state = {ZES_STRUCTURE_TYPE_FABRIC_PORT_STATE, nullptr};
+    SUCCESS_OR_TERMINATE(zesFabricPortGetState(port.handle, &port.state));
+    const zes_fabric_port_speed_t &max_speed =
+        transmit ? port.properties.maxTxSpeed : port.properties.maxRxSpeed;
+    const zes_fabric_port_speed_t &speed =
+        transmit ? port.state.txSpeed : port.state.rxSpeed;
+    const long double max_gbps = port_speed_gbps(max_speed);
+    const long double speed_gbps = port_speed_gbps(speed);
+
+    std::string flags = port_status_name(port.state.status);
+    if (speed_gbps > 0 && speed_gbps < max_gbps) {
+      flags += " SLOW";
+    }
+    if (utilizations[i] < utilization_mean * low_threshold / 100) {
+      flags += " LOW";
+    }
+
+    const std::string name = port_name(port);
+    const char *direction = transmit ? "tx" : "rx";
+    if (csv_output) {
+      std::cout << source << "," << destination << ",port," << name << ","
+                << direction << "," << rates[i] << "," << max_gbps << ","
+                << utilizations[i] << "," << flags << std::endl;
+    } else {
+      std::cout << "  Port " << std::setw(8) << name << " " << direction
+                << ": " << std::setw(8) << rates[i] << " GBPS of "
+                << std::setw(8) << max_gbps << " (" << std::setw(6)
+                << utilizations[i] << "%) " << flags << std::endl;
+    }
+
+    if (results.enabled()) {
+      ResultRecord record;
+      record.test = "Port";
+      record.metric = "utilization";
+      record.unit = "%";
+      record.value = utilizations[i];
+      record.parameters = {{"source", std::to_string(source)},
+                           {"destination", std::to_string(destination)},
+                           {"port", name},
+                           {"direction", direction}};
+      results.add(record);
+      record.metric = "bandwidth";
+      record.unit = "GBPS";
+      record.value = rates[i];
+      results.add(record);
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Drives copies over every link in both directions and reports the
+// bandwidth of the copies against the edge bandwidth, with the
+// utilization of every port of the link from its throughput counters.
+//---------------------------------------------------------------------
+void ZeFabric::test_links(void) {
+  std::cout << std::endl;
+  std::cout << "FABRIC LINK BANDWIDTH" << std::endl;
+  if (csv_output) {
+    std::cout << "Source,Destination,Kind,Name,Direction,Bandwidth_(GBPS),"
+                 "Max_(GBPS),Utilization_(%),Flags"
+              << std::endl;
+  }
+
+  for (auto &link : links) {
+    for (int direction = 0; direction < 2; direction++) {
+      const uint32_t source = direction ? link.device_b : link.device_a;
+      const uint32_t destination = direction ? link.device_a : link.device_b;
+      const std::vector<uint32_t> &source_ports =
+          direction ? link.ports_b : link.ports_a;
+      const std::vector<uint32_t> &destination_ports =
+          direction ? link.ports_a : link.ports_b;
+
+      if (!benchmark->canAccessPeer(source, destination)) {
+        std::cout << "Device " << source << " -> " << destination
+                  << ": no peer access, skipped" << std::endl;
+        continue;
+      }
+
+      const auto source_before = read_throughput(ports, source_ports);
+      const auto destination_before = read_throughput(ports, destination_ports);
+      const std::vector<long double> usec = copy_usec(source, destination);
+      const auto source_after = read_throughput(ports, source_ports);
+      const auto destination_after = read_throughput(ports, destination_ports);
+
+      std::vector<long double> gbps;
+      for (auto sample : usec) {
+        if (sample > 0) {
+          gbps.push_back(transfer_size / sample / 1e3);
+        }
+      }
+      const ResultStats stats = ResultStats::from_samples(gbps);
+      const long double efficiency =
+          (link.edge_gbps > 0) ? 100 * stats.median / link.edge_gbps : 0;
+
+      std::cout << std::fixed << std::setprecision(2);
+      if (csv_output) {
+        std::cout << source << "," << destination << ",link," << link.models
+                  << ",copy," << stats.median << "," << link.edge_gbps << ","
+                  << efficiency << "," << std::endl;
+      } else {
+        std::cout << "Device " << source << " -> " << destination << " ("
+                  << link.models << "): " << std::setw(8) << stats.median
+                  << " GBPS of " << std::setw(8) << link.edge_gbps << " ("
+                  << std::setw(6) << efficiency << "%)" << std::endl;
+      }
+      if (results.enabled()) {
+        ResultRecord record;
+        record.test = "Link";
+        record.metric = "bandwidth";
+        record.unit = "GBPS";
+        record.parameters = {{"source", std::to_string(source)},
+                             {"destination", std::to_string(destination)},
+                             {"model", link.models},
+                             {"size", std::to_string(transfer_size)}};
+        record.stats = stats;
+        record.value = stats.median;
+        record.samples = gbps;
+        results.add(record);
+      }
+
+      report_ports(link, source, source_ports, true, source_before,
+                   source_after);
+      report_ports(link, source, destination_ports, false, destination_before,
+                   destination_after);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  /* the fabric ports are read through sysman on the core device handles */
+  static char sys_env[] = "ZES_ENABLE_SYSMAN=1";
+  putenv(sys_env);
+
+  ZeFabric fabric;
+
+  fabric.parse_arguments(argc, argv);
+
+  if (fabric.results.enabled()) {
+    fabric.results.read_metadata(fabric.benchmark->_devices);
+  }
+
+  if (fabric.discover()) {
+    fabric.test_links();
+  }
+
+  std::cout << std::endl;
+  return fabric.results.finish();
+}
@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 #include <boost/program_options.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
@@ -38,6 +39,12 @@ public:
   uint32_t warm_up_iterations = 10;
   uint32_t num_image_copies = 100;
   uint32_t data_validation = 0;
+  bool sweep = false;
+  uint32_t sweep_max_size_mb = 256;
+  uint32_t num_streams = 0;
+  uint32_t stream_frames = 300;
+  std::string stream_engines = "all";
+  std::vector<std::pair<uint32_t, uint32_t>> stream_resolutions;
   bool validRet = false;
   long double gbps;
   long double latency;
@@ -54,15 +61,32 @@ public:
   void measureParallelDevice2Host();
   void measureSerialHost2Device();
   void measureSerialDevice2Host();
+  void measureImage2Image();
+  void measureImageRegion2Image();
+  void measureImage2DeviceCopy(uint32_t ordinal);
+  void measureImage2DeviceKernel();
+  int32_t get_copy_only_ordinal(void);
+  std::vector<std::pair<uint32_t, uint32_t>> get_stream_engines(void);
+  void measureStreaming(uint32_t frame_width, uint32_t frame_height,
+                        std::vector<long double> &stream_fps,
+                        long double &aggregate_fps);
   int parse_command_line(int argc, char **argv);
   bool is_json_output_enabled();
+  void put_image_config(ptree *test_ptree);
+  bool is_image_supported(void);
+  ze_device_image_properties_t get_device_image_properties(void);
 
 private:
   void initialize_buffer(void);
+  void initialize_image_desc(void);
   void test_initialize(void);
   void test_cleanup(void);
   void validate_data_buffer(void);
   void reset_all_events(void);
+  void measure_command_list(ze_command_queue_handle_t queue,
+                            ze_command_list_handle_t list,
+                            long double bytes_per_list,
+                            uint32_t copies_per_list);
 
   ZeApp *benchmark;
   ze_command_queue_handle_t command_queue;
@@ -87,4 +111,7 @@ public:
   ZeImageCopyLatency();
 };
 
+void measure_image_paths(ZeImageCopy &Imagecopy, ptree *param_array);
+void measure_streaming(ZeImageCopy &Imagecopy);
+
 #endif /* ZE_IMAGE_COPY_H */
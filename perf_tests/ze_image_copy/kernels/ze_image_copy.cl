@@ -0,0 +1,19 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Reads the image through the sampler, one work item per pixel, and packs
+// the four 8-bit channels of every pixel into a uint of the output buffer.
+__kernel void image_read_sampler(read_only image2d_t input, sampler_t sampler,
+                                 __global uint *output, uint width) {
+  int x = get_global_id(0);
+  int y = get_global_id(1);
+  uint4 pixel = read_imageui(input, sampler, (int2)(x, y));
+
+  output[y * width + x] =
+      pixel.x | (pixel.y << 8) | (pixel.z << 16) | (pixel.w << 24);
+}
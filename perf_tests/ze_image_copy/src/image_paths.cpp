@@ -0,0 +1,389 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_image_copy.h"
+
+#include <algorithm>
+
+// Warms up, then times num_iterations executions of a closed command list
+// and sets the bandwidth and the latency of one of its copies
+void ZeImageCopy::measure_command_list(ze_command_queue_handle_t queue,
+                                       ze_command_list_handle_t list,
+                                       long double bytes_per_list,
+                                       uint32_t copies_per_list) {
+  Timer<std::chrono::microseconds::period> timer;
+  long double total_time_usec = 0;
+
+  for (int i = 0; i < warm_up_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+  }
+
+  for (int i = 0; i < num_iterations; i++) {
+    timer.start();
+    SUCCESS_OR_TERMINATE(
+        zeCommandQueueExecuteCommandLists(queue, 1, &list, nullptr));
+    SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(queue, UINT64_MAX));
+    timer.end();
+    total_time_usec += timer.period_minus_overhead();
+  }
+
+  gbps = (bytes_per_list * num_iterations / 1e9) / (total_time_usec / 1e6);
+  latency = total_time_usec /
+            static_cast<long double>(copies_per_list * num_iterations);
+  std::cout << gbps << " GBPS\n";
+  std::cout << std::setprecision(11) << latency << " us"
+            << " (Latency: per copy)" << std::endl;
+}
+
+// Returns the ordinal of the first queue group with copy but no compute
+// support, or -1 when the device has no copy engine
+int32_t ZeImageCopy::get_copy_only_ordinal(void) {
+  uint32_t numQueueGroups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(0, &numQueueGroups, nullptr);
+  std::vector<ze_command_queue_group_properties_t> group_properties(
+      numQueueGroups,
+      {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES, nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(0, &numQueueGroups,
+                                                  group_properties.data());
+
+  for (uint32_t i = 0; i < numQueueGroups; i++) {
+    if ((group_properties[i].flags &
+         ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) == 0 &&
+        (group_properties[i].flags &
+         ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY)) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  return -1;
+}
+
+// Image to image copies of the whole image, with zeCommandListAppendImageCopy
+void ZeImageCopy::measureImage2Image() {
+  ze_image_handle_t dst_image;
+
+  this->test_initialize();
+  benchmark->imageCreate(&imageDesc, &dst_image);
+
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendImageCopyFromMemory(command_list_a, image,
+                                                  srcBuffer, &this->region);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  benchmark->commandListReset(command_list_b);
+  for (int i = 0; i < num_image_copies; i++) {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendImageCopy(
+        command_list_b, dst_image, image, nullptr, 0, nullptr));
+  }
+  benchmark->commandListClose(command_list_b);
+
+  measure_command_list(command_queue, command_list_b,
+                       static_cast<long double>(buffer_size) *
+                           num_image_copies,
+                       num_image_copies);
+
+  // Copy the destination image back to the host to validate it
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendImageCopyToMemory(command_list_a, dstBuffer,
+                                                dst_image, &this->region);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  this->validate_data_buffer();
+  benchmark->imageDestroy(dst_image);
+  this->test_cleanup();
+}
+
+// Copies of the middle half of every dimension of the image, at an offset,
+// to the origin of another image with zeCommandListAppendImageCopyRegion
+void ZeImageCopy::measureImageRegion2Image() {
+  ze_image_handle_t dst_image;
+  const uint32_t bytes_per_pixel =
+      level_zero_tests::num_bytes_per_pixel(Imagelayout);
+
+  this->test_initialize();
+  benchmark->imageCreate(&imageDesc, &dst_image);
+
+  ze_image_region_t src_region = {width / 4,
+                                  height / 4,
+                                  depth / 4,
+                                  std::max(width / 2, 1u),
+                                  std::max(height / 2, 1u),
+                                  std::max(depth / 2, 1u)};
+  ze_image_region_t dst_region = {
+      0, 0, 0, src_region.width, src_region.height, src_region.depth};
+  const size_t region_size = static_cast<size_t>(bytes_per_pixel) *
+                             src_region.width * src_region.height *
+                             src_region.depth;
+
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendImageCopyFromMemory(command_list_a, image,
+                                                  srcBuffer, &this->region);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  benchmark->commandListReset(command_list_b);
+  for (int i = 0; i < num_image_copies; i++) {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendImageCopyRegion(
+        command_list_b, dst_image, image, &dst_region, &src_region, nullptr,
+        0, nullptr));
+  }
+  benchmark->commandListClose(command_list_b);
+
+  measure_command_list(command_queue, command_list_b,
+                       static_cast<long double>(region_size) *
+                           num_image_copies,
+                       num_image_copies);
+
+  // Only the copied block of the destination image is defined, so it is
+  // compared row by row with the block of the source
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendImageCopyToMemory(command_list_a, dstBuffer,
+                                                dst_image, &this->region);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  if (this->data_validation) {
+    const size_t row_size =
+        static_cast<size_t>(bytes_per_pixel) * src_region.width;
+    validRet = true;
+    for (uint32_t z = 0; z < src_region.depth; z++) {
+      for (uint32_t y = 0; y < src_region.height; y++) {
+        const size_t dst_offset =
+            (static_cast<size_t>(z) * height + y) * width * bytes_per_pixel;
+        const size_t src_offset =
+            ((static_cast<size_t>(z + src_region.originZ) * height + y +
+              src_region.originY) *
+                 width +
+             src_region.originX) *
+            bytes_per_pixel;
+        validRet = validRet && (0 == memcmp(dstBuffer + dst_offset,
+                                            srcBuffer + src_offset, row_size));
+      }
+    }
+  }
+
+  benchmark->imageDestroy(dst_image);
+  this->test_cleanup();
+}
+
+// Image to device memory through the copy path, on the queue group ordinal
+void ZeImageCopy::measureImage2DeviceCopy(uint32_t ordinal) {
+  ze_command_queue_handle_t queue;
+  ze_command_list_handle_t list;
+  void *device_buffer = nullptr;
+
+  this->test_initialize();
+  benchmark->memoryAlloc(buffer_size, &device_buffer);
+  benchmark->commandQueueCreate(0, ordinal, &queue);
+  benchmark->commandListCreate(0, ordinal, &list);
+
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendImageCopyFromMemory(command_list_a, image,
+                                                  srcBuffer, &this->region);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  for (int i = 0; i < num_image_copies; i++) {
+    benchmark->commandListAppendImageCopyToMemory(
+        list, static_cast<uint8_t *>(device_buffer), image, &this->region);
+  }
+  benchmark->commandListClose(list);
+
+  measure_command_list(
+      queue, list, static_cast<long double>(buffer_size) * num_image_copies,
+      num_image_copies);
+
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendMemoryCopy(command_list_a, dstBuffer,
+                                         device_buffer, buffer_size);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  this->validate_data_buffer();
+  benchmark->commandListDestroy(list);
+  benchmark->commandQueueDestroy(queue);
+  benchmark->memoryFree(device_buffer);
+  this->test_cleanup();
+}
+
+// Image to device memory through a kernel reading every pixel with a
+// nearest, unnormalized sampler. The kernel packs four 8-bit channels per
+// pixel, so the image must be 2D with layout 8_8_8_8 and format UINT.
+void ZeImageCopy::measureImage2DeviceKernel() {
+  ze_kernel_handle_t function;
+  ze_sampler_handle_t sampler;
+  void *device_buffer = nullptr;
+  uint32_t group_size_x = 0;
+  uint32_t group_size_y = 0;
+  uint32_t group_size_z = 0;
+
+  assert(Imagetype == ZE_IMAGE_TYPE_2D &&
+         Imagelayout == ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8 &&
+         Imageformat == ZE_IMAGE_FORMAT_TYPE_UINT);
+  this->test_initialize();
+  benchmark->memoryAlloc(buffer_size, &device_buffer);
+
+  ze_sampler_desc_t sampler_desc = {};
+  sampler_desc.stype = ZE_STRUCTURE_TYPE_SAMPLER_DESC;
+  sampler_desc.addressMode = ZE_SAMPLER_ADDRESS_MODE_NONE;
+  sampler_desc.filterMode = ZE_SAMPLER_FILTER_MODE_NEAREST;
+  sampler_desc.isNormalized = false;
+  SUCCESS_OR_TERMINATE(zeSamplerCreate(benchmark->context,
+                                       benchmark->_devices[0], &sampler_desc,
+                                       &sampler));
+
+  benchmark->functionCreate(&function, "image_read_sampler");
+  SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(
+      function, width, height, 1, &group_size_x, &group_size_y,
+      &group_size_z));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetGroupSize(function, group_size_x, group_size_y, 1));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(function, 0, sizeof(image), &image));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(function, 1, sizeof(sampler), &sampler));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+      function, 2, sizeof(device_buffer), &device_buffer));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(function, 3, sizeof(width), &width));
+
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendImageCopyFromMemory(command_list_a, image,
+                                                  srcBuffer, &this->region);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  ze_group_count_t group_count = {width / group_size_x, height / group_size_y,
+                                  1};
+  benchmark->commandListReset(command_list_b);
+  for (int i = 0; i < num_image_copies; i++) {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        command_list_b, function, &group_count, nullptr, 0, nullptr));
+  }
+  benchmark->commandListClose(command_list_b);
+
+  measure_command_list(command_queue, command_list_b,
+                       static_cast<long double>(buffer_size) *
+                           num_image_copies,
+                       num_image_copies);
+
+  benchmark->commandListReset(command_list_a);
+  benchmark->commandListAppendMemoryCopy(command_list_a, dstBuffer,
+                                         device_buffer, buffer_size);
+  benchmark->commandListClose(command_list_a);
+  benchmark->commandQueueExecuteCommandList(command_queue, 1, &command_list_a);
+  benchmark->commandQueueSynchronize(command_queue);
+
+  this->validate_data_buffer();
+  benchmark->functionDestroy(function);
+  SUCCESS_OR_TERMINATE(zeSamplerDestroy(sampler));
+  benchmark->memoryFree(device_buffer);
+  this->test_cleanup();
+}
+
+static void put_path_result(ZeImageCopy &Imagecopy, ptree *param_array,
+                            const std::string &name) {
+  if (Imagecopy.is_json_output_enabled()) {
+    std::stringstream Image_dimensions;
+    Image_dimensions << Imagecopy.width << "X" << Imagecopy.height << "X"
+                     << Imagecopy.depth;
+    ptree test_ptree;
+    test_ptree.put("Name", name);
+    test_ptree.put("Image size", Image_dimensions.str());
+    test_ptree.put("Image format",
+                   level_zero_tests::to_string(Imagecopy.Imageformat));
+    test_ptree.put("Image Layout",
+                   level_zero_tests::to_string(Imagecopy.Imagelayout));
+    test_ptree.put("GBPS", Imagecopy.gbps);
+    test_ptree.put("Latency", Imagecopy.latency);
+    if (Imagecopy.data_validation)
+      test_ptree.put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
+    param_array->push_back(std::make_pair("", test_ptree));
+  } else if (Imagecopy.data_validation) {
+    std::cout << "  Results: Data validation "
+              << (Imagecopy.validRet ? "PASSED" : "FAILED") << std::endl;
+    std::cout << std::endl;
+  }
+}
+
+// Copies staying on the device: image to image, a region at an offset of
+// the configured image, then image to device memory for a 2D RGBA 8-bit
+// image of the same width and height, through the copy path on the compute
+// queue and on the copy engine when there is one, and through a sampler
+// kernel. These are the two routes a video pipeline can take.
+void measure_image_paths(ZeImageCopy &Imagecopy, ptree *param_array) {
+  std::cout << "Image2Image: Measuring Bandwidth/Latency for copying the "
+               "image "
+            << Imagecopy.width << "X" << Imagecopy.height << "X"
+            << Imagecopy.depth << " to another image" << std::endl;
+  Imagecopy.measureImage2Image();
+  put_path_result(Imagecopy, param_array,
+                  "Image2Image: Bandwidth copying from Image->Image");
+
+  std::cout << "ImageRegion2Image: Measuring Bandwidth/Latency for copying "
+               "the middle half of the image at an offset to another image"
+            << std::endl;
+  Imagecopy.measureImageRegion2Image();
+  put_path_result(Imagecopy, param_array,
+                  "ImageRegion2Image: Bandwidth copying a region at an offset "
+                  "from Image->Image");
+
+  const ze_image_type_t type = Imagecopy.Imagetype;
+  const ze_image_format_layout_t layout = Imagecopy.Imagelayout;
+  const ze_image_format_type_t format = Imagecopy.Imageformat;
+  const uint32_t depth = Imagecopy.depth;
+  Imagecopy.Imagetype = ZE_IMAGE_TYPE_2D;
+  Imagecopy.Imagelayout = ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8;
+  Imagecopy.Imageformat = ZE_IMAGE_FORMAT_TYPE_UINT;
+  Imagecopy.depth = 1;
+
+  std::cout << "Image2Device: Measuring Bandwidth/Latency for copying the "
+               "image "
+            << Imagecopy.width << "X" << Imagecopy.height
+            << " 8_8_8_8 to device memory on the compute queue" << std::endl;
+  Imagecopy.measureImage2DeviceCopy(0);
+  put_path_result(Imagecopy, param_array,
+                  "Image2Device: Bandwidth copying from Image->Device memory "
+                  "on the compute queue");
+
+  const int32_t copy_ordinal = Imagecopy.get_copy_only_ordinal();
+  if (copy_ordinal >= 0) {
+    std::cout << "Image2Device: Measuring Bandwidth/Latency for copying the "
+                 "image to device memory on the copy engine"
+              << std::endl;
+    Imagecopy.measureImage2DeviceCopy(static_cast<uint32_t>(copy_ordinal));
+    put_path_result(Imagecopy, param_array,
+                    "Image2Device: Bandwidth copying from Image->Device "
+                    "memory on the copy engine");
+  } else {
+    std::cout << "Image2Device: No copy engine, skipping the copy engine path"
+              << std::endl;
+  }
+
+  std::cout << "Image2Device: Measuring Bandwidth/Latency for reading the "
+               "image to device memory with a sampler kernel"
+            << std::endl;
+  Imagecopy.measureImage2DeviceKernel();
+  put_path_result(Imagecopy, param_array,
+                  "Image2Device: Bandwidth reading from Image->Device memory "
+                  "with a sampler kernel");
+
+  Imagecopy.Imagetype = type;
+  Imagecopy.Imagelayout = layout;
+  Imagecopy.Imageformat = format;
+  Imagecopy.depth = depth;
+}
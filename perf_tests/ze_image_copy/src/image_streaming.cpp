@@ -0,0 +1,235 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_image_copy.h"
+
+#include <algorithm>
+
+// One camera: two images filled from two host frames in turn, each slot
+// with its own command list and fence, so one frame is uploaded while the
+// other completes
+struct ImageStream {
+  uint32_t ordinal;
+  uint32_t index;
+  ze_command_queue_handle_t queue;
+  ze_command_list_handle_t list[2];
+  ze_fence_handle_t fence[2];
+  ze_image_handle_t image[2];
+  void *frame[2];
+  uint32_t submitted = 0;
+  uint32_t completed = 0;
+  std::chrono::high_resolution_clock::time_point end;
+};
+
+// Engines of the selected kind as queue group ordinal and queue index,
+// one queue of every group in turn, so that consecutive streams land on
+// different engines
+std::vector<std::pair<uint32_t, uint32_t>>
+ZeImageCopy::get_stream_engines(void) {
+  uint32_t numQueueGroups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(0, &numQueueGroups, nullptr);
+  std::vector<ze_command_queue_group_properties_t> group_properties(
+      numQueueGroups,
+      {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES, nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(0, &numQueueGroups,
+                                                  group_properties.data());
+
+  std::vector<uint32_t> groups;
+  uint32_t max_queues = 0;
+  for (uint32_t i = 0; i < numQueueGroups; i++) {
+    const bool compute = group_properties[i].flags &
+                         ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE;
+    const bool copy =
+        group_properties[i].flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY;
+    if ((stream_engines != "copy" && compute) ||
+        (stream_engines != "compute" && copy && !compute)) {
+      groups.push_back(i);
+      max_queues = std::max(max_queues, group_properties[i].numQueues);
+    }
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> engines;
+  for (uint32_t index = 0; index < max_queues; index++) {
+    for (auto group : groups) {
+      if (index < group_properties[group].numQueues) {
+        engines.push_back(std::make_pair(group, index));
+      }
+    }
+  }
+  return engines;
+}
+
+// Streams stream_frames frames of frame_width x frame_height on each of
+// num_streams streams at once, the host keeping two frames in flight per
+// stream and resubmitting a slot as soon as its fence is signaled. Sets
+// gbps and the frame rate of every stream and of all of them together.
+void ZeImageCopy::measureStreaming(uint32_t frame_width, uint32_t frame_height,
+                                   std::vector<long double> &stream_fps,
+                                   long double &aggregate_fps) {
+  const auto engines = get_stream_engines();
+  if (engines.empty()) {
+    std::cerr << "ERROR : no " << stream_engines
+              << " engine to stream images on" << std::endl;
+    std::terminate();
+  }
+
+  Imagetype = ZE_IMAGE_TYPE_2D;
+  width = frame_width;
+  height = frame_height;
+  depth = 1;
+  initialize_image_desc();
+  const size_t frame_size =
+      static_cast<size_t>(level_zero_tests::num_bytes_per_pixel(Imagelayout)) *
+      width * height;
+  ze_image_region_t frame_region = {0, 0, 0, width, height, 1};
+
+  std::vector<ImageStream> streams(num_streams);
+  for (uint32_t s = 0; s < num_streams; s++) {
+    auto &stream = streams[s];
+    stream.ordinal = engines[s % engines.size()].first;
+    stream.index = engines[s % engines.size()].second;
+    benchmark->commandQueueCreate(0, stream.ordinal, stream.index,
+                                  &stream.queue);
+    for (int slot = 0; slot < 2; slot++) {
+      benchmark->imageCreate(&imageDesc, &stream.image[slot]);
+      benchmark->memoryAllocHost(frame_size, &stream.frame[slot]);
+      memset(stream.frame[slot], static_cast<int>(s + slot), frame_size);
+
+      ze_fence_desc_t fence_desc = {};
+      fence_desc.stype = ZE_STRUCTURE_TYPE_FENCE_DESC;
+      SUCCESS_OR_TERMINATE(
+          zeFenceCreate(stream.queue, &fence_desc, &stream.fence[slot]));
+
+      benchmark->commandListCreate(0, stream.ordinal, &stream.list[slot]);
+      benchmark->commandListAppendImageCopyFromMemory(
+          stream.list[slot], stream.image[slot],
+          static_cast<uint8_t *>(stream.frame[slot]), &frame_region);
+      benchmark->commandListClose(stream.list[slot]);
+    }
+  }
+
+  // Warm up every slot once
+  for (auto &stream : streams) {
+    for (int slot = 0; slot < 2; slot++) {
+      benchmark->commandQueueExecuteCommandList(stream.queue, 1,
+                                                &stream.list[slot]);
+    }
+    benchmark->commandQueueSynchronize(stream.queue);
+  }
+
+  const auto begin = std::chrono::high_resolution_clock::now();
+  for (auto &stream : streams) {
+    for (int slot = 0; slot < 2 && stream.submitted < stream_frames; slot++) {
+      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+          stream.queue, 1, &stream.list[slot], stream.fence[slot]));
+      stream.submitted++;
+    }
+  }
+
+  uint32_t streams_done = 0;
+  while (streams_done < num_streams) {
+    for (auto &stream : streams) {
+      if (stream.completed == stream_frames) {
+        continue;
+      }
+      const int slot = stream.completed % 2;
+      if (zeFenceQueryStatus(stream.fence[slot]) != ZE_RESULT_SUCCESS) {
+        continue;
+      }
+      stream.completed++;
+      SUCCESS_OR_TERMINATE(zeFenceReset(stream.fence[slot]));
+      if (stream.submitted < stream_frames) {
+        SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+            stream.queue, 1, &stream.list[slot], stream.fence[slot]));
+        stream.submitted++;
+      }
+      if (stream.completed == stream_frames) {
+        stream.end = std::chrono::high_resolution_clock::now();
+        streams_done++;
+      }
+    }
+  }
+
+  long double total_time_s = 0;
+  stream_fps.clear();
+  for (auto &stream : streams) {
+    const long double time_s =
+        std::chrono::duration<long double>(stream.end - begin).count();
+    stream_fps.push_back(stream_frames / time_s);
+    total_time_s = std::max(total_time_s, time_s);
+  }
+  aggregate_fps = num_streams * stream_frames / total_time_s;
+  gbps = aggregate_fps * frame_size / 1e9;
+
+  for (auto &stream : streams) {
+    for (int slot = 0; slot < 2; slot++) {
+      SUCCESS_OR_TERMINATE(zeFenceDestroy(stream.fence[slot]));
+      benchmark->commandListDestroy(stream.list[slot]);
+      benchmark->imageDestroy(stream.image[slot]);
+      benchmark->memoryFree(stream.frame[slot]);
+    }
+    benchmark->commandQueueDestroy(stream.queue);
+  }
+}
+
+// Multi-camera ingest: num_streams independent streams uploading frames
+// from the host at each target resolution, one queue per stream
+void measure_streaming(ZeImageCopy &Imagecopy) {
+  ptree ptree_main;
+  const auto engines = Imagecopy.get_stream_engines();
+
+  for (auto &resolution : Imagecopy.stream_resolutions) {
+    std::vector<long double> stream_fps;
+    long double aggregate_fps = 0;
+
+    std::cout << "Streaming: " << Imagecopy.num_streams << " streams of "
+              << resolution.first << "X" << resolution.second << " "
+              << level_zero_tests::to_string(Imagecopy.Imagelayout)
+              << " frames from Host->Device" << std::endl;
+    Imagecopy.measureStreaming(resolution.first, resolution.second,
+                               stream_fps, aggregate_fps);
+
+    ptree test_ptree;
+    ptree ptree_streams;
+    std::stringstream Image_dimensions;
+    Image_dimensions << resolution.first << "X" << resolution.second;
+    test_ptree.put("Name", "Streaming: frames copied from Host->Device");
+    test_ptree.put("Image size", Image_dimensions.str());
+    test_ptree.put("Image Layout",
+                   level_zero_tests::to_string(Imagecopy.Imagelayout));
+    test_ptree.put("Streams", Imagecopy.num_streams);
+    test_ptree.put("Frames", Imagecopy.stream_frames);
+    for (uint32_t s = 0; s < stream_fps.size(); s++) {
+      const auto &engine = engines[s % engines.size()];
+      std::cout << "  Stream " << s << " (engine " << engine.first << "."
+                << engine.second << "): " << std::fixed
+                << std::setprecision(1) << stream_fps[s] << " FPS"
+                << std::endl;
+      ptree ptree_stream;
+      ptree_stream.put("Stream", s);
+      ptree_stream.put("Ordinal", engine.first);
+      ptree_stream.put("Index", engine.second);
+      ptree_stream.put("FPS", stream_fps[s]);
+      ptree_streams.push_back(std::make_pair("", ptree_stream));
+    }
+    std::cout << "  Aggregate: " << aggregate_fps << " FPS, "
+              << std::setprecision(3) << Imagecopy.gbps << " GBPS"
+              << std::endl
+              << std::defaultfloat;
+    test_ptree.put("Aggregate FPS", aggregate_fps);
+    test_ptree.put("GBPS", Imagecopy.gbps);
+    test_ptree.add_child("Per stream", ptree_streams);
+    Imagecopy.param_array.push_back(std::make_pair("", test_ptree));
+  }
+
+  if (Imagecopy.is_json_output_enabled()) {
+    ptree_main.put_child("Performance Benchmark.streaming",
+                         Imagecopy.param_array);
+    pt::write_json(Imagecopy.JsonFileName.c_str(), ptree_main);
+  }
+}
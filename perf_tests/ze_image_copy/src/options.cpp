@@ -14,6 +14,7 @@ int ZeImageCopy::parse_command_line(int argc, char **argv) {
   std::string flags = "";
   std::string type = "";
   std::string format = "";
+  std::string resolutions = "";
 
   // Declare the supported options.
   po::options_description desc("Allowed options");
@@ -49,6 +50,25 @@ int ZeImageCopy::parse_command_line(int argc, char **argv) {
       "image format like UINT/SINT/UNORM/SNORM/FLOAT")(
       "data-validation", po::value<uint32_t>(&data_validation),
       "optional param for validating the copied image is correct or not")(
+      "sweep", po::bool_switch(&sweep),
+      "sweep the common layouts, the image types and sizes up to the device "
+      "limits instead of measuring the configured image")(
+      "sweep-max-size", po::value<uint32_t>(&sweep_max_size_mb)
+                            ->default_value(256),
+      "largest image in MB measured by the sweep")(
+      "streams", po::value<uint32_t>(&num_streams)->default_value(0),
+      "stream frames on this many queues at once instead of the default "
+      "measurements, two frames in flight per stream")(
+      "stream-frames",
+      po::value<uint32_t>(&stream_frames)->default_value(300),
+      "set number of frames per stream")(
+      "stream-engines",
+      po::value<std::string>(&stream_engines)->default_value("all"),
+      "engines the streams are spread over: copy/compute/all")(
+      "stream-resolutions",
+      po::value<std::string>(&resolutions)
+          ->default_value("1280x720,1920x1080,3840x2160"),
+      "comma separated frame resolutions of the streams")(
       "json-output-file", po::value<std::string>(&JsonFileName),
       "test output format file name to be specified");
 
@@ -84,6 +104,28 @@ int ZeImageCopy::parse_command_line(int argc, char **argv) {
     std::cout << "unknown  Imagetype" << std::endl;
     std::cout << desc << std::endl;
     return 1;
+  } else if (stream_engines != "copy" && stream_engines != "compute" &&
+             stream_engines != "all") {
+    std::cout << "unknown stream engines" << std::endl;
+    std::cout << desc << std::endl;
+    return 1;
+  }
+
+  std::stringstream resolution_list(resolutions);
+  std::string resolution;
+  while (std::getline(resolution_list, resolution, ',')) {
+    uint32_t frame_width = 0;
+    uint32_t frame_height = 0;
+    char separator = 0;
+    std::stringstream resolution_stream(resolution);
+    resolution_stream >> frame_width >> separator >> frame_height;
+    if (resolution_stream.fail() || separator != 'x' || frame_width == 0 ||
+        frame_height == 0) {
+      std::cout << "unknown stream resolution " << resolution << std::endl;
+      std::cout << desc << std::endl;
+      return 1;
+    }
+    stream_resolutions.push_back(std::make_pair(frame_width, frame_height));
   }
 
   return 0;
@@ -7,11 +7,12 @@
  */
 
 #include "ze_image_copy.h"
+#include <array>
 #include <cassert>
 
 ZeImageCopy ::ZeImageCopy() {
 
-  benchmark = new ZeApp();
+  benchmark = new ZeApp("ze_image_copy.spv");
   benchmark->singleDeviceInit();
 
   /*
@@ -39,14 +40,36 @@ bool ZeImageCopy::is_json_output_enabled(void) {
   return JsonFileName.size() != 0;
 }
 
-void ZeImageCopy::test_initialize(void) {
-  size_t buffer_size_tmp = level_zero_tests::num_bytes_per_pixel(Imagelayout) *
-                           width * height * depth;
-  buffer_size = roundToMultipleOf(buffer_size_tmp, 8, SIZE_MAX);
-  if (buffer_size == 0 && buffer_size_tmp > 0) {
-    buffer_size = buffer_size_tmp;
+// Name of an enum value without its prefix, as spelled in the options
+static std::string option_name(const std::string &name,
+                               const std::string &prefix) {
+  if (name.compare(0, prefix.size(), prefix) == 0) {
+    return name.substr(prefix.size());
   }
-  region = {xOffset, yOffset, zOffset, width, height, depth};
+  return name;
+}
+
+// Configuration of a result, with the same keys and values as in
+// cl_image_copy
+void ZeImageCopy::put_image_config(ptree *test_ptree) {
+  test_ptree->put("API", "Level Zero");
+  test_ptree->put("Image type",
+                  option_name(level_zero_tests::to_string(Imagetype),
+                              "ZE_IMAGE_TYPE_"));
+  test_ptree->put("Image Layout",
+                  option_name(level_zero_tests::to_string(Imagelayout),
+                              "ZE_IMAGE_FORMAT_LAYOUT_"));
+  test_ptree->put("Image format",
+                  option_name(level_zero_tests::to_string(Imageformat),
+                              "ZE_IMAGE_FORMAT_TYPE_"));
+  test_ptree->put("Iterations", num_iterations);
+  test_ptree->put("Copies", num_image_copies);
+}
+
+// The region always spans width x height x depth. For array types the
+// slices are counted in height (1D arrays) or depth (2D arrays), as in the
+// copy regions, and become the array levels of the image.
+void ZeImageCopy::initialize_image_desc(void) {
   formatDesc = {Imagelayout,
                 Imageformat,
                 ZE_IMAGE_FORMAT_SWIZZLE_R,
@@ -60,10 +83,44 @@ void ZeImageCopy::test_initialize(void) {
   imageDesc.type = Imagetype;
   imageDesc.format = formatDesc;
   imageDesc.width = width;
-  imageDesc.height = height;
-  imageDesc.depth = depth;
-  imageDesc.arraylevels = 0;
+  imageDesc.height = (Imagetype == ZE_IMAGE_TYPE_1DARRAY) ? 1 : height;
+  imageDesc.depth = (Imagetype == ZE_IMAGE_TYPE_2DARRAY) ? 1 : depth;
+  imageDesc.arraylevels = (Imagetype == ZE_IMAGE_TYPE_1DARRAY)   ? height
+                          : (Imagetype == ZE_IMAGE_TYPE_2DARRAY) ? depth
+                                                                 : 0;
   imageDesc.miplevels = 0;
+}
+
+bool ZeImageCopy::is_image_supported(void) {
+  ze_image_handle_t probe_image = nullptr;
+
+  initialize_image_desc();
+  if (zeImageCreate(benchmark->context, benchmark->_devices[0], &imageDesc,
+                    &probe_image) != ZE_RESULT_SUCCESS) {
+    return false;
+  }
+  benchmark->imageDestroy(probe_image);
+  return true;
+}
+
+ze_device_image_properties_t ZeImageCopy::get_device_image_properties(void) {
+  ze_device_image_properties_t properties = {
+      ZE_STRUCTURE_TYPE_DEVICE_IMAGE_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGetImageProperties(benchmark->_devices[0], &properties));
+  return properties;
+}
+
+void ZeImageCopy::test_initialize(void) {
+  size_t buffer_size_tmp =
+      static_cast<size_t>(level_zero_tests::num_bytes_per_pixel(Imagelayout)) *
+      width * height * depth;
+  buffer_size = roundToMultipleOf(buffer_size_tmp, 8, SIZE_MAX);
+  if (buffer_size == 0 && buffer_size_tmp > 0) {
+    buffer_size = buffer_size_tmp;
+  }
+  region = {xOffset, yOffset, zOffset, width, height, depth};
+  initialize_image_desc();
 
 #ifdef _WIN32
   srcBuffer = static_cast<uint8_t *>(_aligned_malloc(buffer_size, 64));
@@ -496,6 +553,7 @@ void measure_bandwidth_Host2Device2Host(ZeImageCopy &Imagecopy,
     test_ptree->put(
         "Name", "Host2Device2Host: Bandwidth copying from Host->Device->Host ");
     test_ptree->put("Image size", Image_dimensions.str());
+    Imagecopy.put_image_config(test_ptree);
   } else {
     std::cout << "Host2Device2Host: Measuring Bandwidth for copying the "
                  "image buffer size "
@@ -525,6 +583,7 @@ void measure_bandwidth_Host2Device(ZeImageCopy &Imagecopy, ptree *test_ptree) {
                      << Imagecopy.depth;
     test_ptree->put("Name", "Host2Device: Bandwidth copying from Host->Device");
     test_ptree->put("Image size", Image_dimensions.str());
+    Imagecopy.put_image_config(test_ptree);
   } else {
     std::cout
         << "Host2Device: Measuring Bandwidth/Latency for copying the image "
@@ -537,6 +596,7 @@ void measure_bandwidth_Host2Device(ZeImageCopy &Imagecopy, ptree *test_ptree) {
 
   if (Imagecopy.is_json_output_enabled()) {
     test_ptree->put("GBPS", Imagecopy.gbps);
+    test_ptree->put("Latency", Imagecopy.latency);
     if (Imagecopy.data_validation) {
       test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
     }
@@ -557,6 +617,7 @@ void measure_bandwidth_Device2Host(ZeImageCopy &Imagecopy, ptree *test_ptree) {
                      << Imagecopy.depth;
     test_ptree->put("Name", "Device2Host: Bandwidth copying from Device->Host");
     test_ptree->put("Image size", Image_dimensions.str());
+    Imagecopy.put_image_config(test_ptree);
   } else {
     std::cout
         << "Device2Host: Measurign Bandwidth/Latency for copying the image "
@@ -569,6 +630,7 @@ void measure_bandwidth_Device2Host(ZeImageCopy &Imagecopy, ptree *test_ptree) {
 
   if (Imagecopy.is_json_output_enabled()) {
     test_ptree->put("GBPS", Imagecopy.gbps);
+    test_ptree->put("Latency", Imagecopy.latency);
     if (Imagecopy.data_validation)
       test_ptree->put("Result", (Imagecopy.validRet ? "PASSED" : "FAILED"));
   } else {
@@ -586,11 +648,13 @@ void measure_bandwidth(ZeImageCopy &Imagecopy) {
   ptree ptree_Host2Device2Host;
   ptree ptree_Host2Device;
   ptree ptree_Device2Host;
+  ptree ptree_paths;
   ptree ptree_main;
 
   measure_bandwidth_Host2Device2Host(Imagecopy, &ptree_Host2Device2Host);
   measure_bandwidth_Host2Device(Imagecopy, &ptree_Host2Device);
   measure_bandwidth_Device2Host(Imagecopy, &ptree_Device2Host);
+  measure_image_paths(Imagecopy, &ptree_paths);
 
   if (Imagecopy.is_json_output_enabled()) {
     Imagecopy.param_array.push_back(std::make_pair("", ptree_Host2Device2Host));
@@ -598,6 +662,7 @@ void measure_bandwidth(ZeImageCopy &Imagecopy) {
     Imagecopy.param_array.push_back(std::make_pair("", ptree_Device2Host));
     ptree_main.put_child("Performance Benchmark.bandwidth",
                          Imagecopy.param_array);
+    ptree_main.put_child("Performance Benchmark.paths", ptree_paths);
     pt::write_json(Imagecopy.JsonFileName.c_str(), ptree_main);
   }
 }
@@ -611,8 +676,7 @@ void measure_latency_Host2Device(ZeImageCopyLatency &imageCopyLatency,
     test_ptree->put("Name",
                     "Host2Device: Measuring Latency for copying the image ");
     test_ptree->put("Image size", Image_dimensions.str());
-    test_ptree->put("Image format", imageCopyLatency.Imageformat);
-    test_ptree->put("Image Layout", imageCopyLatency.Imagelayout);
+    imageCopyLatency.put_image_config(test_ptree);
   } else {
     std::cout
         << "Host2Device: Measuring Bandwidth/Latency for copying the image "
@@ -644,8 +708,7 @@ void measure_latency_Device2Host(ZeImageCopyLatency &imageCopyLatency,
     test_ptree->put("Name",
                     "Device2Host: Measuring Latency for copying the image");
     test_ptree->put("Image size", Image_dimensions.str());
-    test_ptree->put("Image format", imageCopyLatency.Imageformat);
-    test_ptree->put("Image Layout", imageCopyLatency.Imagelayout);
+    imageCopyLatency.put_image_config(test_ptree);
   } else {
     std::cout
         << "Device2Host: Measuring Bandwidth/Latency for copying the image "
@@ -689,14 +752,185 @@ void measure_latency(ZeImageCopyLatency &imageCopyLatency) {
   }
 }
 
+// Edge lengths of the sweep: growing by step from first, then the device
+// limit itself
+static std::vector<uint32_t> sweep_lengths(uint32_t first, uint32_t step,
+                                           uint32_t limit) {
+  std::vector<uint32_t> lengths;
+  for (uint64_t length = first; length < limit; length *= step) {
+    lengths.push_back(static_cast<uint32_t>(length));
+  }
+  if (limit > 0) {
+    lengths.push_back(limit);
+  }
+  return lengths;
+}
+
+// Image extents of the sweep for one type, as width x height x depth with
+// the array slices in height (1D arrays) or depth (2D arrays)
+static std::vector<std::array<uint32_t, 3>>
+sweep_extents(ze_image_type_t type,
+              const ze_device_image_properties_t &properties) {
+  const uint32_t slices = std::min(16u, properties.maxImageArraySlices);
+  std::vector<std::array<uint32_t, 3>> extents;
+
+  switch (type) {
+  case ZE_IMAGE_TYPE_1D:
+  case ZE_IMAGE_TYPE_1DARRAY:
+    for (auto length : sweep_lengths(256, 16, properties.maxImageDims1D)) {
+      extents.push_back(
+          {length, type == ZE_IMAGE_TYPE_1DARRAY ? slices : 1u, 1u});
+    }
+    break;
+  case ZE_IMAGE_TYPE_2D:
+  case ZE_IMAGE_TYPE_2DARRAY:
+    for (auto length : sweep_lengths(64, 4, properties.maxImageDims2D)) {
+      extents.push_back(
+          {length, length, type == ZE_IMAGE_TYPE_2DARRAY ? slices : 1u});
+    }
+    break;
+  case ZE_IMAGE_TYPE_3D:
+    for (auto length : sweep_lengths(16, 4, properties.maxImageDims3D)) {
+      extents.push_back({length, length, length});
+    }
+    break;
+  default:
+    break;
+  }
+  return extents;
+}
+
+// Measures host->device and device->host copies for the common layouts and
+// formats, every image type and sizes up to the device limits, skipping
+// the images above the size limit and those the device does not support.
+// The number of copies per iteration is lowered on large images, so that
+// one iteration moves at most 1 GB.
+void measure_sweep(ZeImageCopy &Imagecopy) {
+  const std::pair<ze_image_format_layout_t, ze_image_format_type_t>
+      formats[] = {
+          {ZE_IMAGE_FORMAT_LAYOUT_8, ZE_IMAGE_FORMAT_TYPE_UINT},
+          {ZE_IMAGE_FORMAT_LAYOUT_16, ZE_IMAGE_FORMAT_TYPE_UINT},
+          {ZE_IMAGE_FORMAT_LAYOUT_32, ZE_IMAGE_FORMAT_TYPE_UINT},
+          {ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8, ZE_IMAGE_FORMAT_TYPE_UINT},
+          {ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16, ZE_IMAGE_FORMAT_TYPE_UINT},
+          {ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32, ZE_IMAGE_FORMAT_TYPE_UINT},
+          {ZE_IMAGE_FORMAT_LAYOUT_16, ZE_IMAGE_FORMAT_TYPE_FLOAT},
+          {ZE_IMAGE_FORMAT_LAYOUT_32, ZE_IMAGE_FORMAT_TYPE_FLOAT},
+          {ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16, ZE_IMAGE_FORMAT_TYPE_FLOAT},
+          {ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32, ZE_IMAGE_FORMAT_TYPE_FLOAT}};
+  const ze_image_type_t types[] = {ZE_IMAGE_TYPE_1D, ZE_IMAGE_TYPE_2D,
+                                   ZE_IMAGE_TYPE_3D, ZE_IMAGE_TYPE_1DARRAY,
+                                   ZE_IMAGE_TYPE_2DARRAY};
+  const uint64_t max_bytes =
+      static_cast<uint64_t>(Imagecopy.sweep_max_size_mb) * 1024 * 1024;
+  const uint64_t max_bytes_per_iteration = 1024ull * 1024 * 1024;
+  const uint32_t num_image_copies = Imagecopy.num_image_copies;
+  const ze_device_image_properties_t properties =
+      Imagecopy.get_device_image_properties();
+  ptree ptree_main;
+
+  Imagecopy.xOffset = Imagecopy.yOffset = Imagecopy.zOffset = 0;
+  for (auto type : types) {
+    for (auto &format : formats) {
+      const uint64_t bytes_per_pixel =
+          level_zero_tests::num_bytes_per_pixel(format.first);
+      for (auto &extent : sweep_extents(type, properties)) {
+        const uint64_t bytes =
+            bytes_per_pixel * extent[0] * extent[1] * extent[2];
+        if (bytes > max_bytes) {
+          continue;
+        }
+
+        Imagecopy.Imagetype = type;
+        Imagecopy.Imagelayout = format.first;
+        Imagecopy.Imageformat = format.second;
+        Imagecopy.width = extent[0];
+        Imagecopy.height = extent[1];
+        Imagecopy.depth = extent[2];
+        Imagecopy.num_image_copies = static_cast<uint32_t>(
+            std::max<uint64_t>(1, std::min<uint64_t>(num_image_copies,
+                                                     max_bytes_per_iteration /
+                                                         bytes)));
+
+        std::stringstream Image_dimensions;
+        Image_dimensions << Imagecopy.width << "X" << Imagecopy.height << "X"
+                         << Imagecopy.depth;
+        ptree test_ptree;
+        test_ptree.put("Image type", level_zero_tests::to_string(type));
+        test_ptree.put("Image Layout",
+                       level_zero_tests::to_string(format.first));
+        test_ptree.put("Image format",
+                       level_zero_tests::to_string(format.second));
+        test_ptree.put("Image size", Image_dimensions.str());
+        test_ptree.put("Bytes", bytes);
+
+        std::cout << "Sweep: " << level_zero_tests::to_string(type) << " "
+                  << level_zero_tests::to_string(format.first) << " "
+                  << level_zero_tests::to_string(format.second) << " "
+                  << Image_dimensions.str() << std::endl;
+
+        if (!Imagecopy.is_image_supported()) {
+          std::cout << "  not supported" << std::endl;
+          test_ptree.put("Supported", false);
+          Imagecopy.param_array.push_back(std::make_pair("", test_ptree));
+          continue;
+        }
+        test_ptree.put("Supported", true);
+        test_ptree.put("Copies", Imagecopy.num_image_copies);
+
+        Imagecopy.measureParallelHost2Device();
+        test_ptree.put("Host2Device GBPS", Imagecopy.gbps);
+        test_ptree.put("Host2Device Latency", Imagecopy.latency);
+        if (Imagecopy.data_validation) {
+          test_ptree.put("Host2Device Result",
+                         (Imagecopy.validRet ? "PASSED" : "FAILED"));
+        }
+
+        Imagecopy.measureParallelDevice2Host();
+        test_ptree.put("Device2Host GBPS", Imagecopy.gbps);
+        test_ptree.put("Device2Host Latency", Imagecopy.latency);
+        if (Imagecopy.data_validation) {
+          test_ptree.put("Device2Host Result",
+                         (Imagecopy.validRet ? "PASSED" : "FAILED"));
+        }
+
+        Imagecopy.param_array.push_back(std::make_pair("", test_ptree));
+      }
+    }
+  }
+  Imagecopy.num_image_copies = num_image_copies;
+
+  if (Imagecopy.is_json_output_enabled()) {
+    ptree_main.put_child("Performance Benchmark.sweep", Imagecopy.param_array);
+    pt::write_json(Imagecopy.JsonFileName.c_str(), ptree_main);
+  }
+}
+
 int main(int argc, char **argv) {
   ZeImageCopy Imagecopy;
   SUCCESS_OR_TERMINATE(Imagecopy.parse_command_line(argc, argv));
+  if (Imagecopy.sweep) {
+    measure_sweep(Imagecopy);
+    std::cout << std::flush;
+    return 0;
+  }
+  if (Imagecopy.num_streams > 0) {
+    measure_streaming(Imagecopy);
+    std::cout << std::flush;
+    return 0;
+  }
   measure_bandwidth(Imagecopy);
 
   ZeImageCopyLatency imageCopyLatency;
   imageCopyLatency.JsonFileName =
       Imagecopy.JsonFileName; // need to add latency values to the same file
+  // 1x1x1 image of the measured format, so that both benchmarks measure the
+  // latency of the same configuration
+  imageCopyLatency.Imagelayout = Imagecopy.Imagelayout;
+  imageCopyLatency.Imageformat = Imagecopy.Imageformat;
+  imageCopyLatency.num_iterations = Imagecopy.num_iterations;
+  imageCopyLatency.warm_up_iterations = Imagecopy.warm_up_iterations;
+  imageCopyLatency.num_image_copies = Imagecopy.num_image_copies;
   measure_latency(imageCopyLatency);
 
   std::cout << std::flush;
@@ -0,0 +1,42 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _SPIRV_KERNELS_HPP_
+#define _SPIRV_KERNELS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class KernelArgType { BUFFER = 0, UINT, ULONG, FLOAT, STRUCT };
+
+struct KernelArg {
+  KernelArgType type;
+  /* bytes of a STRUCT passed by value, a multiple of 4 */
+  uint32_t size;
+};
+
+/* A kernel whose first argument is a global uint buffer */
+struct KernelSpec {
+  std::string name;
+  std::vector<KernelArg> args;
+};
+
+/*
+ * Builds an OpenCL SPIR-V 1.0 module with one kernel per spec, so that
+ * kernels of any signature can be created without a compiler. Structs are
+ * passed by value, as arrays of uint, and every kernel only stores its
+ * argument count to the buffer of its first argument; the other
+ * arguments are set and passed, but not read.
+ */
+std::vector<uint32_t> build_spirv_kernels(const std::vector<KernelSpec> &specs);
+
+/* Bytes the arguments take when set */
+size_t kernel_arg_size(const KernelArg &arg);
+
+#endif /* _SPIRV_KERNELS_HPP_ */
@@ -0,0 +1,69 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_LAUNCH_ARGS_HPP_
+#define _ZE_LAUNCH_ARGS_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "clock_correlation.hpp"
+#include "results.hpp"
+#include "spirv_kernels.hpp"
+#include "ze_app.hpp"
+
+#include <string>
+#include <vector>
+
+/* What changes on the kernel between two launches besides its arguments */
+enum class LaunchMode { PLAIN = 0, INDIRECT_ACCESS, GROUP_SIZE };
+
+class ZeLaunchArgs {
+public:
+  ZeLaunchArgs();
+  ~ZeLaunchArgs();
+  int parse_arguments(int argc, char **argv);
+  void build_kernels(void);
+  void test_launches(void);
+
+  /* kernels of 1 to 64 arguments cycling through buffer, uint, ulong and
+   * float, and kernels of a buffer and a struct passed by value */
+  std::vector<uint32_t> arg_counts{1, 2, 4, 8, 16, 32, 64};
+  std::vector<uint32_t> struct_sizes{16, 64, 256, 1024, 2048};
+  std::vector<LaunchMode> modes{LaunchMode::PLAIN, LaunchMode::INDIRECT_ACCESS,
+                                LaunchMode::GROUP_SIZE};
+  uint32_t device_id = 0;
+  uint32_t number_iterations = 1000;
+  uint32_t warmup_iterations = 100;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_launch_args"};
+
+  ZeApp *benchmark;
+
+private:
+  void set_arguments(ze_kernel_handle_t kernel, const KernelSpec &spec);
+  void launch_samples(ze_kernel_handle_t kernel, const KernelSpec &spec,
+                      LaunchMode mode, SampleTimer<std::micro> &set_timer,
+                      SampleTimer<std::micro> &append_timer,
+                      std::vector<long double> &start_usec);
+  void add_result(const std::string &test, const KernelSpec &spec,
+                  LaunchMode mode, const std::vector<long double> &samples);
+
+  std::vector<KernelSpec> specs;
+  ze_module_handle_t module = nullptr;
+  std::vector<ze_kernel_handle_t> kernels;
+  ze_command_list_handle_t immediate_list = nullptr;
+  ze_event_pool_handle_t event_pool = nullptr;
+  ze_event_handle_t event = nullptr;
+  void *buffer = nullptr;
+  /* value of every struct argument */
+  std::vector<uint8_t> struct_value;
+  ze_device_properties_t device_properties = {};
+};
+
+#endif /* _ZE_LAUNCH_ARGS_HPP_ */
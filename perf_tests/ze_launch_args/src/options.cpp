@@ -0,0 +1,169 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_launch_args.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_launch_args [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -a, list                 comma separated argument counts of the "
+    "kernels of"
+    "\n                            buffer, uint, ulong and float arguments, "
+    "up to 64"
+    "\n                            [default:  1,2,4,8,16,32,64]"
+    "\n  -S, list                 comma separated sizes (bytes, multiple of "
+    "4) of the"
+    "\n                            struct passed by value to the kernels "
+    "of a buffer"
+    "\n                            and a struct [default:  "
+    "16,64,256,1024,2048]"
+    "\n  -m, list                 comma separated launch modes "
+    "[default:  all]:"
+    "\n      plain                            set the arguments before "
+    "every launch"
+    "\n      indirect_access                  also toggle the indirect "
+    "access flags"
+    "\n      group_size                       also toggle the group size"
+    "\n  -i                       set number of iterations per kernel and "
+    "mode"
+    "\n                            [default:  1000]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  100]"
+    "\n  -d                       select the device (default: 0)"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static const uint32_t max_arg_count = 64;
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+static bool parse_number_list(char *list, std::vector<uint32_t> &numbers) {
+  numbers.clear();
+  for (auto &item : split_list(list)) {
+    if (!isdigit(item[0])) {
+      return false;
+    }
+    numbers.push_back(sanitize_ulong(&item[0]));
+  }
+  return !numbers.empty();
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_launch_args and
+// sets the test parameters accordingly for main to execute the tests
+// with the correct environment.
+//---------------------------------------------------------------------
+int ZeLaunchArgs::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-a") == 0) && (i + 1 < argc)) {
+      if (!parse_number_list(argv[i + 1], arg_counts)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      for (auto count : arg_counts) {
+        if (count == 0 || count > max_arg_count) {
+          std::cerr << "argument count " << count << " is not 1 to "
+                    << max_arg_count << std::endl;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-S") == 0) && (i + 1 < argc)) {
+      if (!parse_number_list(argv[i + 1], struct_sizes)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      for (auto size : struct_sizes) {
+        if (size == 0 || size % sizeof(uint32_t)) {
+          std::cerr << "struct size " << size << " is not a multiple of 4"
+                    << std::endl;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-m") == 0) && (i + 1 < argc)) {
+      modes.clear();
+      for (auto &mode : split_list(argv[i + 1])) {
+        if (mode == "plain") {
+          modes.push_back(LaunchMode::PLAIN);
+        } else if (mode == "indirect_access") {
+          modes.push_back(LaunchMode::INDIRECT_ACCESS);
+        } else if (mode == "group_size") {
+          modes.push_back(LaunchMode::GROUP_SIZE);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc)) {
+      device_id = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  return 0;
+}
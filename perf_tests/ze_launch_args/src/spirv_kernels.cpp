@@ -0,0 +1,231 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "spirv_kernels.hpp"
+
+#include <map>
+
+namespace {
+
+/* The opcodes and enumerants of the SPIR-V 1.0 specification used here */
+enum : uint32_t {
+  OP_MEMORY_MODEL = 14,
+  OP_ENTRY_POINT = 15,
+  OP_CAPABILITY = 17,
+  OP_TYPE_VOID = 19,
+  OP_TYPE_INT = 21,
+  OP_TYPE_FLOAT = 22,
+  OP_TYPE_ARRAY = 28,
+  OP_TYPE_STRUCT = 30,
+  OP_TYPE_POINTER = 32,
+  OP_TYPE_FUNCTION = 33,
+  OP_CONSTANT = 43,
+  OP_FUNCTION = 54,
+  OP_FUNCTION_PARAMETER = 55,
+  OP_FUNCTION_END = 56,
+  OP_STORE = 62,
+  OP_DECORATE = 71,
+  OP_LABEL = 248,
+  OP_RETURN = 253,
+
+  CAPABILITY_ADDRESSES = 4,
+  CAPABILITY_KERNEL = 6,
+  CAPABILITY_INT64 = 11,
+  ADDRESSING_MODEL_PHYSICAL64 = 2,
+  MEMORY_MODEL_OPENCL = 2,
+  EXECUTION_MODEL_KERNEL = 6,
+  STORAGE_CLASS_FUNCTION = 7,
+  STORAGE_CLASS_CROSS_WORKGROUP = 5,
+  DECORATION_FUNC_PARAM_ATTR = 38,
+  DECORATION_ALIGNMENT = 44,
+  FUNCTION_PARAMETER_ATTRIBUTE_BY_VAL = 2,
+  FUNCTION_CONTROL_NONE = 0
+};
+
+const uint32_t spirv_magic = 0x07230203;
+const uint32_t spirv_version_1_0 = 0x00010000;
+
+class SpirvWriter {
+public:
+  SpirvWriter() {
+    void_type = declare(OP_TYPE_VOID, {});
+    uint_type = declare(OP_TYPE_INT, {32, 0});
+    ulong_type = declare(OP_TYPE_INT, {64, 0});
+    float_type = declare(OP_TYPE_FLOAT, {32});
+    buffer_type = declare(OP_TYPE_POINTER,
+                          {STORAGE_CLASS_CROSS_WORKGROUP, uint_type});
+  }
+
+  void add_kernel(const KernelSpec &spec) {
+    std::vector<uint32_t> arg_types;
+    for (auto &arg : spec.args) {
+      arg_types.push_back(arg_type(arg));
+    }
+    const uint32_t function_type = declare_function_type(arg_types);
+    const uint32_t count =
+        uint_constant(static_cast<uint32_t>(spec.args.size()));
+
+    const uint32_t function = next_id++;
+    std::vector<uint32_t> entry_point = {EXECUTION_MODEL_KERNEL, function};
+    append_string(entry_point, spec.name);
+    emit(entry_points, OP_ENTRY_POINT, entry_point);
+
+    emit(functions, OP_FUNCTION,
+         {void_type, function, FUNCTION_CONTROL_NONE, function_type});
+    std::vector<uint32_t> parameters;
+    for (size_t i = 0; i < spec.args.size(); i++) {
+      const uint32_t parameter = next_id++;
+      emit(functions, OP_FUNCTION_PARAMETER, {arg_types[i], parameter});
+      if (spec.args[i].type == KernelArgType::STRUCT) {
+        emit(annotations, OP_DECORATE,
+             {parameter, DECORATION_FUNC_PARAM_ATTR,
+              FUNCTION_PARAMETER_ATTRIBUTE_BY_VAL});
+        emit(annotations, OP_DECORATE,
+             {parameter, DECORATION_ALIGNMENT, sizeof(uint32_t)});
+      }
+      parameters.push_back(parameter);
+    }
+    emit(functions, OP_LABEL, {next_id++});
+    if (!parameters.empty()) {
+      emit(functions, OP_STORE, {parameters[0], count});
+    }
+    emit(functions, OP_RETURN, {});
+    emit(functions, OP_FUNCTION_END, {});
+  }
+
+  std::vector<uint32_t> finish() const {
+    std::vector<uint32_t> words = {spirv_magic, spirv_version_1_0, 0,
+                                   next_id, 0};
+    emit(words, OP_CAPABILITY, {CAPABILITY_ADDRESSES});
+    emit(words, OP_CAPABILITY, {CAPABILITY_KERNEL});
+    emit(words, OP_CAPABILITY, {CAPABILITY_INT64});
+    emit(words, OP_MEMORY_MODEL,
+         {ADDRESSING_MODEL_PHYSICAL64, MEMORY_MODEL_OPENCL});
+    for (auto section : {&entry_points, &annotations, &types, &functions}) {
+      words.insert(words.end(), section->begin(), section->end());
+    }
+    return words;
+  }
+
+private:
+  static void emit(std::vector<uint32_t> &section, uint32_t opcode,
+                   const std::vector<uint32_t> &operands) {
+    section.push_back(static_cast<uint32_t>(operands.size() + 1) << 16 |
+                      opcode);
+    section.insert(section.end(), operands.begin(), operands.end());
+  }
+
+  /* Nul terminated UTF-8, padded to whole words, first byte lowest */
+  static void append_string(std::vector<uint32_t> &words,
+                            const std::string &string) {
+    for (size_t i = 0; i <= string.size(); i += 4) {
+      uint32_t word = 0;
+      for (size_t j = 0; j < 4 && i + j < string.size(); j++) {
+        word |= static_cast<uint32_t>(static_cast<uint8_t>(string[i + j]))
+                << (8 * j);
+      }
+      words.push_back(word);
+    }
+  }
+
+  /* Types and constants with their result id first */
+  uint32_t declare(uint32_t opcode, std::vector<uint32_t> operands) {
+    const uint32_t id = next_id++;
+    operands.insert(operands.begin(), id);
+    emit(types, opcode, operands);
+    return id;
+  }
+
+  uint32_t uint_constant(uint32_t value) {
+    auto found = uint_constants.find(value);
+    if (found != uint_constants.end()) {
+      return found->second;
+    }
+    const uint32_t id = next_id++;
+    emit(types, OP_CONSTANT, {uint_type, id, value});
+    uint_constants[value] = id;
+    return id;
+  }
+
+  uint32_t declare_function_type(const std::vector<uint32_t> &arg_types) {
+    auto found = function_types.find(arg_types);
+    if (found != function_types.end()) {
+      return found->second;
+    }
+    std::vector<uint32_t> operands = {void_type};
+    operands.insert(operands.end(), arg_types.begin(), arg_types.end());
+    const uint32_t id = declare(OP_TYPE_FUNCTION, operands);
+    function_types[arg_types] = id;
+    return id;
+  }
+
+  /* A struct of size bytes, passed as a pointer to a private copy */
+  uint32_t struct_pointer_type(uint32_t size) {
+    auto found = struct_pointers.find(size);
+    if (found != struct_pointers.end()) {
+      return found->second;
+    }
+    const uint32_t length = uint_constant(size / sizeof(uint32_t));
+    const uint32_t array = declare(OP_TYPE_ARRAY, {uint_type, length});
+    const uint32_t structure = declare(OP_TYPE_STRUCT, {array});
+    const uint32_t pointer =
+        declare(OP_TYPE_POINTER, {STORAGE_CLASS_FUNCTION, structure});
+    struct_pointers[size] = pointer;
+    return pointer;
+  }
+
+  uint32_t arg_type(const KernelArg &arg) {
+    switch (arg.type) {
+    case KernelArgType::UINT:
+      return uint_type;
+    case KernelArgType::ULONG:
+      return ulong_type;
+    case KernelArgType::FLOAT:
+      return float_type;
+    case KernelArgType::STRUCT:
+      return struct_pointer_type(arg.size);
+    default:
+      return buffer_type;
+    }
+  }
+
+  uint32_t next_id = 1;
+  uint32_t void_type, uint_type, ulong_type, float_type, buffer_type;
+  std::map<uint32_t, uint32_t> uint_constants;
+  std::map<uint32_t, uint32_t> struct_pointers;
+  std::map<std::vector<uint32_t>, uint32_t> function_types;
+  std::vector<uint32_t> entry_points;
+  std::vector<uint32_t> annotations;
+  std::vector<uint32_t> types;
+  std::vector<uint32_t> functions;
+};
+
+} // namespace
+
+std::vector<uint32_t>
+build_spirv_kernels(const std::vector<KernelSpec> &specs) {
+  SpirvWriter writer;
+  for (auto &spec : specs) {
+    writer.add_kernel(spec);
+  }
+  return writer.finish();
+}
+
+size_t kernel_arg_size(const KernelArg &arg) {
+  switch (arg.type) {
+  case KernelArgType::UINT:
+  case KernelArgType::FLOAT:
+    return sizeof(uint32_t);
+  case KernelArgType::ULONG:
+    return sizeof(uint64_t);
+  case KernelArgType::STRUCT:
+    return arg.size;
+  default:
+    return sizeof(void *);
+  }
+}
@@ -0,0 +1,358 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_launch_args.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+/* Group sizes alternated by the GROUP_SIZE mode, the first one is used by
+ * the other modes */
+static const uint32_t group_sizes[] = {16, 32};
+
+static const char *launch_mode_names[] = {"plain", "indirect_access",
+                                          "group_size"};
+
+static const ze_kernel_indirect_access_flags_t all_indirect_access =
+    ZE_KERNEL_INDIRECT_ACCESS_FLAG_HOST |
+    ZE_KERNEL_INDIRECT_ACCESS_FLAG_DEVICE |
+    ZE_KERNEL_INDIRECT_ACCESS_FLAG_SHARED;
+
+ZeLaunchArgs::ZeLaunchArgs() {
+  benchmark = new ZeApp();
+
+  benchmark->allDevicesInit();
+}
+
+ZeLaunchArgs::~ZeLaunchArgs() {
+  for (auto kernel : kernels) {
+    benchmark->functionDestroy(kernel);
+  }
+  if (module) {
+    SUCCESS_OR_TERMINATE(zeModuleDestroy(module));
+  }
+  if (event) {
+    benchmark->destroy_event(event);
+  }
+  if (event_pool) {
+    benchmark->destroy_event_pool(event_pool);
+  }
+  if (immediate_list) {
+    benchmark->commandListDestroy(immediate_list);
+  }
+  if (buffer) {
+    benchmark->memoryFree(buffer);
+  }
+
+  benchmark->allDevicesCleanup();
+
+  delete benchmark;
+}
+
+//---------------------------------------------------------------------
+// Generates the kernels of the sweep as one SPIR-V module, leaving out
+// the ones whose arguments take more than the device accepts, and sets
+// up the buffer, list and timestamp event all launches share.
+//---------------------------------------------------------------------
+void ZeLaunchArgs::build_kernels(void) {
+  ze_device_handle_t device = benchmark->_devices[device_id];
+  device_properties.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  SUCCESS_OR_TERMINATE(zeDeviceGetProperties(device, &device_properties));
+  ze_device_module_properties_t module_properties = {
+      ZE_STRUCTURE_TYPE_DEVICE_MODULE_PROPERTIES, nullptr};
+  SUCCESS_OR_TERMINATE(zeDeviceGetModuleProperties(device, &module_properties));
+
+  auto add_spec = [&](const std::string &name, std::vector<KernelArg> args) {
+    size_t size = 0;
+    for (auto &arg : args) {
+      size += kernel_arg_size(arg);
+    }
+    if (size > module_properties.maxArgumentsSize) {
+      std::cout << "Skipping " << name << ": " << size
+                << " bytes of arguments, the device takes at most "
+                << module_properties.maxArgumentsSize << std::endl;
+      return;
+    }
+    specs.push_back({name, args});
+  };
+  const KernelArgType mixed_types[] = {
+      KernelArgType::BUFFER, KernelArgType::UINT, KernelArgType::ULONG,
+      KernelArgType::FLOAT};
+  for (auto count : arg_counts) {
+    std::vector<KernelArg> args;
+    for (uint32_t i = 0; i < count; i++) {
+      args.push_back({mixed_types[i % 4], 0});
+    }
+    add_spec("launch_args_" + std::to_string(count), args);
+  }
+  for (auto size : struct_sizes) {
+    add_spec("launch_struct_" + std::to_string(size),
+             {{KernelArgType::BUFFER, 0}, {KernelArgType::STRUCT, size}});
+    struct_value.resize(std::max<size_t>(struct_value.size(), size));
+  }
+
+  const std::vector<uint32_t> spirv = build_spirv_kernels(specs);
+  ze_module_desc_t module_description = {
+      ZE_STRUCTURE_TYPE_MODULE_DESC,
+      nullptr,
+      ZE_MODULE_FORMAT_IL_SPIRV,
+      spirv.size() * sizeof(uint32_t),
+      reinterpret_cast<const uint8_t *>(spirv.data()),
+      nullptr,
+      nullptr};
+  ze_module_build_log_handle_t build_log = nullptr;
+  ze_result_t result = zeModuleCreate(benchmark->context, device,
+                                      &module_description, &module,
+                                      &build_log);
+  if (result != ZE_RESULT_SUCCESS) {
+    size_t log_size = 0;
+    zeModuleBuildLogGetString(build_log, &log_size, nullptr);
+    std::string log(log_size, '\0');
+    zeModuleBuildLogGetString(build_log, &log_size, &log[0]);
+    std::cerr << "Generated kernels failed to build: " << log << std::endl;
+  }
+  zeModuleBuildLogDestroy(build_log);
+  SUCCESS_OR_TERMINATE(result);
+
+  for (auto &spec : specs) {
+    ze_kernel_desc_t kernel_description = {ZE_STRUCTURE_TYPE_KERNEL_DESC,
+                                           nullptr, 0, spec.name.c_str()};
+    ze_kernel_handle_t kernel;
+    SUCCESS_OR_TERMINATE(zeKernelCreate(module, &kernel_description, &kernel));
+    kernels.push_back(kernel);
+  }
+
+  benchmark->memoryAlloc(device_id, sizeof(uint32_t), &buffer);
+
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  queue_properties.data());
+  uint32_t ordinal = 0;
+  for (uint32_t i = 0; i < num_queue_groups; i++) {
+    if (queue_properties[i].flags &
+        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      ordinal = i;
+      break;
+    }
+  }
+  benchmark->commandListCreateImmediate(device_id, ordinal, 0,
+                                        ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                                        &immediate_list);
+
+  ze_event_pool_desc_t pool_description = {
+      ZE_STRUCTURE_TYPE_EVENT_POOL_DESC, nullptr,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP,
+      1};
+  SUCCESS_OR_TERMINATE(zeEventPoolCreate(benchmark->context,
+                                         &pool_description, 1, &device,
+                                         &event_pool));
+  ze_event_desc_t event_description = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr,
+                                       0, ZE_EVENT_SCOPE_FLAG_HOST,
+                                       ZE_EVENT_SCOPE_FLAG_HOST};
+  SUCCESS_OR_TERMINATE(zeEventCreate(event_pool, &event_description, &event));
+}
+
+void ZeLaunchArgs::set_arguments(ze_kernel_handle_t kernel,
+                                 const KernelSpec &spec) {
+  const uint32_t uint_value = 1;
+  const uint64_t ulong_value = 1;
+  const float float_value = 1.0f;
+
+  for (uint32_t i = 0; i < spec.args.size(); i++) {
+    const KernelArg &arg = spec.args[i];
+    const void *value;
+    switch (arg.type) {
+    case KernelArgType::UINT:
+      value = &uint_value;
+      break;
+    case KernelArgType::ULONG:
+      value = &ulong_value;
+      break;
+    case KernelArgType::FLOAT:
+      value = &float_value;
+      break;
+    case KernelArgType::STRUCT:
+      value = struct_value.data();
+      break;
+    default:
+      value = &buffer;
+      break;
+    }
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(kernel, i, kernel_arg_size(arg), value));
+  }
+}
+
+//---------------------------------------------------------------------
+// Launches the kernel on the immediate list, setting all of its arguments
+// before every launch as frameworks do, and in INDIRECT_ACCESS and
+// GROUP_SIZE mode also toggling its indirect access flags or its group
+// size. Times the argument setup and the append on the host, and the
+// device start latency from just before the append to the start of the
+// kernel, from its kernel timestamp.
+//---------------------------------------------------------------------
+void ZeLaunchArgs::launch_samples(ze_kernel_handle_t kernel,
+                                  const KernelSpec &spec, LaunchMode mode,
+                                  SampleTimer<std::micro> &set_timer,
+                                  SampleTimer<std::micro> &append_timer,
+                                  std::vector<long double> &start_usec) {
+  ClockCorrelation correlation(benchmark->_devices[device_id]);
+  const ze_group_count_t group_count = {1, 1, 1};
+
+  SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(kernel, group_sizes[0], 1, 1));
+  SUCCESS_OR_TERMINATE(zeKernelSetIndirectAccess(kernel, 0));
+
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    if (i == warmup_iterations) {
+      set_timer.clear();
+      append_timer.clear();
+      start_usec.clear();
+    }
+
+    set_timer.start();
+    set_arguments(kernel, spec);
+    if (mode == LaunchMode::INDIRECT_ACCESS) {
+      SUCCESS_OR_TERMINATE(zeKernelSetIndirectAccess(
+          kernel, (i & 1) ? 0 : all_indirect_access));
+    } else if (mode == LaunchMode::GROUP_SIZE) {
+      SUCCESS_OR_TERMINATE(
+          zeKernelSetGroupSize(kernel, group_sizes[(i + 1) & 1], 1, 1));
+    }
+    set_timer.stop();
+
+    const uint64_t device_timestamp = correlation.sample().device_ticks;
+    append_timer.start();
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        immediate_list, kernel, &group_count, event, 0, nullptr));
+    append_timer.stop();
+
+    benchmark->hostSynchronize(event);
+    ze_kernel_timestamp_result_t timestamp;
+    SUCCESS_OR_TERMINATE(zeEventQueryKernelTimestamp(event, &timestamp));
+    SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+
+    start_usec.push_back(correlation.global_to_kernel_ticks(
+                             device_timestamp, timestamp.global.kernelStart) *
+                         correlation.nsec_per_tick() / 1e3);
+  }
+}
+
+void ZeLaunchArgs::add_result(const std::string &test, const KernelSpec &spec,
+                              LaunchMode mode,
+                              const std::vector<long double> &samples) {
+  if (!results.enabled()) {
+    return;
+  }
+  size_t arg_bytes = 0;
+  for (auto &arg : spec.args) {
+    arg_bytes += kernel_arg_size(arg);
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = "usec";
+  record.parameters = {{"device", std::to_string(device_id)},
+                       {"kernel", spec.name},
+                       {"args", std::to_string(spec.args.size())},
+                       {"arg_bytes", std::to_string(arg_bytes)},
+                       {"mode", launch_mode_names[static_cast<int>(mode)]}};
+  record.stats = ResultStats::from_samples(samples);
+  record.value = record.stats.median;
+  record.samples = samples;
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// Host and device cost of launching every generated kernel in every
+// mode, as the median of the iterations after the warmup.
+//---------------------------------------------------------------------
+void ZeLaunchArgs::test_launches(void) {
+  std::cout << std::endl;
+  std::cout << "KERNEL LAUNCH COST BY ARGUMENTS" << std::endl;
+  if (csv_output) {
+    std::cout << "Kernel,Args,Arg_bytes,Mode,Set_args_median_(usec),"
+                 "Append_median_(usec),Device_start_median_(usec),"
+                 "Device_start_p99_(usec)"
+              << std::endl;
+  }
+
+  SampleTimer<std::micro> set_timer(number_iterations);
+  SampleTimer<std::micro> append_timer(number_iterations);
+  std::vector<long double> start_usec;
+  start_usec.reserve(warmup_iterations + number_iterations);
+
+  for (size_t k = 0; k < specs.size(); k++) {
+    const KernelSpec &spec = specs[k];
+    size_t arg_bytes = 0;
+    for (auto &arg : spec.args) {
+      arg_bytes += kernel_arg_size(arg);
+    }
+
+    for (auto mode : modes) {
+      launch_samples(kernels[k], spec, mode, set_timer, append_timer,
+                     start_usec);
+      const ResultStats start = ResultStats::from_samples(start_usec);
+      const char *mode_name = launch_mode_names[static_cast<int>(mode)];
+
+      if (csv_output) {
+        std::cout << spec.name << "," << spec.args.size() << "," << arg_bytes
+                  << "," << mode_name << "," << set_timer.median() << ","
+                  << append_timer.median() << "," << start.median << ","
+                  << start.p99 << std::endl;
+      } else {
+        std::cout << std::setprecision(2) << std::fixed << std::left
+                  << std::setw(20) << spec.name << std::right
+                  << " Args: " << std::setw(2) << spec.args.size()
+                  << " Bytes: " << std::setw(4) << arg_bytes
+                  << " Mode: " << std::setw(15) << mode_name
+                  << " Set args: " << std::setw(7) << set_timer.median()
+                  << " usec Append: " << std::setw(7) << append_timer.median()
+                  << " usec Device start(median/p99): " << std::setw(7)
+                  << start.median << "/" << std::setw(7) << start.p99
+                  << " usec" << std::endl;
+      }
+
+      add_result("SetArguments", spec, mode, set_timer.samples());
+      add_result("Append", spec, mode, append_timer.samples());
+      add_result("DeviceStart", spec, mode, start_usec);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  ZeLaunchArgs launch_args;
+
+  launch_args.parse_arguments(argc, argv);
+
+  if (launch_args.device_id >= launch_args.benchmark->_devices.size()) {
+    std::cerr << "ERROR: device " << launch_args.device_id << " not found"
+              << std::endl;
+    return -1;
+  }
+
+  if (launch_args.results.enabled()) {
+    launch_args.results.read_metadata(
+        {launch_args.benchmark->_devices[launch_args.device_id]});
+  }
+
+  launch_args.build_kernels();
+  launch_args.test_launches();
+
+  std::cout << std::endl;
+  return launch_args.results.finish();
+}
@@ -0,0 +1,71 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_MULTI_CONTEXT_HPP_
+#define _ZE_MULTI_CONTEXT_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/* One queue of a tenant, submitting a list of one small kernel */
+struct KernelStream {
+  ze_command_queue_handle_t queue = nullptr;
+  ze_command_list_handle_t list = nullptr;
+  ze_kernel_handle_t kernel = nullptr;
+  uint32_t *buffer = nullptr;
+
+  /* submission round trips of the last run, in usec */
+  std::vector<long double> latency;
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+};
+
+/* One ZeApp, and so one context, with the streams of its queues */
+struct Tenant {
+  ZeApp *app = nullptr;
+  std::vector<KernelStream> streams;
+};
+
+class ZeMultiContext {
+public:
+  ZeMultiContext() = default;
+  ~ZeMultiContext();
+  int parse_arguments(int argc, char **argv);
+  void create_tenants(void);
+  void test_scheduling(void);
+
+  std::vector<uint32_t> context_counts{1, 2, 4, 8};
+  std::vector<uint32_t> queue_counts{1, 2, 4};
+  /* uints each kernel writes */
+  uint32_t node_work = 64;
+  uint32_t number_iterations = 500;
+  uint32_t warmup_iterations = 50;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_multi_context"};
+
+  std::vector<Tenant> tenants;
+
+private:
+  void create_stream(ZeApp *app, uint32_t ordinal, uint32_t queue_index,
+                     KernelStream &stream);
+  void stream_thread(KernelStream &stream, std::atomic<uint32_t> &ready,
+                     const std::atomic<bool> &go);
+  void add_result(const std::string &test, const std::string &metric,
+                  const std::string &unit, uint32_t contexts,
+                  uint32_t queues, const std::vector<long double> &samples);
+};
+
+#endif /* _ZE_MULTI_CONTEXT_HPP_ */
@@ -0,0 +1,121 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_multi_context.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_multi_context [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -c, list                 comma separated numbers of contexts, one "
+    "per tenant"
+    "\n                            [default:  1,2,4,8]"
+    "\n  -q, list                 comma separated numbers of queues per "
+    "context"
+    "\n                            [default:  1,2,4]"
+    "\n  --work                   set number of uints each kernel writes"
+    "\n                            [default:  64]"
+    "\n  -i                       set number of submissions per queue"
+    "\n                            [default:  500]"
+    "\n  -w                       set number of warmup submissions"
+    "\n                            [default:  50]"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+/* Comma separated numbers, none of them 0 */
+static bool parse_count_list(char *list, std::vector<uint32_t> &counts) {
+  counts.clear();
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (item.empty()) {
+      continue;
+    }
+    const uint32_t count = isdigit(item[0]) ? sanitize_ulong(&item[0]) : 0;
+    if (count == 0) {
+      return false;
+    }
+    counts.push_back(count);
+  }
+  return !counts.empty();
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_multi_context and
+// sets the test parameters accordingly for main to execute the tests
+// with the correct environment.
+//---------------------------------------------------------------------
+int ZeMultiContext::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc)) {
+      if (!parse_count_list(argv[i + 1], context_counts)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-q") == 0) && (i + 1 < argc)) {
+      if (!parse_count_list(argv[i + 1], queue_counts)) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "--work") == 0) && (i + 1 < argc)) {
+      node_work = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,273 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_multi_context.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+/* Every kernel is produce_shared of ze_bandwidth, writing node_work uints */
+static const uint32_t node_group_size = 64;
+
+ZeMultiContext::~ZeMultiContext() {
+  for (auto &tenant : tenants) {
+    for (auto &stream : tenant.streams) {
+      tenant.app->commandListDestroy(stream.list);
+      tenant.app->commandQueueDestroy(stream.queue);
+      tenant.app->functionDestroy(stream.kernel);
+      tenant.app->memoryFree(stream.buffer);
+    }
+    tenant.app->singleDeviceCleanup();
+    delete tenant.app;
+  }
+}
+
+//---------------------------------------------------------------------
+// Creates a queue on the compute engine, and a closed command list of
+// one kernel writing its own buffer, in the context of app.
+//---------------------------------------------------------------------
+void ZeMultiContext::create_stream(ZeApp *app, uint32_t ordinal,
+                                   uint32_t queue_index,
+                                   KernelStream &stream) {
+  const ze_group_count_t group_count = {
+      (node_work + node_group_size - 1) / node_group_size, 1, 1};
+  const uint32_t value = 1;
+
+  app->memoryAlloc(node_work * sizeof(uint32_t),
+                   reinterpret_cast<void **>(&stream.buffer));
+  app->functionCreate(&stream.kernel, "produce_shared");
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetGroupSize(stream.kernel, node_group_size, 1, 1));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(
+      stream.kernel, 0, sizeof(stream.buffer), &stream.buffer));
+  SUCCESS_OR_TERMINATE(zeKernelSetArgumentValue(stream.kernel, 1,
+                                                sizeof(node_work), &node_work));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(stream.kernel, 2, sizeof(value), &value));
+
+  app->commandQueueCreate(0, ordinal, queue_index, &stream.queue);
+  app->commandListCreate(0, ordinal, &stream.list);
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      stream.list, stream.kernel, &group_count, nullptr, 0, nullptr));
+  app->commandListClose(stream.list);
+}
+
+//---------------------------------------------------------------------
+// Creates one ZeApp per tenant up to the largest number of contexts,
+// each with a stream per queue up to the largest number of queues.
+// Queues of a tenant are spread over the queues of the compute engine.
+//---------------------------------------------------------------------
+void ZeMultiContext::create_tenants(void) {
+  const uint32_t max_contexts =
+      *std::max_element(context_counts.begin(), context_counts.end());
+  const uint32_t max_queues =
+      *std::max_element(queue_counts.begin(), queue_counts.end());
+
+  tenants.resize(max_contexts);
+  for (auto &tenant : tenants) {
+    tenant.app = new ZeApp("ze_bandwidth.spv");
+    tenant.app->singleDeviceInit();
+
+    uint32_t num_queue_groups = 0;
+    tenant.app->deviceGetCommandQueueGroupProperties(0, &num_queue_groups,
+                                                     nullptr);
+    std::vector<ze_command_queue_group_properties_t> queue_properties(
+        num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                           nullptr});
+    tenant.app->deviceGetCommandQueueGroupProperties(
+        0, &num_queue_groups, queue_properties.data());
+    uint32_t ordinal = 0;
+    for (uint32_t i = 0; i < num_queue_groups; i++) {
+      if (queue_properties[i].flags &
+          ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+        ordinal = i;
+        break;
+      }
+    }
+    const uint32_t engine_queues =
+        std::max(1u, queue_properties[ordinal].numQueues);
+
+    tenant.streams.resize(max_queues);
+    for (uint32_t q = 0; q < max_queues; q++) {
+      create_stream(tenant.app, ordinal, q % engine_queues,
+                    tenant.streams[q]);
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Submits the list of the stream and waits for it, once per iteration,
+// keeping the round trip of each iteration after the warmup ones and
+// when the measured iterations began and ended. Every thread counts
+// itself ready, then all are released together.
+//---------------------------------------------------------------------
+void ZeMultiContext::stream_thread(KernelStream &stream,
+                                   std::atomic<uint32_t> &ready,
+                                   const std::atomic<bool> &go) {
+  SampleTimer<std::micro> timer(number_iterations);
+
+  ready.fetch_add(1, std::memory_order_release);
+  while (!go.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
+  for (uint32_t i = 0; i < warmup_iterations + number_iterations; i++) {
+    if (i == warmup_iterations) {
+      timer.clear();
+      stream.begin = std::chrono::steady_clock::now();
+    }
+    timer.start();
+    SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandList(
+        stream.queue, 1, &stream.list, nullptr));
+    SUCCESS_OR_TERMINATE(
+        zeCommandQueueSynchronize(stream.queue, UINT64_MAX));
+    timer.stop();
+  }
+  stream.end = std::chrono::steady_clock::now();
+
+  stream.latency = timer.samples();
+}
+
+void ZeMultiContext::add_result(const std::string &test,
+                                const std::string &metric,
+                                const std::string &unit, uint32_t contexts,
+                                uint32_t queues,
+                                const std::vector<long double> &samples) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = metric;
+  record.unit = unit;
+  record.parameters = {{"contexts", std::to_string(contexts)},
+                       {"queues", std::to_string(queues)},
+                       {"work", std::to_string(node_work)}};
+  record.stats = ResultStats::from_samples(samples);
+  record.value = record.stats.median;
+  record.samples = samples;
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// Runs the same stream of small kernels from every queue of 1..N
+// contexts at once, one host thread per queue, and reports the round
+// trip of a submission and the kernels completed per second over all
+// streams, next to the first configuration, by default one context with
+// one queue.
+//---------------------------------------------------------------------
+void ZeMultiContext::test_scheduling(void) {
+  std::cout << std::endl;
+  std::cout << "MULTI CONTEXT SCHEDULING" << std::endl;
+  if (csv_output) {
+    std::cout << "Contexts,Queues_per_context,Streams,"
+                 "Latency_median_(usec),Latency_p99_(usec),"
+                 "Throughput_(kernels/s),Latency_vs_first,"
+                 "Throughput_per_stream_vs_first"
+              << std::endl;
+  }
+
+  long double first_latency = 0;
+  long double first_throughput = 0;
+  for (auto contexts : context_counts) {
+    for (auto queues : queue_counts) {
+      std::vector<KernelStream *> streams;
+      for (uint32_t c = 0; c < contexts; c++) {
+        for (uint32_t q = 0; q < queues; q++) {
+          streams.push_back(&tenants[c].streams[q]);
+        }
+      }
+
+      std::vector<std::thread> workers;
+      std::atomic<uint32_t> ready{0};
+      std::atomic<bool> go{false};
+      for (auto stream : streams) {
+        workers.emplace_back(&ZeMultiContext::stream_thread, this,
+                             std::ref(*stream), std::ref(ready),
+                             std::cref(go));
+      }
+      while (ready.load(std::memory_order_acquire) < streams.size()) {
+        std::this_thread::yield();
+      }
+      go.store(true, std::memory_order_release);
+      for (auto &worker : workers) {
+        worker.join();
+      }
+
+      std::vector<long double> latency;
+      auto begin = streams[0]->begin;
+      auto end = streams[0]->end;
+      for (auto stream : streams) {
+        latency.insert(latency.end(), stream->latency.begin(),
+                       stream->latency.end());
+        begin = std::min(begin, stream->begin);
+        end = std::max(end, stream->end);
+      }
+      const ResultStats latency_stats = ResultStats::from_samples(latency);
+      const long double seconds =
+          std::chrono::duration<long double>(end - begin).count();
+      const long double throughput =
+          seconds > 0 ? latency.size() / seconds : 0;
+      if (first_latency == 0) {
+        first_latency = latency_stats.median;
+        first_throughput = throughput / streams.size();
+      }
+      const long double latency_ratio =
+          first_latency > 0 ? latency_stats.median / first_latency : 0;
+      const long double throughput_ratio =
+          first_throughput > 0
+              ? throughput / streams.size() / first_throughput
+              : 0;
+
+      if (csv_output) {
+        std::cout << contexts << "," << queues << "," << streams.size()
+                  << "," << latency_stats.median << "," << latency_stats.p99
+                  << "," << throughput << "," << latency_ratio << ","
+                  << throughput_ratio << std::endl;
+      } else {
+        std::cout << std::setprecision(2) << std::fixed
+                  << "Contexts: " << std::setw(3) << contexts
+                  << " Queues: " << std::setw(3) << queues
+                  << " Latency(median/p99): " << std::setw(9)
+                  << latency_stats.median << "/" << std::setw(9)
+                  << latency_stats.p99 << " usec (" << latency_ratio
+                  << "x) Throughput: " << std::setw(11) << throughput
+                  << " kernels/s (" << throughput_ratio
+                  << "x per stream)" << std::endl;
+      }
+
+      add_result("Latency", "latency", "usec", contexts, queues, latency);
+      add_result("Throughput", "throughput", "kernels/s", contexts, queues,
+                 {throughput});
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  ZeMultiContext multi_context;
+
+  multi_context.parse_arguments(argc, argv);
+  multi_context.create_tenants();
+
+  if (multi_context.results.enabled()) {
+    multi_context.results.read_metadata(
+        multi_context.tenants[0].app->_devices);
+  }
+
+  multi_context.test_scheduling();
+
+  std::cout << std::endl;
+  return multi_context.results.finish();
+}
@@ -0,0 +1,86 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_MUTABLE_CMDLIST_HPP_
+#define _ZE_MUTABLE_CMDLIST_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <string>
+#include <vector>
+
+/*
+ * What changes in every kernel of the list between two submissions:
+ *   VALUE       -> the value argument
+ *   BUFFER      -> the value and the buffer argument
+ *   GROUP_COUNT -> the value argument and the group count
+ */
+enum class UpdateKind { VALUE = 0, BUFFER, GROUP_COUNT };
+
+class ZeMutableCmdList {
+public:
+  ZeMutableCmdList();
+  ~ZeMutableCmdList();
+  int parse_arguments(int argc, char **argv);
+  void read_mutable_support(void);
+  void test_update(void);
+
+  std::vector<uint32_t> list_sizes{10, 100, 1000, 10000};
+  std::vector<UpdateKind> kinds{UpdateKind::VALUE, UpdateKind::BUFFER,
+                                UpdateKind::GROUP_COUNT};
+  /* uints each kernel writes */
+  uint32_t node_work = 16;
+  uint32_t number_iterations = 20;
+  uint32_t warmup_iterations = 2;
+  uint32_t device_id = 0;
+  bool csv_output = false;
+  /* kernels of the last update read back and checked */
+  bool validation_failed = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_mutable_cmdlist"};
+
+  ZeApp *benchmark;
+
+private:
+  /* The arguments and group count of every kernel in one iteration */
+  uint32_t *iteration_buffer(UpdateKind kind, uint32_t iteration) const;
+  uint32_t iteration_value(uint32_t iteration) const { return iteration + 1; }
+  ze_group_count_t iteration_group_count(UpdateKind kind,
+                                         uint32_t iteration) const;
+
+  void record(ze_command_list_handle_t list, uint32_t kernel_count,
+              UpdateKind kind, uint32_t iteration,
+              std::vector<uint64_t> *command_ids);
+  void update(ze_command_list_handle_t list,
+              const std::vector<uint64_t> &command_ids, UpdateKind kind,
+              uint32_t iteration);
+  void check_written(ze_command_list_handle_t list, uint32_t kernel_count,
+                     UpdateKind kind, uint32_t iteration);
+  void add_result(const std::string &test, UpdateKind kind,
+                  uint32_t kernel_count, SampleTimer<std::micro> &timer);
+
+  /* the driver can update kernel arguments, and group counts */
+  bool mutable_arguments = false;
+  bool mutable_group_count = false;
+  uint32_t compute_ordinal = 0;
+  ze_command_queue_handle_t queue = nullptr;
+  ze_kernel_handle_t kernel = nullptr;
+  uint32_t *buffers[2] = {nullptr, nullptr};
+#ifdef ZE_MUTABLE_COMMAND_LIST_EXP_NAME
+  std::vector<ze_mutable_kernel_argument_exp_desc_t> argument_descs;
+  std::vector<ze_mutable_group_count_exp_desc_t> group_count_descs;
+  std::vector<ze_group_count_t> group_counts;
+  /* buffer arguments of the kernels, which the descriptors point to */
+  std::vector<uint32_t *> slices;
+#endif
+};
+
+#endif /* _ZE_MUTABLE_CMDLIST_HPP_ */
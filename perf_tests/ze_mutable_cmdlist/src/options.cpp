@@ -0,0 +1,146 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_mutable_cmdlist.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_mutable_cmdlist [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -k, list                 comma separated numbers of kernels per "
+    "command list"
+    "\n                            [default:  10,100,1000,10000]"
+    "\n  -u, list                 comma separated updates between two "
+    "submissions"
+    "\n                            [default:  all]:"
+    "\n      value                            the value argument of every "
+    "kernel"
+    "\n      buffer                           the value and buffer "
+    "arguments of every"
+    "\n                                       kernel"
+    "\n      group_count                      the value argument and group "
+    "count of"
+    "\n                                       every kernel"
+    "\n  --work                   set number of uints each kernel writes"
+    "\n                            [default:  16]"
+    "\n  -i                       set number of iterations per list size "
+    "and update"
+    "\n                            [default:  20]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  2]"
+    "\n  -d                       select the device (default: 0)"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_mutable_cmdlist and
+// sets the test parameters accordingly for main to execute the tests
+// with the correct environment.
+//---------------------------------------------------------------------
+int ZeMutableCmdList::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-k") == 0) && (i + 1 < argc)) {
+      list_sizes.clear();
+      for (auto &item : split_list(argv[i + 1])) {
+        const uint32_t count = isdigit(item[0]) ? sanitize_ulong(&item[0]) : 0;
+        if (count == 0) {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+        list_sizes.push_back(count);
+      }
+      if (list_sizes.empty()) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-u") == 0) && (i + 1 < argc)) {
+      kinds.clear();
+      for (auto &kind : split_list(argv[i + 1])) {
+        if (kind == "value") {
+          kinds.push_back(UpdateKind::VALUE);
+        } else if (kind == "buffer") {
+          kinds.push_back(UpdateKind::BUFFER);
+        } else if (kind == "group_count") {
+          kinds.push_back(UpdateKind::GROUP_COUNT);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "--work") == 0) && (i + 1 < argc)) {
+      node_work = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc)) {
+      device_id = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,391 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_mutable_cmdlist.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+/* Every kernel is produce_shared of ze_bandwidth, writing node_work uints */
+static const uint32_t node_group_size = 16;
+
+static const char *update_kind_names[] = {"value", "buffer", "group_count"};
+
+ZeMutableCmdList::ZeMutableCmdList() {
+  benchmark = new ZeApp("ze_bandwidth.spv");
+
+  benchmark->allDevicesInit();
+}
+
+ZeMutableCmdList::~ZeMutableCmdList() {
+  if (kernel) {
+    benchmark->functionDestroy(kernel);
+  }
+  if (queue) {
+    benchmark->commandQueueDestroy(queue);
+  }
+  for (auto buffer : buffers) {
+    if (buffer) {
+      benchmark->memoryFree(buffer);
+    }
+  }
+
+  benchmark->allDevicesCleanup();
+
+  delete benchmark;
+}
+
+//---------------------------------------------------------------------
+// Reads whether the driver exposes the mutable command list extension
+// and which parts of a kernel launch the device can update with it.
+//---------------------------------------------------------------------
+void ZeMutableCmdList::read_mutable_support(void) {
+#ifdef ZE_MUTABLE_COMMAND_LIST_EXP_NAME
+  if (benchmark->driverHasExtension(ZE_MUTABLE_COMMAND_LIST_EXP_NAME)) {
+    ze_mutable_command_list_exp_properties_t mutable_properties = {
+        ZE_STRUCTURE_TYPE_MUTABLE_COMMAND_LIST_EXP_PROPERTIES, nullptr};
+    ze_device_properties_t device_properties = {
+        ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES, &mutable_properties};
+    SUCCESS_OR_TERMINATE(zeDeviceGetProperties(
+        benchmark->_devices[device_id], &device_properties));
+    mutable_arguments = mutable_properties.mutableCommandFlags &
+                        ZE_MUTABLE_COMMAND_EXP_FLAG_KERNEL_ARGUMENTS;
+    mutable_group_count = mutable_arguments &&
+                          (mutable_properties.mutableCommandFlags &
+                           ZE_MUTABLE_COMMAND_EXP_FLAG_GROUP_COUNT);
+  }
+  if (!mutable_arguments) {
+    std::cout << "Mutable command lists are not supported by the driver, "
+                 "measuring re-recording only"
+              << std::endl;
+  } else if (!mutable_group_count) {
+    std::cout << "Mutable group counts are not supported by the device, "
+                 "measuring re-recording only for group_count"
+              << std::endl;
+  }
+#else
+  std::cout << "Built without the mutable command list extension, "
+               "measuring re-recording only"
+            << std::endl;
+#endif
+}
+
+uint32_t *ZeMutableCmdList::iteration_buffer(UpdateKind kind,
+                                             uint32_t iteration) const {
+  return kind == UpdateKind::BUFFER ? buffers[iteration % 2] : buffers[0];
+}
+
+ze_group_count_t
+ZeMutableCmdList::iteration_group_count(UpdateKind kind,
+                                        uint32_t iteration) const {
+  uint32_t groups = (node_work + node_group_size - 1) / node_group_size;
+  if (kind == UpdateKind::GROUP_COUNT) {
+    groups *= 1 + iteration % 2;
+  }
+  return {groups, 1, 1};
+}
+
+//---------------------------------------------------------------------
+// Appends kernel_count kernels with the arguments of the iteration and
+// closes the list. With command_ids, the id of every kernel is taken
+// first, so that its arguments can be updated in place later.
+//---------------------------------------------------------------------
+void ZeMutableCmdList::record(ze_command_list_handle_t list,
+                              uint32_t kernel_count, UpdateKind kind,
+                              uint32_t iteration,
+                              std::vector<uint64_t> *command_ids) {
+  uint32_t *buffer = iteration_buffer(kind, iteration);
+  const uint32_t value = iteration_value(iteration);
+  const ze_group_count_t group_count = iteration_group_count(kind, iteration);
+
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 2, sizeof(value), &value));
+  for (uint32_t k = 0; k < kernel_count; k++) {
+#ifdef ZE_MUTABLE_COMMAND_LIST_EXP_NAME
+    if (command_ids) {
+      ze_mutable_command_id_exp_desc_t id_desc = {
+          ZE_STRUCTURE_TYPE_MUTABLE_COMMAND_ID_EXP_DESC, nullptr,
+          ZE_MUTABLE_COMMAND_EXP_FLAG_KERNEL_ARGUMENTS};
+      if (kind == UpdateKind::GROUP_COUNT) {
+        id_desc.flags |= ZE_MUTABLE_COMMAND_EXP_FLAG_GROUP_COUNT;
+      }
+      SUCCESS_OR_TERMINATE(zeCommandListGetNextCommandIdExp(
+          list, &id_desc, &(*command_ids)[k]));
+    }
+#endif
+    uint32_t *slice = buffer + static_cast<size_t>(k) * node_work;
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetArgumentValue(kernel, 0, sizeof(slice), &slice));
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        list, kernel, &group_count, nullptr, 0, nullptr));
+  }
+  benchmark->commandListClose(list);
+}
+
+//---------------------------------------------------------------------
+// Updates every kernel of the list to the arguments of the iteration
+// with one chain of descriptors, then closes the list again.
+//---------------------------------------------------------------------
+void ZeMutableCmdList::update(ze_command_list_handle_t list,
+                              const std::vector<uint64_t> &command_ids,
+                              UpdateKind kind, uint32_t iteration) {
+#ifdef ZE_MUTABLE_COMMAND_LIST_EXP_NAME
+  uint32_t *buffer = iteration_buffer(kind, iteration);
+  const uint32_t value = iteration_value(iteration);
+  const ze_group_count_t group_count = iteration_group_count(kind, iteration);
+  const void *next = nullptr;
+
+  argument_descs.clear();
+  group_count_descs.clear();
+  for (size_t k = 0; k < command_ids.size(); k++) {
+    argument_descs.push_back(
+        {ZE_STRUCTURE_TYPE_MUTABLE_KERNEL_ARGUMENT_EXP_DESC, nullptr,
+         command_ids[k], 2, sizeof(value), &value});
+    if (kind == UpdateKind::BUFFER) {
+      slices[k] = buffer + k * node_work;
+      argument_descs.push_back(
+          {ZE_STRUCTURE_TYPE_MUTABLE_KERNEL_ARGUMENT_EXP_DESC, nullptr,
+           command_ids[k], 0, sizeof(slices[k]), &slices[k]});
+    } else if (kind == UpdateKind::GROUP_COUNT) {
+      group_counts[k] = group_count;
+      group_count_descs.push_back(
+          {ZE_STRUCTURE_TYPE_MUTABLE_GROUP_COUNT_EXP_DESC, nullptr,
+           command_ids[k], &group_counts[k]});
+    }
+  }
+  /* the vectors do not grow once filled, so the chain stays valid */
+  for (auto &desc : group_count_descs) {
+    desc.pNext = next;
+    next = &desc;
+  }
+  for (auto &desc : argument_descs) {
+    desc.pNext = next;
+    next = &desc;
+  }
+
+  const ze_mutable_commands_exp_desc_t commands_desc = {
+      ZE_STRUCTURE_TYPE_MUTABLE_COMMANDS_EXP_DESC, next, 0};
+  SUCCESS_OR_TERMINATE(zeCommandListUpdateMutableCommandsExp(list,
+                                                             &commands_desc));
+  benchmark->commandListClose(list);
+#endif
+}
+
+//---------------------------------------------------------------------
+// Runs the list and checks that every kernel wrote the value of the
+// iteration to its slice of the buffer of the iteration.
+//---------------------------------------------------------------------
+void ZeMutableCmdList::check_written(ze_command_list_handle_t list,
+                                     uint32_t kernel_count, UpdateKind kind,
+                                     uint32_t iteration) {
+  const size_t count = static_cast<size_t>(kernel_count) * node_work;
+  uint32_t *buffer = iteration_buffer(kind, iteration);
+  const uint32_t value = iteration_value(iteration);
+
+  std::memset(buffer, 0, count * sizeof(uint32_t));
+  benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+  benchmark->commandQueueSynchronize(queue);
+
+  for (size_t i = 0; i < count; i++) {
+    if (buffer[i] != value) {
+      std::cerr << "ERROR: " << update_kind_names[static_cast<int>(kind)]
+                << " list of " << kernel_count << " kernels wrote "
+                << buffer[i] << " instead of " << value << " at " << i
+                << std::endl;
+      validation_failed = true;
+      return;
+    }
+  }
+}
+
+void ZeMutableCmdList::add_result(const std::string &test, UpdateKind kind,
+                                  uint32_t kernel_count,
+                                  SampleTimer<std::micro> &timer) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = "usec";
+  record.parameters = {
+      {"device", std::to_string(device_id)},
+      {"update", update_kind_names[static_cast<int>(kind)]},
+      {"kernels", std::to_string(kernel_count)}};
+  record.stats = ResultStats::from_samples(timer.samples());
+  record.value = record.stats.median;
+  record.samples = timer.samples();
+  results.add(record);
+}
+
+//---------------------------------------------------------------------
+// For every list size and kind of update, measures changing the
+// arguments of all kernels of a closed list by resetting and recording
+// it again, against updating the recorded kernels in place with the
+// mutable command list extension where the driver has it.
+//---------------------------------------------------------------------
+void ZeMutableCmdList::test_update(void) {
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(device_id,
+                                                  &num_queue_groups, nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups, {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                         nullptr});
+  benchmark->deviceGetCommandQueueGroupProperties(
+      device_id, &num_queue_groups, queue_properties.data());
+  for (uint32_t i = 0; i < num_queue_groups; i++) {
+    if (queue_properties[i].flags &
+        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      compute_ordinal = i;
+      break;
+    }
+  }
+
+  const uint32_t max_kernels =
+      *std::max_element(list_sizes.begin(), list_sizes.end());
+  for (auto &buffer : buffers) {
+    benchmark->memoryAllocHost(static_cast<size_t>(max_kernels) * node_work *
+                                   sizeof(uint32_t),
+                               reinterpret_cast<void **>(&buffer));
+  }
+  benchmark->functionCreate(device_id, &kernel, "produce_shared");
+  SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(kernel, node_group_size, 1, 1));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 1, sizeof(node_work), &node_work));
+  benchmark->commandQueueCreate(device_id, compute_ordinal, &queue);
+#ifdef ZE_MUTABLE_COMMAND_LIST_EXP_NAME
+  argument_descs.reserve(2 * static_cast<size_t>(max_kernels));
+  group_count_descs.reserve(max_kernels);
+  group_counts.resize(max_kernels);
+  slices.resize(max_kernels);
+#endif
+
+  std::cout << std::endl;
+  std::cout << "MUTABLE COMMAND LIST UPDATE" << std::endl;
+  if (csv_output) {
+    std::cout << "Update,Kernels,ReRecord_(usec),ReRecord_per_kernel_(usec),"
+                 "Update_(usec),Update_per_kernel_(usec),Speedup"
+              << std::endl;
+  }
+
+  const uint32_t total_iterations = warmup_iterations + number_iterations;
+  for (auto kind : kinds) {
+    const bool updatable = kind == UpdateKind::GROUP_COUNT
+                               ? mutable_group_count
+                               : mutable_arguments;
+    for (auto kernel_count : list_sizes) {
+      SampleTimer<std::micro> rerecord_timer(number_iterations);
+      ze_command_list_handle_t list;
+      benchmark->commandListCreate(device_id, compute_ordinal, &list);
+      for (uint32_t i = 0; i < total_iterations; i++) {
+        if (i == warmup_iterations) {
+          rerecord_timer.clear();
+        }
+        rerecord_timer.start();
+        benchmark->commandListReset(list);
+        record(list, kernel_count, kind, i, nullptr);
+        rerecord_timer.stop();
+      }
+      check_written(list, kernel_count, kind, total_iterations - 1);
+      benchmark->commandListDestroy(list);
+      const long double rerecord = rerecord_timer.percentile(50);
+
+      SampleTimer<std::micro> update_timer(number_iterations);
+#ifdef ZE_MUTABLE_COMMAND_LIST_EXP_NAME
+      if (updatable) {
+        const ze_mutable_command_list_exp_desc_t mutable_desc = {
+            ZE_STRUCTURE_TYPE_MUTABLE_COMMAND_LIST_EXP_DESC, nullptr, 0};
+        ze_command_list_desc_t list_desc = {};
+        list_desc.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+        list_desc.pNext = &mutable_desc;
+        list_desc.commandQueueGroupOrdinal = compute_ordinal;
+        SUCCESS_OR_TERMINATE(
+            zeCommandListCreate(benchmark->context,
+                                benchmark->_devices[device_id], &list_desc,
+                                &list));
+        std::vector<uint64_t> command_ids(kernel_count);
+        record(list, kernel_count, kind, 0, &command_ids);
+        for (uint32_t i = 1; i <= total_iterations; i++) {
+          if (i == warmup_iterations + 1) {
+            update_timer.clear();
+          }
+          update_timer.start();
+          update(list, command_ids, kind, i);
+          update_timer.stop();
+        }
+        check_written(list, kernel_count, kind, total_iterations);
+        benchmark->commandListDestroy(list);
+      }
+#endif
+      const long double update = update_timer.percentile(50);
+
+      const char *kind_name = update_kind_names[static_cast<int>(kind)];
+      if (csv_output) {
+        std::cout << kind_name << "," << kernel_count << "," << rerecord
+                  << "," << rerecord / kernel_count << ",";
+        if (updatable) {
+          std::cout << update << "," << update / kernel_count << ","
+                    << rerecord / update;
+        } else {
+          std::cout << ",,";
+        }
+        std::cout << std::endl;
+      } else {
+        std::cout << std::setprecision(2) << std::fixed
+                  << "Update: " << std::setw(11) << kind_name
+                  << " Kernels: " << std::setw(5) << kernel_count
+                  << " ReRecord: " << std::setw(10) << rerecord << " usec ("
+                  << std::setw(6) << rerecord / kernel_count
+                  << " per kernel)";
+        if (updatable) {
+          std::cout << " Update: " << std::setw(10) << update << " usec ("
+                    << std::setw(6) << update / kernel_count
+                    << " per kernel) Speedup: " << rerecord / update << "x";
+        } else {
+          std::cout << " Update: unsupported";
+        }
+        std::cout << std::endl;
+      }
+
+      add_result("ReRecord", kind, kernel_count, rerecord_timer);
+      if (updatable) {
+        add_result("Update", kind, kernel_count, update_timer);
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  ZeMutableCmdList mutable_cmdlist;
+
+  mutable_cmdlist.parse_arguments(argc, argv);
+
+  if (mutable_cmdlist.device_id >= mutable_cmdlist.benchmark->_devices.size()) {
+    std::cerr << "ERROR: device " << mutable_cmdlist.device_id << " not found"
+              << std::endl;
+    return -1;
+  }
+
+  if (mutable_cmdlist.results.enabled()) {
+    mutable_cmdlist.results.read_metadata(
+        {mutable_cmdlist.benchmark->_devices[mutable_cmdlist.device_id]});
+  }
+
+  mutable_cmdlist.read_mutable_support();
+  mutable_cmdlist.test_update();
+
+  std::cout << std::endl;
+  const int result = mutable_cmdlist.results.finish();
+  return mutable_cmdlist.validation_failed ? 1 : result;
+}
@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -13,13 +13,31 @@
 #include "hardware_counter.hpp"
 #include <level_zero/ze_api.h>
 
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
+#include <cstdint>
 #include <iomanip>
 #include <locale>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 const std::string PREFIX_LATENCY = "[ PERF LATENCY nS ]\t";
+const std::string PREFIX_LATENCY_MIN = "[ PERF LATENCY MIN nS ]\t";
+const std::string PREFIX_LATENCY_MEDIAN = "[ PERF LATENCY MEDIAN nS ]\t";
+const std::string PREFIX_LATENCY_P99 = "[ PERF LATENCY P99 nS ]\t";
+const std::string PREFIX_LATENCY_MAX = "[ PERF LATENCY MAX nS ]\t";
 const std::string PREFIX_FUNCTION_CALL_RATE = "[ PERF FUNC_CALL_RATE ]\t";
+const std::string PREFIX_SCALING_TOTAL = "[ PERF SCALING TOTAL ]\t";
+const std::string PREFIX_SCALING_PER_THREAD = "[ PERF SCALING PER THREAD ]\t";
 const std::string PREFIX_CYCLES = "[ PERF CYCLES ]\t\t";
 const std::string PREFIX_INSTRUCTION = "[ PERF INSTRUCTIONS ]\t";
 const std::string PREFIX_IPC = "[ PERF IPC ]\t\t";
@@ -35,18 +53,65 @@ void api_static_probe_init();
 void api_static_probe_cleanup();
 bool api_static_probe_is_init();
 
+/*
+ * Clock of the per call measurements: the TSC read with rdtscp on x86,
+ * which waits for the measured call to complete before reading, and
+ * steady_clock elsewhere. api_static_probe_init() calibrates it against
+ * steady_clock and measures the cost of back to back reads.
+ */
+inline uint64_t probe_clock_ticks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  unsigned int aux;
+  return __rdtscp(&aux);
+#else
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+extern long double probe_clock_nsec_per_tick;
+extern uint64_t probe_clock_overhead_ticks;
+
 typedef struct _probe_cofig {
   int warm_up_iteration;
   int measure_iteration;
+  /* Largest thread count of PROBE_MEASURE_SCALING */
+  int max_threads;
 } probe_config_t;
 
+/*
+ * Every numeric probe output is also kept as a record, written to JSON
+ * and compared to a baseline by probe_report.hpp. The metric is the
+ * output prefix without brackets, the variant the test case prefix.
+ */
+typedef struct _probe_record_t {
+  std::string api;
+  std::string variant;
+  std::string metric;
+  double value;
+  std::string unit;
+} probe_record_t;
+
+extern std::vector<probe_record_t> probe_records;
+void probe_record_output(const std::string metric_prefix,
+                         const std::string prefix,
+                         const std::string function_name, double output_value,
+                         const std::string suffix, std::true_type);
+template <typename T>
+inline void probe_record_output(const std::string metric_prefix,
+                                const std::string prefix,
+                                const std::string function_name,
+                                T output_value, const std::string suffix,
+                                std::false_type) {}
+
 template <typename T>
 inline void
-print_probe_output(const std::string prefix, const std::string filename,
-                   const int line_number, const std::string function_name,
-                   T output_value, const std::string suffix) {
+print_probe_output(const std::string metric_prefix, const std::string prefix,
+                   const std::string filename, const int line_number,
+                   const std::string function_name, T output_value,
+                   const std::string suffix) {
+  probe_record_output(metric_prefix, prefix, function_name, output_value,
+                      suffix, std::is_arithmetic<T>());
   std::cout.imbue(std::locale(""));
-  std::cout << prefix
+  std::cout << metric_prefix + prefix
             << (verbose ? filename + ":" + std::to_string(line_number) + "\t"
                         : "")
             << (verbose ? function_name + "\t" : "") << std::setw(15)
@@ -77,13 +142,64 @@ long double _function_call_iter_measure_latency(
 
   nsec = timer.period_minus_overhead();
 
-  print_probe_output(
-      PREFIX_LATENCY + prefix, filename, line_number, function_name,
-      nsec / static_cast<long double>(iteration_number), UNIT_LATENCY);
+  print_probe_output(PREFIX_LATENCY, prefix, filename, line_number,
+                     function_name,
+                     nsec / static_cast<long double>(iteration_number),
+                     UNIT_LATENCY);
 
   return nsec;
 }
 
+#define PROBE_MEASURE_LATENCY_DISTRIBUTION(prefix, probe_setting,              \
+                                           function_name, ...)                 \
+  _function_call_latency_distribution(__FILE__, __LINE__, #function_name,      \
+                                      prefix, probe_setting, function_name,    \
+                                      __VA_ARGS__)
+/*
+ * Times every call on its own, instead of the whole loop as
+ * PROBE_MEASURE_LATENCY_ITERATION does, so outliers such as lock
+ * contention or page faults in the driver show in the p99 and max.
+ */
+template <typename... Params, typename... Args>
+void _function_call_latency_distribution(
+    const std::string filename, const int line_number,
+    const std::string function_name, const std::string prefix,
+    const probe_config_t &probe_setting,
+    ze_result_t (*api_function)(Params... params), Args... args) {
+  int iteration_number = probe_setting.measure_iteration;
+  assert(api_static_probe_is_init());
+  if (iteration_number <= 0) {
+    return;
+  }
+
+  std::vector<uint64_t> call_ticks(iteration_number);
+  for (int i = 0; i < iteration_number; i++) {
+    uint64_t start = probe_clock_ticks();
+    api_function(args...);
+    call_ticks[i] = probe_clock_ticks() - start;
+  }
+  std::sort(call_ticks.begin(), call_ticks.end());
+
+  auto nsec = [](uint64_t ticks) {
+    ticks = (ticks > probe_clock_overhead_ticks)
+                ? ticks - probe_clock_overhead_ticks
+                : 0;
+    return ticks * probe_clock_nsec_per_tick;
+  };
+  size_t p99_index = (call_ticks.size() * 99 + 99) / 100 - 1;
+
+  print_probe_output(PREFIX_LATENCY_MIN, prefix, filename, line_number,
+                     function_name, nsec(call_ticks.front()), UNIT_LATENCY);
+  print_probe_output(PREFIX_LATENCY_MEDIAN, prefix, filename, line_number,
+                     function_name, nsec(call_ticks[call_ticks.size() / 2]),
+                     UNIT_LATENCY);
+  print_probe_output(PREFIX_LATENCY_P99, prefix, filename, line_number,
+                     function_name, nsec(call_ticks[p99_index]),
+                     UNIT_LATENCY);
+  print_probe_output(PREFIX_LATENCY_MAX, prefix, filename, line_number,
+                     function_name, nsec(call_ticks.back()), UNIT_LATENCY);
+}
+
 #define PROBE_MEASURE_HARDWARE_COUNTERS(prefix, probe_setting, function_name,  \
                                         ...)                                   \
   _function_call_iter_hardware_counters(__FILE__, __LINE__, #function_name,    \
@@ -101,7 +217,7 @@ void _function_call_iter_hardware_counters(
 
   if (hardware_counters->is_supported() == false) {
     std::string warning = HardwareCounter::support_warning();
-    print_probe_output(UNIT_CYCLES + prefix, filename, line_number,
+    print_probe_output(UNIT_CYCLES, prefix, filename, line_number,
                        function_name, warning, "");
     /*
      * Even though no hardware counters are retrieved, call the api
@@ -128,13 +244,33 @@ void _function_call_iter_hardware_counters(
       static_cast<double>(normalized_instruction_count) /
       normalized_cycle_count;
 
-  print_probe_output(PREFIX_INSTRUCTION + prefix, filename, line_number,
+  print_probe_output(PREFIX_INSTRUCTION, prefix, filename, line_number,
                      function_name, normalized_instruction_count,
                      UNIT_INSTRUCTION);
-  print_probe_output(PREFIX_CYCLES + prefix, filename, line_number,
+  print_probe_output(PREFIX_CYCLES, prefix, filename, line_number,
                      function_name, normalized_cycle_count, UNIT_CYCLES);
-  print_probe_output(PREFIX_IPC + prefix, filename, line_number, function_name,
+  print_probe_output(PREFIX_IPC, prefix, filename, line_number, function_name,
                      instruction_per_cycle, UNIT_IPC);
+
+  /* Events selected with --hw_counters on top of instructions and cycles */
+  for (int e = HW_COUNTER_CYCLES + 1; e < HW_COUNTER_MAX; e++) {
+    auto event = static_cast<hardware_counter_event_t>(e);
+    if (!HardwareCounter::is_event_selected(event)) {
+      continue;
+    }
+    std::string event_name = HardwareCounter::event_name(event);
+    std::string event_prefix = "[ PERF " + event_name + " ]\t";
+    if (!hardware_counters->is_event_supported(event)) {
+      print_probe_output(event_prefix, prefix, filename, line_number,
+                         function_name, "not supported", "");
+      continue;
+    }
+    auto normalized_event_count =
+        static_cast<double>(hardware_counters->counter(event)) /
+        iteration_number;
+    print_probe_output(event_prefix, prefix, filename, line_number,
+                       function_name, normalized_event_count, event_name);
+  }
 }
 
 #define PROBE_MEASURE_FUNCTION_CALL_RATE(prefix, probe_setting, function_name, \
@@ -185,8 +321,76 @@ void _function_call_rate_iter(const std::string filename, const int line_number,
     std::cout << "Period " << nsec << " number function calls "
               << function_call_counter << std::endl;
   }
-  print_probe_output(PREFIX_FUNCTION_CALL_RATE + prefix, filename, line_number,
-                     function_name, function_call_counter,
+  print_probe_output(PREFIX_FUNCTION_CALL_RATE, prefix, filename,
+                     line_number, function_name, function_call_counter,
                      UNIT_FUNCTION_CALL_RATE);
 }
+
+#define PROBE_MEASURE_SCALING(prefix, probe_setting, function_name,            \
+                              thread_call)                                     \
+  _function_call_scaling(__FILE__, __LINE__, #function_name, prefix,           \
+                         probe_setting, thread_call)
+/*
+ * thread_call(t) makes one call of the measured function on the objects
+ * of thread t. The calls run measure_iteration times on each of 1, 2, 4
+ * up to max_threads threads at once, all threads starting together, and
+ * the call rate of every thread count is printed. A rate per thread that
+ * drops as threads are added is contention in the driver.
+ */
+template <typename ThreadCall>
+void _function_call_scaling(const std::string filename, const int line_number,
+                            const std::string function_name,
+                            const std::string prefix,
+                            const probe_config_t &probe_setting,
+                            ThreadCall thread_call) {
+  int iteration_number = probe_setting.measure_iteration;
+  std::vector<int> thread_counts;
+  for (int t = 1; t < probe_setting.max_threads; t *= 2) {
+    thread_counts.push_back(t);
+  }
+  thread_counts.push_back(probe_setting.max_threads);
+
+  for (auto thread_count : thread_counts) {
+    std::atomic<int> ready_threads{0};
+    std::atomic<bool> start{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+          thread_call(t);
+        }
+        ready_threads++;
+        while (!start) {
+        }
+        for (int i = 0; i < iteration_number; i++) {
+          thread_call(t);
+        }
+      });
+    }
+    while (ready_threads < thread_count) {
+    }
+
+    Timer<> timer;
+    timer.start();
+    start = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    timer.end();
+
+    long double nsec = timer.period_minus_overhead();
+    long double calls_per_sec =
+        thread_count * static_cast<long double>(iteration_number) * 1e9 / nsec;
+    std::string threads_prefix =
+        prefix + std::to_string(thread_count) + " threads\t";
+    print_probe_output(PREFIX_SCALING_TOTAL, threads_prefix, filename,
+                       line_number, function_name,
+                       static_cast<long long>(calls_per_sec),
+                       UNIT_FUNCTION_CALL_RATE);
+    print_probe_output(PREFIX_SCALING_PER_THREAD, threads_prefix, filename,
+                       line_number, function_name,
+                       static_cast<long long>(calls_per_sec / thread_count),
+                       UNIT_FUNCTION_CALL_RATE);
+  }
+}
 #endif /* _API_STATIC_PROBE_HPP_ */
@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -18,19 +18,47 @@ inline void cleanup() { api_static_probe_cleanup(); }
 
 namespace latency {
 #include "benchmark_template/command_list.hpp"
+#include "benchmark_template/event.hpp"
+#include "benchmark_template/group_size.hpp"
+#include "benchmark_template/immediate_command_list.hpp"
 #include "benchmark_template/ipc.hpp"
+#include "benchmark_template/memory.hpp"
+#include "benchmark_template/parameter_block.hpp"
 #include "benchmark_template/set_parameter.hpp"
 } /* namespace latency */
+namespace latency_distribution {
+#include "benchmark_template/command_list.hpp"
+#include "benchmark_template/event.hpp"
+#include "benchmark_template/group_size.hpp"
+#include "benchmark_template/immediate_command_list.hpp"
+#include "benchmark_template/ipc.hpp"
+#include "benchmark_template/memory.hpp"
+#include "benchmark_template/parameter_block.hpp"
+#include "benchmark_template/set_parameter.hpp"
+} /* namespace latency_distribution */
 namespace hardware_counter {
 #include "benchmark_template/command_list.hpp"
+#include "benchmark_template/event.hpp"
+#include "benchmark_template/group_size.hpp"
+#include "benchmark_template/immediate_command_list.hpp"
 #include "benchmark_template/ipc.hpp"
+#include "benchmark_template/memory.hpp"
+#include "benchmark_template/parameter_block.hpp"
 #include "benchmark_template/set_parameter.hpp"
 } /* namespace hardware_counter */
 namespace fuction_call_rate {
 #include "benchmark_template/command_list.hpp"
+#include "benchmark_template/event.hpp"
+#include "benchmark_template/group_size.hpp"
+#include "benchmark_template/immediate_command_list.hpp"
 #include "benchmark_template/ipc.hpp"
+#include "benchmark_template/memory.hpp"
+#include "benchmark_template/parameter_block.hpp"
 #include "benchmark_template/set_parameter.hpp"
 } /* namespace fuction_call_rate */
+namespace scaling {
+#include "benchmark_template/scaling.hpp"
+} /* namespace scaling */
 } /* namespace ze_api_benchmarks */
 
 #endif /* _BENCHMARK_HPP_ */
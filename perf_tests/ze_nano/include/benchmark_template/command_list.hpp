@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -10,3 +10,9 @@ void launch_function_no_parameter(ZeApp *benchmark,
                                   probe_config_t &probe_setting);
 void command_list_empty_execute(ZeApp *benchmark,
                                 probe_config_t &probe_setting);
+void command_list_append_barrier(ZeApp *benchmark,
+                                 probe_config_t &probe_setting);
+void command_list_append_memory_copy(ZeApp *benchmark,
+                                     probe_config_t &probe_setting);
+void command_list_append_signal_event(ZeApp *benchmark,
+                                      probe_config_t &probe_setting);
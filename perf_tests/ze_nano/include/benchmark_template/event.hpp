@@ -0,0 +1,11 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void event_host_signal(ZeApp *benchmark, probe_config_t &probe_setting);
+void event_host_reset(ZeApp *benchmark, probe_config_t &probe_setting);
+void event_query_status(ZeApp *benchmark, probe_config_t &probe_setting);
@@ -0,0 +1,11 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void kernel_set_group_size(ZeApp *benchmark, probe_config_t &probe_setting);
+void kernel_suggest_group_size(ZeApp *benchmark,
+                               probe_config_t &probe_setting);
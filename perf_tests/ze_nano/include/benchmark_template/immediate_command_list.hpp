@@ -0,0 +1,16 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void immediate_launch_function_synchronous(ZeApp *benchmark,
+                                           probe_config_t &probe_setting);
+void immediate_launch_function_asynchronous(ZeApp *benchmark,
+                                            probe_config_t &probe_setting);
+void immediate_launch_function_wait_event(ZeApp *benchmark,
+                                          probe_config_t &probe_setting);
+void launch_function_wait_event(ZeApp *benchmark,
+                                probe_config_t &probe_setting);
@@ -0,0 +1,10 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void memory_get_alloc_properties(ZeApp *benchmark,
+                                 probe_config_t &probe_setting);
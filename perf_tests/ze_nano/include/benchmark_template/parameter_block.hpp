@@ -0,0 +1,11 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void parameter_buffers_explicit(ZeApp *benchmark,
+                                probe_config_t &probe_setting);
+void parameter_block_indirect(ZeApp *benchmark, probe_config_t &probe_setting);
@@ -0,0 +1,13 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void parameter_integer_scaling(ZeApp *benchmark,
+                               probe_config_t &probe_setting);
+void launch_function_scaling(ZeApp *benchmark, probe_config_t &probe_setting);
+void event_query_status_scaling(ZeApp *benchmark,
+                                probe_config_t &probe_setting);
@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -10,6 +10,22 @@
 #define _HARDWARE_COUNTER_HPP_
 #include <iostream>
 
+/*
+ * Instructions and cycles are always counted, the other events only when
+ * selected with HardwareCounter::select_events() before the counters are
+ * created.
+ */
+typedef enum _hardware_counter_event_t {
+  HW_COUNTER_INSTRUCTIONS = 0,
+  HW_COUNTER_CYCLES,
+  HW_COUNTER_L1D_MISSES,
+  HW_COUNTER_LLC_MISSES,
+  HW_COUNTER_BRANCH_MISSES,
+  HW_COUNTER_DTLB_MISSES,
+  HW_COUNTER_CONTEXT_SWITCHES,
+  HW_COUNTER_MAX
+} hardware_counter_event_t;
+
 class HardwareCounter {
 public:
   HardwareCounter();
@@ -18,16 +34,23 @@ public:
   void end(void);
   long long counter_instructions(void);
   long long counter_cycles(void);
+  long long counter(hardware_counter_event_t event);
   bool is_supported(void);
+  bool is_event_supported(hardware_counter_event_t event);
   static std::string support_warning(void);
 
+  static void select_events(unsigned int event_mask);
+  static bool is_event_selected(hardware_counter_event_t event);
+  static const char *event_name(hardware_counter_event_t event);
+  /* Parses a comma separated list of event names, or all */
+  static bool parse_events(const std::string &events, unsigned int &mask);
+
 private:
-  static const unsigned int number_events = 2;
+  static unsigned int selected_events;
   inline void counter_asserts(void);
 
-#ifdef WITH_PAPI
+#if defined(WITH_PAPI) || defined(WITH_PERF_EVENT)
   bool _counter_enabled;
-  int event_set;
 
   /*
    * It is used to check that at least on measurement was taken
@@ -41,7 +64,17 @@ private:
    */
   bool active_period;
 
-  long long values[number_events];
+  long long values[HW_COUNTER_MAX];
+#endif
+
+#ifdef WITH_PAPI
+  int event_set;
+  /* Position of each event in the PAPI event set, -1 when not added */
+  int event_index[HW_COUNTER_MAX];
+  long long papi_values[HW_COUNTER_MAX];
+#elif defined(WITH_PERF_EVENT)
+  /* One perf_event_open file descriptor per event, -1 when not opened */
+  int event_fds[HW_COUNTER_MAX];
 #endif
 };
 
@@ -0,0 +1,30 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _PROBE_REPORT_HPP_
+#define _PROBE_REPORT_HPP_
+
+#include <string>
+
+/*
+ * Writes the records of all probes run so far as JSON. Returns false when
+ * the file cannot be written.
+ */
+bool probe_report_write_json(const std::string &filename);
+
+/*
+ * Compares the records of all probes run so far to those of a JSON file
+ * written by probe_report_write_json(). A probe regresses when it is worse
+ * than the baseline by more than threshold_percent: slower for latencies
+ * and counts, lower for call rates and IPC. Returns the number of
+ * regressions, or -1 when the baseline cannot be read.
+ */
+int probe_report_compare_baseline(const std::string &filename,
+                                  double threshold_percent);
+
+#endif /* _PROBE_REPORT_HPP_ */
@@ -0,0 +1,26 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _STARTUP_HPP_
+#define _STARTUP_HPP_
+
+#include <string>
+
+namespace ze_api_benchmarks {
+namespace startup {
+/*
+ * Times zeInit, zeDriverGet, zeDeviceGet, zeContextCreate, zeModuleCreate
+ * and the first kernel launch in a fresh child process per sample, and
+ * prints the min, median and max of every step. The driver must not have
+ * been initialized in this process yet.
+ */
+void startup_profile(const std::string &module_path, int samples);
+} /* namespace startup */
+} /* namespace ze_api_benchmarks */
+
+#endif /* _STARTUP_HPP_ */
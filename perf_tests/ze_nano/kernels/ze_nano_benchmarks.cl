@@ -25,3 +25,25 @@ kernel void function_parameter_image(image2d_t input_a, image2d_t input_b,
 
 kernel void function_no_parameter() {
 }
+
+kernel void function_parameter_buffers_write(global char *input_a,
+                                             global char *input_b,
+                                             global char *input_c,
+                                             global char *input_d,
+                                             global char *input_e,
+                                             global char *input_f) {
+  *input_a = 1;
+  *input_b = 1;
+  *input_c = 1;
+  *input_d = 1;
+  *input_e = 1;
+  *input_f = 1;
+}
+
+// The same six buffers read from a parameter block, which the kernel can
+// only reach with indirect access enabled
+kernel void function_parameter_block(global char *global *block) {
+  for (int i = 0; i < 6; i++) {
+    *block[i] = 1;
+  }
+}
@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -10,11 +10,71 @@
 
 HardwareCounter *hardware_counters = NULL;
 static bool static_probe_init = false;
+long double probe_clock_nsec_per_tick = 1.0;
+uint64_t probe_clock_overhead_ticks = 0;
+std::vector<probe_record_t> probe_records;
+
+/* Removes the blanks and tabs aligning the text output */
+static std::string probe_record_trim(const std::string &text) {
+  auto first = text.find_first_not_of(" \t");
+  if (first == std::string::npos) {
+    return "";
+  }
+  auto last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+void probe_record_output(const std::string metric_prefix,
+                         const std::string prefix,
+                         const std::string function_name, double output_value,
+                         const std::string suffix, std::true_type) {
+  /* "[ PERF LATENCY nS ]\t" is recorded as "LATENCY nS" */
+  std::string metric = probe_record_trim(metric_prefix);
+  const std::string metric_start = "[ PERF ";
+  if (metric.compare(0, metric_start.size(), metric_start) == 0) {
+    metric = metric.substr(metric_start.size());
+  }
+  if (!metric.empty() && metric.back() == ']') {
+    metric.pop_back();
+  }
+  probe_records.push_back({function_name, probe_record_trim(prefix),
+                           probe_record_trim(metric), output_value, suffix});
+}
+
+static void probe_clock_calibrate() {
+  /* Ticks elapsed over 10 ms of steady_clock */
+  const auto calibration_period = std::chrono::milliseconds(10);
+  auto clock_start = std::chrono::steady_clock::now();
+  uint64_t ticks_start = probe_clock_ticks();
+  while (std::chrono::steady_clock::now() - clock_start < calibration_period) {
+  }
+  uint64_t ticks_end = probe_clock_ticks();
+  auto clock_end = std::chrono::steady_clock::now();
+  long double elapsed_nsec =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end -
+                                                           clock_start)
+          .count();
+  probe_clock_nsec_per_tick = elapsed_nsec / (ticks_end - ticks_start);
+
+  /* Cheapest of back to back reads, subtracted from every call */
+  probe_clock_overhead_ticks = UINT64_MAX;
+  for (int i = 0; i < 1000; i++) {
+    uint64_t start = probe_clock_ticks();
+    uint64_t ticks = probe_clock_ticks() - start;
+    probe_clock_overhead_ticks = std::min(probe_clock_overhead_ticks, ticks);
+  }
+  if (verbose) {
+    std::cout << "Probe clock " << probe_clock_nsec_per_tick
+              << " ns per tick, overhead " << probe_clock_overhead_ticks
+              << " ticks" << std::endl;
+  }
+}
 
 void api_static_probe_init() {
   assert(static_probe_init == false); /* Initialize it only once */
   static_probe_init = true;
   hardware_counters = new HardwareCounter;
+  probe_clock_calibrate();
 }
 
 void api_static_probe_cleanup() {
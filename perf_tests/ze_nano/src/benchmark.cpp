@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -33,15 +33,38 @@ namespace ze_api_benchmarks {
 #define NANO_PROBE PROBE_MEASURE_LATENCY_ITERATION
 namespace latency {
 #include "benchmark_template/command_list.cpp"
+#include "benchmark_template/event.cpp"
+#include "benchmark_template/group_size.cpp"
+#include "benchmark_template/immediate_command_list.cpp"
 #include "benchmark_template/ipc.cpp"
+#include "benchmark_template/memory.cpp"
+#include "benchmark_template/parameter_block.cpp"
 #include "benchmark_template/set_parameter.cpp"
 } /* namespace latency */
 
+#undef NANO_PROBE
+#define NANO_PROBE PROBE_MEASURE_LATENCY_DISTRIBUTION
+namespace latency_distribution {
+#include "benchmark_template/command_list.cpp"
+#include "benchmark_template/event.cpp"
+#include "benchmark_template/group_size.cpp"
+#include "benchmark_template/immediate_command_list.cpp"
+#include "benchmark_template/ipc.cpp"
+#include "benchmark_template/memory.cpp"
+#include "benchmark_template/parameter_block.cpp"
+#include "benchmark_template/set_parameter.cpp"
+} /* namespace latency_distribution */
+
 #undef NANO_PROBE
 #define NANO_PROBE PROBE_MEASURE_HARDWARE_COUNTERS
 namespace hardware_counter {
 #include "benchmark_template/command_list.cpp"
+#include "benchmark_template/event.cpp"
+#include "benchmark_template/group_size.cpp"
+#include "benchmark_template/immediate_command_list.cpp"
 #include "benchmark_template/ipc.cpp"
+#include "benchmark_template/memory.cpp"
+#include "benchmark_template/parameter_block.cpp"
 #include "benchmark_template/set_parameter.cpp"
 } /* namespace hardware_counter */
 
@@ -49,7 +72,17 @@ namespace hardware_counter {
 #define NANO_PROBE PROBE_MEASURE_FUNCTION_CALL_RATE
 namespace fuction_call_rate {
 #include "benchmark_template/command_list.cpp"
+#include "benchmark_template/event.cpp"
+#include "benchmark_template/group_size.cpp"
+#include "benchmark_template/immediate_command_list.cpp"
 #include "benchmark_template/ipc.cpp"
+#include "benchmark_template/memory.cpp"
+#include "benchmark_template/parameter_block.cpp"
 #include "benchmark_template/set_parameter.cpp"
 } /* namespace fuction_call_rate */
+
+/* The scaling probe takes a call per thread instead of shared arguments */
+namespace scaling {
+#include "benchmark_template/scaling.cpp"
+} /* namespace scaling */
 } /* namespace ze_api_benchmarks */
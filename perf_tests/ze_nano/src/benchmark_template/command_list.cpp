@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -55,3 +55,67 @@ void command_list_empty_execute(ZeApp *benchmark,
   benchmark->commandListDestroy(command_list);
   benchmark->commandQueueDestroy(command_queue);
 }
+
+void command_list_append_barrier(ZeApp *benchmark,
+                                 probe_config_t &probe_setting) {
+  ze_command_list_handle_t command_list;
+  benchmark->commandListCreate(&command_list);
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr);
+  }
+
+  NANO_PROBE(" Barrier without events\t", probe_setting,
+             zeCommandListAppendBarrier, command_list, nullptr, 0, nullptr);
+
+  benchmark->commandListDestroy(command_list);
+}
+
+void command_list_append_memory_copy(ZeApp *benchmark,
+                                     probe_config_t &probe_setting) {
+  ze_command_list_handle_t command_list;
+  void *src_buffer;
+  void *dst_buffer;
+  size_t buffer_size = 64;
+
+  benchmark->commandListCreate(&command_list);
+  benchmark->memoryAlloc(buffer_size, &src_buffer);
+  benchmark->memoryAlloc(buffer_size, &dst_buffer);
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeCommandListAppendMemoryCopy(command_list, dst_buffer, src_buffer,
+                                  buffer_size, nullptr, 0, nullptr);
+  }
+
+  NANO_PROBE(" 64 bytes device to device\t", probe_setting,
+             zeCommandListAppendMemoryCopy, command_list, dst_buffer,
+             src_buffer, buffer_size, nullptr, 0, nullptr);
+
+  benchmark->memoryFree(dst_buffer);
+  benchmark->memoryFree(src_buffer);
+  benchmark->commandListDestroy(command_list);
+}
+
+void command_list_append_signal_event(ZeApp *benchmark,
+                                      probe_config_t &probe_setting) {
+  ze_command_list_handle_t command_list;
+  ze_event_pool_handle_t event_pool = benchmark->create_event_pool(1, 0);
+  ze_event_handle_t event;
+
+  benchmark->commandListCreate(&command_list);
+  benchmark->create_event(event_pool, event, 0);
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeCommandListAppendSignalEvent(command_list, event);
+  }
+
+  NANO_PROBE(" Signal event\t", probe_setting, zeCommandListAppendSignalEvent,
+             command_list, event);
+
+  benchmark->destroy_event(event);
+  benchmark->destroy_event_pool(event_pool);
+  benchmark->commandListDestroy(command_list);
+}
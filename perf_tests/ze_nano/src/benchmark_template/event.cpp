@@ -0,0 +1,61 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void event_host_signal(ZeApp *benchmark, probe_config_t &probe_setting) {
+  ze_event_pool_handle_t event_pool = benchmark->create_event_pool(1, 0);
+  ze_event_handle_t event;
+  benchmark->create_event(event_pool, event, 0);
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeEventHostSignal(event);
+  }
+
+  NANO_PROBE(" Event host signal\t", probe_setting, zeEventHostSignal, event);
+
+  benchmark->destroy_event(event);
+  benchmark->destroy_event_pool(event_pool);
+}
+
+void event_host_reset(ZeApp *benchmark, probe_config_t &probe_setting) {
+  ze_event_pool_handle_t event_pool = benchmark->create_event_pool(1, 0);
+  ze_event_handle_t event;
+  benchmark->create_event(event_pool, event, 0);
+  SUCCESS_OR_TERMINATE(zeEventHostSignal(event));
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeEventHostReset(event);
+  }
+
+  NANO_PROBE(" Event host reset\t", probe_setting, zeEventHostReset, event);
+
+  benchmark->destroy_event(event);
+  benchmark->destroy_event_pool(event_pool);
+}
+
+void event_query_status(ZeApp *benchmark, probe_config_t &probe_setting) {
+  ze_event_pool_handle_t event_pool = benchmark->create_event_pool(1, 0);
+  ze_event_handle_t event;
+  benchmark->create_event(event_pool, event, 0);
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeEventQueryStatus(event);
+  }
+
+  /* Polling an event not signaled yet is the common case */
+  NANO_PROBE(" Event not signaled\t", probe_setting, zeEventQueryStatus,
+             event);
+
+  SUCCESS_OR_TERMINATE(zeEventHostSignal(event));
+  NANO_PROBE(" Event signaled\t", probe_setting, zeEventQueryStatus, event);
+
+  benchmark->destroy_event(event);
+  benchmark->destroy_event_pool(event_pool);
+}
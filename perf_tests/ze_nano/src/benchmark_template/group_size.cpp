@@ -0,0 +1,45 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void kernel_set_group_size(ZeApp *benchmark, probe_config_t &probe_setting) {
+  ze_kernel_handle_t function;
+
+  benchmark->functionCreate(&function, "function_no_parameter");
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(function, 64, 1, 1));
+  }
+
+  NANO_PROBE(" Group size 64x1x1\t", probe_setting, zeKernelSetGroupSize,
+             function, 64, 1, 1);
+
+  benchmark->functionDestroy(function);
+}
+
+void kernel_suggest_group_size(ZeApp *benchmark,
+                               probe_config_t &probe_setting) {
+  ze_kernel_handle_t function;
+  uint32_t group_size_x = 0;
+  uint32_t group_size_y = 0;
+  uint32_t group_size_z = 0;
+
+  benchmark->functionCreate(&function, "function_no_parameter");
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(
+        function, 1048576, 1, 1, &group_size_x, &group_size_y, &group_size_z));
+  }
+
+  NANO_PROBE(" Global size 1048576x1x1\t", probe_setting,
+             zeKernelSuggestGroupSize, function, 1048576, 1, 1, &group_size_x,
+             &group_size_y, &group_size_z);
+
+  benchmark->functionDestroy(function);
+}
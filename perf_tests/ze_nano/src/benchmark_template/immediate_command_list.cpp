@@ -0,0 +1,132 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * Kernel launches appended to an immediate command list are submitted by
+ * the append itself, so the calls below cost what a regular command list
+ * costs in zeCommandListAppendLaunchKernel and
+ * zeCommandQueueExecuteCommandLists together.
+ */
+static void immediate_launch_function(ZeApp *benchmark,
+                                      probe_config_t &probe_setting,
+                                      ze_command_queue_mode_t mode,
+                                      const char *prefix) {
+  ze_kernel_handle_t function;
+  ze_command_list_handle_t command_list;
+  benchmark->commandListCreateImmediate(mode, &command_list);
+
+  benchmark->functionCreate(&function, "function_no_parameter");
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = 1;
+  group_count.groupCountY = 1;
+  group_count.groupCountZ = 1;
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeCommandListAppendLaunchKernel(command_list, function, &group_count,
+                                    nullptr, 0, nullptr);
+  }
+  SUCCESS_OR_TERMINATE(zeCommandListHostSynchronize(command_list, UINT64_MAX));
+
+  NANO_PROBE(prefix, probe_setting, zeCommandListAppendLaunchKernel,
+             command_list, function, &group_count, nullptr, 0, nullptr);
+  SUCCESS_OR_TERMINATE(zeCommandListHostSynchronize(command_list, UINT64_MAX));
+
+  benchmark->functionDestroy(function);
+  benchmark->commandListDestroy(command_list);
+}
+
+void immediate_launch_function_synchronous(ZeApp *benchmark,
+                                           probe_config_t &probe_setting) {
+  immediate_launch_function(benchmark, probe_setting,
+                            ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS,
+                            " Immediate synchronous\t");
+}
+
+void immediate_launch_function_asynchronous(ZeApp *benchmark,
+                                            probe_config_t &probe_setting) {
+  immediate_launch_function(benchmark, probe_setting,
+                            ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                            " Immediate asynchronous\t");
+}
+
+/*
+ * The wait event is signaled from the host before the appends, so the
+ * launch never stalls and only the cost of the dependency is measured.
+ */
+void immediate_launch_function_wait_event(ZeApp *benchmark,
+                                          probe_config_t &probe_setting) {
+  ze_kernel_handle_t function;
+  ze_command_list_handle_t command_list;
+  ze_event_pool_handle_t event_pool =
+      benchmark->create_event_pool(1, ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  ze_event_handle_t event;
+
+  benchmark->commandListCreateImmediate(ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                                        &command_list);
+  benchmark->functionCreate(&function, "function_no_parameter");
+  benchmark->create_event(event_pool, event, 0);
+  SUCCESS_OR_TERMINATE(zeEventHostSignal(event));
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = 1;
+  group_count.groupCountY = 1;
+  group_count.groupCountZ = 1;
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeCommandListAppendLaunchKernel(command_list, function, &group_count,
+                                    nullptr, 1, &event);
+  }
+  SUCCESS_OR_TERMINATE(zeCommandListHostSynchronize(command_list, UINT64_MAX));
+
+  NANO_PROBE(" Immediate asynchronous, 1 wait event\t", probe_setting,
+             zeCommandListAppendLaunchKernel, command_list, function,
+             &group_count, nullptr, 1, &event);
+  SUCCESS_OR_TERMINATE(zeCommandListHostSynchronize(command_list, UINT64_MAX));
+
+  benchmark->destroy_event(event);
+  benchmark->destroy_event_pool(event_pool);
+  benchmark->functionDestroy(function);
+  benchmark->commandListDestroy(command_list);
+}
+
+/* The same dependency on a regular command list, for comparison */
+void launch_function_wait_event(ZeApp *benchmark,
+                                probe_config_t &probe_setting) {
+  ze_kernel_handle_t function;
+  ze_command_list_handle_t command_list;
+  ze_event_pool_handle_t event_pool =
+      benchmark->create_event_pool(1, ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  ze_event_handle_t event;
+
+  benchmark->commandListCreate(&command_list);
+  benchmark->functionCreate(&function, "function_no_parameter");
+  benchmark->create_event(event_pool, event, 0);
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = 1;
+  group_count.groupCountY = 1;
+  group_count.groupCountZ = 1;
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeCommandListAppendLaunchKernel(command_list, function, &group_count,
+                                    nullptr, 1, &event);
+  }
+
+  NANO_PROBE(" Regular, 1 wait event\t", probe_setting,
+             zeCommandListAppendLaunchKernel, command_list, function,
+             &group_count, nullptr, 1, &event);
+
+  benchmark->destroy_event(event);
+  benchmark->destroy_event_pool(event_pool);
+  benchmark->functionDestroy(function);
+  benchmark->commandListDestroy(command_list);
+}
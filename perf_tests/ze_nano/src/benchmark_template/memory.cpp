@@ -0,0 +1,37 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+void memory_get_alloc_properties(ZeApp *benchmark,
+                                 probe_config_t &probe_setting) {
+  void *device_buffer;
+  void *host_buffer;
+  ze_memory_allocation_properties_t properties = {
+      ZE_STRUCTURE_TYPE_MEMORY_ALLOCATION_PROPERTIES};
+  ze_device_handle_t device;
+  size_t buffer_size = 4096;
+
+  benchmark->memoryAlloc(buffer_size, &device_buffer);
+  benchmark->memoryAllocHost(buffer_size, &host_buffer);
+  /* Pointer into the allocation, not its base, as runtimes usually pass */
+  void *device_pointer = static_cast<uint8_t *>(device_buffer) + 64;
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeMemGetAllocProperties(benchmark->context, device_pointer, &properties,
+                            &device);
+  }
+
+  NANO_PROBE(" Device allocation\t", probe_setting, zeMemGetAllocProperties,
+             benchmark->context, device_pointer, &properties, &device);
+
+  NANO_PROBE(" Host allocation\t", probe_setting, zeMemGetAllocProperties,
+             benchmark->context, host_buffer, &properties, &device);
+
+  benchmark->memoryFree(host_buffer);
+  benchmark->memoryFree(device_buffer);
+}
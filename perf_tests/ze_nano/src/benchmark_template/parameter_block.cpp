@@ -0,0 +1,120 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * Six buffers reach the kernel either as six arguments, or through one
+ * argument pointing to a block holding their addresses. The block needs
+ * indirect access to device allocations, which the driver has to make
+ * resident at every launch, so the probes time both the host cost of
+ * setting the arguments and a synchronous launch with them.
+ */
+static constexpr uint32_t parameter_buffer_count = 6;
+
+static ze_result_t set_parameter_buffers(ze_kernel_handle_t function,
+                                         void *const *buffers) {
+  for (uint32_t i = 0; i < parameter_buffer_count; i++) {
+    ze_result_t result = zeKernelSetArgumentValue(
+        function, i, sizeof(buffers[i]), &buffers[i]);
+    if (result != ZE_RESULT_SUCCESS) {
+      return result;
+    }
+  }
+  return ZE_RESULT_SUCCESS;
+}
+
+static ze_result_t set_parameter_block(ze_kernel_handle_t function,
+                                       void *const *block) {
+  ze_result_t result =
+      zeKernelSetArgumentValue(function, 0, sizeof(*block), block);
+  if (result != ZE_RESULT_SUCCESS) {
+    return result;
+  }
+  return zeKernelSetIndirectAccess(function,
+                                   ZE_KERNEL_INDIRECT_ACCESS_FLAG_DEVICE);
+}
+
+/* Times a launch on a synchronous immediate command list, so to completion */
+static void parameter_launch(ZeApp *benchmark, probe_config_t &probe_setting,
+                             ze_kernel_handle_t function, const char *prefix) {
+  ze_command_list_handle_t command_list;
+  benchmark->commandListCreateImmediate(ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS,
+                                        &command_list);
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = 1;
+  group_count.groupCountY = 1;
+  group_count.groupCountZ = 1;
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    zeCommandListAppendLaunchKernel(command_list, function, &group_count,
+                                    nullptr, 0, nullptr);
+  }
+
+  NANO_PROBE(prefix, probe_setting, zeCommandListAppendLaunchKernel,
+             command_list, function, &group_count, nullptr, 0, nullptr);
+
+  benchmark->commandListDestroy(command_list);
+}
+
+void parameter_buffers_explicit(ZeApp *benchmark,
+                                probe_config_t &probe_setting) {
+  ze_kernel_handle_t function;
+  void *buffers[parameter_buffer_count];
+  for (auto &buffer : buffers) {
+    benchmark->memoryAlloc(sizeof(int8_t), &buffer);
+  }
+
+  benchmark->functionCreate(&function, "function_parameter_buffers_write");
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    SUCCESS_OR_TERMINATE(set_parameter_buffers(function, buffers));
+  }
+
+  NANO_PROBE(" 6 buffer arguments\t", probe_setting, set_parameter_buffers,
+             function, buffers);
+  parameter_launch(benchmark, probe_setting, function,
+                   " Launch, 6 buffer arguments\t");
+
+  benchmark->functionDestroy(function);
+  for (auto buffer : buffers) {
+    benchmark->memoryFree(buffer);
+  }
+}
+
+void parameter_block_indirect(ZeApp *benchmark,
+                              probe_config_t &probe_setting) {
+  ze_kernel_handle_t function;
+  void *buffers[parameter_buffer_count];
+  for (auto &buffer : buffers) {
+    benchmark->memoryAlloc(sizeof(int8_t), &buffer);
+  }
+  /* Host memory, so the framework can rewrite the block without a copy */
+  void *block = nullptr;
+  benchmark->memoryAllocHost(sizeof(buffers), &block);
+  memcpy(block, buffers, sizeof(buffers));
+
+  benchmark->functionCreate(&function, "function_parameter_block");
+
+  /* Warm up */
+  for (int i = 0; i < probe_setting.warm_up_iteration; i++) {
+    SUCCESS_OR_TERMINATE(set_parameter_block(function, &block));
+  }
+
+  NANO_PROBE(" Parameter block, indirect access\t", probe_setting,
+             set_parameter_block, function, &block);
+  parameter_launch(benchmark, probe_setting, function,
+                   " Launch, parameter block\t");
+
+  benchmark->functionDestroy(function);
+  benchmark->memoryFree(block);
+  for (auto buffer : buffers) {
+    benchmark->memoryFree(buffer);
+  }
+}
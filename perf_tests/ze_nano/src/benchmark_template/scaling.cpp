@@ -0,0 +1,77 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * Every thread works on objects of its own, so any slowdown as threads
+ * are added comes from state shared inside the driver.
+ */
+void parameter_integer_scaling(ZeApp *benchmark,
+                               probe_config_t &probe_setting) {
+  std::vector<ze_kernel_handle_t> functions(probe_setting.max_threads);
+  std::vector<int> inputs(probe_setting.max_threads, 1);
+  for (auto &function : functions) {
+    benchmark->functionCreate(&function, "function_parameter_integer");
+  }
+
+  PROBE_MEASURE_SCALING(
+      " Distinct kernels\t", probe_setting, zeKernelSetArgumentValue,
+      [&](int t) {
+        return zeKernelSetArgumentValue(functions[t], 0, sizeof(inputs[t]),
+                                        &inputs[t]);
+      });
+
+  for (auto function : functions) {
+    benchmark->functionDestroy(function);
+  }
+}
+
+void launch_function_scaling(ZeApp *benchmark, probe_config_t &probe_setting) {
+  std::vector<ze_kernel_handle_t> functions(probe_setting.max_threads);
+  std::vector<ze_command_list_handle_t> command_lists(
+      probe_setting.max_threads);
+  for (int t = 0; t < probe_setting.max_threads; t++) {
+    benchmark->functionCreate(&functions[t], "function_no_parameter");
+    benchmark->commandListCreate(&command_lists[t]);
+  }
+
+  ze_group_count_t group_count;
+  group_count.groupCountX = 1;
+  group_count.groupCountY = 1;
+  group_count.groupCountZ = 1;
+
+  PROBE_MEASURE_SCALING(
+      " Distinct command lists\t", probe_setting,
+      zeCommandListAppendLaunchKernel, [&](int t) {
+        return zeCommandListAppendLaunchKernel(
+            command_lists[t], functions[t], &group_count, nullptr, 0, nullptr);
+      });
+
+  for (int t = 0; t < probe_setting.max_threads; t++) {
+    benchmark->commandListDestroy(command_lists[t]);
+    benchmark->functionDestroy(functions[t]);
+  }
+}
+
+void event_query_status_scaling(ZeApp *benchmark,
+                                probe_config_t &probe_setting) {
+  ze_event_pool_handle_t event_pool =
+      benchmark->create_event_pool(probe_setting.max_threads, 0);
+  std::vector<ze_event_handle_t> events(probe_setting.max_threads);
+  for (int t = 0; t < probe_setting.max_threads; t++) {
+    benchmark->create_event(event_pool, events[t], t);
+  }
+
+  PROBE_MEASURE_SCALING(" Distinct events\t", probe_setting,
+                        zeEventQueryStatus,
+                        [&](int t) { return zeEventQueryStatus(events[t]); });
+
+  for (auto event : events) {
+    benchmark->destroy_event(event);
+  }
+  benchmark->destroy_event_pool(event_pool);
+}
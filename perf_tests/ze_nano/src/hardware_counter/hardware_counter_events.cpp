@@ -0,0 +1,60 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "hardware_counter.hpp"
+
+#include <sstream>
+
+/* Event selection shared by the PAPI, perf_event and stub counters */
+unsigned int HardwareCounter::selected_events =
+    (1u << HW_COUNTER_INSTRUCTIONS) | (1u << HW_COUNTER_CYCLES);
+
+static const char *event_names[HW_COUNTER_MAX] = {
+    "instructions",  "cycles",      "l1d_misses", "llc_misses",
+    "branch_misses", "dtlb_misses", "context_switches"};
+
+/* Names accepted by parse_events() */
+static const char *event_option_names[HW_COUNTER_MAX] = {
+    "instructions", "cycles", "l1d", "llc", "branch", "dtlb", "cs"};
+
+void HardwareCounter::select_events(unsigned int event_mask) {
+  selected_events = event_mask | (1u << HW_COUNTER_INSTRUCTIONS) |
+                    (1u << HW_COUNTER_CYCLES);
+}
+
+bool HardwareCounter::is_event_selected(hardware_counter_event_t event) {
+  return (selected_events & (1u << event)) != 0;
+}
+
+const char *HardwareCounter::event_name(hardware_counter_event_t event) {
+  return event_names[event];
+}
+
+bool HardwareCounter::parse_events(const std::string &events,
+                                   unsigned int &mask) {
+  std::stringstream stream(events);
+  std::string event;
+  mask = 0;
+  while (std::getline(stream, event, ',')) {
+    if (event == "all") {
+      mask = (1u << HW_COUNTER_MAX) - 1;
+      continue;
+    }
+    bool found = false;
+    for (unsigned int e = 0; e < HW_COUNTER_MAX; e++) {
+      if (event == event_option_names[e]) {
+        mask |= 1u << e;
+        found = true;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+  }
+  return true;
+}
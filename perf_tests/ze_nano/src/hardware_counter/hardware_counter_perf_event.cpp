@@ -0,0 +1,176 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * Counters read through perf_event_open on Linux systems without the
+ * PAPI library, with the same events as the PAPI counters.
+ */
+
+#include "common.hpp"
+#include "hardware_counter.hpp"
+
+#include <assert.h>
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static long perf_event_open(struct perf_event_attr *attr, pid_t pid, int cpu,
+                            int group_fd, unsigned long flags) {
+  return syscall(__NR_perf_event_open, attr, pid, cpu, group_fd, flags);
+}
+
+static uint64_t hw_cache_config(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+static void perf_event_config(hardware_counter_event_t event,
+                              struct perf_event_attr &attr) {
+  switch (event) {
+  case HW_COUNTER_INSTRUCTIONS:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case HW_COUNTER_CYCLES:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case HW_COUNTER_L1D_MISSES:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = hw_cache_config(PERF_COUNT_HW_CACHE_L1D,
+                                  PERF_COUNT_HW_CACHE_OP_READ,
+                                  PERF_COUNT_HW_CACHE_RESULT_MISS);
+    break;
+  case HW_COUNTER_LLC_MISSES:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    break;
+  case HW_COUNTER_BRANCH_MISSES:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    break;
+  case HW_COUNTER_DTLB_MISSES:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = hw_cache_config(PERF_COUNT_HW_CACHE_DTLB,
+                                  PERF_COUNT_HW_CACHE_OP_READ,
+                                  PERF_COUNT_HW_CACHE_RESULT_MISS);
+    break;
+  default:
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+    break;
+  }
+}
+
+HardwareCounter::HardwareCounter() {
+  measurement_taken = false;
+  active_period = false;
+
+  for (int e = 0; e < HW_COUNTER_MAX; e++) {
+    event_fds[e] = -1;
+    values[e] = 0;
+    auto event = static_cast<hardware_counter_event_t>(e);
+    if (!is_event_selected(event)) {
+      continue;
+    }
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_hv = 1;
+    perf_event_config(event, attr);
+
+    /* Driver calls spend time in the kernel, count it when allowed to */
+    event_fds[e] = perf_event_open(&attr, 0, -1, -1, 0);
+    if (event_fds[e] < 0 && (errno == EACCES || errno == EPERM)) {
+      attr.exclude_kernel = 1;
+      event_fds[e] = perf_event_open(&attr, 0, -1, -1, 0);
+    }
+    if (event_fds[e] < 0) {
+      std::cout << "ERROR: perf_event_open failed for " << event_name(event)
+                << " with " << strerror(errno) << std::endl;
+    }
+  }
+
+  _counter_enabled = (event_fds[HW_COUNTER_INSTRUCTIONS] >= 0) &&
+                     (event_fds[HW_COUNTER_CYCLES] >= 0);
+}
+
+HardwareCounter::~HardwareCounter() {
+  for (auto fd : event_fds) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+void HardwareCounter::start(void) {
+  measurement_taken = true;
+  active_period = true;
+  for (auto fd : event_fds) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void HardwareCounter::end(void) {
+  active_period = false;
+  for (auto fd : event_fds) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  for (int e = 0; e < HW_COUNTER_MAX; e++) {
+    uint64_t count = 0;
+    if (event_fds[e] >= 0 &&
+        read(event_fds[e], &count, sizeof(count)) != sizeof(count)) {
+      count = 0;
+    }
+    values[e] = static_cast<long long>(count);
+  }
+}
+
+void HardwareCounter::counter_asserts(void) {
+  /* No period was measured. start() and end() need to be called first */
+  assert(measurement_taken == true);
+
+  /*
+   * Period was not measured properly.
+   * start() was called without end().
+   */
+  assert(active_period == false);
+}
+
+long long HardwareCounter::counter_instructions(void) {
+  return counter(HW_COUNTER_INSTRUCTIONS);
+}
+
+long long HardwareCounter::counter_cycles(void) {
+  return counter(HW_COUNTER_CYCLES);
+}
+
+long long HardwareCounter::counter(hardware_counter_event_t event) {
+  counter_asserts();
+  return values[event];
+}
+
+bool HardwareCounter::is_supported(void) { return _counter_enabled; }
+
+bool HardwareCounter::is_event_supported(hardware_counter_event_t event) {
+  return event_fds[event] >= 0;
+}
+
+std::string HardwareCounter::support_warning(void) {
+  return "perf_event counters are disabled. Decrease perf_event_paranoid "
+         "level.";
+}
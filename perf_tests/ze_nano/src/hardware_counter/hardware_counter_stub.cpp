@@ -30,9 +30,18 @@ long long HardwareCounter::counter_cycles(void) {
   return -1;
 }
 
+long long HardwareCounter::counter(hardware_counter_event_t event) {
+  assert(0);
+  return -1;
+}
+
 bool HardwareCounter::is_supported(void) { return false; }
 
+bool HardwareCounter::is_event_supported(hardware_counter_event_t event) {
+  return false;
+}
+
 std::string HardwareCounter::support_warning(void) {
   return "Hardware counters are not supported. Compile benchmark with the PAPI "
-         "library on Unix system";
+         "library on Unix system or on Linux";
 }
@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -27,6 +27,15 @@ static void error_handler_counter(std::string function_name,
   print_enable_events(counter_name);
 }
 
+/*
+ * PAPI preset of every event, context switches only being available as
+ * the native event of the perf_event component.
+ */
+static const char *papi_event_names[HW_COUNTER_MAX] = {
+    "PAPI_TOT_INS", "PAPI_TOT_CYC", "PAPI_L1_DCM",
+    "PAPI_L3_TCM",  "PAPI_BR_MSP",  "PAPI_TLB_DM",
+    "perf::CONTEXT-SWITCHES"};
+
 HardwareCounter::HardwareCounter() {
   int ret;
   int number_active_events;
@@ -41,27 +50,34 @@ HardwareCounter::HardwareCounter() {
 
   SUCCESS_OR_TERMINATE(PAPI_create_eventset(&event_set));
 
-  /* Add Total Instructions Executed to the event_set */
-  ret = PAPI_add_event(event_set, PAPI_TOT_INS);
-  if (ret != PAPI_OK) {
-    error_handler_counter("PAPI_add_event", "PAPI_TOT_INS", ret);
-  }
-
-  /* Add Total Cycles event to the event_set */
-  ret = PAPI_add_event(event_set, PAPI_TOT_CYC);
-  if (ret != PAPI_OK) {
-    error_handler_counter("PAPI_add_event", "PAPI_TOT_CYC", ret);
-  }
-
   number_active_events = 0;
-  SUCCESS_OR_TERMINATE(
-      PAPI_list_events(event_set, NULL, &number_active_events));
+  for (int e = 0; e < HW_COUNTER_MAX; e++) {
+    event_index[e] = -1;
+    values[e] = 0;
+    auto event = static_cast<hardware_counter_event_t>(e);
+    if (!is_event_selected(event)) {
+      continue;
+    }
+    int event_code;
+    ret = PAPI_event_name_to_code(const_cast<char *>(papi_event_names[e]),
+                                  &event_code);
+    if (ret == PAPI_OK) {
+      ret = PAPI_add_event(event_set, event_code);
+    }
+    if (ret != PAPI_OK) {
+      error_handler_counter("PAPI_add_event", papi_event_names[e], ret);
+      continue;
+    }
+    event_index[e] = number_active_events++;
+  }
 
   /*
-   * false if PAPI library is available and the events/counters are
-   * disabled; Otherwise, true.
+   * false if PAPI library is available and the instruction or cycle
+   * counters are disabled; Otherwise, true. Other events missing, such as
+   * presets the CPU does not have, are only left out.
    */
-  _counter_enabled = (number_active_events == number_events);
+  _counter_enabled = (event_index[HW_COUNTER_INSTRUCTIONS] >= 0) &&
+                     (event_index[HW_COUNTER_CYCLES] >= 0);
 }
 
 HardwareCounter::~HardwareCounter() {
@@ -78,7 +94,10 @@ void HardwareCounter::start(void) {
 
 void HardwareCounter::end(void) {
   active_period = false;
-  SUCCESS_OR_TERMINATE(PAPI_stop(event_set, values));
+  SUCCESS_OR_TERMINATE(PAPI_stop(event_set, papi_values));
+  for (int e = 0; e < HW_COUNTER_MAX; e++) {
+    values[e] = (event_index[e] >= 0) ? papi_values[event_index[e]] : 0;
+  }
 }
 
 void HardwareCounter::counter_asserts(void) {
@@ -93,17 +112,24 @@ void HardwareCounter::counter_asserts(void) {
 }
 
 long long HardwareCounter::counter_instructions(void) {
-  counter_asserts();
-  return values[0];
+  return counter(HW_COUNTER_INSTRUCTIONS);
 }
 
 long long HardwareCounter::counter_cycles(void) {
+  return counter(HW_COUNTER_CYCLES);
+}
+
+long long HardwareCounter::counter(hardware_counter_event_t event) {
   counter_asserts();
-  return values[1];
+  return values[event];
 }
 
 bool HardwareCounter::is_supported(void) { return _counter_enabled; }
 
+bool HardwareCounter::is_event_supported(hardware_counter_event_t event) {
+  return event_index[event] >= 0;
+}
+
 std::string HardwareCounter::support_warning(void) {
   return "PAPI counters are disabled. Decrease perf_event_paranoid level.";
 }
@@ -0,0 +1,103 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "probe_report.hpp"
+#include "api_static_probe.hpp"
+
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace pt = boost::property_tree;
+
+typedef std::tuple<std::string, std::string, std::string> probe_key_t;
+
+static std::string quoted(const std::string &in) {
+  std::string out = "\"";
+  for (char c : in) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+static bool higher_is_better(const std::string &unit) {
+  return unit == UNIT_FUNCTION_CALL_RATE || unit == UNIT_IPC;
+}
+
+bool probe_report_write_json(const std::string &filename) {
+  std::ofstream stream(filename);
+  if (!stream.good()) {
+    std::cerr << "Failed to open result file: " << filename << std::endl;
+    return false;
+  }
+  stream << std::setprecision(10);
+  stream << "{\n  \"results\": [";
+  for (size_t i = 0; i < probe_records.size(); i++) {
+    auto &record = probe_records[i];
+    stream << (i ? ",\n" : "\n") << "    {\"api\": " << quoted(record.api)
+           << ", \"variant\": " << quoted(record.variant)
+           << ", \"metric\": " << quoted(record.metric)
+           << ", \"value\": " << record.value
+           << ", \"unit\": " << quoted(record.unit) << "}";
+  }
+  stream << "\n  ]\n}\n";
+  std::cout << "Results written to " << filename << std::endl;
+  return true;
+}
+
+int probe_report_compare_baseline(const std::string &filename,
+                                  double threshold_percent) {
+  std::map<probe_key_t, double> baseline;
+  try {
+    pt::ptree tree;
+    pt::read_json(filename, tree);
+    for (auto &entry : tree.get_child("results")) {
+      auto &record = entry.second;
+      baseline[probe_key_t(record.get<std::string>("api"),
+                           record.get<std::string>("variant"),
+                           record.get<std::string>("metric"))] =
+          record.get<double>("value");
+    }
+  } catch (const pt::ptree_error &error) {
+    std::cerr << "Failed to read baseline " << filename << ": "
+              << error.what() << std::endl;
+    return -1;
+  }
+
+  int compared = 0;
+  int regressions = 0;
+  std::cout << std::endl
+            << "Comparing to baseline " << filename << " with a "
+            << threshold_percent << "% threshold" << std::endl;
+  for (auto &record : probe_records) {
+    auto it = baseline.find(
+        probe_key_t(record.api, record.variant, record.metric));
+    if (it == baseline.end() || it->second == 0) {
+      continue;
+    }
+    compared++;
+    double change = (record.value - it->second) / it->second * 100.0;
+    double loss = higher_is_better(record.unit) ? -change : change;
+    if (loss > threshold_percent) {
+      regressions++;
+      std::cout << "[ REGRESSION ]\t" << record.api << "\t" << record.variant
+                << "\t" << record.metric << "\t" << it->second << " -> "
+                << record.value << " " << record.unit << " ("
+                << std::showpos << change << std::noshowpos << "%)"
+                << std::endl;
+    }
+  }
+  std::cout << regressions << " of " << compared
+            << " probes regressed beyond the threshold" << std::endl;
+  return regressions;
+}
@@ -0,0 +1,290 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "startup.hpp"
+#include "api_static_probe.hpp"
+
+#include <fstream>
+#ifndef _WIN32
+#include <ftw.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace ze_api_benchmarks {
+namespace startup {
+
+typedef enum _startup_step_t {
+  STEP_INIT = 0,
+  STEP_DRIVER_GET,
+  STEP_DEVICE_GET,
+  STEP_CONTEXT_CREATE,
+  STEP_MODULE_CREATE_SPIRV,
+  STEP_MODULE_CREATE_NATIVE,
+  STEP_FIRST_LAUNCH,
+  STEP_COUNT
+} startup_step_t;
+
+static const char *step_function_names[STEP_COUNT] = {
+    "zeInit",          "zeDriverGet",    "zeDeviceGet",
+    "zeContextCreate", "zeModuleCreate", "zeModuleCreate",
+    "zeCommandQueueExecuteCommandLists"};
+
+static const char *step_variants[STEP_COUNT] = {
+    " Cold process\t",
+    " Cold process\t",
+    " Cold process\t",
+    " Cold process\t",
+    " SPIR-V, cache disabled\t",
+    " Native binary\t",
+    " First launch, kernel create to completion\t"};
+
+#ifndef _WIN32
+/*
+ * One sample, run in a child process: every step is timed on its own,
+ * in the order an application goes through them.
+ */
+static void startup_sample(const std::vector<uint8_t> &spirv,
+                           long double nsec[STEP_COUNT]) {
+  Timer<> timer;
+  uint32_t count = 0;
+
+  timer.start();
+  SUCCESS_OR_TERMINATE(zeInit(0));
+  timer.end();
+  nsec[STEP_INIT] = timer.period_minus_overhead();
+
+  timer.start();
+  SUCCESS_OR_TERMINATE(zeDriverGet(&count, nullptr));
+  std::vector<ze_driver_handle_t> drivers(count);
+  SUCCESS_OR_TERMINATE(zeDriverGet(&count, drivers.data()));
+  timer.end();
+  nsec[STEP_DRIVER_GET] = timer.period_minus_overhead();
+  if (count == 0) {
+    _exit(1);
+  }
+
+  count = 0;
+  timer.start();
+  SUCCESS_OR_TERMINATE(zeDeviceGet(drivers[0], &count, nullptr));
+  std::vector<ze_device_handle_t> devices(count);
+  SUCCESS_OR_TERMINATE(zeDeviceGet(drivers[0], &count, devices.data()));
+  timer.end();
+  nsec[STEP_DEVICE_GET] = timer.period_minus_overhead();
+  if (count == 0) {
+    _exit(1);
+  }
+
+  ze_context_handle_t context;
+  ze_context_desc_t context_description = {};
+  context_description.stype = ZE_STRUCTURE_TYPE_CONTEXT_DESC;
+  timer.start();
+  SUCCESS_OR_TERMINATE(
+      zeContextCreate(drivers[0], &context_description, &context));
+  timer.end();
+  nsec[STEP_CONTEXT_CREATE] = timer.period_minus_overhead();
+
+  ze_module_handle_t module;
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = spirv.size();
+  module_description.pInputModule = spirv.data();
+  timer.start();
+  SUCCESS_OR_TERMINATE(zeModuleCreate(context, devices[0], &module_description,
+                                      &module, nullptr));
+  timer.end();
+  nsec[STEP_MODULE_CREATE_SPIRV] = timer.period_minus_overhead();
+
+  /* The native binary built above, loaded as an application would ship it */
+  size_t native_size = 0;
+  SUCCESS_OR_TERMINATE(zeModuleGetNativeBinary(module, &native_size, nullptr));
+  std::vector<uint8_t> native_binary(native_size);
+  SUCCESS_OR_TERMINATE(
+      zeModuleGetNativeBinary(module, &native_size, native_binary.data()));
+  ze_module_handle_t native_module;
+  module_description.format = ZE_MODULE_FORMAT_NATIVE;
+  module_description.inputSize = native_binary.size();
+  module_description.pInputModule = native_binary.data();
+  timer.start();
+  SUCCESS_OR_TERMINATE(zeModuleCreate(context, devices[0], &module_description,
+                                      &native_module, nullptr));
+  timer.end();
+  nsec[STEP_MODULE_CREATE_NATIVE] = timer.period_minus_overhead();
+
+  ze_kernel_handle_t function;
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  function_description.pKernelName = "function_no_parameter";
+  ze_command_queue_handle_t command_queue;
+  ze_command_queue_desc_t command_queue_description = {};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  ze_command_list_handle_t command_list;
+  ze_command_list_desc_t command_list_description = {};
+  command_list_description.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+  ze_group_count_t group_count = {1, 1, 1};
+  timer.start();
+  SUCCESS_OR_TERMINATE(
+      zeKernelCreate(module, &function_description, &function));
+  SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(function, 1, 1, 1));
+  SUCCESS_OR_TERMINATE(zeCommandQueueCreate(
+      context, devices[0], &command_queue_description, &command_queue));
+  SUCCESS_OR_TERMINATE(zeCommandListCreate(
+      context, devices[0], &command_list_description, &command_list));
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      command_list, function, &group_count, nullptr, 0, nullptr));
+  SUCCESS_OR_TERMINATE(zeCommandListClose(command_list));
+  SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+      command_queue, 1, &command_list, nullptr));
+  SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(command_queue, UINT64_MAX));
+  timer.end();
+  nsec[STEP_FIRST_LAUNCH] = timer.period_minus_overhead();
+
+  SUCCESS_OR_TERMINATE(zeCommandListDestroy(command_list));
+  SUCCESS_OR_TERMINATE(zeCommandQueueDestroy(command_queue));
+  SUCCESS_OR_TERMINATE(zeKernelDestroy(function));
+  SUCCESS_OR_TERMINATE(zeModuleDestroy(native_module));
+  SUCCESS_OR_TERMINATE(zeModuleDestroy(module));
+  SUCCESS_OR_TERMINATE(zeContextDestroy(context));
+}
+
+/*
+ * Forks a child for one sample and reads its timings back through a pipe.
+ * The compiler cache of the driver is disabled, or pointed at cache_dir.
+ */
+static bool run_sample(const std::vector<uint8_t> &spirv,
+                       const std::string &cache_dir,
+                       long double nsec[STEP_COUNT]) {
+  const size_t size = STEP_COUNT * sizeof(long double);
+  int fds[2];
+  if (pipe(fds) < 0) {
+    perror("pipe");
+    return false;
+  }
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("fork");
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    if (cache_dir.empty()) {
+      setenv("NEO_CACHE_PERSISTENT", "0", 1);
+    } else {
+      setenv("NEO_CACHE_PERSISTENT", "1", 1);
+      setenv("NEO_CACHE_DIR", cache_dir.c_str(), 1);
+    }
+    long double child_nsec[STEP_COUNT];
+    startup_sample(spirv, child_nsec);
+    bool sent = write(fds[1], child_nsec, size) == static_cast<ssize_t>(size);
+    _exit(sent ? 0 : 1);
+  }
+
+  close(fds[1]);
+  size_t received = 0;
+  while (received < size) {
+    ssize_t bytes = read(fds[0], reinterpret_cast<char *>(nsec) + received,
+                         size - received);
+    if (bytes <= 0) {
+      break;
+    }
+    received += bytes;
+  }
+  close(fds[0]);
+  int child_status;
+  waitpid(pid, &child_status, 0);
+  return received == size && WIFEXITED(child_status) &&
+         WEXITSTATUS(child_status) == 0;
+}
+
+static int remove_cache_entry(const char *path, const struct stat *, int,
+                              struct FTW *) {
+  return remove(path);
+}
+#endif
+
+static void print_step(std::vector<long double> &samples, const char *variant,
+                       startup_step_t step) {
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  print_probe_output(PREFIX_LATENCY_MIN, variant, __FILE__, __LINE__,
+                     step_function_names[step], samples.front(),
+                     UNIT_LATENCY);
+  print_probe_output(PREFIX_LATENCY_MEDIAN, variant, __FILE__, __LINE__,
+                     step_function_names[step], samples[samples.size() / 2],
+                     UNIT_LATENCY);
+  print_probe_output(PREFIX_LATENCY_MAX, variant, __FILE__, __LINE__,
+                     step_function_names[step], samples.back(),
+                     UNIT_LATENCY);
+}
+
+void startup_profile(const std::string &module_path, int samples) {
+#ifdef _WIN32
+  std::cout << " Startup profiling forks a process per sample and is only "
+               "supported on Unix systems"
+            << std::endl;
+#else
+  std::ifstream stream(module_path, std::ios::in | std::ios::binary);
+  if (!stream.good()) {
+    std::cerr << "Failed to load binary file: " << module_path << std::endl;
+    return;
+  }
+  std::vector<uint8_t> spirv((std::istreambuf_iterator<char>(stream)),
+                             std::istreambuf_iterator<char>());
+
+  std::vector<long double> cold_samples[STEP_COUNT];
+  std::vector<long double> cached_samples;
+  long double nsec[STEP_COUNT];
+  int failed_samples = 0;
+
+  for (int s = 0; s < samples; s++) {
+    if (!run_sample(spirv, "", nsec)) {
+      failed_samples++;
+      continue;
+    }
+    for (int step = 0; step < STEP_COUNT; step++) {
+      cold_samples[step].push_back(nsec[step]);
+    }
+  }
+
+  char cache_dir[] = "/tmp/ze_nano_cache_XXXXXX";
+  if (mkdtemp(cache_dir) != nullptr) {
+    /* The first child fills the cache, the others build from it */
+    run_sample(spirv, cache_dir, nsec);
+    for (int s = 0; s < samples; s++) {
+      if (!run_sample(spirv, cache_dir, nsec)) {
+        failed_samples++;
+        continue;
+      }
+      cached_samples.push_back(nsec[STEP_MODULE_CREATE_SPIRV]);
+    }
+    nftw(cache_dir, remove_cache_entry, 16, FTW_DEPTH | FTW_PHYS);
+  } else {
+    perror("mkdtemp");
+  }
+
+  for (int step = 0; step < STEP_COUNT; step++) {
+    print_step(cold_samples[step], step_variants[step],
+               static_cast<startup_step_t>(step));
+  }
+  print_step(cached_samples, " SPIR-V, cache warm\t",
+             STEP_MODULE_CREATE_SPIRV);
+  if (failed_samples > 0) {
+    std::cout << " " << failed_samples << " samples failed" << std::endl;
+  }
+#endif
+}
+
+} /* namespace startup */
+} /* namespace ze_api_benchmarks */
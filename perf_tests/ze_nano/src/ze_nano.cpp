@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (C) 2019 Intel Corporation
+ * Copyright (C) 2019-2024 Intel Corporation
  *
  * SPDX-License-Identifier: MIT
  *
@@ -8,14 +8,28 @@
 
 #include "common.hpp"
 #include "benchmark.hpp"
+#include "probe_report.hpp"
+#include "startup.hpp"
 
+#include <algorithm>
 #include <iomanip>
+#include <thread>
 #include <boost/program_options.hpp>
 
 namespace po = boost::program_options;
 using namespace ze_api_benchmarks;
 
 namespace {
+/* Largest thread count of the scaling probes, option --scaling_threads */
+int scaling_threads =
+    static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+/* Child processes per step of the Startup test case, --startup_samples */
+int startup_samples = 10;
+/* Result files, options --json_output, --baseline and --baseline_threshold */
+std::string json_output;
+std::string baseline;
+double baseline_threshold = 5.0;
+
 class ZeNano {
 public:
   ZeNano() {
@@ -24,6 +38,7 @@ public:
     benchmark->singleDeviceInit();
     probe_setting.warm_up_iteration = 0;
     probe_setting.measure_iteration = 0;
+    probe_setting.max_threads = scaling_threads;
   }
 
   ~ZeNano() {
@@ -34,8 +49,8 @@ public:
 
   void header_print_iteration(std::string prefix,
                               probe_config_t &probe_setting) {
-    std::cout << " All measurements are averaged per call except the function "
-                 "call rate metric"
+    std::cout << " All measurements are averaged per call except the latency "
+                 "distribution and the function call rate metrics"
               << std::endl;
     std::cout << std::left << std::setw(25) << " " + prefix << std::internal
               << "Warm up iterations " << probe_setting.warm_up_iteration
@@ -56,6 +71,8 @@ void zeNano_zeKernelSetArgumentValue_Buffer() {
   testInstance.header_print_iteration("Buffer argument",
                                       testInstance.probe_setting);
   latency::parameter_buffer(testInstance.benchmark, testInstance.probe_setting);
+  latency_distribution::parameter_buffer(testInstance.benchmark,
+                                         testInstance.probe_setting);
   hardware_counter::parameter_buffer(testInstance.benchmark,
                                      testInstance.probe_setting);
   fuction_call_rate::parameter_buffer(testInstance.benchmark,
@@ -73,6 +90,8 @@ void zeNano_zeKernelSetArgumentValue_Immediate() {
                                       testInstance.probe_setting);
   latency::parameter_integer(testInstance.benchmark,
                              testInstance.probe_setting);
+  latency_distribution::parameter_integer(testInstance.benchmark,
+                                          testInstance.probe_setting);
   hardware_counter::parameter_integer(testInstance.benchmark,
                                       testInstance.probe_setting);
   fuction_call_rate::parameter_integer(testInstance.benchmark,
@@ -89,6 +108,8 @@ void zeNano_zeKernelSetArgumentValue_Image() {
   testInstance.header_print_iteration("Image argument",
                                       testInstance.probe_setting);
   latency::parameter_image(testInstance.benchmark, testInstance.probe_setting);
+  latency_distribution::parameter_image(testInstance.benchmark,
+                                        testInstance.probe_setting);
   hardware_counter::parameter_image(testInstance.benchmark,
                                     testInstance.probe_setting);
   fuction_call_rate::parameter_image(testInstance.benchmark,
@@ -96,6 +117,33 @@ void zeNano_zeKernelSetArgumentValue_Image() {
   std::cout << std::endl;
 }
 
+void zeNano_zeKernelSetIndirectAccess() {
+  std::cout << "zeNano_zeKernelSetIndirectAccess" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 500;
+  testInstance.probe_setting.measure_iteration = 2500;
+
+  testInstance.header_print_iteration("Buffer arguments and parameter block",
+                                      testInstance.probe_setting);
+  latency::parameter_buffers_explicit(testInstance.benchmark,
+                                      testInstance.probe_setting);
+  latency::parameter_block_indirect(testInstance.benchmark,
+                                    testInstance.probe_setting);
+  latency_distribution::parameter_buffers_explicit(
+      testInstance.benchmark, testInstance.probe_setting);
+  latency_distribution::parameter_block_indirect(testInstance.benchmark,
+                                                 testInstance.probe_setting);
+  hardware_counter::parameter_buffers_explicit(testInstance.benchmark,
+                                               testInstance.probe_setting);
+  hardware_counter::parameter_block_indirect(testInstance.benchmark,
+                                             testInstance.probe_setting);
+  fuction_call_rate::parameter_buffers_explicit(testInstance.benchmark,
+                                                testInstance.probe_setting);
+  fuction_call_rate::parameter_block_indirect(testInstance.benchmark,
+                                              testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
 void zeNano_zeCommandListAppendLaunchKernel() {
   std::cout << "zeNano_zeCommandListAppendLaunchKernel" << std::endl;
   ZeNano testInstance;
@@ -105,8 +153,50 @@ void zeNano_zeCommandListAppendLaunchKernel() {
   testInstance.header_print_iteration("", testInstance.probe_setting);
   latency::launch_function_no_parameter(testInstance.benchmark,
                                         testInstance.probe_setting);
+  latency_distribution::launch_function_no_parameter(
+      testInstance.benchmark, testInstance.probe_setting);
   hardware_counter::launch_function_no_parameter(testInstance.benchmark,
                                                  testInstance.probe_setting);
+  latency::launch_function_wait_event(testInstance.benchmark,
+                                      testInstance.probe_setting);
+  latency_distribution::launch_function_wait_event(testInstance.benchmark,
+                                                   testInstance.probe_setting);
+  hardware_counter::launch_function_wait_event(testInstance.benchmark,
+                                               testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeCommandListAppendLaunchKernel_Immediate() {
+  std::cout << "zeNano_zeCommandListAppendLaunchKernel_Immediate" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 500;
+  testInstance.probe_setting.measure_iteration = 2500;
+
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::immediate_launch_function_synchronous(testInstance.benchmark,
+                                                 testInstance.probe_setting);
+  latency_distribution::immediate_launch_function_synchronous(
+      testInstance.benchmark, testInstance.probe_setting);
+  hardware_counter::immediate_launch_function_synchronous(
+      testInstance.benchmark, testInstance.probe_setting);
+  fuction_call_rate::immediate_launch_function_synchronous(
+      testInstance.benchmark, testInstance.probe_setting);
+  latency::immediate_launch_function_asynchronous(testInstance.benchmark,
+                                                  testInstance.probe_setting);
+  latency_distribution::immediate_launch_function_asynchronous(
+      testInstance.benchmark, testInstance.probe_setting);
+  hardware_counter::immediate_launch_function_asynchronous(
+      testInstance.benchmark, testInstance.probe_setting);
+  fuction_call_rate::immediate_launch_function_asynchronous(
+      testInstance.benchmark, testInstance.probe_setting);
+  latency::immediate_launch_function_wait_event(testInstance.benchmark,
+                                                testInstance.probe_setting);
+  latency_distribution::immediate_launch_function_wait_event(
+      testInstance.benchmark, testInstance.probe_setting);
+  hardware_counter::immediate_launch_function_wait_event(
+      testInstance.benchmark, testInstance.probe_setting);
+  fuction_call_rate::immediate_launch_function_wait_event(
+      testInstance.benchmark, testInstance.probe_setting);
   std::cout << std::endl;
 }
 
@@ -118,6 +208,8 @@ void zeNano_zeCommandQueueExecuteCommandLists() {
   testInstance.header_print_iteration("", testInstance.probe_setting);
   latency::command_list_empty_execute(testInstance.benchmark,
                                       testInstance.probe_setting);
+  latency_distribution::command_list_empty_execute(testInstance.benchmark,
+                                                   testInstance.probe_setting);
   hardware_counter::command_list_empty_execute(testInstance.benchmark,
                                                testInstance.probe_setting);
   fuction_call_rate::command_list_empty_execute(testInstance.benchmark,
@@ -133,6 +225,8 @@ void zeNano_zeDeviceGroupGetMemIpcHandle() {
   testInstance.header_print_iteration("", testInstance.probe_setting);
   latency::ipc_memory_handle_get(testInstance.benchmark,
                                  testInstance.probe_setting);
+  latency_distribution::ipc_memory_handle_get(testInstance.benchmark,
+                                              testInstance.probe_setting);
   hardware_counter::ipc_memory_handle_get(testInstance.benchmark,
                                           testInstance.probe_setting);
   fuction_call_rate::ipc_memory_handle_get(testInstance.benchmark,
@@ -140,6 +234,181 @@ void zeNano_zeDeviceGroupGetMemIpcHandle() {
   std::cout << std::endl;
 }
 
+void zeNano_zeEventHostSignal() {
+  std::cout << "zeNano_zeEventHostSignal" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 1000;
+  testInstance.probe_setting.measure_iteration = 9000;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::event_host_signal(testInstance.benchmark,
+                             testInstance.probe_setting);
+  latency_distribution::event_host_signal(testInstance.benchmark,
+                                          testInstance.probe_setting);
+  hardware_counter::event_host_signal(testInstance.benchmark,
+                                      testInstance.probe_setting);
+  fuction_call_rate::event_host_signal(testInstance.benchmark,
+                                       testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeEventHostReset() {
+  std::cout << "zeNano_zeEventHostReset" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 1000;
+  testInstance.probe_setting.measure_iteration = 9000;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::event_host_reset(testInstance.benchmark, testInstance.probe_setting);
+  latency_distribution::event_host_reset(testInstance.benchmark,
+                                         testInstance.probe_setting);
+  hardware_counter::event_host_reset(testInstance.benchmark,
+                                     testInstance.probe_setting);
+  fuction_call_rate::event_host_reset(testInstance.benchmark,
+                                      testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeEventQueryStatus() {
+  std::cout << "zeNano_zeEventQueryStatus" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 1000;
+  testInstance.probe_setting.measure_iteration = 9000;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::event_query_status(testInstance.benchmark,
+                              testInstance.probe_setting);
+  latency_distribution::event_query_status(testInstance.benchmark,
+                                           testInstance.probe_setting);
+  hardware_counter::event_query_status(testInstance.benchmark,
+                                       testInstance.probe_setting);
+  fuction_call_rate::event_query_status(testInstance.benchmark,
+                                        testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeCommandListAppendBarrier() {
+  std::cout << "zeNano_zeCommandListAppendBarrier" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 500;
+  testInstance.probe_setting.measure_iteration = 2500;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::command_list_append_barrier(testInstance.benchmark,
+                                       testInstance.probe_setting);
+  latency_distribution::command_list_append_barrier(testInstance.benchmark,
+                                                    testInstance.probe_setting);
+  hardware_counter::command_list_append_barrier(testInstance.benchmark,
+                                                testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeCommandListAppendMemoryCopy() {
+  std::cout << "zeNano_zeCommandListAppendMemoryCopy" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 500;
+  testInstance.probe_setting.measure_iteration = 2500;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::command_list_append_memory_copy(testInstance.benchmark,
+                                           testInstance.probe_setting);
+  latency_distribution::command_list_append_memory_copy(
+      testInstance.benchmark, testInstance.probe_setting);
+  hardware_counter::command_list_append_memory_copy(testInstance.benchmark,
+                                                    testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeCommandListAppendSignalEvent() {
+  std::cout << "zeNano_zeCommandListAppendSignalEvent" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 500;
+  testInstance.probe_setting.measure_iteration = 2500;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::command_list_append_signal_event(testInstance.benchmark,
+                                            testInstance.probe_setting);
+  latency_distribution::command_list_append_signal_event(
+      testInstance.benchmark, testInstance.probe_setting);
+  hardware_counter::command_list_append_signal_event(
+      testInstance.benchmark, testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeKernelSetGroupSize() {
+  std::cout << "zeNano_zeKernelSetGroupSize" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 1000;
+  testInstance.probe_setting.measure_iteration = 9000;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::kernel_set_group_size(testInstance.benchmark,
+                                 testInstance.probe_setting);
+  latency_distribution::kernel_set_group_size(testInstance.benchmark,
+                                              testInstance.probe_setting);
+  hardware_counter::kernel_set_group_size(testInstance.benchmark,
+                                          testInstance.probe_setting);
+  fuction_call_rate::kernel_set_group_size(testInstance.benchmark,
+                                           testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeKernelSuggestGroupSize() {
+  std::cout << "zeNano_zeKernelSuggestGroupSize" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 1000;
+  testInstance.probe_setting.measure_iteration = 9000;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::kernel_suggest_group_size(testInstance.benchmark,
+                                     testInstance.probe_setting);
+  latency_distribution::kernel_suggest_group_size(testInstance.benchmark,
+                                                  testInstance.probe_setting);
+  hardware_counter::kernel_suggest_group_size(testInstance.benchmark,
+                                              testInstance.probe_setting);
+  fuction_call_rate::kernel_suggest_group_size(testInstance.benchmark,
+                                               testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_zeMemGetAllocProperties() {
+  std::cout << "zeNano_zeMemGetAllocProperties" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 1000;
+  testInstance.probe_setting.measure_iteration = 9000;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  latency::memory_get_alloc_properties(testInstance.benchmark,
+                                       testInstance.probe_setting);
+  latency_distribution::memory_get_alloc_properties(testInstance.benchmark,
+                                                    testInstance.probe_setting);
+  hardware_counter::memory_get_alloc_properties(testInstance.benchmark,
+                                                testInstance.probe_setting);
+  fuction_call_rate::memory_get_alloc_properties(testInstance.benchmark,
+                                                 testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+void zeNano_Scaling() {
+  std::cout << "zeNano_Scaling" << std::endl;
+  ZeNano testInstance;
+  testInstance.probe_setting.warm_up_iteration = 500;
+  testInstance.probe_setting.measure_iteration = 2500;
+  testInstance.header_print_iteration("", testInstance.probe_setting);
+  std::cout << " Up to " << testInstance.probe_setting.max_threads
+            << " threads, each on objects of its own" << std::endl;
+  scaling::parameter_integer_scaling(testInstance.benchmark,
+                                     testInstance.probe_setting);
+  scaling::launch_function_scaling(testInstance.benchmark,
+                                   testInstance.probe_setting);
+  scaling::event_query_status_scaling(testInstance.benchmark,
+                                      testInstance.probe_setting);
+  std::cout << std::endl;
+}
+
+/*
+ * Runs before any other test case: every sample forks a child, which has
+ * to initialize the driver itself.
+ */
+void zeNano_Startup() {
+  std::cout << "zeNano_Startup" << std::endl;
+  std::cout << " " << startup_samples
+            << " samples, each in a new process" << std::endl;
+  startup::startup_profile("ze_nano_benchmarks.spv", startup_samples);
+  std::cout << std::endl;
+}
+
 } /* end namespace */
 
 int main(int argc, char **argv) {
@@ -150,9 +419,37 @@ int main(int argc, char **argv) {
       "zeKernelSetArgumentValue_Buffer", "enable this test case")(
       "zeKernelSetArgumentValue_Immediate", "enable this test case")(
       "zeKernelSetArgumentValue_Image", "enable this test case")(
+      "zeKernelSetIndirectAccess", "enable this test case")(
       "zeCommandListAppendLaunchKernel", "enable this test case")(
+      "zeCommandListAppendLaunchKernel_Immediate", "enable this test case")(
       "zeCommandQueueExecuteCommandLists", "enable this test case")(
-      "zeDeviceGroupGetMemIpcHandle", "enable this test case");
+      "zeDeviceGroupGetMemIpcHandle", "enable this test case")(
+      "zeEventHostSignal", "enable this test case")(
+      "zeEventHostReset", "enable this test case")(
+      "zeEventQueryStatus", "enable this test case")(
+      "zeCommandListAppendBarrier", "enable this test case")(
+      "zeCommandListAppendMemoryCopy", "enable this test case")(
+      "zeCommandListAppendSignalEvent", "enable this test case")(
+      "zeKernelSetGroupSize", "enable this test case")(
+      "zeKernelSuggestGroupSize", "enable this test case")(
+      "zeMemGetAllocProperties", "enable this test case")(
+      "Scaling", "enable this test case")(
+      "Startup", "enable this test case")(
+      "scaling_threads", po::value<int>(&scaling_threads),
+      "largest thread count of the Scaling test case")(
+      "startup_samples", po::value<int>(&startup_samples),
+      "processes started per step of the Startup test case")(
+      "hw_counters", po::value<std::string>(),
+      "hardware counter events on top of instructions and cycles: comma "
+      "separated list of l1d, llc, branch, dtlb, cs, or all")(
+      "json_output", po::value<std::string>(&json_output),
+      "write the results of all probes to this JSON file")(
+      "baseline", po::value<std::string>(&baseline),
+      "compare the results to a JSON file written by --json_output and "
+      "fail on regressions")(
+      "baseline_threshold", po::value<double>(&baseline_threshold),
+      "percentage by which a probe may be worse than the baseline, "
+      "default 5");
   po::variables_map vm;
   po::store(po::parse_command_line(argc, argv, desc), vm);
   po::notify(vm);
@@ -163,21 +460,83 @@ int main(int argc, char **argv) {
     std::cout << desc << std::endl;
     exit(0);
   }
-  if (vm.size() == 0)
+  /* Options tuning the runs rather than selecting test cases */
+  size_t setting_count = 0;
+  for (auto setting : {"scaling_threads", "startup_samples", "hw_counters",
+                       "json_output", "baseline", "baseline_threshold"}) {
+    setting_count += vm.count(setting);
+  }
+  if (vm.size() == setting_count)
     runAllTests = true;
+  if (vm.count("hw_counters")) {
+    unsigned int event_mask;
+    if (!HardwareCounter::parse_events(vm["hw_counters"].as<std::string>(),
+                                       event_mask)) {
+      std::cerr << "Unknown event in hw_counters" << std::endl;
+      exit(-1);
+    }
+    HardwareCounter::select_events(event_mask);
+  }
+  if (scaling_threads < 1) {
+    std::cerr << "scaling_threads needs to be at least 1" << std::endl;
+    exit(-1);
+  }
+  if (startup_samples < 1) {
+    std::cerr << "startup_samples needs to be at least 1" << std::endl;
+    exit(-1);
+  }
+  if (baseline_threshold < 0) {
+    std::cerr << "baseline_threshold cannot be negative" << std::endl;
+    exit(-1);
+  }
+  if (runAllTests || vm.count("Startup"))
+    zeNano_Startup();
   if (runAllTests || vm.count("zeKernelSetArgumentValue_Buffer"))
     zeNano_zeKernelSetArgumentValue_Buffer();
   if (runAllTests || vm.count("zeKernelSetArgumentValue_Immediate"))
     zeNano_zeKernelSetArgumentValue_Immediate();
   if (runAllTests || vm.count("zeKernelSetArgumentValue_Image"))
     zeNano_zeKernelSetArgumentValue_Image();
+  if (runAllTests || vm.count("zeKernelSetIndirectAccess"))
+    zeNano_zeKernelSetIndirectAccess();
   if (runAllTests || vm.count("zeCommandListAppendLaunchKernel"))
     zeNano_zeCommandListAppendLaunchKernel();
+  if (runAllTests || vm.count("zeCommandListAppendLaunchKernel_Immediate"))
+    zeNano_zeCommandListAppendLaunchKernel_Immediate();
   if (runAllTests || vm.count("zeCommandQueueExecuteCommandLists"))
     zeNano_zeCommandQueueExecuteCommandLists();
   if (runAllTests || vm.count("zeDeviceGroupGetMemIpcHandle"))
     zeNano_zeDeviceGroupGetMemIpcHandle();
+  if (runAllTests || vm.count("zeEventHostSignal"))
+    zeNano_zeEventHostSignal();
+  if (runAllTests || vm.count("zeEventHostReset"))
+    zeNano_zeEventHostReset();
+  if (runAllTests || vm.count("zeEventQueryStatus"))
+    zeNano_zeEventQueryStatus();
+  if (runAllTests || vm.count("zeCommandListAppendBarrier"))
+    zeNano_zeCommandListAppendBarrier();
+  if (runAllTests || vm.count("zeCommandListAppendMemoryCopy"))
+    zeNano_zeCommandListAppendMemoryCopy();
+  if (runAllTests || vm.count("zeCommandListAppendSignalEvent"))
+    zeNano_zeCommandListAppendSignalEvent();
+  if (runAllTests || vm.count("zeKernelSetGroupSize"))
+    zeNano_zeKernelSetGroupSize();
+  if (runAllTests || vm.count("zeKernelSuggestGroupSize"))
+    zeNano_zeKernelSuggestGroupSize();
+  if (runAllTests || vm.count("zeMemGetAllocProperties"))
+    zeNano_zeMemGetAllocProperties();
+  if (runAllTests || vm.count("Scaling"))
+    zeNano_Scaling();
 
   std::cout << "All Tests Complete" << std::endl << std::flush;
-  return 0;
+
+  int status = 0;
+  if (!json_output.empty() && !probe_report_write_json(json_output)) {
+    status = 1;
+  }
+  if (!baseline.empty() &&
+      probe_report_compare_baseline(baseline, baseline_threshold) != 0) {
+    status = 1;
+  }
+  return status;
 }
@@ -9,6 +9,7 @@
 #ifndef ZE_PEAK_H
 #define ZE_PEAK_H
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <ctype.h>
@@ -20,10 +21,17 @@
 #include <stdlib.h>
 #include <string>
 #include <cstring>
+#include <thread>
 #include <vector>
 
 /* ze includes */
 #include <level_zero/ze_api.h>
+#include <level_zero/zes_api.h>
+
+#include "utils/binary_file.hpp"
+
+#include "../../common/include/host_placement.hpp"
+#include "../../common/include/metric_profiler.hpp"
 
 #define MIN(X, Y) (X < Y) ? X : Y
 
@@ -77,6 +85,9 @@ struct L0Context {
       ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES, nullptr};
   bool verbose = false;
   std::vector<ze_command_queue_group_properties_t> queueProperties;
+  /* Path of the last load_binary_file, whose native binaries built ahead
+   * of time create_module tries first */
+  std::string module_path;
 
   void init_xe(uint32_t specified_driver, uint32_t specified_device,
                bool query_engines, bool enable_explicit_scaling,
@@ -87,8 +98,8 @@ struct L0Context {
   void print_ze_device_properties(const ze_device_properties_t &props);
   void reset_commandlist(ze_command_list_handle_t cmd_list);
   void execute_commandlist_and_sync(bool use_copy_only_queue = false);
-  std::vector<uint8_t> load_binary_file(const std::string &file_path);
-  void create_module(std::vector<uint8_t> binary_file);
+  level_zero_tests::BinaryFile load_binary_file(const std::string &file_path);
+  void create_module(const level_zero_tests::BinaryFile &binary_file);
   void ze_peak_query_engines();
 };
 
@@ -99,17 +110,78 @@ struct ZeWorkGroups {
   uint32_t group_size_z;
 };
 
+struct ZePeakResult {
+  std::string test;
+  std::string variant;
+  /* -1 for the device or the sum over the sub devices */
+  int tile;
+  std::string unit;
+  long double value;
+  uint32_t iterations;
+  long double stddev;
+  /* Average power in W and actual GPU frequency in MHz, 0 without --power */
+  long double power = 0;
+  long double frequency = 0;
+  /* Hardware counters over the result, empty without --metrics */
+  std::vector<MetricProfiler::Counter> metrics;
+  /* "implicit" or "explicit" with --compare-scaling, empty otherwise */
+  std::string scaling;
+};
+
+//---------------------------------------------------------------------
+// Reads the energy counters of the device when a window begins and ends
+// and samples the actual GPU frequency on a background thread in
+// between, using sysman. Requires ZES_ENABLE_SYSMAN=1 before zeInit.
+//---------------------------------------------------------------------
+class ZePeakPowerMonitor {
+public:
+  ~ZePeakPowerMonitor();
+  bool init(L0Context &context);
+  void begin();
+  bool end(long double &power, long double &frequency);
+  bool active() const { return running; }
+
+private:
+  void sample_frequency();
+  void read_energy(std::vector<zes_power_energy_counter_t> &counters);
+
+  std::vector<zes_pwr_handle_t> power_handles;
+  std::vector<zes_freq_handle_t> frequency_handles;
+  std::vector<zes_power_energy_counter_t> begin_energy;
+  std::thread sampler;
+  std::atomic<bool> running{false};
+  long double frequency_sum = 0;
+  uint64_t frequency_samples = 0;
+};
+
 class ZePeak {
 public:
   bool use_event_timer = false;
+  bool use_device_timestamps = false;
+  bool batch_barrier = false;
+  bool concurrent_sub_devices = false;
+  /* Run every stage on the root device and then on all sub devices
+   * concurrently, and print the results of both side by side */
+  bool compare_scaling = false;
+  /* Scaling of the running pass, stored with every result */
+  std::string scaling_mode;
   bool verbose = false;
   bool run_global_bw = true;
+  bool run_global_bw_sweep = false;
+  bool run_local_bw = true;
+  bool run_mem_latency = false;
+  bool run_atomics = false;
   bool run_hp_compute = true;
   bool run_sp_compute = true;
   bool run_dp_compute = true;
   bool run_int_compute = true;
+  bool run_matrix_compute = true;
   bool run_transfer_bw = true;
   bool run_kernel_lat = true;
+  bool latency_histogram = false;
+  bool monitor_power = false;
+  /* Cleared by stages that print their results as a table */
+  bool print_power = true;
   bool enable_explicit_scaling = false;
   bool query_engines = false;
   bool enable_fixed_ordinal_index = false;
@@ -117,19 +189,61 @@ public:
   uint32_t specified_device = 0;
   uint32_t global_bw_max_size = 1 << 29;
   uint32_t transfer_bw_max_size = 1 << 29;
+  /* Number of chunks of the pipelined transfers, 0 to skip them */
+  uint32_t transfer_chunks = 0;
   uint32_t iters = 20;
   uint32_t warmup_iterations = 5;
+  uint32_t batch_size = 1;
   uint32_t current_sub_device_id = 0;
   uint32_t command_queue_group_ordinal = 0;
   uint32_t command_queue_index = 0;
+  /* Average device time in ns of a launch timed by the last run_kernel call,
+   * only set when use_device_timestamps is enabled */
+  long double last_device_time = 0;
+  /* Per sub-device launch time in ns of the last run_kernel_concurrent call */
+  std::vector<long double> last_tile_times;
+  /* Per launch wall time in ns of the last run_kernel_concurrent call */
+  long double last_concurrent_time = 0;
+  /* Per iteration times of every run_kernel call since the last
+   * record_result, in the unit of the timing type */
+  std::vector<long double> iteration_times;
+  /* Structured results of every stage, written with --json / --csv */
+  std::vector<ZePeakResult> results;
+  std::string json_output;
+  std::string csv_output;
+  /* Power and frequency window from the first run_kernel call after a
+   * record_result up to the next record_result, with --power */
+  ZePeakPowerMonitor power_monitor;
+  /* Metric streamer window over the same span, with --metrics */
+  MetricProfiler metric_profiler;
+  /* Submission thread and host buffer placement, applied after init */
+  HostPlacement placement;
+  /* Per iteration samples in us of the last latency run_kernel call: host
+   * time of the submit (or immediate append) call, submission to kernel
+   * start from the global timestamps and kernel start to end */
+  std::vector<long double> host_call_samples;
+  std::vector<long double> submit_to_start_samples;
+  std::vector<long double> start_to_end_samples;
+  /* The dispatch phases of the same run, in us: append of the recorded
+   * command list (a single sample, empty for immediate lists, whose
+   * append is the host call), call return to kernel start and kernel end
+   * to the host waking up, both read on the device clock */
+  std::vector<long double> host_append_samples;
+  std::vector<long double> doorbell_to_start_samples;
+  std::vector<long double> end_to_wakeup_samples;
 
   int parse_arguments(int argc, char **argv);
+  void run_tests(L0Context &context);
+  void run_scaling_comparison(L0Context &context);
 
   /* Helper Functions */
-  long double run_kernel(L0Context context, ze_kernel_handle_t &function,
+  long double run_kernel(L0Context &context, ze_kernel_handle_t &function,
                          struct ZeWorkGroups &workgroup_info,
                          TimingMeasurement type,
                          bool reset_command_list = true);
+  long double run_kernel_concurrent(L0Context &context,
+                                    std::vector<ze_kernel_handle_t> &functions,
+                                    struct ZeWorkGroups &workgroup_info);
   uint64_t set_workgroups(L0Context &context,
                           const uint64_t total_work_items_requested,
                           struct ZeWorkGroups *workgroup_info);
@@ -138,13 +252,22 @@ public:
                       size_t outputSize = 0u);
   uint64_t get_max_work_items(L0Context &context);
   void print_test_complete();
+  void record_result(const char *test, const std::string &variant,
+                     const char *unit, long double value);
+  void write_results(L0Context &context);
+  void print_scaling_comparison(uint32_t sub_device_count);
   void run_command_queue(L0Context &context);
   void synchronize_command_queue(L0Context &context);
   /* Benchmark Functions*/
   void ze_peak_global_bw(L0Context &context);
+  void ze_peak_global_bw_sweep(L0Context &context);
+  void ze_peak_local_bw(L0Context &context);
+  void ze_peak_mem_latency(L0Context &context);
+  void ze_peak_atomics(L0Context &context);
   void ze_peak_kernel_latency(L0Context &context);
   void ze_peak_hp_compute(L0Context &context);
   void ze_peak_sp_compute(L0Context &context);
+  void ze_peak_matrix_compute(L0Context &context);
   void ze_peak_transfer_bw(L0Context &context);
 #ifndef EXCLUDE_MAIN
   void ze_peak_dp_compute(L0Context &context);
@@ -162,10 +285,25 @@ private:
                                      void *destination_buffer,
                                      void *source_buffer, size_t buffer_size,
                                      bool shared_is_dest);
+  void _global_bw_stream(L0Context &context, std::vector<void *> &input,
+                         std::vector<void *> &output, uint64_t numItems);
+  long double _transfer_bw_pipelined(L0Context &context,
+                                     void *destination_buffer,
+                                     void *source_buffer, size_t buffer_size,
+                                     bool to_device, bool staged);
   void _transfer_bw_shared_memory(L0Context &context, size_t local_memory_size,
                                   void *local_memory);
   TimingMeasurement is_bandwidth_with_event_timer(void);
   long double calculate_gbps(long double period, long double buffer_size);
+  std::string device_rate(long double device_time, long double work,
+                          const char *unit);
+  void print_latency_breakdown(const char *name,
+                               std::vector<long double> &samples);
+  void print_dispatch_decomposition(
+      const std::string &list_name,
+      std::vector<std::pair<const char *, std::vector<long double>>> &phases);
+  std::string tile_rates(const std::vector<long double> &tile_times,
+                         long double work, const char *unit);
   long double context_time_in_us(L0Context &context, ze_event_handle_t &event);
 };
 
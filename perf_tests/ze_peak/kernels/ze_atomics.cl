@@ -0,0 +1,103 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Built once per type, as devices without int64 or float atomics cannot
+// build the module at all:
+//   -DATOMIC_INT   -> ze_atomics_int.spv
+//   -DATOMIC_LONG  -> ze_atomics_long.spv
+//   -DATOMIC_FLOAT -> ze_atomics_float.spv (cl_ext_float_atomics)
+//
+// Every work item does `ops` relaxed atomics on slot local id & mask of
+// its group: mask 0 has the whole group on one address, a mask covering
+// the group size gives every work item its own address. The global
+// kernels give every group mask + 1 slots, the local kernels work in the
+// group's local buffer and write it to B once done.
+
+#if defined(ATOMIC_LONG)
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#pragma OPENCL EXTENSION cl_khr_int64_extended_atomics : enable
+#define TYPE ulong
+#define ATOMIC_TYPE atomic_ulong
+#define NAME(op, space) atomic_##op##_long_##space
+#elif defined(ATOMIC_FLOAT)
+#define TYPE float
+#define ATOMIC_TYPE atomic_float
+#define NAME(op, space) atomic_##op##_float_##space
+#else
+#define TYPE uint
+#define ATOMIC_TYPE atomic_uint
+#define NAME(op, space) atomic_##op##_int_##space
+#endif
+
+#define ADD(p, i)                                                              \
+  atomic_fetch_add_explicit(p, (TYPE)1, memory_order_relaxed, SCOPE)
+#define MIN(p, i)                                                              \
+  atomic_fetch_min_explicit(p, (TYPE)i, memory_order_relaxed, SCOPE)
+#define MAX(p, i)                                                              \
+  atomic_fetch_max_explicit(p, (TYPE)i, memory_order_relaxed, SCOPE)
+
+#if defined(ATOMIC_FLOAT)
+// On the bits, as there is no float compare exchange
+#define CMPXCHG_DECLARE uint expected = 0;
+#define CMPXCHG(p, i)                                                          \
+  atomic_compare_exchange_strong_explicit(                                     \
+      (volatile ADDRESS atomic_uint *)p, &expected,                            \
+      as_uint(as_float(expected) + 1.0f), memory_order_relaxed,                \
+      memory_order_relaxed, SCOPE)
+#else
+#define CMPXCHG_DECLARE TYPE expected = 0;
+#define CMPXCHG(p, i)                                                          \
+  atomic_compare_exchange_strong_explicit(p, &expected, expected + 1,          \
+                                          memory_order_relaxed,                \
+                                          memory_order_relaxed, SCOPE)
+#endif
+#define ADD_DECLARE
+#define MIN_DECLARE
+#define MAX_DECLARE
+
+#define GLOBAL_ATOMIC(op, OP)                                                  \
+  __kernel void NAME(op, global)(__global TYPE *B, uint mask, uint ops) {      \
+    volatile __global ATOMIC_TYPE *p =                                         \
+        (volatile __global ATOMIC_TYPE *)B + get_group_id(0) * (mask + 1) +    \
+        (get_local_id(0) & mask);                                              \
+    OP##_DECLARE                                                               \
+    for (uint i = 0; i < ops; i++) {                                           \
+      OP(p, i);                                                                \
+    }                                                                          \
+  }
+
+#define LOCAL_ATOMIC(op, OP)                                                   \
+  __kernel void NAME(op, local)(__global TYPE *B, __local TYPE *L, uint mask, \
+                                uint ops) {                                    \
+    L[get_local_id(0)] = 0;                                                    \
+    barrier(CLK_LOCAL_MEM_FENCE);                                              \
+    volatile __local ATOMIC_TYPE *p =                                          \
+        (volatile __local ATOMIC_TYPE *)L + (get_local_id(0) & mask);          \
+    OP##_DECLARE                                                               \
+    for (uint i = 0; i < ops; i++) {                                           \
+      OP(p, i);                                                                \
+    }                                                                          \
+    barrier(CLK_LOCAL_MEM_FENCE);                                              \
+    B[get_global_id(0)] = L[get_local_id(0)];                                  \
+  }
+
+#define SCOPE memory_scope_device
+#define ADDRESS __global
+GLOBAL_ATOMIC(add, ADD)
+GLOBAL_ATOMIC(cmpxchg, CMPXCHG)
+GLOBAL_ATOMIC(min, MIN)
+GLOBAL_ATOMIC(max, MAX)
+#undef SCOPE
+#undef ADDRESS
+
+#define SCOPE memory_scope_work_group
+#define ADDRESS __local
+LOCAL_ATOMIC(add, ADD)
+LOCAL_ATOMIC(cmpxchg, CMPXCHG)
+LOCAL_ATOMIC(min, MIN)
+LOCAL_ATOMIC(max, MAX)
@@ -0,0 +1,99 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// STREAM style kernels, one vector element per work item
+
+// Write only : A = s
+__kernel void global_bandwidth_write_v1(__global float *A, float s)
+{
+    A[get_global_id(0)] = (float)(s);
+}
+
+__kernel void global_bandwidth_write_v2(__global float2 *A, float s)
+{
+    A[get_global_id(0)] = (float2)(s);
+}
+
+__kernel void global_bandwidth_write_v4(__global float4 *A, float s)
+{
+    A[get_global_id(0)] = (float4)(s);
+}
+
+__kernel void global_bandwidth_write_v8(__global float8 *A, float s)
+{
+    A[get_global_id(0)] = (float8)(s);
+}
+
+__kernel void global_bandwidth_write_v16(__global float16 *A, float s)
+{
+    A[get_global_id(0)] = (float16)(s);
+}
+
+
+// Copy : B = A
+__kernel void global_bandwidth_copy_v1(__global float *A, __global float *B)
+{
+    B[get_global_id(0)] = A[get_global_id(0)];
+}
+
+__kernel void global_bandwidth_copy_v2(__global float2 *A, __global float2 *B)
+{
+    B[get_global_id(0)] = A[get_global_id(0)];
+}
+
+__kernel void global_bandwidth_copy_v4(__global float4 *A, __global float4 *B)
+{
+    B[get_global_id(0)] = A[get_global_id(0)];
+}
+
+__kernel void global_bandwidth_copy_v8(__global float8 *A, __global float8 *B)
+{
+    B[get_global_id(0)] = A[get_global_id(0)];
+}
+
+__kernel void global_bandwidth_copy_v16(__global float16 *A, __global float16 *B)
+{
+    B[get_global_id(0)] = A[get_global_id(0)];
+}
+
+
+// Triad : A = B + s * C
+__kernel void global_bandwidth_triad_v1(__global float *A, __global float *B,
+                                        __global float *C, float s)
+{
+    size_t id = get_global_id(0);
+    A[id] = B[id] + s * C[id];
+}
+
+__kernel void global_bandwidth_triad_v2(__global float2 *A, __global float2 *B,
+                                        __global float2 *C, float s)
+{
+    size_t id = get_global_id(0);
+    A[id] = B[id] + s * C[id];
+}
+
+__kernel void global_bandwidth_triad_v4(__global float4 *A, __global float4 *B,
+                                        __global float4 *C, float s)
+{
+    size_t id = get_global_id(0);
+    A[id] = B[id] + s * C[id];
+}
+
+__kernel void global_bandwidth_triad_v8(__global float8 *A, __global float8 *B,
+                                        __global float8 *C, float s)
+{
+    size_t id = get_global_id(0);
+    A[id] = B[id] + s * C[id];
+}
+
+__kernel void global_bandwidth_triad_v16(__global float16 *A, __global float16 *B,
+                                        __global float16 *C, float s)
+{
+    size_t id = get_global_id(0);
+    A[id] = B[id] + s * C[id];
+}
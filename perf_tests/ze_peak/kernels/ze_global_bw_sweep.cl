@@ -0,0 +1,23 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Every work item reads `reads` floats, jumping by global_size * stride
+// elements, and wraps around a working set of mask + 1 floats.
+__kernel void global_bandwidth_sweep(__global float *A, __global float *B,
+                                     uint mask, uint stride, uint reads) {
+  uint id = get_global_id(0) * stride;
+  uint jump = get_global_size(0) * stride;
+  float sum = 0;
+
+  for (uint i = 0; i < reads; i++) {
+    sum += A[id & mask];
+    id += jump;
+  }
+
+  B[get_global_id(0)] = sum;
+}
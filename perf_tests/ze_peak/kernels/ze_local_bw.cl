@@ -0,0 +1,35 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Every work item stores one element of A into local memory, then reads
+// `reads` elements back, starting at local id * stride and moving by one
+// element, wrapping around mask + 1 elements. With stride 1 the work
+// items of a sub group hit consecutive banks, a larger power of two
+// stride folds them onto fewer banks.
+#define LOCAL_BANDWIDTH(type, name)                                            \
+  __kernel void name(__global type *A, __global type *B, __local type *L,     \
+                     uint mask, uint stride, uint reads) {                     \
+    uint lid = get_local_id(0);                                                \
+    L[lid] = A[get_global_id(0)];                                              \
+    barrier(CLK_LOCAL_MEM_FENCE);                                              \
+                                                                               \
+    uint id = lid * stride;                                                    \
+    type sum = 0;                                                              \
+    for (uint i = 0; i < reads; i++) {                                         \
+      sum += L[id & mask];                                                     \
+      id += 1;                                                                 \
+    }                                                                          \
+                                                                               \
+    B[get_global_id(0)] = sum;                                                 \
+  }
+
+LOCAL_BANDWIDTH(float, local_bandwidth_v1)
+LOCAL_BANDWIDTH(float2, local_bandwidth_v2)
+LOCAL_BANDWIDTH(float4, local_bandwidth_v4)
+LOCAL_BANDWIDTH(float8, local_bandwidth_v8)
+LOCAL_BANDWIDTH(float16, local_bandwidth_v16)
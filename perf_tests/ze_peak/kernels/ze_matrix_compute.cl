@@ -0,0 +1,73 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma OPENCL EXTENSION cl_intel_subgroup_matrix_multiply_accumulate : enable
+
+#undef DPAS_4
+#undef DPAS_16
+
+// Four independent accumulator chains keep the systolic pipeline busy
+#define DPAS_4(fn, a, b)    acc0 = fn(a, b, acc0);  acc1 = fn(a, b, acc1);  acc2 = fn(a, b, acc2);  acc3 = fn(a, b, acc3);
+#define DPAS_16(fn, a, b)   DPAS_4(fn, a, b);       DPAS_4(fn, a, b);       DPAS_4(fn, a, b);       DPAS_4(fn, a, b);
+
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void compute_bf16_dpas(__global int *input_value, __global float *output)
+{
+    short8 a = (short8)((short)input_value[0]);
+    int8 b = (int8)(input_value[0]);
+    float8 acc0 = 0;
+    float8 acc1 = 1;
+    float8 acc2 = 2;
+    float8 acc3 = 3;
+
+    for (int i = 0; i < 64; i++)
+    {
+        DPAS_16(intel_sub_group_bf16_bf16_matrix_mad_k16, a, b);
+    }
+
+    float8 sum = acc0 + acc1 + acc2 + acc3;
+    output[get_global_id(0)] = sum.s0 + sum.s1 + sum.s2 + sum.s3 + sum.s4 + sum.s5 + sum.s6 + sum.s7;
+}
+
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void compute_f16_dpas(__global int *input_value, __global float *output)
+{
+    short8 a = (short8)((short)input_value[0]);
+    int8 b = (int8)(input_value[0]);
+    float8 acc0 = 0;
+    float8 acc1 = 1;
+    float8 acc2 = 2;
+    float8 acc3 = 3;
+
+    for (int i = 0; i < 64; i++)
+    {
+        DPAS_16(intel_sub_group_f16_f16_matrix_mad_k16, a, b);
+    }
+
+    float8 sum = acc0 + acc1 + acc2 + acc3;
+    output[get_global_id(0)] = sum.s0 + sum.s1 + sum.s2 + sum.s3 + sum.s4 + sum.s5 + sum.s6 + sum.s7;
+}
+
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void compute_i8_dpas(__global int *input_value, __global float *output)
+{
+    short8 a = (short8)((short)input_value[0]);
+    int8 b = (int8)(input_value[0]);
+    int8 acc0 = 0;
+    int8 acc1 = 1;
+    int8 acc2 = 2;
+    int8 acc3 = 3;
+
+    for (int i = 0; i < 64; i++)
+    {
+        DPAS_16(intel_sub_group_i8_i8_matrix_mad_k32, a, b);
+    }
+
+    int8 sum = acc0 + acc1 + acc2 + acc3;
+    output[get_global_id(0)] = (float)(sum.s0 + sum.s1 + sum.s2 + sum.s3 + sum.s4 + sum.s5 + sum.s6 + sum.s7);
+}
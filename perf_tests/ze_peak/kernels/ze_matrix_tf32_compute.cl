@@ -0,0 +1,35 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma OPENCL EXTENSION cl_intel_subgroup_matrix_multiply_accumulate_tf32 : enable
+
+#undef DPAS_4
+#undef DPAS_16
+
+// Four independent accumulator chains keep the systolic pipeline busy
+#define DPAS_4(fn, a, b)    acc0 = fn(a, b, acc0);  acc1 = fn(a, b, acc1);  acc2 = fn(a, b, acc2);  acc3 = fn(a, b, acc3);
+#define DPAS_16(fn, a, b)   DPAS_4(fn, a, b);       DPAS_4(fn, a, b);       DPAS_4(fn, a, b);       DPAS_4(fn, a, b);
+
+__attribute__((intel_reqd_sub_group_size(16)))
+__kernel void compute_tf32_dpas(__global int *input_value, __global float *output)
+{
+    float4 a = (float4)(as_float(input_value[0]));
+    float8 b = (float8)(as_float(input_value[0]));
+    float8 acc0 = 0;
+    float8 acc1 = 1;
+    float8 acc2 = 2;
+    float8 acc3 = 3;
+
+    for (int i = 0; i < 64; i++)
+    {
+        DPAS_16(intel_sub_group_tf32_tf32_matrix_mad_k8, a, b);
+    }
+
+    float8 sum = acc0 + acc1 + acc2 + acc3;
+    output[get_global_id(0)] = sum.s0 + sum.s1 + sum.s2 + sum.s3 + sum.s4 + sum.s5 + sum.s6 + sum.s7;
+}
@@ -0,0 +1,22 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Launched as a single work item: walks `hops` links of the ring, where
+// every element holds the index of the next one, from the index left in
+// position[0] by the launch before, so that every load waits on the one
+// before it.
+__kernel void pointer_chase(__global const uint *ring,
+                            __global uint *position, uint hops) {
+  uint id = position[0];
+
+  for (uint i = 0; i < hops; i++) {
+    id = ring[id];
+  }
+
+  position[0] = id;
+}
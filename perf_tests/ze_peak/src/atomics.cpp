@@ -0,0 +1,212 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+#include "../../common/include/common.hpp"
+
+static const char *atomic_ops[] = {"add", "cmpxchg", "min", "max"};
+static const char *atomic_spaces[] = {"global", "local"};
+
+struct AtomicType {
+  const char *name;
+  const char *module;
+  size_t size;
+};
+
+/* One module per type, as a module using int64 or float atomics does not
+ * build at all on devices without them */
+static const AtomicType atomic_types[] = {
+    {"int", "ze_atomics_int.spv", sizeof(uint32_t)},
+    {"long", "ze_atomics_long.spv", sizeof(uint64_t)},
+    {"float", "ze_atomics_float.spv", sizeof(float)}};
+
+//---------------------------------------------------------------------
+// Measures the throughput of relaxed atomic add, compare exchange, min
+// and max on int, long and float in global and local memory, each with
+// every work item on its own address and with all work items of a group
+// contending for one address. Types the device has no atomics for are
+// skipped.
+//---------------------------------------------------------------------
+void ZePeak::ze_peak_atomics(L0Context &context) {
+  long double timed, gops;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  struct ZeWorkGroups workgroup_info;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+
+  const uint32_t ops_per_wi = 64;
+
+  if (context.sub_device_count) {
+    std::cout << "atomics test skipping with explicit scaling\n";
+    return;
+  }
+
+  ze_float_atomic_ext_properties_t float_atomic_properties = {};
+  float_atomic_properties.stype = ZE_STRUCTURE_TYPE_FLOAT_ATOMIC_EXT_PROPERTIES;
+  ze_device_module_properties_t module_properties = {};
+  module_properties.stype = ZE_STRUCTURE_TYPE_DEVICE_MODULE_PROPERTIES;
+  module_properties.pNext = &float_atomic_properties;
+  result = zeDeviceGetModuleProperties(context.device, &module_properties);
+  if (result) {
+    throw std::runtime_error("zeDeviceGetModuleProperties failed: " +
+                             std::to_string(result));
+  }
+  const ze_device_fp_atomic_ext_flags_t float_flags =
+      ZE_DEVICE_FP_ATOMIC_EXT_FLAG_GLOBAL_ADD |
+      ZE_DEVICE_FP_ATOMIC_EXT_FLAG_GLOBAL_MIN_MAX |
+      ZE_DEVICE_FP_ATOMIC_EXT_FLAG_LOCAL_ADD |
+      ZE_DEVICE_FP_ATOMIC_EXT_FLAG_LOCAL_MIN_MAX;
+  const bool supported[] = {
+      true,
+      (module_properties.flags & ZE_DEVICE_MODULE_FLAG_INT64_ATOMICS) != 0,
+      (float_atomic_properties.fp32Flags & float_flags) == float_flags};
+
+  // The kernels pick the address of a work item with local id & mask,
+  // so every group gets a power of two number of slots.
+  const uint32_t group_size = context.device_compute_property.maxGroupSizeX;
+  uint32_t slots = 1;
+  while (slots < group_size) {
+    slots *= 2;
+  }
+  uint64_t group_count =
+      std::min(get_max_work_items(context) / group_size,
+               uint64_t(context.device_compute_property.maxGroupCountX));
+  group_count = std::max(group_count, uint64_t(1));
+  workgroup_info.group_size_x = group_size;
+  workgroup_info.group_size_y = 1;
+  workgroup_info.group_size_z = 1;
+  workgroup_info.thread_group_dimensions = {
+      static_cast<uint32_t>(group_count), 1, 1};
+  const uint64_t num_work_items = group_count * group_size;
+  const long double work =
+      static_cast<long double>(num_work_items) * ops_per_wi;
+  if (verbose)
+    std::cout << "Group size x: " << group_size
+              << "\nGroup count x: " << group_count << "\n";
+
+  void *atomicBuf;
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+
+  device_desc.pNext = nullptr;
+  device_desc.ordinal = 0;
+  device_desc.flags = 0;
+  const size_t buffer_size =
+      static_cast<size_t>(group_count * slots * sizeof(uint64_t));
+  result = zeMemAllocDevice(context.context, &device_desc, buffer_size, 1,
+                            context.device, &atomicBuf);
+  if (result) {
+    throw std::runtime_error("zeMemAllocDevice failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "atomicBuf device buffer allocated\n";
+
+  uint64_t pattern = 0;
+  result = zeCommandListAppendMemoryFill(context.command_list, atomicBuf,
+                                         &pattern, sizeof(pattern),
+                                         buffer_size, nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Atomic buffer fill encoded\n";
+
+  context.execute_commandlist_and_sync();
+
+  std::cout << "Atomic Throughput (GOPS)\n";
+
+  for (size_t t = 0; t < sizeof(atomic_types) / sizeof(atomic_types[0]);
+       t++) {
+    const AtomicType &atomic_type = atomic_types[t];
+    if (!supported[t]) {
+      std::cout << atomic_type.name
+                << " atomics skipping for missing support\n";
+      continue;
+    }
+
+    level_zero_tests::BinaryFile binary_file =
+        context.load_binary_file(atomic_type.module);
+
+    context.create_module(binary_file);
+
+    for (auto op : atomic_ops) {
+      for (auto space : atomic_spaces) {
+        const bool local = strcmp(space, "local") == 0;
+        const std::string name = std::string("atomic_") + op + "_" +
+                                 atomic_type.name + "_" + space;
+        const uint32_t masks[] = {slots - 1, 0};
+        uint32_t mask = masks[0];
+        const size_t local_size = size_t(slots) * atomic_type.size;
+
+        ze_kernel_handle_t function;
+        if (local) {
+          setup_function(context, function, name.c_str(), atomicBuf, nullptr,
+                         local_size);
+        } else {
+          setup_function(context, function, name.c_str(), atomicBuf, &mask,
+                         sizeof(mask));
+        }
+        const uint32_t mask_arg = local ? 2 : 1;
+        result = zeKernelSetArgumentValue(function, mask_arg + 1,
+                                          sizeof(ops_per_wi), &ops_per_wi);
+        if (result) {
+          throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                                   std::to_string(result));
+        }
+
+        for (auto contention_mask : masks) {
+          result = zeKernelSetArgumentValue(function, mask_arg,
+                                            sizeof(contention_mask),
+                                            &contention_mask);
+          if (result) {
+            throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                                     std::to_string(result));
+          }
+
+          std::string variant =
+              std::string(atomic_type.name) + " " + op + " " + space;
+          if (contention_mask == 0) {
+            variant += " contended";
+          }
+          std::cout << variant << " : ";
+          timed = run_kernel(context, function, workgroup_info, type);
+          gops = calculate_gbps(timed, work);
+          std::cout << gops << " GOPS"
+                    << device_rate(last_device_time, work, "GOPS") << "\n";
+          record_result("atomics", variant, "GOPS", gops);
+        }
+
+        result = zeKernelDestroy(function);
+        if (result) {
+          throw std::runtime_error("zeKernelDestroy failed: " +
+                                   std::to_string(result));
+        }
+        if (verbose)
+          std::cout << name << " Function Destroyed\n";
+      }
+    }
+
+    result = zeModuleDestroy(context.module);
+    if (result) {
+      throw std::runtime_error("zeModuleDestroy failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << "Module destroyed\n";
+  }
+
+  result = zeMemFree(context.context, atomicBuf);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Atomic Buffer freed\n";
+
+  print_test_complete();
+}
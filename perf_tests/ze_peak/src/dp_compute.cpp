@@ -14,7 +14,7 @@ void ZePeak::ze_peak_dp_compute(L0Context &context) {
 std::vector<long double> ZePeak::ze_peak_dp_compute(L0Context &context) {
   std::vector<long double> gflops_list;
 #endif
-  long double gflops, timed;
+  long double gflops, timed, device_timed;
   ze_result_t result = ZE_RESULT_SUCCESS;
   TimingMeasurement type = is_bandwidth_with_event_timer();
   size_t flops_per_work_item = 4096;
@@ -35,7 +35,7 @@ std::vector<long double> ZePeak::ze_peak_dp_compute(L0Context &context) {
 #endif
   }
 
-  std::vector<uint8_t> binary_file =
+  level_zero_tests::BinaryFile binary_file =
       context.load_binary_file("ze_dp_compute.spv");
 
   context.create_module(binary_file);
@@ -223,115 +223,220 @@ std::vector<long double> ZePeak::ze_peak_dp_compute(L0Context &context) {
   std::cout << "Double Precision Compute (GFLOPS)\n";
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 1
   std::cout << "double : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, dp_v1[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, dp_v1, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, dp_v1[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_dp_v1, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
   std::cout << "double2 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, dp_v2[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, dp_v2, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, dp_v2[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double2", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_dp_v2, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double2", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
   std::cout << "double4 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, dp_v4[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, dp_v4, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, dp_v4[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double4", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_dp_v4, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double4", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
   std::cout << "double8 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, dp_v8[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, dp_v8, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, dp_v8[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double8", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_dp_v8, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double8", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
   std::cout << "double16 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, dp_v16[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, dp_v16, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, dp_v16[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double16", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_dp_v16, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("dp_compute", "double16", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
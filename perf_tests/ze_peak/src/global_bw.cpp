@@ -11,12 +11,15 @@
 
 void ZePeak::ze_peak_global_bw(L0Context &context) {
   long double timed_lo, timed_go, timed, gbps;
+  long double device_lo, device_go, device_timed;
+  std::vector<long double> tile_times_lo, tile_times_go;
+  std::vector<long double> samples_lo;
   ze_result_t result = ZE_RESULT_SUCCESS;
   uint64_t temp_global_size, max_total_work_items;
   struct ZeWorkGroups workgroup_info;
   TimingMeasurement type = is_bandwidth_with_event_timer();
 
-  std::vector<uint8_t> binary_file =
+  level_zero_tests::BinaryFile binary_file =
       context.load_binary_file("ze_global_bw.spv");
 
   context.create_module(binary_file);
@@ -269,6 +272,8 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
   timed = 0;
   timed_lo = 0;
   timed_go = 0;
+  device_lo = 0;
+  device_go = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 1
   std::cout << "float : ";
@@ -282,33 +287,72 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
       set_workgroups(context, temp_global_size, &workgroup_info);
 
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed_lo += run_kernel(context, lo_offset_v1[i], workgroup_info, type);
-      i++;
-    }
-    i = 0;
-    for (auto device : context.sub_devices) {
-      timed_go += run_kernel(context, gl_offset_v1[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed_lo = run_kernel_concurrent(context, lo_offset_v1, workgroup_info);
+      tile_times_lo = last_tile_times;
+      timed_go = run_kernel_concurrent(context, gl_offset_v1, workgroup_info);
+      tile_times_go = last_tile_times;
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed_lo += run_kernel(context, lo_offset_v1[i], workgroup_info, type);
+        device_lo += last_device_time;
+        i++;
+      }
+      samples_lo.swap(iteration_times);
+      i = 0;
+      for (auto device : context.sub_devices) {
+        timed_go += run_kernel(context, gl_offset_v1[i], workgroup_info, type);
+        device_go += last_device_time;
+        i++;
+      }
     }
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
+    last_tile_times = (timed_lo < timed_go) ? tile_times_lo : tile_times_go;
+    last_concurrent_time = timed;
     gbps = calculate_gbps(timed,
                           numItems * context.sub_device_count * sizeof(float));
-    std::cout << gbps << " GFLOPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed,
+                             numItems * context.sub_device_count *
+                                 sizeof(float),
+                             "GBPS")
+              << tile_rates((timed_lo < timed_go) ? tile_times_lo
+                                                  : tile_times_go,
+                            numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float", "GBPS", gbps);
   } else {
     timed_lo = run_kernel(context, local_offset_v1, workgroup_info, type);
+    device_lo = last_device_time;
+    samples_lo.swap(iteration_times);
     timed_go = run_kernel(context, global_offset_v1, workgroup_info, type);
+    device_go = last_device_time;
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
 
     gbps = calculate_gbps(timed, numItems * sizeof(float));
 
-    std::cout << gbps << " GBPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed, numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float", "GBPS", gbps);
   }
 
   timed = 0;
   timed_lo = 0;
   timed_go = 0;
+  device_lo = 0;
+  device_go = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
   std::cout << "float2 : ";
@@ -319,33 +363,72 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
       set_workgroups(context, temp_global_size, &workgroup_info);
 
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed_lo += run_kernel(context, lo_offset_v2[i], workgroup_info, type);
-      i++;
-    }
-    i = 0;
-    for (auto device : context.sub_devices) {
-      timed_go += run_kernel(context, gl_offset_v2[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed_lo = run_kernel_concurrent(context, lo_offset_v2, workgroup_info);
+      tile_times_lo = last_tile_times;
+      timed_go = run_kernel_concurrent(context, gl_offset_v2, workgroup_info);
+      tile_times_go = last_tile_times;
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed_lo += run_kernel(context, lo_offset_v2[i], workgroup_info, type);
+        device_lo += last_device_time;
+        i++;
+      }
+      samples_lo.swap(iteration_times);
+      i = 0;
+      for (auto device : context.sub_devices) {
+        timed_go += run_kernel(context, gl_offset_v2[i], workgroup_info, type);
+        device_go += last_device_time;
+        i++;
+      }
     }
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
+    last_tile_times = (timed_lo < timed_go) ? tile_times_lo : tile_times_go;
+    last_concurrent_time = timed;
     gbps = calculate_gbps(timed,
                           numItems * context.sub_device_count * sizeof(float));
-    std::cout << gbps << " GFLOPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed,
+                             numItems * context.sub_device_count *
+                                 sizeof(float),
+                             "GBPS")
+              << tile_rates((timed_lo < timed_go) ? tile_times_lo
+                                                  : tile_times_go,
+                            numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float2", "GBPS", gbps);
   } else {
     timed_lo = run_kernel(context, local_offset_v2, workgroup_info, type);
+    device_lo = last_device_time;
+    samples_lo.swap(iteration_times);
     timed_go = run_kernel(context, global_offset_v2, workgroup_info, type);
+    device_go = last_device_time;
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
 
     gbps = calculate_gbps(timed, numItems * sizeof(float));
 
-    std::cout << gbps << " GBPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed, numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float2", "GBPS", gbps);
   }
 
   timed = 0;
   timed_lo = 0;
   timed_go = 0;
+  device_lo = 0;
+  device_go = 0;
 
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
@@ -357,33 +440,72 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
       set_workgroups(context, temp_global_size, &workgroup_info);
 
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed_lo += run_kernel(context, lo_offset_v4[i], workgroup_info, type);
-      i++;
-    }
-    i = 0;
-    for (auto device : context.sub_devices) {
-      timed_go += run_kernel(context, gl_offset_v4[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed_lo = run_kernel_concurrent(context, lo_offset_v4, workgroup_info);
+      tile_times_lo = last_tile_times;
+      timed_go = run_kernel_concurrent(context, gl_offset_v4, workgroup_info);
+      tile_times_go = last_tile_times;
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed_lo += run_kernel(context, lo_offset_v4[i], workgroup_info, type);
+        device_lo += last_device_time;
+        i++;
+      }
+      samples_lo.swap(iteration_times);
+      i = 0;
+      for (auto device : context.sub_devices) {
+        timed_go += run_kernel(context, gl_offset_v4[i], workgroup_info, type);
+        device_go += last_device_time;
+        i++;
+      }
     }
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
+    last_tile_times = (timed_lo < timed_go) ? tile_times_lo : tile_times_go;
+    last_concurrent_time = timed;
     gbps = calculate_gbps(timed,
                           numItems * context.sub_device_count * sizeof(float));
-    std::cout << gbps << " GFLOPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed,
+                             numItems * context.sub_device_count *
+                                 sizeof(float),
+                             "GBPS")
+              << tile_rates((timed_lo < timed_go) ? tile_times_lo
+                                                  : tile_times_go,
+                            numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float4", "GBPS", gbps);
   } else {
     timed_lo = run_kernel(context, local_offset_v4, workgroup_info, type);
+    device_lo = last_device_time;
+    samples_lo.swap(iteration_times);
     timed_go = run_kernel(context, global_offset_v4, workgroup_info, type);
+    device_go = last_device_time;
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
 
     gbps = calculate_gbps(timed, numItems * sizeof(float));
 
-    std::cout << gbps << " GBPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed, numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float4", "GBPS", gbps);
   }
 
   timed = 0;
   timed_lo = 0;
   timed_go = 0;
+  device_lo = 0;
+  device_go = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
   std::cout << "float8 : ";
@@ -394,33 +516,72 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
       set_workgroups(context, temp_global_size, &workgroup_info);
 
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed_lo += run_kernel(context, lo_offset_v8[i], workgroup_info, type);
-      i++;
-    }
-    i = 0;
-    for (auto device : context.sub_devices) {
-      timed_go += run_kernel(context, gl_offset_v8[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed_lo = run_kernel_concurrent(context, lo_offset_v8, workgroup_info);
+      tile_times_lo = last_tile_times;
+      timed_go = run_kernel_concurrent(context, gl_offset_v8, workgroup_info);
+      tile_times_go = last_tile_times;
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed_lo += run_kernel(context, lo_offset_v8[i], workgroup_info, type);
+        device_lo += last_device_time;
+        i++;
+      }
+      samples_lo.swap(iteration_times);
+      i = 0;
+      for (auto device : context.sub_devices) {
+        timed_go += run_kernel(context, gl_offset_v8[i], workgroup_info, type);
+        device_go += last_device_time;
+        i++;
+      }
     }
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
+    last_tile_times = (timed_lo < timed_go) ? tile_times_lo : tile_times_go;
+    last_concurrent_time = timed;
     gbps = calculate_gbps(timed,
                           numItems * context.sub_device_count * sizeof(float));
-    std::cout << gbps << " GFLOPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed,
+                             numItems * context.sub_device_count *
+                                 sizeof(float),
+                             "GBPS")
+              << tile_rates((timed_lo < timed_go) ? tile_times_lo
+                                                  : tile_times_go,
+                            numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float8", "GBPS", gbps);
   } else {
     timed_lo = run_kernel(context, local_offset_v8, workgroup_info, type);
+    device_lo = last_device_time;
+    samples_lo.swap(iteration_times);
     timed_go = run_kernel(context, global_offset_v8, workgroup_info, type);
+    device_go = last_device_time;
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
 
     gbps = calculate_gbps(timed, numItems * sizeof(float));
 
-    std::cout << gbps << " GBPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed, numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float8", "GBPS", gbps);
   }
 
   timed = 0;
   timed_lo = 0;
   timed_go = 0;
+  device_lo = 0;
+  device_go = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
   std::cout << "float16 : ";
@@ -430,28 +591,73 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
       set_workgroups(context, temp_global_size, &workgroup_info);
 
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed_lo += run_kernel(context, lo_offset_v16[i], workgroup_info, type);
-      i++;
-    }
-    i = 0;
-    for (auto device : context.sub_devices) {
-      timed_go += run_kernel(context, gl_offset_v16[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed_lo = run_kernel_concurrent(context, lo_offset_v16, workgroup_info);
+      tile_times_lo = last_tile_times;
+      timed_go = run_kernel_concurrent(context, gl_offset_v16, workgroup_info);
+      tile_times_go = last_tile_times;
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed_lo += run_kernel(context, lo_offset_v16[i], workgroup_info, type);
+        device_lo += last_device_time;
+        i++;
+      }
+      samples_lo.swap(iteration_times);
+      i = 0;
+      for (auto device : context.sub_devices) {
+        timed_go += run_kernel(context, gl_offset_v16[i], workgroup_info, type);
+        device_go += last_device_time;
+        i++;
+      }
     }
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
+    last_tile_times = (timed_lo < timed_go) ? tile_times_lo : tile_times_go;
+    last_concurrent_time = timed;
     gbps = calculate_gbps(timed,
                           numItems * context.sub_device_count * sizeof(float));
-    std::cout << gbps << " GFLOPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed,
+                             numItems * context.sub_device_count *
+                                 sizeof(float),
+                             "GBPS")
+              << tile_rates((timed_lo < timed_go) ? tile_times_lo
+                                                  : tile_times_go,
+                            numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float16", "GBPS", gbps);
   } else {
     timed_lo = run_kernel(context, local_offset_v16, workgroup_info, type);
+    device_lo = last_device_time;
+    samples_lo.swap(iteration_times);
     timed_go = run_kernel(context, global_offset_v16, workgroup_info, type);
+    device_go = last_device_time;
     timed = (timed_lo < timed_go) ? timed_lo : timed_go;
+    device_timed = (device_lo < device_go) ? device_lo : device_go;
+    if (timed_lo < timed_go) {
+      iteration_times.swap(samples_lo);
+    }
+    samples_lo.clear();
 
     gbps = calculate_gbps(timed, numItems * sizeof(float));
 
-    std::cout << gbps << " GBPS\n";
+    std::cout << gbps << " GBPS"
+              << device_rate(device_timed, numItems * sizeof(float), "GBPS")
+              << "\n";
+    record_result("global_bw", "float16", "GBPS", gbps);
+  }
+
+  if (context.sub_device_count) {
+    _global_bw_stream(context, dev_in_val, dev_out_val, numItems);
+  } else {
+    std::vector<void *> in_val = {inputBuf};
+    std::vector<void *> out_val = {outputBuf};
+    _global_bw_stream(context, in_val, out_val, numItems);
   }
 
   if (context.sub_device_count) {
@@ -686,3 +892,172 @@ void ZePeak::ze_peak_global_bw(L0Context &context) {
 
   print_test_complete();
 }
+
+//---------------------------------------------------------------------
+// Runs the STREAM style write, copy and triad kernels for every vector
+// width on the buffers allocated by ze_peak_global_bw and prints the rows
+// into the same bandwidth table. numItems is the float count of each
+// buffer, per sub device with explicit scaling.
+//---------------------------------------------------------------------
+void ZePeak::_global_bw_stream(L0Context &context, std::vector<void *> &input,
+                               std::vector<void *> &output,
+                               uint64_t numItems) {
+  long double timed, gbps;
+  long double device_timed;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  struct ZeWorkGroups workgroup_info;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  uint32_t device_count = context.sub_device_count ? context.sub_device_count
+                                                   : 1;
+  float scalar = 3.0f;
+
+  const char *families[] = {"write", "copy", "triad"};
+  /* Global memory accesses per element of each family */
+  const uint32_t accesses[] = {1, 2, 3};
+  const uint32_t widths[] = {1, 2, 4, 8, 16};
+  const char *types[] = {"float", "float2", "float4", "float8", "float16"};
+
+  ze_module_handle_t read_module = context.module;
+  std::vector<ze_module_handle_t> read_subdevice_module =
+      context.subdevice_module;
+
+  level_zero_tests::BinaryFile binary_file =
+      context.load_binary_file("ze_global_bw_stream.spv");
+
+  context.create_module(binary_file);
+
+  std::vector<void *> scratch(device_count);
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+
+  device_desc.pNext = nullptr;
+  device_desc.ordinal = 0;
+  device_desc.flags = 0;
+  for (uint32_t i = 0; i < device_count; i++) {
+    result = zeMemAllocDevice(
+        context.context, &device_desc,
+        static_cast<size_t>((numItems * sizeof(float))), 1,
+        context.sub_device_count ? context.sub_devices[i] : context.device,
+        &scratch[i]);
+    if (result) {
+      throw std::runtime_error("zeMemAllocDevice failed: " +
+                               std::to_string(result));
+    }
+  }
+  if (verbose)
+    std::cout << "scratch device buffer allocated\n";
+
+  for (uint32_t f = 0; f < 3; f++) {
+    for (uint32_t w = 0; w < 5; w++) {
+      std::string name = std::string("global_bandwidth_") + families[f] +
+                         "_v" + std::to_string(widths[w]);
+      std::vector<ze_kernel_handle_t> functions(device_count);
+
+      // write : scratch = s
+      // copy  : output = input
+      // triad : output = input + s * scratch
+      for (uint32_t i = 0; i < device_count; i++) {
+        if (f == 0) {
+          setup_function(context, functions[i], name.c_str(), scratch[i],
+                         &scalar, sizeof(scalar));
+        } else if (f == 1) {
+          setup_function(context, functions[i], name.c_str(), input[i],
+                         output[i]);
+        } else {
+          setup_function(context, functions[i], name.c_str(), output[i],
+                         input[i]);
+          result = zeKernelSetArgumentValue(functions[i], 2, sizeof(void *),
+                                            &scratch[i]);
+          if (result) {
+            throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                                     std::to_string(result));
+          }
+          result = zeKernelSetArgumentValue(functions[i], 3, sizeof(scalar),
+                                            &scalar);
+          if (result) {
+            throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                                     std::to_string(result));
+          }
+        }
+      }
+
+      uint64_t work_items =
+          set_workgroups(context, numItems / widths[w], &workgroup_info);
+      long double work = static_cast<long double>(work_items) * widths[w] *
+                         sizeof(float) * accesses[f];
+
+      std::cout << families[f] << " " << types[w] << " : ";
+
+      timed = 0;
+      device_timed = 0;
+      if (context.sub_device_count) {
+        if (concurrent_sub_devices) {
+          timed = run_kernel_concurrent(context, functions, workgroup_info);
+        } else {
+          current_sub_device_id = 0;
+          for (auto function : functions) {
+            timed += run_kernel(context, function, workgroup_info, type);
+            device_timed += last_device_time;
+            current_sub_device_id++;
+          }
+          current_sub_device_id = 0;
+        }
+        gbps = calculate_gbps(timed, work * context.sub_device_count);
+        std::cout << gbps << " GBPS"
+                  << device_rate(device_timed, work * context.sub_device_count,
+                                 "GBPS")
+                  << tile_rates(last_tile_times, work, "GBPS") << "\n";
+        record_result("global_bw", std::string(families[f]) + " " + types[w],
+                      "GBPS", gbps);
+      } else {
+        timed = run_kernel(context, functions[0], workgroup_info, type);
+        device_timed = last_device_time;
+        gbps = calculate_gbps(timed, work);
+        std::cout << gbps << " GBPS"
+                  << device_rate(device_timed, work, "GBPS") << "\n";
+        record_result("global_bw", std::string(families[f]) + " " + types[w],
+                      "GBPS", gbps);
+      }
+
+      for (auto function : functions) {
+        result = zeKernelDestroy(function);
+        if (result) {
+          throw std::runtime_error("zeKernelDestroy failed: " +
+                                   std::to_string(result));
+        }
+      }
+      if (verbose)
+        std::cout << name << " Function Destroyed\n";
+    }
+  }
+
+  for (auto scratch_buf : scratch) {
+    result = zeMemFree(context.context, scratch_buf);
+    if (result) {
+      throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+    }
+  }
+  if (verbose)
+    std::cout << "scratch Buffer freed\n";
+
+  if (context.sub_device_count) {
+    for (auto module : context.subdevice_module) {
+      result = zeModuleDestroy(module);
+      if (result) {
+        throw std::runtime_error("zeModuleDestroy failed: " +
+                                 std::to_string(result));
+      }
+    }
+  } else {
+    result = zeModuleDestroy(context.module);
+    if (result) {
+      throw std::runtime_error("zeModuleDestroy failed: " +
+                               std::to_string(result));
+    }
+  }
+  if (verbose)
+    std::cout << "stream Module destroyed\n";
+
+  context.module = read_module;
+  context.subdevice_module = read_subdevice_module;
+}
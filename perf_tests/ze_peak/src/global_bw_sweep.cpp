@@ -0,0 +1,204 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+#include "../../common/include/common.hpp"
+
+#include <iomanip>
+
+//---------------------------------------------------------------------
+// Measures read bandwidth against a working set that doubles from 4KB
+// up to the largest allocation, so the GBPS curve steps down as the
+// footprint spills out of each cache level. Every footprint is read
+// with a unit stride, a cache line (64B) stride and a page (4KB) stride.
+//---------------------------------------------------------------------
+void ZePeak::ze_peak_global_bw_sweep(L0Context &context) {
+  long double timed, gbps;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  struct ZeWorkGroups workgroup_info;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+
+  const uint32_t strides[] = {1, 16, 1024};
+  const uint32_t reads_per_wi = 64;
+  const uint64_t min_footprint = 4096;
+
+  if (context.sub_device_count) {
+    std::cout << "global_bw_sweep test skipping with explicit scaling\n";
+    return;
+  }
+
+  level_zero_tests::BinaryFile binary_file =
+      context.load_binary_file("ze_global_bw_sweep.spv");
+
+  context.create_module(binary_file);
+
+  uint64_t max_footprint = min_footprint;
+  uint64_t max_alloc = std::min(context.device_property.maxMemAllocSize,
+                                uint64_t(global_bw_max_size) * sizeof(float));
+  while (max_footprint * 2 <= max_alloc) {
+    max_footprint *= 2;
+  }
+
+  // Keep all work items in dimension x, the kernel indexes with
+  // get_global_id(0) and get_global_size(0) only.
+  uint64_t num_work_items =
+      uint64_t(context.device_compute_property.maxGroupSizeX) *
+      std::min(uint64_t(1024),
+               uint64_t(context.device_compute_property.maxGroupCountX));
+  num_work_items = set_workgroups(context, num_work_items, &workgroup_info);
+
+  void *inputBuf;
+  ze_device_mem_alloc_desc_t in_device_desc = {};
+  in_device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+
+  in_device_desc.pNext = nullptr;
+  in_device_desc.ordinal = 0;
+  in_device_desc.flags = 0;
+  result = zeMemAllocDevice(context.context, &in_device_desc,
+                            static_cast<size_t>(max_footprint), 1,
+                            context.device, &inputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemAllocDevice failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "inputBuf device buffer allocated\n";
+
+  void *outputBuf;
+  ze_device_mem_alloc_desc_t out_device_desc = {};
+  out_device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+
+  out_device_desc.pNext = nullptr;
+  out_device_desc.ordinal = 0;
+  out_device_desc.flags = 0;
+  result = zeMemAllocDevice(context.context, &out_device_desc,
+                            static_cast<size_t>(num_work_items * sizeof(float)),
+                            1, context.device, &outputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemAllocDevice failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "outputBuf device buffer allocated\n";
+
+  float pattern = 1.0f;
+  result = zeCommandListAppendMemoryFill(
+      context.command_list, inputBuf, &pattern, sizeof(pattern),
+      static_cast<size_t>(max_footprint), nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input buffer fill encoded\n";
+
+  result =
+      zeCommandListAppendBarrier(context.command_list, nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Execution barrier appended\n";
+
+  context.execute_commandlist_and_sync();
+
+  ze_kernel_handle_t sweep_function;
+  setup_function(context, sweep_function, "global_bandwidth_sweep", inputBuf,
+                 outputBuf);
+
+  result = zeKernelSetArgumentValue(sweep_function, 4, sizeof(reads_per_wi),
+                                    &reads_per_wi);
+  if (result) {
+    throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                             std::to_string(result));
+  }
+
+  std::cout << "Global memory bandwidth sweep (GBPS)\n";
+  std::cout << std::setw(12) << "footprint" << std::setw(14) << "stride 4B"
+            << std::setw(14) << "stride 64B" << std::setw(14) << "stride 4KB"
+            << "\n";
+
+  long double work = static_cast<long double>(num_work_items) *
+                     reads_per_wi * sizeof(float);
+  /* power per cell would break the table, it is in --json / --csv only */
+  print_power = false;
+
+  for (uint64_t footprint = min_footprint; footprint <= max_footprint;
+       footprint *= 2) {
+    uint32_t mask = static_cast<uint32_t>(footprint / sizeof(float) - 1);
+    result = zeKernelSetArgumentValue(sweep_function, 2, sizeof(mask), &mask);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+
+    if (footprint >= (1 << 20)) {
+      std::cout << std::setw(10) << (footprint >> 20) << "MB";
+    } else {
+      std::cout << std::setw(10) << (footprint >> 10) << "KB";
+    }
+
+    for (auto stride : strides) {
+      if (footprint < stride * sizeof(float)) {
+        std::cout << std::setw(14) << "-";
+        continue;
+      }
+
+      result = zeKernelSetArgumentValue(sweep_function, 3, sizeof(stride),
+                                        &stride);
+      if (result) {
+        throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                                 std::to_string(result));
+      }
+
+      timed = run_kernel(context, sweep_function, workgroup_info, type);
+      gbps = calculate_gbps(timed, work);
+      std::cout << std::setw(14) << gbps
+                << device_rate(last_device_time, work, "GBPS");
+      record_result("global_bw_sweep",
+                    std::to_string(footprint) + "B stride " +
+                        std::to_string(stride * sizeof(float)) + "B",
+                    "GBPS", gbps);
+    }
+    std::cout << "\n";
+  }
+  print_power = true;
+
+  result = zeKernelDestroy(sweep_function);
+  if (result) {
+    throw std::runtime_error("zeKernelDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "global_bandwidth_sweep Function Destroyed\n";
+
+  result = zeMemFree(context.context, inputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input Buffer freed\n";
+
+  result = zeMemFree(context.context, outputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Output Buffer freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
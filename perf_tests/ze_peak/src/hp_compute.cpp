@@ -14,14 +14,14 @@
 #define cl_half uint16_t
 
 void ZePeak::ze_peak_hp_compute(L0Context &context) {
-  long double gflops, timed;
+  long double gflops, timed, device_timed;
   ze_result_t result = ZE_RESULT_SUCCESS;
   TimingMeasurement type = is_bandwidth_with_event_timer();
   size_t flops_per_work_item = 4096;
   struct ZeWorkGroups workgroup_info;
   float input_value = 1.3f;
 
-  std::vector<uint8_t> binary_file =
+  level_zero_tests::BinaryFile binary_file =
       context.load_binary_file("ze_hp_compute.spv");
 
   context.create_module(binary_file);
@@ -130,106 +130,211 @@ void ZePeak::ze_peak_hp_compute(L0Context &context) {
   std::cout << "Half Precision Compute (GFLOPS)\n";
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 1
   std::cout << "half : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, hp_v1[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, hp_v1, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, hp_v1[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_hp_v1, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half", "GFLOPS", gflops);
   }
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
   std::cout << "half2 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, hp_v2[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, hp_v2, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, hp_v2[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half2", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_hp_v2, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half2", "GFLOPS", gflops);
   }
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
   std::cout << "half4 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, hp_v4[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, hp_v4, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, hp_v4[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half4", "GFLOPS", gflops);
   } else {
 
     timed = run_kernel(context, compute_hp_v4, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half4", "GFLOPS", gflops);
   }
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
   std::cout << "half8 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, hp_v8[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, hp_v8, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, hp_v8[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half8", "GFLOPS", gflops);
   } else {
 
     timed = run_kernel(context, compute_hp_v8, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half8", "GFLOPS", gflops);
   }
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
   std::cout << "half16 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, hp_v16[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, hp_v16, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, hp_v16[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half16", "GFLOPS", gflops);
   } else {
 
     timed = run_kernel(context, compute_hp_v16, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("hp_compute", "half16", "GFLOPS", gflops);
   }
 
   if (context.sub_device_count) {
@@ -14,14 +14,14 @@ void ZePeak::ze_peak_int_compute(L0Context &context) {
 std::vector<long double> ZePeak::ze_peak_int_compute(L0Context &context) {
   std::vector<long double> gflops_list;
 #endif
-  long double gflops, timed;
+  long double gflops, timed, device_timed;
   ze_result_t result = ZE_RESULT_SUCCESS;
   TimingMeasurement type = is_bandwidth_with_event_timer();
   size_t flops_per_work_item = 2048;
   struct ZeWorkGroups workgroup_info;
   int input_value = 4;
 
-  std::vector<uint8_t> binary_file =
+  level_zero_tests::BinaryFile binary_file =
       context.load_binary_file("ze_int_compute.spv");
 
   context.create_module(binary_file);
@@ -209,115 +209,220 @@ std::vector<long double> ZePeak::ze_peak_int_compute(L0Context &context) {
   std::cout << "Integer Compute (GFLOPS)\n";
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 1
   std::cout << "int : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, compute_v1[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, compute_v1, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, compute_v1[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_int_v1, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 2
   std::cout << "int2 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, compute_v2[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, compute_v2, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, compute_v2[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int2", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_int_v2, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int2", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 4
   std::cout << "int4 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, compute_v4[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, compute_v4, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, compute_v4[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int4", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_int_v4, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int4", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 8
   std::cout << "int8 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, compute_v8[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, compute_v8, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, compute_v8[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int8", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_int_v8, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int8", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
 #endif
 
   timed = 0;
+  device_timed = 0;
   ///////////////////////////////////////////////////////////////////////////
   // Vector width 16
   std::cout << "int16 : ";
   if (context.sub_device_count) {
-    uint32_t i = 0;
-    for (auto device : context.sub_devices) {
-      timed += run_kernel(context, compute_v16[i], workgroup_info, type);
-      i++;
+    if (concurrent_sub_devices) {
+      timed = run_kernel_concurrent(context, compute_v16, workgroup_info);
+    } else {
+      uint32_t i = 0;
+      for (auto device : context.sub_devices) {
+        timed += run_kernel(context, compute_v16[i], workgroup_info, type);
+        device_timed += last_device_time;
+        i++;
+      }
     }
     gflops =
         calculate_gbps(timed, number_of_work_items * context.sub_device_count *
                                   flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * context.sub_device_count *
+                                 flops_per_work_item,
+                             "GFLOPS")
+              << tile_rates(last_tile_times,
+                            number_of_work_items * flops_per_work_item,
+                            "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int16", "GFLOPS", gflops);
   } else {
     timed = run_kernel(context, compute_int_v16, workgroup_info, type);
+    device_timed = last_device_time;
     gflops = calculate_gbps(timed, number_of_work_items * flops_per_work_item);
-    std::cout << gflops << " GFLOPS\n";
+    std::cout << gflops << " GFLOPS"
+              << device_rate(device_timed,
+                             number_of_work_items * flops_per_work_item,
+                             "GFLOPS")
+              << "\n";
+    record_result("int_compute", "int16", "GFLOPS", gflops);
   }
 #ifdef EXCLUDE_MAIN
   gflops_list.push_back(gflops);
@@ -8,6 +8,11 @@
 
 #include "../include/ze_peak.h"
 
+static void append_samples(std::vector<long double> &samples,
+                           const std::vector<long double> &new_samples) {
+  samples.insert(samples.end(), new_samples.begin(), new_samples.end());
+}
+
 void ZePeak::ze_peak_kernel_latency(L0Context &context) {
   uint64_t num_items = get_max_work_items(context) * FETCH_PER_WI;
   uint64_t global_size = (num_items / FETCH_PER_WI);
@@ -27,9 +32,11 @@ void ZePeak::ze_peak_kernel_latency(L0Context &context) {
   }
 
   long double latency = 0;
+  std::vector<long double> host_calls, submit_to_start, start_to_end;
+  std::vector<long double> host_append, doorbell_to_start, end_to_wakeup;
   ze_result_t result = ZE_RESULT_SUCCESS;
 
-  std::vector<uint8_t> binary_file =
+  level_zero_tests::BinaryFile binary_file =
       context.load_binary_file("ze_global_bw.spv");
 
   context.create_module(binary_file);
@@ -119,6 +126,12 @@ void ZePeak::ze_peak_kernel_latency(L0Context &context) {
   }
 
   latency = 0;
+  host_calls.clear();
+  submit_to_start.clear();
+  start_to_end.clear();
+  host_append.clear();
+  doorbell_to_start.clear();
+  end_to_wakeup.clear();
   ///////////////////////////////////////////////////////////////////////////
   std::cout << "Kernel launch latency : ";
   if (context.sub_device_count) {
@@ -126,16 +139,46 @@ void ZePeak::ze_peak_kernel_latency(L0Context &context) {
     for (auto device : context.sub_devices) {
       latency += run_kernel(context, compute_local_offset_v1[i], workgroup_info,
                             TimingMeasurement::KERNEL_LAUNCH_LATENCY, true);
+      append_samples(host_calls, host_call_samples);
+      append_samples(submit_to_start, submit_to_start_samples);
+      append_samples(start_to_end, start_to_end_samples);
+      append_samples(host_append, host_append_samples);
+      append_samples(doorbell_to_start, doorbell_to_start_samples);
+      append_samples(end_to_wakeup, end_to_wakeup_samples);
       i++;
     }
     std::cout << latency << " (us)\n";
   } else {
     latency = run_kernel(context, local_offset_v1, workgroup_info,
                          TimingMeasurement::KERNEL_LAUNCH_LATENCY, true);
+    append_samples(host_calls, host_call_samples);
+    append_samples(submit_to_start, submit_to_start_samples);
+    append_samples(start_to_end, start_to_end_samples);
+    append_samples(host_append, host_append_samples);
+    append_samples(doorbell_to_start, doorbell_to_start_samples);
+    append_samples(end_to_wakeup, end_to_wakeup_samples);
     std::cout << latency << " (us)\n";
   }
+  record_result("kernel_lat", "Kernel launch latency", "us", latency);
+  print_latency_breakdown("submit call", host_calls);
+  print_latency_breakdown("submit to start", submit_to_start);
+  print_latency_breakdown("start to end", start_to_end);
+
+  std::vector<std::pair<const char *, std::vector<long double>>> phases = {
+      {"host append", host_append},
+      {"submit call", host_calls},
+      {"doorbell to start", doorbell_to_start},
+      {"kernel runtime", start_to_end},
+      {"end to host wakeup", end_to_wakeup}};
+  print_dispatch_decomposition("Kernel launch latency", phases);
 
   latency = 0;
+  host_calls.clear();
+  submit_to_start.clear();
+  start_to_end.clear();
+  host_append.clear();
+  doorbell_to_start.clear();
+  end_to_wakeup.clear();
   ///////////////////////////////////////////////////////////////////////////
   std::cout << "Kernel launch latency with Immediate Command List : ";
   if (context.sub_device_count) {
@@ -144,6 +187,12 @@ void ZePeak::ze_peak_kernel_latency(L0Context &context) {
       latency +=
           run_kernel(context, compute_local_offset_v1[i], workgroup_info,
                      TimingMeasurement::IMMEDIATE_KERNEL_LAUNCH_LATENCY, true);
+      append_samples(host_calls, host_call_samples);
+      append_samples(submit_to_start, submit_to_start_samples);
+      append_samples(start_to_end, start_to_end_samples);
+      append_samples(host_append, host_append_samples);
+      append_samples(doorbell_to_start, doorbell_to_start_samples);
+      append_samples(end_to_wakeup, end_to_wakeup_samples);
       i++;
     }
     std::cout << latency << " (us)\n";
@@ -151,10 +200,35 @@ void ZePeak::ze_peak_kernel_latency(L0Context &context) {
     latency =
         run_kernel(context, local_offset_v1, workgroup_info,
                    TimingMeasurement::IMMEDIATE_KERNEL_LAUNCH_LATENCY, true);
+    append_samples(host_calls, host_call_samples);
+    append_samples(submit_to_start, submit_to_start_samples);
+    append_samples(start_to_end, start_to_end_samples);
+    append_samples(host_append, host_append_samples);
+    append_samples(doorbell_to_start, doorbell_to_start_samples);
+    append_samples(end_to_wakeup, end_to_wakeup_samples);
     std::cout << latency << " (us)\n";
   }
+  record_result("kernel_lat",
+                "Kernel launch latency with Immediate Command List", "us",
+                latency);
+  print_latency_breakdown("append call", host_calls);
+  print_latency_breakdown("submit to start", submit_to_start);
+  print_latency_breakdown("start to end", start_to_end);
+
+  phases = {{"append call", host_calls},
+            {"doorbell to start", doorbell_to_start},
+            {"kernel runtime", start_to_end},
+            {"end to host wakeup", end_to_wakeup}};
+  print_dispatch_decomposition(
+      "Kernel launch latency with Immediate Command List", phases);
 
   latency = 0;
+  host_calls.clear();
+  submit_to_start.clear();
+  start_to_end.clear();
+  host_append.clear();
+  doorbell_to_start.clear();
+  end_to_wakeup.clear();
   ///////////////////////////////////////////////////////////////////////////
   std::cout << "Kernel duration : ";
   if (context.sub_device_count) {
@@ -162,14 +236,18 @@ void ZePeak::ze_peak_kernel_latency(L0Context &context) {
     for (auto device : context.sub_devices) {
       latency += run_kernel(context, compute_local_offset_v1[i], workgroup_info,
                             TimingMeasurement::KERNEL_COMPLETE_RUNTIME, true);
+      append_samples(start_to_end, start_to_end_samples);
       i++;
     }
     std::cout << latency << " (us)\n";
   } else {
     latency = run_kernel(context, local_offset_v1, workgroup_info,
                          TimingMeasurement::KERNEL_COMPLETE_RUNTIME, false);
+    append_samples(start_to_end, start_to_end_samples);
     std::cout << latency << " (us)\n";
   }
+  record_result("kernel_lat", "Kernel duration", "us", latency);
+  print_latency_breakdown("start to end", start_to_end);
 
   if (context.sub_device_count) {
     for (auto kernel : compute_local_offset_v1) {
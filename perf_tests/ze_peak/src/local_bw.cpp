@@ -0,0 +1,254 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+#include "../../common/include/common.hpp"
+
+#include <iomanip>
+
+//---------------------------------------------------------------------
+// Measures shared local memory (SLM) read bandwidth with every work item
+// reading its group's local buffer at the float to float16 widths, then
+// the float kernel again with power of two strides between the work
+// items, so that the GBPS drop shows the cost of the bank conflicts.
+// Rates are given for the device and per EU.
+//---------------------------------------------------------------------
+void ZePeak::ze_peak_local_bw(L0Context &context) {
+  long double timed, gbps;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  struct ZeWorkGroups workgroup_info;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+
+  const uint32_t widths[] = {1, 2, 4, 8, 16};
+  const uint32_t strides[] = {1, 2, 4, 8, 16, 32};
+  const uint32_t max_width = 16;
+  const uint32_t reads_per_wi = 256;
+
+  if (context.sub_device_count) {
+    std::cout << "local_bw test skipping with explicit scaling\n";
+    return;
+  }
+
+  level_zero_tests::BinaryFile binary_file =
+      context.load_binary_file("ze_local_bw.spv");
+
+  context.create_module(binary_file);
+
+  const uint32_t eu_count = context.device_property.numSlices *
+                            context.device_property.numSubslicesPerSlice *
+                            context.device_property.numEUsPerSubslice;
+
+  // The kernels wrap around the local buffer with a mask, so the group
+  // size is a power of two whose float16 buffer fits in local memory.
+  const uint32_t max_group_size =
+      std::min(context.device_compute_property.maxGroupSizeX,
+               context.device_compute_property.maxSharedLocalMemory /
+                   static_cast<uint32_t>(max_width * sizeof(float)));
+  uint32_t group_size = 1;
+  while (group_size * 2 <= max_group_size) {
+    group_size *= 2;
+  }
+  const uint32_t mask = group_size - 1;
+
+  uint64_t group_count =
+      std::min(get_max_work_items(context) * 4 / group_size,
+               uint64_t(context.device_compute_property.maxGroupCountX));
+  group_count = std::max(group_count, uint64_t(1));
+  workgroup_info.group_size_x = group_size;
+  workgroup_info.group_size_y = 1;
+  workgroup_info.group_size_z = 1;
+  workgroup_info.thread_group_dimensions = {
+      static_cast<uint32_t>(group_count), 1, 1};
+  const uint64_t num_work_items = group_count * group_size;
+  if (verbose)
+    std::cout << "Group size x: " << group_size
+              << "\nGroup count x: " << group_count << "\n";
+
+  const size_t buffer_size =
+      static_cast<size_t>(num_work_items * max_width * sizeof(float));
+
+  void *inputBuf;
+  ze_device_mem_alloc_desc_t in_device_desc = {};
+  in_device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+
+  in_device_desc.pNext = nullptr;
+  in_device_desc.ordinal = 0;
+  in_device_desc.flags = 0;
+  result = zeMemAllocDevice(context.context, &in_device_desc, buffer_size, 1,
+                            context.device, &inputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemAllocDevice failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "inputBuf device buffer allocated\n";
+
+  void *outputBuf;
+  ze_device_mem_alloc_desc_t out_device_desc = {};
+  out_device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+
+  out_device_desc.pNext = nullptr;
+  out_device_desc.ordinal = 0;
+  out_device_desc.flags = 0;
+  result = zeMemAllocDevice(context.context, &out_device_desc, buffer_size, 1,
+                            context.device, &outputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemAllocDevice failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "outputBuf device buffer allocated\n";
+
+  float pattern = 1.0f;
+  result = zeCommandListAppendMemoryFill(context.command_list, inputBuf,
+                                         &pattern, sizeof(pattern),
+                                         buffer_size, nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input buffer fill encoded\n";
+
+  result =
+      zeCommandListAppendBarrier(context.command_list, nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Execution barrier appended\n";
+
+  context.execute_commandlist_and_sync();
+
+  std::vector<ze_kernel_handle_t> functions;
+  for (auto width : widths) {
+    ze_kernel_handle_t function;
+    const std::string name = "local_bandwidth_v" + std::to_string(width);
+    setup_function(context, function, name.c_str(), inputBuf, outputBuf);
+
+    const size_t local_size = size_t(group_size) * width * sizeof(float);
+    result = zeKernelSetArgumentValue(function, 2, local_size, nullptr);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    result = zeKernelSetArgumentValue(function, 3, sizeof(mask), &mask);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    result = zeKernelSetArgumentValue(function, 4, sizeof(strides[0]),
+                                      &strides[0]);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    result = zeKernelSetArgumentValue(function, 5, sizeof(reads_per_wi),
+                                      &reads_per_wi);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    functions.push_back(function);
+  }
+
+  std::cout << "Local memory bandwidth (GBPS)\n";
+  for (size_t w = 0; w < functions.size(); w++) {
+    const std::string variant =
+        widths[w] == 1 ? "float" : "float" + std::to_string(widths[w]);
+    long double work = static_cast<long double>(num_work_items) *
+                       reads_per_wi * widths[w] * sizeof(float);
+
+    std::cout << variant << " : ";
+    timed = run_kernel(context, functions[w], workgroup_info, type);
+    gbps = calculate_gbps(timed, work);
+    std::cout << gbps << " GBPS"
+              << device_rate(last_device_time, work, "GBPS");
+    if (eu_count) {
+      std::cout << " (per EU: " << gbps / eu_count << " GBPS)";
+    }
+    std::cout << "\n";
+    record_result("local_bw", variant, "GBPS", gbps);
+    if (eu_count) {
+      record_result("local_bw", variant + " per EU", "GBPS", gbps / eu_count);
+    }
+  }
+
+  std::cout << "Local memory bank conflicts, float (GBPS)\n";
+  std::cout << std::setw(12) << "stride" << std::setw(14) << "GBPS"
+            << std::setw(14) << "per EU" << std::setw(14) << "vs 4B"
+            << "\n";
+  /* power per row would break the table, it is in --json / --csv only */
+  print_power = false;
+
+  long double work = static_cast<long double>(num_work_items) *
+                     reads_per_wi * sizeof(float);
+  long double unit_stride_gbps = 0;
+  for (auto stride : strides) {
+    if (stride > group_size) {
+      break;
+    }
+    result =
+        zeKernelSetArgumentValue(functions[0], 4, sizeof(stride), &stride);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+
+    timed = run_kernel(context, functions[0], workgroup_info, type);
+    gbps = calculate_gbps(timed, work);
+    if (stride == 1) {
+      unit_stride_gbps = gbps;
+    }
+    std::cout << std::setw(10) << stride * sizeof(float) << "B"
+              << std::setw(15) << gbps << std::setw(14)
+              << (eu_count ? gbps / eu_count : 0) << std::setw(13)
+              << (unit_stride_gbps > 0 ? gbps / unit_stride_gbps : 0) << "x"
+              << device_rate(last_device_time, work, "GBPS") << "\n";
+    record_result("local_bw",
+                  "float stride " + std::to_string(stride * sizeof(float)) +
+                      "B",
+                  "GBPS", gbps);
+  }
+  print_power = true;
+
+  for (size_t w = 0; w < functions.size(); w++) {
+    result = zeKernelDestroy(functions[w]);
+    if (result) {
+      throw std::runtime_error("zeKernelDestroy failed: " +
+                               std::to_string(result));
+    }
+    if (verbose)
+      std::cout << "local_bandwidth_v" << widths[w] << " Function Destroyed\n";
+  }
+
+  result = zeMemFree(context.context, inputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Input Buffer freed\n";
+
+  result = zeMemFree(context.context, outputBuf);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Output Buffer freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
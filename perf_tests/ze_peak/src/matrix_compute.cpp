@@ -0,0 +1,278 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+#include <algorithm>
+
+struct ZeMatrixVariant {
+  const char *binary;
+  const char *kernel;
+  const char *label;
+  /* 64 iterations * 16 calls * 2 * M(8) * K */
+  size_t flops_per_work_item;
+};
+
+static const ZeMatrixVariant matrix_variants[] = {
+    {"ze_matrix_compute.spv", "compute_bf16_dpas", "bf16", 262144},
+    {"ze_matrix_compute.spv", "compute_f16_dpas", "fp16", 262144},
+    {"ze_matrix_tf32_compute.spv", "compute_tf32_dpas", "tf32", 131072},
+    {"ze_matrix_compute.spv", "compute_i8_dpas", "int8", 524288},
+};
+
+//---------------------------------------------------------------------
+// Builds the module for the device or every sub device like
+// L0Context::create_module, but reports a build failure to the caller
+// instead of throwing, since the matrix builtins are only available on
+// devices with matrix engines.
+//---------------------------------------------------------------------
+static bool
+try_create_module(L0Context &context,
+                  const level_zero_tests::BinaryFile &binary_file) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  ze_module_desc_t module_description = {};
+  module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+
+  module_description.pNext = nullptr;
+  module_description.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_description.inputSize = static_cast<uint32_t>(binary_file.size());
+  module_description.pInputModule =
+      reinterpret_cast<const uint8_t *>(binary_file.data());
+  module_description.pBuildFlags = nullptr;
+
+  if (context.sub_device_count) {
+    context.subdevice_module.assign(context.sub_device_count, nullptr);
+    for (uint32_t i = 0; i < context.sub_device_count; i++) {
+      result =
+          zeModuleCreate(context.context, context.sub_devices[i],
+                         &module_description, &context.subdevice_module[i],
+                         nullptr);
+      if (result) {
+        for (uint32_t j = 0; j < i; j++) {
+          zeModuleDestroy(context.subdevice_module[j]);
+        }
+        return false;
+      }
+    }
+  } else {
+    result = zeModuleCreate(context.context, context.device,
+                            &module_description, &context.module, nullptr);
+    if (result) {
+      return false;
+    }
+  }
+  if (context.verbose)
+    std::cout << "Module created\n";
+  return true;
+}
+
+static void destroy_module(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  if (context.sub_device_count) {
+    for (auto module : context.subdevice_module) {
+      result = zeModuleDestroy(module);
+      if (result) {
+        throw std::runtime_error("zeModuleDestroy failed: " +
+                                 std::to_string(result));
+      }
+    }
+  } else {
+    result = zeModuleDestroy(context.module);
+    if (result) {
+      throw std::runtime_error("zeModuleDestroy failed: " +
+                               std::to_string(result));
+    }
+  }
+  if (context.verbose)
+    std::cout << "Module destroyed\n";
+}
+
+//---------------------------------------------------------------------
+// Peak throughput of the matrix engines using the sub-group matrix
+// multiply accumulate builtins (DPAS) for bf16, fp16, tf32 and int8.
+// The kernels require a sub-group size of 16.
+//---------------------------------------------------------------------
+void ZePeak::ze_peak_matrix_compute(L0Context &context) {
+  long double gflops, timed, device_timed;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+  struct ZeWorkGroups workgroup_info;
+  int input_value = 0x3c003c00;
+  uint32_t device_count =
+      context.sub_device_count ? context.sub_device_count : 1;
+
+  const uint32_t *sub_group_sizes =
+      context.device_compute_property.subGroupSizes;
+  if (std::find(sub_group_sizes,
+                sub_group_sizes +
+                    context.device_compute_property.numSubGroupSizes,
+                16u) ==
+      sub_group_sizes + context.device_compute_property.numSubGroupSizes) {
+    std::cout << "matrix_compute test skipping for missing support: "
+              << "Device Compute Properties not reporting sub-group size 16\n";
+    return;
+  }
+
+  uint64_t max_work_items = get_max_work_items(context) * 64;
+  uint64_t max_number_of_allocated_items =
+      context.device_property.maxMemAllocSize / sizeof(float);
+  uint64_t number_of_work_items =
+      MIN(max_number_of_allocated_items, max_work_items);
+
+  if (context.sub_device_count) {
+    number_of_work_items = number_of_work_items -
+                           (number_of_work_items % context.sub_device_count);
+    if (verbose)
+      std::cout << "splitting the total work items ::" << number_of_work_items
+                << "across subdevices ::" << context.sub_device_count
+                << std::endl;
+    number_of_work_items =
+        set_workgroups(context, number_of_work_items / context.sub_device_count,
+                       &workgroup_info);
+  } else {
+    number_of_work_items =
+        set_workgroups(context, number_of_work_items, &workgroup_info);
+  }
+
+  std::vector<void *> dev_in_val(device_count);
+  std::vector<void *> dev_out_buf(device_count);
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+
+  device_desc.pNext = nullptr;
+  device_desc.ordinal = 0;
+  device_desc.flags = 0;
+  for (uint32_t i = 0; i < device_count; i++) {
+    ze_device_handle_t device =
+        context.sub_device_count ? context.sub_devices[i] : context.device;
+    result = zeMemAllocDevice(context.context, &device_desc, sizeof(int), 1,
+                              device, &dev_in_val[i]);
+    if (result) {
+      throw std::runtime_error("zeMemAllocDevice failed: " +
+                               std::to_string(result));
+    }
+    result = zeMemAllocDevice(
+        context.context, &device_desc,
+        static_cast<size_t>((number_of_work_items * sizeof(float))), 1, device,
+        &dev_out_buf[i]);
+    if (result) {
+      throw std::runtime_error("zeMemAllocDevice failed: " +
+                               std::to_string(result));
+    }
+
+    ze_command_list_handle_t command_list =
+        context.sub_device_count ? context.cmd_list[i] : context.command_list;
+    result = zeCommandListAppendMemoryCopy(command_list, dev_in_val[i],
+                                           &input_value, sizeof(int), nullptr,
+                                           0, nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                               std::to_string(result));
+    }
+    result = zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                               std::to_string(result));
+    }
+  }
+  if (verbose)
+    std::cout << "device buffers allocated and input value copy encoded\n";
+
+  context.execute_commandlist_and_sync();
+
+  std::cout << "Matrix Engine Compute (GFLOPS)\n";
+
+  for (auto &variant : matrix_variants) {
+    std::cout << variant.label << " : ";
+
+    level_zero_tests::BinaryFile binary_file =
+        context.load_binary_file(variant.binary);
+    if (!try_create_module(context, binary_file)) {
+      std::cout << "skipping for missing support: " << variant.binary
+                << " failed to build\n";
+      continue;
+    }
+
+    std::vector<ze_kernel_handle_t> functions(device_count);
+    for (uint32_t i = 0; i < device_count; i++) {
+      setup_function(context, functions[i], variant.kernel, dev_in_val[i],
+                     dev_out_buf[i]);
+    }
+
+    timed = 0;
+    device_timed = 0;
+    if (context.sub_device_count) {
+      if (concurrent_sub_devices) {
+        timed = run_kernel_concurrent(context, functions, workgroup_info);
+      } else {
+        current_sub_device_id = 0;
+        for (auto function : functions) {
+          timed += run_kernel(context, function, workgroup_info, type);
+          device_timed += last_device_time;
+          current_sub_device_id++;
+        }
+        current_sub_device_id = 0;
+      }
+      gflops = calculate_gbps(timed, number_of_work_items *
+                                         context.sub_device_count *
+                                         variant.flops_per_work_item);
+      std::cout << gflops << " GFLOPS"
+                << device_rate(device_timed,
+                               number_of_work_items *
+                                   context.sub_device_count *
+                                   variant.flops_per_work_item,
+                               "GFLOPS")
+                << tile_rates(last_tile_times,
+                              number_of_work_items *
+                                  variant.flops_per_work_item,
+                              "GFLOPS")
+                << "\n";
+      record_result("matrix_compute", variant.label, "GFLOPS", gflops);
+    } else {
+      timed = run_kernel(context, functions[0], workgroup_info, type);
+      device_timed = last_device_time;
+      gflops = calculate_gbps(timed, number_of_work_items *
+                                         variant.flops_per_work_item);
+      std::cout << gflops << " GFLOPS"
+                << device_rate(device_timed,
+                               number_of_work_items *
+                                   variant.flops_per_work_item,
+                               "GFLOPS")
+                << "\n";
+      record_result("matrix_compute", variant.label, "GFLOPS", gflops);
+    }
+
+    for (auto function : functions) {
+      result = zeKernelDestroy(function);
+      if (result) {
+        throw std::runtime_error("zeKernelDestroy failed: " +
+                                 std::to_string(result));
+      }
+    }
+    if (verbose)
+      std::cout << variant.kernel << " Function Destroyed\n";
+
+    destroy_module(context);
+  }
+
+  for (uint32_t i = 0; i < device_count; i++) {
+    result = zeMemFree(context.context, dev_in_val[i]);
+    if (result) {
+      throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+    }
+    result = zeMemFree(context.context, dev_out_buf[i]);
+    if (result) {
+      throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+    }
+  }
+  if (verbose)
+    std::cout << "Input and Output Buffers freed\n";
+
+  print_test_complete();
+}
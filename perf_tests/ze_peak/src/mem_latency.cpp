@@ -0,0 +1,335 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+#include "../../common/include/common.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <random>
+
+/* One link per cache line, so that no two links share a line */
+static const uint32_t link_stride = 64 / sizeof(uint32_t);
+static const uint32_t hops_per_launch = 1 << 14;
+static const uint64_t min_ring_size = 4096;
+static const uint64_t max_ring_size = uint64_t(1) << 28;
+/* A footprint whose latency is this much above the mean of the current
+ * level starts the next level of the hierarchy */
+static const long double level_step = 1.3;
+
+static const char *memory_names[] = {"device", "host", "shared", "peer"};
+
+static std::string footprint_name(uint64_t footprint) {
+  if (footprint >= (1 << 20)) {
+    return std::to_string(footprint >> 20) + "MB";
+  }
+  return std::to_string(footprint >> 10) + "KB";
+}
+
+//---------------------------------------------------------------------
+// Writes a ring over the first footprint bytes of buffer, one link per
+// cache line, in a random order that visits every link once (Sattolo's
+// algorithm), so that neither the caches nor the prefetchers see a
+// pattern to follow.
+//---------------------------------------------------------------------
+static void build_ring(uint32_t *buffer, uint64_t footprint) {
+  const uint32_t links = static_cast<uint32_t>(footprint / 64);
+  std::vector<uint32_t> order(links);
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937 generator(links);
+  for (uint32_t i = links - 1; i > 0; i--) {
+    std::uniform_int_distribution<uint32_t> pick(0, i - 1);
+    std::swap(order[i], order[pick(generator)]);
+  }
+  for (uint32_t i = 0; i < links; i++) {
+    buffer[i * link_stride] = order[i] * link_stride;
+  }
+}
+
+//---------------------------------------------------------------------
+// Measures the load to use latency with a single work item chasing a
+// random ring that doubles from 4KB up to 256MB, in device, host and
+// shared memory and in the device memory of a peer device, so that the
+// latency steps up as the ring spills out of each level of the memory
+// hierarchy. The footprints are then grouped into levels where the
+// latency stays flat, and the latency of every level is reported.
+//---------------------------------------------------------------------
+void ZePeak::ze_peak_mem_latency(L0Context &context) {
+  long double timed;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  struct ZeWorkGroups workgroup_info;
+  TimingMeasurement type = is_bandwidth_with_event_timer();
+
+  if (context.sub_device_count) {
+    std::cout << "mem_latency test skipping with explicit scaling\n";
+    return;
+  }
+
+  level_zero_tests::BinaryFile binary_file =
+      context.load_binary_file("ze_mem_latency.spv");
+
+  context.create_module(binary_file);
+
+  const uint64_t ring_limit =
+      std::min(max_ring_size, context.device_property.maxMemAllocSize);
+  uint64_t max_footprint = min_ring_size;
+  while (max_footprint * 2 <= ring_limit) {
+    max_footprint *= 2;
+  }
+
+  ze_device_handle_t peer_device = nullptr;
+  uint32_t device_count = 0;
+  SUCCESS_OR_TERMINATE(zeDeviceGet(context.driver, &device_count, nullptr));
+  std::vector<ze_device_handle_t> devices(device_count);
+  SUCCESS_OR_TERMINATE(
+      zeDeviceGet(context.driver, &device_count, devices.data()));
+  for (auto device : devices) {
+    ze_bool_t can_access = false;
+    if (device != context.device &&
+        zeDeviceCanAccessPeer(context.device, device, &can_access) ==
+            ZE_RESULT_SUCCESS &&
+        can_access) {
+      peer_device = device;
+      break;
+    }
+  }
+
+  workgroup_info.group_size_x = 1;
+  workgroup_info.group_size_y = 1;
+  workgroup_info.group_size_z = 1;
+  workgroup_info.thread_group_dimensions = {1, 1, 1};
+
+  /* The ring is built in host memory and copied to the other kinds */
+  void *hostBuf;
+  ze_host_mem_alloc_desc_t host_desc = {};
+  host_desc.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
+  result = zeMemAllocHost(context.context, &host_desc,
+                          static_cast<size_t>(max_footprint), 1, &hostBuf);
+  if (result) {
+    throw std::runtime_error("zeMemAllocHost failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "hostBuf host buffer allocated\n";
+
+  void *positionBuf;
+  ze_device_mem_alloc_desc_t position_desc = {};
+  position_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  result = zeMemAllocDevice(context.context, &position_desc, sizeof(uint32_t),
+                            1, context.device, &positionBuf);
+  if (result) {
+    throw std::runtime_error("zeMemAllocDevice failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "positionBuf device buffer allocated\n";
+
+  ze_kernel_handle_t chase_function;
+  setup_function(context, chase_function, "pointer_chase", hostBuf,
+                 positionBuf);
+
+  /* Launch overhead, taken off every time: the kernel with no hops */
+  uint32_t hops = 0;
+  result = zeKernelSetArgumentValue(chase_function, 2, sizeof(hops), &hops);
+  if (result) {
+    throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                             std::to_string(result));
+  }
+  const long double overhead =
+      run_kernel(context, chase_function, workgroup_info, type);
+  iteration_times.clear();
+  hops = hops_per_launch;
+  result = zeKernelSetArgumentValue(chase_function, 2, sizeof(hops), &hops);
+  if (result) {
+    throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                             std::to_string(result));
+  }
+
+  std::vector<uint64_t> footprints;
+  for (uint64_t footprint = min_ring_size; footprint <= max_footprint;
+       footprint *= 2) {
+    footprints.push_back(footprint);
+  }
+  const size_t memory_count = sizeof(memory_names) / sizeof(memory_names[0]);
+  /* Latency in ns of every footprint and kind of memory */
+  std::vector<std::vector<long double>> latencies(
+      memory_count, std::vector<long double>(footprints.size(), 0));
+  auto skipped = [&](size_t m) {
+    return strcmp(memory_names[m], "peer") == 0 && !peer_device;
+  };
+  /* power per cell would break the table, it is in --json / --csv only */
+  print_power = false;
+
+  for (size_t m = 0; m < memory_count; m++) {
+    const std::string memory = memory_names[m];
+    void *ringBuf = hostBuf;
+    if (skipped(m)) {
+      continue;
+    }
+    if (memory == "device" || memory == "peer") {
+      ze_device_mem_alloc_desc_t device_desc = {};
+      device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+      result = zeMemAllocDevice(
+          context.context, &device_desc, static_cast<size_t>(max_footprint),
+          1, memory == "peer" ? peer_device : context.device, &ringBuf);
+      if (result) {
+        throw std::runtime_error("zeMemAllocDevice failed: " +
+                                 std::to_string(result));
+      }
+    } else if (memory == "shared") {
+      ze_device_mem_alloc_desc_t device_desc = {};
+      device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+      result = zeMemAllocShared(context.context, &device_desc, &host_desc,
+                                static_cast<size_t>(max_footprint), 1,
+                                context.device, &ringBuf);
+      if (result) {
+        throw std::runtime_error("zeMemAllocShared failed: " +
+                                 std::to_string(result));
+      }
+    }
+    if (verbose)
+      std::cout << memory << " ring buffer allocated\n";
+
+    result = zeKernelSetArgumentValue(chase_function, 0, sizeof(ringBuf),
+                                      &ringBuf);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+
+    for (size_t f = 0; f < footprints.size(); f++) {
+      build_ring(static_cast<uint32_t *>(hostBuf), footprints[f]);
+      if (memory == "shared") {
+        memcpy(ringBuf, hostBuf, static_cast<size_t>(footprints[f]));
+      } else if (ringBuf != hostBuf) {
+        result = zeCommandListAppendMemoryCopy(
+            context.command_list, ringBuf, hostBuf,
+            static_cast<size_t>(footprints[f]), nullptr, 0, nullptr);
+        if (result) {
+          throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                                   std::to_string(result));
+        }
+      }
+      uint32_t start = 0;
+      result = zeCommandListAppendMemoryFill(context.command_list,
+                                             positionBuf, &start,
+                                             sizeof(start), sizeof(start),
+                                             nullptr, 0, nullptr);
+      if (result) {
+        throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                                 std::to_string(result));
+      }
+      context.execute_commandlist_and_sync();
+
+      timed = run_kernel(context, chase_function, workgroup_info, type);
+      for (auto &time : iteration_times) {
+        time = std::max(time - overhead, 0.0L) / hops_per_launch;
+      }
+      latencies[m][f] = std::max(timed - overhead, 0.0L) / hops_per_launch;
+      record_result("mem_latency", memory + " " + footprint_name(footprints[f]),
+                    "ns", latencies[m][f]);
+    }
+
+    if (ringBuf != hostBuf) {
+      result = zeMemFree(context.context, ringBuf);
+      if (result) {
+        throw std::runtime_error("zeMemFree failed: " +
+                                 std::to_string(result));
+      }
+      if (verbose)
+        std::cout << memory << " ring buffer freed\n";
+    }
+  }
+  print_power = true;
+
+  std::cout << "Memory latency (ns per load)\n";
+  std::cout << std::setw(12) << "footprint";
+  for (size_t m = 0; m < memory_count; m++) {
+    std::cout << std::setw(14) << memory_names[m];
+  }
+  std::cout << "\n";
+  for (size_t f = 0; f < footprints.size(); f++) {
+    std::cout << std::setw(12) << footprint_name(footprints[f]);
+    for (size_t m = 0; m < memory_count; m++) {
+      if (skipped(m)) {
+        std::cout << std::setw(14) << "-";
+      } else {
+        std::cout << std::setw(14) << latencies[m][f];
+      }
+    }
+    std::cout << "\n";
+  }
+  if (!peer_device) {
+    std::cout << "peer memory skipping: no other device can be accessed\n";
+  }
+
+  // Consecutive footprints with about the same latency make up a level
+  // of the hierarchy, whose latency is the mean over its footprints.
+  std::cout << "Memory latency per level (ns per load)\n";
+  for (size_t m = 0; m < memory_count; m++) {
+    if (skipped(m)) {
+      continue;
+    }
+    size_t first = 0;
+    long double sum = 0;
+    uint32_t level = 1;
+    std::cout << std::setw(8) << memory_names[m] << " :";
+    for (size_t f = 0; f <= footprints.size(); f++) {
+      const long double mean = sum / std::max(f - first, size_t(1));
+      if (f == footprints.size() ||
+          (f > first && latencies[m][f] > mean * level_step)) {
+        const std::string range = footprint_name(footprints[first]) + "-" +
+                                  footprint_name(footprints[f - 1]);
+        std::cout << " " << range << " " << mean << " ns"
+                  << (f < footprints.size() ? "," : "\n");
+        record_result("mem_latency",
+                      std::string(memory_names[m]) + " level " +
+                          std::to_string(level) + " " + range,
+                      "ns", mean);
+        first = f;
+        sum = 0;
+        level++;
+      }
+      if (f < footprints.size()) {
+        sum += latencies[m][f];
+      }
+    }
+  }
+
+  result = zeKernelDestroy(chase_function);
+  if (result) {
+    throw std::runtime_error("zeKernelDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "pointer_chase Function Destroyed\n";
+
+  result = zeMemFree(context.context, hostBuf);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Host Buffer freed\n";
+
+  result = zeMemFree(context.context, positionBuf);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Position Buffer freed\n";
+
+  result = zeModuleDestroy(context.module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+  if (verbose)
+    std::cout << "Module destroyed\n";
+
+  print_test_complete();
+}
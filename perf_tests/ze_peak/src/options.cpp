@@ -17,8 +17,47 @@ static const char *usage_str =
     "\n  -e                          time using ze events instead of std "
     "chrono timer"
     "\n                              hide driver latencies [default: No]"
+    "\n  -k                          report device time from kernel "
+    "timestamps next"
+    "\n                              to the host time [default: No]"
+    "\n  --batch num                 record num kernel launches per "
+    "submission and"
+    "\n                              report per launch throughput "
+    "[default: 1]"
+    "\n  --batch-barrier             append a barrier between the batched "
+    "launches"
+    "\n                              [default: No]"
+    "\n  --transfer-chunks num       also run transfer_bw as num chunks "
+    "pipelined"
+    "\n                              over two copy engines, from pinned and "
+    "staged"
+    "\n                              pageable memory [default: 0, off]"
+    "\n  --json file                 also write every result with its "
+    "iterations and"
+    "\n                              stddev as JSON to file"
+    "\n  --csv file                  also write every result as CSV to file"
+    "\n  --power                     sample power and GPU frequency with "
+    "sysman and"
+    "\n                              report them with perf per W for each "
+    "result"
+    "\n                              [default: No]"
+    "\n  --histogram                 dump a power of two histogram of the "
+    "kernel latency"
+    "\n                              samples next to the percentiles "
+    "[default: No]"
     "\n  -t, string                  selectively run particular tests"
     "\n      global_bw               selectively run global bandwidth test"
+    "\n      global_bw_sweep         selectively run global bandwidth sweep "
+    "over working"
+    "\n                              set sizes and strides (not part of -a)"
+    "\n      local_bw                selectively run local memory bandwidth "
+    "and bank"
+    "\n                              conflict test"
+    "\n      mem_latency             selectively run pointer chasing memory "
+    "latency"
+    "\n                              test over ring sizes and memory types "
+    "(not part"
+    "\n                              of -a)"
     "\n      hp_compute              selectively run half precision compute "
     "test"
     "\n      sp_compute              selectively run single precision compute "
@@ -26,9 +65,16 @@ static const char *usage_str =
     "\n      dp_compute              selectively run double precision compute "
     "test"
     "\n      int_compute             selectively run integer compute test"
+    "\n      matrix_compute          selectively run matrix engine (DPAS) "
+    "compute test"
+    "\n      atomics                 selectively run global and local atomic "
+    "throughput"
+    "\n                              test (not part of -a)"
     "\n      transfer_bw             selectively run transfer bandwidth test"
     "\n      kernel_lat              selectively run kernel latency test"
-    "\n  -a                          run all above tests [default]"
+    "\n  -a                          run all above tests except "
+    "global_bw_sweep,"
+    "\n                              mem_latency and atomics [default]"
     "\n  -v                          enable verbose prints"
     "\n  -i                          set number of iterations to run[default: "
     "50]"
@@ -36,6 +82,19 @@ static const char *usage_str =
     "run[default: 10]"
     "\n  -x                          enable explicit scaling [default: "
     "Disabled]"
+    "\n  --concurrent                with explicit scaling, run the kernels "
+    "on all sub"
+    "\n                              devices at the same time and report "
+    "aggregate"
+    "\n                              and per sub device results [default: "
+    "Disabled]"
+    "\n  --compare-scaling           run the tests on the root device "
+    "(implicit"
+    "\n                              scaling), then on all sub devices "
+    "concurrently"
+    "\n                              (explicit scaling), and print both "
+    "with their"
+    "\n                              ratio [default: Disabled]"
     "\n  -q                          query for number of engines available"
     "\n  -g, group                   select engine group (default: 0)"
     "\n  -n, number                  select engine index (default: 0)"
@@ -67,6 +126,12 @@ int ZePeak::parse_arguments(int argc, char **argv) {
     if (stage == 1) {
       if (strcmp(argv[i], "global_bw") == 0) {
         run_global_bw = true;
+      } else if (strcmp(argv[i], "global_bw_sweep") == 0) {
+        run_global_bw_sweep = true;
+      } else if (strcmp(argv[i], "local_bw") == 0) {
+        run_local_bw = true;
+      } else if (strcmp(argv[i], "mem_latency") == 0) {
+        run_mem_latency = true;
       } else if (strcmp(argv[i], "hp_compute") == 0) {
         run_hp_compute = true;
       } else if (strcmp(argv[i], "sp_compute") == 0) {
@@ -75,14 +140,19 @@ int ZePeak::parse_arguments(int argc, char **argv) {
         run_dp_compute = true;
       } else if (strcmp(argv[i], "int_compute") == 0) {
         run_int_compute = true;
+      } else if (strcmp(argv[i], "matrix_compute") == 0) {
+        run_matrix_compute = true;
+      } else if (strcmp(argv[i], "atomics") == 0) {
+        run_atomics = true;
       } else if (strcmp(argv[i], "transfer_bw") == 0) {
         run_transfer_bw = true;
       } else if (strcmp(argv[i], "kernel_lat") == 0) {
         run_kernel_lat = true;
       } else {
-        if (run_global_bw || run_hp_compute || run_sp_compute ||
-            run_dp_compute || run_int_compute || run_transfer_bw ||
-            run_kernel_lat) {
+        if (run_global_bw || run_global_bw_sweep || run_local_bw ||
+            run_mem_latency || run_hp_compute || run_sp_compute ||
+            run_dp_compute || run_int_compute || run_matrix_compute ||
+            run_atomics || run_transfer_bw || run_kernel_lat) {
           stage = 0;
         } else {
           std::cout << usage_str;
@@ -93,8 +163,12 @@ int ZePeak::parse_arguments(int argc, char **argv) {
 
     if (stage == 0) {
       if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
-        std::cout << usage_str;
+        std::cout << usage_str << "\n Host placement options:"
+                  << HostPlacement::usage() << "\n Metric options:"
+                  << MetricProfiler::usage() << "\n";
         exit(0);
+      } else if (placement.parse_option(argc, argv, i)) {
+      } else if (metric_profiler.parse_option(argc, argv, i)) {
       } else if ((strcmp(argv[i], "-r") == 0) ||
                  (strcmp(argv[i], "--driver") == 0)) {
         if ((i + 1) < argc) {
@@ -109,6 +183,37 @@ int ZePeak::parse_arguments(int argc, char **argv) {
         }
       } else if (strcmp(argv[i], "-e") == 0) {
         use_event_timer = true;
+      } else if (strcmp(argv[i], "-k") == 0) {
+        use_device_timestamps = true;
+      } else if (strcmp(argv[i], "--batch") == 0) {
+        if ((i + 1) < argc) {
+          batch_size = sanitize_ulong(argv[i + 1]);
+          if (batch_size == 0) {
+            batch_size = 1;
+          }
+          i++;
+        }
+      } else if (strcmp(argv[i], "--batch-barrier") == 0) {
+        batch_barrier = true;
+      } else if (strcmp(argv[i], "--transfer-chunks") == 0) {
+        if ((i + 1) < argc) {
+          transfer_chunks = sanitize_ulong(argv[i + 1]);
+          i++;
+        }
+      } else if (strcmp(argv[i], "--json") == 0) {
+        if ((i + 1) < argc) {
+          json_output = argv[i + 1];
+          i++;
+        }
+      } else if (strcmp(argv[i], "--csv") == 0) {
+        if ((i + 1) < argc) {
+          csv_output = argv[i + 1];
+          i++;
+        }
+      } else if (strcmp(argv[i], "--power") == 0) {
+        monitor_power = true;
+      } else if (strcmp(argv[i], "--histogram") == 0) {
+        latency_histogram = true;
       } else if (strcmp(argv[i], "-v") == 0) {
         verbose = true;
       } else if (strcmp(argv[i], "-i") == 0) {
@@ -127,13 +232,20 @@ int ZePeak::parse_arguments(int argc, char **argv) {
           exit(-1);
         }
         stage = 1;
-        run_global_bw = run_hp_compute = run_sp_compute = run_dp_compute =
-            run_int_compute = run_transfer_bw = run_kernel_lat = false;
+        run_global_bw = run_global_bw_sweep = run_local_bw = run_mem_latency =
+            run_hp_compute = run_sp_compute = run_dp_compute =
+                run_int_compute = run_matrix_compute = run_atomics =
+                    run_transfer_bw = run_kernel_lat = false;
       } else if (strcmp(argv[i], "-a") == 0) {
-        run_global_bw = run_hp_compute = run_sp_compute = run_dp_compute =
-            run_int_compute = run_transfer_bw = run_kernel_lat = true;
+        run_global_bw = run_local_bw = run_hp_compute = run_sp_compute =
+            run_dp_compute = run_int_compute = run_matrix_compute =
+                run_transfer_bw = run_kernel_lat = true;
       } else if (strcmp(argv[i], "-x") == 0) {
         enable_explicit_scaling = true;
+      } else if (strcmp(argv[i], "--concurrent") == 0) {
+        concurrent_sub_devices = true;
+      } else if (strcmp(argv[i], "--compare-scaling") == 0) {
+        compare_scaling = true;
       } else if ((strcmp(argv[i], "-q") == 0)) {
         query_engines = true;
       } else if ((strcmp(argv[i], "-g") == 0)) {
@@ -0,0 +1,149 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+/* Interval between two frequency samples of the background thread */
+static const std::chrono::milliseconds frequency_sample_interval(10);
+
+ZePeakPowerMonitor::~ZePeakPowerMonitor() {
+  running = false;
+  if (sampler.joinable()) {
+    sampler.join();
+  }
+}
+
+//---------------------------------------------------------------------
+// Looks up the power domains and GPU frequency domains of the device.
+// The card power domain is used when the device has one, otherwise the
+// energy of every power domain of the device itself is summed up.
+// Returns false if sysman reports neither of them.
+//---------------------------------------------------------------------
+bool ZePeakPowerMonitor::init(L0Context &context) {
+  zes_device_handle_t device =
+      reinterpret_cast<zes_device_handle_t>(context.device);
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  zes_pwr_handle_t card_power = nullptr;
+  result = zesDeviceGetCardPowerDomain(device, &card_power);
+  if (result == ZE_RESULT_SUCCESS && card_power != nullptr) {
+    power_handles.push_back(card_power);
+  } else {
+    uint32_t count = 0;
+    result = zesDeviceEnumPowerDomains(device, &count, nullptr);
+    if (result == ZE_RESULT_SUCCESS && count) {
+      std::vector<zes_pwr_handle_t> handles(count);
+      result = zesDeviceEnumPowerDomains(device, &count, handles.data());
+      for (uint32_t i = 0; result == ZE_RESULT_SUCCESS && i < count; i++) {
+        zes_power_properties_t properties = {
+            ZES_STRUCTURE_TYPE_POWER_PROPERTIES, nullptr};
+        if (zesPowerGetProperties(handles[i], &properties) ==
+                ZE_RESULT_SUCCESS &&
+            !properties.onSubdevice) {
+          power_handles.push_back(handles[i]);
+        }
+      }
+    }
+  }
+
+  uint32_t count = 0;
+  result = zesDeviceEnumFrequencyDomains(device, &count, nullptr);
+  if (result == ZE_RESULT_SUCCESS && count) {
+    std::vector<zes_freq_handle_t> handles(count);
+    result = zesDeviceEnumFrequencyDomains(device, &count, handles.data());
+    for (uint32_t i = 0; result == ZE_RESULT_SUCCESS && i < count; i++) {
+      zes_freq_properties_t properties = {ZES_STRUCTURE_TYPE_FREQ_PROPERTIES,
+                                          nullptr};
+      if (zesFrequencyGetProperties(handles[i], &properties) ==
+              ZE_RESULT_SUCCESS &&
+          properties.type == ZES_FREQ_DOMAIN_GPU) {
+        frequency_handles.push_back(handles[i]);
+      }
+    }
+  }
+
+  if (context.verbose)
+    std::cout << "Power monitor found " << power_handles.size()
+              << " power domains and " << frequency_handles.size()
+              << " GPU frequency domains\n";
+
+  return !power_handles.empty() || !frequency_handles.empty();
+}
+
+void ZePeakPowerMonitor::read_energy(
+    std::vector<zes_power_energy_counter_t> &counters) {
+  counters.assign(power_handles.size(), zes_power_energy_counter_t{});
+  for (size_t i = 0; i < power_handles.size(); i++) {
+    if (zesPowerGetEnergyCounter(power_handles[i], &counters[i]) !=
+        ZE_RESULT_SUCCESS) {
+      counters[i].timestamp = 0;
+    }
+  }
+}
+
+void ZePeakPowerMonitor::sample_frequency() {
+  while (running) {
+    for (auto handle : frequency_handles) {
+      zes_freq_state_t state = {ZES_STRUCTURE_TYPE_FREQ_STATE, nullptr};
+      if (zesFrequencyGetState(handle, &state) == ZE_RESULT_SUCCESS &&
+          state.actual > 0) {
+        frequency_sum += state.actual;
+        frequency_samples++;
+      }
+    }
+    std::this_thread::sleep_for(frequency_sample_interval);
+  }
+}
+
+//---------------------------------------------------------------------
+// Starts a window: takes the energy counters and starts the frequency
+// sampling thread.
+//---------------------------------------------------------------------
+void ZePeakPowerMonitor::begin() {
+  if (running) {
+    return;
+  }
+  frequency_sum = 0;
+  frequency_samples = 0;
+  read_energy(begin_energy);
+  running = true;
+  sampler = std::thread(&ZePeakPowerMonitor::sample_frequency, this);
+}
+
+//---------------------------------------------------------------------
+// Ends the window started by begin() and returns the average power in W
+// and the average actual GPU frequency in MHz over the window. Either of
+// them is 0 when sysman could not read it. Returns false if no window
+// was started.
+//---------------------------------------------------------------------
+bool ZePeakPowerMonitor::end(long double &power, long double &frequency) {
+  power = 0;
+  frequency = 0;
+  if (!running) {
+    return false;
+  }
+  running = false;
+  sampler.join();
+
+  std::vector<zes_power_energy_counter_t> end_energy;
+  read_energy(end_energy);
+  for (size_t i = 0; i < end_energy.size(); i++) {
+    if (begin_energy[i].timestamp == 0 ||
+        end_energy[i].timestamp <= begin_energy[i].timestamp) {
+      continue;
+    }
+    /* energy in uJ over timestamps in us */
+    power += static_cast<long double>(end_energy[i].energy -
+                                      begin_energy[i].energy) /
+             (end_energy[i].timestamp - begin_energy[i].timestamp);
+  }
+  if (frequency_samples) {
+    frequency = frequency_sum / frequency_samples;
+  }
+  return true;
+}
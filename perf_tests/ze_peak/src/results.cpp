@@ -0,0 +1,243 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "../include/ze_peak.h"
+
+#include <iomanip>
+#include <sstream>
+
+/* JSON escapes with a backslash, CSV doubles the quote */
+static std::string quoted(const std::string &in, bool csv = false) {
+  std::string out = "\"";
+  for (char c : in) {
+    if (csv && c == '"') {
+      out += '"';
+    } else if (!csv && (c == '"' || c == '\\')) {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+//---------------------------------------------------------------------
+// Utility function to store a result printed by a stage.
+// The standard deviation is taken over the iteration times recorded by
+// run_kernel since the previous result; for rates every iteration is
+// scaled by the mean time over its own time. With --concurrent one more
+// result is stored for every sub device. With --power the power monitor
+// window is closed and its average power and frequency printed, and with
+// --metrics the counters of the metric streamer window.
+//---------------------------------------------------------------------
+void ZePeak::record_result(const char *test, const std::string &variant,
+                           const char *unit, long double value) {
+  const bool is_time = (strcmp(unit, "us") == 0 || strcmp(unit, "ns") == 0);
+  long double stddev = 0;
+
+  if (iteration_times.size() > 1) {
+    long double mean_time =
+        std::accumulate(iteration_times.begin(), iteration_times.end(),
+                        0.0L) /
+        iteration_times.size();
+    std::vector<long double> samples;
+    for (auto time : iteration_times) {
+      if (is_time) {
+        samples.push_back(time);
+      } else if (time > 0) {
+        samples.push_back(value * mean_time / time);
+      }
+    }
+    if (samples.size() > 1) {
+      long double mean =
+          std::accumulate(samples.begin(), samples.end(), 0.0L) /
+          samples.size();
+      long double sum_of_squares = 0;
+      for (auto sample : samples) {
+        sum_of_squares += (sample - mean) * (sample - mean);
+      }
+      stddev = sqrt(sum_of_squares / (samples.size() - 1));
+    }
+  }
+
+  long double power = 0, frequency = 0;
+  if (monitor_power && power_monitor.end(power, frequency) && print_power) {
+    std::cout << "  power: ";
+    if (power > 0) {
+      std::cout << power << " W";
+      if (!is_time) {
+        std::cout << ", " << value / power << " " << unit << "/W";
+      }
+    } else {
+      std::cout << "n/a";
+    }
+    if (frequency > 0) {
+      std::cout << ", " << frequency << " MHz";
+    }
+    std::cout << "\n";
+  }
+
+  std::vector<MetricProfiler::Counter> metrics;
+  if (metric_profiler.end(metrics) && print_power && !metrics.empty()) {
+    std::cout << "  metrics: " << MetricProfiler::describe(metrics) << "\n";
+  }
+
+  results.push_back({test, variant, -1, unit, value, iters, stddev, power,
+                     frequency, metrics, scaling_mode});
+
+  if (!last_tile_times.empty() && last_concurrent_time > 0) {
+    const long double tile_count = last_tile_times.size();
+    for (size_t tile = 0; tile < last_tile_times.size(); tile++) {
+      if (last_tile_times[tile] > 0) {
+        results.push_back({test, variant, static_cast<int>(tile), unit,
+                           value * last_concurrent_time /
+                               (tile_count * last_tile_times[tile]),
+                           iters, 0, power, frequency, metrics,
+                           scaling_mode});
+      }
+    }
+  }
+
+  iteration_times.clear();
+  last_tile_times.clear();
+}
+
+//---------------------------------------------------------------------
+// Utility function to write the stored results into the files given
+// with --json and --csv.
+//---------------------------------------------------------------------
+void ZePeak::write_results(L0Context &context) {
+  const std::string device = context.device_property.name;
+
+  if (!json_output.empty()) {
+    std::ofstream stream(json_output);
+    if (!stream.good()) {
+      std::cerr << "Failed to open result file: " << json_output << "\n";
+    } else {
+      stream << std::setprecision(10);
+      stream << "{\n";
+      stream << "  \"device\": " << quoted(device) << ",\n";
+      stream << "  \"iterations\": " << iters << ",\n";
+      stream << "  \"warmup_iterations\": " << warmup_iterations << ",\n";
+      stream << "  \"batch_size\": " << batch_size << ",\n";
+      stream << "  \"results\": [";
+      for (size_t i = 0; i < results.size(); i++) {
+        auto &entry = results[i];
+        stream << (i ? ",\n" : "\n") << "    {\"test\": " << quoted(entry.test)
+               << ", \"variant\": " << quoted(entry.variant) << ", \"tile\": ";
+        if (entry.tile < 0) {
+          stream << "null";
+        } else {
+          stream << entry.tile;
+        }
+        stream << ", \"unit\": " << quoted(entry.unit)
+               << ", \"value\": " << entry.value
+               << ", \"iterations\": " << entry.iterations
+               << ", \"stddev\": " << entry.stddev
+               << ", \"power\": " << entry.power
+               << ", \"frequency\": " << entry.frequency;
+        if (!entry.scaling.empty()) {
+          stream << ", \"scaling\": " << quoted(entry.scaling);
+        }
+        if (!entry.metrics.empty()) {
+          stream << ", \"metrics\": {";
+          for (size_t m = 0; m < entry.metrics.size(); m++) {
+            stream << (m ? ", " : "")
+                   << quoted(entry.metrics[m].name + " (" +
+                             entry.metrics[m].unit + ")")
+                   << ": " << entry.metrics[m].value;
+          }
+          stream << "}";
+        }
+        stream << "}";
+      }
+      stream << "\n  ]\n}\n";
+      if (verbose)
+        std::cout << "Results written to " << json_output << "\n";
+    }
+  }
+
+  if (!csv_output.empty()) {
+    std::ofstream stream(csv_output);
+    if (!stream.good()) {
+      std::cerr << "Failed to open result file: " << csv_output << "\n";
+    } else {
+      stream << std::setprecision(10);
+      stream << "device,test,variant,tile,unit,value,iterations,stddev,"
+                "power,frequency"
+             << (compare_scaling ? ",scaling\n" : "\n");
+      for (auto &entry : results) {
+        stream << quoted(device, true) << "," << quoted(entry.test, true)
+               << "," << quoted(entry.variant, true) << ",";
+        if (entry.tile >= 0) {
+          stream << entry.tile;
+        }
+        stream << "," << entry.unit << "," << entry.value << ","
+               << entry.iterations << "," << entry.stddev << ","
+               << entry.power << "," << entry.frequency;
+        if (compare_scaling) {
+          stream << "," << entry.scaling;
+        }
+        stream << "\n";
+      }
+      if (verbose)
+        std::cout << "Results written to " << csv_output << "\n";
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Utility function to print the results of the implicit and the explicit
+// scaling passes of --compare-scaling side by side. The ratio is explicit
+// over implicit for rates and implicit over explicit for times, so that
+// above 1 explicit scaling is faster, and the efficiency divides it by
+// the number of sub devices: 1 / sub_device_count when explicit scaling
+// only matches the root device, 1 when it adds up to as many root
+// devices as there are sub devices.
+//---------------------------------------------------------------------
+void ZePeak::print_scaling_comparison(uint32_t sub_device_count) {
+  std::cout << "\nImplicit vs explicit scaling over " << sub_device_count
+            << " sub devices\n";
+  std::cout << std::left << std::setw(14) << "test" << std::setw(40)
+            << "variant" << std::right << std::setw(14) << "implicit"
+            << std::setw(14) << "explicit" << std::setw(8) << "unit"
+            << std::setw(8) << "ratio" << std::setw(12) << "efficiency"
+            << "\n";
+
+  for (auto &implicit : results) {
+    if (implicit.scaling != "implicit" || implicit.tile >= 0) {
+      continue;
+    }
+    const ZePeakResult *explicit_result = nullptr;
+    for (auto &entry : results) {
+      if (entry.scaling == "explicit" && entry.tile < 0 &&
+          entry.test == implicit.test && entry.variant == implicit.variant &&
+          entry.unit == implicit.unit) {
+        explicit_result = &entry;
+        break;
+      }
+    }
+
+    std::cout << std::left << std::setw(14) << implicit.test << std::setw(40)
+              << implicit.variant << std::right << std::setw(14)
+              << implicit.value;
+    if (explicit_result == nullptr || explicit_result->value <= 0 ||
+        implicit.value <= 0) {
+      std::cout << std::setw(14) << "n/a" << std::setw(8) << implicit.unit
+                << "\n";
+      continue;
+    }
+    const bool is_time = implicit.unit == "us" || implicit.unit == "ns";
+    const long double ratio = is_time
+                                  ? implicit.value / explicit_result->value
+                                  : explicit_result->value / implicit.value;
+    std::cout << std::setw(14) << explicit_result->value << std::setw(8)
+              << implicit.unit << std::setw(8) << std::setprecision(3)
+              << ratio << std::setw(12) << ratio / sub_device_count
+              << std::setprecision(6) << "\n";
+  }
+}
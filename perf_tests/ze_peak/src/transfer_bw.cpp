@@ -9,6 +9,8 @@
 #include "../include/ze_peak.h"
 #include "../../common/include/common.hpp"
 
+#include <algorithm>
+
 long double ZePeak::_transfer_bw_gpu_copy(L0Context &context,
                                           void *destination_buffer,
                                           void *source_buffer,
@@ -141,6 +143,153 @@ long double ZePeak::_transfer_bw_host_copy(L0Context &context,
   return gbps;
 }
 
+//---------------------------------------------------------------------
+// Splits the copy into transfer_chunks chunks which alternate between two
+// copy engine queues, with at most one chunk in flight per queue. With
+// staged, the host side is pageable memory which the host copies through
+// two pinned staging buffers, so the memcpy of one chunk overlaps with
+// the engine copy of the other one, like a data loader staging ring.
+// On success, the bandwidth of the whole transfer is returned.
+//---------------------------------------------------------------------
+long double ZePeak::_transfer_bw_pipelined(L0Context &context,
+                                           void *destination_buffer,
+                                           void *source_buffer,
+                                           size_t buffer_size, bool to_device,
+                                           bool staged) {
+  Timer<std::chrono::nanoseconds::period> timer;
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  long double timed = 0;
+
+  const size_t chunk_size =
+      (buffer_size + transfer_chunks - 1) / transfer_chunks;
+  const uint32_t chunk_count =
+      static_cast<uint32_t>((buffer_size + chunk_size - 1) / chunk_size);
+
+  /* Prefer a copy only group, else any group which can copy */
+  uint32_t ordinal = 0;
+  bool found_ordinal = false;
+  for (uint32_t i = 0; i < context.queueProperties.size(); i++) {
+    auto flags = context.queueProperties[i].flags;
+    if ((flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY) &&
+        context.queueProperties[i].numQueues > 0 &&
+        (!found_ordinal ||
+         !(flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE))) {
+      ordinal = i;
+      found_ordinal = true;
+      if (!(flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE)) {
+        break;
+      }
+    }
+  }
+
+  ze_command_list_handle_t lists[2] = {nullptr, nullptr};
+  for (uint32_t i = 0; i < 2; i++) {
+    ze_command_queue_desc_t cmd_q_desc = {};
+    cmd_q_desc.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+    cmd_q_desc.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+    cmd_q_desc.ordinal = ordinal;
+    if (found_ordinal) {
+      cmd_q_desc.index = i % context.queueProperties[ordinal].numQueues;
+    }
+    SUCCESS_OR_TERMINATE(zeCommandListCreateImmediate(
+        context.context, context.device, &cmd_q_desc, &lists[i]));
+  }
+  if (verbose)
+    std::cout << "copy immediate command lists created on group " << ordinal
+              << "\n";
+
+  ze_event_pool_handle_t event_pool = nullptr;
+  ze_event_pool_desc_t event_pool_desc = {};
+  event_pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+  event_pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  event_pool_desc.count = 2;
+  SUCCESS_OR_TERMINATE(zeEventPoolCreate(context.context, &event_pool_desc, 1,
+                                         &context.device, &event_pool));
+  ze_event_handle_t events[2] = {nullptr, nullptr};
+  for (uint32_t i = 0; i < 2; i++) {
+    ze_event_desc_t event_desc = {};
+    event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+    event_desc.index = i;
+    event_desc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+    event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+    SUCCESS_OR_TERMINATE(zeEventCreate(event_pool, &event_desc, &events[i]));
+  }
+
+  void *staging[2] = {nullptr, nullptr};
+  if (staged) {
+    ze_host_mem_alloc_desc_t host_desc = {};
+    host_desc.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
+    for (uint32_t i = 0; i < 2; i++) {
+      result = zeMemAllocHost(context.context, &host_desc, chunk_size, 1,
+                              &staging[i]);
+      if (result) {
+        throw std::runtime_error("zeMemAllocHost failed: " +
+                                 std::to_string(result));
+      }
+    }
+  }
+
+  uint8_t *source = static_cast<uint8_t *>(source_buffer);
+  uint8_t *destination = static_cast<uint8_t *>(destination_buffer);
+  auto chunk_length = [&](uint32_t chunk) {
+    return std::min(chunk_size, buffer_size - chunk * chunk_size);
+  };
+  auto finish_chunk = [&](uint32_t chunk) {
+    uint32_t slot = chunk % 2;
+    SUCCESS_OR_TERMINATE(zeEventHostSynchronize(events[slot], UINT64_MAX));
+    if (staged && !to_device) {
+      memcpy(destination + chunk * chunk_size, staging[slot],
+             chunk_length(chunk));
+    }
+    SUCCESS_OR_TERMINATE(zeEventHostReset(events[slot]));
+  };
+  auto transfer = [&]() {
+    for (uint32_t chunk = 0; chunk < chunk_count; chunk++) {
+      uint32_t slot = chunk % 2;
+      if (chunk >= 2) {
+        finish_chunk(chunk - 2);
+      }
+      void *src = source + chunk * chunk_size;
+      void *dst = destination + chunk * chunk_size;
+      if (staged && to_device) {
+        memcpy(staging[slot], src, chunk_length(chunk));
+        src = staging[slot];
+      } else if (staged) {
+        dst = staging[slot];
+      }
+      SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+          lists[slot], dst, src, chunk_length(chunk), events[slot], 0,
+          nullptr));
+    }
+    for (uint32_t chunk = chunk_count > 2 ? chunk_count - 2 : 0;
+         chunk < chunk_count; chunk++) {
+      finish_chunk(chunk);
+    }
+  };
+
+  for (uint32_t i = 0; i < warmup_iterations; i++) {
+    transfer();
+  }
+
+  for (uint32_t i = 0; i < iters; i++) {
+    timer.start();
+    transfer();
+    timed += timer.stopAndTime();
+  }
+  timed /= static_cast<long double>(iters);
+
+  for (uint32_t i = 0; i < 2; i++) {
+    if (staging[i]) {
+      SUCCESS_OR_TERMINATE(zeMemFree(context.context, staging[i]));
+    }
+    SUCCESS_OR_TERMINATE(zeEventDestroy(events[i]));
+    SUCCESS_OR_TERMINATE(zeCommandListDestroy(lists[i]));
+  }
+  SUCCESS_OR_TERMINATE(zeEventPoolDestroy(event_pool));
+
+  return calculate_gbps(timed, static_cast<long double>(buffer_size));
+}
+
 void ZePeak::_transfer_bw_shared_memory(L0Context &context,
                                         size_t local_memory_size,
                                         void *local_memory) {
@@ -199,6 +348,8 @@ void ZePeak::_transfer_bw_shared_memory(L0Context &context,
   }
   std::cout << "GPU Copy Host to Shared Memory : ";
   std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "GPU Copy Host to Shared Memory", "GBPS",
+                gflops);
 
   gflops = 0;
   if (context.sub_device_count) {
@@ -216,6 +367,8 @@ void ZePeak::_transfer_bw_shared_memory(L0Context &context,
   }
   std::cout << "GPU Copy Shared Memory to Host : ";
   std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "GPU Copy Shared Memory to Host", "GBPS",
+                gflops);
 
   gflops = 0;
   if (context.sub_device_count) {
@@ -233,6 +386,8 @@ void ZePeak::_transfer_bw_shared_memory(L0Context &context,
   }
   std::cout << "System Memory Copy to Shared Memory : ";
   std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "System Memory Copy to Shared Memory", "GBPS",
+                gflops);
 
   gflops = 0;
   if (context.sub_device_count) {
@@ -250,6 +405,8 @@ void ZePeak::_transfer_bw_shared_memory(L0Context &context,
   }
   std::cout << "System Memory Copy from Shared Memory : ";
   std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "System Memory Copy from Shared Memory", "GBPS",
+                gflops);
 
   current_sub_device_id = 0;
 
@@ -281,8 +438,17 @@ void ZePeak::ze_peak_transfer_bw(L0Context &context) {
       static_cast<size_t>((number_of_items * sizeof(float)));
   void *host_memory = nullptr;
   ze_host_mem_alloc_desc_t host_desc = {};
-  result = zeMemAllocHost(context.context, &host_desc, local_memory_size, 1,
-                          &host_memory);
+  /* First touched by the allocating thread, on the --host-numa-node node */
+  placement.allocate_on_node([&]() {
+    result = zeMemAllocHost(context.context, &host_desc, local_memory_size, 1,
+                            &host_memory);
+    if (result == ZE_RESULT_SUCCESS && host_memory) {
+      float *initial_memory = reinterpret_cast<float *>(host_memory);
+      for (uint32_t i = 0; i < static_cast<uint32_t>(number_of_items); i++) {
+        initial_memory[i] = static_cast<float>(i);
+      }
+    }
+  });
   if (result) {
     throw std::runtime_error("zeMemAllocHost failed: " +
                              std::to_string(result));
@@ -292,9 +458,6 @@ void ZePeak::ze_peak_transfer_bw(L0Context &context) {
     throw std::runtime_error("Failed to allocate host memory");
   }
   float *local_memory = reinterpret_cast<float *>(host_memory);
-  for (uint32_t i = 0; i < static_cast<uint32_t>(number_of_items); i++) {
-    local_memory[i] = static_cast<float>(i);
-  }
 
   void *device_buffer;
   std::vector<void *> dev_out_buf;
@@ -346,6 +509,7 @@ void ZePeak::ze_peak_transfer_bw(L0Context &context) {
   }
   std::cout << "enqueueWriteBuffer : ";
   std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "enqueueWriteBuffer", "GBPS", gflops);
 
   gflops = 0;
   if (context.sub_device_count) {
@@ -363,9 +527,82 @@ void ZePeak::ze_peak_transfer_bw(L0Context &context) {
   }
   std::cout << "enqueueReadBuffer : ";
   std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "enqueueReadBuffer", "GBPS", gflops);
+
+  void *pageable_memory = malloc(local_memory_size);
+  if (!pageable_memory) {
+    throw std::runtime_error("Failed to allocate pageable memory");
+  }
+  memcpy(pageable_memory, host_memory, local_memory_size);
+
+  gflops = 0;
+  if (context.sub_device_count) {
+    current_sub_device_id = 0;
+    for (auto i = 0; i < context.sub_device_count; i++) {
+      gflops +=
+          _transfer_bw_gpu_copy(context, dev_out_buf[i], pageable_memory,
+                                local_memory_size / context.sub_device_count);
+      current_sub_device_id++;
+    }
+    gflops = gflops / context.sub_device_count;
+  } else {
+    gflops = _transfer_bw_gpu_copy(context, device_buffer, pageable_memory,
+                                   local_memory_size);
+  }
+  std::cout << "enqueueWriteBuffer (pageable) : ";
+  std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "enqueueWriteBuffer (pageable)", "GBPS",
+                gflops);
+
+  gflops = 0;
+  if (context.sub_device_count) {
+    current_sub_device_id = 0;
+    for (auto i = 0; i < context.sub_device_count; i++) {
+      gflops +=
+          _transfer_bw_gpu_copy(context, pageable_memory, dev_out_buf[i],
+                                local_memory_size / context.sub_device_count);
+      current_sub_device_id++;
+    }
+    gflops = gflops / context.sub_device_count;
+  } else {
+    gflops = _transfer_bw_gpu_copy(context, pageable_memory, device_buffer,
+                                   local_memory_size);
+  }
+  std::cout << "enqueueReadBuffer (pageable) : ";
+  std::cout << gflops << " GBPS\n";
+  record_result("transfer_bw", "enqueueReadBuffer (pageable)", "GBPS", gflops);
 
   current_sub_device_id = 0;
 
+  if (transfer_chunks && context.sub_device_count) {
+    std::cout << "pipelined transfer skipping with explicit scaling\n";
+  } else if (transfer_chunks) {
+    const std::string chunks =
+        " (" + std::to_string(transfer_chunks) + " chunks)";
+    const struct {
+      const char *name;
+      bool to_device;
+      bool staged;
+    } pipelines[] = {
+        {"Pipelined Write pinned", true, false},
+        {"Pipelined Read pinned", false, false},
+        {"Pipelined Write pageable staged", true, true},
+        {"Pipelined Read pageable staged", false, true},
+    };
+    for (auto &pipeline : pipelines) {
+      void *host = pipeline.staged ? pageable_memory : host_memory;
+      gflops = _transfer_bw_pipelined(
+          context, pipeline.to_device ? device_buffer : host,
+          pipeline.to_device ? host : device_buffer, local_memory_size,
+          pipeline.to_device, pipeline.staged);
+      std::cout << pipeline.name << chunks << " : ";
+      std::cout << gflops << " GBPS\n";
+      record_result("transfer_bw", pipeline.name + chunks, "GBPS", gflops);
+    }
+  }
+
+  free(pageable_memory);
+
   _transfer_bw_shared_memory(context, local_memory_size, local_memory);
 
   if (context.sub_device_count) {
@@ -7,43 +7,34 @@
  */
 
 #include "../include/ze_peak.h"
+#include "../../common/include/clock_correlation.hpp"
 #include "../../common/include/common.hpp"
-#include "../../common/include/common.hpp"
+#include "../../common/include/trace.hpp"
 #include <iomanip>
+#include <sstream>
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 bool verbose = false;
 
 //---------------------------------------------------------------------
-// Utility function to load the binary spv file from a path
-// and return the file as a vector for use by L0.
+// Utility function to map the binary spv file from a path
+// for use by L0, without copying it.
 //---------------------------------------------------------------------
-std::vector<uint8_t> L0Context::load_binary_file(const std::string &file_path) {
+level_zero_tests::BinaryFile
+L0Context::load_binary_file(const std::string &file_path) {
+  module_path = file_path;
   if (verbose)
     std::cout << "File path: " << file_path << "\n";
-  std::ifstream stream(file_path, std::ios::in | std::ios::binary);
-
-  std::vector<uint8_t> binary_file;
-  if (!stream.good()) {
+  level_zero_tests::BinaryFile binary_file(file_path);
+  if (!binary_file.is_open()) {
     std::cerr << "Failed to load binary file: " << file_path << "\n";
-    return binary_file;
+  } else if (verbose) {
+    std::cout << "Binary file length: " << binary_file.size() << "\n";
   }
 
-  size_t length = 0;
-  stream.seekg(0, stream.end);
-  length = static_cast<size_t>(stream.tellg());
-  stream.seekg(0, stream.beg);
-  if (verbose)
-    std::cout << "Binary file length: " << length << "\n";
-
-  binary_file.resize(length);
-  stream.read(reinterpret_cast<char *>(binary_file.data()), length);
-  if (verbose)
-    std::cout << "Binary file loaded"
-              << "\n";
-  stream.close();
-
   return binary_file;
 }
 
@@ -63,12 +54,43 @@ void L0Context::reset_commandlist(ze_command_list_handle_t cmd_list) {
 }
 
 //---------------------------------------------------------------------
-// Utility function to create the L0 module from a binary file.
+// Utility function to create the module from a native binary built
+// ahead of time for the device, if there is one it accepts.
+//---------------------------------------------------------------------
+static bool create_native_module(ze_context_handle_t context,
+                                 ze_device_handle_t device,
+                                 const std::string &module_path,
+                                 ze_module_handle_t *module) {
+  for (auto &native_path : native_binary_paths(module_path)) {
+    level_zero_tests::BinaryFile native_binary(native_path);
+    if (native_binary.empty()) {
+      continue;
+    }
+
+    ze_module_desc_t module_description = {};
+    module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+    module_description.format = ZE_MODULE_FORMAT_NATIVE;
+    module_description.inputSize = native_binary.size();
+    module_description.pInputModule = native_binary.data();
+    if (zeModuleCreate(context, device, &module_description, module,
+                       nullptr) == ZE_RESULT_SUCCESS) {
+      if (verbose)
+        std::cout << "Module loaded from " << native_path << "\n";
+      return true;
+    }
+  }
+  return false;
+}
+
+//---------------------------------------------------------------------
+// Utility function to create the L0 module from a binary file, or from
+// the native binary of the device built ahead of time for it.
 // If successful, this function will set the context's module
 // handle to a valid value for use in future calls.
 // On error, an exception will be thrown describing the failure.
 //---------------------------------------------------------------------
-void L0Context::create_module(std::vector<uint8_t> binary_file) {
+void L0Context::create_module(
+    const level_zero_tests::BinaryFile &binary_file) {
   ze_result_t result = ZE_RESULT_SUCCESS;
   ze_module_desc_t module_description = {};
   module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
@@ -84,6 +106,11 @@ void L0Context::create_module(std::vector<uint8_t> binary_file) {
     subdevice_module.resize(sub_device_count);
     uint32_t i = 0;
     for (auto device : sub_devices) {
+      if (create_native_module(context, device, module_path,
+                               &subdevice_module[i])) {
+        i++;
+        continue;
+      }
       result = zeModuleCreate(context, device, &module_description,
                               &subdevice_module[i], nullptr);
       if (result) {
@@ -92,7 +119,7 @@ void L0Context::create_module(std::vector<uint8_t> binary_file) {
       }
       i++;
     }
-  } else {
+  } else if (!create_native_module(context, device, module_path, &module)) {
     result =
         zeModuleCreate(context, device, &module_description, &module, nullptr);
     if (result) {
@@ -728,6 +755,7 @@ uint64_t ZePeak::set_workgroups(L0Context &context,
 // On error, an exception will be thrown describing the failure.
 //---------------------------------------------------------------------
 void ZePeak::run_command_queue(L0Context &context) {
+  TraceSpan span("zeCommandQueueExecuteCommandLists", "submit");
   ze_result_t result = ZE_RESULT_SUCCESS;
   if (context.sub_device_count) {
     result = zeCommandQueueExecuteCommandLists(
@@ -752,6 +780,7 @@ void ZePeak::run_command_queue(L0Context &context) {
 // On error, an exception will be thrown describing the failure.
 //---------------------------------------------------------------------
 void ZePeak::synchronize_command_queue(L0Context &context) {
+  TraceSpan span("zeCommandQueueSynchronize", "sync");
   ze_result_t result = ZE_RESULT_SUCCESS;
   if (context.sub_device_count) {
     result = zeCommandQueueSynchronize(context.cmd_queue[current_sub_device_id],
@@ -769,14 +798,14 @@ void ZePeak::synchronize_command_queue(L0Context &context) {
   }
 }
 
-void single_event_pool_create(L0Context &context,
-                              ze_event_pool_handle_t *kernel_launch_event_pool,
-                              ze_event_pool_flags_t flags) {
+void event_pool_create(L0Context &context,
+                       ze_event_pool_handle_t *kernel_launch_event_pool,
+                       ze_event_pool_flags_t flags, uint32_t count) {
   ze_result_t result;
   ze_event_pool_desc_t kernel_launch_event_pool_desc = {};
   kernel_launch_event_pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
 
-  kernel_launch_event_pool_desc.count = 1;
+  kernel_launch_event_pool_desc.count = count;
   kernel_launch_event_pool_desc.flags = flags;
 
   kernel_launch_event_pool_desc.pNext = nullptr;
@@ -789,13 +818,19 @@ void single_event_pool_create(L0Context &context,
   }
 }
 
-void single_event_create(ze_event_pool_handle_t event_pool,
-                         ze_event_handle_t *event) {
+void single_event_pool_create(L0Context &context,
+                              ze_event_pool_handle_t *kernel_launch_event_pool,
+                              ze_event_pool_flags_t flags) {
+  event_pool_create(context, kernel_launch_event_pool, flags, 1);
+}
+
+void event_create(ze_event_pool_handle_t event_pool, ze_event_handle_t *event,
+                  uint32_t index) {
   ze_result_t result;
   ze_event_desc_t event_desc = {};
   event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
 
-  event_desc.index = 0;
+  event_desc.index = index;
   event_desc.signal = 0;
   event_desc.wait = 0;
 
@@ -805,23 +840,33 @@ void single_event_create(ze_event_pool_handle_t event_pool,
     throw std::runtime_error("zeEventCreate failed: " + std::to_string(result));
   }
 }
+
+void single_event_create(ze_event_pool_handle_t event_pool,
+                         ze_event_handle_t *event) {
+  event_create(event_pool, event, 0);
+}
 //---------------------------------------------------------------------
 // Utility function to execute a kernel function for a set of iterations
 // and measure the time elapsed based off the timing type.
 // This function takes a pre-calculated workgroup distribution
 // and will time the kernel executed given the timing type.
 // The current timing types supported are:
-//          BANDWIDTH -> Average time to execute the kernel for # iterations
+//          BANDWIDTH -> Average time to execute the kernel for # iterations,
+//                       with batch_size launches recorded per submission
 //          BANDWIDTH_EVENT_TIMING -> Average time to execute the kernel for #
 //                                    iterations using Level Zero Events
 //          KERNEL_LAUNCH_LATENCY->Average time to execute the kernel on
 //                                  the command list
 //          KERNEL_COMPLETE_LATENCY - Average time to execute a given kernel
 //                                  for # iterations.
+// The latency types also record every iteration into host_call_samples,
+// submit_to_start_samples and start_to_end_samples, and the phases of the
+// dispatch into host_append_samples, doorbell_to_start_samples and
+// end_to_wakeup_samples.
 // On success, the average time in microseconds is returned.
 // On error, an exception will be thrown describing the failure.
 //---------------------------------------------------------------------
-long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
+long double ZePeak::run_kernel(L0Context &context, ze_kernel_handle_t &function,
                                struct ZeWorkGroups &workgroup_info,
                                TimingMeasurement type,
                                bool reset_command_list) {
@@ -838,52 +883,71 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
   if (verbose)
     std::cout << "Group size set\n";
 
-  Timer<std::chrono::nanoseconds::period> timer;
+  if (monitor_power)
+    power_monitor.begin();
+  metric_profiler.begin();
+
+  last_device_time = 0;
+  last_tile_times.clear();
+  /* Grow the sample storage up front so the timed loops do not allocate */
+  iteration_times.reserve(iteration_times.size() + iters);
 
   if (type == TimingMeasurement::BANDWIDTH) {
-    if (context.sub_device_count) {
-      SUCCESS_OR_TERMINATE(
-          zeCommandListReset(context.cmd_list[current_sub_device_id]));
-    } else {
-      SUCCESS_OR_TERMINATE(zeCommandListReset(context.command_list));
+    ze_event_pool_handle_t timestamp_event_pool = nullptr;
+    std::vector<ze_event_handle_t> timestamp_events;
+
+    if (use_device_timestamps) {
+      event_pool_create(context, &timestamp_event_pool,
+                        ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
+                            ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP,
+                        batch_size);
+      timestamp_events.resize(batch_size);
+      for (uint32_t j = 0; j < batch_size; j++) {
+        event_create(timestamp_event_pool, &timestamp_events[j], j);
+      }
+      if (verbose)
+        std::cout << "Timestamp Events Created\n";
     }
 
+    ze_command_list_handle_t command_list =
+        context.sub_device_count ? context.cmd_list[current_sub_device_id]
+                                 : context.command_list;
+
+    SUCCESS_OR_TERMINATE(zeCommandListReset(command_list));
+
     if (context.sub_device_count) {
       if (verbose) {
         std::cout << "current_sub_device_id value is ::"
                   << current_sub_device_id << std::endl;
       }
-      result = zeCommandListAppendLaunchKernel(
-          context.cmd_list[current_sub_device_id], function,
-          &workgroup_info.thread_group_dimensions, nullptr, 0, nullptr);
-      if (result) {
-        throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
-                                 std::to_string(result));
+    }
+
+    // Record batch_size back to back launches so that a single submission
+    // amortizes the submission cost over all of them.
+    for (uint32_t j = 0; j < batch_size; j++) {
+      if (j && batch_barrier) {
+        result = zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr);
+        if (result) {
+          throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                                   std::to_string(result));
+        }
       }
-    } else {
       result = zeCommandListAppendLaunchKernel(
-          context.command_list, function,
-          &workgroup_info.thread_group_dimensions, nullptr, 0, nullptr);
+          command_list, function, &workgroup_info.thread_group_dimensions,
+          timestamp_events.empty() ? nullptr : timestamp_events[j], 0,
+          nullptr);
       if (result) {
         throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
                                  std::to_string(result));
       }
     }
     if (verbose)
-      std::cout << "Function launch appended\n";
+      std::cout << "Function launch appended " << batch_size << " times\n";
 
-    if (context.sub_device_count) {
-      result = zeCommandListClose(context.cmd_list[current_sub_device_id]);
-      if (result) {
-        throw std::runtime_error("zeCommandListClose failed: " +
-                                 std::to_string(result));
-      }
-    } else {
-      result = zeCommandListClose(context.command_list);
-      if (result) {
-        throw std::runtime_error("zeCommandListClose failed: " +
-                                 std::to_string(result));
-      }
+    result = zeCommandListClose(command_list);
+    if (result) {
+      throw std::runtime_error("zeCommandListClose failed: " +
+                               std::to_string(result));
     }
     if (verbose)
       std::cout << "Command list closed\n";
@@ -903,10 +967,17 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
       } else {
         synchronize_command_queue(context);
       }
+
+      for (auto event : timestamp_events) {
+        SUCCESS_OR_TERMINATE(zeEventHostSynchronize(event, UINT64_MAX));
+        SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+      }
     }
 
-    timer.start();
+    long double device_timed = 0;
+    Timer<std::chrono::nanoseconds::period> iteration_timer;
     for (uint32_t i = 0; i < iters; i++) {
+      iteration_timer.start();
       run_command_queue(context);
 
       if (context.sub_device_count) {
@@ -921,8 +992,31 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
       } else {
         synchronize_command_queue(context);
       }
+
+      long double iteration_time = iteration_timer.stopAndTime();
+      timed += iteration_time;
+      iteration_times.push_back(iteration_time / batch_size);
+
+      // The launches signal the events, so the timestamps of this iteration
+      // have to be read back before the list is submitted again. The host
+      // time stops before it, so the readback is not billed to the launches.
+      for (auto event : timestamp_events) {
+        SUCCESS_OR_TERMINATE(zeEventHostSynchronize(event, UINT64_MAX));
+        device_timed += context_time_in_us(context, event) * 1000;
+        SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+      }
+    }
+    // Report the time of a single launch out of the batch
+    timed /= batch_size;
+
+    if (!timestamp_events.empty()) {
+      last_device_time =
+          device_timed / (static_cast<long double>(iters) * batch_size);
+      for (auto event : timestamp_events) {
+        zeEventDestroy(event);
+      }
+      zeEventPoolDestroy(timestamp_event_pool);
     }
-    timed = timer.stopAndTime();
   } else if (type == TimingMeasurement::BANDWIDTH_EVENT_TIMING) {
     ze_event_pool_handle_t event_pool;
     ze_event_handle_t function_event;
@@ -1062,7 +1156,9 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
                                  std::to_string(result));
       }
 
-      timed += context_time_in_us(context, function_event);
+      long double event_time = context_time_in_us(context, function_event);
+      timed += event_time;
+      iteration_times.push_back(event_time);
 
       if (context.sub_device_count) {
         if (context.sub_device_count == current_sub_device_id + 1) {
@@ -1093,6 +1189,18 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
   } else if (type == TimingMeasurement::KERNEL_LAUNCH_LATENCY) {
     ze_event_handle_t kernel_launch_event;
     ze_event_pool_handle_t kernel_launch_event_pool;
+    Timer<std::chrono::nanoseconds::period> host_timer;
+    host_call_samples.clear();
+    submit_to_start_samples.clear();
+    start_to_end_samples.clear();
+    host_append_samples.clear();
+    doorbell_to_start_samples.clear();
+    end_to_wakeup_samples.clear();
+    host_call_samples.reserve(iters);
+    submit_to_start_samples.reserve(iters);
+    start_to_end_samples.reserve(iters);
+    doorbell_to_start_samples.reserve(iters);
+    end_to_wakeup_samples.reserve(iters);
 
     single_event_pool_create(context, &kernel_launch_event_pool,
                              ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
@@ -1124,11 +1232,14 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
       SUCCESS_OR_TERMINATE(zeCommandListReset(context.command_list));
     }
 
+    if (context.sub_device_count && verbose) {
+      std::cout << "current_sub_device_id value is ::" << current_sub_device_id
+                << std::endl;
+    }
+    // The list is recorded once and submitted every iteration, so its
+    // append is a single sample
+    host_timer.start();
     if (context.sub_device_count) {
-      if (verbose) {
-        std::cout << "current_sub_device_id value is ::"
-                  << current_sub_device_id << std::endl;
-      }
       result = zeCommandListAppendLaunchKernel(
           context.cmd_list[current_sub_device_id], function,
           &workgroup_info.thread_group_dimensions, kernel_launch_event, 0,
@@ -1148,6 +1259,8 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
       }
     }
 
+    host_append_samples.push_back(host_timer.stopAndTime() / 1e3);
+
     if (verbose)
       std::cout << "Function launch appended\n";
 
@@ -1235,40 +1348,36 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
         std::cout << "Event Reset\n";
     }
 
+    // Sampled every iteration, which also fits the drift of the device
+    // clock for the verbose output
+    ClockCorrelation correlation(context.device);
     for (uint32_t i = 0; i < iters; i++) {
-      uint64_t host_timestamp = 0;
-      uint64_t device_timestamp = 0;
-      result = zeDeviceGetGlobalTimestamps(context.device, &host_timestamp,
-                                           &device_timestamp);
-      if (result) {
-        throw std::runtime_error("zeDeviceGetGlobalTimestamps failed: " +
-                                 std::to_string(result));
-      }
+      const uint64_t device_timestamp = correlation.sample().device_ticks;
 
+      host_timer.start();
       if (context.sub_device_count) {
         result = zeCommandQueueExecuteCommandLists(
             context.cmd_queue[current_sub_device_id], 1,
             &context.cmd_list[current_sub_device_id], nullptr);
-        if (result) {
-          throw std::runtime_error(
-              "zeCommandQueueExecuteCommandLists failed: " +
-              std::to_string(result));
-        }
       } else {
         result = zeCommandQueueExecuteCommandLists(
             context.command_queue, 1, &context.command_list, nullptr);
-        if (result) {
-          throw std::runtime_error(
-              "zeCommandQueueExecuteCommandLists failed: " +
-              std::to_string(result));
-        }
       }
+      host_call_samples.push_back(host_timer.stopAndTime() / 1e3);
+      if (result) {
+        throw std::runtime_error("zeCommandQueueExecuteCommandLists failed: " +
+                                 std::to_string(result));
+      }
+      // Device clock once the call has rung the doorbell and returned
+      const uint64_t doorbell_timestamp = correlation.sample().device_ticks;
 
       result = zeEventHostSynchronize(kernel_launch_event, UINT64_MAX);
       if (result) {
         throw std::runtime_error("zeEventHostSynchronize failed: " +
                                  std::to_string(result));
       }
+      // and once the host thread has woken up on the completion
+      const uint64_t wakeup_timestamp = correlation.sample().device_ticks;
 
       ze_kernel_timestamp_result_t kernel_timestamp;
       result =
@@ -1278,14 +1387,30 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
                                  std::to_string(result));
       }
 
-      // don't know if this is correct.  seems a little odd.
-      uint64_t timestamp_mask = (1ull << timestamp_bits) - 1;
-      uint64_t masked_device_time = device_timestamp & timestamp_mask;
-      uint64_t masked_kernel_time =
-          kernel_timestamp.global.kernelStart & timestamp_mask;
-
-      timed += (masked_kernel_time - masked_device_time) * timer_resolution_ns /
-               1e3; // returned in microseconds
+      // Both timestamps cut to the narrower of the two counters, which
+      // may have wrapped between them
+      long double submit_to_start =
+          ClockCorrelation::elapsed_ticks(device_timestamp,
+                                          kernel_timestamp.global.kernelStart,
+                                          timestamp_bits) *
+          timer_resolution_ns / 1e3; // returned in microseconds
+      timed += submit_to_start;
+      iteration_times.push_back(submit_to_start);
+      submit_to_start_samples.push_back(submit_to_start);
+      // The kernel may start before the doorbell sample is taken, which
+      // counts as no delay rather than a wrap of the counter
+      doorbell_to_start_samples.push_back(
+          std::max<int64_t>(0, ClockCorrelation::signed_elapsed_ticks(
+                                   doorbell_timestamp,
+                                   kernel_timestamp.global.kernelStart,
+                                   timestamp_bits)) *
+          timer_resolution_ns / 1e3);
+      end_to_wakeup_samples.push_back(
+          ClockCorrelation::elapsed_ticks(kernel_timestamp.global.kernelEnd,
+                                          wakeup_timestamp, timestamp_bits) *
+          timer_resolution_ns / 1e3);
+      start_to_end_samples.push_back(
+          context_time_in_us(context, kernel_launch_event));
 
       result = zeEventHostReset(kernel_launch_event);
       if (result) {
@@ -1311,12 +1436,28 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
     if (verbose)
       std::cout << "Command queue synchronized\n";
 
+    if (verbose)
+      std::cout << "Device clock drift: " << correlation.drift_ppm()
+                << " ppm over " << correlation.samples() << " samples\n";
+
     zeEventDestroy(kernel_launch_event);
     zeEventPoolDestroy(kernel_launch_event_pool);
 
   } else if (type == TimingMeasurement::IMMEDIATE_KERNEL_LAUNCH_LATENCY) {
     ze_event_handle_t kernel_launch_event;
     ze_event_pool_handle_t kernel_launch_event_pool;
+    Timer<std::chrono::nanoseconds::period> host_timer;
+    host_call_samples.clear();
+    submit_to_start_samples.clear();
+    start_to_end_samples.clear();
+    host_append_samples.clear();
+    doorbell_to_start_samples.clear();
+    end_to_wakeup_samples.clear();
+    host_call_samples.reserve(iters);
+    submit_to_start_samples.reserve(iters);
+    start_to_end_samples.reserve(iters);
+    doorbell_to_start_samples.reserve(iters);
+    end_to_wakeup_samples.reserve(iters);
 
     single_event_pool_create(context, &kernel_launch_event_pool,
                              ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
@@ -1417,41 +1558,39 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
       }
     }
 
+    // Sampled every iteration, which also fits the drift of the device
+    // clock for the verbose output
+    ClockCorrelation correlation(context.device);
     for (uint32_t i = 0; i < iters; i++) {
-      uint64_t host_timestamp = 0;
-      uint64_t device_timestamp = 0;
-      result = zeDeviceGetGlobalTimestamps(context.device, &host_timestamp,
-                                           &device_timestamp);
-      if (result) {
-        throw std::runtime_error("zeDeviceGetGlobalTimestamps failed: " +
-                                 std::to_string(result));
-      }
+      const uint64_t device_timestamp = correlation.sample().device_ticks;
 
+      host_timer.start();
       if (context.sub_device_count) {
         result = zeCommandListAppendLaunchKernel(
             context.immediate_cmd_list[current_sub_device_id], function,
             &workgroup_info.thread_group_dimensions, kernel_launch_event, 0,
             nullptr);
-        if (result) {
-          throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
-                                   std::to_string(result));
-        }
       } else {
         result = zeCommandListAppendLaunchKernel(
             context.immediate_command_list, function,
             &workgroup_info.thread_group_dimensions, kernel_launch_event, 0,
             nullptr);
-        if (result) {
-          throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
-                                   std::to_string(result));
-        }
       }
+      host_call_samples.push_back(host_timer.stopAndTime() / 1e3);
+      if (result) {
+        throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                                 std::to_string(result));
+      }
+      // Device clock once the call has rung the doorbell and returned
+      const uint64_t doorbell_timestamp = correlation.sample().device_ticks;
 
       result = zeEventHostSynchronize(kernel_launch_event, UINT64_MAX);
       if (result) {
         throw std::runtime_error("zeEventHostSynchronize failed: " +
                                  std::to_string(result));
       }
+      // and once the host thread has woken up on the completion
+      const uint64_t wakeup_timestamp = correlation.sample().device_ticks;
 
       ze_kernel_timestamp_result_t kernel_timestamp;
       result =
@@ -1461,13 +1600,30 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
                                  std::to_string(result));
       }
 
-      uint64_t timestamp_mask = (1ull << timestamp_bits) - 1;
-      uint64_t masked_device_time = device_timestamp & timestamp_mask;
-      uint64_t masked_kernel_time =
-          kernel_timestamp.global.kernelStart & timestamp_mask;
-
-      timed += (masked_kernel_time - masked_device_time) * timer_resolution_ns /
-               1e3; // returned in microseconds
+      // Both timestamps cut to the narrower of the two counters, which
+      // may have wrapped between them
+      long double submit_to_start =
+          ClockCorrelation::elapsed_ticks(device_timestamp,
+                                          kernel_timestamp.global.kernelStart,
+                                          timestamp_bits) *
+          timer_resolution_ns / 1e3; // returned in microseconds
+      timed += submit_to_start;
+      iteration_times.push_back(submit_to_start);
+      submit_to_start_samples.push_back(submit_to_start);
+      // The kernel may start before the doorbell sample is taken, which
+      // counts as no delay rather than a wrap of the counter
+      doorbell_to_start_samples.push_back(
+          std::max<int64_t>(0, ClockCorrelation::signed_elapsed_ticks(
+                                   doorbell_timestamp,
+                                   kernel_timestamp.global.kernelStart,
+                                   timestamp_bits)) *
+          timer_resolution_ns / 1e3);
+      end_to_wakeup_samples.push_back(
+          ClockCorrelation::elapsed_ticks(kernel_timestamp.global.kernelEnd,
+                                          wakeup_timestamp, timestamp_bits) *
+          timer_resolution_ns / 1e3);
+      start_to_end_samples.push_back(
+          context_time_in_us(context, kernel_launch_event));
 
       result = zeEventHostReset(kernel_launch_event);
       if (result) {
@@ -1493,12 +1649,22 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
     if (verbose)
       std::cout << "Command queue synchronized\n";
 
+    if (verbose)
+      std::cout << "Device clock drift: " << correlation.drift_ppm()
+                << " ppm over " << correlation.samples() << " samples\n";
+
     zeEventDestroy(kernel_launch_event);
     zeEventPoolDestroy(kernel_launch_event_pool);
 
   } else if (type == TimingMeasurement::KERNEL_COMPLETE_RUNTIME) {
     ze_event_pool_handle_t event_pool;
     ze_event_handle_t kernel_duration_event;
+    host_call_samples.clear();
+    submit_to_start_samples.clear();
+    start_to_end_samples.clear();
+    host_call_samples.reserve(iters);
+    submit_to_start_samples.reserve(iters);
+    start_to_end_samples.reserve(iters);
 
     single_event_pool_create(context, &event_pool,
                              ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
@@ -1580,7 +1746,10 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
                                  std::to_string(result));
       }
 
-      timed += context_time_in_us(context, kernel_duration_event);
+      long double duration = context_time_in_us(context, kernel_duration_event);
+      timed += duration;
+      iteration_times.push_back(duration);
+      start_to_end_samples.push_back(duration);
 
       result = zeEventHostReset(kernel_duration_event);
       if (result) {
@@ -1612,6 +1781,112 @@ long double ZePeak::run_kernel(L0Context context, ze_kernel_handle_t &function,
   return (timed / static_cast<long double>(iters));
 }
 
+//---------------------------------------------------------------------
+// Utility function to execute one kernel per sub-device at the same time.
+// Every sub-device gets its own host thread which records batch_size
+// launches into the sub-device command list and then submits and
+// synchronizes it for # iterations, starting together with the other
+// threads. The per launch time observed by every thread is stored in
+// last_tile_times, while the returned value is the per launch wall time
+// in nanoseconds spanning all the sub-devices.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+long double
+ZePeak::run_kernel_concurrent(L0Context &context,
+                              std::vector<ze_kernel_handle_t> &functions,
+                              struct ZeWorkGroups &workgroup_info) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  const uint32_t tile_count = context.sub_device_count;
+
+  if (monitor_power)
+    power_monitor.begin();
+  metric_profiler.begin();
+
+  for (auto function : functions) {
+    result = zeKernelSetGroupSize(function, workgroup_info.group_size_x,
+                                  workgroup_info.group_size_y,
+                                  workgroup_info.group_size_z);
+    if (result) {
+      throw std::runtime_error("zeKernelSetGroupSize failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  for (uint32_t tile = 0; tile < tile_count; tile++) {
+    ze_command_list_handle_t command_list = context.cmd_list[tile];
+    SUCCESS_OR_TERMINATE(zeCommandListReset(command_list));
+    for (uint32_t j = 0; j < batch_size; j++) {
+      if (j && batch_barrier) {
+        SUCCESS_OR_TERMINATE(
+            zeCommandListAppendBarrier(command_list, nullptr, 0, nullptr));
+      }
+      SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+          command_list, functions[tile],
+          &workgroup_info.thread_group_dimensions, nullptr, 0, nullptr));
+    }
+    SUCCESS_OR_TERMINATE(zeCommandListClose(command_list));
+  }
+  if (verbose)
+    std::cout << "Function launches appended on " << tile_count
+              << " sub devices\n";
+
+  std::atomic<uint32_t> ready_count(0);
+  std::atomic<bool> start(false);
+  std::vector<long double> tile_times(tile_count, 0);
+  std::vector<std::thread> threads;
+
+  for (uint32_t tile = 0; tile < tile_count; tile++) {
+    threads.emplace_back([&, tile]() {
+      Timer<std::chrono::nanoseconds::period> tile_timer;
+      ze_command_queue_handle_t command_queue = context.cmd_queue[tile];
+
+      for (uint32_t i = 0; i < warmup_iterations; i++) {
+        SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+            command_queue, 1, &context.cmd_list[tile], nullptr));
+        SUCCESS_OR_TERMINATE(
+            zeCommandQueueSynchronize(command_queue, UINT64_MAX));
+      }
+
+      ready_count++;
+      while (!start) {
+        std::this_thread::yield();
+      }
+
+      tile_timer.start();
+      for (uint32_t i = 0; i < iters; i++) {
+        SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+            command_queue, 1, &context.cmd_list[tile], nullptr));
+        SUCCESS_OR_TERMINATE(
+            zeCommandQueueSynchronize(command_queue, UINT64_MAX));
+      }
+      tile_times[tile] = tile_timer.stopAndTime();
+    });
+  }
+
+  while (ready_count < tile_count) {
+    std::this_thread::yield();
+  }
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  timer.start();
+  start = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  long double timed = timer.stopAndTime();
+
+  const long double launches = static_cast<long double>(iters) * batch_size;
+  last_device_time = 0;
+  last_concurrent_time = timed / launches;
+  last_tile_times.resize(tile_count);
+  for (uint32_t tile = 0; tile < tile_count; tile++) {
+    last_tile_times[tile] = tile_times[tile] / launches;
+    context.reset_commandlist(context.cmd_list[tile]);
+  }
+
+  return (timed / launches);
+}
+
 //---------------------------------------------------------------------
 // Utility function to setup a kernel function with an input & output
 // argument. On error, an exception will be thrown describing the failure.
@@ -1686,6 +1961,96 @@ void ZePeak::print_test_complete() {
   std::cout << "<<<<<<<<<<<<<<<<<<<<<<<<<<<<\n";
 }
 
+//---------------------------------------------------------------------
+// Runs each test requested on an initialized context, also when ze_peak
+// is built into another binary with EXCLUDE_MAIN.
+//---------------------------------------------------------------------
+void ZePeak::run_tests(L0Context &context) {
+  if (monitor_power && !power_monitor.init(context)) {
+    std::cout << "power monitoring skipping for missing support: "
+              << "no sysman power or frequency domains\n";
+    monitor_power = false;
+  }
+  if (metric_profiler.enabled() &&
+      !metric_profiler.init(context.context, context.device)) {
+    std::cout << "metric profiling skipping for missing support: "
+              << "no time based metric group of that name\n";
+  }
+
+  if (run_global_bw)
+    ze_peak_global_bw(context);
+
+  if (run_global_bw_sweep)
+    ze_peak_global_bw_sweep(context);
+
+  if (run_local_bw)
+    ze_peak_local_bw(context);
+
+  if (run_mem_latency)
+    ze_peak_mem_latency(context);
+
+  if (run_hp_compute)
+    ze_peak_hp_compute(context);
+
+  if (run_sp_compute)
+    ze_peak_sp_compute(context);
+
+  if (run_dp_compute)
+    ze_peak_dp_compute(context);
+
+  if (run_int_compute)
+    ze_peak_int_compute(context);
+
+  if (run_matrix_compute)
+    ze_peak_matrix_compute(context);
+
+  if (run_atomics)
+    ze_peak_atomics(context);
+
+  if (run_transfer_bw)
+    ze_peak_transfer_bw(context);
+
+  if (run_kernel_lat)
+    ze_peak_kernel_latency(context);
+}
+
+//---------------------------------------------------------------------
+// Runs each test requested with implicit scaling on the initialized
+// root device context, then again with explicit scaling on a second
+// context driving all sub devices concurrently, and prints the two side
+// by side. Stages that skip explicit scaling have no explicit result.
+//---------------------------------------------------------------------
+void ZePeak::run_scaling_comparison(L0Context &context) {
+  uint32_t sub_device_count = 0;
+  zeDeviceGetSubDevices(context.device, &sub_device_count, nullptr);
+  if (sub_device_count == 0) {
+    std::cout << "scaling comparison skipping for missing sub devices\n";
+    run_tests(context);
+    return;
+  }
+
+  std::cout << "\nImplicit scaling: root device\n";
+  scaling_mode = "implicit";
+  run_tests(context);
+
+  std::cout << "\nExplicit scaling: " << sub_device_count
+            << " sub devices concurrently\n";
+  L0Context explicit_context;
+  explicit_context.verbose = verbose;
+  explicit_context.init_xe(specified_driver, specified_device, false, true,
+                           enable_fixed_ordinal_index,
+                           command_queue_group_ordinal, command_queue_index);
+  const bool concurrent = concurrent_sub_devices;
+  concurrent_sub_devices = true;
+  scaling_mode = "explicit";
+  run_tests(explicit_context);
+  concurrent_sub_devices = concurrent;
+  scaling_mode.clear();
+  explicit_context.clean_xe();
+
+  print_scaling_comparison(sub_device_count);
+}
+
 //---------------------------------------------------------------------
 // Main function which calls the argument parsing and calls each
 // test requested.
@@ -1698,9 +2063,20 @@ int main(int argc, char **argv) {
   peak_benchmark.parse_arguments(argc, argv);
   context.verbose = peak_benchmark.verbose;
 
+  if (peak_benchmark.monitor_power ||
+      HostPlacement::needs_sysman(argc, argv)) {
+    static char sys_env[] = "ZES_ENABLE_SYSMAN=1";
+    putenv(sys_env);
+  }
+  if (MetricProfiler::needs_metrics(argc, argv)) {
+    static char metrics_env[] = "ZET_ENABLE_METRICS=1";
+    putenv(metrics_env);
+  }
+
   context.init_xe(peak_benchmark.specified_driver,
                   peak_benchmark.specified_device, peak_benchmark.query_engines,
-                  peak_benchmark.enable_explicit_scaling,
+                  peak_benchmark.enable_explicit_scaling &&
+                      !peak_benchmark.compare_scaling,
                   peak_benchmark.enable_fixed_ordinal_index,
                   peak_benchmark.command_queue_group_ordinal,
                   peak_benchmark.command_queue_index);
@@ -1709,26 +2085,16 @@ int main(int argc, char **argv) {
     return 0;
   }
 
-  if (peak_benchmark.run_global_bw)
-    peak_benchmark.ze_peak_global_bw(context);
-
-  if (peak_benchmark.run_hp_compute)
-    peak_benchmark.ze_peak_hp_compute(context);
-
-  if (peak_benchmark.run_sp_compute)
-    peak_benchmark.ze_peak_sp_compute(context);
+  peak_benchmark.placement.apply(context.device);
+  std::cout << peak_benchmark.placement.describe() << "\n";
 
-  if (peak_benchmark.run_dp_compute)
-    peak_benchmark.ze_peak_dp_compute(context);
-
-  if (peak_benchmark.run_int_compute)
-    peak_benchmark.ze_peak_int_compute(context);
-
-  if (peak_benchmark.run_transfer_bw)
-    peak_benchmark.ze_peak_transfer_bw(context);
+  if (peak_benchmark.compare_scaling) {
+    peak_benchmark.run_scaling_comparison(context);
+  } else {
+    peak_benchmark.run_tests(context);
+  }
 
-  if (peak_benchmark.run_kernel_lat)
-    peak_benchmark.ze_peak_kernel_latency(context);
+  peak_benchmark.write_results(context);
 
   context.clean_xe();
 
@@ -1777,6 +2143,127 @@ TimingMeasurement ZePeak::is_bandwidth_with_event_timer(void) {
   }
 }
 
+std::string ZePeak::device_rate(long double device_time, long double work,
+                                const char *unit) {
+  if (!use_device_timestamps ||
+      is_bandwidth_with_event_timer() != TimingMeasurement::BANDWIDTH ||
+      device_time <= 0) {
+    return "";
+  }
+  std::ostringstream rate;
+  rate << " (device: " << calculate_gbps(device_time, work) << " " << unit
+       << ")";
+  return rate.str();
+}
+
+std::string ZePeak::tile_rates(const std::vector<long double> &tile_times,
+                               long double work, const char *unit) {
+  if (!concurrent_sub_devices || tile_times.empty()) {
+    return "";
+  }
+  std::ostringstream rates;
+  rates << " [";
+  for (size_t tile = 0; tile < tile_times.size(); tile++) {
+    rates << (tile ? ", " : "") << "tile " << tile << ": "
+          << calculate_gbps(tile_times[tile], work) << " " << unit;
+  }
+  rates << "]";
+  return rates.str();
+}
+
+//---------------------------------------------------------------------
+// Utility function to print the p50/p90/p99/p99.9/max of per iteration
+// latency samples in microseconds and, with --histogram, the count of
+// samples falling in every power of two microsecond bucket.
+//---------------------------------------------------------------------
+void ZePeak::print_latency_breakdown(const char *name,
+                                     std::vector<long double> &samples) {
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+
+  const double percentiles[] = {50, 90, 99, 99.9};
+  const char *labels[] = {"p50", "p90", "p99", "p99.9"};
+  std::cout << "    " << name << " :";
+  for (int i = 0; i < 4; i++) {
+    std::cout << " " << labels[i] << " "
+              << sorted_percentile(samples, percentiles[i]);
+  }
+  std::cout << " max " << samples.back() << " (us)\n";
+
+  if (!latency_histogram) {
+    return;
+  }
+  long double bucket_end = 1;
+  while (bucket_end / 2 > samples.front() && bucket_end > 1e-3) {
+    bucket_end /= 2;
+  }
+  size_t i = 0;
+  while (i < samples.size()) {
+    size_t count = 0;
+    while (i < samples.size() && samples[i] < bucket_end) {
+      count++;
+      i++;
+    }
+    if (count) {
+      std::cout << "      [" << bucket_end / 2 << ", " << bucket_end
+                << ") us : " << count << "\n";
+    }
+    bucket_end *= 2;
+  }
+}
+
+//---------------------------------------------------------------------
+// Utility function to print the p50 of every phase of a kernel dispatch
+// with its share of their sum, and the phase that dominates it. Each
+// phase is recorded as "<list_name> <phase>" with its samples.
+//---------------------------------------------------------------------
+void ZePeak::print_dispatch_decomposition(
+    const std::string &list_name,
+    std::vector<std::pair<const char *, std::vector<long double>>> &phases) {
+  std::vector<long double> medians;
+  long double total = 0;
+  for (auto &phase : phases) {
+    std::vector<long double> &samples = phase.second;
+    const long double median = sample_median(samples);
+    medians.push_back(median);
+    total += median;
+  }
+  if (total <= 0) {
+    return;
+  }
+
+  std::cout << "    dispatch decomposition, p50 (us):\n";
+  size_t dominant = 0;
+  for (size_t i = 0; i < phases.size(); i++) {
+    if (phases[i].second.empty()) {
+      continue;
+    }
+    std::cout << "      " << std::left << std::setw(20) << phases[i].first
+              << std::right << " : " << std::setw(10) << medians[i]
+              << std::setw(8) << std::fixed << std::setprecision(1)
+              << medians[i] * 100 / total << "%\n"
+              << std::defaultfloat << std::setprecision(6);
+    if (medians[i] > medians[dominant]) {
+      dominant = i;
+    }
+
+    /* power per phase would break the table, it is in --json / --csv */
+    print_power = false;
+    iteration_times = phases[i].second;
+    record_result("kernel_lat", list_name + " " + phases[i].first, "us",
+                  medians[i]);
+    print_power = true;
+  }
+  std::cout << "      " << std::left << std::setw(20) << "total" << std::right
+            << " : " << std::setw(10) << total << "\n";
+  std::cout << "      dominant phase: " << phases[dominant].first << " ("
+            << std::fixed << std::setprecision(1)
+            << medians[dominant] * 100 / total << "%)\n"
+            << std::defaultfloat << std::setprecision(6);
+}
+
 long double ZePeak::calculate_gbps(long double period,
                                    long double buffer_size) {
   period /= 1e9;                          // seconds
@@ -1794,6 +2281,7 @@ long double ZePeak::context_time_in_us(L0Context &context,
     throw std::runtime_error("zeEventQueryKernelTimestamp failed: " +
                              std::to_string(result));
   }
+  Trace::instance().device_span(context.device, "kernel", ts_result);
 
   const uint64_t timestamp_freq = context.device_property.timerResolution;
   const uint64_t timestamp_max_value =
@@ -21,12 +21,16 @@
 #include <unordered_map>
 #include <utility>
 #include "common.hpp"
+#include "host_placement.hpp"
+#include "trace.hpp"
 #include "ze_app.hpp"
 #include <unistd.h>
 #include <iostream>
 #include <cstdlib>
 #include <signal.h>
 #include <level_zero/ze_api.h>
+#include <level_zero/zes_api.h>
+#include <deque>
 
 typedef enum _peer_transfer_t {
   PEER_WRITE = 0,
@@ -38,12 +42,78 @@ typedef enum _peer_test_t {
   PEER_LATENCY,
   PEER_TEST_MAX
 } peer_test_t;
+typedef enum _peer_collective_t {
+  PEER_ALL_GATHER = 0,
+  PEER_REDUCE_SCATTER,
+  PEER_BROADCAST,
+  PEER_ALL_TO_ALL,
+  PEER_COLLECTIVE_MAX
+} peer_collective_t;
+typedef enum _peer_kernel_copy_t {
+  PEER_KERNEL_COPY_ULONG = 0,
+  PEER_KERNEL_COPY_ULONG2,
+  PEER_KERNEL_COPY_ULONG4,
+  PEER_KERNEL_COPY_ULONG8,
+  PEER_KERNEL_COPY_BLOCK,
+  PEER_KERNEL_COPY_MAX
+} peer_kernel_copy_t;
+typedef enum _peer_ipc_pattern_t {
+  PEER_IPC_FAN_IN = 0,
+  PEER_IPC_RING
+} peer_ipc_pattern_t;
+
+/* Id of -s and -d given as device.subdevice, until resolved to the index of
+ * the subdevice in the device list */
+const uint32_t peer_subdevice_id_flag = 0x80000000u;
+inline uint32_t peer_subdevice_id(uint32_t device_id, uint32_t subdevice_id) {
+  return peer_subdevice_id_flag | (device_id << 16) | subdevice_id;
+}
+
+/* Largest buffer of the default size sweep */
+extern const size_t max_number_of_elements;
 
 typedef struct _ze_peer_device_t {
   std::vector<std::pair<ze_command_queue_handle_t, ze_command_list_handle_t>>
       engines;
 } ze_peer_device_t;
 
+typedef struct _ze_peer_fabric_port_t {
+  uint32_t device_id;
+  int subdevice_id;
+  uint32_t port_number;
+  zes_fabric_port_handle_t handle;
+  zes_fabric_port_throughput_t first;
+  zes_fabric_port_throughput_t last;
+} ze_peer_fabric_port_t;
+
+/* Rolling statistics and link health of the results of option -c */
+class ZePeerTelemetry {
+public:
+  void add(ZeApp *benchmark, peer_test_t type, long double value);
+  void print_summary();
+
+  static volatile sig_atomic_t interrupted;
+  static uint32_t window_size;
+  static uint32_t report_period_sec;
+
+private:
+  void query_fabric_ports(ZeApp *benchmark);
+  void print_fabric_ports(bool since_start);
+  void print_window();
+
+  peer_test_t test_type = PEER_BANDWIDTH;
+  std::deque<long double> window;
+  uint64_t total_count = 0;
+  long double total_sum = 0;
+  long double total_min = 0;
+  long double total_max = 0;
+  bool fabric_ports_queried = false;
+  std::vector<ze_peer_fabric_port_t> fabric_ports;
+  Timer<std::chrono::nanoseconds::period> report_timer;
+};
+
+void telemetry_handler(int signal);
+
 static const char *usage_str =
     "\nze_peer: Level Zero microbenchmark to analyze the P2P performance\n"
     "of a multi-GPU system.\n"
@@ -59,6 +129,15 @@ static const char *usage_str =
     "\n  -b                          run bidirectional mode. Default: Not set."
     "\n  -c                          run continuously until hitting CTRL+C. "
     "Default: Not set."
+    "\n                              Prints min/avg/max/p99 of the last "
+    "results and the"
+    "\n                              fabric port throughput and health "
+    "periodically, and"
+    "\n                              a summary on CTRL+C."
+    "\n  --window                    results in the rolling statistics of "
+    "-c. Default: 100."
+    "\n  --report_period             seconds between the reports of -c. "
+    "Default: 10."
     "\n  -i                          number of iterations to run. Default: 50."
     "\n  -z                          size to run in bytes. Default: 8192(8MB) "
     "to 268435456(256MB)."
@@ -82,6 +161,14 @@ static const char *usage_str =
     "\n  -d                          comma separated list of destination "
     "devices"
     "\n  -s                          comma separated list of source devices"
+    "\n                              Devices of -d and -s can be given as "
+    "device.subdevice,"
+    "\n                              e.g. -s 0.0 -d 0.1,1.0, to run "
+    "between tiles of a card"
+    "\n                              or across cards. Subdevices are then "
+    "listed after the"
+    "\n                              root devices, and the path of every "
+    "pair is printed."
     "\n"
     "\n Tests:"
     "\n  --parallel_single_target    Divide the buffer into the number of "
@@ -128,11 +215,114 @@ static const char *usage_str =
     "\n      src                     use queue in source"
     "\n      dst                     use queue in source"
     "\n"
+    "\n  --all_pairs                 run the unidirectional or, with -b, the "
+    "bidirectional"
+    "\n                              test between every ordered pair of "
+    "devices with P2P"
+    "\n                              access, with the engine of option -u, and "
+    "print one"
+    "\n                              bandwidth and latency matrix per size."
+    "\n                              Extra options: --subdevices, --csv, "
+    "--json"
+    "\n  --subdevices                expose every subdevice as a device "
+    "(flat hierarchy)"
+    "\n                              so the tests run between subdevices. "
+    "Has to come"
+    "\n                              before -q."
+    "\n  --csv file                  with --all_pairs, also write every "
+    "matrix entry to"
+    "\n                              file as CSV"
+    "\n  --json file                 with --all_pairs, also write every "
+    "matrix to file"
+    "\n                              as JSON"
+    "\n"
+    "\n  --collective name           run a collective across the devices of "
+    "option -s"
+    "\n                              (default: all devices) on the first "
+    "engine of option -u,"
+    "\n                              reporting algorithm and bus bandwidth"
+    "\n      allgather               ring all-gather"
+    "\n      reducescatter           ring reduce-scatter of floats, needs a "
+    "compute engine"
+    "\n      broadcast               pipelined ring broadcast from the first "
+    "device"
+    "\n      alltoall                all-to-all exchange"
+    "\n      all                     run all of the above"
+    "\n"
+    "\n  --bidir_sweep               run writes from the first device of -s "
+    "(default: 0)"
+    "\n                              to the first device of -d (default: 1) "
+    "together with"
+    "\n                              reads back, for fwd:rev size ratios of "
+    "1:1 to 1:4 and"
+    "\n                              4:1 and every queue placement, pushing "
+    "from the source"
+    "\n                              or pulling from the destination of each "
+    "direction,"
+    "\n                              splitting the engines of option -u, and "
+    "print the best"
+    "\n                              placement per ratio as a tuning table."
+    "\n"
+    "\n  --chunked                   split each write or read from the first "
+    "device of -s"
+    "\n                              (default: 0) to the first device of -d "
+    "(default: 1)"
+    "\n                              into chunks chained with events across "
+    "the engines"
+    "\n                              of option -u, sweeping the chunk size "
+    "from 64 KB to"
+    "\n                              the whole buffer, and report the best "
+    "chunk size."
+    "\n"
+    "\n  --kernel_copy name          run each write or read from the first "
+    "device of -s"
+    "\n                              (default: 0) to the first device of -d "
+    "(default: 1)"
+    "\n                              with the engine of option -u, then with "
+    "copy kernels"
+    "\n                              on the first compute engine of the "
+    "source over a"
+    "\n                              sweep of group counts, sizes multiple of "
+    "128 B"
+    "\n      ulong                   one ulong per item"
+    "\n      ulong2                  one ulong2 per item"
+    "\n      ulong4                  one ulong4 per item"
+    "\n      ulong8                  one ulong8 per item"
+    "\n      block                   subgroup block reads and writes"
+    "\n      all                     run all of the above"
+    "\n"
     "\n  --ipc                       perform a copy between two devices, "
     "specified by options -s and -d, "
     "\n                              with each device being managed by a "
     "separate process."
     "\n"
+    "\n  --ipc_setup_latency         time getting, sending, receiving, "
+    "opening and closing"
+    "\n                              IPC handles of buffers of the first "
+    "device of -d"
+    "\n                              (default: 1) in a process on the first "
+    "device of -s"
+    "\n                              (default: 0), for 4 KB to 256 MB and 1 "
+    "to 64 handles,"
+    "\n                              and reopening a cached handle. Extra "
+    "options: -z, -i"
+    "\n  --ipc_ranks list            run one process per entry of the comma "
+    "separated list"
+    "\n                              of devices, several entries may name the "
+    "same device."
+    "\n                              Every rank imports the buffers of all "
+    "others with IPC"
+    "\n                              handles and copies concurrently with "
+    "them, with the"
+    "\n                              engine of option -u. Reports per rank and "
+    "aggregate"
+    "\n                              bandwidth. Extra options: --ipc_pattern"
+    "\n  --ipc_pattern name          traffic of --ipc_ranks"
+    "\n      fanin                   every rank but the first one targets "
+    "the first one"
+    "\n                              (default)"
+    "\n      ring                    rank r targets rank r + 1"
+    "\n"
     "\n  --version                   display version"
     "\n  -h, --help                  display help message"
     "\n";
@@ -152,6 +342,37 @@ public:
                                               uint32_t local_device_id,
                                               size_t buffer_size);
 
+  long double chunked_copy(peer_transfer_t transfer_type, size_t buffer_size,
+                           size_t chunk_size, uint32_t remote_device_id,
+                           uint32_t local_device_id);
+
+  void perform_kernel_copy(peer_kernel_copy_t kernel_copy,
+                           uint32_t group_count, ze_kernel_handle_t kernel,
+                           ze_command_list_handle_t command_list,
+                           ze_command_queue_handle_t command_queue,
+                           void *dst_buffer, void *src_buffer,
+                           size_t buffer_size);
+
+  void kernel_copy_bandwidth(peer_transfer_t transfer_type,
+                             peer_kernel_copy_t kernel_copy_to_run,
+                             int number_buffer_elements,
+                             uint32_t remote_device_id,
+                             uint32_t local_device_id, uint32_t queue_index);
+
+  long double bidirectional_sweep_copy(uint32_t remote_device_id,
+                                       uint32_t local_device_id,
+                                       uint32_t placement,
+                                       size_t forward_size,
+                                       size_t reverse_size);
+
+  void bidirectional_sweep(int number_buffer_elements,
+                           uint32_t remote_device_id,
+                           uint32_t local_device_id);
+
+  void chunked_bandwidth(peer_transfer_t transfer_type,
+                         int number_buffer_elements, uint32_t remote_device_id,
+                         uint32_t local_device_id);
+
   void perform_bidirectional_parallel_copy_to_single_target(
       peer_test_t test_type, peer_transfer_t transfer_type,
       uint32_t remote_device_id, uint32_t local_device_id, size_t buffer_size);
@@ -242,6 +463,11 @@ public:
   void tear_down(std::vector<uint32_t> &dst_device_ids,
                  std::vector<uint32_t> &src_device_ids);
 
+  void reserve_buffers(size_t max_buffer_size);
+  void release_buffers();
+  void set_up_from_pool(std::vector<uint32_t> &remote_device_ids,
+                        std::vector<uint32_t> &local_device_ids);
+
   void print_results(bool bidirectional, peer_test_t test_type,
                      size_t buffer_size,
                      Timer<std::chrono::microseconds::period> &timer);
@@ -251,6 +477,16 @@ public:
 
   void query_engines();
 
+  uint32_t init_devices();
+  uint32_t subdevice_index(uint32_t device_id, int subdevice_id);
+  std::string device_name(uint32_t device_id);
+  const char *device_path_name(uint32_t src_device_id,
+                               uint32_t dst_device_id);
+
+  void collective_bandwidth(peer_collective_t collective,
+                            std::vector<uint32_t> &device_ids,
+                            size_t buffer_size);
+
   // IPC
   void bandwidth_latency_ipc(peer_test_t test_type,
                              peer_transfer_t transfer_type, bool is_server,
@@ -261,6 +497,17 @@ public:
                   size_t &buffer_size, ze_command_queue_handle_t &command_queue,
                   ze_command_list_handle_t &command_list);
 
+  void bandwidth_ipc_ranks(peer_transfer_t transfer_type,
+                           peer_ipc_pattern_t pattern, uint32_t rank,
+                           std::vector<uint32_t> &rank_devices,
+                           std::vector<std::vector<int>> &sockets,
+                           int number_buffer_elements, uint32_t queue_index);
+
+  void ipc_setup_export(int commSocket, uint32_t device_id,
+                        size_t buffer_size, uint32_t handle_count);
+  void ipc_setup_import(int commSocket, uint32_t device_id,
+                        size_t buffer_size, uint32_t handle_count);
+
   int sendmsg_fd(int socket, int fd);
   int recvmsg_fd(int socket);
 
@@ -277,10 +524,20 @@ public:
   char *ze_host_buffer;
   char *ze_host_validate_buffer;
 
+  /* buffers set_up reuses across sizes, after reserve_buffers */
+  size_t pool_buffer_size = 0;
+  bool buffers_from_pool = false;
+  std::vector<void *> pool_src_buffers;
+  std::vector<void *> pool_dst_buffers;
+  char *pool_host_buffer = nullptr;
+  char *pool_host_validate_buffer = nullptr;
+
   std::vector<ze_peer_device_t> ze_peer_devices;
   ze_ipc_mem_handle_t pIpcHandle = {};
 
   uint32_t device_count = 0;
+  /* root device and subdevice, or -1, of each device with use_subdevices */
+  std::vector<std::pair<uint32_t, int>> device_locations;
 
   ze_event_pool_handle_t event_pool = {};
   ze_event_handle_t event = {};
@@ -293,7 +550,48 @@ public:
   static bool parallel_copy_to_multiple_targets;
   static bool parallel_copy_to_pair_targets;
   static bool parallel_divide_buffers;
+  /* load ze_peer_benchmarks.spv for the tests launching kernels */
+  static bool use_kernels;
+  /* list the subdevices after the root devices */
+  static bool use_subdevices;
 
   static uint32_t number_iterations;
+  static ZePeerTelemetry telemetry;
   uint32_t warm_up_iterations = number_iterations / 5;
+
+  /* bandwidth in GBPS or latency in us of the last printed result */
+  long double last_result = 0;
 };
+
+void run_all_pairs_test(int size_to_run, std::vector<uint32_t> &queues,
+                        peer_test_t test_type_to_run,
+                        peer_transfer_t transfer_type_to_run,
+                        const std::string &csv_file,
+                        const std::string &json_file);
+
+void run_collective_test(int size_to_run, std::vector<uint32_t> &device_ids,
+                         std::vector<uint32_t> &queues,
+                         peer_collective_t collective_to_run);
+
+void resolve_subdevice_ids(std::vector<uint32_t> &remote_device_ids,
+                           std::vector<uint32_t> &local_device_ids);
+
+void run_bidirectional_sweep_test(int size_to_run, uint32_t remote_device_id,
+                                  uint32_t local_device_id,
+                                  std::vector<uint32_t> &queues);
+
+void run_chunked_test(int size_to_run, uint32_t remote_device_id,
+                      uint32_t local_device_id, std::vector<uint32_t> &queues,
+                      peer_transfer_t transfer_type_to_run);
+
+void run_kernel_copy_test(int size_to_run, uint32_t remote_device_id,
+                          uint32_t local_device_id, uint32_t queue,
+                          peer_transfer_t transfer_type_to_run,
+                          peer_kernel_copy_t kernel_copy_to_run);
+
+void run_ipc_ranks_test(int size_to_run, std::vector<uint32_t> &rank_devices,
+                        uint32_t queue, peer_ipc_pattern_t pattern,
+                        peer_transfer_t transfer_type_to_run);
+
+void run_ipc_setup_latency_test(int size_to_run, uint32_t remote_device_id,
+                                uint32_t local_device_id);
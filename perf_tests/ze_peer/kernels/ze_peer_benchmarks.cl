@@ -11,3 +11,46 @@ __kernel void single_copy_peer_to_peer(__global ulong *dest,
     const int g_id = get_global_id(0);
     dest[g_id] = src[g_id];
 }
+
+__kernel void reduce_sum_float(__global float *dest, __global float *src) {
+    const size_t g_id = get_global_id(0);
+    dest[g_id] += src[g_id];
+}
+
+__kernel void copy_ulong(__global ulong *dest, __global ulong *src,
+                         ulong count) {
+    for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+        dest[i] = src[i];
+    }
+}
+
+__kernel void copy_ulong2(__global ulong2 *dest, __global ulong2 *src,
+                          ulong count) {
+    for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+        dest[i] = src[i];
+    }
+}
+
+__kernel void copy_ulong4(__global ulong4 *dest, __global ulong4 *src,
+                          ulong count) {
+    for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+        dest[i] = src[i];
+    }
+}
+
+__kernel void copy_ulong8(__global ulong8 *dest, __global ulong8 *src,
+                          ulong count) {
+    for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+        dest[i] = src[i];
+    }
+}
+
+/* count has to be a multiple of the subgroup size */
+__kernel void copy_block_uint(__global uint *dest, __global uint *src,
+                              ulong count) {
+    for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+        size_t base = i - get_sub_group_local_id();
+        intel_sub_group_block_write(dest + base,
+                                    intel_sub_group_block_read(src + base));
+    }
+}
@@ -18,11 +18,12 @@ bool ZePeer::parallel_copy_to_single_target = false;
 bool ZePeer::parallel_copy_to_multiple_targets = false;
 bool ZePeer::parallel_copy_to_pair_targets = false;
 bool ZePeer::parallel_divide_buffers = false;
+bool ZePeer::use_kernels = false;
+bool ZePeer::use_subdevices = false;
 uint32_t ZePeer::number_iterations = 50;
+ZePeerTelemetry ZePeer::telemetry;
 const size_t max_number_of_elements = 268435456; /* 256 MB */
 
-void stress_handler(int signal) { exit(1); }
-
 void print_results_header(
     std::vector<uint32_t> remote_device_ids,
     std::vector<uint32_t> local_device_ids,
@@ -152,25 +153,29 @@ void run_test(int size_to_run, std::vector<uint32_t> &remote_device_ids,
   print_results_header(remote_device_ids, local_device_ids, pair_device_ids,
                        test_type, transfer_type);
 
+  /* queues, command lists and buffers are shared by all sizes, the
+   * command lists being recorded again for every size */
+  ZePeer peer(remote_device_ids, local_device_ids, pair_device_ids, queues);
+  if (ZePeer::validate_results) {
+    peer.warm_up_iterations = 0;
+    peer.number_iterations = 1;
+  }
+  peer.reserve_buffers((size_to_run != -1) ? size_to_run
+                                           : max_number_of_elements);
+
+  if (peer.run_continuously) {
+    struct sigaction sigIntHandler;
+    sigIntHandler.sa_handler = telemetry_handler;
+    sigemptyset(&sigIntHandler.sa_mask);
+    sigIntHandler.sa_flags = 0;
+    sigaction(SIGINT, &sigIntHandler, NULL);
+  }
+
   for (int number_of_elements = 8; number_of_elements <= max_number_of_elements;
        number_of_elements *= 2) {
     if (size_to_run != -1) {
       number_of_elements = size_to_run;
     }
-    ZePeer peer(remote_device_ids, local_device_ids, pair_device_ids, queues);
-    if (ZePeer::validate_results) {
-      peer.warm_up_iterations = 0;
-      peer.number_iterations = 1;
-    }
-
-    if (peer.run_continuously) {
-      struct sigaction sigIntHandler;
-      sigIntHandler.sa_handler = stress_handler;
-      sigemptyset(&sigIntHandler.sa_mask);
-      sigIntHandler.sa_flags = 0;
-      sigaction(SIGINT, &sigIntHandler, NULL);
-    }
-
     if (ZePeer::parallel_copy_to_multiple_targets == false &&
         ZePeer::parallel_copy_to_pair_targets == false &&
         ZePeer::parallel_copy_to_single_target == false) {
@@ -240,8 +245,22 @@ void run_test(int size_to_run, std::vector<uint32_t> &remote_device_ids,
 
 int main(int argc, char **argv) {
   bool run_ipc = false;
+  bool run_all_pairs = false;
+  bool run_collective = false;
+  bool run_chunked = false;
+  bool run_bidirectional_sweep = false;
+  bool run_kernel_copy = false;
+  bool run_ipc_setup_latency = false;
+  bool flat_subdevices = false;
+  std::vector<uint32_t> rank_devices{};
+  peer_ipc_pattern_t ipc_pattern = PEER_IPC_FAN_IN;
+  peer_kernel_copy_t kernel_copy_to_run = PEER_KERNEL_COPY_MAX;
+  peer_collective_t collective_to_run = PEER_COLLECTIVE_MAX;
+  std::string csv_file = "";
+  std::string json_file = "";
   std::vector<uint32_t> remote_device_ids{};
   std::vector<uint32_t> local_device_ids{};
+  HostPlacement placement;
   std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
   std::vector<uint32_t> queues{};
   int size_to_run = -1;
@@ -259,6 +278,21 @@ int main(int argc, char **argv) {
     }
   };
 
+  auto parse_and_insert_device = [&](std::string &s,
+                                     std::vector<uint32_t> &device_ids) {
+    size_t dot = s.find('.');
+    if (dot == std::string::npos) {
+      parse_and_insert(s, device_ids);
+    } else if (isdigit(s[0]) && isdigit(s[dot + 1])) {
+      device_ids.push_back(
+          peer_subdevice_id(atoi(s.substr(0, dot).c_str()),
+                            atoi(s.substr(dot + 1).c_str())));
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  };
+
   auto parse_and_insert_pairs =
       [&](std::string &s,
           std::vector<std::pair<uint32_t, uint32_t>> &vector_of_indexes) {
@@ -296,8 +330,10 @@ int main(int argc, char **argv) {
 
   for (int i = 1; i < argc; i++) {
     if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
-      std::cout << usage_str;
+      std::cout << usage_str << "\n Host placement options:"
+                << HostPlacement::usage() << "\n";
       exit(0);
+    } else if (placement.parse_option(argc, argv, i)) {
     } else if (strcmp(argv[i], "--version") == 0) {
       std::cout << "ze_peer v" << version.c_str() << "\n";
       exit(0);
@@ -345,6 +381,25 @@ int main(int argc, char **argv) {
       }
     } else if (strcmp(argv[i], "-c") == 0) {
       ZePeer::run_continuously = true;
+      /* fabric port telemetry needs sysman on the core device handles */
+      putenv(const_cast<char *>("ZES_ENABLE_SYSMAN=1"));
+    } else if ((strcmp(argv[i], "--window") == 0) && ((i + 1) < argc)) {
+      if (isdigit(argv[i + 1][0]) && atoi(argv[i + 1]) > 0) {
+        ZePeerTelemetry::window_size = atoi(argv[i + 1]);
+      } else {
+        std::cout << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "--report_period") == 0) &&
+               ((i + 1) < argc)) {
+      if (isdigit(argv[i + 1][0])) {
+        ZePeerTelemetry::report_period_sec = atoi(argv[i + 1]);
+      } else {
+        std::cout << usage_str;
+        exit(-1);
+      }
+      i++;
     } else if (strcmp(argv[i], "-b") == 0) {
       ZePeer::bidirectional = true;
     } else if ((strcmp(argv[i], "--parallel_single_target") == 0)) {
@@ -373,6 +428,82 @@ int main(int argc, char **argv) {
       ZePeer::parallel_divide_buffers = true;
     } else if (strcmp(argv[i], "--ipc") == 0) {
       run_ipc = true;
+    } else if (strcmp(argv[i], "--all_pairs") == 0) {
+      run_all_pairs = true;
+    } else if (strcmp(argv[i], "--subdevices") == 0) {
+      flat_subdevices = true;
+      putenv(const_cast<char *>("ZE_FLAT_DEVICE_HIERARCHY=FLAT"));
+    } else if ((strcmp(argv[i], "--csv") == 0) && ((i + 1) < argc)) {
+      csv_file = argv[i + 1];
+      i++;
+    } else if ((strcmp(argv[i], "--json") == 0) && ((i + 1) < argc)) {
+      json_file = argv[i + 1];
+      i++;
+    } else if ((strcmp(argv[i], "--kernel_copy") == 0) && ((i + 1) < argc)) {
+      run_kernel_copy = true;
+      if (strcmp(argv[i + 1], "ulong") == 0) {
+        kernel_copy_to_run = PEER_KERNEL_COPY_ULONG;
+      } else if (strcmp(argv[i + 1], "ulong2") == 0) {
+        kernel_copy_to_run = PEER_KERNEL_COPY_ULONG2;
+      } else if (strcmp(argv[i + 1], "ulong4") == 0) {
+        kernel_copy_to_run = PEER_KERNEL_COPY_ULONG4;
+      } else if (strcmp(argv[i + 1], "ulong8") == 0) {
+        kernel_copy_to_run = PEER_KERNEL_COPY_ULONG8;
+      } else if (strcmp(argv[i + 1], "block") == 0) {
+        kernel_copy_to_run = PEER_KERNEL_COPY_BLOCK;
+      } else if (strcmp(argv[i + 1], "all") != 0) {
+        std::cout << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if (strcmp(argv[i], "--ipc_setup_latency") == 0) {
+      run_ipc_setup_latency = true;
+    } else if ((strcmp(argv[i], "--ipc_ranks") == 0) && ((i + 1) < argc)) {
+      std::string rank_devices_string = argv[i + 1];
+      const std::string comma = ",";
+
+      size_t pos = 0;
+      size_t start = 0;
+      std::string device_id_string = "";
+      while ((pos = rank_devices_string.find(comma, start)) !=
+             std::string::npos) {
+        device_id_string = rank_devices_string.substr(start, pos - start);
+        start = pos + 1;
+        parse_and_insert(device_id_string, rank_devices);
+      }
+      device_id_string =
+          rank_devices_string.substr(start, rank_devices_string.length());
+      parse_and_insert(device_id_string, rank_devices);
+      i++;
+    } else if ((strcmp(argv[i], "--ipc_pattern") == 0) && ((i + 1) < argc)) {
+      if (strcmp(argv[i + 1], "fanin") == 0) {
+        ipc_pattern = PEER_IPC_FAN_IN;
+      } else if (strcmp(argv[i + 1], "ring") == 0) {
+        ipc_pattern = PEER_IPC_RING;
+      } else {
+        std::cout << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else if (strcmp(argv[i], "--chunked") == 0) {
+      run_chunked = true;
+    } else if (strcmp(argv[i], "--bidir_sweep") == 0) {
+      run_bidirectional_sweep = true;
+    } else if ((strcmp(argv[i], "--collective") == 0) && ((i + 1) < argc)) {
+      run_collective = true;
+      if (strcmp(argv[i + 1], "allgather") == 0) {
+        collective_to_run = PEER_ALL_GATHER;
+      } else if (strcmp(argv[i + 1], "reducescatter") == 0) {
+        collective_to_run = PEER_REDUCE_SCATTER;
+      } else if (strcmp(argv[i + 1], "broadcast") == 0) {
+        collective_to_run = PEER_BROADCAST;
+      } else if (strcmp(argv[i + 1], "alltoall") == 0) {
+        collective_to_run = PEER_ALL_TO_ALL;
+      } else if (strcmp(argv[i + 1], "all") != 0) {
+        std::cout << usage_str;
+        exit(-1);
+      }
+      i++;
     } else if ((strcmp(argv[i], "-x") == 0)) {
       if ((i + 1) >= argc) {
         std::cout << usage_str;
@@ -397,13 +528,13 @@ int main(int argc, char **argv) {
       std::string device_id_string = "";
       while ((pos = remote_device_ids_string.find(comma, start)) !=
              std::string::npos) {
-        device_id_string = remote_device_ids_string.substr(start, pos);
+        device_id_string = remote_device_ids_string.substr(start, pos - start);
         start = pos + 1;
-        parse_and_insert(device_id_string, remote_device_ids);
+        parse_and_insert_device(device_id_string, remote_device_ids);
       }
       device_id_string = remote_device_ids_string.substr(
           start, remote_device_ids_string.length());
-      parse_and_insert(device_id_string, remote_device_ids);
+      parse_and_insert_device(device_id_string, remote_device_ids);
       i++;
     } else if (strcmp(argv[i], "-s") == 0) {
       std::string local_device_ids_string = argv[i + 1];
@@ -414,13 +545,13 @@ int main(int argc, char **argv) {
       std::string device_id_string = "";
       while ((pos = local_device_ids_string.find(comma, start)) !=
              std::string::npos) {
-        device_id_string = local_device_ids_string.substr(start, pos);
+        device_id_string = local_device_ids_string.substr(start, pos - start);
         start = pos + 1;
-        parse_and_insert(device_id_string, local_device_ids);
+        parse_and_insert_device(device_id_string, local_device_ids);
       }
       device_id_string = local_device_ids_string.substr(
           start, local_device_ids_string.length());
-      parse_and_insert(device_id_string, local_device_ids);
+      parse_and_insert_device(device_id_string, local_device_ids);
       i++;
     } else if (strcmp(argv[i], "-u") == 0) {
       std::string local_queues_string = argv[i + 1];
@@ -456,6 +587,161 @@ int main(int argc, char **argv) {
     }
   }
 
+  auto is_subdevice_id = [](uint32_t device_id) {
+    return (device_id & peer_subdevice_id_flag) != 0;
+  };
+  if (std::any_of(local_device_ids.begin(), local_device_ids.end(),
+                  is_subdevice_id) ||
+      std::any_of(remote_device_ids.begin(), remote_device_ids.end(),
+                  is_subdevice_id)) {
+    if (flat_subdevices) {
+      std::cerr << "[ERROR] Option --subdevices is not supported with "
+                   "device.subdevice ids\n";
+      return -1;
+    }
+    resolve_subdevice_ids(remote_device_ids, local_device_ids);
+  }
+
+  /* The driver is not initialized yet and the IPC tests fork before they
+   * initialize it, so there is no device to place the threads near */
+  if (placement.enabled()) {
+    placement.apply(nullptr);
+    std::cout << placement.describe() << "\n";
+  }
+
+  if (run_all_pairs) {
+    if (ZePeer::run_continuously) {
+      std::cerr << "[ERROR] Option -c is not supported with --all_pairs\n";
+      return -1;
+    }
+    std::cout << "============================================================="
+                 "===================\n"
+              << "All pairs "
+              << ((ZePeer::bidirectional == 0) ? "Unidirectional "
+                                               : "Bidirectional ")
+              << "tests\n"
+              << "============================================================="
+                 "===================\n";
+    run_all_pairs_test(size_to_run, queues, test_type_to_run,
+                       transfer_type_to_run, csv_file, json_file);
+    return 0;
+  }
+
+  if (run_ipc_setup_latency) {
+    uint32_t local_device_id =
+        local_device_ids.empty() ? 0 : local_device_ids.front();
+    uint32_t remote_device_id =
+        remote_device_ids.empty() ? 1 : remote_device_ids.front();
+    std::cout << "============================================================="
+                 "===================\n"
+              << "IPC setup latency tests\n"
+              << "============================================================="
+                 "==================="
+              << std::endl;
+    run_ipc_setup_latency_test(size_to_run, remote_device_id, local_device_id);
+    return 0;
+  }
+
+  if (!rank_devices.empty()) {
+    if (rank_devices.size() < 2 || ZePeer::run_continuously ||
+        ZePeer::bidirectional) {
+      std::cerr << "[ERROR] --ipc_ranks needs at least 2 ranks and does not "
+                   "support -c and -b\n";
+      return -1;
+    }
+    uint32_t queue = queues.empty() ? 0 : queues.front();
+    std::cout << "============================================================="
+                 "===================\n"
+              << "IPC rank tests\n"
+              << "============================================================="
+                 "===================\n";
+    run_ipc_ranks_test(size_to_run, rank_devices, queue, ipc_pattern,
+                       transfer_type_to_run);
+    return 0;
+  }
+
+  if (run_kernel_copy) {
+    if (ZePeer::run_continuously || ZePeer::bidirectional) {
+      std::cerr << "[ERROR] Options -c and -b are not supported with "
+                   "--kernel_copy\n";
+      return -1;
+    }
+    uint32_t local_device_id =
+        local_device_ids.empty() ? 0 : local_device_ids.front();
+    uint32_t remote_device_id =
+        remote_device_ids.empty() ? 1 : remote_device_ids.front();
+    uint32_t queue = queues.empty() ? 0 : queues.front();
+    std::cout << "============================================================="
+                 "===================\n"
+              << "Kernel copy tests\n"
+              << "============================================================="
+                 "===================\n";
+    run_kernel_copy_test(size_to_run, remote_device_id, local_device_id, queue,
+                         transfer_type_to_run, kernel_copy_to_run);
+    return 0;
+  }
+
+  if (run_bidirectional_sweep) {
+    if (ZePeer::run_continuously || ZePeer::bidirectional) {
+      std::cerr << "[ERROR] Options -c and -b are not supported with "
+                   "--bidir_sweep\n";
+      return -1;
+    }
+    uint32_t local_device_id =
+        local_device_ids.empty() ? 0 : local_device_ids.front();
+    uint32_t remote_device_id =
+        remote_device_ids.empty() ? 1 : remote_device_ids.front();
+    std::cout << "============================================================="
+                 "===================\n"
+              << "Bidirectional placement sweep tests\n"
+              << "============================================================="
+                 "===================\n";
+    run_bidirectional_sweep_test(size_to_run, remote_device_id,
+                                 local_device_id, queues);
+    return 0;
+  }
+
+  if (run_chunked) {
+    if (ZePeer::run_continuously || ZePeer::bidirectional) {
+      std::cerr << "[ERROR] Options -c and -b are not supported with "
+                   "--chunked\n";
+      return -1;
+    }
+    uint32_t local_device_id =
+        local_device_ids.empty() ? 0 : local_device_ids.front();
+    uint32_t remote_device_id =
+        remote_device_ids.empty() ? 1 : remote_device_ids.front();
+    std::cout << "============================================================="
+                 "===================\n"
+              << "Chunked pipelined tests\n"
+              << "============================================================="
+                 "===================\n";
+    run_chunked_test(size_to_run, remote_device_id, local_device_id, queues,
+                     transfer_type_to_run);
+    return 0;
+  }
+
+  if (run_collective) {
+    std::vector<uint32_t> device_ids = local_device_ids;
+    if (device_ids.empty()) {
+      ZePeer peerQueryDevices(&num_devices);
+      for (uint32_t d = 0; d < num_devices; d++) {
+        device_ids.push_back(d);
+      }
+    }
+    if (device_ids.size() < 2) {
+      std::cerr << "[ERROR] Collectives need at least 2 devices\n";
+      return -1;
+    }
+    std::cout << "============================================================="
+                 "===================\n"
+              << "Collective tests\n"
+              << "============================================================="
+                 "===================\n";
+    run_collective_test(size_to_run, device_ids, queues, collective_to_run);
+    return 0;
+  }
+
   if (run_ipc == false) {
     // Detect number of devices
     ZePeer peerQueryDevices(&num_devices);
@@ -607,7 +893,7 @@ ZePeer::ZePeer(uint32_t *num_devices) {
 
   benchmark = new ZeApp();
 
-  this->device_count = benchmark->allDevicesInit();
+  this->device_count = init_devices();
   if (num_devices) {
     *num_devices = device_count;
   }
@@ -623,9 +909,10 @@ ZePeer::ZePeer(std::vector<uint32_t> &remote_device_ids,
                std::vector<std::pair<uint32_t, uint32_t>> &pair_device_ids,
                std::vector<uint32_t> &queues) {
 
-  benchmark = new ZeApp();
+  benchmark = use_kernels ? new ZeApp("ze_peer_benchmarks.spv")
+                         : new ZeApp();
 
-  this->device_count = benchmark->allDevicesInit();
+  this->device_count = init_devices();
 
   if (this->device_count <= 1) {
     std::cerr << "ERROR: More than 1 device needed" << std::endl;
@@ -746,6 +1033,7 @@ ZePeer::~ZePeer() {
     SUCCESS_OR_TERMINATE(zeEventDestroy(event));
     SUCCESS_OR_TERMINATE(zeEventPoolDestroy(event_pool));
   }
+  release_buffers();
   benchmark->allDevicesCleanup();
   delete benchmark;
 }
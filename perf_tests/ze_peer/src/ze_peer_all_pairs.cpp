@@ -0,0 +1,228 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+#include "ze_peer.h"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+/* Matrix entries of pairs that were not measured */
+static const long double not_measured = -1;
+
+typedef std::tuple<uint32_t, uint32_t, size_t> all_pairs_key_t;
+
+static const char *test_type_name(peer_test_t test_type) {
+  return (test_type == PEER_BANDWIDTH) ? "bandwidth" : "latency";
+}
+
+static const char *transfer_type_name(peer_transfer_t transfer_type) {
+  return (transfer_type == PEER_WRITE) ? "write" : "read";
+}
+
+static void print_matrix(peer_test_t test_type, peer_transfer_t transfer_type,
+                         size_t buffer_size,
+                         std::vector<std::vector<long double>> &matrix,
+                         std::vector<std::vector<bool>> &access) {
+  std::cout << "-----------------------------------------------------"
+               "---------------------------\n";
+  std::cout << ((test_type == PEER_BANDWIDTH) ? "BW [GBPS] " : "Latency [us] ")
+            << (transfer_type == PEER_WRITE ? "Write" : "Read") << " "
+            << (ZePeer::bidirectional ? "bidirectional " : "") << buffer_size
+            << " B (rows: source, columns: destination)\n";
+
+  std::cout << "  src\\dst";
+  for (uint32_t dst = 0; dst < matrix.size(); dst++) {
+    std::cout << std::setw(9) << dst;
+  }
+  std::cout << "\n";
+  for (uint32_t src = 0; src < matrix.size(); src++) {
+    std::cout << std::setw(9) << src;
+    for (uint32_t dst = 0; dst < matrix.size(); dst++) {
+      if (src == dst) {
+        std::cout << std::setw(9) << "-";
+      } else if (!access[src][dst] || matrix[src][dst] == not_measured) {
+        std::cout << std::setw(9) << "n/a";
+      } else {
+        std::cout << std::setw(9) << std::fixed << std::setprecision(2)
+                  << matrix[src][dst];
+      }
+    }
+    std::cout << "\n";
+  }
+}
+
+//---------------------------------------------------------------------
+// Runs bandwidth_latency, or bidirectional_bandwidth_latency with -b,
+// from every device to every other device with P2P access to it, for
+// every selected test, transfer type and size, and prints one matrix
+// per test, transfer type and size. Pairs without P2P access are
+// reported as n/a instead of terminating the run. With csv_file or
+// json_file set, every matrix entry is also written to that file.
+//---------------------------------------------------------------------
+void run_all_pairs_test(int size_to_run, std::vector<uint32_t> &queues,
+                        peer_test_t test_type_to_run,
+                        peer_transfer_t transfer_type_to_run,
+                        const std::string &csv_file,
+                        const std::string &json_file) {
+  uint32_t num_devices = 0;
+  std::vector<std::vector<bool>> access;
+  {
+    ZePeer peer_query(&num_devices);
+    access.assign(num_devices, std::vector<bool>(num_devices, false));
+    for (uint32_t src = 0; src < num_devices; src++) {
+      for (uint32_t dst = 0; dst < num_devices; dst++) {
+        access[src][dst] =
+            (src != dst) && peer_query.benchmark->canAccessPeer(dst, src);
+      }
+    }
+  }
+
+  uint32_t queue = queues.empty() ? 0 : queues.front();
+  std::vector<size_t> sizes;
+  if (size_to_run != -1) {
+    sizes.push_back(size_to_run);
+  } else {
+    for (size_t size = 8; size <= max_number_of_elements; size *= 2) {
+      sizes.push_back(size);
+    }
+  }
+
+  /* one instance for all pairs and sizes, access was checked above, and
+   * the buffers of each device are allocated once at the largest size */
+  std::vector<uint32_t> no_device_ids{};
+  std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
+  std::vector<uint32_t> pair_queues{queue};
+  ZePeer peer(no_device_ids, no_device_ids, pair_device_ids, pair_queues);
+  if (ZePeer::validate_results) {
+    peer.warm_up_iterations = 0;
+    peer.number_iterations = 1;
+  }
+  peer.reserve_buffers(sizes.back());
+
+  std::map<all_pairs_key_t, std::vector<std::vector<long double>>> matrices;
+  for (uint32_t test_type = 0;
+       test_type < static_cast<uint32_t>(PEER_TEST_MAX); test_type++) {
+    if (test_type_to_run != PEER_TEST_MAX &&
+        static_cast<peer_test_t>(test_type) != test_type_to_run) {
+      continue;
+    }
+    for (uint32_t transfer_type = 0;
+         transfer_type < static_cast<uint32_t>(PEER_TRANSFER_MAX);
+         transfer_type++) {
+      if (transfer_type_to_run != PEER_TRANSFER_MAX &&
+          static_cast<peer_transfer_t>(transfer_type) !=
+              transfer_type_to_run) {
+        continue;
+      }
+      for (auto size : sizes) {
+        auto &matrix = matrices[std::make_tuple(test_type, transfer_type,
+                                                size)];
+        matrix.assign(num_devices,
+                      std::vector<long double>(num_devices, not_measured));
+
+        for (uint32_t src = 0; src < num_devices; src++) {
+          for (uint32_t dst = 0; dst < num_devices; dst++) {
+            if (!access[src][dst]) {
+              continue;
+            }
+            std::cout << "Device(" << src << ")"
+                      << (ZePeer::bidirectional        ? "<->"
+                          : transfer_type == PEER_WRITE ? "->"
+                                                        : "<-")
+                      << "Device(" << dst << ") ";
+            if (ZePeer::bidirectional) {
+              peer.bidirectional_bandwidth_latency(
+                  static_cast<peer_test_t>(test_type),
+                  static_cast<peer_transfer_t>(transfer_type), size, dst, src,
+                  queue);
+            } else {
+              peer.bandwidth_latency(
+                  static_cast<peer_test_t>(test_type),
+                  static_cast<peer_transfer_t>(transfer_type), size, dst, src,
+                  queue);
+            }
+            matrix[src][dst] = peer.last_result;
+          }
+        }
+
+        print_matrix(static_cast<peer_test_t>(test_type),
+                     static_cast<peer_transfer_t>(transfer_type), size, matrix,
+                     access);
+      }
+    }
+  }
+
+  if (!csv_file.empty()) {
+    std::ofstream csv(csv_file);
+    if (!csv.good()) {
+      std::cerr << "[ERROR] Cannot open " << csv_file << "\n";
+    } else {
+      csv << "test,transfer,bidirectional,size_bytes,src_device,dst_device,"
+             "value,unit\n";
+      for (auto &entry : matrices) {
+        auto test_type = static_cast<peer_test_t>(std::get<0>(entry.first));
+        auto transfer_type =
+            static_cast<peer_transfer_t>(std::get<1>(entry.first));
+        for (uint32_t src = 0; src < num_devices; src++) {
+          for (uint32_t dst = 0; dst < num_devices; dst++) {
+            if (entry.second[src][dst] == not_measured) {
+              continue;
+            }
+            csv << test_type_name(test_type) << ","
+                << transfer_type_name(transfer_type) << ","
+                << (ZePeer::bidirectional ? 1 : 0) << ","
+                << std::get<2>(entry.first) << "," << src << "," << dst << ","
+                << std::setprecision(6) << entry.second[src][dst] << ","
+                << (test_type == PEER_BANDWIDTH ? "GBPS" : "us") << "\n";
+          }
+        }
+      }
+    }
+  }
+
+  if (!json_file.empty()) {
+    std::ofstream json(json_file);
+    if (!json.good()) {
+      std::cerr << "[ERROR] Cannot open " << json_file << "\n";
+    } else {
+      json << "{\n  \"devices\": " << num_devices
+           << ",\n  \"bidirectional\": "
+           << (ZePeer::bidirectional ? "true" : "false")
+           << ",\n  \"matrices\": [";
+      bool first = true;
+      for (auto &entry : matrices) {
+        auto test_type = static_cast<peer_test_t>(std::get<0>(entry.first));
+        auto transfer_type =
+            static_cast<peer_transfer_t>(std::get<1>(entry.first));
+        json << (first ? "\n" : ",\n") << "    {\"test\": \""
+             << test_type_name(test_type) << "\", \"transfer\": \""
+             << transfer_type_name(transfer_type)
+             << "\", \"size_bytes\": " << std::get<2>(entry.first)
+             << ", \"unit\": \""
+             << (test_type == PEER_BANDWIDTH ? "GBPS" : "us")
+             << "\",\n     \"values\": [";
+        first = false;
+        for (uint32_t src = 0; src < num_devices; src++) {
+          json << (src ? ",\n                " : "") << "[";
+          for (uint32_t dst = 0; dst < num_devices; dst++) {
+            json << (dst ? ", " : "");
+            if (entry.second[src][dst] == not_measured) {
+              json << "null";
+            } else {
+              json << std::setprecision(6) << entry.second[src][dst];
+            }
+          }
+          json << "]";
+        }
+        json << "]}";
+      }
+      json << "\n  ]\n}\n";
+    }
+  }
+}
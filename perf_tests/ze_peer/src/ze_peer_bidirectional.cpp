@@ -57,17 +57,23 @@ void ZePeer::bidirectional_perform_copy(
   do {
     long double time_usec = 0;
     for (int i = 0; i < number_iterations; i++) {
-      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
-          local_command_queue, 1, &local_command_list, nullptr));
-      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
-          remote_command_queue, 1, &remote_command_list, nullptr));
+      {
+        TraceSpan span("zeCommandQueueExecuteCommandLists", "submit");
+        SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+            local_command_queue, 1, &local_command_list, nullptr));
+        SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+            remote_command_queue, 1, &remote_command_list, nullptr));
+      }
 
       timer.start();
-      SUCCESS_OR_TERMINATE(zeEventHostSignal(event));
-      SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
-          local_command_queue, std::numeric_limits<uint64_t>::max()));
-      SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
-          remote_command_queue, std::numeric_limits<uint64_t>::max()));
+      {
+        TraceSpan span("zeCommandQueueSynchronize", "sync");
+        SUCCESS_OR_TERMINATE(zeEventHostSignal(event));
+        SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+            local_command_queue, std::numeric_limits<uint64_t>::max()));
+        SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+            remote_command_queue, std::numeric_limits<uint64_t>::max()));
+      }
       timer.end();
       time_usec += timer.period_minus_overhead();
 
@@ -0,0 +1,221 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+#include "ze_peer.h"
+
+#include <set>
+#include <sstream>
+
+/* Shares of the buffer moved forward and in reverse */
+static const std::pair<uint32_t, uint32_t> bidirectional_sweep_ratios[] = {
+    {1, 1}, {2, 1}, {4, 1}, {1, 2}, {1, 4}};
+
+/* Queue placement of each direction, on its source (push) or its
+ * destination (pull) */
+static const char *bidirectional_sweep_placements[] = {
+    "push/push", "push/pull", "pull/push", "pull/pull"};
+
+//---------------------------------------------------------------------
+// Times one bidirectional transfer between the local device A and the
+// remote device B: forward_size bytes from A to B and reverse_size from
+// B to A, each direction split across the engines of option -u of the
+// device its queue is placed on, A for a forward push or a reverse pull,
+// B otherwise. When both directions land on the same device and there
+// are several engines, each direction gets half of them. All copies wait
+// on the gate event, so they start together. Returns the mean time of an
+// iteration in us.
+//---------------------------------------------------------------------
+long double ZePeer::bidirectional_sweep_copy(uint32_t remote_device_id,
+                                             uint32_t local_device_id,
+                                             uint32_t placement,
+                                             size_t forward_size,
+                                             size_t reverse_size) {
+  const bool forward_push = (placement & 2) == 0;
+  const bool reverse_push = (placement & 1) == 0;
+  const uint32_t forward_queue_device =
+      forward_push ? local_device_id : remote_device_id;
+  const uint32_t reverse_queue_device =
+      reverse_push ? remote_device_id : local_device_id;
+
+  std::vector<uint32_t> forward_queues = queues;
+  std::vector<uint32_t> reverse_queues = queues;
+  if (forward_queue_device == reverse_queue_device && queues.size() > 1) {
+    size_t half = queues.size() / 2;
+    forward_queues.assign(queues.begin(), queues.begin() + half);
+    reverse_queues.assign(queues.begin() + half, queues.end());
+  }
+
+  /* (device, engine) pairs whose command lists hold copies */
+  std::set<std::pair<uint32_t, uint32_t>> used_engines;
+  auto append = [&](uint32_t queue_device, std::vector<uint32_t> &engines,
+                    char *dst_buffer, char *src_buffer, size_t size) {
+    size_t chunk = size / engines.size();
+    for (size_t e = 0; e < engines.size() && chunk; e++) {
+      size_t bytes = (e + 1 == engines.size()) ? size - e * chunk : chunk;
+      SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+          ze_peer_devices[queue_device].engines[engines[e]].second,
+          dst_buffer + e * chunk, src_buffer + e * chunk, bytes, nullptr, 1,
+          &event));
+      used_engines.insert(std::make_pair(queue_device, engines[e]));
+    }
+  };
+  append(forward_queue_device, forward_queues,
+         static_cast<char *>(ze_dst_buffers[remote_device_id]),
+         static_cast<char *>(ze_src_buffers[local_device_id]), forward_size);
+  append(reverse_queue_device, reverse_queues,
+         static_cast<char *>(ze_dst_buffers[local_device_id]),
+         static_cast<char *>(ze_src_buffers[remote_device_id]), reverse_size);
+
+  std::vector<std::pair<ze_command_queue_handle_t, ze_command_list_handle_t>>
+      engines;
+  for (auto &used_engine : used_engines) {
+    engines.push_back(
+        ze_peer_devices[used_engine.first].engines[used_engine.second]);
+    SUCCESS_OR_TERMINATE(zeCommandListClose(engines.back().second));
+  }
+
+  Timer<std::chrono::microseconds::period> timer;
+  long double time_usec = 0;
+  for (uint32_t i = 0; i < warm_up_iterations + number_iterations; i++) {
+    for (auto &engine : engines) {
+      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+          engine.first, 1, &engine.second, nullptr));
+    }
+    timer.start();
+    SUCCESS_OR_TERMINATE(zeEventHostSignal(event));
+    for (auto &engine : engines) {
+      SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+          engine.first, std::numeric_limits<uint64_t>::max()));
+    }
+    timer.end();
+    if (i >= warm_up_iterations) {
+      time_usec += timer.period_minus_overhead();
+    }
+    SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+  }
+
+  for (auto &engine : engines) {
+    SUCCESS_OR_TERMINATE(zeCommandListReset(engine.second));
+  }
+  return time_usec / number_iterations;
+}
+
+//---------------------------------------------------------------------
+// Tries every queue placement for every forward to reverse ratio between
+// the local and the remote device, prints the total bandwidth of each,
+// and the best placement per ratio as lines of a tuning table.
+//---------------------------------------------------------------------
+void ZePeer::bidirectional_sweep(int number_buffer_elements,
+                                 uint32_t remote_device_id,
+                                 uint32_t local_device_id) {
+  size_t buffer_size = 0;
+  std::vector<uint32_t> remote_device_ids = {remote_device_id};
+  std::vector<uint32_t> local_device_ids = {local_device_id};
+  set_up(number_buffer_elements, remote_device_ids, local_device_ids,
+         buffer_size);
+  initialize_buffers(remote_device_ids, local_device_ids, ze_host_buffer,
+                     buffer_size);
+
+  std::cout << "Size " << std::setw(10) << buffer_size << " B  fwd:rev";
+  for (auto placement : bidirectional_sweep_placements) {
+    std::cout << std::setw(11) << placement;
+  }
+  std::cout << "   [GBPS]\n";
+
+  std::vector<std::string> tuning_lines;
+  long double best_bandwidth = 0;
+  std::string best_config = "";
+  for (auto ratio : bidirectional_sweep_ratios) {
+    uint32_t largest = std::max(ratio.first, ratio.second);
+    size_t forward_size = buffer_size / largest * ratio.first;
+    size_t reverse_size = buffer_size / largest * ratio.second;
+    std::cout << "                     " << ratio.first << ":" << ratio.second;
+
+    long double ratio_best_bandwidth = 0;
+    uint32_t ratio_best_placement = 0;
+    for (uint32_t placement = 0; placement < 4; placement++) {
+      long double time_usec =
+          bidirectional_sweep_copy(remote_device_id, local_device_id,
+                                   placement, forward_size, reverse_size);
+      long double bandwidth = (forward_size + reverse_size) /
+                              static_cast<long double>(ONE_GB) /
+                              (time_usec / 1e6);
+      std::cout << std::fixed << std::setprecision(2) << std::setw(11)
+                << bandwidth;
+      if (bandwidth > ratio_best_bandwidth) {
+        ratio_best_bandwidth = bandwidth;
+        ratio_best_placement = placement;
+      }
+    }
+    std::cout << "\n";
+
+    std::stringstream tuning_line;
+    tuning_line << local_device_id << "," << remote_device_id << ","
+                << buffer_size << "," << ratio.first << ":" << ratio.second
+                << "," << bidirectional_sweep_placements[ratio_best_placement]
+                << "," << std::fixed << std::setprecision(2)
+                << ratio_best_bandwidth;
+    tuning_lines.push_back(tuning_line.str());
+    if (ratio_best_bandwidth > best_bandwidth) {
+      best_bandwidth = ratio_best_bandwidth;
+      best_config = std::to_string(ratio.first) + ":" +
+                    std::to_string(ratio.second) + " " +
+                    bidirectional_sweep_placements[ratio_best_placement];
+    }
+  }
+  last_result = best_bandwidth;
+
+  std::cout << "Best: " << best_config << " at " << std::fixed
+            << std::setprecision(2) << best_bandwidth << " GBPS\n";
+  std::cout << "Tuning table (src,dst,size,fwd:rev,placement,GBPS):\n";
+  for (auto &tuning_line : tuning_lines) {
+    std::cout << "  " << tuning_line << "\n";
+  }
+
+  tear_down(remote_device_ids, local_device_ids);
+}
+
+//---------------------------------------------------------------------
+// Runs the placement and ratio sweep between local_device_id and
+// remote_device_id for size_to_run bytes or for every size of the
+// default sweep.
+//---------------------------------------------------------------------
+void run_bidirectional_sweep_test(int size_to_run, uint32_t remote_device_id,
+                                  uint32_t local_device_id,
+                                  std::vector<uint32_t> &queues) {
+  std::cout << "Bidirectional placement sweep : Device( " << local_device_id
+            << " )<->Device( " << remote_device_id << " ), forward is "
+            << local_device_id << "->" << remote_device_id
+            << ", push places the queue on the source of a direction and pull"
+            << " on its destination\n";
+  std::vector<uint32_t> remote_device_ids{remote_device_id};
+  std::vector<uint32_t> local_device_ids{local_device_id};
+  std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
+  ZePeer peer(remote_device_ids, local_device_ids, pair_device_ids, queues);
+  if (ZePeer::validate_results) {
+    peer.warm_up_iterations = 0;
+    peer.number_iterations = 1;
+  }
+  peer.reserve_buffers((size_to_run != -1) ? size_to_run
+                                           : max_number_of_elements);
+
+  for (int number_of_elements = 8; number_of_elements <= max_number_of_elements;
+       number_of_elements *= 2) {
+    if (size_to_run != -1) {
+      number_of_elements = size_to_run;
+    }
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+    peer.bidirectional_sweep(number_of_elements, remote_device_id,
+                             local_device_id);
+    if (size_to_run != -1) {
+      break;
+    }
+  }
+  std::cout << "-----------------------------------------------------"
+               "---------------------------\n";
+}
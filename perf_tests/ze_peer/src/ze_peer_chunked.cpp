@@ -0,0 +1,228 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+#include "ze_peer.h"
+
+/* Chunk sizes of the sweep are bounded by these and by the chunk count */
+static const size_t chunk_size_min = 64 * 1024;
+static const size_t chunks_max = 1024;
+/* Smallest buffer of the default size sweep worth chunking */
+static const size_t chunked_buffer_min = 1024 * 1024;
+
+static std::string format_size(size_t size) {
+  if (size >= (1024 * 1024)) {
+    return std::to_string(size / (1024 * 1024)) + " MB";
+  } else if (size >= 1024) {
+    return std::to_string(size / 1024) + " KB";
+  }
+  return std::to_string(size) + "  B";
+}
+
+//---------------------------------------------------------------------
+// Splits one write or read of buffer_size bytes between the local and
+// the remote device into chunks of chunk_size bytes, each a copy of its
+// own appended round robin to the engines of option -u of the local
+// device. Chunk c signals event c and waits on event c - K, K being the
+// number of engines, so that every engine has a single chunk in flight
+// and releases its next chunk when the previous one landed, as the
+// pipelined transfers of collectives libraries do. Returns the mean time
+// of an iteration in us.
+//---------------------------------------------------------------------
+long double ZePeer::chunked_copy(peer_transfer_t transfer_type,
+                                 size_t buffer_size, size_t chunk_size,
+                                 uint32_t remote_device_id,
+                                 uint32_t local_device_id) {
+  const uint32_t engine_count = static_cast<uint32_t>(queues.size());
+  const uint32_t chunk_count =
+      static_cast<uint32_t>((buffer_size + chunk_size - 1) / chunk_size);
+
+  char *dst_buffer = static_cast<char *>(ze_dst_buffers[remote_device_id]);
+  char *src_buffer = static_cast<char *>(ze_src_buffers[local_device_id]);
+  if (transfer_type == PEER_READ) {
+    dst_buffer = static_cast<char *>(ze_dst_buffers[local_device_id]);
+    src_buffer = static_cast<char *>(ze_src_buffers[remote_device_id]);
+  }
+
+  /* Pooled, so that the sweep over chunk sizes reuses the events */
+  std::vector<ze_event_handle_t> chunk_events;
+  benchmark->acquire_events(local_device_id, chunk_count,
+                            ZE_EVENT_SCOPE_FLAG_HOST, ZE_EVENT_SCOPE_FLAG_HOST,
+                            chunk_events);
+
+  auto &engines = ze_peer_devices[local_device_id].engines;
+  for (uint32_t c = 0; c < chunk_count; c++) {
+    size_t offset = c * chunk_size;
+    size_t size = std::min(chunk_size, buffer_size - offset);
+    ze_event_handle_t wait =
+        (c >= engine_count) ? chunk_events[c - engine_count] : nullptr;
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+        engines[queues[c % engine_count]].second, dst_buffer + offset,
+        src_buffer + offset, size, chunk_events[c], wait ? 1 : 0,
+        wait ? &wait : nullptr));
+  }
+  for (uint32_t k = 0; k < std::min(engine_count, chunk_count); k++) {
+    SUCCESS_OR_TERMINATE(zeCommandListClose(engines[queues[k]].second));
+  }
+
+  auto run_once = [&]() {
+    for (uint32_t k = 0; k < std::min(engine_count, chunk_count); k++) {
+      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+          engines[queues[k]].first, 1, &engines[queues[k]].second, nullptr));
+    }
+    for (uint32_t k = 0; k < std::min(engine_count, chunk_count); k++) {
+      SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+          engines[queues[k]].first, std::numeric_limits<uint64_t>::max()));
+    }
+    for (auto chunk_event : chunk_events) {
+      SUCCESS_OR_TERMINATE(zeEventHostReset(chunk_event));
+    }
+  };
+
+  for (int i = 0; i < warm_up_iterations; i++) {
+    run_once();
+  }
+  Timer<std::chrono::microseconds::period> timer;
+  timer.start();
+  for (int i = 0; i < number_iterations; i++) {
+    run_once();
+  }
+  timer.end();
+
+  for (uint32_t k = 0; k < std::min(engine_count, chunk_count); k++) {
+    SUCCESS_OR_TERMINATE(zeCommandListReset(engines[queues[k]].second));
+  }
+  benchmark->release_events(chunk_events);
+
+  return timer.period_minus_overhead() /
+         static_cast<long double>(number_iterations);
+}
+
+//---------------------------------------------------------------------
+// Runs chunked_copy for every chunk size between chunk_size_min, or the
+// size giving chunks_max chunks, and the whole buffer, and prints the
+// bandwidth of each next to the best chunk size of the link. The whole
+// buffer entry is a single copy on the first engine, the reference the
+// other chunk sizes are compared to.
+//---------------------------------------------------------------------
+void ZePeer::chunked_bandwidth(peer_transfer_t transfer_type,
+                               int number_buffer_elements,
+                               uint32_t remote_device_id,
+                               uint32_t local_device_id) {
+  size_t buffer_size = 0;
+  std::vector<uint32_t> remote_device_ids = {remote_device_id};
+  std::vector<uint32_t> local_device_ids = {local_device_id};
+  set_up(number_buffer_elements, remote_device_ids, local_device_ids,
+         buffer_size);
+  initialize_buffers(remote_device_ids, local_device_ids, ze_host_buffer,
+                     buffer_size);
+
+  size_t chunk_size = chunk_size_min;
+  while (chunk_size * chunks_max < buffer_size) {
+    chunk_size *= 2;
+  }
+
+  long double whole_bandwidth = 0;
+  long double best_bandwidth = 0;
+  size_t best_chunk_size = 0;
+  for (; chunk_size < 2 * buffer_size; chunk_size *= 2) {
+    chunk_size = std::min(chunk_size, buffer_size);
+    long double time_usec = chunked_copy(transfer_type, buffer_size, chunk_size,
+                                         remote_device_id, local_device_id);
+    long double bandwidth =
+        buffer_size / static_cast<long double>(ONE_GB) / (time_usec / 1e6);
+    if (bandwidth > best_bandwidth) {
+      best_bandwidth = bandwidth;
+      best_chunk_size = chunk_size;
+    }
+    if (chunk_size == buffer_size) {
+      whole_bandwidth = bandwidth;
+    }
+    std::cout << "BW [GBPS]: " << std::setw(7) << format_size(buffer_size)
+              << " in " << std::setw(5)
+              << (buffer_size + chunk_size - 1) / chunk_size << " chunks of "
+              << std::setw(7) << format_size(chunk_size) << ": " << std::fixed
+              << std::setw(8) << std::setprecision(2) << bandwidth
+              << std::endl;
+    if (chunk_size == buffer_size) {
+      break;
+    }
+  }
+  last_result = best_bandwidth;
+  std::cout << "Best chunk for " << format_size(buffer_size) << ": "
+            << format_size(best_chunk_size) << " at " << std::fixed
+            << std::setprecision(2) << best_bandwidth << " GBPS ("
+            << std::setprecision(1) << 100 * best_bandwidth / whole_bandwidth
+            << " % of the whole buffer copy)" << std::endl;
+
+  if (validate_results) {
+    void *dst_buffer = (transfer_type == PEER_READ)
+                           ? ze_dst_buffers[local_device_id]
+                           : ze_dst_buffers[remote_device_id];
+    auto &engine = ze_peer_devices[local_device_id].engines[queues.front()];
+    validate_buffer(engine.second, engine.first, ze_host_validate_buffer,
+                    dst_buffer, ze_host_buffer, buffer_size);
+  }
+
+  tear_down(remote_device_ids, local_device_ids);
+}
+
+//---------------------------------------------------------------------
+// Runs the chunk size sweep from local_device_id to remote_device_id
+// with the engines of queues, for size_to_run bytes or for the sizes of
+// the default sweep from chunked_buffer_min up.
+//---------------------------------------------------------------------
+void run_chunked_test(int size_to_run, uint32_t remote_device_id,
+                      uint32_t local_device_id, std::vector<uint32_t> &queues,
+                      peer_transfer_t transfer_type_to_run) {
+  std::vector<uint32_t> remote_device_ids{remote_device_id};
+  std::vector<uint32_t> local_device_ids{local_device_id};
+  std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
+  ZePeer peer(remote_device_ids, local_device_ids, pair_device_ids, queues);
+  if (ZePeer::validate_results) {
+    peer.warm_up_iterations = 0;
+    peer.number_iterations = 1;
+  }
+  peer.reserve_buffers((size_to_run != -1) ? size_to_run
+                                           : max_number_of_elements);
+
+  for (uint32_t transfer_type = 0;
+       transfer_type < static_cast<uint32_t>(PEER_TRANSFER_MAX);
+       transfer_type++) {
+    if (transfer_type_to_run != PEER_TRANSFER_MAX &&
+        static_cast<peer_transfer_t>(transfer_type) != transfer_type_to_run) {
+      continue;
+    }
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+    std::cout << "Chunked "
+              << (transfer_type == PEER_WRITE ? "Write : Device( "
+                                              : "Read : Device( ")
+              << local_device_id << " )"
+              << (transfer_type == PEER_WRITE ? "->" : "<-") << "Device( "
+              << remote_device_id << " )\n";
+    std::cout << "Engines: ";
+    for (auto queue : peer.queues) {
+      std::cout << queue << " ";
+    }
+    std::cout << "\n";
+
+    for (size_t size = chunked_buffer_min; size <= max_number_of_elements;
+         size *= 2) {
+      if (size_to_run != -1) {
+        size = size_to_run;
+      }
+      peer.chunked_bandwidth(static_cast<peer_transfer_t>(transfer_type),
+                             static_cast<int>(size), remote_device_id,
+                             local_device_id);
+      if (size_to_run != -1) {
+        break;
+      }
+    }
+  }
+  std::cout << "-----------------------------------------------------"
+               "---------------------------\n";
+}
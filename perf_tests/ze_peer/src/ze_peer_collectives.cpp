@@ -0,0 +1,276 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+#include "ze_peer.h"
+
+/* Chunks are kept a multiple of the reduction group size in floats */
+static const uint32_t reduce_group_size = 64;
+static const size_t chunk_alignment = reduce_group_size * sizeof(float);
+
+const char *collective_names[PEER_COLLECTIVE_MAX] = {
+    "AllGather", "ReduceScatter", "Broadcast", "AllToAll"};
+
+//---------------------------------------------------------------------
+// Runs a collective across the devices of device_ids, rank r being
+// device_ids[r], with buffer_size bytes per rank split in one chunk per
+// rank. Every rank records all of its steps into the command list of the
+// first engine passed with option -u, with events between the ranks
+// enforcing the ring order, so that the host only submits and waits once
+// per iteration:
+//   AllGather -> ring, in step k rank r forwards chunk r - k to r + 1
+//   ReduceScatter -> ring, in step k rank r sends its partial sum of
+//                    chunk r - k - 1 to r + 1, which adds it to its own
+//                    with reduce_sum_float
+//   Broadcast -> pipelined ring from rank 0, every chunk is forwarded
+//                as soon as it arrived
+//   AllToAll -> every rank writes chunk j to rank j at the same time
+// Reports algorithm bandwidth, bytes per rank over time, and bus
+// bandwidth, which scales it by (N - 1) / N for all but Broadcast as in
+// the nccl-tests, to compare it with the link bandwidth.
+//---------------------------------------------------------------------
+void ZePeer::collective_bandwidth(peer_collective_t collective,
+                                  std::vector<uint32_t> &device_ids,
+                                  size_t buffer_size) {
+  const uint32_t ranks = static_cast<uint32_t>(device_ids.size());
+  const size_t chunk =
+      (buffer_size / ranks) / chunk_alignment * chunk_alignment;
+  if (ranks < 2 || chunk == 0) {
+    std::cout << collective_names[collective] << ": " << buffer_size
+              << " B skipped, less than " << chunk_alignment
+              << " B per rank and chunk\n";
+    return;
+  }
+  buffer_size = chunk * ranks;
+  const uint32_t queue_index = queues.front();
+
+  std::vector<void *> data(ranks), scratch(ranks);
+  for (uint32_t r = 0; r < ranks; r++) {
+    benchmark->memoryAlloc(device_ids[r], buffer_size, &data[r]);
+    benchmark->memoryAlloc(device_ids[r], buffer_size, &scratch[r]);
+    auto engine = ze_peer_devices[device_ids[r]].engines[queue_index];
+    initialize_buffers(engine.second, engine.first, data[r], ze_host_buffer,
+                       buffer_size);
+  }
+
+  /* one event per rank and step for the copies, one for the reductions */
+  const uint32_t events_per_rank = 2 * ranks;
+  ze_event_pool_desc_t pool_desc = {ZE_STRUCTURE_TYPE_EVENT_POOL_DESC};
+  pool_desc.count = ranks * events_per_rank;
+  pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  std::vector<ze_device_handle_t> devices;
+  for (auto device_id : device_ids) {
+    devices.push_back(benchmark->_devices[device_id]);
+  }
+  ze_event_pool_handle_t collective_pool = nullptr;
+  SUCCESS_OR_TERMINATE(zeEventPoolCreate(benchmark->context, &pool_desc,
+                                         ranks, devices.data(),
+                                         &collective_pool));
+  std::vector<ze_event_handle_t> events(pool_desc.count);
+  for (uint32_t i = 0; i < pool_desc.count; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC};
+    event_desc.index = i;
+    event_desc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+    event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+    SUCCESS_OR_TERMINATE(
+        zeEventCreate(collective_pool, &event_desc, &events[i]));
+  }
+  auto copy_event = [&](uint32_t r, uint32_t step) {
+    return events[r * events_per_rank + step];
+  };
+  auto reduce_event = [&](uint32_t r, uint32_t step) {
+    return events[r * events_per_rank + ranks + step];
+  };
+  auto at = [&](void *buffer, uint32_t index) {
+    return static_cast<char *>(buffer) + index * chunk;
+  };
+
+  std::vector<ze_kernel_handle_t> kernels(ranks, nullptr);
+  ze_group_count_t group_count = {
+      static_cast<uint32_t>(chunk / sizeof(float) / reduce_group_size), 1, 1};
+
+  for (uint32_t r = 0; r < ranks; r++) {
+    ze_command_list_handle_t list =
+        ze_peer_devices[device_ids[r]].engines[queue_index].second;
+    const uint32_t next = (r + 1) % ranks;
+    const uint32_t prev = (r + ranks - 1) % ranks;
+
+    switch (collective) {
+    case PEER_ALL_GATHER:
+      for (uint32_t k = 0; k + 1 < ranks; k++) {
+        uint32_t c = (r + ranks - k) % ranks;
+        ze_event_handle_t wait = (k > 0) ? copy_event(prev, k - 1) : nullptr;
+        SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+            list, at(data[next], c), at(data[r], c), chunk, copy_event(r, k),
+            wait ? 1 : 0, wait ? &wait : nullptr));
+      }
+      break;
+    case PEER_REDUCE_SCATTER:
+      benchmark->functionCreate(device_ids[r], &kernels[r],
+                                "reduce_sum_float");
+      SUCCESS_OR_TERMINATE(
+          zeKernelSetGroupSize(kernels[r], reduce_group_size, 1, 1));
+      for (uint32_t k = 0; k + 1 < ranks; k++) {
+        uint32_t c = (r + 2 * ranks - k - 1) % ranks;
+        ze_event_handle_t wait = (k > 0) ? reduce_event(r, k - 1) : nullptr;
+        /* scratch slot k of the next rank only ever receives step k */
+        SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+            list, at(scratch[next], k), at(data[r], c), chunk,
+            copy_event(r, k), wait ? 1 : 0, wait ? &wait : nullptr));
+
+        uint32_t received = (prev + 2 * ranks - k - 1) % ranks;
+        void *dest = at(data[r], received);
+        void *src = at(scratch[r], k);
+        SUCCESS_OR_TERMINATE(
+            zeKernelSetArgumentValue(kernels[r], 0, sizeof(dest), &dest));
+        SUCCESS_OR_TERMINATE(
+            zeKernelSetArgumentValue(kernels[r], 1, sizeof(src), &src));
+        ze_event_handle_t arrived = copy_event(prev, k);
+        SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+            list, kernels[r], &group_count, reduce_event(r, k), 1, &arrived));
+      }
+      break;
+    case PEER_BROADCAST:
+      if (next == 0) {
+        break;
+      }
+      for (uint32_t c = 0; c < ranks; c++) {
+        ze_event_handle_t wait = (r > 0) ? copy_event(prev, c) : nullptr;
+        SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+            list, at(data[next], c), at(data[r], c), chunk, copy_event(r, c),
+            wait ? 1 : 0, wait ? &wait : nullptr));
+      }
+      break;
+    case PEER_ALL_TO_ALL:
+      for (uint32_t j = 0; j < ranks; j++) {
+        if (j != r) {
+          SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+              list, at(scratch[j], r), at(data[r], j), chunk, nullptr, 0,
+              nullptr));
+        }
+      }
+      break;
+    default:
+      break;
+    }
+    SUCCESS_OR_TERMINATE(zeCommandListClose(list));
+  }
+
+  auto run_once = [&]() {
+    for (auto device_id : device_ids) {
+      auto engine = ze_peer_devices[device_id].engines[queue_index];
+      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+          engine.first, 1, &engine.second, nullptr));
+    }
+    for (auto device_id : device_ids) {
+      SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+          ze_peer_devices[device_id].engines[queue_index].first,
+          std::numeric_limits<uint64_t>::max()));
+    }
+    for (auto event : events) {
+      SUCCESS_OR_TERMINATE(zeEventHostReset(event));
+    }
+  };
+
+  for (uint32_t i = 0; i < warm_up_iterations; i++) {
+    run_once();
+  }
+
+  Timer<std::chrono::microseconds::period> timer;
+  do {
+    long double time_usec = 0;
+    for (uint32_t i = 0; i < number_iterations; i++) {
+      timer.start();
+      run_once();
+      timer.end();
+      time_usec += timer.period_minus_overhead();
+    }
+    time_usec /= number_iterations;
+
+    long double algorithm_bandwidth =
+        buffer_size / static_cast<long double>(ONE_GB) / (time_usec / 1e6);
+    long double bus_factor =
+        (collective == PEER_BROADCAST)
+            ? 1
+            : static_cast<long double>(ranks - 1) / ranks;
+    last_result = algorithm_bandwidth;
+    std::cout << std::left << std::setw(14) << collective_names[collective]
+              << std::right << std::setw(10) << buffer_size
+              << " B: algbw [GBPS] " << std::fixed << std::setw(8)
+              << std::setprecision(2) << algorithm_bandwidth
+              << "  busbw [GBPS] " << std::setw(8)
+              << algorithm_bandwidth * bus_factor << "  time [us] "
+              << std::setw(10) << time_usec << std::endl;
+  } while (run_continuously);
+
+  for (uint32_t r = 0; r < ranks; r++) {
+    SUCCESS_OR_TERMINATE(zeCommandListReset(
+        ze_peer_devices[device_ids[r]].engines[queue_index].second));
+    if (kernels[r]) {
+      benchmark->functionDestroy(kernels[r]);
+    }
+    benchmark->memoryFree(data[r]);
+    benchmark->memoryFree(scratch[r]);
+  }
+  for (auto event : events) {
+    SUCCESS_OR_TERMINATE(zeEventDestroy(event));
+  }
+  SUCCESS_OR_TERMINATE(zeEventPoolDestroy(collective_pool));
+}
+
+//---------------------------------------------------------------------
+// Runs the selected collective, or all of them, across device_ids for
+// size_to_run bytes per rank, or for every size of the default sweep.
+//---------------------------------------------------------------------
+void run_collective_test(int size_to_run, std::vector<uint32_t> &device_ids,
+                         std::vector<uint32_t> &queues,
+                         peer_collective_t collective_to_run) {
+  std::cout << "Collectives across Device( ";
+  for (auto device_id : device_ids) {
+    std::cout << device_id << " ";
+  }
+  std::cout << ")\n";
+
+  ZePeer::use_kernels = true;
+  for (uint32_t collective = 0;
+       collective < static_cast<uint32_t>(PEER_COLLECTIVE_MAX); collective++) {
+    if (collective_to_run != PEER_COLLECTIVE_MAX &&
+        static_cast<peer_collective_t>(collective) != collective_to_run) {
+      continue;
+    }
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+    for (size_t size = 8; size <= max_number_of_elements; size *= 2) {
+      if (size_to_run != -1) {
+        size = size_to_run;
+      }
+      std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
+      ZePeer peer(device_ids, device_ids, pair_device_ids, queues);
+      if (ZePeer::validate_results) {
+        peer.warm_up_iterations = 0;
+        peer.number_iterations = 1;
+      }
+      /* host buffers sized for the initialization of every rank */
+      void **host_buffer = reinterpret_cast<void **>(&peer.ze_host_buffer);
+      peer.benchmark->memoryAllocHost(size, host_buffer);
+      void **host_validate_buffer =
+          reinterpret_cast<void **>(&peer.ze_host_validate_buffer);
+      peer.benchmark->memoryAllocHost(size, host_validate_buffer);
+
+      peer.collective_bandwidth(static_cast<peer_collective_t>(collective),
+                                device_ids, size);
+
+      peer.benchmark->memoryFree(peer.ze_host_buffer);
+      peer.benchmark->memoryFree(peer.ze_host_validate_buffer);
+      if (size_to_run != -1) {
+        break;
+      }
+    }
+  }
+  std::cout << "-----------------------------------------------------"
+               "---------------------------\n";
+  std::cout << std::endl;
+}
@@ -88,6 +88,11 @@ void ZePeer::print_results(bool bidirectional, peer_test_t test_type,
     total_data_transfer = 2 * total_data_transfer;
   }
   long double total_bandwidth = total_data_transfer / total_time_s;
+  last_result =
+      (test_type == PEER_BANDWIDTH) ? total_bandwidth : total_time_usec;
+  if (run_continuously) {
+    telemetry.add(benchmark, test_type, last_result);
+  }
 
   int buffer_size_formatted;
   std::string buffer_format_str;
@@ -117,6 +122,69 @@ void ZePeer::print_results(bool bidirectional, peer_test_t test_type,
   }
 }
 
+//---------------------------------------------------------------------
+// Keeps the buffers of set_up across calls for buffers of up to
+// max_buffer_size bytes, so a size sweep allocates every device buffer
+// once, at max_buffer_size, on the first size using that device.
+//---------------------------------------------------------------------
+void ZePeer::reserve_buffers(size_t max_buffer_size) {
+  pool_buffer_size = max_buffer_size;
+  pool_src_buffers.resize(benchmark->_devices.size(), nullptr);
+  pool_dst_buffers.resize(benchmark->_devices.size(), nullptr);
+}
+
+void ZePeer::release_buffers() {
+  for (auto &pool_buffer : pool_src_buffers) {
+    if (pool_buffer) {
+      benchmark->memoryFree(pool_buffer);
+      pool_buffer = nullptr;
+    }
+  }
+  for (auto &pool_buffer : pool_dst_buffers) {
+    if (pool_buffer) {
+      benchmark->memoryFree(pool_buffer);
+      pool_buffer = nullptr;
+    }
+  }
+  if (pool_host_buffer) {
+    benchmark->memoryFree(pool_host_buffer);
+    benchmark->memoryFree(pool_host_validate_buffer);
+    pool_host_buffer = nullptr;
+    pool_host_validate_buffer = nullptr;
+  }
+  pool_buffer_size = 0;
+}
+
+void ZePeer::set_up_from_pool(std::vector<uint32_t> &remote_device_ids,
+                              std::vector<uint32_t> &local_device_ids) {
+  auto take_from_pool = [&](uint32_t device_id) {
+    if (pool_src_buffers[device_id] == nullptr) {
+      benchmark->memoryAlloc(device_id, pool_buffer_size,
+                             &pool_src_buffers[device_id]);
+      benchmark->memoryAlloc(device_id, pool_buffer_size,
+                             &pool_dst_buffers[device_id]);
+    }
+    ze_src_buffers[device_id] = pool_src_buffers[device_id];
+    ze_dst_buffers[device_id] = pool_dst_buffers[device_id];
+  };
+  for (auto local_device_id : local_device_ids) {
+    take_from_pool(local_device_id);
+  }
+  for (auto remote_device_id : remote_device_ids) {
+    take_from_pool(remote_device_id);
+  }
+
+  if (pool_host_buffer == nullptr) {
+    benchmark->memoryAllocHost(pool_buffer_size,
+                               reinterpret_cast<void **>(&pool_host_buffer));
+    benchmark->memoryAllocHost(
+        pool_buffer_size,
+        reinterpret_cast<void **>(&pool_host_validate_buffer));
+  }
+  ze_host_buffer = pool_host_buffer;
+  ze_host_validate_buffer = pool_host_validate_buffer;
+}
+
 void ZePeer::set_up(int number_buffer_elements,
                     std::vector<uint32_t> &remote_device_ids,
                     std::vector<uint32_t> &local_device_ids,
@@ -125,6 +193,12 @@ void ZePeer::set_up(int number_buffer_elements,
   size_t element_size = sizeof(char);
   buffer_size = element_size * number_buffer_elements;
 
+  buffers_from_pool = (buffer_size <= pool_buffer_size);
+  if (buffers_from_pool) {
+    set_up_from_pool(remote_device_ids, local_device_ids);
+    return;
+  }
+
   for (auto local_device_id : local_device_ids) {
     void *ze_buffer = nullptr;
     benchmark->memoryAlloc(local_device_id, buffer_size, &ze_buffer);
@@ -155,6 +229,19 @@ void ZePeer::set_up(int number_buffer_elements,
 void ZePeer::tear_down(std::vector<uint32_t> &remote_device_ids,
                        std::vector<uint32_t> &local_device_ids) {
 
+  if (buffers_from_pool) {
+    /* the buffers stay in the pool for the next size */
+    for (auto local_device_id : local_device_ids) {
+      ze_src_buffers[local_device_id] = nullptr;
+      ze_dst_buffers[local_device_id] = nullptr;
+    }
+    for (auto remote_device_id : remote_device_ids) {
+      ze_src_buffers[remote_device_id] = nullptr;
+      ze_dst_buffers[remote_device_id] = nullptr;
+    }
+    return;
+  }
+
   for (auto local_device_id : local_device_ids) {
     if (ze_dst_buffers[local_device_id]) {
       benchmark->memoryFree(ze_dst_buffers[local_device_id]);
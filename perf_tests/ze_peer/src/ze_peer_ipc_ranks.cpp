@@ -0,0 +1,335 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_peer.h"
+
+/* Rank collecting the results and, with fan-in, target of the traffic */
+static const uint32_t root_rank = 0;
+
+static void write_or_terminate(int socket, const void *data, size_t size) {
+  if (write(socket, data, size) != static_cast<ssize_t>(size)) {
+    std::cerr << "Failing to write to rank socket\n";
+    std::terminate();
+  }
+}
+
+static void read_or_terminate(int socket, void *data, size_t size) {
+  size_t received = 0;
+  while (received < size) {
+    ssize_t bytes =
+        read(socket, static_cast<char *>(data) + received, size - received);
+    if (bytes <= 0) {
+      std::cerr << "Failing to read from rank socket\n";
+      std::terminate();
+    }
+    received += bytes;
+  }
+}
+
+//---------------------------------------------------------------------
+// Blocks until every rank reached the barrier, rank root_rank gathering
+// one byte of every other rank and releasing them all at once.
+//---------------------------------------------------------------------
+static void ipc_ranks_barrier(uint32_t rank,
+                              std::vector<std::vector<int>> &sockets) {
+  char token = 0;
+  const uint32_t ranks = static_cast<uint32_t>(sockets.size());
+  if (rank == root_rank) {
+    for (uint32_t r = 0; r < ranks; r++) {
+      if (r != root_rank) {
+        read_or_terminate(sockets[root_rank][r], &token, sizeof(token));
+      }
+    }
+    for (uint32_t r = 0; r < ranks; r++) {
+      if (r != root_rank) {
+        write_or_terminate(sockets[root_rank][r], &token, sizeof(token));
+      }
+    }
+  } else {
+    write_or_terminate(sockets[rank][root_rank], &token, sizeof(token));
+    read_or_terminate(sockets[rank][root_rank], &token, sizeof(token));
+  }
+}
+
+static uint32_t ipc_ranks_target(peer_ipc_pattern_t pattern, uint32_t rank,
+                                 uint32_t ranks) {
+  return (pattern == PEER_IPC_FAN_IN) ? root_rank : (rank + 1) % ranks;
+}
+
+//---------------------------------------------------------------------
+// Body of rank rank of an IPC run of rank_devices.size() processes, rank
+// r running on device rank_devices[r]. Every rank allocates a source
+// buffer of buffer_size bytes holding the test pattern and a destination
+// buffer with one buffer_size slice per rank, exports the buffer the
+// other ranks access, destination for writes and source for reads, and
+// imports the exported buffers of all other ranks over the rank sockets.
+// Each rank then copies between its own buffers and those of its target
+// concurrently with the others:
+//   PEER_IPC_FAN_IN -> every rank but root_rank targets root_rank
+//   PEER_IPC_RING -> rank r targets rank r + 1
+// Writes go from the own source to slice r of the target destination,
+// reads from the target source to slice r of the own destination. Every
+// rank reports its time to root_rank, which prints per rank and aggregate
+// bandwidth, the latter as all bytes moved over the slowest rank time.
+//---------------------------------------------------------------------
+void ZePeer::bandwidth_ipc_ranks(peer_transfer_t transfer_type,
+                                 peer_ipc_pattern_t pattern, uint32_t rank,
+                                 std::vector<uint32_t> &rank_devices,
+                                 std::vector<std::vector<int>> &sockets,
+                                 int number_buffer_elements,
+                                 uint32_t queue_index) {
+  const uint32_t ranks = static_cast<uint32_t>(rank_devices.size());
+  const uint32_t device_id = rank_devices[rank];
+  const uint32_t target = ipc_ranks_target(pattern, rank, ranks);
+  const bool is_active = (pattern == PEER_IPC_RING) || (rank != root_rank);
+  size_t buffer_size = sizeof(char) * number_buffer_elements;
+
+  ze_command_queue_handle_t command_queue =
+      ze_peer_devices[device_id].engines[queue_index].first;
+  ze_command_list_handle_t command_list =
+      ze_peer_devices[device_id].engines[queue_index].second;
+
+  void *src_buffer = nullptr;
+  void *dst_buffer = nullptr;
+  benchmark->memoryAlloc(device_id, buffer_size, &src_buffer);
+  benchmark->memoryAlloc(device_id, buffer_size * ranks, &dst_buffer);
+  void **host_buffer = reinterpret_cast<void **>(&ze_host_buffer);
+  benchmark->memoryAllocHost(buffer_size, host_buffer);
+  void **host_validate_buffer =
+      reinterpret_cast<void **>(&ze_host_validate_buffer);
+  benchmark->memoryAllocHost(buffer_size, host_validate_buffer);
+  initialize_buffers(command_list, command_queue, src_buffer, ze_host_buffer,
+                     buffer_size);
+
+  /* fds are buffered by the sockets, so all sends can go ahead */
+  void *exported = (transfer_type == PEER_WRITE) ? dst_buffer : src_buffer;
+  ze_ipc_mem_handle_t ipc_handle = {};
+  benchmark->getIpcHandle(exported, &ipc_handle);
+  int dma_buf_fd;
+  memcpy(static_cast<void *>(&dma_buf_fd), &ipc_handle, sizeof(dma_buf_fd));
+  for (uint32_t r = 0; r < ranks; r++) {
+    if (r != rank && sendmsg_fd(sockets[rank][r], dma_buf_fd) < 0) {
+      std::cerr << "Failing to send dma_buf fd to rank " << r << "\n";
+      std::terminate();
+    }
+  }
+  std::vector<void *> imported(ranks, nullptr);
+  for (uint32_t r = 0; r < ranks; r++) {
+    if (r == rank) {
+      continue;
+    }
+    int fd = recvmsg_fd(sockets[rank][r]);
+    if (fd < 0) {
+      std::cerr << "Failing to get dma_buf fd from rank " << r << "\n";
+      std::terminate();
+    }
+    ze_ipc_mem_handle_t remote_handle = {};
+    memcpy(&remote_handle, static_cast<void *>(&fd), sizeof(fd));
+    benchmark->memoryOpenIpcHandle(device_id, remote_handle, &imported[r]);
+  }
+
+  if (is_active) {
+    char *slice = nullptr;
+    void *source = nullptr;
+    if (transfer_type == PEER_WRITE) {
+      slice = static_cast<char *>(imported[target]) + rank * buffer_size;
+      source = src_buffer;
+    } else {
+      slice = static_cast<char *>(dst_buffer) + rank * buffer_size;
+      source = imported[target];
+    }
+    SUCCESS_OR_TERMINATE(zeCommandListAppendMemoryCopy(
+        command_list, slice, source, buffer_size, nullptr, 0, nullptr));
+    SUCCESS_OR_TERMINATE(zeCommandListClose(command_list));
+  }
+
+  auto run = [&](int iterations) {
+    for (int i = 0; i < iterations && is_active; i++) {
+      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+          command_queue, 1, &command_list, nullptr));
+      SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+          command_queue, std::numeric_limits<uint64_t>::max()));
+    }
+  };
+
+  run(warm_up_iterations);
+  ipc_ranks_barrier(rank, sockets);
+  Timer<std::chrono::microseconds::period> timer;
+  timer.start();
+  run(number_iterations);
+  timer.end();
+  long double time_usec =
+      is_active ? timer.period_minus_overhead() /
+                      static_cast<long double>(number_iterations)
+                : 0;
+  if (is_active) {
+    SUCCESS_OR_TERMINATE(zeCommandListReset(command_list));
+  }
+  ipc_ranks_barrier(rank, sockets);
+
+  if (validate_results) {
+    for (uint32_t r = 0; r < ranks; r++) {
+      bool wrote_here = (transfer_type == PEER_WRITE) && (r != rank) &&
+                        ((pattern == PEER_IPC_RING) || (r != root_rank)) &&
+                        (ipc_ranks_target(pattern, r, ranks) == rank);
+      bool read_here = (transfer_type == PEER_READ) && (r == rank) && is_active;
+      if (wrote_here || read_here) {
+        validate_buffer(command_list, command_queue, ze_host_validate_buffer,
+                        static_cast<char *>(dst_buffer) + r * buffer_size,
+                        ze_host_buffer, buffer_size);
+      }
+    }
+  }
+
+  if (rank == root_rank) {
+    std::vector<long double> times_usec(ranks, 0);
+    times_usec[root_rank] = time_usec;
+    for (uint32_t r = 0; r < ranks; r++) {
+      if (r != root_rank) {
+        read_or_terminate(sockets[root_rank][r], &times_usec[r],
+                          sizeof(long double));
+      }
+    }
+    long double slowest_usec = 0;
+    long double total_bytes = 0;
+    for (uint32_t r = 0; r < ranks; r++) {
+      if (times_usec[r] == 0) {
+        continue;
+      }
+      long double bandwidth = buffer_size / static_cast<long double>(ONE_GB) /
+                              (times_usec[r] / 1e6);
+      std::cout << "  Rank " << std::setw(2) << r << " Device("
+                << rank_devices[r] << ")"
+                << (transfer_type == PEER_WRITE ? "->" : "<-") << "Device("
+                << rank_devices[ipc_ranks_target(pattern, r, ranks)]
+                << ") BW [GBPS]: " << std::fixed << std::setw(8)
+                << std::setprecision(2) << bandwidth << std::endl;
+      slowest_usec = std::max(slowest_usec, times_usec[r]);
+      total_bytes += buffer_size;
+    }
+    last_result = total_bytes / static_cast<long double>(ONE_GB) /
+                  (slowest_usec / 1e6);
+    std::cout << "Aggregate BW [GBPS]: " << std::fixed << std::setw(10)
+              << buffer_size << " B per rank: " << std::setw(8)
+              << std::setprecision(2) << last_result << std::endl;
+  } else {
+    write_or_terminate(sockets[rank][root_rank], &time_usec,
+                       sizeof(long double));
+  }
+
+  /* imports are closed before the exporting ranks free their buffers */
+  for (uint32_t r = 0; r < ranks; r++) {
+    if (imported[r]) {
+      benchmark->closeIpcHandle(imported[r]);
+    }
+  }
+  ipc_ranks_barrier(rank, sockets);
+
+  benchmark->memoryFree(src_buffer);
+  benchmark->memoryFree(dst_buffer);
+  benchmark->memoryFree(ze_host_buffer);
+  benchmark->memoryFree(ze_host_validate_buffer);
+
+  exit(0);
+}
+
+//---------------------------------------------------------------------
+// Forks one process per entry of rank_devices for every size, connected
+// pairwise by unix sockets, each running bandwidth_ipc_ranks with the
+// engine queue of its device.
+//---------------------------------------------------------------------
+void run_ipc_ranks_test(int size_to_run, std::vector<uint32_t> &rank_devices,
+                        uint32_t queue, peer_ipc_pattern_t pattern,
+                        peer_transfer_t transfer_type_to_run) {
+  const uint32_t ranks = static_cast<uint32_t>(rank_devices.size());
+
+  for (uint32_t transfer_type = 0;
+       transfer_type < static_cast<uint32_t>(PEER_TRANSFER_MAX);
+       transfer_type++) {
+    if (transfer_type_to_run != PEER_TRANSFER_MAX &&
+        static_cast<peer_transfer_t>(transfer_type) != transfer_type_to_run) {
+      continue;
+    }
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+    std::cout << ranks << " ranks "
+              << (pattern == PEER_IPC_FAN_IN ? "fan-in " : "ring ")
+              << (transfer_type == PEER_WRITE ? "Write" : "Read")
+              << " : Devices( ";
+    for (auto device_id : rank_devices) {
+      std::cout << device_id << " ";
+    }
+    std::cout << ")\n";
+
+    for (int number_of_elements = 8;
+         number_of_elements <= max_number_of_elements;
+         number_of_elements *= 2) {
+      if (size_to_run != -1) {
+        number_of_elements = size_to_run;
+      }
+
+      std::vector<std::vector<int>> sockets(ranks, std::vector<int>(ranks, -1));
+      for (uint32_t i = 0; i < ranks; i++) {
+        for (uint32_t j = i + 1; j < ranks; j++) {
+          int sv[2];
+          if (socketpair(PF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+            perror("socketpair");
+            exit(1);
+          }
+          sockets[i][j] = sv[0];
+          sockets[j][i] = sv[1];
+        }
+      }
+
+      for (uint32_t rank = 0; rank < ranks; rank++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+          std::vector<uint32_t> local_device_ids{rank_devices[rank]};
+          std::vector<uint32_t> remote_device_ids = rank_devices;
+          std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
+          std::vector<uint32_t> queues{queue};
+          ZePeer peer(remote_device_ids, local_device_ids, pair_device_ids,
+                      queues);
+          if (ZePeer::validate_results) {
+            peer.warm_up_iterations = 0;
+            peer.number_iterations = 1;
+          }
+          peer.bandwidth_ipc_ranks(static_cast<peer_transfer_t>(transfer_type),
+                                   pattern, rank, rank_devices, sockets,
+                                   number_of_elements, queue);
+        } else if (pid < 0) {
+          perror("fork");
+          exit(1);
+        }
+      }
+
+      for (uint32_t rank = 0; rank < ranks; rank++) {
+        int child_status;
+        pid_t child_pid = wait(&child_status);
+        if (child_pid <= 0 || !WIFEXITED(child_status) ||
+            WEXITSTATUS(child_status) != 0) {
+          std::cerr << "Rank terminated abruptly\n";
+          std::terminate();
+        }
+      }
+      for (auto &rank_sockets : sockets) {
+        for (auto socket : rank_sockets) {
+          if (socket >= 0) {
+            close(socket);
+          }
+        }
+      }
+
+      if (size_to_run != -1) {
+        break;
+      }
+    }
+  }
+  std::cout << "-----------------------------------------------------"
+               "---------------------------\n";
+}
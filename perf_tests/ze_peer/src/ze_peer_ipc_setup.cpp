@@ -0,0 +1,225 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_peer.h"
+
+static const size_t ipc_setup_sizes[] = {4096, 65536, 1048576, 16777216,
+                                         268435456};
+static const uint32_t ipc_setup_handle_counts[] = {1, 8, 64};
+
+/* Times of the exporting process sent to the importing one, in ns */
+typedef struct _ipc_setup_export_times_t {
+  long double get_nsec;
+  long double send_nsec;
+} ipc_setup_export_times_t;
+
+//---------------------------------------------------------------------
+// Exporting side of one IPC setup measurement: allocates handle_count
+// buffers of buffer_size bytes on device_id, times zeMemGetIpcHandle and
+// the transfer of the dma_buf fds over commSocket for all of them, and
+// keeps the buffers alive until the importer is done with them.
+//---------------------------------------------------------------------
+void ZePeer::ipc_setup_export(int commSocket, uint32_t device_id,
+                              size_t buffer_size, uint32_t handle_count) {
+  std::vector<void *> buffers(handle_count, nullptr);
+  std::vector<ze_ipc_mem_handle_t> handles(handle_count);
+  for (auto &buffer : buffers) {
+    benchmark->memoryAlloc(device_id, buffer_size, &buffer);
+  }
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  ipc_setup_export_times_t times = {};
+  timer.start();
+  for (uint32_t h = 0; h < handle_count; h++) {
+    benchmark->getIpcHandle(buffers[h], &handles[h]);
+  }
+  timer.end();
+  times.get_nsec = timer.period_minus_overhead();
+
+  timer.start();
+  for (uint32_t h = 0; h < handle_count; h++) {
+    int dma_buf_fd;
+    memcpy(static_cast<void *>(&dma_buf_fd), &handles[h], sizeof(dma_buf_fd));
+    if (sendmsg_fd(commSocket, dma_buf_fd) < 0) {
+      std::cerr << "Failing to send dma_buf fd to client\n";
+      std::terminate();
+    }
+  }
+  timer.end();
+  times.send_nsec = timer.period_minus_overhead();
+
+  if (write(commSocket, &times, sizeof(times)) !=
+      static_cast<ssize_t>(sizeof(times))) {
+    std::cerr << "Failing to send export times to client\n";
+    std::terminate();
+  }
+  char done = 0;
+  if (read(commSocket, &done, sizeof(done)) != 1) {
+    std::cerr << "Client terminated before closing its handles\n";
+    std::terminate();
+  }
+
+  for (auto buffer : buffers) {
+    benchmark->memoryFree(buffer);
+  }
+}
+
+//---------------------------------------------------------------------
+// Importing side of one IPC setup measurement: times the reception of
+// the handle_count fds, zeMemOpenIpcHandle and zeMemCloseIpcHandle of
+// each, then the cached case of opening and closing the first handle
+// again number_iterations times, and prints the mean per handle times
+// of both processes.
+//---------------------------------------------------------------------
+void ZePeer::ipc_setup_import(int commSocket, uint32_t device_id,
+                              size_t buffer_size, uint32_t handle_count) {
+  std::vector<int> fds(handle_count, -1);
+  std::vector<void *> buffers(handle_count, nullptr);
+
+  Timer<std::chrono::nanoseconds::period> timer;
+  timer.start();
+  for (auto &fd : fds) {
+    fd = recvmsg_fd(commSocket);
+    if (fd < 0) {
+      std::cerr << "Failing to get dma_buf fd from server\n";
+      std::terminate();
+    }
+  }
+  timer.end();
+  long double recv_nsec = timer.period_minus_overhead();
+
+  ipc_setup_export_times_t times = {};
+  size_t received = 0;
+  while (received < sizeof(times)) {
+    ssize_t bytes =
+        read(commSocket, reinterpret_cast<char *>(&times) + received,
+             sizeof(times) - received);
+    if (bytes <= 0) {
+      std::cerr << "Failing to get export times from server\n";
+      std::terminate();
+    }
+    received += bytes;
+  }
+
+  auto to_handle = [](int fd) {
+    ze_ipc_mem_handle_t handle = {};
+    memcpy(&handle, static_cast<void *>(&fd), sizeof(fd));
+    return handle;
+  };
+
+  long double open_nsec = 0;
+  long double close_nsec = 0;
+  for (uint32_t h = 0; h < handle_count; h++) {
+    timer.start();
+    benchmark->memoryOpenIpcHandle(device_id, to_handle(fds[h]), &buffers[h]);
+    timer.end();
+    open_nsec += timer.period_minus_overhead();
+  }
+  for (uint32_t h = 0; h < handle_count; h++) {
+    timer.start();
+    benchmark->closeIpcHandle(buffers[h]);
+    timer.end();
+    close_nsec += timer.period_minus_overhead();
+  }
+
+  long double reopen_nsec = 0;
+  for (uint32_t i = 0; i < number_iterations; i++) {
+    void *buffer = nullptr;
+    timer.start();
+    benchmark->memoryOpenIpcHandle(device_id, to_handle(fds[0]), &buffer);
+    timer.end();
+    reopen_nsec += timer.period_minus_overhead();
+    benchmark->closeIpcHandle(buffer);
+  }
+  reopen_nsec /= number_iterations;
+
+  for (auto fd : fds) {
+    close(fd);
+  }
+  char done = 0;
+  if (write(commSocket, &done, sizeof(done)) != 1) {
+    std::cerr << "Failing to notify server\n";
+    std::terminate();
+  }
+
+  long double count = handle_count;
+  std::cout << std::setw(10) << buffer_size << std::setw(8) << handle_count
+            << std::fixed << std::setprecision(2) << std::setw(12)
+            << times.get_nsec / count / 1e3 << std::setw(12)
+            << times.send_nsec / count / 1e3 << std::setw(12)
+            << recv_nsec / count / 1e3 << std::setw(12)
+            << open_nsec / count / 1e3 << std::setw(12)
+            << close_nsec / count / 1e3 << std::setw(12) << reopen_nsec / 1e3
+            << std::endl;
+}
+
+//---------------------------------------------------------------------
+// Measures the startup cost of sharing buffers between two processes,
+// the server exporting from remote_device_id, the client importing on
+// local_device_id, for every size and handle count, or for size_to_run
+// only. Times are per handle in us.
+//---------------------------------------------------------------------
+void run_ipc_setup_latency_test(int size_to_run, uint32_t remote_device_id,
+                                uint32_t local_device_id) {
+  std::vector<size_t> sizes(std::begin(ipc_setup_sizes),
+                            std::end(ipc_setup_sizes));
+  if (size_to_run != -1) {
+    sizes.assign(1, size_to_run);
+  }
+
+  std::cout << "IPC setup latency [us per handle]: export on Device("
+            << remote_device_id << "), import on Device(" << local_device_id
+            << ")\n";
+  std::cout << "      Size Handles         Get        Send        Recv"
+               "        Open       Close      Reopen"
+            << std::endl;
+
+  for (auto size : sizes) {
+    for (auto handle_count : ipc_setup_handle_counts) {
+      int sv[2];
+      if (socketpair(PF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+        perror("socketpair");
+        exit(1);
+      }
+
+      pid_t pid = fork();
+      if (pid == 0) {
+        pid_t test_pid = fork();
+        std::vector<uint32_t> remote_device_ids{remote_device_id};
+        std::vector<uint32_t> local_device_ids{local_device_id};
+        std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
+        std::vector<uint32_t> queues{0};
+        ZePeer peer(remote_device_ids, local_device_ids, pair_device_ids,
+                    queues);
+        if (test_pid == 0) {
+          peer.ipc_setup_import(sv[1], local_device_id, size, handle_count);
+        } else {
+          peer.ipc_setup_export(sv[0], remote_device_id, size, handle_count);
+          int child_status;
+          if (wait(&child_status) <= 0) {
+            std::cerr << "Client terminated abruptly with error code "
+                      << strerror(errno) << "\n";
+            std::terminate();
+          }
+        }
+        exit(0);
+      } else {
+        int child_status;
+        pid_t child_pid = wait(&child_status);
+        if (child_pid <= 0) {
+          std::cerr << "Client terminated abruptly with error code "
+                    << strerror(errno) << "\n";
+          std::terminate();
+        }
+      }
+      close(sv[0]);
+      close(sv[1]);
+    }
+  }
+  std::cout << std::endl;
+}
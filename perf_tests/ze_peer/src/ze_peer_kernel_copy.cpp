@@ -0,0 +1,250 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+#include "ze_peer.h"
+
+static const uint32_t kernel_copy_group_size = 256;
+/* Group counts of the sweep, 0 standing for one item per element */
+static const uint32_t kernel_copy_group_counts[] = {16, 64, 256, 1024, 0};
+/* Buffers have to hold whole subgroups of the widest element */
+static const size_t kernel_copy_alignment = 128;
+
+static const char *kernel_copy_names[PEER_KERNEL_COPY_MAX] = {
+    "copy_ulong", "copy_ulong2", "copy_ulong4", "copy_ulong8",
+    "copy_block_uint"};
+static const size_t kernel_copy_element_sizes[PEER_KERNEL_COPY_MAX] = {
+    sizeof(uint64_t), 2 * sizeof(uint64_t), 4 * sizeof(uint64_t),
+    8 * sizeof(uint64_t), sizeof(uint32_t)};
+
+//---------------------------------------------------------------------
+// Looks up the first engine of the local device able to run kernels, in
+// the numbering of option -u.
+//---------------------------------------------------------------------
+static uint32_t compute_engine_index(ZeApp *benchmark, uint32_t device_id) {
+  uint32_t num_queue_groups = 0;
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  nullptr);
+  std::vector<ze_command_queue_group_properties_t> queue_properties(
+      num_queue_groups);
+  for (auto &queue_property : queue_properties) {
+    queue_property = {ZE_STRUCTURE_TYPE_COMMAND_QUEUE_GROUP_PROPERTIES,
+                      nullptr};
+  }
+  benchmark->deviceGetCommandQueueGroupProperties(device_id, &num_queue_groups,
+                                                  queue_properties.data());
+  uint32_t engine_index = 0;
+  for (uint32_t g = 0; g < num_queue_groups; g++) {
+    if (queue_properties[g].flags &
+        ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE) {
+      return engine_index;
+    }
+    engine_index += queue_properties[g].numQueues;
+  }
+  throw std::runtime_error("No compute engine found");
+}
+
+//---------------------------------------------------------------------
+// Times number_iterations launches of one copy kernel from src_buffer to
+// dst_buffer with group_count groups of kernel_copy_group_size items,
+// every item striding over the buffer by the global size.
+//---------------------------------------------------------------------
+void ZePeer::perform_kernel_copy(peer_kernel_copy_t kernel_copy,
+                                 uint32_t group_count,
+                                 ze_kernel_handle_t kernel,
+                                 ze_command_list_handle_t command_list,
+                                 ze_command_queue_handle_t command_queue,
+                                 void *dst_buffer, void *src_buffer,
+                                 size_t buffer_size) {
+  uint64_t count = buffer_size / kernel_copy_element_sizes[kernel_copy];
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 0, sizeof(dst_buffer), &dst_buffer));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 1, sizeof(src_buffer), &src_buffer));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 2, sizeof(count), &count));
+  ze_group_count_t group_counts = {group_count, 1, 1};
+  SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+      command_list, kernel, &group_counts, nullptr, 0, nullptr));
+  SUCCESS_OR_TERMINATE(zeCommandListClose(command_list));
+
+  for (int i = 0; i < warm_up_iterations; i++) {
+    SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+        command_queue, 1, &command_list, nullptr));
+    SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+        command_queue, std::numeric_limits<uint64_t>::max()));
+  }
+
+  Timer<std::chrono::microseconds::period> timer;
+  timer.start();
+  for (int i = 0; i < number_iterations; i++) {
+    SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+        command_queue, 1, &command_list, nullptr));
+    SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
+        command_queue, std::numeric_limits<uint64_t>::max()));
+  }
+  timer.end();
+
+  long double time_usec = timer.period_minus_overhead() /
+                          static_cast<long double>(number_iterations);
+  last_result =
+      buffer_size / static_cast<long double>(ONE_GB) / (time_usec / 1e6);
+
+  SUCCESS_OR_TERMINATE(zeCommandListReset(command_list));
+}
+
+//---------------------------------------------------------------------
+// Runs the write or read between the local and the remote device first
+// on the engine of option -u with a copy, then on the first compute
+// engine of the local device with each selected copy kernel and group
+// count, and prints the kernel results next to the copy engine result.
+//---------------------------------------------------------------------
+void ZePeer::kernel_copy_bandwidth(peer_transfer_t transfer_type,
+                                   peer_kernel_copy_t kernel_copy_to_run,
+                                   int number_buffer_elements,
+                                   uint32_t remote_device_id,
+                                   uint32_t local_device_id,
+                                   uint32_t queue_index) {
+  size_t buffer_size = 0;
+  std::vector<uint32_t> remote_device_ids = {remote_device_id};
+  std::vector<uint32_t> local_device_ids = {local_device_id};
+  set_up(number_buffer_elements, remote_device_ids, local_device_ids,
+         buffer_size);
+
+  void *dst_buffer = ze_dst_buffers[remote_device_id];
+  void *src_buffer = ze_src_buffers[local_device_id];
+  if (transfer_type == PEER_READ) {
+    dst_buffer = ze_dst_buffers[local_device_id];
+    src_buffer = ze_src_buffers[remote_device_id];
+  }
+  initialize_buffers(remote_device_ids, local_device_ids, ze_host_buffer,
+                     buffer_size);
+
+  auto &copy_engine = ze_peer_devices[local_device_id].engines[queue_index];
+  std::cout << "Copy engine " << std::setw(2) << queue_index << "          ";
+  perform_copy(PEER_BANDWIDTH, copy_engine.second, copy_engine.first,
+               dst_buffer, src_buffer, buffer_size);
+  long double copy_engine_bandwidth = last_result;
+
+  auto &compute_engine =
+      ze_peer_devices[local_device_id]
+          .engines[compute_engine_index(benchmark, local_device_id)];
+  long double best_bandwidth = 0;
+  std::string best_kernel_copy = "";
+  for (uint32_t kernel_copy = 0;
+       kernel_copy < static_cast<uint32_t>(PEER_KERNEL_COPY_MAX);
+       kernel_copy++) {
+    if (kernel_copy_to_run != PEER_KERNEL_COPY_MAX &&
+        static_cast<peer_kernel_copy_t>(kernel_copy) != kernel_copy_to_run) {
+      continue;
+    }
+    ze_kernel_handle_t kernel = nullptr;
+    benchmark->functionCreate(local_device_id, &kernel,
+                              kernel_copy_names[kernel_copy]);
+    SUCCESS_OR_TERMINATE(
+        zeKernelSetGroupSize(kernel, kernel_copy_group_size, 1, 1));
+
+    uint64_t count = buffer_size / kernel_copy_element_sizes[kernel_copy];
+    for (auto group_count : kernel_copy_group_counts) {
+      if (group_count == 0) {
+        group_count = static_cast<uint32_t>(
+            (count + kernel_copy_group_size - 1) / kernel_copy_group_size);
+      }
+      perform_kernel_copy(static_cast<peer_kernel_copy_t>(kernel_copy),
+                          group_count, kernel, compute_engine.second,
+                          compute_engine.first, dst_buffer, src_buffer,
+                          buffer_size);
+      std::cout << std::left << std::setw(16) << kernel_copy_names[kernel_copy]
+                << std::right << std::setw(7) << group_count
+                << " groups BW [GBPS]: " << std::fixed << std::setw(8)
+                << std::setprecision(2) << last_result << "  ("
+                << std::setprecision(1)
+                << 100 * last_result / copy_engine_bandwidth
+                << " % of copy engine)" << std::endl;
+      if (last_result > best_bandwidth) {
+        best_bandwidth = last_result;
+        best_kernel_copy = std::string(kernel_copy_names[kernel_copy]) +
+                           " with " + std::to_string(group_count) +
+                           " groups";
+      }
+      if (group_count * kernel_copy_group_size >= count) {
+        break;
+      }
+    }
+    benchmark->functionDestroy(kernel);
+  }
+  std::cout << "Best kernel: " << best_kernel_copy << ", "
+            << (best_bandwidth > copy_engine_bandwidth ? "faster" : "slower")
+            << " than copy engine " << queue_index << std::endl;
+
+  if (validate_results) {
+    validate_buffer(compute_engine.second, compute_engine.first,
+                    ze_host_validate_buffer, dst_buffer, ze_host_buffer,
+                    buffer_size);
+  }
+
+  tear_down(remote_device_ids, local_device_ids);
+}
+
+//---------------------------------------------------------------------
+// Runs the kernel copy comparison between local_device_id and
+// remote_device_id for size_to_run bytes or for every size of the
+// default sweep holding whole subgroups of the widest element.
+//---------------------------------------------------------------------
+void run_kernel_copy_test(int size_to_run, uint32_t remote_device_id,
+                          uint32_t local_device_id, uint32_t queue,
+                          peer_transfer_t transfer_type_to_run,
+                          peer_kernel_copy_t kernel_copy_to_run) {
+  ZePeer::use_kernels = true;
+  std::vector<uint32_t> remote_device_ids{remote_device_id};
+  std::vector<uint32_t> local_device_ids{local_device_id};
+  std::vector<std::pair<uint32_t, uint32_t>> pair_device_ids{};
+  std::vector<uint32_t> queues{queue};
+  ZePeer peer(remote_device_ids, local_device_ids, pair_device_ids, queues);
+  if (ZePeer::validate_results) {
+    peer.warm_up_iterations = 0;
+    peer.number_iterations = 1;
+  }
+  peer.reserve_buffers((size_to_run != -1) ? size_to_run
+                                           : max_number_of_elements);
+
+  for (uint32_t transfer_type = 0;
+       transfer_type < static_cast<uint32_t>(PEER_TRANSFER_MAX);
+       transfer_type++) {
+    if (transfer_type_to_run != PEER_TRANSFER_MAX &&
+        static_cast<peer_transfer_t>(transfer_type) != transfer_type_to_run) {
+      continue;
+    }
+    std::cout << "-----------------------------------------------------"
+                 "---------------------------\n";
+    std::cout << "Kernel copy "
+              << (transfer_type == PEER_WRITE ? "Write : Device( "
+                                              : "Read : Device( ")
+              << local_device_id << " )"
+              << (transfer_type == PEER_WRITE ? "->" : "<-") << "Device( "
+              << remote_device_id << " )\n";
+
+    for (size_t size = kernel_copy_alignment; size <= max_number_of_elements;
+         size *= 2) {
+      if (size_to_run != -1) {
+        size = size_to_run;
+        if (size % kernel_copy_alignment) {
+          std::cerr << "[ERROR] Kernel copies need a size multiple of "
+                    << kernel_copy_alignment << " B\n";
+          return;
+        }
+      }
+      peer.kernel_copy_bandwidth(static_cast<peer_transfer_t>(transfer_type),
+                                 kernel_copy_to_run, static_cast<int>(size),
+                                 remote_device_id, local_device_id, queue);
+      if (size_to_run != -1) {
+        break;
+      }
+    }
+  }
+  std::cout << "-----------------------------------------------------"
+               "---------------------------\n";
+}
@@ -0,0 +1,144 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+#include "ze_peer.h"
+
+//---------------------------------------------------------------------
+// Initializes the root devices and, with use_subdevices, appends their
+// subdevices, so device i below the root device count keeps its index.
+//---------------------------------------------------------------------
+uint32_t ZePeer::init_devices() {
+  uint32_t count = benchmark->allDevicesInit();
+  if (use_subdevices) {
+    device_locations = benchmark->subDevicesInit();
+    count = static_cast<uint32_t>(benchmark->_devices.size());
+  }
+  return count;
+}
+
+uint32_t ZePeer::subdevice_index(uint32_t device_id, int subdevice_id) {
+  for (uint32_t d = 0; d < device_locations.size(); d++) {
+    if (device_locations[d].first == device_id &&
+        device_locations[d].second == subdevice_id) {
+      return d;
+    }
+  }
+  std::cerr << "[ERROR] Device " << device_id << "." << subdevice_id
+            << " not found\n";
+  std::terminate();
+}
+
+std::string ZePeer::device_name(uint32_t device_id) {
+  if (device_id >= device_locations.size()) {
+    return std::to_string(device_id);
+  }
+  auto &location = device_locations[device_id];
+  if (location.second < 0) {
+    return std::to_string(location.first);
+  }
+  return std::to_string(location.first) + "." +
+         std::to_string(location.second);
+}
+
+//---------------------------------------------------------------------
+// Tells which path a copy between two devices of the list takes: within
+// one tile, between tiles of one card, or between cards.
+//---------------------------------------------------------------------
+const char *ZePeer::device_path_name(uint32_t src_device_id,
+                                     uint32_t dst_device_id) {
+  auto &src = device_locations[src_device_id];
+  auto &dst = device_locations[dst_device_id];
+  if (src_device_id == dst_device_id) {
+    return (src.second < 0) ? "device-local" : "tile-local";
+  }
+  if (src.first != dst.first) {
+    return "cross-card";
+  }
+  if (src.second < 0 || dst.second < 0) {
+    return "same card, root device and tile";
+  }
+  return "tile-remote, same card";
+}
+
+//---------------------------------------------------------------------
+// Replaces the device.subdevice ids of -s and -d by the index of the
+// subdevice in the device list and prints the path of every pair. The
+// lookup runs in a child process, so the driver is not initialized in
+// this one before the IPC tests fork.
+//---------------------------------------------------------------------
+void resolve_subdevice_ids(std::vector<uint32_t> &remote_device_ids,
+                           std::vector<uint32_t> &local_device_ids) {
+  /* subdevices are only enumerated in the composite hierarchy */
+  putenv(const_cast<char *>("ZE_FLAT_DEVICE_HIERARCHY=COMPOSITE"));
+  ZePeer::use_subdevices = true;
+
+  std::vector<uint32_t> device_ids = local_device_ids;
+  device_ids.insert(device_ids.end(), remote_device_ids.begin(),
+                    remote_device_ids.end());
+
+  int fds[2];
+  if (pipe(fds) < 0) {
+    perror("pipe");
+    exit(1);
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    ZePeer peer(nullptr);
+    for (auto &device_id : device_ids) {
+      if (device_id & peer_subdevice_id_flag) {
+        device_id = peer.subdevice_index((device_id >> 16) & 0x7fff,
+                                         static_cast<int>(device_id & 0xffff));
+      } else if (device_id >= peer.device_count) {
+        std::cerr << "[ERROR] Device " << device_id << " not found\n";
+        std::terminate();
+      }
+    }
+    for (uint32_t d = 0; d < peer.device_count; d++) {
+      std::cout << "Device " << std::setw(2) << d << " : "
+                << peer.device_name(d) << "\n";
+    }
+    for (size_t l = 0; l < local_device_ids.size(); l++) {
+      for (size_t r = local_device_ids.size(); r < device_ids.size(); r++) {
+        std::cout << "Device( " << peer.device_name(device_ids[l])
+                  << " )->Device( " << peer.device_name(device_ids[r])
+                  << " ) : "
+                  << peer.device_path_name(device_ids[l], device_ids[r])
+                  << "\n";
+      }
+    }
+    std::cout << std::endl;
+    ssize_t size = device_ids.size() * sizeof(uint32_t);
+    if (write(fds[1], device_ids.data(), size) != size) {
+      std::cerr << "Failing to send resolved device ids\n";
+      std::terminate();
+    }
+    exit(0);
+  }
+
+  close(fds[1]);
+  size_t received = 0;
+  size_t size = device_ids.size() * sizeof(uint32_t);
+  while (received < size) {
+    ssize_t bytes = read(fds[0], reinterpret_cast<char *>(device_ids.data()) +
+                                     received,
+                         size - received);
+    if (bytes <= 0) {
+      std::cerr << "[ERROR] Subdevices could not be resolved\n";
+      exit(-1);
+    }
+    received += bytes;
+  }
+  close(fds[0]);
+  int child_status;
+  waitpid(pid, &child_status, 0);
+
+  std::copy(device_ids.begin(), device_ids.begin() + local_device_ids.size(),
+            local_device_ids.begin());
+  std::copy(device_ids.begin() + local_device_ids.size(), device_ids.end(),
+            remote_device_ids.begin());
+}
@@ -0,0 +1,184 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+#include "ze_peer.h"
+
+volatile sig_atomic_t ZePeerTelemetry::interrupted = 0;
+uint32_t ZePeerTelemetry::window_size = 100;
+uint32_t ZePeerTelemetry::report_period_sec = 10;
+
+static const char *fabric_port_status_name(zes_fabric_port_status_t status) {
+  switch (status) {
+  case ZES_FABRIC_PORT_STATUS_HEALTHY:
+    return "healthy";
+  case ZES_FABRIC_PORT_STATUS_DEGRADED:
+    return "DEGRADED";
+  case ZES_FABRIC_PORT_STATUS_FAILED:
+    return "FAILED";
+  case ZES_FABRIC_PORT_STATUS_DISABLED:
+    return "disabled";
+  default:
+    return "unknown";
+  }
+}
+
+//---------------------------------------------------------------------
+// First CTRL+C of a continuous run asks for the summary, which the next
+// result prints before exiting, a second one exits right away.
+//---------------------------------------------------------------------
+void telemetry_handler(int signal) {
+  if (ZePeerTelemetry::interrupted) {
+    _exit(1);
+  }
+  ZePeerTelemetry::interrupted = 1;
+}
+
+//---------------------------------------------------------------------
+// Looks up the fabric ports of every device through sysman, with their
+// first throughput counters as the reference of the rates. Devices
+// without sysman or fabric ports are left out.
+//---------------------------------------------------------------------
+void ZePeerTelemetry::query_fabric_ports(ZeApp *benchmark) {
+  for (uint32_t d = 0; d < benchmark->_devices.size(); d++) {
+    zes_device_handle_t device =
+        reinterpret_cast<zes_device_handle_t>(benchmark->_devices[d]);
+    uint32_t port_count = 0;
+    if (zesDeviceEnumFabricPorts(device, &port_count, nullptr) !=
+            ZE_RESULT_SUCCESS ||
+        port_count == 0) {
+      continue;
+    }
+    std::vector<zes_fabric_port_handle_t> handles(port_count);
+    SUCCESS_OR_TERMINATE(
+        zesDeviceEnumFabricPorts(device, &port_count, handles.data()));
+    for (auto handle : handles) {
+      ze_peer_fabric_port_t port = {};
+      port.device_id = d;
+      port.handle = handle;
+      zes_fabric_port_properties_t properties = {
+          ZES_STRUCTURE_TYPE_FABRIC_PORT_PROPERTIES, nullptr};
+      SUCCESS_OR_TERMINATE(zesFabricPortGetProperties(handle, &properties));
+      port.port_number = properties.portId.portNumber;
+      port.subdevice_id =
+          properties.onSubdevice ? static_cast<int>(properties.subdeviceId)
+                                 : -1;
+      SUCCESS_OR_TERMINATE(zesFabricPortGetThroughput(handle, &port.first));
+      port.last = port.first;
+      fabric_ports.push_back(port);
+    }
+  }
+  fabric_ports_queried = true;
+}
+
+//---------------------------------------------------------------------
+// Prints rx and tx rates of every fabric port since the previous report,
+// or since the start with since_start, next to its health.
+//---------------------------------------------------------------------
+void ZePeerTelemetry::print_fabric_ports(bool since_start) {
+  for (auto &port : fabric_ports) {
+    zes_fabric_port_throughput_t throughput = {};
+    SUCCESS_OR_TERMINATE(zesFabricPortGetThroughput(port.handle, &throughput));
+    zes_fabric_port_state_t state = {ZES_STRUCTURE_TYPE_FABRIC_PORT_STATE,
+                                     nullptr};
+    SUCCESS_OR_TERMINATE(zesFabricPortGetState(port.handle, &state));
+
+    auto &reference = since_start ? port.first : port.last;
+    long double elapsed_usec = throughput.timestamp - reference.timestamp;
+    long double rx_rate = 0;
+    long double tx_rate = 0;
+    if (elapsed_usec > 0) {
+      /* bytes per us over 1e3 are GBPS */
+      rx_rate = (throughput.rxCounter - reference.rxCounter) / elapsed_usec /
+                1e3;
+      tx_rate = (throughput.txCounter - reference.txCounter) / elapsed_usec /
+                1e3;
+    }
+    port.last = throughput;
+
+    std::cout << "  Device(" << port.device_id;
+    if (port.subdevice_id >= 0) {
+      std::cout << "." << port.subdevice_id;
+    }
+    std::cout << ") port " << std::setw(2) << port.port_number
+              << ": rx [GBPS] " << std::fixed << std::setprecision(2)
+              << std::setw(8) << rx_rate << "  tx [GBPS] " << std::setw(8)
+              << tx_rate << "  " << fabric_port_status_name(state.status)
+              << std::endl;
+  }
+}
+
+//---------------------------------------------------------------------
+// Records one result of the continuous run into the totals and the
+// rolling window, prints min/avg/max/p99 of the window with the fabric
+// port rates every report_period_sec, and the summary once interrupted.
+//---------------------------------------------------------------------
+void ZePeerTelemetry::add(ZeApp *benchmark, peer_test_t type,
+                          long double value) {
+  if (!fabric_ports_queried) {
+    query_fabric_ports(benchmark);
+    report_timer.start();
+  }
+  test_type = type;
+
+  window.push_back(value);
+  if (window.size() > window_size) {
+    window.pop_front();
+  }
+  total_count++;
+  total_sum += value;
+  total_min = (total_count == 1) ? value : std::min(total_min, value);
+  total_max = (total_count == 1) ? value : std::max(total_max, value);
+
+  report_timer.end();
+  if (report_timer.period_minus_overhead() >= report_period_sec * 1e9) {
+    std::cout << "Rolling " << window.size() << " results: ";
+    print_window();
+    print_fabric_ports(false);
+    report_timer.start();
+  }
+
+  if (interrupted) {
+    print_summary();
+    exit(0);
+  }
+}
+
+void ZePeerTelemetry::print_window() {
+  std::vector<long double> sorted(window.begin(), window.end());
+  std::sort(sorted.begin(), sorted.end());
+  long double sum = 0;
+  for (auto value : sorted) {
+    sum += value;
+  }
+  size_t p99_index =
+      static_cast<size_t>(std::ceil(0.99 * sorted.size())) - 1;
+  std::cout << ((test_type == PEER_BANDWIDTH) ? "BW [GBPS]" : "Latency [us]")
+            << std::fixed << std::setprecision(2) << " min " << sorted.front()
+            << " avg " << sum / sorted.size() << " max " << sorted.back()
+            << " p99 " << sorted[p99_index] << std::endl;
+}
+
+void ZePeerTelemetry::print_summary() {
+  std::cout << "============================================================="
+               "===================\n"
+            << "Continuous run summary: " << total_count << " results\n";
+  if (total_count) {
+    std::cout << "  All results: "
+              << ((test_type == PEER_BANDWIDTH) ? "BW [GBPS]" : "Latency [us]")
+              << std::fixed << std::setprecision(2) << " min " << total_min
+              << " avg " << total_sum / total_count << " max " << total_max
+              << "\n  Last " << window.size() << " results: ";
+    print_window();
+  }
+  if (!fabric_ports.empty()) {
+    std::cout << "  Fabric ports over the whole run:\n";
+    print_fabric_ports(true);
+  }
+  std::cout << "============================================================="
+               "==================="
+            << std::endl;
+}
@@ -30,8 +30,12 @@ void ZePeer::perform_copy(peer_test_t test_type,
   do {
     timer.start();
     for (int i = 0; i < number_iterations; i++) {
-      SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
-          command_queue, 1, &command_list, nullptr));
+      {
+        TraceSpan span("zeCommandQueueExecuteCommandLists", "submit");
+        SUCCESS_OR_TERMINATE(zeCommandQueueExecuteCommandLists(
+            command_queue, 1, &command_list, nullptr));
+      }
+      TraceSpan span("zeCommandQueueSynchronize", "sync");
       SUCCESS_OR_TERMINATE(zeCommandQueueSynchronize(
           command_queue, std::numeric_limits<uint64_t>::max()));
     }
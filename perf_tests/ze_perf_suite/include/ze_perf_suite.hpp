@@ -0,0 +1,84 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_PERF_SUITE_HPP_
+#define _ZE_PERF_SUITE_HPP_
+
+#include "../../ze_peak/include/ze_peak.h"
+#include "results.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/* One entry of a test plan: a tool and its command line */
+struct PlanTest {
+  std::string name;
+  std::string tool;
+  std::vector<std::string> args;
+  uint32_t repeat = 1;
+};
+
+/*
+ * A JSON test plan:
+ *
+ *   {
+ *     "report": "console,json:nightly.json",
+ *     "tests": [
+ *       {"name": "compute", "tool": "ze_peak", "args": ["-t", "sp_compute"]},
+ *       {"name": "h2d", "tool": "ze_bandwidth", "args": ["-t", "h2d"],
+ *        "repeat": 3}
+ *     ]
+ *   }
+ *
+ * Names default to the tool, args to none and repeat to once. On a
+ * malformed plan, a std::runtime_error is thrown.
+ */
+struct TestPlan {
+  std::string report;
+  std::vector<PlanTest> tests;
+
+  static TestPlan load(const std::string &file_name);
+};
+
+/*
+ * Runs the tests of a plan in one process and reports all their results
+ * together. ze_peak is built in and its tests share one driver context,
+ * which is only initialized again when a test selects another driver,
+ * device or engine. The other tools keep their own main and are run from
+ * the binary directory, and those taking --results report their records
+ * into the combined report. Every test adds its exit status and duration.
+ */
+class ZePerfSuite {
+public:
+  ZePerfSuite(const std::string &binary_dir);
+  ~ZePerfSuite();
+
+  /* Number of failed tests, plus one when a gate:<dir> sink of the report
+   * found a regression */
+  uint32_t run(const TestPlan &plan);
+
+  ResultReport results{"ze_perf_suite"};
+
+private:
+  int run_ze_peak(const PlanTest &test, uint32_t repetition);
+  int run_tool(const PlanTest &test, uint32_t repetition);
+  void merge_results(const PlanTest &test, uint32_t repetition,
+                     const std::string &file_name);
+  void init_context(const ZePeak &peak);
+  void read_metadata();
+
+  std::string binary_dir;
+  std::unique_ptr<L0Context> context;
+  bool context_ready = false;
+  /* Driver, device, explicit scaling, fixed ordinal, ordinal and index of
+   * the current context */
+  std::vector<uint32_t> context_key;
+};
+
+#endif /* _ZE_PERF_SUITE_HPP_ */
@@ -0,0 +1,57 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_perf_suite.hpp"
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <stdexcept>
+
+namespace pt = boost::property_tree;
+
+TestPlan TestPlan::load(const std::string &file_name) {
+  pt::ptree tree;
+  try {
+    pt::read_json(file_name, tree);
+  } catch (const pt::json_parser_error &error) {
+    throw std::runtime_error("cannot read test plan " + file_name + ": " +
+                             error.what());
+  }
+
+  TestPlan plan;
+  plan.report = tree.get<std::string>("report", "");
+
+  auto tests = tree.get_child_optional("tests");
+  if (!tests || tests->empty()) {
+    throw std::runtime_error("test plan " + file_name + " has no tests");
+  }
+  for (auto &entry : *tests) {
+    const pt::ptree &node = entry.second;
+    PlanTest test;
+    test.tool = node.get<std::string>("tool", "");
+    if (test.tool.empty()) {
+      throw std::runtime_error("test plan " + file_name +
+                               " has a test without a tool");
+    }
+    test.name = node.get<std::string>("name", test.tool);
+    try {
+      test.repeat = node.get<uint32_t>("repeat", 1);
+    } catch (const pt::ptree_bad_data &) {
+      throw std::runtime_error("test " + test.name + " has a bad repeat");
+    }
+    auto args = node.get_child_optional("args");
+    if (args) {
+      for (auto &arg : *args) {
+        test.args.push_back(arg.second.get_value<std::string>());
+      }
+    }
+    plan.tests.push_back(test);
+  }
+  return plan;
+}
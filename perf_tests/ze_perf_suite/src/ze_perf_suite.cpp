@@ -0,0 +1,437 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_perf_suite.hpp"
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#if defined(unix) || defined(__unix__) || defined(__unix)
+#include <sys/wait.h>
+#endif
+
+namespace pt = boost::property_tree;
+
+static const char *usage_str =
+    "\n ze_perf_suite [OPTIONS] plan.json"
+    "\n"
+    "\n Runs the tests of a JSON test plan and reports their results together"
+    "\n"
+    "\n OPTIONS:"
+    "\n  --results list           report to a comma separated list of console,"
+    "\n                           csv, csv:<file>, json:<file>, gate:<dir> and"
+    "\n                           baseline:<dir>, overriding"
+    "\n                           the report of the plan [default: console]"
+    "\n  --binary-dir dir         directory of the other perf tools"
+    "\n                           [default: directory of ze_perf_suite]"
+    "\n  --list                   print the tests of the plan and exit"
+    "\n  -h, --help               display help message"
+    "\n";
+
+/* Tools run as child processes, and whether they take --results */
+static const struct {
+  const char *name;
+  bool takes_results;
+} external_tools[] = {
+    {"ze_bandwidth", true},       {"ze_alloc", true},
+    {"ze_launch_args", true},     {"ze_cmdlist_replay", true},
+    {"ze_mutable_cmdlist", true}, {"ze_multi_context", true},
+    {"ze_cl_interop", true},      {"ze_sampler", true},
+    {"ze_fabric", true},          {"ze_autotune", true},
+    {"ze_cooperative", true},     {"ze_peer", false},
+    {"ze_nano", false},           {"ze_pingpong", false},
+    {"ze_cabe", false},           {"ze_image_copy", false},
+    {"cl_image_copy", false}};
+
+static const char *ze_peak_tool = "ze_peak";
+
+static bool is_external_tool(const std::string &tool, bool *takes_results) {
+  for (auto &external : external_tools) {
+    if (tool == external.name) {
+      if (takes_results) {
+        *takes_results = external.takes_results;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::string shell_quoted(const std::string &arg) {
+#if defined(_WIN32)
+  return "\"" + arg + "\"";
+#else
+  std::string quoted = "'";
+  for (auto c : arg) {
+    if (c == '\'') {
+      quoted += "'\\''";
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "'";
+#endif
+}
+
+static void add_test_parameters(ResultRecord &record, const PlanTest &test,
+                                uint32_t repetition) {
+  record.parameters.push_back({"tool", test.tool});
+  if (test.repeat > 1) {
+    record.parameters.push_back({"repetition", std::to_string(repetition)});
+  }
+}
+
+ZePerfSuite::ZePerfSuite(const std::string &binary_dir)
+    : binary_dir(binary_dir) {}
+
+ZePerfSuite::~ZePerfSuite() {
+  if (context_ready) {
+    try {
+      context->clean_xe();
+    } catch (const std::exception &error) {
+      std::cerr << "ERROR : " << error.what() << std::endl;
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Reads the driver and devices for the report, from the first driver
+// which is also the default of the tools.
+//---------------------------------------------------------------------
+void ZePerfSuite::read_metadata() {
+  ze_result_t result = zeInit(0);
+  if (result) {
+    throw std::runtime_error("zeInit failed: " + std::to_string(result));
+  }
+
+  uint32_t driver_count = 1;
+  ze_driver_handle_t driver = nullptr;
+  result = zeDriverGet(&driver_count, &driver);
+  if (result || driver_count == 0) {
+    throw std::runtime_error("zeDriverGet failed: " + std::to_string(result));
+  }
+
+  uint32_t device_count = 0;
+  result = zeDeviceGet(driver, &device_count, nullptr);
+  if (result) {
+    throw std::runtime_error("zeDeviceGet failed: " + std::to_string(result));
+  }
+  std::vector<ze_device_handle_t> devices(device_count);
+  result = zeDeviceGet(driver, &device_count, devices.data());
+  if (result) {
+    throw std::runtime_error("zeDeviceGet failed: " + std::to_string(result));
+  }
+  results.read_metadata(driver, devices);
+}
+
+//---------------------------------------------------------------------
+// Initializes the ze_peak context for the driver, device and engine a
+// test selects, keeping the current one when they are the same.
+//---------------------------------------------------------------------
+void ZePerfSuite::init_context(const ZePeak &peak) {
+  const std::vector<uint32_t> key = {
+      peak.specified_driver,           peak.specified_device,
+      peak.enable_explicit_scaling,    peak.enable_fixed_ordinal_index,
+      peak.command_queue_group_ordinal, peak.command_queue_index};
+  if (context_ready && key == context_key) {
+    context->verbose = peak.verbose;
+    return;
+  }
+  if (context_ready) {
+    context_ready = false;
+    context->clean_xe();
+  }
+
+  context.reset(new L0Context());
+  context->verbose = peak.verbose;
+  bool enable_fixed_ordinal_index = peak.enable_fixed_ordinal_index;
+  context->init_xe(peak.specified_driver, peak.specified_device, false,
+                   peak.enable_explicit_scaling, enable_fixed_ordinal_index,
+                   peak.command_queue_group_ordinal, peak.command_queue_index);
+  context_ready = true;
+  context_key = key;
+}
+
+int ZePerfSuite::run_ze_peak(const PlanTest &test, uint32_t repetition) {
+  std::vector<std::string> args = {ze_peak_tool};
+  args.insert(args.end(), test.args.begin(), test.args.end());
+  std::vector<char *> argv;
+  for (auto &arg : args) {
+    argv.push_back(&arg[0]);
+  }
+  argv.push_back(nullptr);
+
+  ZePeak peak;
+  peak.parse_arguments(static_cast<int>(args.size()), argv.data());
+  if (peak.query_engines) {
+    std::cerr << "ERROR : " << test.name
+              << ": -q only queries engines and is not run in a test plan"
+              << std::endl;
+    return 1;
+  }
+
+  init_context(peak);
+  if (peak.placement.enabled()) {
+    peak.placement.apply(context->device);
+    std::cout << peak.placement.describe() << std::endl;
+  }
+  peak.run_tests(*context);
+  peak.write_results(*context);
+
+  for (auto &entry : peak.results) {
+    ResultRecord record;
+    record.test = test.name + "/" + entry.test;
+    record.metric = entry.variant;
+    record.unit = entry.unit;
+    record.value = entry.value;
+    add_test_parameters(record, test, repetition);
+    if (entry.tile >= 0) {
+      record.parameters.push_back({"tile", std::to_string(entry.tile)});
+    }
+    record.parameters.push_back(
+        {"iterations", std::to_string(entry.iterations)});
+    record.parameters.push_back({"stddev", std::to_string(entry.stddev)});
+    if (entry.power > 0) {
+      record.parameters.push_back({"power_w", std::to_string(entry.power)});
+    }
+    if (entry.frequency > 0) {
+      record.parameters.push_back(
+          {"frequency_mhz", std::to_string(entry.frequency)});
+    }
+    results.add(record);
+  }
+  return 0;
+}
+
+int ZePerfSuite::run_tool(const PlanTest &test, uint32_t repetition) {
+  bool takes_results = false;
+  is_external_tool(test.tool, &takes_results);
+
+  std::string command = shell_quoted(binary_dir + "/" + test.tool);
+  for (auto &arg : test.args) {
+    command += " " + shell_quoted(arg);
+  }
+  std::string results_file;
+  if (takes_results && results.enabled()) {
+    results_file = "ze_perf_suite." + test.tool + ".json";
+    command += " --results " + shell_quoted("json:" + results_file);
+  }
+#if defined(_WIN32)
+  /* cmd.exe strips the outer quotes of the command line */
+  command = "\"" + command + "\"";
+#endif
+
+  std::cout << command << std::endl;
+  int status = std::system(command.c_str());
+#if defined(unix) || defined(__unix__) || defined(__unix)
+  if (status != -1 && WIFEXITED(status)) {
+    status = WEXITSTATUS(status);
+  }
+#endif
+
+  if (!results_file.empty()) {
+    merge_results(test, repetition, results_file);
+    std::remove(results_file.c_str());
+  }
+  return status;
+}
+
+//---------------------------------------------------------------------
+// Adds the records of a JSON report written by a tool with --results,
+// keeping only the records, as the suite reports its own metadata.
+//---------------------------------------------------------------------
+void ZePerfSuite::merge_results(const PlanTest &test, uint32_t repetition,
+                                const std::string &file_name) {
+  pt::ptree tree;
+  try {
+    pt::read_json(file_name, tree);
+  } catch (const pt::json_parser_error &error) {
+    std::cerr << "ERROR : " << test.name << ": no results: " << error.what()
+              << std::endl;
+    return;
+  }
+
+  auto tool_results = tree.get_child_optional("results");
+  if (!tool_results) {
+    return;
+  }
+  for (auto &entry : *tool_results) {
+    const pt::ptree &node = entry.second;
+    ResultRecord record;
+    record.test = test.name + "/" + node.get<std::string>("test", "");
+    record.metric = node.get<std::string>("metric", "");
+    record.unit = node.get<std::string>("unit", "");
+    record.value = strtold(node.get<std::string>("value", "nan").c_str(),
+                           nullptr);
+    add_test_parameters(record, test, repetition);
+    auto parameters = node.get_child_optional("parameters");
+    if (parameters) {
+      for (auto &parameter : *parameters) {
+        record.parameters.push_back(
+            {parameter.first, parameter.second.get_value<std::string>()});
+      }
+    }
+    auto stats = node.get_child_optional("stats");
+    if (stats) {
+      auto stat = [&](const char *name) {
+        return strtold(stats->get<std::string>(name, "nan").c_str(), nullptr);
+      };
+      record.stats.count = stats->get<size_t>("count", 0);
+      record.stats.min = stat("min");
+      record.stats.max = stat("max");
+      record.stats.mean = stat("mean");
+      record.stats.median = stat("median");
+      record.stats.stddev = stat("stddev");
+      record.stats.p99 = stat("p99");
+    }
+    results.add(record);
+  }
+}
+
+uint32_t ZePerfSuite::run(const TestPlan &plan) {
+  bool monitor_power = false;
+  for (auto &test : plan.tests) {
+    if (test.tool == ze_peak_tool) {
+      std::vector<char *> argv = {nullptr};
+      for (auto &arg : test.args) {
+        monitor_power |= (arg == "--power");
+        argv.push_back(const_cast<char *>(arg.c_str()));
+      }
+      monitor_power |= HostPlacement::needs_sysman(
+          static_cast<int>(argv.size()), argv.data());
+    } else if (!is_external_tool(test.tool, nullptr)) {
+      throw std::runtime_error("test " + test.name + " has unknown tool " +
+                               test.tool);
+    }
+  }
+  /* Must be set before the first zeInit, which initializes sysman */
+  if (monitor_power) {
+    static char sys_env[] = "ZES_ENABLE_SYSMAN=1";
+    putenv(sys_env);
+  }
+  if (results.enabled()) {
+    read_metadata();
+  }
+
+  uint32_t failed = 0;
+  for (auto &test : plan.tests) {
+    for (uint32_t repetition = 0; repetition < test.repeat; repetition++) {
+      std::cout << "==== " << test.name;
+      if (test.repeat > 1) {
+        std::cout << " (" << repetition + 1 << "/" << test.repeat << ")";
+      }
+      std::cout << " ====" << std::endl;
+
+      const auto begin = std::chrono::steady_clock::now();
+      int status = 0;
+      try {
+        status = (test.tool == ze_peak_tool) ? run_ze_peak(test, repetition)
+                                             : run_tool(test, repetition);
+      } catch (const std::exception &error) {
+        std::cerr << "ERROR : " << test.name << ": " << error.what()
+                  << std::endl;
+        status = 1;
+        /* The context may be left half way, the next test starts over */
+        context_ready = false;
+      }
+      const std::chrono::duration<long double> duration =
+          std::chrono::steady_clock::now() - begin;
+
+      ResultRecord status_record;
+      status_record.test = test.name;
+      status_record.metric = "exit_status";
+      status_record.value = status;
+      add_test_parameters(status_record, test, repetition);
+      results.add(status_record);
+
+      ResultRecord duration_record = status_record;
+      duration_record.metric = "duration";
+      duration_record.unit = "s";
+      duration_record.value = duration.count();
+      results.add(duration_record);
+
+      if (status) {
+        failed++;
+      }
+    }
+  }
+  const bool regressed = results.finish() != 0;
+
+  std::cout << plan.tests.size() << " tests run, " << failed << " failed"
+            << std::endl;
+  if (regressed) {
+    std::cout << "Performance regressed against the baseline" << std::endl;
+  }
+  return failed + (regressed ? 1 : 0);
+}
+
+int main(int argc, char **argv) {
+  std::string plan_file;
+  std::string sinks;
+  std::string binary_dir = argv[0];
+  const size_t separator = binary_dir.find_last_of("/\\");
+  binary_dir =
+      separator == std::string::npos ? "." : binary_dir.substr(0, separator);
+  bool list = false;
+
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      return 0;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1) < argc) {
+      sinks = argv[++i];
+    } else if ((strcmp(argv[i], "--binary-dir") == 0) && (i + 1) < argc) {
+      binary_dir = argv[++i];
+    } else if (strcmp(argv[i], "--list") == 0) {
+      list = true;
+    } else if (argv[i][0] != '-' && plan_file.empty()) {
+      plan_file = argv[i];
+    } else {
+      std::cout << usage_str;
+      return -1;
+    }
+  }
+  if (plan_file.empty()) {
+    std::cout << usage_str;
+    return -1;
+  }
+
+  try {
+    const TestPlan plan = TestPlan::load(plan_file);
+    if (list) {
+      for (auto &test : plan.tests) {
+        std::cout << test.name << ": " << test.tool;
+        for (auto &arg : test.args) {
+          std::cout << " " << arg;
+        }
+        if (test.repeat > 1) {
+          std::cout << " (" << test.repeat << " times)";
+        }
+        std::cout << std::endl;
+      }
+      return 0;
+    }
+
+    ZePerfSuite suite(binary_dir);
+    if (sinks.empty()) {
+      sinks = plan.report.empty() ? "console" : plan.report;
+    }
+    if (!suite.results.add_sinks(sinks)) {
+      return -1;
+    }
+    return suite.run(plan) ? 1 : 0;
+  } catch (const std::exception &error) {
+    std::cerr << "ERROR : " << error.what() << std::endl;
+    return 1;
+  }
+}
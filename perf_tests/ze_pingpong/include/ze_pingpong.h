@@ -27,6 +27,8 @@
 /* ze includes */
 #include <level_zero/ze_api.h>
 
+#include "utils/binary_file.hpp"
+
 enum TestType {
   DEVICE_MEM_KERNEL_ONLY,
   DEVICE_MEM_XFER,
@@ -36,6 +38,49 @@ enum TestType {
   SHARED_MEM_MAP
 };
 
+/* How the host learns that a round trip completed */
+enum SyncMechanism {
+  SYNC_COMMAND_QUEUE,
+  SYNC_EVENT_HOST,
+  SYNC_EVENT_QUERY,
+  SYNC_FENCE,
+  SYNC_DEVICE_POLLING
+};
+
+/* Ints between the request and the reply of the mailbox, one cache line */
+const int mailbox_reply_index = 16;
+
+/* How the commands of an iteration reach the device */
+enum SubmitMode {
+  SUBMIT_REGULAR_REUSE,
+  SUBMIT_REGULAR_RERECORD,
+  SUBMIT_IMMEDIATE_SYNC,
+  SUBMIT_IMMEDIATE_ASYNC,
+  SUBMIT_MULTI_QUEUE
+};
+
+/* Queues with a submission in flight in SUBMIT_MULTI_QUEUE */
+const int queues_in_flight = 4;
+
+/* Round trips of each device to device kernel relaunch measurement */
+const int peer_relaunch_round_trips = 1000;
+
+/* Ints of the device to device mailbox, the error count at the end */
+const int peer_mailbox_errors_index = 2 * mailbox_reply_index;
+
+/* One of the two devices of the device to device experiments */
+struct PeerSide {
+  ze_device_handle_t device = nullptr;
+  ze_device_properties_t device_property = {ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES,
+                                            nullptr};
+  ze_module_handle_t module = nullptr;
+  ze_kernel_handle_t function = nullptr;
+  ze_module_handle_t persistent_module = nullptr;
+  ze_kernel_handle_t persistent_function = nullptr;
+  ze_command_queue_handle_t command_queue = nullptr;
+  ze_command_list_handle_t command_list = nullptr;
+};
+
 struct L0Context {
   ze_command_queue_handle_t command_queue = nullptr;
   ze_command_list_handle_t command_list = nullptr;
@@ -44,6 +89,20 @@ struct L0Context {
   ze_driver_handle_t driver = nullptr;
   ze_device_handle_t device = nullptr;
   ze_kernel_handle_t function = nullptr;
+  /* Asynchronous queue and list of the synchronization experiments */
+  ze_command_queue_handle_t async_command_queue = nullptr;
+  ze_command_list_handle_t sync_command_list = nullptr;
+  ze_event_pool_handle_t event_pool = nullptr;
+  ze_event_handle_t event = nullptr;
+  ze_fence_handle_t fence = nullptr;
+  ze_module_handle_t persistent_module = nullptr;
+  ze_kernel_handle_t persistent_function = nullptr;
+  void *mailbox = nullptr;
+  /* Lists and queues of the command submission experiments */
+  ze_command_list_handle_t immediate_sync_command_list = nullptr;
+  ze_command_list_handle_t immediate_async_command_list = nullptr;
+  ze_command_queue_handle_t multi_command_queues[queues_in_flight] = {};
+  ze_command_list_handle_t multi_command_lists[queues_in_flight] = {};
   ze_group_count_t thread_group_dimensions = {1, 1, 1};
   void *device_input = nullptr;
   void *host_output = nullptr;
@@ -58,24 +117,71 @@ struct L0Context {
   void init();
   void destroy();
   void print_ze_device_properties(const ze_device_properties_t &props);
-  std::vector<uint8_t> load_binary_file(const std::string &file_path);
+  level_zero_tests::BinaryFile load_binary_file(const std::string &file_path);
 };
 
 class ZePingPong {
 public:
   int num_execute = 20000;
+  enum SubmitMode submit_mode = SUBMIT_REGULAR_REUSE;
   /* Helper Functions */
-  void create_module(L0Context &context, std::vector<uint8_t> binary_file,
+  void create_module(L0Context &context,
+                     const level_zero_tests::BinaryFile &binary_file,
                      ze_module_format_t format, const char *build_flag);
+  void create_module(L0Context &context,
+                     const level_zero_tests::BinaryFile &binary_file,
+                     ze_module_format_t format, const char *build_flag,
+                     ze_module_handle_t &module);
+  void create_module(L0Context &context, ze_device_handle_t device,
+                     const level_zero_tests::BinaryFile &binary_file,
+                     ze_module_format_t format, const char *build_flag,
+                     ze_module_handle_t &module);
   void set_argument_value(L0Context &context, uint32_t argIndex, size_t argSize,
                           const void *pArgValue);
+  void append_commands(L0Context &context, ze_command_list_handle_t list,
+                       enum TestType test);
   void setup_commandlist(L0Context &context, enum TestType test);
+  void submit_commands(L0Context &context, enum TestType test, int iteration);
+  void synchronize_multi_queues(L0Context &context);
   void run_test(L0Context &context);
   void run_command_queue(L0Context &context);
   double measure_benchmark(L0Context &context, enum TestType test);
   void reset_commandlist(L0Context &context);
   void synchronize_command_queue(L0Context &context);
+  void synchronize_command_queue_async(L0Context &context);
   void verify_result(int result);
+  void setup_sync_commandlist(L0Context &context,
+                              enum SyncMechanism mechanism);
+  void measure_round_trips(L0Context &context, enum SyncMechanism mechanism,
+                           std::vector<double> &round_trips);
+  void create_persistent_kernel(L0Context &context);
+  void destroy_persistent_kernel(L0Context &context);
+  void start_persistent_kernel(L0Context &context, void *mailbox_buffer);
+  void stop_persistent_kernel(L0Context &context, void *mailbox_buffer);
+  void measure_persistent_round_trips(L0Context &context, void *mailbox_buffer,
+                                      std::vector<double> &round_trips);
+  double measure_doorbell_rate(L0Context &context, void *mailbox_buffer,
+                               int window);
+  void print_latency_distribution(const std::string &name,
+                                  std::vector<double> &round_trips);
+  void run_sync_test(L0Context &context);
+  void run_doorbell_test(L0Context &context);
+  void run_submission_test(L0Context &context);
+  void create_peer_side(L0Context &context, ze_device_handle_t device,
+                        const char *persistent_name, PeerSide &side);
+  void destroy_peer_side(PeerSide &side);
+  void synchronize_peer_sides(PeerSide *sides);
+  double peer_timestamp_nsec(const PeerSide &side, uint64_t begin,
+                             uint64_t end);
+  void measure_peer_relaunch_round_trips(
+      L0Context &context, PeerSide *sides,
+      const std::vector<ze_event_handle_t> &events, void *counter,
+      std::vector<double> &round_trips);
+  void measure_peer_persistent_round_trips(
+      L0Context &context, PeerSide *sides,
+      const std::vector<ze_event_handle_t> &events, void *mailbox,
+      std::vector<double> &round_trips);
+  void run_peer_test(L0Context &context);
 };
 
 #endif /* ZE_PINGPONG_H */
@@ -0,0 +1,37 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * The two sides of a device to device ping-pong through a mailbox in peer
+ * memory, each launched once on its own device. The initiator posts round
+ * trip i in mailbox[0] with a payload in mailbox[1] and spins until the
+ * responder echoes the payload to mailbox[17] and the round trip to
+ * mailbox[16], a cache line away. Payloads echoed wrong are counted in
+ * mailbox[32].
+ */
+__kernel __attribute__((reqd_work_group_size(1, 1, 1))) void
+kPingPongPeerInitiator(__global int *mailbox, int round_trips) {
+  for (int i = 1; i <= round_trips; i++) {
+    atomic_xchg(&mailbox[1], i ^ 0x5A5A5A5A);
+    atomic_xchg(&mailbox[0], i);
+    while (atomic_add(&mailbox[16], 0) != i)
+      ;
+    if (atomic_add(&mailbox[17], 0) != (i ^ 0x5A5A5A5A))
+      atomic_add(&mailbox[32], 1);
+  }
+}
+
+__kernel __attribute__((reqd_work_group_size(1, 1, 1))) void
+kPingPongPeerResponder(__global int *mailbox, int round_trips) {
+  for (int i = 1; i <= round_trips; i++) {
+    while (atomic_add(&mailbox[0], 0) != i)
+      ;
+    atomic_xchg(&mailbox[17], atomic_add(&mailbox[1], 0));
+    atomic_xchg(&mailbox[16], i);
+  }
+}
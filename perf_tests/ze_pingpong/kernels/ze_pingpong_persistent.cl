@@ -0,0 +1,26 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+/*
+ * Launched once and left running: answers every request the host posts
+ * in mailbox[0] by counting it in mailbox[16], a cache line away, until
+ * the host posts a negative request.
+ */
+__kernel __attribute__((reqd_work_group_size(1, 1, 1))) void
+kPingPongPersistent(__global int *mailbox) {
+  int reply = 0;
+  for (;;) {
+    int request = atomic_add(&mailbox[0], 0);
+    if (request < 0)
+      break;
+    if (request != reply) {
+      reply++;
+      atomic_xchg(&mailbox[16], reply);
+    }
+  }
+}
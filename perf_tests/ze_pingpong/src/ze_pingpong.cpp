@@ -134,6 +134,94 @@ void L0Context::init() {
     throw std::runtime_error("zeMemAllocShared failed: " +
                              std::to_string(result));
   }
+
+  /* The synchronous queue above would block on every submission */
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  result = zeCommandQueueCreate(context, device, &command_queue_description,
+                                &async_command_queue);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueCreate failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListCreate(context, device, &command_list_description,
+                               &sync_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListCreate failed: " +
+                             std::to_string(result));
+  }
+
+  ze_event_pool_desc_t event_pool_desc = {};
+  event_pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+  event_pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+  event_pool_desc.count = 1;
+  result = zeEventPoolCreate(context, &event_pool_desc, 1, &device,
+                             &event_pool);
+  if (result) {
+    throw std::runtime_error("zeEventPoolCreate failed: " +
+                             std::to_string(result));
+  }
+
+  ze_event_desc_t event_desc = {};
+  event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+  event_desc.index = 0;
+  event_desc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+  event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+  result = zeEventCreate(event_pool, &event_desc, &event);
+  if (result) {
+    throw std::runtime_error("zeEventCreate failed: " +
+                             std::to_string(result));
+  }
+
+  ze_fence_desc_t fence_desc = {};
+  fence_desc.stype = ZE_STRUCTURE_TYPE_FENCE_DESC;
+  result = zeFenceCreate(async_command_queue, &fence_desc, &fence);
+  if (result) {
+    throw std::runtime_error("zeFenceCreate failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeMemAllocHost(context, &host_desc,
+                          (mailbox_reply_index + 1) * sizeof(int), 64,
+                          &mailbox);
+  if (result) {
+    throw std::runtime_error("zeMemAllocHost failed: " +
+                             std::to_string(result));
+  }
+
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
+  result = zeCommandListCreateImmediate(context, device,
+                                        &command_queue_description,
+                                        &immediate_sync_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListCreateImmediate failed: " +
+                             std::to_string(result));
+  }
+
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  result = zeCommandListCreateImmediate(context, device,
+                                        &command_queue_description,
+                                        &immediate_async_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListCreateImmediate failed: " +
+                             std::to_string(result));
+  }
+
+  for (int q = 0; q < queues_in_flight; q++) {
+    result = zeCommandQueueCreate(context, device, &command_queue_description,
+                                  &multi_command_queues[q]);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueCreate failed: " +
+                               std::to_string(result));
+    }
+
+    result = zeCommandListCreate(context, device, &command_list_description,
+                                 &multi_command_lists[q]);
+    if (result) {
+      throw std::runtime_error("zeCommandListCreate failed: " +
+                               std::to_string(result));
+    }
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -155,6 +243,67 @@ void L0Context::destroy() {
                              std::to_string(result));
   }
 
+  for (int q = 0; q < queues_in_flight; q++) {
+    result = zeCommandListDestroy(multi_command_lists[q]);
+    if (result) {
+      throw std::runtime_error("zeCommandListDestroy failed: " +
+                               std::to_string(result));
+    }
+
+    result = zeCommandQueueDestroy(multi_command_queues[q]);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueDestroy failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  result = zeCommandListDestroy(immediate_async_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListDestroy(immediate_sync_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeFenceDestroy(fence);
+  if (result) {
+    throw std::runtime_error("zeFenceDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeEventDestroy(event);
+  if (result) {
+    throw std::runtime_error("zeEventDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeEventPoolDestroy(event_pool);
+  if (result) {
+    throw std::runtime_error("zeEventPoolDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListDestroy(sync_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandQueueDestroy(async_command_queue);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeMemFree(context, mailbox);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+
   result = zeMemFree(context, device_input);
   if (result) {
     throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
@@ -199,41 +348,48 @@ void L0Context::print_ze_device_properties(
 }
 
 //---------------------------------------------------------------------
-// Utility function to load the binary spv file from a path
-// and return the file as a vector for use by L0.
+// Utility function to map the binary spv file from a path
+// for use by L0, without copying it.
 //---------------------------------------------------------------------
-std::vector<uint8_t> L0Context::load_binary_file(const std::string &file_path) {
-
-  std::ifstream stream(file_path, std::ios::in | std::ios::binary);
-
-  std::vector<uint8_t> binary_file;
-  if (!stream.good()) {
+level_zero_tests::BinaryFile
+L0Context::load_binary_file(const std::string &file_path) {
+  level_zero_tests::BinaryFile binary_file(file_path);
+  if (!binary_file.is_open()) {
     std::cerr << "Failed to load binary file: " << file_path << "\n";
-    return binary_file;
   }
-
-  size_t length = 0;
-  stream.seekg(0, stream.end);
-  length = static_cast<size_t>(stream.tellg());
-  stream.seekg(0, stream.beg);
-
-  binary_file.resize(length);
-  stream.read(reinterpret_cast<char *>(binary_file.data()), length);
-  stream.close();
-
   return binary_file;
 }
 
 //---------------------------------------------------------------------
 // Utility function to create the L0 module from a binary file.
 // If successful, this function will set the context's module
-// handle to a valid value for use in future calls.
+// handle to a valid value for use in future calls. The module is built
+// for the context's device unless another device is given.
 // On error, an exception will be thrown describing the failure.
 //---------------------------------------------------------------------
 void ZePingPong::create_module(L0Context &l0_context,
-                               std::vector<uint8_t> binary_file,
+                               const level_zero_tests::BinaryFile &binary_file,
                                ze_module_format_t format,
                                const char *build_flag) {
+  create_module(l0_context, binary_file, format, build_flag,
+                l0_context.module);
+}
+
+void ZePingPong::create_module(L0Context &l0_context,
+                               const level_zero_tests::BinaryFile &binary_file,
+                               ze_module_format_t format,
+                               const char *build_flag,
+                               ze_module_handle_t &module) {
+  create_module(l0_context, l0_context.device, binary_file, format,
+                build_flag, module);
+}
+
+void ZePingPong::create_module(L0Context &l0_context,
+                               ze_device_handle_t device,
+                               const level_zero_tests::BinaryFile &binary_file,
+                               ze_module_format_t format,
+                               const char *build_flag,
+                               ze_module_handle_t &module) {
   ze_result_t result = ZE_RESULT_SUCCESS;
   ze_module_desc_t module_description = {};
   module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
@@ -247,8 +403,8 @@ void ZePingPong::create_module(L0Context &l0_context,
       reinterpret_cast<const uint8_t *>(binary_file.data());
   module_description.pBuildFlags = build_flag;
 
-  result = zeModuleCreate(l0_context.context, l0_context.device,
-                          &module_description, &l0_context.module, nullptr);
+  result = zeModuleCreate(l0_context.context, device, &module_description,
+                          &module, nullptr);
   if (result) {
     throw std::runtime_error("zeModuleCreate failed: " +
                              std::to_string(result));
@@ -297,6 +453,19 @@ void ZePingPong::synchronize_command_queue(L0Context &context) {
   }
 }
 
+//---------------------------------------------------------------------
+// Utility function to synchronize the asynchronous command queue.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::synchronize_command_queue_async(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  result = zeCommandQueueSynchronize(context.async_command_queue, UINT64_MAX);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueSynchronize failed: " +
+                             std::to_string(result));
+  }
+}
+
 //---------------------------------------------------------------------
 // Utility function to reset the Command List.
 //---------------------------------------------------------------------
@@ -318,44 +487,49 @@ void ZePingPong::verify_result(int result) {
     std::cout << "FAILED (" << result << "!=" << validResult << ")!\n";
 }
 
-void ZePingPong::setup_commandlist(L0Context &context, enum TestType test) {
+//---------------------------------------------------------------------
+// Utility function to append the commands of one iteration of a test to
+// a regular or an immediate command list.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::append_commands(L0Context &context,
+                                 ze_command_list_handle_t list,
+                                 enum TestType test) {
 
   ze_result_t result = ZE_RESULT_SUCCESS;
 
   if (test == DEVICE_MEM_XFER) {
-    result = zeCommandListAppendMemoryCopy(
-        context.command_list, context.device_input, context.host_output,
-        sizeof(int), nullptr, 0, nullptr);
+    result = zeCommandListAppendMemoryCopy(list, context.device_input,
+                                           context.host_output, sizeof(int),
+                                           nullptr, 0, nullptr);
     if (result) {
       throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
                                std::to_string(result));
     }
 
-    result =
-        zeCommandListAppendBarrier(context.command_list, nullptr, 0, nullptr);
+    result = zeCommandListAppendBarrier(list, nullptr, 0, nullptr);
     if (result) {
       throw std::runtime_error("zeCommandListAppendBarrier failed: " +
                                std::to_string(result));
     }
 
-    result = zeCommandListAppendLaunchKernel(
-        context.command_list, context.function,
-        &context.thread_group_dimensions, nullptr, 0, nullptr);
+    result = zeCommandListAppendLaunchKernel(list, context.function,
+                                             &context.thread_group_dimensions,
+                                             nullptr, 0, nullptr);
     if (result) {
       throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
                                std::to_string(result));
     }
 
-    result =
-        zeCommandListAppendBarrier(context.command_list, nullptr, 0, nullptr);
+    result = zeCommandListAppendBarrier(list, nullptr, 0, nullptr);
     if (result) {
       throw std::runtime_error("zeCommandListAppendBarrier failed: " +
                                std::to_string(result));
     }
 
-    result = zeCommandListAppendMemoryCopy(
-        context.command_list, context.host_output, context.device_input,
-        sizeof(int), nullptr, 0, nullptr);
+    result = zeCommandListAppendMemoryCopy(list, context.host_output,
+                                           context.device_input, sizeof(int),
+                                           nullptr, 0, nullptr);
     if (result) {
       throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
                                std::to_string(result));
@@ -365,18 +539,25 @@ void ZePingPong::setup_commandlist(L0Context &context, enum TestType test) {
 
     if (test == SHARED_MEM_MAP) {
         zeCommandListAppendMemAdvise(
-            context.command_list, context.device, context.shared_output,
-            sizeof(int), ZE_MEMORY_ADVICE_SET_SYSTEM_MEMORY_PREFERRED_LOCATION);
+            list, context.device, context.shared_output, sizeof(int),
+            ZE_MEMORY_ADVICE_SET_SYSTEM_MEMORY_PREFERRED_LOCATION);
     }
 
-    result = zeCommandListAppendLaunchKernel(
-        context.command_list, context.function,
-        &context.thread_group_dimensions, nullptr, 0, nullptr);
+    result = zeCommandListAppendLaunchKernel(list, context.function,
+                                             &context.thread_group_dimensions,
+                                             nullptr, 0, nullptr);
     if (result) {
       throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
                                std::to_string(result));
     }
   }
+}
+
+void ZePingPong::setup_commandlist(L0Context &context, enum TestType test) {
+
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  append_commands(context, context.command_list, test);
 
   result = zeCommandListClose(context.command_list);
   if (result) {
@@ -385,6 +566,77 @@ void ZePingPong::setup_commandlist(L0Context &context, enum TestType test) {
   }
 }
 
+//---------------------------------------------------------------------
+// Utility function to submit the commands of one iteration the way
+// submit_mode asks for. On return, the commands completed, except with
+// SUBMIT_MULTI_QUEUE where up to queues_in_flight submissions are left
+// running; synchronize_multi_queues() waits for them.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::submit_commands(L0Context &context, enum TestType test,
+                                 int iteration) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  const int q = iteration % queues_in_flight;
+
+  switch (submit_mode) {
+  case SUBMIT_REGULAR_REUSE:
+    run_command_queue(context);
+    break;
+  case SUBMIT_REGULAR_RERECORD:
+    reset_commandlist(context);
+    setup_commandlist(context, test);
+    run_command_queue(context);
+    break;
+  case SUBMIT_IMMEDIATE_SYNC:
+    append_commands(context, context.immediate_sync_command_list, test);
+    break;
+  case SUBMIT_IMMEDIATE_ASYNC:
+    append_commands(context, context.immediate_async_command_list, test);
+    result = zeCommandListHostSynchronize(context.immediate_async_command_list,
+                                          UINT64_MAX);
+    if (result) {
+      throw std::runtime_error("zeCommandListHostSynchronize failed: " +
+                               std::to_string(result));
+    }
+    break;
+  case SUBMIT_MULTI_QUEUE:
+    if (iteration >= queues_in_flight) {
+      result = zeCommandQueueSynchronize(context.multi_command_queues[q],
+                                         UINT64_MAX);
+      if (result) {
+        throw std::runtime_error("zeCommandQueueSynchronize failed: " +
+                                 std::to_string(result));
+      }
+    }
+    result = zeCommandQueueExecuteCommandLists(
+        context.multi_command_queues[q], 1, &context.multi_command_lists[q],
+        nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueExecuteCommandLists failed: " +
+                               std::to_string(result));
+    }
+    break;
+  }
+}
+
+//---------------------------------------------------------------------
+// Utility function to wait for the submissions left running on the
+// queues of SUBMIT_MULTI_QUEUE.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::synchronize_multi_queues(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  for (int q = 0; q < queues_in_flight; q++) {
+    result =
+        zeCommandQueueSynchronize(context.multi_command_queues[q], UINT64_MAX);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueSynchronize failed: " +
+                               std::to_string(result));
+    }
+  }
+}
+
 double ZePingPong::measure_benchmark(L0Context &context, enum TestType test) {
 
   int *ping = static_cast<int *>(context.device_input);
@@ -398,15 +650,18 @@ double ZePingPong::measure_benchmark(L0Context &context, enum TestType test) {
       (test == SHARED_MEM_KERNEL_ONLY)) {
     clk_begin = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < num_execute; i++) {
-      run_command_queue(context);
+      submit_commands(context, test, i);
       // next line not needed for ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
       // synchronize_command_queue(context);
     }
+    if (submit_mode == SUBMIT_MULTI_QUEUE) {
+      synchronize_multi_queues(context);
+    }
     clk_end = std::chrono::high_resolution_clock::now();
   } else if ((test == DEVICE_MEM_XFER) || (test == HOST_MEM_NO_XFER)) {
     clk_begin = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < num_execute; i++) {
-      run_command_queue(context);
+      submit_commands(context, test, i);
       // next line not needed for ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
       // synchronize_command_queue(context);
       pong[0]--;
@@ -417,7 +672,7 @@ double ZePingPong::measure_benchmark(L0Context &context, enum TestType test) {
     clk_begin = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < num_execute; i++) {
       ping_shared[0] = pong[0];
-      run_command_queue(context);
+      submit_commands(context, test, i);
       // next line not needed for ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
       // synchronize_command_queue(context);
       pong[0] = ping_shared[0];
@@ -435,73 +690,1048 @@ double ZePingPong::measure_benchmark(L0Context &context, enum TestType test) {
   return elapsed_time;
 }
 
-void ZePingPong::run_test(L0Context &context) {
-
+//---------------------------------------------------------------------
+// Utility function to record the ping-pong kernel into the list of the
+// synchronization experiments, signaling the event for the mechanisms
+// waiting on it. With SYNC_DEVICE_POLLING the list launches the
+// persistent kernel instead, once for all round trips.
+//---------------------------------------------------------------------
+void ZePingPong::setup_sync_commandlist(L0Context &context,
+                                        enum SyncMechanism mechanism) {
   ze_result_t result = ZE_RESULT_SUCCESS;
 
-  std::vector<uint8_t> binary_file =
-      context.load_binary_file("ze_pingpong.spv");
+  result = zeCommandListReset(context.sync_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListReset failed: " +
+                             std::to_string(result));
+  }
 
-  create_module(context, binary_file, ZE_MODULE_FORMAT_IL_SPIRV, nullptr);
+  ze_kernel_handle_t function = (mechanism == SYNC_DEVICE_POLLING)
+                                    ? context.persistent_function
+                                    : context.function;
+  ze_event_handle_t signal_event =
+      (mechanism == SYNC_EVENT_HOST || mechanism == SYNC_EVENT_QUERY)
+          ? context.event
+          : nullptr;
+  result = zeCommandListAppendLaunchKernel(
+      context.sync_command_list, function, &context.thread_group_dimensions,
+      signal_event, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                             std::to_string(result));
+  }
 
-  ze_kernel_desc_t function_description = {};
-  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  result = zeCommandListClose(context.sync_command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListClose failed: " +
+                             std::to_string(result));
+  }
+}
 
-  int *ping = static_cast<int *>(context.device_input);
+//---------------------------------------------------------------------
+// Utility function to time every round trip on its own: submission of
+// the ping-pong kernel on host memory, wait for its completion with the
+// given mechanism and decrement on the host. Round trips are stored in
+// usec, after num_execute / 10 warm-up round trips.
+//---------------------------------------------------------------------
+void ZePingPong::measure_round_trips(L0Context &context,
+                                     enum SyncMechanism mechanism,
+                                     std::vector<double> &round_trips) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
   int *pong = static_cast<int *>(context.host_output);
-  int *ping_shared = static_cast<int *>(context.shared_output);
+  ze_fence_handle_t fence =
+      (mechanism == SYNC_FENCE) ? context.fence : nullptr;
+  const int warm_up = num_execute / 10;
 
-  function_description.pNext = nullptr;
-  function_description.flags = 0;
-  function_description.pKernelName = "kPingPong";
+  round_trips.clear();
+  pong[0] = 0;
+  for (int i = 0; i < warm_up + num_execute; i++) {
+    auto clk_begin = std::chrono::high_resolution_clock::now();
+    result = zeCommandQueueExecuteCommandLists(
+        context.async_command_queue, 1, &context.sync_command_list, fence);
+    if (result) {
+      throw std::runtime_error("zeCommandQueueExecuteCommandLists failed: " +
+                               std::to_string(result));
+    }
 
-  result =
-      zeKernelCreate(context.module, &function_description, &context.function);
+    switch (mechanism) {
+    case SYNC_EVENT_HOST:
+      result = zeEventHostSynchronize(context.event, UINT64_MAX);
+      break;
+    case SYNC_EVENT_QUERY:
+      do {
+        result = zeEventQueryStatus(context.event);
+      } while (result == ZE_RESULT_NOT_READY);
+      break;
+    case SYNC_FENCE:
+      result = zeFenceHostSynchronize(context.fence, UINT64_MAX);
+      break;
+    default:
+      result = zeCommandQueueSynchronize(context.async_command_queue,
+                                         UINT64_MAX);
+      break;
+    }
+    if (result) {
+      throw std::runtime_error("Round trip synchronization failed: " +
+                               std::to_string(result));
+    }
+    pong[0]--;
+    auto clk_end = std::chrono::high_resolution_clock::now();
+
+    if (i >= warm_up) {
+      round_trips.push_back(
+          std::chrono::duration<double, std::micro>(clk_end - clk_begin)
+              .count());
+    }
+
+    /* Re-arming is not part of the round trip */
+    if (mechanism == SYNC_EVENT_HOST || mechanism == SYNC_EVENT_QUERY) {
+      result = zeEventHostReset(context.event);
+    } else if (mechanism == SYNC_FENCE) {
+      result = zeFenceReset(context.fence);
+    }
+    if (result) {
+      throw std::runtime_error("Round trip reset failed: " +
+                               std::to_string(result));
+    }
+  }
+  synchronize_command_queue_async(context);
+  verify_result(pong[0]);
+}
+
+//---------------------------------------------------------------------
+// Utility function to create the persistent kernel, and to destroy it.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::create_persistent_kernel(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  level_zero_tests::BinaryFile binary_file =
+      context.load_binary_file("ze_pingpong_persistent.spv");
+  create_module(context, binary_file, ZE_MODULE_FORMAT_IL_SPIRV, nullptr,
+                context.persistent_module);
+
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+  function_description.pKernelName = "kPingPongPersistent";
+  result = zeKernelCreate(context.persistent_module, &function_description,
+                          &context.persistent_function);
   if (result) {
     throw std::runtime_error("zeKernelCreate failed: " +
                              std::to_string(result));
   }
 
-  result = zeKernelSetGroupSize(context.function, 1, 1, 1);
+  result = zeKernelSetGroupSize(context.persistent_function, 1, 1, 1);
   if (result) {
     throw std::runtime_error("zeKernelSetGroupSize failed: " +
                              std::to_string(result));
   }
+}
 
-  std::cout << "\n"
-            << "KERNEL EXECUTION ONLY EXPERIMENTS\n\n";
-  set_argument_value(context, 0, sizeof(ping), &ping);
-  setup_commandlist(context, DEVICE_MEM_KERNEL_ONLY);
+void ZePingPong::destroy_persistent_kernel(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
 
-  // Warm-up
-  for (int i = 0; i < num_execute / 2; i++) {
-    run_command_queue(context);
-    // next line not needed for ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
-    // synchronize_command_queue(context);
+  result = zeKernelDestroy(context.persistent_function);
+  if (result) {
+    throw std::runtime_error("zeKernelDestroy failed: " +
+                             std::to_string(result));
   }
-  reset_commandlist(context);
-  set_argument_value(context, 0, sizeof(ping), &ping);
-  setup_commandlist(context, DEVICE_MEM_KERNEL_ONLY);
-
-  auto elapsed_time = measure_benchmark(context, DEVICE_MEM_KERNEL_ONLY);
-  const auto loop_time_kernel_dev = elapsed_time / num_execute * 1000.;
-  std::cout << "Device allocated memory w.sync:   " << std::fixed
-            << std::setprecision(2) << loop_time_kernel_dev << " usec/loop ";
-  std::cout << "(" << std::fixed << std::setprecision(2) << elapsed_time
-            << " msec total)\n";
-  reset_commandlist(context);
 
-  set_argument_value(context, 0, sizeof(pong), &pong);
-  setup_commandlist(context, HOST_MEM_KERNEL_ONLY);
-  elapsed_time = measure_benchmark(context, HOST_MEM_KERNEL_ONLY);
-  const auto loop_time_kernel_host = elapsed_time / num_execute * 1000.;
-  std::cout << "Host allocated memory w.sync  :   " << std::fixed
-            << std::setprecision(2) << loop_time_kernel_host << " usec/loop ";
-  std::cout << "(" << std::fixed << std::setprecision(2) << elapsed_time
-            << " msec total)\n";
-  reset_commandlist(context);
+  result = zeModuleDestroy(context.persistent_module);
+  if (result) {
+    throw std::runtime_error("zeModuleDestroy failed: " +
+                             std::to_string(result));
+  }
+}
 
-  set_argument_value(context, 0, sizeof(ping_shared), &ping_shared);
+//---------------------------------------------------------------------
+// Utility function to launch the persistent kernel on a mailbox, and to
+// stop it. The kernel answers requests until a negative one is posted.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::start_persistent_kernel(L0Context &context,
+                                         void *mailbox_buffer) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  volatile int *mailbox = static_cast<volatile int *>(mailbox_buffer);
+
+  mailbox[0] = 0;
+  mailbox[mailbox_reply_index] = 0;
+
+  result = zeKernelSetArgumentValue(context.persistent_function, 0,
+                                    sizeof(mailbox_buffer), &mailbox_buffer);
+  if (result) {
+    throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                             std::to_string(result));
+  }
+
+  setup_sync_commandlist(context, SYNC_DEVICE_POLLING);
+  result = zeCommandQueueExecuteCommandLists(
+      context.async_command_queue, 1, &context.sync_command_list, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueExecuteCommandLists failed: " +
+                             std::to_string(result));
+  }
+}
+
+void ZePingPong::stop_persistent_kernel(L0Context &context,
+                                        void *mailbox_buffer) {
+  volatile int *mailbox = static_cast<volatile int *>(mailbox_buffer);
+
+  mailbox[0] = -1;
+  synchronize_command_queue_async(context);
+}
+
+//---------------------------------------------------------------------
+// Utility function to time round trips through the mailbox of the
+// persistent kernel: the host posts request i and spins until the kernel
+// has answered it, with no submission or driver call in between.
+// On a reply not coming within 10 seconds, an exception will be thrown.
+//---------------------------------------------------------------------
+void ZePingPong::measure_persistent_round_trips(
+    L0Context &context, void *mailbox_buffer,
+    std::vector<double> &round_trips) {
+  volatile int *mailbox = static_cast<volatile int *>(mailbox_buffer);
+  const int warm_up = num_execute / 10;
+  const auto timeout = std::chrono::seconds(10);
+
+  round_trips.clear();
+  start_persistent_kernel(context, mailbox_buffer);
+
+  for (int i = 1; i <= warm_up + num_execute; i++) {
+    auto clk_begin = std::chrono::high_resolution_clock::now();
+    mailbox[0] = i;
+    while (mailbox[mailbox_reply_index] != i) {
+      if (std::chrono::high_resolution_clock::now() - clk_begin > timeout) {
+        mailbox[0] = -1;
+        throw std::runtime_error("Persistent kernel did not answer request " +
+                                 std::to_string(i));
+      }
+    }
+    auto clk_end = std::chrono::high_resolution_clock::now();
+
+    if (i > warm_up) {
+      round_trips.push_back(
+          std::chrono::duration<double, std::micro>(clk_end - clk_begin)
+              .count());
+    }
+  }
+
+  stop_persistent_kernel(context, mailbox_buffer);
+  verify_result(mailbox[mailbox_reply_index] - warm_up - num_execute);
+}
+
+//---------------------------------------------------------------------
+// Utility function to measure the message rate of the persistent kernel
+// with up to window requests posted ahead of the replies. The host rings
+// the doorbell by raising the request counter, and the kernel answers the
+// requests in order. Returns messages per second.
+// On the kernel stalling for 10 seconds, an exception will be thrown.
+//---------------------------------------------------------------------
+double ZePingPong::measure_doorbell_rate(L0Context &context,
+                                         void *mailbox_buffer, int window) {
+  volatile int *mailbox = static_cast<volatile int *>(mailbox_buffer);
+  const auto timeout = std::chrono::seconds(10);
+  const int messages = num_execute * 10;
+  int reply = 0;
+
+  start_persistent_kernel(context, mailbox_buffer);
+
+  auto clk_begin = std::chrono::high_resolution_clock::now();
+  auto clk_progress = clk_begin;
+  for (int posted = 0; reply < messages;) {
+    if (posted < messages && posted - reply < window) {
+      posted++;
+      mailbox[0] = posted;
+    }
+    const int seen = mailbox[mailbox_reply_index];
+    const auto clk_now = std::chrono::high_resolution_clock::now();
+    if (seen != reply) {
+      reply = seen;
+      clk_progress = clk_now;
+    } else if (clk_now - clk_progress > timeout) {
+      mailbox[0] = -1;
+      throw std::runtime_error("Persistent kernel stalled at message " +
+                               std::to_string(reply));
+    }
+  }
+  auto clk_end = std::chrono::high_resolution_clock::now();
+
+  stop_persistent_kernel(context, mailbox_buffer);
+  verify_result(mailbox[mailbox_reply_index] - messages);
+
+  return messages / std::chrono::duration<double>(clk_end - clk_begin).count();
+}
+
+//---------------------------------------------------------------------
+// Utility function to print the distribution of round trips in usec.
+//---------------------------------------------------------------------
+void ZePingPong::print_latency_distribution(const std::string &name,
+                                            std::vector<double> &round_trips) {
+  std::sort(round_trips.begin(), round_trips.end());
+  const double mean =
+      std::accumulate(round_trips.begin(), round_trips.end(), 0.0) /
+      round_trips.size();
+
+  std::cout << std::left << std::setw(28) << name << ": " << std::right
+            << std::fixed << std::setprecision(2) << "mean " << mean
+            << "  min " << round_trips.front() << "  median "
+            << round_trips[round_trips.size() / 2] << "  p99 "
+            << round_trips[round_trips.size() * 99 / 100] << "  max "
+            << round_trips.back() << " usec\n";
+}
+
+//---------------------------------------------------------------------
+// Round trips completed through each synchronization mechanism, on the
+// ping-pong kernel with its integer in host memory. The persistent
+// kernel is the floor: it is launched once and polls a host memory
+// mailbox on the device.
+//---------------------------------------------------------------------
+void ZePingPong::run_sync_test(L0Context &context) {
+  std::vector<double> round_trips;
+  int *pong = static_cast<int *>(context.host_output);
+
+  std::cout << "\n"
+            << "SYNCHRONIZATION EXPERIMENTS: ROUND-TRIP LATENCY "
+               "DISTRIBUTION\n\n";
+
+  set_argument_value(context, 0, sizeof(pong), &pong);
+
+  const std::pair<enum SyncMechanism, const char *> mechanisms[] = {
+      {SYNC_COMMAND_QUEUE, "zeCommandQueueSynchronize"},
+      {SYNC_EVENT_HOST, "zeEventHostSynchronize"},
+      {SYNC_EVENT_QUERY, "zeEventQueryStatus polling"},
+      {SYNC_FENCE, "zeFenceHostSynchronize"}};
+  for (auto &mechanism : mechanisms) {
+    setup_sync_commandlist(context, mechanism.first);
+    measure_round_trips(context, mechanism.first, round_trips);
+    print_latency_distribution(mechanism.second, round_trips);
+  }
+
+  create_persistent_kernel(context);
+  measure_persistent_round_trips(context, context.mailbox, round_trips);
+  print_latency_distribution("Persistent kernel polling", round_trips);
+  destroy_persistent_kernel(context);
+}
+
+//---------------------------------------------------------------------
+// Doorbell mode: one persistent kernel answers requests posted in a host
+// or shared memory mailbox, with no kernel relaunch. Reports the round
+// trip latency distribution and the message rate with more requests in
+// flight.
+//---------------------------------------------------------------------
+void ZePingPong::run_doorbell_test(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  std::vector<double> round_trips;
+  void *shared_mailbox = nullptr;
+
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  ze_host_mem_alloc_desc_t host_desc = {};
+  host_desc.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
+  result = zeMemAllocShared(context.context, &device_desc, &host_desc,
+                            (mailbox_reply_index + 1) * sizeof(int), 64,
+                            context.device, &shared_mailbox);
+  if (result) {
+    throw std::runtime_error("zeMemAllocShared failed: " +
+                             std::to_string(result));
+  }
+
+  create_persistent_kernel(context);
+
+  std::cout << "\n"
+            << "PERSISTENT KERNEL DOORBELL EXPERIMENTS\n\n";
+
+  const std::pair<void *, const char *> mailboxes[] = {
+      {context.mailbox, "Host memory mailbox"},
+      {shared_mailbox, "Shared memory mailbox"}};
+  const int windows[] = {1, 4, 16, 64};
+  for (auto &mailbox : mailboxes) {
+    std::cout << mailbox.second << "\n";
+    measure_persistent_round_trips(context, mailbox.first, round_trips);
+    print_latency_distribution("  Round trip", round_trips);
+    for (auto window : windows) {
+      auto rate = measure_doorbell_rate(context, mailbox.first, window);
+      std::cout << "  Message rate, " << std::setw(2) << window
+                << " in flight    : " << std::fixed << std::setprecision(0)
+                << rate << " messages/sec\n";
+    }
+    std::cout << "\n";
+  }
+
+  destroy_persistent_kernel(context);
+
+  result = zeMemFree(context.context, shared_mailbox);
+  if (result) {
+    throw std::runtime_error("zeMemFree failed: " + std::to_string(result));
+  }
+}
+
+//---------------------------------------------------------------------
+// Command submission experiments: the ping-pong tests through regular
+// lists recorded once or once per iteration, through synchronous and
+// asynchronous immediate lists, and with queues_in_flight queues kept
+// busy, all timed by measure_benchmark.
+//---------------------------------------------------------------------
+void ZePingPong::run_submission_test(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  int *ping = static_cast<int *>(context.device_input);
+  int *pong = static_cast<int *>(context.host_output);
+
+  std::cout << "\n"
+            << "COMMAND SUBMISSION EXPERIMENTS\n\n";
+
+  const std::pair<enum SubmitMode, const char *> modes[] = {
+      {SUBMIT_REGULAR_REUSE, "Regular list, reused"},
+      {SUBMIT_REGULAR_RERECORD, "Regular list, re-recorded"},
+      {SUBMIT_IMMEDIATE_SYNC, "Immediate list, synchronous"},
+      {SUBMIT_IMMEDIATE_ASYNC, "Immediate list, asynchronous"},
+      {SUBMIT_MULTI_QUEUE, "Regular lists, queues in flight"}};
+  const std::pair<enum TestType, const char *> tests[] = {
+      {HOST_MEM_KERNEL_ONLY, "HOST_MEM_KERNEL_ONLY"},
+      {DEVICE_MEM_XFER, "DEVICE_MEM_XFER"},
+      {HOST_MEM_NO_XFER, "HOST_MEM_NO_XFER"}};
+
+  for (auto &mode : modes) {
+    std::cout << mode.second << "\n";
+    submit_mode = mode.first;
+    for (auto &test : tests) {
+      /* Round trips wait on the host, they cannot overlap */
+      if (submit_mode == SUBMIT_MULTI_QUEUE &&
+          test.first != HOST_MEM_KERNEL_ONLY) {
+        continue;
+      }
+
+      if (test.first == DEVICE_MEM_XFER) {
+        set_argument_value(context, 0, sizeof(ping), &ping);
+      } else {
+        set_argument_value(context, 0, sizeof(pong), &pong);
+      }
+
+      if (submit_mode == SUBMIT_REGULAR_REUSE) {
+        setup_commandlist(context, test.first);
+      } else if (submit_mode == SUBMIT_MULTI_QUEUE) {
+        for (int q = 0; q < queues_in_flight; q++) {
+          result = zeCommandListReset(context.multi_command_lists[q]);
+          if (result) {
+            throw std::runtime_error("zeCommandListReset failed: " +
+                                     std::to_string(result));
+          }
+          append_commands(context, context.multi_command_lists[q],
+                          test.first);
+          result = zeCommandListClose(context.multi_command_lists[q]);
+          if (result) {
+            throw std::runtime_error("zeCommandListClose failed: " +
+                                     std::to_string(result));
+          }
+        }
+      }
+
+      std::cout << "  " << std::left << std::setw(22) << test.second
+                << std::right << ": ";
+      const auto elapsed_time = measure_benchmark(context, test.first);
+      std::cout << std::fixed << std::setprecision(2)
+                << elapsed_time / num_execute * 1000. << " usec/loop\n";
+
+      if (submit_mode == SUBMIT_REGULAR_REUSE ||
+          submit_mode == SUBMIT_REGULAR_RERECORD) {
+        reset_commandlist(context);
+      }
+    }
+  }
+  submit_mode = SUBMIT_REGULAR_REUSE;
+}
+
+//---------------------------------------------------------------------
+// Utility function to set up one device of the device to device
+// experiments: the ping-pong kernel, the named kernel of the peer
+// module, and an asynchronous queue and list on the device.
+// On error, an exception will be thrown describing the failure.
+//---------------------------------------------------------------------
+void ZePingPong::create_peer_side(L0Context &context,
+                                  ze_device_handle_t device,
+                                  const char *persistent_name,
+                                  PeerSide &side) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  side.device = device;
+  result = zeDeviceGetProperties(device, &side.device_property);
+  if (result) {
+    throw std::runtime_error("zeDeviceGetProperties failed: " +
+                             std::to_string(result));
+  }
+
+  const std::pair<const char *, const char *> kernels[] = {
+      {"ze_pingpong.spv", "kPingPong"},
+      {"ze_pingpong_peer.spv", persistent_name}};
+  ze_module_handle_t *modules[] = {&side.module, &side.persistent_module};
+  ze_kernel_handle_t *functions[] = {&side.function,
+                                     &side.persistent_function};
+  for (int k = 0; k < 2; k++) {
+    level_zero_tests::BinaryFile binary_file =
+        context.load_binary_file(kernels[k].first);
+    create_module(context, device, binary_file, ZE_MODULE_FORMAT_IL_SPIRV,
+                  nullptr, *modules[k]);
+
+    ze_kernel_desc_t function_description = {};
+    function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+    function_description.pKernelName = kernels[k].second;
+    result =
+        zeKernelCreate(*modules[k], &function_description, functions[k]);
+    if (result) {
+      throw std::runtime_error("zeKernelCreate failed: " +
+                               std::to_string(result));
+    }
+
+    result = zeKernelSetGroupSize(*functions[k], 1, 1, 1);
+    if (result) {
+      throw std::runtime_error("zeKernelSetGroupSize failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  ze_command_queue_desc_t command_queue_description = {};
+  command_queue_description.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
+  command_queue_description.ordinal = context.command_queue_id;
+  command_queue_description.priority = ZE_COMMAND_QUEUE_PRIORITY_NORMAL;
+  command_queue_description.mode = ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS;
+  result = zeCommandQueueCreate(context.context, device,
+                                &command_queue_description,
+                                &side.command_queue);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueCreate failed: " +
+                             std::to_string(result));
+  }
+
+  ze_command_list_desc_t command_list_description = {};
+  command_list_description.stype = ZE_STRUCTURE_TYPE_COMMAND_LIST_DESC;
+  command_list_description.commandQueueGroupOrdinal = context.command_queue_id;
+  result = zeCommandListCreate(context.context, device,
+                               &command_list_description, &side.command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListCreate failed: " +
+                             std::to_string(result));
+  }
+}
+
+void ZePingPong::destroy_peer_side(PeerSide &side) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  result = zeCommandListDestroy(side.command_list);
+  if (result) {
+    throw std::runtime_error("zeCommandListDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandQueueDestroy(side.command_queue);
+  if (result) {
+    throw std::runtime_error("zeCommandQueueDestroy failed: " +
+                             std::to_string(result));
+  }
+
+  for (auto function : {side.function, side.persistent_function}) {
+    result = zeKernelDestroy(function);
+    if (result) {
+      throw std::runtime_error("zeKernelDestroy failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  for (auto module : {side.module, side.persistent_module}) {
+    result = zeModuleDestroy(module);
+    if (result) {
+      throw std::runtime_error("zeModuleDestroy failed: " +
+                               std::to_string(result));
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Utility function to wait for the lists submitted to both devices. A
+// side left waiting for the other one hangs the device, so the wait
+// gives up after 10 seconds with an exception.
+//---------------------------------------------------------------------
+void ZePingPong::synchronize_peer_sides(PeerSide *sides) {
+  const uint64_t timeout_nsec = 10000000000ULL;
+
+  for (int s = 0; s < 2; s++) {
+    ze_result_t result =
+        zeCommandQueueSynchronize(sides[s].command_queue, timeout_nsec);
+    if (result) {
+      throw std::runtime_error("Device to device ping-pong did not "
+                               "complete: " +
+                               std::to_string(result));
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Utility function to convert the span between two kernel timestamps of
+// a device to nanoseconds, across one wrap of the counter.
+//---------------------------------------------------------------------
+double ZePingPong::peer_timestamp_nsec(const PeerSide &side, uint64_t begin,
+                                       uint64_t end) {
+  const uint64_t timestamp_max_value =
+      ~(-1L << side.device_property.kernelTimestampValidBits);
+
+  return ((end - begin) & timestamp_max_value) *
+         static_cast<double>(side.device_property.timerResolution);
+}
+
+//---------------------------------------------------------------------
+// Utility function to time device to device round trips made by kernel
+// relaunches: the ping-pong kernel on the first device increments a
+// counter in its memory, the one on the second device, launched on the
+// event of the first, increments it over P2P, and so on for
+// peer_relaunch_round_trips round trips with no host involvement. The
+// round trip is the span between the starts of the first and the last
+// kernel of the first device, over the round trips, in usec.
+//---------------------------------------------------------------------
+void ZePingPong::measure_peer_relaunch_round_trips(
+    L0Context &context, PeerSide *sides,
+    const std::vector<ze_event_handle_t> &events, void *counter,
+    std::vector<double> &round_trips) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  const int n = peer_relaunch_round_trips;
+  const int zero = 0;
+  int *pong = static_cast<int *>(context.host_output);
+
+  for (int s = 0; s < 2; s++) {
+    result = zeKernelSetArgumentValue(sides[s].function, 0, sizeof(counter),
+                                      &counter);
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    result = zeCommandListReset(sides[s].command_list);
+    if (result) {
+      throw std::runtime_error("zeCommandListReset failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  /* Events 2k and 2k+1 end launch k of the first and second device */
+  result = zeCommandListAppendMemoryFill(sides[0].command_list, counter,
+                                         &zero, sizeof(zero), sizeof(zero),
+                                         nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendBarrier(sides[0].command_list, nullptr, 0,
+                                      nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                             std::to_string(result));
+  }
+  for (int k = 0; k <= n; k++) {
+    ze_event_handle_t wait_event = k ? events[2 * k - 1] : nullptr;
+    result = zeCommandListAppendLaunchKernel(
+        sides[0].command_list, sides[0].function,
+        &context.thread_group_dimensions, events[2 * k], k ? 1 : 0,
+        k ? &wait_event : nullptr);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                               std::to_string(result));
+    }
+    if (k == n) {
+      break;
+    }
+    wait_event = events[2 * k];
+    result = zeCommandListAppendLaunchKernel(
+        sides[1].command_list, sides[1].function,
+        &context.thread_group_dimensions, events[2 * k + 1], 1, &wait_event);
+    if (result) {
+      throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                               std::to_string(result));
+    }
+  }
+  result = zeCommandListAppendBarrier(sides[0].command_list, nullptr, 0,
+                                      nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendMemoryCopy(sides[0].command_list, pong,
+                                         counter, sizeof(int), nullptr, 0,
+                                         nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                             std::to_string(result));
+  }
+  for (int s = 0; s < 2; s++) {
+    result = zeCommandListClose(sides[s].command_list);
+    if (result) {
+      throw std::runtime_error("zeCommandListClose failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  round_trips.clear();
+  int errors = 0;
+  /* One extra measurement, the first, left out as warm-up */
+  for (int i = 0; i <= 10; i++) {
+    for (auto event : events) {
+      result = zeEventHostReset(event);
+      if (result) {
+        throw std::runtime_error("zeEventHostReset failed: " +
+                                 std::to_string(result));
+      }
+    }
+    /* The second device first, as it only waits for the first */
+    for (int s = 1; s >= 0; s--) {
+      result = zeCommandQueueExecuteCommandLists(
+          sides[s].command_queue, 1, &sides[s].command_list, nullptr);
+      if (result) {
+        throw std::runtime_error(
+            "zeCommandQueueExecuteCommandLists failed: " +
+            std::to_string(result));
+      }
+    }
+    synchronize_peer_sides(sides);
+
+    ze_kernel_timestamp_result_t first = {}, last = {};
+    result = zeEventQueryKernelTimestamp(events[0], &first);
+    if (result == ZE_RESULT_SUCCESS) {
+      result = zeEventQueryKernelTimestamp(events[2 * n], &last);
+    }
+    if (result) {
+      throw std::runtime_error("zeEventQueryKernelTimestamp failed: " +
+                               std::to_string(result));
+    }
+    errors += (pong[0] != 2 * n + 1);
+    if (i > 0) {
+      round_trips.push_back(peer_timestamp_nsec(sides[0],
+                                                first.global.kernelStart,
+                                                last.global.kernelStart) /
+                            n / 1000.);
+    }
+  }
+  verify_result(errors);
+}
+
+//---------------------------------------------------------------------
+// Utility function to time device to device round trips between two
+// kernels spinning on a mailbox in the memory of the first device, each
+// launched once on its device: the initiator posts num_execute round
+// trips that the responder echoes over P2P, and counts the payloads
+// echoed wrong. The responder signals that it is about to launch before
+// the initiator starts. The round trip is the initiator run time over
+// the round trips, in usec.
+//---------------------------------------------------------------------
+void ZePingPong::measure_peer_persistent_round_trips(
+    L0Context &context, PeerSide *sides,
+    const std::vector<ze_event_handle_t> &events, void *mailbox,
+    std::vector<double> &round_trips) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  const int zero = 0;
+  int *pong = static_cast<int *>(context.host_output);
+  int *mailbox_errors =
+      static_cast<int *>(mailbox) + peer_mailbox_errors_index;
+
+  for (int s = 0; s < 2; s++) {
+    result = zeKernelSetArgumentValue(sides[s].persistent_function, 0,
+                                      sizeof(mailbox), &mailbox);
+    if (result == ZE_RESULT_SUCCESS) {
+      result = zeKernelSetArgumentValue(sides[s].persistent_function, 1,
+                                        sizeof(num_execute), &num_execute);
+    }
+    if (result) {
+      throw std::runtime_error("zeKernelSetArgumentValue failed: " +
+                               std::to_string(result));
+    }
+    result = zeCommandListReset(sides[s].command_list);
+    if (result) {
+      throw std::runtime_error("zeCommandListReset failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  /* Event 0: mailbox cleared, 1: responder launching, 2: initiator */
+  ze_event_handle_t cleared = events[0], launching = events[1];
+  result = zeCommandListAppendMemoryFill(
+      sides[0].command_list, mailbox, &zero, sizeof(zero),
+      (peer_mailbox_errors_index + 1) * sizeof(int), nullptr, 0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryFill failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendBarrier(sides[0].command_list, cleared, 0,
+                                      nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendLaunchKernel(
+      sides[0].command_list, sides[0].persistent_function,
+      &context.thread_group_dimensions, events[2], 1, &launching);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendBarrier(sides[0].command_list, nullptr, 0,
+                                      nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendBarrier failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendMemoryCopy(sides[0].command_list, pong,
+                                         mailbox_errors, sizeof(int), nullptr,
+                                         0, nullptr);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendMemoryCopy failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeCommandListAppendSignalEvent(sides[1].command_list, launching);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendSignalEvent failed: " +
+                             std::to_string(result));
+  }
+  result = zeCommandListAppendLaunchKernel(
+      sides[1].command_list, sides[1].persistent_function,
+      &context.thread_group_dimensions, nullptr, 1, &cleared);
+  if (result) {
+    throw std::runtime_error("zeCommandListAppendLaunchKernel failed: " +
+                             std::to_string(result));
+  }
+  for (int s = 0; s < 2; s++) {
+    result = zeCommandListClose(sides[s].command_list);
+    if (result) {
+      throw std::runtime_error("zeCommandListClose failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  round_trips.clear();
+  int errors = 0;
+  /* One extra measurement, the first, left out as warm-up */
+  for (int i = 0; i <= 10; i++) {
+    for (int e = 0; e < 3; e++) {
+      result = zeEventHostReset(events[e]);
+      if (result) {
+        throw std::runtime_error("zeEventHostReset failed: " +
+                                 std::to_string(result));
+      }
+    }
+    for (int s = 0; s < 2; s++) {
+      result = zeCommandQueueExecuteCommandLists(
+          sides[s].command_queue, 1, &sides[s].command_list, nullptr);
+      if (result) {
+        throw std::runtime_error(
+            "zeCommandQueueExecuteCommandLists failed: " +
+            std::to_string(result));
+      }
+    }
+    synchronize_peer_sides(sides);
+
+    ze_kernel_timestamp_result_t timestamp = {};
+    result = zeEventQueryKernelTimestamp(events[2], &timestamp);
+    if (result) {
+      throw std::runtime_error("zeEventQueryKernelTimestamp failed: " +
+                               std::to_string(result));
+    }
+    errors += pong[0];
+    if (i > 0) {
+      round_trips.push_back(peer_timestamp_nsec(sides[0],
+                                                timestamp.global.kernelStart,
+                                                timestamp.global.kernelEnd) /
+                            num_execute / 1000.);
+    }
+  }
+  verify_result(errors);
+}
+
+//---------------------------------------------------------------------
+// Device to device ping-pong over P2P memory between the first two
+// devices of the driver, with no host involvement between round trips:
+// by kernels relaunched on each other's events, and by two persistent
+// kernels spinning on a mailbox. Each distribution is over the mean
+// round trip of 10 measurements.
+//---------------------------------------------------------------------
+void ZePingPong::run_peer_test(L0Context &context) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+  std::vector<double> round_trips;
+
+  std::cout << "\n"
+            << "DEVICE TO DEVICE EXPERIMENTS: ROUND-TRIP LATENCY OVER P2P "
+               "MEMORY\n\n";
+
+  uint32_t device_count = 0;
+  result = zeDeviceGet(context.driver, &device_count, nullptr);
+  if (result) {
+    throw std::runtime_error("zeDeviceGet failed: " + std::to_string(result));
+  }
+  if (device_count < 2) {
+    std::cout << "Skipped: needs two devices, the driver has "
+              << device_count << "\n";
+    return;
+  }
+  std::vector<ze_device_handle_t> devices(device_count);
+  result = zeDeviceGet(context.driver, &device_count, devices.data());
+  if (result) {
+    throw std::runtime_error("zeDeviceGet failed: " + std::to_string(result));
+  }
+
+  for (int s = 0; s < 2; s++) {
+    ze_bool_t can_access = false;
+    result = zeDeviceCanAccessPeer(devices[s], devices[1 - s], &can_access);
+    if (result) {
+      throw std::runtime_error("zeDeviceCanAccessPeer failed: " +
+                               std::to_string(result));
+    }
+    if (!can_access) {
+      std::cout << "Skipped: device " << s << " cannot access the memory "
+                << "of device " << 1 - s << "\n";
+      return;
+    }
+  }
+
+  PeerSide sides[2];
+  create_peer_side(context, devices[0], "kPingPongPeerInitiator", sides[0]);
+  create_peer_side(context, devices[1], "kPingPongPeerResponder", sides[1]);
+  std::cout << "Device 0: " << sides[0].device_property.name << "\n"
+            << "Device 1: " << sides[1].device_property.name << "\n\n";
+
+  /* Events of both devices, the relaunch experiment uses them all */
+  ze_event_pool_handle_t event_pool = nullptr;
+  ze_event_pool_desc_t event_pool_desc = {};
+  event_pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+  event_pool_desc.flags =
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP;
+  event_pool_desc.count = 2 * peer_relaunch_round_trips + 1;
+  result = zeEventPoolCreate(context.context, &event_pool_desc, 2,
+                             devices.data(), &event_pool);
+  if (result) {
+    throw std::runtime_error("zeEventPoolCreate failed: " +
+                             std::to_string(result));
+  }
+  std::vector<ze_event_handle_t> events(event_pool_desc.count);
+  for (uint32_t e = 0; e < event_pool_desc.count; e++) {
+    ze_event_desc_t event_desc = {};
+    event_desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
+    event_desc.index = e;
+    event_desc.signal = ZE_EVENT_SCOPE_FLAG_HOST;
+    event_desc.wait = ZE_EVENT_SCOPE_FLAG_HOST;
+    result = zeEventCreate(event_pool, &event_desc, &events[e]);
+    if (result) {
+      throw std::runtime_error("zeEventCreate failed: " +
+                               std::to_string(result));
+    }
+  }
+
+  /* Counter and mailbox in the memory of the first device */
+  void *counter = nullptr, *mailbox = nullptr;
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  result = zeMemAllocDevice(context.context, &device_desc, sizeof(int), 64,
+                            devices[0], &counter);
+  if (result == ZE_RESULT_SUCCESS) {
+    result = zeMemAllocDevice(context.context, &device_desc,
+                              (peer_mailbox_errors_index + 1) * sizeof(int),
+                              64, devices[0], &mailbox);
+  }
+  if (result) {
+    throw std::runtime_error("zeMemAllocDevice failed: " +
+                             std::to_string(result));
+  }
+
+  measure_peer_relaunch_round_trips(context, sides, events, counter,
+                                    round_trips);
+  print_latency_distribution("Kernel relaunch", round_trips);
+  measure_peer_persistent_round_trips(context, sides, events, mailbox,
+                                      round_trips);
+  print_latency_distribution("Persistent kernel spinning", round_trips);
+
+  for (auto buffer : {counter, mailbox}) {
+    result = zeMemFree(context.context, buffer);
+    if (result) {
+      throw std::runtime_error("zeMemFree failed: " +
+                               std::to_string(result));
+    }
+  }
+  for (auto event : events) {
+    result = zeEventDestroy(event);
+    if (result) {
+      throw std::runtime_error("zeEventDestroy failed: " +
+                               std::to_string(result));
+    }
+  }
+  result = zeEventPoolDestroy(event_pool);
+  if (result) {
+    throw std::runtime_error("zeEventPoolDestroy failed: " +
+                             std::to_string(result));
+  }
+  destroy_peer_side(sides[1]);
+  destroy_peer_side(sides[0]);
+}
+
+void ZePingPong::run_test(L0Context &context) {
+
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  level_zero_tests::BinaryFile binary_file =
+      context.load_binary_file("ze_pingpong.spv");
+
+  create_module(context, binary_file, ZE_MODULE_FORMAT_IL_SPIRV, nullptr);
+
+  ze_kernel_desc_t function_description = {};
+  function_description.stype = ZE_STRUCTURE_TYPE_KERNEL_DESC;
+
+  int *ping = static_cast<int *>(context.device_input);
+  int *pong = static_cast<int *>(context.host_output);
+  int *ping_shared = static_cast<int *>(context.shared_output);
+
+  function_description.pNext = nullptr;
+  function_description.flags = 0;
+  function_description.pKernelName = "kPingPong";
+
+  result =
+      zeKernelCreate(context.module, &function_description, &context.function);
+  if (result) {
+    throw std::runtime_error("zeKernelCreate failed: " +
+                             std::to_string(result));
+  }
+
+  result = zeKernelSetGroupSize(context.function, 1, 1, 1);
+  if (result) {
+    throw std::runtime_error("zeKernelSetGroupSize failed: " +
+                             std::to_string(result));
+  }
+
+  std::cout << "\n"
+            << "KERNEL EXECUTION ONLY EXPERIMENTS\n\n";
+  set_argument_value(context, 0, sizeof(ping), &ping);
+  setup_commandlist(context, DEVICE_MEM_KERNEL_ONLY);
+
+  // Warm-up
+  for (int i = 0; i < num_execute / 2; i++) {
+    run_command_queue(context);
+    // next line not needed for ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS;
+    // synchronize_command_queue(context);
+  }
+  reset_commandlist(context);
+  set_argument_value(context, 0, sizeof(ping), &ping);
+  setup_commandlist(context, DEVICE_MEM_KERNEL_ONLY);
+
+  auto elapsed_time = measure_benchmark(context, DEVICE_MEM_KERNEL_ONLY);
+  const auto loop_time_kernel_dev = elapsed_time / num_execute * 1000.;
+  std::cout << "Device allocated memory w.sync:   " << std::fixed
+            << std::setprecision(2) << loop_time_kernel_dev << " usec/loop ";
+  std::cout << "(" << std::fixed << std::setprecision(2) << elapsed_time
+            << " msec total)\n";
+  reset_commandlist(context);
+
+  set_argument_value(context, 0, sizeof(pong), &pong);
+  setup_commandlist(context, HOST_MEM_KERNEL_ONLY);
+  elapsed_time = measure_benchmark(context, HOST_MEM_KERNEL_ONLY);
+  const auto loop_time_kernel_host = elapsed_time / num_execute * 1000.;
+  std::cout << "Host allocated memory w.sync  :   " << std::fixed
+            << std::setprecision(2) << loop_time_kernel_host << " usec/loop ";
+  std::cout << "(" << std::fixed << std::setprecision(2) << elapsed_time
+            << " msec total)\n";
+  reset_commandlist(context);
+
+  set_argument_value(context, 0, sizeof(ping_shared), &ping_shared);
   setup_commandlist(context, SHARED_MEM_KERNEL_ONLY);
   elapsed_time = measure_benchmark(context, SHARED_MEM_KERNEL_ONLY);
   const auto loop_time_kernel_shared = elapsed_time / num_execute * 1000.;
@@ -560,6 +1790,10 @@ void ZePingPong::run_test(L0Context &context) {
             << "%"
             << "\n";
 
+  run_submission_test(context);
+
+  run_sync_test(context);
+
   result = zeKernelDestroy(context.function);
   if (result) {
     throw std::runtime_error("zeKernelDestroy failed: " +
@@ -580,13 +1814,21 @@ int main(int argc, char **argv) {
   ZePingPong pingpong_benchmark;
   L0Context context;
 
-  if (argc > 1) {
-    throw std::runtime_error("no arguments are accepted");
+  const std::string mode = argc == 2 ? argv[1] : "";
+  if (argc > 2 || (argc == 2 && mode != "--doorbell" && mode != "--p2p")) {
+    throw std::runtime_error("the only arguments accepted are --doorbell "
+                             "and --p2p");
   }
 
   context.init();
 
-  pingpong_benchmark.run_test(context);
+  if (mode == "--doorbell") {
+    pingpong_benchmark.run_doorbell_test(context);
+  } else if (mode == "--p2p") {
+    pingpong_benchmark.run_peer_test(context);
+  } else {
+    pingpong_benchmark.run_test(context);
+  }
 
   context.destroy();
 
@@ -0,0 +1,79 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _ZE_SAMPLER_HPP_
+#define _ZE_SAMPLER_HPP_
+
+#include <level_zero/ze_api.h>
+#include "../../common/include/common.hpp"
+#include "results.hpp"
+#include "ze_app.hpp"
+
+#include <string>
+#include <vector>
+
+/* An image format of the sweep and the buffer kernel reading the same bytes
+ * one texel per work item */
+struct SamplerFormat {
+  const char *name;
+  ze_image_format_layout_t layout;
+  ze_image_format_type_t type;
+  uint32_t texel_size;
+  const char *buffer_kernel;
+};
+
+class ZeSampler {
+public:
+  ZeSampler();
+  ~ZeSampler();
+  int parse_arguments(int argc, char **argv);
+  void test_sampler(void);
+
+  /* indexes into the formats of ze_sampler.cpp */
+  std::vector<uint32_t> formats{0, 1, 2, 3};
+  std::vector<ze_sampler_filter_mode_t> filter_modes{
+      ZE_SAMPLER_FILTER_MODE_NEAREST, ZE_SAMPLER_FILTER_MODE_LINEAR};
+  std::vector<bool> normalized_modes{false, true};
+  std::vector<ze_sampler_address_mode_t> address_modes{
+      ZE_SAMPLER_ADDRESS_MODE_NONE, ZE_SAMPLER_ADDRESS_MODE_CLAMP,
+      ZE_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER, ZE_SAMPLER_ADDRESS_MODE_REPEAT,
+      ZE_SAMPLER_ADDRESS_MODE_MIRROR};
+  uint32_t width = 2048;
+  uint32_t height = 2048;
+  /* texels the coordinates are shifted by, past the right and bottom edges */
+  uint32_t overscan = 0;
+  uint32_t launches_per_list = 10;
+  uint32_t number_iterations = 50;
+  uint32_t warmup_iterations = 5;
+  bool csv_output = false;
+  /* --results sinks, which get every result */
+  ResultReport results{"ze_sampler"};
+
+  ZeApp *benchmark;
+
+private:
+  void fill_texels(const SamplerFormat &format, std::vector<uint8_t> &texels);
+  std::vector<long double> measure_kernel(ze_kernel_handle_t kernel,
+                                          const ze_group_count_t &group_count);
+  std::vector<long double> sample_usec(ze_image_handle_t image,
+                                       ze_sampler_handle_t sampler,
+                                       bool normalized, uint64_t &texels);
+  std::vector<long double> buffer_usec(const SamplerFormat &format,
+                                       uint64_t &texels);
+  void add_result(const std::string &test, const SamplerFormat &format,
+                  const std::vector<std::pair<std::string, std::string>> &mode,
+                  const std::vector<long double> &samples);
+
+  ze_command_queue_handle_t queue = nullptr;
+  ze_command_list_handle_t list = nullptr;
+  ze_kernel_handle_t sample_kernel = nullptr;
+  void *buffer = nullptr;
+  void *output = nullptr;
+};
+
+#endif /* _ZE_SAMPLER_HPP_ */
@@ -0,0 +1,56 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Each kernel reads one texel, or the bytes of one texel, per work item.
+// The result only reaches the output on data the benchmark never writes,
+// so the reads are kept without adding writes to the measured traffic.
+
+// Reads through the sampler at the centre of pixel (x, y), scaled and
+// offset on the host: by 1 and 0 with unnormalized coordinates, and by the
+// inverse of the image size with normalized ones.
+__kernel void image_sample(read_only image2d_t input, sampler_t sampler,
+                           __global float *output, float scale_x,
+                           float scale_y, float offset_x, float offset_y) {
+  float x = ((float)(uint)get_global_id(0) + 0.5f) * scale_x + offset_x;
+  float y = ((float)(uint)get_global_id(1) + 0.5f) * scale_y + offset_y;
+  float4 pixel = read_imagef(input, sampler, (float2)(x, y));
+  float sum = pixel.x + pixel.y + pixel.z + pixel.w;
+
+  if (sum < 0.0f) {
+    output[0] = sum;
+  }
+}
+
+__kernel void buffer_read_u32(__global const uint *input,
+                              __global uint *output) {
+  uint value = input[get_global_id(0)];
+
+  if (value == 0xffffffff) {
+    output[0] = value;
+  }
+}
+
+__kernel void buffer_read_u64(__global const uint2 *input,
+                              __global uint *output) {
+  uint2 texel = input[get_global_id(0)];
+  uint value = texel.x ^ texel.y;
+
+  if (value == 0xffffffff) {
+    output[0] = value;
+  }
+}
+
+__kernel void buffer_read_u128(__global const uint4 *input,
+                               __global uint *output) {
+  uint4 texel = input[get_global_id(0)];
+  uint value = texel.x ^ texel.y ^ texel.z ^ texel.w;
+
+  if (value == 0xffffffff) {
+    output[0] = value;
+  }
+}
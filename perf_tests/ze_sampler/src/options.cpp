@@ -0,0 +1,199 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "ze_sampler.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char *usage_str =
+    "\n ze_sampler [OPTIONS]"
+    "\n"
+    "\n OPTIONS:"
+    "\n  -f, list                 comma separated image formats "
+    "[default:  all]:"
+    "\n      rgba8                            4 channels of 8 bit unorm"
+    "\n      r32f                             1 channel of 32 bit float"
+    "\n      rgba16f                          4 channels of 16 bit float"
+    "\n      rgba32f                          4 channels of 32 bit float"
+    "\n  -F, list                 comma separated filter modes "
+    "[default:  all]:"
+    "\n      nearest, linear"
+    "\n  -c, list                 comma separated coordinates "
+    "[default:  all]:"
+    "\n      unnormalized, normalized"
+    "\n  -a, list                 comma separated address modes "
+    "[default:  all]:"
+    "\n      none, clamp, clamp_to_border, repeat, mirror"
+    "\n                            repeat and mirror only with normalized "
+    "coordinates"
+    "\n  -x                       set image width in texels "
+    "[default:  2048]"
+    "\n  -y                       set image height in texels "
+    "[default:  2048]"
+    "\n  --overscan               shift the coordinates by this many "
+    "texels past the"
+    "\n                            right and bottom edges, so that the "
+    "address mode"
+    "\n                            applies to them [default:  0]"
+    "\n  -l                       set number of launches per command list"
+    "\n                            [default:  10]"
+    "\n  -i                       set number of iterations per mode"
+    "\n                            [default:  50]"
+    "\n  -w                       set number of warmup iterations"
+    "\n                            [default:  5]"
+    "\n  --csv                    output in csv format (default: disabled)"
+    "\n  --results list           also report the results to the comma "
+    "separated"
+    "\n                            sinks console, csv, csv:file, json:file, "
+    "gate:dir"
+    "\n                            and baseline:dir, with the driver and "
+    "device"
+    "\n                            metadata; gate:dir exits with 1 on a "
+    "regression"
+    "\n                            against the baseline in dir"
+    "\n  -h, --help               display help message"
+    "\n";
+
+static const char *format_names[] = {"rgba8", "r32f", "rgba16f", "rgba32f"};
+
+static uint32_t sanitize_ulong(char *in) {
+  unsigned long temp = strtoul(in, NULL, 0);
+  if (ERANGE == errno) {
+    fprintf(stderr, "%s out of range of type ulong\n", in);
+  } else if (temp > UINT32_MAX) {
+    fprintf(stderr, "%ld greater than UINT32_MAX\n", temp);
+  } else {
+    return static_cast<uint32_t>(temp);
+  }
+  return 0;
+}
+
+static std::vector<std::string> split_list(const char *list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+//---------------------------------------------------------------------
+// Utility function which parses the arguments to ze_sampler and sets
+// the test parameters accordingly for main to execute the tests with
+// the correct environment.
+//---------------------------------------------------------------------
+int ZeSampler::parse_arguments(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) {
+      std::cout << usage_str;
+      exit(0);
+    } else if ((strcmp(argv[i], "-f") == 0) && (i + 1 < argc)) {
+      formats.clear();
+      for (auto &format : split_list(argv[i + 1])) {
+        uint32_t index = 0;
+        while (index < 4 && format != format_names[index]) {
+          index++;
+        }
+        if (index == 4) {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+        formats.push_back(index);
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-F") == 0) && (i + 1 < argc)) {
+      filter_modes.clear();
+      for (auto &mode : split_list(argv[i + 1])) {
+        if (mode == "nearest") {
+          filter_modes.push_back(ZE_SAMPLER_FILTER_MODE_NEAREST);
+        } else if (mode == "linear") {
+          filter_modes.push_back(ZE_SAMPLER_FILTER_MODE_LINEAR);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc)) {
+      normalized_modes.clear();
+      for (auto &mode : split_list(argv[i + 1])) {
+        if (mode == "unnormalized") {
+          normalized_modes.push_back(false);
+        } else if (mode == "normalized") {
+          normalized_modes.push_back(true);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-a") == 0) && (i + 1 < argc)) {
+      address_modes.clear();
+      for (auto &mode : split_list(argv[i + 1])) {
+        if (mode == "none") {
+          address_modes.push_back(ZE_SAMPLER_ADDRESS_MODE_NONE);
+        } else if (mode == "clamp") {
+          address_modes.push_back(ZE_SAMPLER_ADDRESS_MODE_CLAMP);
+        } else if (mode == "clamp_to_border") {
+          address_modes.push_back(ZE_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER);
+        } else if (mode == "repeat") {
+          address_modes.push_back(ZE_SAMPLER_ADDRESS_MODE_REPEAT);
+        } else if (mode == "mirror") {
+          address_modes.push_back(ZE_SAMPLER_ADDRESS_MODE_MIRROR);
+        } else {
+          std::cerr << usage_str;
+          exit(-1);
+        }
+      }
+      i++;
+    } else if ((strcmp(argv[i], "-x") == 0) && (i + 1 < argc)) {
+      width = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-y") == 0) && (i + 1 < argc)) {
+      height = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "--overscan") == 0) && (i + 1 < argc)) {
+      overscan = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if ((strcmp(argv[i], "-l") == 0) && (i + 1 < argc)) {
+      launches_per_list = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      number_iterations = std::max(1u, sanitize_ulong(argv[i + 1]));
+      i++;
+    } else if ((strcmp(argv[i], "-w") == 0) && (i + 1 < argc)) {
+      warmup_iterations = sanitize_ulong(argv[i + 1]);
+      i++;
+    } else if (strcmp(argv[i], "--csv") == 0) {
+      csv_output = true;
+    } else if ((strcmp(argv[i], "--results") == 0) && (i + 1 < argc)) {
+      if (!results.add_sinks(argv[i + 1])) {
+        std::cerr << usage_str;
+        exit(-1);
+      }
+      i++;
+    } else {
+      std::cerr << usage_str;
+      exit(-1);
+    }
+  }
+
+  if (formats.empty() || filter_modes.empty() || normalized_modes.empty() ||
+      address_modes.empty()) {
+    std::cerr << usage_str;
+    exit(-1);
+  }
+
+  return 0;
+}
@@ -0,0 +1,391 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include <level_zero/ze_api.h>
+
+#include "../../common/include/common.hpp"
+#include "ze_app.hpp"
+#include "ze_sampler.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+/* Every texel of the formats reads as non negative, with the top bit of
+ * each of its bytes clear, so that no kernel ever writes its output */
+static const SamplerFormat sampler_formats[] = {
+    {"rgba8", ZE_IMAGE_FORMAT_LAYOUT_8_8_8_8, ZE_IMAGE_FORMAT_TYPE_UNORM, 4,
+     "buffer_read_u32"},
+    {"r32f", ZE_IMAGE_FORMAT_LAYOUT_32, ZE_IMAGE_FORMAT_TYPE_FLOAT, 4,
+     "buffer_read_u32"},
+    {"rgba16f", ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16, ZE_IMAGE_FORMAT_TYPE_FLOAT,
+     8, "buffer_read_u64"},
+    {"rgba32f", ZE_IMAGE_FORMAT_LAYOUT_32_32_32_32, ZE_IMAGE_FORMAT_TYPE_FLOAT,
+     16, "buffer_read_u128"}};
+
+static const char *filter_mode_name(ze_sampler_filter_mode_t mode) {
+  return mode == ZE_SAMPLER_FILTER_MODE_LINEAR ? "linear" : "nearest";
+}
+
+static const char *address_mode_name(ze_sampler_address_mode_t mode) {
+  switch (mode) {
+  case ZE_SAMPLER_ADDRESS_MODE_REPEAT:
+    return "repeat";
+  case ZE_SAMPLER_ADDRESS_MODE_CLAMP:
+    return "clamp";
+  case ZE_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER:
+    return "clamp_to_border";
+  case ZE_SAMPLER_ADDRESS_MODE_MIRROR:
+    return "mirror";
+  default:
+    return "none";
+  }
+}
+
+static const char *coordinates_name(bool normalized) {
+  return normalized ? "normalized" : "unnormalized";
+}
+
+ZeSampler::ZeSampler() {
+  benchmark = new ZeApp("ze_sampler.spv");
+
+  benchmark->singleDeviceInit();
+}
+
+ZeSampler::~ZeSampler() {
+  if (sample_kernel) {
+    benchmark->functionDestroy(sample_kernel);
+  }
+  if (list) {
+    benchmark->commandListDestroy(list);
+  }
+  if (queue) {
+    benchmark->commandQueueDestroy(queue);
+  }
+  if (buffer) {
+    benchmark->memoryFree(buffer);
+  }
+  if (output) {
+    benchmark->memoryFree(output);
+  }
+
+  benchmark->singleDeviceCleanup();
+
+  delete benchmark;
+}
+
+//---------------------------------------------------------------------
+// Fills width x height texels of the format with a ramp of small non
+// negative values, so that linear filtering blends different texels.
+//---------------------------------------------------------------------
+void ZeSampler::fill_texels(const SamplerFormat &format,
+                            std::vector<uint8_t> &texels) {
+  const size_t count = static_cast<size_t>(width) * height;
+  texels.resize(count * format.texel_size);
+
+  if (format.type == ZE_IMAGE_FORMAT_TYPE_UNORM) {
+    for (size_t i = 0; i < texels.size(); i++) {
+      texels[i] = static_cast<uint8_t>(i % 128);
+    }
+  } else if (format.layout == ZE_IMAGE_FORMAT_LAYOUT_16_16_16_16) {
+    /* halves from 0.5 up to just below 1 */
+    for (size_t i = 0; i < texels.size() / sizeof(uint16_t); i++) {
+      const uint16_t half = static_cast<uint16_t>(0x3800 | (i % 1024));
+      memcpy(&texels[i * sizeof(half)], &half, sizeof(half));
+    }
+  } else {
+    for (size_t i = 0; i < texels.size() / sizeof(float); i++) {
+      const float value = static_cast<float>(i % 1024) / 1024.0f;
+      memcpy(&texels[i * sizeof(value)], &value, sizeof(value));
+    }
+  }
+}
+
+//---------------------------------------------------------------------
+// Runs a list of launches_per_list launches of the kernel once per
+// iteration and returns the time per launch of every iteration.
+//---------------------------------------------------------------------
+std::vector<long double>
+ZeSampler::measure_kernel(ze_kernel_handle_t kernel,
+                          const ze_group_count_t &group_count) {
+  SampleTimer<std::micro> timer(number_iterations);
+
+  benchmark->commandListReset(list);
+  for (uint32_t i = 0; i < launches_per_list; i++) {
+    SUCCESS_OR_TERMINATE(zeCommandListAppendLaunchKernel(
+        list, kernel, &group_count, nullptr, 0, nullptr));
+  }
+  benchmark->commandListClose(list);
+
+  for (uint32_t i = 0; i < warmup_iterations; i++) {
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+  }
+  for (uint32_t i = 0; i < number_iterations; i++) {
+    timer.start();
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+    timer.stop(launches_per_list);
+  }
+
+  return timer.samples();
+}
+
+//---------------------------------------------------------------------
+// Reads every texel of the image through the sampler, one work item per
+// texel, at the texel centres shifted by overscan texels, and returns
+// the number of texels read with the time per launch.
+//---------------------------------------------------------------------
+std::vector<long double> ZeSampler::sample_usec(ze_image_handle_t image,
+                                                ze_sampler_handle_t sampler,
+                                                bool normalized,
+                                                uint64_t &texels) {
+  uint32_t group_size_x = 0;
+  uint32_t group_size_y = 0;
+  uint32_t group_size_z = 0;
+  SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(sample_kernel, width, height,
+                                                1, &group_size_x,
+                                                &group_size_y, &group_size_z));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetGroupSize(sample_kernel, group_size_x, group_size_y, 1));
+
+  const float scale_x = normalized ? 1.0f / width : 1.0f;
+  const float scale_y = normalized ? 1.0f / height : 1.0f;
+  const float offset_x = overscan * scale_x;
+  const float offset_y = overscan * scale_y;
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(sample_kernel, 0, sizeof(image), &image));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(sample_kernel, 1, sizeof(sampler), &sampler));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(sample_kernel, 2, sizeof(output), &output));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(sample_kernel, 3, sizeof(scale_x), &scale_x));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(sample_kernel, 4, sizeof(scale_y), &scale_y));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(sample_kernel, 5, sizeof(offset_x), &offset_x));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(sample_kernel, 6, sizeof(offset_y), &offset_y));
+
+  const ze_group_count_t group_count = {width / group_size_x,
+                                        height / group_size_y, 1};
+  texels = static_cast<uint64_t>(group_count.groupCountX) * group_size_x *
+           group_count.groupCountY * group_size_y;
+  return measure_kernel(sample_kernel, group_count);
+}
+
+//---------------------------------------------------------------------
+// Reads the same bytes as the image from a device buffer, one texel per
+// work item, and returns the number of texels read with the time per
+// launch.
+//---------------------------------------------------------------------
+std::vector<long double> ZeSampler::buffer_usec(const SamplerFormat &format,
+                                                uint64_t &texels) {
+  const uint32_t count = width * height;
+  ze_kernel_handle_t kernel;
+  uint32_t group_size_x = 0;
+  uint32_t group_size_y = 0;
+  uint32_t group_size_z = 0;
+
+  benchmark->functionCreate(&kernel, format.buffer_kernel);
+  SUCCESS_OR_TERMINATE(zeKernelSuggestGroupSize(
+      kernel, count, 1, 1, &group_size_x, &group_size_y, &group_size_z));
+  SUCCESS_OR_TERMINATE(zeKernelSetGroupSize(kernel, group_size_x, 1, 1));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 0, sizeof(buffer), &buffer));
+  SUCCESS_OR_TERMINATE(
+      zeKernelSetArgumentValue(kernel, 1, sizeof(output), &output));
+
+  const ze_group_count_t group_count = {count / group_size_x, 1, 1};
+  texels = static_cast<uint64_t>(group_count.groupCountX) * group_size_x;
+  std::vector<long double> samples = measure_kernel(kernel, group_count);
+
+  benchmark->functionDestroy(kernel);
+  return samples;
+}
+
+void ZeSampler::add_result(
+    const std::string &test, const SamplerFormat &format,
+    const std::vector<std::pair<std::string, std::string>> &mode,
+    const std::vector<long double> &samples) {
+  if (!results.enabled()) {
+    return;
+  }
+  ResultRecord record;
+  record.test = test;
+  record.metric = "latency";
+  record.unit = "usec";
+  record.parameters = {{"format", format.name},
+                       {"width", std::to_string(width)},
+                       {"height", std::to_string(height)}};
+  record.parameters.insert(record.parameters.end(), mode.begin(), mode.end());
+  record.stats = ResultStats::from_samples(samples);
+  record.value = record.stats.median;
+  record.samples = samples;
+  results.add(record);
+}
+
+static void print_rate(bool csv_output, long double usec, uint64_t texels,
+                       uint32_t texel_size) {
+  const long double gbps = texels * texel_size / usec / 1e3;
+  const long double gtexels = texels / usec / 1e3;
+  if (csv_output) {
+    std::cout << usec << "," << gbps << "," << gtexels;
+  } else {
+    std::cout << std::setprecision(2) << std::fixed << std::setw(9) << usec
+              << " usec " << std::setw(8) << gbps << " GBPS " << std::setw(8)
+              << gtexels << " GTexels/s";
+  }
+}
+
+//---------------------------------------------------------------------
+// For every format, reads a width x height image through a sampler of
+// every filter, coordinate and address mode, and the same bytes from a
+// buffer, and reports the time per launch, the bandwidth and the texel
+// rate of both, with the speedup of the sampler over the buffer.
+//---------------------------------------------------------------------
+void ZeSampler::test_sampler(void) {
+  const size_t max_size =
+      static_cast<size_t>(width) * height * sizeof(float) * 4;
+  benchmark->memoryAlloc(max_size, &buffer);
+  benchmark->memoryAlloc(sizeof(uint32_t), &output);
+  benchmark->functionCreate(&sample_kernel, "image_sample");
+  benchmark->commandQueueCreate(0, &queue);
+  benchmark->commandListCreate(&list);
+
+  std::cout << std::endl;
+  std::cout << "SAMPLER READ" << std::endl;
+  if (csv_output) {
+    std::cout << "Format,Path,Filter,Coordinates,Address,Time_(usec),GBPS,"
+                 "GTexels/s,Speedup"
+              << std::endl;
+  }
+
+  std::vector<uint8_t> texels;
+  for (auto format_index : formats) {
+    const SamplerFormat &format = sampler_formats[format_index];
+
+    ze_image_desc_t image_desc = {};
+    image_desc.stype = ZE_STRUCTURE_TYPE_IMAGE_DESC;
+    image_desc.type = ZE_IMAGE_TYPE_2D;
+    image_desc.format = {format.layout,
+                         format.type,
+                         ZE_IMAGE_FORMAT_SWIZZLE_R,
+                         ZE_IMAGE_FORMAT_SWIZZLE_G,
+                         ZE_IMAGE_FORMAT_SWIZZLE_B,
+                         ZE_IMAGE_FORMAT_SWIZZLE_A};
+    image_desc.width = width;
+    image_desc.height = height;
+    image_desc.depth = 1;
+    ze_image_handle_t image = nullptr;
+    if (zeImageCreate(benchmark->context, benchmark->_devices[0], &image_desc,
+                      &image) != ZE_RESULT_SUCCESS) {
+      std::cout << "Format: " << format.name
+                << " images are not supported, skipped" << std::endl;
+      continue;
+    }
+
+    fill_texels(format, texels);
+    benchmark->commandListReset(list);
+    benchmark->commandListAppendImageCopyFromMemory(list, image, texels.data(),
+                                                    nullptr);
+    benchmark->commandListAppendMemoryCopy(list, buffer, texels.data(),
+                                           texels.size());
+    benchmark->commandListClose(list);
+    benchmark->commandQueueExecuteCommandList(queue, 1, &list);
+    benchmark->commandQueueSynchronize(queue);
+
+    uint64_t buffer_texels = 0;
+    const std::vector<long double> buffer_samples =
+        buffer_usec(format, buffer_texels);
+    const long double buffer_time =
+        ResultStats::from_samples(buffer_samples).median;
+    if (csv_output) {
+      std::cout << format.name << ",buffer,,,,";
+      print_rate(true, buffer_time, buffer_texels, format.texel_size);
+      std::cout << ",1" << std::endl;
+    } else {
+      std::cout << "Format: " << std::setw(7) << format.name
+                << " Buffer:                                         ";
+      print_rate(false, buffer_time, buffer_texels, format.texel_size);
+      std::cout << std::endl;
+    }
+    add_result("Buffer", format, {}, buffer_samples);
+
+    for (auto filter_mode : filter_modes) {
+      for (auto normalized : normalized_modes) {
+        for (auto address_mode : address_modes) {
+          /* repeat and mirror are only defined on normalized coordinates */
+          if (!normalized &&
+              (address_mode == ZE_SAMPLER_ADDRESS_MODE_REPEAT ||
+               address_mode == ZE_SAMPLER_ADDRESS_MODE_MIRROR)) {
+            continue;
+          }
+          ze_sampler_desc_t sampler_desc = {};
+          sampler_desc.stype = ZE_STRUCTURE_TYPE_SAMPLER_DESC;
+          sampler_desc.addressMode = address_mode;
+          sampler_desc.filterMode = filter_mode;
+          sampler_desc.isNormalized = normalized;
+          ze_sampler_handle_t sampler = nullptr;
+          if (zeSamplerCreate(benchmark->context, benchmark->_devices[0],
+                              &sampler_desc, &sampler) != ZE_RESULT_SUCCESS) {
+            continue;
+          }
+
+          uint64_t sample_texels = 0;
+          const std::vector<long double> samples =
+              sample_usec(image, sampler, normalized, sample_texels);
+          SUCCESS_OR_TERMINATE(zeSamplerDestroy(sampler));
+          const long double time = ResultStats::from_samples(samples).median;
+
+          const char *filter = filter_mode_name(filter_mode);
+          const char *coordinates = coordinates_name(normalized);
+          const char *address = address_mode_name(address_mode);
+          if (csv_output) {
+            std::cout << format.name << ",sampler," << filter << ","
+                      << coordinates << "," << address << ",";
+            print_rate(true, time, sample_texels, format.texel_size);
+            std::cout << "," << buffer_time / time << std::endl;
+          } else {
+            std::cout << "Format: " << std::setw(7) << format.name
+                      << " Sampler: " << std::setw(7) << filter << " "
+                      << std::setw(12) << coordinates << " " << std::setw(15)
+                      << address << " ";
+            print_rate(false, time, sample_texels, format.texel_size);
+            std::cout << " Speedup: " << buffer_time / time << "x"
+                      << std::endl;
+          }
+          add_result("Sampler", format,
+                     {{"filter", filter},
+                      {"coordinates", coordinates},
+                      {"address", address},
+                      {"overscan", std::to_string(overscan)}},
+                     samples);
+        }
+      }
+    }
+
+    benchmark->imageDestroy(image);
+  }
+}
+
+int main(int argc, char **argv) {
+  ZeSampler sampler;
+
+  sampler.parse_arguments(argc, argv);
+
+  if (sampler.results.enabled()) {
+    sampler.results.read_metadata(sampler.benchmark->_devices);
+  }
+
+  sampler.test_sampler();
+
+  std::cout << std::endl;
+  return sampler.results.finish();
+}
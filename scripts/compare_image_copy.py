@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# Copyright (C) 2024 Intel Corporation
+# SPDX-License-Identifier: MIT
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+def IsListableDirPath(path: str):
+    try:
+        os.listdir(path)
+    except Exception as e:
+        raise argparse.ArgumentTypeError(path + ' is not a listable directory: ' + str(e))
+    return os.path.abspath(path)
+
+def ParseSize(size: str):
+    try:
+        width, height = size.lower().split('x')
+        return int(width), int(height)
+    except ValueError:
+        raise argparse.ArgumentTypeError(size + ' is not an image size like 1920x1080')
+
+def RunBenchmark(binary: str, binary_dir: str, width: int, height: int, layout: str, args):
+    # Both benchmarks take the same options, see their README.md
+    with tempfile.TemporaryDirectory() as output_dir:
+        output_file = os.path.join(output_dir, 'output.json')
+        command = [os.path.join(binary_dir, binary),
+                   '-w', str(width), '-h', str(height),
+                   '--layout', layout, '--format', args.format,
+                   '--type', args.type,
+                   '--num-iter', str(args.iterations),
+                   '--warmup', str(args.warmup),
+                   '--noofimg', str(args.copies),
+                   '--json-output-file', output_file]
+        print(' '.join(command), flush=True)
+        try:
+            subprocess.run(command, cwd=binary_dir, stdout=subprocess.DEVNULL, check=True)
+            with open(output_file) as output:
+                benchmark = json.load(output)['Performance Benchmark']
+        except (OSError, ValueError, KeyError, subprocess.CalledProcessError) as e:
+            print(binary + ' failed: ' + str(e), file=sys.stderr)
+            return {}
+
+    # Entries are named "<direction>: <description>", and the direction is
+    # the same in both benchmarks
+    results = {}
+    for section, metric in [('bandwidth', 'GBPS'), ('latency', 'Latency')]:
+        for entry in benchmark.get(section, []):
+            direction = entry['Name'].split(':')[0]
+            results.setdefault(direction, {})[metric] = float(entry[metric])
+            if section == 'bandwidth' and 'Latency' in entry:
+                results[direction]['Copy latency'] = float(entry['Latency'])
+    return results
+
+def Delta(level_zero: float, opencl: float):
+    if opencl == 0:
+        return float('nan')
+    return (level_zero - opencl) / opencl * 100
+
+def main():
+    parser = argparse.ArgumentParser(description='Runs ze_image_copy and cl_image_copy with the same image parameters and reports the Level Zero vs OpenCL difference per configuration')
+    parser.add_argument('--binary_dir', type=IsListableDirPath, required=True, help='Directory which contains ze_image_copy and cl_image_copy')
+    parser.add_argument('--sizes', type=lambda s: [ParseSize(size) for size in s.split(',')], default=[(2048, 2048)], help='List of image sizes Comma Separated, like 1920x1080,4096x4096')
+    parser.add_argument('--layouts', type=lambda s: s.split(','), default=['8_8_8_8'], help='List of image layouts Comma Separated, like 8,8_8_8_8,32_32_32_32')
+    parser.add_argument('--format', default='UINT', help='Image format like UINT/SINT/UNORM/SNORM/FLOAT')
+    parser.add_argument('--type', default='2D', help='Image type like 1D/2D/3D/1DARRAY/2DARRAY')
+    parser.add_argument('--iterations', type=int, default=50, help='Number of iterations')
+    parser.add_argument('--warmup', type=int, default=10, help='Number of warmup operations')
+    parser.add_argument('--copies', type=int, default=100, help='Number of image copies per iteration')
+    parser.add_argument('--csv', help='Also write the report to this CSV file')
+    args = parser.parse_args()
+
+    rows = []
+    for width, height in args.sizes:
+        for layout in args.layouts:
+            level_zero = RunBenchmark('ze_image_copy', args.binary_dir, width, height, layout, args)
+            opencl = RunBenchmark('cl_image_copy', args.binary_dir, width, height, layout, args)
+            for direction in level_zero:
+                if direction not in opencl:
+                    continue
+                for metric in ['GBPS', 'Copy latency', 'Latency']:
+                    if metric in level_zero[direction] and metric in opencl[direction]:
+                        rows.append([str(width) + 'x' + str(height), layout, args.format,
+                                     direction, metric, level_zero[direction][metric],
+                                     opencl[direction][metric],
+                                     Delta(level_zero[direction][metric], opencl[direction][metric])])
+
+    header = ['Size', 'Layout', 'Format', 'Direction', 'Metric', 'Level Zero', 'OpenCL', 'Delta %']
+    print()
+    print('{:<11} {:<18} {:<6} {:<16} {:<13} {:>12} {:>12} {:>8}'.format(*header))
+    for row in rows:
+        print('{:<11} {:<18} {:<6} {:<16} {:<13} {:>12.3f} {:>12.3f} {:>+8.1f}'.format(*row))
+    print()
+    print('GBPS is higher is better, latencies are in usec and lower is better')
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as csv_file:
+            writer = csv.writer(csv_file)
+            writer.writerow(header)
+            writer.writerows(rows)
+
+    return 0 if rows else 1
+
+if __name__ == '__main__':
+    sys.exit(main())
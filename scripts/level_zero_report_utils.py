@@ -2,7 +2,12 @@
 # Copyright (C) 2021-2023 Intel Corporation
 # SPDX-License-Identifier: MIT
 
+import csv
+import json
+import os
 import re
+import statistics
+import sys
 
 def assign_test_feature_tag(test_feature: str, test_name: str, test_section: str,):
         test_feature_tag = ""
@@ -425,3 +430,170 @@ def assign_test_feature(test_binary: str, test_name: str):
 
         return test_feature, test_section
 
+
+#
+# Performance results
+#
+# The result files of the perf tools are read into records of one measured
+# value each: the tool, the test, the metric, its unit, the parameters it was
+# measured with, as "name=value;..." and the value. Records with the same
+# tool, test, metric and parameters are the same measurement across runs.
+#
+
+perf_result_tools = ["ze_peak", "ze_bandwidth", "ze_alloc", "ze_launch_args", "ze_cmdlist_replay", "ze_mutable_cmdlist", "ze_multi_context", "ze_cl_interop", "ze_sampler", "ze_fabric", "ze_autotune", "ze_cooperative", "ze_peer", "ze_nano", "ze_perf_suite"]
+
+# Units where lower is better, as in the regression gate of the perf tools
+perf_lower_is_better_units = ["ns", "nsec", "nanoseconds", "us", "usec", "ms", "msec", "s", "sec",
+                              "cycles", "instructions"]
+
+def perf_record(tool: str, test: str, metric: str, unit: str, value, parameters: list):
+    return {"tool": tool, "test": test, "metric": metric, "unit": unit, "value": float(value),
+            "parameters": ";".join(name + "=" + str(parameter) for name, parameter in parameters
+                                   if parameter is not None and parameter != "")}
+
+# ze_peak --json or --csv
+def parse_ze_peak_results(file_name: str):
+    records = []
+    if file_name.endswith(".json"):
+        with open(file_name) as file:
+            entries = json.load(file)["results"]
+    else:
+        with open(file_name, newline='') as file:
+            entries = list(csv.DictReader(file))
+    for entry in entries:
+        metric = "latency" if entry["unit"] == "us" else "throughput"
+        records.append(perf_record("ze_peak", entry["test"], metric, entry["unit"], entry["value"],
+                                   [("variant", entry["variant"]), ("tile", entry["tile"])]))
+    return records
+
+# The json:<file> and csv:<file> result sinks of ze_bandwidth and ze_perf_suite
+def parse_result_report(file_name: str):
+    records = []
+    if file_name.endswith(".json"):
+        with open(file_name) as file:
+            report = json.load(file)
+        for entry in report["results"]:
+            if entry["value"] is not None:
+                records.append(perf_record(report["tool"], entry["test"], entry["metric"], entry["unit"],
+                                           entry["value"], sorted(entry["parameters"].items())))
+    else:
+        with open(file_name, newline='') as file:
+            for entry in csv.DictReader(file):
+                if entry["value"] == "null":
+                    continue
+                parameters = [tuple(parameter.split("=", 1)) for parameter in entry["parameters"].split(";")
+                              if "=" in parameter]
+                records.append(perf_record(entry["tool"], entry["test"], entry["metric"], entry["unit"],
+                                           entry["value"], sorted(parameters)))
+    return records
+
+# ze_peer --json or --csv of the all pairs matrices
+def parse_ze_peer_results(file_name: str):
+    records = []
+    if file_name.endswith(".json"):
+        with open(file_name) as file:
+            report = json.load(file)
+        bidirectional = 1 if report["bidirectional"] else 0
+        for matrix in report["matrices"]:
+            for src, row in enumerate(matrix["values"]):
+                for dst, value in enumerate(row):
+                    if value is not None:
+                        records.append(perf_record("ze_peer", matrix["test"], matrix["transfer"], matrix["unit"], value,
+                                                   [("bidirectional", bidirectional), ("size_bytes", matrix["size_bytes"]),
+                                                    ("src_device", src), ("dst_device", dst)]))
+    else:
+        with open(file_name, newline='') as file:
+            for entry in csv.DictReader(file):
+                records.append(perf_record("ze_peer", entry["test"], entry["transfer"], entry["unit"], entry["value"],
+                                           [("bidirectional", entry["bidirectional"]), ("size_bytes", entry["size_bytes"]),
+                                            ("src_device", entry["src_device"]), ("dst_device", entry["dst_device"])]))
+    return records
+
+# ze_nano --json_output
+def parse_ze_nano_results(file_name: str):
+    with open(file_name) as file:
+        entries = json.load(file)["results"]
+    return [perf_record("ze_nano", entry["api"], entry["metric"], entry["unit"], entry["value"],
+                        [("variant", entry["variant"])])
+            for entry in entries]
+
+def parse_perf_results(tool: str, file_name: str):
+    if tool == "ze_peak":
+        return parse_ze_peak_results(file_name)
+    elif tool == "ze_peer":
+        return parse_ze_peer_results(file_name)
+    elif tool == "ze_nano":
+        return parse_ze_nano_results(file_name)
+    elif tool in perf_result_tools:
+        return parse_result_report(file_name)
+    raise ValueError("no result parser for " + tool + ", expected one of " + ",".join(perf_result_tools))
+
+#
+# The history of the results is one CSV file with a row per record and run,
+# appended to by every run
+#
+perf_history_fields = ["run", "tool", "test", "metric", "unit", "parameters", "value"]
+
+def append_perf_history(history_file: str, run: str, records: list):
+    new_file = not os.path.exists(history_file) or os.path.getsize(history_file) == 0
+    with open(history_file, 'a', newline='') as file:
+        writer = csv.DictWriter(file, fieldnames = perf_history_fields)
+        if new_file:
+            writer.writeheader()
+        for record in records:
+            writer.writerow(dict(record, run = run))
+
+def read_perf_history(history_file: str):
+    if not os.path.exists(history_file):
+        return []
+    with open(history_file, newline='') as file:
+        return [dict(row, value = float(row["value"])) for row in csv.DictReader(file)]
+
+#
+# Compares the last run of every measurement in the history against the
+# median of up to window runs before it. A measurement regresses when it is
+# worse by more than threshold_percent: higher for times and counts, lower
+# for all other units. Writes one row per measurement to report_file and
+# returns the number of regressions.
+#
+def generate_perf_trend_report(history: list, report_file: str, window: int = 5, threshold_percent: float = 5.0):
+    runs = []
+    series = {}
+    for row in history:
+        if row["run"] not in runs:
+            runs.append(row["run"])
+        key = (row["tool"], row["test"], row["metric"], row["unit"], row["parameters"])
+        series.setdefault(key, {})[row["run"]] = row["value"]
+    last_run = runs[-1] if runs else None
+
+    rows = []
+    regressions = 0
+    for key, values in series.items():
+        if last_run not in values:
+            continue
+        previous = [values[run] for run in runs[:-1] if run in values][-window:]
+        latest = values[last_run]
+        baseline = statistics.median(previous) if previous else None
+        status = "NEW"
+        change = None
+        if baseline:
+            change = (latest - baseline) / baseline * 100.0
+            loss = change if key[3] in perf_lower_is_better_units else -change
+            if loss > threshold_percent:
+                status = "REGRESSION"
+                regressions += 1
+            elif loss < -threshold_percent:
+                status = "IMPROVEMENT"
+            else:
+                status = "OK"
+        rows.append(key + (len(previous) + 1,
+                           "" if baseline is None else "{:.6g}".format(baseline),
+                           "{:.6g}".format(latest),
+                           "" if change is None else "{:+.2f}".format(change),
+                           status))
+
+    with open(report_file, 'w', newline='') as file:
+        writer = csv.writer(file)
+        writer.writerow(("Tool", "Test", "Metric", "Unit", "Parameters", "Runs", "Baseline", "Latest", "Change %", "Status"))
+        writer.writerows(sorted(rows, key = lambda row: (row[9] != "REGRESSION", row[:5])))
+    return regressions
@@ -12,6 +12,11 @@ import re
 import sys
 import csv
 import signal
+import tempfile
+import threading
+import queue
+import time
+import heapq
 import level_zero_report_utils
 
 test_plan_generated = []
@@ -107,91 +112,200 @@ def add_to_test_list(test_name: str,
     if checks_passed == True:
         test_plan_generated.append((test_name, test_filter, os.path.basename(binary_and_path), test_feature_tag, test_section, test_feature))
 
-def run_test_plan(test_plan: [], test_run_timeout: int, fail_log_name: str):
-    results = []
-    i = 0
-    failed = 0
-    unsupported = 0
-    num_passed = 0
-    num_failed = 0
-    num_skipped = 0
-    fail_log = open(fail_log_name, 'a')
-    for i in range(len(test_plan)):
-        stdout_log = "_stdout.log"
-        stderr_log = "_stderr.log"
-        fout = open(stdout_log, 'a+')
-        ferr = open(stderr_log, 'a+')
-        binary_prefix_path = os.path.join(binary_cwd, '')
-        test_run = subprocess.Popen([binary_prefix_path + test_plan[i][2], test_plan[i][1]], stdout=fout, stderr=ferr, start_new_session=True, cwd=binary_cwd)
+#
+# Runs one item of the test plan, with ZE_AFFINITY_MASK set to the given mask
+# unless it is None, and returns its status, the output of the binary and the
+# time it ran for in seconds
+#
+def run_test_item(test_item: (), test_run_timeout: int, affinity_mask: str):
+    env = os.environ.copy()
+    if affinity_mask is not None:
+        env["ZE_AFFINITY_MASK"] = affinity_mask
+    binary_prefix_path = os.path.join(binary_cwd, '')
+    start = time.monotonic()
+    with tempfile.TemporaryFile('w+') as fout, tempfile.TemporaryFile('w+') as ferr:
+        test_run = subprocess.Popen([binary_prefix_path + test_item[2], test_item[1]], stdout=fout, stderr=ferr, start_new_session=True, cwd=binary_cwd, env=env)
         try:
-            failed = 0
-            unsupported = 0
             test_run.wait(timeout=test_run_timeout)
-            fout.close()
-            ferr.close()
-            fout = open(stdout_log, 'r')
-            ferr = open(stderr_log, 'r')
-            output = ferr.readlines() + fout.readlines()
-            for line in output:
-                if re.search("ZE_RESULT_ERROR_UNSUPPORTED*", line, re.IGNORECASE):
-                    unsupported = 1
-                    break
-                elif re.search("FAILED", line):
-                    failed = 1
-                    break
-
-            if not unsupported:
-                if test_run.returncode:
-                    failed = 1
-
-            if failed == 1:
-                result = (test_plan[i][0], test_plan[i][4], test_plan[i][3], 'FAILED')
-                results.append(result)
-                num_failed += 1
-                fail_log.write(test_plan[i][0] + ' FAILED' + "\n")
-                for line in output:
-                    fail_log.write(line + "\n")
-            elif unsupported == 1:
-                result = (test_plan[i][0], test_plan[i][4], test_plan[i][3], 'UNSUPPORTED')
-                results.append(result)
-                num_skipped += 1
-                fail_log.write(test_plan[i][0] + ' UNSUPPORTED' + "\n")
-                for line in output:
-                    fail_log.write(line + "\n")
-            else:
-                result = (test_plan[i][0], test_plan[i][4], test_plan[i][3], 'PASSED')
-                results.append(result)
-                num_passed += 1
-            i += 1
-            print("-", end = '')
-            sys.stdout.flush()
+            timed_out = False
         except subprocess.TimeoutExpired:
-            fout.close()
-            ferr.close()
-            fout = open(stdout_log, 'r')
-            ferr = open(stderr_log, 'r')
-
-            result = (test_plan[i][0], test_plan[i][4], test_plan[i][3], 'TIMEOUT')
-            results.append(result)
-            num_failed += 1
-            output = ferr.readlines() + fout.readlines()
-            fail_log.write(test_plan[i][0] + ' TIMEOUT' + "\n")
-            if output:
+            timed_out = True
+            os.killpg(os.getpgid(test_run.pid), signal.SIGTERM)
+            try:
+                test_run.wait(timeout=30)
+            except subprocess.TimeoutExpired:
+                os.killpg(os.getpgid(test_run.pid), signal.SIGKILL)
+                test_run.wait()
+        fout.seek(0)
+        ferr.seek(0)
+        output = ferr.readlines() + fout.readlines()
+    duration = time.monotonic() - start
+
+    if timed_out:
+        return 'TIMEOUT', output, duration
+
+    failed = 0
+    unsupported = 0
+    for line in output:
+        if re.search("ZE_RESULT_ERROR_UNSUPPORTED*", line, re.IGNORECASE):
+            unsupported = 1
+            break
+        elif re.search("FAILED", line):
+            failed = 1
+            break
+
+    if not unsupported:
+        if test_run.returncode:
+            failed = 1
+
+    if failed == 1:
+        return 'FAILED', output, duration
+    elif unsupported == 1:
+        return 'UNSUPPORTED', output, duration
+    return 'PASSED', output, duration
+
+#
+# The seventh column of a test plan item is its duration in seconds in a
+# previous run, missing or empty when not known
+#
+def get_test_item_duration(test_item: ()):
+    if len(test_item) > 6 and test_item[6]:
+        try:
+            return float(test_item[6])
+        except ValueError:
+            return None
+    return None
+
+def set_test_item_duration(test_item: (), duration: float):
+    return tuple(test_item[:6]) + ("{:.3f}".format(duration),)
+
+#
+# Copies the durations of the items of a previous plan to the items of the
+# test plan that run the same binary and filter
+#
+def apply_test_plan_durations(test_plan: [], durations_plan: []):
+    durations = {}
+    for test_item in durations_plan:
+        duration = get_test_item_duration(test_item)
+        if duration is not None:
+            durations[(test_item[2], test_item[1])] = duration
+    return [set_test_item_duration(test_item, durations[(test_item[2], test_item[1])])
+            if (test_item[2], test_item[1]) in durations else test_item
+            for test_item in test_plan]
+
+#
+# Durations used for scheduling: items without one are expected to take the
+# average of the others
+#
+def estimate_test_item_durations(test_plan: []):
+    durations = [get_test_item_duration(test_item) for test_item in test_plan]
+    known = [duration for duration in durations if duration is not None]
+    default = sum(known) / len(known) if known else 1.0
+    return [duration if duration is not None else default for duration in durations]
+
+#
+# Splits the test plan into shards of about the same total duration, by
+# giving each item, longest first, to the shard with the least work so far.
+# Each shard keeps the plan order.
+#
+def shard_test_plan(test_plan: [], shard_count: int):
+    estimates = estimate_test_item_durations(test_plan)
+    shards = [[] for _ in range(shard_count)]
+    loads = [(0.0, shard) for shard in range(shard_count)]
+    for index in sorted(range(len(test_plan)), key = lambda index: estimates[index], reverse = True):
+        load, shard = heapq.heappop(loads)
+        shards[shard].append(index)
+        heapq.heappush(loads, (load + estimates[index], shard))
+    return [[test_plan[index] for index in sorted(shard)] for shard in shards], sorted(loads, key = lambda load: load[1])
+
+#
+# Returns the ZE_AFFINITY_MASK values of the parallel workers: "auto" is one
+# per GPU render node, otherwise a comma separated list of masks such as
+# "0,1" for devices or "0.0,0.1,1.0,1.1" for tiles
+#
+def get_worker_affinity_masks(parallel_devices: str, workers_per_device: int):
+    if not parallel_devices:
+        return []
+    if parallel_devices == "auto":
+        device_count = len(glob.glob("/dev/dri/renderD*"))
+        masks = [str(device) for device in range(device_count)]
+    else:
+        masks = [mask.strip() for mask in parallel_devices.split(',') if mask.strip()]
+    return [mask for mask in masks for _ in range(max(1, workers_per_device))]
+
+#
+# Items that need several devices, or change the state of the whole device,
+# run alone and without an affinity mask after the parallel ones
+#
+def is_serial_test_item(test_item: (), serial_features: str, serial_regex: str):
+    if serial_features:
+        for feature in serial_features.split(','):
+            if feature.strip() and len(test_item) > 5 and re.search(re.escape(feature.strip()), test_item[5], re.IGNORECASE):
+                return True
+    if serial_regex:
+        if re.search(serial_regex, test_item[0]) or re.search(serial_regex, test_item[1]):
+            return True
+    return False
+
+def run_test_plan(test_plan: [], test_run_timeout: int, fail_log_name: str,
+                  affinity_masks: [] = None, serial_features: str = None, serial_regex: str = None):
+    statuses = [None] * len(test_plan)
+    durations = [None] * len(test_plan)
+    fail_log = open(fail_log_name, 'a')
+    lock = threading.Lock()
+
+    def run_item(index: int, affinity_mask: str):
+        status, output, duration = run_test_item(test_plan[index], test_run_timeout, affinity_mask)
+        with lock:
+            statuses[index] = status
+            durations[index] = duration
+            if status != 'PASSED':
+                fail_log.write(test_plan[index][0] + ' ' + status + "\n")
                 for line in output:
                     fail_log.write(line + "\n")
-            os.killpg(os.getpgid(test_run.pid), signal.SIGTERM)
-            fout.close()
-            ferr.close()
-            i += 1
-            print("T", end = '')
+            print("T" if status == 'TIMEOUT' else "-", end = '')
             sys.stdout.flush()
 
-        fout.close()
-        ferr.close()
-        os.remove(stdout_log)
-        os.remove(stderr_log)
+    serial_items = list(range(len(test_plan)))
+    if affinity_masks:
+        # Longest first, so that the last items to finish are short ones
+        estimates = estimate_test_item_durations(test_plan)
+        parallel_items = queue.Queue()
+        serial_items = []
+        for index in sorted(range(len(test_plan)), key = lambda index: estimates[index], reverse = True):
+            if is_serial_test_item(test_plan[index], serial_features, serial_regex):
+                serial_items.append(index)
+            else:
+                parallel_items.put(index)
+        serial_items.sort()
+
+        def worker(affinity_mask: str):
+            while True:
+                try:
+                    index = parallel_items.get_nowait()
+                except queue.Empty:
+                    return
+                run_item(index, affinity_mask)
+
+        workers = [threading.Thread(target = worker, args = (mask,)) for mask in affinity_masks]
+        for thread in workers:
+            thread.start()
+        for thread in workers:
+            thread.join()
+
+    for index in serial_items:
+        run_item(index, None)
     fail_log.close()
-    return results, num_passed, num_failed, num_skipped
+
+    # The results are reported in the order of the plan, however they ran
+    results = []
+    for index in range(len(test_plan)):
+        results.append((test_plan[index][0], test_plan[index][4], test_plan[index][3], statuses[index]))
+    num_passed = statuses.count('PASSED')
+    num_failed = statuses.count('FAILED') + statuses.count('TIMEOUT')
+    num_skipped = statuses.count('UNSUPPORTED')
+    timed_plan = [set_test_item_duration(test_plan[index], durations[index]) for index in range(len(test_plan))]
+    return results, num_passed, num_failed, num_skipped, timed_plan
 
 def write_test_plan(test_plan: [], plan_name: str):
     testplan_filename = plan_name + ".csv"
@@ -218,15 +332,19 @@ def read_test_plan(plan_name: str):
 
     return test_plan
 
-def run_test_report(test_plan: [], test_run_timeout: int, log_prefix: str):
+def run_test_report(test_plan: [], test_run_timeout: int, log_prefix: str,
+                    affinity_masks: [] = None, serial_features: str = None, serial_regex: str = None):
     report_log_name = log_prefix + "_results.csv"
     fail_log_name = log_prefix + "_failure_log.txt"
+    timed_plan_name = log_prefix + "_test_plan"
     fail_log = open(fail_log_name, 'w')
     fail_log.close()
 
     print("Running:", end = '')
     print(len(test_plan), end = '')
     print(" Tests")
+    if affinity_masks:
+        print("Parallel workers with ZE_AFFINITY_MASK: " + ",".join(affinity_masks))
 
     num_passed = 0
     num_failed = 0
@@ -237,11 +355,13 @@ def run_test_report(test_plan: [], test_run_timeout: int, log_prefix: str):
     print("<", end = '')
     sys.stdout.flush()
 
-    data = run_test_plan(test_plan, test_run_timeout, fail_log_name)
+    data = run_test_plan(test_plan, test_run_timeout, fail_log_name,
+                         affinity_masks, serial_features, serial_regex)
     results += data[0]
     num_passed += data[1]
     num_failed += data[2]
     num_skipped += data[3]
+    write_test_plan(test_plan = data[4], plan_name = timed_plan_name)
 
     print(">\n")
     print("Generating Test Report\n")
@@ -260,6 +380,7 @@ def run_test_report(test_plan: [], test_run_timeout: int, log_prefix: str):
         writer.writerows(results)
 
     print("Completed Test Report, see results in " + report_log_name + "\n")
+    print("Test Plan with the durations of this run written to " + timed_plan_name + ".csv\n")
     print("Overall Results| Total Tests: ", end = '')
     print(total_tests, end = '')
     print("\n\t Passed Tests: ", end = '')
@@ -279,6 +400,35 @@ def run_test_report(test_plan: [], test_run_timeout: int, log_prefix: str):
     else:
         return 0
 
+#
+# Reads the result files of the perf tools, each given as <tool>:<file>, adds
+# them to the history as one run, and writes the trend of every measurement
+# against the runs before it to <prefix>_perf_trend.csv
+#
+def run_perf_report(perf_results: [], history_file: str, log_prefix: str, window: int, threshold_percent: float):
+    trend_report_name = log_prefix + "_perf_trend.csv"
+    records = []
+    for perf_result in perf_results:
+        tool, separator, file_name = perf_result.partition(':')
+        if not separator:
+            print("Performance results must be given as <tool>:<file>, not " + perf_result)
+            return -1
+        try:
+            records += level_zero_report_utils.parse_perf_results(tool, file_name)
+        except (OSError, ValueError, KeyError) as e:
+            print("Could not read performance results " + file_name + ": " + str(e))
+            return -1
+
+    run = time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime())
+    level_zero_report_utils.append_perf_history(history_file, run, records)
+    history = level_zero_report_utils.read_perf_history(history_file)
+    regressions = level_zero_report_utils.generate_perf_trend_report(history, trend_report_name, window, threshold_percent)
+
+    print("Performance Results| Measurements: " + str(len(records)) + ", added to history " + history_file)
+    print("\t Regressions beyond " + str(threshold_percent) + "%: " + str(regressions))
+    print("Completed Performance Trend Report, see results in " + trend_report_name + "\n")
+    return -1 if regressions > 0 else 0
+
 def create_test_name(suite_name: str, test_binary: str, line: str):
         test_section = "None"
         updated_suite_name = suite_name.split('/')  # e.g., 'GivenXWhenYThenZ'
@@ -364,7 +514,8 @@ if __name__ == '__main__':
             --exclude_features \"image\"
             --exclude_regex \"events*\"
             --test_run_timeout 1200
-            --log_prefix \"level_zero_tests_1234\"\n""", formatter_class=RawTextHelpFormatter)
+            --log_prefix \"level_zero_tests_1234\"
+            --parallel_devices \"0,1\"\n""", formatter_class=RawTextHelpFormatter)
     parser.add_argument('--binary_dir', type = IsListableDirPath, help = 'Directory containing gtest binaries and SPVs.', required = True)
     parser.add_argument('--run_test_sections', type = str, help = 'List of Sections of Tests to include Comma Separated: core,tools,negative,stress,all NOTE:all sets all types', default = "core")
     parser.add_argument('--run_test_features', type = str, help = 'List of Test Features to include Comma Separated: Sets of Features (basic, advanced, discrete), individual features ie barrier,...', default = None)
@@ -375,6 +526,17 @@ if __name__ == '__main__':
     parser.add_argument('--log_prefix', type = str, help = 'Change the prefix name for the results such that the output is <prefix>_results.csv & <prefix>_failure_log.txt', default = "level_zero_tests")
     parser.add_argument('--export_test_plan', type = str, help = 'Name of the Generated Test Plan to export as <arg>.csv without execution. The name provided is combined with .csv appended.', default = None)
     parser.add_argument('--import_test_plan', type = str, help = 'Name of the Imported Test Plan as <arg>.csv for execution. The name provided is combined with .csv appended.', default = None)
+    parser.add_argument('--parallel_devices', type = str, help = 'Run the test plan in parallel, one worker per ZE_AFFINITY_MASK value Comma Separated: 0,1 for devices or 0.0,0.1 for tiles, or auto for one worker per GPU', default = None)
+    parser.add_argument('--workers_per_device', type = int, help = 'Number of parallel workers sharing each ZE_AFFINITY_MASK value of --parallel_devices', default = 1)
+    parser.add_argument('--serial_features', type = str, help = 'List of Test Features Comma Separated which run alone on all devices after the parallel tests', default = "Peer-To-Peer,SysMan Device Reset")
+    parser.add_argument('--serial_regex', type = str, help = 'Regular Expression of tests, matching either in the name or filter, which run alone on all devices after the parallel tests', default = None)
+    parser.add_argument('--durations_plan', type = str, help = 'Name of a Test Plan <arg>.csv with durations from a previous run, such as <log_prefix>_test_plan.csv, used to schedule the longest tests first and to balance shards', default = None)
+    parser.add_argument('--shard_count', type = int, help = 'Split the Test Plan into this many shards of about equal duration. With --export_test_plan each shard is exported as <arg>_<index>.csv, otherwise --shard_index selects the shard to run', default = None)
+    parser.add_argument('--shard_index', type = int, help = 'Index of the shard of --shard_count to run, from 0', default = None)
+    parser.add_argument('--perf_results', type = str, action = 'append', help = 'Result file of a perf tool to add to the performance history as <tool>:<file>, repeatable. Tools: ' + ','.join(level_zero_report_utils.perf_result_tools), default = None)
+    parser.add_argument('--perf_history', type = str, help = 'CSV file keeping the performance results of every run, default <log_prefix>_perf_history.csv', default = None)
+    parser.add_argument('--perf_trend_window', type = int, help = 'Number of previous runs whose median each performance result is compared to', default = 5)
+    parser.add_argument('--perf_regression_threshold', type = float, help = 'Percentage by which a performance result must be worse than the median of the previous runs to be flagged as a regression', default = 5.0)
     args = parser.parse_args()
 
     run_test_sections = args.run_test_sections
@@ -391,6 +553,7 @@ if __name__ == '__main__':
     exit_code = -1
     export_test_plan = args.export_test_plan
     import_test_plan = args.import_test_plan
+    affinity_masks = get_worker_affinity_masks(args.parallel_devices, args.workers_per_device)
 
     print("Level Zero Test Report Generator\n")
 
@@ -420,13 +583,41 @@ if __name__ == '__main__':
         )
         print("Generated Test List\n")
 
+    if len(test_plan_generated) > 0 and args.durations_plan:
+        print("Applying durations of Test plan: " + args.durations_plan)
+        test_plan_generated = apply_test_plan_durations(test_plan_generated, read_test_plan(plan_name = args.durations_plan))
+
+    test_plan_shards = None
+    if len(test_plan_generated) > 0 and args.shard_count:
+        test_plan_shards, shard_loads = shard_test_plan(test_plan_generated, args.shard_count)
+        for load, shard in shard_loads:
+            print("Shard " + str(shard) + ": " + str(len(test_plan_shards[shard])) + " tests, about " + "{:.1f}".format(load) + " s")
+        if not export_test_plan:
+            if args.shard_index is None or args.shard_index < 0 or args.shard_index >= args.shard_count:
+                print("--shard_index must select one of the " + str(args.shard_count) + " shards")
+                sys.exit()
+            test_plan_generated = test_plan_shards[args.shard_index]
+
     if len(test_plan_generated) > 0:
-        if export_test_plan:
+        if export_test_plan and test_plan_shards:
+            print("Generated Test plan Being Exported to CSV in " + str(args.shard_count) + " shards.\n")
+            for shard in range(args.shard_count):
+                exit_code = write_test_plan(test_plan = test_plan_shards[shard], plan_name = export_test_plan + "_" + str(shard))
+            print("Generated Test plan shards: " + export_test_plan + "_<index>")
+        elif export_test_plan:
             print("Generated Test plan Being Exported to CSV.\n")
             exit_code = write_test_plan(test_plan = test_plan_generated, plan_name = export_test_plan)
             print("Generated Test plan: " + export_test_plan)
         else:
-            exit_code = run_test_report(test_plan = test_plan_generated, test_run_timeout = test_run_timeout, log_prefix = log_prefix)
+            exit_code = run_test_report(test_plan = test_plan_generated, test_run_timeout = test_run_timeout, log_prefix = log_prefix,
+                                        affinity_masks = affinity_masks, serial_features = args.serial_features, serial_regex = args.serial_regex)
     else:
         print("Test Filters set are invalid or test plan imported is invalid, no tests that match all requirements.")
+
+    if args.perf_results:
+        perf_history = args.perf_history if args.perf_history else log_prefix + "_perf_history.csv"
+        perf_exit_code = run_perf_report(perf_results = args.perf_results, history_file = perf_history, log_prefix = log_prefix,
+                                         window = args.perf_trend_window, threshold_percent = args.perf_regression_threshold)
+        if not exit_code:
+            exit_code = perf_exit_code
     exit(exit_code)
@@ -0,0 +1,30 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _STRESS_SOAK_HPP_
+#define _STRESS_SOAK_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Soak mode repeats the selected tests (--gtest_filter) until the time given
+// with --duration=<time> has passed, where time is a number of minutes or a
+// number followed by s, m or h.  Throughput of every test is recorded per
+// minute and reported at the end, and with --soak_report=<file> also
+// written as CSV, so that decay over a long run is visible.
+//
+// Returns whether soak mode was requested, removing the soak options from
+// command_line.  Called after gtest and logging are initialized.
+bool init_soak_mode(std::vector<std::string> &command_line);
+
+// Adds count operations to the throughput of the running test.  A test that
+// never records operations counts as one operation per run.
+void record_soak_operations(uint64_t count);
+
+#endif /* _STRESS_SOAK_HPP_*/
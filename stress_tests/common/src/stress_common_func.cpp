@@ -12,6 +12,7 @@ namespace lzt = level_zero_tests;
 
 #if defined(unix) || defined(__unix__) || defined(__unix)
 
+#include <fstream>
 #include <unistd.h>
 
 uint64_t total_available_host_memory() {
@@ -26,6 +27,13 @@ uint64_t get_page_size() {
   const long page_size = sysconf(_SC_PAGE_SIZE);
   return page_size;
 }
+
+uint64_t process_resident_memory() {
+  uint64_t total_pages = 0, resident_pages = 0;
+  std::ifstream statm("/proc/self/statm");
+  statm >> total_pages >> resident_pages;
+  return resident_pages * get_page_size();
+}
 #endif
 
 #if defined(_WIN64) || defined(_WIN64) || defined(_WIN32)
@@ -35,6 +43,7 @@ uint64_t get_page_size() {
 #endif
 #include <windows.h>
 #include <Sysinfoapi.h>
+#include <psapi.h>
 
 uint64_t total_available_host_memory() {
   MEMORYSTATUSEX stat;
@@ -49,6 +58,11 @@ uint64_t get_page_size() {
   const long page_size = si.dwPageSize;
   return page_size;
 }
+uint64_t process_resident_memory() {
+  PROCESS_MEMORY_COUNTERS counters;
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return counters.WorkingSetSize;
+}
 
 #endif
 
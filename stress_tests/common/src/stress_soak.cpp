@@ -0,0 +1,235 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "stress_soak.hpp"
+#include "gtest/gtest.h"
+#include "logging/logging.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+typedef std::chrono::steady_clock soak_clock;
+
+std::atomic<uint64_t> soak_operations{0};
+std::atomic<bool> soak_operations_recorded{false};
+
+struct MinuteSample {
+  uint64_t runs = 0;
+  uint64_t operations = 0;
+  double busy_seconds = 0;
+
+  double rate() const {
+    return (busy_seconds > 0) ? operations / busy_seconds : 0;
+  }
+};
+
+struct TestSamples {
+  uint64_t runs = 0;
+  uint64_t failures = 0;
+  std::vector<MinuteSample> minutes;
+};
+
+// Repeats the tests with gtest_repeat until the duration has passed.  The
+// check is made when an iteration starts, after every listener has seen the
+// end of the previous one, so the XML output of the last iteration is
+// complete when the run stops.
+class SoakListener : public ::testing::EmptyTestEventListener {
+public:
+  SoakListener(std::chrono::seconds duration, const std::string &report)
+      : duration_(duration), report_(report), start_(soak_clock::now()) {}
+
+  void OnTestIterationStart(const ::testing::UnitTest &unit_test,
+                            int iteration) override {
+    if (iteration > 0 && soak_clock::now() - start_ >= duration_) {
+      finish();
+    }
+  }
+
+  void OnTestStart(const ::testing::TestInfo &test_info) override {
+    soak_operations = 0;
+    soak_operations_recorded = false;
+    test_start_ = soak_clock::now();
+  }
+
+  void OnTestEnd(const ::testing::TestInfo &test_info) override {
+    const auto now = soak_clock::now();
+    const size_t minute = static_cast<size_t>(
+        std::chrono::duration_cast<std::chrono::minutes>(now - start_)
+            .count());
+    if (minute != current_minute_) {
+      log_minute();
+      current_minute_ = minute;
+    }
+
+    auto &samples = tests_[std::string(test_info.test_case_name()) + "." +
+                           test_info.name()];
+    samples.runs++;
+    if (test_info.result()->Failed()) {
+      samples.failures++;
+      minute_failures_++;
+    }
+    if (samples.minutes.size() <= minute) {
+      samples.minutes.resize(minute + 1);
+    }
+    auto &sample = samples.minutes[minute];
+    sample.runs++;
+    sample.operations += soak_operations_recorded ? soak_operations.load() : 1;
+    sample.busy_seconds +=
+        std::chrono::duration<double>(now - test_start_).count();
+    minute_runs_++;
+  }
+
+  void OnTestIterationEnd(const ::testing::UnitTest &unit_test,
+                          int iteration) override {
+    iterations_++;
+    if (unit_test.Failed()) {
+      failed_iterations_++;
+    }
+  }
+
+private:
+  void log_minute() {
+    if (minute_runs_ != 0) {
+      LOG_INFO << "Soak minute " << current_minute_ + 1 << ": "
+               << minute_runs_ << " test runs, " << minute_failures_
+               << " failed";
+    }
+    minute_runs_ = 0;
+    minute_failures_ = 0;
+  }
+
+  void finish() {
+    log_minute();
+    LOG_INFO << "Soak finished after " << iterations_ << " iterations, "
+             << failed_iterations_ << " with failures";
+    for (auto &test : tests_) {
+      double first = 0, last = 0, lowest = 0;
+      bool found = false;
+      for (auto &sample : test.second.minutes) {
+        if (sample.runs == 0) {
+          continue;
+        }
+        if (!found || sample.rate() < lowest) {
+          lowest = sample.rate();
+        }
+        if (!found) {
+          first = sample.rate();
+        }
+        last = sample.rate();
+        found = true;
+      }
+      LOG_INFO << test.first << ": " << test.second.runs << " runs, "
+               << test.second.failures << " failed, operations/s first "
+               << first << " last " << last << " lowest " << lowest;
+      if (first > 0 && last < first * 0.9) {
+        LOG_WARNING << test.first << ": throughput dropped by "
+                    << 100 * (first - last) / first << "% during the soak";
+      }
+    }
+    write_report();
+    std::exit(failed_iterations_ ? 1 : 0);
+  }
+
+  void write_report() {
+    if (report_.empty()) {
+      return;
+    }
+    std::ofstream file(report_);
+    file << "test,minute,runs,operations,busy_seconds,operations_per_second\n";
+    for (auto &test : tests_) {
+      for (size_t i = 0; i < test.second.minutes.size(); i++) {
+        auto &sample = test.second.minutes[i];
+        if (sample.runs == 0) {
+          continue;
+        }
+        file << test.first << "," << i + 1 << "," << sample.runs << ","
+             << sample.operations << "," << sample.busy_seconds << ","
+             << sample.rate() << "\n";
+      }
+    }
+    if (!file.good()) {
+      LOG_ERROR << "Cannot write soak report " << report_;
+    }
+  }
+
+  const std::chrono::seconds duration_;
+  const std::string report_;
+  const soak_clock::time_point start_;
+  soak_clock::time_point test_start_;
+  std::map<std::string, TestSamples> tests_;
+  size_t current_minute_ = 0;
+  uint64_t minute_runs_ = 0;
+  uint64_t minute_failures_ = 0;
+  uint64_t iterations_ = 0;
+  uint64_t failed_iterations_ = 0;
+};
+
+std::chrono::seconds parse_duration(const std::string &value) {
+  size_t end = 0;
+  double amount = 0;
+  try {
+    amount = std::stod(value, &end);
+  } catch (const std::exception &) {
+    end = 0;
+  }
+  const std::string unit = value.substr(end);
+  double seconds_per_unit = 0;
+  if (unit.empty() || unit == "m") {
+    seconds_per_unit = 60;
+  } else if (unit == "s") {
+    seconds_per_unit = 1;
+  } else if (unit == "h") {
+    seconds_per_unit = 3600;
+  }
+  if (end == 0 || seconds_per_unit == 0 || amount <= 0) {
+    throw std::runtime_error("Invalid soak duration: " + value);
+  }
+  return std::chrono::seconds(
+      static_cast<std::chrono::seconds::rep>(amount * seconds_per_unit));
+}
+
+} // namespace
+
+bool init_soak_mode(std::vector<std::string> &command_line) {
+  const std::string duration_option = "--duration=";
+  const std::string report_option = "--soak_report=";
+  std::string duration, report;
+  std::vector<std::string> remaining;
+  for (auto &arg : command_line) {
+    if (arg.compare(0, duration_option.size(), duration_option) == 0) {
+      duration = arg.substr(duration_option.size());
+    } else if (arg.compare(0, report_option.size(), report_option) == 0) {
+      report = arg.substr(report_option.size());
+    } else {
+      remaining.push_back(arg);
+    }
+  }
+  command_line = remaining;
+  if (duration.empty()) {
+    return false;
+  }
+
+  const auto soak_duration = parse_duration(duration);
+  LOG_INFO << "Soak mode: repeating the tests for " << soak_duration.count()
+           << " s";
+  ::testing::GTEST_FLAG(repeat) = -1;
+  ::testing::UnitTest::GetInstance()->listeners().Append(
+      new SoakListener(soak_duration, report));
+  return true;
+}
+
+void record_soak_operations(uint64_t count) {
+  soak_operations += count;
+  soak_operations_recorded = true;
+}
@@ -0,0 +1,53 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#pragma OPENCL EXTENSION cl_khr_int64_extended_atomics : enable
+
+// Every work item adds one to the address picked by mask, iterations
+// times, so the values of the buffer add up to global size * iterations
+
+kernel void atomic_throughput_ulong_device(global atomic_ulong *buffer,
+                                           uint mask, uint iterations) {
+  global atomic_ulong *address = buffer + ((uint)get_global_id(0) & mask);
+  for (uint i = 0; i < iterations; i++)
+    atomic_fetch_add_explicit(address, 1ul, memory_order_relaxed,
+                              memory_scope_device);
+}
+
+kernel void atomic_throughput_ulong_system(global atomic_ulong *buffer,
+                                           uint mask, uint iterations) {
+  global atomic_ulong *address = buffer + ((uint)get_global_id(0) & mask);
+  for (uint i = 0; i < iterations; i++)
+    atomic_fetch_add_explicit(address, 1ul, memory_order_relaxed,
+                              memory_scope_all_svm_devices);
+}
+
+// The atomics go to local memory, which is added to the first mask + 1
+// values of the buffer at the end
+__attribute__((reqd_work_group_size(256, 1, 1))) kernel void
+atomic_throughput_ulong_work_group(global atomic_ulong *buffer, uint mask,
+                                 uint iterations) {
+  local atomic_ulong scratch[256];
+  const uint lid = get_local_id(0);
+  atomic_init(scratch + lid, 0);
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  local atomic_ulong *address = scratch + (lid & mask);
+  for (uint i = 0; i < iterations; i++)
+    atomic_fetch_add_explicit(address, 1ul, memory_order_relaxed,
+                              memory_scope_work_group);
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+  if (lid <= mask)
+    atomic_fetch_add_explicit(buffer + lid,
+                              atomic_load_explicit(scratch + lid,
+                                                   memory_order_relaxed,
+                                                   memory_scope_work_group),
+                              memory_order_relaxed, memory_scope_device);
+}
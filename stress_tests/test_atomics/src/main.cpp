@@ -9,11 +9,13 @@
 #include "gmock/gmock.h"
 #include "logging/logging.hpp"
 #include "utils/utils.hpp"
+#include "stress_soak.hpp"
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleMock(&argc, argv);
   std::vector<std::string> command_line(argv + 1, argv + argc);
   level_zero_tests::init_logging(command_line);
+  init_soak_mode(command_line);
 
   ze_result_t result = zeInit(0);
   if (result) {
@@ -13,6 +13,7 @@
 #include "test_harness/test_harness.hpp"
 #include "logging/logging.hpp"
 #include "stress_common_func.hpp"
+#include "stress_soak.hpp"
 
 namespace lzt = level_zero_tests;
 
@@ -177,6 +178,7 @@ TEST_P(zeDriverAtomicsStressTest, RunAtomicWithMemoryLimit) {
     }
   }
 
+  record_soak_operations(test_single_allocation_count);
   EXPECT_EQ(false, test_failure);
 } // namespace
 
@@ -0,0 +1,285 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_common_func.hpp"
+#include "stress_soak.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+enum class AtomicType { UINT32, UINT64, FLOAT32, FLOAT64 };
+enum class AtomicScope { WORK_GROUP, DEVICE, SYSTEM };
+
+std::string to_string(AtomicType type) {
+  switch (type) {
+  case AtomicType::UINT32:
+    return "uint";
+  case AtomicType::UINT64:
+    return "ulong";
+  case AtomicType::FLOAT32:
+    return "float";
+  default:
+    return "double";
+  }
+}
+
+std::string to_string(AtomicScope scope) {
+  switch (scope) {
+  case AtomicScope::WORK_GROUP:
+    return "work_group";
+  case AtomicScope::DEVICE:
+    return "device";
+  default:
+    return "system";
+  }
+}
+
+size_t type_size(AtomicType type) {
+  return (type == AtomicType::UINT32 || type == AtomicType::FLOAT32) ? 4 : 8;
+}
+
+// Sum of the values in the buffer, which is exact for the float types as
+// long as no value exceeds 2^24
+double buffer_sum(AtomicType type, const std::vector<uint8_t> &buffer,
+                  uint32_t count) {
+  double sum = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    const uint8_t *value = buffer.data() + i * type_size(type);
+    switch (type) {
+    case AtomicType::UINT32:
+      sum += *reinterpret_cast<const uint32_t *>(value);
+      break;
+    case AtomicType::UINT64:
+      sum += static_cast<double>(*reinterpret_cast<const uint64_t *>(value));
+      break;
+    case AtomicType::FLOAT32:
+      sum += *reinterpret_cast<const float *>(value);
+      break;
+    default:
+      sum += *reinterpret_cast<const double *>(value);
+      break;
+    }
+  }
+  return sum;
+}
+
+// Measures atomic adds per second with every work item adding one to an
+// address of the buffer.  The contention parameter is the number of
+// addresses the work items share, 0 meaning one address per work item.
+class zeDriverAtomicsThroughputStressTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::tuple<AtomicType, AtomicScope, ze_memory_type_t, uint32_t>> {
+protected:
+  bool is_supported(ze_device_handle_t device, AtomicType type,
+                    AtomicScope scope, ze_memory_type_t memory_type) {
+    auto module_properties = lzt::get_device_module_properties(device);
+    auto float_properties =
+        lzt::get_device_module_float_atomic_properties(device);
+    const ze_device_fp_atomic_ext_flags_t add_flag =
+        (scope == AtomicScope::WORK_GROUP)
+            ? ZE_DEVICE_FP_ATOMIC_EXT_FLAG_LOCAL_ADD
+            : ZE_DEVICE_FP_ATOMIC_EXT_FLAG_GLOBAL_ADD;
+    if (type == AtomicType::UINT64 &&
+        !(module_properties.flags & ZE_DEVICE_MODULE_FLAG_INT64_ATOMICS)) {
+      LOG_INFO << "64-bit integer atomics are not supported";
+      return false;
+    }
+    if (type == AtomicType::FLOAT32 &&
+        !(float_properties.fp32Flags & add_flag)) {
+      LOG_INFO << "32-bit float atomic add is not supported";
+      return false;
+    }
+    if (type == AtomicType::FLOAT64 &&
+        (!(module_properties.flags & ZE_DEVICE_MODULE_FLAG_FP64) ||
+         !(float_properties.fp64Flags & add_flag))) {
+      LOG_INFO << "64-bit float atomic add is not supported";
+      return false;
+    }
+
+    auto access_properties = lzt::get_memory_access_properties(device);
+    ze_memory_access_cap_flags_t capabilities =
+        access_properties.deviceAllocCapabilities;
+    if (memory_type == ZE_MEMORY_TYPE_HOST) {
+      capabilities = access_properties.hostAllocCapabilities;
+    } else if (memory_type == ZE_MEMORY_TYPE_SHARED) {
+      capabilities = access_properties.sharedSingleDeviceAllocCapabilities;
+    }
+    if (!(capabilities & ZE_MEMORY_ACCESS_CAP_FLAG_ATOMIC)) {
+      LOG_INFO << print_allocation_type(memory_type)
+               << " memory does not support atomics";
+      return false;
+    }
+
+    auto compute_properties = lzt::get_compute_properties(device);
+    if (compute_properties.maxGroupSizeX < workgroup_size_) {
+      LOG_INFO << "Work group size " << workgroup_size_ << " is not supported";
+      return false;
+    }
+    return true;
+  }
+
+  // Matches the work group size required by the work group scope kernels
+  const uint32_t workgroup_size_ = 256;
+  const uint32_t group_count_ = 1024;
+  // Keeps every float value below 2^24 with a single address
+  const uint32_t iterations_ = 32;
+};
+
+TEST_P(zeDriverAtomicsThroughputStressTest, MeasureAtomicAddThroughput) {
+  const AtomicType type = std::get<0>(GetParam());
+  const AtomicScope scope = std::get<1>(GetParam());
+  const ze_memory_type_t memory_type = std::get<2>(GetParam());
+  const uint32_t contention = std::get<3>(GetParam());
+
+  auto driver = lzt::get_default_driver();
+  auto device = lzt::get_default_device(driver);
+  if (!is_supported(device, type, scope, memory_type)) {
+    GTEST_SKIP();
+  }
+  auto context = lzt::create_context(driver);
+
+  const uint32_t global_size = workgroup_size_ * group_count_;
+  uint32_t address_count = (contention == 0) ? global_size : contention;
+  if (scope == AtomicScope::WORK_GROUP) {
+    address_count = std::min(address_count, workgroup_size_);
+  }
+  const uint32_t mask = address_count - 1;
+  const size_t buffer_size = address_count * type_size(type);
+  const uint64_t operations =
+      static_cast<uint64_t>(global_size) * iterations_;
+
+  uint8_t *buffer = allocate_memory<uint8_t>(context, device, memory_type,
+                                             buffer_size, false);
+  std::vector<uint8_t> data_out(buffer_size, 0xff);
+
+  const std::string module_name =
+      "test_atomics_throughput_" + to_string(type) + ".spv";
+  const std::string kernel_name =
+      "atomic_throughput_" + to_string(type) + "_" + to_string(scope);
+  ze_module_handle_t module_handle = lzt::create_module(
+      context, device, module_name, ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+  ze_kernel_handle_t test_function =
+      lzt::create_function(module_handle, kernel_name);
+  lzt::set_group_size(test_function, workgroup_size_, 1, 1);
+  lzt::set_argument_value(test_function, 0, sizeof(buffer), &buffer);
+  lzt::set_argument_value(test_function, 1, sizeof(mask), &mask);
+  lzt::set_argument_value(test_function, 2, sizeof(iterations_),
+                          &iterations_);
+  ze_group_count_t thread_group_dimensions = {group_count_, 1, 1};
+
+  auto event_pool =
+      lzt::create_event_pool(context, 1,
+                             ZE_EVENT_POOL_FLAG_HOST_VISIBLE |
+                                 ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                ZE_EVENT_SCOPE_FLAG_HOST,
+                                ZE_EVENT_SCOPE_FLAG_HOST};
+  auto event = lzt::create_event(event_pool, event_desc);
+
+  // The first launch warms up the kernel and the memory, only the second
+  // one is timed and checked
+  ze_command_list_handle_t command_list =
+      lzt::create_command_list(context, device, 0);
+  const uint8_t zero = 0;
+  for (int launch = 0; launch < 2; launch++) {
+    lzt::append_memory_fill(command_list, buffer, &zero, sizeof(zero),
+                            buffer_size, nullptr);
+    lzt::append_barrier(command_list, nullptr);
+    lzt::append_launch_function(command_list, test_function,
+                                &thread_group_dimensions,
+                                (launch == 1) ? event : nullptr, 0, nullptr);
+    lzt::append_barrier(command_list, nullptr);
+  }
+  lzt::append_memory_copy(command_list, data_out.data(), buffer, buffer_size,
+                          nullptr);
+  lzt::close_command_list(command_list);
+
+  ze_command_queue_handle_t command_queue = lzt::create_command_queue(
+      context, device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+      ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+  lzt::execute_command_lists(command_queue, 1, &command_list, nullptr);
+  lzt::synchronize(command_queue, UINT64_MAX);
+
+  const auto timestamp = lzt::get_event_kernel_timestamp(event);
+  const double duration_ns =
+      lzt::get_timestamp_clock(device).duration_ns(timestamp.global);
+
+  lzt::destroy_event(event);
+  lzt::destroy_event_pool(event_pool);
+  lzt::destroy_command_queue(command_queue);
+  lzt::destroy_command_list(command_list);
+  lzt::destroy_function(test_function);
+  lzt::destroy_module(module_handle);
+  lzt::free_memory(context, buffer);
+  lzt::destroy_context(context);
+
+  EXPECT_EQ(static_cast<double>(operations),
+            buffer_sum(type, data_out, address_count));
+  EXPECT_GT(duration_ns, 0.0);
+  if (duration_ns > 0) {
+    LOG_INFO << to_string(type) << " " << to_string(scope) << " scope, "
+             << print_allocation_type(memory_type) << " memory, "
+             << address_count << " addresses: "
+             << operations / duration_ns << " G atomic ops/s";
+  }
+  record_soak_operations(operations);
+}
+
+struct ThroughputTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    std::stringstream ss;
+    ss << to_string(std::get<0>(info.param)) << "_"
+       << to_string(std::get<1>(info.param)) << "_"
+       << print_allocation_type(std::get<2>(info.param)) << "_";
+    if (std::get<3>(info.param) == 0) {
+      ss << "disjoint";
+    } else {
+      ss << std::get<3>(info.param) << "_addresses";
+    }
+    return ss.str();
+  }
+};
+
+std::vector<AtomicType> atomic_types = {AtomicType::UINT32, AtomicType::UINT64,
+                                        AtomicType::FLOAT32,
+                                        AtomicType::FLOAT64};
+// From every work item on one address to one address per work item
+std::vector<uint32_t> contention_levels = {1, 16, 256, 4096, 0};
+
+// Local memory atomics, the buffer is only written once per work item
+INSTANTIATE_TEST_CASE_P(
+    TestAtomicsThroughputWorkGroupScope, zeDriverAtomicsThroughputStressTest,
+    ::testing::Combine(::testing::ValuesIn(atomic_types),
+                       ::testing::Values(AtomicScope::WORK_GROUP),
+                       ::testing::Values(ZE_MEMORY_TYPE_DEVICE),
+                       ::testing::Values(1, 16, 0)),
+    ThroughputTestNameSuffix());
+INSTANTIATE_TEST_CASE_P(
+    TestAtomicsThroughputGlobalScopes, zeDriverAtomicsThroughputStressTest,
+    ::testing::Combine(::testing::ValuesIn(atomic_types),
+                       ::testing::Values(AtomicScope::DEVICE,
+                                         AtomicScope::SYSTEM),
+                       ::testing::Values(ZE_MEMORY_TYPE_DEVICE,
+                                         ZE_MEMORY_TYPE_SHARED,
+                                         ZE_MEMORY_TYPE_HOST),
+                       ::testing::ValuesIn(contention_levels)),
+    ThroughputTestNameSuffix());
+
+} // namespace
@@ -13,6 +13,7 @@
 #include "test_harness/test_harness.hpp"
 #include "logging/logging.hpp"
 #include "stress_common_func.hpp"
+#include "stress_soak.hpp"
 namespace lzt = level_zero_tests;
 
 #include <level_zero/ze_api.h>
@@ -310,6 +311,7 @@ TEST_P(
     data_id = 0;
   }
 
+  record_soak_operations(number_of_requested_dispatches);
   EXPECT_EQ(false, memory_test_failure);
 }
 
@@ -0,0 +1,185 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_common_func.hpp"
+#include "stress_soak.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+enum churn_object_t { CHURN_EVENT, CHURN_EVENT_POOL, CHURN_FENCE };
+
+std::string to_string(churn_object_t object) {
+  switch (object) {
+  case CHURN_EVENT:
+    return "event";
+  case CHURN_EVENT_POOL:
+    return "event_pool";
+  default:
+    return "fence";
+  }
+}
+
+// Every thread creates, signals, resets and destroys objects of one type
+// as fast as it can for a fixed time.  The process memory is sampled at
+// the end of every round, so that a leak shows as steady growth.
+class zeDriverObjectChurnStressTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::tuple<churn_object_t, uint32_t>> {
+protected:
+  // Creates, signals, resets and destroys one event of a long lived pool
+  void churn_event(ze_event_pool_handle_t event_pool) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    auto event = lzt::create_event(event_pool, event_desc);
+    lzt::signal_event_from_host(event);
+    lzt::event_host_synchronize(event, UINT64_MAX);
+    lzt::event_host_reset(event);
+    lzt::destroy_event(event);
+  }
+
+  // Does the same with a pool of its own around the event
+  void churn_event_pool(ze_context_handle_t context) {
+    auto event_pool = lzt::create_event_pool(
+        context, events_per_pool_, ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+    churn_event(event_pool);
+    lzt::destroy_event_pool(event_pool);
+  }
+
+  // Signals a new fence with an empty command list and waits for it
+  void churn_fence(ze_command_queue_handle_t queue,
+                   ze_command_list_handle_t list) {
+    auto fence = lzt::create_fence(queue);
+    lzt::execute_command_lists(queue, 1, &list, fence);
+    EXPECT_EQ(ZE_RESULT_SUCCESS, lzt::sync_fence(fence, UINT64_MAX));
+    lzt::reset_fence(fence);
+    lzt::destroy_fence(fence);
+  }
+
+  const std::chrono::seconds round_duration_{2};
+  const uint32_t rounds_ = 5;
+  const uint32_t events_per_pool_ = 64;
+  // Memory growth between the first and the last round reported as a leak
+  const uint64_t leak_threshold_ = 16 * 1024 * 1024;
+};
+
+TEST_P(zeDriverObjectChurnStressTest, ChurnObjectsFromManyThreads) {
+  const churn_object_t object = std::get<0>(GetParam());
+  const uint32_t thread_count = std::get<1>(GetParam());
+  auto driver = lzt::get_default_driver();
+  auto context = lzt::create_context(driver);
+  auto device = lzt::get_default_device(driver);
+
+  // Objects the churned ones come from are created once per thread
+  std::vector<ze_event_pool_handle_t> event_pools(thread_count, nullptr);
+  std::vector<ze_command_queue_handle_t> queues(thread_count, nullptr);
+  std::vector<ze_command_list_handle_t> lists(thread_count, nullptr);
+  for (uint32_t i = 0; i < thread_count; i++) {
+    if (object == CHURN_EVENT) {
+      event_pools[i] = lzt::create_event_pool(context, 1,
+                                              ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+    } else if (object == CHURN_FENCE) {
+      queues[i] = lzt::create_command_queue(
+          context, device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+          ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+      lists[i] = lzt::create_command_list(context, device, 0);
+      lzt::close_command_list(lists[i]);
+    }
+  }
+
+  std::vector<uint64_t> resident_memory;
+  uint64_t total_operations = 0;
+  for (uint32_t round = 0; round < rounds_; round++) {
+    std::atomic<uint64_t> operations{0};
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < thread_count; i++) {
+      threads.emplace_back([&, i]() {
+        uint64_t thread_operations = 0;
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < round_duration_) {
+          switch (object) {
+          case CHURN_EVENT:
+            churn_event(event_pools[i]);
+            break;
+          case CHURN_EVENT_POOL:
+            churn_event_pool(context);
+            break;
+          default:
+            churn_fence(queues[i], lists[i]);
+            break;
+          }
+          thread_operations++;
+        }
+        operations += thread_operations;
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    resident_memory.push_back(process_resident_memory());
+    total_operations += operations;
+    LOG_INFO << to_string(object) << " churn round " << round << " with "
+             << thread_count << " threads: "
+             << operations / static_cast<double>(round_duration_.count())
+             << " ops/s, resident memory " << resident_memory.back()
+             << " bytes";
+  }
+
+  // The first round pays for warming up the driver pools
+  if (resident_memory.back() > resident_memory.front() + leak_threshold_) {
+    LOG_WARNING << "Resident memory grows by "
+                << resident_memory.back() - resident_memory.front()
+                << " bytes over " << rounds_ - 1 << " rounds of "
+                << to_string(object) << " churn";
+  }
+  record_soak_operations(total_operations);
+
+  for (uint32_t i = 0; i < thread_count; i++) {
+    if (event_pools[i]) {
+      lzt::destroy_event_pool(event_pools[i]);
+    }
+    if (lists[i]) {
+      lzt::destroy_command_list(lists[i]);
+      lzt::destroy_command_queue(queues[i]);
+    }
+  }
+  lzt::destroy_context(context);
+}
+
+struct ChurnTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    std::stringstream ss;
+    ss << to_string(std::get<0>(info.param)) << "_" << std::get<1>(info.param)
+       << "_threads";
+    return ss.str();
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestObjectChurn, zeDriverObjectChurnStressTest,
+    ::testing::Combine(::testing::Values(CHURN_EVENT, CHURN_EVENT_POOL,
+                                         CHURN_FENCE),
+                       ::testing::Values(1, 4, 16, 64)),
+    ChurnTestNameSuffix());
+
+} // namespace
@@ -0,0 +1,182 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_common_func.hpp"
+#include "stress_soak.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+typedef std::chrono::steady_clock scaling_clock;
+
+double elapsed_ns(scaling_clock::time_point start,
+                  scaling_clock::time_point end) {
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Builds command lists of doubling numbers of dispatches and measures the
+// append rate, the close time and the execution time per dispatch of each,
+// to find how long a command list can get before the execution time per
+// dispatch rises again, e.g. when the driver chains command buffers.  The
+// parameter selects whether a barrier follows every dispatch.
+class zeDriverCommandListScalingStressTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<bool> {
+protected:
+  struct ScalingSample {
+    uint32_t dispatches;
+    double append_ns_per_dispatch;
+    double close_ns;
+    double execute_ns_per_dispatch;
+  };
+
+  uint32_t workgroup_size_x_ = 8;
+  uint32_t data_count_ = 1024;
+  uint32_t max_dispatches_ = 128 * 1024;
+  uint32_t executions_ = 3;
+  // Growth in execution time per dispatch reported as a drop in throughput
+  double slowdown_threshold_ = 1.5;
+};
+
+TEST_P(zeDriverCommandListScalingStressTest,
+       MeasureAppendAndExecutionScaling) {
+  const bool barriers = GetParam();
+  auto driver = lzt::get_default_driver();
+  auto context = lzt::create_context(driver);
+  auto device = lzt::get_default_device(driver);
+
+  uint32_t *buffer = allocate_memory<uint32_t>(
+      context, device, ZE_MEMORY_TYPE_DEVICE, data_count_ * sizeof(uint32_t),
+      false);
+  std::vector<uint32_t> data_out(data_count_, 0);
+
+  ze_module_handle_t module_handle = lzt::create_module(
+      context, device, "test_commands_overloading.spv",
+      ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+  ze_kernel_handle_t kernel_handle =
+      lzt::create_function(module_handle, "test_device_memory1");
+  lzt::set_group_size(kernel_handle, workgroup_size_x_, 1, 1);
+  lzt::set_argument_value(kernel_handle, 0, sizeof(buffer), &buffer);
+  ze_group_count_t thread_group_dimensions = {data_count_ / workgroup_size_x_,
+                                              1, 1};
+  ze_command_queue_handle_t command_queue = lzt::create_command_queue(
+      context, device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+      ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+
+  std::vector<ScalingSample> samples;
+  bool memory_test_failure = false;
+  uint64_t total_dispatches = 0;
+  for (uint32_t dispatches = 1; dispatches <= max_dispatches_;
+       dispatches *= 2) {
+    ze_command_list_handle_t command_list =
+        lzt::create_command_list(context, device, 0);
+    const uint32_t zero = 0;
+    lzt::append_memory_fill(command_list, buffer, &zero, sizeof(zero),
+                            data_count_ * sizeof(uint32_t), nullptr);
+    lzt::append_barrier(command_list, nullptr);
+
+    const auto append_start = scaling_clock::now();
+    for (uint32_t i = 0; i < dispatches; i++) {
+      lzt::append_launch_function(command_list, kernel_handle,
+                                  &thread_group_dimensions, nullptr, 0,
+                                  nullptr);
+      if (barriers) {
+        lzt::append_barrier(command_list, nullptr);
+      }
+    }
+    const auto append_end = scaling_clock::now();
+
+    if (!barriers) {
+      lzt::append_barrier(command_list, nullptr);
+    }
+    lzt::append_memory_copy(command_list, data_out.data(), buffer,
+                            data_count_ * sizeof(uint32_t), nullptr);
+    const auto close_start = scaling_clock::now();
+    lzt::close_command_list(command_list);
+    const auto close_end = scaling_clock::now();
+
+    // The first execution is a warm up
+    double execute_ns = 0;
+    for (uint32_t i = 0; i < executions_; i++) {
+      const auto execute_start = scaling_clock::now();
+      lzt::execute_command_lists(command_queue, 1, &command_list, nullptr);
+      lzt::synchronize(command_queue, UINT64_MAX);
+      const double ns = elapsed_ns(execute_start, scaling_clock::now());
+      if (i == 1 || (i > 1 && ns < execute_ns)) {
+        execute_ns = ns;
+      }
+    }
+    lzt::destroy_command_list(command_list);
+    total_dispatches += static_cast<uint64_t>(dispatches) * executions_;
+
+    // Without barriers the dispatches race on the buffer
+    if (barriers) {
+      for (uint32_t i = 0; i < data_count_; i++) {
+        if (data_out[i] != i * dispatches) {
+          LOG_ERROR << "Results for " << dispatches << " dispatches failed. "
+                    << " The index " << i << " found = " << data_out[i]
+                    << " expected = " << i * dispatches;
+          memory_test_failure = true;
+          break;
+        }
+      }
+    }
+
+    samples.push_back({dispatches,
+                       elapsed_ns(append_start, append_end) / dispatches,
+                       elapsed_ns(close_start, close_end),
+                       execute_ns / dispatches});
+    const auto &sample = samples.back();
+    LOG_INFO << dispatches << " dispatches: append "
+             << 1e3 / sample.append_ns_per_dispatch
+             << " M appends/s, close " << sample.close_ns / 1e3
+             << " us, execute " << sample.execute_ns_per_dispatch / 1e3
+             << " us per dispatch";
+  }
+
+  // Longer lists amortize the submission, so the execution time per
+  // dispatch falls until something in the driver or device costs more
+  double fastest = samples.front().execute_ns_per_dispatch;
+  for (auto &sample : samples) {
+    if (sample.execute_ns_per_dispatch > fastest * slowdown_threshold_) {
+      LOG_INFO << "Execution time per dispatch rises from " << fastest / 1e3
+               << " us to " << sample.execute_ns_per_dispatch / 1e3
+               << " us at " << sample.dispatches << " dispatches per list";
+      break;
+    }
+    fastest = std::min(fastest, sample.execute_ns_per_dispatch);
+  }
+
+  lzt::destroy_command_queue(command_queue);
+  lzt::destroy_function(kernel_handle);
+  lzt::destroy_module(module_handle);
+  lzt::free_memory(context, buffer);
+  lzt::destroy_context(context);
+
+  record_soak_operations(total_dispatches);
+  EXPECT_EQ(false, memory_test_failure);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    zeDriverCommandListScalingStressTest, zeDriverCommandListScalingStressTest,
+    ::testing::Values(true, false),
+    [](const testing::TestParamInfo<bool> &info) {
+      return std::string(info.param ? "with_barriers" : "without_barriers");
+    });
+
+} // namespace
@@ -0,0 +1,210 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_soak.hpp"
+
+#include <level_zero/ze_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace lzt = level_zero_tests;
+
+namespace {
+
+const uint32_t dispatch_size = 4 * 1024 * 1024;
+const uint32_t dispatches_per_operation = 8;
+const size_t copy_size = 64 * 1024 * 1024;
+
+// One queue of a command queue group, with the list it keeps executing:
+// dispatches on compute engines and copies on copy-only engines
+struct Engine {
+  uint32_t ordinal;
+  uint32_t index;
+  bool compute;
+  ze_command_queue_handle_t queue;
+  ze_command_list_handle_t list;
+  void *source;
+  void *destination;
+  ze_kernel_handle_t kernel;
+  double operations_per_second;
+};
+
+// Executes the engine list until the duration passes, returning the
+// operations per second
+double run_engine(Engine &engine, std::chrono::duration<double> duration,
+                  const std::atomic<bool> &start) {
+  while (!start) {
+    std::this_thread::yield();
+  }
+  uint64_t operations = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  auto now = begin;
+  while (now - begin < duration) {
+    lzt::execute_command_lists(engine.queue, 1, &engine.list, nullptr);
+    lzt::synchronize(engine.queue, UINT64_MAX);
+    operations++;
+    now = std::chrono::steady_clock::now();
+  }
+  return operations / std::chrono::duration<double>(now - begin).count();
+}
+
+// Measures each engine of every command queue group alone, then all of them
+// at once, reporting how much of its standalone throughput every engine
+// keeps while the others share the device with it
+class zeDriverConcurrentEnginesStressTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto driver = lzt::get_default_driver();
+    context_ = lzt::create_context(driver);
+    device_ = lzt::get_default_device(driver);
+    module_ = lzt::create_module(context_, device_,
+                                 "test_concurrent_engines.spv",
+                                 ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+
+    auto group_properties = lzt::get_command_queue_group_properties(device_);
+    for (uint32_t ordinal = 0; ordinal < group_properties.size(); ordinal++) {
+      const auto &properties = group_properties[ordinal];
+      const bool compute =
+          properties.flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE;
+      if (!compute &&
+          !(properties.flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY)) {
+        continue;
+      }
+      for (uint32_t index = 0; index < properties.numQueues; index++) {
+        engines_.push_back(create_engine(ordinal, index, compute));
+      }
+    }
+  }
+
+  void TearDown() override {
+    for (auto &engine : engines_) {
+      lzt::destroy_command_list(engine.list);
+      lzt::destroy_command_queue(engine.queue);
+      if (engine.kernel) {
+        lzt::destroy_function(engine.kernel);
+      }
+      if (engine.source) {
+        lzt::free_memory(context_, engine.source);
+      }
+      lzt::free_memory(context_, engine.destination);
+    }
+    lzt::destroy_module(module_);
+    lzt::destroy_context(context_);
+  }
+
+  Engine create_engine(uint32_t ordinal, uint32_t index, bool compute) {
+    Engine engine = {ordinal, index, compute, nullptr, nullptr,
+                     nullptr, nullptr, nullptr, 0};
+    engine.queue = lzt::create_command_queue(
+        context_, device_, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+        ZE_COMMAND_QUEUE_PRIORITY_NORMAL, ordinal, index);
+    engine.list = lzt::create_command_list(context_, device_, 0, ordinal);
+    if (compute) {
+      engine.destination = lzt::allocate_device_memory(
+          dispatch_size * sizeof(uint32_t), 1, 0, 0, device_, context_);
+      engine.kernel =
+          lzt::create_function(module_, "concurrent_engines_add_one");
+      uint32_t group_size_x = 0, group_size_y = 0, group_size_z = 0;
+      lzt::suggest_group_size(engine.kernel, dispatch_size, 1, 1,
+                              group_size_x, group_size_y, group_size_z);
+      lzt::set_group_size(engine.kernel, group_size_x, 1, 1);
+      lzt::set_argument_value(engine.kernel, 0, sizeof(engine.destination),
+                              &engine.destination);
+      ze_group_count_t group_count = {dispatch_size / group_size_x, 1, 1};
+      for (uint32_t i = 0; i < dispatches_per_operation; i++) {
+        lzt::append_launch_function(engine.list, engine.kernel, &group_count,
+                                    nullptr, 0, nullptr);
+        lzt::append_barrier(engine.list, nullptr);
+      }
+    } else {
+      engine.source = lzt::allocate_device_memory(copy_size, 1, 0, 0, device_,
+                                                  context_);
+      engine.destination = lzt::allocate_device_memory(copy_size, 1, 0, 0,
+                                                       device_, context_);
+      lzt::append_memory_copy(engine.list, engine.destination, engine.source,
+                              copy_size, nullptr);
+    }
+    lzt::close_command_list(engine.list);
+    return engine;
+  }
+
+  // Runs the engines in their own threads, all starting together
+  std::vector<double> run_engines(const std::vector<Engine *> &engines) {
+    std::vector<double> throughputs(engines.size(), 0);
+    std::vector<std::thread> threads;
+    std::atomic<bool> start{false};
+    for (size_t i = 0; i < engines.size(); i++) {
+      threads.emplace_back([&, i]() {
+        throughputs[i] = run_engine(*engines[i], duration_, start);
+      });
+    }
+    start = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    return throughputs;
+  }
+
+  std::string engine_name(const Engine &engine) {
+    return (engine.compute ? "compute" : "copy") + std::string(" engine ") +
+           std::to_string(engine.ordinal) + "." + std::to_string(engine.index);
+  }
+
+  const std::chrono::seconds duration_{5};
+  // Share of the standalone throughput below which interference is reported
+  const double interference_threshold_ = 0.5;
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+  ze_module_handle_t module_ = nullptr;
+  std::vector<Engine> engines_;
+};
+
+TEST_F(zeDriverConcurrentEnginesStressTest,
+       SaturateAllEnginesAndCompareWithStandaloneThroughput) {
+  ASSERT_FALSE(engines_.empty());
+
+  for (auto &engine : engines_) {
+    engine.operations_per_second = run_engines({&engine})[0];
+    LOG_INFO << engine_name(engine) << " standalone: "
+             << engine.operations_per_second << " operations/s";
+  }
+
+  std::vector<Engine *> all_engines;
+  for (auto &engine : engines_) {
+    all_engines.push_back(&engine);
+  }
+  auto throughputs = run_engines(all_engines);
+
+  uint64_t total_operations = 0;
+  for (size_t i = 0; i < engines_.size(); i++) {
+    const auto &engine = engines_[i];
+    const double share = (engine.operations_per_second > 0)
+                             ? throughputs[i] / engine.operations_per_second
+                             : 0;
+    LOG_INFO << engine_name(engine) << " concurrent: " << throughputs[i]
+             << " operations/s, " << 100 * share << "% of standalone";
+    if (share < interference_threshold_) {
+      LOG_WARNING << engine_name(engine)
+                  << " loses more than half of its throughput while the "
+                     "other engines run";
+    }
+    EXPECT_GT(throughputs[i], 0);
+    total_operations += static_cast<uint64_t>(throughputs[i] *
+                                              duration_.count());
+  }
+  record_soak_operations(total_operations);
+}
+
+} // namespace
@@ -0,0 +1,18 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _TEST_HOST_MEMORY_CONTENTION_HPP_
+#define _TEST_HOST_MEMORY_CONTENTION_HPP_
+
+#include <cstdint>
+
+// Most CPU threads generating memory traffic, from
+// --cpu_traffic_threads=<n>; 0 uses all CPUs but one
+extern uint32_t max_cpu_traffic_threads;
+
+#endif /* _TEST_HOST_MEMORY_CONTENTION_HPP_ */
@@ -0,0 +1,37 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gmock/gmock.h"
+#include "logging/logging.hpp"
+#include "utils/utils.hpp"
+#include "stress_soak.hpp"
+#include "test_host_memory_contention.hpp"
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleMock(&argc, argv);
+  std::vector<std::string> command_line(argv + 1, argv + argc);
+  level_zero_tests::init_logging(command_line);
+  init_soak_mode(command_line);
+  const std::string threads_option = "--cpu_traffic_threads=";
+  for (auto &argument : command_line) {
+    if (argument.compare(0, threads_option.size(), threads_option) == 0) {
+      max_cpu_traffic_threads =
+          std::stoul(argument.substr(threads_option.size()));
+    }
+  }
+
+  ze_result_t result = zeInit(0);
+  if (result) {
+    throw std::runtime_error("zeInit failed: " +
+                             level_zero_tests::to_string(result));
+  }
+  LOG_TRACE << "Driver initialized";
+  level_zero_tests::print_platform_overview();
+
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,372 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_soak.hpp"
+#include "test_host_memory_contention.hpp"
+
+#include <level_zero/ze_api.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace lzt = level_zero_tests;
+
+uint32_t max_cpu_traffic_threads = 0;
+
+namespace {
+
+typedef std::chrono::steady_clock contention_clock;
+
+const size_t transfer_size = 64 * 1024 * 1024;
+const size_t latency_size = 4096;
+const int latency_transfers = 200;
+// Larger than the last level cache, so that the copies reach DRAM
+const size_t traffic_buffer_size = 64 * 1024 * 1024;
+const std::chrono::seconds measure_duration{2};
+// Share of the idle bandwidth below which the degradation is reported
+const double degradation_threshold = 0.5;
+
+#if defined(__linux__)
+// CPUs of a sysfs cpulist such as 0-3,8
+std::vector<int> parse_cpu_list(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ranges(list);
+  std::string range;
+  while (std::getline(ranges, range, ',')) {
+    int first = 0, last = 0;
+    const int fields = sscanf(range.c_str(), "%d-%d", &first, &last);
+    if (fields < 1) {
+      continue;
+    }
+    for (int cpu = first; cpu <= (fields == 2 ? last : first); cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<int> numa_node_cpus(int node) {
+  std::ifstream cpulist_file("/sys/devices/system/node/node" +
+                             std::to_string(node) + "/cpulist");
+  std::string cpulist;
+  cpulist_file >> cpulist;
+  return parse_cpu_list(cpulist);
+}
+
+// NUMA node of the PCI device, -1 when unknown
+int device_numa_node(ze_device_handle_t device) {
+  ze_pci_ext_properties_t pci_properties = {
+      ZE_STRUCTURE_TYPE_PCI_EXT_PROPERTIES, nullptr};
+  if (zeDevicePciGetPropertiesExt(device, &pci_properties) !=
+      ZE_RESULT_SUCCESS) {
+    return -1;
+  }
+  char bdf[32];
+  snprintf(bdf, sizeof(bdf), "%04x:%02x:%02x.%x",
+           pci_properties.address.domain, pci_properties.address.bus,
+           pci_properties.address.device, pci_properties.address.function);
+  int node = -1;
+  std::ifstream numa_node_file(std::string("/sys/bus/pci/devices/") + bdf +
+                               "/numa_node");
+  numa_node_file >> node;
+  return node;
+}
+
+void bind_thread(const std::vector<int> &cpus) {
+  if (cpus.empty()) {
+    return;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+}
+#else
+void bind_thread(const std::vector<int> &cpus) {}
+#endif
+
+// CPU threads copying between private buffers, as preprocessing saturating
+// DRAM bandwidth would. Each thread touches its buffers first, so that
+// they are placed on the NUMA node of the CPUs it is bound to.
+class CpuTraffic {
+public:
+  void start(uint32_t thread_count, const std::vector<int> &cpus) {
+    running_ = true;
+    bytes_ = 0;
+    std::atomic<uint32_t> ready{0};
+    for (uint32_t i = 0; i < thread_count; i++) {
+      threads_.emplace_back([&, cpus]() {
+        bind_thread(cpus);
+        std::vector<char> source(traffic_buffer_size, 1);
+        std::vector<char> destination(traffic_buffer_size, 0);
+        ready++;
+        while (running_) {
+          memcpy(destination.data(), source.data(), traffic_buffer_size);
+          // Read once and written once
+          bytes_ += 2 * traffic_buffer_size;
+        }
+      });
+    }
+    while (ready < thread_count) {
+      std::this_thread::yield();
+    }
+    begin_ = contention_clock::now();
+  }
+
+  // Stops the threads, returning the traffic they generated in GB/s
+  double stop() {
+    running_ = false;
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+    const double seconds =
+        std::chrono::duration<double>(contention_clock::now() - begin_)
+            .count();
+    return bytes_ / seconds / 1e9;
+  }
+
+private:
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> bytes_{0};
+  std::vector<std::thread> threads_;
+  contention_clock::time_point begin_;
+};
+
+struct TransferResult {
+  double host_to_device_gbps = 0;
+  double device_to_host_gbps = 0;
+  double latency_us = 0;
+};
+
+// Host to device and device to host transfers of a host buffer against
+// CPU memory traffic growing from none to max_cpu_traffic_threads
+// threads: bandwidth of 64 MB copies and latency of 4 KB copies. With
+// two NUMA nodes or more, the same transfers with the host buffer and
+// the traffic on the node of the device or on another node.
+class zeDriverHostMemoryContentionStressTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto driver = lzt::get_default_driver();
+    context_ = lzt::create_context(driver);
+    device_ = lzt::get_default_device(driver);
+
+    // A copy engine when there is one, as used for transfers
+    auto group_properties = lzt::get_command_queue_group_properties(device_);
+    for (uint32_t ordinal = 0; ordinal < group_properties.size(); ordinal++) {
+      const auto flags = group_properties[ordinal].flags;
+      if ((flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COPY) &&
+          !(flags & ZE_COMMAND_QUEUE_GROUP_PROPERTY_FLAG_COMPUTE)) {
+        ordinal_ = ordinal;
+        break;
+      }
+    }
+    queue_ = lzt::create_command_queue(
+        context_, device_, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+        ZE_COMMAND_QUEUE_PRIORITY_NORMAL, ordinal_);
+    device_buffer_ = lzt::allocate_device_memory(transfer_size, 64, 0, 0,
+                                                 device_, context_);
+
+    const uint32_t cpus = std::max(2u, std::thread::hardware_concurrency());
+    max_threads_ = max_cpu_traffic_threads ? max_cpu_traffic_threads
+                                           : cpus - 1;
+  }
+
+  void TearDown() override {
+    lzt::free_memory(context_, device_buffer_);
+    lzt::destroy_command_queue(queue_);
+    lzt::destroy_context(context_);
+  }
+
+  // Executes list until measure_duration passes, returning GB/s
+  double measure_bandwidth(ze_command_list_handle_t list) {
+    uint64_t transfers = 0;
+    const auto begin = contention_clock::now();
+    auto now = begin;
+    while (now - begin < measure_duration) {
+      lzt::execute_command_lists(queue_, 1, &list, nullptr);
+      lzt::synchronize(queue_, UINT64_MAX);
+      transfers++;
+      now = contention_clock::now();
+    }
+    transfers_ += transfers;
+    return transfers * transfer_size /
+           std::chrono::duration<double>(now - begin).count() / 1e9;
+  }
+
+  // Transfers from a thread bound to cpus, which allocates the host
+  // buffer, so that it is placed on their NUMA node; no binding when
+  // cpus is empty
+  TransferResult run_transfers(const std::vector<int> &cpus) {
+    TransferResult result;
+    std::thread transfer_thread([&]() {
+      bind_thread(cpus);
+      void *host_buffer =
+          lzt::allocate_host_memory(transfer_size, 64, context_);
+      memset(host_buffer, 0, transfer_size);
+      auto to_device = lzt::create_command_list(context_, device_, 0,
+                                                ordinal_);
+      lzt::append_memory_copy(to_device, device_buffer_, host_buffer,
+                              transfer_size, nullptr);
+      lzt::close_command_list(to_device);
+      auto to_host = lzt::create_command_list(context_, device_, 0, ordinal_);
+      lzt::append_memory_copy(to_host, host_buffer, device_buffer_,
+                              transfer_size, nullptr);
+      lzt::close_command_list(to_host);
+      auto small = lzt::create_command_list(context_, device_, 0, ordinal_);
+      lzt::append_memory_copy(small, device_buffer_, host_buffer,
+                              latency_size, nullptr);
+      lzt::close_command_list(small);
+
+      result.host_to_device_gbps = measure_bandwidth(to_device);
+      result.device_to_host_gbps = measure_bandwidth(to_host);
+      std::vector<double> latencies;
+      for (int i = 0; i < latency_transfers; i++) {
+        const auto begin = contention_clock::now();
+        lzt::execute_command_lists(queue_, 1, &small, nullptr);
+        lzt::synchronize(queue_, UINT64_MAX);
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+                                contention_clock::now() - begin)
+                                .count());
+      }
+      result.latency_us = lzt::median(latencies);
+
+      lzt::destroy_command_list(small);
+      lzt::destroy_command_list(to_host);
+      lzt::destroy_command_list(to_device);
+      lzt::free_memory(context_, host_buffer);
+    });
+    transfer_thread.join();
+    return result;
+  }
+
+  void log_result(const std::string &name, double cpu_gbps,
+                  const TransferResult &result) {
+    LOG_INFO << name << ": CPU traffic " << cpu_gbps << " GB/s, host to "
+             << "device " << result.host_to_device_gbps
+             << " GB/s, device to host " << result.device_to_host_gbps
+             << " GB/s, 4 KB copy latency " << result.latency_us << " us";
+  }
+
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+  uint32_t ordinal_ = 0;
+  ze_command_queue_handle_t queue_ = nullptr;
+  void *device_buffer_ = nullptr;
+  uint32_t max_threads_ = 1;
+  uint64_t transfers_ = 0;
+};
+
+TEST_F(zeDriverHostMemoryContentionStressTest,
+       SweepCpuMemoryTrafficAndMeasureTransferDegradation) {
+  const TransferResult idle = run_transfers({});
+  log_result("0 CPU traffic threads", 0, idle);
+
+  // Powers of two up to the most threads, then the most threads
+  std::vector<uint32_t> thread_counts;
+  for (uint32_t threads = 1; threads < max_threads_; threads *= 2) {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads_);
+  for (auto threads : thread_counts) {
+    CpuTraffic traffic;
+    traffic.start(threads, {});
+    const TransferResult result = run_transfers({});
+    const double cpu_gbps = traffic.stop();
+    log_result(std::to_string(threads) + " CPU traffic threads", cpu_gbps,
+               result);
+    EXPECT_GT(result.host_to_device_gbps, 0);
+    EXPECT_GT(result.device_to_host_gbps, 0);
+    if (result.host_to_device_gbps <
+            degradation_threshold * idle.host_to_device_gbps ||
+        result.device_to_host_gbps <
+            degradation_threshold * idle.device_to_host_gbps) {
+      LOG_WARNING << threads << " CPU traffic threads take more than half "
+                  << "of the idle transfer bandwidth";
+    }
+  }
+  record_soak_operations(transfers_);
+}
+
+TEST_F(zeDriverHostMemoryContentionStressTest,
+       PlaceHostBufferAndCpuTrafficOnNumaNodesAndMeasureTransferDegradation) {
+#if defined(__linux__)
+  const int device_node = device_numa_node(device_);
+  if (device_node < 0) {
+    GTEST_SKIP() << "NUMA node of the device unknown";
+  }
+  const std::vector<int> local_cpus = numa_node_cpus(device_node);
+  std::vector<int> remote_cpus;
+  int remote_node = -1;
+  for (int node = 0; node < 64 && remote_cpus.empty(); node++) {
+    if (node != device_node) {
+      remote_cpus = numa_node_cpus(node);
+      remote_node = node;
+    }
+  }
+  if (local_cpus.empty() || remote_cpus.empty()) {
+    GTEST_SKIP() << "Needs CPUs on two NUMA nodes";
+  }
+  LOG_INFO << "Device on NUMA node " << device_node << ", remote node "
+           << remote_node;
+
+  // Traffic from as many threads as a node has CPUs, but one for the
+  // transfers
+  const struct {
+    const char *buffer_name;
+    const std::vector<int> *buffer_cpus;
+    const char *traffic_name;
+    const std::vector<int> *traffic_cpus;
+  } placements[] = {{"local", &local_cpus, "none", nullptr},
+                    {"local", &local_cpus, "local", &local_cpus},
+                    {"local", &local_cpus, "remote", &remote_cpus},
+                    {"remote", &remote_cpus, "none", nullptr},
+                    {"remote", &remote_cpus, "local", &local_cpus},
+                    {"remote", &remote_cpus, "remote", &remote_cpus}};
+  for (auto &placement : placements) {
+    CpuTraffic traffic;
+    if (placement.traffic_cpus) {
+      const uint32_t threads = std::max<uint32_t>(
+          1, std::min<uint32_t>(max_threads_,
+                                placement.traffic_cpus->size() - 1));
+      traffic.start(threads, *placement.traffic_cpus);
+    }
+    const TransferResult result = run_transfers(*placement.buffer_cpus);
+    const double cpu_gbps = placement.traffic_cpus ? traffic.stop() : 0;
+    log_result(std::string("Host buffer ") + placement.buffer_name +
+                   ", CPU traffic " + placement.traffic_name,
+               cpu_gbps, result);
+    EXPECT_GT(result.host_to_device_gbps, 0);
+    EXPECT_GT(result.device_to_host_gbps, 0);
+  }
+  record_soak_operations(transfers_);
+#else
+  GTEST_SKIP() << "NUMA placement is only supported on Linux";
+#endif
+}
+
+} // namespace
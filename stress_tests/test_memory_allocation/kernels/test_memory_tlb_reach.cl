@@ -0,0 +1,28 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+kernel void tlb_stream(global const uint *data, global uint *sums,
+                       ulong count) {
+  uint sum = 0;
+  for (size_t i = get_global_id(0); i < count; i += get_global_size(0)) {
+    sum += data[i];
+  }
+  sums[get_global_id(0)] = sum;
+}
+
+// Every work item walks `hops` links of the ring, where every node holds
+// the index of the next one, from the index left in its position by the
+// launch before
+kernel void tlb_random_walk(global const uint *ring, global uint *positions,
+                            uint hops) {
+  uint id = positions[get_global_id(0)];
+  for (uint i = 0; i < hops; i++) {
+    id = ring[id];
+  }
+  positions[get_global_id(0)] = id;
+}
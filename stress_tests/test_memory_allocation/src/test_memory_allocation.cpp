@@ -13,6 +13,7 @@
 #include "test_harness/test_harness.hpp"
 #include "logging/logging.hpp"
 #include "stress_common_func.hpp"
+#include "stress_soak.hpp"
 
 namespace lzt = level_zero_tests;
 
@@ -281,6 +282,7 @@ TEST_P(
   LOG_INFO << "call destroy module";
   EXPECT_EQ(ZE_RESULT_SUCCESS, zeModuleDestroy(module_handle));
 
+  record_soak_operations(number_of_all_allocations);
   EXPECT_EQ(false, memory_test_failure);
 }
 
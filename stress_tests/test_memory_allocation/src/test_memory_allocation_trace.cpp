@@ -0,0 +1,348 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_common_func.hpp"
+#include "stress_soak.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+namespace {
+
+struct AllocationEvent {
+  bool allocate;
+  uint64_t id;
+  size_t size;
+};
+
+// One operation per line, "alloc <id> <bytes>" or "free <id>", with lines
+// starting with # ignored
+std::vector<AllocationEvent> read_allocation_trace(const std::string &path) {
+  std::vector<AllocationEvent> trace;
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    LOG_ERROR << "Cannot open allocation trace " << path;
+    return trace;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    std::string operation;
+    AllocationEvent event = {false, 0, 0};
+    if (!(fields >> operation) || operation[0] == '#') {
+      continue;
+    }
+    if (operation == "alloc" && fields >> event.id >> event.size) {
+      event.allocate = true;
+      trace.push_back(event);
+    } else if (operation == "free" && fields >> event.id) {
+      trace.push_back(event);
+    } else {
+      LOG_WARNING << "Ignoring allocation trace line: " << line;
+    }
+  }
+  return trace;
+}
+
+enum class SizeDistribution { SMALL, MIXED, LARGE };
+
+std::string to_string(SizeDistribution distribution) {
+  switch (distribution) {
+  case SizeDistribution::SMALL:
+    return "small";
+  case SizeDistribution::MIXED:
+    return "mixed";
+  default:
+    return "large";
+  }
+}
+
+// Sizes are log-uniform over the range of the distribution and lifetimes,
+// counted in operations, exponential.  The oldest allocations are freed
+// early when the live bytes would exceed live_limit, and everything still
+// live is freed at the end.
+std::vector<AllocationEvent> synthetic_trace(SizeDistribution distribution,
+                                             uint32_t allocation_count,
+                                             uint64_t live_limit) {
+  double min_size = 64, max_size = 64.0 * 1024;
+  if (distribution == SizeDistribution::MIXED) {
+    max_size = 64.0 * 1024 * 1024;
+  } else if (distribution == SizeDistribution::LARGE) {
+    min_size = 1024.0 * 1024;
+    max_size = 256.0 * 1024 * 1024;
+  }
+  max_size = std::min(max_size, static_cast<double>(live_limit));
+  min_size = std::min(min_size, max_size);
+
+  std::mt19937_64 engine(allocation_count);
+  std::uniform_real_distribution<double> log_size(std::log(min_size),
+                                                  std::log(max_size));
+  std::exponential_distribution<double> lifetime(1.0 / 100);
+
+  std::vector<AllocationEvent> trace;
+  // Expiry operation and id of the live allocations
+  std::multimap<uint64_t, uint64_t> expiries;
+  std::map<uint64_t, size_t> live;
+  uint64_t live_bytes = 0;
+  auto free_first = [&]() {
+    auto first = expiries.begin();
+    trace.push_back({false, first->second, 0});
+    live_bytes -= live[first->second];
+    live.erase(first->second);
+    expiries.erase(first);
+  };
+  for (uint64_t id = 0; id < allocation_count; id++) {
+    const size_t size = static_cast<size_t>(std::exp(log_size(engine)));
+    while (!expiries.empty() && (expiries.begin()->first <= trace.size() ||
+                                 live_bytes + size > live_limit)) {
+      free_first();
+    }
+    trace.push_back({true, id, size});
+    live[id] = size;
+    live_bytes += size;
+    expiries.insert(
+        {trace.size() + static_cast<uint64_t>(lifetime(engine)), id});
+  }
+  while (!expiries.empty()) {
+    free_first();
+  }
+  return trace;
+}
+
+void print_latency(const std::string &operation,
+                   const std::vector<double> &values) {
+  if (values.empty()) {
+    LOG_INFO << operation << " latency: no successful calls";
+    return;
+  }
+  LOG_INFO << operation << " latency us over " << values.size()
+           << " calls: p50 " << lzt::median(values) << " p90 "
+           << lzt::percentile(values, 90) << " p99 "
+           << lzt::percentile(values, 99) << " p99.9 "
+           << lzt::percentile(values, 99.9) << " max "
+           << lzt::percentile(values, 100);
+}
+
+// Replays allocation traces with zeMemAlloc* and zeMemFree called
+// directly, timing every call.  Every probe_interval_ operations the
+// largest allocation that still succeeds is searched for, to show how
+// fragmentation reduces it while the trace runs.
+class zeDriverMemoryAllocationTraceStressTest : public ::testing::Test {
+protected:
+  void *allocate(ze_context_handle_t context, ze_device_handle_t device,
+                 ze_memory_type_t memory_type, size_t size,
+                 ze_result_t *result) {
+    if (memory_type == ZE_MEMORY_TYPE_HOST) {
+      return lzt::allocate_host_memory_no_check(size, alignment_, context,
+                                                result);
+    } else if (memory_type == ZE_MEMORY_TYPE_SHARED) {
+      return lzt::allocate_shared_memory_no_check(
+          size, alignment_, 0, nullptr, 0, nullptr, device, context, result);
+    }
+    return lzt::allocate_device_memory_no_check(size, alignment_, 0, nullptr,
+                                                0, device, context, result);
+  }
+
+  // Binary search at probe_granularity_ for the largest size up to
+  // upper_limit that can be allocated
+  size_t probe_max_allocation(ze_context_handle_t context,
+                              ze_device_handle_t device,
+                              ze_memory_type_t memory_type,
+                              size_t upper_limit) {
+    size_t low = 0, high = upper_limit / probe_granularity_;
+    while (low < high) {
+      const size_t middle = (low + high + 1) / 2;
+      ze_result_t result = ZE_RESULT_SUCCESS;
+      void *memory = allocate(context, device, memory_type,
+                              middle * probe_granularity_, &result);
+      if (result == ZE_RESULT_SUCCESS && memory != nullptr) {
+        EXPECT_EQ(ZE_RESULT_SUCCESS, zeMemFree(context, memory));
+        low = middle;
+      } else {
+        high = middle - 1;
+      }
+    }
+    return low * probe_granularity_;
+  }
+
+  void replay(const std::vector<AllocationEvent> &trace,
+              ze_memory_type_t memory_type) {
+    auto driver = lzt::get_default_driver();
+    auto device = lzt::get_default_device(driver);
+    auto context = lzt::create_context(driver);
+    auto device_properties = lzt::get_device_properties(device);
+    const size_t upper_limit = device_properties.maxMemAllocSize;
+
+    struct ProbeSample {
+      size_t operation;
+      uint64_t live_bytes;
+      size_t max_allocation;
+    };
+    std::vector<ProbeSample> probes;
+    std::vector<double> allocate_us, free_us;
+    std::map<uint64_t, std::pair<void *, size_t>> live;
+    uint64_t live_bytes = 0, failed_allocations = 0;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+      if (i % probe_interval_ == 0) {
+        probes.push_back({i, live_bytes,
+                          probe_max_allocation(context, device, memory_type,
+                                               upper_limit)});
+      }
+      const auto &event = trace[i];
+      if (event.allocate) {
+        ze_result_t result = ZE_RESULT_SUCCESS;
+        const auto start = std::chrono::steady_clock::now();
+        void *memory =
+            allocate(context, device, memory_type, event.size, &result);
+        const auto end = std::chrono::steady_clock::now();
+        if (result != ZE_RESULT_SUCCESS || memory == nullptr) {
+          failed_allocations++;
+          continue;
+        }
+        allocate_us.push_back(
+            std::chrono::duration<double, std::micro>(end - start).count());
+        if (live.count(event.id)) {
+          LOG_WARNING << "Allocation id " << event.id
+                      << " is reused before it is freed";
+          EXPECT_EQ(ZE_RESULT_SUCCESS,
+                    zeMemFree(context, live[event.id].first));
+          live_bytes -= live[event.id].second;
+        }
+        live[event.id] = {memory, event.size};
+        live_bytes += event.size;
+      } else {
+        auto allocation = live.find(event.id);
+        if (allocation == live.end()) {
+          continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(ZE_RESULT_SUCCESS,
+                  zeMemFree(context, allocation->second.first));
+        const auto end = std::chrono::steady_clock::now();
+        free_us.push_back(
+            std::chrono::duration<double, std::micro>(end - start).count());
+        live_bytes -= allocation->second.second;
+        live.erase(allocation);
+      }
+    }
+    probes.push_back({trace.size(), live_bytes,
+                      probe_max_allocation(context, device, memory_type,
+                                           upper_limit)});
+    for (auto &allocation : live) {
+      EXPECT_EQ(ZE_RESULT_SUCCESS,
+                zeMemFree(context, allocation.second.first));
+    }
+    lzt::destroy_context(context);
+
+    LOG_INFO << print_allocation_type(memory_type) << " memory, "
+             << trace.size() << " operations, " << failed_allocations
+             << " failed allocations";
+    print_latency("Allocation", allocate_us);
+    print_latency("Free", free_us);
+    size_t lowest = probes.front().max_allocation;
+    for (auto &probe : probes) {
+      LOG_INFO << "After " << probe.operation << " operations with "
+               << probe.live_bytes / 1024 << " KB live: max allocation "
+               << probe.max_allocation / (1024 * 1024) << " MB";
+      lowest = std::min(lowest, probe.max_allocation);
+    }
+    if (lowest < probes.front().max_allocation) {
+      LOG_INFO << "Max allocation shrank from "
+               << probes.front().max_allocation / (1024 * 1024) << " MB to "
+               << lowest / (1024 * 1024) << " MB during the trace";
+    }
+    record_soak_operations(trace.size());
+  }
+
+  const size_t alignment_ = 1;
+  const size_t probe_interval_ = 1000;
+  const size_t probe_granularity_ = 2 * 1024 * 1024;
+  const uint32_t allocation_count_ = 10000;
+};
+
+class zeDriverSyntheticAllocationTraceStressTest
+    : public zeDriverMemoryAllocationTraceStressTest,
+      public ::testing::WithParamInterface<
+          std::tuple<SizeDistribution, ze_memory_type_t>> {};
+
+TEST_P(zeDriverSyntheticAllocationTraceStressTest,
+       ReplaySyntheticAllocationTrace) {
+  const SizeDistribution distribution = std::get<0>(GetParam());
+  const ze_memory_type_t memory_type = std::get<1>(GetParam());
+
+  auto device = lzt::get_default_device(lzt::get_default_driver());
+  auto device_memory_properties = lzt::get_memory_properties(device);
+  // A quarter of the memory stays free for the max allocation probes
+  uint64_t live_limit =
+      std::min(device_memory_properties[0].totalSize,
+               total_available_host_memory()) /
+      4;
+  replay(synthetic_trace(distribution, allocation_count_, live_limit),
+         memory_type);
+}
+
+// Replays the trace file given with LZT_ALLOCATION_TRACE
+class zeDriverAllocationTraceFileStressTest
+    : public zeDriverMemoryAllocationTraceStressTest,
+      public ::testing::WithParamInterface<ze_memory_type_t> {};
+
+TEST_P(zeDriverAllocationTraceFileStressTest, ReplayAllocationTraceFile) {
+  const char *path = getenv("LZT_ALLOCATION_TRACE");
+  if (path == nullptr) {
+    LOG_INFO << "LZT_ALLOCATION_TRACE is not set";
+    GTEST_SKIP();
+  }
+  auto trace = read_allocation_trace(path);
+  ASSERT_FALSE(trace.empty());
+  replay(trace, GetParam());
+}
+
+struct TraceTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    std::stringstream ss;
+    ss << to_string(std::get<0>(info.param)) << "_"
+       << print_allocation_type(std::get<1>(info.param));
+    return ss.str();
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestAllocationTraces, zeDriverSyntheticAllocationTraceStressTest,
+    ::testing::Combine(::testing::Values(SizeDistribution::SMALL,
+                                         SizeDistribution::MIXED,
+                                         SizeDistribution::LARGE),
+                       ::testing::Values(ZE_MEMORY_TYPE_DEVICE,
+                                         ZE_MEMORY_TYPE_SHARED,
+                                         ZE_MEMORY_TYPE_HOST)),
+    TraceTestNameSuffix());
+INSTANTIATE_TEST_CASE_P(TestAllocationTraceFile,
+                        zeDriverAllocationTraceFileStressTest,
+                        ::testing::Values(ZE_MEMORY_TYPE_DEVICE,
+                                          ZE_MEMORY_TYPE_SHARED,
+                                          ZE_MEMORY_TYPE_HOST),
+                        [](const testing::TestParamInfo<ze_memory_type_t>
+                               &info) {
+                          return print_allocation_type(info.param);
+                        });
+
+} // namespace
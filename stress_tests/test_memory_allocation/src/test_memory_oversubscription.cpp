@@ -0,0 +1,205 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_common_func.hpp"
+#include "stress_soak.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace {
+
+// Streams over shared allocations larger than the device memory, so that
+// every pass has to evict pages and migrate them back.  The driver has no
+// page fault counter, so chunks taking much longer than a resident chunk
+// are counted as migrated.
+class zeDriverMemoryOversubscriptionStressTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<float> {
+protected:
+  const size_t chunk_size_ = 64 * 1024 * 1024;
+  const uint32_t workgroup_size_x_ = 256;
+  const uint32_t passes_ = 5;
+  // Chunk time over the resident chunk time counted as a migration
+  const double migration_threshold_ = 2.0;
+};
+
+TEST_P(zeDriverMemoryOversubscriptionStressTest,
+       StreamOverOversubscribedSharedMemory) {
+  const float oversubscription = GetParam();
+  auto driver = lzt::get_default_driver();
+  auto context = lzt::create_context(driver);
+  auto device = lzt::get_default_device(driver);
+
+  auto access_properties = lzt::get_memory_access_properties(device);
+  if (!(access_properties.sharedSingleDeviceAllocCapabilities &
+        ZE_MEMORY_ACCESS_CAP_FLAG_RW)) {
+    LOG_INFO << "Shared memory is not supported";
+    lzt::destroy_context(context);
+    GTEST_SKIP();
+  }
+
+  uint64_t device_memory = 0;
+  for (auto &properties : lzt::get_memory_properties(device)) {
+    device_memory += properties.totalSize;
+  }
+  const uint32_t chunk_count = static_cast<uint32_t>(
+      oversubscription * device_memory / chunk_size_);
+  const uint64_t total_size = static_cast<uint64_t>(chunk_count) * chunk_size_;
+  if (total_size > 0.8 * total_available_host_memory()) {
+    LOG_INFO << "Not enough host memory to back " << total_size
+             << " bytes of shared memory";
+    lzt::destroy_context(context);
+    GTEST_SKIP();
+  }
+  LOG_INFO << "Device memory " << device_memory << " bytes, streaming over "
+           << chunk_count << " shared chunks of " << chunk_size_ << " bytes";
+
+  // Every chunk is first touched on the host, so that it starts there
+  const size_t chunk_elements = chunk_size_ / sizeof(uint32_t);
+  std::vector<uint32_t *> chunks;
+  for (uint32_t i = 0; i < chunk_count; i++) {
+    chunks.push_back(allocate_memory<uint32_t>(
+        context, device, ZE_MEMORY_TYPE_SHARED, chunk_size_, false));
+    std::fill(chunks.back(), chunks.back() + chunk_elements, i);
+  }
+
+  ze_module_handle_t module_handle = lzt::create_module(
+      context, device, "test_multiple_memory_allocations.spv",
+      ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+  ze_kernel_handle_t kernel_handle =
+      lzt::create_function(module_handle, "test_device_memory1_unit_size4");
+  lzt::set_group_size(kernel_handle, workgroup_size_x_, 1, 1);
+  ze_group_count_t thread_group_dimensions = {
+      static_cast<uint32_t>(chunk_elements / workgroup_size_x_), 1, 1};
+
+  auto event_pool = lzt::create_event_pool(
+      context, chunk_count + 1,
+      ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+  std::vector<ze_event_handle_t> events(chunk_count + 1);
+  for (uint32_t i = 0; i <= chunk_count; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    events[i] = lzt::create_event(event_pool, event_desc);
+  }
+  const auto clock = lzt::get_timestamp_clock(device);
+  ze_command_queue_handle_t command_queue = lzt::create_command_queue(
+      context, device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+      ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+
+  // The second of two passes over the first chunk gives the resident time
+  ze_command_list_handle_t resident_list =
+      lzt::create_command_list(context, device, 0);
+  lzt::set_argument_value(kernel_handle, 0, sizeof(chunks[0]), &chunks[0]);
+  lzt::set_argument_value(kernel_handle, 1, sizeof(chunks[0]), &chunks[0]);
+  for (int launch = 0; launch < 2; launch++) {
+    lzt::append_launch_function(
+        resident_list, kernel_handle, &thread_group_dimensions,
+        (launch == 1) ? events[chunk_count] : nullptr, 0, nullptr);
+    lzt::append_barrier(resident_list, nullptr);
+  }
+  lzt::close_command_list(resident_list);
+  lzt::execute_command_lists(command_queue, 1, &resident_list, nullptr);
+  lzt::synchronize(command_queue, UINT64_MAX);
+  lzt::destroy_command_list(resident_list);
+  const double resident_ns =
+      clock.duration_ns(lzt::get_event_kernel_timestamp(events[chunk_count])
+                            .global);
+  LOG_INFO << "Resident chunk: " << 2 * chunk_size_ / resident_ns << " GB/s";
+
+  ze_command_list_handle_t command_list =
+      lzt::create_command_list(context, device, 0);
+  for (uint32_t i = 0; i < chunk_count; i++) {
+    lzt::set_argument_value(kernel_handle, 0, sizeof(chunks[i]), &chunks[i]);
+    lzt::set_argument_value(kernel_handle, 1, sizeof(chunks[i]), &chunks[i]);
+    lzt::append_launch_function(command_list, kernel_handle,
+                                &thread_group_dimensions, events[i], 0,
+                                nullptr);
+    lzt::append_barrier(command_list, nullptr);
+  }
+  lzt::close_command_list(command_list);
+
+  const uint64_t pages_per_chunk = chunk_size_ / get_page_size();
+  for (uint32_t pass = 0; pass < passes_; pass++) {
+    const auto pass_start = std::chrono::steady_clock::now();
+    lzt::execute_command_lists(command_queue, 1, &command_list, nullptr);
+    lzt::synchronize(command_queue, UINT64_MAX);
+    const double pass_seconds = std::chrono::duration<double>(
+                                    std::chrono::steady_clock::now() -
+                                    pass_start)
+                                    .count();
+
+    uint32_t migrated_chunks = 0;
+    for (uint32_t i = 0; i < chunk_count; i++) {
+      const double chunk_ns =
+          clock.duration_ns(lzt::get_event_kernel_timestamp(events[i]).global);
+      if (chunk_ns > migration_threshold_ * resident_ns) {
+        migrated_chunks++;
+      }
+      lzt::event_host_reset(events[i]);
+    }
+    // Every byte is read and written once per pass
+    LOG_INFO << oversubscription << "x oversubscription pass " << pass
+             << ": " << 2 * total_size / pass_seconds / 1e9 << " GB/s, "
+             << migrated_chunks << " of " << chunk_count
+             << " chunks migrated, "
+             << migrated_chunks * pages_per_chunk / pass_seconds
+             << " page migrations/s";
+  }
+  record_soak_operations(static_cast<uint64_t>(chunk_count) * passes_);
+
+  // The kernel copies every chunk onto itself, so the host fill survives
+  bool memory_test_failure = false;
+  for (uint32_t i = 0; i < chunk_count; i++) {
+    if (chunks[i][0] != i || chunks[i][chunk_elements - 1] != i) {
+      LOG_ERROR << "Chunk " << i << " corrupted after migration";
+      memory_test_failure = true;
+      break;
+    }
+  }
+
+  lzt::destroy_command_list(command_list);
+  lzt::destroy_command_queue(command_queue);
+  for (auto event : events) {
+    lzt::destroy_event(event);
+  }
+  lzt::destroy_event_pool(event_pool);
+  lzt::destroy_function(kernel_handle);
+  lzt::destroy_module(module_handle);
+  for (auto chunk : chunks) {
+    lzt::free_memory(context, chunk);
+  }
+  lzt::destroy_context(context);
+  EXPECT_EQ(false, memory_test_failure);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    TestMemoryOversubscription, zeDriverMemoryOversubscriptionStressTest,
+    ::testing::Values(1.5f, 2.0f, 4.0f),
+    [](const testing::TestParamInfo<float> &info) {
+      const uint32_t tenths = static_cast<uint32_t>(info.param * 10);
+      std::stringstream ss;
+      ss << tenths / 10;
+      if (tenths % 10) {
+        ss << "_" << tenths % 10;
+      }
+      ss << "x";
+      return ss.str();
+    });
+
+} // namespace
@@ -0,0 +1,323 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_common_func.hpp"
+#include "stress_soak.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+namespace {
+
+const size_t kilobyte = 1024;
+const size_t megabyte = 1024 * kilobyte;
+const size_t gigabyte = 1024 * megabyte;
+
+// Runs a streaming and a random-access kernel over growing footprints of one
+// buffer, either allocated with zeMemAllocDevice aligned to a page size hint
+// or reserved and mapped with physical pages of a given size.  The random
+// access walks a ring with one node per 4 KB of the footprint, so every hop
+// lands in another page and the hop latency jumps once the footprint
+// outgrows what the device TLBs reach with the page size in use.  The
+// parameters are whether the buffer is mapped and the page size, 0 for
+// the driver default.
+class zeDriverTlbReachStressTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<std::tuple<bool, size_t>> {
+protected:
+  void SetUp() override {
+    driver_ = lzt::get_default_driver();
+    context_ = lzt::create_context(driver_);
+    device_ = lzt::get_default_device(driver_);
+    module_ = lzt::create_module(context_, device_,
+                                 "test_memory_tlb_reach.spv",
+                                 ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+    stream_kernel_ = lzt::create_function(module_, "tlb_stream");
+    walk_kernel_ = lzt::create_function(module_, "tlb_random_walk");
+    command_list_ = lzt::create_immediate_command_list(
+        context_, device_, 0, ZE_COMMAND_QUEUE_MODE_SYNCHRONOUS,
+        ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0, 0);
+    event_pool_ = lzt::create_event_pool(
+        context_, 1,
+        ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    event_ = lzt::create_event(event_pool_, event_desc);
+    sums_ = lzt::allocate_device_memory(stream_groups_ * stream_group_size_ *
+                                            sizeof(uint32_t),
+                                        1, 0, 0, device_, context_);
+    positions_ = lzt::allocate_device_memory(max_walkers_ * sizeof(uint32_t),
+                                             1, 0, 0, device_, context_);
+  }
+
+  void TearDown() override {
+    lzt::free_memory(context_, positions_);
+    lzt::free_memory(context_, sums_);
+    lzt::destroy_event(event_);
+    lzt::destroy_event_pool(event_pool_);
+    lzt::destroy_command_list(command_list_);
+    lzt::destroy_function(walk_kernel_);
+    lzt::destroy_function(stream_kernel_);
+    lzt::destroy_module(module_);
+    lzt::destroy_context(context_);
+  }
+
+  // Launches the kernel twice, the first launch warming up the page
+  // tables, and returns the time of the second one in ns
+  double kernel_ns(ze_kernel_handle_t kernel,
+                   const ze_group_count_t &group_count) {
+    lzt::append_launch_function(command_list_, kernel, &group_count, nullptr,
+                                0, nullptr);
+    lzt::event_host_reset(event_);
+    lzt::append_launch_function(command_list_, kernel, &group_count, event_,
+                                0, nullptr);
+    return lzt::get_timestamp_clock(device_).duration_ns(
+        lzt::get_event_kernel_timestamp(event_).global);
+  }
+
+  // Reads the footprint from the start of the buffer, returning the
+  // bandwidth in GB/s
+  double stream_bandwidth(void *buffer, size_t footprint) {
+    const uint64_t count = footprint / sizeof(uint32_t);
+    const uint32_t groups = static_cast<uint32_t>(
+        std::min<uint64_t>(stream_groups_, count / stream_group_size_));
+    lzt::set_group_size(stream_kernel_, stream_group_size_, 1, 1);
+    lzt::set_argument_value(stream_kernel_, 0, sizeof(buffer), &buffer);
+    lzt::set_argument_value(stream_kernel_, 1, sizeof(sums_), &sums_);
+    lzt::set_argument_value(stream_kernel_, 2, sizeof(count), &count);
+    return footprint / kernel_ns(stream_kernel_, {groups, 1, 1});
+  }
+
+  // Links one node per node_stride_ bytes of the footprint, at a random
+  // cache line of its stride, into one ring in random order, and walks it
+  // from evenly spaced nodes.  Returns the latency of one hop in ns and
+  // the hops of all walkers per us in lookup_rate.
+  double random_walk_latency(void *buffer, size_t footprint,
+                             double &lookup_rate) {
+    const size_t nodes = footprint / node_stride_;
+    const uint32_t stride_elements = node_stride_ / sizeof(uint32_t);
+    const uint32_t line_elements = line_size_ / sizeof(uint32_t);
+    std::mt19937 generator(static_cast<uint32_t>(nodes));
+    std::uniform_int_distribution<uint32_t> line_distribution(
+        0, node_stride_ / line_size_ - 1);
+    std::vector<uint32_t> element(nodes);
+    for (size_t k = 0; k < nodes; k++) {
+      element[k] = static_cast<uint32_t>(k) * stride_elements +
+                   line_distribution(generator) * line_elements;
+    }
+    std::vector<uint32_t> order(nodes);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), generator);
+    std::vector<uint32_t> next(nodes);
+    for (size_t j = 0; j < nodes; j++) {
+      next[order[j]] = element[order[(j + 1) % nodes]];
+    }
+
+    // Only the nodes are written, the rest of every chunk is never read
+    const size_t chunk_size = std::min(footprint, staging_size_);
+    const size_t chunk_nodes = chunk_size / node_stride_;
+    std::vector<uint32_t> staging(chunk_size / sizeof(uint32_t), 0);
+    for (size_t offset = 0; offset < footprint; offset += chunk_size) {
+      const size_t first = offset / node_stride_;
+      for (size_t k = first; k < first + chunk_nodes; k++) {
+        staging[element[k] - first * stride_elements] = next[k];
+      }
+      lzt::append_memory_copy(command_list_,
+                              static_cast<char *>(buffer) + offset,
+                              staging.data(), chunk_size);
+      for (size_t k = first; k < first + chunk_nodes; k++) {
+        staging[element[k] - first * stride_elements] = 0;
+      }
+    }
+
+    const uint32_t walkers =
+        static_cast<uint32_t>(std::min<size_t>(max_walkers_, nodes));
+    std::vector<uint32_t> positions(walkers);
+    for (uint32_t w = 0; w < walkers; w++) {
+      positions[w] = element[order[w * nodes / walkers]];
+    }
+    lzt::append_memory_copy(command_list_, positions_, positions.data(),
+                            walkers * sizeof(uint32_t));
+
+    const uint32_t group_size = std::min(walkers, walk_group_size_);
+    lzt::set_group_size(walk_kernel_, group_size, 1, 1);
+    lzt::set_argument_value(walk_kernel_, 0, sizeof(buffer), &buffer);
+    lzt::set_argument_value(walk_kernel_, 1, sizeof(positions_),
+                            &positions_);
+    lzt::set_argument_value(walk_kernel_, 2, sizeof(hops_), &hops_);
+    const double walk_ns =
+        kernel_ns(walk_kernel_, {walkers / group_size, 1, 1});
+    lookup_rate = 1000.0 * walkers * hops_ / walk_ns;
+    return walk_ns / hops_;
+  }
+
+  ze_driver_handle_t driver_ = nullptr;
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+  ze_module_handle_t module_ = nullptr;
+  ze_kernel_handle_t stream_kernel_ = nullptr;
+  ze_kernel_handle_t walk_kernel_ = nullptr;
+  ze_command_list_handle_t command_list_ = nullptr;
+  ze_event_pool_handle_t event_pool_ = nullptr;
+  ze_event_handle_t event_ = nullptr;
+  void *sums_ = nullptr;
+  void *positions_ = nullptr;
+
+  const size_t min_footprint_ = megabyte;
+  const size_t max_footprint_ = 4 * gigabyte;
+  const size_t staging_size_ = 64 * megabyte;
+  const size_t node_stride_ = 4 * kilobyte;
+  const size_t line_size_ = 64;
+  const uint32_t max_walkers_ = 4096;
+  const uint32_t walk_group_size_ = 64;
+  const uint32_t hops_ = 512;
+  const uint32_t stream_groups_ = 1024;
+  const uint32_t stream_group_size_ = 256;
+  // Hop latency growth over the footprint before reported as a cliff
+  const double cliff_ratio_ = 1.3;
+};
+
+TEST_P(zeDriverTlbReachStressTest,
+       GivenPageSizeWhenGrowingFootprintThenReportStreamAndRandomAccess) {
+  const bool mapped = std::get<0>(GetParam());
+  size_t page_size = std::get<1>(GetParam());
+  const auto device_properties = lzt::get_device_properties(device_);
+
+  // Keep the buffer within a quarter of the device memory, and a single
+  // allocation within maxMemAllocSize, in a power of two
+  uint64_t device_memory = 0;
+  for (auto &properties : lzt::get_memory_properties(device_)) {
+    device_memory += properties.totalSize;
+  }
+  uint64_t limit = std::min<uint64_t>(max_footprint_, device_memory / 4);
+  if (!mapped) {
+    limit = std::min<uint64_t>(limit, device_properties.maxMemAllocSize);
+  }
+  size_t footprint_limit = min_footprint_;
+  while (2 * footprint_limit <= limit) {
+    footprint_limit *= 2;
+  }
+
+  void *buffer = nullptr;
+  std::vector<ze_physical_mem_handle_t> physical_memory;
+  size_t reservation_size = 0;
+  if (mapped) {
+    size_t granularity = 0;
+    if (page_size == 0) {
+      lzt::query_page_size(context_, device_, footprint_limit, &page_size);
+    } else {
+      lzt::query_page_size(context_, device_, 1, &granularity);
+      page_size = (page_size + granularity - 1) / granularity * granularity;
+    }
+    if (page_size > footprint_limit) {
+      LOG_INFO << "Not enough device memory for " << page_size
+               << " bytes pages";
+      GTEST_SKIP();
+    }
+    reservation_size =
+        (footprint_limit + page_size - 1) / page_size * page_size;
+    lzt::virtual_memory_reservation(context_, nullptr, reservation_size,
+                                    &buffer);
+    ASSERT_NE(nullptr, buffer);
+    physical_memory.resize(reservation_size / page_size, nullptr);
+    for (size_t page = 0; page < physical_memory.size(); page++) {
+      lzt::physical_memory_allocation(context_, device_, page_size,
+                                      &physical_memory[page]);
+      lzt::virtual_memory_map(context_,
+                              static_cast<char *>(buffer) + page * page_size,
+                              page_size, physical_memory[page], 0,
+                              ZE_MEMORY_ACCESS_ATTRIBUTE_READWRITE);
+    }
+    LOG_INFO << "Buffer of " << footprint_limit << " bytes mapped with "
+             << physical_memory.size() << " physical pages of " << page_size
+             << " bytes";
+  } else {
+    buffer = lzt::allocate_device_memory(footprint_limit, page_size, 0, 0,
+                                         device_, context_);
+    ze_memory_allocation_properties_t properties = {
+        ZE_STRUCTURE_TYPE_MEMORY_ALLOCATION_PROPERTIES};
+    lzt::get_mem_alloc_properties(context_, buffer, &properties);
+    LOG_INFO << "Buffer of " << footprint_limit
+             << " bytes allocated with alignment " << page_size
+             << ", driver page size " << properties.pageSize << " bytes";
+  }
+
+  double first_hop_ns = 0;
+  double previous_hop_ns = 0;
+  uint32_t footprints = 0;
+  for (size_t footprint = min_footprint_; footprint <= footprint_limit;
+       footprint *= 2, footprints++) {
+    const double bandwidth = stream_bandwidth(buffer, footprint);
+    double lookup_rate = 0;
+    const double hop_ns = random_walk_latency(buffer, footprint, lookup_rate);
+    if (first_hop_ns == 0) {
+      first_hop_ns = hop_ns;
+    }
+    std::stringstream cliff;
+    if (previous_hop_ns > 0 && hop_ns > cliff_ratio_ * previous_hop_ns) {
+      cliff << " <- cliff, x" << hop_ns / previous_hop_ns;
+    }
+    previous_hop_ns = hop_ns;
+    LOG_INFO << "  " << footprint / kilobyte << " KB: stream " << bandwidth
+             << " GB/s, random hop " << hop_ns << " ns ("
+             << hop_ns / first_hop_ns << "x), " << lookup_rate
+             << " lookups/us" << cliff.str();
+  }
+  record_soak_operations(footprints);
+
+  if (mapped) {
+    for (size_t page = 0; page < physical_memory.size(); page++) {
+      lzt::virtual_memory_unmap(
+          context_, static_cast<char *>(buffer) + page * page_size, page_size);
+      lzt::physical_memory_destroy(context_, physical_memory[page]);
+    }
+    lzt::virtual_memory_free(context_, buffer, reservation_size);
+  } else {
+    lzt::free_memory(context_, buffer);
+  }
+}
+
+struct TlbReachTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    std::stringstream ss;
+    ss << (std::get<0>(info.param) ? "mapped_" : "allocated_");
+    if (std::get<1>(info.param) == 0) {
+      ss << "default_pages";
+    } else {
+      ss << std::get<1>(info.param) / kilobyte << "KB_pages";
+    }
+    return ss.str();
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestTlbReachAllocated, zeDriverTlbReachStressTest,
+    ::testing::Combine(::testing::Values(false),
+                       ::testing::Values(0, 64 * kilobyte, 2 * megabyte)),
+    TlbReachTestNameSuffix());
+
+INSTANTIATE_TEST_CASE_P(
+    TestTlbReachMapped, zeDriverTlbReachStressTest,
+    ::testing::Combine(::testing::Values(true),
+                       ::testing::Values(0, 64 * kilobyte, 2 * megabyte,
+                                         64 * megabyte)),
+    TlbReachTestNameSuffix());
+
+} // namespace
@@ -0,0 +1,241 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_common_func.hpp"
+#include "stress_soak.hpp"
+
+namespace lzt = level_zero_tests;
+
+#include <level_zero/ze_api.h>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock mapping_clock;
+
+double elapsed_us(mapping_clock::time_point start) {
+  const auto elapsed = mapping_clock::now() - start;
+  return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+// Maps thousands of physical pages into one large reservation from several
+// threads, each thread owning a contiguous range of the pages, as a
+// growable heap would.  The parameters are the thread count and the size of
+// every physical page in multiples of the driver page size.
+class zeDriverVirtualMemoryMappingStressTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<std::tuple<uint32_t, uint32_t>> {
+protected:
+  // Runs the operation on every page from the threads, returning the
+  // latency of every call in us and the calls per second of all threads
+  template <typename Operation>
+  double run_on_pages(uint32_t thread_count, uint32_t page_count,
+                      std::vector<double> &latencies, Operation operation) {
+    std::vector<std::vector<double>> thread_latencies(thread_count);
+    std::vector<std::thread> threads;
+    const auto start = mapping_clock::now();
+    for (uint32_t t = 0; t < thread_count; t++) {
+      threads.emplace_back([&, t]() {
+        const uint32_t first = t * page_count / thread_count;
+        const uint32_t last = (t + 1) * page_count / thread_count;
+        for (uint32_t page = first; page < last; page++) {
+          const auto call_start = mapping_clock::now();
+          operation(page);
+          thread_latencies[t].push_back(elapsed_us(call_start));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    const double seconds = elapsed_us(start) / 1e6;
+    latencies.clear();
+    for (auto &values : thread_latencies) {
+      latencies.insert(latencies.end(), values.begin(), values.end());
+    }
+    return page_count / seconds;
+  }
+
+  void print_latencies(const std::string &name, double rate,
+                       const std::vector<double> &latencies) {
+    LOG_INFO << name << ": " << rate << " calls/s, us per call p50 "
+             << lzt::median(latencies) << " p99 "
+             << lzt::percentile(latencies, 99) << " max "
+             << lzt::percentile(latencies, 100);
+  }
+
+  // Copies the first half of the buffer to the second half, returning the
+  // bandwidth in GB/s
+  double copy_bandwidth(ze_context_handle_t context, ze_device_handle_t device,
+                        ze_module_handle_t module, void *buffer, size_t size) {
+    uint32_t *source = static_cast<uint32_t *>(buffer);
+    uint32_t *destination = source + size / 2 / sizeof(uint32_t);
+    ze_kernel_handle_t kernel =
+        lzt::create_function(module, "test_device_memory1_unit_size4");
+    lzt::set_group_size(kernel, workgroup_size_x_, 1, 1);
+    lzt::set_argument_value(kernel, 0, sizeof(source), &source);
+    lzt::set_argument_value(kernel, 1, sizeof(destination), &destination);
+    ze_group_count_t group_count = {
+        static_cast<uint32_t>(size / 2 / sizeof(uint32_t) / workgroup_size_x_),
+        1, 1};
+
+    auto event_pool = lzt::create_event_pool(
+        context, 1,
+        ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    auto event = lzt::create_event(event_pool, event_desc);
+    const uint32_t pattern = 0x5A5A5A5A;
+    std::vector<uint32_t> data_out(size / 2 / sizeof(uint32_t), 0);
+
+    // The first copy warms up the page tables, only the second one is timed
+    ze_command_list_handle_t command_list =
+        lzt::create_command_list(context, device, 0);
+    lzt::append_memory_fill(command_list, source, &pattern, sizeof(pattern),
+                            size / 2, nullptr);
+    lzt::append_barrier(command_list, nullptr);
+    for (int launch = 0; launch < 2; launch++) {
+      lzt::append_launch_function(command_list, kernel, &group_count,
+                                  (launch == 1) ? event : nullptr, 0, nullptr);
+      lzt::append_barrier(command_list, nullptr);
+    }
+    lzt::append_memory_copy(command_list, data_out.data(), destination,
+                            size / 2, nullptr);
+    lzt::close_command_list(command_list);
+    ze_command_queue_handle_t command_queue = lzt::create_command_queue(
+        context, device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+        ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+    lzt::execute_command_lists(command_queue, 1, &command_list, nullptr);
+    lzt::synchronize(command_queue, UINT64_MAX);
+    const double copy_ns = lzt::get_timestamp_clock(device).duration_ns(
+        lzt::get_event_kernel_timestamp(event).global);
+
+    const size_t mismatches =
+        data_out.size() - std::count(data_out.begin(), data_out.end(), pattern);
+    EXPECT_EQ(0u, mismatches) << "Copy over the mapping corrupted data";
+
+    lzt::destroy_command_queue(command_queue);
+    lzt::destroy_command_list(command_list);
+    lzt::destroy_event(event);
+    lzt::destroy_event_pool(event_pool);
+    lzt::destroy_function(kernel);
+    return size / copy_ns;
+  }
+
+  const uint32_t max_page_count_ = 4096;
+  const uint32_t workgroup_size_x_ = 256;
+};
+
+TEST_P(zeDriverVirtualMemoryMappingStressTest,
+       MapAndUnmapPagesFromManyThreads) {
+  const uint32_t thread_count = std::get<0>(GetParam());
+  const uint32_t pages_per_mapping = std::get<1>(GetParam());
+  auto driver = lzt::get_default_driver();
+  auto context = lzt::create_context(driver);
+  auto device = lzt::get_default_device(driver);
+
+  size_t driver_page_size = 0;
+  lzt::query_page_size(context, device, 1, &driver_page_size);
+  const size_t page_size = driver_page_size * pages_per_mapping;
+
+  // Keep the physical memory within a quarter of the device memory
+  uint64_t device_memory = 0;
+  for (auto &properties : lzt::get_memory_properties(device)) {
+    device_memory += properties.totalSize;
+  }
+  // The copy bandwidth needs an even page count to split the mapping
+  uint32_t page_count = static_cast<uint32_t>(
+      std::min<uint64_t>(max_page_count_, device_memory / 4 / page_size));
+  page_count &= ~1u;
+  if (page_count < 2) {
+    LOG_INFO << "Not enough device memory for " << page_size << " bytes pages";
+    lzt::destroy_context(context);
+    GTEST_SKIP();
+  }
+  const size_t size = page_size * page_count;
+  LOG_INFO << "Mapping " << page_count << " pages of " << page_size
+           << " bytes from " << thread_count << " threads";
+
+  void *reservation = nullptr;
+  lzt::virtual_memory_reservation(context, nullptr, size, &reservation);
+  ASSERT_NE(nullptr, reservation);
+  std::vector<ze_physical_mem_handle_t> physical_memory(page_count, nullptr);
+  auto page_address = [&](uint32_t page) {
+    return static_cast<char *>(reservation) + page * page_size;
+  };
+
+  std::vector<double> latencies;
+  double rate = run_on_pages(thread_count, page_count, latencies,
+                             [&](uint32_t page) {
+                               lzt::physical_memory_allocation(
+                                   context, device, page_size,
+                                   &physical_memory[page]);
+                             });
+  print_latencies("zePhysicalMemCreate", rate, latencies);
+  rate = run_on_pages(thread_count, page_count, latencies, [&](uint32_t page) {
+    lzt::virtual_memory_map(context, page_address(page), page_size,
+                            physical_memory[page], 0,
+                            ZE_MEMORY_ACCESS_ATTRIBUTE_READWRITE);
+  });
+  print_latencies("zeVirtualMemMap", rate, latencies);
+
+  ze_module_handle_t module = lzt::create_module(
+      context, device, "test_multiple_memory_allocations.spv",
+      ZE_MODULE_FORMAT_IL_SPIRV, "", nullptr);
+  const double mapped_bandwidth =
+      copy_bandwidth(context, device, module, reservation, size);
+  void *allocation =
+      lzt::allocate_device_memory(size, 1, 0, 0, device, context);
+  const double allocated_bandwidth =
+      copy_bandwidth(context, device, module, allocation, size);
+  lzt::free_memory(context, allocation);
+  LOG_INFO << "Kernel copy over the mapping " << mapped_bandwidth
+           << " GB/s, over a single allocation " << allocated_bandwidth
+           << " GB/s";
+
+  rate = run_on_pages(thread_count, page_count, latencies, [&](uint32_t page) {
+    lzt::virtual_memory_unmap(context, page_address(page), page_size);
+  });
+  print_latencies("zeVirtualMemUnmap", rate, latencies);
+  rate = run_on_pages(thread_count, page_count, latencies, [&](uint32_t page) {
+    lzt::physical_memory_destroy(context, physical_memory[page]);
+  });
+  print_latencies("zePhysicalMemDestroy", rate, latencies);
+  record_soak_operations(page_count);
+
+  lzt::destroy_module(module);
+  lzt::virtual_memory_free(context, reservation, size);
+  lzt::destroy_context(context);
+}
+
+struct MappingTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    std::stringstream ss;
+    ss << std::get<0>(info.param) << "_threads_" << std::get<1>(info.param)
+       << "_driver_pages_per_mapping";
+    return ss.str();
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(
+    TestVirtualMemoryMapping, zeDriverVirtualMemoryMappingStressTest,
+    ::testing::Combine(::testing::Values(1, 4, 16),
+                       ::testing::Values(1, 16, 256)),
+    MappingTestNameSuffix());
+
+} // namespace
@@ -13,6 +13,7 @@
 #include <sys/mman.h>
 #endif
 #include "stress_common_func.hpp"
+#include "stress_soak.hpp"
 
 void reserve_memory(bool release) {
   size_t page_size = get_page_size();
@@ -69,13 +70,19 @@ int main(int argc, char **argv) {
   ::testing::InitGoogleMock(&argc, argv);
   std::vector<std::string> command_line(argv + 1, argv + argc);
   level_zero_tests::init_logging(command_line);
+  init_soak_mode(command_line);
   std::string user_arg = "release_memory";
   bool release = false;
   if (std::find(command_line.begin(), command_line.end(), user_arg) !=
       command_line.end()) {
     release = true;
   }
-  reserve_memory(release);
+  // Leaving the 48 bit space free lets the performance test compare both
+  // placements
+  if (std::find(command_line.begin(), command_line.end(),
+                "keep_48b_address_space") == command_line.end()) {
+    reserve_memory(release);
+  }
   ze_result_t result = zeInit(0);
   if (result) {
     throw std::runtime_error("zeInit failed: " +
@@ -16,6 +16,7 @@
 namespace lzt = level_zero_tests;
 
 #include <level_zero/ze_api.h>
+#include <chrono>
 
 namespace {
 
@@ -78,4 +79,207 @@ TEST_F(zeRunDriverIn57bAddressSpace, CheckIfKernelCanBeExecuted) {
     EXPECT_EQ(init_value_1, output_allocation[i]);
   }
 }
+
+// Addresses from here on need 5-level paging
+constexpr uintptr_t address_space_48b_limit = 1ULL << 47;
+
+struct PlacementResult {
+  bool available;
+  double map_us;
+  double dispatch_us;
+  double bandwidth_gbps;
+};
+
+// Compares virtual memory reserved below and above the 48 bit limit.  The
+// main reserves the whole 48 bit space unless keep_48b_address_space is
+// given, so both placements are only measured with that argument on a host
+// with 5-level paging.
+class zeRunDriverIn57bAddressSpacePerformance : public ::testing::Test {
+protected:
+  // Reserves and maps two buffers at the hint, returning false when the
+  // driver placed them on the other side of the 48 bit limit
+  bool map_buffers(const void *hint, bool above_48b, void **memory,
+                   ze_physical_mem_handle_t *physical_memory) {
+    lzt::virtual_memory_reservation(context_, hint, 2 * size_, memory);
+    if ((reinterpret_cast<uintptr_t>(*memory) >= address_space_48b_limit) !=
+        above_48b) {
+      lzt::virtual_memory_free(context_, *memory, 2 * size_);
+      return false;
+    }
+    for (int i = 0; i < 2; i++) {
+      lzt::physical_memory_allocation(context_, device_, size_,
+                                      &physical_memory[i]);
+      lzt::virtual_memory_map(
+          context_, static_cast<char *>(*memory) + i * size_, size_,
+          physical_memory[i], 0, ZE_MEMORY_ACCESS_ATTRIBUTE_READWRITE);
+    }
+    return true;
+  }
+
+  void unmap_buffers(void *memory, ze_physical_mem_handle_t *physical_memory) {
+    lzt::virtual_memory_unmap(context_, memory, 2 * size_);
+    for (int i = 0; i < 2; i++) {
+      lzt::physical_memory_destroy(context_, physical_memory[i]);
+    }
+    lzt::virtual_memory_free(context_, memory, 2 * size_);
+  }
+
+  PlacementResult measure_placement(const void *hint, bool above_48b) {
+    PlacementResult result = {false, 0, 0, 0};
+    void *memory = nullptr;
+    ze_physical_mem_handle_t physical_memory[2] = {};
+
+    double map_ns = 0;
+    for (uint32_t i = 0; i < iterations_; i++) {
+      const auto start = std::chrono::steady_clock::now();
+      if (!map_buffers(hint, above_48b, &memory, physical_memory)) {
+        return result;
+      }
+      map_ns += std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+      unmap_buffers(memory, physical_memory);
+    }
+    result.available = map_buffers(hint, above_48b, &memory, physical_memory);
+    if (!result.available) {
+      return result;
+    }
+    result.map_us = map_ns / iterations_ / 1e3;
+    LOG_INFO << "Buffers reserved at " << memory;
+
+    uint32_t *source = static_cast<uint32_t *>(memory);
+    uint32_t *destination = source + size_ / sizeof(uint32_t);
+    ze_kernel_handle_t kernel = lzt::create_function(module_, "simple_test");
+    lzt::set_group_size(kernel, workgroup_size_x_, 1, 1);
+    lzt::set_argument_value(kernel, 0, sizeof(source), &source);
+    lzt::set_argument_value(kernel, 1, sizeof(destination), &destination);
+
+    // A single work group dispatch is dominated by the launch latency
+    ze_group_count_t one_group = {1, 1, 1};
+    ze_command_list_handle_t dispatch_list =
+        lzt::create_command_list(context_, device_, 0);
+    lzt::append_launch_function(dispatch_list, kernel, &one_group, nullptr, 0,
+                                nullptr);
+    lzt::close_command_list(dispatch_list);
+    double dispatch_ns = 0;
+    for (uint32_t i = 0; i <= iterations_; i++) {
+      const auto start = std::chrono::steady_clock::now();
+      lzt::execute_command_lists(queue_, 1, &dispatch_list, nullptr);
+      lzt::synchronize(queue_, UINT64_MAX);
+      // The first dispatch is a warm up
+      if (i > 0) {
+        dispatch_ns += std::chrono::duration<double, std::nano>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+      }
+    }
+    lzt::destroy_command_list(dispatch_list);
+    result.dispatch_us = dispatch_ns / iterations_ / 1e3;
+
+    auto event_pool = lzt::create_event_pool(
+        context_, 1,
+        ZE_EVENT_POOL_FLAG_HOST_VISIBLE | ZE_EVENT_POOL_FLAG_KERNEL_TIMESTAMP);
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, 0,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    auto event = lzt::create_event(event_pool, event_desc);
+    const uint32_t pattern = 0xAAAAAAAA;
+    std::vector<uint32_t> data_out(workgroup_size_x_, 0);
+    ze_group_count_t all_groups = {
+        static_cast<uint32_t>(size_ / sizeof(uint32_t) / workgroup_size_x_), 1,
+        1};
+    ze_command_list_handle_t copy_list =
+        lzt::create_command_list(context_, device_, 0);
+    lzt::append_memory_fill(copy_list, source, &pattern, sizeof(pattern),
+                            size_, nullptr);
+    lzt::append_barrier(copy_list, nullptr);
+    for (int launch = 0; launch < 2; launch++) {
+      lzt::append_launch_function(copy_list, kernel, &all_groups,
+                                  (launch == 1) ? event : nullptr, 0, nullptr);
+      lzt::append_barrier(copy_list, nullptr);
+    }
+    lzt::append_memory_copy(copy_list, data_out.data(), destination,
+                            data_out.size() * sizeof(uint32_t), nullptr);
+    lzt::close_command_list(copy_list);
+    lzt::execute_command_lists(queue_, 1, &copy_list, nullptr);
+    lzt::synchronize(queue_, UINT64_MAX);
+    const double copy_ns = lzt::get_timestamp_clock(device_).duration_ns(
+        lzt::get_event_kernel_timestamp(event).global);
+    result.bandwidth_gbps = 2 * size_ / copy_ns;
+    for (auto value : data_out) {
+      EXPECT_EQ(pattern, value);
+    }
+
+    lzt::destroy_command_list(copy_list);
+    lzt::destroy_event(event);
+    lzt::destroy_event_pool(event_pool);
+    lzt::destroy_function(kernel);
+    unmap_buffers(memory, physical_memory);
+    return result;
+  }
+
+  void SetUp() override {
+    auto driver = lzt::get_default_driver();
+    context_ = lzt::create_context(driver);
+    device_ = lzt::get_default_device(driver);
+    module_ =
+        lzt::create_module(context_, device_, "test_memory_reservation_57b.spv",
+                           ZE_MODULE_FORMAT_IL_SPIRV, nullptr, nullptr);
+    queue_ = lzt::create_command_queue(context_, device_, 0,
+                                       ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+                                       ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+    size_t page_size = 0;
+    lzt::query_page_size(context_, device_, buffer_size_, &page_size);
+    size_ = lzt::create_page_aligned_size(buffer_size_, page_size);
+  }
+
+  void TearDown() override {
+    lzt::destroy_command_queue(queue_);
+    lzt::destroy_module(module_);
+    lzt::destroy_context(context_);
+  }
+
+  const size_t buffer_size_ = 64 * 1024 * 1024;
+  const uint32_t workgroup_size_x_ = 256;
+  const uint32_t iterations_ = 100;
+  size_t size_ = 0;
+  ze_context_handle_t context_ = nullptr;
+  ze_device_handle_t device_ = nullptr;
+  ze_module_handle_t module_ = nullptr;
+  ze_command_queue_handle_t queue_ = nullptr;
+};
+
+TEST_F(zeRunDriverIn57bAddressSpacePerformance,
+       CompareMemoryPerformanceBelowAndAbove48bLimit) {
+  const struct {
+    const char *name;
+    const void *hint;
+    bool above_48b;
+  } placements[] = {
+      {"48 bit", reinterpret_cast<const void *>(1ULL << 44), false},
+      {"57 bit", reinterpret_cast<const void *>(1ULL << 52), true}};
+
+  std::vector<PlacementResult> results;
+  for (const auto &placement : placements) {
+    results.push_back(measure_placement(placement.hint, placement.above_48b));
+    const auto &result = results.back();
+    if (!result.available) {
+      LOG_INFO << "No " << placement.name << " placement available";
+      continue;
+    }
+    LOG_INFO << placement.name << " placement: reserve and map "
+             << result.map_us << " us, dispatch " << result.dispatch_us
+             << " us, bandwidth " << result.bandwidth_gbps << " GB/s";
+  }
+  if (!results[0].available && !results[1].available) {
+    GTEST_SKIP() << "The driver honored neither address hint";
+  }
+  if (results[0].available && results[1].available) {
+    LOG_INFO << "57 bit relative to 48 bit: reserve and map "
+             << results[1].map_us / results[0].map_us << "x, dispatch "
+             << results[1].dispatch_us / results[0].dispatch_us
+             << "x, bandwidth "
+             << results[1].bandwidth_gbps / results[0].bandwidth_gbps << "x";
+  }
+}
 } // namespace
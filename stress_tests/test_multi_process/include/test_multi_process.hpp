@@ -0,0 +1,41 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef _TEST_MULTI_PROCESS_HPP_
+#define _TEST_MULTI_PROCESS_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+// Shared between the test and its worker processes
+#define MULTI_PROCESS_SHARED_MEMORY "multi_process_stress_test"
+constexpr uint32_t max_worker_processes = 64;
+
+enum multi_process_workload_t {
+  WORKLOAD_DISPATCH = 0,
+  WORKLOAD_COPY,
+  WORKLOAD_ALLOCATION,
+  WORKLOAD_COUNT
+};
+
+struct WorkerResult {
+  std::atomic<uint32_t> ready;
+  // Operations of each workload, and the seconds the worker ran them for
+  uint64_t operations[WORKLOAD_COUNT];
+  double seconds;
+  uint32_t failed;
+};
+
+struct MultiProcessSharedData {
+  // Set by the test once every worker is ready, so that all of them run
+  // at the same time
+  std::atomic<uint32_t> start;
+  WorkerResult workers[max_worker_processes];
+};
+
+#endif /* _TEST_MULTI_PROCESS_HPP_ */
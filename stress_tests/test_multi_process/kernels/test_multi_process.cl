@@ -0,0 +1,11 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+kernel void multi_process_add_one(global uint *buffer) {
+  buffer[get_global_id(0)] += 1;
+}
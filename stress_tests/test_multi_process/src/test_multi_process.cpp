@@ -0,0 +1,166 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "gtest/gtest.h"
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "stress_soak.hpp"
+#include "test_multi_process.hpp"
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/process.hpp>
+
+#include <level_zero/ze_api.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+namespace lzt = level_zero_tests;
+namespace bipc = boost::interprocess;
+
+namespace {
+
+const char *workload_names[WORKLOAD_COUNT] = {"dispatch", "copy",
+                                              "allocation"};
+
+// Jain's fairness index of the worker throughputs, 1 when all of them are
+// equal and 1/n when one worker gets everything
+double fairness_index(const std::vector<double> &throughputs) {
+  double sum = 0, sum_of_squares = 0;
+  for (auto throughput : throughputs) {
+    sum += throughput;
+    sum_of_squares += throughput * throughput;
+  }
+  return (sum_of_squares > 0)
+             ? sum * sum / (throughputs.size() * sum_of_squares)
+             : 0;
+}
+
+// Runs the workload mix in several worker processes on the default device
+// at the same time and compares the throughput each of them gets
+class zeDriverMultiProcessStressTest
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<
+          std::tuple<uint32_t, std::vector<multi_process_workload_t>>> {
+protected:
+  const double duration_seconds_ = 10;
+  const std::chrono::seconds ready_timeout_{60};
+};
+
+TEST_P(zeDriverMultiProcessStressTest, RunConcurrentWorkerProcesses) {
+#ifdef __linux__
+  const uint32_t process_count = std::get<0>(GetParam());
+  const auto &workloads = std::get<1>(GetParam());
+
+  bipc::shared_memory_object::remove(MULTI_PROCESS_SHARED_MEMORY);
+  bipc::shared_memory_object shm(bipc::create_only,
+                                 MULTI_PROCESS_SHARED_MEMORY,
+                                 bipc::read_write);
+  shm.truncate(sizeof(MultiProcessSharedData));
+  bipc::mapped_region region(shm, bipc::read_write);
+  std::memset(region.get_address(), 0, sizeof(MultiProcessSharedData));
+  auto shared_data =
+      static_cast<MultiProcessSharedData *>(region.get_address());
+
+  std::stringstream workload_list;
+  for (size_t i = 0; i < workloads.size(); i++) {
+    workload_list << (i ? "," : "") << workloads[i];
+  }
+  std::vector<std::unique_ptr<boost::process::child>> workers;
+  for (uint32_t i = 0; i < process_count; i++) {
+    workers.emplace_back(new boost::process::child(
+        "./multi_process/test_stress_multi_process_worker", std::to_string(i),
+        workload_list.str(), std::to_string(duration_seconds_)));
+  }
+
+  // Start all workers together once their setup is done
+  const auto wait_start = std::chrono::steady_clock::now();
+  uint32_t ready = 0;
+  while (ready < process_count &&
+         std::chrono::steady_clock::now() - wait_start < ready_timeout_) {
+    ready = 0;
+    for (uint32_t i = 0; i < process_count; i++) {
+      ready += shared_data->workers[i].ready;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(process_count, ready);
+  shared_data->start = 1;
+
+  for (uint32_t i = 0; i < process_count; i++) {
+    workers[i]->wait();
+    EXPECT_EQ(0, workers[i]->exit_code()) << "Worker " << i << " failed";
+  }
+
+  uint64_t total_operations = 0;
+  for (auto workload : workloads) {
+    std::vector<double> throughputs;
+    double aggregate = 0;
+    for (uint32_t i = 0; i < process_count; i++) {
+      const auto &result = shared_data->workers[i];
+      const double throughput =
+          (result.seconds > 0) ? result.operations[workload] / result.seconds
+                               : 0;
+      LOG_INFO << "Process " << i << " " << workload_names[workload] << ": "
+               << result.operations[workload] << " operations, "
+               << throughput << " operations/s";
+      EXPECT_GT(result.operations[workload], 0u);
+      throughputs.push_back(throughput);
+      aggregate += throughput;
+      total_operations += result.operations[workload];
+    }
+    const double fairness = fairness_index(throughputs);
+    LOG_INFO << process_count << " processes " << workload_names[workload]
+             << ": aggregate " << aggregate << " operations/s, fairness "
+             << fairness;
+    if (fairness < 0.8) {
+      LOG_WARNING << "Unfair " << workload_names[workload]
+                  << " throughput between processes";
+    }
+  }
+  record_soak_operations(total_operations);
+
+  bipc::shared_memory_object::remove(MULTI_PROCESS_SHARED_MEMORY);
+#else
+  GTEST_SKIP() << "Worker processes are only supported on Linux";
+#endif
+}
+
+struct MultiProcessTestNameSuffix {
+  template <class ParamType>
+  std::string operator()(const testing::TestParamInfo<ParamType> &info) const {
+    std::stringstream ss;
+    ss << std::get<0>(info.param) << "_processes";
+    for (auto workload : std::get<1>(info.param)) {
+      ss << "_" << workload_names[workload];
+    }
+    return ss.str();
+  }
+};
+
+// One process gives the baseline for the aggregate throughput
+std::vector<uint32_t> process_counts = {1, 2, 4, 8};
+std::vector<std::vector<multi_process_workload_t>> workload_mixes = {
+    {WORKLOAD_DISPATCH},
+    {WORKLOAD_COPY},
+    {WORKLOAD_ALLOCATION},
+    {WORKLOAD_DISPATCH, WORKLOAD_COPY, WORKLOAD_ALLOCATION}};
+
+INSTANTIATE_TEST_CASE_P(TestMultiProcessSaturation,
+                        zeDriverMultiProcessStressTest,
+                        ::testing::Combine(::testing::ValuesIn(process_counts),
+                                           ::testing::ValuesIn(workload_mixes)),
+                        MultiProcessTestNameSuffix());
+
+} // namespace
@@ -0,0 +1,189 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "utils/utils.hpp"
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+#include "test_multi_process.hpp"
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <level_zero/ze_api.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace lzt = level_zero_tests;
+namespace bipc = boost::interprocess;
+
+namespace {
+
+const uint32_t dispatch_size = 64 * 1024;
+const uint32_t dispatches_per_operation = 16;
+const size_t copy_size = 16 * 1024 * 1024;
+const size_t allocation_size = 1024 * 1024;
+
+// Device objects the workloads run on, created before the start so that
+// only the workloads themselves run concurrently
+struct WorkerContext {
+  ze_context_handle_t context;
+  ze_device_handle_t device;
+  ze_module_handle_t module;
+  ze_kernel_handle_t kernel;
+  ze_command_queue_handle_t queue;
+  ze_command_list_handle_t dispatch_list;
+  ze_command_list_handle_t copy_list;
+  void *dispatch_buffer;
+  void *copy_source;
+  void *copy_destination;
+};
+
+WorkerContext create_worker_context() {
+  WorkerContext worker;
+  auto driver = lzt::get_default_driver();
+  worker.device = lzt::get_default_device(driver);
+  worker.context = lzt::create_context(driver);
+  worker.module =
+      lzt::create_module(worker.context, worker.device,
+                         "test_multi_process.spv", ZE_MODULE_FORMAT_IL_SPIRV,
+                         "", nullptr);
+  worker.kernel = lzt::create_function(worker.module, "multi_process_add_one");
+  worker.queue = lzt::create_command_queue(
+      worker.context, worker.device, 0, ZE_COMMAND_QUEUE_MODE_ASYNCHRONOUS,
+      ZE_COMMAND_QUEUE_PRIORITY_NORMAL, 0);
+
+  worker.dispatch_buffer = lzt::allocate_device_memory(
+      dispatch_size * sizeof(uint32_t), 1, 0, 0, worker.device,
+      worker.context);
+  uint32_t group_size_x = 0, group_size_y = 0, group_size_z = 0;
+  lzt::suggest_group_size(worker.kernel, dispatch_size, 1, 1, group_size_x,
+                          group_size_y, group_size_z);
+  lzt::set_group_size(worker.kernel, group_size_x, 1, 1);
+  lzt::set_argument_value(worker.kernel, 0, sizeof(worker.dispatch_buffer),
+                          &worker.dispatch_buffer);
+  ze_group_count_t group_count = {dispatch_size / group_size_x, 1, 1};
+  worker.dispatch_list =
+      lzt::create_command_list(worker.context, worker.device, 0);
+  for (uint32_t i = 0; i < dispatches_per_operation; i++) {
+    lzt::append_launch_function(worker.dispatch_list, worker.kernel,
+                                &group_count, nullptr, 0, nullptr);
+    lzt::append_barrier(worker.dispatch_list, nullptr);
+  }
+  lzt::close_command_list(worker.dispatch_list);
+
+  worker.copy_source = lzt::allocate_device_memory(
+      copy_size, 1, 0, 0, worker.device, worker.context);
+  worker.copy_destination = lzt::allocate_device_memory(
+      copy_size, 1, 0, 0, worker.device, worker.context);
+  worker.copy_list = lzt::create_command_list(worker.context, worker.device, 0);
+  lzt::append_memory_copy(worker.copy_list, worker.copy_destination,
+                          worker.copy_source, copy_size, nullptr);
+  lzt::close_command_list(worker.copy_list);
+  return worker;
+}
+
+void destroy_worker_context(WorkerContext &worker) {
+  lzt::destroy_command_list(worker.copy_list);
+  lzt::destroy_command_list(worker.dispatch_list);
+  lzt::free_memory(worker.context, worker.copy_destination);
+  lzt::free_memory(worker.context, worker.copy_source);
+  lzt::free_memory(worker.context, worker.dispatch_buffer);
+  lzt::destroy_command_queue(worker.queue);
+  lzt::destroy_function(worker.kernel);
+  lzt::destroy_module(worker.module);
+  lzt::destroy_context(worker.context);
+}
+
+// Runs one operation of the workload, returning whether it succeeded
+bool run_workload(WorkerContext &worker, multi_process_workload_t workload) {
+  ze_command_list_handle_t list = nullptr;
+  switch (workload) {
+  case WORKLOAD_DISPATCH:
+    list = worker.dispatch_list;
+    break;
+  case WORKLOAD_COPY:
+    list = worker.copy_list;
+    break;
+  default: {
+    ze_device_mem_alloc_desc_t device_desc = {
+        ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC};
+    void *memory = nullptr;
+    if (zeMemAllocDevice(worker.context, &device_desc, allocation_size, 1,
+                         worker.device, &memory) != ZE_RESULT_SUCCESS) {
+      return false;
+    }
+    return zeMemFree(worker.context, memory) == ZE_RESULT_SUCCESS;
+  }
+  }
+  return zeCommandQueueExecuteCommandLists(worker.queue, 1, &list,
+                                           nullptr) == ZE_RESULT_SUCCESS &&
+         zeCommandQueueSynchronize(worker.queue, UINT64_MAX) ==
+             ZE_RESULT_SUCCESS;
+}
+
+} // namespace
+
+// Arguments: worker index, comma separated workload indices, seconds
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    LOG_ERROR << "Usage: " << argv[0] << " <index> <workloads> <seconds>";
+    return 1;
+  }
+  const uint32_t index = std::stoul(argv[1]);
+  std::vector<multi_process_workload_t> workloads;
+  std::stringstream workload_list(argv[2]);
+  for (std::string workload; std::getline(workload_list, workload, ',');) {
+    workloads.push_back(
+        static_cast<multi_process_workload_t>(std::stoul(workload)));
+  }
+  const std::chrono::duration<double> duration(std::stod(argv[3]));
+  if (index >= max_worker_processes || workloads.empty()) {
+    LOG_ERROR << "Invalid worker arguments";
+    return 1;
+  }
+
+  ze_result_t result = zeInit(0);
+  if (result != ZE_RESULT_SUCCESS) {
+    LOG_ERROR << "Worker " << index << " zeInit failed";
+    return 1;
+  }
+
+  bipc::shared_memory_object shm(bipc::open_only, MULTI_PROCESS_SHARED_MEMORY,
+                                 bipc::read_write);
+  bipc::mapped_region region(shm, bipc::read_write);
+  auto shared_data =
+      static_cast<MultiProcessSharedData *>(region.get_address());
+  auto &worker_result = shared_data->workers[index];
+
+  auto worker = create_worker_context();
+  worker_result.ready = 1;
+  while (shared_data->start == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  auto now = start;
+  bool failed = false;
+  while (now - start < duration && !failed) {
+    for (auto workload : workloads) {
+      if (!run_workload(worker, workload)) {
+        failed = true;
+        break;
+      }
+      worker_result.operations[workload]++;
+    }
+    now = std::chrono::steady_clock::now();
+  }
+  worker_result.seconds = std::chrono::duration<double>(now - start).count();
+  worker_result.failed = failed ? 1 : 0;
+
+  destroy_worker_context(worker);
+  return failed ? 1 : 0;
+}
@@ -9,7 +9,9 @@
 #ifndef level_zero_tests_IMAGE_HPP
 #define level_zero_tests_IMAGE_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -103,6 +105,148 @@ private:
 typedef ImageBMP<uint8_t> ImageBMP8Bit;
 typedef ImageBMP<uint32_t> ImageBMP32Bit;
 
+enum class image_pattern { gradient, noise, checkerboard };
+
+// Image generated from a pattern rather than read, for benchmarks of large
+// images and volumes without media files.  A pixel is a function of the
+// pattern, the seed and its coordinates only, so that any rows can be
+// generated alone and in any order:
+//  - gradient: channels 0, 1 and 2 ramp from 0 to 255 along x, y and z, and
+//    the fourth channel is 255; a single channel ramps along x and y
+//  - noise: Philox random bits of the seed
+//  - checkerboard: cells of cell_size pixels, all channels 0 or 255, the
+//    fourth channel 255
+// Pixels of 32 bits are RGBA as those of ImagePNG32Bit.  Volumes of depth
+// slices are held slice after slice; width() and height() are those of a
+// slice, and the pixel accessors of Image address the first slice.
+//
+// The pixels are generated into the buffer given, of at least
+// buffer_size() bytes, such as aligned or pinned host memory, or else into
+// one the image owns.
+template <typename T> class ImageGenerated : public Image<T> {
+public:
+  ImageGenerated(const image_pattern pattern, const int width,
+                 const int height, const int depth = 1,
+                 const uint64_t seed = 0, T *data = nullptr,
+                 const int cell_size = 8);
+  static size_t buffer_size(const int width, const int height,
+                            const int depth = 1);
+
+  // Generates rows of the volume, row_count from first_row, counting the
+  // rows of all slices
+  void generate_rows(const size_t first_row, const size_t row_count);
+  // Generates the whole volume, on a thread per hardware thread
+  void generate();
+
+  // Generated images are not read; write() writes the pixels as they are
+  bool read(const std::string &image_path) override;
+  bool write(const std::string &image_path) override;
+  bool write(const std::string &image_path, const T *data) override;
+  int width() const override;
+  int height() const override;
+  int depth() const;
+  int number_of_channels() const override;
+  int bits_per_channel() const override;
+  int bits_per_pixel() const override;
+  int size() const override;
+  int size_in_bytes() const override;
+  T get_pixel(const int x, const int y) const override;
+  T get_pixel(const int x, const int y, const int z) const;
+  void set_pixel(const int x, const int y, const T data) override;
+  std::vector<T> get_pixels() const override;
+  void copy_raw_data(const T *data) override;
+  T *raw_data() override;
+  const T *raw_data() const override;
+
+private:
+  T generate_pixel(const int x, const int y, const int z) const;
+
+  image_pattern pattern_;
+  int width_;
+  int height_;
+  int depth_;
+  uint64_t seed_;
+  int cell_size_;
+  std::vector<T> owned_;
+  T *data_;
+};
+
+typedef ImageGenerated<uint8_t> ImageGenerated8Bit;
+typedef ImageGenerated<uint32_t> ImageGenerated32Bit;
+
+// Read-only view of the pixels of an image file, mapped rather than read, for
+// large media.  Raw files hold only the rows of pixels, top down; BMP files
+// must have pixels of the size of T, which are not converted.  Rows are
+// views into the mapping.  raw_data() views the whole image only where the
+// file holds it as ImageBMP does in memory, top down, unpadded and aligned
+// for T, and is nullptr otherwise; copy_pixels() gives that layout in a
+// single copy, straight into pinned host memory for instance.
+template <typename T> class MappedImage {
+public:
+  MappedImage();
+  MappedImage(const std::string &image_path);
+  ~MappedImage();
+  MappedImage(const MappedImage &) = delete;
+  MappedImage &operator=(const MappedImage &) = delete;
+
+  // As with read() of the images, these return true on error
+  bool map_bmp(const std::string &image_path);
+  bool map_raw(const std::string &image_path, const int width,
+               const int height);
+  void unmap();
+
+  int width() const;
+  int height() const;
+  int size() const;
+  size_t size_in_bytes() const;
+  const uint8_t *row_data(const int y) const;
+  const T *raw_data() const;
+  void copy_pixels(T *data) const;
+
+private:
+  bool map_file(const std::string &image_path);
+
+  struct Mapping;
+  std::unique_ptr<Mapping> mapping_;
+  const uint8_t *first_row_;
+  std::ptrdiff_t pitch_;
+  int width_;
+  int height_;
+};
+
+typedef MappedImage<uint8_t> MappedImage8Bit;
+typedef MappedImage<uint32_t> MappedImage32Bit;
+
+// Decodes a PNG file a row at a time, into the pixel format of
+// ImagePNG32Bit, so that the image is only held where its rows are read to.
+// Interlaced files cannot be decoded by rows, and are decoded whole by
+// open().
+class PNGRowReader {
+public:
+  PNGRowReader();
+  ~PNGRowReader();
+  PNGRowReader(const PNGRowReader &) = delete;
+  PNGRowReader &operator=(const PNGRowReader &) = delete;
+
+  // As with read() of the images, these return true on error
+  bool open(const std::string &image_path);
+  // Reads the next row of width() pixels
+  bool read_row(uint32_t *row);
+  // Reads the rows left, width() pixels each
+  bool read_rows(uint32_t *data);
+  void close();
+
+  int width() const;
+  int height() const;
+
+private:
+  struct Decoder;
+  std::unique_ptr<Decoder> decoder_;
+  int width_;
+  int height_;
+  int next_row_;
+};
+
 template <typename T> int size_in_bytes(const Image<T> &i) {
   return i.size_in_bytes();
 }
@@ -323,4 +323,34 @@ bool BmpUtils::load_bmp_image_8u(uint8_t *&data, int &width, int &height,
 
   return success;
 }
+
+bool BmpUtils::get_bmp_layout(const uint8_t *file, size_t file_size,
+                              int &width, int &height, int &pitch,
+                              uint16_t &bits_per_pixel, size_t &pixels_offset,
+                              bool &top_down) {
+  BMPFileHeader file_header;
+  BMPInfoHeader info_header;
+  if (file_size < sizeof(file_header) + sizeof(info_header)) {
+    return false;
+  }
+  memcpy(&file_header, file, sizeof(file_header));
+  memcpy(&info_header, file + sizeof(file_header), sizeof(info_header));
+  if (file_header.bf_type_ != 0x4D42) {
+    return false;
+  }
+
+  width = info_header.bi_width_;
+  top_down = info_header.bi_height_ < 0;
+  height = top_down ? -info_header.bi_height_ : info_header.bi_height_;
+  bits_per_pixel = info_header.bi_bit_count_;
+  pitch = info_header.bi_width_ * ((info_header.bi_bit_count_ + 7) / 8);
+  // Pitch is a multiple of four bytes:
+  pitch = (pitch + (4 - 1)) & ~(4 - 1);
+  pixels_offset = file_header.bf_off_bits_;
+
+  if ((width <= 0) || (height > (1 << 16)) || (pitch > (1 << 16))) {
+    return false;
+  }
+  return pixels_offset + static_cast<size_t>(height) * pitch <= file_size;
+}
 } // namespace level_zero_tests
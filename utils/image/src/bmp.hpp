@@ -28,6 +28,13 @@ public:
                              const char *file_name);
   static bool load_bmp_image_8u(uint8_t *&data, int &width, int &height,
                                 const char *file_name);
+
+  // Layout of the pixels of a BMP file already in memory; rows are stored
+  // bottom up unless top_down
+  static bool get_bmp_layout(const uint8_t *file, size_t file_size,
+                             int &width, int &height, int &pitch,
+                             uint16_t &bits_per_pixel, size_t &pixels_offset,
+                             bool &top_down);
 };
 } // namespace level_zero_tests
 
@@ -29,9 +29,144 @@
 
 namespace gil = boost::gil;
 
+#include <png.h>
+
+#include <csetjmp>
+#include <cstdio>
+
 #include "bmp.hpp"
 
 namespace level_zero_tests {
+struct PNGRowReader::Decoder {
+  FILE *file = nullptr;
+  png_structp png = nullptr;
+  png_infop info = nullptr;
+  // The whole decoded image of an interlaced file, or else one row
+  std::vector<png_byte> rows;
+  std::vector<png_bytep> row_pointers;
+  bool interlaced = false;
+};
+
+PNGRowReader::PNGRowReader() : width_(0), height_(0), next_row_(0) {}
+
+PNGRowReader::~PNGRowReader() { close(); }
+
+void PNGRowReader::close() {
+  if (decoder_) {
+    png_destroy_read_struct(&decoder_->png, &decoder_->info, nullptr);
+    if (decoder_->file != nullptr) {
+      fclose(decoder_->file);
+    }
+    decoder_.reset();
+  }
+  width_ = 0;
+  height_ = 0;
+  next_row_ = 0;
+}
+
+// libpng reports errors by longjmp to the setjmp of the call, so each
+// function calling it sets one, and holds no objects with destructors
+// across its calls
+bool PNGRowReader::open(const std::string &image_path) {
+  close();
+  decoder_.reset(new Decoder);
+  Decoder &d = *decoder_;
+  d.file = fopen(image_path.c_str(), "rb");
+  if (d.file == nullptr) {
+    LOG_ERROR << "Failed to open " << image_path;
+    close();
+    return true;
+  }
+  d.png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr,
+                                 nullptr);
+  d.info = d.png ? png_create_info_struct(d.png) : nullptr;
+  if (d.info == nullptr) {
+    close();
+    return true;
+  }
+  if (setjmp(png_jmpbuf(d.png))) {
+    LOG_ERROR << "Failed to decode " << image_path;
+    close();
+    return true;
+  }
+  png_init_io(d.png, d.file);
+  png_read_info(d.png, d.info);
+
+  // Converted to 8 bit RGBA, as gil::read_and_convert_image does
+  const png_byte color_type = png_get_color_type(d.png, d.info);
+  png_set_expand(d.png);
+#ifdef PNG_READ_SCALE_16_TO_8_SUPPORTED
+  png_set_scale_16(d.png);
+#else
+  png_set_strip_16(d.png);
+#endif
+  if (!(color_type & PNG_COLOR_MASK_COLOR)) {
+    png_set_gray_to_rgb(d.png);
+  }
+  if (!(color_type & PNG_COLOR_MASK_ALPHA) &&
+      !png_get_valid(d.png, d.info, PNG_INFO_tRNS)) {
+    png_set_filler(d.png, 0xFF, PNG_FILLER_AFTER);
+  }
+  d.interlaced =
+      png_get_interlace_type(d.png, d.info) != PNG_INTERLACE_NONE;
+  if (d.interlaced) {
+    png_set_interlace_handling(d.png);
+  }
+  png_read_update_info(d.png, d.info);
+
+  width_ = static_cast<int>(png_get_image_width(d.png, d.info));
+  height_ = static_cast<int>(png_get_image_height(d.png, d.info));
+  const size_t row_size = png_get_rowbytes(d.png, d.info);
+  if (d.interlaced) {
+    d.rows.resize(row_size * height_);
+    d.row_pointers.resize(height_);
+    for (int y = 0; y < height_; y++) {
+      d.row_pointers[y] = d.rows.data() + row_size * y;
+    }
+    png_read_image(d.png, d.row_pointers.data());
+  } else {
+    d.rows.resize(row_size);
+  }
+  return false;
+}
+
+bool PNGRowReader::read_row(uint32_t *row) {
+  if (!decoder_ || next_row_ >= height_) {
+    return true;
+  }
+  Decoder &d = *decoder_;
+  const png_byte *rgba = nullptr;
+  if (d.interlaced) {
+    rgba = d.rows.data() + static_cast<size_t>(next_row_) * width_ * 4;
+  } else {
+    if (setjmp(png_jmpbuf(d.png))) {
+      LOG_ERROR << "Failed to decode row " << next_row_;
+      close();
+      return true;
+    }
+    png_read_row(d.png, d.rows.data(), nullptr);
+    rgba = d.rows.data();
+  }
+  for (int x = 0; x < width_; x++, rgba += 4) {
+    row[x] = (rgba[0] << 24) + (rgba[1] << 16) + (rgba[2] << 8) + rgba[3];
+  }
+  next_row_++;
+  return false;
+}
+
+bool PNGRowReader::read_rows(uint32_t *data) {
+  for (uint32_t *row = data; next_row_ < height_; row += width_) {
+    if (read_row(row)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int PNGRowReader::width() const { return width_; }
+
+int PNGRowReader::height() const { return height_; }
+
 template <typename T> ImagePNG<T>::ImagePNG() : width_(0), height_(0) {}
 
 template <typename T> ImagePNG<T>::ImagePNG(const std::string &image_path) {
@@ -49,22 +184,19 @@ ImagePNG<T>::ImagePNG(const int width, const int height,
                       const std::vector<T> &data)
     : width_(width), height_(height), pixels_(data) {}
 
+// Decoded by rows straight into the pixels, rather than through a gil image
 template <> bool ImagePNG<uint32_t>::read(const std::string &image_path) {
-  gil::rgba8_image_t image;
-#ifdef BOOST_GIL_IO_PNG_168_API
-  gil::read_and_convert_image(image_path, image, gil::png_tag());
-#else
-  gil::png_read_and_convert_image(image_path, image);
-#endif
-  gil::rgba8_view_t view = gil::view(image);
-  for (gil::rgba8_pixel_t pixel : view) {
-    uint32_t raw_pixel =
-        (pixel[0] << 24) + (pixel[1] << 16) + (pixel[2] << 8) + pixel[3];
-    pixels_.push_back(raw_pixel);
+  PNGRowReader reader;
+  if (reader.open(image_path)) {
+    width_ = 0;
+    height_ = 0;
+    pixels_.clear();
+    return true;
   }
-  width_ = static_cast<int>(view.width());
-  height_ = static_cast<int>(view.height());
-  return false;
+  width_ = reader.width();
+  height_ = reader.height();
+  pixels_.resize(size());
+  return reader.read_rows(pixels_.data());
 }
 
 template <> bool ImagePNG<uint32_t>::write(const std::string &image_path) {
@@ -0,0 +1,204 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "image/image.hpp"
+#include "random/random.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <thread>
+
+namespace level_zero_tests {
+
+template <typename T>
+ImageGenerated<T>::ImageGenerated(const image_pattern pattern, const int width,
+                                  const int height, const int depth,
+                                  const uint64_t seed, T *data,
+                                  const int cell_size)
+    : pattern_(pattern), width_(width), height_(height), depth_(depth),
+      seed_(seed), cell_size_(std::max(1, cell_size)), data_(data) {
+  if (data_ == nullptr) {
+    owned_.resize(buffer_size(width, height, depth) / sizeof(T));
+    data_ = owned_.data();
+  }
+  generate();
+}
+
+template <typename T>
+size_t ImageGenerated<T>::buffer_size(const int width, const int height,
+                                      const int depth) {
+  return static_cast<size_t>(width) * height * depth * sizeof(T);
+}
+
+static uint8_t ramp(const int position, const int length) {
+  return length > 1 ? static_cast<uint8_t>(position * 255 / (length - 1)) : 0;
+}
+
+template <typename T>
+T ImageGenerated<T>::generate_pixel(const int x, const int y,
+                                    const int z) const {
+  const int channels = number_of_channels();
+  uint8_t channel[4] = {0, 0, 0, 0};
+  switch (pattern_) {
+  case image_pattern::gradient:
+    if (channels == 1) {
+      channel[0] = static_cast<uint8_t>(
+          (ramp(x, width_) + ramp(y, height_)) / 2);
+    } else {
+      channel[0] = ramp(x, width_);
+      channel[1] = ramp(y, height_);
+      channel[2] = ramp(z, depth_);
+      channel[3] = 0xFF;
+    }
+    break;
+  case image_pattern::noise: {
+    const uint64_t index =
+        (static_cast<uint64_t>(z) * height_ + y) * width_ + x;
+    const uint32_t counter[4] = {static_cast<uint32_t>(index),
+                                 static_cast<uint32_t>(index >> 32), 0, 0};
+    const uint32_t key[2] = {static_cast<uint32_t>(seed_),
+                             static_cast<uint32_t>(seed_ >> 32)};
+    uint32_t bits[4];
+    philox4x32_10(counter, key, bits);
+    return static_cast<T>(bits[0]);
+  }
+  case image_pattern::checkerboard: {
+    const bool on =
+        ((x / cell_size_ + y / cell_size_ + z / cell_size_) & 1) != 0;
+    std::fill(channel, channel + 4, on ? 0xFF : 0x00);
+    channel[3] = 0xFF;
+    break;
+  }
+  }
+  if (channels == 1) {
+    return static_cast<T>(channel[0]);
+  }
+  return static_cast<T>((static_cast<uint32_t>(channel[0]) << 24) +
+                        (channel[1] << 16) + (channel[2] << 8) + channel[3]);
+}
+
+template <typename T>
+void ImageGenerated<T>::generate_rows(const size_t first_row,
+                                      const size_t row_count) {
+  for (size_t row = first_row; row < first_row + row_count; row++) {
+    const int y = static_cast<int>(row % height_);
+    const int z = static_cast<int>(row / height_);
+    T *pixel = data_ + row * width_;
+    for (int x = 0; x < width_; x++) {
+      pixel[x] = generate_pixel(x, y, z);
+    }
+  }
+}
+
+template <typename T> void ImageGenerated<T>::generate() {
+  const size_t rows = static_cast<size_t>(height_) * depth_;
+  const size_t threads = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), rows);
+  if (threads <= 1) {
+    generate_rows(0, rows);
+    return;
+  }
+  const size_t chunk = (rows + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (size_t first = chunk; first < rows; first += chunk) {
+    workers.emplace_back(&ImageGenerated<T>::generate_rows, this, first,
+                         std::min(chunk, rows - first));
+  }
+  generate_rows(0, std::min(chunk, rows));
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+template <typename T>
+bool ImageGenerated<T>::read(const std::string &image_path) {
+  return true;
+}
+
+template <typename T>
+bool ImageGenerated<T>::write(const std::string &image_path) {
+  FILE *stream = fopen(image_path.c_str(), "wb");
+  if (stream == nullptr) {
+    return true;
+  }
+  const size_t count = buffer_size(width_, height_, depth_) / sizeof(T);
+  const bool error = fwrite(data_, sizeof(T), count, stream) != count;
+  fclose(stream);
+  return error;
+}
+
+template <typename T>
+bool ImageGenerated<T>::write(const std::string &image_path, const T *data) {
+  copy_raw_data(data);
+  return write(image_path);
+}
+
+template <typename T> int ImageGenerated<T>::width() const { return width_; }
+
+template <typename T> int ImageGenerated<T>::height() const {
+  return height_;
+}
+
+template <typename T> int ImageGenerated<T>::depth() const { return depth_; }
+
+template <typename T> int ImageGenerated<T>::number_of_channels() const {
+  return bits_per_pixel() / bits_per_channel();
+}
+
+template <typename T> int ImageGenerated<T>::bits_per_channel() const {
+  return 8;
+}
+
+template <typename T> int ImageGenerated<T>::bits_per_pixel() const {
+  return std::numeric_limits<T>::digits;
+}
+
+template <typename T> int ImageGenerated<T>::size() const {
+  return width() * height() * depth();
+}
+
+template <typename T> int ImageGenerated<T>::size_in_bytes() const {
+  return static_cast<int>(buffer_size(width_, height_, depth_));
+}
+
+template <typename T>
+T ImageGenerated<T>::get_pixel(const int x, const int y) const {
+  return data_[y * width() + x];
+}
+
+template <typename T>
+T ImageGenerated<T>::get_pixel(const int x, const int y, const int z) const {
+  return data_[(static_cast<size_t>(z) * height() + y) * width() + x];
+}
+
+template <typename T>
+void ImageGenerated<T>::set_pixel(const int x, const int y, const T data) {
+  data_[y * width() + x] = data;
+}
+
+template <typename T> std::vector<T> ImageGenerated<T>::get_pixels() const {
+  return std::vector<T>(data_,
+                        data_ + buffer_size(width_, height_, depth_) /
+                                    sizeof(T));
+}
+
+template <typename T> void ImageGenerated<T>::copy_raw_data(const T *data) {
+  std::copy(data, data + buffer_size(width_, height_, depth_) / sizeof(T),
+            data_);
+}
+
+template <typename T> T *ImageGenerated<T>::raw_data() { return data_; }
+
+template <typename T> const T *ImageGenerated<T>::raw_data() const {
+  return data_;
+}
+
+template class ImageGenerated<uint8_t>;
+template class ImageGenerated<uint32_t>;
+} // namespace level_zero_tests
@@ -0,0 +1,154 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "image/image.hpp"
+#include "logging/logging.hpp"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+
+#include "bmp.hpp"
+
+namespace ipc = boost::interprocess;
+
+namespace level_zero_tests {
+
+template <typename T> struct MappedImage<T>::Mapping {
+  ipc::file_mapping file;
+  ipc::mapped_region region;
+};
+
+template <typename T>
+MappedImage<T>::MappedImage()
+    : first_row_(nullptr), pitch_(0), width_(0), height_(0) {}
+
+template <typename T>
+MappedImage<T>::MappedImage(const std::string &image_path) : MappedImage() {
+  map_bmp(image_path);
+}
+
+template <typename T> MappedImage<T>::~MappedImage() = default;
+
+template <typename T> void MappedImage<T>::unmap() {
+  mapping_.reset();
+  first_row_ = nullptr;
+  pitch_ = 0;
+  width_ = 0;
+  height_ = 0;
+}
+
+template <typename T>
+bool MappedImage<T>::map_file(const std::string &image_path) {
+  unmap();
+  try {
+    mapping_.reset(new Mapping{
+        ipc::file_mapping(image_path.c_str(), ipc::read_only), {}});
+    mapping_->region = ipc::mapped_region(mapping_->file, ipc::read_only);
+  } catch (const ipc::interprocess_exception &e) {
+    LOG_ERROR << "Failed to map " << image_path << ": " << e.what();
+    mapping_.reset();
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+bool MappedImage<T>::map_raw(const std::string &image_path, const int width,
+                             const int height) {
+  if (map_file(image_path)) {
+    return true;
+  }
+  const size_t size = static_cast<size_t>(width) * height * sizeof(T);
+  if (width <= 0 || height <= 0 || mapping_->region.get_size() < size) {
+    LOG_ERROR << image_path << " is smaller than " << width << "x" << height
+              << " pixels";
+    unmap();
+    return true;
+  }
+  first_row_ = static_cast<const uint8_t *>(mapping_->region.get_address());
+  pitch_ = width * sizeof(T);
+  width_ = width;
+  height_ = height;
+  return false;
+}
+
+template <typename T>
+bool MappedImage<T>::map_bmp(const std::string &image_path) {
+  if (map_file(image_path)) {
+    return true;
+  }
+  const uint8_t *file =
+      static_cast<const uint8_t *>(mapping_->region.get_address());
+  int width = 0, height = 0, pitch = 0;
+  uint16_t bits_per_pixel = 0;
+  size_t pixels_offset = 0;
+  bool top_down = false;
+  if (!BmpUtils::get_bmp_layout(file, mapping_->region.get_size(), width,
+                                height, pitch, bits_per_pixel, pixels_offset,
+                                top_down) ||
+      bits_per_pixel != 8 * sizeof(T)) {
+    LOG_ERROR << image_path << " is not a BMP file of " << 8 * sizeof(T)
+              << " bit pixels";
+    unmap();
+    return true;
+  }
+  if (top_down) {
+    first_row_ = file + pixels_offset;
+    pitch_ = pitch;
+  } else {
+    first_row_ =
+        file + pixels_offset + static_cast<size_t>(height - 1) * pitch;
+    pitch_ = -pitch;
+  }
+  width_ = width;
+  height_ = height;
+  return false;
+}
+
+template <typename T> int MappedImage<T>::width() const { return width_; }
+
+template <typename T> int MappedImage<T>::height() const { return height_; }
+
+template <typename T> int MappedImage<T>::size() const {
+  return width() * height();
+}
+
+template <typename T> size_t MappedImage<T>::size_in_bytes() const {
+  return static_cast<size_t>(size()) * sizeof(T);
+}
+
+template <typename T>
+const uint8_t *MappedImage<T>::row_data(const int y) const {
+  return first_row_ + y * pitch_;
+}
+
+template <typename T> const T *MappedImage<T>::raw_data() const {
+  if (pitch_ != static_cast<std::ptrdiff_t>(width() * sizeof(T)) ||
+      reinterpret_cast<uintptr_t>(first_row_) % alignof(T) != 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<const T *>(first_row_);
+}
+
+template <typename T> void MappedImage<T>::copy_pixels(T *data) const {
+  const size_t row_size = width() * sizeof(T);
+  if (raw_data() != nullptr) {
+    std::memcpy(data, raw_data(), size_in_bytes());
+    return;
+  }
+  for (int y = 0; y < height(); y++) {
+    std::memcpy(data + static_cast<size_t>(y) * width(), row_data(y),
+                row_size);
+  }
+}
+
+template class MappedImage<uint8_t>;
+template class MappedImage<uint32_t>;
+} // namespace level_zero_tests
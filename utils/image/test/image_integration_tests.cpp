@@ -9,6 +9,8 @@
 #include "image/image.hpp"
 #include "gtest/gtest.h"
 
+#include <cstdio>
+
 TEST(ImageIntegrationTests, ReadsPNGFile) {
   level_zero_tests::ImagePNG32Bit image("rgb_brg_3x2.png");
   const std::vector<uint32_t> pixels = {
@@ -108,3 +110,59 @@ TEST(ImageIntegrationTests, WritesColorBMPFile) {
 
   EXPECT_EQ(image.get_pixels(), pixels);
 }
+
+TEST(ImageIntegrationTests, MapsColorBMPFile) {
+  level_zero_tests::ImageBMP32Bit image("rgb_brg_3x2_argb.bmp");
+  level_zero_tests::MappedImage32Bit mapped("rgb_brg_3x2_argb.bmp");
+  ASSERT_EQ(image.width(), mapped.width());
+  ASSERT_EQ(image.height(), mapped.height());
+  std::vector<uint32_t> pixels(mapped.size());
+  mapped.copy_pixels(pixels.data());
+  EXPECT_EQ(image.get_pixels(), pixels);
+}
+
+TEST(ImageIntegrationTests, MapsBMPFileOnlyOfPixelSize) {
+  level_zero_tests::MappedImage8Bit mapped;
+  EXPECT_TRUE(mapped.map_bmp("rgb_brg_3x2_argb.bmp"));
+  EXPECT_EQ(0, mapped.size());
+}
+
+TEST(ImageIntegrationTests, MapsRawFileWithoutCopy) {
+  const std::vector<uint32_t> pixels = {
+      0xFF0000FF, //
+      0x00FF00FF, //
+      0x0000FFFF, //
+      0x0000FFFF, //
+      0xFF0000FF, //
+      0x00FF00FF  //
+  };
+  std::FILE *file = std::fopen("output.raw", "wb");
+  ASSERT_NE(nullptr, file);
+  std::fwrite(pixels.data(), sizeof(uint32_t), pixels.size(), file);
+  std::fclose(file);
+
+  level_zero_tests::MappedImage32Bit mapped;
+  ASSERT_FALSE(mapped.map_raw("output.raw", 3, 2));
+  ASSERT_NE(nullptr, mapped.raw_data());
+  EXPECT_EQ(pixels, std::vector<uint32_t>(mapped.raw_data(),
+                                          mapped.raw_data() + mapped.size()));
+  EXPECT_TRUE(mapped.map_raw("output.raw", 3, 3));
+  mapped.unmap();
+  std::remove("output.raw");
+}
+
+TEST(ImageIntegrationTests, ReadsPNGFileByRows) {
+  level_zero_tests::ImagePNG32Bit image("rgb_brg_3x2.png");
+  level_zero_tests::PNGRowReader reader;
+  ASSERT_FALSE(reader.open("rgb_brg_3x2.png"));
+  ASSERT_EQ(image.width(), reader.width());
+  ASSERT_EQ(image.height(), reader.height());
+  std::vector<uint32_t> row(reader.width());
+  for (int y = 0; y < reader.height(); y++) {
+    ASSERT_FALSE(reader.read_row(row.data()));
+    for (int x = 0; x < reader.width(); x++) {
+      EXPECT_EQ(image.get_pixel(x, y), row[x]);
+    }
+  }
+  EXPECT_TRUE(reader.read_row(row.data()));
+}
@@ -141,3 +141,50 @@ TYPED_TEST(SizeInBytes, MultiplePixels) {
   const TypeParam image(2, 2);
   EXPECT_EQ(image.size_in_bytes(), level_zero_tests::size_in_bytes(image));
 }
+
+TEST(ImageGenerated32Bit, GradientRampsAlongEachAxis) {
+  const level_zero_tests::ImageGenerated32Bit image(
+      level_zero_tests::image_pattern::gradient, 16, 8, 4);
+  EXPECT_EQ(0x000000FFu, image.get_pixel(0, 0, 0));
+  EXPECT_EQ(0xFF0000FFu, image.get_pixel(15, 0, 0));
+  EXPECT_EQ(0x00FF00FFu, image.get_pixel(0, 7, 0));
+  EXPECT_EQ(0x0000FFFFu, image.get_pixel(0, 0, 3));
+  EXPECT_EQ(16 * 8 * 4, image.size());
+}
+
+TEST(ImageGenerated8Bit, CheckerboardAlternatesCells) {
+  const level_zero_tests::ImageGenerated8Bit image(
+      level_zero_tests::image_pattern::checkerboard, 8, 8, 1, 0, nullptr, 2);
+  EXPECT_EQ(0x00, image.get_pixel(0, 0));
+  EXPECT_EQ(0x00, image.get_pixel(1, 1));
+  EXPECT_EQ(0xFF, image.get_pixel(2, 0));
+  EXPECT_EQ(0xFF, image.get_pixel(0, 2));
+  EXPECT_EQ(0x00, image.get_pixel(2, 2));
+}
+
+TEST(ImageGenerated32Bit, NoiseIsDeterminedBySeed) {
+  const level_zero_tests::ImageGenerated32Bit first(
+      level_zero_tests::image_pattern::noise, 64, 32, 2, 1);
+  const level_zero_tests::ImageGenerated32Bit second(
+      level_zero_tests::image_pattern::noise, 64, 32, 2, 1);
+  const level_zero_tests::ImageGenerated32Bit other(
+      level_zero_tests::image_pattern::noise, 64, 32, 2, 2);
+  EXPECT_EQ(first.get_pixels(), second.get_pixels());
+  EXPECT_NE(first.get_pixels(), other.get_pixels());
+}
+
+TEST(ImageGenerated32Bit, GeneratesIntoGivenBuffer) {
+  const size_t size =
+      level_zero_tests::ImageGenerated32Bit::buffer_size(64, 32, 2);
+  std::vector<uint32_t> buffer(size / sizeof(uint32_t));
+  level_zero_tests::ImageGenerated32Bit image(
+      level_zero_tests::image_pattern::noise, 64, 32, 2, 1, buffer.data());
+  EXPECT_EQ(buffer.data(), image.raw_data());
+
+  // Rows generated alone are those of the whole volume
+  const std::vector<uint32_t> expected = buffer;
+  std::fill(buffer.begin(), buffer.end(), 0);
+  image.generate_rows(40, 24);
+  image.generate_rows(0, 40);
+  EXPECT_EQ(expected, buffer);
+}
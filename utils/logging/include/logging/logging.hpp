@@ -9,6 +9,7 @@
 #ifndef level_zero_tests_LOGGING_HPP
 #define level_zero_tests_LOGGING_HPP
 
+#include <atomic>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -19,12 +20,21 @@
 
 namespace level_zero_tests {
 
-#define LOG_TRACE BOOST_LOG_TRIVIAL(trace)
-#define LOG_DEBUG BOOST_LOG_TRIVIAL(debug)
-#define LOG_INFO BOOST_LOG_TRIVIAL(info)
-#define LOG_WARNING BOOST_LOG_TRIVIAL(warning)
-#define LOG_ERROR BOOST_LOG_TRIVIAL(error)
-#define LOG_FATAL BOOST_LOG_TRIVIAL(fatal)
+// Records below the minimal level are dropped on a single relaxed load,
+// before Boost.Log opens a record, and their stream expression is not
+// evaluated
+#define LZT_LOG(severity)                                                      \
+  if (!::level_zero_tests::logging_level_enabled(                              \
+          ::boost::log::trivial::severity)) {                                  \
+  } else                                                                       \
+    BOOST_LOG_TRIVIAL(severity)
+
+#define LOG_TRACE LZT_LOG(trace)
+#define LOG_DEBUG LZT_LOG(debug)
+#define LOG_INFO LZT_LOG(info)
+#define LOG_WARNING LZT_LOG(warning)
+#define LOG_ERROR LZT_LOG(error)
+#define LOG_FATAL LZT_LOG(fatal)
 
 #define LOG_ENTER_FUNCTION LOG_TRACE << "Enter function: " << __func__;
 #define LOG_EXIT_FUNCTION LOG_TRACE << "Exit function: " << __func__;
@@ -38,12 +48,24 @@ using logging_level = boost::log::trivial::severity_level;
 struct LoggingSettings {
   logging_format format = logging_format::precise;
   logging_level level = logging_level::info;
+  // Records are formatted and written by a background thread, so that
+  // logging threads only queue them
+  bool asynchronous = false;
 };
 
+extern std::atomic<int> min_logging_level;
+inline bool logging_level_enabled(const logging_level level) {
+  return static_cast<int>(level) >=
+         min_logging_level.load(std::memory_order_relaxed);
+}
+
 void init_logging();
 void init_logging(const LoggingSettings settings);
 void init_logging(std::vector<std::string> &command_line);
 void stop_logging();
+// Blocks until the queued records are written; a no-op for synchronous
+// logging
+void flush_logging();
 void add_stream(const boost::shared_ptr<std::ostream> &stream);
 LoggingSettings parse_command_line(std::vector<std::string> &command_line);
 
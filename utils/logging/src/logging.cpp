@@ -10,11 +10,16 @@
 
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/console.hpp>
 #include <boost/log/support/date_time.hpp>
+#include <boost/core/null_deleter.hpp>
+#include <boost/smart_ptr/make_shared_object.hpp>
+
+#include <cstdlib>
 
 namespace logging = boost::log;
 namespace sinks = boost::log::sinks;
@@ -26,7 +31,11 @@ namespace po = boost::program_options;
 namespace level_zero_tests {
 
 typedef sinks::synchronous_sink<sinks::text_ostream_backend> text_sink;
+typedef sinks::asynchronous_sink<sinks::text_ostream_backend> async_text_sink;
 static boost::shared_ptr<text_sink> sink;
+static boost::shared_ptr<async_text_sink> async_sink;
+
+std::atomic<int> min_logging_level{logging_level::trace};
 
 void set_format(const logging_format format) {
   logging::formatter formatter;
@@ -43,10 +52,15 @@ void set_format(const logging_format format) {
   } else {
     throw std::runtime_error("Unknown logging_format");
   }
-  sink->set_formatter(formatter);
+  if (async_sink) {
+    async_sink->set_formatter(formatter);
+  } else {
+    sink->set_formatter(formatter);
+  }
 }
 
 void set_min_level(const logging_level level) {
+  min_logging_level.store(level, std::memory_order_relaxed);
   logging::core::get()->set_filter(logging::trivial::severity >= level);
 }
 
@@ -55,8 +69,29 @@ void init_logging() {
   logging::add_common_attributes();
 }
 
+// The queue is unbounded, so that logging threads never wait on the writer,
+// and is drained at exit, as the test mains do not stop logging
+void init_async_logging() {
+  auto backend = boost::make_shared<sinks::text_ostream_backend>();
+  backend->add_stream(
+      boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+  async_sink = boost::make_shared<async_text_sink>(backend);
+  logging::core::get()->add_sink(async_sink);
+  logging::add_common_attributes();
+
+  static bool flush_at_exit = false;
+  if (!flush_at_exit) {
+    std::atexit(flush_logging);
+    flush_at_exit = true;
+  }
+}
+
 void init_logging(const LoggingSettings settings) {
-  init_logging();
+  if (settings.asynchronous) {
+    init_async_logging();
+  } else {
+    init_logging();
+  }
 
   set_format(settings.format);
   set_min_level(settings.level);
@@ -67,12 +102,29 @@ void init_logging(std::vector<std::string> &command_line) {
 }
 
 void stop_logging() {
-  logging::core::get()->remove_sink(sink);
-  sink.reset();
+  if (async_sink) {
+    logging::core::get()->remove_sink(async_sink);
+    async_sink->stop();
+    async_sink->flush();
+    async_sink.reset();
+  } else {
+    logging::core::get()->remove_sink(sink);
+    sink.reset();
+  }
+}
+
+void flush_logging() {
+  if (async_sink) {
+    async_sink->flush();
+  }
 }
 
 void add_stream(const boost::shared_ptr<std::ostream> &stream) {
-  sink->locked_backend()->add_stream(stream);
+  if (async_sink) {
+    async_sink->locked_backend()->add_stream(stream);
+  } else {
+    sink->locked_backend()->add_stream(stream);
+  }
 }
 
 std::ostream &operator<<(std::ostream &os, const logging_format &f) {
@@ -110,6 +162,8 @@ LoggingSettings parse_command_line(std::vector<std::string> &command_line) {
   options("logging-level",
           po::value(&settings.level)->default_value(logging_level::info),
           "minimal logging level to print");
+  options("logging-async", po::bool_switch(&settings.asynchronous),
+          "write logged messages from a background thread");
 
   po::parsed_options parsed = po::command_line_parser(command_line)
                                   .options(desc)
@@ -15,6 +15,7 @@
 namespace po = boost::program_options;
 
 #include <regex>
+#include <thread>
 
 namespace lzt = level_zero_tests;
 
@@ -141,6 +142,18 @@ TEST(LoggingCommandLineParser, ChooseUnknownLevelFromCommandLine) {
   EXPECT_THROW(lzt::parse_command_line(cmd), po::validation_error);
 }
 
+TEST(LoggingCommandLineParser, ChooseAsynchronousFromCommandLine) {
+  std::vector<std::string> cmd = {"--logging-async"};
+  const lzt::LoggingSettings settings = lzt::parse_command_line(cmd);
+  EXPECT_TRUE(settings.asynchronous);
+}
+
+TEST(LoggingCommandLineParser, SynchronousIsDefault) {
+  std::vector<std::string> cmd;
+  const lzt::LoggingSettings settings = lzt::parse_command_line(cmd);
+  EXPECT_FALSE(settings.asynchronous);
+}
+
 class LoggingInitTest : public ::testing::Test {
 protected:
   void SetUp() override { logs = boost::make_shared<std::stringstream>(); }
@@ -187,6 +200,66 @@ TEST_F(LoggingInitTest, WarningLevelFromSettings) {
   EXPECT_EQ("[warning] Message\n", logs->str());
 }
 
+TEST_F(LoggingInitTest, DisabledLevelIsNotFormatted) {
+  lzt::LoggingSettings settings;
+  settings.level = lzt::logging_level::info;
+  lzt::init_logging(settings);
+  lzt::add_stream(logs);
+
+  int evaluated = 0;
+  auto message = [&evaluated] {
+    evaluated++;
+    return "Message";
+  };
+  LOG_DEBUG << message();
+  EXPECT_EQ(0, evaluated);
+  LOG_INFO << message();
+  EXPECT_EQ(1, evaluated);
+}
+
+TEST_F(LoggingInitTest, AsynchronousFromSettings) {
+  lzt::LoggingSettings settings;
+  settings.format = lzt::logging_format::simple;
+  settings.asynchronous = true;
+  lzt::init_logging(settings);
+  lzt::add_stream(logs);
+
+  LOG_INFO << "Message";
+  lzt::flush_logging();
+  EXPECT_EQ("[info] Message\n", logs->str());
+}
+
+TEST_F(LoggingInitTest, AsynchronousKeepsRecordsOfEachThread) {
+  lzt::LoggingSettings settings;
+  settings.format = lzt::logging_format::simple;
+  settings.asynchronous = true;
+  lzt::init_logging(settings);
+  lzt::add_stream(logs);
+
+  const int thread_count = 4;
+  const int message_count = 100;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; i++) {
+    threads.emplace_back([] {
+      for (int j = 0; j < message_count; j++) {
+        LOG_INFO << "Message " << j;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  lzt::flush_logging();
+
+  std::string line;
+  int lines = 0;
+  while (std::getline(*logs, line)) {
+    EXPECT_EQ(0, line.find("[info] Message "));
+    lines++;
+  }
+  EXPECT_EQ(thread_count * message_count, lines);
+}
+
 TEST(VectorToString, Empty) {
   const std::vector<int> x;
   EXPECT_EQ("[]", lzt::to_string(x));
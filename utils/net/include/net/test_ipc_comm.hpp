@@ -15,8 +15,11 @@
 #include <boost/asio.hpp>
 #include <chrono>
 #include <thread>
+#include <vector>
 #ifdef __linux__
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 #endif
 
 #include "logging/logging.hpp"
@@ -40,6 +43,57 @@ int read_fd_from_socket(int socket, char *data);
 template <typename T> int receive_ipc_handle(char *data);
 int write_fd_to_socket(int socket, int fd, char *data);
 template <typename T> void send_ipc_handle(const T &ipc_handle);
+template <typename T> void receive_ipc_handles(std::vector<T> &ipc_handles);
+template <typename T> void send_ipc_handles(const std::vector<T> &ipc_handles);
+
+// Batched transfer: descriptors go as one SCM_RIGHTS control message of up
+// to IPC_MAX_FDS_PER_MESSAGE (the kernel's SCM_MAX_FD) descriptors, with
+// ZE_MAX_IPC_HANDLE_SIZE bytes of data for each, so that handles are not
+// paced by a message, let alone a connection, each.  Both return 0, or -1
+// on error.
+const size_t IPC_MAX_FDS_PER_MESSAGE = 253;
+int write_fds_to_socket(int socket, const int *fds, const char *data,
+                        size_t count);
+int read_fds_from_socket(int socket, int *fds, char *data, size_t count);
+
+// A connection kept for any number of transfers, both ways
+class IpcConnection {
+public:
+  explicit IpcConnection(int socket);
+  ~IpcConnection();
+  IpcConnection(IpcConnection &&other);
+  IpcConnection &operator=(IpcConnection &&other);
+  IpcConnection(const IpcConnection &) = delete;
+  IpcConnection &operator=(const IpcConnection &) = delete;
+
+  // Connects to an IpcServer, retrying until CONNECTION_TIMEOUT
+  static IpcConnection connect(const std::string &socket_path = "ipc_socket");
+
+  void send_fds(const std::vector<int> &fds);
+  std::vector<int> receive_fds(size_t count);
+  // As send_ipc_handles() and receive_ipc_handles(), in batches
+  template <typename T> void send_ipc_handles(const std::vector<T> &handles);
+  template <typename T> void receive_ipc_handles(std::vector<T> &handles);
+
+private:
+  int socket_;
+};
+
+// Listens for any number of clients, each accepted into its own connection
+class IpcServer {
+public:
+  explicit IpcServer(const std::string &socket_path = "ipc_socket",
+                     int backlog = SOMAXCONN);
+  ~IpcServer();
+  IpcServer(const IpcServer &) = delete;
+  IpcServer &operator=(const IpcServer &) = delete;
+
+  IpcConnection accept();
+
+private:
+  std::string socket_path_;
+  int socket_;
+};
 
 // definition
 template <typename T> int receive_ipc_handle(char *data) {
@@ -136,6 +190,143 @@ template <typename T> void send_ipc_handle(const T &ipc_handle) {
   close(unix_send_socket);
 }
 
+// Receives as many handles as the vector holds over a single connection,
+// so that bulk transfers are not paced by reconnecting for every handle.
+// The descriptor of every handle replaces its leading bytes.
+template <typename T> void receive_ipc_handles(std::vector<T> &ipc_handles) {
+  const char *socket_path = "ipc_socket";
+
+  struct sockaddr_un local_addr, remote_addr;
+  local_addr.sun_family = AF_UNIX;
+  strcpy(local_addr.sun_path, socket_path);
+  unlink(local_addr.sun_path);
+
+  int unix_rcv_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (unix_rcv_socket == -1) {
+    perror("Server Connection Error");
+    throw std::runtime_error("[Server] Could not create socket");
+  }
+
+  if (bind(unix_rcv_socket, (struct sockaddr *)&local_addr,
+           strlen(local_addr.sun_path) + sizeof(local_addr.sun_family)) == -1) {
+    perror("Server Bind Error");
+    close(unix_rcv_socket);
+    throw std::runtime_error("[Server] Could not bind to socket");
+  }
+
+  if (listen(unix_rcv_socket, 1) == -1) {
+    perror("Server Listen Error");
+    close(unix_rcv_socket);
+    throw std::runtime_error("[Server] Could not listen on socket");
+  }
+
+  int len = sizeof(struct sockaddr_un);
+  int other_socket = accept(unix_rcv_socket, (struct sockaddr *)&remote_addr,
+                            (socklen_t *)&len);
+  if (other_socket == -1) {
+    close(unix_rcv_socket);
+    perror("Server Accept Error");
+    throw std::runtime_error("[Server] Could not accept connection");
+  }
+
+  for (auto &ipc_handle : ipc_handles) {
+    int ipc_descriptor = -1;
+    try {
+      ipc_descriptor = read_fd_from_socket(other_socket, ipc_handle.data);
+    } catch (...) {
+      close(other_socket);
+      close(unix_rcv_socket);
+      throw;
+    }
+    if (ipc_descriptor < 0) {
+      close(other_socket);
+      close(unix_rcv_socket);
+      throw std::runtime_error("[Server] Failed to read IPC handle");
+    }
+    memcpy(&ipc_handle, static_cast<void *>(&ipc_descriptor),
+           sizeof(ipc_descriptor));
+  }
+  LOG_DEBUG << "[Server] Received " << ipc_handles.size()
+            << " IPC handle descriptors from client";
+
+  close(other_socket);
+  close(unix_rcv_socket);
+}
+
+template <typename T>
+void send_ipc_handles(const std::vector<T> &ipc_handles) {
+  const char *socket_path = "ipc_socket";
+
+  struct sockaddr_un remote_addr;
+  remote_addr.sun_family = AF_UNIX;
+  strcpy(remote_addr.sun_path, socket_path);
+  int unix_send_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (unix_send_socket == -1) {
+    perror("Client Connection Error");
+    throw std::runtime_error(
+        "[Client] IPC process could not create UNIX socket");
+  }
+
+  std::chrono::milliseconds wait = std::chrono::milliseconds(0);
+  while (connect(unix_send_socket, (struct sockaddr *)&remote_addr,
+                 sizeof(remote_addr)) == -1) {
+    std::this_thread::sleep_for(CONNECTION_WAIT);
+    wait += CONNECTION_WAIT;
+    if (wait > CONNECTION_TIMEOUT) {
+      close(unix_send_socket);
+      perror("Error: ");
+      throw std::runtime_error("[Client] Timed out waiting to send ipc handle");
+    }
+  }
+
+  for (const auto &ipc_handle : ipc_handles) {
+    int ipc_handle_id;
+    memcpy(static_cast<void *>(&ipc_handle_id), &ipc_handle,
+           sizeof(ipc_handle_id));
+    if (write_fd_to_socket(unix_send_socket, static_cast<int>(ipc_handle_id),
+                           const_cast<char *>(ipc_handle.data))) {
+      close(unix_send_socket);
+      perror("Error: ");
+      throw std::runtime_error("[Client] Error sending ipc handle");
+    }
+  }
+  LOG_DEBUG << "[Client] Wrote " << ipc_handles.size()
+            << " ipc descriptors to socket";
+
+  close(unix_send_socket);
+}
+
+// The descriptor of a handle is in its leading bytes, as above
+template <typename T>
+void IpcConnection::send_ipc_handles(const std::vector<T> &handles) {
+  std::vector<int> fds(handles.size());
+  std::vector<char> data(handles.size() * ZE_MAX_IPC_HANDLE_SIZE);
+  for (size_t i = 0; i < handles.size(); i++) {
+    memcpy(&fds[i], &handles[i], sizeof(int));
+    memcpy(&data[i * ZE_MAX_IPC_HANDLE_SIZE], handles[i].data,
+           ZE_MAX_IPC_HANDLE_SIZE);
+  }
+  if (write_fds_to_socket(socket_, fds.data(), data.data(), handles.size())) {
+    perror("Error: ");
+    throw std::runtime_error("Error sending ipc handles");
+  }
+}
+
+template <typename T>
+void IpcConnection::receive_ipc_handles(std::vector<T> &handles) {
+  std::vector<int> fds(handles.size());
+  std::vector<char> data(handles.size() * ZE_MAX_IPC_HANDLE_SIZE);
+  if (read_fds_from_socket(socket_, fds.data(), data.data(),
+                           handles.size())) {
+    throw std::runtime_error("Error receiving ipc handles");
+  }
+  for (size_t i = 0; i < handles.size(); i++) {
+    memcpy(handles[i].data, &data[i * ZE_MAX_IPC_HANDLE_SIZE],
+           ZE_MAX_IPC_HANDLE_SIZE);
+    memcpy(&handles[i], &fds[i], sizeof(int));
+  }
+}
+
 #endif
 
 } // namespace level_zero_tests
@@ -6,8 +6,12 @@
  *
  */
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <string>
 #include <thread>
+#include <vector>
 #ifdef __linux__
 #include <sys/socket.h>
 #endif
@@ -80,6 +84,201 @@ int write_fd_to_socket(int unix_socket, int fd,
   return 0;
 }
 
+// A message is the descriptor count, then the data of each descriptor; the
+// descriptors come with its first byte.  Stream sockets may send or
+// receive a message in parts, and only the first carries the descriptors.
+int write_fds_to_socket(int unix_socket, const int *fds, const char *data,
+                        size_t count) {
+  std::vector<char> message;
+  std::vector<char> cmsg_buff(
+      CMSG_SPACE(IPC_MAX_FDS_PER_MESSAGE * sizeof(int)));
+  for (size_t sent = 0; sent < count;) {
+    const uint32_t batch = static_cast<uint32_t>(
+        std::min(count - sent, IPC_MAX_FDS_PER_MESSAGE));
+    message.resize(sizeof(batch) + batch * ZE_MAX_IPC_HANDLE_SIZE);
+    memcpy(message.data(), &batch, sizeof(batch));
+    memcpy(message.data() + sizeof(batch),
+           data + sent * ZE_MAX_IPC_HANDLE_SIZE,
+           batch * ZE_MAX_IPC_HANDLE_SIZE);
+
+    struct iovec msg_buffer;
+    msg_buffer.iov_base = message.data();
+    msg_buffer.iov_len = message.size();
+
+    struct msghdr msg_header = {};
+    msg_header.msg_iov = &msg_buffer;
+    msg_header.msg_iovlen = 1;
+    msg_header.msg_control = cmsg_buff.data();
+    msg_header.msg_controllen = CMSG_SPACE(batch * sizeof(int));
+
+    struct cmsghdr *control_header = CMSG_FIRSTHDR(&msg_header);
+    control_header->cmsg_type = SCM_RIGHTS;
+    control_header->cmsg_level = SOL_SOCKET;
+    control_header->cmsg_len = CMSG_LEN(batch * sizeof(int));
+    memcpy(CMSG_DATA(control_header), fds + sent, batch * sizeof(int));
+
+    ssize_t bytes = sendmsg(unix_socket, &msg_header, 0);
+    if (bytes <= 0) {
+      return -1;
+    }
+    for (size_t written = bytes; written < message.size(); written += bytes) {
+      bytes = send(unix_socket, message.data() + written,
+                   message.size() - written, 0);
+      if (bytes <= 0) {
+        return -1;
+      }
+    }
+    sent += batch;
+  }
+  return 0;
+}
+
+int read_fds_from_socket(int unix_socket, int *fds, char *data,
+                         size_t count) {
+  std::vector<char> cmsg_buff(
+      CMSG_SPACE(IPC_MAX_FDS_PER_MESSAGE * sizeof(int)));
+  for (size_t received = 0; received < count;) {
+    uint32_t batch = 0;
+    struct iovec msg_buffer;
+    msg_buffer.iov_base = &batch;
+    msg_buffer.iov_len = sizeof(batch);
+
+    struct msghdr msg_header = {};
+    msg_header.msg_iov = &msg_buffer;
+    msg_header.msg_iovlen = 1;
+    msg_header.msg_control = cmsg_buff.data();
+    msg_header.msg_controllen = cmsg_buff.size();
+
+    if (recvmsg(unix_socket, &msg_header, MSG_WAITALL) !=
+            static_cast<ssize_t>(sizeof(batch)) ||
+        (msg_header.msg_flags & MSG_CTRUNC)) {
+      return -1;
+    }
+    struct cmsghdr *control_header = CMSG_FIRSTHDR(&msg_header);
+    if (control_header == nullptr || control_header->cmsg_type != SCM_RIGHTS ||
+        control_header->cmsg_len != CMSG_LEN(batch * sizeof(int)) ||
+        batch > count - received) {
+      return -1;
+    }
+    memcpy(fds + received, CMSG_DATA(control_header), batch * sizeof(int));
+
+    char *batch_data = data + received * ZE_MAX_IPC_HANDLE_SIZE;
+    const size_t size = batch * ZE_MAX_IPC_HANDLE_SIZE;
+    for (size_t read = 0; read < size;) {
+      ssize_t bytes = recv(unix_socket, batch_data + read, size - read, 0);
+      if (bytes <= 0) {
+        return -1;
+      }
+      read += bytes;
+    }
+    received += batch;
+  }
+  return 0;
+}
+
+IpcConnection::IpcConnection(int socket) : socket_(socket) {}
+
+IpcConnection::~IpcConnection() {
+  if (socket_ != -1) {
+    close(socket_);
+  }
+}
+
+IpcConnection::IpcConnection(IpcConnection &&other) : socket_(other.socket_) {
+  other.socket_ = -1;
+}
+
+IpcConnection &IpcConnection::operator=(IpcConnection &&other) {
+  std::swap(socket_, other.socket_);
+  return *this;
+}
+
+IpcConnection IpcConnection::connect(const std::string &socket_path) {
+  struct sockaddr_un remote_addr = {};
+  remote_addr.sun_family = AF_UNIX;
+  strncpy(remote_addr.sun_path, socket_path.c_str(),
+          sizeof(remote_addr.sun_path) - 1);
+  int unix_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (unix_socket == -1) {
+    perror("Client Connection Error");
+    throw std::runtime_error("[Client] Could not create UNIX socket");
+  }
+
+  std::chrono::milliseconds wait = std::chrono::milliseconds(0);
+  while (::connect(unix_socket, (struct sockaddr *)&remote_addr,
+                   sizeof(remote_addr)) == -1) {
+    std::this_thread::sleep_for(CONNECTION_WAIT);
+    wait += CONNECTION_WAIT;
+    if (wait > CONNECTION_TIMEOUT) {
+      close(unix_socket);
+      perror("Error: ");
+      throw std::runtime_error("[Client] Timed out connecting to server");
+    }
+  }
+  LOG_DEBUG << "[Client] Connected to server";
+  return IpcConnection(unix_socket);
+}
+
+void IpcConnection::send_fds(const std::vector<int> &fds) {
+  std::vector<char> data(fds.size() * ZE_MAX_IPC_HANDLE_SIZE);
+  if (write_fds_to_socket(socket_, fds.data(), data.data(), fds.size())) {
+    perror("Error: ");
+    throw std::runtime_error("Error sending descriptors");
+  }
+}
+
+std::vector<int> IpcConnection::receive_fds(size_t count) {
+  std::vector<int> fds(count);
+  std::vector<char> data(count * ZE_MAX_IPC_HANDLE_SIZE);
+  if (read_fds_from_socket(socket_, fds.data(), data.data(), count)) {
+    throw std::runtime_error("Error receiving descriptors");
+  }
+  return fds;
+}
+
+IpcServer::IpcServer(const std::string &socket_path, int backlog)
+    : socket_path_(socket_path) {
+  struct sockaddr_un local_addr = {};
+  local_addr.sun_family = AF_UNIX;
+  strncpy(local_addr.sun_path, socket_path.c_str(),
+          sizeof(local_addr.sun_path) - 1);
+  unlink(local_addr.sun_path);
+
+  socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket_ == -1) {
+    perror("Server Connection Error");
+    throw std::runtime_error("[Server] Could not create socket");
+  }
+  if (bind(socket_, (struct sockaddr *)&local_addr, sizeof(local_addr)) ==
+      -1) {
+    perror("Server Bind Error");
+    close(socket_);
+    throw std::runtime_error("[Server] Could not bind to socket");
+  }
+  if (listen(socket_, backlog) == -1) {
+    perror("Server Listen Error");
+    close(socket_);
+    unlink(socket_path_.c_str());
+    throw std::runtime_error("[Server] Could not listen on socket");
+  }
+  LOG_DEBUG << "[Server] Unix Socket Listening...";
+}
+
+IpcServer::~IpcServer() {
+  close(socket_);
+  unlink(socket_path_.c_str());
+}
+
+IpcConnection IpcServer::accept() {
+  int other_socket = ::accept(socket_, nullptr, nullptr);
+  if (other_socket == -1) {
+    perror("Server Accept Error");
+    throw std::runtime_error("[Server] Could not accept connection");
+  }
+  LOG_DEBUG << "[Server] Connection accepted";
+  return IpcConnection(other_socket);
+}
+
 #endif
 
 } // namespace level_zero_tests
@@ -13,6 +13,9 @@
 #include <random>
 #include <limits>
 #include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
 
 namespace level_zero_tests {
 template <typename T>
@@ -40,20 +43,97 @@ template <typename T> T generate_value(const int seed) {
   return generate_value(min, max, seed);
 }
 
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3"): 128 random bits as a function of a 128-bit counter and a 64-bit key
+void philox4x32_10(const uint32_t counter[4], const uint32_t key[2],
+                   uint32_t result[4]);
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, T>::type
+random_bits_to_value(const uint64_t bits, const T min, const T max) {
+  typedef typename std::make_unsigned<T>::type U;
+  const uint64_t range =
+      static_cast<U>(static_cast<U>(max) - static_cast<U>(min));
+  if (range == std::numeric_limits<uint64_t>::max()) {
+    return static_cast<T>(bits);
+  }
+  return static_cast<T>(static_cast<U>(min) +
+                        static_cast<U>(bits % (range + 1)));
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, T>::type
+random_bits_to_value(const uint64_t bits, const T min, const T max) {
+  // The top 53 bits as a double in [0, 1)
+  const double unit = (bits >> 11) * (1.0 / 9007199254740992.0);
+  return std::min(max, static_cast<T>(min + unit * (max - min)));
+}
+
+// Fills a buffer with values in [min, max] from Philox: element i depends only
+// on the seed and i, so the buffer is the same whatever the number of
+// threads filling it.  threads == 0 uses a thread per hardware thread, and
+// buffers of less than 64Ki elements are filled by the calling thread.
+template <typename T>
+void generate_buffer(T *data, const size_t count, const T min, const T max,
+                     const uint64_t seed, uint32_t threads = 0) {
+  const size_t min_chunk = 64 * 1024;
+  const uint32_t key[2] = {static_cast<uint32_t>(seed),
+                           static_cast<uint32_t>(seed >> 32)};
+  auto fill = [=](const size_t begin, const size_t end) {
+    uint32_t bits[4];
+    for (size_t i = begin; i < end; i++) {
+      // Each counter gives the bits of two consecutive elements
+      if (i == begin || i % 2 == 0) {
+        const uint32_t counter[4] = {static_cast<uint32_t>(i / 2),
+                                     static_cast<uint32_t>(i / 2 >> 32), 0,
+                                     0};
+        philox4x32_10(counter, key, bits);
+      }
+      const uint32_t *word = bits + 2 * (i % 2);
+      data[i] = random_bits_to_value<T>(
+          word[0] | static_cast<uint64_t>(word[1]) << 32, min, max);
+    }
+  };
+
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const size_t chunks = (count + min_chunk - 1) / min_chunk;
+  threads = static_cast<uint32_t>(std::min<size_t>(threads, chunks));
+  if (threads <= 1) {
+    fill(0, count);
+    return;
+  }
+  const size_t chunk = (count + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (size_t begin = chunk; begin < count; begin += chunk) {
+    workers.emplace_back(fill, begin, std::min(begin + chunk, count));
+  }
+  fill(0, chunk);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+template <typename T>
+void generate_buffer(T *data, const size_t count, const uint64_t seed,
+                     uint32_t threads = 0) {
+  generate_buffer(data, count, std::numeric_limits<T>::min(),
+                  std::numeric_limits<T>::max(), seed, threads);
+}
+
 template <typename T>
 std::vector<T> generate_vector(const int size, const T min, const T max,
                                const int seed) {
   std::vector<T> data(size);
-  std::generate(data.begin(), data.end(),
-                [&] { return generate_value<T>(min, max, seed); });
+  generate_buffer(data.data(), data.size(), min, max, seed);
   return data;
 }
 
 template <typename T>
 std::vector<T> generate_vector(const int size, const int seed) {
   std::vector<T> data(size);
-  std::generate(data.begin(), data.end(),
-                [&] { return generate_value<T>(seed); });
+  generate_buffer(data.data(), data.size(), seed);
   return data;
 }
 
@@ -9,6 +9,27 @@
 #include "random/random.hpp"
 
 namespace level_zero_tests {
+void philox4x32_10(const uint32_t counter[4], const uint32_t key[2],
+                   uint32_t result[4]) {
+  uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+  uint32_t k[2] = {key[0], key[1]};
+  for (int round = 0; round < 10; round++) {
+    if (round > 0) {
+      k[0] += 0x9E3779B9;
+      k[1] += 0xBB67AE85;
+    }
+    const uint64_t product0 = static_cast<uint64_t>(0xD2511F53) * c[0];
+    const uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57) * c[2];
+    const uint32_t next[4] = {
+        static_cast<uint32_t>(product1 >> 32) ^ c[1] ^ k[0],
+        static_cast<uint32_t>(product1),
+        static_cast<uint32_t>(product0 >> 32) ^ c[3] ^ k[1],
+        static_cast<uint32_t>(product0)};
+    std::copy(next, next + 4, c);
+  }
+  std::copy(c, c + 4, result);
+}
+
 template <>
 int8_t generate_value<int8_t>(const int8_t min, const int8_t max,
                               const int seed) {
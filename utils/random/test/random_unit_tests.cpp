@@ -9,6 +9,7 @@
 #include "random/random.hpp"
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace lzt = level_zero_tests;
@@ -117,3 +118,58 @@ TYPED_TEST(GenerateVector, WithExpectedSize) {
       lzt::generate_vector<TypeParam>(this->size, this->seed);
   EXPECT_EQ(this->size, vector.size());
 }
+
+TEST(Philox, MatchesKnownAnswers) {
+  // From the known answer tests of Random123
+  const uint32_t zero_counter[4] = {0, 0, 0, 0};
+  const uint32_t zero_key[2] = {0, 0};
+  uint32_t result[4];
+  lzt::philox4x32_10(zero_counter, zero_key, result);
+  EXPECT_EQ(0x6627e8d5u, result[0]);
+  EXPECT_EQ(0xe169c58du, result[1]);
+  EXPECT_EQ(0xbc57ac4cu, result[2]);
+  EXPECT_EQ(0x9b00dbd8u, result[3]);
+
+  const uint32_t pi_counter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e,
+                                  0x03707344};
+  const uint32_t pi_key[2] = {0xa4093822, 0x299f31d0};
+  lzt::philox4x32_10(pi_counter, pi_key, result);
+  EXPECT_EQ(0xd16cfe09u, result[0]);
+  EXPECT_EQ(0x94fdccebu, result[1]);
+  EXPECT_EQ(0x5001e420u, result[2]);
+  EXPECT_EQ(0x24126ea1u, result[3]);
+}
+
+template <typename T> class GenerateBuffer : public testing::Test {
+protected:
+  const size_t size = 1000 * 1000 + 1;
+  const uint64_t seed = 0x123456789abcdef;
+};
+TYPED_TEST_CASE(GenerateBuffer, StandardTypes);
+
+TYPED_TEST(GenerateBuffer, SameForAnyThreadCount) {
+  std::vector<TypeParam> expected(this->size);
+  lzt::generate_buffer(expected.data(), expected.size(), this->seed, 1);
+  for (uint32_t threads : {2u, 3u, 7u, 0u}) {
+    std::vector<TypeParam> buffer(this->size);
+    lzt::generate_buffer(buffer.data(), buffer.size(), this->seed, threads);
+    EXPECT_EQ(expected, buffer) << threads << " threads";
+  }
+}
+
+TYPED_TEST(GenerateBuffer, DifferentForDifferentSeeds) {
+  std::vector<TypeParam> first(this->size);
+  std::vector<TypeParam> second(this->size);
+  lzt::generate_buffer(first.data(), first.size(), this->seed);
+  lzt::generate_buffer(second.data(), second.size(), this->seed + 1);
+  EXPECT_NE(first, second);
+}
+
+TYPED_TEST(GenerateBuffer, WithinGivenMinAndMaxValue) {
+  const TypeParam min = 1;
+  const TypeParam max = 10;
+  std::vector<TypeParam> buffer(this->size);
+  lzt::generate_buffer(buffer.data(), buffer.size(), min, max, this->seed);
+  EXPECT_LE(min, *std::min_element(buffer.begin(), buffer.end()));
+  EXPECT_GE(max, *std::max_element(buffer.begin(), buffer.end()));
+}
@@ -21,10 +21,15 @@
 #include "test_harness_image.hpp"
 #include "test_harness_module.hpp"
 #include "test_harness_sampler.hpp"
+#include "test_harness_shard.hpp"
+#include "test_harness_statistics.hpp"
+#include "test_harness_topology.hpp"
 //#include "test_harness_ocl_interop.hpp"
 #include "test_harness_driver_info.hpp"
 #include "../../tools/include/test_harness_api_tracing.hpp"
 #include "../../tools/include/test_harness_api_ltracing.hpp"
+#include "../../tools/include/test_harness_trace_collector.hpp"
+#include "../../tools/include/test_harness_tracing_overhead.hpp"
 #include "../../sysman/include/test_harness_sysman.hpp"
 #include "../../tools/include/test_harness_metric.hpp"
 #include "../../tools/include/test_harness_debug.hpp"
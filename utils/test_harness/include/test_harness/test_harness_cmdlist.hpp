@@ -13,6 +13,9 @@
 #include <level_zero/ze_api.h>
 #include "gtest/gtest.h"
 
+#include <functional>
+#include <vector>
+
 namespace level_zero_tests {
 
 struct zeCommandBundle {
@@ -261,6 +264,49 @@ void destroy_command_list(ze_command_list_handle_t cl);
 
 void execute_and_sync_command_bundle(zeCommandBundle bundle, uint64_t timeout);
 void destroy_command_bundle(zeCommandBundle bundle);
+// Destroys the LZT_REUSE_COMMAND_BUNDLES bundles of context, before it is
+// destroyed
+void release_command_bundles(ze_context_handle_t context);
+
+// Accumulates operations in the command list of one bundle and submits them
+// together, in place of a close, execute, synchronize and reset per
+// operation.  Each operation may come with a verification that runs on the
+// host once the batch completed, in the order of the operations.  Unless
+// the batch is created independent, operations are separated by barriers,
+// so that each one sees the results of the previous ones as with one
+// submission per operation.  The batch is submitted once it holds
+// max_operations operations, by submit() and on destruction.
+class zeDeferredBatch {
+public:
+  zeDeferredBatch();
+  zeDeferredBatch(ze_device_handle_t device, bool isImmediate);
+  zeDeferredBatch(ze_context_handle_t context, ze_device_handle_t device,
+                  uint32_t ordinal, bool isImmediate, bool independent);
+  ~zeDeferredBatch();
+  zeDeferredBatch(const zeDeferredBatch &) = delete;
+  zeDeferredBatch &operator=(const zeDeferredBatch &) = delete;
+
+  // operation appends its commands to the list it is given
+  void append(const std::function<void(ze_command_list_handle_t)> &operation,
+              const std::function<void()> &verification = nullptr);
+  void append_memory_copy(void *dstptr, const void *srcptr, size_t size,
+                          const std::function<void()> &verification = nullptr);
+  void append_memory_fill(void *dstptr, const void *pattern,
+                          size_t pattern_size, size_t size,
+                          const std::function<void()> &verification = nullptr);
+  void submit();
+
+  size_t pending() const { return operations_; }
+  ze_command_list_handle_t list() const { return bundle_.list; }
+
+  size_t max_operations = 256;
+
+private:
+  zeCommandBundle bundle_;
+  bool independent_ = false;
+  size_t operations_ = 0;
+  std::vector<std::function<void()>> verifications_;
+};
 
 }; // namespace level_zero_tests
 #endif
@@ -45,6 +45,11 @@ std::vector<ze_device_handle_t> get_ze_sub_devices(ze_device_handle_t device);
 std::vector<ze_device_handle_t> get_ze_sub_devices(ze_device_handle_t device,
                                                    uint32_t count);
 
+// The device, compute, memory and image properties are queried once per
+// device and then returned from a cache, unless LZT_DISABLE_PROPERTY_CACHE
+// is set. clear_properties_cache() drops them, which destroy_context() and
+// sysman_device_reset() do.
+void clear_properties_cache();
 ze_device_properties_t get_device_properties(ze_device_handle_t device,
                                              ze_structure_type_t stype);
 ze_device_properties_t get_device_properties(ze_device_handle_t device);
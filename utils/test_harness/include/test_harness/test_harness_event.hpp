@@ -12,6 +12,10 @@
 #include "test_harness/test_harness.hpp"
 #include <level_zero/ze_api.h>
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace lzt = level_zero_tests;
 
 namespace level_zero_tests {
@@ -25,6 +29,13 @@ public:
   // during the first call to create_events().  To change the default behavior
   // call InitEventPool() with any other values BEFORE calling
   // create_events().
+  //
+  // Once all events of the pools are in use, create_event() adds another
+  // pool with the same flags and devices and twice the count of the last
+  // one, so only event_pool_ holds the first count events.  Pools created
+  // with a desc.pNext extension chain do not grow.  Free events are
+  // kept in a free list and looked up by handle, and all members may be
+  // called from several threads.
   void InitEventPool();
   void InitEventPool(uint32_t count);
   void InitEventPool(ze_context_handle_t context, uint32_t count);
@@ -53,8 +64,29 @@ public:
 
   ze_event_pool_handle_t event_pool_ = nullptr;
   ze_context_handle_t context_ = nullptr;
-  std::vector<bool> pool_indexes_available_;
-  std::map<ze_event_handle_t, uint32_t> handle_to_index_map_;
+
+private:
+  struct EventSlot {
+    uint32_t pool;
+    uint32_t index;
+  };
+
+  void init_event_pool(ze_event_pool_desc_t desc,
+                       const std::vector<ze_device_handle_t> &devices);
+  void add_event_pool(uint32_t count);
+  bool take_free_slot(EventSlot &slot);
+
+  std::mutex mutex_;
+  ze_event_pool_desc_t pool_desc_ = {};
+  std::vector<ze_device_handle_t> pool_devices_;
+  bool grows_ = true;
+  // event_pools_[0] is event_pool_
+  std::vector<ze_event_pool_handle_t> event_pools_;
+  std::vector<std::vector<bool>> slots_in_use_;
+  // May hold slots taken since by create_event() with an explicit index,
+  // which take_free_slot() skips
+  std::vector<EventSlot> free_slots_;
+  std::unordered_map<ze_event_handle_t, EventSlot> handle_to_slot_;
 };
 
 void signal_event_from_host(ze_event_handle_t hEvent);
@@ -94,6 +126,44 @@ get_timestamp_context_duration(const ze_kernel_timestamp_result_t *timestamp,
                                const ze_structure_type_t property_type =
                                    ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES);
 
+// Converts the kernel timestamps of a device to nanoseconds.  Only the
+// kernelTimestampValidBits low bits of a timestamp are valid, and an end
+// below its start has wrapped around once.
+struct TimestampClock {
+  double ns_per_tick = 0;
+  uint64_t valid_mask = 0;
+
+  uint64_t ticks(uint64_t start, uint64_t end) const;
+  // Ticks from origin to value, negative when value is before origin,
+  // for timestamps less than half a wraparound apart
+  int64_t signed_ticks(uint64_t origin, uint64_t value) const;
+  double duration_ns(const ze_kernel_timestamp_data_t &data) const;
+};
+TimestampClock get_timestamp_clock(ze_device_handle_t device);
+
+// Start and end of a kernel in nanoseconds from the start of its timeline
+struct TimestampSpan {
+  double start_ns = 0;
+  double end_ns = 0;
+  double duration_ns() const { return end_ns - start_ns; }
+};
+// Spans of a set of kernels in the order given, from the earliest start.
+// total_ns runs from the earliest start to the latest end, and busy_ns
+// counts the time any of the kernels ran, so total_ns - busy_ns is the
+// time the device was idle between them.
+struct KernelTimeline {
+  std::vector<TimestampSpan> spans;
+  double total_ns = 0;
+  double busy_ns = 0;
+};
+KernelTimeline
+get_kernel_timeline(const TimestampClock &clock,
+                    const std::vector<ze_kernel_timestamp_result_t> &timestamps,
+                    bool context_timestamps = false);
+KernelTimeline get_kernel_timeline(ze_device_handle_t device,
+                                   const std::vector<ze_event_handle_t> &events,
+                                   bool context_timestamps = false);
+
 #ifdef ZE_EVENT_QUERY_TIMESTAMPS_EXP_NAME
 uint32_t get_timestamp_count(const ze_event_handle_t &event,
                              const ze_device_handle_t &device);
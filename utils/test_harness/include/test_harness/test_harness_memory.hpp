@@ -101,6 +101,8 @@ void allocate_mem(void **memory, ze_memory_type_t mem_type, size_t size,
 
 void free_memory(const void *ptr);
 void free_memory(ze_context_handle_t context, const void *ptr);
+// Frees the LZT_USM_ARENA blocks of context, before it is destroyed
+void release_usm_arena(ze_context_handle_t context);
 
 void allocate_mem_and_get_ipc_handle(ze_context_handle_t context,
                                      ze_ipc_mem_handle_t *handle, void **memory,
@@ -114,8 +116,30 @@ void put_ipc_handle(ze_context_handle_t context, ze_ipc_mem_handle_t handle);
 void open_ipc_handle(ze_context_handle_t context, ze_device_handle_t device,
                      ze_ipc_mem_handle_t mem_handle, void **memory);
 void close_ipc_handle(ze_context_handle_t context, void **memory);
+
+// Mismatching bytes of a buffer and, when there are any, the offset and
+// values of the first one
+struct DataMismatch {
+  size_t count = 0;
+  size_t first = 0;
+  uint8_t expected = 0;
+  uint8_t actual = 0;
+};
+
+// Byte i of the pattern is data_pattern * (i + 1).  Buffers are filled and
+// checked in blocks on several host threads, and must be host accessible.
 void write_data_pattern(void *buff, size_t size, int8_t data_pattern);
 void validate_data_pattern(void *buff, size_t size, int8_t data_pattern);
+DataMismatch check_data_pattern(const void *buff, size_t size,
+                                int8_t data_pattern);
+DataMismatch compare_buffers(const void *actual, const void *expected,
+                             size_t size);
+// Checks the pattern with a kernel, so that device memory is not copied to
+// the host.  The kernel uses 64-bit atomics.
+DataMismatch check_data_pattern_on_device(ze_context_handle_t context,
+                                          ze_device_handle_t device,
+                                          const void *buff, size_t size,
+                                          int8_t data_pattern);
 void get_mem_alloc_properties(
     ze_context_handle_t context, const void *memory,
     ze_memory_allocation_properties_t *memory_properties);
@@ -0,0 +1,31 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_ZE_TEST_HARNESS_SHARD_HPP
+#define level_zero_tests_ZE_TEST_HARNESS_SHARD_HPP
+
+#include <string>
+#include <vector>
+
+namespace level_zero_tests {
+
+// Runs the tests of the binary as RUN_ALL_TESTS does.  With
+// LZT_SHARD_DEVICES set to devices or subdevices, it instead runs one
+// worker process of the binary per device or subdevice of the default
+// driver, as a gtest shard whose default device is that device, waits for
+// all of them and merges their XML output.  Called after zeInit.
+int run_all_tests();
+
+// Merges gtest XML reports into one, summing their counts and keeping the
+// longest time
+bool merge_xml_reports(const std::vector<std::string> &reports,
+                       const std::string &output);
+
+}; // namespace level_zero_tests
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_ZE_TEST_HARNESS_STATISTICS_HPP
+#define level_zero_tests_ZE_TEST_HARNESS_STATISTICS_HPP
+
+#include <vector>
+
+namespace level_zero_tests {
+
+// Untimed iterations the performance tests run before the measured ones,
+// so that first use costs such as lazy allocation or residency are not
+// part of the samples
+const int warm_up_iterations = 1;
+
+// Sample at the given percent (0 to 100) of the sorted samples, the lower
+// one when it falls between two.  Fails the test when values is empty.
+double percentile(std::vector<double> values, double percent);
+
+double median(const std::vector<double> &values);
+
+}; // namespace level_zero_tests
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_ZE_TEST_HARNESS_TOPOLOGY_HPP
+#define level_zero_tests_ZE_TEST_HARNESS_TOPOLOGY_HPP
+
+#include <level_zero/ze_api.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace level_zero_tests {
+
+struct TopologyDevice {
+  ze_device_handle_t device = nullptr;
+  // The device itself for root devices
+  ze_device_handle_t root = nullptr;
+  uint32_t root_index = 0;
+  // -1 for root devices
+  int sub_device_index = -1;
+  // Null when the fabric does not expose the device
+  ze_fabric_vertex_handle_t vertex = nullptr;
+};
+
+// What a device can do with the memory of a peer
+struct TopologyLink {
+  bool can_access = false;
+  ze_device_p2p_property_flags_t flags = 0;
+  // From the bandwidth properties extension, 0 when it is not supported
+  uint32_t logical_bandwidth = 0;
+  uint32_t physical_bandwidth = 0;
+  uint32_t logical_latency = 0;
+  uint32_t physical_latency = 0;
+  // Fabric edges between the vertices of the two devices
+  std::vector<ze_fabric_edge_exp_properties_t> edges;
+
+  bool has_atomics() const {
+    return (flags & ZE_DEVICE_P2P_PROPERTY_FLAG_ATOMICS) != 0;
+  }
+};
+
+// Root devices and their subdevices, the P2P properties of every ordered
+// pair of them and the fabric edges between them, queried once.  Fabric
+// and bandwidth information is left empty when the driver does not
+// support it, so building the topology does not fail a test.
+class DeviceTopology {
+public:
+  // The topology of the default driver, built on first use
+  static const DeviceTopology &get();
+  explicit DeviceTopology(ze_driver_handle_t driver);
+
+  // Root devices in order, each followed by its subdevices
+  const std::vector<TopologyDevice> &devices() const { return devices_; }
+  std::vector<ze_device_handle_t> root_devices() const;
+  std::vector<ze_device_handle_t> sub_devices(ze_device_handle_t root) const;
+  const TopologyDevice *find(ze_device_handle_t device) const;
+
+  // Null for a device and itself, or devices not in the topology
+  const TopologyLink *link(ze_device_handle_t device,
+                           ze_device_handle_t peer) const;
+  bool can_access_peer(ze_device_handle_t device,
+                       ze_device_handle_t peer) const;
+  // Ordered pairs in which the first device can access the memory of the
+  // second, of root devices only unless include_sub_devices
+  std::vector<std::pair<ze_device_handle_t, ze_device_handle_t>>
+  p2p_pairs(bool include_sub_devices = false,
+            bool require_atomics = false) const;
+
+private:
+  void find_vertices(ze_driver_handle_t driver);
+  void query_links(ze_driver_handle_t driver);
+
+  std::vector<TopologyDevice> devices_;
+  std::map<std::pair<ze_device_handle_t, ze_device_handle_t>, TopologyLink>
+      links_;
+};
+
+}; // namespace level_zero_tests
+
+#endif
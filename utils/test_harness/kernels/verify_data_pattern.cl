@@ -0,0 +1,26 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+// Checks the bytes of buffer against the pattern of write_data_pattern,
+// in which byte i is pattern * (i + 1), counting the mismatches in
+// result[0] and keeping the offset of the first one in result[1], which
+// the caller initializes to 0 and ULONG_MAX. Built into
+// test_harness_memory.cpp as SPIR-V.
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#pragma OPENCL EXTENSION cl_khr_int64_extended_atomics : enable
+
+__kernel void verify_data_pattern(__global const uchar *buffer, ulong size,
+                                  uchar pattern, __global ulong *result) {
+  for (ulong i = get_global_id(0); i < size; i += get_global_size(0)) {
+    const uchar expected = (uchar)(pattern * (i + 1));
+    if (buffer[i] != expected) {
+      atom_inc(&result[0]);
+      atom_min(&result[1], i);
+    }
+  }
+}
@@ -11,10 +11,79 @@
 #include "utils/utils.hpp"
 #include <level_zero/ze_api.h>
 
+#include <cstdlib>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 namespace lzt = level_zero_tests;
 
 namespace level_zero_tests {
 
+namespace {
+
+// With LZT_REUSE_COMMAND_BUNDLES set, destroy_command_bundle resets the
+// list of a bundle and keeps the bundle, and create_command_bundle returns
+// a kept bundle created with the same parameters instead of creating a new
+// queue and list.  Bundles are kept by context, device, queue and list
+// parameters, up to a few per key, and destroyed with their context.
+struct CommandBundlePool {
+  using Key = std::tuple<ze_context_handle_t, ze_device_handle_t,
+                         ze_command_queue_flags_t, ze_command_queue_mode_t,
+                         ze_command_queue_priority_t, ze_command_list_flags_t,
+                         uint32_t, uint32_t, bool>;
+  static constexpr size_t max_bundles_per_key = 4;
+
+  std::mutex mutex;
+  bool enabled = getenv("LZT_REUSE_COMMAND_BUNDLES") != nullptr;
+  std::map<Key, std::vector<zeCommandBundle>> bundles;
+  // Parameters of every bundle created while enabled, by its list
+  std::unordered_map<ze_command_list_handle_t, Key> keys;
+};
+
+CommandBundlePool &command_bundle_pool() {
+  static CommandBundlePool pool;
+  return pool;
+}
+
+void destroy_bundle_handles(const zeCommandBundle &bundle) {
+  if (bundle.queue != nullptr) {
+    EXPECT_EQ(ZE_RESULT_SUCCESS, zeCommandQueueDestroy(bundle.queue));
+  }
+  EXPECT_EQ(ZE_RESULT_SUCCESS, zeCommandListDestroy(bundle.list));
+}
+
+} // namespace
+
+void release_command_bundles(ze_context_handle_t context) {
+  auto &pool = command_bundle_pool();
+  if (!pool.enabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  auto entry = pool.bundles.begin();
+  while (entry != pool.bundles.end()) {
+    if (std::get<0>(entry->first) != context) {
+      ++entry;
+      continue;
+    }
+    for (auto &bundle : entry->second) {
+      pool.keys.erase(bundle.list);
+      destroy_bundle_handles(bundle);
+    }
+    entry = pool.bundles.erase(entry);
+  }
+  // Bundles of the context still in use are no longer kept when destroyed
+  auto key = pool.keys.begin();
+  while (key != pool.keys.end()) {
+    key = (std::get<0>(key->second) == context) ? pool.keys.erase(key)
+                                                 : std::next(key);
+  }
+}
+
 ze_command_list_handle_t create_command_list() {
   return create_command_list(zeDevice::get_instance()->get_device());
 }
@@ -161,6 +230,21 @@ zeCommandBundle create_command_bundle(
   if (!(queueFlags & ZE_COMMAND_QUEUE_FLAG_EXPLICIT_ONLY)) {
     EXPECT_EQ(0, index);
   }
+
+  auto &pool = command_bundle_pool();
+  const CommandBundlePool::Key key(context, device, queueFlags, mode,
+                                   priority, listFlags, ordinal, index,
+                                   isImmediate);
+  if (pool.enabled) {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    auto entry = pool.bundles.find(key);
+    if (entry != pool.bundles.end() && !entry->second.empty()) {
+      auto bundle = entry->second.back();
+      entry->second.pop_back();
+      return bundle;
+    }
+  }
+
   ze_command_queue_desc_t queueDesc = {};
   queueDesc.stype = ZE_STRUCTURE_TYPE_COMMAND_QUEUE_DESC;
   queueDesc.pNext = nullptr;
@@ -198,6 +282,10 @@ zeCommandBundle create_command_bundle(
   EXPECT_EQ(context, context_initial);
   EXPECT_EQ(device, device_initial);
 
+  if (pool.enabled && list != nullptr) {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    pool.keys[list] = key;
+  }
   return {queue, list};
 }
 
@@ -824,10 +912,105 @@ void execute_and_sync_command_bundle(zeCommandBundle bundle, uint64_t timeout) {
   }
 }
 
+zeDeferredBatch::zeDeferredBatch()
+    : zeDeferredBatch(zeDevice::get_instance()->get_device(), false) {}
+
+zeDeferredBatch::zeDeferredBatch(ze_device_handle_t device, bool isImmediate)
+    : zeDeferredBatch(lzt::get_default_context(), device, 0, isImmediate,
+                      false) {}
+
+zeDeferredBatch::zeDeferredBatch(ze_context_handle_t context,
+                                 ze_device_handle_t device, uint32_t ordinal,
+                                 bool isImmediate, bool independent)
+    : independent_(independent) {
+  bundle_ = create_command_bundle(context, device, 0, ordinal, isImmediate);
+}
+
+zeDeferredBatch::~zeDeferredBatch() {
+  submit();
+  destroy_command_bundle(bundle_);
+}
+
+void zeDeferredBatch::append(
+    const std::function<void(ze_command_list_handle_t)> &operation,
+    const std::function<void()> &verification) {
+  if (operations_ > 0 && !independent_) {
+    append_barrier(bundle_.list);
+  }
+  operation(bundle_.list);
+  operations_++;
+  if (verification) {
+    verifications_.push_back(verification);
+  }
+  if (operations_ >= max_operations) {
+    submit();
+  }
+}
+
+void zeDeferredBatch::append_memory_copy(
+    void *dstptr, const void *srcptr, size_t size,
+    const std::function<void()> &verification) {
+  append(
+      [&](ze_command_list_handle_t cl) {
+        lzt::append_memory_copy(cl, dstptr, srcptr, size);
+      },
+      verification);
+}
+
+void zeDeferredBatch::append_memory_fill(
+    void *dstptr, const void *pattern, size_t pattern_size, size_t size,
+    const std::function<void()> &verification) {
+  append(
+      [&](ze_command_list_handle_t cl) {
+        lzt::append_memory_fill(cl, dstptr, pattern, pattern_size, size,
+                                nullptr);
+      },
+      verification);
+}
+
+void zeDeferredBatch::submit() {
+  if (operations_ == 0) {
+    return;
+  }
+  // Appends to an immediate list are already submitted
+  if (bundle_.queue != nullptr) {
+    close_command_list(bundle_.list);
+  }
+  execute_and_sync_command_bundle(bundle_, UINT64_MAX);
+  if (bundle_.queue != nullptr) {
+    reset_command_list(bundle_.list);
+  }
+  operations_ = 0;
+
+  // A verification may append to the batch again
+  std::vector<std::function<void()>> verifications;
+  verifications.swap(verifications_);
+  for (auto &verification : verifications) {
+    verification();
+  }
+}
+
 void destroy_command_bundle(zeCommandBundle bundle) {
-  if (bundle.queue != nullptr) {
-    EXPECT_EQ(ZE_RESULT_SUCCESS, zeCommandQueueDestroy(bundle.queue));
+  auto &pool = command_bundle_pool();
+  if (pool.enabled) {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    auto key = pool.keys.find(bundle.list);
+    if (key != pool.keys.end()) {
+      auto &kept = pool.bundles[key->second];
+      // Work still in flight on a kept bundle would leak into the next test
+      const ze_result_t idle =
+          (bundle.queue != nullptr)
+              ? zeCommandQueueSynchronize(bundle.queue, UINT64_MAX)
+              : zeCommandListHostSynchronize(bundle.list, UINT64_MAX);
+      if (kept.size() < CommandBundlePool::max_bundles_per_key &&
+          idle == ZE_RESULT_SUCCESS &&
+          zeCommandListReset(bundle.list) == ZE_RESULT_SUCCESS) {
+        kept.push_back(bundle);
+        return;
+      }
+      pool.keys.erase(key);
+    }
   }
-  EXPECT_EQ(ZE_RESULT_SUCCESS, zeCommandListDestroy(bundle.list));
+  destroy_bundle_handles(bundle);
 }
 }; // namespace level_zero_tests
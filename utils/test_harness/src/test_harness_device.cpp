@@ -11,10 +11,69 @@
 #include <level_zero/zes_api.h>
 #include "utils/utils.hpp"
 
+#include <cstdlib>
+#include <map>
+#include <utility>
+
 namespace lzt = level_zero_tests;
 
 namespace level_zero_tests {
 
+namespace {
+
+struct PropertiesCache {
+  std::mutex mutex;
+  bool disabled = (getenv("LZT_DISABLE_PROPERTY_CACHE") != nullptr);
+  std::map<std::pair<ze_device_handle_t, ze_structure_type_t>,
+           ze_device_properties_t>
+      device;
+  std::map<ze_device_handle_t, ze_device_compute_properties_t> compute;
+  std::map<std::pair<ze_device_handle_t, uint32_t>,
+           std::vector<ze_device_memory_properties_t>>
+      memory;
+  std::map<std::pair<ze_device_handle_t, uint32_t>,
+           std::vector<ze_device_memory_ext_properties_t>>
+      memory_ext;
+  std::map<ze_device_handle_t, ze_device_image_properties_t> image;
+};
+
+PropertiesCache &properties_cache() {
+  static PropertiesCache cache;
+  return cache;
+}
+
+// Returns the cached value of key, or queries and caches it. The query
+// runs without the lock, so two threads may both query a new key.
+template <typename K, typename V, typename Q>
+V cached_properties(std::map<K, V> &cache, const K &key, Q query) {
+  auto &properties = properties_cache();
+  if (!properties.disabled) {
+    std::lock_guard<std::mutex> lock(properties.mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+  V value = query();
+  if (!properties.disabled && !::testing::Test::HasFailure()) {
+    std::lock_guard<std::mutex> lock(properties.mutex);
+    cache[key] = value;
+  }
+  return value;
+}
+
+} // namespace
+
+void clear_properties_cache() {
+  auto &properties = properties_cache();
+  std::lock_guard<std::mutex> lock(properties.mutex);
+  properties.device.clear();
+  properties.compute.clear();
+  properties.memory.clear();
+  properties.memory_ext.clear();
+  properties.image.clear();
+}
+
 zeDevice *zeDevice::instance_ = nullptr;
 std::once_flag zeDevice::instance;
 
@@ -156,30 +215,35 @@ ze_device_properties_t get_device_properties(ze_device_handle_t device) {
 
 ze_device_properties_t get_device_properties(ze_device_handle_t device,
                                              ze_structure_type_t stype) {
-  auto device_initial = device;
-  ze_device_properties_t properties = {};
-  if (stype == ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES_1_2) {
-    properties.stype = stype;
-  } else {
-    properties.stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
+  if (stype != ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES_1_2) {
+    stype = ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES;
   }
-  EXPECT_EQ(ZE_RESULT_SUCCESS, zeDeviceGetProperties(device, &properties));
-  EXPECT_EQ(device, device_initial);
-  return properties;
+  return cached_properties(
+      properties_cache().device, std::make_pair(device, stype), [&]() {
+        auto device_initial = device;
+        ze_device_properties_t properties = {};
+        properties.stype = stype;
+        EXPECT_EQ(ZE_RESULT_SUCCESS,
+                  zeDeviceGetProperties(device, &properties));
+        EXPECT_EQ(device, device_initial);
+        return properties;
+      });
 }
 
 ze_device_compute_properties_t
 get_compute_properties(ze_device_handle_t device) {
-  ze_device_compute_properties_t properties = {
-      ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES, nullptr};
-  memset(&properties, 0, sizeof(properties));
-  properties = {ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES};
-
-  auto device_initial = device;
-  EXPECT_EQ(ZE_RESULT_SUCCESS,
-            zeDeviceGetComputeProperties(device, &properties));
-  EXPECT_EQ(device, device_initial);
-  return properties;
+  return cached_properties(properties_cache().compute, device, [&]() {
+    ze_device_compute_properties_t properties = {
+        ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES, nullptr};
+    memset(&properties, 0, sizeof(properties));
+    properties = {ZE_STRUCTURE_TYPE_DEVICE_COMPUTE_PROPERTIES};
+
+    auto device_initial = device;
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeDeviceGetComputeProperties(device, &properties));
+    EXPECT_EQ(device, device_initial);
+    return properties;
+  });
 }
 
 uint32_t get_memory_properties_count(ze_device_handle_t device) {
@@ -199,35 +263,63 @@ get_memory_properties(ze_device_handle_t device) {
 
 std::vector<ze_device_memory_properties_t>
 get_memory_properties(ze_device_handle_t device, uint32_t count) {
-  std::vector<ze_device_memory_properties_t> properties(count);
-  memset(properties.data(), 0, sizeof(ze_device_memory_properties_t) * count);
-  for (auto &prop : properties) {
-    prop.pNext = nullptr;
-    prop.stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_PROPERTIES;
-  }
-
-  auto device_initial = device;
-  EXPECT_EQ(ZE_RESULT_SUCCESS,
-            zeDeviceGetMemoryProperties(device, &count, properties.data()));
-  EXPECT_EQ(device, device_initial);
-  return properties;
-}
-
+  return cached_properties(
+      properties_cache().memory, std::make_pair(device, count), [&]() {
+        std::vector<ze_device_memory_properties_t> properties(count);
+        memset(properties.data(), 0,
+               sizeof(ze_device_memory_properties_t) * count);
+        for (auto &prop : properties) {
+          prop.pNext = nullptr;
+          prop.stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_PROPERTIES;
+        }
+
+        auto device_initial = device;
+        uint32_t query_count = count;
+        EXPECT_EQ(ZE_RESULT_SUCCESS,
+                  zeDeviceGetMemoryProperties(device, &query_count,
+                                              properties.data()));
+        EXPECT_EQ(device, device_initial);
+        return properties;
+      });
+}
+
+// The extension structures are cached on their own and copied to
+// extProperties, which the pNext pointers of the returned properties point
+// into
 std::vector<ze_device_memory_properties_t> get_memory_properties_ext(
     ze_device_handle_t device, uint32_t count,
     std::vector<ze_device_memory_ext_properties_t> &extProperties) {
-  std::vector<ze_device_memory_properties_t> properties(count);
-  memset(properties.data(), 0, sizeof(ze_device_memory_properties_t) * count);
-  for (int i = 0; i < count; i++) {
-    properties[i].stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_PROPERTIES;
-    extProperties[i].stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_EXT_PROPERTIES;
+  auto ext_properties = cached_properties(
+      properties_cache().memory_ext, std::make_pair(device, count), [&]() {
+        std::vector<ze_device_memory_properties_t> properties(count);
+        std::vector<ze_device_memory_ext_properties_t> ext(count);
+        memset(properties.data(), 0,
+               sizeof(ze_device_memory_properties_t) * count);
+        memset(ext.data(), 0,
+               sizeof(ze_device_memory_ext_properties_t) * count);
+        for (uint32_t i = 0; i < count; i++) {
+          properties[i].stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_PROPERTIES;
+          ext[i].stype = ZE_STRUCTURE_TYPE_DEVICE_MEMORY_EXT_PROPERTIES;
+          properties[i].pNext = &ext[i];
+        }
+
+        auto device_initial = device;
+        uint32_t query_count = count;
+        EXPECT_EQ(ZE_RESULT_SUCCESS,
+                  zeDeviceGetMemoryProperties(device, &query_count,
+                                              properties.data()));
+        EXPECT_EQ(device, device_initial);
+        for (auto &prop : ext) {
+          prop.pNext = nullptr;
+        }
+        return ext;
+      });
+
+  auto properties = get_memory_properties(device, count);
+  for (uint32_t i = 0; i < count; i++) {
+    extProperties[i] = ext_properties[i];
     properties[i].pNext = &extProperties[i];
   }
-
-  auto device_initial = device;
-  EXPECT_EQ(ZE_RESULT_SUCCESS,
-            zeDeviceGetMemoryProperties(device, &count, properties.data()));
-  EXPECT_EQ(device, device_initial);
   return properties;
 }
 
@@ -319,14 +411,17 @@ get_cache_properties(ze_device_handle_t device) {
 }
 
 ze_device_image_properties_t get_image_properties(ze_device_handle_t device) {
-  ze_device_image_properties_t properties;
-  memset(&properties, 0, sizeof(properties));
-  properties = {ZE_STRUCTURE_TYPE_DEVICE_IMAGE_PROPERTIES};
-
-  auto device_initial = device;
-  EXPECT_EQ(ZE_RESULT_SUCCESS, zeDeviceGetImageProperties(device, &properties));
-  EXPECT_EQ(device, device_initial);
-  return properties;
+  return cached_properties(properties_cache().image, device, [&]() {
+    ze_device_image_properties_t properties;
+    memset(&properties, 0, sizeof(properties));
+    properties = {ZE_STRUCTURE_TYPE_DEVICE_IMAGE_PROPERTIES};
+
+    auto device_initial = device;
+    EXPECT_EQ(ZE_RESULT_SUCCESS,
+              zeDeviceGetImageProperties(device, &properties));
+    EXPECT_EQ(device, device_initial);
+    return properties;
+  });
 }
 
 ze_device_module_properties_t
@@ -9,6 +9,8 @@
 #include "test_harness/test_harness.hpp"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+
 namespace lzt = level_zero_tests;
 
 namespace level_zero_tests {
@@ -182,6 +184,97 @@ get_timestamp_context_duration(const ze_kernel_timestamp_result_t *timestamp,
   return context_time_ns;
 }
 
+uint64_t TimestampClock::ticks(uint64_t start, uint64_t end) const {
+  start &= valid_mask;
+  end &= valid_mask;
+  return (end >= start) ? end - start : (valid_mask - start) + end + 1;
+}
+
+int64_t TimestampClock::signed_ticks(uint64_t origin, uint64_t value) const {
+  const uint64_t forward = ticks(origin, value);
+  return (forward > valid_mask / 2)
+             ? -static_cast<int64_t>(valid_mask - forward + 1)
+             : static_cast<int64_t>(forward);
+}
+
+double
+TimestampClock::duration_ns(const ze_kernel_timestamp_data_t &data) const {
+  return ticks(data.kernelStart, data.kernelEnd) * ns_per_tick;
+}
+
+TimestampClock get_timestamp_clock(ze_device_handle_t device) {
+  // timerResolution is in cycles per second in the current properties
+  auto device_properties =
+      lzt::get_device_properties(device, ZE_STRUCTURE_TYPE_DEVICE_PROPERTIES);
+  TimestampClock clock;
+  if (device_properties.timerResolution != 0) {
+    clock.ns_per_tick =
+        1000000000.0 / static_cast<double>(device_properties.timerResolution);
+  }
+  const uint32_t valid_bits = device_properties.kernelTimestampValidBits;
+  clock.valid_mask =
+      (valid_bits == 0 || valid_bits >= 64) ? UINT64_MAX
+                                             : (uint64_t(1) << valid_bits) - 1;
+  return clock;
+}
+
+KernelTimeline
+get_kernel_timeline(const TimestampClock &clock,
+                    const std::vector<ze_kernel_timestamp_result_t> &timestamps,
+                    bool context_timestamps) {
+  KernelTimeline timeline;
+  if (timestamps.empty()) {
+    return timeline;
+  }
+  auto data = [&](const ze_kernel_timestamp_result_t &timestamp) {
+    return context_timestamps ? timestamp.context : timestamp.global;
+  };
+
+  // Relative to the first start, then moved to the earliest one
+  const uint64_t origin = data(timestamps[0]).kernelStart;
+  double earliest = 0;
+  for (auto &timestamp : timestamps) {
+    TimestampSpan span;
+    span.start_ns =
+        clock.signed_ticks(origin, data(timestamp).kernelStart) *
+        clock.ns_per_tick;
+    span.end_ns = span.start_ns + clock.duration_ns(data(timestamp));
+    earliest = std::min(earliest, span.start_ns);
+    timeline.spans.push_back(span);
+  }
+  for (auto &span : timeline.spans) {
+    span.start_ns -= earliest;
+    span.end_ns -= earliest;
+    timeline.total_ns = std::max(timeline.total_ns, span.end_ns);
+  }
+
+  auto sorted = timeline.spans;
+  std::sort(sorted.begin(), sorted.end(),
+            [](const TimestampSpan &a, const TimestampSpan &b) {
+              return a.start_ns < b.start_ns;
+            });
+  double covered_until = 0;
+  for (auto &span : sorted) {
+    const double start = std::max(span.start_ns, covered_until);
+    if (span.end_ns > start) {
+      timeline.busy_ns += span.end_ns - start;
+      covered_until = span.end_ns;
+    }
+  }
+  return timeline;
+}
+
+KernelTimeline get_kernel_timeline(ze_device_handle_t device,
+                                   const std::vector<ze_event_handle_t> &events,
+                                   bool context_timestamps) {
+  std::vector<ze_kernel_timestamp_result_t> timestamps;
+  for (auto event : events) {
+    timestamps.push_back(get_event_kernel_timestamp(event));
+  }
+  return get_kernel_timeline(get_timestamp_clock(device), timestamps,
+                             context_timestamps);
+}
+
 #ifdef ZE_EVENT_QUERY_TIMESTAMPS_EXP_NAME
 uint32_t get_timestamp_count(const ze_event_handle_t &event,
                              const ze_device_handle_t &device) {
@@ -220,77 +313,101 @@ void zeEventPool::InitEventPool(uint32_t count) {
   InitEventPool(count, ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
 }
 void zeEventPool::InitEventPool(uint32_t count, ze_event_pool_flags_t flags) {
-  if (event_pool_ == nullptr) {
-    if (context_ == nullptr) {
-      context_ = lzt::get_default_context();
-    }
-    event_pool_ = create_event_pool(context_, count, flags);
-    pool_indexes_available_.resize(count, true);
-  }
+  ze_event_pool_desc_t desc = {};
+  desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+  desc.flags = flags;
+  desc.count = count;
+  std::lock_guard<std::mutex> lock(mutex_);
+  init_event_pool(desc, {});
 }
 
 void zeEventPool::InitEventPool(ze_context_handle_t context, uint32_t count,
                                 ze_event_pool_flags_t flags) {
+  ze_event_pool_desc_t desc = {};
+  desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+  desc.flags = flags;
+  desc.count = count;
+  std::lock_guard<std::mutex> lock(mutex_);
   context_ = context;
-  if (event_pool_ == nullptr) {
-    if (context_ == nullptr) {
-      context_ = lzt::get_default_context();
-    }
-    event_pool_ = create_event_pool(context_, count, flags);
-    pool_indexes_available_.resize(count, true);
-  }
+  init_event_pool(desc, {});
 }
 
 void zeEventPool::InitEventPool(ze_context_handle_t context, uint32_t count) {
-  context_ = context;
-  if (event_pool_ == nullptr) {
-    if (context_ == nullptr) {
-      context_ = lzt::get_default_context();
-    }
-    event_pool_ =
-        create_event_pool(context_, count, ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
-    pool_indexes_available_.resize(count, true);
-  }
+  InitEventPool(context, count, ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
 }
 
 void zeEventPool::InitEventPool(ze_event_pool_desc_t desc) {
-  if (event_pool_ == nullptr) {
-    if (context_ == nullptr) {
-      context_ = lzt::get_default_context();
-    }
-    event_pool_ = create_event_pool(context_, desc);
-    pool_indexes_available_.resize(desc.count, true);
-  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  init_event_pool(desc, {});
 }
 
 void zeEventPool::InitEventPool(ze_event_pool_desc_t desc,
                                 std::vector<ze_device_handle_t> devices) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  init_event_pool(desc, devices);
+}
+
+// Called with mutex_ held
+void zeEventPool::init_event_pool(
+    ze_event_pool_desc_t desc, const std::vector<ze_device_handle_t> &devices) {
   if (event_pool_ == nullptr) {
     if (context_ == nullptr) {
       context_ = lzt::get_default_context();
     }
-    event_pool_ = create_event_pool(context_, desc, devices);
-    pool_indexes_available_.resize(desc.count, true);
+    pool_desc_ = desc;
+    pool_devices_ = devices;
+    add_event_pool(desc.count);
+    event_pool_ = event_pools_[0];
+    // The extensions of desc.pNext may not outlive this call, so pools
+    // created with them do not grow
+    grows_ = (desc.pNext == nullptr);
+    pool_desc_.pNext = nullptr;
+  }
+}
+
+// Called with mutex_ held
+void zeEventPool::add_event_pool(uint32_t count) {
+  ze_event_pool_desc_t desc = pool_desc_;
+  desc.count = count;
+  const uint32_t pool = static_cast<uint32_t>(event_pools_.size());
+  event_pools_.push_back(
+      pool_devices_.empty() ? create_event_pool(context_, desc)
+                            : create_event_pool(context_, desc, pool_devices_));
+  slots_in_use_.emplace_back(count, false);
+  // Reversed, so that the lowest index is taken first
+  for (uint32_t index = count; index > 0; index--) {
+    free_slots_.push_back({pool, index - 1});
   }
 }
 
+// Called with mutex_ held, returns false when all events are in use and
+// the pool cannot grow
+bool zeEventPool::take_free_slot(EventSlot &slot) {
+  while (!free_slots_.empty()) {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+    if (!slots_in_use_[slot.pool][slot.index]) {
+      slots_in_use_[slot.pool][slot.index] = true;
+      return true;
+    }
+  }
+  if (!grows_) {
+    return false;
+  }
+  add_event_pool(2 * static_cast<uint32_t>(slots_in_use_.back().size()));
+  return take_free_slot(slot);
+}
+
 zeEventPool::zeEventPool() {}
 
 zeEventPool::~zeEventPool() {
   // If the event pool was never created, do not attempt to destroy it
   // as that will needlessly cause a test failure.
-  if (event_pool_) {
-    destroy_event_pool(event_pool_);
+  for (auto pool : event_pools_) {
+    destroy_event_pool(pool);
   }
 }
 
-uint32_t find_index(const std::vector<bool> &indexes_available) {
-  for (uint32_t i = 0; i < indexes_available.size(); i++)
-    if (indexes_available[i])
-      return i;
-  return -1;
-}
-
 void zeEventPool::create_event(ze_event_handle_t &event) {
   create_event(event, 0, 0);
 }
@@ -298,8 +415,6 @@ void zeEventPool::create_event(ze_event_handle_t &event) {
 void zeEventPool::create_event(ze_event_handle_t &event,
                                ze_event_scope_flags_t signal,
                                ze_event_scope_flags_t wait) {
-  // Make sure the event pool is initialized to at least defaults:
-  InitEventPool();
   ze_event_desc_t desc = {};
   memset(&desc, 0, sizeof(desc));
   desc.stype = ZE_STRUCTURE_TYPE_EVENT_DESC;
@@ -307,18 +422,47 @@ void zeEventPool::create_event(ze_event_handle_t &event,
   desc.signal = signal;
   desc.wait = wait;
   event = nullptr;
-  desc.index = find_index(pool_indexes_available_);
-  EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventCreate(event_pool_, &desc, &event));
+
+  EventSlot slot;
+  ze_event_pool_handle_t pool;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Make sure the event pool is initialized to at least defaults:
+    if (event_pool_ == nullptr) {
+      ze_event_pool_desc_t pool_desc = {};
+      pool_desc.stype = ZE_STRUCTURE_TYPE_EVENT_POOL_DESC;
+      pool_desc.flags = ZE_EVENT_POOL_FLAG_HOST_VISIBLE;
+      pool_desc.count = 32;
+      init_event_pool(pool_desc, {});
+    }
+    if (!take_free_slot(slot)) {
+      ADD_FAILURE() << "All " << pool_desc_.count
+                    << " events of the event pool are in use";
+      return;
+    }
+    pool = event_pools_[slot.pool];
+  }
+
+  desc.index = slot.index;
+  EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventCreate(pool, &desc, &event));
   EXPECT_NE(nullptr, event);
-  handle_to_index_map_[event] = desc.index;
-  pool_indexes_available_[desc.index] = false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (event == nullptr) {
+    slots_in_use_[slot.pool][slot.index] = false;
+    free_slots_.push_back(slot);
+    return;
+  }
+  handle_to_slot_[event] = slot;
 }
 
-// Use to bypass zeEventPool management of event indexes
+// Use to bypass zeEventPool management of event indexes, the index is one
+// of event_pool_
 void zeEventPool::create_event(ze_event_handle_t &event, ze_event_desc_t desc) {
   EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventCreate(event_pool_, &desc, &event));
-  handle_to_index_map_[event] = desc.index;
-  pool_indexes_available_[desc.index] = false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  handle_to_slot_[event] = {0, desc.index};
+  slots_in_use_[0][desc.index] = true;
 }
 
 void zeEventPool::create_events(std::vector<ze_event_handle_t> &events,
@@ -331,6 +475,7 @@ void zeEventPool::create_events(std::vector<ze_event_handle_t> &events,
                                 ze_event_scope_flags_t signal,
                                 ze_event_scope_flags_t wait) {
   events.clear();
+  events.reserve(event_count);
   for (size_t i = 0; i < event_count; i++) {
     ze_event_handle_t event;
     create_event(event, signal, wait);
@@ -339,13 +484,17 @@ void zeEventPool::create_events(std::vector<ze_event_handle_t> &events,
 }
 
 void zeEventPool::destroy_event(ze_event_handle_t event) {
-  std::map<ze_event_handle_t, uint32_t>::iterator it =
-      handle_to_index_map_.find(event);
-
-  EXPECT_NE(it, handle_to_index_map_.end());
-  pool_indexes_available_[(*it).second] = true;
-  handle_to_index_map_.erase(it);
+  // Destroyed before its slot is free for another thread to take
   EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventDestroy(event));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = handle_to_slot_.find(event);
+  EXPECT_NE(it, handle_to_slot_.end());
+  if (it != handle_to_slot_.end()) {
+    slots_in_use_[it->second.pool][it->second.index] = false;
+    free_slots_.push_back(it->second);
+    handle_to_slot_.erase(it);
+  }
 }
 
 void zeEventPool::destroy_events(std::vector<ze_event_handle_t> &events) {
@@ -13,8 +13,310 @@ namespace lzt = level_zero_tests;
 
 #include <level_zero/ze_api.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 namespace level_zero_tests {
 
+namespace {
+
+// With LZT_USM_ARENA set, the checked allocate_host_memory,
+// allocate_device_memory and allocate_shared_memory calls without flags or
+// extensions sub-allocate from large blocks kept per context, device and
+// memory type, instead of allocating from the driver on every call.  Chunks
+// are aligned as requested and to at least a cache line.  free_memory
+// returns a chunk to its block, a block is reused from its start once all
+// of its chunks are free, and blocks are freed with their context.  Larger
+// or more aligned requests than a block serves go to the driver.
+struct UsmArena {
+  static constexpr size_t block_size = 16 * 1024 * 1024;
+  static constexpr size_t max_chunk_size = block_size / 8;
+  static constexpr size_t block_alignment = 64 * 1024;
+  static constexpr size_t min_alignment = 64;
+
+  struct Block {
+    void *base;
+    size_t offset;
+    size_t chunks;
+  };
+  using Key =
+      std::tuple<ze_context_handle_t, ze_device_handle_t, ze_memory_type_t>;
+
+  std::mutex mutex;
+  bool enabled = getenv("LZT_USM_ARENA") != nullptr;
+  std::map<Key, std::vector<std::unique_ptr<Block>>> blocks;
+  std::unordered_map<const void *, Block *> chunks;
+};
+
+UsmArena &usm_arena() {
+  static UsmArena arena;
+  return arena;
+}
+
+// Set while allocating memory that must be a driver allocation of its own,
+// such as memory exported through an IPC handle
+thread_local bool usm_arena_bypassed = false;
+
+void *allocate_usm_block(ze_memory_type_t type, ze_device_handle_t device,
+                         ze_context_handle_t context) {
+  ze_device_mem_alloc_desc_t device_desc = {};
+  device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
+  ze_host_mem_alloc_desc_t host_desc = {};
+  host_desc.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
+
+  void *memory = nullptr;
+  ze_result_t result = ZE_RESULT_ERROR_UNINITIALIZED;
+  switch (type) {
+  case ZE_MEMORY_TYPE_HOST:
+    result = zeMemAllocHost(context, &host_desc, UsmArena::block_size,
+                            UsmArena::block_alignment, &memory);
+    break;
+  case ZE_MEMORY_TYPE_DEVICE:
+    result = zeMemAllocDevice(context, &device_desc, UsmArena::block_size,
+                              UsmArena::block_alignment, device, &memory);
+    break;
+  case ZE_MEMORY_TYPE_SHARED:
+    result = zeMemAllocShared(context, &device_desc, &host_desc,
+                              UsmArena::block_size, UsmArena::block_alignment,
+                              device, &memory);
+    break;
+  default:
+    break;
+  }
+  return (result == ZE_RESULT_SUCCESS) ? memory : nullptr;
+}
+
+// A chunk of an arena block, or null when the request is not served by the
+// arena and goes to the driver
+void *arena_allocate(ze_memory_type_t type, size_t size, size_t alignment,
+                     ze_device_handle_t device, ze_context_handle_t context) {
+  auto &arena = usm_arena();
+  if (!arena.enabled || usm_arena_bypassed || size == 0 ||
+      size > UsmArena::max_chunk_size ||
+      alignment > UsmArena::block_alignment ||
+      (alignment & (alignment - 1)) != 0) {
+    return nullptr;
+  }
+  if (alignment < UsmArena::min_alignment) {
+    alignment = UsmArena::min_alignment;
+  }
+
+  std::lock_guard<std::mutex> lock(arena.mutex);
+  auto &blocks = arena.blocks[UsmArena::Key(context, device, type)];
+  UsmArena::Block *block = nullptr;
+  size_t offset = 0;
+  for (auto &candidate : blocks) {
+    offset = (candidate->offset + alignment - 1) & ~(alignment - 1);
+    if (offset + size <= UsmArena::block_size) {
+      block = candidate.get();
+      break;
+    }
+  }
+  if (block == nullptr) {
+    void *base = allocate_usm_block(type, device, context);
+    if (base == nullptr) {
+      return nullptr;
+    }
+    blocks.emplace_back(new UsmArena::Block{base, 0, 0});
+    block = blocks.back().get();
+    offset = 0;
+  }
+
+  void *memory = static_cast<uint8_t *>(block->base) + offset;
+  block->offset = offset + size;
+  block->chunks++;
+  arena.chunks[memory] = block;
+  return memory;
+}
+
+// Whether ptr was a chunk of an arena block
+bool arena_free(const void *ptr) {
+  auto &arena = usm_arena();
+  if (!arena.enabled) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(arena.mutex);
+  auto chunk = arena.chunks.find(ptr);
+  if (chunk == arena.chunks.end()) {
+    return false;
+  }
+  auto block = chunk->second;
+  arena.chunks.erase(chunk);
+  if (--block->chunks == 0) {
+    block->offset = 0;
+  }
+  return true;
+}
+
+// Host threads for size bytes, one per 16 MB up to the CPUs
+size_t host_threads(size_t size) {
+  const size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+  return std::max<size_t>(1, std::min<size_t>(cpus, size >> 24));
+}
+
+// Compares and fills work in blocks of this many bytes, a multiple of the
+// 256 byte period of the data pattern
+constexpr size_t data_block_size = 4096;
+
+// Splits [0, size) into one range per host thread, at multiples of the
+// block size, and returns the mismatches found by check in all of them
+DataMismatch
+parallel_ranges(size_t size,
+                const std::function<DataMismatch(size_t, size_t)> &check) {
+  const size_t threads = host_threads(size);
+  const size_t blocks = (size + data_block_size - 1) / data_block_size;
+  const size_t chunk = (blocks + threads - 1) / threads * data_block_size;
+  std::vector<DataMismatch> ranges(threads);
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads && t * chunk < size; t++) {
+    workers.emplace_back([&, t]() {
+      ranges[t] = check(t * chunk, std::min(size, (t + 1) * chunk));
+    });
+  }
+  ranges[0] = check(0, std::min(size, chunk));
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  DataMismatch mismatch;
+  for (auto &range : ranges) {
+    if (mismatch.count == 0 && range.count != 0) {
+      mismatch = range;
+    } else {
+      mismatch.count += range.count;
+    }
+  }
+  return mismatch;
+}
+
+// Compares actual with expected over [begin, end), where expected(offset)
+// points to the expected bytes of the block at offset
+DataMismatch
+compare_range(const uint8_t *actual, size_t begin, size_t end,
+              const std::function<const uint8_t *(size_t)> &expected) {
+  DataMismatch mismatch;
+  for (size_t offset = begin; offset < end; offset += data_block_size) {
+    const size_t length = std::min(data_block_size, end - offset);
+    const uint8_t *block = expected(offset);
+    if (memcmp(actual + offset, block, length) == 0) {
+      continue;
+    }
+    for (size_t i = 0; i < length; i++) {
+      if (actual[offset + i] != block[i]) {
+        if (mismatch.count++ == 0) {
+          mismatch.first = offset + i;
+          mismatch.expected = block[i];
+          mismatch.actual = actual[offset + i];
+        }
+      }
+    }
+  }
+  return mismatch;
+}
+
+// One block of the data pattern, in which byte i is data_pattern * (i + 1)
+std::vector<uint8_t> data_pattern_block(int8_t data_pattern) {
+  std::vector<uint8_t> block(data_block_size);
+  for (size_t i = 0; i < block.size(); i++) {
+    block[i] =
+        static_cast<uint8_t>(static_cast<uint8_t>(data_pattern) * (i + 1));
+  }
+  return block;
+}
+
+// SPIR-V of kernels/verify_data_pattern.cl
+const uint32_t verify_data_pattern_spirv[] = {
+    0x07230203, 0x00010000, 0x0006000e, 0x0000002e, 0x00000000, 0x00020011,
+    0x00000004, 0x00020011, 0x00000005, 0x00020011, 0x00000006, 0x00020011,
+    0x0000000b, 0x00020011, 0x00000027, 0x00020011, 0x0000000c, 0x0005000b,
+    0x00000001, 0x6e65704f, 0x732e4c43, 0x00006474, 0x0003000e, 0x00000002,
+    0x00000002, 0x000a000f, 0x00000006, 0x00000002, 0x69726576, 0x645f7966,
+    0x5f617461, 0x74746170, 0x006e7265, 0x00000003, 0x00000004, 0x00030003,
+    0x00000003, 0x00030d40, 0x000b0005, 0x00000003, 0x70735f5f, 0x5f767269,
+    0x6c697542, 0x476e4974, 0x61626f6c, 0x766e496c, 0x7461636f, 0x496e6f69,
+    0x00000064, 0x00090005, 0x00000004, 0x70735f5f, 0x5f767269, 0x6c697542,
+    0x476e4974, 0x61626f6c, 0x7a69536c, 0x00000065, 0x00040005, 0x00000005,
+    0x66667562, 0x00007265, 0x00040005, 0x00000006, 0x657a6973, 0x00000000,
+    0x00040005, 0x00000007, 0x74746170, 0x006e7265, 0x00040005, 0x00000008,
+    0x75736572, 0x0000746c, 0x00030047, 0x00000009, 0x00000016, 0x00020049,
+    0x00000009, 0x00040047, 0x00000003, 0x0000000b, 0x0000001c, 0x00040047,
+    0x00000004, 0x0000000b, 0x0000001f, 0x000d0047, 0x00000003, 0x00000029,
+    0x70735f5f, 0x5f767269, 0x6c697542, 0x476e4974, 0x61626f6c, 0x766e496c,
+    0x7461636f, 0x496e6f69, 0x00000064, 0x00000001, 0x000b0047, 0x00000004,
+    0x00000029, 0x70735f5f, 0x5f767269, 0x6c697542, 0x476e4974, 0x61626f6c,
+    0x7a69536c, 0x00000065, 0x00000001, 0x0004004a, 0x00000009, 0x00000003,
+    0x00000004, 0x00040015, 0x0000000a, 0x00000040, 0x00000000, 0x00040015,
+    0x0000000b, 0x00000020, 0x00000000, 0x00040015, 0x0000000c, 0x00000008,
+    0x00000000, 0x0005002b, 0x0000000a, 0x0000000d, 0x00000001, 0x00000000,
+    0x0004002b, 0x0000000b, 0x0000000e, 0x00000001, 0x0004002b, 0x0000000b,
+    0x0000000f, 0x00000210, 0x00040017, 0x00000010, 0x0000000a, 0x00000003,
+    0x00040020, 0x00000011, 0x00000001, 0x00000010, 0x00020013, 0x00000012,
+    0x00040020, 0x00000013, 0x00000005, 0x0000000c, 0x00040020, 0x00000014,
+    0x00000005, 0x0000000a, 0x00070021, 0x00000015, 0x00000012, 0x00000013,
+    0x0000000a, 0x0000000c, 0x00000014, 0x00020014, 0x00000016, 0x0004003b,
+    0x00000011, 0x00000003, 0x00000001, 0x0004003b, 0x00000011, 0x00000004,
+    0x00000001, 0x00050036, 0x00000012, 0x00000002, 0x00000000, 0x00000015,
+    0x00030037, 0x00000013, 0x00000005, 0x00030037, 0x0000000a, 0x00000006,
+    0x00030037, 0x0000000c, 0x00000007, 0x00030037, 0x00000014, 0x00000008,
+    0x000200f8, 0x00000017, 0x0004003d, 0x00000010, 0x00000018, 0x00000003,
+    0x00050051, 0x0000000a, 0x00000019, 0x00000018, 0x00000000, 0x0004003d,
+    0x00000010, 0x0000001a, 0x00000004, 0x00050051, 0x0000000a, 0x0000001b,
+    0x0000001a, 0x00000000, 0x00040071, 0x0000000a, 0x0000001c, 0x00000007,
+    0x00050046, 0x00000014, 0x0000001d, 0x00000008, 0x0000000d, 0x000200f9,
+    0x0000001e, 0x000200f8, 0x0000001e, 0x000700f5, 0x0000000a, 0x0000001f,
+    0x00000019, 0x00000017, 0x00000020, 0x00000021, 0x000500b0, 0x00000016,
+    0x00000022, 0x0000001f, 0x00000006, 0x000400fa, 0x00000022, 0x00000023,
+    0x00000024, 0x000200f8, 0x00000023, 0x00050046, 0x00000013, 0x00000025,
+    0x00000005, 0x0000001f, 0x0006003d, 0x0000000c, 0x00000026, 0x00000025,
+    0x00000002, 0x00000001, 0x00050080, 0x0000000a, 0x00000027, 0x0000001f,
+    0x0000000d, 0x00050084, 0x0000000a, 0x00000028, 0x0000001c, 0x00000027,
+    0x00040071, 0x0000000c, 0x00000029, 0x00000028, 0x000500ab, 0x00000016,
+    0x0000002a, 0x00000026, 0x00000029, 0x000400fa, 0x0000002a, 0x0000002b,
+    0x00000021, 0x000200f8, 0x0000002b, 0x000600e8, 0x0000000a, 0x0000002c,
+    0x00000008, 0x0000000e, 0x0000000f, 0x000700ed, 0x0000000a, 0x0000002d,
+    0x0000001d, 0x0000000e, 0x0000000f, 0x0000001f, 0x000200f9, 0x00000021,
+    0x000200f8, 0x00000021, 0x00050080, 0x0000000a, 0x00000020, 0x0000001f,
+    0x0000001b, 0x000200f9, 0x0000001e, 0x000200f8, 0x00000024, 0x000100fd,
+    0x00010038,
+};
+
+} // namespace
+
+void release_usm_arena(ze_context_handle_t context) {
+  auto &arena = usm_arena();
+  if (!arena.enabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(arena.mutex);
+  auto entry = arena.blocks.begin();
+  while (entry != arena.blocks.end()) {
+    if (std::get<0>(entry->first) != context) {
+      ++entry;
+      continue;
+    }
+    for (auto &block : entry->second) {
+      // Chunks not freed before the context go with their block
+      auto chunk = arena.chunks.begin();
+      while (chunk != arena.chunks.end()) {
+        chunk = (chunk->second == block.get()) ? arena.chunks.erase(chunk)
+                                                : std::next(chunk);
+      }
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeMemFree(context, block->base));
+    }
+    entry = arena.blocks.erase(entry);
+  }
+}
+
 void *allocate_host_memory(const size_t size) {
   return allocate_host_memory(size, 1);
 }
@@ -43,6 +345,11 @@ void *allocate_host_memory_no_check(const size_t size, const size_t alignment,
 
 void *allocate_host_memory(const size_t size, const size_t alignment,
                            ze_context_handle_t context) {
+  auto chunk =
+      arena_allocate(ZE_MEMORY_TYPE_HOST, size, alignment, nullptr, context);
+  if (chunk != nullptr) {
+    return chunk;
+  }
 
   ze_host_mem_alloc_desc_t host_desc = {};
   host_desc.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
@@ -63,6 +370,13 @@ void *allocate_host_memory(const size_t size, const size_t alignment,
 void *allocate_host_memory(const size_t size, const size_t alignment,
                            const ze_host_mem_alloc_flags_t flags, void *pNext,
                            ze_context_handle_t context) {
+  if (flags == 0 && pNext == nullptr) {
+    auto chunk =
+        arena_allocate(ZE_MEMORY_TYPE_HOST, size, alignment, nullptr, context);
+    if (chunk != nullptr) {
+      return chunk;
+    }
+  }
 
   ze_host_mem_alloc_desc_t host_desc = {};
   host_desc.stype = ZE_STRUCTURE_TYPE_HOST_MEM_ALLOC_DESC;
@@ -145,6 +459,14 @@ void *allocate_device_memory(const size_t size, const size_t alignment,
                              void *pNext, const uint32_t ordinal,
                              ze_device_handle_t device_handle,
                              ze_context_handle_t context) {
+  if (flags == 0 && pNext == nullptr && ordinal == 0) {
+    auto chunk = arena_allocate(ZE_MEMORY_TYPE_DEVICE, size, alignment,
+                                device_handle, context);
+    if (chunk != nullptr) {
+      return chunk;
+    }
+  }
+
   void *memory = nullptr;
   ze_device_mem_alloc_desc_t device_desc = {};
   device_desc.stype = ZE_STRUCTURE_TYPE_DEVICE_MEM_ALLOC_DESC;
@@ -242,6 +564,14 @@ void *allocate_shared_memory(const size_t size, const size_t alignment,
                              const ze_host_mem_alloc_flags_t host_flags,
                              void *host_pNext, ze_device_handle_t device,
                              ze_context_handle_t context) {
+  if (device_flags == 0 && device_pNext == nullptr && host_flags == 0 &&
+      host_pNext == nullptr) {
+    auto chunk = arena_allocate(ZE_MEMORY_TYPE_SHARED, size, alignment, device,
+                                context);
+    if (chunk != nullptr) {
+      return chunk;
+    }
+  }
 
   uint32_t ordinal = 0;
 
@@ -294,6 +624,9 @@ void free_memory(const void *ptr) {
 }
 
 void free_memory(ze_context_handle_t context, const void *ptr) {
+  if (arena_free(ptr)) {
+    return;
+  }
   auto context_initial = context;
   EXPECT_EQ(ZE_RESULT_SUCCESS, zeMemFree(context, (void *)ptr));
   EXPECT_EQ(context, context_initial);
@@ -309,7 +642,10 @@ void allocate_mem_and_get_ipc_handle(ze_context_handle_t context,
                                      ze_ipc_mem_handle_t *mem_handle,
                                      void **memory, ze_memory_type_t mem_type,
                                      size_t size) {
+  // An IPC handle exports a whole driver allocation
+  usm_arena_bypassed = true;
   allocate_mem(memory, mem_type, size, context);
+  usm_arena_bypassed = false;
   get_ipc_handle(context, mem_handle, *memory);
 }
 
@@ -334,21 +670,113 @@ void close_ipc_handle(ze_context_handle_t context, void **memory) {
 }
 
 void write_data_pattern(void *buff, size_t size, int8_t data_pattern) {
-  int8_t *pbuff = static_cast<int8_t *>(buff);
-  int8_t dp = data_pattern;
-  for (size_t i = 0; i < size; i++) {
-    pbuff[i] = dp;
-    dp = (dp + data_pattern) & 0xff;
-  }
+  uint8_t *pbuff = static_cast<uint8_t *>(buff);
+  const auto block = data_pattern_block(data_pattern);
+  parallel_ranges(size, [&](size_t begin, size_t end) {
+    for (size_t offset = begin; offset < end; offset += data_block_size) {
+      memcpy(pbuff + offset, block.data(),
+             std::min(data_block_size, end - offset));
+    }
+    return DataMismatch();
+  });
 }
 
 void validate_data_pattern(void *buff, size_t size, int8_t data_pattern) {
-  int8_t *pbuff = static_cast<int8_t *>(buff);
-  int8_t dp = data_pattern;
-  for (size_t i = 0; i < size; i++) {
-    ASSERT_EQ(pbuff[i], dp);
-    dp = (dp + data_pattern) & 0xff;
+  const auto mismatch = check_data_pattern(buff, size, data_pattern);
+  ASSERT_EQ(0u, mismatch.count)
+      << "first mismatch at offset " << mismatch.first << ": expected "
+      << static_cast<int>(mismatch.expected) << ", actual "
+      << static_cast<int>(mismatch.actual);
+}
+
+DataMismatch check_data_pattern(const void *buff, size_t size,
+                                int8_t data_pattern) {
+  const uint8_t *pbuff = static_cast<const uint8_t *>(buff);
+  const auto block = data_pattern_block(data_pattern);
+  return parallel_ranges(size, [&](size_t begin, size_t end) {
+    return compare_range(pbuff, begin, end,
+                         [&](size_t) { return block.data(); });
+  });
+}
+
+DataMismatch compare_buffers(const void *actual, const void *expected,
+                             size_t size) {
+  const uint8_t *pactual = static_cast<const uint8_t *>(actual);
+  const uint8_t *pexpected = static_cast<const uint8_t *>(expected);
+  return parallel_ranges(size, [&](size_t begin, size_t end) {
+    return compare_range(pactual, begin, end,
+                         [&](size_t offset) { return pexpected + offset; });
+  });
+}
+
+DataMismatch check_data_pattern_on_device(ze_context_handle_t context,
+                                          ze_device_handle_t device,
+                                          const void *buff, size_t size,
+                                          int8_t data_pattern) {
+  DataMismatch mismatch;
+  ze_module_desc_t module_desc = {};
+  module_desc.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
+  module_desc.format = ZE_MODULE_FORMAT_IL_SPIRV;
+  module_desc.inputSize = sizeof(verify_data_pattern_spirv);
+  module_desc.pInputModule =
+      reinterpret_cast<const uint8_t *>(verify_data_pattern_spirv);
+  ze_module_handle_t module = nullptr;
+  EXPECT_EQ(ZE_RESULT_SUCCESS,
+            zeModuleCreate(context, device, &module_desc, &module, nullptr));
+  if (module == nullptr) {
+    return mismatch;
+  }
+  auto kernel = create_function(module, "verify_data_pattern");
+
+  // Count, first offset and the byte at the first offset
+  auto result = static_cast<uint64_t *>(allocate_shared_memory(
+      3 * sizeof(uint64_t), sizeof(uint64_t), 0, 0, device, context));
+  result[0] = 0;
+  result[1] = UINT64_MAX;
+  result[2] = 0;
+
+  // Work items stride over the buffer, so a bounded grid covers any size
+  const uint32_t items = static_cast<uint32_t>(
+      std::min<size_t>(std::max<size_t>(size, 1), 1u << 20));
+  uint32_t group_size_x = 1, group_size_y = 1, group_size_z = 1;
+  suggest_group_size(kernel, items, 1, 1, group_size_x, group_size_y,
+                     group_size_z);
+  set_group_size(kernel, group_size_x, 1, 1);
+  const uint64_t size_arg = size;
+  const uint8_t pattern_arg = static_cast<uint8_t>(data_pattern);
+  set_argument_value(kernel, 0, sizeof(buff), &buff);
+  set_argument_value(kernel, 1, sizeof(size_arg), &size_arg);
+  set_argument_value(kernel, 2, sizeof(pattern_arg), &pattern_arg);
+  set_argument_value(kernel, 3, sizeof(result), &result);
+  ze_group_count_t group_count = {
+      (items + group_size_x - 1) / group_size_x, 1, 1};
+
+  auto bundle = create_command_bundle(context, device, 0, 0, false);
+  append_launch_function(bundle.list, kernel, &group_count, nullptr, 0,
+                         nullptr);
+  close_command_list(bundle.list);
+  execute_and_sync_command_bundle(bundle, UINT64_MAX);
+
+  mismatch.count = static_cast<size_t>(result[0]);
+  if (mismatch.count != 0) {
+    // The buffer may not be accessible from the host
+    mismatch.first = static_cast<size_t>(result[1]);
+    reset_command_list(bundle.list);
+    append_memory_copy(bundle.list, &result[2],
+                       static_cast<const uint8_t *>(buff) + mismatch.first,
+                       1);
+    close_command_list(bundle.list);
+    execute_and_sync_command_bundle(bundle, UINT64_MAX);
+    mismatch.expected = static_cast<uint8_t>(
+        static_cast<uint8_t>(data_pattern) * (mismatch.first + 1));
+    mismatch.actual = static_cast<uint8_t>(result[2]);
   }
+
+  destroy_command_bundle(bundle);
+  free_memory(context, result);
+  destroy_function(kernel);
+  destroy_module(module);
+  return mismatch;
 }
 void get_mem_alloc_properties(
     ze_context_handle_t context, const void *memory,
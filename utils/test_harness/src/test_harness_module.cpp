@@ -7,16 +7,150 @@
  */
 
 #include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
 #include "utils/utils.hpp"
 #include "utils/utils.hpp"
 #include "gtest/gtest.h"
 #include <level_zero/ze_api.h>
 #include <thread>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <string>
 
 namespace level_zero_tests {
 
+namespace {
+
+// With LZT_MODULE_CACHE or LZT_MODULE_CACHE_DIR set, create_module keeps the
+// native binary of every SPIR-V module it builds, keyed by the SPIR-V, the
+// build flags, the device type and the driver version, and creates later
+// modules with the same key from it instead of building them again.  With
+// LZT_MODULE_CACHE_DIR the binaries are also stored in that directory, so
+// they are shared across test binaries and runs.  Every call still returns
+// a module of its own.
+struct NativeModuleCache {
+  std::mutex mutex;
+  bool enabled = (getenv("LZT_MODULE_CACHE") != nullptr ||
+                  getenv("LZT_MODULE_CACHE_DIR") != nullptr);
+  std::string directory = getenv("LZT_MODULE_CACHE_DIR")
+                              ? getenv("LZT_MODULE_CACHE_DIR")
+                              : "";
+  std::map<std::string, std::vector<uint8_t>> binaries;
+};
+
+NativeModuleCache &native_module_cache() {
+  static NativeModuleCache cache;
+  return cache;
+}
+
+// The driver enumerating device, or the root device of a sub-device
+ze_driver_handle_t driver_of_device(ze_device_handle_t device) {
+  ze_device_handle_t root_device = nullptr;
+  if (zeDeviceGetRootDevice(device, &root_device) == ZE_RESULT_SUCCESS &&
+      root_device != nullptr) {
+    device = root_device;
+  }
+  for (auto driver : lzt::get_all_driver_handles()) {
+    for (auto driver_device : lzt::get_devices(driver)) {
+      if (driver_device == device) {
+        return driver;
+      }
+    }
+  }
+  return lzt::get_default_driver();
+}
+
+std::string native_module_key(ze_device_handle_t device,
+                              const std::string &filename,
+                              const BinaryFile &spirv,
+                              const char *build_flags) {
+  // FNV-1a of the SPIR-V and the flags, so that a rebuilt module is not
+  // matched
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto byte : spirv) {
+    hash = (hash ^ byte) * 1099511628211ULL;
+  }
+  for (const char *flag = build_flags; flag && *flag; flag++) {
+    hash = (hash ^ static_cast<uint8_t>(*flag)) * 1099511628211ULL;
+  }
+
+  auto device_properties = lzt::get_device_properties(device);
+  std::string module_name = filename;
+  const size_t separator = module_name.find_last_of("/\\");
+  if (separator != std::string::npos) {
+    module_name = module_name.substr(separator + 1);
+  }
+  char key[96];
+  snprintf(key, sizeof(key), "-%016llx-%04x-%04x-%08x.bin",
+           static_cast<unsigned long long>(hash), device_properties.vendorId,
+           device_properties.deviceId,
+           lzt::get_driver_version(driver_of_device(device)));
+  return module_name + key;
+}
+
+bool find_native_module(const std::string &key, std::vector<uint8_t> &binary) {
+  auto &cache = native_module_cache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.binaries.find(key);
+    if (it != cache.binaries.end()) {
+      binary = it->second;
+      return true;
+    }
+  }
+  if (cache.directory.empty()) {
+    return false;
+  }
+  std::ifstream stream(cache.directory + "/" + key,
+                       std::ios::in | std::ios::binary);
+  if (!stream.good()) {
+    return false;
+  }
+  binary.assign(std::istreambuf_iterator<char>(stream),
+                std::istreambuf_iterator<char>());
+  return !binary.empty();
+}
+
+void store_native_module(const std::string &key, ze_module_handle_t module) {
+  size_t size = 0;
+  if (zeModuleGetNativeBinary(module, &size, nullptr) != ZE_RESULT_SUCCESS ||
+      size == 0) {
+    return;
+  }
+  std::vector<uint8_t> binary(size);
+  if (zeModuleGetNativeBinary(module, &size, binary.data()) !=
+      ZE_RESULT_SUCCESS) {
+    return;
+  }
+
+  auto &cache = native_module_cache();
+  if (!cache.directory.empty()) {
+    // Written to a temporary file first, so that concurrent runs never read
+    // a partial entry
+    const std::string path = cache.directory + "/" + key;
+    const std::string temporary_path =
+        path + "." + std::to_string(reinterpret_cast<uintptr_t>(module));
+    std::ofstream stream(temporary_path, std::ios::out | std::ios::binary);
+    stream.write(reinterpret_cast<const char *>(binary.data()), binary.size());
+    stream.close();
+    if (!stream.good() ||
+        std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+      LOG_WARNING << "Cannot write module cache " << path;
+      std::remove(temporary_path.c_str());
+    }
+  }
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.binaries[key] = std::move(binary);
+}
+
+} // namespace
+
 #ifdef ZE_MODULE_PROGRAM_EXP_NAME
 ze_module_handle_t
 create_program_module(ze_context_handle_t context, ze_device_handle_t device,
@@ -29,23 +163,24 @@ create_program_module(ze_context_handle_t context, ze_device_handle_t device,
   std::vector<size_t> input_sizes;
   std::vector<char *> build_flags;
   std::vector<ze_module_constants_t *> constants;
-  std::vector<uint8_t *> module_data;
+  std::vector<const uint8_t *> module_data;
+  std::vector<BinaryFile> binary_files;
 
   for (auto module : modules_in) {
-    const std::vector<uint8_t> binary_file =
-        level_zero_tests::load_binary_file(module.filename);
-
-    auto binary_data = new uint8_t[binary_file.size()];
-    memcpy(binary_data, binary_file.data(), binary_file.size());
+    binary_files.emplace_back(module.filename);
+    const BinaryFile &binary_file = binary_files.back();
+    if (!binary_file.is_open()) {
+      LOG_ERROR << "Failed to load binary file: " << module.filename;
+    }
 
-    module_data.push_back(binary_data);
+    module_data.push_back(binary_file.data());
     input_sizes.push_back(size_t(binary_file.size()));
     build_flags.push_back(module.pBuildFlags);
     constants.push_back(module.pConstants);
   }
 
   module_program_desc.inputSizes = input_sizes.data();
-  module_program_desc.pInputModules = (const uint8_t **)module_data.data();
+  module_program_desc.pInputModules = module_data.data();
   module_program_desc.pBuildFlags = (const char **)build_flags.data();
   module_program_desc.pConstants =
       (const ze_module_constants_t **)constants.data();
@@ -65,9 +200,6 @@ create_program_module(ze_context_handle_t context, ze_device_handle_t device,
   EXPECT_EQ(context, context_initial);
   EXPECT_EQ(device, device_initial);
 
-  for (auto data : module_data)
-    delete[] data;
-
   return module;
 }
 
@@ -113,12 +245,33 @@ ze_module_handle_t create_module(ze_context_handle_t context,
   module_description.stype = ZE_STRUCTURE_TYPE_MODULE_DESC;
   ze_module_handle_t module;
   ze_module_constants_t module_constants = {};
-  const std::vector<uint8_t> binary_file =
-      level_zero_tests::load_binary_file(filename);
+  const BinaryFile binary_file(filename);
+  if (!binary_file.is_open()) {
+    LOG_ERROR << "Failed to load binary file: " << filename;
+  }
 
   EXPECT_TRUE((format == ZE_MODULE_FORMAT_IL_SPIRV) ||
               (format == ZE_MODULE_FORMAT_NATIVE));
 
+  // Modules built for their build log always build from the SPIR-V
+  std::string cache_key;
+  if (native_module_cache().enabled && format == ZE_MODULE_FORMAT_IL_SPIRV &&
+      p_build_log == nullptr && !binary_file.empty()) {
+    cache_key = native_module_key(device, filename, binary_file, build_flags);
+    std::vector<uint8_t> native_binary;
+    if (find_native_module(cache_key, native_binary)) {
+      module_description.format = ZE_MODULE_FORMAT_NATIVE;
+      module_description.inputSize = native_binary.size();
+      module_description.pInputModule = native_binary.data();
+      // A stale entry is built again from the SPIR-V
+      if (zeModuleCreate(context, device, &module_description, &module,
+                         nullptr) == ZE_RESULT_SUCCESS) {
+        *build_result = ZE_RESULT_SUCCESS;
+        return module;
+      }
+    }
+  }
+
   module_description.pNext = nullptr;
   module_description.format = format;
   module_description.inputSize = static_cast<uint32_t>(binary_file.size());
@@ -134,6 +287,9 @@ ze_module_handle_t create_module(ze_context_handle_t context,
   EXPECT_EQ(context, context_initial);
   EXPECT_EQ(device, device_initial);
 
+  if (!cache_key.empty() && *build_result == ZE_RESULT_SUCCESS) {
+    store_native_module(cache_key, module);
+  }
   return module;
 }
 
@@ -0,0 +1,305 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "test_harness/test_harness.hpp"
+#include "test_harness/test_harness_shard.hpp"
+#include "logging/logging.hpp"
+#include "utils/utils.hpp"
+#include <level_zero/ze_api.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+
+namespace lzt = level_zero_tests;
+
+namespace level_zero_tests {
+
+namespace {
+
+#ifdef GTEST_FLAG_GET
+std::string gtest_output_flag() { return GTEST_FLAG_GET(output); }
+bool gtest_list_tests_flag() { return GTEST_FLAG_GET(list_tests); }
+#else
+std::string gtest_output_flag() { return ::testing::GTEST_FLAG(output); }
+bool gtest_list_tests_flag() { return ::testing::GTEST_FLAG(list_tests); }
+#endif
+
+std::string xml_attribute(const std::string &tag, const char *name) {
+  const std::string key = std::string(" ") + name + "=\"";
+  const size_t start = tag.find(key);
+  if (start == std::string::npos) {
+    return "";
+  }
+  const size_t value = start + key.size();
+  return tag.substr(value, tag.find('"', value) - value);
+}
+
+#ifdef __linux__
+
+struct ShardTarget {
+  uint32_t device_index;
+  // -1 for the root device
+  int sub_device_index;
+};
+
+std::vector<ShardTarget> shard_targets(bool sub_devices) {
+  std::vector<ShardTarget> targets;
+  auto devices = lzt::get_ze_devices(lzt::get_default_driver());
+  for (uint32_t i = 0; i < devices.size(); i++) {
+    const uint32_t sub_device_count =
+        sub_devices ? lzt::get_ze_sub_device_count(devices[i]) : 0;
+    if (sub_device_count == 0) {
+      targets.push_back({i, -1});
+    }
+    for (uint32_t j = 0; j < sub_device_count; j++) {
+      targets.push_back({i, static_cast<int>(j)});
+    }
+  }
+  return targets;
+}
+
+std::string target_name(const ShardTarget &target) {
+  return std::to_string(target.device_index) +
+         (target.sub_device_index < 0
+              ? ""
+              : "." + std::to_string(target.sub_device_index));
+}
+
+std::string binary_name(const std::string &path) {
+  const size_t separator = path.find_last_of("/\\");
+  return (separator == std::string::npos) ? path : path.substr(separator + 1);
+}
+
+// XML report file requested with --gtest_output or GTEST_OUTPUT, if any
+std::string xml_output_path(const std::string &binary) {
+  const std::string output = gtest_output_flag();
+  if (output.compare(0, 3, "xml") != 0) {
+    return "";
+  }
+  std::string path = (output.size() > 4) ? output.substr(4) : "";
+  if (path.empty()) {
+    return "test_detail.xml";
+  }
+  if (path.back() == '/' || path.back() == '\\') {
+    path += binary + ".xml";
+  }
+  return path;
+}
+
+// The environment of the parent, with the sharding and default device
+// variables of the worker in place of the parent's
+std::vector<std::string> worker_environment(size_t shard, size_t shards,
+                                            const ShardTarget &target,
+                                            const std::string &xml) {
+  static const char *replaced[] = {
+      "GTEST_TOTAL_SHARDS",        "GTEST_SHARD_INDEX",
+      "GTEST_OUTPUT",              "LZT_SHARD_DEVICES",
+      "LZT_DEFAULT_DEVICE_IDX",    "LZT_DEFAULT_DEVICE_NAME",
+      "LZT_DEFAULT_SUBDEVICE_IDX",
+  };
+  std::vector<std::string> environment;
+  for (char **entry = environ; *entry != nullptr; entry++) {
+    const std::string variable = *entry;
+    const std::string name = variable.substr(0, variable.find('='));
+    if (std::find_if(std::begin(replaced), std::end(replaced),
+                     [&](const char *r) { return name == r; }) ==
+        std::end(replaced)) {
+      environment.push_back(variable);
+    }
+  }
+  environment.push_back("GTEST_TOTAL_SHARDS=" + std::to_string(shards));
+  environment.push_back("GTEST_SHARD_INDEX=" + std::to_string(shard));
+  environment.push_back("LZT_DEFAULT_DEVICE_IDX=" +
+                        std::to_string(target.device_index));
+  if (target.sub_device_index >= 0) {
+    environment.push_back("LZT_DEFAULT_SUBDEVICE_IDX=" +
+                          std::to_string(target.sub_device_index));
+  }
+  if (!xml.empty()) {
+    environment.push_back("GTEST_OUTPUT=xml:" + xml);
+  }
+  return environment;
+}
+
+std::vector<char *> c_strings(std::vector<std::string> &strings) {
+  std::vector<char *> pointers;
+  for (auto &s : strings) {
+    pointers.push_back(&s[0]);
+  }
+  pointers.push_back(nullptr);
+  return pointers;
+}
+
+// Starts the binary again with the output of the worker going to log,
+// preparing everything before fork so that the child only calls
+// async-signal-safe functions before exec
+pid_t start_worker(std::vector<std::string> args,
+                   std::vector<std::string> environment,
+                   const std::string &log) {
+  auto argv = c_strings(args);
+  auto envp = c_strings(environment);
+  const pid_t pid = fork();
+  if (pid == 0) {
+    const int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+    execve("/proc/self/exe", argv.data(), envp.data());
+    _exit(127);
+  }
+  return pid;
+}
+
+int run_sharded(bool sub_devices) {
+  const auto targets = shard_targets(sub_devices);
+  // Command line flags take precedence over the environment, so the
+  // workers get their XML output through GTEST_OUTPUT only
+  std::vector<std::string> args;
+  for (auto &arg : ::testing::internal::GetArgvs()) {
+    if (arg.compare(0, 15, "--gtest_output=") != 0) {
+      args.push_back(arg);
+    }
+  }
+  const std::string binary = binary_name(args.empty() ? "" : args[0]);
+  const std::string xml = xml_output_path(binary);
+
+  std::cout << "Running " << binary << " as " << targets.size()
+            << " shards, one per " << (sub_devices ? "subdevice" : "device")
+            << std::endl;
+  std::vector<pid_t> workers;
+  std::vector<std::string> logs, reports;
+  for (size_t i = 0; i < targets.size(); i++) {
+    const std::string suffix = ".shard" + std::to_string(i);
+    logs.push_back(binary + suffix + ".log");
+    reports.push_back(xml.empty() ? "" : xml + suffix);
+    workers.push_back(start_worker(
+        args, worker_environment(i, targets.size(), targets[i], reports[i]),
+        logs[i]));
+    if (workers.back() < 0) {
+      LOG_ERROR << "Cannot start the worker of shard " << i;
+    }
+  }
+
+  int failed = 0;
+  for (size_t i = 0; i < targets.size(); i++) {
+    int status = 1;
+    if (workers[i] < 0 || waitpid(workers[i], &status, 0) < 0) {
+      status = 1;
+    }
+    const bool passed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    failed += passed ? 0 : 1;
+
+    std::cout << "[==========] Shard " << i << " on device "
+              << target_name(targets[i]) << ": "
+              << (passed ? "PASSED" : "FAILED") << std::endl;
+    std::ifstream log(logs[i]);
+    if (log.peek() != std::ifstream::traits_type::eof()) {
+      std::cout << log.rdbuf() << std::flush;
+    }
+    log.close();
+    remove(logs[i].c_str());
+  }
+
+  bool merged = true;
+  if (!xml.empty()) {
+    merged = merge_xml_reports(reports, xml);
+    for (auto &report : reports) {
+      remove(report.c_str());
+    }
+  }
+  std::cout << "[==========] " << targets.size() - failed << " of "
+            << targets.size() << " shards passed" << std::endl;
+  return (failed || !merged) ? 1 : 0;
+}
+
+#endif
+
+} // namespace
+
+bool merge_xml_reports(const std::vector<std::string> &reports,
+                       const std::string &output) {
+  static const char *counts[] = {"tests", "failures", "disabled", "errors"};
+  uint64_t totals[4] = {};
+  double wall_time = 0;
+  std::string timestamp, suites;
+  for (auto &report : reports) {
+    std::ifstream file(report);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const std::string xml = contents.str();
+
+    const size_t root = xml.find("<testsuites");
+    const size_t root_end =
+        (root == std::string::npos) ? root : xml.find('>', root);
+    const size_t close = xml.rfind("</testsuites>");
+    if (root_end == std::string::npos || close == std::string::npos ||
+        close < root_end) {
+      LOG_ERROR << report << " is not a gtest XML report";
+      return false;
+    }
+    const std::string tag = xml.substr(root, root_end - root);
+    for (int i = 0; i < 4; i++) {
+      totals[i] +=
+          strtoull(xml_attribute(tag, counts[i]).c_str(), nullptr, 10);
+    }
+    // The shards run at the same time
+    wall_time = std::max(wall_time, atof(xml_attribute(tag, "time").c_str()));
+    if (timestamp.empty()) {
+      timestamp = xml_attribute(tag, "timestamp");
+    }
+    suites += xml.substr(root_end + 1, close - root_end - 1);
+  }
+
+  std::ofstream file(output);
+  file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites";
+  for (int i = 0; i < 4; i++) {
+    file << " " << counts[i] << "=\"" << totals[i] << "\"";
+  }
+  if (!timestamp.empty()) {
+    file << " timestamp=\"" << timestamp << "\"";
+  }
+  file << " time=\"" << wall_time << "\" name=\"AllTests\">" << suites
+       << "</testsuites>\n";
+  if (!file.good()) {
+    LOG_ERROR << "Cannot write " << output;
+    return false;
+  }
+  return true;
+}
+
+int run_all_tests() {
+  const char *mode = getenv("LZT_SHARD_DEVICES");
+  // A worker, or sharding set up by the caller
+  if (mode == nullptr || getenv("GTEST_TOTAL_SHARDS") != nullptr ||
+      gtest_list_tests_flag()) {
+    return RUN_ALL_TESTS();
+  }
+#ifdef __linux__
+  return run_sharded(strcmp(mode, "subdevices") == 0);
+#else
+  LOG_WARNING << "LZT_SHARD_DEVICES is only supported on Linux, running "
+                 "unsharded";
+  return RUN_ALL_TESTS();
+#endif
+}
+
+}; // namespace level_zero_tests
@@ -0,0 +1,32 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "test_harness/test_harness.hpp"
+#include "test_harness/test_harness_statistics.hpp"
+
+#include <algorithm>
+
+namespace level_zero_tests {
+
+double percentile(std::vector<double> values, double percent) {
+  EXPECT_FALSE(values.empty());
+  if (values.empty()) {
+    return 0;
+  }
+  percent = std::min(std::max(percent, 0.0), 100.0);
+  const size_t index =
+      static_cast<size_t>((values.size() - 1) * percent / 100);
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+double median(const std::vector<double> &values) {
+  return percentile(values, 50);
+}
+
+}; // namespace level_zero_tests
@@ -0,0 +1,229 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "test_harness/test_harness.hpp"
+#include "test_harness/test_harness_topology.hpp"
+#include "utils/utils.hpp"
+
+namespace lzt = level_zero_tests;
+
+namespace level_zero_tests {
+
+namespace {
+
+// Fabric queries go to the driver directly, since a driver without fabric
+// support is not an error here
+std::vector<ze_fabric_vertex_handle_t>
+fabric_vertices(ze_driver_handle_t driver) {
+  uint32_t count = 0;
+  if (zeFabricVertexGetExp(driver, &count, nullptr) != ZE_RESULT_SUCCESS) {
+    return {};
+  }
+  std::vector<ze_fabric_vertex_handle_t> vertices(count);
+  if (count != 0 && zeFabricVertexGetExp(driver, &count, vertices.data()) !=
+                        ZE_RESULT_SUCCESS) {
+    return {};
+  }
+  return vertices;
+}
+
+std::vector<ze_fabric_vertex_handle_t>
+fabric_sub_vertices(ze_fabric_vertex_handle_t vertex) {
+  uint32_t count = 0;
+  if (zeFabricVertexGetSubVerticesExp(vertex, &count, nullptr) !=
+      ZE_RESULT_SUCCESS) {
+    return {};
+  }
+  std::vector<ze_fabric_vertex_handle_t> sub_vertices(count);
+  if (count != 0 &&
+      zeFabricVertexGetSubVerticesExp(vertex, &count, sub_vertices.data()) !=
+          ZE_RESULT_SUCCESS) {
+    return {};
+  }
+  return sub_vertices;
+}
+
+std::vector<ze_fabric_edge_exp_properties_t>
+fabric_edges(ze_fabric_vertex_handle_t vertex_a,
+             ze_fabric_vertex_handle_t vertex_b) {
+  std::vector<ze_fabric_edge_exp_properties_t> properties;
+  uint32_t count = 0;
+  if (zeFabricEdgeGetExp(vertex_a, vertex_b, &count, nullptr) !=
+          ZE_RESULT_SUCCESS ||
+      count == 0) {
+    return properties;
+  }
+  std::vector<ze_fabric_edge_handle_t> edges(count);
+  if (zeFabricEdgeGetExp(vertex_a, vertex_b, &count, edges.data()) !=
+      ZE_RESULT_SUCCESS) {
+    return properties;
+  }
+  for (auto edge : edges) {
+    ze_fabric_edge_exp_properties_t edge_properties = {
+        ZE_STRUCTURE_TYPE_FABRIC_EDGE_EXP_PROPERTIES};
+    if (zeFabricEdgeGetPropertiesExp(edge, &edge_properties) ==
+        ZE_RESULT_SUCCESS) {
+      properties.push_back(edge_properties);
+    }
+  }
+  return properties;
+}
+
+} // namespace
+
+const DeviceTopology &DeviceTopology::get() {
+  static const DeviceTopology topology(lzt::get_default_driver());
+  return topology;
+}
+
+DeviceTopology::DeviceTopology(ze_driver_handle_t driver) {
+  auto roots = lzt::get_ze_devices(driver);
+  for (uint32_t i = 0; i < roots.size(); i++) {
+    TopologyDevice root;
+    root.device = roots[i];
+    root.root = roots[i];
+    root.root_index = i;
+    devices_.push_back(root);
+
+    auto sub_devices = lzt::get_ze_sub_devices(roots[i]);
+    for (uint32_t j = 0; j < sub_devices.size(); j++) {
+      TopologyDevice sub_device = root;
+      sub_device.device = sub_devices[j];
+      sub_device.sub_device_index = static_cast<int>(j);
+      devices_.push_back(sub_device);
+    }
+  }
+  find_vertices(driver);
+  query_links(driver);
+}
+
+void DeviceTopology::find_vertices(ze_driver_handle_t driver) {
+  auto set_vertex = [&](ze_fabric_vertex_handle_t vertex) {
+    ze_device_handle_t device = nullptr;
+    if (zeFabricVertexGetDeviceExp(vertex, &device) != ZE_RESULT_SUCCESS) {
+      return;
+    }
+    for (auto &entry : devices_) {
+      if (entry.device == device) {
+        entry.vertex = vertex;
+      }
+    }
+  };
+  for (auto vertex : fabric_vertices(driver)) {
+    set_vertex(vertex);
+    for (auto sub_vertex : fabric_sub_vertices(vertex)) {
+      set_vertex(sub_vertex);
+    }
+  }
+}
+
+void DeviceTopology::query_links(ze_driver_handle_t driver) {
+#ifdef ZE_BANDWIDTH_PROPERTIES_EXP_NAME
+  const bool bandwidth_supported = lzt::check_if_extension_supported(
+      driver, ZE_BANDWIDTH_PROPERTIES_EXP_NAME);
+#endif
+  for (auto &device : devices_) {
+    for (auto &peer : devices_) {
+      if (device.device == peer.device) {
+        continue;
+      }
+      TopologyLink link;
+      link.can_access = lzt::can_access_peer(device.device, peer.device);
+
+      ze_device_p2p_properties_t properties = {
+          ZE_STRUCTURE_TYPE_DEVICE_P2P_PROPERTIES};
+#ifdef ZE_BANDWIDTH_PROPERTIES_EXP_NAME
+      ze_device_p2p_bandwidth_exp_properties_t bandwidth = {
+          ZE_STRUCTURE_TYPE_DEVICE_P2P_BANDWIDTH_EXP_PROPERTIES};
+      if (bandwidth_supported) {
+        properties.pNext = &bandwidth;
+      }
+#endif
+      EXPECT_EQ(ZE_RESULT_SUCCESS, zeDeviceGetP2PProperties(
+                                       device.device, peer.device,
+                                       &properties));
+      link.flags = properties.flags;
+#ifdef ZE_BANDWIDTH_PROPERTIES_EXP_NAME
+      if (bandwidth_supported) {
+        link.logical_bandwidth = bandwidth.logicalBandwidth;
+        link.physical_bandwidth = bandwidth.physicalBandwidth;
+        link.logical_latency = bandwidth.logicalLatency;
+        link.physical_latency = bandwidth.physicalLatency;
+      }
+#endif
+      if (device.vertex != nullptr && peer.vertex != nullptr) {
+        link.edges = fabric_edges(device.vertex, peer.vertex);
+      }
+      links_[{device.device, peer.device}] = link;
+    }
+  }
+}
+
+std::vector<ze_device_handle_t> DeviceTopology::root_devices() const {
+  std::vector<ze_device_handle_t> roots;
+  for (auto &entry : devices_) {
+    if (entry.sub_device_index < 0) {
+      roots.push_back(entry.device);
+    }
+  }
+  return roots;
+}
+
+std::vector<ze_device_handle_t>
+DeviceTopology::sub_devices(ze_device_handle_t root) const {
+  std::vector<ze_device_handle_t> sub_devices;
+  for (auto &entry : devices_) {
+    if (entry.sub_device_index >= 0 && entry.root == root) {
+      sub_devices.push_back(entry.device);
+    }
+  }
+  return sub_devices;
+}
+
+const TopologyDevice *DeviceTopology::find(ze_device_handle_t device) const {
+  for (auto &entry : devices_) {
+    if (entry.device == device) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+const TopologyLink *DeviceTopology::link(ze_device_handle_t device,
+                                         ze_device_handle_t peer) const {
+  auto entry = links_.find({device, peer});
+  return (entry == links_.end()) ? nullptr : &entry->second;
+}
+
+bool DeviceTopology::can_access_peer(ze_device_handle_t device,
+                                     ze_device_handle_t peer) const {
+  auto entry = link(device, peer);
+  return entry != nullptr && entry->can_access;
+}
+
+std::vector<std::pair<ze_device_handle_t, ze_device_handle_t>>
+DeviceTopology::p2p_pairs(bool include_sub_devices,
+                          bool require_atomics) const {
+  std::vector<std::pair<ze_device_handle_t, ze_device_handle_t>> pairs;
+  for (auto &device : devices_) {
+    for (auto &peer : devices_) {
+      if (!include_sub_devices &&
+          (device.sub_device_index >= 0 || peer.sub_device_index >= 0)) {
+        continue;
+      }
+      auto entry = link(device.device, peer.device);
+      if (entry != nullptr && entry->can_access &&
+          (!require_atomics || entry->has_atomics())) {
+        pairs.push_back({device.device, peer.device});
+      }
+    }
+  }
+  return pairs;
+}
+
+}; // namespace level_zero_tests
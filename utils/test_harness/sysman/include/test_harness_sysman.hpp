@@ -31,4 +31,5 @@
 #include "test_harness_sysman_scheduler.hpp"
 #include "test_harness_sysman_performance.hpp"
 #include "test_harness_sysman_ecc.hpp"
+#include "test_harness_sysman_telemetry.hpp"
 #endif
@@ -0,0 +1,110 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_ZE_TEST_HARNESS_SYSMAN_TELEMETRY_HPP
+#define level_zero_tests_ZE_TEST_HARNESS_SYSMAN_TELEMETRY_HPP
+
+#include <level_zero/zes_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace level_zero_tests {
+
+enum telemetry_component_t : uint32_t {
+  TELEMETRY_POWER = 1 << 0,
+  TELEMETRY_FREQUENCY = 1 << 1,
+  TELEMETRY_ENGINE = 1 << 2,
+  TELEMETRY_TEMPERATURE = 1 << 3,
+  TELEMETRY_ALL = TELEMETRY_POWER | TELEMETRY_FREQUENCY | TELEMETRY_ENGINE |
+                  TELEMETRY_TEMPERATURE
+};
+
+// Averages over an interval of a recording; a value is -1 when its component
+// was not sampled
+struct TelemetryInterval {
+  double begin_s;
+  double end_s;
+  double power_w;
+  double frequency_mhz;
+  double throttle_percent;
+  double utilization_percent;
+  double temperature_c;
+};
+
+// Samples the power, GPU frequency and throttle time, engine activity and GPU
+// temperature of a device from a background thread, at a fixed period, into
+// buffers allocated before the recording starts, so that sampling does not
+// allocate while the workload runs.  Sampling stops when the buffer is full.
+//
+// The device handle must be usable with Sysman, as with ZES_ENABLE_SYSMAN=1
+// before zeInit.  Components the device does not report are left out.
+class TelemetryRecorder {
+public:
+  TelemetryRecorder(zes_device_handle_t device,
+                    uint32_t components = TELEMETRY_ALL,
+                    std::chrono::milliseconds period =
+                        std::chrono::milliseconds(100),
+                    size_t max_samples = 4096);
+  ~TelemetryRecorder();
+  TelemetryRecorder(const TelemetryRecorder &) = delete;
+  TelemetryRecorder &operator=(const TelemetryRecorder &) = delete;
+
+  // Components actually sampled
+  uint32_t components() const { return components_; }
+
+  // start() discards the samples of any previous recording
+  void start();
+  void stop();
+
+  size_t sample_count() const { return sample_count_; }
+  // Each interval averages samples_per_interval periods of the recording
+  std::vector<TelemetryInterval>
+  get_intervals(uint32_t samples_per_interval = 1) const;
+  // The average over the whole recording
+  TelemetryInterval get_average() const;
+  // Logs the average over the recording, prefixed with the label
+  void log_average(const std::string &label) const;
+
+private:
+  struct Sample {
+    double time_s;
+    zes_power_energy_counter_t energy;
+    double frequency_mhz;
+    zes_freq_throttle_time_t throttle;
+    zes_engine_stats_t activity;
+    double temperature_c;
+  };
+
+  void sample_loop();
+  bool take_sample(Sample &sample);
+  TelemetryInterval interval(size_t first, size_t last) const;
+
+  std::atomic<uint32_t> components_{0};
+  zes_pwr_handle_t power_ = nullptr;
+  zes_freq_handle_t frequency_ = nullptr;
+  zes_engine_handle_t engine_ = nullptr;
+  zes_temp_handle_t temperature_ = nullptr;
+  std::chrono::milliseconds period_;
+  std::vector<Sample> samples_;
+  std::atomic<size_t> sample_count_{0};
+  std::chrono::steady_clock::time_point start_time_;
+  std::mutex mutex_;
+  std::condition_variable stop_condition_;
+  bool stopping_ = false;
+  std::thread sampler_;
+};
+
+}; // namespace level_zero_tests
+
+#endif
@@ -18,6 +18,7 @@ namespace level_zero_tests {
 void sysman_device_reset(zes_device_handle_t device) {
 
   EXPECT_EQ(ZE_RESULT_SUCCESS, zesDeviceReset(device, false));
+  clear_properties_cache();
 }
 
 zes_device_properties_t
@@ -0,0 +1,312 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "test_harness/test_harness.hpp"
+#include "logging/logging.hpp"
+
+#include <level_zero/zes_api.h>
+
+#include <algorithm>
+
+namespace level_zero_tests {
+
+namespace {
+
+// Handles are picked for the whole device: the card power domain, the GPU
+// frequency domain, the engine group of all engines and the GPU temperature
+// sensor, or the nearest the device has
+
+zes_pwr_handle_t telemetry_power_handle(zes_device_handle_t device) {
+  zes_pwr_handle_t handle = nullptr;
+  if (zesDeviceGetCardPowerDomain(device, &handle) == ZE_RESULT_SUCCESS &&
+      handle != nullptr) {
+    return handle;
+  }
+  uint32_t count = 1;
+  if (zesDeviceEnumPowerDomains(device, &count, &handle) != ZE_RESULT_SUCCESS ||
+      count == 0) {
+    return nullptr;
+  }
+  return handle;
+}
+
+zes_freq_handle_t telemetry_frequency_handle(zes_device_handle_t device) {
+  uint32_t count = 0;
+  if (zesDeviceEnumFrequencyDomains(device, &count, nullptr) !=
+      ZE_RESULT_SUCCESS) {
+    return nullptr;
+  }
+  std::vector<zes_freq_handle_t> handles(count);
+  if (zesDeviceEnumFrequencyDomains(device, &count, handles.data()) !=
+      ZE_RESULT_SUCCESS) {
+    return nullptr;
+  }
+  for (auto handle : handles) {
+    zes_freq_properties_t properties = {ZES_STRUCTURE_TYPE_FREQ_PROPERTIES,
+                                        nullptr};
+    if (zesFrequencyGetProperties(handle, &properties) == ZE_RESULT_SUCCESS &&
+        properties.type == ZES_FREQ_DOMAIN_GPU) {
+      return handle;
+    }
+  }
+  return nullptr;
+}
+
+zes_engine_handle_t telemetry_engine_handle(zes_device_handle_t device) {
+  uint32_t count = 0;
+  if (zesDeviceEnumEngineGroups(device, &count, nullptr) != ZE_RESULT_SUCCESS) {
+    return nullptr;
+  }
+  std::vector<zes_engine_handle_t> handles(count);
+  if (zesDeviceEnumEngineGroups(device, &count, handles.data()) !=
+      ZE_RESULT_SUCCESS) {
+    return nullptr;
+  }
+  zes_engine_handle_t compute = nullptr;
+  for (auto handle : handles) {
+    zes_engine_properties_t properties = {ZES_STRUCTURE_TYPE_ENGINE_PROPERTIES,
+                                          nullptr};
+    if (zesEngineGetProperties(handle, &properties) != ZE_RESULT_SUCCESS ||
+        properties.onSubdevice) {
+      continue;
+    }
+    if (properties.type == ZES_ENGINE_GROUP_ALL) {
+      return handle;
+    }
+    if (properties.type == ZES_ENGINE_GROUP_COMPUTE_ALL) {
+      compute = handle;
+    }
+  }
+  return compute;
+}
+
+zes_temp_handle_t telemetry_temperature_handle(zes_device_handle_t device) {
+  uint32_t count = 0;
+  if (zesDeviceEnumTemperatureSensors(device, &count, nullptr) !=
+      ZE_RESULT_SUCCESS) {
+    return nullptr;
+  }
+  std::vector<zes_temp_handle_t> handles(count);
+  if (zesDeviceEnumTemperatureSensors(device, &count, handles.data()) !=
+      ZE_RESULT_SUCCESS) {
+    return nullptr;
+  }
+  zes_temp_handle_t global = nullptr;
+  for (auto handle : handles) {
+    zes_temp_properties_t properties = {ZES_STRUCTURE_TYPE_TEMP_PROPERTIES,
+                                        nullptr};
+    if (zesTemperatureGetProperties(handle, &properties) != ZE_RESULT_SUCCESS) {
+      continue;
+    }
+    if (properties.type == ZES_TEMP_SENSORS_GPU) {
+      return handle;
+    }
+    if (properties.type == ZES_TEMP_SENSORS_GLOBAL) {
+      global = handle;
+    }
+  }
+  return global;
+}
+
+double counter_rate(uint64_t first, uint64_t last, uint64_t first_timestamp,
+                    uint64_t last_timestamp, double scale) {
+  if (last_timestamp <= first_timestamp || first_timestamp == 0) {
+    return -1;
+  }
+  return scale * static_cast<int64_t>(last - first) /
+         static_cast<double>(last_timestamp - first_timestamp);
+}
+
+} // namespace
+
+TelemetryRecorder::TelemetryRecorder(zes_device_handle_t device,
+                                     uint32_t components,
+                                     std::chrono::milliseconds period,
+                                     size_t max_samples)
+    : period_(period), samples_(max_samples) {
+  if (components & TELEMETRY_POWER) {
+    power_ = telemetry_power_handle(device);
+  }
+  if (components & TELEMETRY_FREQUENCY) {
+    frequency_ = telemetry_frequency_handle(device);
+  }
+  if (components & TELEMETRY_ENGINE) {
+    engine_ = telemetry_engine_handle(device);
+  }
+  if (components & TELEMETRY_TEMPERATURE) {
+    temperature_ = telemetry_temperature_handle(device);
+  }
+  components_ = (power_ ? TELEMETRY_POWER : 0) |
+                (frequency_ ? TELEMETRY_FREQUENCY : 0) |
+                (engine_ ? TELEMETRY_ENGINE : 0) |
+                (temperature_ ? TELEMETRY_TEMPERATURE : 0);
+
+  // A component that cannot be read now is not sampled at all
+  Sample sample;
+  take_sample(sample);
+}
+
+TelemetryRecorder::~TelemetryRecorder() { stop(); }
+
+void TelemetryRecorder::start() {
+  stop();
+  sample_count_ = 0;
+  stopping_ = false;
+  start_time_ = std::chrono::steady_clock::now();
+  sampler_ = std::thread(&TelemetryRecorder::sample_loop, this);
+}
+
+void TelemetryRecorder::stop() {
+  if (!sampler_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  stop_condition_.notify_all();
+  sampler_.join();
+}
+
+// Samples on fixed deadlines; a sample that misses its deadline is skipped
+// rather than taken late
+void TelemetryRecorder::sample_loop() {
+  auto deadline = start_time_;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    const size_t index = sample_count_.load(std::memory_order_relaxed);
+    if (index == samples_.size()) {
+      break;
+    }
+    lock.unlock();
+    if (take_sample(samples_[index])) {
+      sample_count_.store(index + 1, std::memory_order_release);
+    }
+    lock.lock();
+
+    const auto now = std::chrono::steady_clock::now();
+    do {
+      deadline += period_;
+    } while (deadline <= now);
+    stop_condition_.wait_until(lock, deadline, [this] { return stopping_; });
+  }
+}
+
+bool TelemetryRecorder::take_sample(Sample &sample) {
+  sample.time_s = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start_time_)
+                      .count();
+  sample.energy = {};
+  sample.throttle = {};
+  sample.activity = {};
+  sample.frequency_mhz = -1;
+  sample.temperature_c = -1;
+
+  if (power_ && zesPowerGetEnergyCounter(power_, &sample.energy) !=
+                    ZE_RESULT_SUCCESS) {
+    power_ = nullptr;
+    components_ &= ~TELEMETRY_POWER;
+  }
+  if (frequency_) {
+    zes_freq_state_t state = {ZES_STRUCTURE_TYPE_FREQ_STATE, nullptr};
+    if (zesFrequencyGetState(frequency_, &state) == ZE_RESULT_SUCCESS) {
+      sample.frequency_mhz = state.actual;
+      // Throttle time is optional, and left at 0 where not supported
+      if (zesFrequencyGetThrottleTime(frequency_, &sample.throttle) !=
+          ZE_RESULT_SUCCESS) {
+        sample.throttle = {};
+      }
+    } else {
+      frequency_ = nullptr;
+      components_ &= ~TELEMETRY_FREQUENCY;
+    }
+  }
+  if (engine_ &&
+      zesEngineGetActivity(engine_, &sample.activity) != ZE_RESULT_SUCCESS) {
+    engine_ = nullptr;
+    components_ &= ~TELEMETRY_ENGINE;
+  }
+  if (temperature_ && zesTemperatureGetState(temperature_,
+                                             &sample.temperature_c) !=
+                          ZE_RESULT_SUCCESS) {
+    temperature_ = nullptr;
+    components_ &= ~TELEMETRY_TEMPERATURE;
+  }
+  return components_ != 0;
+}
+
+// Counters are differenced between the first and the last sample, and the
+// instantaneous values averaged over the samples after the first
+TelemetryInterval TelemetryRecorder::interval(size_t first,
+                                              size_t last) const {
+  const Sample &begin = samples_[first];
+  const Sample &end = samples_[last];
+  TelemetryInterval result = {begin.time_s, end.time_s, -1, -1, -1, -1, -1};
+  if (last <= first) {
+    return result;
+  }
+
+  // Energy in microjoules over microseconds is watts
+  result.power_w = counter_rate(begin.energy.energy, end.energy.energy,
+                                begin.energy.timestamp, end.energy.timestamp,
+                                1.0);
+  result.throttle_percent = counter_rate(
+      begin.throttle.throttleTime, end.throttle.throttleTime,
+      begin.throttle.timestamp, end.throttle.timestamp, 100.0);
+  result.utilization_percent = counter_rate(
+      begin.activity.activeTime, end.activity.activeTime,
+      begin.activity.timestamp, end.activity.timestamp, 100.0);
+
+  double frequency = 0, temperature = 0;
+  for (size_t i = first + 1; i <= last; i++) {
+    frequency += samples_[i].frequency_mhz;
+    temperature += samples_[i].temperature_c;
+  }
+  if (end.frequency_mhz >= 0) {
+    result.frequency_mhz = frequency / (last - first);
+  }
+  if (end.temperature_c >= 0) {
+    result.temperature_c = temperature / (last - first);
+  }
+  return result;
+}
+
+std::vector<TelemetryInterval>
+TelemetryRecorder::get_intervals(uint32_t samples_per_interval) const {
+  std::vector<TelemetryInterval> intervals;
+  const size_t count = sample_count_.load(std::memory_order_acquire);
+  const size_t step = std::max(1u, samples_per_interval);
+  for (size_t first = 0; first + 1 < count; first += step) {
+    intervals.push_back(interval(first, std::min(first + step, count - 1)));
+  }
+  return intervals;
+}
+
+TelemetryInterval TelemetryRecorder::get_average() const {
+  const size_t count = sample_count_.load(std::memory_order_acquire);
+  if (count < 2) {
+    return {0, 0, -1, -1, -1, -1, -1};
+  }
+  return interval(0, count - 1);
+}
+
+void TelemetryRecorder::log_average(const std::string &label) const {
+  const TelemetryInterval average = get_average();
+  auto value = [](double v, const char *units) {
+    return v < 0 ? std::string("n/a")
+                 : std::to_string(static_cast<int64_t>(v + 0.5)) + units;
+  };
+  LOG_INFO << label << " telemetry over " << average.end_s - average.begin_s
+           << " s: power " << value(average.power_w, " W") << ", frequency "
+           << value(average.frequency_mhz, " MHz") << ", throttled "
+           << value(average.throttle_percent, "%") << ", utilization "
+           << value(average.utilization_percent, "%") << ", temperature "
+           << value(average.temperature_c, " C");
+}
+
+}; // namespace level_zero_tests
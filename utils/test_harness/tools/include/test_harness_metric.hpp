@@ -11,6 +11,10 @@
 
 #include <level_zero/ze_api.h>
 #include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 
@@ -163,6 +167,58 @@ void metric_validate_streamer_marker_data(
     std::vector<uint32_t> &metricValueSets,
     std::vector<uint32_t> &streamerMarkerValues);
 
+// Drains a metric streamer from a thread of its own into a ring of buffers
+// allocated up front, so that high sampling rates do not overflow the
+// hardware buffer between reads.  Every read goes straight into the next
+// free buffer of the ring, with no allocation or copy.  When the ring is
+// full the oldest buffer is overwritten and its bytes counted as lost, so
+// the ring should hold the whole profile unless buffers are taken while
+// it runs.  Metric values are only calculated from the raw reports once
+// the reader is stopped.
+class zeMetricStreamerReader {
+public:
+  zeMetricStreamerReader(zet_metric_streamer_handle_t streamer,
+                         size_t buffer_size = 4 * 1024 * 1024,
+                         size_t buffer_count = 16,
+                         std::chrono::microseconds interval =
+                             std::chrono::microseconds(1000));
+  ~zeMetricStreamerReader();
+  zeMetricStreamerReader(const zeMetricStreamerReader &) = delete;
+  zeMetricStreamerReader &operator=(const zeMetricStreamerReader &) = delete;
+
+  void start();
+  // Joins the drain thread and reads what is left in the streamer
+  void stop();
+
+  // Moves the filled buffers, oldest first, to raw_data, releasing them for
+  // the drain thread
+  void take(std::vector<uint8_t> &raw_data);
+  void calculate(zet_metric_group_handle_t group,
+                 std::vector<zet_typed_value_t> &values,
+                 std::vector<uint32_t> &value_sets);
+
+  uint32_t reads() const { return reads_; }
+  uint32_t dropped_reads() const { return dropped_reads_; }
+  uint64_t lost_bytes() const { return lost_bytes_; }
+
+private:
+  void drain();
+  void read_all();
+
+  zet_metric_streamer_handle_t streamer_;
+  std::chrono::microseconds interval_;
+  std::vector<std::vector<uint8_t>> buffers_;
+  std::vector<size_t> used_;
+  size_t oldest_ = 0;
+  size_t filled_ = 0;
+  std::mutex mutex_;
+  std::thread drainer_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint32_t> reads_{0};
+  std::atomic<uint32_t> dropped_reads_{0};
+  std::atomic<uint64_t> lost_bytes_{0};
+};
+
 }; // namespace level_zero_tests
 
 #endif /* TEST_HARNESS_SYSMAN_METRIC_HPP */
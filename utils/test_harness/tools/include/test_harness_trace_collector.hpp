@@ -0,0 +1,101 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_TEST_HARNESS_TRACE_COLLECTOR_HPP
+#define level_zero_tests_TEST_HARNESS_TRACE_COLLECTOR_HPP
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace level_zero_tests {
+
+// One traced API call, as written to the trace file
+struct TraceRecord {
+  uint64_t begin_ns;
+  uint32_t duration_ns;
+  int32_t result;
+  uint32_t thread;
+  uint16_t api;
+  uint16_t reserved;
+};
+
+// Records the enter and exit time of the most common core API calls through
+// a tracer of the default context.  Every calling thread logs into a ring
+// of its own, with no lock, and a flush thread moves the rings to a binary
+// file while the collector runs.  A call made while the ring of its thread
+// is full is dropped and counted, rather than waiting for the flush.
+//
+// The file starts with the magic "LZTTRC01", the number of API names and
+// the names, each as a 16-bit length followed by its characters, and is
+// followed by TraceRecords.  convert_trace_to_chrome_json turns it into the
+// Chrome trace event format, which chrome://tracing and Perfetto open.
+class TraceCollector {
+public:
+  TraceCollector() = default;
+  ~TraceCollector();
+  TraceCollector(const TraceCollector &) = delete;
+  TraceCollector &operator=(const TraceCollector &) = delete;
+
+  // records_per_thread is rounded up to a power of two
+  bool start(const std::string &file_name, size_t records_per_thread = 65536,
+             std::chrono::milliseconds flush_interval =
+                 std::chrono::milliseconds(10));
+  // Disables the tracer and flushes the remaining records
+  void stop();
+
+  uint64_t records_written() const { return records_written_; }
+  uint64_t dropped_records() const;
+
+  static uint64_t now_ns();
+  void record(uint16_t api, uint64_t begin_ns, ze_result_t result);
+
+private:
+  struct ThreadRing {
+    std::vector<TraceRecord> records;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+  };
+
+  ThreadRing *thread_ring();
+  void flush_loop();
+  void flush();
+
+  zet_tracer_exp_handle_t tracer_ = nullptr;
+  FILE *file_ = nullptr;
+  size_t ring_size_ = 0;
+  std::chrono::milliseconds flush_interval_{10};
+  uint64_t generation_ = 0;
+  std::mutex rings_mutex_;
+  std::vector<std::unique_ptr<ThreadRing>> rings_;
+  std::thread flusher_;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> records_written_{0};
+};
+
+// Names of the APIs traced, indexed by TraceRecord::api
+const std::vector<std::string> &trace_collector_api_names();
+
+// Writes the trace file of a TraceCollector as Chrome trace JSON, with one
+// row per calling thread.  Returns false if the file is not a trace.
+bool convert_trace_to_chrome_json(const std::string &trace_file,
+                                  const std::string &json_file);
+
+}; // namespace level_zero_tests
+
+#endif
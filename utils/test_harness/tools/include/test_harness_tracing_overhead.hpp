@@ -0,0 +1,65 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_TEST_HARNESS_TRACING_OVERHEAD_HPP
+#define level_zero_tests_TEST_HARNESS_TRACING_OVERHEAD_HPP
+
+#include <level_zero/ze_api.h>
+#include <level_zero/zet_api.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace level_zero_tests {
+
+// Callbacks installed by the tracing overhead tests, which the zet and the
+// zel tracers take in the same callback tables
+enum tracing_overhead_mode_t {
+  TRACING_OVERHEAD_DISABLED,
+  TRACING_OVERHEAD_EMPTY_CALLBACKS,
+  TRACING_OVERHEAD_TIMESTAMP_CALLBACKS
+};
+
+std::string tracing_overhead_mode_name(tracing_overhead_mode_t mode);
+
+// Sets the zeEventQueryStatus prologue and epilogue of mode
+void set_query_status_callbacks(tracing_overhead_mode_t mode,
+                                zet_core_callbacks_t &prologues,
+                                zet_core_callbacks_t &epilogues);
+
+// 1, 2, 4 and more threads, up to the CPU count capped at 16
+std::vector<uint32_t> tracing_thread_counts();
+
+// Runs body on thread_count threads started at the same time, each given
+// its index and a signaled event of its own, and returns the time in ns
+// every thread spent in body
+std::vector<double> time_threads_with_own_event(
+    uint32_t thread_count,
+    const std::function<void(uint32_t, ze_event_handle_t)> &body);
+
+struct query_status_times_t {
+  double ns_per_call;
+  // Time from prologue to epilogue of the timestamp callbacks, as an
+  // always-on profiler would record it, 0 with the other modes
+  double callback_ns_per_call;
+};
+
+// Mean times of one zeEventQueryStatus call, a cheap call whose cost is
+// dominated by the tracing layer once traced, over thread_count threads
+// calling it at the same time
+query_status_times_t time_query_status_calls(uint32_t thread_count);
+
+// Logs the time of the calls traced as name describes, and its overhead
+// over untraced_ns, the untraced time of the same calls
+void log_tracing_overhead(const std::string &name, uint32_t thread_count,
+                          double untraced_ns, double traced_ns);
+
+}; // namespace level_zero_tests
+
+#endif
@@ -1031,4 +1031,104 @@ void metric_validate_streamer_marker_data(
   EXPECT_EQ(numbefOfStreamerMarkerMatches, metricValueSets.size());
 }
 
+zeMetricStreamerReader::zeMetricStreamerReader(
+    zet_metric_streamer_handle_t streamer, size_t buffer_size,
+    size_t buffer_count, std::chrono::microseconds interval)
+    : streamer_(streamer), interval_(interval),
+      buffers_(buffer_count, std::vector<uint8_t>(buffer_size)),
+      used_(buffer_count, 0) {}
+
+zeMetricStreamerReader::~zeMetricStreamerReader() { stop(); }
+
+void zeMetricStreamerReader::start() {
+  if (running_) {
+    return;
+  }
+  running_ = true;
+  drainer_ = std::thread(&zeMetricStreamerReader::drain, this);
+}
+
+void zeMetricStreamerReader::stop() {
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+  drainer_.join();
+  read_all();
+}
+
+void zeMetricStreamerReader::drain() {
+  while (running_) {
+    std::this_thread::sleep_for(interval_);
+    read_all();
+  }
+}
+
+// Reads into free buffers until the streamer has less than a buffer left
+void zeMetricStreamerReader::read_all() {
+  while (true) {
+    size_t index;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (filled_ == buffers_.size()) {
+        lost_bytes_ += used_[oldest_];
+        oldest_ = (oldest_ + 1) % buffers_.size();
+        filled_--;
+      }
+      index = (oldest_ + filled_) % buffers_.size();
+    }
+    // Only the drain thread, or stop() once it joined, writes to a free
+    // buffer, so the read is done outside of the lock
+    size_t size = buffers_[index].size();
+    const ze_result_t result = zetMetricStreamerReadData(
+        streamer_, UINT32_MAX, &size, buffers_[index].data());
+    reads_++;
+    if (result == ZE_RESULT_WARNING_DROPPED_DATA) {
+      dropped_reads_++;
+    } else if (result != ZE_RESULT_SUCCESS) {
+      ADD_FAILURE() << "zetMetricStreamerReadData failed with " << result;
+      return;
+    }
+    if (size == 0) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      used_[index] = size;
+      filled_++;
+    }
+    // A partly filled buffer means the streamer was emptied
+    if (size < buffers_[index].size() / 2) {
+      return;
+    }
+  }
+}
+
+void zeMetricStreamerReader::take(std::vector<uint8_t> &raw_data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (; filled_ > 0; filled_--) {
+    auto &buffer = buffers_[oldest_];
+    raw_data.insert(raw_data.end(), buffer.begin(),
+                    buffer.begin() + used_[oldest_]);
+    used_[oldest_] = 0;
+    oldest_ = (oldest_ + 1) % buffers_.size();
+  }
+}
+
+void zeMetricStreamerReader::calculate(zet_metric_group_handle_t group,
+                                       std::vector<zet_typed_value_t> &values,
+                                       std::vector<uint32_t> &value_sets) {
+  stop();
+  std::vector<uint8_t> raw_data;
+  take(raw_data);
+  values.clear();
+  value_sets.clear();
+  if (raw_data.empty()) {
+    return;
+  }
+  metric_calculate_metric_values_from_raw_data(group, raw_data, values,
+                                               value_sets,
+                                               dropped_reads_ > 0);
+}
+
 } // namespace level_zero_tests
@@ -0,0 +1,332 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "test_harness/test_harness.hpp"
+#include "gtest/gtest.h"
+#include "logging/logging.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include <level_zero/ze_api.h>
+
+namespace lzt = level_zero_tests;
+
+namespace level_zero_tests {
+
+namespace {
+
+const char trace_magic[8] = {'L', 'Z', 'T', 'T', 'R', 'C', '0', '1'};
+
+// The traced APIs, as the group and name of their callback and the type of
+// their parameters
+#define TRACE_COLLECTOR_APIS(X)                                                \
+  X(CommandList, Create, ze_command_list_create_params_t)                      \
+  X(CommandList, CreateImmediate, ze_command_list_create_immediate_params_t)   \
+  X(CommandList, Destroy, ze_command_list_destroy_params_t)                    \
+  X(CommandList, Close, ze_command_list_close_params_t)                        \
+  X(CommandList, Reset, ze_command_list_reset_params_t)                        \
+  X(CommandList, AppendBarrier, ze_command_list_append_barrier_params_t)       \
+  X(CommandList, AppendLaunchKernel,                                           \
+    ze_command_list_append_launch_kernel_params_t)                             \
+  X(CommandList, AppendMemoryCopy,                                             \
+    ze_command_list_append_memory_copy_params_t)                               \
+  X(CommandList, AppendMemoryFill,                                             \
+    ze_command_list_append_memory_fill_params_t)                               \
+  X(CommandList, AppendSignalEvent,                                            \
+    ze_command_list_append_signal_event_params_t)                              \
+  X(CommandList, AppendWaitOnEvents,                                           \
+    ze_command_list_append_wait_on_events_params_t)                            \
+  X(CommandQueue, Create, ze_command_queue_create_params_t)                    \
+  X(CommandQueue, Destroy, ze_command_queue_destroy_params_t)                  \
+  X(CommandQueue, ExecuteCommandLists,                                         \
+    ze_command_queue_execute_command_lists_params_t)                           \
+  X(CommandQueue, Synchronize, ze_command_queue_synchronize_params_t)          \
+  X(Fence, HostSynchronize, ze_fence_host_synchronize_params_t)                \
+  X(EventPool, Create, ze_event_pool_create_params_t)                          \
+  X(EventPool, Destroy, ze_event_pool_destroy_params_t)                        \
+  X(Event, Create, ze_event_create_params_t)                                   \
+  X(Event, Destroy, ze_event_destroy_params_t)                                 \
+  X(Event, HostSignal, ze_event_host_signal_params_t)                          \
+  X(Event, HostSynchronize, ze_event_host_synchronize_params_t)                \
+  X(Event, QueryStatus, ze_event_query_status_params_t)                        \
+  X(Event, HostReset, ze_event_host_reset_params_t)                            \
+  X(Module, Create, ze_module_create_params_t)                                 \
+  X(Module, Destroy, ze_module_destroy_params_t)                               \
+  X(Kernel, Create, ze_kernel_create_params_t)                                 \
+  X(Kernel, Destroy, ze_kernel_destroy_params_t)                               \
+  X(Kernel, SetGroupSize, ze_kernel_set_group_size_params_t)                   \
+  X(Kernel, SetArgumentValue, ze_kernel_set_argument_value_params_t)           \
+  X(Mem, AllocShared, ze_mem_alloc_shared_params_t)                            \
+  X(Mem, AllocDevice, ze_mem_alloc_device_params_t)                            \
+  X(Mem, AllocHost, ze_mem_alloc_host_params_t)                                \
+  X(Mem, Free, ze_mem_free_params_t)
+
+enum TraceApi : uint16_t {
+#define TRACE_COLLECTOR_API_ID(group, name, params) TRACE_##group##name,
+  TRACE_COLLECTOR_APIS(TRACE_COLLECTOR_API_ID)
+#undef TRACE_COLLECTOR_API_ID
+};
+
+// The prologue passes the enter time to the epilogue of the same call
+template <typename params_type>
+void collector_prologue(params_type *params, ze_result_t result,
+                        void *pTracerUserData,
+                        void **ppTracerInstanceUserData) {
+  *ppTracerInstanceUserData =
+      reinterpret_cast<void *>(static_cast<uintptr_t>(TraceCollector::now_ns()));
+}
+
+template <typename params_type, uint16_t api>
+void collector_epilogue(params_type *params, ze_result_t result,
+                        void *pTracerUserData,
+                        void **ppTracerInstanceUserData) {
+  static_cast<TraceCollector *>(pTracerUserData)
+      ->record(api, reinterpret_cast<uintptr_t>(*ppTracerInstanceUserData),
+               result);
+}
+
+// Every start of a collector gets a new generation, so that a thread does
+// not log into the ring of a collector that was stopped since
+std::atomic<uint64_t> collector_generations(0);
+
+struct ThreadTraceState {
+  uint64_t generation = 0;
+  void *ring = nullptr;
+  uint32_t thread = 0;
+};
+thread_local ThreadTraceState thread_trace_state;
+
+std::string trace_quoted(const std::string &value) {
+  std::string quoted = "\"";
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+} // namespace
+
+const std::vector<std::string> &trace_collector_api_names() {
+  static const std::vector<std::string> names = {
+#define TRACE_COLLECTOR_API_NAME(group, name, params) "ze" #group #name,
+      TRACE_COLLECTOR_APIS(TRACE_COLLECTOR_API_NAME)
+#undef TRACE_COLLECTOR_API_NAME
+  };
+  return names;
+}
+
+uint64_t TraceCollector::now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+TraceCollector::~TraceCollector() { stop(); }
+
+bool TraceCollector::start(const std::string &file_name,
+                           size_t records_per_thread,
+                           std::chrono::milliseconds flush_interval) {
+  if (running_) {
+    return false;
+  }
+  file_ = fopen(file_name.c_str(), "wb");
+  if (file_ == nullptr) {
+    LOG_WARNING << "cannot open trace file " << file_name;
+    return false;
+  }
+  const auto &names = trace_collector_api_names();
+  const uint32_t name_count = static_cast<uint32_t>(names.size());
+  fwrite(trace_magic, sizeof(trace_magic), 1, file_);
+  fwrite(&name_count, sizeof(name_count), 1, file_);
+  for (auto &name : names) {
+    const uint16_t length = static_cast<uint16_t>(name.size());
+    fwrite(&length, sizeof(length), 1, file_);
+    fwrite(name.data(), 1, length, file_);
+  }
+
+  ring_size_ = 1;
+  while (ring_size_ < records_per_thread) {
+    ring_size_ *= 2;
+  }
+  flush_interval_ = flush_interval;
+  generation_ = ++collector_generations;
+  records_written_ = 0;
+  rings_.clear();
+  running_ = true;
+  flusher_ = std::thread(&TraceCollector::flush_loop, this);
+
+  zet_tracer_exp_desc_t tracer_desc = {ZET_STRUCTURE_TYPE_TRACER_EXP_DESC,
+                                       nullptr, this};
+  tracer_ = create_tracer_handle(tracer_desc);
+  zet_core_callbacks_t prologues = {};
+  zet_core_callbacks_t epilogues = {};
+#define TRACE_COLLECTOR_SET_CALLBACKS(group, name, params)                     \
+  prologues.group.pfn##name##Cb = collector_prologue<params>;                  \
+  epilogues.group.pfn##name##Cb = collector_epilogue<params, TRACE_##group##name>;
+  TRACE_COLLECTOR_APIS(TRACE_COLLECTOR_SET_CALLBACKS)
+#undef TRACE_COLLECTOR_SET_CALLBACKS
+  set_tracer_prologues(tracer_, prologues);
+  set_tracer_epilogues(tracer_, epilogues);
+  enable_tracer(tracer_);
+  return true;
+}
+
+void TraceCollector::stop() {
+  if (!running_) {
+    return;
+  }
+  disable_tracer(tracer_);
+  destroy_tracer_handle(tracer_);
+  tracer_ = nullptr;
+  running_ = false;
+  flusher_.join();
+  flush();
+  fclose(file_);
+  file_ = nullptr;
+  if (dropped_records()) {
+    LOG_WARNING << "trace collector dropped " << dropped_records()
+                << " records, raise records_per_thread";
+  }
+}
+
+uint64_t TraceCollector::dropped_records() const {
+  uint64_t dropped = 0;
+  for (auto &ring : rings_) {
+    dropped += ring->dropped;
+  }
+  return dropped;
+}
+
+// The ring of a thread is created on its first traced call, which is the
+// only time a traced call takes a lock
+TraceCollector::ThreadRing *TraceCollector::thread_ring() {
+  auto &state = thread_trace_state;
+  if (state.generation != generation_) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.emplace_back(new ThreadRing);
+    rings_.back()->records.resize(ring_size_);
+    state.generation = generation_;
+    state.ring = rings_.back().get();
+    state.thread = static_cast<uint32_t>(rings_.size() - 1);
+  }
+  return static_cast<ThreadRing *>(state.ring);
+}
+
+void TraceCollector::record(uint16_t api, uint64_t begin_ns,
+                            ze_result_t result) {
+  const uint64_t end_ns = now_ns();
+  ThreadRing *ring = thread_ring();
+  const uint64_t head = ring->head.load(std::memory_order_relaxed);
+  if (head - ring->tail.load(std::memory_order_acquire) == ring_size_) {
+    ring->dropped++;
+    return;
+  }
+  TraceRecord &record = ring->records[head & (ring_size_ - 1)];
+  record.begin_ns = begin_ns;
+  record.duration_ns = static_cast<uint32_t>(end_ns - begin_ns);
+  record.result = static_cast<int32_t>(result);
+  record.thread = thread_trace_state.thread;
+  record.api = api;
+  record.reserved = 0;
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+void TraceCollector::flush_loop() {
+  while (running_) {
+    std::this_thread::sleep_for(flush_interval_);
+    flush();
+  }
+}
+
+// Only the flush thread, or stop() once it joined, consumes the rings
+void TraceCollector::flush() {
+  std::vector<ThreadRing *> rings;
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto &ring : rings_) {
+      rings.push_back(ring.get());
+    }
+  }
+  for (auto ring : rings) {
+    const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    if (head == tail) {
+      continue;
+    }
+    const size_t first = tail & (ring_size_ - 1);
+    const size_t count = head - tail;
+    const size_t until_end = std::min(count, ring_size_ - first);
+    fwrite(&ring->records[first], sizeof(TraceRecord), until_end, file_);
+    fwrite(&ring->records[0], sizeof(TraceRecord), count - until_end, file_);
+    ring->tail.store(head, std::memory_order_release);
+    records_written_ += count;
+  }
+  fflush(file_);
+}
+
+bool convert_trace_to_chrome_json(const std::string &trace_file,
+                                  const std::string &json_file) {
+  std::ifstream in(trace_file, std::ios::binary);
+  char magic[sizeof(trace_magic)];
+  uint32_t name_count = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      memcmp(magic, trace_magic, sizeof(magic)) != 0 ||
+      !in.read(reinterpret_cast<char *>(&name_count), sizeof(name_count))) {
+    return false;
+  }
+  std::vector<std::string> names(name_count);
+  for (auto &name : names) {
+    uint16_t length = 0;
+    if (!in.read(reinterpret_cast<char *>(&length), sizeof(length))) {
+      return false;
+    }
+    name.resize(length);
+    if (!in.read(&name[0], length)) {
+      return false;
+    }
+  }
+
+  std::vector<TraceRecord> records;
+  TraceRecord record;
+  while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    records.push_back(record);
+  }
+  uint64_t origin_ns = UINT64_MAX;
+  for (auto &r : records) {
+    origin_ns = std::min(origin_ns, r.begin_ns);
+  }
+
+  std::ofstream out(json_file);
+  if (!out.good()) {
+    return false;
+  }
+  // Timestamps of the format are in microseconds
+  out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n"
+      << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, "
+         "\"args\": {\"name\": \"Level Zero API\"}}";
+  out << std::fixed << std::setprecision(3);
+  for (auto &r : records) {
+    const std::string name =
+        (r.api < names.size()) ? names[r.api] : "unknown";
+    out << ",\n{\"name\": " << trace_quoted(name)
+        << ", \"cat\": \"api\", \"ph\": \"X\", \"pid\": 0, \"tid\": "
+        << r.thread << ", \"ts\": " << (r.begin_ns - origin_ns) / 1e3L
+        << ", \"dur\": " << r.duration_ns / 1e3L
+        << ", \"args\": {\"result\": " << r.result << "}}";
+  }
+  out << "\n]}\n";
+  return out.good();
+}
+
+} // namespace level_zero_tests
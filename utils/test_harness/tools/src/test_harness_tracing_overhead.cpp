@@ -0,0 +1,165 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "test_harness/test_harness.hpp"
+#include "gtest/gtest.h"
+#include "logging/logging.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+void OnEnterEventQueryStatusEmpty(ze_event_query_status_params_t *params,
+                                  ze_result_t result, void *pTraceUserData,
+                                  void **ppTracerInstanceUserData) {}
+
+void OnExitEventQueryStatusEmpty(ze_event_query_status_params_t *params,
+                                 ze_result_t result, void *pTraceUserData,
+                                 void **ppTracerInstanceUserData) {}
+
+// The prologue passes its time to the epilogue in the instance data, and
+// the epilogue accumulates the time between them for its thread
+thread_local uint64_t callback_ns = 0;
+
+void OnEnterEventQueryStatusTimestamp(ze_event_query_status_params_t *params,
+                                      ze_result_t result,
+                                      void *pTraceUserData,
+                                      void **ppTracerInstanceUserData) {
+  *ppTracerInstanceUserData = reinterpret_cast<void *>(static_cast<uintptr_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count()));
+}
+
+void OnExitEventQueryStatusTimestamp(ze_event_query_status_params_t *params,
+                                     ze_result_t result, void *pTraceUserData,
+                                     void **ppTracerInstanceUserData) {
+  callback_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count() -
+                 reinterpret_cast<uintptr_t>(*ppTracerInstanceUserData);
+}
+
+} // namespace
+
+namespace level_zero_tests {
+
+std::string tracing_overhead_mode_name(tracing_overhead_mode_t mode) {
+  switch (mode) {
+  case TRACING_OVERHEAD_DISABLED:
+    return "tracing disabled";
+  case TRACING_OVERHEAD_EMPTY_CALLBACKS:
+    return "empty callbacks";
+  case TRACING_OVERHEAD_TIMESTAMP_CALLBACKS:
+    return "timestamp callbacks";
+  }
+  return "unknown";
+}
+
+void set_query_status_callbacks(tracing_overhead_mode_t mode,
+                                zet_core_callbacks_t &prologues,
+                                zet_core_callbacks_t &epilogues) {
+  if (mode == TRACING_OVERHEAD_EMPTY_CALLBACKS) {
+    prologues.Event.pfnQueryStatusCb = OnEnterEventQueryStatusEmpty;
+    epilogues.Event.pfnQueryStatusCb = OnExitEventQueryStatusEmpty;
+  } else if (mode == TRACING_OVERHEAD_TIMESTAMP_CALLBACKS) {
+    prologues.Event.pfnQueryStatusCb = OnEnterEventQueryStatusTimestamp;
+    epilogues.Event.pfnQueryStatusCb = OnExitEventQueryStatusTimestamp;
+  }
+}
+
+std::vector<uint32_t> tracing_thread_counts() {
+  const uint32_t max_threads =
+      std::max(1u, std::min(16u, std::thread::hardware_concurrency()));
+  std::vector<uint32_t> counts;
+  for (uint32_t count = 1; count < max_threads; count *= 2) {
+    counts.push_back(count);
+  }
+  counts.push_back(max_threads);
+  return counts;
+}
+
+std::vector<double> time_threads_with_own_event(
+    uint32_t thread_count,
+    const std::function<void(uint32_t, ze_event_handle_t)> &body) {
+  auto ep = create_event_pool(get_default_context(), thread_count,
+                              ZE_EVENT_POOL_FLAG_HOST_VISIBLE);
+  std::vector<ze_event_handle_t> events(thread_count);
+  for (uint32_t i = 0; i < thread_count; i++) {
+    ze_event_desc_t event_desc = {ZE_STRUCTURE_TYPE_EVENT_DESC, nullptr, i,
+                                  ZE_EVENT_SCOPE_FLAG_HOST,
+                                  ZE_EVENT_SCOPE_FLAG_HOST};
+    events[i] = create_event(ep, event_desc);
+    signal_event_from_host(events[i]);
+  }
+
+  std::atomic<uint32_t> started(0);
+  std::vector<double> thread_ns(thread_count);
+  auto caller = [&](uint32_t index) {
+    started++;
+    while (started < thread_count) {
+    }
+    const auto start = std::chrono::steady_clock::now();
+    body(index, events[index]);
+    thread_ns[index] = std::chrono::duration<double, std::nano>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  };
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < thread_count; i++) {
+    threads.emplace_back(caller, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (auto event : events) {
+    EXPECT_EQ(ZE_RESULT_SUCCESS, zeEventQueryStatus(event));
+    destroy_event(event);
+  }
+  destroy_event_pool(ep);
+  return thread_ns;
+}
+
+query_status_times_t time_query_status_calls(uint32_t thread_count) {
+  const uint32_t calls = 100000;
+  std::vector<double> thread_callback_ns(thread_count);
+  const auto thread_ns = time_threads_with_own_event(
+      thread_count, [&](uint32_t index, ze_event_handle_t event) {
+        callback_ns = 0;
+        for (uint32_t i = 0; i < calls; i++) {
+          if (zeEventQueryStatus(event) != ZE_RESULT_SUCCESS) {
+            break;
+          }
+        }
+        thread_callback_ns[index] = static_cast<double>(callback_ns);
+      });
+
+  double total_ns = 0, total_callback_ns = 0;
+  for (uint32_t i = 0; i < thread_count; i++) {
+    total_ns += thread_ns[i];
+    total_callback_ns += thread_callback_ns[i];
+  }
+  const double total_calls = static_cast<double>(calls) * thread_count;
+  query_status_times_t times;
+  times.ns_per_call = total_ns / total_calls;
+  times.callback_ns_per_call = total_callback_ns / total_calls;
+  return times;
+}
+
+void log_tracing_overhead(const std::string &name, uint32_t thread_count,
+                          double untraced_ns, double traced_ns) {
+  LOG_INFO << name << ", " << thread_count << " threads: " << traced_ns
+           << " ns per call, " << traced_ns - untraced_ns << " ns overhead ("
+           << 100.0 * (traced_ns / untraced_ns - 1) << "%)";
+}
+
+}; // namespace level_zero_tests
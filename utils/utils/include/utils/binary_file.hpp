@@ -0,0 +1,56 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#ifndef level_zero_tests_BINARY_FILE_HPP
+#define level_zero_tests_BINARY_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace level_zero_tests {
+
+// The contents of a whole file, mapped read-only into memory, so that kernel
+// binaries are handed to the driver without being read into a copy first.
+// The data stays valid for the lifetime of the object. A file that cannot be
+// opened gives an empty, not open, object.
+class BinaryFile {
+public:
+  BinaryFile() = default;
+  explicit BinaryFile(const std::string &file_path);
+  ~BinaryFile();
+  BinaryFile(BinaryFile &&other) noexcept;
+  BinaryFile &operator=(BinaryFile &&other) noexcept;
+  BinaryFile(const BinaryFile &) = delete;
+  BinaryFile &operator=(const BinaryFile &) = delete;
+
+  bool is_open() const { return open_; }
+  bool empty() const { return size_ == 0; }
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+  const uint8_t *begin() const { return data_; }
+  const uint8_t *end() const { return data_ + size_; }
+
+  std::vector<uint8_t> to_vector() const {
+    return std::vector<uint8_t>(begin(), end());
+  }
+
+private:
+  void release();
+
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  bool open_ = false;
+  // The file mapping object on Windows
+  void *mapping_ = nullptr;
+};
+
+}; // namespace level_zero_tests
+
+#endif
@@ -16,12 +16,17 @@
 #include <level_zero/zet_api.h>
 #include <level_zero/zes_api.h>
 
+#include "utils/binary_file.hpp"
 #include "utils/utils_string.hpp"
 
 namespace level_zero_tests {
 
 zes_driver_handle_t get_default_zes_driver();
 
+// The default driver, device and context are chosen once per process, and
+// the driver and device handles enumerated once unless
+// LZT_DISABLE_ENUMERATION_CACHE is set; all of them are safe to call from
+// several threads.
 ze_context_handle_t get_default_context();
 ze_device_handle_t get_default_device(ze_driver_handle_t driver);
 ze_device_handle_t find_device(ze_driver_handle_t &driver,
@@ -50,6 +55,7 @@ void print_driver_overview(const std::vector<ze_driver_handle_t> driver);
 void print_platform_overview(const std::string context);
 void print_platform_overview();
 
+// Copies the file into a vector; BinaryFile maps it without a copy
 std::vector<uint8_t> load_binary_file(const std::string &file_path);
 void save_binary_file(const std::vector<uint8_t> &data,
                       const std::string &file_path);
@@ -59,9 +65,6 @@ template <typename T> int size_in_bytes(const std::vector<T> &v) {
   return static_cast<int>(sizeof(T) * v.size());
 }
 
-extern std::unique_ptr<std::map<std::string, std::vector<uint8_t>>>
-    binary_file_map;
-
 } // namespace level_zero_tests
 
 #endif
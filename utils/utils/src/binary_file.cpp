@@ -0,0 +1,130 @@
+/*
+ *
+ * Copyright (C) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#include "utils/binary_file.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace level_zero_tests {
+
+#ifdef _WIN32
+
+BinaryFile::BinaryFile(const std::string &file_path) {
+  HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    return;
+  }
+  open_ = true;
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  // An empty file cannot be mapped, and needs no data
+  if (size_ != 0) {
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ != nullptr) {
+      data_ = static_cast<const uint8_t *>(
+          MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (data_ == nullptr) {
+      release();
+    }
+  }
+  CloseHandle(file);
+}
+
+void BinaryFile::release() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+  }
+  data_ = nullptr;
+  mapping_ = nullptr;
+  size_ = 0;
+  open_ = false;
+}
+
+#else
+
+BinaryFile::BinaryFile(const std::string &file_path) {
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode)) {
+    close(fd);
+    return;
+  }
+  open_ = true;
+  size_ = static_cast<size_t>(file_stat.st_size);
+  // An empty file cannot be mapped, and needs no data
+  if (size_ != 0) {
+    void *address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+      release();
+    } else {
+      data_ = static_cast<const uint8_t *>(address);
+    }
+  }
+  // The mapping keeps its own reference to the file
+  close(fd);
+}
+
+void BinaryFile::release() {
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t *>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+}
+
+#endif
+
+BinaryFile::~BinaryFile() { release(); }
+
+BinaryFile::BinaryFile(BinaryFile &&other) noexcept
+    : data_(other.data_), size_(other.size_), open_(other.open_),
+      mapping_(other.mapping_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.open_ = false;
+  other.mapping_ = nullptr;
+}
+
+BinaryFile &BinaryFile::operator=(BinaryFile &&other) noexcept {
+  if (this != &other) {
+    release();
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(open_, other.open_);
+    std::swap(mapping_, other.mapping_);
+  }
+  return *this;
+}
+
+}; // namespace level_zero_tests
@@ -10,8 +10,11 @@
 #include "logging/logging.hpp"
 #include "test_harness/test_harness.hpp"
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
 namespace level_zero_tests {
 
@@ -39,38 +42,148 @@ std::vector<zes_driver_handle_t> get_all_zes_driver_handles() {
   return driver_handles;
 }
 
-zes_driver_handle_t get_default_zes_driver() {
+namespace {
+
+// Driver and device handles stay valid for the life of the process, so they
+// are enumerated once, unless LZT_DISABLE_ENUMERATION_CACHE is set. The
+// default device of each driver is always selected once.
+struct EnumerationCache {
+  std::mutex mutex;
+  bool disabled = (getenv("LZT_DISABLE_ENUMERATION_CACHE") != nullptr);
+  std::vector<ze_driver_handle_t> drivers;
+  std::map<ze_driver_handle_t, std::vector<ze_device_handle_t>> devices;
+  std::map<ze_driver_handle_t, ze_device_handle_t> default_devices;
+};
+
+EnumerationCache &enumeration_cache() {
+  static EnumerationCache cache;
+  return cache;
+}
+
+std::vector<ze_driver_handle_t> enumerate_driver_handles() {
   ze_result_t result = ZE_RESULT_SUCCESS;
+  uint32_t driver_handle_count = get_driver_handle_count();
 
-  static zes_driver_handle_t driver = nullptr;
-  int default_idx = 0;
+  std::vector<ze_driver_handle_t> driver_handles(driver_handle_count);
 
-  if (driver)
-    return driver;
+  result = zeDriverGet(&driver_handle_count, driver_handles.data());
 
-  char *user_driver_index = getenv("LZT_DEFAULT_DRIVER_IDX");
-  if (user_driver_index != nullptr) {
-    default_idx = std::stoi(user_driver_index);
+  if (result) {
+    throw std::runtime_error("zeDriverGet failed: " + to_string(result));
   }
+  return driver_handles;
+}
 
-  std::vector<zes_driver_handle_t> drivers =
-      level_zero_tests::get_all_zes_driver_handles();
-  if (drivers.size() == 0) {
-    throw std::runtime_error("zesDriverGet failed: " + to_string(result));
+std::vector<ze_device_handle_t> enumerate_devices(ze_driver_handle_t driver) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  uint32_t device_count = get_device_count(driver);
+  std::vector<ze_device_handle_t> devices(device_count);
+
+  result = zeDeviceGet(driver, &device_count, devices.data());
+
+  if (result) {
+    throw std::runtime_error("zeDeviceGet failed: " + to_string(result));
   }
+  return devices;
+}
+
+ze_device_handle_t select_default_device(ze_driver_handle_t driver) {
+  ze_result_t result = ZE_RESULT_SUCCESS;
+
+  ze_device_handle_t device = nullptr;
+  int default_idx = 0;
+  char *default_name = nullptr;
+
+  char *user_device_index = getenv("LZT_DEFAULT_DEVICE_IDX");
+  if (user_device_index != nullptr) {
+    default_idx = std::stoi(user_device_index);
+  }
+  default_name = getenv("LZT_DEFAULT_DEVICE_NAME");
 
-  if (default_idx >= drivers.size()) {
-    LOG_ERROR << "Default Driver index " << default_idx
-              << " invalid on this machine.";
-    throw std::runtime_error("Get Default Driver failed");
+  std::vector<ze_device_handle_t> devices =
+      level_zero_tests::get_devices(driver);
+  if (devices.size() == 0) {
+    throw std::runtime_error("zeDeviceGet failed: " + to_string(result));
+  }
+
+  if (default_name != nullptr) {
+    LOG_INFO << "Default Device to use has NAME:" << default_name;
+    for (auto d : devices) {
+      ze_device_properties_t device_props =
+          level_zero_tests::get_device_properties(d);
+      LOG_TRACE << "Device Name :" << device_props.name;
+      if (strcmp(default_name, device_props.name) == 0) {
+        device = d;
+        break;
+      }
+    }
+    if (!device) {
+      LOG_ERROR << "Default Device name " << default_name
+                << " invalid on this machine.";
+      throw std::runtime_error("Get Default Device failed");
+    }
+  } else {
+    if (default_idx >= devices.size()) {
+      LOG_ERROR << "Default Device index " << default_idx
+                << " invalid on this machine.";
+      throw std::runtime_error("Get Default Device failed");
+    }
+    device = devices[default_idx];
+    LOG_INFO << "Default Device retrieved at index " << default_idx;
   }
-  driver = drivers[default_idx];
-  if (!driver) {
-    LOG_ERROR << "Invalid Driver handle at index " << default_idx;
-    throw std::runtime_error("Get Default Driver failed");
+
+  char *user_sub_device_index = getenv("LZT_DEFAULT_SUBDEVICE_IDX");
+  if (user_sub_device_index != nullptr) {
+    const int sub_device_idx = std::stoi(user_sub_device_index);
+    std::vector<ze_device_handle_t> sub_devices =
+        level_zero_tests::get_ze_sub_devices(device);
+    device = nullptr;
+    if (sub_device_idx < 0 || sub_device_idx >= sub_devices.size()) {
+      LOG_ERROR << "Default Subdevice index " << sub_device_idx
+                << " invalid on this machine.";
+      throw std::runtime_error("Get Default Device failed");
+    }
+    device = sub_devices[sub_device_idx];
+    LOG_INFO << "Default Device is the subdevice at index " << sub_device_idx;
   }
+  return device;
+}
+
+} // namespace
+
+zes_driver_handle_t get_default_zes_driver() {
+  static std::once_flag driverInitializedFlag = {};
+  static zes_driver_handle_t driver = nullptr;
+
+  std::call_once(driverInitializedFlag, [&]() {
+    ze_result_t result = ZE_RESULT_SUCCESS;
+    int default_idx = 0;
 
-  LOG_INFO << "Default Driver retrieved at index " << default_idx;
+    char *user_driver_index = getenv("LZT_DEFAULT_DRIVER_IDX");
+    if (user_driver_index != nullptr) {
+      default_idx = std::stoi(user_driver_index);
+    }
+
+    std::vector<zes_driver_handle_t> drivers =
+        level_zero_tests::get_all_zes_driver_handles();
+    if (drivers.size() == 0) {
+      throw std::runtime_error("zesDriverGet failed: " + to_string(result));
+    }
+
+    if (default_idx >= drivers.size()) {
+      LOG_ERROR << "Default Driver index " << default_idx
+                << " invalid on this machine.";
+      throw std::runtime_error("Get Default Driver failed");
+    }
+    if (!drivers[default_idx]) {
+      LOG_ERROR << "Invalid Driver handle at index " << default_idx;
+      throw std::runtime_error("Get Default Driver failed");
+    }
+    driver = drivers[default_idx];
+
+    LOG_INFO << "Default Driver retrieved at index " << default_idx;
+  });
 
   return driver;
 }
@@ -94,37 +207,37 @@ ze_context_handle_t get_default_context() {
 }
 
 ze_driver_handle_t get_default_driver() {
-  ze_result_t result = ZE_RESULT_SUCCESS;
-
+  static std::once_flag driverInitializedFlag = {};
   static ze_driver_handle_t driver = nullptr;
-  int default_idx = 0;
 
-  if (driver)
-    return driver;
+  std::call_once(driverInitializedFlag, [&]() {
+    ze_result_t result = ZE_RESULT_SUCCESS;
+    int default_idx = 0;
 
-  char *user_driver_index = getenv("LZT_DEFAULT_DRIVER_IDX");
-  if (user_driver_index != nullptr) {
-    default_idx = std::stoi(user_driver_index);
-  }
+    char *user_driver_index = getenv("LZT_DEFAULT_DRIVER_IDX");
+    if (user_driver_index != nullptr) {
+      default_idx = std::stoi(user_driver_index);
+    }
 
-  std::vector<ze_driver_handle_t> drivers =
-      level_zero_tests::get_all_driver_handles();
-  if (drivers.size() == 0) {
-    throw std::runtime_error("zeDriverGet failed: " + to_string(result));
-  }
+    std::vector<ze_driver_handle_t> drivers =
+        level_zero_tests::get_all_driver_handles();
+    if (drivers.size() == 0) {
+      throw std::runtime_error("zeDriverGet failed: " + to_string(result));
+    }
 
-  if (default_idx >= drivers.size()) {
-    LOG_ERROR << "Default Driver index " << default_idx
-              << " invalid on this machine.";
-    throw std::runtime_error("Get Default Driver failed");
-  }
-  driver = drivers[default_idx];
-  if (!driver) {
-    LOG_ERROR << "Invalid Driver handle at index " << default_idx;
-    throw std::runtime_error("Get Default Driver failed");
-  }
+    if (default_idx >= drivers.size()) {
+      LOG_ERROR << "Default Driver index " << default_idx
+                << " invalid on this machine.";
+      throw std::runtime_error("Get Default Driver failed");
+    }
+    if (!drivers[default_idx]) {
+      LOG_ERROR << "Invalid Driver handle at index " << default_idx;
+      throw std::runtime_error("Get Default Driver failed");
+    }
+    driver = drivers[default_idx];
 
-  LOG_INFO << "Default Driver retrieved at index " << default_idx;
+    LOG_INFO << "Default Driver retrieved at index " << default_idx;
+  });
 
   return driver;
 }
@@ -161,56 +274,24 @@ ze_context_handle_t create_context_ex(ze_driver_handle_t driver) {
 }
 
 void destroy_context(ze_context_handle_t context) {
+  release_usm_arena(context);
+  release_command_bundles(context);
   EXPECT_EQ(ZE_RESULT_SUCCESS, zeContextDestroy(context));
+  clear_properties_cache();
 }
 
 ze_device_handle_t get_default_device(ze_driver_handle_t driver) {
-  ze_result_t result = ZE_RESULT_SUCCESS;
-
-  static ze_device_handle_t device = nullptr;
-  int default_idx = 0;
-  char *default_name = nullptr;
-  if (device)
-    return device;
-
-  char *user_device_index = getenv("LZT_DEFAULT_DEVICE_IDX");
-  if (user_device_index != nullptr) {
-    default_idx = std::stoi(user_device_index);
-  }
-  default_name = getenv("LZT_DEFAULT_DEVICE_NAME");
-
-  std::vector<ze_device_handle_t> devices =
-      level_zero_tests::get_ze_devices(driver);
-  if (devices.size() == 0) {
-    throw std::runtime_error("zeDeviceGet failed: " + to_string(result));
-  }
-
-  if (default_name != nullptr) {
-    LOG_INFO << "Default Device to use has NAME:" << default_name;
-    for (auto d : devices) {
-      ze_device_properties_t device_props =
-          level_zero_tests::get_device_properties(d);
-      LOG_TRACE << "Device Name :" << device_props.name;
-      if (strcmp(default_name, device_props.name) == 0) {
-        device = d;
-        break;
-      }
-    }
-    if (!device) {
-      LOG_ERROR << "Default Device name " << default_name
-                << " invalid on this machine.";
-      throw std::runtime_error("Get Default Device failed");
+  auto &cache = enumeration_cache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.default_devices.find(driver);
+    if (it != cache.default_devices.end()) {
+      return it->second;
     }
-  } else {
-    if (default_idx >= devices.size()) {
-      LOG_ERROR << "Default Device index " << default_idx
-                << " invalid on this machine.";
-      throw std::runtime_error("Get Default Device failed");
-    }
-    device = devices[default_idx];
-    LOG_INFO << "Default Device retrieved at index " << default_idx;
   }
-  return device;
+  ze_device_handle_t device = select_default_device(driver);
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.default_devices.emplace(driver, device).first->second;
 }
 
 uint32_t get_device_count(ze_driver_handle_t driver) {
@@ -246,31 +327,39 @@ uint32_t get_sub_device_count(ze_device_handle_t device) {
 }
 
 std::vector<ze_driver_handle_t> get_all_driver_handles() {
-  ze_result_t result = ZE_RESULT_SUCCESS;
-  uint32_t driver_handle_count = get_driver_handle_count();
-
-  std::vector<ze_driver_handle_t> driver_handles(driver_handle_count);
-
-  result = zeDriverGet(&driver_handle_count, driver_handles.data());
-
-  if (result) {
-    throw std::runtime_error("zeDriverGet failed: " + to_string(result));
+  auto &cache = enumeration_cache();
+  if (cache.disabled) {
+    return enumerate_driver_handles();
   }
-  return driver_handles;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (!cache.drivers.empty()) {
+      return cache.drivers;
+    }
+  }
+  auto drivers = enumerate_driver_handles();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.drivers.empty()) {
+    cache.drivers = drivers;
+  }
+  return drivers;
 }
 
 std::vector<ze_device_handle_t> get_devices(ze_driver_handle_t driver) {
-
-  ze_result_t result = ZE_RESULT_SUCCESS;
-
-  uint32_t device_count = get_device_count(driver);
-  std::vector<ze_device_handle_t> devices(device_count);
-
-  result = zeDeviceGet(driver, &device_count, devices.data());
-
-  if (result) {
-    throw std::runtime_error("zeDeviceGet failed: " + to_string(result));
+  auto &cache = enumeration_cache();
+  if (cache.disabled) {
+    return enumerate_devices(driver);
+  }
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.devices.find(driver);
+    if (it != cache.devices.end()) {
+      return it->second;
+    }
   }
+  auto devices = enumerate_devices(driver);
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.devices.emplace(driver, devices);
   return devices;
 }
 
@@ -326,23 +415,26 @@ ze_device_handle_t find_device(ze_driver_handle_t &driver,
   return device;
 }
 
+// Orders devices by their UUID read from the last byte to the first. The
+// keys are read once per device rather than once per comparison.
 void sort_devices(std::vector<ze_device_handle_t> &devices) {
-  std::sort(devices.begin(), devices.end(),
-            [](ze_device_handle_t &a, ze_device_handle_t &b) {
-              auto device_properties_a = lzt::get_device_properties(a);
-              auto device_properties_b = lzt::get_device_properties(b);
-
-              for (int i = (ZE_MAX_DEVICE_UUID_SIZE - 1); i >= 0; i--) {
-                if (device_properties_a.uuid.id[i] <
-                    device_properties_b.uuid.id[i]) {
-                  return true;
-                } else if (device_properties_a.uuid.id[i] >
-                           device_properties_b.uuid.id[i]) {
-                  return false;
-                }
-              }
-              return false;
-            });
+  std::vector<std::pair<std::array<uint8_t, ZE_MAX_DEVICE_UUID_SIZE>, size_t>>
+      keys(devices.size());
+  for (size_t i = 0; i < devices.size(); i++) {
+    auto uuid = lzt::get_device_properties(devices[i]).uuid;
+    std::reverse_copy(uuid.id, uuid.id + ZE_MAX_DEVICE_UUID_SIZE,
+                      keys[i].first.begin());
+    keys[i].second = i;
+  }
+  std::stable_sort(
+      keys.begin(), keys.end(),
+      [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  std::vector<ze_device_handle_t> sorted(devices.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    sorted[i] = devices[keys[i].second];
+  }
+  devices.swap(sorted);
 }
 
 void print_driver_version(ze_driver_handle_t driver) {
@@ -410,48 +502,21 @@ void print_platform_overview(const std::string context) {
 
 void print_platform_overview() { print_platform_overview(""); }
 
-std::unique_ptr<std::map<std::string, std::vector<uint8_t>>> binary_file_map =
-    std::make_unique<std::map<std::string, std::vector<uint8_t>>>();
-
 std::vector<uint8_t> load_binary_file(const std::string &file_path) {
-  std::map<std::string, std::vector<uint8_t>> *binary_map =
-      binary_file_map.get();
-  std::map<std::string, std::vector<uint8_t>>::iterator it =
-      binary_map->find(file_path);
-  // Iterate through the map of modules and return if the module was already
-  // used in this test run.
-  if (it != binary_map->end()) {
-    return it->second;
-  }
   LOG_ENTER_FUNCTION
   LOG_DEBUG << "File path: " << file_path;
-  std::ifstream stream(file_path, std::ios::in | std::ios::binary);
-
-  std::vector<uint8_t> binary_file;
-  if (!stream.good()) {
+  const BinaryFile binary_file(file_path);
+  if (!binary_file.is_open()) {
     LOG_ERROR << "Failed to load binary file: " << file_path << "error "
               << strerror(errno);
 
     LOG_EXIT_FUNCTION
-    return binary_file;
+    return std::vector<uint8_t>();
   }
-
-  size_t length = 0;
-  stream.seekg(0, stream.end);
-  length = static_cast<size_t>(stream.tellg());
-  stream.seekg(0, stream.beg);
-  LOG_DEBUG << "Binary file length: " << length;
-
-  binary_file.resize(length);
-  stream.read(reinterpret_cast<char *>(binary_file.data()), length);
-  LOG_DEBUG << "Binary file loaded";
-
-  stream.close();
+  LOG_DEBUG << "Binary file length: " << binary_file.size();
 
   LOG_EXIT_FUNCTION
-  binary_map->insert(
-      std::pair<std::string, std::vector<uint8_t>>(file_path, binary_file));
-  return binary_file;
+  return binary_file.to_vector();
 }
 
 void save_binary_file(const std::vector<uint8_t> &data,
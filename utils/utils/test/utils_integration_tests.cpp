@@ -9,6 +9,7 @@
 #include "utils/utils.hpp"
 #include "gtest/gtest.h"
 #include <cstdio>
+#include <utility>
 
 TEST(LoadBinaryFile, ValidFile) {
   const std::vector<uint8_t> bytes =
@@ -24,6 +25,29 @@ TEST(LoadBinaryFile, NotExistingFile) {
   EXPECT_EQ(reference, bytes);
 }
 
+TEST(BinaryFile, MapsValidFile) {
+  const level_zero_tests::BinaryFile binary_file("binary_file.bin");
+  const std::vector<uint8_t> reference = {0x00, 0x11, 0x22, 0x33};
+  EXPECT_TRUE(binary_file.is_open());
+  EXPECT_EQ(reference, binary_file.to_vector());
+}
+
+TEST(BinaryFile, NotExistingFileIsEmpty) {
+  const level_zero_tests::BinaryFile binary_file("invalid/path");
+  EXPECT_FALSE(binary_file.is_open());
+  EXPECT_TRUE(binary_file.empty());
+  EXPECT_EQ(nullptr, binary_file.data());
+}
+
+TEST(BinaryFile, MovedFileKeepsItsData) {
+  level_zero_tests::BinaryFile binary_file("binary_file.bin");
+  const uint8_t *data = binary_file.data();
+  level_zero_tests::BinaryFile moved(std::move(binary_file));
+  EXPECT_FALSE(binary_file.is_open());
+  EXPECT_EQ(data, moved.data());
+  EXPECT_EQ(4u, moved.size());
+}
+
 TEST(SaveBinaryFile, ValidFile) {
   const std::vector<uint8_t> bytes = {0x00, 0x11, 0x22, 0x33};
   const std::string path = "output.bin";
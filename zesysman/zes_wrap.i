@@ -3,7 +3,7 @@
  *
  * SPDX-License-Identifier: MIT
  */
-%module zes_wrap
+%module(threads="1") zes_wrap
 
 %{
 #include <sys/stat.h>
@@ -279,6 +279,80 @@ void add_pci_bar_properties_1_2_array(zes_pci_bar_properties_t *baseArray, zes_p
 }
 %}
 
+//
+// Derived rates: a zes_rate_t keeps the previous sample of one handle, and each
+// *_rate_update() takes the counters just read into the API structure and sets
+// the rates over the interval since that sample. Rates are -1 until two samples
+// with increasing timestamps have been taken.
+//
+
+%inline %{
+typedef struct _zes_rate_t
+{
+    double rate;
+    double rate2;
+    double utilization;
+    uint64_t counter;
+    uint64_t counter2;
+    uint64_t timestamp;
+    uint32_t samples;
+} zes_rate_t;
+%}
+
+%{
+static int rate_update(zes_rate_t *r, uint64_t counter, uint64_t counter2, uint64_t timestamp,
+                       double scale, uint64_t maxBandwidth)
+{
+    int64_t deltaT = (int64_t)(timestamp - r->timestamp);
+    double delta = (double)(int64_t)(counter - r->counter);
+    double delta2 = (double)(int64_t)(counter2 - r->counter2);
+    int valid = r->samples > 0 && deltaT > 0;
+
+    r->rate = valid ? scale * delta / deltaT : -1.0;
+    r->rate2 = valid ? scale * delta2 / deltaT : -1.0;
+    r->utilization = valid && maxBandwidth > 0 ?
+        1e8 * (delta + delta2) / ((double)maxBandwidth * deltaT) : -1.0;
+    r->counter = counter;
+    r->counter2 = counter2;
+    r->timestamp = timestamp;
+    if (r->samples < UINT32_MAX)
+        ++r->samples;
+    return valid;
+}
+%}
+
+%inline %{
+// Power in mW from energy in uJ
+int power_rate_update(zes_rate_t *r, zes_power_energy_counter_t *c)
+{
+    return rate_update(r, c->energy, 0, c->timestamp, 1000.0, 0);
+}
+
+// Percentage of the interval the engine was active
+int engine_rate_update(zes_rate_t *r, zes_engine_stats_t *c)
+{
+    return rate_update(r, c->activeTime, 0, c->timestamp, 100.0, 0);
+}
+
+// Percentage of the interval the frequency was throttled
+int throttle_rate_update(zes_rate_t *r, zes_freq_throttle_time_t *c)
+{
+    return rate_update(r, c->throttleTime, 0, c->timestamp, 100.0, 0);
+}
+
+// Read and write throughput in B/s, and utilization in % of maxBandwidth
+int mem_rate_update(zes_rate_t *r, zes_mem_bandwidth_t *c)
+{
+    return rate_update(r, c->readCounter, c->writeCounter, c->timestamp, 1e6, c->maxBandwidth);
+}
+
+// Receive and transmit throughput in B/s
+int fabric_port_rate_update(zes_rate_t *r, zes_fabric_port_throughput_t *c)
+{
+    return rate_update(r, c->rxCounter, c->txCounter, c->timestamp, 1e6, 0);
+}
+%}
+
 %pointer_class(ze_bool_t, ze_bool_ptr)
 %pointer_class(int32_t, int32_ptr)
 %pointer_class(uint32_t, uint32_ptr)
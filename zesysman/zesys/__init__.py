@@ -2,4 +2,4 @@
 # Copyright (C) 2020 Intel Corporation
 # SPDX-License-Identifier: MIT
 
-__all__ = ["arg", "logger", "otree", "state", "stub", "util"]
+__all__ = ["arg", "exporter", "logger", "otree", "proctop", "state", "stream", "stub", "util"]
@@ -14,7 +14,9 @@ from operator import add
 from . import logger
 from . import otree
 from . import output
+from . import proctop
 from . import state
+from . import stream
 from . import util
 from . import zes_wrap
 
@@ -272,6 +274,10 @@ def parse():
     parser.add_argument("--show-device", action='store_true', help="show device attributes")
     parser.add_argument("--show-ecc", action='store_true', help="show ecc attributes")
     parser.add_argument("--show-processes", action='store_true', help="show process usage")
+    parser.add_argument("--top-processes", metavar='N', type=int,
+                        help="show the N processes using the device most, with changes between polls")
+    parser.add_argument("--sort-processes", choices=proctop.sortKeys, default="mem",
+                        help="order of --top-processes (default mem)")
     parser.add_argument("--show-scheduler", action='store_true', help="show scheduler mode")
     parser.add_argument("--show-diag", action='store_true', help="show diagnostic test suites")
     parser.add_argument("--show-topo", choices=["matrix","graph","info"], help="show topology map")
@@ -280,6 +286,12 @@ def parse():
                         help="set sampling interval (in s by default)")
     parser.add_argument("--iterations", metavar='NUM', type=int,
                         help="samples to collect (0 = until stopped)")
+    parser.add_argument("--stream", metavar='DEST',
+                        help="stream telemetry counters as line protocol to DEST (-, FILE, udp://HOST:PORT, tcp://HOST:PORT)")
+    parser.add_argument("--stream-rate", metavar='HZ', type=float, default=10.0,
+                        help="samples per second when streaming (default 10)")
+    parser.add_argument("--stream-counters", metavar='LIST',
+                        help="comma separated counters to stream (default " + ",".join(stream.streamCounters) + ")")
     parser.add_argument("--enable-critical-temp", nargs=1, metavar='IDX', type=int,
                         help="enable critical temperature sensor")
     parser.add_argument("--disable-critical-temp", nargs=1, metavar='IDX', type=int,
@@ -339,9 +351,11 @@ def parse():
     parser.add_argument("-y", "--yes", action='store_true', help="do not ask for reset confirmation")
     parser.add_argument("--run-diag", nargs='+', metavar=('SUITE','N'),
                         help="run diagnostic test suites")
-    parser.add_argument("-f", "--format", metavar='FMT', choices=["list","xml","table","csv"],
-                        help="specify output format (list/xml/table/csv)")
+    parser.add_argument("-f", "--format", metavar='FMT', choices=["list","xml","table","csv","openmetrics"],
+                        help="specify output format (list/xml/table/csv/openmetrics)")
     parser.add_argument("--output", metavar='FILE', help="output to FILE")
+    parser.add_argument("--serve", metavar='PORT', type=int,
+                        help="serve telemetry in OpenMetrics format over HTTP on PORT")
     parser.add_argument("--tee", action='store_true', help="print to standard output also")
     parser.add_argument("--indent", metavar='COUNT', type=int,
                         help="use COUNT space (or -COUNT tab) indents")
@@ -414,8 +428,18 @@ def parse():
         for a,v in darg.__dict__.items():
             args.__dict__[a] = v
 
+    if args.serve is not None:
+        args.format = "openmetrics"
+        if args.iterations is None:
+            args.iterations = 0
+
     otree.setNodeClassByName(args.format)
 
+    if args.top_processes is not None:
+        if args.top_processes < 1:
+            logger.pr.fail("ERROR: --top-processes needs at least 1 process")
+        args.show_processes = True
+
     if args.poll is not None and args.iterations is None:
         args.iterations = 0
 
@@ -431,6 +455,20 @@ def parse():
         if remainder:
             logger.pr.err("WARNING: Extra polling arguments ignored:", remainder)
 
+    if args.stream is not None:
+        if args.iterations is None:
+            state.maxIterations = float("inf")
+        if args.stream_counters:
+            args.stream_counters = args.stream_counters.split(",")
+            for counter in args.stream_counters:
+                if counter not in stream.streamCounters:
+                    logger.pr.fail("ERROR: unknown stream counter", counter)
+        else:
+            args.stream_counters = stream.streamCounters
+        if not 0 < args.stream_rate <= 1000:
+            logger.pr.err("WARNING: Stream rate must be between 0 and 1000 Hz, defaulting to 10 Hz")
+            args.stream_rate = 10.0
+
     if state.pollInterval <= 0:
         logger.pr.err("WARNING: Polling interval must be greater than 0, defaulting to 1s")
         state.pollInterval = 1.0
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# Copyright (C) 2024 Intel Corporation
+# SPDX-License-Identifier: MIT
+
+import http.server
+import threading
+
+from . import logger
+from . import state
+
+#
+# HTTP exposition of the OpenMetrics output: the polling loop publishes each iteration, and
+# every scrape of /metrics is served the latest one, so that scrapes never wait on the
+# devices and rates are derived over the poll interval rather than between scrapes.
+#
+
+contentType = "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+class Exporter:
+    def __init__(self, port):
+        self.lock = threading.Lock()
+        self.page = b"# EOF\n"
+        exporter = self
+
+        class Handler(http.server.BaseHTTPRequestHandler):
+            def do_GET(self):
+                if self.path.split("?")[0] != "/metrics":
+                    self.send_error(404)
+                    return
+                with exporter.lock:
+                    page = exporter.page
+                self.send_response(200)
+                self.send_header("Content-Type", contentType)
+                self.send_header("Content-Length", str(len(page)))
+                self.end_headers()
+                self.wfile.write(page)
+
+            def log_message(self, format, *args):
+                pass
+
+        try:
+            self.server = http.server.ThreadingHTTPServer(("", port), Handler)
+        except OSError as e:
+            logger.pr.fail("Could not serve metrics on port", port, ":", e)
+        self.thread = threading.Thread(target=self.server.serve_forever, daemon=True)
+        self.thread.start()
+        state.metricsPublisher = self.publish
+
+    def publish(self, text):
+        page = text.encode()
+        with self.lock:
+            self.page = page
+
+    def shutdown(self):
+        state.metricsPublisher = None
+        self.server.shutdown()
+        self.server.server_close()
@@ -1,7 +1,8 @@
 #!/usr/bin/env python3
-# Copyright (C) 2020-2023 Intel Corporation
+# Copyright (C) 2020-2024 Intel Corporation
 # SPDX-License-Identifier: MIT
 
+import re
 import time
 
 from . import logger
@@ -501,13 +502,101 @@ class CsvNode(TableNode):
     def outputFinish(self):
         pass
 
+#
+# OpenMetrics exposition: every numeric leaf is a gauge sample, named after the component
+# and the leaf ("zes_power_domain_current_power_watts"), labelled with the index and other
+# identifying attributes of its ancestors, and scaled back to the base unit.
+#
+OpenMetricsUnits = { "W" : (1, "watts"), "mW" : (1e-3, "watts"), "kW" : (1e3, "watts"),
+                     "MHz" : (1e6, "hertz"), "GHz" : (1e9, "hertz"),
+                     "s" : (1, "seconds"), "ms" : (1e-3, "seconds"), "us" : (1e-6, "seconds"),
+                     "J" : (1, "joules"), "uJ" : (1e-6, "joules"), "mJ" : (1e-3, "joules"),
+                     "kJ" : (1e3, "joules"), "MJ" : (1e6, "joules"),
+                     "V" : (1, "volts"), "uV" : (1e-6, "volts"), "mV" : (1e-3, "volts"),
+                     "kV" : (1e3, "volts"), "MV" : (1e6, "volts"),
+                     "A" : (1, "amperes"), "uA" : (1e-6, "amperes"), "mA" : (1e-3, "amperes"),
+                     "B" : (1, "bytes"), "kB" : (1e3, "bytes"), "MB" : (1e6, "bytes"),
+                     "GB" : (1e9, "bytes"), "TB" : (1e12, "bytes"),
+                     "B/s" : (1, "bytes_per_second"), "kB/s" : (1e3, "bytes_per_second"),
+                     "MB/s" : (1e6, "bytes_per_second"), "GB/s" : (1e9, "bytes_per_second"),
+                     "TB/s" : (1e12, "bytes_per_second"),
+                     "bps" : (1, "bits_per_second"), "kbps" : (1e3, "bits_per_second"),
+                     "Mbps" : (1e6, "bits_per_second"), "Gbps" : (1e9, "bits_per_second"),
+                     "Tbps" : (1e12, "bits_per_second"),
+                     "%" : (1, "percent"), "degC" : (1, "celsius"), "\u00b0C" : (1, "celsius") }
+
+def openMetricsName(name):
+    name = re.sub(r"(?<=[a-z0-9])(?=[A-Z])", "_", str(name))
+    return re.sub(r"[^a-zA-Z0-9_]", "_", name).lower()
+
+def openMetricsLabel(value):
+    return str(value).replace("\\", "\\\\").replace('"', '\\"').replace("\n", "\\n")
+
+class OpenMetricsNode(Node):
+    def sampleValue(self):
+        if self.children or self.text is None or type(self.text) == list:
+            return None
+        if type(self.text) == bool:
+            return int(self.text)
+        try:
+            return float(self.text)
+        except ValueError:
+            return None
+    def collectSamples(self, families, labels=(), component=""):
+        name = openMetricsName(self.name)
+        labels = list(labels)
+        indexed = False
+        for attr,val in self.attrs:
+            if attr == "Index":
+                labels.append((name, val))
+                indexed = True
+            elif attr not in DecorateAttributes:
+                labels.append((name + "_" + openMetricsName(attr), val))
+        if indexed:
+            component = name
+        value = self.sampleValue()
+        if value is not None:
+            family = "zes_" + (component + "_" if component else "") + name
+            unit = None
+            for attr,val in self.attrs:
+                if attr == "Units":
+                    scale, unit = OpenMetricsUnits.get(val, (1, openMetricsName(val)))
+                    family += "_" + unit
+                    value *= scale
+            families.setdefault(family, (unit, []))[1].append((labels, value))
+        for child in self.children:
+            child.collectSamples(families, labels, component)
+    def render(self):
+        families = {}
+        self.collectSamples(families)
+        lines = []
+        for family, (unit, samples) in sorted(families.items()):
+            lines.append("# TYPE %s gauge" % family)
+            if unit:
+                lines.append("# UNIT %s %s" % (family, unit))
+            for labels, value in samples:
+                labelText = ",".join('%s="%s"' % (l, openMetricsLabel(v)) for l,v in labels)
+                if labelText:
+                    labelText = "{" + labelText + "}"
+                lines.append("%s%s %s" % (family, labelText, repr(value)))
+        lines.append("# EOF")
+        return "\n".join(lines) + "\n"
+    def outputTree(self):
+        if state.metricsPublisher:
+            state.metricsPublisher(self.render())
+        else:
+            pr(self.render(), end="")
+
+OpenMetricsNode.IterationNode = OpenMetricsNode
+OpenMetricsNode.RangeNode = OpenMetricsNode
+
 # Currently-selected Node class
 NodeClass = ListNode
 
 def setNodeClassByName(name):
     global NodeClass
     classMap = { "list" : ListNode, "xml" : XmlNode,
-                 "table" : TableNode, "csv" : CsvNode }
+                 "table" : TableNode, "csv" : CsvNode, "openmetrics" : OpenMetricsNode }
 
     NodeClass = classMap.get(name, NodeClass)
 
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# Copyright (C) 2024 Intel Corporation
+# SPDX-License-Identifier: MIT
+
+import os
+import time
+
+from .types import *
+from zesys.zes_wrap import *
+
+#
+# Process accounting for --top-processes. Every poll reads the process
+# list of a device once into an array that is kept between polls and only
+# grows, and diffs it against the snapshot of the poll before, so that a
+# node shared by hundreds of processes costs one call and one pass over
+# the list per poll, whatever is shown.
+#
+# zes_process_state_t has no engine time, so on Linux it comes from the
+# drm-engine-* counters (ns) in /proc/PID/fdinfo of the DRM clients of the
+# device. The fdinfo files of every process are looked up once and kept
+# until they stop being readable; processes without any are looked up
+# again every rescanPolls polls, in case they open the device later.
+#
+
+sortKeys = ["mem", "mem-delta", "engine"]
+
+rescanPolls = 10
+
+class ProcessSample:
+    def __init__(self, pid, memSize, sharedSize, engines, engineNs):
+        self.pid = pid
+        self.memSize = memSize
+        self.sharedSize = sharedSize
+        self.engines = engines
+        # None when the engine time is unknown
+        self.engineNs = engineNs
+        # Set against the snapshot before, None on the first poll
+        self.memDelta = None
+        self.engineUtil = None
+
+def pciAddressString(device, getPci):
+    pciProps = zes_typed_structure(ZES_STRUCTURE_TYPE_PCI_PROPERTIES)
+    try:
+        zeCall(getPci(device, pciProps))
+    except (NotImplementedError, ValueError):
+        return None
+    pciAddr = pciProps.address
+    return "%04x:%02x:%02x.%x" % (pciAddr.domain, pciAddr.bus, pciAddr.device, pciAddr.function)
+
+#
+# The API functions are passed in by the caller, so that the stubs of the
+# developer mode replace them here too.
+#
+class ProcessTracker:
+    def __init__(self, device, getState=zesDeviceProcessesGetState, getPci=zesDevicePciGetProperties):
+        self.device = device
+        self.getState = getState
+        self.count = uint32_ptr()
+        self.capacity = 0
+        self.procs = None
+        self.snapshot = {}
+        self.snapshotTime = None
+        self.started = 0
+        self.exited = 0
+        self.pdev = pciAddressString(device, getPci) if os.path.isdir("/proc") else None
+        # pid -> fdinfo paths of the DRM clients of the device
+        self.fdinfo = {}
+        self.rescan = {}
+
+    def readProcesses(self):
+        zeCall(self.getState(self.device, self.count.cast(), None))
+        needed = self.count.value()
+        if needed > self.capacity:
+            # Headroom, so that a few processes starting do not reallocate
+            self.capacity = max(16, needed + needed // 4)
+            self.procs = zes_typed_array(ZES_STRUCTURE_TYPE_PROCESS_STATE, self.capacity)
+        self.count.assign(self.capacity)
+        zeCall(self.getState(self.device, self.count.cast(), self.procs.cast()))
+        return [self.procs[i] for i in range(min(self.count.value(), self.capacity))]
+
+    def scanFdinfo(self, pid):
+        paths = []
+        fdDir = "/proc/%d/fd" % pid
+        try:
+            fds = os.listdir(fdDir)
+        except OSError:
+            return paths
+        clients = set()
+        for fd in fds:
+            try:
+                if not os.readlink(os.path.join(fdDir, fd)).startswith("/dev/dri/"):
+                    continue
+                path = "/proc/%d/fdinfo/%s" % (pid, fd)
+                with open(path) as f:
+                    info = dict(line.split(":", 1) for line in f if ":" in line)
+            except (OSError, ValueError):
+                continue
+            client = info.get("drm-client-id", "").strip()
+            if info.get("drm-pdev", "").strip() == self.pdev and client not in clients:
+                clients.add(client)
+                paths.append(path)
+        return paths
+
+    def engineNs(self, pid):
+        if self.pdev is None:
+            return None
+        paths = self.fdinfo.get(pid)
+        if not paths:
+            if self.rescan.get(pid, 0) > 0:
+                self.rescan[pid] -= 1
+                return None
+            paths = self.fdinfo[pid] = self.scanFdinfo(pid)
+            if not paths:
+                self.rescan[pid] = rescanPolls
+                return None
+        total = 0
+        for path in paths:
+            try:
+                with open(path) as f:
+                    for line in f:
+                        if line.startswith("drm-engine-") and line.rstrip().endswith(" ns"):
+                            total += int(line.split(":", 1)[1].split()[0])
+            except (OSError, ValueError):
+                # The client went away, look the process up again next poll
+                del self.fdinfo[pid]
+                return None
+        return total
+
+    def poll(self):
+        now = time.monotonic()
+        current = {}
+        for proc in self.readProcesses():
+            current[proc.processId] = ProcessSample(proc.processId, proc.memSize, proc.sharedSize,
+                                                    proc.engines, self.engineNs(proc.processId))
+        if self.snapshotTime is not None:
+            elapsedNs = (now - self.snapshotTime) * 1e9
+            for pid, sample in current.items():
+                before = self.snapshot.get(pid)
+                # A process that started since counts all its memory as grown
+                if before is None:
+                    sample.memDelta = sample.memSize
+                    continue
+                sample.memDelta = sample.memSize - before.memSize
+                if sample.engineNs is not None and before.engineNs is not None and elapsedNs > 0:
+                    sample.engineUtil = 100.0 * (sample.engineNs - before.engineNs) / elapsedNs
+            self.started = len(current.keys() - self.snapshot.keys())
+            self.exited = len(self.snapshot.keys() - current.keys())
+        for pid in self.snapshot.keys() - current.keys():
+            self.fdinfo.pop(pid, None)
+            self.rescan.pop(pid, None)
+        self.snapshot = current
+        self.snapshotTime = now
+        return current
+
+    def top(self, count, sortKey):
+        if sortKey == "mem-delta":
+            key = lambda s: abs(s.memDelta or 0)
+        elif sortKey == "engine":
+            key = lambda s: s.engineUtil or 0.0
+        else:
+            key = lambda s: s.memSize
+        return sorted(self.snapshot.values(), key=key, reverse=True)[:count]
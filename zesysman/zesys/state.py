@@ -13,3 +13,4 @@ addAnsi256ColorBlock = False
 hideTimestamp = False
 indexAttribute = "Index"
 earlyExit = threading.Event()
+metricsPublisher = None
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+# Copyright (C) 2024 Intel Corporation
+# SPDX-License-Identifier: MIT
+
+import socket
+import sys
+import time
+
+from . import logger
+from . import output
+from . import state
+from . import util
+from .types import *
+from zesys.zes_wrap import *
+
+#
+# Streaming mode: the handles and structures are set up once, and every
+# sample only reads the raw counters and writes them as InfluxDB line
+# protocol, one line per component:
+#
+#   zes_power,device=0,domain=0 energy=123456789i,timestamp=987654321i 1700000000000000000
+#
+# Cumulative counters (energy, active time, throttle time, bytes) are
+# written as read, so that the consumer derives rates over any window.
+#
+
+streamCounters = ["temp", "power", "freq", "util", "mem"]
+
+#
+# Destinations: "-" (standard output), a file name, or udp://HOST:PORT,
+# tcp://HOST:PORT
+#
+class StreamSocket:
+    def __init__(self, sock):
+        self.sock = sock
+
+    def write(self, data):
+        self.sock.sendall(data)
+
+    def flush(self):
+        pass
+
+    def close(self):
+        self.sock.close()
+
+def openStream(dest):
+    if dest == "-":
+        return sys.stdout.buffer
+    for scheme, kind in (("udp://", socket.SOCK_DGRAM), ("tcp://", socket.SOCK_STREAM)):
+        if dest.startswith(scheme):
+            host, sep, port = dest[len(scheme):].rpartition(":")
+            if not sep or not port.isdigit():
+                logger.pr.fail("ERROR: stream destination must be %sHOST:PORT" % scheme)
+            try:
+                sock = socket.socket(socket.AF_INET, kind)
+                sock.connect((host, int(port)))
+            except OSError as e:
+                logger.pr.fail("Could not connect to", dest + ":", e)
+            return StreamSocket(sock)
+    try:
+        return open(dest, "ab", buffering=0)
+    except OSError:
+        logger.pr.fail("Could not open file", dest, "for writing")
+
+def enumHandles(enumFn, device, arrayCtor):
+    count = uint32_ptr()
+    try:
+        zeCall(enumFn(device, count.cast(), None))
+    except NotImplementedError:
+        return []
+    except ValueError:
+        logger.reportZeException()
+        return []
+    handles = arrayCtor(count.value())
+    zeCall(enumFn(device, count.cast(), handles.cast()))
+    return [handles[i] for i in range(count.value())]
+
+#
+# Returns one closure per component, each returning its line protocol
+# record, without the timestamp
+#
+def makeSamplers(deviceIndex, device, counters):
+    samplers = []
+    dev = "device=%s" % deviceIndex
+
+    if "temp" in counters:
+        for i, temp in util.indexed(enumHandles(zesDeviceEnumTemperatureSensors, device,
+                                                 zes_temp_handle_array)):
+            def tempSample(temp=temp, tags="zes_temp,%s,sensor=%d" % (dev, i)):
+                return "%s temp=%.1f" % (tags, zeCall(zesTemperatureGetState(temp)))
+            samplers.append(tempSample)
+
+    if "power" in counters:
+        for i, pwr in util.indexed(enumHandles(zesDeviceEnumPowerDomains, device,
+                                                zes_pwr_handle_array)):
+            def pwrSample(pwr=pwr, counter=zes_power_energy_counter_t(),
+                          tags="zes_power,%s,domain=%d" % (dev, i)):
+                zeCall(zesPowerGetEnergyCounter(pwr, counter))
+                return "%s energy=%di,timestamp=%di" % (tags, counter.energy, counter.timestamp)
+            samplers.append(pwrSample)
+
+    if "freq" in counters:
+        for i, freq in util.indexed(enumHandles(zesDeviceEnumFrequencyDomains, device,
+                                                 zes_freq_handle_array)):
+            freqProps = zes_typed_structure(ZES_STRUCTURE_TYPE_FREQ_PROPERTIES)
+            zeCall(zesFrequencyGetProperties(freq, freqProps))
+            def freqSample(freq=freq, freqState=zes_typed_structure(ZES_STRUCTURE_TYPE_FREQ_STATE),
+                           freqThrottle=zes_freq_throttle_time_t(),
+                           tags="zes_freq,%s,domain=%d,type=%s" %
+                                (dev, i, output.freqTypeString(freqProps.type))):
+                zeCall(zesFrequencyGetState(freq, freqState))
+                record = "%s request=%.1f,actual=%.1f,throttle_reasons=%di" % (
+                    tags, freqState.request, freqState.actual, freqState.throttleReasons)
+                try:
+                    zeCall(zesFrequencyGetThrottleTime(freq, freqThrottle))
+                except NotImplementedError:
+                    return record
+                return "%s,throttle_time=%di,timestamp=%di" % (
+                    record, freqThrottle.throttleTime, freqThrottle.timestamp)
+            samplers.append(freqSample)
+
+    if "util" in counters:
+        for i, eng in util.indexed(enumHandles(zesDeviceEnumEngineGroups, device,
+                                                zes_engine_handle_array)):
+            engProps = zes_typed_structure(ZES_STRUCTURE_TYPE_ENGINE_PROPERTIES)
+            zeCall(zesEngineGetProperties(eng, engProps))
+            tags = "zes_engine,%s,engine=%d,type=%s" % (dev, i, output.engTypeString(engProps.type))
+            if engProps.onSubdevice:
+                tags += ",subdevice=%d" % engProps.subdeviceId
+            def utilSample(eng=eng, stats=zes_engine_stats_t(), tags=tags):
+                zeCall(zesEngineGetActivity(eng, stats))
+                return "%s active=%di,timestamp=%di" % (tags, stats.activeTime, stats.timestamp)
+            samplers.append(utilSample)
+
+    if "mem" in counters:
+        for i, mem in util.indexed(enumHandles(zesDeviceEnumMemoryModules, device,
+                                                zes_mem_handle_array)):
+            def memSample(mem=mem, memState=zes_typed_structure(ZES_STRUCTURE_TYPE_MEM_STATE),
+                          memCounter=zes_mem_bandwidth_t(),
+                          tags="zes_mem,%s,module=%d" % (dev, i)):
+                zeCall(zesMemoryGetState(mem, memState))
+                record = "%s free=%di,size=%di" % (tags, memState.free, memState.size)
+                try:
+                    zeCall(zesMemoryGetBandwidth(mem, memCounter))
+                except NotImplementedError:
+                    return record
+                return "%s,read=%di,write=%di,timestamp=%di" % (
+                    record, memCounter.readCounter, memCounter.writeCounter, memCounter.timestamp)
+            samplers.append(memSample)
+
+    return samplers
+
+#
+# Samples the selected counters of the devices at the given rate, on fixed
+# deadlines, until the iterations are done or the user interrupts. A sample
+# that misses its deadline is not made up for, and counted as an overrun.
+#
+def run(deviceIDs, devices, counters, rate, dest):
+    samplers = []
+    for deviceID, device in zip(deviceIDs, devices):
+        samplers.extend(makeSamplers(deviceID, device, counters))
+    if not samplers:
+        logger.pr.fail("ERROR: no telemetry counters available to stream")
+
+    # Samplers that fail are dropped rather than reported on every sample
+    def sampleAll():
+        records = []
+        for sampler in list(samplers):
+            try:
+                records.append(sampler())
+            except NotImplementedError:
+                samplers.remove(sampler)
+            except ValueError:
+                logger.reportZeException()
+                samplers.remove(sampler)
+        return records
+
+    stream = openStream(dest)
+    period = 1.0 / rate
+    samples, slot, overruns = 0, 0, 0
+    start = time.monotonic()
+    try:
+        while samples < state.maxIterations:
+            timestamp = " %d\n" % time.time_ns()
+            records = sampleAll()
+            if records:
+                stream.write((timestamp.join(records) + timestamp).encode())
+                stream.flush()
+            samples += 1
+
+            slot += 1
+            now = time.monotonic()
+            if now > start + slot * period:
+                missed = int((now - start) / period) + 1 - slot
+                overruns += missed
+                slot += missed
+            if state.earlyExit.wait(start + slot * period - now):
+                break
+    except BrokenPipeError:
+        pass
+    finally:
+        if stream is not sys.stdout.buffer:
+            stream.close()
+
+    elapsed = time.monotonic() - start
+    logger.pr.err("Streamed %d samples of %d counters in %.1f s (%d overruns)" %
+                  (samples, len(samplers), elapsed, overruns))
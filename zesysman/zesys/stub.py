@@ -612,7 +612,8 @@ def api():
     def zesDeviceProcessesGetState(dev, count_ptr, proc_array):
         if proc_array is None:
             uint32_assign(count_ptr, 4)
-        elif uint32_value(count_ptr) == 4:
+        elif uint32_value(count_ptr) >= 4:
+            uint32_assign(count_ptr, 4)
             procs = zes_process_state_array.frompointer(proc_array)
             proc = procs[0]
             proc.processId = 32765